@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "core/common/common.h"
@@ -33,6 +36,8 @@ class ORTInvoker {
     }
   }
 
+  ~ORTInvoker();
+
   IExecutionProvider& GetCurrentExecutionProvider() {
     return *execution_provider_;
   }
@@ -45,12 +50,30 @@ class ORTInvoker {
                         const std::string& domain = kOnnxDomain,
                         const int version = -1);
 
+  // Drop the kernels cached by Invoke.
+  void ClearKernelCache();
+
  private:
+  // The graph, frame info and kernel of an op, created by the first Invoke of the op with a given set of
+  // attributes and input types and reused by the later ones.
+  struct CachedKernel;
+
+  common::Status CreateCachedKernel(const std::string& op_name,
+                                    const std::vector<OrtValue>& inputs,
+                                    size_t output_count,
+                                    const NodeAttributes* attributes,
+                                    const std::string& domain,
+                                    int version,
+                                    std::unique_ptr<CachedKernel>& cached_kernel);
+
   std::shared_ptr<IExecutionProvider> execution_provider_;
   const logging::Logger& logger_;
   // custom ops for current execution provider
   // we need the op schema to resolve the output type during invoke
   const IOnnxRuntimeOpSchemaRegistryList& custom_op_registries_;
+
+  std::mutex kernel_cache_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<CachedKernel>> kernel_cache_;
 };
 
 #ifdef __GNUC__
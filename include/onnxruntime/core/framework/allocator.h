@@ -20,16 +20,28 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_max_chunks(-1),
+                  shrink_half_life_ms(-1),
+                  huge_page_size(-1),
+                  numa_node(-1),
+                  enable_tracing(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
-              int64_t max_power_of_two_extend_bytes)
+              int64_t max_power_of_two_extend_bytes, int thread_cache_max_chunks = -1,
+              int64_t shrink_half_life_ms = -1, int64_t huge_page_size = -1, int numa_node = -1,
+              int enable_tracing = -1)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_max_chunks(thread_cache_max_chunks),
+        shrink_half_life_ms(shrink_half_life_ms),
+        huge_page_size(huge_page_size),
+        numa_node(numa_node),
+        enable_tracing(enable_tracing) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +49,11 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int thread_cache_max_chunks;            // use -1 to allow ORT to choose the default (0 = disabled)
+  int64_t shrink_half_life_ms;            // use -1 to allow ORT to choose the default (0 = disabled)
+  int64_t huge_page_size;                 // use -1 to allow ORT to choose the default (0 = regular pages)
+  int numa_node;                          // use -1 to allow ORT to choose the default (no NUMA binding)
+  int enable_tracing;                     // use -1 to allow ORT to choose the default (0 = disabled, 1 = enabled)
 };
 
 namespace onnxruntime {
@@ -88,6 +105,19 @@ class IAllocator {
   // By default, the base implementation  just calls Alloc().
   virtual void* Reserve(size_t size) { return Alloc(size); }
 
+  // IsStreamAware() returns true for an implementation of IAllocator that orders its allocations on a Stream,
+  // such as StreamAwareArena or an allocator backed by a device memory pool. For such an allocator
+  // AllocOnStream() is used instead of Alloc() whenever the memory is going to be used on a known Stream, and
+  // ReleaseStreamBuffers() is called before a Stream is released so that memory still associated with it
+  // can be handed back.
+  virtual bool IsStreamAware() const { return false; }
+
+  virtual void* AllocOnStream(size_t size, Stream* /*stream*/, WaitNotificationFn /*wait_fn*/) {
+    return Alloc(size);
+  }
+
+  virtual void ReleaseStreamBuffers(Stream* /*stream*/) {}
+
   const OrtMemoryInfo& Info() const { return memory_info_; };
 
   // Each implementation of IAllocator can override and provide their own implementation
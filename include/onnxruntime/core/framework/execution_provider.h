@@ -218,6 +218,13 @@ class IExecutionProvider {
     return Status::OK();
   }
 
+  /**
+     Release the instantiated graph of the annotation id, so that the id can be captured again.
+   */
+  virtual common::Status ReleaseGraph(int /*graph_annotation_id*/) {
+    return Status::OK();
+  }
+
   /**
      Called when session creation is complete
      This provides an opportunity for execution providers to optionally synchronize and
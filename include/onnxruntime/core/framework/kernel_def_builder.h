@@ -68,6 +68,10 @@ class KernelDef {
     return variadic_alias_offsets_;
   }
 
+  const std::optional<int>& MayViewOutputs() const {
+    return may_view_outputs_of_;
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -135,6 +139,9 @@ class KernelDef {
   // output 'i + output_offset' is an alias of input 'i + input_offset' for all i >= 0
   std::optional<std::pair<int, int>> variadic_alias_offsets_;
 
+  // If set, the outputs may be views of contiguous sub-ranges of this input.
+  std::optional<int> may_view_outputs_of_;
+
   // Require input tensors to be allocated contiguously.
   bool allocate_inputs_contiguously_ = false;
 
@@ -240,6 +247,14 @@ class KernelDefBuilder {
   */
   KernelDefBuilder& VariadicAlias(int input_offset, int output_offset);
 
+  /**
+     Specify that the outputs of this kernel may be views of contiguous sub-ranges of the input_index-th input.
+     The allocation planner makes an output a view when it can prove from the static shapes that the output is a
+     contiguous sub-range of the input. The kernel detects it by the output having the data pointer of the input,
+     moves the start of the output to its sub-range with Tensor::SetByteOffset() and does not copy the data.
+  */
+  KernelDefBuilder& MayViewOutputs(int input_index);
+
   /**
      Specify that this kernel requires input tensors to be allocated
      contiguously. This allows kernels to execute as a single large
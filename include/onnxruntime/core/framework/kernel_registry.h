@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string_view>
 
 #include "core/framework/op_kernel.h"
@@ -118,8 +119,30 @@ class KernelRegistry {
   static std::string GetMapKey(const KernelDef& kernel_def) {
     return GetMapKey(kernel_def.OpName(), kernel_def.Domain(), kernel_def.Provider());
   }
+  // The result of searching the kernels for a node. It only depends on the op, the provider and the types of the
+  // node's args, so it is shared by all the nodes with the same signature.
+  struct KernelMatch {
+    std::string op_type;
+    std::string domain;
+    std::string provider;
+    int since_version;
+    InlinedVector<int> input_arg_counts;
+    // type of each input followed by each output, nullptr if the arg doesn't exist
+    InlinedVector<const std::string*> arg_types;
+
+    // the matching kernel, or nullptr if there is none
+    const KernelCreateInfo* kernel_create_info;
+    // the reasons the kernels didn't match, one per line
+    std::string errors;
+  };
+
   // Kernel create function map from op name to kernel creation info.
   // key is opname+domain_name+provider_name
   KernelCreateMap kernel_creator_fn_map_;
+
+  // Kernel matches keyed by the hash of their signature. The registries of the built-in providers are shared by all
+  // the sessions, and so are the matches.
+  mutable std::mutex kernel_match_cache_mutex_;
+  mutable InlinedHashMap<size_t, std::vector<KernelMatch>> kernel_match_cache_;
 };
 }  // namespace onnxruntime
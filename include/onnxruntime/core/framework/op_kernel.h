@@ -129,6 +129,24 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed buffers that were persisted by an earlier session instead of calling
+  // PrePack(). The buffers are what PrePack() put in prepacked_weights for the same tensor, in the same order.
+  // Unlike UseSharedPrePackedBuffers(), PrePack() is not called first, so the kernel must also restore any metadata
+  // it computes in PrePack() from the tensor, and should validate the buffer sizes against it.
+  // @param tensor: The constant initializer the buffers were packed from.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffers: The persisted buffers. As for UseSharedPrePackedBuffers() the deleter is NULL.
+  // @param prepacked_buffer_sizes: The size in bytes of each buffer.
+  // @param used_prepacked_buffers: Boolean flag set by the kernel implementation indicating that the buffers have
+  // been used. If false, the session calls PrePack() instead.
+  virtual Status RestorePrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                         std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                         gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                         /*out*/ bool& used_prepacked_buffers) {
+    used_prepacked_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -390,7 +390,10 @@ class Node {
   bool ClearAttribute(const std::string& attr_name);
 
   /** Gets the Node's mutable attributes. */
-  NodeAttributes& GetMutableAttributes() noexcept { return attributes_; }
+  NodeAttributes& GetMutableAttributes() noexcept {
+    ClearInferredArgs();
+    return attributes_;
+  }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
@@ -591,6 +594,18 @@ class Node {
   // validate and update the input arg count
   common::Status UpdateInputArgCount();
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Returns true if the op, the inputs, the outputs and the attributes of this node are unchanged since its last
+  // type and shape inferencing, so inferencing it again would give the same result.
+  bool IsTypeAndShapeInferenceCurrent() const;
+
+  // Records the state of the inputs and outputs after a successful type and shape inferencing of this node.
+  void SetTypeAndShapeInferenceCurrent();
+#endif
+
+  // Forgets the last type and shape inferencing, so the next Graph::Resolve infers this node again.
+  void ClearInferredArgs() noexcept { inferred_args_.clear(); }
+
   const Definitions& GetDefinitions() const noexcept { return definitions_; }
   const Relationships& GetRelationships() const noexcept { return relationships_; }
 
@@ -668,6 +683,18 @@ class Node {
 
   // Can be saved? The node cannot be saved anymore if removable attributes have been cleared.
   bool can_be_saved_;
+
+  // An input or output as of the last type and shape inferencing of the node.
+  struct InferredArg {
+    const NodeArg* node_arg;
+    uint64_t version;
+    // the initializer if the input is one, as inferencing may read its data
+    const ONNX_NAMESPACE::TensorProto* initializer;
+  };
+
+  // The inputs followed by the outputs as of the last type and shape inferencing, empty if there is none to reuse.
+  std::vector<InferredArg> inferred_args_;
+  const ONNX_NAMESPACE::OpSchema* inferred_op_ = nullptr;
 };
 
 /**
@@ -1701,6 +1728,9 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   std::vector<const NodeArg*> graph_inputs_including_initializers_;
   bool graph_inputs_manually_set_ = false;
 
+  // Graph inputs as of the last type and shape inferencing in Resolve.
+  std::vector<const NodeArg*> inferred_graph_inputs_;
+
   // Graph inputs excluding initializers.
   std::vector<const NodeArg*> graph_inputs_excluding_initializers_;
 
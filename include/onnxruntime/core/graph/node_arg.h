@@ -112,6 +112,7 @@ class NodeArg {
   bool Exists() const noexcept;
 
   friend class Graph;
+  friend class Node;
 
   NodeArg(NodeArgInfo&& node_arg_info);
 
@@ -122,6 +123,9 @@ class NodeArg {
   void SetType(const ONNX_NAMESPACE::TypeProto& type_proto);
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
+  // Gives this NodeArg a new version after its type or shape changed.
+  void UpdateVersion() noexcept;
+
   // Node arg PType.
   const std::string* type_;
 
@@ -130,5 +134,9 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Version of the type and shape, which changes whenever they change. Versions are unique across all the NodeArg
+  // instances, so Graph::Resolve can compare them to find the nodes that need type and shape inferencing again.
+  uint64_t version_;
 };
 }  // namespace onnxruntime
@@ -39,6 +39,8 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
@@ -53,6 +55,8 @@
 #include "core/platform/ort_mutex.h"
 #include "core/platform/ort_spin_lock.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
+#include "core/platform/tracepoints.h"
 
 // ORT thread pool overview
 // ------------------------
@@ -78,6 +82,9 @@
 //
 //   This spin-then-block behavior is configured via a flag provided
 //   when creating the thread pool, and by the constant spin_count.
+//   With adaptive spinning, each worker also stops spinning once it
+//   has waited longer than AdaptiveSpinPolicy allows, based on the
+//   idle time it observed between its previous tasks.
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -230,8 +237,11 @@ class ThreadPoolProfiler {
   void LogStartAndCoreAndBlock(std::ptrdiff_t){};
   void LogCoreAndBlock(std::ptrdiff_t){};
   void LogThreadId(int) {};
+  void LogRunStart(int) {};
+  void LogSteal(int) {};
   void LogRun(int) {};
   std::string DumpChildThreadStat() { return {}; }
+  std::vector<ThreadPoolThreadStats> GetThreadStats() const { return {}; }
 };
 #else
 class ThreadPoolProfiler {
@@ -256,8 +266,11 @@ class ThreadPoolProfiler {
   void LogStartAndCoreAndBlock(std::ptrdiff_t block_size);
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
+  void LogRunStart(int thread_idx);                 // called in child thread before running a task
+  void LogSteal(int thread_idx);                    // called in child thread to log a task stolen from another queue
   void LogRun(int thread_idx);                      // called in child thread to log num of run
   std::string DumpChildThreadStat();                // return all child statitics collected so far
+  std::vector<ThreadPoolThreadStats> GetThreadStats() const;  // return child statistics since Start, unsynchronized
 
  private:
   static const char* GetEventName(ThreadPoolEvent);
@@ -274,6 +287,7 @@ class ThreadPoolProfiler {
     std::string Reset();
   };
   bool enabled_ = false;
+  onnxruntime::TimePoint start_point_;  // first call to Start
   MainThreadStat& GetMainThreadStat();  // return thread local stat
   int num_threads_;
 #ifdef _MSC_VER
@@ -284,6 +298,9 @@ class ThreadPoolProfiler {
   struct ORT_ALIGN_TO_AVOID_FALSE_SHARING ChildThreadStat {
     std::thread::id thread_id_;
     uint64_t num_run_ = 0;
+    uint64_t num_steal_ = 0;
+    uint64_t busy_us_ = 0;  // time spent running tasks since Start
+    onnxruntime::TimePoint run_start_point_;
     onnxruntime::TimePoint last_logged_point_ = Clock::now();
     int32_t core_ = -1;  // core that the child thread is running on
   };
@@ -339,6 +356,7 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+  virtual std::vector<ThreadPoolThreadStats> GetProfilingStats() const = 0;
 };
 
 class ThreadPoolParallelSection {
@@ -405,6 +423,41 @@ class ThreadPoolLoop {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolLoop);
 };
 
+// AdaptiveSpinPolicy sizes the spin of a worker from the idle time between its tasks, which it averages over the
+// recent tasks.  If the tasks arrive back-to-back, e.g. the parallel sections of consecutive small ops, the worker
+// spins for twice the average gap to pick up the next task without the wakeup latency.  If the average gap is
+// longer than kMaxSpinMicros, e.g. between the requests of a session at low QPS, the worker blocks right away
+// instead of burning CPU.  Each worker thread owns its policy.
+class AdaptiveSpinPolicy {
+ public:
+  static constexpr int64_t kMinSpinMicros = 20;
+  static constexpr int64_t kMaxSpinMicros = 1000;
+
+  // Record the time between the end of a task and the start of the next one.
+  void RecordIdleTime(int64_t idle_micros) {
+    if (average_idle_micros_ < 0) {
+      average_idle_micros_ = idle_micros;
+    } else {
+      // exponential moving average with a weight of 1/8 for the new sample
+      average_idle_micros_ += (idle_micros - average_idle_micros_) / 8;
+    }
+  }
+
+  // How long to spin before blocking.  Spins up to kMaxSpinMicros until the first idle time is recorded.
+  int64_t SpinMicros() const {
+    if (average_idle_micros_ < 0) {
+      return kMaxSpinMicros;
+    }
+    if (average_idle_micros_ > kMaxSpinMicros) {
+      return 0;
+    }
+    return std::min(std::max(2 * average_idle_micros_, kMinSpinMicros), kMaxSpinMicros);
+  }
+
+ private:
+  int64_t average_idle_micros_ = -1;
+};
+
 template <typename Work, typename Tag, unsigned kSize>
 class RunQueue {
  public:
@@ -730,6 +783,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  std::vector<ThreadPoolThreadStats> GetProfilingStats() const override {
+    return profiler_.GetThreadStats();
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -773,6 +830,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -790,6 +848,23 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    // With threads on several NUMA nodes, each thread steals from the threads of its own node only.
+    // ThreadPool has renumbered the nodes 0..N-1, or left them empty for a single node.
+    if (thread_options.numa_local_stealing && thread_options.numa_nodes.size() == num_threads_) {
+      std::vector<std::vector<unsigned>> threads_of_node;
+      for (auto i = 0u; i < num_threads_; ++i) {
+        const auto node = static_cast<size_t>(thread_options.numa_nodes[i]);
+        if (threads_of_node.size() <= node) {
+          threads_of_node.resize(node + 1);
+        }
+        threads_of_node[node].push_back(i);
+      }
+      numa_peers_.reserve(num_threads_);
+      for (auto i = 0u; i < num_threads_; ++i) {
+        numa_peers_.push_back(threads_of_node[static_cast<size_t>(thread_options.numa_nodes[i])]);
+      }
+    }
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -1492,9 +1567,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
+  // Threads on the NUMA node of each thread, including itself.  Empty unless stealing is limited to the node.
+  std::vector<std::vector<unsigned>> numa_peers_;
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
@@ -1535,17 +1613,29 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     constexpr int log2_spin = 20;
     const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
     const int steal_count = spin_count / 100;
+    // with adaptive spinning, the time spent spinning is checked every 64 iterations.
+    constexpr int adaptive_spin_check_mask = 63;
+    AdaptiveSpinPolicy spin_policy;
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
 
     while (!should_exit) {
       Task t = q.PopFront();
+      std::chrono::steady_clock::time_point idle_start;
+      if (!t && adaptive_spinning_) {
+        idle_start = std::chrono::steady_clock::now();
+      }
       if (!t) {
+        const auto spin_duration = std::chrono::microseconds(adaptive_spinning_ ? spin_policy.SpinMicros() : 0);
         // Spin waiting for work.
         for (int i = 0; i < spin_count && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
+            if (t) {
+              profiler_.LogSteal(thread_id);
+              ORT_TRACEPOINT(threadpool_steal, thread_id);
+            }
           } else {
             t = q.PopFront();
           }
@@ -1554,6 +1644,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
             break;
           }
+          if (adaptive_spinning_ && (i & adaptive_spin_check_mask) == 0 &&
+              std::chrono::steady_clock::now() - idle_start >= spin_duration) {
+            break;
+          }
           onnxruntime::concurrency::SpinPause();
         }
 
@@ -1609,22 +1703,39 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                     }
                   }
                 }
+                if (should_block) {
+                  ORT_TRACEPOINT(threadpool_park, thread_id);
+                }
                 return should_block;
               },
               // Post-block update (executed only if we blocked)
               [&]() {
                 blocked_--;
+                ORT_TRACEPOINT(threadpool_unpark, thread_id);
               });
           // Thread just unblocked.  Unless we picked up work while
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
           if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) {
+            t = Steal(StealAttemptKind::TRY_ALL);
+            if (t) {
+              profiler_.LogSteal(thread_id);
+              ORT_TRACEPOINT(threadpool_steal, thread_id);
+            }
+          }
+        }
+
+        if (t && adaptive_spinning_) {
+          spin_policy.RecordIdleTime(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::steady_clock::now() - idle_start)
+                                         .count());
         }
       }
 
       if (t) {
         td.SetActive();
+        profiler_.LogRunStart(thread_id);
         t();
         profiler_.LogRun(thread_id);
         td.SetSpinning();
@@ -1647,6 +1758,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
+    if (!numa_peers_.empty()) {
+      return StealFromNode(*pt, steal_kind);
+    }
     unsigned size = num_threads_;
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
@@ -1670,6 +1784,30 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return Task();
   }
 
+  // Variant of Steal for pools spanning several NUMA nodes: the victims are the threads of the node of the calling
+  // worker, walked from a random start.
+  Task StealFromNode(PerThread& pt, StealAttemptKind steal_kind) {
+    const auto& peers = numa_peers_[pt.thread_id];
+    const unsigned size = static_cast<unsigned>(peers.size());
+    const unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
+    unsigned victim_idx = Rand(&pt.rand) % size;
+
+    for (unsigned i = 0; i < num_attempts; i++) {
+      const unsigned victim = peers[victim_idx];
+      if (worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
+        Task t = worker_data_[victim].queue.PopBack();
+        if (t) {
+          return t;
+        }
+      }
+      if (++victim_idx == size) {
+        victim_idx = 0;
+      }
+    }
+
+    return Task();
+  }
+
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     const unsigned size = static_cast<unsigned>(worker_data_.size());
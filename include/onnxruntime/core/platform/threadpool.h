@@ -16,6 +16,9 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <optional>
 #include <string>
 #include <vector>
 #include <functional>
@@ -132,8 +135,30 @@ namespace concurrency {
 template <typename Environment>
 class ThreadPoolTempl;
 
+// Scheduling statistics of one thread of a thread pool, accumulated since profiling of the pool started.
+struct ThreadPoolThreadStats {
+  uint64_t num_runs = 0;    // tasks run by the thread
+  uint64_t num_steals = 0;  // tasks the thread took from the queue of another thread
+  uint64_t busy_us = 0;     // time spent running tasks
+  uint64_t elapsed_us = 0;  // time since profiling started
+
+  double StealRate() const {
+    return num_runs == 0 ? 0.0 : static_cast<double>(num_steals) / static_cast<double>(num_runs);
+  }
+
+  double IdlePercentage() const {
+    return elapsed_us == 0 ? 0.0 : 100.0 * (1.0 - std::min(1.0, static_cast<double>(busy_us) / elapsed_us));
+  }
+
+  // average time the thread spent in each task of a parallel section
+  double AverageRunMicros() const {
+    return num_runs == 0 ? 0.0 : static_cast<double>(busy_us) / static_cast<double>(num_runs);
+  }
+};
+
 class ExtendedThreadPoolInterface;
 class LoopCounter;
+class LoopCostTable;
 class ThreadPoolParallelSection;
 
 class ThreadPool {
@@ -159,10 +184,44 @@ class ThreadPool {
              bool low_latency_hint,
              bool force_hybrid = false);
 
+  // Scheduling class of the loops of a session in a thread pool shared with other sessions.
+  enum class SchedulingPriority {
+    kNormal,
+    kHigh,
+  };
+
+  // Constructs a view of "shared_pool" for one of the sessions sharing it, e.g. the global intra-op thread pool.
+  // Loops run through the view execute on the threads of "shared_pool" and enlist at most
+  // "max_degree_of_parallelism" of them, including the thread starting the loop (0: no limit).
+  // While a session with high priority is running (see BeginRun), loops of normal priority views enlist at most
+  // half of the threads, to leave the others to the high priority session.
+  ThreadPool(ThreadPool& shared_pool, int max_degree_of_parallelism, SchedulingPriority priority);
+
   // Waits until all scheduled work has finished and then destroy the
   // set of threads.
   ~ThreadPool();
 
+  // Mark the start and the end of a run of the session using the pool. Only runs through views of high priority
+  // are tracked, see the constructor of views.
+  static void BeginRun(ThreadPool* tp);
+  static void EndRun(ThreadPool* tp);
+
+  // Overrides, for the parallel loops started by the calling thread while it exists, the limit on the threads
+  // enlisted by a loop (0: no override) and the scheduling class, e.g. for a single run of a session. A high
+  // priority counts as a run of a high priority view of the pool "tp" (see the constructor of views), and then
+  // BeginRun/EndRun must not be called for the same run. Scopes can be nested, the innermost one applies.
+  class RunScope {
+   public:
+    RunScope(ThreadPool* tp, int max_degree_of_parallelism, std::optional<SchedulingPriority> priority);
+    ~RunScope();
+
+   private:
+    ThreadPool* high_priority_pool_{nullptr};
+    int prev_max_degree_of_parallelism_;
+    std::optional<SchedulingPriority> prev_priority_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScope);
+  };
+
   // Start and end a multi-loop parallel section.  Parallel loops can
   // be executed directly (without using this API), but entering a
   // parallel section allows the runtime system to amortize loop
@@ -192,8 +251,10 @@ class ThreadPool {
   // Parallel sections are only implemented with the Eigen threadpool.
   // They have no effect when using OpenMP.
   //
-  // Parallel sections may not be nested, and may not be used inside
-  // parallel loops.
+  // Parallel sections may not be used inside parallel loops.  A section
+  // entered while the thread is already inside one joins the outer
+  // section; loops run on a pool other than the one of the outer
+  // section then run in the calling thread.
 
   class ParallelSection {
    public:
@@ -210,6 +271,8 @@ class ThreadPool {
     // point to avoid a dependence on the Eigen headers.
     ThreadPoolParallelSection* ps_{nullptr};
     ThreadPool* tp_;
+    // Whether the section holds a caller lease of tp_, see ThreadPool::AcquireCallerLease.
+    bool leased_{false};
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
@@ -366,6 +429,10 @@ class ThreadPool {
   static void StartProfiling(concurrency::ThreadPool* tp);
   static std::string StopProfiling(concurrency::ThreadPool* tp);
 
+  // Returns the statistics of each thread of the pool collected since profiling started, without stopping it.
+  // Empty if tp is null, has no threads or was never profiled.
+  static std::vector<ThreadPoolThreadStats> GetProfilingStats(const concurrency::ThreadPool* tp);
+
  private:
   friend class LoopCounter;
 
@@ -373,6 +440,30 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads, including the caller, that a loop started now may enlist.  This is
+  // NumThreads() + 1 unless a view limits it, or the threads are leased to several concurrent callers.
+  int MaxParallelism() const;
+
+  // With thread_options_.lease_workers_to_callers, counts the calling thread as a caller running parallel loops on
+  // the pool until ReleaseCallerLease is called, so that MaxParallelism() gives each concurrent caller an equal share
+  // of the threads. Returns false, and the lease must not be released, if the thread is not counted: the option is
+  // off, the thread belongs to the pool, or it already holds a lease.
+  bool AcquireCallerLease();
+  void ReleaseCallerLease();
+
+  // Holds a caller lease, if one can be acquired, for its lifetime.
+  class CallerLease;
+
+  // ParallelFor with the cost of an iteration measured at runtime for each call site instead of the given estimate.
+  void CalibratedParallelFor(LoopCostTable& loop_costs, std::ptrdiff_t n, const TensorOpCost& c,
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f);
+
+  // Renumbers thread_options_.numa_nodes for the threads of the pool, or clears it if they are all on one node.
+  void InitNumaNodes(int num_threads);
+
+  // Returns the NUMA node of the calling thread if it belongs to a pool spanning several nodes, otherwise -1.
+  int CurrentNumaNode() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -415,6 +506,8 @@ class ThreadPool {
 
   std::string StopProfiling();
 
+  std::vector<ThreadPoolThreadStats> GetProfilingStats() const;
+
   ThreadOptions thread_options_;
 
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
@@ -428,6 +521,29 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Factor applied to the degree of parallelism to split loops into smaller blocks, computed from the throughput
+  // weights of the threads when they are bound to cores of different speed. 0 if the weights are not known.
+  int task_granularity_factor_ = 0;
+
+  // Number of NUMA nodes the threads are bound to, 0 unless the pool spans several nodes.
+  int num_numa_nodes_ = 0;
+
+  // Costs of the iterations of each ParallelFor call site measured at runtime, if calibration is enabled.
+  // Views use the table of the shared pool.
+  std::unique_ptr<LoopCostTable> loop_costs_;
+
+  // Set for views of a shared pool: the pool owning the threads, the limit on the threads enlisted by a loop
+  // (0: no limit) and the scheduling class of the loops.
+  ThreadPool* shared_pool_ = nullptr;
+  int max_degree_of_parallelism_ = 0;
+  SchedulingPriority priority_ = SchedulingPriority::kNormal;
+
+  // Number of runs through high priority views in progress, counted in the pool owning the threads.
+  std::atomic<int> num_high_priority_runs_{0};
+
+  // Number of threads holding a caller lease, counted in the pool owning the threads.
+  std::atomic<int> num_leased_callers_{0};
 };
 
 }  // namespace concurrency
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+// Statically defined tracepoints of the hot paths, for tracing production latency with bpftrace or perf.
+//
+// With the onnxruntime_ENABLE_USDT build option (Linux, requires sys/sdt.h from systemtap-sdt-dev), each
+// ORT_TRACEPOINT is a USDT probe of the "onnxruntime" provider. A probe that no tracer is attached to is a single
+// nop instruction, and its arguments are plain values that are computed anyway, so the probes can stay in release
+// builds. Without the option the macro expands to nothing and its arguments are not evaluated.
+//
+// Probes and their arguments:
+//   node_start(node_index, op_type, provider)        before a kernel computes
+//   node_end(node_index, op_type, status_code)       after it computed
+//   arena_extend(arena, bytes, total_allocated_bytes) a BFC arena allocated a region from its device allocator
+//   arena_shrink(arena, bytes, total_allocated_bytes) a BFC arena freed a region
+//   threadpool_steal(thread_id)                      a worker took a task from the queue of another worker
+//   threadpool_park(thread_id)                       a worker found no work and blocks
+//   threadpool_unpark(thread_id)                     a blocked worker woke up
+//   copy_start(bytes, src_device_type, dst_device_type)  a copy between devices, e.g. at an EP boundary
+//   copy_end(bytes, src_device_type, dst_device_type)    it completed, or was enqueued on a stream if async
+//
+// For example the time of each op type:
+//   bpftrace -e 'usdt:libonnxruntime.so:onnxruntime:node_start { @start[tid] = nsecs; }
+//                usdt:libonnxruntime.so:onnxruntime:node_end /@start[tid]/ {
+//                  @us[str(arg1)] = hist((nsecs - @start[tid]) / 1000); delete(@start[tid]); }'
+
+#if defined(ORT_ENABLE_USDT)
+#include <sys/sdt.h>
+
+#define ORT_TRACEPOINT(name, ...) STAP_PROBEV(onnxruntime, name, __VA_ARGS__)
+#else
+#define ORT_TRACEPOINT(name, ...) \
+  do {                            \
+  } while (false)
+#endif
@@ -40,4 +40,9 @@ struct OrtCUDAProviderOptionsV2 {
   int use_tf32 = 1;                                                                                            // use TF32
   int fuse_conv_bias = 0;                                                                                      // Enable CUDNN Frontend kernel fusing, results in JIT compiles
   int sdpa_kernel = 0;                                                                                         // Scaled Dot Product Attention kernel option
+  int use_cuda_mempool = 0;                                                                                    // use the stream-ordered CUDA memory pool of the device instead of an arena
+  size_t cuda_mempool_release_threshold = 0;                                                                   // bytes the CUDA memory pool keeps cached at synchronization points
+  size_t pinned_staging_buffer_size = 0;                                                                       // size of the two pinned buffers staging pageable host copies of a stream, 0 disables the staging
+  size_t device_mem_limit = 0;                                                                                 // device memory budget shared by the sessions on the device, 0 disables it
+  int device_mem_wait_ms = 0;                                                                                  // time an allocation above the device memory budget waits for memory to be freed
 };
@@ -45,9 +45,16 @@ enum NNAPIFlags {
   // and NNAPI_FLAG_CPU_ONLY flags are set
   NNAPI_FLAG_CPU_ONLY = 0x008,
 
+  // Run the NNAPI model with an ANeuralNetworksBurst, which reduces the latency of a rapid sequence of executions,
+  // such as a model that runs on every frame of a camera stream. It will likely cause overhead for a model that runs
+  // only once.
+  //
+  // This option is only available after Android API level 29, and will be ignored for Android API level 28-
+  NNAPI_FLAG_USE_BURST = 0x010,
+
   // Keep NNAPI_FLAG_LAST at the end of the enum definition
   // And assign the last NNAPIFlag to it
-  NNAPI_FLAG_LAST = NNAPI_FLAG_CPU_ONLY,
+  NNAPI_FLAG_LAST = NNAPI_FLAG_USE_BURST,
 };
 
 #ifdef __cplusplus
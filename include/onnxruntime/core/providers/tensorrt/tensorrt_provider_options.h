@@ -88,4 +88,10 @@ struct OrtTensorRTProviderOptionsV2 {
 
   const char* trt_engine_cache_prefix{nullptr};  // specify engine cache prefix
   int trt_engine_hw_compatible{0};               // Enable hardware compatibility. Default 0 = false, nonzero = true
+  int trt_engine_refit_enable{0};                // Build refittable engines and refit a cached engine when only the
+                                                 // weights of its subgraph have changed. Default 0 = false,
+                                                 // nonzero = true
+  int trt_profile_auto_update_runs{0};           // Record the input shapes of subgraphs with dynamic shape inputs and
+                                                 // every this many runs rebuild their engine in the background with the
+                                                 // most frequent shapes as opt shapes. Default 0 = disabled
 };
@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedInitializerStore;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -79,7 +81,15 @@ class Environment {
    */
   Status UnregisterAllocator(const OrtMemoryInfo& mem_info);
 
-  Environment() = default;
+  /**
+   * Returns the store of initializers shared between the sessions of this env.
+   */
+  SharedInitializerStore* GetSharedInitializerStore() const {
+    return shared_initializer_store_.get();
+  }
+
+  Environment();
+  ~Environment();
 
   /**
    * Create and register an allocator, specified by provider_type, for sharing between multiple sessions.
@@ -99,5 +109,6 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::unique_ptr<SharedInitializerStore> shared_initializer_store_;
 };
 }  // namespace onnxruntime
@@ -304,6 +304,7 @@ ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -725,6 +726,23 @@ typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options
  */
 typedef void (*RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
 
+/** \brief Callback function for OrtApi::BindOutputToAllocatorFn
+ *
+ * Called during the run once the shape of the output is known.
+ *
+ * \param[in] user_data User specific data that passed back to the callback
+ * \param[in] output_name Name of the output
+ * \param[in] shape Dimensions of the output
+ * \param[in] shape_len Number of dimensions
+ * \param[in] size_in_bytes Size of the buffer required for the output
+ * \param[out] buffer Set to a buffer of at least `size_in_bytes` bytes. It remains owned by the caller and must stay
+ *                    valid until the output ::OrtValue is released.
+ * \return nullptr on success, or an ::OrtStatus that fails the run.
+ */
+typedef OrtStatusPtr (*OrtOutputBufferAllocatorFn)(void* user_data, const char* output_name,
+                                                   const int64_t* shape, size_t shape_len,
+                                                   size_t size_in_bytes, void** buffer);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2803,6 +2821,22 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_chunks": Maximum number of freed chunks each thread keeps per size bin in a lock-free
+   *  per-thread cache in front of the arena. Only allocations smaller than 2MB are cached. Chunks held in a thread
+   *  cache are reported as in use. Use 0 to disable the cache or -1 to allow ORT to choose the default (disabled).
+   * "shrink_half_life_ms": Enables amortized shrinking of the arena. The arena keeps a high-water mark of the bytes
+   *  in use that halves every shrink_half_life_ms milliseconds, and frees unused allocation regions that keep the
+   *  total allocated memory above it. This works independently of the "memory.enable_memory_arena_shrinkage"
+   *  run option. Use 0 to disable or -1 to allow ORT to choose the default (disabled).
+   * "huge_page_size": Only relevant for CPU arenas. Size in bytes of the huge pages (e.g. 2MB or 1GB) used to back
+   *  the arena regions. Falls back to regular pages with transparent huge pages requested if no such pages are
+   *  available. Setting initial_chunk_size_bytes and initial_growth_chunk_size_bytes to multiples of this size avoids
+   *  wasting the remainder of the last page of each region. Use 0 or -1 for regular pages (default).
+   * "numa_node": Only relevant for CPU arenas. NUMA node the arena regions are bound to. Typically the node of the
+   *  cores the session's intra-op threads are pinned to. Use -1 for no binding (default).
+   * "enable_tracing": Records the distribution of the requested allocation sizes and the regions the arena allocated,
+   *  with the node that was running when each was allocated, for OrtApi::SessionGetArenaReport. Use 1 to enable,
+   *  0 to disable or -1 to allow ORT to choose the default (disabled).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4386,6 +4420,10 @@ struct OrtApi {
                   _In_reads_(num_keys) const char* const* provider_options_keys, _In_reads_(num_keys) const char* const* provider_options_values, _In_ size_t num_keys);
 
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
+   *
+   * If the "session.async_run_num_threads" session config entry is set, the run is queued on threads dedicated to
+   * RunAsync instead. Input names, inputs and output names are copied, so only `run_options` and `output` need to
+   * remain valid until `run_async_callback` is invoked.
    *
    * \param[in] session
    * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
@@ -4666,6 +4704,217 @@ struct OrtApi {
                   _In_reads_(num_external_initializer_files) char* const* external_initializer_file_buffer_array,
                   _In_reads_(num_external_initializer_files) const size_t* external_initializer_file_lengths,
                   size_t num_external_initializer_files);
+
+  /** \brief Get the aggregated kernel statistics of a session
+   *
+   * Kernel statistics are enabled with the "session.enable_kernel_statistics" session config entry.
+   * They are accumulated across all runs without writing any file, so they can be queried periodically on live
+   * traffic. The result is a JSON array with one object per op type and execution provider with the members
+   * "op_type", "provider", "count", "total_ns", "p50_ns", "p99_ns", "max_ns" and "output_bytes",
+   * ordered by total time.
+   *
+   * \param[in] session
+   * \param[in] reset If non-zero the statistics are cleared after they are read.
+   * \param[in] allocator
+   * \param[out] out Null terminated JSON string, allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetKernelStatistics, _In_ OrtSession* session, _In_ int reset,
+                  _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+  /** \brief Bind an output to a callback that provides the output buffer
+   *
+   * The callback is invoked during OrtApi::RunWithBinding once the output shape is known, so outputs whose shape is
+   * not known ahead of time are written directly into caller owned memory such as network send buffers or shared
+   * memory rings, without a copy. A new buffer is requested on every run.
+   * Only non-string tensor outputs are supported. If the output is produced on a device other than the one of
+   * `mem_info_ptr`, it is allocated by ORT and copied to that device as with OrtApi::BindOutputToDevice.
+   *
+   * \param[in] binding_ptr
+   * \param[in] name Null terminated string of the output name
+   * \param[in] mem_info_ptr Location of the buffers returned by `allocator_fn`
+   * \param[in] allocator_fn
+   * \param[in] user_data Passed to `allocator_fn`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(BindOutputToAllocatorFn, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                  _In_ const OrtMemoryInfo* mem_info_ptr, _In_ OrtOutputBufferAllocatorFn allocator_fn,
+                  _In_opt_ void* user_data);
+
+  /** \brief Create a tensor that is a strided view of a user supplied buffer
+   *
+   * The tensor refers to the buffer without copying it, so views such as a slice of the channels or a transpose of
+   * a larger tensor can be fed to a session directly. Kernels that accept strided inputs read the view in place.
+   * For other kernels ORT makes a contiguous copy of the input when the session is run.
+   * Strided tensors require a build with strided tensor support, e.g. a training build. Other builds only accept
+   * strides that describe a contiguous tensor.
+   *
+   * \param[in] info Memory info of the buffer
+   * \param[in] p_data Pointer to the first element of the view
+   * \param[in] p_data_len Number of bytes that can be read from p_data
+   * \param[in] shape Pointer to the tensor shape dimensions
+   * \param[in] shape_len The number of tensor shape dimensions
+   * \param[in] strides Pointer to the stride of each dimension in elements. Strides must not be negative.
+   * \param[in] strides_len The number of strides. Must match shape_len.
+   * \param[in] type The data type
+   * \param[out] out Returns newly created ::OrtValue. Must be freed with OrtApi::ReleaseValue
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreateTensorWithDataAndStridesAsOrtValue, _In_ const OrtMemoryInfo* info, _Inout_ void* p_data,
+                  size_t p_data_len, _In_ const int64_t* shape, size_t shape_len, _In_ const int64_t* strides,
+                  size_t strides_len, ONNXTensorElementDataType type, _Outptr_ OrtValue** out);
+
+  /** \brief Get the scheduling statistics of the threads of the thread pools used by a session
+   *
+   * The statistics are collected while profiling is enabled, e.g. with OrtApi::EnableProfiling, and accumulate from
+   * the first profiled run. They can be queried at any time without ending profiling. The result is a JSON object
+   * with an "intra_op" and an "inter_op" array holding one object per thread of the pool with the members
+   * "num_runs", "num_steals", "busy_us", "elapsed_us", "steal_rate" (stolen tasks per task run),
+   * "idle_percentage" and "avg_run_us" (average time per task of a parallel section).
+   *
+   * \param[in] session
+   * \param[in] allocator
+   * \param[out] out Null terminated JSON string, allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetThreadPoolStatistics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Set all strings of a string tensor from one contiguous buffer
+   *
+   * The strings are stored back to back in `s` and `offsets` holds the position of each string in it, the last string
+   * ends at `s_len`. This is the layout returned by OrtApi::GetStringTensorContent, so large batches of text can be
+   * fed without building an array of null terminated strings. The strings may contain null characters.
+   *
+   * \param[in] value A tensor created from OrtApi::CreateTensorAsOrtValue with element type
+   * ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING
+   * \param[in] s Buffer holding the bytes of all the strings
+   * \param[in] s_len Number of bytes in `s`
+   * \param[in] offsets Position of each string in `s`, must not decrease
+   * \param[in] offsets_len Number of elements in `offsets`, must match the number of elements of `value`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_reads_bytes_(s_len) const void* s,
+                  size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+
+  /** \brief Warm up a session for a set of input shapes
+   *
+   * The first run of a session for each new input shape searches kernel algorithms, grows the arenas, creates the
+   * memory patterns, captures the graphs of the EPs with graph capture enabled and loads the device code lazily.
+   * This function does all of that ahead of time by running the session on zero filled inputs for each shape set,
+   * so that a service can report readiness only once the session is warm for the shapes it expects.
+   *
+   * The shapes of shape set `s` and input `i` are `shapes[s * num_inputs + i]`, with `shape_lens[s * num_inputs + i]`
+   * dimensions. Inputs that are not listed in `input_names` use their shape from the model, with 1 for the dimensions
+   * that are not fixed. If `num_inputs` is 0 the session is warmed up once for the model shapes.
+   * Only models with tensor inputs are supported.
+   *
+   * \param[in] session
+   * \param[in] run_options Used for the warmup runs. If nullptr, the default run options are used.
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] num_inputs Number of elements in `input_names`
+   * \param[in] shapes Array of `num_shape_sets * num_inputs` pointers to the dimensions of the shapes
+   * \param[in] shape_lens Number of dimensions of each element of `shapes`
+   * \param[in] num_shape_sets Number of shape sets
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionWarmup, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(num_inputs) const char* const* input_names, size_t num_inputs,
+                  _In_reads_(num_shape_sets* num_inputs) const int64_t* const* shapes,
+                  _In_reads_(num_shape_sets* num_inputs) const size_t* shape_lens, size_t num_shape_sets);
+
+  /** \brief Prepare the runs of a session that use the same input and output names
+   *
+   * OrtApi::Run maps the input and output names to the session values on every call. This function does it once,
+   * so that OrtApi::RunPrepared can run with arrays of values only, which matters for models that run in
+   * microseconds. The ::OrtPreparedRun also keeps the buffers the values are passed to the session in, so that a
+   * run does not allocate them. It is tied to the session it was created for and must not be used by concurrent
+   * runs. Models with state tensors and runs with a LoRA adapter are not supported.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in `input_names`
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in `output_names`
+   * \param[out] out Must be freed with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Release an ::OrtPreparedRun obtained from OrtApi::CreatePreparedRun
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /** \brief Run the model with the input and output names of an ::OrtPreparedRun
+   *
+   * Same as OrtApi::Run, with the inputs and outputs in the order of the names given to OrtApi::CreatePreparedRun.
+   * Outputs that are pre-allocated by the caller are filled in place, the others are allocated by the session.
+   *
+   * \param[in] session The session the ::OrtPreparedRun was created for. ORT_INVALID_ARGUMENT is returned for a
+   *     different session.
+   * \param[in] run_options If nullptr, the default run options are used
+   * \param[in] prepared_run
+   * \param[in] inputs Array of ::OrtValue%s of the inputs
+   * \param[in] input_len Number of elements in `inputs`, which must match the number of input names
+   * \param[in,out] outputs Array of ::OrtValue%s that the outputs are stored in. This can also be
+   *     an array of nullptr values, in this case ::OrtValue objects will be allocated and pointers
+   *     to them will be set into the `outputs` array.
+   * \param[in] output_len Number of elements in `outputs`, which must match the number of output names
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run, _In_reads_(input_len) const OrtValue* const* inputs,
+                  size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+  /** \brief Get a report of the state of an arena of a session
+   *
+   * The report is a JSON object with the configuration and the stats of the arena, and for each size bin the chunks
+   * in use, the free chunks and the largest of them, as well as the largest free chunk of the arena and the
+   * fragmentation of its free memory. If the arena was created with the "enable_tracing" key of
+   * OrtApi::CreateArenaCfgV2, the report also holds the histogram of the requested allocation sizes, the regions the
+   * arena allocated with the node that was running when each was allocated, and the failed allocations.
+   * It is meant for choosing "arena_extend_strategy", "initial_chunk_size_bytes" and "max_dead_bytes_per_chunk".
+   *
+   * \param[in] session
+   * \param[in] mem_info The memory info of the arena, e.g. from OrtApi::CreateCpuMemoryInfo
+   * \param[in] allocator The allocator used to allocate the returned string
+   * \param[out] out Null terminated JSON string of the report, to be freed with `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetArenaReport, _In_ const OrtSession* session, _In_ const OrtMemoryInfo* mem_info,
+                  _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
 };
 
 /*
@@ -522,6 +522,7 @@ ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
 ORT_DEFINE_RELEASE(Op);
 ORT_DEFINE_RELEASE(KernelInfo);
+ORT_DEFINE_RELEASE(PreparedRun);
 
 #undef ORT_DEFINE_RELEASE
 
@@ -994,6 +995,7 @@ struct ModelMetadata : detail::Base<OrtModelMetadata> {
 };
 
 struct IoBinding;
+struct PreparedRun;
 
 namespace detail {
 
@@ -1038,6 +1040,23 @@ struct ConstSessionImpl : Base<T> {
   uint64_t GetProfilingStartTimeNs() const;  ///< Wraps OrtApi::SessionGetProfilingStartTimeNs
   ModelMetadata GetModelMetadata() const;    ///< Wraps OrtApi::SessionGetModelMetadata
 
+  /** \brief Returns a copy of the scheduling statistics of the session thread pools as a JSON string.
+   *
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetThreadPoolStatisticsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetThreadPoolStatistics
+
+  /** \brief Returns a copy of the report of the session arena for mem_info as a JSON string.
+   *
+   * \param mem_info memory info of the arena
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetArenaReportAllocated(const OrtMemoryInfo* mem_info, OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetArenaReport
+
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
   TypeInfo GetOutputTypeInfo(size_t index) const;                  ///< Wraps OrtApi::SessionGetOutputTypeInfo
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerTypeInfo
@@ -1076,6 +1095,21 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model with the input and output names of a PreparedRun
+   *
+   * Wraps OrtApi::RunPrepared
+   *
+   * \param[in] run_options
+   * \param[in] prepared_run Created for this session
+   * \param[in] input_values Array of Value objects in the order of the prepared input names
+   * \param[in] input_count Number of elements in input_values
+   * \param[in,out] output_values Array of Value objects in the order of the prepared output names. Empty values are
+   *            allocated by the session, the others are filled in place.
+   * \param[in] output_count Number of elements in output_values
+   */
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
    *
    * Wraps OrtApi::RunAsync
@@ -1105,6 +1139,24 @@ struct SessionImpl : ConstSessionImpl<T> {
    *  The OrtAllocator instances must be valid at the point of memory release.
    */
   AllocatedStringPtr EndProfilingAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionEndProfiling
+
+  /** \brief Returns a copy of the aggregated kernel statistics as a JSON string.
+   *
+   * \param reset clear the statistics after reading them
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetKernelStatisticsAllocated(bool reset, OrtAllocator* allocator);  ///< Wraps OrtApi::SessionGetKernelStatistics
+
+  /** \brief Run the session on zero filled inputs of each shape set, so later runs with these shapes are fast.
+   *
+   * \param[in] run_options
+   * \param[in] input_names The inputs the shapes are given for
+   * \param[in] shapes One vector of shapes per shape set, in the order of input_names
+   */
+  void Warmup(const RunOptions& run_options, const std::vector<const char*>& input_names,
+              const std::vector<std::vector<std::vector<int64_t>>>& shapes);  ///< Wraps OrtApi::SessionWarmup
 };
 
 }  // namespace detail
@@ -1504,6 +1556,15 @@ struct ValueImpl : ConstValueImpl<T> {
   /// <param name="s_len">[in] Count of strings in s (Must match the size of \p value's tensor shape)</param>
   void FillStringTensor(const char* const* s, size_t s_len);
 
+  /// <summary>
+  /// Set all strings at once in a string tensor from one contiguous buffer. Wraps OrtApi::FillStringTensorFromBuffer
+  /// </summary>
+  /// <param name="s">[in] Buffer holding the bytes of all the strings back to back</param>
+  /// <param name="s_len">[in] Number of bytes in s</param>
+  /// <param name="offsets">[in] Position of each string in s, the last string ends at s_len</param>
+  /// <param name="offsets_len">[in] Count of offsets (Must match the size of \p value's tensor shape)</param>
+  void FillStringTensorFromBuffer(const void* s, size_t s_len, const size_t* offsets, size_t offsets_len);
+
   /// <summary>
   /// Set a single string in a string tensor
   /// </summary>
@@ -1647,6 +1708,21 @@ struct Value : detail::ValueImpl<OrtValue> {
   static Value CreateTensor(const OrtMemoryInfo* info, void* p_data, size_t p_data_byte_count, const int64_t* shape, size_t shape_len,
                             ONNXTensorElementDataType type);
 
+  /** \brief Creates a tensor that is a strided view of a user supplied buffer.
+   * Wraps OrtApi::CreateTensorWithDataAndStridesAsOrtValue.
+   *
+   * \param info Memory description of where the p_data buffer resides (CPU vs GPU etc).
+   * \param p_data Pointer to the first element of the view.
+   * \param p_data_byte_count The number of bytes that can be read from p_data.
+   * \param shape Pointer to the tensor shape dimensions.
+   * \param shape_len The number of tensor shape dimensions.
+   * \param strides Pointer to the stride of each dimension in elements.
+   * \param strides_len The number of strides.
+   * \param type The data type.
+   */
+  static Value CreateTensor(const OrtMemoryInfo* info, void* p_data, size_t p_data_byte_count, const int64_t* shape, size_t shape_len,
+                            const int64_t* strides, size_t strides_len, ONNXTensorElementDataType type);
+
   /** \brief Creates an OrtValue with a tensor using a supplied OrtAllocator. Wraps OrtApi::CreateTensorAsOrtValue.
    *         This overload will allocate the buffer for the tensor  according to the supplied shape and data type.
    *         The allocated buffer will be owned by the returned OrtValue and will be freed when the OrtValue is released.
@@ -1847,6 +1923,8 @@ struct IoBindingImpl : ConstIoBindingImpl<T> {
   void BindInput(const char* name, const Value&);
   void BindOutput(const char* name, const Value&);
   void BindOutput(const char* name, const OrtMemoryInfo*);
+  void BindOutput(const char* name, const OrtMemoryInfo*, OrtOutputBufferAllocatorFn allocator_fn,
+                  void* user_data);  ///< Wraps OrtApi::BindOutputToAllocatorFn
   void ClearBoundInputs();
   void ClearBoundOutputs();
   void SynchronizeInputs();
@@ -1868,6 +1946,17 @@ struct IoBinding : detail::IoBindingImpl<OrtIoBinding> {
   UnownedIoBinding GetUnowned() const { return UnownedIoBinding{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtPreparedRun
+ *
+ * Resolves the input and output names of a session once, for the runs that use them repeatedly.
+ * Must not be used by concurrent runs.
+ */
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}  ///< Create an empty object for convenience. Sometimes, we want to initialize members later.
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);  ///< Wraps OrtApi::CreatePreparedRun
+};
+
 /*! \struct Ort::ArenaCfg
  * \brief it is a structure that represents the configuration of an arena based allocator
  * \details Please see docs/C_API.md for details
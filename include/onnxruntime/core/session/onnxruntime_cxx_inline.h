@@ -346,6 +346,12 @@ inline void IoBindingImpl<T>::BindOutput(const char* name, const OrtMemoryInfo*
   ThrowOnError(GetApi().BindOutputToDevice(this->p_, name, mem_info));
 }
 
+template <typename T>
+inline void IoBindingImpl<T>::BindOutput(const char* name, const OrtMemoryInfo* mem_info,
+                                         OrtOutputBufferAllocatorFn allocator_fn, void* user_data) {
+  ThrowOnError(GetApi().BindOutputToAllocatorFn(this->p_, name, mem_info, allocator_fn, user_data));
+}
+
 template <typename T>
 inline void IoBindingImpl<T>::ClearBoundInputs() {
   GetApi().ClearBoundInputs(this->p_);
@@ -434,6 +440,11 @@ inline IoBinding::IoBinding(Session& session) {
   ThrowOnError(GetApi().CreateIoBinding(session, &this->p_));
 }
 
+inline PreparedRun::PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(GetApi().CreatePreparedRun(session, input_names, input_count, output_names, output_count, &this->p_));
+}
+
 inline ArenaCfg::ArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes, int max_dead_bytes_per_chunk) {
   ThrowOnError(GetApi().CreateArenaCfg(max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk, &p_));
 }
@@ -1004,6 +1015,21 @@ inline uint64_t ConstSessionImpl<T>::GetProfilingStartTimeNs() const {
   return out;
 }
 
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetThreadPoolStatisticsAllocated(OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetThreadPoolStatistics(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetArenaReportAllocated(const OrtMemoryInfo* mem_info,
+                                                                       OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetArenaReport(this->p_, mem_info, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
 template <typename T>
 inline ModelMetadata ConstSessionImpl<T>::GetModelMetadata() const {
   OrtModelMetadata* out;
@@ -1057,6 +1083,16 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline void SessionImpl<T>::Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values,
+                                size_t input_count, Value* output_values, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunPrepared(this->p_, run_options, prepared_run, ort_input_values, input_count,
+                                    ort_output_values, output_count));
+}
+
 template <typename T>
 inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                      const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
@@ -1074,6 +1110,31 @@ inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* al
   return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
 }
 
+template <typename T>
+inline AllocatedStringPtr SessionImpl<T>::GetKernelStatisticsAllocated(bool reset, OrtAllocator* allocator) {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetKernelStatistics(this->p_, reset ? 1 : 0, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline void SessionImpl<T>::Warmup(const RunOptions& run_options, const std::vector<const char*>& input_names,
+                                   const std::vector<std::vector<std::vector<int64_t>>>& shapes) {
+  std::vector<const int64_t*> shape_ptrs;
+  std::vector<size_t> shape_lens;
+  for (const auto& shape_set : shapes) {
+    if (shape_set.size() != input_names.size()) {
+      ORT_CXX_API_THROW("Each shape set must have a shape for every input name", ORT_INVALID_ARGUMENT);
+    }
+    for (const auto& shape : shape_set) {
+      shape_ptrs.push_back(shape.data());
+      shape_lens.push_back(shape.size());
+    }
+  }
+  ThrowOnError(GetApi().SessionWarmup(this->p_, run_options, input_names.data(), input_names.size(),
+                                      shape_ptrs.data(), shape_lens.data(), shapes.size()));
+}
+
 }  // namespace detail
 
 inline SessionOptions::SessionOptions() {
@@ -1451,6 +1512,11 @@ void ValueImpl<T>::FillStringTensor(const char* const* s, size_t s_len) {
   ThrowOnError(GetApi().FillStringTensor(this->p_, s, s_len));
 }
 
+template <typename T>
+void ValueImpl<T>::FillStringTensorFromBuffer(const void* s, size_t s_len, const size_t* offsets, size_t offsets_len) {
+  ThrowOnError(GetApi().FillStringTensorFromBuffer(this->p_, s, s_len, offsets, offsets_len));
+}
+
 template <typename T>
 void ValueImpl<T>::FillStringTensorElement(const char* s, size_t index) {
   ThrowOnError(GetApi().FillStringTensorElement(this->p_, s, index));
@@ -1547,6 +1613,14 @@ inline Value Value::CreateTensor(const OrtMemoryInfo* info, void* p_data, size_t
   return Value{out};
 }
 
+inline Value Value::CreateTensor(const OrtMemoryInfo* info, void* p_data, size_t p_data_byte_count, const int64_t* shape, size_t shape_len,
+                                 const int64_t* strides, size_t strides_len, ONNXTensorElementDataType type) {
+  OrtValue* out;
+  ThrowOnError(GetApi().CreateTensorWithDataAndStridesAsOrtValue(info, p_data, p_data_byte_count, shape, shape_len,
+                                                                 strides, strides_len, type, &out));
+  return Value{out};
+}
+
 template <typename T>
 inline Value Value::CreateTensor(OrtAllocator* allocator, const int64_t* shape, size_t shape_len) {
   return CreateTensor(allocator, shape, shape_len, TypeToTensorType<T>::type);
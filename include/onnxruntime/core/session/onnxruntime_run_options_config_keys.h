@@ -40,6 +40,11 @@ static const char* const kOrtRunOptionsConfigQnnPerfMode = "qnn.htp_perf_mode";
 // Set HTP performance mode for QNN HTP backend post session run.
 static const char* const kOrtRunOptionsConfigQnnPerfModePostRun = "qnn.htp_perf_mode_post_run";
 
+// Delay in milliseconds of the qnn.htp_perf_mode_post_run vote. The vote happens only if no other run starts on the
+// same thread within the delay, so a burst of runs stays at qnn.htp_perf_mode without voting around every run.
+// Default to "0", which votes the post-run mode at the end of each run.
+static const char* const kOrtRunOptionsConfigQnnPerfModePostRunIdleTimeout = "qnn.htp_perf_mode_post_run_idle_timeout_ms";
+
 // Set RPC control latency for QNN HTP backend
 static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_control_latency";
 
@@ -54,3 +59,28 @@ static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id
 // “Default”: OS determines the scheduling priority and processor performance to service this workload. [Default]
 // “Efficient”: OS treats this workload is efficiency oriented with low scheduling priority and efficient processor performance.
 static const char* const kOrtRunOptionsWorkloadType = "run.workload_type";
+
+// Drop the state tensors kept by a session created with "session.state_tensors" before running, e.g. at the start of
+// a new stream.
+// Option values:
+// - "0": Feed the states of the previous run. [DEFAULT]
+// - "1": Start from the states fed by the caller or the initializers.
+static const char* const kOrtRunOptionsConfigResetStateTensors = "run.reset_state_tensors";
+
+// Name of the LoRA adapter set, registered with InferenceSession::AddLoraAdapter, that feeds the adapter inputs of
+// the graph in this run. The inputs fed by the caller take precedence. [DEFAULT: "", no adapter]
+static const char* const kOrtRunOptionsConfigLoraAdapter = "run.lora_adapter";
+
+// Maximum number of threads, including the calling thread, that a parallel loop of the CPU kernels may use in this
+// run, e.g. to run offline batches on fewer cores than the latency critical runs of the same session. It can only
+// lower the limit set for the session. Applies to the loops run on the calling thread, which are all of them with
+// the sequential execution mode. [DEFAULT: "0", no limit]
+static const char* const kOrtRunOptionsConfigIntraOpNumThreads = "run.intra_op_num_threads";
+
+// Scheduling class of the parallel loops of this run in the intra-op thread pool. While a run of high priority is in
+// progress, the loops of the runs of normal priority using the same threads enlist at most half of them.
+// Option values:
+// - "": Use the priority of the session, see kOrtSessionOptionsConfigSharedIntraOpPoolPriority. [DEFAULT]
+// - "normal"
+// - "high"
+static const char* const kOrtRunOptionsConfigIntraOpPriority = "run.intra_op_priority";
@@ -96,6 +96,18 @@ static const char* const kOrtSessionOptionsMemoryOptimizerApplyConfig = "optimiz
 // Specifies the config for detecting subgraphs for memory footprint reduction.
 // The value should be a string contains int separated using commas. The default value is "0:0".
 static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimization.enable_memory_probe_recompute_config";
+
+// Specifies a memory budget in MB for the activations stashed for the backward pass, to choose the subgraphs to
+// recompute automatically instead of with "optimization.memory_optimizer_config", which takes precedence if set.
+// The subgraphs found with the probe config that bring the activations within the budget with the least recompute
+// work are applied, and the chosen configs are logged in the format of the config file. "0" recomputes all of them.
+// The default value is "", no budget.
+static const char* const kOrtSessionOptionsMemoryOptimizerBudgetMB = "optimization.memory_optimizer_budget_mb";
+
+// Specifies the values of the symbolic dimensions of the activations, used to compute their sizes for the memory
+// budget, e.g. "batch_size=8,sequence_length=512". If a size depends on a dimension without a value, the budget is
+// ignored with a warning.
+static const char* const kOrtSessionOptionsMemoryOptimizerDimValues = "optimization.memory_optimizer_dim_values";
 #endif
 
 // This setting if set should contain a comma separated list of optimizers names that should be disabled.
@@ -111,6 +123,14 @@ static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimiz
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Size in bytes of the chunks in which the external data of initializers placed on a non-CPU device is loaded, e.g.
+// "67108864". The file is read in chunks that are copied to the device while the next chunk is read, instead of
+// mapping the whole initializer into CPU memory before copying it, so that loading needs little CPU memory and the
+// reads overlap with the copies.
+// "0": map the whole initializer into CPU memory. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsDeviceInitializerLoadChunkSize =
+    "session.device_initializer_load_chunk_size";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
@@ -166,6 +186,12 @@ static const char* const kOrtSessionOptionsConfigMinimalBuildOptimizations =
 // exclusion, set the value to "".
 static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "ep.nnapi.partitioning_stop_ops";
 
+// Specifies a directory the NNAPI EP lets the NNAPI drivers cache the compiled models in, so that a later session
+// with the same model skips most of the compilation. The directory must exist and be writable by the application,
+// e.g. the directory returned by Context.getCodeCacheDir().
+// Only available after Android API level 29. If not specified or empty, the compiled models are not cached.
+static const char* const kOrtSessionOptionsConfigNnapiEpCacheDir = "ep.nnapi.cache_dir";
+
 // Enabling dynamic block-sizing for multithreading.
 // With a positive value, thread pool will split a task of N iterations to blocks of size starting from:
 // N / (num_of_threads * dynamic_block_base)
@@ -269,6 +295,16 @@ static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed
 // in case user need to merge/connect multiple EPContext nodes in one model
 static const char* const kOrtSessionOptionEpContextNodeNamePrefix = "ep.context_node_name_prefix";
 
+// Share the EP contexts across the sessions in the process that set this option, e.g. the prefill and decode graphs of
+// an LLM that use the same weights.
+// When generating EP context models, the graphs of all the sessions are created in one context, so the context binary
+// dumped by the last session contains all the graphs with a single copy of the weights.
+// When loading EP context models, the graphs of a context binary that aren't used by the session loading it are kept
+// for the sessions created later, which use them instead of loading the binary again.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_contexts";
+
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
@@ -284,3 +320,417 @@ static const char* const kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel = "sessio
 // “Default”: OS determines the scheduling priority and processor performance to service this workload. [Default]
 // “Efficient”: OS treats this workload is efficiency oriented with low scheduling priority and efficient processor performance.
 static const char* const kOrtSessionOptionsWorkloadType = "session.workload_type";
+
+// Round the input dimensions up to a multiple of this value when looking up cached memory patterns, so inputs
+// whose shapes fall into the same bucket (e.g. sequence lengths 65..128 with a value of "64") share one pattern.
+// A pattern traced for a smaller shape in the bucket is re-traced the first time a larger shape does not fit it.
+// Only has an effect when memory pattern optimization is enabled.
+// Default is "0", which disables bucketing so patterns are only reused for identical input shapes.
+static const char* const kOrtSessionOptionsMemoryPatternShapeBucketSize = "session.memory_pattern_shape_bucket_size";
+
+// Path of a file to persist memory patterns to. If set, the patterns in the file are loaded when the session is
+// initialized and the file is rewritten whenever a new pattern is generated, so a restarted process can reuse the
+// patterns of a previous one instead of tracing them again. Typically placed next to the ORT format model.
+// The file is ignored if it was produced for a different model or bucket size.
+static const char* const kOrtSessionOptionsMemoryPatternFilePath = "session.memory_pattern_file_path";
+
+// Plan the memory of all intermediate tensors when the session is initialized if every graph input has a static
+// shape. Offsets for all tensors with static shapes are computed up front so even the first run uses a single
+// pre-allocated buffer per device instead of per-node arena calls. Requires memory pattern optimization.
+// Option values:
+// - "0": Memory patterns are traced during the first run for each set of input shapes. [DEFAULT]
+// - "1": Memory patterns are planned statically at initialization when possible.
+static const char* const kOrtSessionOptionsStaticMemoryPlanning = "session.static_memory_planning";
+
+// Collect aggregated per op type kernel statistics (call count, latency percentiles, output bytes) on every run.
+// Unlike profiling no events are recorded and no file is written, so it is intended to stay enabled in production.
+// The statistics are retrieved with OrtApi::SessionGetKernelStatistics.
+// Option values:
+// - "0": Kernel statistics are not collected. [DEFAULT]
+// - "1": Kernel statistics are collected.
+static const char* const kOrtSessionOptionsEnableKernelStatistics = "session.enable_kernel_statistics";
+
+// Number of threads dedicated to OrtApi::RunAsync. Queued runs are executed on these threads instead of the
+// intra-op thread pool, so they neither take threads away from the kernels of other runs nor require the
+// intra-op thread pool to have more than one thread. Runs beyond the number of threads are queued.
+// Default is "0", which runs RunAsync requests on the intra-op thread pool.
+static const char* const kOrtSessionOptionsAsyncRunNumThreads = "session.async_run_num_threads";
+
+// Batch concurrent Run calls of the session. Requests with the same input and output names and the same input shapes
+// apart from the first dimension are concatenated along the first dimension, executed as one run and each caller
+// receives a view of its rows of the outputs. Requires all model inputs and outputs to share a symbolic first
+// dimension. Only Run calls without pre-allocated outputs are batched.
+// The value is the maximum number of rows in a batch. Default is "0", which disables batching.
+static const char* const kOrtSessionOptionsRequestBatchingMaxBatchSize = "session.request_batching_max_batch_size";
+
+// Maximum time in microseconds a batched Run call waits for other calls to join its batch. Default is "1000".
+static const char* const kOrtSessionOptionsRequestBatchingMaxDelayUs = "session.request_batching_max_delay_us";
+
+// Share constant initializers stored as external data with the other sessions of the environment that enable it.
+// Initializers are memory mapped from the external data file and deduplicated by a hash of their content, so
+// sessions of the same model or of models with common weights use a single copy regardless of the file they were
+// loaded from. Only applies to initializers placed on CPU.
+// Option values:
+// - "0": Each session holds its own initializers. [DEFAULT]
+// - "1": Identical external initializers are shared through the environment.
+static const char* const kOrtSessionOptionsShareInitializersWithEnv = "session.share_initializers_with_env";
+
+// Path of a file to persist the pre-packed weights of CPU kernels to. If set, kernels that support it use the
+// weights in the file instead of packing their constant initializers again when the session is initialized, and
+// weights that are not in the file yet are added to it. The file is memory mapped, so the packed weights are paged
+// in on demand. It is ignored and rewritten if it was produced by another ORT version or for a CPU with different
+// features. Sessions using the same file should use the same session options that affect kernels, such as
+// "mlas.enable_gemm_fastmath_arm64_bfloat16".
+// Has no effect on initializers that use the pre-packed weights container shared between sessions.
+static const char* const kOrtSessionOptionsPrepackedWeightsFilePath = "session.prepacked_weights_file_path";
+
+// Release the resident memory of cold initializers. Constant initializers with external data on CPU are memory
+// mapped, so their pages are only read from the file when a kernel first accesses them. If set to N > 0, every N
+// runs the pages of the initializers that no kernel used in the last N runs, e.g. the rarely selected experts of a
+// mixture of experts model, are returned to the OS. They are read from the file again on their next use.
+// Initializers that were pre-packed are not tracked as the packed copy is used instead.
+// Default is "0", which keeps the pages of the initializers resident once accessed.
+static const char* const kOrtSessionOptionsEvictColdInitializersAfterRuns = "session.evict_cold_initializers_after_runs";
+
+// Use the intra-op thread pool to initialize the session. Initializers are deserialized, and the kernels of the CPU
+// EP are created and pre-pack their constant initializers, in parallel. Graph partitioning and optimization stay
+// sequential. Custom CPU kernels must support being constructed and pre-packed concurrently.
+// Option values:
+// - "0": Initialize the session sequentially. [DEFAULT]
+// - "1": Initialize the session using the intra-op thread pool.
+static const char* const kOrtSessionOptionsParallelInitialization = "session.parallel_initialization";
+
+// Path of a file to persist the execution plan of the main graph to. If the file contains the plan of the same
+// partitioned graph and session options that affect planning, the session restores the plan instead of running the
+// allocation planner, otherwise it writes the plan it computes to the file. Only plans without synchronization
+// between streams are persisted, e.g. the plans of models that run on the CPU EP only.
+// Sessions using the same file should register the same execution providers and custom op libraries.
+static const char* const kOrtSessionOptionsExecutionPlanSnapshotFilePath = "session.execution_plan_snapshot_file_path";
+
+// Limit in bytes for the peak memory of the intermediate tensors of the main graph. Requires every graph input to
+// have a static shape and all nodes to run on a single stream. The peak of the plan is computed when the session is
+// initialized and, if it is over the budget, the nodes are reordered using the other available topological order
+// and the plan with the smaller peak is kept. Session initialization fails if no plan stays within the budget.
+// Memory patterns are planned statically, as with "session.static_memory_planning".
+// Initializers, and tensors whose shape is only known at runtime, are not counted.
+// Default is "0", which disables the budget.
+static const char* const kOrtSessionOptionsMemoryBudgetBytes = "session.memory_budget_bytes";
+
+// Order the nodes of each graph to keep the memory of the live intermediate tensors small instead of using the
+// topological order of the execution order. At each step the node that grows the live set the least is run next,
+// using the sizes the allocation planner knows from the static shapes (symbolic dimensions count as 1).
+// The chosen order is included in the allocation plan dump. Ignored with the memory efficient execution order.
+// Option values:
+// - "0": Use the topological order of the execution order. [DEFAULT]
+// - "1": Use the memory aware node order.
+static const char* const kOrtSessionOptionsMemoryAwareNodeOrder = "session.memory_aware_node_order";
+
+// Bind the threads of the intra-op thread pool of the session to the performance cores (P-cores) of a hybrid CPU,
+// e.g. for latency critical sessions on Intel CPUs with P-cores and E-cores or ARM big.LITTLE CPUs. If the number of
+// intra-op threads is not set, the pool gets one thread per P-core, otherwise it is capped to the number of P-cores.
+// The thread calling Run is not bound. Has no effect on CPUs whose cores are all the same.
+// Cannot be combined with "session.intra_op_thread_affinities".
+// Option values:
+// - "0": Use all the cores. [DEFAULT]
+// - "1": Use the performance cores only.
+static const char* const kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly = "session.intra_op.performance_cores_only";
+
+// Adapt how long the threads of the intra-op thread pool spin after running out of work to the idle time each of them
+// observed between its previous tasks. Threads keep spinning through the short gaps between the parallel sections
+// of back-to-back ops, and block right away when the gaps are long, e.g. between requests at a low rate.
+// Only applies when "session.intra_op.allow_spinning" is "1".
+// Option values:
+// - "0": Spin for a fixed number of iterations before blocking. [DEFAULT]
+// - "1": Adapt the spin to the observed idle time.
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
+// Limit the number of threads, including the thread calling Run, that the loops of the session use from the global
+// intra-op thread pool of the env. Lets several sessions share the global pool without one of them taking all of it.
+// Only applies when the session uses the global thread pools ("session.use_per_session_threads" disabled).
+// Option values:
+// - "0": No limit. [DEFAULT]
+// - "N": Use at most N threads.
+static const char* const kOrtSessionOptionsConfigSharedIntraOpPoolQuota = "session.intra_op.shared_pool_quota";
+
+// Priority of the session in the global intra-op thread pool of the env. While a Run of a high priority session is
+// in progress, the loops of the normal priority sessions sharing the pool use at most half of its threads, leaving
+// the rest to the high priority session. Tasks already queued are not preempted.
+// Only applies when the session uses the global thread pools ("session.use_per_session_threads" disabled).
+// Option values:
+// - "normal": [DEFAULT]
+// - "high": Shrink the share of the normal priority sessions while this session runs.
+static const char* const kOrtSessionOptionsConfigSharedIntraOpPoolPriority = "session.intra_op.shared_pool_priority";
+
+// On machines with several NUMA nodes, when the threads of the intra-op thread pool are bound to the cores
+// automatically (the thread pool size is not set), the threads of each node work on a contiguous part of the
+// iterations of each parallel loop. This option controls whether an idle thread may also steal queued work from the
+// threads of another node.
+// Option values:
+// - "0": Steal from the threads of any node.
+// - "1": Steal from the threads of the same node only. [DEFAULT]
+static const char* const kOrtSessionOptionsConfigIntraOpNumaLocalStealing = "session.intra_op.numa_local_stealing";
+
+// Measure the cost per iteration of the parallel loops of each kernel of the intra-op thread pool at runtime, and use
+// it instead of the static estimate of the kernel to choose the block size and the number of threads of the later
+// calls. Keeps small loops on the calling thread when the estimate of the kernel is too high. A few calls to each
+// loop, and a small sample of the calls after that, are timed.
+// Option values:
+// - "0": Use the cost estimated by the kernels. [DEFAULT]
+// - "1": Calibrate the costs at runtime.
+static const char* const kOrtSessionOptionsConfigIntraOpCalibrateLoopCosts = "session.intra_op.calibrate_loop_costs";
+
+// Keep one parallel section of the intra-op thread pool open across each run of consecutive CPU nodes of the
+// sequential executor, so the threads summoned by the parallel loop of a node stay with the next nodes instead of
+// being woken up and joined again at every node. This helps chains of small element-wise ops. The threads of the
+// section spin between the parallel loops of the nodes, so it uses more CPU time while a run is in progress.
+// Option values:
+// - "0": Each node uses its own parallel section. [DEFAULT]
+// - "1": Consecutive CPU nodes share a parallel section.
+static const char* const kOrtSessionOptionsChainParallelSections = "session.chain_parallel_sections";
+
+// Divide the threads of the intra-op thread pool equally among the threads that run parallel loops on it at the same
+// time, instead of letting the parallel loop of each kernel enlist all of them. With parallel execution the kernels
+// run on the inter-op threads, and without this their nested loops oversubscribe the cores. Concurrent calls to Run
+// share the threads the same way.
+// Option values:
+// - "0": Each parallel loop may enlist all the threads. [DEFAULT for sequential execution]
+// - "1": Concurrent callers share the threads. [DEFAULT for parallel execution]
+static const char* const kOrtSessionOptionsConfigIntraOpLeaseWorkersToCallers = "session.intra_op.lease_workers_to_callers";
+
+// Gemm fastmath mode for x64 provides fp32 gemm acceleration with bfloat16 based matmul on the AMX-BF16 tiles.
+// The weights of MatMul are converted to bfloat16 and packed once. The option has no effect on processors without
+// AMX-BF16 support.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathX64Bfloat16 = "mlas.enable_gemm_fastmath_x64_bfloat16";
+
+// Compute the MatMul of a small constant B input (N <= 64 and K <= 256) with GEMM kernels specialized to the shape
+// of B. The column blocks and row unrolling of the kernel are selected once when the weights are prepacked, instead
+// of at every call, and the kernel of each shape is cached and shared across the sessions of the process. B is then
+// kept unpacked. Larger weights keep using the general packed kernels.
+// Option values:
+// - "0": Use the general kernels. [DEFAULT]
+// - "1": Use the shape specialized kernels for small weights.
+static const char* const kOrtSessionOptionsMlasShapeSpecializedGemm = "mlas.enable_shape_specialized_gemm";
+
+// Compute the float Conv of a constant 3x3 filter with unit strides and dilations using the Winograd F(4x4, 3x3)
+// algorithm, which needs 36 instead of 144 multiplies per 4x4 output tile. The filter is transformed once when the
+// weights are prepacked. The results differ from the GEMM based algorithms in the rounding of the transforms.
+// Option values:
+// - "0": Use the GEMM based algorithms. [DEFAULT]
+// - "1": Use the Winograd algorithm for 3x3 convolutions with at least 16 input channels and filters per group.
+static const char* const kOrtSessionOptionsMlasConvWinograd = "mlas.enable_conv_winograd";
+
+// Quantize the constant filter of the float Conv to 4 or 8 bits with one scale per block of 32 elements when the
+// weights are prepacked. The filter is dequantized a block of rows at a time inside the im2col/GEMM loop, so the
+// weight memory shrinks by 4 to 8 times while the activations stay in float. The results differ from the float
+// filter by the quantization error. Convolutions with a kernel of more than 3 dimensions keep the float filter.
+// Option values:
+// - "0": Keep the float filter. [DEFAULT]
+// - "4": Quantize the filter to 4 bits.
+// - "8": Quantize the filter to 8 bits.
+static const char* const kOrtSessionOptionsMlasConvWeightOnlyQuantizationBits = "mlas.conv_weight_only_quantization_bits";
+
+// Enable TunableOp for the CPU execution provider. The kernels with several MLAS algorithms, such as the float Conv,
+// use the algorithm recorded in the tuning results for the shape, and the fixed heuristics otherwise. The tuning
+// results can be embedded in the model so that they are loaded, and TunableOp enabled, when the session is created.
+// Option values:
+// - "0": Use the fixed heuristics. [DEFAULT]
+// - "1": Use the tuning results.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Time the candidate MLAS algorithms of the CPU execution provider on the first run of each shape and record the
+// fastest in the tuning results, which can be retrieved from the session and embedded in the model. Implies
+// "session.cpu_tunable_op_enable".
+// Option values:
+// - "0": Only use the existing tuning results. [DEFAULT]
+// - "1": Tune the shapes without tuning results.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// The maximum time in milliseconds spent profiling each candidate algorithm when tuning a shape on the CPU.
+// "0" means no limit other than the maximum number of iterations. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs = "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Directory holding TreeEnsembleRegressor and TreeEnsembleClassifier models compiled into native code. Each
+// ensemble is turned into straight-line branches with the thresholds as immediates and named after a hash of that
+// code. If the directory holds the matching shared library, the kernel calls it instead of walking the trees.
+// Otherwise the kernel writes the C source into the directory and interprets the trees. Compile the source into a
+// shared library, e.g. with "cc -O2 -shared -fPIC", and later sessions will use it.
+// The library is loaded and run unchecked, so the directory must be trusted.
+// An empty value disables compilation. [DEFAULT: ""]
+static const char* const kOrtSessionOptionsTreeEnsembleCompiledDir = "session.tree_ensemble_compiled_dir";
+
+// Graph outputs that are fed back to graph inputs by the next Run, e.g. the hidden and cell states of a streaming
+// LSTM. The value is a ';' separated list of "<output name>:<input name>" pairs. The session keeps the last value of
+// each output, on the device consuming the input, and feeds it to the input when the caller does not. Until the
+// first Run, or after a Run with "run.reset_state_tensors", the input must be fed by the caller or have an
+// initializer. The outputs are still returned when requested, but not into pre-allocated buffers.
+// Runs of such a session are serialized. [DEFAULT: ""]
+static const char* const kOrtSessionOptionsStateTensors = "session.state_tensors";
+
+// Selects the boxes of the CPU NonMaxSuppression with the sorted bitmask algorithm. The candidates of a class are
+// sorted by score and the overlaps of all the pairs are computed in parallel as one bit per pair, then the selection
+// only combines bitmasks. This is faster than the greedy selection when many boxes are selected, which compares
+// every candidate with the boxes selected so far. Classes with more than 16384 candidates use the greedy selection.
+// Both give the same result.
+// Option values:
+// - "0": Greedy selection, with the classes selected in parallel. [DEFAULT]
+// - "1": Sorted bitmask selection.
+static const char* const kOrtSessionOptionsNonMaxSuppressionSortedBitmask = "session.nms_sorted_bitmask";
+
+// Fuses the chains of float elementwise operators left by the other Level 2 optimizations on the CPU and CUDA EPs,
+// e.g. the Mul/Add/Sub/Div/Sigmoid/Tanh sequences of models exported from PyTorch, into com.microsoft.FusedElementwise
+// nodes that compute a whole chain in one pass over memory, with a single kernel launch on CUDA where float16 chains
+// are fused too. All the intermediate results of a chain must have the shape of its output, and its other inputs must
+// have that shape or a single element.
+// Option values:
+// - "0": Disable the fusion. [DEFAULT]
+// - "1": Enable the fusion.
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
+
+// Computes the attention scores of the CPU QAttention with u8 x s8 GEMMs. Q, K and V of every head are quantized
+// per head after the input projection, Q x K' and the probabilities x V run as int8 GEMMs, and the softmax
+// probabilities are requantized to 8 bits with a scale of 1/255. The results differ from the float scores by the
+// quantization error. Attention with a past state, unidirectional attention, and masks other than the key lengths
+// (batch_size) or the raw mask (batch_size, sequence_length) keep the float scores.
+// Option values:
+// - "0": Compute the scores in float. [DEFAULT]
+// - "1": Compute the scores with int8 GEMMs.
+static const char* const kOrtSessionOptionsQAttentionInt8Scores = "mlas.qattention_int8_scores";
+
+// Number of graphs captured by the graph capture EP (e.g. the CUDA EP with enable_cuda_graph) for the runs that do
+// not set "gpu_graph_id". The session captures one graph per distinct set of input shapes and output names, with the
+// graph annotation ids picked by the session from 1 up, and releases the least recently used graph when a new shape
+// comes in after the limit. The inputs are copied into buffers staged on their devices for every shape, and the
+// outputs of a replay are copied out of the buffers of the captured graph, so the caller does not need to bind
+// inputs and outputs at fixed addresses. Runs with inputs that are not tensors are not captured, and runs with an
+// IOBinding keep the "gpu_graph_id" behavior. The replays are serialized. A value of "0" disables the automatic
+// capture. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsGraphCaptureMaxShapes = "session.graph_capture_max_shapes";
+
+// Maximum number of streams the nodes assigned to one non-CPU device are spread over when the session does not load
+// a partition config from "session.node_partition_config_file". A node continues the stream of its first producer on
+// the device unless another consumer already did, so independent branches, e.g. the towers of a multi-tower model or
+// the members of an ensemble, start new streams and overlap on the device, with events synchronizing the streams
+// where the branches meet. Once the limit is reached a new branch goes to the stream with the lowest estimated cost,
+// which is the number of output elements known from the static shapes. EPs that run all their streams on a single
+// stream, e.g. the CUDA EP with a user compute stream or CUDA graphs, keep executing sequentially.
+// [DEFAULT: "1"]
+static const char* const kOrtSessionOptionsMaxStreamsPerDevice = "session.max_streams_per_device";
+
+// Enables the fusion of a MatMul of two tensors dequantized from float 8 with per tensor scales,
+// DequantizeLinear(float8) -> MatMul <- DequantizeLinear(float8), into a GemmFloat8 on the CUDA EP, which reads the
+// float 8 tensors directly with cuBLASLt and applies the scales in the GEMM. The second input must be a constant
+// 2D initializer, which is transposed once since cuBLASLt only supports float 8 GEMMs with a transposed B. The fused
+// kernel requires a GPU with float 8 tensor cores (compute capability 8.9 or higher), so the fusion is opt-in.
+// Option values:
+// - "0": Keep the DequantizeLinear nodes and the MatMul. [DEFAULT]
+// - "1": Fuse into GemmFloat8.
+static const char* const kOrtSessionOptionsEnableDQMatMulFloat8Fusion = "optimization.enable_dq_matmul_float8_fusion";
+
+// Path of a file that persists tuning results across sessions and process restarts, e.g. the convolution
+// algorithms found by the cuDNN algorithm search of the CUDA EP ("cudnn_conv_algo_search") and the TunableOp
+// results. The results in the file are loaded when the session is initialized, as if they were embedded in the
+// "tuning_results" model metadata, and results that fail the validation of their EP, e.g. because of a different
+// GPU, CUDA or cuDNN version, are ignored. The results of the session, including the loaded ones, are written back
+// to the file when the session is destroyed. The file does not need to exist on the first run.
+static const char* const kOrtSessionOptionsTuningResultsFile = "session.tuning_results_file";
+
+// Directory where the CoreML EP keeps the compiled CoreML models (.mlmodelc) across sessions and process restarts.
+// A compiled model is named after a hash of the CoreML model created from the ONNX nodes and of the OS version, so a
+// later session with the same nodes loads it instead of compiling the model again.
+// Must be set before the CoreML EP is appended to the session options.
+// An empty value disables the cache. [DEFAULT: ""]
+static const char* const kOrtSessionOptionsCoreMLModelCacheDir = "ep.coreml.model_cache_dir";
+
+// Minimum number of nodes in a partition assigned to an EP other than the CPU EP. The nodes of a smaller partition
+// are left to the next EP in the priority order, usually the CPU EP, as copying the inputs and outputs of a small
+// partition between devices often costs more than the EP saves. The nodes that the CPU EP has no kernel for stay with
+// the EP. Only applies to ONNX format models.
+// "0" or "1": take every partition. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsMinEpPartitionSize = "session.min_ep_partition_size";
+
+// Limits the size of the tensors created by constant folding, as a ratio of the output to the input size of the node.
+// A node is not folded if the total size of its outputs is larger than the given multiple of the total size of its
+// constant inputs. This prevents folding nodes such as Expand, Tile or ConstantOfShape from growing the model and
+// its memory usage. Outputs of no more than 1 KiB are always folded.
+// The value is a positive float, e.g. "4". "0" disables the limit. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsConstantFoldingMaxOutputSizeRatio =
+    "optimization.constant_folding_max_output_size_ratio";
+
+// Runs the compute heavy parts of a float model in a lower precision type on the EPs the nodes are assigned to.
+// MatMul, Gemm, Conv and ConvTranspose nodes are converted if their EP has a kernel for the type, together with the
+// connected element-wise and data movement nodes. Numerically sensitive ops such as Softmax, the normalizations and
+// the reductions stay in float, and Cast nodes are added at the boundaries of the converted regions.
+// The graph inputs and outputs keep their types. Requires a graph optimization level of at least Extended.
+// "fp16": convert to float16.
+// "bf16": convert to bfloat16.
+// "": do not convert. [DEFAULT: ""]
+static const char* const kOrtSessionOptionsFloat16Conversion = "optimization.float16_conversion";
+
+// Semicolon separated list of op types that "optimization.float16_conversion" keeps in float, e.g. "Sigmoid;Tanh".
+// [DEFAULT: ""]
+static const char* const kOrtSessionOptionsFloat16ConversionOpBlockList =
+    "optimization.float16_conversion_op_block_list";
+
+// Semicolon separated list of the graph outputs the application fetches, e.g. "logits;present.0.key".
+// If set, the other graph outputs are removed when the session is initialized, together with the nodes and
+// initializers that are only needed to compute them. The removed outputs cannot be fetched by Run.
+// [DEFAULT: ""] keeps all the graph outputs.
+static const char* const kOrtSessionOptionsOutputsToKeep = "session.outputs_to_keep";
+
+// Logs the DequantizeLinear -> op -> QuantizeLinear groups of a QDQ model that the graph optimizations did not fuse
+// into quantized ops, with the reason for each, to find the ops that run in float in a quantized model.
+// The report is logged at the warning level when the session is initialized.
+// "0": disabled. "1": enabled. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsQDQFusionReport = "session.qdq_fusion_report";
+
+// Memory maps an ORT format model loaded from a file instead of reading it into a buffer, and uses the initializers
+// in place from the mapping, which is kept until the session is destroyed. Loading doesn't copy the initializers,
+// and the pages of the model are shared by the sessions of all the processes that load it.
+// Initializers of models saved by older versions, whose data is not aligned, are copied.
+// "0": read the model into a buffer, which is freed when the session is initialized.
+// "1": memory map the model. [DEFAULT: "1"]
+static const char* const kOrtSessionOptionsUseMmapForOrtModel = "session.use_mmap_for_ort_model";
+
+// Loads an ONNX model file without reading the raw data of its large initializers, which are referenced in the file
+// like external data instead. The data is read directly into the buffers of the initializers, or memory mapped on CPU,
+// when the session is initialized, so that the peak memory while loading is about the size of the model instead of
+// several times it. Also allows loading model files over the 2GB protobuf limit.
+// An optimized model saved by the session references the initializers in the original model file, so it must be saved
+// to the same directory. Only applies to models loaded from a file path.
+// "0": disabled. "1": enabled. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsStreamInitializersFromModelFile = "session.stream_initializers_from_model_file";
+
+// Writes a summary table of the nodes next to the profile file when profiling ends, named like the profile file
+// with ".json" replaced by "_summary.csv". It has one line per node with its run count, CPU time, the time and
+// number of the GPU kernels correlated with it, and the arena bytes it allocated, freed and added to the peak,
+// sorted by time. The same values are in the args of the node events of the profile.
+// "0": disabled. "1": enabled. [DEFAULT: "0"]
+static const char* const kOrtSessionOptionsProfilingNodeSummary = "session.profiling_node_summary";
+
+// Freeze the immutable state of the session, so that processes forked after the session is created share it.
+// The CPU initializers and pre-packed weights are allocated directly from the OS, apart from any memory written by
+// the runs, and made read only once the session is initialized. Worker processes forked from the process that created
+// the session then share these pages copy-on-write without ever copying them, and only own their per-run state.
+// The session should not be run before forking, so the arenas the runs grow belong to each worker.
+// Initializers with external data on the CPU are memory mapped from their file and are shared in any case.
+// Only supported on platforms that can protect memory pages, e.g. Linux.
+// - "0": The immutable state is allocated with the session allocators. [DEFAULT]
+// - "1": The immutable state is allocated separately and made read only.
+static const char* const kOrtSessionOptionsFreezeImmutableState = "session.freeze_immutable_state";
+
+// Flag the runs of a node that take more than this factor times its usual compute time, to find the rare slow paths
+// behind tail latency. Each node keeps a moving average of its compute time as baseline, and an outlier is logged as
+// a warning with the node name, op type, time, baseline and input and output shapes. Only the 1st, 2nd, 4th, 8th, ...
+// outlier of each node is logged. The first 32 runs of a node only establish its baseline.
+// The cost is a clock read and a few relaxed atomic operations per kernel.
+// Option values:
+// - "0": Outliers are not flagged. [DEFAULT]
+// - a number greater than 1, e.g. "5": Runs taking more than this times the baseline are outliers.
+static const char* const kOrtSessionOptionsNodeLatencyAlertFactor = "session.node_latency_alert_factor";
+
+// Minimum compute time in microseconds of an outlier run with "session.node_latency_alert_factor", so that the noise
+// of very short kernels is not flagged. [DEFAULT: "100"]
+static const char* const kOrtSessionOptionsNodeLatencyAlertMinUs = "session.node_latency_alert_min_us";
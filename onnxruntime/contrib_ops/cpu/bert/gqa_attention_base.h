@@ -10,6 +10,8 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -31,6 +33,17 @@ class GQAAttentionBase {
     rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    kv_cache_bit_width_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("kv_cache_bit_width", 0));
+    ORT_ENFORCE(kv_cache_bit_width_ == 0 || kv_cache_bit_width_ == 8, "kv_cache_bit_width shall be 0 or 8");
+
+    kv_block_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("kv_block_size", 0));
+    ORT_ENFORCE(kv_block_size_ >= 0, "kv_block_size shall not be negative");
+    ORT_ENFORCE(kv_block_size_ == 0 || kv_cache_bit_width_ == 0,
+                "kv_block_size is not supported with a quantized key/value cache");
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -39,6 +52,16 @@ class GQAAttentionBase {
   bool do_rotary_;    // whether or not to use rotary embeddings
   bool rotary_interleaved_;
   int local_window_size_;
+  int kv_cache_bit_width_;  // 8 when the past and present key/value cache is quantized to int8
+  int kv_block_size_;       // tokens per block of the paged key/value cache, 0 when the cache is contiguous
+  bool disable_flash_;
+  int l2_cache_size_;
+
+  // Number of keys of a sequence before its new tokens. The first chunk of a prompt has none, a later chunk of a
+  // prompt or a generated token follows all the other keys of its sequence.
+  static int PastSeqlen(const int32_t* seqlens_k, int batch_index, int sequence_length) {
+    return std::max(static_cast<int>(seqlens_k[batch_index]) + 1 - sequence_length, 0);
+  }
 
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
@@ -79,6 +102,16 @@ class GQAAttentionBase {
 
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
+    if constexpr (std::is_same_v<T, float>) {
+      if (CanUseFlashAttention(sequence_length, packed_qkv, present_key_data, present_value_data,
+                               seqlens_k->Data<int32_t>(), batch_size)) {
+        ComputeFlashAttention(output->MutableData<T>(), Q, K, V, present_key_data, present_value_data,
+                              batch_size, sequence_length, seqlen_present_kv_cache, head_size,
+                              past_present_share_buffer, allocator, tp);
+        return Status::OK();
+      }
+    }
+
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
                              sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
@@ -94,7 +127,448 @@ class GQAAttentionBase {
     return Status::OK();
   }
 
+  // Same as ApplyAttention with the past and present key/value cache quantized to int8, with one scale per token of
+  // each head. The new keys and values are quantized when they are appended to the present cache.
+  Status ApplyAttentionQuantizedKv(const float* Q,                            // Q data with shape BxNxSxH
+                                   const float* K,                            // K data with shape BxN_kvxSxH
+                                   const float* V,                            // V data with shape BxN_kvxSxH
+                                   const Tensor* past_key,                    // int8 past K with shape BxN_kvxLxH
+                                   const Tensor* past_value,                  // int8 past V with shape BxN_kvxLxH
+                                   const Tensor* past_key_scale,              // past K scales with shape BxN_kvxL
+                                   const Tensor* past_value_scale,            // past V scales with shape BxN_kvxL
+                                   Tensor* output,                            // output tensor
+                                   Tensor* present_key,                       // int8 present K with shape BxN_kvxTxH
+                                   Tensor* present_value,                     // int8 present V with shape BxN_kvxTxH
+                                   Tensor* present_key_scale,                 // present K scales with shape BxN_kvxT
+                                   Tensor* present_value_scale,               // present V scales with shape BxN_kvxT
+                                   const Tensor* seqlens_k,                   // past sequence lengths tensor
+                                   GroupQueryAttentionParameters& parameters,  // attention parameters
+                                   AllocatorPtr allocator,                    // allocator for temporary tensors
+                                   OpKernelContext* context) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    int seqlen_past_kv_cache = 0;
+    if (past_key != nullptr && past_value != nullptr) {
+      seqlen_past_kv_cache = static_cast<int>(past_key->Shape().GetDims()[2]);
+    }
+    int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
+
+    const int8_t* past_key_data = past_key != nullptr ? past_key->Data<int8_t>() : nullptr;
+    const int8_t* past_value_data = past_value != nullptr ? past_value->Data<int8_t>() : nullptr;
+    const float* past_key_scale_data = past_key_scale != nullptr ? past_key_scale->Data<float>() : nullptr;
+    const float* past_value_scale_data = past_value_scale != nullptr ? past_value_scale->Data<float>() : nullptr;
+    int8_t* present_key_data = present_key->MutableData<int8_t>();
+    int8_t* present_value_data = present_value->MutableData<int8_t>();
+    float* present_key_scale_data = present_key_scale->MutableData<float>();
+    float* present_value_scale_data = present_value_scale->MutableData<float>();
+
+    bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data &&
+                                     past_key_scale_data == present_key_scale_data &&
+                                     past_value_scale_data == present_value_scale_data;
+
+    const float* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const float* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    ConcatQuantizedStateGQA(k, past_key_data, past_key_scale_data, present_key_data, present_key_scale_data,
+                            seqlens_k->Data<int32_t>(), batch_size, sequence_length, seqlen_past_kv_cache,
+                            seqlen_present_kv_cache, head_size, past_present_share_buffer, packed_qkv, tp);
+    ConcatQuantizedStateGQA(v, past_value_data, past_value_scale_data, present_value_data, present_value_scale_data,
+                            seqlens_k->Data<int32_t>(), batch_size, sequence_length, seqlen_past_kv_cache,
+                            seqlen_present_kv_cache, head_size, past_present_share_buffer, packed_qkv, tp);
+
+    // Compute the attention score.
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+    float* probs = static_cast<float*>(attention_probs);
+
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // S x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(seqlen_present_kv_cache) * head_size;        // T x H
+    const size_t probs_chunk_length = static_cast<size_t>(sequence_length) * seqlen_present_kv_cache;          // S x T
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    // The cost of reading the int8 cache and computing S x T dot products of length H.
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * seqlen_present_kv_cache);
+    unit_cost.bytes_loaded = static_cast<double>(present_buff_chunk_length + q_input_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = static_cast<double>(probs_chunk_length * sizeof(float));
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i) / num_heads_;
+        const int head_index = static_cast<int>(i) % num_heads_;
+        const int total_seqlen = seqlens_k_data[batch_index] + 1;
+        const std::ptrdiff_t kv_index = i / kv_num_heads_factor;
+
+        const float* q;
+        if (packed_qkv) {
+          q = Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index;
+        } else {
+          q = Q + q_input_chunk_length * i;
+        }
+
+        float* output_probs = probs + probs_chunk_length * i;
+        MlasAttentionQKInt8Kv(q, sequence_length, present_key_data + present_buff_chunk_length * kv_index,
+                              present_key_scale_data + seqlen_present_kv_cache * kv_index, total_seqlen, head_size,
+                              alpha, output_probs, seqlen_present_kv_cache);
+
+        ComputeCausalSoftmaxInplace(output_probs, sequence_length,
+                                    PastSeqlen(seqlens_k_data, batch_index, sequence_length), total_seqlen,
+                                    seqlen_present_kv_cache);
+      }
+    });
+
+    // Compute the attentionScore * Value: out(B, S, N, H_v) = attention_probs(B, N, S, T) x V(B, N_kv, T, H_v)
+    float* output_data = output->MutableData<float>();
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i) / num_heads_;
+        const int head_index = static_cast<int>(i) % num_heads_;
+        const int total_seqlen = seqlens_k_data[batch_index] + 1;
+        const std::ptrdiff_t kv_index = i / kv_num_heads_factor;
+
+        float* output_current = output_data + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+        MlasAttentionPVInt8Kv(probs + probs_chunk_length * i, seqlen_present_kv_cache, sequence_length,
+                              present_value_data + present_buff_chunk_length * kv_index,
+                              present_value_scale_data + seqlen_present_kv_cache * kv_index, total_seqlen, head_size,
+                              output_current, hidden_size);
+      }
+    });
+
+    return Status::OK();
+  }
+
+  // Same as ApplyAttention with the key/value cache in a pool of blocks of kv_block_size_ tokens shared by all the
+  // sequences. Token t of sequence b is row t % kv_block_size_ of block block_table[b, t / kv_block_size_], so a
+  // sequence only holds the blocks it uses. The new keys and values are written to their blocks, then the scores
+  // and the output are accumulated block by block, reading the cache in place.
+  template <typename T>
+  Status ApplyPagedAttention(const T* Q,                                 // Q data with shape BxNxSxH
+                             const T* K,                                 // K data with shape BxN_kvxSxH
+                             const T* V,                                 // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                     // K pool with shape BlocksxN_kvxBlockxH
+                             const Tensor* past_value,                   // V pool with shape BlocksxN_kvxBlockxH
+                             const Tensor* block_table,                  // blocks of each sequence with shape BxM
+                             Tensor* output,                             // output tensor
+                             Tensor* present_key,                        // K pool, may share the past_key buffer
+                             Tensor* present_value,                      // V pool, may share the past_value buffer
+                             const Tensor* seqlens_k,                    // past sequence lengths tensor
+                             GroupQueryAttentionParameters& parameters,  // attention parameters
+                             AllocatorPtr allocator,                     // allocator for temporary tensors
+                             OpKernelContext* context) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    // the scores of each head are stored with the leading dimension of the longest sequence
+    const int seqlen_present_kv_cache = parameters.seqlen_present_kv_cache;
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    T* present_key_data = present_key->MutableData<T>();
+    T* present_value_data = present_value->MutableData<T>();
+    if (present_key_data != past_key->Data<T>()) {
+      memcpy(present_key_data, past_key->Data<T>(), past_key->SizeInBytes());
+    }
+    if (present_value_data != past_value->Data<T>()) {
+      memcpy(present_value_data, past_value->Data<T>(), past_value->SizeInBytes());
+    }
+
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    const int32_t* block_table_data = block_table->Data<int32_t>();
+    const int max_blocks = static_cast<int>(block_table->Shape()[1]);
+
+    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    WritePagedStateGQA(k, present_key_data, block_table_data, max_blocks, seqlens_k_data, batch_size, sequence_length,
+                       head_size, packed_qkv, tp);
+    WritePagedStateGQA(v, present_value_data, block_table_data, max_blocks, seqlens_k_data, batch_size,
+                       sequence_length, head_size, packed_qkv, tp);
+
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+    T* probs = static_cast<T*>(attention_probs);
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;             // S x H
+    const size_t block_chunk_length = static_cast<size_t>(kv_block_size_) * head_size;                // Block x H
+    const size_t block_length = block_chunk_length * kv_num_heads_;  // N_kv x Block x H
+    const size_t probs_chunk_length = static_cast<size_t>(sequence_length) * seqlen_present_kv_cache;  // S x T
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * seqlen_present_kv_cache);
+    unit_cost.bytes_loaded =
+        static_cast<double>((sequence_length + seqlen_present_kv_cache) * head_size * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(probs_chunk_length * sizeof(T));
+
+    // Compute the attention score: attention_probs(B, N, S, T) = alpha x Q(B, N, S, H) x K'(B, N_kv, T, H)
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i) / num_heads_;
+        const int head_index = static_cast<int>(i) % num_heads_;
+        const int total_seqlen = seqlens_k_data[batch_index] + 1;
+        const size_t kv_head_offset = block_chunk_length * (head_index / kv_num_heads_factor);
+        const int32_t* blocks = block_table_data + static_cast<size_t>(batch_index) * max_blocks;
+
+        const T* q;
+        if (packed_qkv) {
+          q = Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index;
+        } else {
+          q = Q + q_input_chunk_length * i;
+        }
+
+        T* output_probs = probs + probs_chunk_length * i;
+        for (int t = 0; t < total_seqlen; t += kv_block_size_) {
+          const T* k_block = present_key_data + block_length * blocks[t / kv_block_size_] + kv_head_offset;
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length,
+                                      std::min(kv_block_size_, total_seqlen - t), head_size, alpha, q, head_size,
+                                      k_block, head_size, 0.0f /*beta*/, output_probs + t, seqlen_present_kv_cache,
+                                      nullptr);
+        }
+
+        ComputeCausalSoftmaxInplace(output_probs, sequence_length,
+                                    PastSeqlen(seqlens_k_data, batch_index, sequence_length), total_seqlen,
+                                    seqlen_present_kv_cache);
+      }
+    });
+
+    // Compute the attentionScore * Value: out(B, S, N, H_v) = attention_probs(B, N, S, T) x V(B, N_kv, T, H_v)
+    T* output_data = output->MutableData<T>();
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i) / num_heads_;
+        const int head_index = static_cast<int>(i) % num_heads_;
+        const int total_seqlen = seqlens_k_data[batch_index] + 1;
+        const size_t kv_head_offset = block_chunk_length * (head_index / kv_num_heads_factor);
+        const int32_t* blocks = block_table_data + static_cast<size_t>(batch_index) * max_blocks;
+
+        T* output_current = output_data + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+        const T* output_probs = probs + probs_chunk_length * i;
+        for (int t = 0; t < total_seqlen; t += kv_block_size_) {
+          const T* v_block = present_value_data + block_length * blocks[t / kv_block_size_] + kv_head_offset;
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size,
+                                      std::min(kv_block_size_, total_seqlen - t), 1.0f /*alpha*/, output_probs + t,
+                                      seqlen_present_kv_cache, v_block, head_size, t == 0 ? 0.0f : 1.0f /*beta*/,
+                                      output_current, hidden_size, nullptr);
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
  private:
+  // Writes the new keys or values of each head to the rows of their tokens in the blocks of the paged cache.
+  template <typename T>
+  void WritePagedStateGQA(const T* input,                // new K or V with shape BxN_kvxSxH, or packed QKV
+                          T* present,                    // pool of blocks with shape BlocksxN_kvxBlockxH
+                          const int32_t* block_table,    // blocks of each sequence with shape BxM
+                          int max_blocks,                // blocks per sequence in the block table (M)
+                          const int32_t* seqlens_k,      // past sequence lengths tensor
+                          int batch_size,                // batch size
+                          int sequence_length,           // sequence length of the new tokens (S)
+                          int head_size,                 // head size of K and V
+                          bool packed_qkv,               // whether Q, K, V are packed
+                          ThreadPool* tp) const {
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const size_t block_chunk_length = static_cast<size_t>(kv_block_size_) * head_size;     // Block x H
+    const size_t block_length = block_chunk_length * kv_num_heads_;                        // N_kv x Block x H
+
+    const double bytes_to_copy = static_cast<double>(kv_input_chunk_length * sizeof(T));
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_,
+                               TensorOpCost{bytes_to_copy, bytes_to_copy, 0},
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int head_index = static_cast<int>(i % kv_num_heads_);
+        const int past_seqlen = PastSeqlen(seqlens_k, batch_index, sequence_length);
+        const int32_t* blocks = block_table + static_cast<size_t>(batch_index) * max_blocks;
+
+        const T* chunk;
+        if (packed_qkv) {
+          chunk = input + packed_batch_stride * batch_index + kv_input_chunk_length * head_index;
+        } else {
+          chunk = input + kv_input_chunk_length * i;
+        }
+
+        for (int s = 0; s < sequence_length; s++) {
+          const int t = past_seqlen + s;
+          T* row = present + block_length * blocks[t / kv_block_size_] + block_chunk_length * head_index +
+                   static_cast<size_t>(t % kv_block_size_) * head_size;
+          memcpy(row, chunk + static_cast<size_t>(s) * head_size, head_size * sizeof(T));
+        }
+      }
+    });
+  }
+
+  // Appends the new keys or values of each head to the int8 present cache, after copying the past cache when it does
+  // not share the buffer of the present cache.
+  void ConcatQuantizedStateGQA(const float* input,           // new K or V with shape BxN_kvxSxH, or packed QKV
+                               const int8_t* past,           // past cache with shape BxN_kvxLxH
+                               const float* past_scale,      // past scales with shape BxN_kvxL
+                               int8_t* present,              // present cache with shape BxN_kvxTxH
+                               float* present_scale,         // present scales with shape BxN_kvxT
+                               const int32_t* seqlens_k,     // past sequence lengths tensor
+                               int batch_size,               // batch size
+                               int sequence_length,          // sequence length of the new tokens (S)
+                               int past_buffer_sequence_length,     // sequence length of past state (L)
+                               int present_buffer_sequence_length,  // sequence length of present state (T)
+                               int head_size,                // head size of K and V
+                               bool past_present_share_buffer,  // whether present and past share the same buffer
+                               bool packed_qkv,              // whether Q, K, V are packed
+                               ThreadPool* tp) const {
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // S x H
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+    const ptrdiff_t loop_len = SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_;
+
+    if (!past_present_share_buffer) {
+      memset(present, 0, loop_len * present_buff_chunk_length);
+      memset(present_scale, 0, loop_len * present_buffer_sequence_length * sizeof(float));
+    }
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = static_cast<double>(kv_input_chunk_length * 4);
+    unit_cost.bytes_loaded = static_cast<double>(kv_input_chunk_length * sizeof(float) + past_buff_chunk_length);
+    unit_cost.bytes_stored = static_cast<double>(kv_input_chunk_length + past_buff_chunk_length);
+
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int head_index = static_cast<int>(i % kv_num_heads_);
+
+        int8_t* present_chunk = present + present_buff_chunk_length * i;
+        float* present_scale_chunk = present_scale + static_cast<size_t>(present_buffer_sequence_length) * i;
+
+        const int past_seqlen = PastSeqlen(seqlens_k, batch_index, sequence_length);
+        if (past_seqlen > 0) {
+          if (!past_present_share_buffer && past != nullptr) {
+            memcpy(present_chunk, past + past_buff_chunk_length * i, static_cast<size_t>(past_seqlen) * head_size);
+            memcpy(present_scale_chunk, past_scale + static_cast<size_t>(past_buffer_sequence_length) * i,
+                   static_cast<size_t>(past_seqlen) * sizeof(float));
+          }
+          present_chunk += static_cast<size_t>(past_seqlen) * head_size;
+          present_scale_chunk += past_seqlen;
+        }
+
+        const float* chunk;
+        if (packed_qkv) {
+          chunk = input + packed_batch_stride * batch_index + kv_input_chunk_length * head_index;
+        } else {
+          chunk = input + kv_input_chunk_length * i;
+        }
+
+        MlasQuantizeKvCacheInt8(chunk, present_chunk, present_scale_chunk, sequence_length, head_size);
+      }
+    });
+  }
+
+  // Flash attention handles the prompt when every sequence of the batch is the full prompt, so that the keys
+  // visible to each query are given by the causal mask alone.
+  bool CanUseFlashAttention(int sequence_length, bool packed_qkv, const void* present_key, const void* present_value,
+                            const int32_t* seqlens_k, int batch_size) const {
+    if (disable_flash_ || l2_cache_size_ <= 0 || sequence_length == 1 || packed_qkv || local_window_size_ > 0 ||
+        present_key == nullptr || present_value == nullptr) {
+      return false;
+    }
+    for (int b = 0; b < batch_size; b++) {
+      if (seqlens_k[b] + 1 != sequence_length) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Copies K and V of the prompt into the present state and computes the causal attention with MlasFlashAttention.
+  // The query heads of a group read the shared K and V head in place.
+  void ComputeFlashAttention(float* output,                     // output with size BxSxNxH
+                             const float* Q,                    // Q data with shape BxNxSxH
+                             const float* K,                    // K data with shape BxN_kvxSxH
+                             const float* V,                    // V data with shape BxN_kvxSxH
+                             float* present_key,                // present K with shape BxN_kvxTxH
+                             float* present_value,              // present V with shape BxN_kvxTxH
+                             int batch_size,                    // batch size
+                             int sequence_length,               // sequence length of the prompt (S)
+                             int present_buffer_sequence_length,  // sequence length of present state (T)
+                             int head_size,                     // head size of Q, K and V
+                             bool past_present_share_buffer,    // whether present key and value share the past buffer
+                             AllocatorPtr allocator,            // allocator for the scratch buffer
+                             ThreadPool* tp) const {            // thread pool
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // S x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+    const size_t present_buff_length = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length;
+
+    if (!past_present_share_buffer) {
+      memset(present_key, 0, present_buff_length * sizeof(float));
+      memset(present_value, 0, present_buff_length * sizeof(float));
+    }
+
+    const double bytes_to_copy = static_cast<double>(kv_input_chunk_length * sizeof(float) * 2);
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_,
+                               TensorOpCost{bytes_to_copy, bytes_to_copy, 0},
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                                 for (std::ptrdiff_t i = begin; i != end; ++i) {
+                                   memcpy(present_key + i * present_buff_chunk_length, K + i * kv_input_chunk_length,
+                                          kv_input_chunk_length * sizeof(float));
+                                   memcpy(present_value + i * present_buff_chunk_length, V + i * kv_input_chunk_length,
+                                          kv_input_chunk_length * sizeof(float));
+                                 }
+                               });
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.kv_num_heads = kv_num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    args.is_causal = true;
+    SetFlashAttentionBlockSizes(args, l2_cache_size_);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(&args);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+    args.query = Q;
+    args.key = K;
+    args.value = V;
+    args.output = output;
+
+    MlasFlashAttention(&args, tp);
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -113,7 +587,6 @@ class GQAAttentionBase {
                              bool past_present_share_buffer,      // whether present key and value share the same buffer
                              bool packed_qkv,                     // whether Q, K, V are packed
                              ThreadPool* tp) const {              // thread pool
-    const bool is_prompt = sequence_length != 1;
     const ptrdiff_t packed_batch_stride =
         packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
                    : SafeInt<ptrdiff_t>(0);
@@ -152,8 +625,7 @@ class GQAAttentionBase {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const int batch_index = static_cast<int>(i) / num_heads_;
         const int head_index = static_cast<int>(i) % num_heads_;
-        const int past_seqlen =
-            sequence_length == 1 ? static_cast<int>(seqlens_k[batch_index]) : past_buffer_sequence_length;
+        const int past_seqlen = PastSeqlen(seqlens_k, batch_index, sequence_length);
         const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
         const int total_seqlen = seqlens_k[batch_index] + 1;
 
@@ -168,8 +640,8 @@ class GQAAttentionBase {
         }
         if (nullptr != present_key) {
           k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
-                                  past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                  i / kv_num_heads_factor);
+                                  past_chunk_length, kv_input_chunk_length, past_seqlen == 0,
+                                  past_present_share_buffer, i / kv_num_heads_factor);
         }
 
         // Compute Q*K' + AttentionMask
@@ -187,29 +659,40 @@ class GQAAttentionBase {
                                     head_size, k, head_size, 0.0f /*bata*/, output, present_buffer_sequence_length,
                                     nullptr);
 
-        // compute Softmax
-        T* output_softmax = output;
-        for (int seq = 0; seq < sequence_length; seq++) {
-          int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
-            for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                           local_window_size_ + 1, nullptr);
-          } else {
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
-          }
-
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+        ComputeCausalSoftmaxInplace(output, sequence_length, past_seqlen, total_seqlen,
+                                    present_buffer_sequence_length);
+      }
+    });
+  }
 
-          output_softmax += present_buffer_sequence_length;
+  // Applies the causal (and local window) mask and the softmax to the attention scores of one head. Query s sees
+  // the past keys and the new keys up to its own.
+  template <typename T>
+  void ComputeCausalSoftmaxInplace(T* output,                            // scores with size SxT
+                                   int sequence_length,                  // sequence length of self-attention (S)
+                                   int past_seqlen,                      // number of keys before the new ones
+                                   int total_seqlen,                     // number of valid keys
+                                   int present_buffer_sequence_length) const {  // leading dimension (T)
+    T* output_softmax = output;
+    for (int seq = 0; seq < sequence_length; seq++) {
+      int seq_causal_length = past_seqlen + seq + 1;
+      if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
+        for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
         }
+        ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                       local_window_size_ + 1, nullptr);
+      } else {
+        ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
       }
-    });
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += present_buffer_sequence_length;
+    }
   }
 
   template <typename T>
@@ -228,7 +711,6 @@ class GQAAttentionBase {
                                bool past_present_share_buffer,      // whether present key and value share the same buffer
                                bool packed_qkv,                     // whether Q, K, V are packed
                                ThreadPool* tp) const {
-    const bool is_prompt = sequence_length != 1;
     const ptrdiff_t packed_batch_stride =
         packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
                    : SafeInt<ptrdiff_t>(0);
@@ -265,8 +747,7 @@ class GQAAttentionBase {
           for (std::ptrdiff_t i = begin; i != end; ++i) {
             const int batch_index = static_cast<int>(i / num_heads_);
             const int head_index = static_cast<int>(i % num_heads_);
-            const int past_seqlen =
-                sequence_length == 1 ? static_cast<int>(seqlens_k[batch_index]) : past_buffer_sequence_length;
+            const int past_seqlen = PastSeqlen(seqlens_k, batch_index, sequence_length);
             const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
             const int total_seqlen = seqlens_k[batch_index] + 1;
 
@@ -278,8 +759,8 @@ class GQAAttentionBase {
             }
             if (nullptr != present_value) {
               v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
-                                      past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                      i / kv_num_heads_factor);
+                                      past_chunk_length, kv_input_chunk_length, past_seqlen == 0,
+                                      past_present_share_buffer, i / kv_num_heads_factor);
             }
 
             T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
@@ -5,8 +5,6 @@
 #include "contrib_ops/cpu/bert/group_query_attention_helper.h"
 #include "contrib_ops/cpu/bert/rotary_helper.h"
 #include "contrib_ops/cpu/bert/attention_utils.h"
-#include "contrib_ops/cpu/bert/rotary_embedding.h"
-#include "contrib_ops/cpu/bert/rotary_embedding_helper.h"
 
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
@@ -30,6 +28,8 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T_SCALE", DataTypeImpl::GetTensorType<float>())
         .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
     GroupQueryAttention<float>);
 
@@ -48,14 +48,23 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* past_key_scale = context->Input<Tensor>(9);
+  const Tensor* past_value_scale = context->Input<Tensor>(10);
+  const Tensor* block_table = context->Input<Tensor>(11);
+
+  const bool paged_kv_cache = kv_block_size_ > 0;
+  if (!paged_kv_cache && block_table != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'block_table' requires the kv_block_size attribute");
+  }
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
+  // the blocks of a paged cache are not bound to the batch, they are checked separately
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
                                                                 key,
                                                                 value,
-                                                                past_key,
-                                                                past_value,
+                                                                paged_kv_cache ? nullptr : past_key,
+                                                                paged_kv_cache ? nullptr : past_value,
                                                                 cos_cache,
                                                                 sin_cache,
                                                                 &parameters,
@@ -64,6 +73,20 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 seqlens_k,
                                                                 total_seqlen,
                                                                 scale));
+  if (paged_kv_cache) {
+    ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckPagedKvCache(past_key, past_value, block_table, seqlens_k,
+                                                                        kv_block_size_, parameters));
+  } else {
+    // A later chunk of a prompt, like a generated token, follows the past keys of its sequence.
+    for (int b = 0; b < parameters.batch_size; b++) {
+      const int past_seqlen = PastSeqlen(seqlens_k->Data<int32_t>(), b, parameters.sequence_length);
+      if (past_seqlen > parameters.seqlen_past_kv_cache) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sequence ", b, " has ", past_seqlen,
+                               " past tokens, more than the ", parameters.seqlen_past_kv_cache,
+                               " tokens of 'past_key'.");
+      }
+    }
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -80,8 +103,8 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
-  Tensor* present_k = context->Output(1, present_k_shape);
-  Tensor* present_v = context->Output(2, present_v_shape);
+  Tensor* present_k = context->Output(1, paged_kv_cache ? past_key->Shape() : TensorShape(present_k_shape));
+  Tensor* present_v = context->Output(2, paged_kv_cache ? past_value->Shape() : TensorShape(present_v_shape));
 
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
@@ -90,7 +113,44 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   OrtValue Q;
   OrtValue K;
   OrtValue V;
-  if (packed_qkv) {
+  if (do_rotary_) {
+    // The rotary embedding is applied while Q and K are transposed to BNSH, so the new tokens are read once.
+    auto* tp = context->GetOperatorThreadPool();
+    std::vector<int64_t> pos_ids(static_cast<size_t>(batch_size) * sequence_length);
+    for (int b = 0; b < batch_size; b++) {
+      // the new tokens of a sequence, the first chunk of a prompt, a later one or a generated token, follow its past
+      const int past_seqlen = PastSeqlen(seqlens_k->Data<int32_t>(), b, sequence_length);
+      for (int s = 0; s < sequence_length; s++) {
+        pos_ids[static_cast<size_t>(b) * sequence_length + s] = static_cast<int64_t>(past_seqlen) + s;
+      }
+    }
+    const T* cos_data = cos_cache->Data<T>();
+    const T* sin_data = sin_cache->Data<T>();
+    if (packed_qkv) {
+      const int num_qkv_heads = num_heads_ + 2 * kv_num_heads_;
+      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_qkv_heads, sequence_length, head_size}),
+                           allocator, Q);
+      ORT_RETURN_IF_ERROR(rotary_helper::TransposeWithRotaryToBNSH<T>(
+          tp, batch_size, sequence_length, num_qkv_heads, num_heads_ + kv_num_heads_, head_size, parameters.rotary_dim,
+          rotary_interleaved_, pos_ids.data(), cos_data, sin_data, query->Data<T>(),
+          Q.GetMutable<Tensor>()->MutableData<T>()));
+    } else {
+      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_, sequence_length, head_size}),
+                           allocator, Q);
+      Tensor::InitOrtValue(element_type, TensorShape({batch_size, kv_num_heads_, sequence_length, head_size}),
+                           allocator, K);
+      ORT_RETURN_IF_ERROR(rotary_helper::TransposeWithRotaryToBNSH<T>(
+          tp, batch_size, sequence_length, num_heads_, num_heads_, head_size, parameters.rotary_dim,
+          rotary_interleaved_, pos_ids.data(), cos_data, sin_data, query->Data<T>(),
+          Q.GetMutable<Tensor>()->MutableData<T>()));
+      ORT_RETURN_IF_ERROR(rotary_helper::TransposeWithRotaryToBNSH<T>(
+          tp, batch_size, sequence_length, kv_num_heads_, kv_num_heads_, head_size, parameters.rotary_dim,
+          rotary_interleaved_, pos_ids.data(), cos_data, sin_data, key->Data<T>(),
+          K.GetMutable<Tensor>()->MutableData<T>()));
+      ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
+          allocator, batch_size, kv_num_heads_, sequence_length, head_size, value, V));
+    }
+  } else if (packed_qkv) {
     ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
         allocator, batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size, query, Q));
   } else {
@@ -102,80 +162,47 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
         allocator, batch_size, kv_num_heads_, sequence_length, head_size, value, V));
   }
 
-  if (do_rotary_) {
-    rotary_embedding_helper::RotaryParameters rotary_params = {};
-    rotary_params.batch_size = batch_size;
-    rotary_params.sequence_length = sequence_length;
-    rotary_params.hidden_size = q_hidden_size;
-    rotary_params.head_size = head_size;
-    rotary_params.rotary_embedding_dim = parameters.rotary_dim;
-    rotary_params.num_heads = num_heads_;
-    rotary_params.max_sequence_length = sequence_length;  // unused
-    rotary_params.seq_stride = head_size;
-    rotary_params.head_stride = sequence_length * rotary_params.seq_stride;
-    rotary_params.batch_stride = (packed_qkv ? (num_heads_ + 2 * kv_num_heads_) : num_heads_) * rotary_params.head_stride;
-    rotary_params.position_ids_format = sequence_length == 1 ? 1 : 0;
-    rotary_params.transposed = true;
-    auto* tp = context->GetOperatorThreadPool();
-    std::vector<int64_t> pos_ids(sequence_length == 1 ? batch_size : 1);
-    if (sequence_length == 1) {
-      for (int b = 0; b < batch_size; b++) {
-        pos_ids[b] = static_cast<int64_t>(seqlens_k->Data<int32_t>()[b]);
-      }
-    } else {
-      pos_ids[0] = static_cast<int64_t>(0);
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  if (kv_cache_bit_width_ == 8) {
+    std::vector<int64_t> present_scale_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen)});
+    Tensor* present_k_scale = context->Output(3, present_scale_shape);
+    Tensor* present_v_scale = context->Output(4, present_scale_shape);
+    if (present_k_scale == nullptr || present_v_scale == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Outputs 'present_key_scale' and 'present_value_scale' are required when "
+                             "kv_cache_bit_width is 8");
     }
-    const T* q_input;
-    const T* k_input;
-    T* q_rotary;
-    T* k_rotary;
-    if (packed_qkv) {
-      OrtValue RotaryQKV;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size}), allocator, RotaryQKV);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = q_input + num_heads_ * sequence_length * head_size;
-      q_rotary = RotaryQKV.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = q_rotary + num_heads_ * sequence_length * head_size;
-      Q = RotaryQKV;
-    } else {
-      OrtValue RotaryQ;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_, sequence_length, head_size}), allocator, RotaryQ);
-      OrtValue RotaryK;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, kv_num_heads_, sequence_length, head_size}), allocator, RotaryK);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = K.Get<Tensor>().Data<T>();
-      q_rotary = RotaryQ.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = RotaryK.GetMutable<Tensor>()->MutableData<T>();
-      Q = RotaryQ;
-      K = RotaryK;
+    if (past_key != nullptr && (past_key_scale == nullptr || past_value_scale == nullptr)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'past_key_scale' and 'past_value_scale' are required with an int8 past state");
     }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, q_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), q_rotary, rotary_interleaved_));
-
-    rotary_params.num_heads = kv_num_heads_;
-    rotary_params.hidden_size = parameters.kv_hidden_size;
-    if (!packed_qkv) {
-      rotary_params.batch_stride = kv_num_heads_ * rotary_params.head_stride;
+    if (past_key != nullptr) {
+      const auto& past_dims = past_key->Shape().GetDims();
+      const TensorShape past_scale_shape({past_dims[0], past_dims[1], past_dims[2]});
+      if (past_key_scale->Shape() != past_scale_shape || past_value_scale->Shape() != past_scale_shape) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Inputs 'past_key_scale' and 'past_value_scale' shall have shape ",
+                               past_scale_shape);
+      }
     }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, k_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), k_rotary, rotary_interleaved_));
-    if (packed_qkv) {
-      const T* v_input = k_input + kv_num_heads_ * sequence_length * head_size;
-      T* v_rotary = k_rotary + kv_num_heads_ * sequence_length * head_size;
-      ORT_RETURN_IF_ERROR(rotary_helper::PackVIntoRotaryQKV<T>(tp,
-                                                               parameters.batch_size,
-                                                               parameters.sequence_length,
-                                                               parameters.num_heads,
-                                                               parameters.kv_num_heads,
-                                                               parameters.head_size,
-                                                               v_input,
-                                                               v_rotary));
+
+    return ApplyAttentionQuantizedKv(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                                     packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value,
+                                     past_key_scale, past_value_scale, output, present_k, present_v, present_k_scale,
+                                     present_v_scale, seqlens_k, parameters, allocator, context);
+  }
+
+  if (paged_kv_cache) {
+    if (present_k == nullptr || present_v == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Outputs 'present_key' and 'present_value' are required when kv_block_size is set");
     }
+    return ApplyPagedAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                               packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, block_table,
+                               output, present_k, present_v, seqlens_k, parameters, allocator, context);
   }
 
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
                         packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
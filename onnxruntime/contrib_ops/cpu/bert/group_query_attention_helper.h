@@ -263,6 +263,71 @@ Status CheckInputs(const Tensor* query,
 
   return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, scale);
 }
+// Checks the paged key/value cache: past_key and past_value are pools of blocks with shape
+// (num_blocks, kv_num_heads, kv_block_size, head_size), and row b of block_table with shape
+// (batch_size, max_blocks_per_sequence) holds the blocks of sequence b in order.
+Status CheckPagedKvCache(const Tensor* past_key,
+                         const Tensor* past_value,
+                         const Tensor* block_table,
+                         const Tensor* seqlens_k,
+                         int kv_block_size,
+                         const GroupQueryAttentionParameters& parameters) {
+  if (past_key == nullptr || past_value == nullptr || block_table == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'past_key', 'past_value' and 'block_table' are required when kv_block_size is set.");
+  }
+
+  const auto& past_key_dims = past_key->Shape().GetDims();
+  if (past_key_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' is expected to have 4 dimensions, got ", past_key_dims.size());
+  }
+  if (past_value->Shape() != past_key->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' shall have the same shape with a paged cache.");
+  }
+  if (past_key_dims[1] != parameters.kv_num_heads || past_key_dims[2] != kv_block_size ||
+      past_key_dims[3] != parameters.head_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' shall have shape (num_blocks, kv_num_heads, kv_block_size, head_size), "
+                           "got ", past_key->Shape());
+  }
+
+  const auto& block_table_dims = block_table->Shape().GetDims();
+  if (block_table_dims.size() != 2 || block_table_dims[0] != parameters.batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'block_table' shall have shape (batch_size, max_blocks_per_sequence), got ",
+                           block_table->Shape());
+  }
+
+  // The first chunk of a prompt is written from the start of the sequence, the new tokens after the past tokens.
+  const int64_t num_blocks = past_key_dims[0];
+  const int64_t max_blocks = block_table_dims[1];
+  const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+  const int32_t* block_table_data = block_table->Data<int32_t>();
+  for (int b = 0; b < parameters.batch_size; b++) {
+    const int64_t total_seqlen = static_cast<int64_t>(seqlens_k_data[b]) + 1;
+    const int64_t stored_seqlen = parameters.is_prompt ? std::max<int64_t>(total_seqlen, parameters.sequence_length)
+                                                       : total_seqlen;
+    const int64_t used_blocks = (stored_seqlen + kv_block_size - 1) / kv_block_size;
+    if (total_seqlen <= 0 || used_blocks > max_blocks) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Sequence ", b, " of length ", stored_seqlen, " needs more than the ", max_blocks,
+                             " blocks of 'block_table'.");
+    }
+    for (int64_t j = 0; j < used_blocks; j++) {
+      const int32_t block = block_table_data[b * max_blocks + j];
+      if (block < 0 || block >= num_blocks) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Block ", block, " of sequence ", b, " is out of the range of the ", num_blocks,
+                               " blocks of the cache.");
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace group_query_attention_helper
 }  // namespace contrib
 }  // namespace onnxruntime
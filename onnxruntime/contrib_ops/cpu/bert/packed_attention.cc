@@ -0,0 +1,256 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/packed_attention.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "contrib_ops/cpu/bert/multihead_attention_helper.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    PackedAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
+    PackedAttention<float>);
+
+template <typename T>
+PackedAttention<T>::PackedAttention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+  scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+  qkv_hidden_sizes_ = info.GetAttrsOrDefault<int64_t>("qkv_hidden_sizes");
+}
+
+template <typename T>
+Status PackedAttention<T>::CheckInputs(const TensorShape& input_shape,
+                                       const TensorShape& weights_shape,
+                                       const TensorShape& bias_shape,
+                                       const TensorShape& token_offset_shape,
+                                       const TensorShape& cu_seq_len_shape,
+                                       const Tensor* attention_bias,
+                                       PackedAttentionParameters& parameters) const {
+  // Input shapes:
+  //   input:                  : (T, D_i)
+  //   weights      (Q/K/V)    : (D_i, D + D + D_v)
+  //   bias         (Q/K/V)    : (D + D + D_v)
+  //   token_offset            : (B, S)
+  //   cu_seq_len_shape        : (B + 1)
+  //   attention_bias          : (B or 1, N or 1, S, S) or NULL
+  const auto& input_dims = input_shape.GetDims();
+  if (input_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input' is expected to have 2 dimensions in packing mode, got ",
+                           input_dims.size());
+  }
+  const int64_t token_count = input_dims[0];
+  const int64_t input_hidden_size = input_dims[1];
+
+  const auto& token_offset_dims = token_offset_shape.GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'token_offset' is expected to have 2 dimensions in packing mode, got ",
+                           token_offset_dims.size());
+  }
+  const int64_t batch_size = token_offset_dims[0];
+  const int64_t sequence_length = token_offset_dims[1];
+
+  const auto& bias_dims = bias_shape.GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' is expected to have 1 dimension, got ",
+                           bias_dims.size());
+  }
+
+  const auto& weights_dims = weights_shape.GetDims();
+  if (weights_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weights' is expected to have 2 dimensions, got ",
+                           weights_dims.size());
+  }
+  if (weights_dims[0] != input_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 0 should have same length as dimension 1 of input 0");
+  }
+  if (bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as dimension 1 of input 'weights'");
+  }
+
+  const auto& cu_seq_len_dims = cu_seq_len_shape.GetDims();
+  if (cu_seq_len_dims.size() != 1 || cu_seq_len_dims[0] != batch_size + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' should have 1 dimension with size equal to "
+                           "batch_size + 1");
+  }
+
+  int64_t q_hidden_size = bias_dims[0] / static_cast<int64_t>(3);
+  int64_t k_hidden_size = q_hidden_size;
+  int64_t v_hidden_size = k_hidden_size;
+  if (qkv_hidden_sizes_.size() != 0) {
+    if (qkv_hidden_sizes_.size() != 3) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "qkv_hidden_sizes attribute should have 3 elements");
+    }
+    q_hidden_size = qkv_hidden_sizes_[0];
+    k_hidden_size = qkv_hidden_sizes_[1];
+    v_hidden_size = qkv_hidden_sizes_[2];
+  }
+  if (q_hidden_size % num_heads_ != 0 || v_hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "hidden_size should be divisible by num_heads");
+  }
+  if (q_hidden_size != k_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "qkv_hidden_sizes first element should be same as the second");
+  }
+  if (bias_dims[0] != q_hidden_size + k_hidden_size + v_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as sum of Q/K/V hidden sizes");
+  }
+
+  gsl::span<const int64_t> attention_bias_dims;
+  if (attention_bias != nullptr) {
+    attention_bias_dims = attention_bias->Shape().GetDims();
+    ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckAttentionBias(
+        attention_bias_dims, batch_size, num_heads_, sequence_length, sequence_length));
+  }
+  parameters.broadcast_attn_bias_dim_0 = attention_bias_dims.size() > 0 && attention_bias_dims[0] == 1;
+  parameters.broadcast_attn_bias_dim_1 = attention_bias_dims.size() > 1 && attention_bias_dims[1] == 1;
+
+  parameters.batch_size = static_cast<int>(batch_size);
+  parameters.sequence_length = static_cast<int>(sequence_length);
+  parameters.input_hidden_size = static_cast<int>(input_hidden_size);
+  parameters.hidden_size = static_cast<int>(q_hidden_size);
+  parameters.v_hidden_size = static_cast<int>(v_hidden_size);
+  parameters.head_size = static_cast<int>(q_hidden_size) / num_heads_;
+  parameters.v_head_size = static_cast<int>(v_hidden_size) / num_heads_;
+  parameters.num_heads = num_heads_;
+  parameters.scale = scale_;
+  parameters.token_count = static_cast<int>(token_count);
+  parameters.use_tf32 = false;
+
+  return Status::OK();
+}
+
+template <typename T>
+Status PackedAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* token_offset = context->Input<Tensor>(3);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(4);
+  const Tensor* attention_bias = context->Input<Tensor>(5);
+
+  PackedAttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(), weights->Shape(), bias->Shape(), token_offset->Shape(),
+                                  cumulative_sequence_length->Shape(), attention_bias, parameters));
+
+  const int batch_size = parameters.batch_size;
+  const int sequence_length = parameters.sequence_length;
+  const int token_count = parameters.token_count;
+  const int num_heads = parameters.num_heads;
+  const int head_size = parameters.head_size;
+  const int v_head_size = parameters.v_head_size;
+  const int v_hidden_size = parameters.v_hidden_size;
+  const int qkv_size = 2 * parameters.hidden_size + v_hidden_size;
+
+  // The tokens of sequence b are the rows [cu_seq_len[b], cu_seq_len[b + 1]) of the input.
+  const int32_t* cu_seq_len = cumulative_sequence_length->Data<int32_t>();
+  ORT_RETURN_IF_NOT(cu_seq_len[0] == 0 && cu_seq_len[batch_size] == token_count,
+                    "Input 'cumulative_sequence_length' shall start with 0 and end with the token count ",
+                    token_count);
+  for (int b = 0; b < batch_size; b++) {
+    const int length = cu_seq_len[b + 1] - cu_seq_len[b];
+    ORT_RETURN_IF_NOT(length >= 0 && length <= sequence_length,
+                      "The length of sequence ", b, " in 'cumulative_sequence_length' is not in [0, ",
+                      sequence_length, "], got ", length);
+  }
+
+  Tensor* output = context->Output(0, {token_count, v_hidden_size});
+  if (token_count == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto* tp = context->GetOperatorThreadPool();
+
+  // qkv(T, D + D + D_v) = input(T, D_i) x weights(D_i, D + D + D_v) + bias
+  auto qkv_data = allocator->Alloc(SafeInt<size_t>(token_count) * qkv_size * sizeof(T));
+  BufferUniquePtr qkv_buffer(qkv_data, BufferDeleter(allocator));
+  T* qkv = static_cast<T*>(qkv_data);
+  const T* bias_data = bias->Data<T>();
+  for (int t = 0; t < token_count; t++) {
+    std::copy_n(bias_data, qkv_size, qkv + static_cast<ptrdiff_t>(t) * qkv_size);
+  }
+  MlasGemm(CblasNoTrans, CblasNoTrans, token_count, qkv_size, parameters.input_hidden_size, 1.0f,
+           input->Data<T>(), parameters.input_hidden_size, weights->Data<T>(), qkv_size, 1.0f, qkv, qkv_size, tp);
+
+  const float alpha = scale_ == 0.0f ? 1.0f / std::sqrt(static_cast<float>(head_size)) : scale_;
+  const T* attention_bias_data = attention_bias != nullptr ? attention_bias->Data<T>() : nullptr;
+  const ptrdiff_t bias_matrix_size = static_cast<ptrdiff_t>(sequence_length) * sequence_length;
+  T* output_data = output->MutableData<T>();
+
+  // The cost of a sequence of the full length. Shorter sequences cost less, and empty ones nothing.
+  const double full_length = static_cast<double>(sequence_length);
+  const TensorOpCost unit_cost{full_length * (head_size + v_head_size) * sizeof(T),
+                               full_length * v_head_size * sizeof(T),
+                               2.0 * full_length * full_length * (head_size + v_head_size)};
+  ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(batch_size) * num_heads, unit_cost,
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    std::vector<T> scores;
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int b = static_cast<int>(i / num_heads);
+      const int n = static_cast<int>(i % num_heads);
+      const int first_token = cu_seq_len[b];
+      const int length = cu_seq_len[b + 1] - first_token;
+      if (length == 0) {
+        continue;
+      }
+
+      const T* q = qkv + static_cast<ptrdiff_t>(first_token) * qkv_size + n * head_size;
+      const T* k = q + parameters.hidden_size;
+      const T* v = qkv + static_cast<ptrdiff_t>(first_token) * qkv_size + 2 * parameters.hidden_size +
+                   n * v_head_size;
+      scores.resize(static_cast<size_t>(length) * length);
+
+      // scores(L, L) = alpha x Q(L, H) x K'(H, L) + attention_bias
+      MlasGemm(CblasNoTrans, CblasTrans, length, length, head_size, alpha, q, qkv_size, k, qkv_size, 0.0f,
+               scores.data(), length, nullptr);
+      if (attention_bias_data != nullptr) {
+        // the tokens are at the start of their padded sequence
+        const int bias_heads = parameters.broadcast_attn_bias_dim_1 ? 1 : num_heads;
+        const int bias_index = (parameters.broadcast_attn_bias_dim_0 ? 0 : b) * bias_heads +
+                               (parameters.broadcast_attn_bias_dim_1 ? 0 : n);
+        const T* bias_matrix = attention_bias_data + bias_index * bias_matrix_size;
+        for (int s = 0; s < length; s++) {
+          for (int j = 0; j < length; j++) {
+            scores[static_cast<size_t>(s) * length + j] += bias_matrix[s * sequence_length + j];
+          }
+        }
+      }
+      MlasComputeSoftmax(scores.data(), scores.data(), length, length, false, nullptr);
+
+      // output(L, H_v) = scores(L, L) x V(L, H_v), stored at the rows of the tokens
+      T* out = output_data + static_cast<ptrdiff_t>(first_token) * v_hidden_size + n * v_head_size;
+      MlasGemm(CblasNoTrans, CblasNoTrans, length, v_head_size, length, 1.0f, scores.data(), length, v, qkv_size,
+               0.0f, out, v_hidden_size, nullptr);
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
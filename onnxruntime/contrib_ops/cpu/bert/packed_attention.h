@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attention over packed input, i.e. the real tokens of all the sequences without padding. The tokens of every
+// sequence only attend the tokens of the same sequence given by cumulative_sequence_length, so that no score or
+// product is computed for padding.
+template <typename T>
+class PackedAttention final : public OpKernel {
+ public:
+  PackedAttention(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  Status CheckInputs(const TensorShape& input_shape,
+                     const TensorShape& weights_shape,
+                     const TensorShape& bias_shape,
+                     const TensorShape& token_offset_shape,
+                     const TensorShape& cu_seq_len_shape,
+                     const Tensor* attention_bias,
+                     PackedAttentionParameters& parameters) const;
+
+  int num_heads_;
+  float scale_;
+  std::vector<int64_t> qkv_hidden_sizes_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -4,6 +4,11 @@
 #include "contrib_ops/cpu/bert/rotary_embedding.h"
 #include "contrib_ops/cpu/bert/rotary_embedding_helper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
 #include "core/platform/threadpool.h"
 
 using onnxruntime::concurrency::ThreadPool;
@@ -35,6 +40,120 @@ RotaryEmbedding<T>::RotaryEmbedding(const OpKernelInfo& info) : OpKernel(info) {
   if (rotary_embedding_dim > 0) {
     ORT_ENFORCE(num_heads > 0, "num_heads must be provided if rotary_embedding_dim is specified");
   }
+
+  rope_theta = info.GetAttrOrDefault<float>("rope_theta", 10000.0f);
+  const std::string scaling_type = info.GetAttrOrDefault<std::string>("rope_scaling_type", "");
+  if (scaling_type.empty() || scaling_type == "none") {
+    rope_scaling_type = RopeScalingType::None;
+  } else if (scaling_type == "linear") {
+    rope_scaling_type = RopeScalingType::Linear;
+  } else if (scaling_type == "ntk") {
+    rope_scaling_type = RopeScalingType::Ntk;
+  } else if (scaling_type == "yarn") {
+    rope_scaling_type = RopeScalingType::Yarn;
+  } else if (scaling_type == "longrope") {
+    rope_scaling_type = RopeScalingType::LongRope;
+  } else {
+    ORT_THROW("Unsupported rope_scaling_type: ", scaling_type);
+  }
+  rope_scaling_factor = info.GetAttrOrDefault<float>("rope_scaling_factor", 1.0f);
+  original_max_position_embeddings =
+      static_cast<int>(info.GetAttrOrDefault<int64_t>("original_max_position_embeddings", 0));
+  long_factor = info.GetAttrsOrDefault<float>("long_factor");
+  short_factor = info.GetAttrsOrDefault<float>("short_factor");
+
+  ORT_ENFORCE(rope_theta > 0.0f && rope_scaling_factor > 0.0f, "rope_theta and rope_scaling_factor must be positive");
+  if (rope_scaling_type == RopeScalingType::Yarn || rope_scaling_type == RopeScalingType::LongRope) {
+    ORT_ENFORCE(original_max_position_embeddings > 0,
+                "original_max_position_embeddings must be provided with yarn and longrope scaling");
+  }
+  if (rope_scaling_type == RopeScalingType::LongRope) {
+    ORT_ENFORCE(!long_factor.empty() && long_factor.size() == short_factor.size(),
+                "long_factor and short_factor must be provided with the same size with longrope scaling");
+  }
+}
+
+template <typename T>
+std::shared_ptr<const typename RotaryEmbedding<T>::RotaryTables> RotaryEmbedding<T>::GetTables(int length,
+                                                                                               int rotary_dim) const {
+  const bool use_long_factor = rope_scaling_type == RopeScalingType::LongRope &&
+                               length > original_max_position_embeddings;
+  std::lock_guard<OrtMutex> lock(tables_mutex);
+  if (tables != nullptr && tables->length >= length && tables->use_long_factor == use_long_factor) {
+    return tables;
+  }
+
+  // Grow geometrically so that the tables are recomputed a few times only while a sequence is generated, the short
+  // factors of LongRoPE only apply up to the original context.
+  int new_length = std::max(length, tables != nullptr ? 2 * tables->length : 0);
+  if (rope_scaling_type == RopeScalingType::LongRope && !use_long_factor) {
+    new_length = std::min(new_length, original_max_position_embeddings);
+  }
+
+  const int half = rotary_dim / 2;
+  const double factor = rope_scaling_factor;
+  double base = rope_theta;
+  if (rope_scaling_type == RopeScalingType::Ntk) {
+    base *= std::pow(factor, static_cast<double>(rotary_dim) / (rotary_dim - 2));
+  }
+
+  std::vector<double> inv_freq(half);
+  for (int i = 0; i < half; i++) {
+    inv_freq[i] = 1.0 / std::pow(base, 2.0 * i / rotary_dim);
+  }
+
+  double attention_factor = 1.0;
+  if (rope_scaling_type == RopeScalingType::Linear) {
+    for (auto& f : inv_freq) {
+      f /= factor;
+    }
+  } else if (rope_scaling_type == RopeScalingType::Yarn) {
+    // dimension of the frequency that rotates the given number of times over the original context
+    constexpr double kBetaFast = 32.0;
+    constexpr double kBetaSlow = 1.0;
+    constexpr double kPi = 3.14159265358979323846;
+    auto correction_dim = [&](double rotations) {
+      return rotary_dim * std::log(original_max_position_embeddings / (rotations * 2 * kPi)) / (2 * std::log(base));
+    };
+    const double low = std::max(std::floor(correction_dim(kBetaFast)), 0.0);
+    double high = std::min(std::ceil(correction_dim(kBetaSlow)), static_cast<double>(rotary_dim - 1));
+    if (high == low) {
+      high += 0.001;
+    }
+    for (int i = 0; i < half; i++) {
+      const double ramp = std::clamp((i - low) / (high - low), 0.0, 1.0);
+      inv_freq[i] = inv_freq[i] / factor * ramp + inv_freq[i] * (1.0 - ramp);
+    }
+    if (factor > 1.0) {
+      attention_factor = 0.1 * std::log(factor) + 1.0;
+    }
+  } else if (rope_scaling_type == RopeScalingType::LongRope) {
+    const std::vector<float>& dim_factor = use_long_factor ? long_factor : short_factor;
+    ORT_ENFORCE(static_cast<int>(dim_factor.size()) == half, "long_factor and short_factor must have ",
+                half, " elements, got ", dim_factor.size());
+    for (int i = 0; i < half; i++) {
+      inv_freq[i] /= dim_factor[i];
+    }
+    if (factor > 1.0) {
+      attention_factor = std::sqrt(1.0 + std::log(factor) / std::log(original_max_position_embeddings));
+    }
+  }
+
+  auto new_tables = std::make_shared<RotaryTables>();
+  new_tables->length = new_length;
+  new_tables->use_long_factor = use_long_factor;
+  new_tables->cos.resize(static_cast<size_t>(new_length) * half);
+  new_tables->sin.resize(new_tables->cos.size());
+  for (int p = 0; p < new_length; p++) {
+    for (int i = 0; i < half; i++) {
+      const double angle = p * inv_freq[i];
+      new_tables->cos[static_cast<size_t>(p) * half + i] = static_cast<T>(std::cos(angle) * attention_factor);
+      new_tables->sin[static_cast<size_t>(p) * half + i] = static_cast<T>(std::sin(angle) * attention_factor);
+    }
+  }
+
+  tables = std::move(new_tables);
+  return tables;
 }
 
 // TODO: rotary embedding in place
@@ -120,15 +239,32 @@ Status RotaryEmbedding<T>::Compute(OpKernelContext* context) const {
 
   Tensor* output = context->Output(0, input->Shape());
 
-  if (is_packed_batching == false && parameters.sequence_length > parameters.max_sequence_length) {
-    // Launch update_cos_sin_cache kernel with scale
-    ORT_NOT_IMPLEMENTED("Updating cos_cache and sin_cache in RotaryEmbedding is not currently supported");
-  }
-
   const T* input_src = input->Data<T>();
   const int64_t* pos_ids_data = position_ids->Data<int64_t>();
-  const T* cos_cache_data = cos_cache->Data<T>();
-  const T* sin_cache_data = sin_cache->Data<T>();
+  const T* cos_cache_data = nullptr;
+  const T* sin_cache_data = nullptr;
+  std::shared_ptr<const RotaryTables> computed_tables;
+  if (cos_cache != nullptr) {
+    if (is_packed_batching == false && parameters.sequence_length > parameters.max_sequence_length) {
+      // Launch update_cos_sin_cache kernel with scale
+      ORT_NOT_IMPLEMENTED("Updating cos_cache and sin_cache in RotaryEmbedding is not currently supported");
+    }
+    cos_cache_data = cos_cache->Data<T>();
+    sin_cache_data = sin_cache->Data<T>();
+  } else {
+    // the tables cover the positions of this run, position ids (1) give the position of the first token
+    const auto position_ids_span = position_ids->DataAsSpan<int64_t>();
+    const int64_t min_position = *std::min_element(position_ids_span.begin(), position_ids_span.end());
+    int64_t max_position = *std::max_element(position_ids_span.begin(), position_ids_span.end());
+    if (parameters.position_ids_format == 0) {
+      max_position += parameters.sequence_length - 1;
+    }
+    ORT_RETURN_IF(min_position < 0 || max_position >= std::numeric_limits<int>::max() / 2,
+                  "Input 'position_ids' shall be in the range [0, ", std::numeric_limits<int>::max() / 2, ")");
+    computed_tables = GetTables(static_cast<int>(max_position + 1), parameters.rotary_embedding_dim);
+    cos_cache_data = computed_tables->cos.data();
+    sin_cache_data = computed_tables->sin.data();
+  }
   T* output_dest = output->MutableData<T>();
 
   AllocatorPtr allocator;
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <memory>
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 #include "rotary_embedding_helper.h"
 
 namespace onnxruntime {
@@ -14,6 +18,16 @@ Status RunRotaryEmbedding(onnxruntime::concurrency::ThreadPool* tp, rotary_embed
                           const int64_t* position_ids, const T* cos_cache, const T* sin_cache, T* output,
                           bool interleaved);
 
+// Scaling of the rotary frequencies for the contexts longer than the one the model was trained with, used when the
+// cos and sin tables are computed by the kernel.
+enum class RopeScalingType {
+  None,
+  Linear,    // positions divided by the factor
+  Ntk,       // base of the frequencies scaled by factor ^ (d / (d - 2))
+  Yarn,      // high frequencies kept, low frequencies divided by the factor, with a ramp in between
+  LongRope,  // frequencies divided by the short or long factor of each dimension
+};
+
 template <typename T>
 class RotaryEmbedding final : public OpKernel {
  public:
@@ -21,11 +35,32 @@ class RotaryEmbedding final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  protected:
+  // cos and sin tables with shape (length, rotary_embedding_dim / 2)
+  struct RotaryTables {
+    int length;
+    bool use_long_factor;
+    std::vector<T> cos;
+    std::vector<T> sin;
+  };
+
+  // Returns tables of at least the given length, computing them when the ones of the previous runs are too short.
+  std::shared_ptr<const RotaryTables> GetTables(int length, int rotary_dim) const;
+
   float scale;
   int num_heads;
   int rotary_embedding_dim;
   bool interleaved;
   bool is_packed_batching;
+
+  float rope_theta;
+  RopeScalingType rope_scaling_type;
+  float rope_scaling_factor;
+  int original_max_position_embeddings;
+  std::vector<float> long_factor;
+  std::vector<float> short_factor;
+
+  mutable std::shared_ptr<const RotaryTables> tables;
+  mutable OrtMutex tables_mutex;
 };
 
 }  // namespace contrib
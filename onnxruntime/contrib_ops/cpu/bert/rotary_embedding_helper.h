@@ -35,8 +35,8 @@ Status CheckInputs(const T* input,
                    void* parameters) {
   //    input        : (batch_size, sequence_length, hidden_size)
   //    position ids : (1) or (batch_size, sequence_length)
-  //    cos cache    : (max_sequence_length, rotary_embedding_dim / 2)
-  //    sin cache    : (max_sequence_length, rotary_embedding_dim / 2)
+  //    cos cache    : (max_sequence_length, rotary_embedding_dim / 2), optional
+  //    sin cache    : (max_sequence_length, rotary_embedding_dim / 2), optional
 
   // Check input
   const auto& input_dims = input->Shape().GetDims();
@@ -51,19 +51,29 @@ Status CheckInputs(const T* input,
                            "dimensions, got ", position_ids_dims.size());
   }
   // Check cos_cache and sin_cache
-  const auto& cos_cache_dims = cos_cache->Shape().GetDims();
-  if (cos_cache_dims.size() != 2) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'cos_cache' is expected to have 2 dimensions, got ",
-                           cos_cache_dims.size());
+  if ((cos_cache == nullptr) != (sin_cache == nullptr)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'cos_cache' and 'sin_cache' shall be both present ",
+                           "or both absent");
   }
-  const auto& sin_cache_dims = sin_cache->Shape().GetDims();
-  if (sin_cache_dims.size() != 2) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'sin_cache' is expected to have 2 dimensions, got ",
-                           sin_cache_dims.size());
-  }
-  if (cos_cache_dims[0] != sin_cache_dims[0] || cos_cache_dims[1] != sin_cache_dims[1]) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'cos_cache' and 'sin_cache' are expected to have ",
-                           "the same shape");
+  const bool has_cache = cos_cache != nullptr;
+  if (has_cache) {
+    const auto& cos_cache_dims = cos_cache->Shape().GetDims();
+    if (cos_cache_dims.size() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'cos_cache' is expected to have 2 dimensions, got ",
+                             cos_cache_dims.size());
+    }
+    const auto& sin_cache_dims = sin_cache->Shape().GetDims();
+    if (sin_cache_dims.size() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'sin_cache' is expected to have 2 dimensions, got ",
+                             sin_cache_dims.size());
+    }
+    if (cos_cache_dims[0] != sin_cache_dims[0] || cos_cache_dims[1] != sin_cache_dims[1]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'cos_cache' and 'sin_cache' are expected to have ",
+                             "the same shape");
+    }
+  } else if (num_heads == 0 && input_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads must be provided for a 3D input when ",
+                           "'cos_cache' and 'sin_cache' are absent");
   }
 
   // Check num_heads and rotary_embedding_dim
@@ -84,9 +94,16 @@ Status CheckInputs(const T* input,
     hidden_size = static_cast<int>(input_dims[1]) * static_cast<int>(input_dims[3]);
     transposed = true;
   }
-  int max_sequence_length = static_cast<int>(cos_cache_dims[0]);
-  int head_size = rotary_embedding_dim == 0 ? static_cast<int>(cos_cache_dims[1]) * 2
-                                            : static_cast<int>(hidden_size / num_heads);
+  // Without the caches, the tables are computed by the kernel for the positions in use.
+  int max_sequence_length = has_cache ? static_cast<int>(cos_cache->Shape()[0]) : 0;
+  int head_size = 0;
+  if (rotary_embedding_dim == 0 && has_cache) {
+    head_size = static_cast<int>(cos_cache->Shape()[1]) * 2;
+  } else if (num_heads > 0) {
+    head_size = static_cast<int>(hidden_size / num_heads);
+  } else {
+    head_size = static_cast<int>(input_dims[3]);
+  }
   if (rotary_embedding_dim > 0 && rotary_embedding_dim > head_size) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "rotary_embedding_dim must be less than or equal to ",
                            "head_size");
@@ -110,13 +127,13 @@ Status CheckInputs(const T* input,
   }
 
   // Check cos_cache input shapes
-  if (max_sequence_length != static_cast<int>(cos_cache_dims[0])) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'cos_cache' dimension 0 should be same as ",
-                           "max_sequence_length, got ", cos_cache_dims[0]);
-  }
-  if ((head_size / 2) != static_cast<int>(cos_cache_dims[1]) && (rotary_embedding_dim > 0 && (rotary_embedding_dim / 2) != static_cast<int>(cos_cache_dims[1]))) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'cos_cache' dimension 1 should be same as ",
-                           "head_size / 2 or rotary_embedding_dim / 2, got ", cos_cache_dims[1]);
+  if (has_cache) {
+    const int64_t cache_dim = cos_cache->Shape()[1];
+    if ((head_size / 2) != static_cast<int>(cache_dim) &&
+        (rotary_embedding_dim > 0 && (rotary_embedding_dim / 2) != static_cast<int>(cache_dim))) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'cos_cache' dimension 1 should be same as ",
+                             "head_size / 2 or rotary_embedding_dim / 2, got ", cache_dim);
+    }
   }
 
   num_heads = num_heads > 0 ? num_heads : static_cast<int>(hidden_size / head_size);
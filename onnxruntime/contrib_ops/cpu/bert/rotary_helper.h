@@ -42,6 +42,62 @@ Status PackVIntoRotaryQKV(concurrency::ThreadPool* tp,
   return Status::OK();
 }
 
+// Transposes input (B, S, N, H) to output (B, N, S, H) and applies the rotary embedding of the position of every token
+// to the first rotary_heads heads in the same pass. The other heads, like V of a packed QKV, are copied.
+template <typename T>
+Status TransposeWithRotaryToBNSH(concurrency::ThreadPool* tp,
+                                 int batch_size,
+                                 int sequence_length,
+                                 int num_heads,
+                                 int rotary_heads,
+                                 int head_size,
+                                 int rotary_embedding_dim,
+                                 bool interleaved,
+                                 const int64_t* position_ids,  // (B, S)
+                                 const T* cos_cache,
+                                 const T* sin_cache,
+                                 const T* input,
+                                 T* output) {
+  const int half_rotary_emb_dim = rotary_embedding_dim / 2;
+  const int loop_len = batch_size * sequence_length * num_heads;
+  const double cost = static_cast<double>(head_size);
+  ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t ptr = begin; ptr != end; ++ptr) {
+      const int b = static_cast<int>((ptr / num_heads) / sequence_length);
+      const int s = static_cast<int>((ptr / num_heads) % sequence_length);
+      const int n = static_cast<int>(ptr % num_heads);
+      const T* input_data = input + static_cast<std::ptrdiff_t>(ptr) * head_size;
+      T* output_data = output + ((static_cast<std::ptrdiff_t>(b) * num_heads + n) * sequence_length + s) * head_size;
+
+      int i = 0;
+      if (n < rotary_heads) {
+        const int cache_offset = static_cast<int>(position_ids[b * sequence_length + s]) * half_rotary_emb_dim;
+        const T* cos_data = cos_cache + cache_offset;
+        const T* sin_data = sin_cache + cache_offset;
+        for (; i < rotary_embedding_dim; i++) {
+          int cache_idx;
+          T sign;
+          int j;
+          if (interleaved) {
+            cache_idx = (i / 2) % half_rotary_emb_dim;
+            sign = (i % 2 == 0) ? static_cast<T>(-1) : static_cast<T>(1);
+            j = (i % 2 == 0) ? i + 1 : i - 1;
+          } else {
+            cache_idx = i % half_rotary_emb_dim;
+            sign = (i < half_rotary_emb_dim) ? static_cast<T>(-1) : static_cast<T>(1);
+            j = (i + half_rotary_emb_dim) % rotary_embedding_dim;
+          }
+          output_data[i] = input_data[i] * cos_data[cache_idx] + sign * input_data[j] * sin_data[cache_idx];
+        }
+      }
+      for (; i < head_size; i++) {
+        output_data[i] = input_data[i];
+      }
+    }
+  });
+  return Status::OK();
+}
+
 }  // namespace rotary_helper
 }  // namespace contrib
 }  // namespace onnxruntime
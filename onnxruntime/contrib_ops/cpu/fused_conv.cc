@@ -1,7 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
+#include "core/common/safeint.h"
 #include "core/providers/cpu/nn/conv.h"
+#include "core/providers/cpu/nn/conv_attributes.h"
+#include "core/util/math.h"
 #include "contrib_ops/cpu/fused_activation.h"
 
 namespace onnxruntime {
@@ -22,5 +27,275 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     FusedConvFloat);
 
+// Channels last convolution with the bias, the optional residual input Z and the activation fused in. Every image
+// is one GEMM per group of its (output pixels x kernel) im2col matrix and the filters, which are packed once when
+// they are constant. The output rows start from the bias plus Z so that the GEMM accumulates onto them, and the
+// activation is applied afterwards, so the Add of a residual block costs no extra pass over the output.
+class NhwcFusedConvFloat final : public OpKernel {
+ public:
+  NhwcFusedConvFloat(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  // Reorders the filters from (M x C/group x kernel) to (M x kernel x C/group), the order of the channels last
+  // im2col rows, so that every output channel is a row of the transposed GEMM operand B.
+  static void ReorderFilter(const float* input, float* output, size_t output_channels, size_t input_channels,
+                            size_t kernel_size) {
+    for (size_t oc = 0; oc < output_channels; oc++) {
+      for (size_t k = 0; k < kernel_size; k++) {
+        for (size_t ic = 0; ic < input_channels; ic++) {
+          *output++ = input[(oc * input_channels + ic) * kernel_size + k];
+        }
+      }
+    }
+  }
+
+  MLAS_ACTIVATION activation_;
+  ConvAttributes conv_attrs_;
+  TensorShape W_shape_;
+  BufferUniquePtr packed_W_buffer_;
+  size_t packed_W_size_{0};
+};
+
+Status NhwcFusedConvFloat::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                   /*out*/ bool& is_packed,
+                                   /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() <= 2 || shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  const size_t output_channels = static_cast<size_t>(shape[0]);
+  const size_t group_input_channels = static_cast<size_t>(shape[1]);
+  const size_t kernel_size = static_cast<size_t>(shape.SizeFromDimension(2));
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t group_output_channels = output_channels / group_count;
+  const size_t kernel_dim = group_input_channels * kernel_size;
+
+  packed_W_size_ = MlasGemmPackBSize(group_output_channels, kernel_dim);
+  if (packed_W_size_ == 0) {
+    return Status::OK();
+  }
+
+  const size_t packed_W_data_size = SafeInt<size_t>(group_count) * packed_W_size_;
+  auto* packed_W = static_cast<uint8_t*>(alloc->Alloc(packed_W_data_size));
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_W, 0, packed_W_data_size);
+  packed_W_buffer_ = BufferUniquePtr(packed_W, BufferDeleter(alloc));
+
+  auto* group_reordered_W = static_cast<float*>(
+      alloc->Alloc(SafeInt<size_t>(sizeof(float)) * group_output_channels * kernel_dim));
+  BufferUniquePtr group_reordered_W_buffer(group_reordered_W, BufferDeleter(alloc));
+
+  const auto* Wdata = tensor.Data<float>();
+  for (size_t group_id = 0; group_id < group_count; ++group_id) {
+    ReorderFilter(Wdata + group_id * group_output_channels * kernel_dim, group_reordered_W,
+                  group_output_channels, group_input_channels, kernel_size);
+    MlasGemmPackB(CblasTrans, group_output_channels, kernel_dim, group_reordered_W, kernel_dim,
+                  packed_W + group_id * packed_W_size_);
+  }
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_W_buffer_));
+    prepacked_weights->buffer_sizes_.push_back(packed_W_data_size);
+  }
+
+  W_shape_ = shape;
+  is_packed = true;
+  return Status::OK();
+}
+
+Status NhwcFusedConvFloat::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                     int input_idx,
+                                                     /*out*/ bool& used_shared_buffers) {
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  used_shared_buffers = true;
+  packed_W_buffer_ = std::move(prepacked_buffers[0]);
+  return Status::OK();
+}
+
+Status NhwcFusedConvFloat::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = packed_W_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const TensorShape& W_shape = W ? W->Shape() : W_shape_;
+  const Tensor* B = context->Input<Tensor>(2);
+  const Tensor* Sum = context->Input<Tensor>(3);
+
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape, true));
+
+  const int64_t N = X->Shape()[0];
+  const int64_t M = W_shape[0];
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
+  const size_t kernel_rank = kernel_shape.size();
+
+  ConvAttributes::ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_rank * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_rank, 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_rank, 1);
+  }
+
+  // The spatial shape comes from the input of every run, so the kernel serves models with symbolic dimensions.
+  const int64_t C = X->Shape()[1 + kernel_rank];
+  TensorShape input_shape = X->Shape().Slice(1, 1 + kernel_rank);
+  TensorShapeVector Y_dims({N});
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Y_dims.push_back(M);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(1, 1 + kernel_rank);
+
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+  if (Sum && Sum->Shape() != Y->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Z shape does not match output shape.",
+                           " Z: ", Sum->Shape().ToString().c_str(),
+                           " Output: ", Y->Shape().ToString().c_str());
+  }
+
+  const size_t input_image_size = static_cast<size_t>(input_shape.Size());
+  const size_t output_image_size = static_cast<size_t>(output_shape.Size());
+  const size_t kernel_size = static_cast<size_t>(TensorShape(kernel_shape).Size());
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t group_input_channels = static_cast<size_t>(W_shape[1]);
+  const size_t group_output_channels = static_cast<size_t>(M) / group_count;
+  const size_t kernel_dim = group_input_channels * kernel_size;
+  const size_t input_channels = static_cast<size_t>(C);
+  const size_t output_channels = static_cast<size_t>(M);
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Handle the case of a dynamic weight filter.
+  BufferUniquePtr reordered_W_buffer;
+  if (!packed_W_buffer_) {
+    auto* reordered_W = static_cast<float*>(alloc->Alloc(SafeInt<size_t>(sizeof(float)) * W_shape.Size()));
+    reordered_W_buffer = BufferUniquePtr(reordered_W, BufferDeleter(alloc));
+    ReorderFilter(W->Data<float>(), reordered_W, output_channels, group_input_channels, kernel_size);
+  }
+
+  // Pointwise convolutions read the input in place, rows of the channels last image are the im2col rows.
+  const bool use_col_buffer = kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding();
+  const size_t col_buffer_size = kernel_dim * output_image_size;
+  BufferUniquePtr col_buffer;
+  if (use_col_buffer) {
+    auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * group_count * col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+  }
+  float* col_data = static_cast<float*>(col_buffer.get());
+
+  const float* Xdata = X->Data<float>();
+  const float* Bdata = B != nullptr ? B->Data<float>() : nullptr;
+  const float* sum_data = Sum != nullptr ? Sum->Data<float>() : nullptr;
+  float* Ydata = Y->MutableData<float>();
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  InlinedVector<MLAS_SGEMM_DATA_PARAMS> gemm_params(group_count);
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    if (use_col_buffer) {
+      for (size_t group_id = 0; group_id < group_count; ++group_id) {
+        math::Im2col<float, StorageOrder::NHWC>()(
+            Xdata + group_id * group_input_channels,
+            static_cast<int64_t>(group_input_channels),
+            C,
+            input_shape.GetDims().data(),
+            output_shape.GetDims().data(),
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<ptrdiff_t>(kernel_rank),
+            col_data + group_id * col_buffer_size);
+      }
+    }
+
+    // The GEMM accumulates onto the bias and the residual input.
+    if (sum_data != nullptr) {
+      std::copy_n(sum_data, output_image_size * output_channels, Ydata);
+    }
+    if (Bdata != nullptr) {
+      for (size_t pixel = 0; pixel < output_image_size; ++pixel) {
+        float* y = Ydata + pixel * output_channels;
+        for (size_t oc = 0; oc < output_channels; ++oc) {
+          y[oc] = (sum_data != nullptr ? y[oc] : 0.0f) + Bdata[oc];
+        }
+      }
+    }
+
+    for (size_t group_id = 0; group_id < group_count; ++group_id) {
+      MLAS_SGEMM_DATA_PARAMS& params = gemm_params[group_id];
+      if (use_col_buffer) {
+        params.A = col_data + group_id * col_buffer_size;
+        params.lda = kernel_dim;
+      } else {
+        params.A = Xdata + group_id * group_input_channels;
+        params.lda = input_channels;
+      }
+      if (packed_W_buffer_) {
+        params.B = reinterpret_cast<const float*>(static_cast<const uint8_t*>(packed_W_buffer_.get()) +
+                                                  group_id * packed_W_size_);
+        params.BIsPacked = true;
+      } else {
+        params.B = static_cast<const float*>(reordered_W_buffer.get()) + group_id * group_output_channels * kernel_dim;
+        params.ldb = kernel_dim;
+      }
+      params.C = Ydata + group_id * group_output_channels;
+      params.ldc = output_channels;
+      params.beta = (Bdata != nullptr || sum_data != nullptr) ? 1.0f : 0.0f;
+    }
+
+    MlasGemmBatch(CblasNoTrans, CblasTrans, output_image_size, group_output_channels, kernel_dim,
+                  gemm_params.data(), group_count, thread_pool);
+
+    MlasActivation(&activation_, Ydata, nullptr, output_image_size, output_channels, output_channels);
+
+    Xdata += input_image_size * input_channels;
+    Ydata += output_image_size * output_channels;
+    if (sum_data != nullptr) {
+      sum_data += output_image_size * output_channels;
+    }
+  }
+
+  return Status::OK();
+}
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NhwcFusedConv,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcFusedConvFloat);
+
 }  // namespace contrib
 }  // namespace onnxruntime
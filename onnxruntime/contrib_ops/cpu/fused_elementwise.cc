@@ -0,0 +1,245 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "core/common/inlined_containers.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Elements of the output computed together, the registers of a tile stay in the L1 cache.
+constexpr size_t kTileSize = 256;
+
+struct Operand {
+  const float* data;
+  bool scalar;
+};
+
+template <typename TFunc>
+void ComputeBinary(Operand a, Operand b, float* y, size_t count, TFunc func) {
+  if (a.scalar && b.scalar) {
+    std::fill_n(y, count, func(*a.data, *b.data));
+  } else if (a.scalar) {
+    const float value = *a.data;
+    for (size_t i = 0; i < count; ++i) {
+      y[i] = func(value, b.data[i]);
+    }
+  } else if (b.scalar) {
+    const float value = *b.data;
+    for (size_t i = 0; i < count; ++i) {
+      y[i] = func(a.data[i], value);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      y[i] = func(a.data[i], b.data[i]);
+    }
+  }
+}
+
+template <typename TFunc>
+void ComputeUnary(Operand x, float* y, size_t count, TFunc func) {
+  if (x.scalar) {
+    std::fill_n(y, count, func(*x.data));
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      y[i] = func(x.data[i]);
+    }
+  }
+}
+
+using MlasUnaryFunction = void(MLASCALL*)(const float*, float*, size_t);
+
+void ComputeUnary(Operand x, float* y, size_t count, MlasUnaryFunction func) {
+  if (x.scalar) {
+    float value;
+    func(x.data, &value, 1);
+    std::fill_n(y, count, value);
+  } else {
+    func(x.data, y, count);
+  }
+}
+
+void ComputeInstruction(FusedElementwise::OpCode op, Operand a, Operand b, float* y, size_t count) {
+  using OpCode = FusedElementwise::OpCode;
+  switch (op) {
+    case OpCode::Add:
+      ComputeBinary(a, b, y, count, [](float u, float v) { return u + v; });
+      break;
+    case OpCode::Sub:
+      ComputeBinary(a, b, y, count, [](float u, float v) { return u - v; });
+      break;
+    case OpCode::Mul:
+      ComputeBinary(a, b, y, count, [](float u, float v) { return u * v; });
+      break;
+    case OpCode::Div:
+      ComputeBinary(a, b, y, count, [](float u, float v) { return u / v; });
+      break;
+    case OpCode::Abs:
+      ComputeUnary(a, y, count, [](float u) { return std::fabs(u); });
+      break;
+    case OpCode::Erf:
+      ComputeUnary(a, y, count, MlasComputeErf);
+      break;
+    case OpCode::Exp:
+      ComputeUnary(a, y, count, MlasComputeExp);
+      break;
+    case OpCode::Neg:
+      ComputeUnary(a, y, count, [](float u) { return -u; });
+      break;
+    case OpCode::Relu:
+      ComputeUnary(a, y, count, [](float u) { return std::max(u, 0.0f); });
+      break;
+    case OpCode::Sigmoid:
+      ComputeUnary(a, y, count, MlasComputeLogistic);
+      break;
+    case OpCode::Sqrt:
+      ComputeUnary(a, y, count, [](float u) { return std::sqrt(u); });
+      break;
+    case OpCode::Tanh:
+      ComputeUnary(a, y, count, MlasComputeTanh);
+      break;
+  }
+}
+
+}  // namespace
+
+bool FusedElementwise::GetOpCode(const std::string& op_type, OpCode& op) {
+  static const InlinedHashMap<std::string, OpCode> op_codes{
+      {"Add", OpCode::Add},
+      {"Sub", OpCode::Sub},
+      {"Mul", OpCode::Mul},
+      {"Div", OpCode::Div},
+      {"Abs", OpCode::Abs},
+      {"Erf", OpCode::Erf},
+      {"Exp", OpCode::Exp},
+      {"Neg", OpCode::Neg},
+      {"Relu", OpCode::Relu},
+      {"Sigmoid", OpCode::Sigmoid},
+      {"Sqrt", OpCode::Sqrt},
+      {"Tanh", OpCode::Tanh},
+  };
+  auto it = op_codes.find(op_type);
+  if (it == op_codes.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  input_count_ = info.GetInputCount();
+  std::vector<std::string> ops = info.GetAttrsOrDefault<std::string>("ops");
+  std::vector<int64_t> operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise: the program must have at least one operator.");
+  ORT_ENFORCE(operands.size() == 2 * ops.size(),
+              "FusedElementwise: 'operands' must hold two registers per operator, got ", operands.size(),
+              " for ", ops.size(), " operators.");
+
+  program_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Instruction instruction{};
+    ORT_ENFORCE(GetOpCode(ops[i], instruction.op), "FusedElementwise: unsupported operator ", ops[i]);
+    instruction.a = operands[2 * i];
+    instruction.b = operands[2 * i + 1];
+    // an instruction can only read the inputs and the results of the instructions before it
+    const int64_t registers = static_cast<int64_t>(input_count_ + i);
+    ORT_ENFORCE(instruction.a >= 0 && instruction.a < registers,
+                "FusedElementwise: invalid register ", instruction.a, " for operator ", i);
+    if (IsUnary(instruction.op)) {
+      ORT_ENFORCE(instruction.b == -1, "FusedElementwise: unary operator ", i, " must have -1 as second register.");
+    } else {
+      ORT_ENFORCE(instruction.b >= 0 && instruction.b < registers,
+                  "FusedElementwise: invalid register ", instruction.b, " for operator ", i);
+    }
+    program_.push_back(instruction);
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  // The output has the shape of the largest input, every other input has this shape or a single element.
+  const TensorShape* output_shape = nullptr;
+  for (size_t i = 0; i < input_count_; ++i) {
+    const TensorShape& shape = context->Input<Tensor>(static_cast<int>(i))->Shape();
+    if (output_shape == nullptr || shape.Size() > output_shape->Size()) {
+      output_shape = &shape;
+    }
+  }
+  ORT_RETURN_IF(output_shape == nullptr, "FusedElementwise requires at least one input.");
+
+  InlinedVector<Operand> inputs;
+  inputs.reserve(input_count_);
+  for (size_t i = 0; i < input_count_; ++i) {
+    const Tensor& input = *context->Input<Tensor>(static_cast<int>(i));
+    const TensorShape& shape = input.Shape();
+    const bool scalar = shape.Size() == 1 && shape.NumDimensions() <= output_shape->NumDimensions();
+    ORT_RETURN_IF_NOT(scalar || shape == *output_shape, "FusedElementwise: input ", i, " with shape ", shape,
+                      " can not be broadcast to ", *output_shape);
+    inputs.push_back(Operand{input.Data<float>(), scalar});
+  }
+
+  Tensor& output = *context->Output(0, *output_shape);
+  const size_t size = static_cast<size_t>(output_shape->Size());
+  if (size == 0) {
+    return Status::OK();
+  }
+  float* output_data = output.MutableData<float>();
+
+  size_t tensor_inputs = 0;
+  for (const auto& input : inputs) {
+    tensor_inputs += input.scalar ? 0 : 1;
+  }
+  const std::ptrdiff_t tile_count = static_cast<std::ptrdiff_t>((size + kTileSize - 1) / kTileSize);
+  const TensorOpCost cost{static_cast<double>(tensor_inputs * kTileSize * sizeof(float)),
+                          static_cast<double>(kTileSize * sizeof(float)),
+                          static_cast<double>(program_.size() * kTileSize)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), tile_count, cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // the result of the last instruction goes to the output
+        auto registers = std::make_unique<float[]>(program_.size() * kTileSize);
+        for (std::ptrdiff_t tile = first; tile < last; ++tile) {
+          const size_t offset = static_cast<size_t>(tile) * kTileSize;
+          const size_t count = std::min(kTileSize, size - offset);
+
+          auto get_operand = [&](int64_t index) {
+            const size_t r = static_cast<size_t>(index);
+            if (r < input_count_) {
+              const Operand& input = inputs[r];
+              return input.scalar ? input : Operand{input.data + offset, false};
+            }
+            return Operand{registers.get() + (r - input_count_) * kTileSize, false};
+          };
+
+          for (size_t i = 0; i < program_.size(); ++i) {
+            const Instruction& instruction = program_[i];
+            float* y = i + 1 == program_.size() ? output_data + offset : registers.get() + i * kTileSize;
+            ComputeInstruction(instruction.op, get_operand(instruction.a),
+                               instruction.b < 0 ? Operand{nullptr, true} : get_operand(instruction.b), y, count);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
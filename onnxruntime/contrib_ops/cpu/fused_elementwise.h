@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Runs a chain of elementwise operators fused by ElementwiseFusion in one pass over the output.
+// The program is evaluated on tiles of the output that stay in the L1 cache, every instruction reads the inputs or
+// the results of the previous instructions and the last one writes the output.
+class FusedElementwise final : public OpKernel {
+ public:
+  enum class OpCode {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Abs,
+    Erf,
+    Exp,
+    Neg,
+    Relu,
+    Sigmoid,
+    Sqrt,
+    Tanh,
+  };
+
+  // Registers 0 to input count - 1 are the inputs, register input count + i is the result of instruction i.
+  struct Instruction {
+    OpCode op;
+    int64_t a;
+    int64_t b;  // -1 for the unary operators
+  };
+
+  // Returns false if `op_type` is not an elementwise operator supported by the program.
+  static bool GetOpCode(const std::string& op_type, OpCode& op);
+  static bool IsUnary(OpCode op) { return op >= OpCode::Abs; }
+
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  size_t input_count_;
+  std::vector<Instruction> program_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -14,17 +14,20 @@ namespace contrib {
                                           KernelDefBuilder()                                                \
                                               .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())        \
                                               .TypeConstraint("U", DataTypeImpl::GetTensorType<T>())        \
-                                              .TypeConstraint("V", DataTypeImpl::GetTensorType<T>()),       \
+                                              .TypeConstraint("V", DataTypeImpl::GetTensorType<T>())        \
+                                              .MayInplace(0, 0),                                            \
                                           LayerNorm<false>);                                                \
   ONNX_OPERATOR_TYPED_KERNEL_EX(SimplifiedLayerNormalization, kOnnxDomain, 1, T, kCpuExecutionProvider,     \
                                 KernelDefBuilder()                                                          \
                                     .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                  \
                                     .TypeConstraint("U", DataTypeImpl::GetTensorType<T>())                  \
-                                    .TypeConstraint("V", DataTypeImpl::GetTensorType<T>()),                 \
+                                    .TypeConstraint("V", DataTypeImpl::GetTensorType<T>())                  \
+                                    .MayInplace(0, 0),                                                      \
                                 LayerNorm<true>);
 
 REGISTER_CONTRIB_KERNELS(float)
 REGISTER_CONTRIB_KERNELS(double)
+REGISTER_CONTRIB_KERNELS(MLFloat16)
 
 }  // namespace contrib
 }  // namespace onnxruntime
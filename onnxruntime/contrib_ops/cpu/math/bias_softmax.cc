@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <type_traits>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = softmax(X + B) with the OpSet-11 definition of the axis, B broadcast along the batches of X as described in
+// BiasSoftmaxFusion. Every batch is added to its bias row and normalized while it is in the cache, float16 batches
+// are computed in float.
+class BiasSoftmax final : public OpKernel {
+ public:
+  explicit BiasSoftmax(const OpKernelInfo& info) : OpKernel(info) {
+    axis_ = info.GetAttrOrDefault<int64_t>("axis", 1);
+    int64_t is_inner_broadcast_value;
+    ORT_ENFORCE(info.GetAttr<int64_t>("is_inner_broadcast", &is_inner_broadcast_value).IsOK());
+    is_inner_broadcast_ = is_inner_broadcast_value != 0;
+  }
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  template <typename T>
+  void ComputeImpl(const T* X, const T* B, T* Y, size_t batch_count, size_t element_count,
+                   size_t bias_batch_count, concurrency::ThreadPool* thread_pool) const;
+
+  int64_t axis_;
+  bool is_inner_broadcast_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    BiasSoftmax,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraints<float, MLFloat16>()),
+    BiasSoftmax);
+
+template <typename T>
+void BiasSoftmax::ComputeImpl(const T* X, const T* B, T* Y, size_t batch_count, size_t element_count,
+                              size_t bias_batch_count, concurrency::ThreadPool* thread_pool) const {
+  // consecutive batches share a bias row with the inner broadcast, else the bias rows repeat along the batches
+  const size_t batches_per_bias = batch_count / bias_batch_count;
+  const TensorOpCost cost{static_cast<double>(2 * element_count * sizeof(T)),
+                          static_cast<double>(element_count * sizeof(T)),
+                          static_cast<double>(element_count * 8)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(batch_count), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::unique_ptr<float[]> buffer;
+        if constexpr (std::is_same<T, MLFloat16>::value) {
+          buffer = std::make_unique<float[]>(2 * element_count);
+        }
+
+        for (std::ptrdiff_t b = first; b < last; ++b) {
+          const size_t batch = static_cast<size_t>(b);
+          const size_t bias_batch = is_inner_broadcast_ ? batch / batches_per_bias : batch % bias_batch_count;
+          const T* x = X + batch * element_count;
+          const T* bias = B + bias_batch * element_count;
+          T* y = Y + batch * element_count;
+
+          if constexpr (std::is_same<T, float>::value) {
+            for (size_t i = 0; i < element_count; ++i) {
+              y[i] = x[i] + bias[i];
+            }
+            MlasComputeSoftmax(y, y, 1, element_count, false, nullptr);
+          } else {
+            float* row = buffer.get();
+            float* bias_row = row + element_count;
+            MlasConvertHalfToFloatBuffer(&x[0].val, row, element_count);
+            MlasConvertHalfToFloatBuffer(&bias[0].val, bias_row, element_count);
+            for (size_t i = 0; i < element_count; ++i) {
+              row[i] += bias_row[i];
+            }
+            MlasComputeSoftmax(row, row, 1, element_count, false, nullptr);
+            for (size_t i = 0; i < element_count; ++i) {
+              y[i] = MLFloat16(row[i]);
+            }
+          }
+        }
+      });
+}
+
+Status BiasSoftmax::Compute(OpKernelContext* ctx) const {
+  const Tensor* X = ctx->Input<Tensor>(0);
+  const Tensor* B = ctx->Input<Tensor>(1);
+  const TensorShape& X_shape = X->Shape();
+  Tensor* Y = ctx->Output(0, X_shape);
+
+  if (X_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t axis = static_cast<size_t>(HandleNegativeAxis(axis_, X_shape.NumDimensions()));
+  const size_t batch_count = narrow<size_t>(X_shape.SizeToDimension(axis));
+  const size_t element_count = narrow<size_t>(X_shape.SizeFromDimension(axis));
+  const size_t bias_size = narrow<size_t>(B->Shape().Size());
+  ORT_RETURN_IF_NOT(bias_size != 0 && bias_size % element_count == 0 &&
+                        batch_count % (bias_size / element_count) == 0,
+                    "BiasSoftmax: bias shape ", B->Shape(), " can not be broadcast to ", X_shape, " with axis ", axis);
+  const size_t bias_batch_count = bias_size / element_count;
+
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  if (X->IsDataType<float>()) {
+    ComputeImpl(X->Data<float>(), B->Data<float>(), Y->MutableData<float>(), batch_count, element_count,
+                bias_batch_count, thread_pool);
+  } else {
+    ComputeImpl(X->Data<MLFloat16>(), B->Data<MLFloat16>(), Y->MutableData<MLFloat16>(), batch_count,
+                element_count, bias_batch_count, thread_pool);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,268 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    MoE,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MoE);
+
+namespace {
+
+Status CheckShape(const Tensor* tensor, const char* name, std::initializer_list<int64_t> dims) {
+  if (tensor != nullptr && tensor->Shape() != TensorShape(dims)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MoE: ", name, " must have the shape ",
+                           TensorShape(dims), ", got ", tensor->Shape());
+  }
+  return Status::OK();
+}
+
+// C = A * B + bias for the rows of A, with the bias broadcast to the rows if present. Like in the CUDA kernel, the
+// (K, N) weights B of an expert are stored column major, that is as the rows of B^T.
+void Linear(const float* A, size_t rows, size_t K, size_t N, const float* B, const float* bias, float* C,
+            concurrency::ThreadPool* thread_pool) {
+  if (bias != nullptr) {
+    for (size_t i = 0; i < rows; ++i) {
+      std::copy_n(bias, N, C + i * N);
+    }
+  }
+  MlasGemm(CblasNoTrans, CblasTrans, rows, N, K, 1.0f, A, K, B, K, bias != nullptr ? 1.0f : 0.0f, C, N,
+           thread_pool);
+}
+
+void ApplyActivation(MoEActivationType activation_type, float* data, size_t count) {
+  switch (activation_type) {
+    case MoEActivationType::Relu:
+      for (size_t i = 0; i < count; ++i) {
+        data[i] = std::max(data[i], 0.0f);
+      }
+      break;
+    case MoEActivationType::Gelu:
+      // the tanh approximation used by the CUDA kernel
+      for (size_t i = 0; i < count; ++i) {
+        const float x = data[i];
+        data[i] = 0.5f * x * (1.0f + std::tanh(0.7978845608f * (x + 0.044715f * x * x * x)));
+      }
+      break;
+    case MoEActivationType::Silu:
+      for (size_t i = 0; i < count; ++i) {
+        data[i] = data[i] / (1.0f + std::exp(-data[i]));
+      }
+      break;
+    case MoEActivationType::Identity:
+      break;
+  }
+}
+
+}  // namespace
+
+MoE::MoE(const OpKernelInfo& info) : OpKernel(info) {
+  ORT_ENFORCE(info.GetAttr<int64_t>("k", &k_).IsOK());
+  ORT_ENFORCE(k_ > 0, "MoE: k must be positive, got ", k_);
+
+  const std::string activation_type = info.GetAttrOrDefault<std::string>("activation_type", "relu");
+  if (activation_type == "relu") {
+    activation_type_ = MoEActivationType::Relu;
+  } else if (activation_type == "gelu") {
+    activation_type_ = MoEActivationType::Gelu;
+  } else if (activation_type == "silu") {
+    activation_type_ = MoEActivationType::Silu;
+  } else if (activation_type == "identity") {
+    activation_type_ = MoEActivationType::Identity;
+  } else {
+    ORT_THROW("Unsupported MoE activation type: ", activation_type);
+  }
+
+  normalize_routing_weights_ = info.GetAttrOrDefault<int64_t>("normalize_routing_weights", 0) == 1;
+}
+
+Status MoE::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+  const Tensor* fc1_experts_weights = context->Input<Tensor>(2);
+  const Tensor* fc1_experts_bias = context->Input<Tensor>(3);
+  const Tensor* fc2_experts_weights = context->Input<Tensor>(4);
+  const Tensor* fc2_experts_bias = context->Input<Tensor>(5);
+  const Tensor* fc3_experts_weights = context->Input<Tensor>(6);
+  const Tensor* fc3_experts_bias = context->Input<Tensor>(7);
+
+  const TensorShape& input_shape = input->Shape();
+  ORT_RETURN_IF_NOT(input_shape.NumDimensions() == 2 || input_shape.NumDimensions() == 3,
+                    "MoE: input must be 2D or 3D, got ", input_shape);
+  const auto& fc1_dims = fc1_experts_weights->Shape().GetDims();
+  ORT_RETURN_IF_NOT(fc1_dims.size() == 3, "MoE: fc1_experts_weights must be 3D, got ", fc1_experts_weights->Shape());
+  const int64_t hidden_size = input_shape[input_shape.NumDimensions() - 1];
+  const int64_t num_rows = input_shape.SizeToDimension(input_shape.NumDimensions() - 1);
+  const int64_t num_experts = fc1_dims[0];
+  const int64_t inter_size = fc1_dims[2];
+
+  ORT_RETURN_IF_ERROR(CheckShape(router_probs, "router_probs", {num_rows, num_experts}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc1_experts_weights, "fc1_experts_weights", {num_experts, hidden_size, inter_size}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc1_experts_bias, "fc1_experts_bias", {num_experts, inter_size}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc2_experts_weights, "fc2_experts_weights", {num_experts, inter_size, hidden_size}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc2_experts_bias, "fc2_experts_bias", {num_experts, hidden_size}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc3_experts_weights, "fc3_experts_weights", {num_experts, hidden_size, inter_size}));
+  ORT_RETURN_IF_ERROR(CheckShape(fc3_experts_bias, "fc3_experts_bias", {num_experts, inter_size}));
+  ORT_RETURN_IF_NOT(k_ <= num_experts, "MoE: k must not be larger than the number of experts ", num_experts,
+                    ", got ", k_);
+
+  Tensor* output = context->Output(0, input_shape);
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  const size_t rows = narrow<size_t>(num_rows);
+  const size_t experts = narrow<size_t>(num_experts);
+  const size_t hidden = narrow<size_t>(hidden_size);
+  const size_t inter = narrow<size_t>(inter_size);
+  const size_t k = narrow<size_t>(k_);
+  const size_t slots = rows * k;
+
+  // top k of the softmax of the router logits of every row
+  std::vector<int32_t> expert_for_slot(slots);
+  std::vector<float> routing_weights(slots);
+  {
+    const float* logits = router_probs->Data<float>();
+    std::vector<float> probs(experts);
+    std::vector<int32_t> order(experts);
+    for (size_t r = 0; r < rows; ++r) {
+      const float* row_logits = logits + r * experts;
+      const float max_logit = *std::max_element(row_logits, row_logits + experts);
+      float sum = 0.0f;
+      for (size_t e = 0; e < experts; ++e) {
+        probs[e] = std::exp(row_logits[e] - max_logit);
+        sum += probs[e];
+      }
+
+      std::iota(order.begin(), order.end(), 0);
+      std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                        [&probs](int32_t a, int32_t b) {
+                          return probs[a] > probs[b] || (probs[a] == probs[b] && a < b);
+                        });
+      float selected_sum = 0.0f;
+      for (size_t j = 0; j < k; ++j) {
+        selected_sum += probs[order[j]];
+      }
+      const float scale = normalize_routing_weights_ ? selected_sum : sum;
+      for (size_t j = 0; j < k; ++j) {
+        expert_for_slot[r * k + j] = order[j];
+        routing_weights[r * k + j] = probs[order[j]] / scale;
+      }
+    }
+  }
+
+  // the slots of an expert are consecutive in the buffers of the computation
+  std::vector<size_t> expert_offsets(experts + 1, 0);
+  for (int32_t e : expert_for_slot) {
+    ++expert_offsets[e + 1];
+  }
+  std::partial_sum(expert_offsets.begin(), expert_offsets.end(), expert_offsets.begin());
+  std::vector<size_t> slot_for_position(slots);
+  std::vector<size_t> position_for_slot(slots);
+  {
+    std::vector<size_t> next_position(expert_offsets.begin(), expert_offsets.end() - 1);
+    for (size_t slot = 0; slot < slots; ++slot) {
+      const size_t position = next_position[expert_for_slot[slot]]++;
+      slot_for_position[position] = slot;
+      position_for_slot[slot] = position;
+    }
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto gathered = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(slots) * hidden);
+  auto fc1_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(slots) * inter);
+  auto fc3_output = fc3_experts_weights != nullptr
+                        ? IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(slots) * inter)
+                        : IAllocatorUniquePtr<float>{};
+  auto fc2_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(slots) * hidden);
+
+  const float* input_data = input->Data<float>();
+  auto run_expert = [&](size_t e, concurrency::ThreadPool* gemm_thread_pool) {
+    const size_t first = expert_offsets[e];
+    const size_t count = expert_offsets[e + 1] - first;
+    float* x = gathered.get() + first * hidden;
+    for (size_t i = 0; i < count; ++i) {
+      std::copy_n(input_data + slot_for_position[first + i] / k * hidden, hidden, x + i * hidden);
+    }
+
+    float* h = fc1_output.get() + first * inter;
+    Linear(x, count, hidden, inter, fc1_experts_weights->Data<float>() + e * hidden * inter,
+           fc1_experts_bias ? fc1_experts_bias->Data<float>() + e * inter : nullptr, h, gemm_thread_pool);
+    ApplyActivation(activation_type_, h, count * inter);
+    if (fc3_experts_weights != nullptr) {
+      float* gate = fc3_output.get() + first * inter;
+      Linear(x, count, hidden, inter, fc3_experts_weights->Data<float>() + e * hidden * inter,
+             fc3_experts_bias ? fc3_experts_bias->Data<float>() + e * inter : nullptr, gate, gemm_thread_pool);
+      for (size_t i = 0; i < count * inter; ++i) {
+        h[i] *= gate[i];
+      }
+    }
+
+    Linear(h, count, inter, hidden, fc2_experts_weights->Data<float>() + e * inter * hidden, nullptr,
+           fc2_output.get() + first * hidden, gemm_thread_pool);
+  };
+
+  std::vector<size_t> active_experts;
+  for (size_t e = 0; e < experts; ++e) {
+    if (expert_offsets[e + 1] != expert_offsets[e]) {
+      active_experts.push_back(e);
+    }
+  }
+
+  // the experts run in parallel when there are enough of them to use the threads, else their GEMMs are parallel
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  if (active_experts.size() > 1 &&
+      static_cast<int>(active_experts.size()) >= concurrency::ThreadPool::DegreeOfParallelism(thread_pool)) {
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, static_cast<std::ptrdiff_t>(active_experts.size()),
+                                                  [&](std::ptrdiff_t i) { run_expert(active_experts[i], nullptr); });
+  } else {
+    for (size_t e : active_experts) {
+      run_expert(e, thread_pool);
+    }
+  }
+
+  const float* fc2_bias = fc2_experts_bias ? fc2_experts_bias->Data<float>() : nullptr;
+  float* output_data = output->MutableData<float>();
+  const TensorOpCost cost{static_cast<double>(k * hidden * sizeof(float)), static_cast<double>(hidden * sizeof(float)),
+                          static_cast<double>(2 * k * hidden)};
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(rows), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t r = static_cast<size_t>(first); r < static_cast<size_t>(last); ++r) {
+          float* y = output_data + r * hidden;
+          std::fill_n(y, hidden, 0.0f);
+          for (size_t j = 0; j < k; ++j) {
+            const size_t slot = r * k + j;
+            const float weight = routing_weights[slot];
+            const float* expert_output = fc2_output.get() + position_for_slot[slot] * hidden;
+            const float* bias = fc2_bias ? fc2_bias + expert_for_slot[slot] * hidden : nullptr;
+            for (size_t c = 0; c < hidden; ++c) {
+              y[c] += weight * (expert_output[c] + (bias ? bias[c] : 0.0f));
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class MoEActivationType {
+  Relu,
+  Gelu,
+  Silu,
+  Identity,
+};
+
+// Mixture of experts. Every row is routed to the top k experts of the softmax of its router logits, the rows of an
+// expert are gathered so that each of its weights is read by one GEMM, and the experts that no row selects are not
+// computed. The results of the experts are scattered back to the rows scaled by their routing weights.
+class MoE final : public OpKernel {
+ public:
+  explicit MoE(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t k_;
+  bool normalize_routing_weights_;
+  MoEActivationType activation_type_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
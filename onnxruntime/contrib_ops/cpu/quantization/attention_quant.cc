@@ -10,6 +10,10 @@
 #include "core/common/safeint.h"
 #include "core/platform/threadpool.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+#include <algorithm>
+#include <cmath>
 
 using onnxruntime::concurrency::ThreadPool;
 
@@ -32,10 +36,16 @@ class QAttention : public OpKernel, public AttentionCPUBase {
                                    /*out*/ bool& used_shared_buffers) override;
 
  private:
+  // Computes the attention of Q, K and V (B, N, S, H) with u8 x s8 GEMMs for Q x K' and the probabilities x V.
+  Status ApplyAttentionInt8(const T* Q, const T* K, const T* V, const Tensor* mask_index, Tensor* output,
+                            int batch_size, int sequence_length, int head_size, int hidden_size,
+                            AllocatorPtr allocator, ThreadPool* tp) const;
+
   IAllocatorUniquePtr<void> packed_weights_;
   size_t packed_weights_size_;
   TensorShape weight_shape_;
   bool weights_is_signed_;
+  bool int8_scores_;
 };
 
 // These ops are internal-only, so register outside of onnx
@@ -54,6 +64,147 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
 
 template <typename T>
 QAttention<T>::QAttention(const OpKernelInfo& info) : OpKernel(info), AttentionCPUBase(info, true) {
+  int8_scores_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsQAttentionInt8Scores, "0") == "1";
+}
+
+template <typename T>
+Status QAttention<T>::ApplyAttentionInt8(const T* Q, const T* K, const T* V, const Tensor* mask_index,
+                                         Tensor* output, int batch_size, int sequence_length, int head_size,
+                                         int hidden_size, AllocatorPtr allocator, ThreadPool* tp) const {
+  const int loop_len = batch_size * num_heads_;
+  const size_t head_elements = static_cast<size_t>(sequence_length) * head_size;     // S x H
+  const size_t score_elements = static_cast<size_t>(sequence_length) * sequence_length;  // S x S
+  const float alpha = scale_ == 0.0f ? 1.0f / std::sqrt(static_cast<float>(head_size)) : scale_;
+  const int32_t* mask_data = mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr;
+  const bool is_raw_mask = mask_index != nullptr && mask_index->Shape().NumDimensions() == 2;
+
+  // Q is u8 with a zero point, K' (H x S) and V are symmetric s8, the probabilities are u8 with a scale of 1/255
+  auto buffer = allocator->Alloc(SafeInt<size_t>(loop_len) * (3 * head_elements + score_elements));
+  BufferUniquePtr quant_buffer(buffer, BufferDeleter(allocator));
+  uint8_t* q_quant = static_cast<uint8_t*>(buffer);
+  int8_t* k_quant = reinterpret_cast<int8_t*>(q_quant + loop_len * head_elements);
+  int8_t* v_quant = k_quant + loop_len * head_elements;
+  uint8_t* probs_quant = reinterpret_cast<uint8_t*>(v_quant + loop_len * head_elements);
+
+  auto scores_data = allocator->Alloc(SafeInt<size_t>(loop_len) * score_elements * sizeof(float));
+  BufferUniquePtr scores_buffer(scores_data, BufferDeleter(allocator));
+  float* scores = static_cast<float*>(scores_data);
+
+  std::vector<uint8_t> q_zero_points(loop_len);
+  std::vector<float> qk_scales(loop_len);
+  std::vector<float> v_scales(loop_len);
+
+  auto symmetric_scale = [](const float* data, size_t count) {
+    float min = 0.0f;
+    float max = 0.0f;
+    MlasFindMinMaxElement(data, &min, &max, count);
+    const float abs_max = std::max(std::fabs(min), std::fabs(max));
+    return abs_max == 0.0f ? 1.0f : abs_max / 127.0f;
+  };
+
+  const TensorOpCost quantize_cost{static_cast<double>(3 * head_elements * sizeof(T)),
+                                   static_cast<double>(3 * head_elements), static_cast<double>(6 * head_elements)};
+  ThreadPool::TryParallelFor(tp, loop_len, quantize_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const T* q = Q + i * head_elements;
+      const T* k = K + i * head_elements;
+      const T* v = V + i * head_elements;
+
+      float q_scale;
+      GetQuantizationParameter<uint8_t>(q, static_cast<int64_t>(head_elements), q_scale, q_zero_points[i], nullptr);
+      MlasQuantizeLinear<uint8_t>(q, q_quant + i * head_elements, head_elements, q_scale, q_zero_points[i]);
+
+      const float k_scale = symmetric_scale(k, head_elements);
+      int8_t* k_transposed = k_quant + i * head_elements;
+      for (int s = 0; s < sequence_length; s++) {
+        for (int h = 0; h < head_size; h++) {
+          const float value = std::nearbyint(k[s * head_size + h] / k_scale);
+          k_transposed[h * sequence_length + s] = static_cast<int8_t>(std::clamp(value, -127.0f, 127.0f));
+        }
+      }
+      qk_scales[i] = alpha * q_scale * k_scale;
+
+      v_scales[i] = symmetric_scale(v, head_elements);
+      MlasQuantizeLinear<int8_t>(v, v_quant + i * head_elements, head_elements, v_scales[i], 0);
+      v_scales[i] /= 255.0f;
+    }
+  });
+
+  constexpr uint8_t zero_point = 0;
+  MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+  gemm_shape.BIsSigned = true;
+  std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(loop_len);
+  std::vector<MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR> scale_procs;
+  scale_procs.reserve(loop_len);
+
+  // scores(S x S) = Q(S x H) x K'(H x S), the int32 result is scaled in place
+  gemm_shape.M = sequence_length;
+  gemm_shape.N = sequence_length;
+  gemm_shape.K = head_size;
+  for (int i = 0; i < loop_len; i++) {
+    float* score = scores + i * score_elements;
+    scale_procs.emplace_back(score, sequence_length, &qk_scales[i], nullptr);
+    auto& gemm_params = gemm_data_vec[i];
+    gemm_params.A = q_quant + i * head_elements;
+    gemm_params.lda = head_size;
+    gemm_params.ZeroPointA = q_zero_points[i];
+    gemm_params.B = reinterpret_cast<const uint8_t*>(k_quant + i * head_elements);
+    gemm_params.ldb = sequence_length;
+    gemm_params.ZeroPointB = &zero_point;
+    gemm_params.C = reinterpret_cast<int32_t*>(score);
+    gemm_params.ldc = sequence_length;
+    gemm_params.OutputProcessor = &scale_procs[i];
+  }
+  MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+
+  const TensorOpCost softmax_cost{static_cast<double>(score_elements * sizeof(float)),
+                                  static_cast<double>(score_elements), static_cast<double>(score_elements * 8)};
+  ThreadPool::TryParallelFor(tp, loop_len, softmax_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int batch_index = static_cast<int>(i / num_heads_);
+      float* score = scores + i * score_elements;
+      if (mask_data != nullptr) {
+        for (int j = 0; j < sequence_length; j++) {
+          const bool masked = is_raw_mask ? mask_data[batch_index * sequence_length + j] == 0
+                                          : j >= mask_data[batch_index];
+          if (masked) {
+            for (int s = 0; s < sequence_length; s++) {
+              score[s * sequence_length + j] += mask_filter_value_;
+            }
+          }
+        }
+      }
+      MlasComputeSoftmax(score, score, sequence_length, sequence_length, false, nullptr);
+      MlasQuantizeLinear<uint8_t>(score, probs_quant + i * score_elements, score_elements, 1.0f / 255.0f, 0);
+    }
+  });
+
+  // output(S x H) = probs(S x S) x V(S x H), written to (B, S, N, H)
+  gemm_shape.M = sequence_length;
+  gemm_shape.N = head_size;
+  gemm_shape.K = sequence_length;
+  scale_procs.clear();
+  T* output_data = output->MutableData<T>();
+  for (int i = 0; i < loop_len; i++) {
+    const int batch_index = i / num_heads_;
+    const int head_index = i % num_heads_;
+    T* out = output_data + static_cast<ptrdiff_t>(batch_index) * sequence_length * hidden_size +
+             static_cast<ptrdiff_t>(head_index) * head_size;
+    scale_procs.emplace_back(out, hidden_size, &v_scales[i], nullptr);
+    auto& gemm_params = gemm_data_vec[i];
+    gemm_params.A = probs_quant + i * score_elements;
+    gemm_params.lda = sequence_length;
+    gemm_params.ZeroPointA = 0;
+    gemm_params.B = reinterpret_cast<const uint8_t*>(v_quant + i * head_elements);
+    gemm_params.ldb = head_size;
+    gemm_params.ZeroPointB = &zero_point;
+    gemm_params.C = reinterpret_cast<int32_t*>(out);
+    gemm_params.ldc = hidden_size;
+    gemm_params.OutputProcessor = &scale_procs[i];
+  }
+  MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+
+  return Status::OK();
 }
 
 template <typename T>
@@ -287,6 +438,17 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
     MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
   }
 
+  const bool int8_mask_supported =
+      mask_index == nullptr ||
+      (mask_index->Shape().NumDimensions() == 1 && mask_index->Shape()[0] == batch_size) ||
+      (mask_index->Shape().NumDimensions() == 2 && mask_index->Shape()[1] == sequence_length);
+  if (int8_scores_ && past_tensor == nullptr && !is_unidirectional_ && int8_mask_supported) {
+    AllocatorPtr temp_allocator;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&temp_allocator));
+    return ApplyAttentionInt8(Q, K, V, mask_index, output, batch_size, sequence_length, head_size, hidden_size,
+                              temp_allocator, tp);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past_tensor, nullptr /* past_key */, nullptr /* past_value*/,
                         output, nullptr /* present_key */, nullptr /* present_value */,
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
@@ -34,6 +35,11 @@ class GatherBlockQuantized : public OpKernel {
 
     ORT_ENFORCE(block_size_ >= 16 && ((block_size_ - 1) & block_size_) == 0,
                 "'block_size' must be 2's power and not less than 16.");
+
+    bits_ = info.GetAttrOrDefault<int64_t>("bits", 4);
+    if constexpr (std::is_same_v<T1, uint8_t>) {
+      ORT_ENFORCE(bits_ == 4 || bits_ == 8, "'bits' must be 4 or 8 for uint8 data.");
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -65,10 +71,29 @@ class GatherBlockQuantized : public OpKernel {
                                const int64_t quantize_N,
                                concurrency::ThreadPool* tp) const;
 
+  // uint8 data is laid out like the B input of MatMulNBits: (N, k_blocks, blob_size) with `bits` bits per element,
+  // the scales are (N * k_blocks) and the zero points are packed like the data, row by row. A tied embedding and
+  // LM head can then share a single quantized initializer.
+  Status ComputeNBits(OpKernelContext* context) const;
+
+  Status ComputeInt4(OpKernelContext* context) const;
+
+  template <typename T2>
+  Status CopyDataAndDequantizeNBits(const uint8_t* data_ptr,
+                                    const Tind* indices_ptr,
+                                    const T2* scales_ptr,
+                                    const uint8_t* zero_points_ptr,
+                                    T2* output_ptr,
+                                    const int64_t N,
+                                    const int64_t k_blocks,
+                                    const int64_t gather_N,
+                                    concurrency::ThreadPool* tp) const;
+
  private:
   int64_t gather_axis_;
   int64_t quantize_axis_;
   int64_t block_size_;
+  int64_t bits_;
 };
 
 template <typename T1, typename Tind>
@@ -201,8 +226,114 @@ Status GatherBlockQuantized<T1, Tind>::CopyDataAndDequantize(const T1* data_ptr,
   return Status::OK();
 }
 
+template <typename T1, typename Tind>
+template <typename T2>
+Status GatherBlockQuantized<T1, Tind>::CopyDataAndDequantizeNBits(const uint8_t* data_ptr,
+                                                                  const Tind* indices_ptr,
+                                                                  const T2* scales_ptr,
+                                                                  const uint8_t* zero_points_ptr,
+                                                                  T2* output_ptr,
+                                                                  const int64_t N,
+                                                                  const int64_t k_blocks,
+                                                                  const int64_t gather_N,
+                                                                  concurrency::ThreadPool* tp) const {
+  const int64_t blob_size = block_size_ * bits_ / 8;
+  const int64_t zero_points_row_size = (k_blocks * bits_ + 7) / 8;
+  const int64_t row_size = k_blocks * block_size_;
+  const int64_t elements_per_byte = 8 / bits_;
+  const int32_t mask = (1 << bits_) - 1;
+  const int32_t default_zero_point = 1 << (bits_ - 1);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp,
+      SafeInt<ptrdiff_t>(gather_N),
+      static_cast<double>(row_size * 3),
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (auto index = static_cast<int64_t>(first), end = static_cast<int64_t>(last); index < end; ++index) {
+          int64_t row = static_cast<int64_t>(indices_ptr[index]);
+          ORT_ENFORCE(row >= -N && row < N,
+                      "indices element out of data bounds, idx=", row,
+                      " must be within the inclusive range [", -N, ",", N - 1, "]");
+          row = row < 0 ? row + N : row;
+
+          const uint8_t* row_data = data_ptr + row * k_blocks * blob_size;
+          const T2* row_scales = scales_ptr + row * k_blocks;
+          const uint8_t* row_zero_points = zero_points_ptr ? zero_points_ptr + row * zero_points_row_size : nullptr;
+          T2* output_row = output_ptr + index * row_size;
+
+          for (int64_t blk = 0; blk < k_blocks; ++blk) {
+            const auto scale_val = static_cast<float>(row_scales[blk]);
+            const int32_t zp_val =
+                row_zero_points
+                    ? (row_zero_points[blk / elements_per_byte] >> (blk % elements_per_byte * bits_)) & mask
+                    : default_zero_point;
+            const uint8_t* blob = row_data + blk * blob_size;
+            T2* output_block = output_row + blk * block_size_;
+            for (int64_t i = 0; i < block_size_; ++i) {
+              const int32_t data_val = (blob[i / elements_per_byte] >> (i % elements_per_byte * bits_)) & mask;
+              output_block[i] = static_cast<T2>(static_cast<float>(data_val - zp_val) * scale_val);
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+template <typename T1, typename Tind>
+Status GatherBlockQuantized<T1, Tind>::ComputeNBits(OpKernelContext* context) const {
+  const Tensor* data_tensor = context->Input<Tensor>(0);
+  const Tensor* indices_tensor = context->Input<Tensor>(1);
+  const Tensor* scales_tensor = context->Input<Tensor>(2);
+  const Tensor* zero_points_tensor = context->Input<Tensor>(3);
+
+  const auto& data_shape = data_tensor->Shape();
+  ORT_RETURN_IF_NOT(data_shape.NumDimensions() == 3,
+                    "uint8 data must have the shape (N, k_blocks, blob_size) of the B input of MatMulNBits.");
+  ORT_RETURN_IF_NOT(HandleNegativeAxis(gather_axis_, 3) == 0, "gather_axis must be 0 for uint8 data.");
+  const int64_t N = data_shape[0];
+  const int64_t k_blocks = data_shape[1];
+  ORT_RETURN_IF_NOT(data_shape[2] * 8 == block_size_ * bits_,
+                    "blob_size of uint8 data must be block_size * bits / 8, got ", data_shape[2]);
+  ORT_RETURN_IF_NOT(scales_tensor->Shape().Size() == N * k_blocks,
+                    "scales must have N * k_blocks elements, got shape ", scales_tensor->Shape());
+  ORT_RETURN_IF_NOT(zero_points_tensor == nullptr ||
+                        zero_points_tensor->Shape().Size() == N * ((k_blocks * bits_ + 7) / 8),
+                    "zero_points must be packed like data, got shape ",
+                    zero_points_tensor ? zero_points_tensor->Shape() : TensorShape());
+
+  const auto& indices_shape = indices_tensor->Shape();
+  std::vector<int64_t> shape(indices_shape.GetDims().begin(), indices_shape.GetDims().end());
+  shape.push_back(k_blocks * block_size_);
+  Tensor* output_tensor = context->Output(0, TensorShape(std::move(shape)));
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const auto* data_ptr = data_tensor->Data<uint8_t>();
+  const auto* indices_ptr = indices_tensor->Data<Tind>();
+  const auto* zero_points_ptr = zero_points_tensor ? zero_points_tensor->Data<uint8_t>() : nullptr;
+  const int64_t gather_N = indices_shape.Size();
+
+  if (scales_tensor->IsDataType<float>()) {
+    return CopyDataAndDequantizeNBits<float>(data_ptr, indices_ptr, scales_tensor->Data<float>(), zero_points_ptr,
+                                             output_tensor->MutableData<float>(), N, k_blocks, gather_N, tp);
+  }
+
+  return CopyDataAndDequantizeNBits<MLFloat16>(data_ptr, indices_ptr, scales_tensor->Data<MLFloat16>(),
+                                               zero_points_ptr, output_tensor->MutableData<MLFloat16>(), N,
+                                               k_blocks, gather_N, tp);
+}
+
 template <typename T1, typename Tind>
 Status GatherBlockQuantized<T1, Tind>::Compute(OpKernelContext* context) const {
+  if constexpr (std::is_same_v<T1, uint8_t>) {
+    return ComputeNBits(context);
+  } else {
+    return ComputeInt4(context);
+  }
+}
+
+template <typename T1, typename Tind>
+Status GatherBlockQuantized<T1, Tind>::ComputeInt4(OpKernelContext* context) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
 
@@ -277,6 +408,8 @@ REGISTER_GATHERBLOCKQUANTIZED(UInt4x2, int32_t);
 REGISTER_GATHERBLOCKQUANTIZED(UInt4x2, int64_t);
 REGISTER_GATHERBLOCKQUANTIZED(Int4x2, int32_t);
 REGISTER_GATHERBLOCKQUANTIZED(Int4x2, int64_t);
+REGISTER_GATHERBLOCKQUANTIZED(uint8_t, int32_t);
+REGISTER_GATHERBLOCKQUANTIZED(uint8_t, int64_t);
 
 }  // namespace contrib
 }  // namespace onnxruntime
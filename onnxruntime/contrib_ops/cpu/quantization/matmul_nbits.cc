@@ -4,6 +4,7 @@
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
 #include <cstdint>
+#include <string>
 #include <type_traits>
 
 #include "core/common/common.h"
@@ -33,9 +34,27 @@ constexpr size_t A = 0,
                  scales = 2,
                  zero_points = 3,
                  g_idx = 4,
-                 bias = 5;
+                 bias = 5,
+                 multiplier = 6,
+                 residual = 7;
 };
 
+MLAS_SQNBIT_GEMM_EPILOGUE_ACTIVATION GetEpilogueActivation(const std::string& activation) {
+  if (activation.empty()) {
+    return MlasSQNBitGemmEpilogueIdentity;
+  }
+  if (activation == "gelu") {
+    return MlasSQNBitGemmEpilogueGelu;
+  }
+  if (activation == "fastgelu") {
+    return MlasSQNBitGemmEpilogueFastGelu;
+  }
+  if (activation == "silu") {
+    return MlasSQNBitGemmEpilogueSilu;
+  }
+  ORT_THROW("Unsupported activation for MatMulNBits: ", activation);
+}
+
 int64_t GetAccuracyLevel(size_t nbits, size_t block_size, int64_t accuracy_level_attr) {
   const auto accuracy_level = std::clamp(accuracy_level_attr,
                                          static_cast<int64_t>(CompMostAccurate),
@@ -89,7 +108,12 @@ class MatMulNBits final : public OpKernel {
         nbits_{narrow<size_t>(info.GetAttr<int64_t>("bits"))},
         accuracy_level_{GetAccuracyLevel(nbits_, block_size_, info.GetAttr<int64_t>("accuracy_level"))},
         has_g_idx_{info.GetInputCount() > InputIndex::g_idx && info.node().InputDefs()[InputIndex::g_idx]->Exists()},
-        has_bias_{info.GetInputCount() > InputIndex::bias && info.node().InputDefs()[InputIndex::bias]->Exists()} {
+        has_bias_{info.GetInputCount() > InputIndex::bias && info.node().InputDefs()[InputIndex::bias]->Exists()},
+        activation_{GetEpilogueActivation(info.GetAttrOrDefault<std::string>("activation", ""))},
+        has_multiplier_{info.GetInputCount() > InputIndex::multiplier &&
+                        info.node().InputDefs()[InputIndex::multiplier]->Exists()},
+        has_residual_{info.GetInputCount() > InputIndex::residual &&
+                      info.node().InputDefs()[InputIndex::residual]->Exists()} {
     const auto& node = info.node();
     auto input_defs = node.InputDefs();
 
@@ -126,7 +150,29 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                 gsl::span<const size_t> prepacked_buffer_sizes,
+                                 /*out*/ bool& used_prepacked_buffers) override;
+
  private:
+  // whether the elementwise operations following the MatMul are fused into this node
+  bool HasEpilogue() const {
+    return activation_ != MlasSQNBitGemmEpilogueIdentity || has_multiplier_ || has_residual_;
+  }
+
+#if !defined(ORT_NEURAL_SPEED)
+  // whether the scales and zero points are packed into packed_b_ after B is packed. packed_b_ can't be shared or
+  // persisted as it is modified after PrePack() returns for B.
+  bool PacksQuantParamsIntoB() const {
+#ifdef MLAS_TARGET_AMD64_IX86
+    return static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_) == CompInt8;
+#else
+    return false;
+#endif
+  }
+#endif  // !defined(ORT_NEURAL_SPEED)
+
   const size_t K_;
   const size_t N_;
   const size_t block_size_;
@@ -134,6 +180,9 @@ class MatMulNBits final : public OpKernel {
   const int64_t accuracy_level_;
   const bool has_g_idx_;
   const bool has_bias_;
+  const MLAS_SQNBIT_GEMM_EPILOGUE_ACTIVATION activation_;
+  const bool has_multiplier_;
+  const bool has_residual_;
   bool has_unquantized_zero_point_{false};
   const bool column_wise_quant_{true};
   IAllocatorUniquePtr<void> packed_b_{};
@@ -209,7 +258,6 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
   }
 
 #else  // defined(ORT_NEURAL_SPEED)
-  ORT_UNUSED_PARAMETER(prepacked_weights);
   const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
   if (input_idx == InputIndex::B) {
     if (!MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
@@ -223,6 +271,10 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
+    if (prepacked_weights != nullptr && !PacksQuantParamsIntoB()) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+    }
   } else if (compute_type == CompInt8) {
 #ifdef MLAS_TARGET_AMD64_IX86
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
@@ -273,6 +325,36 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+Status MatMulNBits::RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                            std::vector<BufferUniquePtr>& prepacked_buffers,
+                                            gsl::span<const size_t> prepacked_buffer_sizes,
+                                            /*out*/ bool& used_prepacked_buffers) {
+  ORT_UNUSED_PARAMETER(tensor);
+  used_prepacked_buffers = false;
+
+#if defined(ORT_NEURAL_SPEED)
+  // the packed layout depends on the scales and zero points as well, so let PrePack() pack it again.
+  ORT_UNUSED_PARAMETER(input_idx);
+  ORT_UNUSED_PARAMETER(prepacked_buffers);
+  ORT_UNUSED_PARAMETER(prepacked_buffer_sizes);
+#else  // defined(ORT_NEURAL_SPEED)
+  const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
+  if (input_idx != InputIndex::B || prepacked_buffers.size() != 1 || PacksQuantParamsIntoB() ||
+      !MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
+    return Status::OK();
+  }
+
+  const size_t packed_b_size = MlasSQNBitGemmPackQuantBDataSize(N_, K_, nbits_, block_size_, compute_type);
+  if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+    used_prepacked_buffers = true;
+    packed_b_size_ = packed_b_size;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+#endif  // defined(ORT_NEURAL_SPEED)
+
+  return Status::OK();
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(InputIndex::A);
@@ -301,6 +383,37 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
                                                helper.RightOffsets().end(),
                                                [](size_t offset) { return offset == 0; });
 
+  // one epilogue per GEMM of the batch, each reading the multiplier and residual at its output offset
+  InlinedVector<MLAS_SQNBIT_GEMM_EPILOGUE_PROCESSOR> epilogues;
+  if (HasEpilogue()) {
+    const Tensor* multiplier = ctx->Input<Tensor>(InputIndex::multiplier);
+    const Tensor* residual = ctx->Input<Tensor>(InputIndex::residual);
+    ORT_RETURN_IF(multiplier != nullptr && multiplier->Shape() != y->Shape(),
+                  "MatMulNBits multiplier shape ", multiplier->Shape(), " does not match the output shape ",
+                  y->Shape());
+    ORT_RETURN_IF(residual != nullptr && residual->Shape() != y->Shape(),
+                  "MatMulNBits residual shape ", residual->Shape(), " does not match the output shape ",
+                  y->Shape());
+
+    const auto* multiplier_data = multiplier == nullptr ? nullptr : multiplier->Data<float>();
+    const auto* residual_data = residual == nullptr ? nullptr : residual->Data<float>();
+
+    epilogues.reserve(batch_count);
+    for (size_t i = 0; i < batch_count; ++i) {
+      const size_t offset = helper.OutputOffsets()[i];
+      epilogues.emplace_back(activation_,
+                             multiplier_data == nullptr ? nullptr : multiplier_data + offset, N,
+                             residual_data == nullptr ? nullptr : residual_data + offset, N);
+    }
+  }
+
+  // applies the epilogue after a GEMM implementation that does not take a post processor
+  const auto apply_epilogues = [&]() {
+    for (size_t i = 0; i < epilogues.size(); ++i) {
+      epilogues[i].Process(y_data + helper.OutputOffsets()[i], 0, 0, M, N, N);
+    }
+  };
+
 #if defined(ORT_NEURAL_SPEED)
 
   if (has_single_b_matrix &&
@@ -319,6 +432,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
     // workspace for activation process(dynamic quantization and others)
     auto ws_ptr = IAllocator::MakeUniquePtr<int8_t>(allocator, ws_size);
     NSSQNBitsGemmBatchPackedB(M, N, K, batch_count, gemm_params.data(), ws_ptr.get(), thread_pool);
+    apply_epilogues();
     return Status::OK();
   }
 
@@ -364,6 +478,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
         data[i].Bias = bias_data;
         data[i].C = y_data + helper.OutputOffsets()[i];
         data[i].ldc = N;
+        data[i].PostProcessor = epilogues.empty() ? nullptr : &epilogues[i];
       }
       MlasSQNBitGemmBatch(M, N, K, batch_count, nbits_, block_size_, compute_type, data.data(), workspace.get(),
                           thread_pool);
@@ -469,6 +584,8 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   MlasGemmBatch(CblasNoTrans, CblasTrans,
                 M, N, K, data.data(), batch_count, thread_pool);
 
+  apply_epilogues();
+
   return Status::OK();
 }
 
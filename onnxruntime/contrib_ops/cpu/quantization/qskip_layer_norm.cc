@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/quantization/qskip_layer_norm.h"
+
+#include <memory>
+
+#include "contrib_ops/cpu/skip_layer_norm_helper.h"
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define REGISTER_KERNEL_TYPED(T2)                                    \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                     \
+      QSkipLayerNormalization,                                       \
+      kMSDomain,                                                     \
+      1,                                                             \
+      T2,                                                            \
+      kCpuExecutionProvider,                                         \
+      KernelDefBuilder()                                             \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()) \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T2>()),  \
+      QSkipLayerNorm<T2>);
+
+REGISTER_KERNEL_TYPED(uint8_t)
+REGISTER_KERNEL_TYPED(int8_t)
+
+template <typename T2>
+QSkipLayerNorm<T2>::QSkipLayerNorm(const OpKernelInfo& op_kernel_info)
+    : OpKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+  ORT_ENFORCE(epsilon_ >= 0);
+}
+
+template <typename T2>
+Status QSkipLayerNorm<T2>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* skip = context->Input<Tensor>(1);
+  const Tensor* gamma = context->Input<Tensor>(2);
+  const Tensor* beta = context->Input<Tensor>(3);
+  const Tensor* bias = context->Input<Tensor>(4);
+  const Tensor* y_scale = context->Input<Tensor>(5);
+  const Tensor* y_zero_point = context->Input<Tensor>(6);
+
+  const auto& input_dims = input->Shape().GetDims();
+  const size_t input_dims_size = input_dims.size();
+  const int hidden_size = static_cast<int>(input_dims[input_dims_size - 1]);
+
+  ORT_RETURN_IF_ERROR(skip_layer_norm_helper::CheckInputs<Tensor>(input, skip, gamma, beta, bias, hidden_size,
+                                                                  input_dims_size));
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_scale) && IsScalarOr1ElementVector(y_zero_point),
+                    "QSkipLayerNormalization : y_scale and y_zero_point must be scalars");
+
+  Tensor* output = context->Output(0, input->Shape());
+  Tensor* skip_input_bias_add_output = context->Output(1, input->Shape());
+
+  const float scale = *y_scale->Data<float>();
+  const T2 zero_point = *y_zero_point->Data<T2>();
+
+  const float* input_data = input->Data<float>();
+  const float* skip_data = skip->Data<float>();
+  const float* gamma_data = gamma->Data<float>();
+  const float* beta_data = beta == nullptr ? nullptr : beta->Data<float>();
+  const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+  T2* output_data = output->MutableData<T2>();
+  float* skip_input_bias_add_output_data =
+      skip_input_bias_add_output != nullptr ? skip_input_bias_add_output->MutableData<float>() : nullptr;
+
+  const size_t hidden = static_cast<size_t>(hidden_size);
+  const int64_t skip_size = skip->Shape().Size();
+  const int64_t task_count = input->Shape().SizeToDimension(input_dims_size - 1);
+  const TensorOpCost cost{static_cast<double>(3 * hidden * sizeof(float)),
+                          static_cast<double>(hidden * sizeof(T2)),
+                          static_cast<double>(hidden * 8)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(task_count), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        auto normalized = std::make_unique<float[]>(hidden);
+
+        for (std::ptrdiff_t task_idx = first; task_idx < last; ++task_idx) {
+          const int64_t offset = task_idx * hidden_size;
+          float* p_skip_input_bias_add_output_data =
+              skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
+
+          MlasLayerNormalization(input_data + offset, skip_data + (offset % skip_size), bias_data, gamma_data,
+                                 beta_data, normalized.get(), p_skip_input_bias_add_output_data, hidden, epsilon_,
+                                 false, nullptr, nullptr);
+          MlasQuantizeLinear(normalized.get(), output_data + offset, hidden, scale, zero_point);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// SkipLayerNormalization fused with the QuantizeLinear of its output. Every row is normalized into a scratch row
+// that stays in the cache and is quantized from there, so the float output is never written.
+template <typename T2>
+class QSkipLayerNorm final : public OpKernel {
+ public:
+  explicit QSkipLayerNorm(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float epsilon_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -33,6 +34,68 @@ namespace contrib {
 
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+template <bool simplified, typename T>
+void ComputeJob(const T* p_input, const T* p_skip, const T* gamma_data, const T* beta_data, const T* bias_data,
+                T* p_output, T* p_skip_input_bias_add_output_data, int hidden_size, float epsilon) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    T value = p_input[h] + p_skip[h];
+
+    if (nullptr != bias_data) {
+      value += bias_data[h];
+    }
+
+    if (nullptr != p_skip_input_bias_add_output_data) {
+      p_skip_input_bias_add_output_data[h] = value;
+    }
+
+    p_output[h] = value;
+    mean += value;
+    mean_square += value * value;
+  }
+
+  mean = mean / hidden_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / hidden_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    if (simplified) {
+      p_output[h] = p_output[h] / mean_square * gamma_data[h];
+    } else if (nullptr == beta_data) {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+    } else {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+    }
+  }
+}
+
+// float and MLFloat16 rows are normalized by MLAS, which accumulates the statistics in a single vectorized pass.
+template <bool simplified>
+void ComputeJob(const float* p_input, const float* p_skip, const float* gamma_data, const float* beta_data,
+                const float* bias_data, float* p_output, float* p_skip_input_bias_add_output_data, int hidden_size,
+                float epsilon) {
+  MlasLayerNormalization(p_input, p_skip, bias_data, gamma_data, beta_data, p_output,
+                         p_skip_input_bias_add_output_data, static_cast<size_t>(hidden_size), epsilon, simplified,
+                         nullptr, nullptr);
+}
+
+template <bool simplified>
+void ComputeJob(const MLFloat16* p_input, const MLFloat16* p_skip, const MLFloat16* gamma_data,
+                const MLFloat16* beta_data, const MLFloat16* bias_data, MLFloat16* p_output,
+                MLFloat16* p_skip_input_bias_add_output_data, int hidden_size, float epsilon) {
+  MlasLayerNormalizationFp16(p_input, p_skip, bias_data, gamma_data, beta_data, p_output,
+                             p_skip_input_bias_add_output_data, static_cast<size_t>(hidden_size), epsilon,
+                             simplified, nullptr, nullptr);
+}
+}  // namespace
 
 template <typename T, bool simplified>
 SkipLayerNorm<T, simplified>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
@@ -91,41 +154,8 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
         T* p_output = output_data + offset;
         T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
 
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
-
-          if (nullptr != bias_data) {
-            value += bias_data[h];
-          }
-
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
-          }
-
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
-
-        mean = mean / hidden_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / hidden_size + epsilon_);
-        } else {
-          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-        }
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (simplified) {
-            p_output[h] = p_output[h] / mean_square * gamma_data[h];
-          } else if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-          }
-        }
+        ComputeJob<simplified>(p_input, p_skip, gamma_data, beta_data, bias_data, p_output,
+                               p_skip_input_bias_add_output_data, hidden_size, epsilon_);
       },
       0);
 
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+
 #include "contrib_ops/cpu/bert/attention_helper.h"
 
 #include "core/common/common.h"
@@ -199,26 +202,23 @@ class SparseAttentionBase {
           q = Q + q_input_chunk_length * i;
         }
 
+        int layout_id = head_index % parameters.num_sparse_layout;
+        bool is_sparse_layout = layout_has_sparse[layout_id];
+
         DUMP_STRING("i=", i, ",batch_index=", batch_index, ",head_index=", head_index,
-                    ",past_seq_len=", past_seq_len, ",total_seq_len=", total_seq_len, ",packed_qkv=", packed_qkv);
+                    ",past_seq_len=", past_seq_len, ",total_seq_len=", total_seq_len, ",packed_qkv=", packed_qkv,
+                    ",layout_id=", layout_id, ",is_sparse_layout=", is_sparse_layout);
         DUMP_CPU_TENSOR("Q", q, sequence_length, head_size);
         DUMP_CPU_TENSOR("K", k, total_seq_len, head_size);
 
-        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seq_len, head_size, alpha, q,
-                                    head_size, k, head_size, 0.0f /*bata*/, output, total_seq_len,
-                                    nullptr);
-
-        DUMP_CPU_TENSOR("QK", output, sequence_length, total_seq_len);
-
-        // Compute Softmax for causal and output result in place.
-        T* output_softmax = output;
-
-        int layout_id = head_index % parameters.num_sparse_layout;
-        bool is_sparse_layout = layout_has_sparse[layout_id];
+        if (!is_sparse_layout) {  // dense
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seq_len, head_size, alpha, q,
+                                      head_size, k, head_size, 0.0f /*bata*/, output, total_seq_len,
+                                      nullptr);
 
-        DUMP_STRING("layout_id=", layout_id, ",is_sparse_layout=", is_sparse_layout);
+          DUMP_CPU_TENSOR("QK", output, sequence_length, total_seq_len);
 
-        if (!is_sparse_layout) {  // dense
+          T* output_softmax = output;
           for (int q_id = 0; q_id < sequence_length; q_id++) {
             int causal_length = past_seq_len + q_id + 1;
             ComputeAttentionSoftmaxInplace(output_softmax, 1, causal_length, nullptr);
@@ -228,69 +228,48 @@ class SparseAttentionBase {
             output_softmax += total_seq_len;
           }
         } else {  // sparse
-          int q_id = 0;
-          bool has_sparse = false;
-          std::vector<int32_t> mask(parameters.max_sequence_length);
-
           const int32_t* layout_row_indices = block_row_indices + layout_id * parameters.stride_row_indices;
           const int32_t* layout_col_indices = block_col_indices + layout_id * parameters.stride_col_indices;
-          do {
-            int q_abs_position = past_seq_len + q_id;
-            int causal_length = q_abs_position + 1;
-
-            // Update mask when query token is the first or at the boundary of sparse block.
-            if (q_id == 0 || q_abs_position % parameters.sparse_block_size == 0) {
-              int row_in_sparse_layout = q_abs_position / parameters.sparse_block_size;
-              int start_in_col_indices = layout_row_indices[row_in_sparse_layout];
-              int end_in_col_indices = layout_row_indices[row_in_sparse_layout + 1];
-              int nonzero_blocks = end_in_col_indices - start_in_col_indices;
-              has_sparse = (nonzero_blocks != row_in_sparse_layout + 1);
-
-              DUMP_STRING("q_id=", q_id,
-                          ",q_abs_position=", q_abs_position,
-                          ",sparse_block_size=", parameters.sparse_block_size,
-                          ",row_in_sparse_layout=", row_in_sparse_layout,
-                          ",start_in_col_indices=", start_in_col_indices,
-                          ",end_in_col_indices=", end_in_col_indices,
-                          ",nonzero_blocks=", nonzero_blocks,
-                          ",has_sparse=", has_sparse);
-
-              // Expand attention mask for current row of q_id
-              if (has_sparse) {
-                int block_aligned_length = q_abs_position / parameters.sparse_block_size * parameters.sparse_block_size + parameters.sparse_block_size;
-                DUMP_STRING("block_aligned_length=", block_aligned_length);
-
-                std::fill_n(mask.begin(), block_aligned_length, 0);
-                for (int j = start_in_col_indices; j < end_in_col_indices; j++) {
-                  int col_in_sparse_layout = layout_col_indices[j];
-
-                  int offset = col_in_sparse_layout * parameters.sparse_block_size;
-                  for (int s = 0; s < parameters.sparse_block_size; s++, offset++) {
-                    mask[offset] = 1;
-                  }
-                }
-
-                DUMP_CPU_TENSOR("mask", mask, block_aligned_length);
-              }
-            }
+          const int block_size = parameters.sparse_block_size;
 
-            // Update inline according to attention mask.
-            if (has_sparse) {
-              for (int s = 0; s < causal_length; s++) {
-                if (mask[s] == 0)
-                  output_softmax[s] = std::numeric_limits<T>::lowest();
+          // The query tokens in the same row of the sparse layout attend the same key blocks. Only the nonzero
+          // blocks of the row are computed, the scores of the other keys stay at the lowest value so that their
+          // probabilities are zero after softmax.
+          int q_id = 0;
+          while (q_id < sequence_length) {
+            int row_in_sparse_layout = (past_seq_len + q_id) / block_size;
+            int row_end = std::min(sequence_length, (row_in_sparse_layout + 1) * block_size - past_seq_len);
+            int rows = row_end - q_id;
+            int causal_length = past_seq_len + row_end;  // causal length of the last query token in the row
+            T* row_output = output + static_cast<ptrdiff_t>(q_id) * total_seq_len;
+            std::fill_n(row_output, static_cast<size_t>(rows) * total_seq_len, std::numeric_limits<T>::lowest());
+
+            int start_in_col_indices = layout_row_indices[row_in_sparse_layout];
+            int end_in_col_indices = layout_row_indices[row_in_sparse_layout + 1];
+            DUMP_STRING("q_id=", q_id, ",row_in_sparse_layout=", row_in_sparse_layout, ",rows=", rows,
+                        ",start_in_col_indices=", start_in_col_indices, ",end_in_col_indices=", end_in_col_indices);
+
+            for (int j = start_in_col_indices; j < end_in_col_indices; j++) {
+              int key_start = layout_col_indices[j] * block_size;
+              if (key_start >= causal_length) {
+                continue;
               }
+              int keys = std::min(block_size, causal_length - key_start);
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, rows, keys, head_size, alpha,
+                                          q + static_cast<ptrdiff_t>(q_id) * head_size, head_size,
+                                          k + static_cast<ptrdiff_t>(key_start) * head_size, head_size,
+                                          0.0f /*bata*/, row_output + key_start, total_seq_len, nullptr);
             }
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, causal_length, nullptr);
 
-            for (int remain_seq_id = causal_length; remain_seq_id < total_seq_len; remain_seq_id++) {
-              output_softmax[remain_seq_id] = 0.f;
+            for (; q_id < row_end; q_id++) {
+              int q_causal_length = past_seq_len + q_id + 1;
+              T* output_softmax = output + static_cast<ptrdiff_t>(q_id) * total_seq_len;
+              ComputeAttentionSoftmaxInplace(output_softmax, 1, q_causal_length, nullptr);
+              for (int remain_seq_id = q_causal_length; remain_seq_id < total_seq_len; remain_seq_id++) {
+                output_softmax[remain_seq_id] = 0.f;
+              }
             }
-
-            output_softmax += total_seq_len;
-            q_id++;
-
-          } while (q_id < sequence_length);
+          }
         }
 
         DUMP_CPU_TENSOR("softmax", output, sequence_length, total_seq_len);
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/tensor/embedding_bag.h"
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const Tensor& weight = *context->Input<Tensor>(0);
+  const Tensor& indices = *context->Input<Tensor>(1);
+  const Tensor& offsets = *context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  ORT_RETURN_IF_NOT(weight.Shape().NumDimensions() == 2, "EmbeddingBag: weight must be 2D, got ", weight.Shape());
+  ORT_RETURN_IF_NOT(indices.Shape().NumDimensions() == 1, "EmbeddingBag: indices must be 1D, got ", indices.Shape());
+  ORT_RETURN_IF_NOT(offsets.Shape().NumDimensions() == 1, "EmbeddingBag: offsets must be 1D, got ", offsets.Shape());
+  ORT_RETURN_IF_NOT(indices.DataType() == offsets.DataType(), "EmbeddingBag: indices and offsets must have the same type");
+  if (per_sample_weights != nullptr) {
+    ORT_RETURN_IF_NOT(!mean_, "EmbeddingBag: per_sample_weights is only supported with mode 'sum'");
+    ORT_RETURN_IF_NOT(per_sample_weights->Shape() == indices.Shape(),
+                      "EmbeddingBag: per_sample_weights must have the shape of indices, got ",
+                      per_sample_weights->Shape(), " and ", indices.Shape());
+  }
+
+  if (indices.IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(context, weight, indices, offsets, per_sample_weights);
+  }
+  return ComputeImpl<int64_t>(context, weight, indices, offsets, per_sample_weights);
+}
+
+template <typename Tind>
+Status EmbeddingBag::ComputeImpl(OpKernelContext* context, const Tensor& weight, const Tensor& indices,
+                                 const Tensor& offsets, const Tensor* per_sample_weights) const {
+  const int64_t num_rows = weight.Shape()[0];
+  const int64_t row_size = weight.Shape()[1];
+  const int64_t num_indices = indices.Shape()[0];
+  const int64_t num_bags = offsets.Shape()[0];
+
+  const Tind* indices_data = indices.Data<Tind>();
+  const Tind* offsets_data = offsets.Data<Tind>();
+  for (int64_t i = 0; i < num_indices; ++i) {
+    if (indices_data[i] < 0 || indices_data[i] >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag: indices element out of data bounds, idx=",
+                             indices_data[i], " must be within the inclusive range [0,", num_rows - 1, "]");
+    }
+  }
+  for (int64_t b = 0; b < num_bags; ++b) {
+    const int64_t previous = b == 0 ? 0 : static_cast<int64_t>(offsets_data[b - 1]);
+    if ((b == 0 && offsets_data[0] != 0) || offsets_data[b] < previous || offsets_data[b] > num_indices) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: offsets must start at 0, be non-decreasing and not exceed the number of "
+                             "indices ", num_indices, ", got ", offsets_data[b], " at position ", b);
+    }
+  }
+
+  Tensor& output = *context->Output(0, {num_bags, row_size});
+  if (num_bags == 0 || row_size == 0) {
+    return Status::OK();
+  }
+
+  const float* weight_data = weight.Data<float>();
+  const float* sample_weights = per_sample_weights != nullptr ? per_sample_weights->Data<float>() : nullptr;
+  float* output_data = output.MutableData<float>();
+  const size_t row_bytes = narrow<size_t>(row_size) * sizeof(float);
+  const bool mean = mean_;
+
+  const double rows_per_bag = static_cast<double>(num_indices) / static_cast<double>(num_bags);
+  const double bag_bytes = rows_per_bag * static_cast<double>(row_bytes);
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<ptrdiff_t>(num_bags),
+      TensorOpCost{bag_bytes, static_cast<double>(row_bytes), rows_per_bag * static_cast<double>(row_size)},
+      [&](ptrdiff_t first_bag, ptrdiff_t last_bag) {
+        const int64_t last_index = last_bag == num_bags ? num_indices : static_cast<int64_t>(offsets_data[last_bag]);
+        for (ptrdiff_t b = first_bag; b < last_bag; ++b) {
+          const int64_t begin = static_cast<int64_t>(offsets_data[b]);
+          const int64_t end = b + 1 == num_bags ? num_indices : static_cast<int64_t>(offsets_data[b + 1]);
+          float* y = output_data + b * row_size;
+          std::fill_n(y, narrow<size_t>(row_size), 0.0f);
+
+          for (int64_t i = begin; i < end; ++i) {
+            // the rows of the following bags in this range are prefetched as well
+            if (i + kGatherPrefetchDistance < last_index) {
+              PrefetchGatherRow(weight_data + indices_data[i + kGatherPrefetchDistance] * row_size, row_bytes);
+            }
+            const float* row = weight_data + indices_data[i] * row_size;
+            if (sample_weights != nullptr) {
+              const float w = sample_weights[i];
+              for (int64_t j = 0; j < row_size; ++j) {
+                y[j] += w * row[j];
+              }
+            } else {
+              for (int64_t j = 0; j < row_size; ++j) {
+                y[j] += row[j];
+              }
+            }
+          }
+
+          if (mean && end > begin) {
+            const float scale = 1.0f / static_cast<float>(end - begin);
+            for (int64_t j = 0; j < row_size; ++j) {
+              y[j] *= scale;
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
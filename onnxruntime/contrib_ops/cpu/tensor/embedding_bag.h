@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Sums or averages the rows of an embedding table looked up by each bag of indices.
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+    std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag: mode must be 'sum' or 'mean', got '", mode, "'");
+    mean_ = mode == "mean";
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(OpKernelContext* context, const Tensor& weight, const Tensor& indices, const Tensor& offsets,
+                     const Tensor* per_sample_weights) const;
+
+  bool mean_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
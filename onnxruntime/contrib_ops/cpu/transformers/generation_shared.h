@@ -74,11 +74,7 @@ struct IGreedySearchState {
 
 template <typename T>
 struct ISamplingState {
-  gsl::span<int> d_index_in;
-  gsl::span<int> d_index_out;
-  gsl::span<int> d_offset;
-  gsl::span<T> d_sorted_score;
-  gsl::span<float> d_sorted_softmaxed_score;
+  gsl::span<float> d_unfiltered_softmaxed_score;
   gsl::span<float> d_softmaxed_score;
   gsl::span<float> h_softmaxed_score;
   gsl::span<float> d_sampled;
@@ -86,8 +82,6 @@ struct ISamplingState {
   gsl::span<int32_t> d_indices;
   gsl::span<int> d_presence_mask;
 
-  BufferUniquePtr storage_buffer;
-  size_t temp_storage_bytes;
   std::default_random_engine generator;
 
   gsl::span<T> sorted_scores;
@@ -163,6 +157,10 @@ struct IGenerationParameters {
   gsl::span<const int32_t> prefix_vocab_mask;
   gsl::span<const int32_t> presence_mask;
 
+  // Token level state machine of constrained decoding, shape (num_states, vocab_size).
+  gsl::span<const int32_t> grammar_transitions;
+  int grammar_num_states = 0;
+
   // Parameters from outputs.
   bool output_scores;  // whether scores existed in output
 
@@ -194,6 +192,8 @@ struct IGenerationParameters {
   int32_t beginning_timestamp_token_id = -1;
   void* no_speech_probs = nullptr;
 
+  int presence_mask_input_id = -1;
+  int grammar_transitions_input_id = -1;
   int cross_qk_layer_head_input_id = -1;
   int extra_decoding_ids_input_id = -1;
   int cross_qk_output_id = -1;
@@ -94,6 +94,20 @@ void GreedySearch::Init(const OpKernelInfo& info) {
     if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("init_decoder", &proto).IsOK()) {
       has_init_decoder_ = true;
     }
+
+    // Check if the draft_decoder sub-graph attribute is present for speculative decoding.
+    if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("draft_decoder", &proto).IsOK()) {
+      has_draft_decoder_ = true;
+      num_speculative_tokens_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("num_speculative_tokens", 4));
+      ORT_ENFORCE(num_speculative_tokens_ > 0, "num_speculative_tokens shall be positive, got ",
+                  num_speculative_tokens_);
+    }
+  }
+
+  const int64_t prefix_cache_size = info.GetAttrOrDefault<int64_t>("prefix_cache_size", 0);
+  ORT_ENFORCE(prefix_cache_size >= 0, "prefix_cache_size shall not be negative, got ", prefix_cache_size);
+  if (prefix_cache_size > 0) {
+    prefix_cache_ = std::make_unique<PrefixCache>(static_cast<size_t>(prefix_cache_size));
   }
 
   // Make sure the decoder sub-graph attribute is present for all model types.
@@ -132,6 +146,14 @@ Status GreedySearch::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
       init_run_gpt_subgraph_ = std::move(res.second);
       init_run_decoder_feeds_fetches_manager_ = init_run_gpt_subgraph_->GetFeedsFetchesManager();
+    } else if (attribute_name == "draft_decoder") {
+      ORT_ENFORCE(draft_gpt_subgraph_ == nullptr,
+                  "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+      // The draft subgraph does not update 'parameters_', it only needs the vocabulary of the decoder.
+      draft_gpt_subgraph_ = std::make_unique<GptSubgraph>(node, attribute_name,
+                                                          subgraph_session_state.GetGraphViewer());
+      ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->Setup(session_state, subgraph_session_state));
+      draft_feeds_fetches_manager_ = draft_gpt_subgraph_->GetFeedsFetchesManager();
     }
   } else if (parameters_.model_type == IGenerationParameters::kModelTypeT5) {  // encoder-decoder like T5
     ORT_THROW("Not Implemented");
@@ -178,6 +200,15 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
   }
 
+  auto* draft_decoder_session_state = ctx_internal->SubgraphSessionState("draft_decoder");
+  if (has_draft_decoder_) {
+    ORT_ENFORCE(draft_decoder_session_state, "Subgraph SessionState was not found for 'draft_decoder' attribute.");
+    ORT_ENFORCE(draft_feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
+    ORT_RETURN_IF_NOT(draft_gpt_subgraph_->vocab_size == gpt_subgraph_->vocab_size,
+                      "draft_decoder and decoder subgraphs shall have the same vocab_size, got ",
+                      draft_gpt_subgraph_->vocab_size, " and ", gpt_subgraph_->vocab_size);
+  }
+
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   // make a copy since we will update the parameters based on inputs later
@@ -207,6 +238,11 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
       ORT_RETURN_IF_ERROR(impl.Initialize());
+      if (has_draft_decoder_) {
+        impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get(), draft_feeds_fetches_manager_,
+                             num_speculative_tokens_);
+      }
+      impl.SetPrefixCache(prefix_cache_.get());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
     } else {
@@ -231,6 +267,11 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
       ORT_RETURN_IF_ERROR(impl.Initialize());
+      if (has_draft_decoder_) {
+        impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get(), draft_feeds_fetches_manager_,
+                             num_speculative_tokens_);
+      }
+      impl.SetPrefixCache(prefix_cache_.get());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
     }
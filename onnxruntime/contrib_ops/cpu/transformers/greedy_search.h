@@ -8,6 +8,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_parameters.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
 #include "contrib_ops/cpu/transformers/subgraph_gpt.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_encoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_decoder.h"
@@ -124,11 +125,22 @@ class GreedySearch : public IControlFlowKernel {
   FeedsFetchesManager* decoder_feeds_fetches_manager_;
   FeedsFetchesManager* init_run_decoder_feeds_fetches_manager_;
 
+  // Relevant only for GPT2
+  // The draft_gpt_subgraph_ (if the `draft_decoder` attribute is present) proposes the tokens that
+  // the gpt_subgraph_ verifies with speculative decoding.
+  std::unique_ptr<GptSubgraph> draft_gpt_subgraph_;
+  FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+
+  // Present state of the prompts of previous runs (if the `prefix_cache_size` attribute is positive).
+  std::unique_ptr<PrefixCache> prefix_cache_;
+
   IConsoleDumper* dumper_;
 
   GreedySearchParameters parameters_;
 
   bool has_init_decoder_ = false;
+  bool has_draft_decoder_ = false;
+  int num_speculative_tokens_ = 0;
 };
 
 }  // namespace transformers
@@ -29,16 +29,11 @@ struct SamplingState : public ISamplingState<T> {
     this->generator = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
 
     if (is_cuda) {
-      this->d_index_in = AllocateBuffer<int>(allocator, d_index_in_buffer_, SafeInt<size_t>(total_count), stream);
-      this->d_index_out = AllocateBuffer<int>(allocator, d_index_out_buffer_, SafeInt<size_t>(total_count), stream);
-      this->d_offset = AllocateBuffer<int>(allocator, d_offset_buffer_, SafeInt<size_t>(batch_size + 1), stream);
-      this->d_sorted_score = AllocateBuffer<T>(allocator, d_sorted_score_buffer_, SafeInt<size_t>(total_count), stream);
-      this->d_sorted_softmaxed_score = AllocateBuffer<float>(allocator, d_sorted_softmaxed_score_buffer_, SafeInt<size_t>(total_count), stream);
+      this->d_unfiltered_softmaxed_score = AllocateBuffer<float>(allocator, d_unfiltered_softmaxed_score_buffer_, SafeInt<size_t>(total_count), stream);
       this->d_softmaxed_score = AllocateBuffer<float>(allocator, d_softmaxed_score_buffer_, SafeInt<size_t>(total_count), stream);
       this->d_sampled = AllocateBuffer<float>(allocator, d_sampled_buffer_, SafeInt<size_t>(batch_size), stream);
       this->h_sampled_all = AllocateBuffer<float>(cpu_allocator, h_sampled_all_buffer_, SafeInt<size_t>(batch_size * max_iter), stream);
       this->d_indices = AllocateBuffer<int32_t>(allocator, d_indices_buffer_, SafeInt<size_t>(batch_size), stream);
-      this->temp_storage_bytes = 0;
       // TODO: Do not allocate this buffer if there's no presence_mask
       this->d_presence_mask = AllocateBuffer<int>(allocator, d_presence_mask_buffer_, SafeInt<size_t>(total_count), stream);
 
@@ -55,11 +50,7 @@ struct SamplingState : public ISamplingState<T> {
   }
 
  private:
-  IAllocatorUniquePtr<void> d_index_in_buffer_;
-  IAllocatorUniquePtr<void> d_index_out_buffer_;
-  IAllocatorUniquePtr<void> d_offset_buffer_;
-  IAllocatorUniquePtr<void> d_sorted_score_buffer_;
-  IAllocatorUniquePtr<void> d_sorted_softmaxed_score_buffer_;
+  IAllocatorUniquePtr<void> d_unfiltered_softmaxed_score_buffer_;
   IAllocatorUniquePtr<void> d_softmaxed_score_buffer_;
   IAllocatorUniquePtr<void> h_softmaxed_score_buffer_;
   IAllocatorUniquePtr<void> d_sampled_buffer_;
@@ -211,13 +202,32 @@ Status GreedySearchBase<T, ParametersT>::CheckInputs(const OpKernelContextIntern
   //   input_ids          : (batch_size, sequence_length)
   //   vocab_mask         : (vocab_size) or nullptr
   //   decoder_input_ids  : (batch_size, initial_decode_sequence_length)
+  //   grammar_transitions: (num_states, vocab_size) or nullptr
+  auto optional_input = [&context](int input_id) {
+    return input_id >= 0 ? context.Input<Tensor>(input_id) : nullptr;
+  };
   ORT_RETURN_IF_ERROR(this->CheckInputsImpl(parameters_,
-                                            context.Input<Tensor>(0),     // input_ids
-                                            context.Input<Tensor>(4),     // vocab_mask
-                                            context.Input<Tensor>(5),     // prefix_vocab_mask
-                                            context.Input<Tensor>(6),     // attention_mask
-                                            context.Input<Tensor>(7),     // presence_mask
-                                            context.Input<Tensor>(10)));  // decoder_input_ids
+                                            context.Input<Tensor>(0),                            // input_ids
+                                            context.Input<Tensor>(4),                            // vocab_mask
+                                            context.Input<Tensor>(5),                            // prefix_vocab_mask
+                                            context.Input<Tensor>(6),                            // attention_mask
+                                            optional_input(parameters_->presence_mask_input_id),  // presence_mask
+                                            context.Input<Tensor>(10)));                         // decoder_input_ids
+
+  const Tensor* grammar_transitions = optional_input(parameters_->grammar_transitions_input_id);
+  if (grammar_transitions != nullptr) {
+    if (this->IsCuda()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Input 'grammar_transitions' is only supported on CPU");
+    }
+    const auto& dims = grammar_transitions->Shape().GetDims();
+    if (dims.size() != 2 || dims[0] <= 0 || static_cast<int>(dims[1]) != parameters_->vocab_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'grammar_transitions' is expected to have shape (num_states, vocab_size), got ",
+                             grammar_transitions->Shape());
+    }
+    parameters_->grammar_transitions = grammar_transitions->DataAsSpan<int32_t>();
+    parameters_->grammar_num_states = static_cast<int>(dims[0]);
+  }
 
   return Status::OK();
 }
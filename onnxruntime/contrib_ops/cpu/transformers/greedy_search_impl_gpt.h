@@ -3,10 +3,14 @@
 
 #pragma once
 #include <algorithm>
+#include <numeric>
+#include <type_traits>
 #include <vector>
 
+#include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -79,12 +83,69 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Enables speculative decoding: the draft subgraph proposes up to num_speculative_tokens tokens after the last
+  // token, and the decoder subgraph verifies them in one run.
+  void SetDraftDecoder(const SessionState* draft_session_state,
+                       GptSubgraph* draft_gpt_subgraph,
+                       const FeedsFetchesManager* draft_feeds_fetches_manager,
+                       int num_speculative_tokens) {
+    draft_session_state_ = draft_session_state;
+    draft_gpt_subgraph_ = draft_gpt_subgraph;
+    draft_feeds_fetches_manager_ = draft_feeds_fetches_manager;
+    num_speculative_tokens_ = num_speculative_tokens;
+  }
+
+  // Reuses the present state of the cached prompts that start the prompt, and caches the present state of the prompt.
+  void SetPrefixCache(PrefixCache* prefix_cache) {
+    prefix_cache_ = prefix_cache;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                  const FeedsFetchesManager& feeds_fetches_manager);
 
  private:
+  // Speculative decoding runs on CPU for greedy search of a single sequence with separate past and present state.
+  bool UseSpeculativeDecoding() const {
+    return draft_session_state_ != nullptr && !this->IsCuda() &&
+           std::is_same<ParametersT, GreedySearchParameters>::value && this->parameters_->BatchBeamSize() == 1 &&
+           !gpt_subgraph_.past_present_share_buffer_ && !draft_gpt_subgraph_->past_present_share_buffer_;
+  }
+
+  // The prefix cache is used on CPU for a single sequence without padding and with separate past and present state.
+  bool UsePrefixCache(const std::vector<OrtValue>& feeds) const {
+    if (prefix_cache_ == nullptr || this->IsCuda() || this->parameters_->BatchBeamSize() != 1 ||
+        gpt_subgraph_.past_present_share_buffer_) {
+      return false;
+    }
+    gsl::span<const int32_t> mask = feeds[2].Get<Tensor>().DataAsSpan<int32_t>();
+    return std::all_of(mask.begin(), mask.end(), [](int32_t value) { return value == 1; });
+  }
+
+  // Generates the sequence with speculative decoding. In each iteration the draft subgraph proposes k tokens one by
+  // one, and the decoder subgraph computes the logits of the last token and of the k proposed tokens in one run. The
+  // proposed tokens are accepted while they match the tokens generated from these logits, the first token that does
+  // not match is replaced by the generated one. The past state of both subgraphs is then cut to the accepted tokens.
+  Status ExecuteSpeculative(const FeedsFetchesManager* init_run_feeds_fetches_manager,
+                            const FeedsFetchesManager& feeds_fetches_manager,
+                            std::vector<OrtValue>& feeds,
+                            GreedySearchState<T>& greedy_state,
+                            SamplingState<T>& sampling_state);
+
+  // Sets the inputs of a subgraph to run on `tokens`, which follow the first `past_length` tokens of the sequence.
+  // The past state is the present state in `last_outputs` cut to `past_length` tokens.
+  void SetFeedsWithPast(const GptSubgraph& subgraph,
+                           const std::vector<OrtValue>& last_outputs,
+                           std::vector<OrtValue>& next_inputs,
+                           gsl::span<const int32_t> tokens,
+                           int past_length,
+                           gsl::span<const int32_t> prompt_mask,
+                           int32_t first_position);
+
+  // Copies the generated sequences to the `sequences` output.
+  void CopySequencesToOutput(const GreedySearchState<T>& greedy_state, Tensor* output_sequences) const;
+
   // Prepare the inputs for first inference of subgraph
   Status CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                             OrtValue& expanded_input_ids,
@@ -101,6 +162,17 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Removes the rows of the finished sequences from the inputs of the next iteration, so that the subgraph only runs
+  // on the sequences still generating. active_rows holds the batch index of each row of the inputs.
+  void RemoveFinishedRows(gsl::span<const bool> eos_meet,
+                          std::vector<int32_t>& active_rows,
+                          std::vector<OrtValue>& next_inputs,
+                          OrtValue& position_ids,
+                          gsl::span<int32_t> next_positions);
+
+  // Copies the rows of dimension `axis` of `input` given by `rows` to a new tensor.
+  OrtValue GatherRows(const OrtValue& input, int axis, gsl::span<const int32_t> rows);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -116,6 +188,13 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  const SessionState* draft_session_state_ = nullptr;
+  GptSubgraph* draft_gpt_subgraph_ = nullptr;
+  const FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+  int num_speculative_tokens_ = 0;
+
+  PrefixCache* prefix_cache_ = nullptr;
 };
 
 template <typename T, typename ParametersT>
@@ -187,6 +266,273 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+OrtValue GreedySearchGpt<T, ParametersT>::GatherRows(const OrtValue& input, int axis, gsl::span<const int32_t> rows) {
+  const Tensor& tensor = input.Get<Tensor>();
+  const TensorShape& shape = tensor.Shape();
+  TensorShape output_shape = shape;
+  const size_t dim = static_cast<size_t>(axis);
+  output_shape[dim] = static_cast<int64_t>(rows.size());
+
+  OrtValue output;
+  Tensor::InitOrtValue(tensor.DataType(), output_shape, this->temp_space_allocator_, output);
+
+  const size_t outer_count = onnxruntime::narrow<size_t>(shape.SizeToDimension(dim));
+  const size_t row_count = onnxruntime::narrow<size_t>(shape[dim]);
+  const size_t row_bytes = onnxruntime::narrow<size_t>(shape.SizeFromDimension(dim + 1)) * tensor.DataType()->Size();
+  const char* source = static_cast<const char*>(tensor.DataRaw());
+  char* target = static_cast<char*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < outer_count; i++) {
+    for (size_t j = 0; j < rows.size(); j++) {
+      memcpy(target + (i * rows.size() + j) * row_bytes, source + (i * row_count + rows[j]) * row_bytes, row_bytes);
+    }
+  }
+  return output;
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::RemoveFinishedRows(gsl::span<const bool> eos_meet,
+                                                         std::vector<int32_t>& active_rows,
+                                                         std::vector<OrtValue>& next_inputs,
+                                                         OrtValue& position_ids,
+                                                         gsl::span<int32_t> next_positions) {
+  // rows of the inputs to keep, in order
+  std::vector<int32_t> rows;
+  rows.reserve(active_rows.size());
+  for (size_t i = 0; i < active_rows.size(); i++) {
+    if (!eos_meet[active_rows[i]]) {
+      rows.push_back(static_cast<int32_t>(i));
+    }
+  }
+  if (rows.size() == active_rows.size()) {
+    return;
+  }
+
+  // next_inputs: input_ids, position_ids, attention_mask, past_0, past_1, ...
+  next_inputs[0] = GatherRows(next_inputs[0], 0, rows);
+  next_inputs[2] = GatherRows(next_inputs[2], 0, rows);
+  // past state has shape (2, batch_size, num_heads, past_sequence_length, head_size)
+  for (int i = 0; i < gpt_subgraph_.num_layers; i++) {
+    OrtValue& past = next_inputs[static_cast<size_t>(gpt_subgraph_.GetFirstPastInputIndex()) + i];
+    past = GatherRows(past, 1, rows);
+  }
+
+  // The position ids stay in the buffer of next_positions, compacted to its first rows.
+  for (size_t j = 0; j < rows.size(); j++) {
+    next_positions[j] = next_positions[rows[j]];
+    active_rows[j] = active_rows[rows[j]];
+  }
+  active_rows.resize(rows.size());
+
+  int64_t dims[] = {static_cast<int64_t>(rows.size()), 1};
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), TensorShape(&dims[0], 2), next_positions.data(),
+                       this->temp_space_allocator_->Info(), position_ids);
+  next_inputs[1] = position_ids;
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::CopySequencesToOutput(const GreedySearchState<T>& greedy_state,
+                                                            Tensor* output_sequences) const {
+  const ParametersT* parameters = this->parameters_;
+  gsl::span<int32_t> output = output_sequences->MutableDataAsSpan<int32_t>();
+  for (int batch_id = 0; batch_id < parameters->batch_size; ++batch_id) {
+    auto batch_output = output.subspan(
+        static_cast<size_t>(batch_id) * parameters->max_length,
+        parameters->max_length);
+    gsl::span<const int32_t> sequence_source = greedy_state.sequences.GetSequence(batch_id);
+    gsl::copy(sequence_source, batch_output);
+  }
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::SetFeedsWithPast(const GptSubgraph& subgraph,
+                                                          const std::vector<OrtValue>& last_outputs,
+                                                          std::vector<OrtValue>& next_inputs,
+                                                          gsl::span<const int32_t> tokens,
+                                                          int past_length,
+                                                          gsl::span<const int32_t> prompt_mask,
+                                                          int32_t first_position) {
+  // next_inputs: input_ids, position_ids, attention_mask, past_0, past_1, ...
+  const int prompt_length = static_cast<int>(prompt_mask.size());
+  const int length = static_cast<int>(tokens.size());
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  int64_t dims[] = {1, length};
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, TensorShape(&dims[0], 2), this->temp_space_allocator_, input_ids);
+  gsl::copy(tokens, input_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>());
+  next_inputs[0] = input_ids;
+
+  // the generated tokens follow the last position of the prompt
+  OrtValue position_ids;
+  Tensor::InitOrtValue(int32_type, TensorShape(&dims[0], 2), this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int i = 0; i < length; i++) {
+    position_data[i] = first_position + past_length + i - prompt_length;
+  }
+  next_inputs[1] = position_ids;
+
+  int64_t mask_dims[] = {1, past_length + length};
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(int32_type, TensorShape(&mask_dims[0], 2), this->temp_space_allocator_, attention_mask);
+  int32_t* mask_data = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int j = 0; j < past_length + length; j++) {
+    mask_data[j] = j < prompt_length ? prompt_mask[j] : 1;
+  }
+  next_inputs[2] = attention_mask;
+
+  // present state has shape (2, 1, num_heads, total_sequence_length, head_size)
+  for (int i = 0; i < subgraph.num_layers; i++) {
+    const OrtValue& present = last_outputs[static_cast<size_t>(subgraph.GetFirstPresentOutputIndex()) + i];
+    OrtValue& past = next_inputs[static_cast<size_t>(subgraph.GetFirstPastInputIndex()) + i];
+    const Tensor& present_tensor = present.Get<Tensor>();
+    const TensorShape& present_shape = present_tensor.Shape();
+    if (present_shape[3] == past_length) {
+      past = present;
+      continue;
+    }
+
+    TensorShape past_shape = present_shape;
+    past_shape[3] = past_length;
+    Tensor::InitOrtValue(present_tensor.DataType(), past_shape, this->temp_space_allocator_, past);
+    const size_t outer_count = onnxruntime::narrow<size_t>(present_shape.SizeToDimension(3));
+    const size_t head_bytes = onnxruntime::narrow<size_t>(present_shape[4]) * present_tensor.DataType()->Size();
+    const size_t present_bytes = onnxruntime::narrow<size_t>(present_shape[3]) * head_bytes;
+    const size_t past_bytes = static_cast<size_t>(past_length) * head_bytes;
+    const char* source = static_cast<const char*>(present_tensor.DataRaw());
+    char* target = static_cast<char*>(past.GetMutable<Tensor>()->MutableDataRaw());
+    for (size_t j = 0; j < outer_count; j++) {
+      memcpy(target + j * past_bytes, source + j * present_bytes, past_bytes);
+    }
+  }
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculative(const FeedsFetchesManager* init_run_feeds_fetches_manager,
+                                                           const FeedsFetchesManager& feeds_fetches_manager,
+                                                           std::vector<OrtValue>& feeds,
+                                                           GreedySearchState<T>& greedy_state,
+                                                           SamplingState<T>& sampling_state) {
+  const ParametersT* parameters = this->parameters_;
+  const int prompt_length = parameters->sequence_length;
+
+  auto run_subgraph = [this](const SessionState& session_state, const FeedsFetchesManager& ffm,
+                             std::vector<OrtValue>& subgraph_feeds, std::vector<OrtValue>& subgraph_fetches) {
+    return utils::ExecuteSubgraph(session_state, ffm, subgraph_feeds, subgraph_fetches, {},
+                                  ExecutionMode::ORT_SEQUENTIAL, this->context_.GetTerminateFlag(),
+                                  this->context_.Logger(), this->ort_stream_);
+  };
+
+  // The generated tokens are not masked and their positions follow the prompt ones.
+  const std::vector<int32_t> prompt_mask(feeds[2].Get<Tensor>().DataAsSpan<int32_t>().begin(),
+                                         feeds[2].Get<Tensor>().DataAsSpan<int32_t>().end());
+  const int32_t first_position = greedy_state.next_positions[0];
+
+  std::vector<OrtValue> draft_feeds;
+  IAllocatorUniquePtr<char> draft_buffer;
+  OrtValue draft_input_ids;
+  std::vector<int32_t> draft_sequence_lengths_data(1);
+  gsl::span<int32_t> draft_sequence_lengths(draft_sequence_lengths_data);
+  ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->CreateInitialFeeds(this->context_.GetInputOrtValue(0)->Get<Tensor>(),
+                                                              this->implicit_inputs_,
+                                                              parameters->num_beams,
+                                                              parameters->pad_token_id,
+                                                              draft_sequence_lengths,
+                                                              draft_input_ids,
+                                                              this->context_.GetInputOrtValue(6),
+                                                              draft_feeds,
+                                                              this->create_inputs_func_,
+                                                              this->add_to_feeds_func_,
+                                                              draft_buffer,
+                                                              this->ort_stream_,
+                                                              parameters->max_length));
+
+  // Both subgraphs run on the prompt, the decoder generates the first token.
+  std::vector<OrtValue> fetches;
+  std::vector<OrtValue> draft_fetches;
+  if (init_run_decoder_session_state_ != nullptr) {
+    ORT_RETURN_IF_ERROR(run_subgraph(*init_run_decoder_session_state_, *init_run_feeds_fetches_manager, feeds,
+                                     fetches));
+  } else {
+    ORT_RETURN_IF_ERROR(run_subgraph(this->decoder_session_state_, feeds_fetches_manager, feeds, fetches));
+  }
+  ORT_RETURN_IF_ERROR(run_subgraph(*draft_session_state_, *draft_feeds_fetches_manager_, draft_feeds, draft_fetches));
+
+  int counter = 0;
+  gsl::span<int32_t> next_tokens;
+  ORT_RETURN_IF_ERROR(this->GenerateNextToken(fetches[0], next_tokens, greedy_state, sampling_state, ++counter,
+                                              parameters->eos_token_id));
+
+  // The past state of the decoder holds all the tokens but the last one, the draft one may lag one more token.
+  int current_length = prompt_length + 1;
+  int draft_past_length = prompt_length;
+  std::vector<int32_t> draft_tokens;
+  std::vector<int32_t> tokens;
+  while (!greedy_state.eos_meet[0] && current_length < parameters->max_length) {
+    const int max_draft_tokens = std::min(num_speculative_tokens_, parameters->max_length - current_length - 1);
+
+    // The draft subgraph proposes the next tokens greedily from its raw logits.
+    draft_tokens.clear();
+    gsl::span<const int32_t> sequence = greedy_state.sequences.GetSequence(0);
+    tokens.assign(sequence.begin() + draft_past_length, sequence.begin() + current_length);
+    for (int i = 0; i < max_draft_tokens; i++) {
+      SetFeedsWithPast(*draft_gpt_subgraph_, draft_fetches, draft_feeds, tokens, draft_past_length, prompt_mask,
+                          first_position);
+      draft_fetches.clear();
+      ORT_RETURN_IF_ERROR(run_subgraph(*draft_session_state_, *draft_feeds_fetches_manager_, draft_feeds,
+                                       draft_fetches));
+      draft_past_length += static_cast<int>(tokens.size());
+
+      const Tensor& draft_logits = draft_fetches[0].Get<Tensor>();
+      const int64_t vocab_size = draft_logits.Shape()[2];
+      const size_t offset = onnxruntime::narrow<size_t>((draft_logits.Shape()[1] - 1) * vocab_size);
+      int32_t token = 0;
+      if (draft_logits.IsDataType<float>()) {
+        const float* scores = draft_logits.Data<float>() + offset;
+        token = static_cast<int32_t>(std::max_element(scores, scores + vocab_size) - scores);
+      } else {
+        const MLFloat16* scores = draft_logits.Data<MLFloat16>() + offset;
+        for (int64_t j = 1; j < vocab_size; j++) {
+          if (scores[j].ToFloat() > scores[token].ToFloat()) {
+            token = static_cast<int32_t>(j);
+          }
+        }
+      }
+      draft_tokens.push_back(token);
+      tokens.assign(1, token);
+    }
+
+    // The decoder computes the logits of the last token and of the proposed tokens.
+    tokens.assign(1, sequence[current_length - 1]);
+    tokens.insert(tokens.end(), draft_tokens.begin(), draft_tokens.end());
+    SetFeedsWithPast(gpt_subgraph_, fetches, feeds, tokens, current_length - 1, prompt_mask, first_position);
+    fetches.clear();
+    ORT_RETURN_IF_ERROR(run_subgraph(this->decoder_session_state_, feeds_fetches_manager, feeds, fetches));
+
+    const Tensor& logits = fetches[0].Get<Tensor>();
+    const TensorShape& logits_shape = logits.Shape();
+    int64_t token_logits_dims[] = {1, 1, logits_shape[2]};
+    const size_t token_logits_bytes = logits.SizeInBytes() / onnxruntime::narrow<size_t>(logits_shape[1]);
+    for (size_t i = 0; i < tokens.size(); i++) {
+      OrtValue token_logits;
+      Tensor::InitOrtValue(logits.DataType(), TensorShape(&token_logits_dims[0], 3),
+                           const_cast<char*>(static_cast<const char*>(logits.DataRaw())) + i * token_logits_bytes,
+                           logits.Location(), token_logits);
+      ORT_RETURN_IF_ERROR(this->GenerateNextToken(token_logits, next_tokens, greedy_state, sampling_state, ++counter,
+                                                  parameters->eos_token_id));
+      ++current_length;
+      if (greedy_state.eos_meet[0] || i == draft_tokens.size() || next_tokens[0] != draft_tokens[i]) {
+        break;
+      }
+    }
+
+    // Drop the state of the rejected tokens, the accepted ones are in the sequence before its last token.
+    draft_past_length = std::min(draft_past_length, current_length - 1);
+  }
+
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -268,6 +614,37 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  if (UseSpeculativeDecoding()) {
+    ORT_RETURN_IF_ERROR(ExecuteSpeculative(init_run_feeds_fetches_manager, feeds_fetches_manager, feeds, greedy_state,
+                                           sampling_state));
+    CopySequencesToOutput(greedy_state, output_sequences);
+    return Status::OK();
+  }
+
+  // The decoder subgraph runs on the part of the prompt after the longest cached prompt that starts it. When the
+  // whole prompt is cached, its last token is run again to get the logits.
+  const bool use_prefix_cache = UsePrefixCache(feeds);
+  gsl::span<const int32_t> prompt = input_ids.first(parameters->sequence_length);
+  int cached_length = 0;
+  if (use_prefix_cache) {
+    std::vector<OrtValue> cached_outputs(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()));
+    cached_length = prefix_cache_->Find(prompt, cached_outputs);
+    if (cached_length > 0) {
+      const int past_length = std::min(cached_length, parameters->sequence_length - 1);
+      const std::vector<int32_t> prompt_mask(prompt.size(), 1);
+      SetFeedsWithPast(gpt_subgraph_, cached_outputs, feeds, prompt.subspan(past_length), past_length, prompt_mask,
+                       greedy_state.next_positions[0]);
+    }
+  }
+
+  // On CPU, the sequences that meet EOS leave the batch of the subgraph. active_rows holds the batch index of each
+  // row of the subgraph inputs, the logits of these rows are scattered to full_logits for the logits processing.
+  const bool remove_finished_rows = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_;
+  std::vector<int32_t> active_rows(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_rows.begin(), active_rows.end(), 0);
+  std::vector<int32_t> active_next_tokens;
+  OrtValue full_logits;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -280,9 +657,9 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     dumper->Print("past", feeds[3]);
 #endif
 
-    // For the first iteration use the init_run_decoder subgraph (if present)
+    // For the first iteration use the init_run_decoder subgraph (if present), unless the past state is cached
     if (iteration_counter++ == 0 &&
-        init_run_decoder_session_state_ != nullptr) {
+        init_run_decoder_session_state_ != nullptr && cached_length == 0) {
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       const_cast<SessionState*>(this->init_run_decoder_session_state_)->IncrementGraphExecutionCounter();
 #endif
@@ -312,10 +689,32 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    if (iteration_counter == 1 && use_prefix_cache && cached_length < parameters->sequence_length) {
+      prefix_cache_->Insert(prompt, gsl::make_span(fetches).subspan(gpt_subgraph_.GetFirstPresentOutputIndex(),
+                                                                     gpt_subgraph_.num_layers));
+    }
+
+    const OrtValue* logits = &fetches[0];
+    if (active_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      const Tensor& active_logits = fetches[0].Get<Tensor>();
+      const TensorShape& active_logits_shape = active_logits.Shape();
+      if (!full_logits.IsAllocated() || full_logits.Get<Tensor>().Shape()[1] != active_logits_shape[1]) {
+        int64_t logits_dims[] = {parameters->BatchBeamSize(), active_logits_shape[1], active_logits_shape[2]};
+        Tensor::InitOrtValue(active_logits.DataType(), TensorShape(&logits_dims[0], 3), this->temp_space_allocator_,
+                             full_logits);
+        memset(full_logits.GetMutable<Tensor>()->MutableDataRaw(), 0, full_logits.Get<Tensor>().SizeInBytes());
+      }
+      const size_t row_bytes = active_logits.SizeInBytes() / active_rows.size();
+      const char* source = static_cast<const char*>(active_logits.DataRaw());
+      char* target = static_cast<char*>(full_logits.GetMutable<Tensor>()->MutableDataRaw());
+      for (size_t j = 0; j < active_rows.size(); j++) {
+        memcpy(target + active_rows[j] * row_bytes, source + j * row_bytes, row_bytes);
+      }
+      logits = &full_logits;
+    }
     gsl::span<int32_t> next_tokens;
 
-    ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
+    ORT_RETURN_IF_ERROR(this->GenerateNextToken(*logits,
                                                 next_tokens,
                                                 greedy_state,
                                                 sampling_state,
@@ -361,10 +760,23 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
+      gsl::span<const int32_t> feed_tokens = ReinterpretAsSpan<const int32_t>(next_tokens);
+      if (active_rows.size() < next_tokens.size()) {
+        active_next_tokens.resize(active_rows.size());
+        for (size_t j = 0; j < active_rows.size(); j++) {
+          active_next_tokens[j] = next_tokens[active_rows[j]];
+        }
+        feed_tokens = active_next_tokens;
+      }
+
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
+                                      feed_tokens,
                                       current_length - 1));
+
+      if (remove_finished_rows) {
+        RemoveFinishedRows(greedy_state.eos_meet, active_rows, feeds, position_ids, greedy_state.next_positions);
+      }
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
@@ -376,15 +788,7 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     }
   }
 
-  // Copy the sequences to output
-  gsl::span<int32_t> output = output_sequences->MutableDataAsSpan<int32_t>();
-  for (int batch_id = 0; batch_id < parameters->batch_size; ++batch_id) {
-    auto batch_output = output.subspan(
-        static_cast<size_t>(batch_id) * parameters->max_length,
-        parameters->max_length);
-    gsl::span<const int32_t> sequence_source = greedy_state.sequences.GetSequence(batch_id);
-    gsl::copy(sequence_source, batch_output);
-  }
+  CopySequencesToOutput(greedy_state, output_sequences);
 
 #ifdef DEBUG_GENERATION
   // Debug the one step filtered logits for sampling
@@ -149,6 +149,50 @@ void PrefixVocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
   }
 }
 
+template <typename T>
+GrammarLogitsProcessor<T>::GrammarLogitsProcessor(const gsl::span<const int32_t>& transitions, int num_states)
+    : transitions_(transitions),
+      num_states_(num_states) {
+}
+
+template <typename T>
+void GrammarLogitsProcessor<T>::Process(const ISequences* sequences,
+                                        NextTokenScores<T>& next_token_scores) {
+  assert(!transitions_.empty());
+
+  // the first call sees the prompts only.
+  const int sequence_length = sequences->GetSequenceLength();
+  if (prompt_length_ < 0) {
+    prompt_length_ = sequence_length;
+  }
+
+  const int vocab_size = next_token_scores.vocab_size;
+  for (int i = 0; i < next_token_scores.batch_beam_size; i++) {
+    // the state is walked from the prompt so that it follows the beams of beam search, the walk is short next to
+    // the masking of the vocabulary.
+    gsl::span<const int32_t> sequence = sequences->GetSequence(i);
+    int state = 0;
+    for (int j = prompt_length_; j < sequence_length && state >= 0; j++) {
+      const int32_t token = sequence[j];
+      state = token >= 0 && token < vocab_size ? transitions_[SafeInt<size_t>(state) * vocab_size + token] : -1;
+      if (state >= num_states_) {
+        state = -1;
+      }
+    }
+    if (state < 0) {
+      continue;
+    }
+
+    const int32_t* next_states = transitions_.data() + SafeInt<size_t>(state) * vocab_size;
+    gsl::span<T> scores = next_token_scores.GetScores(i);
+    for (int k = 0; k < vocab_size; k++) {
+      if (next_states[k] < 0) {
+        scores[k] = std::numeric_limits<T>::lowest();
+      }
+    }
+  }
+}
+
 template <typename T>
 TemperatureLogitsProcessor<T>::TemperatureLogitsProcessor(float temperature) : temperature_(temperature) {
 }
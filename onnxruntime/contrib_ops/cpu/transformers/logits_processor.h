@@ -115,6 +115,24 @@ class PrefixVocabMaskLogitsProcessor : public ILogitsProcessor<T> {
   const int batch_size_;
 };
 
+// Constrained decoding with a token level state machine, like a grammar or a regular expression compiled over the
+// vocabulary. transitions[state * vocab_size + token] is the state after the token, or -1 when the token is not
+// allowed. Every sequence starts in state 0 after its prompt, and the tokens leading to no state are masked. A sequence
+// that left the state machine, e.g. with the padding after its EOS, is not masked.
+template <typename T>
+class GrammarLogitsProcessor : public ILogitsProcessor<T> {
+ public:
+  GrammarLogitsProcessor(const gsl::span<const int32_t>& transitions, int num_states);
+
+  void Process(const ISequences* sequences,
+               NextTokenScores<T>& next_token_scores) override;
+
+ private:
+  gsl::span<const int32_t> transitions_;
+  const int num_states_;
+  int prompt_length_ = -1;
+};
+
 template <typename T>
 class TemperatureLogitsProcessor : public ILogitsProcessor<T> {
  public:
@@ -330,6 +348,12 @@ class LogitsProcessorList : public ILogitsProcessorList {
       processor_list_.push_back(prefix_vocab_mask_processor_.get());
     }
 
+    if (!parameters.grammar_transitions.empty()) {
+      grammar_processor_ = std::make_unique<GrammarLogitsProcessor<float>>(parameters.grammar_transitions,
+                                                                            parameters.grammar_num_states);
+      processor_list_.push_back(grammar_processor_.get());
+    }
+
     if (parameters.min_length > 0) {
       min_length_processor_ = std::make_unique<MinLengthLogitsProcessor<float>>(parameters.min_length,
                                                                                 parameters.eos_token_id);
@@ -375,6 +399,7 @@ class LogitsProcessorList : public ILogitsProcessorList {
   std::unique_ptr<NoRepeatNGramLogitsProcessor<float>> no_repeat_ngram_processor_;
   std::unique_ptr<VocabMaskLogitsProcessor<float>> vocab_mask_processor_;
   std::unique_ptr<PrefixVocabMaskLogitsProcessor<float>> prefix_vocab_mask_processor_;
+  std::unique_ptr<GrammarLogitsProcessor<float>> grammar_processor_;
   std::unique_ptr<MinLengthLogitsProcessor<float>> min_length_processor_;
   std::unique_ptr<TemperatureLogitsProcessor<float>> temperature_processor_;
   std::unique_ptr<PresencePenaltyLogitsProcessor<float>> presence_penalty_processor_;
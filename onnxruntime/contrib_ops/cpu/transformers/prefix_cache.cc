@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+namespace {
+
+// FNV-1a, one token at a time so that the hashes of all the prefixes are computed in one pass.
+constexpr uint64_t kHashBasis = 14695981039346656037ULL;
+
+uint64_t HashToken(uint64_t hash, int32_t token) {
+  const uint32_t value = static_cast<uint32_t>(token);
+  for (int i = 0; i < 4; i++) {
+    hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+int PrefixCache::Find(gsl::span<const int32_t> tokens, std::vector<OrtValue>& presents) {
+  std::vector<uint64_t> prefix_hashes(tokens.size());
+  uint64_t hash = kHashBasis;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    hash = HashToken(hash, tokens[i]);
+    prefix_hashes[i] = hash;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t length = tokens.size(); length > 0; length--) {
+    auto it = entries_.find(prefix_hashes[length - 1]);
+    if (it == entries_.end()) {
+      continue;
+    }
+
+    Entry& entry = it->second;
+    if (entry.tokens.size() != length || !std::equal(entry.tokens.begin(), entry.tokens.end(), tokens.begin())) {
+      continue;
+    }
+
+    lru_.splice(lru_.begin(), lru_, entry.lru_position);
+    presents.insert(presents.end(), entry.presents.begin(), entry.presents.end());
+    return static_cast<int>(length);
+  }
+
+  return 0;
+}
+
+void PrefixCache::Insert(gsl::span<const int32_t> tokens, gsl::span<const OrtValue> presents) {
+  if (capacity_ == 0 || tokens.empty()) {
+    return;
+  }
+
+  uint64_t hash = kHashBasis;
+  for (int32_t token : tokens) {
+    hash = HashToken(hash, token);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(hash);
+  if (it != entries_.end()) {
+    // a prompt with the same hash is replaced by the most recent one
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  } else if (entries_.size() == capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+
+  lru_.push_front(hash);
+  Entry& entry = entries_[hash];
+  entry.tokens.assign(tokens.begin(), tokens.end());
+  entry.presents.assign(presents.begin(), presents.end());
+  entry.lru_position = lru_.begin();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <gsl/gsl>
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// This class keeps the present state of the decoder subgraph after the prompts of previous requests, so that a
+// request whose prompt starts with a cached prompt only runs the decoder subgraph on the rest of its prompt.
+// Prompts are keyed by the hash of their tokens, and the least recently used prompt is dropped when it is full.
+class PrefixCache {
+ public:
+  explicit PrefixCache(size_t capacity) : capacity_(capacity) {}
+
+  // Finds the longest cached prompt that is a prefix of `tokens`. Returns its length, or 0 if there is none, and
+  // appends its present state (one tensor per layer) to `presents`.
+  int Find(gsl::span<const int32_t> tokens, std::vector<OrtValue>& presents);
+
+  // Caches the present state (one tensor per layer) after `tokens`.
+  void Insert(gsl::span<const int32_t> tokens, gsl::span<const OrtValue> presents);
+
+ private:
+  struct Entry {
+    std::vector<int32_t> tokens;
+    std::vector<OrtValue> presents;
+    std::list<uint64_t>::iterator lru_position;
+  };
+
+  std::mutex mutex_;
+  size_t capacity_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  std::list<uint64_t> lru_;  // hashes of the prompts, most recently used first
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -19,6 +19,8 @@ void SamplingParameters::ParseFromAttributes(const OpKernelInfo& info) {
   presence_penalty = info.GetAttrOrDefault<float>("presence_penalty", 0.0f);
   custom_sampling = static_cast<int>(info.GetAttrOrDefault<int64_t>("custom", 0));
   vocab_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("vocab_size", -1));
+  presence_mask_input_id = 7;
+  grammar_transitions_input_id = 9;
 }
 
 void SamplingParameters::ParseFromInputs(OpKernelContext* context) {
@@ -207,6 +207,16 @@ Status WhisperDecoderSubgraph::CreateInitialFeeds(
   // When first_past_input_index_ == 1, the past states are copied from the second output of encoder.
   // TODO: MAKE IT MORE READABLE
   for (size_t j = static_cast<size_t>(3) - first_past_input_index_; j < encoder_fetches.size(); j++) {
+    // past key/value for cross attention does not need to be initialized with max_seq_len since they are static.
+    bool use_max_seq_len = j != 1 && (j - first_past_input_index_) <= 2 * static_cast<size_t>(num_layers);
+
+    // The encoder runs once per batch entry, so with one beam its outputs already have the shapes of the decoder
+    // inputs and are fed without a copy, unless a self attention past state is padded to the max sequence length.
+    if (num_beam == 1 && !(use_max_seq_len && past_present_share_buffer_max_seq_len > 0)) {
+      decoder_feeds.push_back(encoder_fetches[j]);
+      continue;
+    }
+
     if (j == 1) {
       ORT_RETURN_IF(has_hidden_state_ == false, "Invalid hidden_states expension: has_hidden_state_ == false");
       OrtValue expanded_hidden_states;
@@ -229,9 +239,6 @@ Status WhisperDecoderSubgraph::CreateInitialFeeds(
       }
       decoder_feeds.push_back(expanded_hidden_states);
     } else {
-      // past key/value for cross attention does not need to be initialized with max_seq_len since they are static.
-      bool use_max_seq_len = (j - first_past_input_index_) <= 2 * static_cast<size_t>(num_layers);
-
       OrtValue expanded_cache;
       if (is_output_float16_) {
         ORT_RETURN_IF_ERROR(expand_buffer_float16_func(stream,
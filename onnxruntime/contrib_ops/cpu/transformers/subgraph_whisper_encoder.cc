@@ -33,8 +33,8 @@ namespace transformers {
       ... (for each cross attention layer)
 
     Note:
-      Here, B = batch_size * num_beams since we expand the inputs.
-      Ideally, we could use B=batch_size and expand the outputs with a factor of num_beams.
+      Here, B = batch_size. The cross attention key/value are computed once per audio input and expanded with a
+      factor of num_beams when the decoder feeds are created, they are not copied again in the decoding steps.
       Data type of input or output is float or float16 if not specified.
 */
 
@@ -46,6 +46,10 @@ Status RotaryEmbedding<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* position_ids = context->Input<Tensor>(1);
   const Tensor* cos_cache = context->Input<Tensor>(2);
   const Tensor* sin_cache = context->Input<Tensor>(3);
+  if (cos_cache == nullptr || sin_cache == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "RotaryEmbedding without cos_cache and sin_cache is only supported on CPU");
+  }
 
   RotaryParameters parameters = {};
   ORT_RETURN_IF_ERROR(rotary_embedding_helper::CheckInputs<Tensor>(input,
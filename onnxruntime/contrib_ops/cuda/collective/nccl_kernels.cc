@@ -228,11 +228,19 @@ NcclContext::NcclContext() {
   ORT_ENFORCE(ret.IsOK());
 }
 
+NcclContext::NcclContext(ncclComm_t comm, int rank, int world_size)
+    : comm_(comm), rank_(rank), world_size_(world_size), single_process_(true) {
+}
+
 NcclContext::~NcclContext() {
   if (comm_ != nullptr) {
     ncclCommDestroy(comm_);
   }
 
+  if (single_process_) {
+    return;
+  }
+
 #ifdef USE_MPI
   int is_mpi_finalized = 0;
   MPI_Finalized(&is_mpi_finalized);
@@ -242,9 +250,40 @@ NcclContext::~NcclContext() {
 #endif
 }
 
+InlinedVector<std::unique_ptr<NcclContext>> NcclContext::CreateSingleProcessContexts() {
+  int device_count = 0;
+  CUDA_CALL_THROW(cudaGetDeviceCount(&device_count));
+  const int world_size = ParseEnvironmentVariableWithDefault<int32_t>("LOCAL_WORLD_SIZE", device_count);
+  ORT_ENFORCE(world_size > 0 && world_size <= device_count, "LOCAL_WORLD_SIZE is ", world_size, " but only ",
+              device_count, " CUDA devices are visible to the process.");
+
+  // ncclCommInitAll creates the communicators of all the local devices at once, rank i uses device i.
+  InlinedVector<ncclComm_t> comms(world_size, nullptr);
+  NCCL_CALL_THROW(ncclCommInitAll(comms.data(), world_size, nullptr));
+
+  InlinedVector<std::unique_ptr<NcclContext>> contexts;
+  contexts.reserve(world_size);
+  for (int rank = 0; rank < world_size; ++rank) {
+    contexts.push_back(std::unique_ptr<NcclContext>(new NcclContext(comms[rank], rank, world_size)));
+  }
+  return contexts;
+}
+
+NcclContext* NcclContext::GetInstance(int device_id) {
+  static const bool single_process = ParseEnvironmentVariableWithDefault<bool>("ORT_NCCL_SINGLE_PROCESS", false);
+  if (!single_process) {
+    static NcclContext context;
+    return &context;
+  }
+
+  static const InlinedVector<std::unique_ptr<NcclContext>> contexts = CreateSingleProcessContexts();
+  ORT_ENFORCE(device_id >= 0 && static_cast<size_t>(device_id) < contexts.size(), "CUDA device ", device_id,
+              " is not in the NCCL group of ", contexts.size(), " local devices.");
+  return contexts[device_id].get();
+}
+
 NcclKernel::NcclKernel(const OpKernelInfo& info) : CudaKernel(info) {
-  static NcclContext context;
-  nccl_ = &context;
+  nccl_ = NcclContext::GetInstance(GetDeviceId());
 }
 
 AllReduce::AllReduce(const OpKernelInfo& info) : NcclKernel(info) {
@@ -259,6 +298,44 @@ Status AllReduce::ComputeInternal(OpKernelContext* context) const {
 
   void* output_data = context->Output(0, in_shape)->MutableDataRaw();
 
+  const int input_tensor_count = context->InputCount();
+  if (input_tensor_count > 1) {
+    // A bucket of tensors, e.g. the gradients that became ready together in the backward pass.
+    // The inputs are allocated contiguously and the outputs alias them, so the whole bucket is usually reduced in a
+    // single call. ORT pads the tensors to keep them aligned, and the padding gaps are reduced along with the data.
+    // A gap of kMaxPaddingBytes or more may hold another tensor, and then the tensors are reduced one by one.
+    constexpr ptrdiff_t kMaxPaddingBytes = 256;
+    const auto* element_type = input_tensor->DataType();
+    const auto* input_begin = static_cast<const int8_t*>(input_data);
+    const int8_t* input_end = input_begin;
+    bool is_contiguous = true;
+    for (int i = 0; i < input_tensor_count; ++i) {
+      const Tensor* input = context->Input<Tensor>(i);
+      ORT_RETURN_IF_NOT(input->DataType() == element_type, "All the inputs of AllReduce must have the same type.");
+      Tensor* output = context->Output(i, input->Shape());
+      const auto* data = static_cast<const int8_t*>(input->DataRaw());
+      is_contiguous = is_contiguous && output->DataRaw() == input->DataRaw() &&
+                      (i == 0 || (data >= input_end && data - input_end < kMaxPaddingBytes));
+      input_end = data + input->SizeInBytes();
+    }
+
+    const auto num_bytes = static_cast<size_t>(input_end - input_begin);
+    if (is_contiguous && num_bytes % element_type->Size() == 0) {
+      input_count = static_cast<int64_t>(num_bytes / element_type->Size());
+    } else {
+      ncclComm_t comm = nccl_->Comm();
+      ncclDataType_t dtype = GetNcclDataType(element_type);
+      NCCL_RETURN_IF_ERROR(ncclGroupStart());
+      for (int i = 0; i < input_tensor_count; ++i) {
+        const Tensor* input = context->Input<Tensor>(i);
+        NCCL_RETURN_IF_ERROR(ncclAllReduce(input->DataRaw(), context->Output<Tensor>(i)->MutableDataRaw(),
+                                           input->Shape().Size(), dtype, ncclSum, comm, Stream(context)));
+      }
+      NCCL_RETURN_IF_ERROR(ncclGroupEnd());
+      return Status::OK();
+    }
+  }
+
 #ifndef USE_ROCM
   return FuncCustomAllReduce(nccl_,
                              Stream(context),
@@ -443,7 +520,9 @@ Status FuncCustomAllReduce(
   onnxruntime::cuda::collective::AllReduceStrategyType runtime_strategy =
       onnxruntime::cuda::collective::SelectImplementation(input_count, rank, world_size, data_type);
 
-  if (runtime_strategy == onnxruntime::cuda::collective::AllReduceStrategyType::NCCL) {
+  // The custom kernels exchange their workspaces with CUDA IPC, which only works between processes. NCCL uses the
+  // peer to peer transport between the GPUs of a single process.
+  if (runtime_strategy == onnxruntime::cuda::collective::AllReduceStrategyType::NCCL || nccl->IsSingleProcess()) {
     ncclDataType_t dtype = GetNcclDataType(data_type);
     NCCL_RETURN_IF_ERROR(ncclAllReduce(input_data, output_data, input_count, dtype, ncclSum, nccl->Comm(), stream));
 
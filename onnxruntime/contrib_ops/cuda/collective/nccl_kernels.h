@@ -38,6 +38,12 @@ class NcclContext final {
   NcclContext();
   ~NcclContext();
 
+  // Returns the communicator of the kernels running on the CUDA device `device_id`. By default there is a single
+  // communicator per process, whose rank comes from MPI or LOCAL_RANK. With ORT_NCCL_SINGLE_PROCESS=1 the process
+  // drives all the GPUs of the group itself, typically with one session and one thread per GPU: a communicator is
+  // created for each of the LOCAL_WORLD_SIZE (by default all the visible) devices and the rank is the device id.
+  static NcclContext* GetInstance(int device_id);
+
   ncclComm_t Comm() {
     return comm_;
   }
@@ -50,10 +56,19 @@ class NcclContext final {
     return world_size_;
   }
 
+  // Whether the ranks of the communicator are the GPUs of this process rather than other processes.
+  bool IsSingleProcess() const {
+    return single_process_;
+  }
+
  private:
+  NcclContext(ncclComm_t comm, int rank, int world_size);
+  static InlinedVector<std::unique_ptr<NcclContext>> CreateSingleProcessContexts();
+
   ncclComm_t comm_;
   int rank_;
   int world_size_;
+  bool single_process_ = false;
 };
 
 class NcclKernel : public ::onnxruntime::cuda::CudaKernel {
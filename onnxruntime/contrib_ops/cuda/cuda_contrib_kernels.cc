@@ -44,6 +44,10 @@ class CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, TransposeMatMul);  // backward c
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedMatMul);
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, double, FusedMatMul);
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedMatMul);
+class CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedGemm);
+class CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedGemm);
+class CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedElementwise);
+class CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedElementwise);
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, float, RelativePositionBias);
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, RelativePositionBias);
 class CUDA_MS_OP_TYPED_CLASS_NAME(1, float, GatedRelativePositionBias);
@@ -252,6 +256,10 @@ Status RegisterCudaContribKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedMatMul)>,
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, double, FusedMatMul)>,
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedMatMul)>,
+      BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedGemm)>,
+      BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedGemm)>,
+      BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, float, FusedElementwise)>,
+      BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, FusedElementwise)>,
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, float, RelativePositionBias)>,
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, MLFloat16, RelativePositionBias)>,
       BuildKernelCreateInfo<CUDA_MS_OP_TYPED_CLASS_NAME(1, float, GatedRelativePositionBias)>,
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise.h"
+
+#include <string>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedElementwise,                                           \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      (*KernelDefBuilder::Create())                               \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedElementwise<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// Returns false if `op_type` is not an elementwise operator supported by the program.
+bool GetOpCode(const std::string& op_type, FusedElementwiseOpCode& op) {
+  static const InlinedHashMap<std::string, FusedElementwiseOpCode> op_codes{
+      {"Add", FusedElementwiseOpCode::Add},
+      {"Sub", FusedElementwiseOpCode::Sub},
+      {"Mul", FusedElementwiseOpCode::Mul},
+      {"Div", FusedElementwiseOpCode::Div},
+      {"Abs", FusedElementwiseOpCode::Abs},
+      {"Erf", FusedElementwiseOpCode::Erf},
+      {"Exp", FusedElementwiseOpCode::Exp},
+      {"Neg", FusedElementwiseOpCode::Neg},
+      {"Relu", FusedElementwiseOpCode::Relu},
+      {"Sigmoid", FusedElementwiseOpCode::Sigmoid},
+      {"Sqrt", FusedElementwiseOpCode::Sqrt},
+      {"Tanh", FusedElementwiseOpCode::Tanh},
+  };
+  auto it = op_codes.find(op_type);
+  if (it == op_codes.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info), program_{} {
+  const size_t input_count = info.GetInputCount();
+  std::vector<std::string> ops = info.GetAttrsOrDefault<std::string>("ops");
+  std::vector<int64_t> operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise: the program must have at least one operator.");
+  ORT_ENFORCE(ops.size() <= static_cast<size_t>(kMaxFusedElementwiseOps) &&
+                  input_count <= static_cast<size_t>(kMaxFusedElementwiseInputs),
+              "FusedElementwise: the CUDA kernel supports up to ", kMaxFusedElementwiseOps, " operators and ",
+              kMaxFusedElementwiseInputs, " inputs, got ", ops.size(), " and ", input_count, ".");
+  ORT_ENFORCE(operands.size() == 2 * ops.size(),
+              "FusedElementwise: 'operands' must hold two registers per operator, got ", operands.size(),
+              " for ", ops.size(), " operators.");
+
+  program_.input_count = static_cast<int>(input_count);
+  program_.op_count = static_cast<int>(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    ORT_ENFORCE(GetOpCode(ops[i], program_.ops[i]), "FusedElementwise: unsupported operator ", ops[i]);
+    const int64_t a = operands[2 * i];
+    const int64_t b = operands[2 * i + 1];
+    // an instruction can only read the inputs and the results of the instructions before it
+    const int64_t registers = static_cast<int64_t>(input_count + i);
+    ORT_ENFORCE(a >= 0 && a < registers, "FusedElementwise: invalid register ", a, " for operator ", i);
+    if (program_.ops[i] >= FusedElementwiseOpCode::Abs) {
+      ORT_ENFORCE(b == -1, "FusedElementwise: unary operator ", i, " must have -1 as second register.");
+    } else {
+      ORT_ENFORCE(b >= 0 && b < registers, "FusedElementwise: invalid register ", b, " for operator ", i);
+    }
+    program_.a[i] = static_cast<int8_t>(a);
+    program_.b[i] = static_cast<int8_t>(b);
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  // The output has the shape of the largest input, every other input has this shape or a single element.
+  const TensorShape* output_shape = nullptr;
+  for (int i = 0; i < program_.input_count; ++i) {
+    const TensorShape& shape = context->Input<Tensor>(i)->Shape();
+    if (output_shape == nullptr || shape.Size() > output_shape->Size()) {
+      output_shape = &shape;
+    }
+  }
+  ORT_RETURN_IF(output_shape == nullptr, "FusedElementwise requires at least one input.");
+
+  FusedElementwiseInputs<CudaT> inputs{};
+  for (int i = 0; i < program_.input_count; ++i) {
+    const Tensor& input = *context->Input<Tensor>(i);
+    const TensorShape& shape = input.Shape();
+    const bool scalar = shape.Size() == 1 && shape.NumDimensions() <= output_shape->NumDimensions();
+    ORT_RETURN_IF_NOT(scalar || shape == *output_shape, "FusedElementwise: input ", i, " with shape ", shape,
+                      " can not be broadcast to ", *output_shape);
+    inputs.data[i] = reinterpret_cast<const CudaT*>(input.Data<T>());
+    inputs.scalar[i] = scalar;
+  }
+
+  Tensor& output = *context->Output(0, *output_shape);
+  const int64_t size = output_shape->Size();
+  if (size == 0) {
+    return Status::OK();
+  }
+
+  LaunchFusedElementwiseKernel<CudaT>(Stream(context), program_, inputs,
+                                      reinterpret_cast<CudaT*>(output.MutableData<T>()), size);
+  return CUDA_CALL(cudaGetLastError());
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
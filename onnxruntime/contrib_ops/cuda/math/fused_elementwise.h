@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_kernel.h"
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using onnxruntime::cuda::CudaKernel;
+
+// Runs a chain of elementwise operators fused by ElementwiseFusion with a single kernel launch. The program is
+// decoded once when the kernel is created and interpreted by every thread, so the intermediate results stay in
+// registers instead of making a round trip through global memory per operator.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  FusedElementwiseProgram program_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
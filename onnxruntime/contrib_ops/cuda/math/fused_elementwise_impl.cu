@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+namespace {
+
+constexpr int kThreadsPerBlock = GridDim::maxThreadsPerBlock;
+// Blocks of a launch, larger outputs are covered by a grid stride loop.
+constexpr int64_t kMaxBlocks = 65535;
+
+__device__ __forceinline__ float ComputeInstruction(FusedElementwiseOpCode op, float u, float v) {
+  switch (op) {
+    case FusedElementwiseOpCode::Add:
+      return u + v;
+    case FusedElementwiseOpCode::Sub:
+      return u - v;
+    case FusedElementwiseOpCode::Mul:
+      return u * v;
+    case FusedElementwiseOpCode::Div:
+      return u / v;
+    case FusedElementwiseOpCode::Abs:
+      return fabsf(u);
+    case FusedElementwiseOpCode::Erf:
+      return erff(u);
+    case FusedElementwiseOpCode::Exp:
+      return expf(u);
+    case FusedElementwiseOpCode::Neg:
+      return -u;
+    case FusedElementwiseOpCode::Relu:
+      return fmaxf(u, 0.0f);
+    case FusedElementwiseOpCode::Sigmoid:
+      return 1.0f / (1.0f + expf(-u));
+    case FusedElementwiseOpCode::Sqrt:
+      return sqrtf(u);
+    case FusedElementwiseOpCode::Tanh:
+      return tanhf(u);
+  }
+  return 0.0f;
+}
+
+// Every thread evaluates the whole program for its elements, the intermediate results never leave the thread and
+// only the inputs and the output go through global memory. The program is the same for all the threads of a warp
+// so the dispatch on the operator does not diverge.
+template <typename T>
+__global__ void FusedElementwiseKernel(const FusedElementwiseProgram program, const FusedElementwiseInputs<T> inputs,
+                                       T* output, int64_t count) {
+  float results[kMaxFusedElementwiseOps];
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; idx < count;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    auto load = [&](int r) -> float {
+      if (r < program.input_count) {
+        return static_cast<float>(inputs.data[r][inputs.scalar[r] ? 0 : idx]);
+      }
+      return results[r - program.input_count];
+    };
+
+    for (int i = 0; i < program.op_count; ++i) {
+      const int8_t b = program.b[i];
+      results[i] = ComputeInstruction(program.ops[i], load(program.a[i]), b < 0 ? 0.0f : load(b));
+    }
+    output[idx] = static_cast<T>(results[program.op_count - 1]);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs, T* output, int64_t count) {
+  const int blocks = static_cast<int>(std::min<int64_t>(CeilDiv(count, kThreadsPerBlock), kMaxBlocks));
+  FusedElementwiseKernel<T><<<blocks, kThreadsPerBlock, 0, stream>>>(program, inputs, output, count);
+}
+
+#define SPECIALIZED_FUSED_ELEMENTWISE_IMPL(T)                                                              \
+  template void LaunchFusedElementwiseKernel<T>(cudaStream_t stream, const FusedElementwiseProgram& program, \
+                                                const FusedElementwiseInputs<T>& inputs, T* output, int64_t count)
+
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(float);
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(half);
+
+#undef SPECIALIZED_FUSED_ELEMENTWISE_IMPL
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cuda_runtime.h>
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// ElementwiseFusion::kMaxFusedNodes, a chain of binary operators reads at most one more input than its length.
+constexpr int kMaxFusedElementwiseOps = 32;
+constexpr int kMaxFusedElementwiseInputs = kMaxFusedElementwiseOps + 1;
+
+enum class FusedElementwiseOpCode : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Abs,
+  Erf,
+  Exp,
+  Neg,
+  Relu,
+  Sigmoid,
+  Sqrt,
+  Tanh,
+};
+
+// The program is passed by value as a kernel parameter so that it is read from the constant bank by all the threads.
+// Registers 0 to input_count - 1 are the inputs, register input_count + i is the result of instruction i.
+struct FusedElementwiseProgram {
+  int input_count;
+  int op_count;
+  FusedElementwiseOpCode ops[kMaxFusedElementwiseOps];
+  int8_t a[kMaxFusedElementwiseOps];
+  int8_t b[kMaxFusedElementwiseOps];  // -1 for the unary operators
+};
+
+template <typename T>
+struct FusedElementwiseInputs {
+  const T* data[kMaxFusedElementwiseInputs];
+  bool scalar[kMaxFusedElementwiseInputs];
+};
+
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs, T* output, int64_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
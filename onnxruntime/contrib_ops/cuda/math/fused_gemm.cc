@@ -0,0 +1,281 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_gemm.h"
+
+#include "core/providers/cpu/math/gemm_helper.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+#include "core/providers/cuda/tunable/cuda_tunable.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      (*KernelDefBuilder::Create())                               \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// The workspace that the heuristic may assume and that every run allocates from the scratch allocator.
+constexpr size_t kWorkspaceSize = 4 * 1024 * 1024;
+
+// How C is combined with the product of A and B.
+enum class BiasMode {
+  None,       // no C or beta == 0
+  Epilogue,   // C is (N) or (1, N) and beta == 1, added by the BIAS epilogue
+  Matrix,     // C is (M, N), read through the C descriptor
+  Broadcast,  // any other C, broadcast into Y which is then read through the C descriptor
+};
+
+BiasMode GetBiasMode(const Tensor* B, float beta, int M, int N) {
+  if (B == nullptr || beta == 0.0f) {
+    return BiasMode::None;
+  }
+
+  const auto& b_shape = B->Shape();
+  const bool is_row = (b_shape.NumDimensions() == 1 && b_shape[0] == N) ||
+                      (b_shape.NumDimensions() == 2 && b_shape[0] == 1 && b_shape[1] == N);
+  if (is_row && beta == 1.0f) {
+    return BiasMode::Epilogue;
+  }
+
+  if (b_shape.NumDimensions() == 2 && b_shape[0] == M && b_shape[1] == N) {
+    return BiasMode::Matrix;
+  }
+
+  return BiasMode::Broadcast;
+}
+
+cublasLtEpilogue_t WithBias(cublasLtEpilogue_t epilogue) {
+  switch (epilogue) {
+    case CUBLASLT_EPILOGUE_RELU:
+      return CUBLASLT_EPILOGUE_RELU_BIAS;
+    case CUBLASLT_EPILOGUE_GELU:
+      return CUBLASLT_EPILOGUE_GELU_BIAS;
+    default:
+      return CUBLASLT_EPILOGUE_BIAS;
+  }
+}
+
+template <typename T>
+struct FusedGemmParams : OpParams {
+  FusedGemmParams(int m, int n, int k, BiasMode bias_mode, const FusedGemm<T>* kernel, OpKernelContext* ctx)
+      : OpParams(kernel->GetTuningContext(), ctx->GetComputeStream()),
+        m_(m), n_(n), k_(k), bias_mode_(bias_mode), kernel_(kernel), ctx_(ctx) {}
+
+  std::string Signature() const override {
+    return MakeString(m_, "_", n_, "_", k_, "_", static_cast<int>(bias_mode_));
+  }
+
+  int m_;
+  int n_;
+  int k_;
+  BiasMode bias_mode_;
+  const FusedGemm<T>* kernel_;
+  OpKernelContext* ctx_;
+};
+
+// One candidate per heuristic algorithm. Candidates beyond the number of algorithms the heuristic returned for the
+// problem report themselves as unsupported.
+template <typename T>
+class FusedGemmTunableOp : public TunableOp<FusedGemmParams<T>> {
+ public:
+  FusedGemmTunableOp() {
+    for (int i = 0; i < FusedGemm<T>::kMaxHeuristicAlgos; ++i) {
+      this->RegisterOp([i](const FusedGemmParams<T>* params) {
+        return params->kernel_->ComputeWithAlgo(params->ctx_, params->m_, params->n_, params->k_, i);
+      });
+    }
+  }
+};
+
+}  // namespace
+
+template <typename T>
+FusedGemm<T>::FusedGemm(const OpKernelInfo& info) : CudaKernel(info) {
+  int64_t temp;
+  ORT_ENFORCE(info.GetAttr<int64_t>("transA", &temp).IsOK());
+  trans_A_ = (temp != 0);
+
+  ORT_ENFORCE(info.GetAttr<int64_t>("transB", &temp).IsOK());
+  trans_B_ = (temp != 0);
+
+  ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
+  ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+  const std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+  if (activation.empty()) {
+    activation_epilogue_ = CUBLASLT_EPILOGUE_DEFAULT;
+  } else if (activation == "Relu") {
+    activation_epilogue_ = CUBLASLT_EPILOGUE_RELU;
+  } else if (activation == "FastGelu") {
+    activation_epilogue_ = CUBLASLT_EPILOGUE_GELU;
+  } else {
+    ORT_THROW("FusedGemm on CUDA does not support activation ", activation);
+  }
+}
+
+template <typename T>
+Status FusedGemm<T>::ComputeInternal(OpKernelContext* ctx) const {
+  const auto* X = ctx->Input<Tensor>(0);
+  const auto* W = ctx->Input<Tensor>(1);
+  const auto* B = ctx->Input<Tensor>(2);
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(X->Shape(), trans_A_, W->Shape(), trans_B_, B != nullptr ? B->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int M = gsl::narrow_cast<int>(helper.M());
+  int N = gsl::narrow_cast<int>(helper.N());
+  int K = gsl::narrow_cast<int>(helper.K());
+  auto* Y = ctx->Output(0, {M, N});
+
+  // Bail out early if the output is going to be empty
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  FusedGemmParams<T> params(M, N, K, GetBiasMode(B, beta_, M, N), this, ctx);
+  if (params.tuning_ctx->IsTunableOpEnabled()) {
+    static FusedGemmTunableOp<T> fused_gemm{};
+    return fused_gemm(&params);
+  }
+
+  return ComputeWithAlgo(ctx, M, N, K, 0);
+}
+
+template <typename T>
+Status FusedGemm<T>::ComputeWithAlgo(OpKernelContext* ctx, int M, int N, int K, int algo_index) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const auto* X = ctx->Input<Tensor>(0);
+  const auto* W = ctx->Input<Tensor>(1);
+  const auto* B = ctx->Input<Tensor>(2);
+  auto* Y = ctx->Output(0, {M, N});
+  CudaT* out_data = reinterpret_cast<CudaT*>(Y->MutableData<T>());
+  cudaStream_t stream = Stream(ctx);
+
+  const BiasMode bias_mode = GetBiasMode(B, beta_, M, N);
+  const CudaT* b_data = B != nullptr ? reinterpret_cast<const CudaT*>(B->Data<T>()) : nullptr;
+
+  // The broadcast is redone on every call as tuning runs the candidates repeatedly on the same output.
+  if (bias_mode == BiasMode::Broadcast) {
+    CudaT one = ToCudaType<T>::FromFloat(1.0f);
+    CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+    auto& b_shape = B->Shape();
+    if (b_shape.Size() == 1) {
+      CUBLAS_RETURN_IF_ERROR(cublasCopyHelper(stream, GetCublasHandle(ctx), M * N, b_data, 0, out_data, 1));
+    } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+      // B is (N,) or (1, N) with beta != 1, broadcast using Y(N,M) = 1 * B(N,1) x ones(1,M) + 0 * Y
+      CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(GetCublasHandle(ctx), CUBLAS_OP_N, CUBLAS_OP_N, N, M, 1, &one,
+                                              b_data, N, GetConstOnes<CudaT>(M, stream), 1, &zero,
+                                              out_data, N, GetDeviceProp(), UseTF32()));
+    } else {
+      // B is (M, 1), broadcast using Y(N,M) = 1 * ones(N,1) x B(1,M) + 0 * Y
+      CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(GetCublasHandle(ctx), CUBLAS_OP_N, CUBLAS_OP_N, N, M, 1, &one,
+                                              GetConstOnes<CudaT>(N, stream), N, b_data, 1, &zero,
+                                              out_data, N, GetDeviceProp(), UseTF32()));
+    }
+  }
+
+  const cublasLtEpilogue_t epilogue =
+      bias_mode == BiasMode::Epilogue ? WithBias(activation_epilogue_) : activation_epilogue_;
+  const float beta = (bias_mode == BiasMode::Matrix || bias_mode == BiasMode::Broadcast) ? beta_ : 0.0f;
+  const void* c_data = bias_mode == BiasMode::Matrix ? static_cast<const void*>(b_data)
+                                                     : static_cast<const void*>(out_data);
+
+  const cudaDataType_t data_type = std::is_same<T, MLFloat16>::value ? CUDA_R_16F : CUDA_R_32F;
+  const cublasComputeType_t compute_type =
+      std::is_same<T, float>::value && UseTF32() ? CUBLAS_COMPUTE_32F_FAST_TF32 : CUBLAS_COMPUTE_32F;
+
+  cublasLtMatmulDesc_t operation_desc = nullptr;
+  cublasLtMatrixLayout_t a_desc = nullptr, b_desc = nullptr, c_desc = nullptr;
+  cublasLtMatmulPreference_t preference = nullptr;
+  auto clean_descs = gsl::finally([&]() {
+    if (preference) cublasLtMatmulPreferenceDestroy(preference);
+    if (c_desc) cublasLtMatrixLayoutDestroy(c_desc);
+    if (b_desc) cublasLtMatrixLayoutDestroy(b_desc);
+    if (a_desc) cublasLtMatrixLayoutDestroy(a_desc);
+    if (operation_desc) cublasLtMatmulDescDestroy(operation_desc);
+  });
+
+  // cuBLASLt is column major, so Y(N,M) = alpha * op(W) x op(X) + beta * C with W as the A operand.
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&a_desc, data_type, trans_B_ ? K : N, trans_B_ ? N : K,
+                                                    trans_B_ ? K : N));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&b_desc, data_type, trans_A_ ? M : K, trans_A_ ? K : M,
+                                                    trans_A_ ? M : K));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&c_desc, data_type, N, M, N));
+
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&operation_desc, compute_type, CUDA_R_32F));
+  cublasOperation_t trans_a = trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  cublasOperation_t trans_b = trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(operation_desc, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                        &trans_a, sizeof(trans_a)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(operation_desc, CUBLASLT_MATMUL_DESC_TRANSB,
+                                                        &trans_b, sizeof(trans_b)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(operation_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                        &epilogue, sizeof(epilogue)));
+  if (bias_mode == BiasMode::Epilogue) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(operation_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                          &b_data, sizeof(b_data)));
+  }
+
+  const std::vector<cublasLtMatmulHeuristicResult_t>* algos = nullptr;
+  {
+    const std::string key = MakeString(trans_A_, trans_B_, "_", M, "_", N, "_", K, "_", static_cast<int>(epilogue),
+                                       "_", static_cast<int>(bias_mode));
+    std::lock_guard<std::mutex> lock(heuristics_mutex_);
+    auto it = heuristics_.find(key);
+    if (it == heuristics_.end()) {
+      size_t workspace_size = kWorkspaceSize;
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&preference));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+                                                                  &workspace_size, sizeof(workspace_size)));
+      std::vector<cublasLtMatmulHeuristicResult_t> results(kMaxHeuristicAlgos);
+      int returned_results = 0;
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulAlgoGetHeuristic(CublasLtHandle(), operation_desc, a_desc, b_desc,
+                                                            c_desc, c_desc, preference, kMaxHeuristicAlgos,
+                                                            results.data(), &returned_results));
+      ORT_RETURN_IF_NOT(returned_results > 0, "No cuBLASLt algorithm supports FusedGemm with M=", M, ", N=", N,
+                        ", K=", K, ", epilogue=", static_cast<int>(epilogue));
+      results.resize(returned_results);
+      it = heuristics_.emplace(key, std::move(results)).first;
+    }
+    // Entries are never erased, so the vector stays valid once the lock is released.
+    algos = &it->second;
+  }
+
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(algo_index >= static_cast<int>(algos->size()),
+                                            "only ", algos->size(), " cuBLASLt algorithms for this problem");
+
+  auto workspace = GetScratchBuffer<void>(kWorkspaceSize, ctx->GetComputeStream());
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(CublasLtHandle(), operation_desc,
+                                        &alpha_,
+                                        W->DataRaw(), a_desc,
+                                        X->DataRaw(), b_desc,
+                                        &beta,
+                                        c_data, c_desc,
+                                        out_data, c_desc,
+                                        &(*algos)[algo_index].algo,
+                                        workspace.get(), kWorkspaceSize, stream));
+
+  return Status::OK();
+}
+
+template class FusedGemm<float>;
+template class FusedGemm<MLFloat16>;
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/providers/cuda/cuda_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using onnxruntime::cuda::CudaKernel;
+
+// Gemm followed by an activation, computed by a single cublasLtMatmul. A bias of shape (N) or (1, N) with beta == 1
+// is added by the BIAS epilogue and the activation (Relu or the tanh approximation of Gelu used by FastGelu) is
+// applied by the matching activation epilogue, so neither needs a pass of its own over the output.
+template <typename T>
+class FusedGemm final : public CudaKernel {
+ public:
+  FusedGemm(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+  // Runs the GEMM with the algo_index-th algorithm returned by the cuBLASLt heuristic for the problem. The heuristic
+  // results are cached per problem so that they are only queried once per shape.
+  Status ComputeWithAlgo(OpKernelContext* context, int M, int N, int K, int algo_index) const;
+
+  // Number of heuristic algorithms that are requested per problem and that tuning chooses from.
+  static constexpr int kMaxHeuristicAlgos = 4;
+
+ private:
+  bool trans_A_;
+  bool trans_B_;
+  float alpha_;
+  float beta_;
+  cublasLtEpilogue_t activation_epilogue_;
+
+  mutable std::mutex heuristics_mutex_;
+  mutable InlinedHashMap<std::string, std::vector<cublasLtMatmulHeuristicResult_t>> heuristics_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -43,8 +43,9 @@ Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
   // Bail out early if the output is going to be empty
   if (Y->Shape().Size() == 0) return Status::OK();
 
-  bool is_4bit_done = (reorder_idx_data == nullptr) &&
-                      (!zero_points || !zero_points->IsDataType<T>()) &&
+  const bool is_4bit_supported = (reorder_idx_data == nullptr) &&
+                                 (!zero_points || !zero_points->IsDataType<T>());
+  bool is_4bit_done = is_4bit_supported &&
                       TryMatMul4Bits(
                           reinterpret_cast<CudaT*>(Y->MutableData<T>()),
                           reinterpret_cast<const CudaT*>(a_data),
@@ -58,6 +59,23 @@ Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
                           SafeInt<int>(GetDeviceProp().sharedMemPerBlock),
                           static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle()));
 
+  // With many rows, e.g. in the prompt phase, the weights are dequantized tile by tile into shared memory by a
+  // tensor core GEMM instead of being dequantized to a scratch buffer for cuBLAS.
+  is_4bit_done = is_4bit_done ||
+                 (is_4bit_supported &&
+                  TryMatMul4BitsGemm(
+                      reinterpret_cast<CudaT*>(Y->MutableData<T>()),
+                      reinterpret_cast<const CudaT*>(a_data),
+                      blob_data,
+                      reinterpret_cast<const CudaT*>(scales_data),
+                      static_cast<const uint8_t*>(zero_points_data),
+                      SafeInt<int>(helper.M()),
+                      SafeInt<int>(helper.N()),
+                      SafeInt<int>(helper.K()),
+                      SafeInt<int>(block_size_),
+                      GetDeviceProp().major * 10 + GetDeviceProp().minor,
+                      static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle())));
+
   if (is_4bit_done) {
     return Status::OK();
   }
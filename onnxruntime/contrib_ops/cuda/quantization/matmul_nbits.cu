@@ -6,6 +6,9 @@
 #include <cublas_v2.h>
 #include <cuda_fp16.h>
 #include <math_constants.h>
+#if !defined(__HIPCC__)
+#include <mma.h>
+#endif
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "core/providers/cuda/cuda_common.h"
 #include "matmul_nbits.cuh"
@@ -349,6 +352,234 @@ template bool TryMatMul4Bits<half>(
     int shared_mem_per_block,
     cudaStream_t stream);
 
+#if !defined(__HIPCC__)
+// Tiles of the tensor core GEMM used when A has many rows, e.g. in the prompt phase. Every thread block computes
+// (kGemmTileM, kGemmTileN) of the output with kGemmWarpsM x kGemmWarpsN warps, the weights of a (kGemmTileN,
+// kGemmTileK) tile of B are dequantized to shared memory so the fp16 weights never go through global memory.
+constexpr int kGemmTileM = 128;
+constexpr int kGemmTileN = 128;
+constexpr int kGemmTileK = 32;
+constexpr int kGemmWarpsM = 2;
+constexpr int kGemmWarpsN = 4;
+constexpr int kGemmThreads = kGemmWarpsM * kGemmWarpsN * kWarpSize;
+constexpr int kWmmaSize = 16;
+constexpr int kGemmWarpTileM = kGemmTileM / kGemmWarpsM;
+constexpr int kGemmWarpTileN = kGemmTileN / kGemmWarpsN;
+constexpr int kGemmFragmentsM = kGemmWarpTileM / kWmmaSize;
+constexpr int kGemmFragmentsN = kGemmWarpTileN / kWmmaSize;
+// Rows of the shared tiles are padded against bank conflicts, wmma needs a multiple of 8 halves.
+constexpr int kGemmSmemStride = kGemmTileK + 8;
+// Below this many rows the cuBLAS GEMM on dequantized weights is used.
+constexpr int kGemmMinRows = 32;
+
+static_assert(kGemmThreads == 2 * kGemmTileN, "every thread dequantizes half a column of the B tile");
+static_assert(kGemmTileK == 32, "a thread dequantizes 16 weights of a column");
+
+// kernel for 4bits quantized gemm, i.e., computing A(M, K) x B(K, N) with tensor cores
+// B(K, N) is quantized blockwise with 4bits and stored as [N, (K + block_size - 1)/block_size, blob] like in
+// MatMulFloatInt4Kernel, block_size must be a multiple of kGemmTileK so that a tile of B has one scale per column.
+// The thread block size is kGemmThreads and grid size is (N/kGemmTileN, (M + kGemmTileM - 1)/kGemmTileM)
+template <bool has_zero_point>
+__global__ void __launch_bounds__(kGemmThreads) MatMulFloatInt4GemmKernel(
+    half* output,
+    const half* a_data,
+    const uint8_t* b_data_quant,
+    const half* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int blocks_per_K) {
+#if !defined(__CUDA_ARCH__) || __CUDA_ARCH__ >= 700
+  using namespace nvcuda;
+
+  __shared__ __align__(32) half a_tile[kGemmTileM * kGemmSmemStride];
+  __shared__ __align__(32) half b_tile[kGemmTileN * kGemmSmemStride];
+  __shared__ __align__(32) float c_stage[kGemmWarpsM * kGemmWarpsN][kWmmaSize * kWmmaSize];
+
+  const int m_start = blockIdx.y * kGemmTileM;
+  const int n_start = blockIdx.x * kGemmTileN;
+  const int warp_id = threadIdx.x / kWarpSize;
+  const int lane_id = threadIdx.x % kWarpSize;
+  const int warp_m = warp_id / kGemmWarpsN;
+  const int warp_n = warp_id % kGemmWarpsN;
+
+  wmma::fragment<wmma::accumulator, kWmmaSize, kWmmaSize, kWmmaSize, float> acc[kGemmFragmentsM][kGemmFragmentsN];
+#pragma unroll
+  for (int i = 0; i < kGemmFragmentsM; ++i) {
+#pragma unroll
+    for (int j = 0; j < kGemmFragmentsN; ++j) {
+      wmma::fill_fragment(acc[i][j], 0.0f);
+    }
+  }
+
+  // the column of B and the 16 weights of it dequantized by this thread
+  const int b_col = threadIdx.x / 2;
+  const int b_k_offset = (threadIdx.x % 2) * 16;
+  const uint8_t* b_col_data = b_data_quant + static_cast<int64_t>(n_start + b_col) * blocks_per_K * (block_size / 2);
+  const half* b_col_scales = scales_data + static_cast<int64_t>(n_start + b_col) * blocks_per_K;
+  const uint8_t* b_col_zero_points = has_zero_point
+                                         ? zero_points + static_cast<int64_t>(n_start + b_col) * ((blocks_per_K + 1) / 2)
+                                         : nullptr;
+
+  for (int k_start = 0; k_start < k; k_start += kGemmTileK) {
+    // A tile, 8 halves per 16 bytes load, the rows past m are zeros
+    constexpr int kVectorsPerRow = kGemmTileK / 8;
+    for (int v = threadIdx.x; v < kGemmTileM * kVectorsPerRow; v += kGemmThreads) {
+      const int row = v / kVectorsPerRow;
+      const int col = (v % kVectorsPerRow) * 8;
+      uint4 value = make_uint4(0, 0, 0, 0);
+      if (m_start + row < m) {
+        value = *reinterpret_cast<const uint4*>(a_data + static_cast<int64_t>(m_start + row) * k + k_start + col);
+      }
+      *reinterpret_cast<uint4*>(a_tile + row * kGemmSmemStride + col) = value;
+    }
+
+    // B tile, stored column major as wmma::matrix_b expects for B(K, N)
+    {
+      const int block_id = k_start / block_size;
+      const uint2 packed = *reinterpret_cast<const uint2*>(b_col_data + (k_start + b_k_offset) / 2);
+      const float scale = __half2float(b_col_scales[block_id]);
+      float zp = 8.0f;
+      if constexpr (has_zero_point) {
+        const uint8_t zp_pair = b_col_zero_points[block_id / 2];
+        zp = static_cast<float>((block_id & 1) ? (zp_pair >> 4) : (zp_pair & 0x0f));
+      }
+      const float zp_adjust = -scale * zp;
+      half* dst = b_tile + b_col * kGemmSmemStride + b_k_offset;
+      const uint32_t words[2] = {packed.x, packed.y};
+#pragma unroll
+      for (int w = 0; w < 2; ++w) {
+#pragma unroll
+        for (int i = 0; i < 8; ++i) {
+          dst[w * 8 + i] = __float2half(static_cast<float>((words[w] >> (4 * i)) & 0xF) * scale + zp_adjust);
+        }
+      }
+    }
+    __syncthreads();
+
+#pragma unroll
+    for (int kk = 0; kk < kGemmTileK; kk += kWmmaSize) {
+      wmma::fragment<wmma::matrix_a, kWmmaSize, kWmmaSize, kWmmaSize, half, wmma::row_major> a_frag[kGemmFragmentsM];
+      wmma::fragment<wmma::matrix_b, kWmmaSize, kWmmaSize, kWmmaSize, half, wmma::col_major> b_frag[kGemmFragmentsN];
+#pragma unroll
+      for (int i = 0; i < kGemmFragmentsM; ++i) {
+        wmma::load_matrix_sync(a_frag[i], a_tile + (warp_m * kGemmWarpTileM + i * kWmmaSize) * kGemmSmemStride + kk,
+                               kGemmSmemStride);
+      }
+#pragma unroll
+      for (int j = 0; j < kGemmFragmentsN; ++j) {
+        wmma::load_matrix_sync(b_frag[j], b_tile + (warp_n * kGemmWarpTileN + j * kWmmaSize) * kGemmSmemStride + kk,
+                               kGemmSmemStride);
+      }
+#pragma unroll
+      for (int i = 0; i < kGemmFragmentsM; ++i) {
+#pragma unroll
+        for (int j = 0; j < kGemmFragmentsN; ++j) {
+          wmma::mma_sync(acc[i][j], a_frag[i], b_frag[j], acc[i][j]);
+        }
+      }
+    }
+    __syncthreads();
+  }
+
+  // the accumulators go through a staging tile of the warp to be converted and to skip the rows past m
+  float* stage = c_stage[warp_id];
+#pragma unroll
+  for (int i = 0; i < kGemmFragmentsM; ++i) {
+#pragma unroll
+    for (int j = 0; j < kGemmFragmentsN; ++j) {
+      wmma::store_matrix_sync(stage, acc[i][j], kWmmaSize, wmma::mem_row_major);
+      __syncwarp();
+      const int row_start = m_start + warp_m * kGemmWarpTileM + i * kWmmaSize;
+      const int col_start = n_start + warp_n * kGemmWarpTileN + j * kWmmaSize;
+      for (int e = lane_id; e < kWmmaSize * kWmmaSize; e += kWarpSize) {
+        const int row = row_start + e / kWmmaSize;
+        if (row < m) {
+          output[static_cast<int64_t>(row) * n + col_start + e % kWmmaSize] = __float2half(stage[e]);
+        }
+      }
+      __syncwarp();
+    }
+  }
+#endif
+}
+#endif  // !defined(__HIPCC__)
+
+template <class T>
+bool TryMatMul4BitsGemm(
+    T* /*output*/,
+    const T* /*a_data*/,
+    const uint8_t* /*b_data_quant*/,
+    const T* /*scales_data*/,
+    const uint8_t* /*zero_points*/,
+    int /*m*/,
+    int /*n*/,
+    int /*k*/,
+    int /*block_size*/,
+    int /*sm*/,
+    cudaStream_t /*stream*/) {
+  return false;
+}
+
+template <>
+bool TryMatMul4BitsGemm<half>(
+    half* output,
+    const half* a_data,
+    const uint8_t* b_data_quant,
+    const half* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int sm,
+    cudaStream_t stream) {
+#if !defined(__HIPCC__)
+  if (sm < 70 || m < kGemmMinRows || n % kGemmTileN != 0 || k % kGemmTileK != 0 || block_size % kGemmTileK != 0) {
+    return false;
+  }
+
+  dim3 blocks(n / kGemmTileN, (m + kGemmTileM - 1) / kGemmTileM);
+  int blocks_per_K = (k + block_size - 1) / block_size;
+  if (nullptr != zero_points) {
+    MatMulFloatInt4GemmKernel<true><<<blocks, kGemmThreads, 0, stream>>>(
+        output, a_data, b_data_quant, scales_data, zero_points, m, n, k, block_size, blocks_per_K);
+  } else {
+    MatMulFloatInt4GemmKernel<false><<<blocks, kGemmThreads, 0, stream>>>(
+        output, a_data, b_data_quant, scales_data, zero_points, m, n, k, block_size, blocks_per_K);
+  }
+  return true;
+#else
+  ORT_UNUSED_PARAMETER(output);
+  ORT_UNUSED_PARAMETER(a_data);
+  ORT_UNUSED_PARAMETER(b_data_quant);
+  ORT_UNUSED_PARAMETER(scales_data);
+  ORT_UNUSED_PARAMETER(zero_points);
+  ORT_UNUSED_PARAMETER(m);
+  ORT_UNUSED_PARAMETER(n);
+  ORT_UNUSED_PARAMETER(k);
+  ORT_UNUSED_PARAMETER(block_size);
+  ORT_UNUSED_PARAMETER(sm);
+  ORT_UNUSED_PARAMETER(stream);
+  return false;
+#endif
+}
+
+template bool TryMatMul4BitsGemm<float>(
+    float* output,
+    const float* a_data,
+    const uint8_t* b_data_quant,
+    const float* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int sm,
+    cudaStream_t stream);
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -22,6 +22,22 @@ bool TryMatMul4Bits(
     int shared_mem_per_block,
     cudaStream_t stream);
 
+// Tensor core GEMM for the A with many rows, only implemented for half on sm70 and newer. Returns false when the
+// shapes or the device are not supported.
+template <class T>
+bool TryMatMul4BitsGemm(
+    T* output,
+    const T* a_data,
+    const uint8_t* b_data_quant,
+    const T* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int sm,
+    cudaStream_t stream);
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #endif
 
 #include <cub/util_type.cuh>
+#include <algorithm>
 
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/cu_inc/common.cuh"
@@ -686,291 +687,205 @@ void LaunchUpdateGptKernel(const int32_t* old_mask_data,
       old_mask_data, mask_data, next_positions, batch_beam_size, current_length);
 }
 
-template <typename T>
-void GetTempStorageSize(const T* d_keys_in,
-                        const int* d_values_in,
-                        int* d_offsets,
-                        int num_items,
-                        int num_segments,
-                        cudaStream_t stream,
-                        bool is_descending,
-                        size_t& temp_storage_bytes) {
-  if (is_descending) {
-    CUDA_CALL_THROW(cub::DeviceSegmentedRadixSort::SortPairsDescending(nullptr,
-                                                                       temp_storage_bytes,
-                                                                       d_keys_in,
-                                                                       (T*)nullptr,
-                                                                       d_values_in,
-                                                                       (int*)nullptr,
-                                                                       num_items,
-                                                                       num_segments,
-                                                                       d_offsets,
-                                                                       d_offsets + 1,
-                                                                       0,
-                                                                       sizeof(T) * 8,
-                                                                       stream));
-  } else {
-    CUDA_CALL_THROW(cub::DeviceSegmentedRadixSort::SortPairs(nullptr,
-                                                             temp_storage_bytes,
-                                                             d_keys_in,
-                                                             (T*)nullptr,
-                                                             d_values_in,
-                                                             (int*)nullptr,
-                                                             num_items,
-                                                             num_segments,
-                                                             d_offsets,
-                                                             d_offsets + 1,
-                                                             0,
-                                                             sizeof(T) * 8,
-                                                             stream));
-  }
-}
-
-template void GetTempStorageSize(
-    const float* d_keys_in,
-    const int* d_values_in,
-    int* d_offsets,
-    int num_items,
-    int num_segments,
-    cudaStream_t stream,
-    bool is_descending,
-    size_t& temp_storage_bytes);
-
-template void GetTempStorageSize(
-    const half* d_keys_in,
-    const int* d_values_in,
-    int* d_offsets,
-    int num_items,
-    int num_segments,
-    cudaStream_t stream,
-    bool is_descending,
-    size_t& temp_storage_bytes);
-
-// TODO: merge to one kernel
-__global__ void SetupParamsKernel(int* d_values_in,
-                                  int* d_offsets,
-                                  int batch_size,
-                                  int vocab_size) {
-  int index = blockIdx.x * blockDim.x + threadIdx.x;
-  int total_elements = batch_size * vocab_size;
-  if (index < total_elements) {
-    d_values_in[index] = index % vocab_size;
-  }
-  if (index < batch_size + 1) {
-    d_offsets[index] = index * vocab_size;
+template <typename TWord>
+__global__ void GatherBeamStateKernel(const TWord* present,
+                                      TWord* past,
+                                      const int32_t* beam_indices,
+                                      int batch_beam_size,
+                                      size_t beam_words) {
+  // one block row per beam of each part, the threads of the row stride over the words of the beam
+  const int part = blockIdx.y / batch_beam_size;
+  const int beam = blockIdx.y % batch_beam_size;
+  const size_t part_words = beam_words * batch_beam_size;
+  const TWord* source = present + part * part_words + beam_indices[beam] * beam_words;
+  TWord* target = past + part * part_words + beam * beam_words;
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < beam_words; i += gridDim.x * blockDim.x) {
+    target[i] = source[i];
   }
 }
 
-void LaunchSetupParamsKernel(int* d_values_in,
-                             int* d_offsets,
-                             int batch_size,
-                             int vocab_size,
-                             cudaStream_t stream) {
-  int total_elements = batch_size * vocab_size;
+void LaunchGatherBeamState(const void* present,
+                           void* past,
+                           const int32_t* beam_indices,
+                           int num_parts,
+                           int batch_beam_size,
+                           size_t beam_bytes,
+                           cudaStream_t stream) {
   constexpr int blockSize = 256;
-  const int gridSize = (total_elements + blockSize - 1) / blockSize;
-  SetupParamsKernel<<<gridSize, blockSize, 0, stream>>>(d_values_in,
-                                                        d_offsets,
-                                                        batch_size,
-                                                        vocab_size);
-}
-
-template <typename T>
-void LaunchSortPairs(void* d_temp_storage,
-                     size_t temp_storage_bytes,
-                     const T* d_keys_in,
-                     T* d_keys_out,
-                     const int* d_values_in,
-                     int* d_values_out,
-                     int num_items,
-                     int num_segments,
-                     int* d_offsets,
-                     cudaStream_t stream,
-                     bool is_descending) {
-  if (is_descending) {
-    CUDA_CALL_THROW(cub::DeviceSegmentedRadixSort::SortPairsDescending(d_temp_storage,
-                                                                       temp_storage_bytes,
-                                                                       d_keys_in,
-                                                                       d_keys_out,
-                                                                       d_values_in,
-                                                                       d_values_out,
-                                                                       num_items,
-                                                                       num_segments,
-                                                                       d_offsets,
-                                                                       d_offsets + 1,
-                                                                       0,
-                                                                       sizeof(T) * 8,
-                                                                       stream));
+  constexpr size_t kMaxBlocksPerBeam = 64;
+  auto launch = [&](auto word) {
+    using TWord = decltype(word);
+    const size_t beam_words = beam_bytes / sizeof(TWord);
+    const size_t blocks_per_beam = std::min((beam_words + blockSize - 1) / blockSize, kMaxBlocksPerBeam);
+    const dim3 grid(static_cast<unsigned int>(std::max<size_t>(blocks_per_beam, 1)), num_parts * batch_beam_size);
+    GatherBeamStateKernel<TWord><<<grid, blockSize, 0, stream>>>(reinterpret_cast<const TWord*>(present),
+                                                                 reinterpret_cast<TWord*>(past), beam_indices,
+                                                                 batch_beam_size, beam_words);
+  };
+
+  // the state of a beam is copied in 16 bytes words when its size allows
+  if (beam_bytes % sizeof(int4) == 0) {
+    launch(int4{});
+  } else if (beam_bytes % sizeof(int32_t) == 0) {
+    launch(int32_t{});
   } else {
-    CUDA_CALL_THROW(cub::DeviceSegmentedRadixSort::SortPairs(d_temp_storage,
-                                                             temp_storage_bytes,
-                                                             d_keys_in,
-                                                             d_keys_out,
-                                                             d_values_in,
-                                                             d_values_out,
-                                                             num_items,
-                                                             num_segments,
-                                                             d_offsets,
-                                                             d_offsets + 1,
-                                                             0,
-                                                             sizeof(T) * 8,
-                                                             stream));
+    launch(int8_t{});
   }
 }
 
-template void LaunchSortPairs(void* d_temp_storage,
-                              size_t temp_storage_bytes,
-                              const float* d_keys_in,
-                              float* d_keys_out,
-                              const int* d_values_in,
-                              int* d_values_out,
-                              int num_items,
-                              int num_segments,
-                              int* d_offsets,
-                              cudaStream_t stream,
-                              bool is_descending);
-
-template void LaunchSortPairs(void* d_temp_storage,
-                              size_t temp_storage_bytes,
-                              const half* d_keys_in,
-                              half* d_keys_out,
-                              const int* d_values_in,
-                              int* d_values_out,
-                              int num_items,
-                              int num_segments,
-                              int* d_offsets,
-                              cudaStream_t stream,
-                              bool is_descending);
-
-// A stateful callback functor that maintains a running prefix to be applied
-// during consecutive scan operations.
-struct BlockPrefixCallbackOp {
-  float running_total;  // running prefix
-
-  __device__ BlockPrefixCallbackOp(float running_total) : running_total(running_total) {}
-  // Callback operator to be entered by the first warp of threads in the block.
-  // Thread-0 is responsible for returning a value for seeding the block-wide scan.
-  __device__ float operator()(float block_aggregate) {
-    float old_prefix = running_total;
-    running_total += block_aggregate;
-    return old_prefix;
+// Non-negative floats are ordered like the unsigned integers of their bits, so the top-p threshold is found with a
+// bisection on the bits of the probabilities, every step being a block reduction over the vocabulary. This costs
+// about 31 reads of the probabilities, which stay in L2, where a segmented sort of the scores with their indices
+// writes and reads the whole batch several times.
+constexpr uint32_t kProbabilityOneBits = 0x3F800000;
+
+template <int kBlockSize>
+__device__ void ReduceProbabilities(const float* probs, int vocab_size, uint32_t threshold_bits, bool above,
+                                    float& mass, int& count) {
+  typedef cub::BlockReduce<float, kBlockSize> BlockReduceFloat;
+  typedef cub::BlockReduce<int, kBlockSize> BlockReduceInt;
+  __shared__ typename BlockReduceFloat::TempStorage float_storage;
+  __shared__ typename BlockReduceInt::TempStorage int_storage;
+  __shared__ float block_mass;
+  __shared__ int block_count;
+
+  float thread_mass = 0.0f;
+  int thread_count = 0;
+  for (int idx = threadIdx.x; idx < vocab_size; idx += kBlockSize) {
+    const float p = probs[idx];
+    if ((__float_as_uint(p) > threshold_bits) == above) {
+      thread_mass += p;
+      ++thread_count;
+    }
   }
-};
+
+  const float total_mass = BlockReduceFloat(float_storage).Sum(thread_mass);
+  const int total_count = BlockReduceInt(int_storage).Sum(thread_count);
+  if (threadIdx.x == 0) {
+    block_mass = total_mass;
+    block_count = total_count;
+  }
+  __syncthreads();
+  mass = block_mass;
+  count = block_count;
+  __syncthreads();
+}
 
 template <typename T, int kBlockSize>
-__global__ void FilterLogitsKernelCustom(float* d_sorted_logits_in,
-                                         const int* d_sorted_indices,
-                                         T* d_logits_in_out,
-                                         float top_p_threshold,
-                                         float filter_value,
-                                         int batch_size,
-                                         int vocab_size) {
-  int vocab_idx = threadIdx.x;
-  int batch_id = blockIdx.x;
-  int offset = batch_id * vocab_size;
-
-  typedef cub::BlockScan<float, kBlockSize> BlockScan;
-  __shared__ typename BlockScan::TempStorage temp_storage;
-  BlockPrefixCallbackOp prefix_op(0);
-
-  for (int idx = vocab_idx; idx < vocab_size; idx += kBlockSize) {
-    float sum = d_sorted_logits_in[offset + idx];
-    BlockScan(temp_storage).ExclusiveSum(sum, sum, prefix_op);
+__global__ void TopPFilterKernelCustom(const float* d_softmaxed_logits_in,
+                                       T* d_logits_in_out,
+                                       float top_p,
+                                       float filter_value,
+                                       int vocab_size) {
+  const float* probs = d_softmaxed_logits_in + static_cast<int64_t>(blockIdx.x) * vocab_size;
+  T* logits = d_logits_in_out + static_cast<int64_t>(blockIdx.x) * vocab_size;
+
+  // A token is kept if the tokens more likely than it weigh less than top_p, which holds for the probabilities
+  // from the smallest threshold t with mass(p > t) < top_p.
+  uint32_t lo = 0;
+  uint32_t hi = kProbabilityOneBits + 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    float mass;
+    int count;
+    ReduceProbabilities<kBlockSize>(probs, vocab_size, mid, true, mass, count);
+    if (mass < top_p) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
 
-    __syncthreads();
-    if (sum >= top_p_threshold) {
-      int original_index = offset + d_sorted_indices[offset + idx];
-      d_logits_in_out[original_index] = (T)filter_value;
+  for (int idx = threadIdx.x; idx < vocab_size; idx += kBlockSize) {
+    if (__float_as_uint(probs[idx]) < lo) {
+      logits[idx] = (T)filter_value;
     }
   }
 }
 
 template <typename T, int kBlockSize>
-__global__ void FilterLogitsKernel(float* d_sorted_logits_in,
-                                   const int* d_sorted_indices,
-                                   T* d_logits_in_out,
-                                   float top_p_threshold,
-                                   float filter_value,
-                                   int min_tokens_to_keep,
-                                   int batch_size,
-                                   int vocab_size) {
-  int vocab_idx = threadIdx.x;
-  int batch_id = blockIdx.x;
-  int offset = batch_id * vocab_size;
-
-  typedef cub::BlockScan<float, kBlockSize> BlockScan;
-  __shared__ typename BlockScan::TempStorage temp_storage;
-  BlockPrefixCallbackOp prefix_op(0);
-
-  for (int idx = vocab_idx; idx < vocab_size; idx += kBlockSize) {
-    float sum = d_sorted_logits_in[offset + idx];
-    BlockScan(temp_storage).InclusiveSum(sum, sum, prefix_op);
-
-    __syncthreads();
+__global__ void TopPFilterKernel(const float* d_softmaxed_logits_in,
+                                 T* d_logits_in_out,
+                                 float top_p_threshold,
+                                 float filter_value,
+                                 int min_tokens_to_keep,
+                                 int vocab_size) {
+  const float* probs = d_softmaxed_logits_in + static_cast<int64_t>(blockIdx.x) * vocab_size;
+  T* logits = d_logits_in_out + static_cast<int64_t>(blockIdx.x) * vocab_size;
+
+  // A token is removed if it and the less likely tokens weigh at most 1 - top_p, keeping the min_tokens_to_keep
+  // most likely ones, which holds for the probabilities up to the largest threshold t that satisfies both.
+  int64_t lo = -1;
+  int64_t hi = kProbabilityOneBits;
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo + 1) / 2;
+    float mass;
+    int count;
+    ReduceProbabilities<kBlockSize>(probs, vocab_size, static_cast<uint32_t>(mid), false, mass, count);
+    if (mass <= top_p_threshold && count + min_tokens_to_keep <= vocab_size) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
 
-    if (sum <= top_p_threshold) {
-      if (idx + min_tokens_to_keep < vocab_size) {
-        int original_index = offset + d_sorted_indices[offset + idx];
-        d_logits_in_out[original_index] = (T)filter_value;
-      }
+  if (lo < 0) {
+    return;
+  }
+  for (int idx = threadIdx.x; idx < vocab_size; idx += kBlockSize) {
+    if (__float_as_uint(probs[idx]) <= static_cast<uint32_t>(lo)) {
+      logits[idx] = (T)filter_value;
     }
   }
 }
 
 template <typename T>
-void LaunchFilterLogitsKernel(float* d_sorted_logits_in,
-                              const int* d_sorted_indices,
-                              T* d_logits_in_out,
-                              float top_p,
-                              float filter_value,
-                              int min_tokens_to_keep,
-                              int batch_size,
-                              int vocab_size,
-                              cudaStream_t stream,
-                              bool is_descending) {
-  constexpr int kBlockSize = 256;
+void LaunchTopPFilterKernel(const float* d_softmaxed_logits_in,
+                            T* d_logits_in_out,
+                            float top_p,
+                            float filter_value,
+                            int min_tokens_to_keep,
+                            int batch_size,
+                            int vocab_size,
+                            cudaStream_t stream,
+                            bool is_descending) {
+  constexpr int kBlockSize = 1024;
 
   if (is_descending) {
-    FilterLogitsKernelCustom<T, kBlockSize><<<batch_size, kBlockSize, 0, stream>>>(d_sorted_logits_in,
-                                                                                   d_sorted_indices,
-                                                                                   d_logits_in_out,
-                                                                                   top_p,
-                                                                                   filter_value,
-                                                                                   batch_size,
-                                                                                   vocab_size);
+    TopPFilterKernelCustom<T, kBlockSize><<<batch_size, kBlockSize, 0, stream>>>(d_softmaxed_logits_in,
+                                                                                 d_logits_in_out,
+                                                                                 top_p,
+                                                                                 filter_value,
+                                                                                 vocab_size);
   } else {
-    FilterLogitsKernel<T, kBlockSize><<<batch_size, kBlockSize, 0, stream>>>(d_sorted_logits_in,
-                                                                             d_sorted_indices,
-                                                                             d_logits_in_out,
-                                                                             1 - top_p,
-                                                                             filter_value,
-                                                                             min_tokens_to_keep,
-                                                                             batch_size,
-                                                                             vocab_size);
+    TopPFilterKernel<T, kBlockSize><<<batch_size, kBlockSize, 0, stream>>>(d_softmaxed_logits_in,
+                                                                           d_logits_in_out,
+                                                                           1 - top_p,
+                                                                           filter_value,
+                                                                           min_tokens_to_keep,
+                                                                           vocab_size);
   }
 }
 
-template void LaunchFilterLogitsKernel(float* d_sorted_logits_in,
-                                       const int* d_sorted_indices,
-                                       float* d_logits_in_out,
-                                       float top_p,
-                                       float filter_value,
-                                       int min_tokens_to_keep,
-                                       int batch_size,
-                                       int vocab_size,
-                                       cudaStream_t stream,
-                                       bool is_descending);
-
-template void LaunchFilterLogitsKernel(float* d_sorted_logits_in,
-                                       const int* d_sorted_indices,
-                                       half* d_logits_in_out,
-                                       float top_p,
-                                       float filter_value,
-                                       int min_tokens_to_keep,
-                                       int batch_size,
-                                       int vocab_size,
-                                       cudaStream_t stream,
-                                       bool is_descending);
+template void LaunchTopPFilterKernel(const float* d_softmaxed_logits_in,
+                                     float* d_logits_in_out,
+                                     float top_p,
+                                     float filter_value,
+                                     int min_tokens_to_keep,
+                                     int batch_size,
+                                     int vocab_size,
+                                     cudaStream_t stream,
+                                     bool is_descending);
+
+template void LaunchTopPFilterKernel(const float* d_softmaxed_logits_in,
+                                     half* d_logits_in_out,
+                                     float top_p,
+                                     float filter_value,
+                                     int min_tokens_to_keep,
+                                     int batch_size,
+                                     int vocab_size,
+                                     cudaStream_t stream,
+                                     bool is_descending);
 
 // Ref: https://github.com/pytorch/pytorch/blob/release/1.13/aten/src/ATen/native/cuda/MultinomialKernel.cu
 template <typename scalar_t, typename accscalar_t>
@@ -142,46 +142,28 @@ void LaunchUpdateGptKernel(const int32_t* old_mask_data,
                            int current_length,
                            cudaStream_t stream);
 
-template <typename T>
-void GetTempStorageSize(const T* d_keys_in,
-                        const int* d_values_in,
-                        int* d_offsets,
-                        int num_items,
-                        int num_segments,
-                        cudaStream_t stream,
-                        bool is_descending,
-                        size_t& temp_storage_bytes);
-
-void LaunchSetupParamsKernel(int* d_values_in,
-                             int* d_offsets,
-                             int batch_size,
-                             int vocab_size,
-                             cudaStream_t stream);
-
-template <typename T>
-void LaunchSortPairs(void* d_temp_storage,
-                     size_t temp_storage_bytes,
-                     const T* d_keys_in,
-                     T* d_keys_out,
-                     const int* d_values_in,
-                     int* d_values_out,
-                     int num_items,
-                     int num_segments,
-                     int* d_offsets,
-                     cudaStream_t stream,
-                     bool is_descending);
+// Copies the state of the beams selected by beam_indices (on device) to the past state. The state has num_parts
+// consecutive parts (like key and value) of batch_beam_size beams of beam_bytes each.
+void LaunchGatherBeamState(const void* present,
+                           void* past,
+                           const int32_t* beam_indices,
+                           int num_parts,
+                           int batch_beam_size,
+                           size_t beam_bytes,
+                           cudaStream_t stream);
 
+// Replaces the scores of the tokens outside of the top-p nucleus by filter_value, given the softmax of the scores.
+// The nucleus is found with a threshold search on the probabilities, without sorting the vocabulary.
 template <typename T>
-void LaunchFilterLogitsKernel(float* d_sorted_logits_in,
-                              const int* d_sorted_indices,
-                              T* d_logits_in_out,
-                              float top_p,
-                              float filter_value,
-                              int min_tokens_to_keep,
-                              int batch_size,
-                              int vocab_size,
-                              cudaStream_t stream,
-                              bool is_descending);
+void LaunchTopPFilterKernel(const float* d_softmaxed_logits_in,
+                            T* d_logits_in_out,
+                            float top_p,
+                            float filter_value,
+                            int min_tokens_to_keep,
+                            int batch_size,
+                            int vocab_size,
+                            cudaStream_t stream,
+                            bool is_descending);
 
 void TorchMultinomialKernelLauncher(float* d_input,
                                     float* d_sampled,
@@ -1019,14 +1019,17 @@ Status DeviceCopy(gsl::span<T> target, gsl::span<const T> source, Stream* ort_st
   return Status::OK();
 }
 
+// Copy present state to past state for GPT model. The beam indices are on device, so the per step past state update
+// is a kernel per layer without a copy of the indices to host.
 template <typename T>
 Status PickGptPastState(const std::vector<OrtValue>& last_outputs,
                         std::vector<OrtValue>& next_inputs,
-                        gsl::span<const int32_t>& beam_indices,
+                        gsl::span<const int32_t>& beam_indices_gpu,
                         AllocatorPtr allocator,
                         ptrdiff_t gpt_subgraph_first_past_input_idx,
                         ptrdiff_t gpt_subgraph_first_present_output_idx,
                         Stream* ort_stream) {
+  cudaStream_t cuda_stream = ort_stream ? static_cast<cudaStream_t>(ort_stream->GetHandle()) : nullptr;
   ptrdiff_t num_present_tensors = static_cast<ptrdiff_t>(last_outputs.size()) - gpt_subgraph_first_present_output_idx;
   for (int i = 0; i < num_present_tensors; ++i) {
     const OrtValue& present = last_outputs[gpt_subgraph_first_present_output_idx + i];
@@ -1034,31 +1037,16 @@ Status PickGptPastState(const std::vector<OrtValue>& last_outputs,
     // shape is like (2, batch_beam_size, 12, past_seq_len, 64)
     const TensorShape& past_shape = present.Get<Tensor>().Shape();
     auto block_size_per_beam = past_shape[2] * past_shape[3] * past_shape[4];
-    auto past_key_size = past_shape[1] * past_shape[2] * past_shape[3] * past_shape[4];
 
     // Create a tensor with same shape.
-    // TODO(tianleiwu): allocate one buffer for all layers, and use a CUDA kernel to copy key/value cache data.
     OrtValue past;
     auto past_type = DataTypeImpl::GetType<T>();
     Tensor::InitOrtValue(past_type, past_shape, allocator, past);
-    cudaStream_t cuda_stream = ort_stream ? static_cast<cudaStream_t>(ort_stream->GetHandle()) : nullptr;
-
-    gsl::span<T> past_span = gsl::make_span<T>(past.GetMutable<Tensor>()->MutableData<T>(), past_shape.Size());
-    gsl::span<const T> present_span = gsl::make_span<const T>(present.Get<Tensor>().Data<T>(), past_shape.Size());
 
-    for (size_t j = 0; j < beam_indices.size(); j++) {
-      int32_t beam_index = beam_indices[j];
-      gsl::span<const T> present_key = present_span.subspan(beam_index * block_size_per_beam, block_size_per_beam);
-      gsl::span<const T> present_value = present_span.subspan(past_key_size + beam_index * block_size_per_beam,
-                                                              block_size_per_beam);
-
-      gsl::span<T> past_key = past_span.subspan(j * block_size_per_beam, block_size_per_beam);
-      gsl::span<T> past_value = past_span.subspan(past_key_size + j * block_size_per_beam, block_size_per_beam);
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(past_key.data(), present_key.data(), present_key.size_bytes(),
-                                           cudaMemcpyDeviceToDevice, cuda_stream));
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(past_value.data(), present_value.data(), present_value.size_bytes(),
-                                           cudaMemcpyDeviceToDevice, cuda_stream));
-    }
+    cuda::LaunchGatherBeamState(present.Get<Tensor>().DataRaw(), past.GetMutable<Tensor>()->MutableDataRaw(),
+                                beam_indices_gpu.data(), 2, static_cast<int>(beam_indices_gpu.size()),
+                                SafeInt<size_t>(block_size_per_beam) * sizeof(T), cuda_stream);
+    CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
     next_inputs[gpt_subgraph_first_past_input_idx + i] = past;
   }
@@ -1071,7 +1059,7 @@ template <typename T>
 Status PickT5PastState(const std::vector<OrtValue>& last_outputs,
                        std::vector<OrtValue>& next_inputs,
                        int num_present_tensors,
-                       gsl::span<const int32_t>& beam_indices,
+                       gsl::span<const int32_t>& beam_indices_gpu,
                        AllocatorPtr allocator,
                        ptrdiff_t t5_decoder_first_past_input_idx,
                        ptrdiff_t t5_decoder_first_present_output_idx,
@@ -1085,19 +1073,13 @@ Status PickT5PastState(const std::vector<OrtValue>& last_outputs,
     auto block_size_per_beam = past_shape[1] * past_shape[2] * past_shape[3];
 
     // Create a tensor with same shape.
-    // TODO(tianleiwu): allocate one buffer for all layers, and use a CUDA kernel to copy key/value cache data.
     OrtValue past;
     Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), past_shape, allocator, past);
 
-    gsl::span<T> past_span = gsl::make_span<T>(past.GetMutable<Tensor>()->MutableData<T>(), past_shape.Size());
-    gsl::span<const T> present_span = gsl::make_span<const T>(present.Get<Tensor>().Data<T>(), past_shape.Size());
-    for (size_t j = 0; j < beam_indices.size(); j++) {
-      int32_t beam_index = beam_indices[j];
-      gsl::span<const T> present_beam = present_span.subspan(beam_index * block_size_per_beam, block_size_per_beam);
-      gsl::span<T> past_beam = past_span.subspan(j * block_size_per_beam, block_size_per_beam);
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(past_beam.data(), present_beam.data(), present_beam.size_bytes(),
-                                           cudaMemcpyDeviceToDevice, cuda_stream));
-    }
+    cuda::LaunchGatherBeamState(present.Get<Tensor>().DataRaw(), past.GetMutable<Tensor>()->MutableDataRaw(),
+                                beam_indices_gpu.data(), 1, static_cast<int>(beam_indices_gpu.size()),
+                                SafeInt<size_t>(block_size_per_beam) * sizeof(T), cuda_stream);
+    CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
     next_inputs[t5_decoder_first_past_input_idx + i] = past;
   }
@@ -1207,11 +1189,12 @@ Status UpdateGptFeeds(
         next_inputs[i + k] = last_outputs[i];
       }
     } else {
-      ORT_RETURN_IF_ERROR(PickGptPastState<T>(last_outputs, next_inputs, beam_indices_cpu, allocator,
+      // the past state is gathered on the stream of the next subgraph execution, there is no need to wait for it
+      ORT_UNUSED_PARAMETER(beam_indices_cpu);
+      ORT_ENFORCE(!beam_indices_gpu.empty(), "Beam indices must be present on CUDA to pick the past state");
+      ORT_RETURN_IF_ERROR(PickGptPastState<T>(last_outputs, next_inputs, beam_indices_gpu, allocator,
                                               gpt_subgraph_first_past_input_idx,
                                               gpt_subgraph_first_present_output_idx, ort_stream));
-      // Make sure data is ready before next subgraph execution.
-      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(cuda_stream));
     }
   }
 
@@ -1334,7 +1317,9 @@ Status UpdateDecoderFeeds(
       return Status::OK();
     }
 
-    return PickT5PastState<T>(last_outputs, next_inputs, num_present_tensors, beam_indices, allocator,
+    ORT_UNUSED_PARAMETER(beam_indices);
+    ORT_ENFORCE(!beam_indices_gpu.empty(), "Beam indices must be present on CUDA to pick the past state");
+    return PickT5PastState<T>(last_outputs, next_inputs, num_present_tensors, beam_indices_gpu, allocator,
                               t5_decoder_first_past_input_idx, t5_decoder_first_present_output_idx, ort_stream);
   }
 
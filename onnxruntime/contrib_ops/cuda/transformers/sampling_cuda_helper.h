@@ -27,97 +27,40 @@ Status Sample(AllocatorPtr& allocator,
               const transformers::IGenerationParameters* parameters,
               int step,
               const IConsoleDumper* dumper) {
+  ORT_UNUSED_PARAMETER(allocator);
   ORT_UNUSED_PARAMETER(dumper);
   typedef typename ToCudaType<T>::MappedType CudaT;
 
   auto cuda_stream = static_cast<cudaStream_t>(stream->GetHandle());
 
-  gsl::span<int>& d_index_in = sampling_state->d_index_in;
-  gsl::span<int>& d_offset = sampling_state->d_offset;
-
-  BufferUniquePtr& storage_buffer = sampling_state->storage_buffer;
-  size_t& temp_storage_bytes = sampling_state->temp_storage_bytes;
-
   bool is_descending = parameters->custom_sampling;
-  if (step == 1) {
-    cuda::GetTempStorageSize<CudaT>(reinterpret_cast<CudaT*>(next_token_scores.data()),
-                                    d_index_in.data(),
-                                    d_offset.data(),
-                                    parameters->batch_size * parameters->vocab_size,
-                                    parameters->batch_size,
-                                    cuda_stream,
-                                    is_descending,
-                                    temp_storage_bytes);
-
-    cuda::LaunchSetupParamsKernel(d_index_in.data(),
-                                  d_offset.data(),
-                                  parameters->batch_size,
-                                  parameters->vocab_size,
-                                  cuda_stream);
-
-#ifdef DEBUG_GENERATION
-    dumper->Print("d_offset_buffer", d_offset.data(), parameters->batch_size + 1, 1);
-#endif
 
-    void* temp_storage = allocator->Alloc(sampling_state->temp_storage_bytes);
-    BufferUniquePtr temp_storage_buffer(temp_storage, BufferDeleter(allocator));
-    storage_buffer = std::move(temp_storage_buffer);
-  }
-
-  gsl::span<T>& d_sorted_score = sampling_state->d_sorted_score;
-  gsl::span<int>& d_index_out = sampling_state->d_index_out;
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("temp_storage_bytes", sampling_state->temp_storage_bytes, true);
-#endif
-
-  cuda::LaunchSortPairs<CudaT>(storage_buffer.get(),
-                               temp_storage_bytes,
-                               reinterpret_cast<CudaT*>(next_token_scores.data()),
-                               reinterpret_cast<CudaT*>(d_sorted_score.data()),
-                               d_index_in.data(),
-                               d_index_out.data(),
-                               parameters->batch_size * parameters->vocab_size,
-                               parameters->batch_size,
-                               d_offset.data(),
-                               cuda_stream,
-                               is_descending);
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("d_sorted_score_buffer",
-                reinterpret_cast<T*>(d_sorted_score.data()),
-                parameters->batch_size,
-                parameters->vocab_size);
-  dumper->Print("d_index_buffer_in", d_index_in.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("d_index_buffer_out", d_index_out.data(), parameters->batch_size, parameters->vocab_size);
-#endif
-
-  gsl::span<float>& d_sorted_softmaxed_score = sampling_state->d_sorted_softmaxed_score;
+  // The top-p filter works on the probabilities of the scores, in vocabulary order.
+  gsl::span<float>& d_unfiltered_softmaxed_score = sampling_state->d_unfiltered_softmaxed_score;
   ORT_RETURN_IF_ERROR((dispatch_blockwise_softmax_forward<CudaT, float, float, false>(stream,
-                                                                                      d_sorted_softmaxed_score.data(),
-                                                                                      reinterpret_cast<CudaT*>(d_sorted_score.data()),
+                                                                                      d_unfiltered_softmaxed_score.data(),
+                                                                                      reinterpret_cast<CudaT*>(next_token_scores.data()),
                                                                                       parameters->vocab_size,
                                                                                       parameters->vocab_size,
                                                                                       parameters->vocab_size,
                                                                                       parameters->batch_size)));
 
 #ifdef DEBUG_GENERATION
-  dumper->Print("d_sorted_softmaxed_score_buffer",
-                d_sorted_softmaxed_score.data(),
+  dumper->Print("d_unfiltered_softmaxed_score_buffer",
+                d_unfiltered_softmaxed_score.data(),
                 parameters->batch_size,
                 parameters->vocab_size);
 #endif
 
-  cuda::LaunchFilterLogitsKernel<CudaT>(d_sorted_softmaxed_score.data(),
-                                        d_index_out.data(),
-                                        reinterpret_cast<CudaT*>(next_token_scores.data()),
-                                        parameters->top_p,
-                                        parameters->filter_value,
-                                        parameters->min_tokens_to_keep,
-                                        parameters->batch_size,
-                                        parameters->vocab_size,
-                                        cuda_stream,
-                                        is_descending);
+  cuda::LaunchTopPFilterKernel<CudaT>(d_unfiltered_softmaxed_score.data(),
+                                      reinterpret_cast<CudaT*>(next_token_scores.data()),
+                                      parameters->top_p,
+                                      parameters->filter_value,
+                                      parameters->min_tokens_to_keep,
+                                      parameters->batch_size,
+                                      parameters->vocab_size,
+                                      cuda_stream,
+                                      is_descending);
 
 #ifdef DEBUG_GENERATION
   dumper->Print("next_token_scores after filtering logits",
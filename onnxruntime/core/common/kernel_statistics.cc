@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/kernel_statistics.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace onnxruntime {
+namespace profiling {
+
+namespace {
+// index of the highest set bit. value must be non-zero.
+int HighestBit(uint64_t value) {
+  int bit = 0;
+  for (int shift = 32; shift > 0; shift >>= 1) {
+    if (value >> shift) {
+      value >>= shift;
+      bit += shift;
+    }
+  }
+  return bit;
+}
+
+void AtomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+}  // namespace
+
+size_t KernelStatistics::GetBucketIndex(uint64_t value) {
+  if (value < kNumLinearBuckets) {
+    return static_cast<size_t>(value);
+  }
+
+  const int exponent = HighestBit(value);
+  const size_t sub_bucket = static_cast<size_t>(value >> (exponent - kSubBucketBits)) & ((1 << kSubBucketBits) - 1);
+  return kNumLinearBuckets + (static_cast<size_t>(exponent) - 4) * (1 << kSubBucketBits) + sub_bucket;
+}
+
+uint64_t KernelStatistics::GetBucketValue(size_t bucket_index) {
+  if (bucket_index < kNumLinearBuckets) {
+    return bucket_index;
+  }
+
+  const size_t offset = bucket_index - kNumLinearBuckets;
+  const size_t exponent = offset / (1 << kSubBucketBits) + 4;
+  const uint64_t sub_bucket = offset % (1 << kSubBucketBits);
+  const uint64_t width = uint64_t{1} << (exponent - kSubBucketBits);
+  const uint64_t lower = ((uint64_t{1} << kSubBucketBits) + sub_bucket) * width;
+  return lower + width / 2;
+}
+
+void KernelStatistics::OpStats::Record(uint64_t duration_ns, uint64_t output_bytes) {
+  count.fetch_add(1, std::memory_order_relaxed);
+  total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+  total_output_bytes.fetch_add(output_bytes, std::memory_order_relaxed);
+  latency_buckets[GetBucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+  AtomicMax(max_ns, duration_ns);
+}
+
+KernelStatistics::OpStats& KernelStatistics::GetOrAddOpStats(const std::string& op_type,
+                                                             const std::string& provider) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = std::find_if(op_stats_.begin(), op_stats_.end(), [&](const std::unique_ptr<OpStats>& stats) {
+    return stats->op_type == op_type && stats->provider == provider;
+  });
+
+  if (it != op_stats_.end()) {
+    return **it;
+  }
+
+  op_stats_.push_back(std::make_unique<OpStats>(op_type, provider));
+  return *op_stats_.back();
+}
+
+uint64_t KernelStatistics::GetPercentile(const OpStats& stats, uint64_t count, double percentile) {
+  // rank of the sample at the percentile, 1 based.
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * static_cast<double>(count) + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += stats.latency_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return GetBucketValue(i);
+    }
+  }
+
+  return stats.max_ns.load(std::memory_order_relaxed);
+}
+
+std::vector<KernelStatistics::Summary> KernelStatistics::GetSummaries() const {
+  std::vector<Summary> summaries;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    summaries.reserve(op_stats_.size());
+    for (const auto& stats : op_stats_) {
+      uint64_t count = 0;
+      for (const auto& bucket : stats->latency_buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+      }
+
+      if (count == 0) {
+        continue;
+      }
+
+      // the percentiles use the histogram count so they are consistent with each other even if kernels are
+      // recording while the snapshot is taken.
+      const uint64_t max_ns = stats->max_ns.load(std::memory_order_relaxed);
+      summaries.push_back(Summary{stats->op_type, stats->provider,
+                                  stats->count.load(std::memory_order_relaxed),
+                                  stats->total_ns.load(std::memory_order_relaxed),
+                                  std::min(GetPercentile(*stats, count, 0.5), max_ns),
+                                  std::min(GetPercentile(*stats, count, 0.99), max_ns),
+                                  max_ns,
+                                  stats->total_output_bytes.load(std::memory_order_relaxed)});
+    }
+  }
+
+  std::sort(summaries.begin(), summaries.end(), [](const Summary& a, const Summary& b) {
+    return a.total_ns > b.total_ns;
+  });
+
+  return summaries;
+}
+
+std::string KernelStatistics::ToJson() const {
+  std::ostringstream ss;
+  ss << "[";
+  bool first = true;
+  for (const auto& summary : GetSummaries()) {
+    ss << (first ? "" : ",")
+       << "{\"op_type\":\"" << summary.op_type
+       << "\",\"provider\":\"" << summary.provider
+       << "\",\"count\":" << summary.count
+       << ",\"total_ns\":" << summary.total_ns
+       << ",\"p50_ns\":" << summary.p50_ns
+       << ",\"p99_ns\":" << summary.p99_ns
+       << ",\"max_ns\":" << summary.max_ns
+       << ",\"output_bytes\":" << summary.total_output_bytes
+       << "}";
+    first = false;
+  }
+  ss << "]";
+  return ss.str();
+}
+
+void KernelStatistics::Reset() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto& stats : op_stats_) {
+    stats->count.store(0, std::memory_order_relaxed);
+    stats->total_ns.store(0, std::memory_order_relaxed);
+    stats->max_ns.store(0, std::memory_order_relaxed);
+    stats->total_output_bytes.store(0, std::memory_order_relaxed);
+    for (auto& bucket : stats->latency_buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+namespace profiling {
+
+/**
+ * Aggregated kernel statistics that are cheap enough to be collected for every run in production.
+ * Instead of one event per kernel invocation, each (op type, provider) pair keeps a call count, the total
+ * output bytes and a log-linear latency histogram from which percentiles are derived on query.
+ */
+class KernelStatistics {
+ public:
+  // 16 exact buckets for values below 16, then 4 sub-buckets for each power of two up to 2^63.
+  static constexpr size_t kNumLinearBuckets = 16;
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kNumBuckets = kNumLinearBuckets + (64 - 4) * (1 << kSubBucketBits);
+
+  struct OpStats {
+    OpStats(std::string op_type_in, std::string provider_in)
+        : op_type(std::move(op_type_in)), provider(std::move(provider_in)) {}
+
+    // Thread safe. Only relaxed atomic increments so concurrent kernels don't serialize on the stats.
+    void Record(uint64_t duration_ns, uint64_t output_bytes);
+
+    const std::string op_type;
+    const std::string provider;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> total_output_bytes{0};
+    std::array<std::atomic<uint64_t>, kNumBuckets> latency_buckets{};
+  };
+
+  struct Summary {
+    std::string op_type;
+    std::string provider;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+    uint64_t total_output_bytes;
+  };
+
+  KernelStatistics() = default;
+
+  /*
+  Returns the stats for the op type and provider, creating them if needed.
+  The returned reference stays valid for the lifetime of this instance so callers can cache it.
+  */
+  OpStats& GetOrAddOpStats(const std::string& op_type, const std::string& provider);
+
+  /*
+  Snapshot of all stats, ordered by total time with the most expensive op type first.
+  */
+  std::vector<Summary> GetSummaries() const;
+
+  /*
+  GetSummaries() as a JSON array.
+  */
+  std::string ToJson() const;
+
+  /*
+  Clears the counters. Concurrent updates may or may not be included in the next snapshot.
+  */
+  void Reset();
+
+  static size_t GetBucketIndex(uint64_t value);
+  // Value reported for samples in the bucket. The midpoint of its range.
+  static uint64_t GetBucketValue(size_t bucket_index);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelStatistics);
+
+  static uint64_t GetPercentile(const OpStats& stats, uint64_t count, double percentile);
+
+  mutable OrtMutex mutex_;
+  std::vector<std::unique_ptr<OpStats>> op_stats_;
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
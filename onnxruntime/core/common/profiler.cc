@@ -3,10 +3,114 @@
 
 #include "profiler.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
 
+namespace {
+
+constexpr std::string_view kKernelTimeSuffix = "_kernel_time";
+
+int64_t GetIntArg(const EventRecord& event, const std::string& name) {
+  const auto it = event.args.find(name);
+  return it == event.args.end() || it->second.empty() ? 0 : std::stoll(it->second);
+}
+
+// Adds the GPU kernels that the EP profilers correlated with a node event to its args as "gpu_kernels",
+// "gpu_kernel_count" and "gpu_time", so that the node record holds its CPU time, memory and kernels.
+void AddGpuKernelsToNodeEvents(Events& events) {
+  // the kernels of a node are merged right after the node event, so the latest node event with the name of their
+  // parent is the one they belong to when the node runs several times
+  std::unordered_map<std::string, size_t> latest_node_events;
+  std::unordered_map<size_t, std::tuple<std::string, int64_t, long long>> node_kernels;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    if (event.cat == NODE_EVENT) {
+      latest_node_events[event.name] = i;
+      continue;
+    }
+
+    const auto parent = event.args.find("parent_name");
+    if (event.cat != KERNEL_EVENT || parent == event.args.end()) {
+      continue;
+    }
+
+    const auto node_event = latest_node_events.find(parent->second);
+    if (node_event != latest_node_events.end()) {
+      auto& [kernels, count, time] = node_kernels[node_event->second];
+      kernels += (kernels.empty() ? "[" : ",") + std::string(R"({"name" : ")") + event.name +
+                 R"(", "dur" : )" + std::to_string(event.dur) + "}";
+      ++count;
+      time += event.dur;
+    }
+  }
+
+  for (const auto& [index, kernels] : node_kernels) {
+    auto& args = events[index].args;
+    args["gpu_kernels"] = std::get<0>(kernels) + "]";
+    args["gpu_kernel_count"] = std::to_string(std::get<1>(kernels));
+    args["gpu_time"] = std::to_string(std::get<2>(kernels));
+  }
+}
+
+void WriteNodeSummary(const Events& events, const std::string& file_name) {
+  struct NodeSummary {
+    std::string op_name;
+    std::string provider;
+    int64_t count{0};
+    int64_t cpu_time{0};
+    int64_t gpu_time{0};
+    int64_t gpu_kernel_count{0};
+    int64_t allocated_bytes{0};
+    int64_t freed_bytes{0};
+    int64_t peak_increase_bytes{0};
+  };
+
+  std::unordered_map<std::string, NodeSummary> summaries;
+  for (const auto& event : events) {
+    if (event.cat != NODE_EVENT || event.name.size() < kKernelTimeSuffix.size() ||
+        event.name.compare(event.name.size() - kKernelTimeSuffix.size(), kKernelTimeSuffix.size(),
+                           kKernelTimeSuffix) != 0) {
+      continue;
+    }
+
+    auto& summary = summaries[event.name.substr(0, event.name.size() - kKernelTimeSuffix.size())];
+    if (summary.count == 0) {
+      const auto op_name = event.args.find("op_name");
+      const auto provider = event.args.find("provider");
+      summary.op_name = op_name != event.args.end() ? op_name->second : "";
+      summary.provider = provider != event.args.end() ? provider->second : "";
+    }
+
+    ++summary.count;
+    summary.cpu_time += event.dur;
+    summary.gpu_time += GetIntArg(event, "gpu_time");
+    summary.gpu_kernel_count += GetIntArg(event, "gpu_kernel_count");
+    summary.allocated_bytes += GetIntArg(event, "allocated_bytes");
+    summary.freed_bytes += GetIntArg(event, "freed_bytes");
+    summary.peak_increase_bytes += GetIntArg(event, "peak_increase_bytes");
+  }
+
+  std::vector<std::pair<std::string, NodeSummary>> sorted(summaries.begin(), summaries.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.second.cpu_time + a.second.gpu_time > b.second.cpu_time + b.second.gpu_time;
+  });
+
+  std::ofstream stream(file_name, std::ios::out | std::ios::trunc);
+  stream << "node,op_name,provider,count,cpu_time_us,gpu_time_us,gpu_kernel_count,allocated_bytes,freed_bytes,"
+            "peak_increase_bytes\n";
+  for (const auto& [name, summary] : sorted) {
+    stream << name << "," << summary.op_name << "," << summary.provider << "," << summary.count << ","
+           << summary.cpu_time << "," << summary.gpu_time << "," << summary.gpu_kernel_count << ","
+           << summary.allocated_bytes << "," << summary.freed_bytes << "," << summary.peak_increase_bytes << "\n";
+  }
+}
+
+}  // namespace
+
 std::atomic<size_t> Profiler::global_max_num_events_{1000 * 1000};
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
@@ -121,6 +225,20 @@ std::string Profiler::EndProfiling() {
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->EndProfiling(profiling_start_time_, events_);
   }
+  AddGpuKernelsToNodeEvents(events_);
+
+#if !defined(__wasm__)
+  if (node_summary_enabled_) {
+    std::string summary_file = profile_stream_file_;
+    constexpr std::string_view kJsonExtension = ".json";
+    if (summary_file.size() >= kJsonExtension.size() &&
+        summary_file.compare(summary_file.size() - kJsonExtension.size(), kJsonExtension.size(), kJsonExtension) == 0) {
+      summary_file.resize(summary_file.size() - kJsonExtension.size());
+    }
+
+    WriteNodeSummary(events_, summary_file + "_summary.csv");
+  }
+#endif
 
   for (size_t i = 0; i < events_.size(); ++i) {
     auto& rec = events_[i];
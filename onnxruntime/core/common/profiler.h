@@ -9,6 +9,7 @@
 #include <iostream>
 #include <tuple>
 
+#include "core/common/kernel_statistics.h"
 #include "core/common/profiler_common.h"
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
@@ -110,6 +111,28 @@ class Profiler {
     global_max_num_events_.store(new_max_num_events);
   }
 
+  /*
+  Aggregated per op type kernel statistics. Collected independently of IsEnabled() when
+  the session is configured with kOrtSessionOptionsEnableKernelStatistics.
+  */
+  KernelStatistics& GetKernelStatistics() noexcept {
+    return kernel_statistics_;
+  }
+
+  const KernelStatistics& GetKernelStatistics() const noexcept {
+    return kernel_statistics_;
+  }
+
+  /*
+  Writes a summary table of the node events next to the profile file when profiling ends, with one line per node:
+  its CPU time, the time and number of the GPU kernels the EP profilers correlated with it, and the arena bytes it
+  allocated, freed and added to the peak. The file name is the profile file name with ".json" replaced by
+  "_summary.csv".
+  */
+  void EnableNodeSummary(bool enable) noexcept {
+    node_summary_enabled_ = enable;
+  }
+
   void AddEpProfilers(std::unique_ptr<EpProfiler> ep_profiler) {
     if (ep_profiler) {
       ep_profilers_.push_back(std::move(ep_profiler));
@@ -149,6 +172,7 @@ class Profiler {
   Events events_;
   bool max_events_reached{false};
   bool profile_with_logger_{false};
+  bool node_summary_enabled_{false};
   const size_t max_num_events_{global_max_num_events_.load()};
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
@@ -156,6 +180,7 @@ class Profiler {
 #endif
 
   std::vector<std::unique_ptr<EpProfiler>> ep_profilers_;
+  KernelStatistics kernel_statistics_;
 };
 
 }  // namespace profiling
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <optional>
 
@@ -64,6 +67,9 @@ ThreadPoolProfiler::~ThreadPoolProfiler() {
 }
 
 void ThreadPoolProfiler::Start() {
+  if (!enabled_) {
+    start_point_ = Clock::now();
+  }
   enabled_ = true;
 }
 
@@ -202,10 +208,27 @@ void ThreadPoolProfiler::LogThreadId(int thread_idx) {
   child_thread_stats_[thread_idx].thread_id_ = std::this_thread::get_id();
 }
 
+void ThreadPoolProfiler::LogRunStart(int thread_idx) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].run_start_point_ = Clock::now();
+  }
+}
+
+void ThreadPoolProfiler::LogSteal(int thread_idx) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].num_steal_++;
+  }
+}
+
 void ThreadPoolProfiler::LogRun(int thread_idx) {
   if (enabled_) {
     child_thread_stats_[thread_idx].num_run_++;
     auto now = Clock::now();
+    // a run that started before profiling was enabled is not accounted as busy time
+    if (child_thread_stats_[thread_idx].run_start_point_ >= start_point_) {
+      child_thread_stats_[thread_idx].busy_us_ += TimeDiffMicroSeconds(child_thread_stats_[thread_idx].run_start_point_,
+                                                                       now);
+    }
     if (child_thread_stats_[thread_idx].core_ < 0 ||
         TimeDiffMicroSeconds(child_thread_stats_[thread_idx].last_logged_point_, now) > 10000) {
 #ifdef _WIN32
@@ -235,11 +258,30 @@ std::string ThreadPoolProfiler::DumpChildThreadStat() {
   for (int i = 0; i < num_threads_; ++i) {
     ss << "\"" << child_thread_stats_[i].thread_id_ << "\": {"
        << "\"num_run\": " << child_thread_stats_[i].num_run_ << ", "
+       << "\"num_steal\": " << child_thread_stats_[i].num_steal_ << ", "
+       << "\"busy_us\": " << child_thread_stats_[i].busy_us_ << ", "
        << "\"core\": " << child_thread_stats_[i].core_ << "}"
        << (i == num_threads_ - 1 ? "" : ",");
   }
   return ss.str();
 }
+
+std::vector<ThreadPoolThreadStats> ThreadPoolProfiler::GetThreadStats() const {
+  std::vector<ThreadPoolThreadStats> stats;
+  if (!enabled_) {
+    return stats;
+  }
+  const uint64_t elapsed_us = static_cast<uint64_t>(TimeDiffMicroSeconds(start_point_, Clock::now()));
+  stats.reserve(num_threads_);
+  for (int i = 0; i < num_threads_; ++i) {
+    ThreadPoolThreadStats& thread_stats = stats.emplace_back();
+    thread_stats.num_runs = child_thread_stats_[i].num_run_;
+    thread_stats.num_steals = child_thread_stats_[i].num_steal_;
+    thread_stats.busy_us = child_thread_stats_[i].busy_us_;
+    thread_stats.elapsed_us = elapsed_us;
+  }
+  return stats;
+}
 #endif
 
 // A sharded loop counter distributes loop iterations between a set of worker threads.  The iteration space of
@@ -306,6 +348,19 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
     return idx % _num_shards;
   }
 
+  // On pools spanning several NUMA nodes the shards are split into contiguous groups, one per node, and the
+  // threads of a node start from the shards of its group.  Each node then works on its own contiguous part of the
+  // iteration space, and the same part in successive loops, which keeps the pages it first touched local to it.
+  // Threads outside the pool, and loops with fewer shards than nodes, fall back to the worker ID.
+  unsigned GetHomeShard(unsigned idx, int numa_node, int num_numa_nodes) const {
+    if (numa_node < 0 || _num_shards < static_cast<unsigned>(num_numa_nodes)) {
+      return GetHomeShard(idx);
+    }
+    const unsigned first_shard = static_cast<unsigned>(numa_node) * _num_shards / num_numa_nodes;
+    const unsigned end_shard = static_cast<unsigned>(numa_node + 1) * _num_shards / num_numa_nodes;
+    return first_shard + idx % (end_shard - first_shard);
+  }
+
   // Attempt to claim iterations from the sharded counter.  The function either
   // returns true, along with a block of exactly block_size iterations, or it returns false
   // if all of the iterations have been claimed.
@@ -369,6 +424,55 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// Cost of an iteration of each ParallelFor call site, measured at runtime.  A call site is identified by the type
+// of its function object, which differs for each lambda expression, and by the cost estimated by the caller.  The
+// table has a fixed number of slots and is lock free: a call site colliding with another one takes over its slot,
+// which only costs a new calibration.  The costs are kept in nanoseconds; as documented for TryParallelFor, the cost
+// model accepts nanoseconds in place of cycles.
+class LoopCostTable {
+ public:
+  struct Slot {
+    std::atomic<size_t> call_site{0};
+    std::atomic<uint64_t> num_calls{0};
+    std::atomic<uint64_t> picos_per_unit{0};  // 0 until the first measurement
+
+    // Returns true if the current call should be timed: the first calls, then a sample to follow drifts.
+    bool ShouldMeasure() {
+      const uint64_t calls = num_calls.fetch_add(1, std::memory_order_relaxed);
+      return calls < kNumWarmupCalls || calls % kResampleInterval == 0;
+    }
+
+    // Returns the measured cost of an iteration, or a negative value if it is not known yet.
+    double NanosPerUnit() const {
+      const uint64_t picos = picos_per_unit.load(std::memory_order_relaxed);
+      return picos == 0 ? -1.0 : static_cast<double>(picos) / 1000.0;
+    }
+
+    void Record(uint64_t busy_ns, std::ptrdiff_t num_units) {
+      const uint64_t measured = std::max<uint64_t>(1, busy_ns * 1000 / static_cast<uint64_t>(num_units));
+      const uint64_t previous = picos_per_unit.load(std::memory_order_relaxed);
+      // moving average weighting the new measurement by 1/4, racing updates may drop a measurement.
+      picos_per_unit.store(previous == 0 ? measured : previous - previous / 4 + measured / 4, std::memory_order_relaxed);
+    }
+  };
+
+  Slot& Find(size_t call_site) {
+    Slot& slot = slots_[call_site % kNumSlots];
+    if (slot.call_site.load(std::memory_order_relaxed) != call_site) {
+      slot.call_site.store(call_site, std::memory_order_relaxed);
+      slot.num_calls.store(0, std::memory_order_relaxed);
+      slot.picos_per_unit.store(0, std::memory_order_relaxed);
+    }
+    return slot;
+  }
+
+ private:
+  static constexpr size_t kNumSlots = 256;
+  static constexpr uint64_t kNumWarmupCalls = 8;
+  static constexpr uint64_t kResampleInterval = 64;
+  Slot slots_[kNumSlots];
+};
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -376,18 +480,35 @@ ThreadPool::ThreadPool(Env* env,
                        bool low_latency_hint,
                        bool force_hybrid)
     : thread_options_(thread_options), force_hybrid_(force_hybrid) {
+  if (thread_options_.calibrate_loop_costs) {
+    loop_costs_ = std::make_unique<LoopCostTable>();
+  }
   // In the current implementation, a thread pool with degree_of_parallelism==1 uses
   // the caller as one of the threads for executing work.  Hence we only create
   // additional thread(s) for degree_of_parallelism>=2.
   assert(degree_of_parallelism >= 1);
+  const auto& throughput_weights = thread_options_.throughput_weights;
+  if (!throughput_weights.empty() && throughput_weights.size() == thread_options_.affinities.size()) {
+    const auto [min_weight, max_weight] = std::minmax_element(throughput_weights.begin(), throughput_weights.end());
+    // a block run by a thread on the slowest core takes max_weight / min_weight times longer than on the fastest
+    // core. shrink the blocks by that ratio so the last ones do not leave the other threads waiting.
+    task_granularity_factor_ = *min_weight > 0.0f && *min_weight < *max_weight
+                                   ? static_cast<int>(std::ceil(TaskGranularityFactor * *max_weight / *min_weight))
+                                   : 1;
+  }
+
   if (degree_of_parallelism >= 2) {
     int threads_to_create = degree_of_parallelism - 1;
 
     if (!thread_options_.affinities.empty()) {
       // Remove first affinity element as designated for the caller thread
+      if (thread_options_.numa_nodes.size() == thread_options_.affinities.size()) {
+        thread_options_.numa_nodes.erase(thread_options_.numa_nodes.begin());
+      }
       thread_options_.affinities.erase(thread_options_.affinities.begin());
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
     }
+    InitNumaNodes(threads_to_create);
 
     extended_eigen_threadpool_ =
         std::make_unique<ThreadPoolTempl<Env> >(name,
@@ -399,8 +520,155 @@ ThreadPool::ThreadPool(Env* env,
   }
 }
 
+ThreadPool::ThreadPool(ThreadPool& shared_pool, int max_degree_of_parallelism, SchedulingPriority priority)
+    : thread_options_(shared_pool.thread_options_),
+      underlying_threadpool_(shared_pool.underlying_threadpool_),
+      force_hybrid_(shared_pool.force_hybrid_),
+      task_granularity_factor_(shared_pool.task_granularity_factor_),
+      num_numa_nodes_(shared_pool.num_numa_nodes_),
+      shared_pool_(shared_pool.shared_pool_ != nullptr ? shared_pool.shared_pool_ : &shared_pool),
+      max_degree_of_parallelism_(max_degree_of_parallelism),
+      priority_(priority) {
+  ORT_ENFORCE(max_degree_of_parallelism >= 0, "Invalid max degree of parallelism: ", max_degree_of_parallelism);
+}
+
 ThreadPool::~ThreadPool() = default;
 
+void ThreadPool::InitNumaNodes(int num_threads) {
+  // Renumber the nodes of the threads 0..N-1. They are dropped unless there is one per thread and more than one node.
+  auto& numa_nodes = thread_options_.numa_nodes;
+  if (numa_nodes.size() < static_cast<size_t>(num_threads)) {
+    numa_nodes.clear();
+    return;
+  }
+  numa_nodes.resize(static_cast<size_t>(num_threads));
+  std::vector<int> distinct_nodes(numa_nodes);
+  std::sort(distinct_nodes.begin(), distinct_nodes.end());
+  distinct_nodes.erase(std::unique(distinct_nodes.begin(), distinct_nodes.end()), distinct_nodes.end());
+  if (distinct_nodes.size() <= 1) {
+    numa_nodes.clear();
+    return;
+  }
+  for (auto& node : numa_nodes) {
+    node = static_cast<int>(std::lower_bound(distinct_nodes.begin(), distinct_nodes.end(), node) -
+                            distinct_nodes.begin());
+  }
+  num_numa_nodes_ = static_cast<int>(distinct_nodes.size());
+}
+
+int ThreadPool::CurrentNumaNode() const {
+  if (num_numa_nodes_ == 0) {
+    return -1;
+  }
+  const int thread_id = CurrentThreadId();
+  return thread_id >= 0 ? thread_options_.numa_nodes[thread_id] : -1;
+}
+
+void ThreadPool::BeginRun(ThreadPool* tp) {
+  if (tp && tp->shared_pool_ && tp->priority_ == SchedulingPriority::kHigh) {
+    tp->shared_pool_->num_high_priority_runs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ThreadPool::EndRun(ThreadPool* tp) {
+  if (tp && tp->shared_pool_ && tp->priority_ == SchedulingPriority::kHigh) {
+    tp->shared_pool_->num_high_priority_runs_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+namespace {
+// the overrides of the innermost ThreadPool::RunScope of the current thread
+thread_local int run_max_degree_of_parallelism = 0;
+thread_local std::optional<ThreadPool::SchedulingPriority> run_priority;
+}  // namespace
+
+ThreadPool::RunScope::RunScope(ThreadPool* tp, int max_degree_of_parallelism,
+                               std::optional<SchedulingPriority> priority)
+    : prev_max_degree_of_parallelism_(run_max_degree_of_parallelism), prev_priority_(run_priority) {
+  if (max_degree_of_parallelism > 0) {
+    run_max_degree_of_parallelism = max_degree_of_parallelism;
+  }
+  if (priority.has_value()) {
+    run_priority = priority;
+    if (tp && *priority == SchedulingPriority::kHigh) {
+      high_priority_pool_ = tp->shared_pool_ ? tp->shared_pool_ : tp;
+      high_priority_pool_->num_high_priority_runs_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+ThreadPool::RunScope::~RunScope() {
+  if (high_priority_pool_) {
+    high_priority_pool_->num_high_priority_runs_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  run_max_degree_of_parallelism = prev_max_degree_of_parallelism_;
+  run_priority = prev_priority_;
+}
+
+int ThreadPool::MaxParallelism() const {
+  const int num_threads_inc_main = NumThreads() + 1;
+  int max_parallelism = num_threads_inc_main;
+  if (max_degree_of_parallelism_ > 0) {
+    max_parallelism = std::min(max_parallelism, max_degree_of_parallelism_);
+  }
+  if (run_max_degree_of_parallelism > 0) {
+    max_parallelism = std::min(max_parallelism, run_max_degree_of_parallelism);
+  }
+  // the high priority runs are counted in the pool owning the threads, whether they run through a view or not
+  const ThreadPool& owner = shared_pool_ ? *shared_pool_ : *this;
+  const SchedulingPriority priority = run_priority.value_or(priority_);
+  if (priority == SchedulingPriority::kNormal &&
+      owner.num_high_priority_runs_.load(std::memory_order_relaxed) > 0) {
+    max_parallelism = std::min(max_parallelism, std::max(1, num_threads_inc_main / 2));
+  }
+  if (thread_options_.lease_workers_to_callers) {
+    const ThreadPool& owner = shared_pool_ ? *shared_pool_ : *this;
+    // each caller counts itself among the threads of its share
+    const int num_callers = owner.num_leased_callers_.load(std::memory_order_relaxed);
+    if (num_callers > 1) {
+      max_parallelism = std::min(max_parallelism, std::max(1, num_threads_inc_main / num_callers));
+    }
+  }
+  return max_parallelism;
+}
+
+namespace {
+// whether the current thread holds a caller lease of a pool
+thread_local bool holds_caller_lease = false;
+}  // namespace
+
+bool ThreadPool::AcquireCallerLease() {
+  if (!thread_options_.lease_workers_to_callers || !underlying_threadpool_ || holds_caller_lease ||
+      CurrentThreadId() != -1) {
+    return false;
+  }
+  ThreadPool& owner = shared_pool_ ? *shared_pool_ : *this;
+  owner.num_leased_callers_.fetch_add(1, std::memory_order_relaxed);
+  holds_caller_lease = true;
+  return true;
+}
+
+void ThreadPool::ReleaseCallerLease() {
+  ThreadPool& owner = shared_pool_ ? *shared_pool_ : *this;
+  owner.num_leased_callers_.fetch_sub(1, std::memory_order_relaxed);
+  holds_caller_lease = false;
+}
+
+class ThreadPool::CallerLease {
+ public:
+  explicit CallerLease(ThreadPool& tp) : tp_(tp), leased_(tp.AcquireCallerLease()) {}
+  ~CallerLease() {
+    if (leased_) {
+      tp_.ReleaseCallerLease();
+    }
+  }
+
+ private:
+  ThreadPool& tp_;
+  const bool leased_;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CallerLease);
+};
+
 // Base case for parallel loops, running iterations 0..total, divided into blocks
 // of block_size iterations, and calling into a function that takes a start..end
 // range of indices to run.
@@ -415,18 +683,20 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     return;
   }
 
+  // count the caller while the loop runs, so concurrent callers of the pool each get a share of the threads.
+  CallerLease caller_lease(*this);
   auto d_of_p = DegreeOfParallelism(this);
   if (thread_options_.dynamic_block_base_ <= 0) {
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = MaxParallelism();
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
     LoopCounter lc(total, d_of_p, block_size);
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, CurrentNumaNode(), num_numa_nodes_);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
@@ -445,7 +715,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     LoopCounter lc(total, d_of_p, base_block_size);
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
       std::ptrdiff_t b = base_block_size;
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, CurrentNumaNode(), num_numa_nodes_);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
@@ -459,7 +729,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(MaxParallelism(), num_of_blocks), base_block_size);
   }
 }
 
@@ -493,31 +763,53 @@ std::string ThreadPool::StopProfiling() {
   }
 }
 
+std::vector<ThreadPoolThreadStats> ThreadPool::GetProfilingStats() const {
+  if (underlying_threadpool_) {
+    return underlying_threadpool_->GetProfilingStats();
+  } else {
+    return {};
+  }
+}
+
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+// pool the current parallel section was started on
+thread_local ExtendedThreadPoolInterface* current_parallel_section_pool = nullptr;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
-  ORT_ENFORCE(!current_parallel_section.has_value(), "Nested parallelism not supported");
   ORT_ENFORCE(!ps_);
   tp_ = tp;
-  if (tp && tp->underlying_threadpool_) {
+  // A section entered while the thread is already in one, e.g. the section a kernel opens inside the section the
+  // executor holds across consecutive nodes, joins the outer section.
+  if (tp && tp->underlying_threadpool_ && !current_parallel_section.has_value()) {
+    leased_ = tp->AcquireCallerLease();
     current_parallel_section.emplace();
+    current_parallel_section_pool = tp->underlying_threadpool_;
     ps_ = &*current_parallel_section;
     tp_->underlying_threadpool_->StartParallelSection(*ps_);
   }
 }
 
 ThreadPool::ParallelSection::~ParallelSection() {
-  if (current_parallel_section) {
+  if (ps_) {
     tp_->underlying_threadpool_->EndParallelSection(*ps_);
     current_parallel_section.reset();
+    current_parallel_section_pool = nullptr;
+    if (leased_) {
+      tp_->ReleaseCallerLease();
+    }
   }
 }
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
+      if (current_parallel_section_pool != underlying_threadpool_) {
+        // the workers of the pool cannot join a section of another pool, run the loop in the caller.
+        fn(0);
+        return;
+      }
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
                                                    n, block_size);
@@ -546,6 +838,11 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Do not parallelize loops of a view that may not enlist any other thread.
+  if (MaxParallelism() == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -613,6 +910,11 @@ static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::Tenso
 void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
   ORT_ENFORCE(n >= 0);
+  LoopCostTable* loop_costs = shared_pool_ ? shared_pool_->loop_costs_.get() : loop_costs_.get();
+  if (loop_costs && n > 0) {
+    CalibratedParallelFor(*loop_costs, n, c, f);
+    return;
+  }
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
   auto d_of_p = DegreeOfParallelism(this);
   // Compute small problems directly in the caller thread.
@@ -626,6 +928,51 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
   ParallelForFixedBlockSizeScheduling(n, block, f);
 }
 
+void ThreadPool::CalibratedParallelFor(LoopCostTable& loop_costs, std::ptrdiff_t n, const TensorOpCost& c,
+                                       const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
+  size_t call_site = std::hash<double>{}(c.bytes_loaded) ^ (std::hash<double>{}(c.bytes_stored) << 1) ^
+                     (std::hash<double>{}(c.compute_cycles) << 2);
+#ifndef ORT_NO_RTTI
+  call_site ^= f.target_type().hash_code();
+#endif
+  LoopCostTable::Slot& slot = loop_costs.Find(call_site);
+  const double nanos_per_unit = slot.NanosPerUnit();
+  const Eigen::TensorOpCost cost = nanos_per_unit < 0
+                                       ? Eigen::TensorOpCost{c.bytes_loaded, c.bytes_stored, c.compute_cycles}
+                                       : Eigen::TensorOpCost{0, 0, nanos_per_unit};
+  const bool measure = slot.ShouldMeasure();
+
+  auto d_of_p = DegreeOfParallelism(this);
+  // Unlike ParallelFor, the number of threads of the cost model also bounds the blocks of the loop: with a
+  // measured cost, small loops fan out to the threads they can keep busy only.
+  const int num_threads = static_cast<int>(CostModel::numThreads(static_cast<double>(n), cost, d_of_p));
+  const bool run_in_caller = !ShouldParallelizeLoop(n) || num_threads == 1;
+  if (!measure) {
+    if (run_in_caller) {
+      f(0, n);
+    } else {
+      ParallelForFixedBlockSizeScheduling(n, CalculateParallelForBlock(n, cost, nullptr, num_threads), f);
+    }
+    return;
+  }
+
+  std::atomic<uint64_t> busy_ns{0};
+  auto timed_f = [&f, &busy_ns](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const auto start = std::chrono::steady_clock::now();
+    f(first, last);
+    busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                std::chrono::steady_clock::now() - start)
+                                                .count()),
+                      std::memory_order_relaxed);
+  };
+  if (run_in_caller) {
+    timed_f(0, n);
+  } else {
+    ParallelForFixedBlockSizeScheduling(n, CalculateParallelForBlock(n, cost, nullptr, num_threads), timed_f);
+  }
+  slot.Record(busy_ns.load(std::memory_order_relaxed), n);
+}
+
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
   ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
@@ -639,10 +986,12 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // When not using OpenMP, we parallelize over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
-    if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+    if (tp->task_granularity_factor_ > 0) {
+      return tp->MaxParallelism() * tp->task_granularity_factor_;
+    } else if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
+      return tp->MaxParallelism() * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return tp->MaxParallelism();
     }
   } else {
     return 1;
@@ -663,6 +1012,14 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+std::vector<ThreadPoolThreadStats> ThreadPool::GetProfilingStats(const concurrency::ThreadPool* tp) {
+  if (tp) {
+    return tp->GetProfilingStats();
+  } else {
+    return {};
+  }
+}
+
 void ThreadPool::EnableSpinning() {
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/eager/ort_kernel_invoker.h"
+
+#include <algorithm>
+
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/common/logging/logging.h"
 #include "core/graph/model.h"
@@ -13,46 +16,98 @@ namespace onnxruntime {
 
 #define ORT_EAGER_ONNX_OPSET_VERSION 14
 
-common::Status ORTInvoker::Invoke(const std::string& op_name,
-                                  // optional inputs / outputs?
-                                  const std::vector<OrtValue>& inputs,
-                                  std::vector<OrtValue>& outputs,
-                                  const NodeAttributes* attributes,
-                                  const std::string& domain,
-                                  const int version) {
+struct ORTInvoker::CachedKernel {
+  std::unique_ptr<Model> model;
+  // the Info keeps a reference to it
+  std::function<bool(const std::string&)> is_sparse_initializer_func;
+  std::unique_ptr<OptimizerExecutionFrame::Info> info;
+  std::unique_ptr<const OpKernel> kernel;
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<int> fetch_mlvalue_idxs;
+};
+
+ORTInvoker::~ORTInvoker() = default;
+
+void ORTInvoker::ClearKernelCache() {
+  std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+  kernel_cache_.clear();
+}
+
+namespace {
+
+// The kernel of an op depends on the op, its attributes and the types of its inputs, but not on the input shapes.
+std::string GetKernelCacheKey(const std::string& op_name,
+                              const std::vector<OrtValue>& inputs,
+                              size_t output_count,
+                              const NodeAttributes* attributes,
+                              const std::string& domain,
+                              int version) {
+  std::string key = domain + ":" + op_name + ":" + std::to_string(version) + ":" + std::to_string(output_count);
+  for (const auto& input : inputs) {
+    key += ":" + std::to_string(input.Get<Tensor>().GetElementType());
+  }
+
+  if (attributes != nullptr) {
+    // NodeAttributes is unordered, so sort the names for a stable key
+    std::vector<const std::string*> names;
+    names.reserve(attributes->size());
+    for (const auto& attribute : *attributes) {
+      names.push_back(&attribute.first);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+    for (const auto* name : names) {
+      key += ":" + attributes->at(*name).SerializeAsString();
+    }
+  }
+
+  return key;
+}
+
+}  // namespace
+
+common::Status ORTInvoker::CreateCachedKernel(const std::string& op_name,
+                                              const std::vector<OrtValue>& inputs,
+                                              size_t output_count,
+                                              const NodeAttributes* attributes,
+                                              const std::string& domain,
+                                              int version,
+                                              std::unique_ptr<CachedKernel>& cached_kernel) {
   std::unordered_map<std::string, int> domain_version_map = {{kOnnxDomain, ORT_EAGER_ONNX_OPSET_VERSION},
                                                              {kMSDomain, 1}};
+  auto entry = std::make_unique<CachedKernel>();
+
   // create a graph
-  Model model("test",
-              false,
-              ModelMetaData(),
-              ORT_TSTR(""),
-              custom_op_registries_,
-              domain_version_map,
-              {},
-              logger_);
+  entry->model = std::make_unique<Model>("test",
+                                         false,
+                                         ModelMetaData(),
+                                         ORT_TSTR(""),
+                                         custom_op_registries_,
+                                         domain_version_map,
+                                         std::vector<ONNX_NAMESPACE::FunctionProto>{},
+                                         logger_);
 
   std::vector<onnxruntime::NodeArg*> input_args;
   std::vector<onnxruntime::NodeArg*> output_args;
 
   input_args.reserve(inputs.size());
-  output_args.reserve(outputs.size());
+  output_args.reserve(output_count);
 
-  Graph& graph = model.MainGraph();
-  std::unordered_map<std::string, OrtValue> initializer_map;
+  Graph& graph = entry->model->MainGraph();
   size_t i = 0;
 
-  for (auto input : inputs) {
+  // the inputs are graph inputs rather than initializers, so that the kernel does not treat them as constants
+  // and can be reused with other values
+  for (const auto& input : inputs) {
     std::string name = "I" + std::to_string(i++);
     const Tensor& input_tensor = input.Get<Tensor>();
     ONNX_NAMESPACE::TypeProto input_tensor_type;
     input_tensor_type.mutable_tensor_type()->set_elem_type(input_tensor.GetElementType());
     auto& arg = graph.GetOrCreateNodeArg(name, &input_tensor_type);
     input_args.push_back(&arg);
-    initializer_map[name] = input;
   }
 
-  for (i = 0; i < outputs.size(); ++i) {
+  for (i = 0; i < output_count; ++i) {
     auto& arg = graph.GetOrCreateNodeArg("O" + std::to_string(i), nullptr);
     output_args.push_back(&arg);
   }
@@ -61,36 +116,77 @@ common::Status ORTInvoker::Invoke(const std::string& op_name,
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   node.SetExecutionProviderType(execution_provider_->Type());
-  std::vector<const Node*> frame_nodes{&node};
 
-  OptimizerExecutionFrame::Info info({&node}, initializer_map, graph.ModelPath(), *execution_provider_, [](std::string const&) { return false; });
+  entry->is_sparse_initializer_func = [](std::string const&) { return false; };
+  entry->info = std::make_unique<OptimizerExecutionFrame::Info>(std::vector<const Node*>{&node},
+                                                                std::unordered_map<std::string, OrtValue>{},
+                                                                graph.ModelPath(), *execution_provider_,
+                                                                entry->is_sparse_initializer_func);
   const KernelCreateInfo* kernel_create_info = nullptr;
-  ORT_RETURN_IF_ERROR(info.TryFindKernel(&node, &kernel_create_info));
+  ORT_RETURN_IF_ERROR(entry->info->TryFindKernel(&node, &kernel_create_info));
   if (!kernel_create_info) {
     ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
   }
-  // check whether the inputs are contiguous tensor
-  const auto& may_strided_inputs = kernel_create_info->kernel_def->MayStridedInput();
-  for (i = 0; i < inputs.size(); ++i) {
-    const Tensor& input_tensor = inputs[i].Get<Tensor>();
-    if (!input_tensor.IsContiguous() && std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
-                                                  static_cast<int>(i)) == may_strided_inputs.end())
-      ORT_THROW("kernel name:", op_name, "'s ", i, "th input doesn't support non-contiguous tensor.");
-  }
 
-  auto kernel = info.CreateKernel(&node);
-  if (!kernel) {
+  entry->kernel = entry->info->CreateKernel(&node, ConfigOptions{});
+  if (!entry->kernel) {
     ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
   }
 
-  std::vector<int> fetch_mlvalue_idxs;
+  for (const auto* node_in : node.InputDefs()) {
+    entry->feed_mlvalue_idxs.push_back(entry->info->GetMLValueIndex(node_in->Name()));
+  }
+
   for (const auto* node_out : node.OutputDefs()) {
-    fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+    entry->fetch_mlvalue_idxs.push_back(entry->info->GetMLValueIndex(node_out->Name()));
+  }
+
+  cached_kernel = std::move(entry);
+  return Status::OK();
+}
+
+common::Status ORTInvoker::Invoke(const std::string& op_name,
+                                  // optional inputs / outputs?
+                                  const std::vector<OrtValue>& inputs,
+                                  std::vector<OrtValue>& outputs,
+                                  const NodeAttributes* attributes,
+                                  const std::string& domain,
+                                  const int version) {
+  // repeated invocations of an op skip the graph construction and kernel creation
+  const std::string key = GetKernelCacheKey(op_name, inputs, outputs.size(), attributes, domain, version);
+  const CachedKernel* cached_kernel = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+    auto it = kernel_cache_.find(key);
+    if (it != kernel_cache_.end()) {
+      cached_kernel = it->second.get();
+    }
+  }
+
+  if (cached_kernel == nullptr) {
+    std::unique_ptr<CachedKernel> new_kernel;
+    ORT_RETURN_IF_ERROR(CreateCachedKernel(op_name, inputs, outputs.size(), attributes, domain, version, new_kernel));
+
+    // another thread may have created the same kernel in the meantime, in which case that one is used
+    std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+    cached_kernel = kernel_cache_.try_emplace(key, std::move(new_kernel)).first->second.get();
+  }
+
+  const OpKernel& kernel = *cached_kernel->kernel;
+
+  // check whether the inputs are contiguous tensor
+  const auto& may_strided_inputs = kernel.KernelDef().MayStridedInput();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const Tensor& input_tensor = inputs[i].Get<Tensor>();
+    if (!input_tensor.IsContiguous() && std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
+                                                  static_cast<int>(i)) == may_strided_inputs.end())
+      ORT_THROW("kernel name:", op_name, "'s ", i, "th input doesn't support non-contiguous tensor.");
   }
 
-  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs, outputs);
-  OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, nullptr, logger_);
-  ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+  OptimizerExecutionFrame frame(*cached_kernel->info, cached_kernel->feed_mlvalue_idxs, inputs,
+                                cached_kernel->fetch_mlvalue_idxs, outputs);
+  OpKernelContext op_kernel_context(&frame, &kernel, nullptr, nullptr, logger_);
+  ORT_RETURN_IF_ERROR(kernel.Compute(&op_kernel_context));
 
   return frame.GetOutputs(outputs);
 }
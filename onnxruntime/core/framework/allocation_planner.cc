@@ -98,6 +98,7 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.view_of != -1) out << " view of " << elt_plan.view_of;
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
     } else {
@@ -117,6 +118,15 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     out << "End logic stream : " << i << std::endl;
   }
 
+  if (!plan.memory_aware_node_order.empty()) {
+    out << "\nMemory aware node order:\n";
+    const auto& graph_viewer = session_state.GetGraphViewer();
+    for (auto node_index : plan.memory_aware_node_order) {
+      const auto* node = graph_viewer.GetNode(node_index);
+      out << "(" << node_index << ")" << (node != nullptr ? node->Name() : std::string{}) << std::endl;
+    }
+  }
+
   return out;
 }
 
@@ -293,14 +303,170 @@ class PlannerImpl {
   }
 #endif
 
+  // Record that a value uses the buffer of an input the kernel updates in place, so it doesn't need its own buffer.
+  void RecordInplaceReuse(const onnxruntime::NodeArg& output_arg) {
+    ++plan_.inplace_reuse_stats.num_values;
+    const auto* shape = context_->GetShape(output_arg);
+    if (shape == nullptr || IsNonTensor(output_arg)) {
+      return;
+    }
+
+    SafeInt<size_t> num_bytes = GetElementSize(output_arg.Type());
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim)) {
+        // the size of values with a symbolic shape is only known at runtime.
+        return;
+      }
+      num_bytes *= dim.dim_value();
+    }
+
+    plan_.inplace_reuse_stats.num_bytes += num_bytes;
+  }
+
+  // The order the nodes are planned and executed in.
+  const std::vector<NodeIndex>& NodeOrder() const {
+    return plan_.memory_aware_node_order.empty() ? graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder())
+                                                 : plan_.memory_aware_node_order;
+  }
+
+  // Estimated size of the value in bytes. Symbolic dimensions count as 1, non-tensors as 0.
+  size_t EstimatedSizeInBytes(const onnxruntime::NodeArg& arg) const {
+    if (!arg.Exists() || arg.Type() == nullptr || IsNonTensor(arg)) {
+      return 0;
+    }
+
+    SafeInt<size_t> num_bytes = GetElementSize(arg.Type());
+    const auto* shape = context_->GetShape(arg);
+    if (shape != nullptr) {
+      for (const auto& dim : shape->dim()) {
+        if (utils::HasDimValue(dim) && dim.dim_value() > 0) {
+          num_bytes *= dim.dim_value();
+        }
+      }
+    }
+    return num_bytes;
+  }
+
+  // Greedy topological sort that keeps the live set small: among the nodes whose producers have all run, pick the one
+  // that grows the live set the least, i.e. the size of its outputs minus the size of the values it consumes last.
+  // Ties are broken by the position in the order given by the execution order, so a graph without any choice keeps it.
+  void ComputeMemoryAwareNodeOrder() {
+    const auto& base_order = graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder());
+
+    InlinedHashMap<NodeIndex, size_t> position;
+    position.reserve(base_order.size());
+    for (size_t i = 0; i < base_order.size(); ++i) {
+      position[base_order[i]] = i;
+    }
+
+    // number of in-graph producers (including control edges) each node still waits for.
+    std::vector<size_t> pending_inputs(base_order.size(), 0);
+    // number of nodes that still have to consume each value produced by a node of this graph.
+    InlinedHashMap<const NodeArg*, size_t> pending_consumers;
+    InlinedHashSet<const NodeArg*> graph_outputs(graph_viewer_.GetOutputs().begin(), graph_viewer_.GetOutputs().end());
+
+    auto for_each_distinct_input = [](const Node& node, auto&& func) {
+      InlinedHashSet<const NodeArg*> seen;
+      for (const auto* defs : {&node.InputDefs(), &node.ImplicitInputDefs()}) {
+        for (const auto* arg : *defs) {
+          if (arg->Exists() && seen.insert(arg).second) {
+            func(*arg);
+          }
+        }
+      }
+    };
+
+    for (size_t i = 0; i < base_order.size(); ++i) {
+      const auto* node = graph_viewer_.GetNode(base_order[i]);
+      for (auto it = node->InputEdgesBegin(), end = node->InputEdgesEnd(); it != end; ++it) {
+        if (position.count(it->GetNode().Index()) > 0) {
+          ++pending_inputs[i];
+        }
+      }
+      for (const auto* output : node->OutputDefs()) {
+        if (output->Exists()) {
+          pending_consumers[output] = 0;
+        }
+      }
+    }
+    for (auto node_index : base_order) {
+      for_each_distinct_input(*graph_viewer_.GetNode(node_index), [&pending_consumers](const NodeArg& arg) {
+        auto it = pending_consumers.find(&arg);
+        if (it != pending_consumers.end()) {
+          ++it->second;
+        }
+      });
+    }
+
+    auto live_set_growth = [&](const Node& node) {
+      int64_t growth = 0;
+      for (const auto* output : node.OutputDefs()) {
+        growth += static_cast<int64_t>(EstimatedSizeInBytes(*output));
+      }
+      for_each_distinct_input(node, [&](const NodeArg& arg) {
+        auto it = pending_consumers.find(&arg);
+        if (it != pending_consumers.end() && it->second == 1 && graph_outputs.count(&arg) == 0) {
+          growth -= static_cast<int64_t>(EstimatedSizeInBytes(arg));
+        }
+      });
+      return growth;
+    };
+
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < base_order.size(); ++i) {
+      if (pending_inputs[i] == 0) {
+        ready.push_back(i);
+      }
+    }
+
+    std::vector<NodeIndex> node_order;
+    node_order.reserve(base_order.size());
+    while (!ready.empty()) {
+      size_t best = 0;
+      int64_t best_growth = live_set_growth(*graph_viewer_.GetNode(base_order[ready[0]]));
+      for (size_t r = 1; r < ready.size(); ++r) {
+        int64_t growth = live_set_growth(*graph_viewer_.GetNode(base_order[ready[r]]));
+        if (growth < best_growth || (growth == best_growth && ready[r] < ready[best])) {
+          best = r;
+          best_growth = growth;
+        }
+      }
+
+      const size_t pos = ready[best];
+      ready.erase(ready.begin() + best);
+      const auto* node = graph_viewer_.GetNode(base_order[pos]);
+      node_order.push_back(node->Index());
+
+      for_each_distinct_input(*node, [&pending_consumers](const NodeArg& arg) {
+        auto it = pending_consumers.find(&arg);
+        if (it != pending_consumers.end()) {
+          --it->second;
+        }
+      });
+      for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
+        auto consumer = position.find(it->GetNode().Index());
+        if (consumer != position.end() && --pending_inputs[consumer->second] == 0) {
+          ready.push_back(consumer->second);
+        }
+      }
+    }
+
+    ORT_ENFORCE(node_order.size() == base_order.size(), "Memory aware node order did not schedule all the nodes.");
+    plan_.memory_aware_node_order = std::move(node_order);
+  }
+
   // Find if there exists some input tensor that we can use in-place for output_arg_num-th output in the node.
+  // is_inplace is set if the input is updated in place by the kernel, i.e. it is not an alias of the output.
+  // is_view is set if the output is a view of a contiguous sub-range of the input.
   bool FindReusableInput(const GraphViewer& graph, const onnxruntime::Node& node, int output_arg_num,
-                         OrtValueIndex* reusable_input, bool* is_strided_tensor) {
+                         OrtValueIndex* reusable_input, bool* is_strided_tensor, bool* is_inplace, bool* is_view) {
 #if defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
     ORT_UNUSED_PARAMETER(graph);
 #endif
 
     *is_strided_tensor = false;
+    *is_inplace = false;
+    *is_view = false;
 #ifdef ENABLE_TRAINING
     // Inputs of Yields are essentially the outputs for FW partial subgraph
     // These tensors will be passed back to pytorch, thus cannot share the buffer with other tensors
@@ -393,6 +559,7 @@ class PlannerImpl {
                 if (SameSize(*p_input_arg, *p_output_arg)) {
                   // we can reuse this input since it is its last use and permitted for in-place update
                   *reusable_input = input_arg_index;  // or original; both should be okay
+                  *is_inplace = true;
                   return true;
                 }
               } else {
@@ -407,6 +574,22 @@ class PlannerImpl {
       }
     }
 
+    const auto& may_view_outputs_of = ci.kernel_def->MayViewOutputs();
+    if (may_view_outputs_of.has_value() && static_cast<size_t>(*may_view_outputs_of) < input_args.size() &&
+        input_args[*may_view_outputs_of]->Exists() &&
+        IsContiguousSubRange(node, *input_args[*may_view_outputs_of], *p_output_arg)) {
+      bool need_skip = false;
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+      const Node* producer_node = graph.GetProducerNode(input_args[*may_view_outputs_of]->Name());
+      need_skip = producer_node && HasExternalOutputs(*producer_node);
+#endif
+      if (!need_skip) {
+        *reusable_input = Index(input_args[*may_view_outputs_of]->Name());
+        *is_view = true;
+        return true;
+      }
+    }
+
 #ifdef ENABLE_STRIDED_TENSORS
     // If any output of the kernel can support strided tensor, and all its consumers' inputs also support
     // strided tensors at the corresponding position, this output will generate a strided tensor
@@ -460,6 +643,85 @@ class PlannerImpl {
     return false;
   }
 
+  // Whether the static shapes prove that `output` of a Split or Slice node is a contiguous sub-range of `input`.
+  bool IsContiguousSubRange(const Node& node, const NodeArg& input, const NodeArg& output) const {
+    const auto* input_shape = context_->GetShape(input);
+    const auto* output_shape = context_->GetShape(output);
+    if (input_shape == nullptr || output_shape == nullptr || input_shape->dim_size() == 0 ||
+        input_shape->dim_size() != output_shape->dim_size() || node.Domain() != kOnnxDomain) {
+      return false;
+    }
+    const int rank = input_shape->dim_size();
+
+    if (node.OpType() == "Split") {
+      // the outputs are contiguous if all the dims before the split axis have a single element
+      const auto& attributes = node.GetAttributes();
+      const auto axis_attr = attributes.find("axis");
+      int64_t axis = axis_attr != attributes.end() ? axis_attr->second.i() : 0;
+      if (axis < 0) {
+        axis += rank;
+      }
+      if (axis < 0 || axis >= rank) {
+        return false;
+      }
+      for (int i = 0; i < static_cast<int>(axis); ++i) {
+        const auto& dim = input_shape->dim(i);
+        if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    if (node.OpType() == "Slice") {
+      // the steps must all be 1 for the output dims to describe the region
+      const auto& input_defs = node.InputDefs();
+      if (input_defs.size() > 4 && input_defs[4]->Exists()) {
+        const auto* steps = graph_viewer_.GetConstantInitializer(input_defs[4]->Name(), true);
+        std::vector<uint8_t> unpacked;
+        if (steps == nullptr ||
+            (steps->data_type() != TensorProto_DataType_INT64 && steps->data_type() != TensorProto_DataType_INT32) ||
+            !utils::UnpackInitializerData(*steps, unpacked).IsOK()) {
+          return false;
+        }
+        const bool is_int64 = steps->data_type() == TensorProto_DataType_INT64;
+        const size_t count = unpacked.size() / (is_int64 ? sizeof(int64_t) : sizeof(int32_t));
+        for (size_t i = 0; i < count; ++i) {
+          const int64_t step = is_int64 ? reinterpret_cast<const int64_t*>(unpacked.data())[i]
+                                        : reinterpret_cast<const int32_t*>(unpacked.data())[i];
+          if (step != 1) {
+            return false;
+          }
+        }
+      }
+
+      // the region is contiguous if the dims before the first sliced one have a single element and the dims after it
+      // are not sliced
+      int axis = 0;
+      for (; axis < rank; ++axis) {
+        const auto& input_dim = input_shape->dim(axis);
+        const auto& output_dim = output_shape->dim(axis);
+        if (!utils::HasDimValue(input_dim) || !utils::HasDimValue(output_dim) || output_dim.dim_value() == 0) {
+          return false;
+        }
+        if (output_dim.dim_value() != 1) {
+          break;
+        }
+      }
+      for (int i = axis + 1; i < rank; ++i) {
+        const auto& input_dim = input_shape->dim(i);
+        const auto& output_dim = output_shape->dim(i);
+        if (!utils::HasDimValue(input_dim) || !utils::HasDimValue(output_dim) ||
+            input_dim.dim_value() != output_dim.dim_value()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    return false;
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -1286,6 +1548,8 @@ class PlannerImpl {
                       value_consumer_map[input_arg_index].insert(value_consumer_map[output_idx_global].begin(),
                                                                  value_consumer_map[output_idx_global].end());
                       reused.insert(input_arg_index);
+                      RecordInplaceReuse(*p_output_arg);
+                      found_reusable = true;
                     }
                   }
                 } else {
@@ -1297,6 +1561,11 @@ class PlannerImpl {
               }
             }
           }
+
+          // a kernel may allow several inputs to be in-place with the output. only one of them can be used.
+          if (found_reusable) {
+            break;
+          }
         }
       }
     };  // TryReuseInput
@@ -1498,6 +1767,8 @@ class PlannerImpl {
         // The the OrtValue indexed by current may reuse the memory in the OrtValue indexed by reused.
         OrtValueIndex reused;
         bool is_strided_tensor = false;
+        bool is_inplace = false;
+        bool is_view = false;
         if (has_external_outputs) {
           ORT_ENFORCE(!IsNonTensor(*node_output), "Only tensors are supported for external outputs for now.");
           AllocPlan(current).alloc_kind = AllocKind::kAllocatedExternally;
@@ -1539,12 +1810,19 @@ class PlannerImpl {
           }
         } else if (!context_->IsParallelExecutionEnabled() &&
                    FindReusableInput(graph_viewer_, *pnode, static_cast<int>(output_arg_def_index),
-                                     &reused, &is_strided_tensor)) {
+                                     &reused, &is_strided_tensor, &is_inplace, &is_view)) {
           // Re-using inputs is applicable for tensors, sequence tensors,
           // and optional types if the kernel has marked certain inputs as
           // possible candidates for re-use
           Reuse(reused, current, AllocKind::kReuse);
+          // the data of a view does not start at its buffer, so the aliases of a view start at the data of the view
+          if (is_view || AllocPlan(reused).view_of != -1) {
+            AllocPlan(current).view_of = reused;
+          }
           ort_value_info_[current].is_inplace_reuse = true;
+          if (is_inplace) {
+            RecordInplaceReuse(*node_output);
+          }
 #ifdef ENABLE_STRIDED_TENSORS
           if (is_strided_tensor) AllocPlan(current).is_strided_tensor = true;
 #else
@@ -1681,7 +1959,7 @@ class PlannerImpl {
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   void CalculateLifetime(std::vector<int>& ort_value_usecount) {
-    auto& execution_plan = graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder());
+    auto& execution_plan = NodeOrder();
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
       auto node_index = execution_plan[program_counter];
       // the node (aka operator) which carries the considered program (aka computation).
@@ -1854,7 +2132,9 @@ class PlannerImpl {
             break;
           }
         }
-        if (is_all_consumer_same_stream) {
+        // with parallel execution the nodes of a stream may run concurrently (see ParallelNodeScheduler),
+        // so the last consumer in stream order is not necessarily the last one to finish.
+        if (is_all_consumer_same_stream && !context_->IsParallelExecutionEnabled()) {
           // all the consumers are on the same stream, so the first element is the last consumer int the stream.
           process_consumer(release_action_idx, ortvalue_to_consumers_map[i][0]);
         } else {
@@ -1875,7 +2155,9 @@ class PlannerImpl {
     if (graph_viewer_.NumberOfNodes() > 0) {
       stream_nodes_.push_back({});
       plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
-      for (auto node_index : graph_viewer_.GetNodesInTopologicalOrder()) {
+      const auto& node_order = plan_.memory_aware_node_order.empty() ? graph_viewer_.GetNodesInTopologicalOrder()
+                                                                     : plan_.memory_aware_node_order;
+      for (auto node_index : node_order) {
         stream_nodes_[0].push_back(node_index);
         plan_.node_stream_map_[node_index] = 0;
       }
@@ -1918,8 +2200,10 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
-    auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
+    // subgraphs run on the streams of their parent node, so only the main graph is spread over several streams.
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(
+        logger, partition_config_file, parent_node_ ? 1 : context_->GetMaxStreamsPerDevice());
+    auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, NodeOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
     for (size_t i = 0; i < stream_nodes_.size(); ++i) {
@@ -1960,7 +2244,7 @@ class PlannerImpl {
     // before yieldOp thus will be executed in RunForward()
     // But the final result is still correct, as long as all the nodes will be executed in either RunForward() or RunBackward()
     // and no dependency conflict during the execution.
-    const std::vector<NodeIndex>& topo_sort = graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder());
+    const std::vector<NodeIndex>& topo_sort = NodeOrder();
     plan_.node_index_2_toposort_index.reserve(topo_sort.size());
     size_t yieldOp_index_in_toposort = topo_sort.size();
     for (size_t i = 0; i < topo_sort.size(); i++) {
@@ -2130,7 +2414,7 @@ class PlannerImpl {
       }
     }
 
-    for (auto node_index : graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder())) {
+    for (auto node_index : NodeOrder()) {
       auto* node = graph_viewer_.GetNode(node_index);
       const auto& output_defs = node->OutputDefs();
       for (size_t output_idx_local = 0; output_idx_local < output_defs.size(); ++output_idx_local) {
@@ -2167,7 +2451,7 @@ class PlannerImpl {
     }
 
     InlinedHashSet<OrtValueIndex> producable_values;
-    for (auto node_index : graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder())) {
+    for (auto node_index : NodeOrder()) {
       auto* node = graph_viewer_.GetNode(node_index);
       // add the output to produce nodes list
       for (auto* output_def : node->OutputDefs()) {
@@ -2226,7 +2510,7 @@ class PlannerImpl {
       }
     };
 
-    auto num_of_nodes = graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder()).size();
+    auto num_of_nodes = NodeOrder().size();
     plan_.node_execution_order_in_training.reserve(num_of_nodes);
     for (size_t i = 0; i < stream_nodes_.size(); ++i) {
       process_stream(i, -1);
@@ -2284,6 +2568,11 @@ Status PlannerImpl::CreatePlan(
 #endif
     const PathString& partition_config_file,
     const logging::Logger& logger) {
+  // 0. pick the node order. the memory efficient order of training already optimizes for memory.
+  if (context_->UseMemoryAwareNodeOrder() && context_->GetExecutionOrder() != ExecutionOrder::MEMORY_EFFICIENT) {
+    ComputeMemoryAwareNodeOrder();
+  }
+
   // 1. partition graph into streams
   PartitionIntoStreams(logger, execution_providers_, this->parent_node_ ? PathString{} : partition_config_file);
 
@@ -2316,6 +2605,12 @@ Status PlannerImpl::CreatePlan(
   ORT_RETURN_IF_ERROR(ComputeAllocationOrder());
 #endif
 
+  if (plan_.inplace_reuse_stats.num_values > 0) {
+    LOGS(logger, INFO) << plan_.inplace_reuse_stats.num_values << " values are computed in place in the buffer of a "
+                       << "kernel input, saving " << plan_.inplace_reuse_stats.num_bytes
+                       << " bytes for values with a static shape.";
+  }
+
   // convert information in the freelist_ into a deallocation plan in required format
   ORT_RETURN_IF_ERROR(GenerateDeallocationPlan());
 
@@ -2364,6 +2659,88 @@ Status SequentialPlanner::CreatePlan(
       logger);
 }
 
+Status StaticMemoryPlanner::CreatePatterns(gsl::span<const StaticMemoryPlanValue> values,
+                                           MemoryPatternGroup& output) {
+  struct PlacedValue {
+    const StaticMemoryPlanValue* value;
+    size_t offset;
+  };
+
+  InlinedVector<OrtDevice> locations;
+  std::vector<std::vector<const StaticMemoryPlanValue*>> values_per_location;
+  for (const auto& value : values) {
+    ORT_RETURN_IF_NOT(value.first_step <= value.last_step, "Invalid lifetime for OrtValue ", value.index);
+    auto it = std::find(locations.begin(), locations.end(), value.location);
+    if (it == locations.end()) {
+      locations.push_back(value.location);
+      values_per_location.emplace_back();
+      it = locations.end() - 1;
+    }
+    values_per_location[it - locations.begin()].push_back(&value);
+  }
+
+  for (size_t l = 0; l < locations.size(); ++l) {
+    auto& to_place = values_per_location[l];
+    // largest first. ties are broken by lifetime then index so the result is deterministic.
+    std::sort(to_place.begin(), to_place.end(),
+              [](const StaticMemoryPlanValue* a, const StaticMemoryPlanValue* b) {
+                if (a->size != b->size) return a->size > b->size;
+                if (a->first_step != b->first_step) return a->first_step < b->first_step;
+                return a->index < b->index;
+              });
+
+    std::vector<PlacedValue> placed;
+    placed.reserve(to_place.size());
+    std::vector<const PlacedValue*> conflicts;
+    InlinedHashMap<int, MemoryBlock> blocks;
+    blocks.reserve(to_place.size());
+    size_t peak_size = 0;
+
+    for (const auto* value : to_place) {
+      conflicts.clear();
+      for (const auto& other : placed) {
+        if (value->first_step <= other.value->last_step && other.value->first_step <= value->last_step) {
+          conflicts.push_back(&other);
+        }
+      }
+
+      std::sort(conflicts.begin(), conflicts.end(),
+                [](const PlacedValue* a, const PlacedValue* b) { return a->offset < b->offset; });
+
+      // best fit among the gaps between live values, otherwise after the last of them
+      size_t current = 0;
+      size_t best_offset = 0;
+      size_t waste_bytes = std::numeric_limits<size_t>::max();
+      bool best_offset_found = false;
+      for (const auto* other : conflicts) {
+        if (other->offset >= current) {
+          const size_t gap = other->offset - current;
+          if (gap >= value->size && gap - value->size < waste_bytes) {
+            waste_bytes = gap - value->size;
+            best_offset = current;
+            best_offset_found = true;
+          }
+        }
+
+        current = std::max(current, other->offset + other->value->size);
+      }
+
+      if (!best_offset_found) {
+        best_offset = current;
+      }
+
+      peak_size = std::max(peak_size, static_cast<size_t>(SafeInt<size_t>(best_offset) + value->size));
+      placed.push_back(PlacedValue{value, best_offset});
+      blocks.insert_or_assign(value->index, MemoryBlock(best_offset, value->size));
+    }
+
+    output.locations.push_back(locations[l]);
+    output.patterns.emplace_back(std::move(blocks), peak_size);
+  }
+
+  return Status::OK();
+}
+
 #ifdef ORT_ENABLE_STREAM
 /*
 DeviceBasedPartitioner stores config in json format:
@@ -2381,11 +2758,18 @@ DeviceBasedPartitioner stores config in json format:
 "streams" specifies streams of nodes;
 "devices" specifies the type of device of each stream.
 Pls check definition of OrtDevice for more detail on device type.
+
+Without a config, the nodes of a CPU device go to one stream, and the nodes of any other device are spread over up to
+max_streams_per_device streams: a node continues the stream of its first producer on the same device unless another
+consumer of that producer already did, so every independent branch starts a new stream. When the device has no
+stream left, the branch goes to the stream of the device with the lowest estimated cost so far.
 */
 class DeviceBasedPartitioner : public IGraphPartitioner {
  public:
   DeviceBasedPartitioner(const logging::Logger& logger,
-                         const PathString& config_file) : IGraphPartitioner(logger, config_file) {
+                         const PathString& config_file,
+                         size_t max_streams_per_device) : IGraphPartitioner(logger, config_file),
+                                                          max_streams_per_device_(max_streams_per_device) {
     Initialize();
   }
 
@@ -2399,7 +2783,7 @@ class DeviceBasedPartitioner : public IGraphPartitioner {
   Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                         const ExecutionProviders& execution_providers,
                         std::vector<InlinedVector<NodeIndex>>& stream_nodes,
-                        ExecutionOrder execution_order) override;
+                        const std::vector<NodeIndex>& node_order) override;
 
   const char* Type() const override { return "DeviceBasedPartitioner"; }
   size_t Streams() const override { return node_names_by_stream_.size(); }
@@ -2410,6 +2794,7 @@ class DeviceBasedPartitioner : public IGraphPartitioner {
   std::vector<OrtDevice::DeviceType> device_types_;
   std::vector<InlinedVector<std::string>> node_names_by_stream_;
   bool need_save_ = false;
+  size_t max_streams_per_device_ = 1;
 };
 
 #define EXIT_ON_ERR(warning)         \
@@ -2421,13 +2806,18 @@ class DeviceBasedPartitioner : public IGraphPartitioner {
 Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                               const ExecutionProviders& execution_providers,
                                               std::vector<InlinedVector<NodeIndex>>& stream_nodes,
-                                              ExecutionOrder execution_order) {
+                                              const std::vector<NodeIndex>& node_order) {
   InlinedHashMap<std::string, int> op_type_counter;
-  auto& p_graph_nodes = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  auto& p_graph_nodes = node_order;
 
   if (node_names_by_stream_.empty()) {  // input configure empty, do it from scratch
 
-    InlinedHashMap<OrtDevice::DeviceType, int> device_to_stream;
+    InlinedHashMap<OrtDevice::DeviceType, InlinedVector<size_t>> device_to_streams;
+    InlinedHashMap<NodeIndex, size_t> node_to_stream;
+    // producers whose stream has been continued by one of their consumers
+    InlinedHashSet<NodeIndex> continued_producers;
+    // estimated cost of the nodes in each stream
+    std::vector<size_t> stream_costs;
 
     for (auto node_index : p_graph_nodes) {
       // get device info of the node
@@ -2436,20 +2826,52 @@ Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& gr
       const auto& node_name = node->Name();
       auto* ep = execution_providers.Get(*node);
       auto device_type = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
+      const size_t max_streams = device_type == OrtDevice::CPU ? 1 : max_streams_per_device_;
+      auto& device_streams = device_to_streams[device_type];
 
-      // log the device
-      auto it = device_to_stream.find(device_type);
-      if (it == device_to_stream.end()) {
-        device_to_stream[device_type] = static_cast<int>(node_names_by_stream_.size());
+      size_t stream = node_names_by_stream_.size();
+      if (max_streams == 1 && !device_streams.empty()) {
+        stream = device_streams.front();
+      } else {
+        for (auto input_node = node->InputNodesBegin(); input_node != node->InputNodesEnd(); ++input_node) {
+          auto producer = node_to_stream.find(input_node->Index());
+          if (producer != node_to_stream.end() && device_types_[producer->second] == device_type &&
+              continued_producers.insert(producer->first).second) {
+            stream = producer->second;
+            break;
+          }
+        }
+        if (stream == node_names_by_stream_.size() && device_streams.size() >= max_streams) {
+          stream = *std::min_element(device_streams.begin(), device_streams.end(),
+                                     [&stream_costs](size_t a, size_t b) { return stream_costs[a] < stream_costs[b]; });
+        }
+      }
+
+      if (stream == node_names_by_stream_.size()) {
         node_names_by_stream_.push_back({});
         device_types_.push_back(device_type);
-        it = device_to_stream.find(device_type);
+        stream_costs.push_back(0);
+        device_streams.push_back(stream);
       }
+      node_to_stream[node_index] = stream;
+
+      // the elements of the outputs are the cost of the node, or 1 when their shapes are not known
+      size_t cost = 0;
+      for (const auto* output : node->OutputDefs()) {
+        if (output->Exists() && output->Shape() != nullptr) {
+          auto shape = utils::GetTensorShapeFromTensorShapeProto(*output->Shape());
+          if (shape.Size() > 0) {
+            cost += static_cast<size_t>(shape.Size());
+          }
+        }
+      }
+      stream_costs[stream] += std::max<size_t>(cost, 1);
+
       // put the node into the belonging stream
       if (node_name.empty()) {
-        node_names_by_stream_[it->second].push_back(op_type + std::to_string(op_type_counter[op_type]++));
+        node_names_by_stream_[stream].push_back(op_type + std::to_string(op_type_counter[op_type]++));
       } else {
-        node_names_by_stream_[it->second].push_back(node_name);
+        node_names_by_stream_[stream].push_back(node_name);
       }
     }
   }
@@ -2542,7 +2964,8 @@ void DeviceBasedPartitioner::SaveConfig() const {
 }
 
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
+                                                                             const PathString& config_file,
+                                                                             size_t max_streams_per_device) {
   // use device based partitioner by default
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
       IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
@@ -2565,7 +2988,7 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   }
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
-    return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+    return std::make_unique<DeviceBasedPartitioner>(logger, config_file, max_streams_per_device);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
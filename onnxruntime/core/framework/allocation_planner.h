@@ -27,6 +27,7 @@ std::string ComposeNestedSubgraphInfoKeyHelper(const std::string& base, size_t g
 
 class ExecutionProviders;
 struct KernelCreateInfo;
+struct MemoryPatternGroup;
 class KernelRegistryManager;
 class OrtValueNameIdxMap;
 class IStreamCommandHandleRegistry;
@@ -46,15 +47,26 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // If it returns true, planner orders the nodes to keep the estimated size of the live values small
+  // instead of following GetExecutionOrder(). see PlannerImpl::ComputeMemoryAwareNodeOrder
+  virtual bool UseMemoryAwareNodeOrder() const { return false; }
+
+  // Maximum number of streams the partitioner spreads the nodes of a non-CPU device over.
+  // see DeviceBasedPartitioner::PartitionGraph
+  virtual size_t GetMaxStreamsPerDevice() const { return 1; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           bool use_memory_aware_node_order = false, size_t max_streams_per_device = 1)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        use_memory_aware_node_order_(use_memory_aware_node_order),
+        max_streams_per_device_(max_streams_per_device) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +79,16 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  bool UseMemoryAwareNodeOrder() const override { return use_memory_aware_node_order_; }
+
+  size_t GetMaxStreamsPerDevice() const override { return max_streams_per_device_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  bool use_memory_aware_node_order_ = false;
+  size_t max_streams_per_device_ = 1;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -90,12 +108,14 @@ class IGraphPartitioner {
   virtual ~IGraphPartitioner() = default;
   // create the partition based on the partition type.
   // perform partition based on the user input when provided.
+  // without user input, the nodes of each non-CPU device are spread over up to max_streams_per_device streams.
   static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
-                                                                   const PathString& config_file);
+                                                                   const PathString& config_file,
+                                                                   size_t max_streams_per_device = 1);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
-                                ExecutionOrder execution_order) = 0;
+                                const std::vector<NodeIndex>& node_order) = 0;
   virtual const char* Type() const = 0;
   // return total number of streams
   virtual size_t Streams() const = 0;
@@ -130,4 +150,23 @@ class SequentialPlanner {
       std::optional<SequentialExecutionPlan>& plan);
 };
 
+// A tensor whose location, size and lifetime are all known when the session is initialized.
+// first_step and last_step are the execution steps that allocate and release the value, inclusive.
+struct StaticMemoryPlanValue {
+  OrtValueIndex index;
+  OrtDevice location;
+  size_t size;
+  size_t first_step;
+  size_t last_step;
+};
+
+// Computes offsets for all values up front instead of tracing a run. Values are placed largest first at the
+// offset with the least waste that doesn't overlap any already placed value whose lifetime intersects its own,
+// which is a greedy solution of the interval coloring problem. Considering all values at once typically produces
+// a smaller peak than MemPatternPlanner, which has to place each value in the order it is allocated.
+class StaticMemoryPlanner {
+ public:
+  static Status CreatePatterns(gsl::span<const StaticMemoryPlanValue> values, MemoryPatternGroup& output);
+};
+
 }  // namespace onnxruntime
@@ -114,12 +114,9 @@ void CPUAllocator::Free(void* p) {
 void* AllocateBufferWithOptions(IAllocator& alloc, size_t size, bool use_reserve, Stream* stream, WaitNotificationFn wait_fn) {
   if (use_reserve)
     return alloc.Reserve(size);
-  if (stream && alloc.Info().alloc_type == OrtArenaAllocator) {
+  if (stream && alloc.IsStreamAware()) {
 #ifdef ORT_ENABLE_STREAM
-    auto* stream_aware_alloc = StreamAwareArena::FromBFCArena(static_cast<BFCArena&>(alloc));
-    if (stream_aware_alloc) {
-      return stream_aware_alloc->AllocOnStream(size, stream, wait_fn);
-    }
+    return alloc.AllocOnStream(size, stream, wait_fn);
 #else
     ORT_UNUSED_PARAMETER(wait_fn);
 #endif  // ORT_ENABLE_STREAM
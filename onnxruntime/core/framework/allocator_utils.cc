@@ -11,6 +11,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/cpu_page_allocator.h"
 
 namespace onnxruntime {
 using namespace common;
@@ -32,6 +33,26 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int thread_cache_max_chunks = info.arena_cfg.thread_cache_max_chunks == -1
+                                      ? BFCArena::DEFAULT_THREAD_CACHE_MAX_CHUNKS
+                                      : info.arena_cfg.thread_cache_max_chunks;
+    int64_t shrink_half_life_ms = info.arena_cfg.shrink_half_life_ms == -1
+                                      ? BFCArena::DEFAULT_SHRINK_HALF_LIFE_MS
+                                      : info.arena_cfg.shrink_half_life_ms;
+    bool enable_tracing = info.arena_cfg.enable_tracing > 0;
+
+    // back the arena regions of the default CPU allocator with huge pages and/or NUMA local memory if requested
+    const bool use_huge_pages = info.arena_cfg.huge_page_size > 0;
+    const bool use_numa_node = info.arena_cfg.numa_node >= 0;
+    if ((use_huge_pages || use_numa_node) &&
+        strcmp(device_allocator->Info().name, CPU) == 0 &&
+        device_allocator->Info().device.MemType() == OrtDevice::MemType::DEFAULT) {
+      device_allocator = std::make_unique<CPUPageAllocator>(
+          device_allocator->Info(),
+          use_huge_pages ? static_cast<size_t>(info.arena_cfg.huge_page_size) : 0,
+          use_numa_node ? info.arena_cfg.numa_node : -1);
+    }
+
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -56,7 +77,10 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                              arena_extend_str,
                                              initial_chunk_size_bytes,
                                              max_dead_bytes_per_chunk,
-                                             initial_growth_chunk_size_bytes));
+                                             initial_growth_chunk_size_bytes,
+                                             max_power_of_two_extend_bytes,
+                                             shrink_half_life_ms,
+                                             enable_tracing));
 #else
       ORT_THROW("StreamAwareArena should be transparent to minimal build.");
 #endif
@@ -68,7 +92,10 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_chunks,
+                                     shrink_half_life_ms,
+                                     enable_tracing));
     }
   } else {
     return device_allocator;
@@ -3,16 +3,102 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include "core/platform/tracepoints.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <type_traits>
 
 namespace onnxruntime {
+
+struct BFCArena::ThreadCache {
+  struct CachedChunk {
+    void* ptr;
+    size_t size;  // usable size of the chunk, i.e. the rounded size of the request that took it from the arena
+  };
+
+  // Only accessed by the owning thread, or under lock_ once the owning thread has exited.
+  std::array<std::vector<CachedChunk>, kNumThreadCacheBins> free_chunks;
+  // Chunks handed out by this cache that have not been freed yet, mapped to their usable size.
+  std::unordered_map<const void*, size_t> live_chunks;
+
+  // Chunks from live_chunks that were freed by another thread directly into the shared bins.
+  // The owning thread drops them from live_chunks before it next looks a pointer up there.
+  OrtMutex remote_frees_mutex;
+  std::vector<const void*> remote_frees;
+  std::atomic<bool> has_remote_frees{false};
+};
+
+namespace {
+// Arenas with an enabled thread cache, keyed by their thread cache id.
+// Consulted on thread exit so that cached chunks are only handed back to arenas that are still alive.
+struct ThreadCacheArenaRegistry {
+  OrtMutex mutex;
+  std::unordered_map<uint64_t, BFCArena*> arenas;
+  uint64_t next_id = 1;
+};
+
+ThreadCacheArenaRegistry& GetThreadCacheArenaRegistry() {
+  static ThreadCacheArenaRegistry registry;
+  return registry;
+}
+
+thread_local const std::string* tracing_node_name = nullptr;
+
+void WriteJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+}  // namespace
+
+ArenaTracingNodeScope::ArenaTracingNodeScope(const std::string& node_name)
+    : previous_node_name_(tracing_node_name) {
+  tracing_node_name = &node_name;
+}
+
+ArenaTracingNodeScope::~ArenaTracingNodeScope() {
+  tracing_node_name = previous_node_name_;
+}
+
+const std::string* ArenaTracingNodeScope::CurrentNodeName() {
+  return tracing_node_name;
+}
+
+// The thread caches owned by the current thread, one per arena it has used.
+struct BFCArena::ThreadLocalCaches {
+  std::vector<std::pair<uint64_t, ThreadCache*>> entries;
+
+  ~ThreadLocalCaches() {
+    auto& registry = GetThreadCacheArenaRegistry();
+    std::lock_guard<OrtMutex> guard(registry.mutex);
+    for (auto& entry : entries) {
+      auto it = registry.arenas.find(entry.first);
+      if (it != registry.arenas.end()) {
+        it->second->RetireThreadCache(entry.second);
+      }
+    }
+  }
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int thread_cache_max_chunks,
+                   int64_t shrink_half_life_ms,
+                   bool enable_tracing)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,12 +111,19 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_cache_max_chunks_(thread_cache_max_chunks),
+      shrink_half_life_ms_(shrink_half_life_ms),
+      last_decay_time_(std::chrono::steady_clock::now()),
+      enable_tracing_(enable_tracing) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_cache_max_chunks: " << thread_cache_max_chunks_
+                     << " shrink_half_life_ms: " << shrink_half_life_ms_
+                     << " enable_tracing: " << enable_tracing_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -75,9 +168,23 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_chunks_ > 0) {
+    auto& registry = GetThreadCacheArenaRegistry();
+    std::lock_guard<OrtMutex> guard(registry.mutex);
+    thread_cache_arena_id_ = registry.next_id++;
+    registry.arenas[thread_cache_arena_id_] = this;
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (thread_cache_max_chunks_ > 0) {
+    // After this no exiting thread will touch our thread caches. Cached chunks are released with their regions below.
+    auto& registry = GetThreadCacheArenaRegistry();
+    std::lock_guard<OrtMutex> guard(registry.mutex);
+    registry.arenas.erase(thread_cache_arena_id_);
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -206,6 +313,8 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   LOGS_DEFAULT(INFO) << "Extended allocation by " << bytes << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
+  ORT_TRACEPOINT(arena_extend, this, bytes, stats_.total_allocated_bytes);
+  TraceAllocationEvent(rounded_bytes, bytes);
   LOGS_DEFAULT(INFO) << "Total allocated bytes: "
                      << stats_.total_allocated_bytes;
 
@@ -269,9 +378,141 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_max_chunks_ > 0 && size != 0) {
+    size_t rounded_bytes = RoundedBytes(size);
+    BinNum bin_num = BinNumForSize(rounded_bytes);
+    if (bin_num < kNumThreadCacheBins) {
+      ThreadCache& cache = GetThreadCache();
+      void* ptr = AllocateFromThreadCache(cache, bin_num, rounded_bytes);
+      if (ptr == nullptr) {
+        ptr = AllocateRawInternal(size, false, nullptr, false, nullptr, &cache);
+        cache.live_chunks[ptr] = rounded_bytes;
+      }
+      return ptr;
+    }
+  }
+
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+BFCArena::ThreadCache& BFCArena::GetThreadCache() {
+  static thread_local ThreadLocalCaches thread_local_caches;
+  for (auto& entry : thread_local_caches.entries) {
+    if (entry.first == thread_cache_arena_id_) {
+      return *entry.second;
+    }
+  }
+
+  // First use of this arena on the current thread. Drop entries for arenas that no longer exist.
+  {
+    auto& registry = GetThreadCacheArenaRegistry();
+    std::lock_guard<OrtMutex> guard(registry.mutex);
+    auto& entries = thread_local_caches.entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&registry](const std::pair<uint64_t, ThreadCache*>& entry) {
+                                   return registry.arenas.count(entry.first) == 0;
+                                 }),
+                  entries.end());
+  }
+
+  ThreadCache* cache = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    thread_caches_.push_back(std::make_unique<ThreadCache>());
+    cache = thread_caches_.back().get();
+  }
+
+  thread_local_caches.entries.emplace_back(thread_cache_arena_id_, cache);
+  return *cache;
+}
+
+void* BFCArena::AllocateFromThreadCache(ThreadCache& cache, BinNum bin_num, size_t rounded_bytes) {
+  auto& cached_chunks = cache.free_chunks[bin_num];
+  // Prefer the most recently freed chunk as it is the most likely to still be in the CPU cache.
+  for (auto it = cached_chunks.rbegin(); it != cached_chunks.rend(); ++it) {
+    if (it->size >= rounded_bytes) {
+      void* ptr = it->ptr;
+      cache.live_chunks[ptr] = it->size;
+      cached_chunks.erase(std::next(it).base());
+      return ptr;
+    }
+  }
+
+  return nullptr;
+}
+
+bool BFCArena::FreeToThreadCache(ThreadCache& cache, void* p) {
+  if (cache.has_remote_frees.load(std::memory_order_acquire)) {
+    std::lock_guard<OrtMutex> guard(cache.remote_frees_mutex);
+    for (const void* remote_free : cache.remote_frees) {
+      cache.live_chunks.erase(remote_free);
+    }
+    cache.remote_frees.clear();
+    cache.has_remote_frees.store(false, std::memory_order_relaxed);
+  }
+
+  auto it = cache.live_chunks.find(p);
+  if (it == cache.live_chunks.end()) {
+    // not allocated through this thread's cache
+    return false;
+  }
+
+  const size_t size = it->second;
+  cache.live_chunks.erase(it);
+
+  BinNum bin_num = BinNumForSize(size);
+  auto& cached_chunks = cache.free_chunks[bin_num];
+  cached_chunks.push_back({p, size});
+  if (cached_chunks.size() > static_cast<size_t>(thread_cache_max_chunks_)) {
+    // return the older half in one go to amortize the cost of taking the lock
+    FlushThreadCacheBin(cache, bin_num, (cached_chunks.size() + 1) / 2);
+  }
+
+  return true;
+}
+
+void BFCArena::FlushThreadCacheBin(ThreadCache& cache, BinNum bin_num, size_t num_chunks) {
+  auto& cached_chunks = cache.free_chunks[bin_num];
+  num_chunks = std::min(num_chunks, cached_chunks.size());
+  if (num_chunks == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    for (size_t i = 0; i < num_chunks; ++i) {
+      thread_cached_chunks_.erase(cached_chunks[i].ptr);
+      DeallocateRawInternal(cached_chunks[i].ptr);
+    }
+  }
+
+  cached_chunks.erase(cached_chunks.begin(), cached_chunks.begin() + num_chunks);
+}
+
+void BFCArena::FlushThreadCache(ThreadCache& cache) {
+  for (BinNum b = 0; b < kNumThreadCacheBins; b++) {
+    FlushThreadCacheBin(cache, b, cache.free_chunks[b].size());
+  }
+}
+
+void BFCArena::RetireThreadCache(ThreadCache* cache) {
+  FlushThreadCache(*cache);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  // Chunks the exiting thread still has handed out go back to the shared bins through the regular Free path.
+  for (auto it = thread_cached_chunks_.begin(); it != thread_cached_chunks_.end();) {
+    if (it->second == cache) {
+      it = thread_cached_chunks_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  thread_caches_.erase(std::remove_if(thread_caches_.begin(), thread_caches_.end(),
+                                      [cache](const std::unique_ptr<ThreadCache>& c) { return c.get() == cache; }),
+                       thread_caches_.end());
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -288,6 +529,7 @@ void* BFCArena::Reserve(size_t size) {
   stats_.num_allocs += 1;
   stats_.max_alloc_size = std::max<size_t>(static_cast<size_t>(stats_.max_alloc_size), size);
   stats_.max_bytes_in_use = std::max<int64_t>(static_cast<int64_t>(stats_.max_bytes_in_use), stats_.bytes_in_use);
+  decayed_high_water_mark_ = std::max(decayed_high_water_mark_, stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
   return ptr;
 }
@@ -312,7 +554,8 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                                     bool dump_log_on_failure,
                                     Stream* stream,
                                     bool enable_cross_stream_reusing,
-                                    WaitNotificationFn wait_fn) {
+                                    WaitNotificationFn wait_fn,
+                                    ThreadCache* thread_cache) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -326,6 +569,10 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   std::lock_guard<OrtMutex> lock(lock_);
+  if (enable_tracing_) {
+    allocation_size_histogram_[Log2FloorNonZero(num_bytes)]++;
+  }
+
   // search for a valid chunk
   auto* chunk = FindChunkPtr(bin_num,
                              rounded_bytes,
@@ -341,6 +588,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (stream)
         chunk->stream_timestamp = stream->GetCurrentTimestamp();
     }
+    if (thread_cache) {
+      thread_cached_chunks_[chunk->ptr] = thread_cache;
+    }
     return chunk->ptr;
   }
 
@@ -356,6 +606,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (chunk->stream == nullptr && stream) {
         chunk->stream = stream;
       }
+      if (thread_cache) {
+        thread_cached_chunks_[chunk->ptr] = thread_cache;
+      }
       return chunk->ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -364,6 +617,8 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
     }
   }
 
+  TraceAllocationEvent(rounded_bytes, 0);
+
   // We searched all bins for an existing free chunk to use and
   // couldn't find one.  This means we must have run out of memory,
   // Dump the memory log for analysis.
@@ -381,6 +636,120 @@ void BFCArena::GetStats(AllocatorStats* stats) {
   *stats = stats_;
 }
 
+void BFCArena::TraceAllocationEvent(size_t requested_bytes, size_t region_bytes) {
+  if (!enable_tracing_) {
+    return;
+  }
+
+  auto& events = region_bytes == 0 ? failed_allocation_events_ : extend_events_;
+  if (events.size() >= kMaxTracedEvents) {
+    num_dropped_events_++;
+    return;
+  }
+
+  const std::string* node_name = ArenaTracingNodeScope::CurrentNodeName();
+  events.push_back(AllocationEvent{requested_bytes, region_bytes, stats_.total_allocated_bytes,
+                                   node_name != nullptr ? *node_name : std::string()});
+}
+
+std::string BFCArena::GetReport() {
+  std::lock_guard<OrtMutex> lock(lock_);
+  const std::array<BinDebugInfo, kNumBins> bin_infos = get_bin_debug_info();
+
+  std::ostringstream out;
+  out << "{\"allocator\": ";
+  WriteJsonString(out, device_allocator_->Info().name);
+  out << ", \"device_id\": " << device_allocator_->Info().id
+      << ",\n \"config\": {\"arena_extend_strategy\": "
+      << (arena_extend_strategy_ == ArenaExtendStrategy::kSameAsRequested ? "\"kSameAsRequested\""
+                                                                           : "\"kNextPowerOfTwo\"")
+      << ", \"memory_limit\": " << memory_limit_
+      << ", \"initial_chunk_size_bytes\": " << initial_chunk_size_bytes_
+      << ", \"max_dead_bytes_per_chunk\": " << max_dead_bytes_per_chunk_
+      << ", \"initial_growth_chunk_size_bytes\": " << initial_growth_chunk_size_bytes_
+      << ", \"max_power_of_two_extend_bytes\": " << max_power_of_two_extend_bytes_
+      << ", \"thread_cache_max_chunks\": " << thread_cache_max_chunks_
+      << ", \"shrink_half_life_ms\": " << shrink_half_life_ms_ << "},\n"
+      << " \"stats\": {\"num_allocs\": " << stats_.num_allocs
+      << ", \"num_reserves\": " << stats_.num_reserves
+      << ", \"num_arena_extensions\": " << stats_.num_arena_extensions
+      << ", \"num_arena_shrinkages\": " << stats_.num_arena_shrinkages
+      << ", \"bytes_in_use\": " << stats_.bytes_in_use
+      << ", \"total_allocated_bytes\": " << stats_.total_allocated_bytes
+      << ", \"max_bytes_in_use\": " << stats_.max_bytes_in_use
+      << ", \"max_alloc_size\": " << stats_.max_alloc_size << "},\n";
+
+  // Free chunks are in the bin of their size, so each bin's largest free chunk is the last of its set.
+  size_t free_bytes = 0;
+  size_t largest_free_chunk = 0;
+  size_t waste = 0;
+  out << " \"bins\": [";
+  bool first = true;
+  for (BinNum bin_num = 0; bin_num < kNumBins; bin_num++) {
+    const BinDebugInfo& bin_info = bin_infos[bin_num];
+    if (bin_info.total_chunks_in_bin == 0) {
+      continue;
+    }
+
+    const Bin* b = BinFromIndex(bin_num);
+    const size_t bin_free_bytes = bin_info.total_bytes_in_bin - bin_info.total_bytes_in_use;
+    const size_t bin_largest_free_chunk = b->free_chunks.empty() ? 0 : ChunkFromHandle(*b->free_chunks.rbegin())->size;
+    free_bytes += bin_free_bytes;
+    largest_free_chunk = std::max(largest_free_chunk, bin_largest_free_chunk);
+    waste += bin_info.total_bytes_in_use - bin_info.total_requested_bytes_in_use;
+
+    out << (first ? "\n  " : ",\n  ") << "{\"bin_size\": " << b->bin_size
+        << ", \"chunks_in_use\": " << bin_info.total_chunks_in_use
+        << ", \"bytes_in_use\": " << bin_info.total_bytes_in_use
+        << ", \"requested_bytes_in_use\": " << bin_info.total_requested_bytes_in_use
+        << ", \"free_chunks\": " << b->free_chunks.size()
+        << ", \"free_bytes\": " << bin_free_bytes
+        << ", \"largest_free_chunk\": " << bin_largest_free_chunk << "}";
+    first = false;
+  }
+
+  out << "],\n \"num_regions\": " << region_manager_.regions().size()
+      << ", \"free_bytes\": " << free_bytes
+      << ", \"largest_free_chunk\": " << largest_free_chunk
+      << ", \"fragmentation\": "
+      << (free_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free_chunk) / static_cast<double>(free_bytes))
+      << ", \"bytes_in_use_not_requested\": " << waste
+      << ",\n \"tracing\": " << (enable_tracing_ ? "true" : "false");
+
+  if (enable_tracing_) {
+    out << ",\n \"allocation_size_histogram\": [";
+    first = true;
+    for (size_t i = 0; i < allocation_size_histogram_.size(); i++) {
+      if (allocation_size_histogram_[i] != 0) {
+        out << (first ? "" : ", ") << "{\"min_bytes\": " << (uint64_t{1} << i)
+            << ", \"count\": " << allocation_size_histogram_[i] << "}";
+        first = false;
+      }
+    }
+    out << "]";
+
+    auto write_events = [&out](const char* name, const std::vector<AllocationEvent>& events) {
+      out << ",\n \"" << name << "\": [";
+      for (size_t i = 0; i < events.size(); i++) {
+        out << (i == 0 ? "\n  " : ",\n  ") << "{\"requested_bytes\": " << events[i].requested_bytes;
+        if (events[i].region_bytes != 0) {
+          out << ", \"region_bytes\": " << events[i].region_bytes;
+        }
+        out << ", \"total_allocated_bytes\": " << events[i].total_allocated_bytes << ", \"node\": ";
+        WriteJsonString(out, events[i].node_name);
+        out << "}";
+      }
+      out << "]";
+    };
+    write_events("extensions", extend_events_);
+    write_events("failed_allocations", failed_allocation_events_);
+    out << ",\n \"num_dropped_events\": " << num_dropped_events_;
+  }
+
+  out << "}\n";
+  return out.str();
+}
+
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
                                                  const BFCArena::Bin::FreeChunkSet::iterator& citer,
                                                  size_t rounded_bytes,
@@ -408,6 +777,7 @@ BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* fr
   stats_.bytes_in_use += chunk->size;
   stats_.max_bytes_in_use =
       std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  decayed_high_water_mark_ = std::max(decayed_high_water_mark_, stats_.bytes_in_use);
   stats_.max_alloc_size =
       std::max<int64_t>(stats_.max_alloc_size, static_cast<int64_t>(chunk->size));
   return chunk;
@@ -496,6 +866,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_max_chunks_ > 0 && FreeToThreadCache(GetThreadCache(), p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -504,27 +879,69 @@ void BFCArena::Free(void* p) {
     stats_.total_allocated_bytes -= it->second;
     reserved_chunks_.erase(it);
   } else {
+    if (!thread_cached_chunks_.empty()) {
+      // Freed by a thread other than the one that allocated it through its cache.
+      // Tell the owner so it doesn't treat the pointer as one of its own anymore.
+      auto owner = thread_cached_chunks_.find(p);
+      if (owner != thread_cached_chunks_.end()) {
+        ThreadCache* cache = owner->second;
+        {
+          std::lock_guard<OrtMutex> guard(cache->remote_frees_mutex);
+          cache->remote_frees.push_back(p);
+          cache->has_remote_frees.store(true, std::memory_order_release);
+        }
+        thread_cached_chunks_.erase(owner);
+      }
+    }
+
     DeallocateRawInternal(p);
   }
 }
 
 Status BFCArena::Shrink() {
+  if (thread_cache_max_chunks_ > 0) {
+    FlushThreadCache(GetThreadCache());
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  FreeUnusedRegions(0);
+
+  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+
+  return Status::OK();
+}
+
+int64_t BFCArena::DecayedHighWaterMark() {
   std::lock_guard<OrtMutex> lock(lock_);
-  auto num_regions = region_manager_.regions().size();
-  std::vector<void*> region_ptrs;
-  std::vector<size_t> region_sizes;
-  region_ptrs.reserve(num_regions);
-  region_sizes.reserve(num_regions);
+  return decayed_high_water_mark_;
+}
+
+size_t BFCArena::FreeUnusedRegions(int64_t target_allocated_bytes) {
+  std::vector<std::pair<void*, size_t>> candidates;
+  candidates.reserve(region_manager_.regions().size());
 
   for (const auto& region : region_manager_.regions()) {
     if (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) {
-      region_ptrs.push_back(region.ptr());
-      region_sizes.push_back(region.memory_size());
+      candidates.emplace_back(region.ptr(), region.memory_size());
     }
   }
 
-  size_t i = 0;
-  for (void* region_ptr : region_ptrs) {
+  // free the largest regions first so that the target is reached releasing as few regions as possible
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const std::pair<void*, size_t>& a, const std::pair<void*, size_t>& b) {
+                     return a.second > b.second;
+                   });
+
+  size_t num_freed = 0;
+  for (const auto& candidate : candidates) {
+    void* region_ptr = candidate.first;
+    const auto shrink_size = candidate.second;
+    if (stats_.total_allocated_bytes <= target_allocated_bytes) {
+      break;
+    }
+
     bool deallocate_region = true;
     ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
     ChunkHandle h = region_begin_chunk;
@@ -540,9 +957,9 @@ Status BFCArena::Shrink() {
     }
 
     if (deallocate_region) {
-      auto shrink_size = region_sizes[i];
       stats_.num_arena_shrinkages += 1;
       stats_.total_allocated_bytes -= shrink_size;
+      ORT_TRACEPOINT(arena_shrink, this, shrink_size, stats_.total_allocated_bytes);
 
       LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
                             << shrink_size << " bytes. "
@@ -561,16 +978,35 @@ Status BFCArena::Shrink() {
       device_allocator_->Free(region_ptr);
       region_manager_.RemoveAllocationRegion(region_ptr);
       stats_.num_arena_extensions--;
+      ++num_freed;
     }
+  }
 
-    ++i;
+  return num_freed;
+}
+
+void BFCArena::MaybeShrinkToDecayedHighWaterMark() {
+  if (shrink_half_life_ms_ <= 0) {
+    return;
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  // re-evaluate a few times per half-life
+  const auto now = Now();
+  const int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_decay_time_).count();
+  if (elapsed_ms < std::max<int64_t>(1, shrink_half_life_ms_ / 4)) {
+    return;
+  }
 
-  return Status::OK();
+  last_decay_time_ = now;
+  const double decay = std::exp2(-static_cast<double>(elapsed_ms) / static_cast<double>(shrink_half_life_ms_));
+  decayed_high_water_mark_ = std::max(stats_.bytes_in_use,
+                                      static_cast<int64_t>(static_cast<double>(decayed_high_water_mark_) * decay));
+
+  if (stats_.total_allocated_bytes > decayed_high_water_mark_ &&
+      FreeUnusedRegions(decayed_high_water_mark_) > 0) {
+    // the arena is smaller now so restart growth from the initial growth size as Shrink() does
+    curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  }
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -580,6 +1016,8 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
 
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
+
+  MaybeShrinkToDecayedHighWaterMark();
 }
 
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
@@ -856,14 +1294,20 @@ StreamAwareArena::StreamAwareArena(std::unique_ptr<IAllocator> resource_allocato
                                    int initial_chunk_size_bytes,
                                    int max_dead_bytes_per_chunk,
                                    int initial_growth_chunk_size_bytes,
-                                   int64_t max_power_of_two_extend_bytes) : BFCArena(std::move(resource_allocator),
-                                                                                     total_memory,
-                                                                                     arena_extend_strategy,
-                                                                                     initial_chunk_size_bytes,
-                                                                                     max_dead_bytes_per_chunk,
-                                                                                     initial_growth_chunk_size_bytes,
-                                                                                     max_power_of_two_extend_bytes),
-                                                                            enable_cross_stream_reusing_(enable_cross_stream_sharing) {
+                                   int64_t max_power_of_two_extend_bytes,
+                                   int64_t shrink_half_life_ms,
+                                   bool enable_tracing)
+    : BFCArena(std::move(resource_allocator),
+               total_memory,
+               arena_extend_strategy,
+               initial_chunk_size_bytes,
+               max_dead_bytes_per_chunk,
+               initial_growth_chunk_size_bytes,
+               max_power_of_two_extend_bytes,
+               DEFAULT_THREAD_CACHE_MAX_CHUNKS,
+               shrink_half_life_ms,
+               enable_tracing),
+      enable_cross_stream_reusing_(enable_cross_stream_sharing) {
   arena_type_ = ArenaType::StreamAwareArena;
 }
 
@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -45,6 +48,23 @@ namespace onnxruntime {
 #endif
 
 class StreamAwareArena;
+
+// Names the node whose kernel runs on the current thread while the scope is alive, so that arenas with tracing
+// enabled can attribute the regions they allocate to it. The name must outlive the scope.
+class ArenaTracingNodeScope {
+ public:
+  explicit ArenaTracingNodeScope(const std::string& node_name);
+  ~ArenaTracingNodeScope();
+
+  // Returns the name of the innermost node in scope on the current thread, or nullptr if there is none.
+  static const std::string* CurrentNodeName();
+
+ private:
+  const std::string* previous_node_name_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ArenaTracingNodeScope);
+};
+
 // A memory allocator that implements a 'best-fit with coalescing'
 // algorithm.  This is essentially a very simple version of Doug Lea's
 // malloc (dlmalloc).
@@ -61,6 +81,9 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int DEFAULT_THREAD_CACHE_MAX_CHUNKS = 0;  // thread cache disabled
+  static const int64_t DEFAULT_SHRINK_HALF_LIFE_MS = 0;  // decay based shrinking disabled
+  static const bool DEFAULT_ENABLE_TRACING = false;
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +96,10 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int thread_cache_max_chunks = DEFAULT_THREAD_CACHE_MAX_CHUNKS,
+           int64_t shrink_half_life_ms = DEFAULT_SHRINK_HALF_LIFE_MS,
+           bool enable_tracing = DEFAULT_ENABLE_TRACING);
 
   ~BFCArena() override;
 
@@ -86,6 +112,8 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held in the calling thread's cache are returned to the arena first. Chunks cached by other threads
+  // are still considered in use.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -93,10 +121,22 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Returns the current value of the decaying high-water mark of bytes in use.
+  // Only maintained if the arena was created with a positive shrink_half_life_ms.
+  int64_t DecayedHighWaterMark();
+
   void* Reserve(size_t size) override;
 
   void GetStats(AllocatorStats* stats) override;
 
+  // Returns a JSON report of the state of the arena for tuning its configuration: the configuration, the stats,
+  // the chunks in use and free chunks of each bin, the largest free chunk and the fragmentation of the free memory
+  // (1 - largest free chunk / free bytes).
+  // If tracing is enabled it also contains the log2 histogram of the requested allocation sizes, the regions the
+  // arena allocated with the node that was running when each was allocated, and the allocations that failed.
+  // Allocations served by thread caches are not traced.
+  std::string GetReport();
+
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
@@ -108,16 +148,23 @@ class BFCArena : public IAllocator {
                               WaitNotificationFn /*wait_fn*/) const {}
 
  protected:
+  // Per-thread cache of freed chunks. See GetThreadCache().
+  struct ThreadCache;
+
   void* AllocateRawInternal(size_t num_bytes,
                             bool dump_log_on_failure,
                             Stream* stream,
                             bool enable_cross_stream_reusing,
-                            WaitNotificationFn wait_fn);
+                            WaitNotificationFn wait_fn,
+                            ThreadCache* thread_cache = nullptr);
 #ifdef ORT_ENABLE_STREAM
   // for any chunk that associated with target stream, reset it to default (nullptr in stream, timestamp 0)
   // perform coalesce if coalesce_flag is true
   void ResetChunkOnTargetStream(Stream* target_stream, bool coalesce_flag);
 #endif
+  // Clock the shrink policy measures the decay of the high-water mark with. Tests override it to control time.
+  virtual std::chrono::steady_clock::time_point Now() const { return std::chrono::steady_clock::now(); }
+
   ArenaType arena_type_;
 
  private:
@@ -131,6 +178,8 @@ class BFCArena : public IAllocator {
   using BinNum = int;
   static const int kInvalidBinNum = -1;
   static const int kNumBins = 21;
+  // Only chunks in the first kNumThreadCacheBins bins (i.e. smaller than 2MB) are kept in thread caches.
+  static const int kNumThreadCacheBins = 13;
 
   // Chunks point to memory.  Their prev/next pointers form a
   // doubly-linked list of addresses sorted by base address that
@@ -410,8 +459,20 @@ class BFCArena : public IAllocator {
   // Removes the chunk metadata represented by 'h'.
   void DeleteChunk(ChunkHandle h);
 
+  // Frees allocation regions in which no chunk is in use, largest first, while the total allocated bytes
+  // exceed 'target_allocated_bytes'. Returns the number of regions freed.
+  size_t FreeUnusedRegions(int64_t target_allocated_bytes);
+
+  // Amortized shrink policy. Decays the high-water mark of bytes in use with a half-life of shrink_half_life_ms_
+  // and frees unused regions that keep the total allocated bytes above it. Cheap to call frequently as it does
+  // nothing until a fraction of the half-life has passed since the last evaluation.
+  void MaybeShrinkToDecayedHighWaterMark();
+
   void DumpMemoryLog(size_t num_bytes);
 
+  // Records an Extend or a failed allocation if tracing is enabled. region_bytes is 0 for a failed allocation.
+  void TraceAllocationEvent(size_t requested_bytes, size_t region_bytes);
+
   ChunkHandle AllocateChunk();
   void DeallocateChunk(ChunkHandle h);
 
@@ -429,6 +490,26 @@ class BFCArena : public IAllocator {
   // Computes and returns a BinDebugInfo for each Bin.
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info();
 
+  // Optional per-thread cache in front of the shared bins.
+  //
+  // A chunk allocated through the cache stays 'in use' from the arena's point of view while the owning thread holds
+  // it, either handed out to the caller or parked in the thread's free list. Alloc/Free on the owning thread are
+  // served from the free list without taking lock_, and the free list is returned to the shared bins in batches
+  // once it grows past thread_cache_max_chunks_ entries for a bin.
+  //
+  // Note: RequestedSize() reports the size of the request that originally took the chunk from the shared bins.
+  struct ThreadLocalCaches;
+
+  // Returns the calling thread's cache for this arena, creating it on first use.
+  ThreadCache& GetThreadCache();
+  void* AllocateFromThreadCache(ThreadCache& cache, BinNum bin_num, size_t rounded_bytes);
+  bool FreeToThreadCache(ThreadCache& cache, void* p);
+  // Returns the first num_chunks chunks of the free list for bin_num to the shared bins.
+  void FlushThreadCacheBin(ThreadCache& cache, BinNum bin_num, size_t num_chunks);
+  void FlushThreadCache(ThreadCache& cache);
+  // Called on thread exit. Returns all cached chunks and destroys the cache.
+  void RetireThreadCache(ThreadCache* cache);
+
   // Structures immutable after construction
   size_t memory_limit_ = 0;
   ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
@@ -509,6 +590,33 @@ class BFCArena : public IAllocator {
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
 
+  const int thread_cache_max_chunks_;
+
+  const int64_t shrink_half_life_ms_;
+  // Peak of bytes_in_use, decayed by half every shrink_half_life_ms_. See MaybeShrinkToDecayedHighWaterMark().
+  int64_t decayed_high_water_mark_ = 0;
+  std::chrono::steady_clock::time_point last_decay_time_;
+  // Process-unique id used to find this arena's entry in the thread-local cache list. Ids are never reused.
+  uint64_t thread_cache_arena_id_ = 0;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+  // Owner of every chunk that was handed out by a thread cache and is still in use or cached.
+  std::unordered_map<const void*, ThreadCache*> thread_cached_chunks_;
+
+  // Tracing state, only updated if tracing is enabled. Guarded by lock_.
+  struct AllocationEvent {
+    size_t requested_bytes;
+    size_t region_bytes;
+    int64_t total_allocated_bytes;
+    std::string node_name;
+  };
+  static const size_t kMaxTracedEvents = 4096;
+  const bool enable_tracing_;
+  // Number of allocations with a requested size in [2^i, 2^(i+1)).
+  std::array<uint64_t, 64> allocation_size_histogram_{};
+  std::vector<AllocationEvent> extend_events_;
+  std::vector<AllocationEvent> failed_allocation_events_;
+  size_t num_dropped_events_ = 0;
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
@@ -526,14 +634,18 @@ class StreamAwareArena : public BFCArena {
                    int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
                    int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
                    int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-                   int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+                   int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                   int64_t shrink_half_life_ms = DEFAULT_SHRINK_HALF_LIFE_MS,
+                   bool enable_tracing = DEFAULT_ENABLE_TRACING);
 
   // If size is 0, then this function returns either NULL,
   // or a unique pointer value that can later be successfully
   // passed to free(). Whatever, do not dereference that pointer
-  void* AllocOnStream(size_t size, Stream* current_stream_id, WaitNotificationFn wait_fn);
+  void* AllocOnStream(size_t size, Stream* current_stream_id, WaitNotificationFn wait_fn) override;
+
+  void ReleaseStreamBuffers(Stream* stream) override;
 
-  void ReleaseStreamBuffers(Stream* stream);
+  bool IsStreamAware() const override { return true; }
 
   static StreamAwareArena* FromBFCArena(BFCArena& arena) {
     return arena.GetArenaType() == ArenaType::StreamAwareArena ? reinterpret_cast<StreamAwareArena*>(&arena) : nullptr;
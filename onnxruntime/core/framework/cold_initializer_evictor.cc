@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/cold_initializer_evictor.h"
+
+#include "core/framework/tensor.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+size_t ColdInitializerEvictor::Register(const OrtValue& value) {
+  // initializers shared by several nodes, or with an outer scope, are tracked once.
+  const void* data = value.Get<Tensor>().DataRaw();
+  auto it = slots_by_data_.find(data);
+  if (it != slots_by_data_.end()) {
+    return it->second;
+  }
+
+  entries_.emplace_back(value);
+  const size_t slot = entries_.size() - 1;
+  slots_by_data_.emplace(data, slot);
+  return slot;
+}
+
+void ColdInitializerEvictor::OnRunEnd() {
+  const uint64_t completed_runs = completed_runs_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (completed_runs % eviction_runs_ != 0) {
+    return;
+  }
+
+  const Env& env = Env::Default();
+  for (auto& entry : entries_) {
+    // concurrent runs may use the initializer while its pages are released, which only costs a page fault.
+    if (entry.resident.load(std::memory_order_relaxed) &&
+        completed_runs - entry.last_used_run.load(std::memory_order_relaxed) > eviction_runs_) {
+      const Tensor& tensor = entry.value.Get<Tensor>();
+      entry.resident.store(false, std::memory_order_relaxed);
+      if (env.ReleaseMemoryPages(tensor.DataRaw(), tensor.SizeInBytes())) {
+        num_evictions_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+}  // namespace onnxruntime
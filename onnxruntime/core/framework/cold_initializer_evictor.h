@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+// Releases the resident pages of memory mapped initializers that recent runs didn't use.
+//
+// Initializers with external data on CPU are memory mapped, so their pages are read from the file on first access
+// and a weight that is never used, e.g. an expert of a mixture of experts model that is never selected, doesn't use
+// memory. Once accessed the pages stay resident though. The evictor tracks the run in which each initializer was last
+// used by a kernel and, every eviction_runs runs, asks the OS to reclaim the pages of the initializers that weren't
+// used in the last eviction_runs runs. The content is preserved, a later access reads the pages from the file again.
+class ColdInitializerEvictor {
+ public:
+  explicit ColdInitializerEvictor(uint64_t eviction_runs) : eviction_runs_(eviction_runs) {}
+
+  // Tracks the initializer. Returns the slot to pass to MarkUsed. The value is kept alive by the evictor.
+  // Must not be called once runs have started.
+  size_t Register(const OrtValue& value);
+
+  // Called by the executor before a kernel runs with the slots of the tracked initializers it consumes.
+  void MarkUsed(gsl::span<const size_t> slots) noexcept {
+    const uint64_t completed_runs = completed_runs_.load(std::memory_order_relaxed);
+    for (size_t slot : slots) {
+      auto& entry = entries_[slot];
+      entry.last_used_run.store(completed_runs, std::memory_order_relaxed);
+      entry.resident.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Called at the end of every run.
+  void OnRunEnd();
+
+  size_t GetNumberOfTrackedInitializers() const noexcept { return entries_.size(); }
+
+  // number of times the pages of an initializer were released.
+  size_t GetNumberOfEvictions() const noexcept { return num_evictions_.load(std::memory_order_relaxed); }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ColdInitializerEvictor);
+
+ private:
+  struct Entry {
+    explicit Entry(const OrtValue& v) : value(v) {}
+
+    OrtValue value;
+    // number of completed runs when the initializer was last used.
+    std::atomic<uint64_t> last_used_run{0};
+    // false once the pages are released, until the next use.
+    std::atomic<bool> resident{true};
+  };
+
+  const uint64_t eviction_runs_;
+  std::atomic<uint64_t> completed_runs_{0};
+  std::atomic<size_t> num_evictions_{0};
+  // deque so the atomics of existing entries are never moved.
+  std::deque<Entry> entries_;
+  std::unordered_map<const void*, size_t> slots_by_data_;
+};
+
+}  // namespace onnxruntime
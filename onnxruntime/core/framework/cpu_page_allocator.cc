@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/cpu_page_allocator.h"
+
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+constexpr size_t kRegularPageSize = 4096;
+}
+
+CPUPageAllocator::CPUPageAllocator(const OrtMemoryInfo& memory_info, size_t huge_page_size, int numa_node)
+    : IAllocator(memory_info),
+      huge_page_size_(huge_page_size),
+      numa_node_(numa_node) {
+  ORT_ENFORCE((huge_page_size_ & (huge_page_size_ - 1)) == 0, "huge_page_size must be a power of 2. Got ",
+              huge_page_size_);
+}
+
+void* CPUPageAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // leave room for the overrun some MLAS kernels rely on, like AllocatorDefaultAlloc does
+  const size_t page_size = huge_page_size_ > 0 ? huge_page_size_ : kRegularPageSize;
+  const size_t mapped_size = (SafeInt<size_t>(size) + MLAS_SYMM_QGEMM_BUF_OVERRUN + page_size - 1) / page_size *
+                             page_size;
+
+  void* p = Env::Default().AllocatePages(mapped_size, huge_page_size_, numa_node_);
+  if (p == nullptr) {
+    LOGS_DEFAULT(WARNING) << "Failed to allocate " << mapped_size << " bytes of pages (huge page size: "
+                          << huge_page_size_ << ", NUMA node: " << numa_node_
+                          << "). Falling back to the default CPU allocation.";
+    return AllocatorDefaultAlloc(size);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  page_allocations_[p] = mapped_size;
+  return p;
+}
+
+void CPUPageAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  size_t mapped_size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = page_allocations_.find(p);
+    if (it != page_allocations_.end()) {
+      mapped_size = it->second;
+      page_allocations_.erase(it);
+    }
+  }
+
+  if (mapped_size != 0) {
+    Env::Default().FreePages(p, mapped_size);
+  } else {
+    AllocatorDefaultFree(p);
+  }
+}
+
+}  // namespace onnxruntime
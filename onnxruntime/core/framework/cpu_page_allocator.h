@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// CPU device allocator that gets its memory directly from the OS using Env::AllocatePages so that it can be backed
+// by huge pages and/or bound to a NUMA node.
+// Every allocation is rounded up to a whole number of pages, so this is meant to provide the regions of a BFCArena
+// rather than to serve individual tensors. Falls back to the default CPU allocation if the OS can't provide the pages.
+class CPUPageAllocator : public IAllocator {
+ public:
+  // huge_page_size: size of the huge pages to request, or 0 for regular pages.
+  // numa_node: NUMA node to bind the memory to, or -1 for no binding.
+  CPUPageAllocator(const OrtMemoryInfo& memory_info, size_t huge_page_size, int numa_node);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  const size_t huge_page_size_;
+  const int numa_node_;
+
+  OrtMutex mutex_;
+  // size of each allocation made with Env::AllocatePages. Allocations not in here came from the fallback allocator.
+  std::unordered_map<void*, size_t> page_allocations_;
+};
+
+}  // namespace onnxruntime
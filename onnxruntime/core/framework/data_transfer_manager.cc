@@ -4,6 +4,7 @@
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
+#include "core/platform/tracepoints.h"
 
 namespace onnxruntime {
 using namespace common;
@@ -37,7 +38,12 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst) const {
       continue;
     }
 
-    return data_transfer->CopyTensor(src, dst);
+    ORT_TRACEPOINT(copy_start, src.SizeInBytes(), static_cast<int>(src.Location().device.Type()),
+                   static_cast<int>(dst.Location().device.Type()));
+    auto status = data_transfer->CopyTensor(src, dst);
+    ORT_TRACEPOINT(copy_end, src.SizeInBytes(), static_cast<int>(src.Location().device.Type()),
+                   static_cast<int>(dst.Location().device.Type()));
+    return status;
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME,
@@ -58,7 +64,12 @@ Status DataTransferManager::CopyTensorAsync(const Tensor& src, Tensor& dst, Stre
       continue;
     }
 
-    return data_transfer->CopyTensorAsync(src, dst, stream);
+    ORT_TRACEPOINT(copy_start, src.SizeInBytes(), static_cast<int>(src.Location().device.Type()),
+                   static_cast<int>(dst.Location().device.Type()));
+    auto status = data_transfer->CopyTensorAsync(src, dst, stream);
+    ORT_TRACEPOINT(copy_end, src.SizeInBytes(), static_cast<int>(src.Location().device.Type()),
+                   static_cast<int>(dst.Location().device.Type()));
+    return status;
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME,
@@ -126,7 +137,16 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
 
   // all copies are between the same devices so we can do them all at once
   if (all_same) {
-    return first_dt->CopyTensors(src_dst_pairs);
+#if defined(ORT_ENABLE_USDT)
+    size_t total_bytes = 0;
+    for (const auto& pair : src_dst_pairs) {
+      total_bytes += pair.src.get().SizeInBytes();
+    }
+#endif
+    ORT_TRACEPOINT(copy_start, total_bytes, static_cast<int>(src_device.Type()), static_cast<int>(dst_device.Type()));
+    auto status = first_dt->CopyTensors(src_dst_pairs);
+    ORT_TRACEPOINT(copy_end, total_bytes, static_cast<int>(src_device.Type()), static_cast<int>(dst_device.Type()));
+    return status;
   }
 
   // there are a mix of devices requiring copies. we don't expect this to happen, so just iterate the pairs
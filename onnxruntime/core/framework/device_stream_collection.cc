@@ -33,13 +33,8 @@ class DeviceStreamCollectionImpl {
   void ReleaseSingleStreamBuffers(Stream* stream) {
     if (!stream) return;
     for (auto it : allocators_) {
-      if (it.second->Info().device == stream->GetDevice() &&
-          it.second->Info().alloc_type == OrtArenaAllocator) {
-        auto* arena_alloc = static_cast<BFCArena*>(it.second.get());
-        auto* stream_aware_alloc = StreamAwareArena::FromBFCArena(*arena_alloc);
-        if (stream_aware_alloc) {
-          stream_aware_alloc->ReleaseStreamBuffers(stream);
-        }
+      if (it.second->Info().device == stream->GetDevice() && it.second->IsStreamAware()) {
+        it.second->ReleaseStreamBuffers(stream);
       }
     }
   }
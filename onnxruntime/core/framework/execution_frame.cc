@@ -548,8 +548,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // with shape bucketing the pattern covers a range of shapes, so any block large enough can be used.
+          const bool bucketed = session_state_.GetMemoryPatternShapeBucketSize() > 0;
+          if (block->size_ == size || (bucketed && size < block->size_)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -564,6 +566,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
                                                    << ", block in memory pattern size is: " << block->size_
                                                    << " but the actual size is: " << size
                                                    << ", fall back to default allocation behavior";
+            if (bucketed && size > block->size_) {
+              mem_pattern_miss_ = true;
+            }
           }
         }
         // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
@@ -578,13 +583,12 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   Stream* current_stream = GetValueStream(ort_value_index);
   if (current_stream) {
 #ifdef ORT_ENABLE_STREAM
-    auto stream_aware_alloc = AsStreamBasedAllocator(alloc);
-    if (stream_aware_alloc) {
+    if (alloc->IsStreamAware()) {
       size_t buffer_size = Tensor::CalculateTensorStorageSize(element_type, shape);
       // the reused memory must from same EP
       auto wait_handle = this->session_state_.GetStreamHandleRegistryInstance().GetWaitHandle(
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
-      void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
+      void* p_data = alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
       Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
     } else {
       Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
@@ -762,6 +766,14 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
 
         ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, shape));
 
+        if (per_alloc_plan.view_of != -1) {
+          // the kernel producing a view moves its start to the sub-range of the input it covers
+          auto* view_of = GetMutableMLValue(per_alloc_plan.view_of).GetMutable<Tensor>();
+          ORT_RETURN_IF_ERROR(AllocateTensorWithPreAllocateBufferHelper(ort_value, view_of->MutableDataRaw(),
+                                                                        ml_data_type, alloc_info, *shape));
+          break;
+        }
+
         bool is_strided_tensor = false;
 #ifdef ENABLE_STRIDED_TENSORS
         is_strided_tensor = per_alloc_plan.is_strided_tensor;
@@ -166,6 +166,12 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // true if a cached memory pattern was used but a block in it was too small for the actual allocation.
+  // only tracked when memory pattern shape bucketing is enabled.
+  bool HasMemoryPatternMiss() const {
+    return mem_pattern_miss_;
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is successful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -237,6 +243,9 @@ class ExecutionFrame final : public IExecutionFrame {
   // use this planner_ to trace the memory allocation in current executor.
   std::optional<OrtValuePatternPlanner> planner_;
 
+  // set when a block of mem_patterns_ was too small. see HasMemoryPatternMiss().
+  bool mem_pattern_miss_{false};
+
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
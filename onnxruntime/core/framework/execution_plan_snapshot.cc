@@ -0,0 +1,426 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_plan_snapshot.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/execution_steps.h"
+#include "core/framework/mldata_type_utils.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/session_options.h"
+#include "core/graph/graph_viewer.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace execution_plan_snapshot {
+
+namespace {
+constexpr const char* kExecutionPlanSnapshotMagic = "ORT_EXECUTION_PLAN";
+// version 2 added the view_of of the values.
+constexpr int kExecutionPlanSnapshotVersion = 2;
+
+void AddNodeArg(std::ostream& out, const NodeArg* node_arg) {
+  // the planner reuses buffers based on the shapes, so they are part of the fingerprint
+  out << node_arg->Name() << ":";
+  if (node_arg->Exists() && node_arg->TypeAsProto() != nullptr) {
+    out << node_arg->TypeAsProto()->SerializeAsString();
+  }
+  out << ";";
+}
+
+// the value types are pointers to the type singletons, so they are restored from the graph.
+// returns nullptr if the value has no NodeArg in the graph.
+MLDataType GetValueType(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                        int ort_value_idx) {
+  std::string name;
+  if (!ort_value_name_idx_map.GetName(ort_value_idx, name).IsOK()) {
+    return nullptr;
+  }
+
+  const NodeArg* node_arg = graph_viewer.GetNodeArg(name);
+  return node_arg != nullptr ? utils::GetMLDataType(*node_arg) : nullptr;
+}
+
+bool IsSupported(const SequentialExecutionPlan& plan) {
+#ifdef ENABLE_TRAINING
+  // the training specific execution order isn't persisted
+  ORT_UNUSED_PARAMETER(plan);
+  return false;
+#else
+  // without notifications, barriers and downstream triggers all the steps are kernel launches
+  return plan.notification_owners.empty() && plan.downstream_map.empty() && plan.num_barriers == 0;
+#endif
+}
+
+template <typename T>
+bool ReadIndices(std::istream& in, size_t max_size, size_t bound, std::vector<T>& indices) {
+  size_t count = 0;
+  in >> count;
+  if (!in || count > max_size) {
+    return false;
+  }
+
+  indices.resize(count);
+  for (auto& index : indices) {
+    in >> index;
+    if (!in || static_cast<size_t>(index) >= bound) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void WriteIndices(std::ostream& out, const T& indices) {
+  out << indices.size();
+  for (auto index : indices) {
+    out << " " << index;
+  }
+  out << "\n";
+}
+}  // namespace
+
+uint64_t CalculateFingerprint(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                              const SessionOptions& session_options) {
+  std::ostringstream ss;
+  ss << ORT_VERSION << "\n"
+     << static_cast<int>(session_options.execution_mode) << " " << static_cast<int>(session_options.execution_order)
+     << " " << session_options.enable_mem_reuse << " "
+     << session_options.config_options.GetConfigOrDefault(kNodePartitionConfigFile, "") << "\n"
+     << session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryAwareNodeOrder, "0") << " "
+     << session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryBudgetBytes, "0") << " "
+     << session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMaxStreamsPerDevice, "1") << "\n";
+#ifdef ENABLE_STRIDED_TENSORS
+  ss << "strided\n";
+#endif
+
+  const int max_idx = ort_value_name_idx_map.MaxIdx();
+  std::string name;
+  for (int i = 0; i <= max_idx; ++i) {
+    if (ort_value_name_idx_map.GetName(i, name).IsOK()) {
+      ss << i << ":" << name << ";";
+    }
+  }
+  ss << "\n";
+
+  for (const auto* node_arg : graph_viewer.GetInputsIncludingInitializers()) {
+    AddNodeArg(ss, node_arg);
+  }
+  ss << "\n";
+  for (const auto* node_arg : graph_viewer.GetOutputs()) {
+    AddNodeArg(ss, node_arg);
+  }
+  ss << "\n";
+
+  // the kernel assignment determines the locations and the in-place reuse of the values
+  for (const auto& node : graph_viewer.Nodes()) {
+    ss << node.Index() << " " << node.OpType() << " " << node.Domain() << " " << node.SinceVersion() << " "
+       << node.GetExecutionProviderType() << "\n";
+    for (const auto* node_arg : node.InputDefs()) {
+      AddNodeArg(ss, node_arg);
+    }
+    ss << "\n";
+    for (const auto* node_arg : node.ImplicitInputDefs()) {
+      AddNodeArg(ss, node_arg);
+    }
+    ss << "\n";
+    for (const auto* node_arg : node.OutputDefs()) {
+      AddNodeArg(ss, node_arg);
+    }
+    ss << "\n";
+  }
+
+  const std::string description = ss.str();
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(description.data(), static_cast<int>(description.size()), 0, hash);
+  return (static_cast<uint64_t>(hash[1]) << 32) | hash[0];
+}
+
+bool Load(const PathString& file_path, uint64_t fingerprint, const GraphViewer& graph_viewer,
+          const OrtValueNameIdxMap& ort_value_name_idx_map, const logging::Logger& logger,
+          std::optional<SequentialExecutionPlan>& plan) {
+  std::ifstream in(file_path);
+  if (!in.is_open()) {
+    // first session with this file. it is created once the plan is generated.
+    return false;
+  }
+
+  std::string magic;
+  int version = 0;
+  uint64_t file_fingerprint = 0;
+  in >> magic >> version >> file_fingerprint;
+  if (!in || magic != kExecutionPlanSnapshotMagic || version != kExecutionPlanSnapshotVersion) {
+    LOGS(logger, WARNING) << "Ignoring execution plan snapshot " << ToUTF8String(file_path)
+                          << " as it is not in the expected format.";
+    return false;
+  }
+
+  if (file_fingerprint != fingerprint) {
+    LOGS(logger, INFO) << "Ignoring execution plan snapshot " << ToUTF8String(file_path)
+                       << " as it was created for a different model or session options.";
+    return false;
+  }
+
+  const size_t num_values = static_cast<size_t>(ort_value_name_idx_map.MaxIdx() + 1);
+  const size_t num_nodes = graph_viewer.MaxNodeIndex();
+  SequentialExecutionPlan loaded;
+
+  // every index read from the file is validated against the graph so a corrupt file can't cause out of bounds
+  // accesses when the plan is executed.
+  auto read_plan = [&]() -> bool {
+    size_t count = 0;
+    in >> count;
+    if (!in || count != num_values) {
+      return false;
+    }
+
+    loaded.allocation_plan.resize(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+      auto& value_plan = loaded.allocation_plan[i];
+      int alloc_kind = 0, has_value_type = 0, device_type = 0, mem_type = 0, device_id = 0;
+      in >> alloc_kind >> has_value_type >> device_type >> mem_type >> device_id >> value_plan.reused_buffer >>
+          value_plan.view_of;
+#ifdef ENABLE_STRIDED_TENSORS
+      in >> value_plan.is_strided_tensor;
+#endif
+      if (!in || alloc_kind < static_cast<int>(AllocKind::kNotSet) ||
+          alloc_kind > static_cast<int>(AllocKind::kAllocatedExternally) ||
+          value_plan.reused_buffer < 0 || static_cast<size_t>(value_plan.reused_buffer) >= num_values ||
+          value_plan.view_of < -1 ||
+          (value_plan.view_of != -1 && static_cast<size_t>(value_plan.view_of) >= num_values)) {
+        return false;
+      }
+
+      value_plan.alloc_kind = static_cast<AllocKind>(alloc_kind);
+      value_plan.location = OrtDevice(static_cast<OrtDevice::DeviceType>(device_type),
+                                      static_cast<OrtDevice::MemoryType>(mem_type),
+                                      static_cast<OrtDevice::DeviceId>(device_id));
+      if (has_value_type) {
+        value_plan.value_type = GetValueType(graph_viewer, ort_value_name_idx_map, static_cast<int>(i));
+        if (value_plan.value_type == nullptr) {
+          return false;
+        }
+      }
+
+      std::vector<size_t> starts, ends;
+      constexpr size_t max_program_counters = std::numeric_limits<int>::max();
+      if (!ReadIndices(in, max_program_counters, std::numeric_limits<size_t>::max(), starts) ||
+          !ReadIndices(in, max_program_counters, std::numeric_limits<size_t>::max(), ends) ||
+          starts.size() != ends.size()) {
+        return false;
+      }
+      for (size_t pc = 0; pc < starts.size(); ++pc) {
+        // the conditions ProgramCounter enforces
+        if (starts[pc] > ends[pc] || (pc > 0 && starts[pc] <= ends[pc - 1])) {
+          return false;
+        }
+        value_plan.program_counter.AddStart(starts[pc]);
+        value_plan.program_counter.AddEnd(ends[pc]);
+      }
+    }
+
+    if (!ReadIndices(in, num_values, num_values, loaded.initializer_allocation_order) ||
+        !ReadIndices(in, num_values, num_values, loaded.activation_allocation_order)) {
+      return false;
+    }
+
+    size_t num_streams = 0;
+    in >> num_streams;
+    if (!in || num_streams > num_nodes + 1) {
+      return false;
+    }
+    for (size_t s = 0; s < num_streams; ++s) {
+      int has_stream = 0;
+      in >> has_stream;
+      if (!in) {
+        return false;
+      }
+      if (!has_stream) {
+        loaded.execution_plan.emplace_back(nullptr);
+        continue;
+      }
+
+      int device_type = 0, mem_type = 0, device_id = 0;
+      std::vector<NodeIndex> node_indices;
+      in >> device_type >> mem_type >> device_id;
+      if (!in || !ReadIndices(in, num_nodes, num_nodes, node_indices)) {
+        return false;
+      }
+
+      auto stream = std::make_unique<SequentialExecutionPlan::LogicStream>(
+          OrtDevice(static_cast<OrtDevice::DeviceType>(device_type), static_cast<OrtDevice::MemoryType>(mem_type),
+                    static_cast<OrtDevice::DeviceId>(device_id)));
+      for (NodeIndex node_index : node_indices) {
+        const Node* node = graph_viewer.GetNode(node_index);
+        if (node == nullptr) {
+          return false;
+        }
+#if defined(ORT_MINIMAL_BUILD)
+        stream->steps_.emplace_back(std::make_unique<LaunchKernelStep>(node_index));
+#else
+        stream->steps_.emplace_back(std::make_unique<LaunchKernelStep>(node_index, node->Name()));
+#endif
+      }
+      loaded.execution_plan.push_back(std::move(stream));
+    }
+
+    size_t num_value_streams = 0;
+    in >> num_value_streams;
+    if (!in || num_value_streams > num_values) {
+      return false;
+    }
+    for (size_t i = 0; i < num_value_streams; ++i) {
+      size_t value_index = 0, stream_index = 0;
+      in >> value_index >> stream_index;
+      if (!in || value_index >= num_values || stream_index >= num_streams) {
+        return false;
+      }
+      loaded.value_to_stream_map.insert_or_assign(value_index, stream_index);
+    }
+
+    size_t num_release_actions = 0;
+    in >> num_release_actions;
+    if (!in || num_release_actions > num_values) {
+      return false;
+    }
+    loaded.release_actions.resize(num_release_actions);
+    for (auto& release_action : loaded.release_actions) {
+      in >> release_action.value_index >> release_action.ref_count;
+      if (!in || release_action.value_index >= num_values) {
+        return false;
+      }
+    }
+
+    // the release lists are indexed by node index
+    size_t num_release_lists = 0;
+    in >> num_release_lists;
+    if (!in || num_release_lists != num_nodes + 1) {
+      return false;
+    }
+    loaded.node_release_list.resize(num_release_lists);
+    for (auto& release_list : loaded.node_release_list) {
+      if (!ReadIndices(in, num_release_actions, num_release_actions, release_list)) {
+        return false;
+      }
+    }
+
+    std::vector<size_t> node_stream_map;
+    if (!ReadIndices(in, num_nodes + 1, std::max<size_t>(num_streams, 1), node_stream_map) ||
+        (!node_stream_map.empty() && node_stream_map.size() != num_nodes + 1)) {
+      return false;
+    }
+    loaded.node_stream_map_.assign(node_stream_map.begin(), node_stream_map.end());
+    return true;
+  };
+
+  if (!read_plan()) {
+    LOGS(logger, WARNING) << "Ignoring execution plan snapshot " << ToUTF8String(file_path)
+                          << " as it is truncated or corrupt.";
+    return false;
+  }
+
+  plan.emplace(std::move(loaded));
+  return true;
+}
+
+void Save(const PathString& file_path, uint64_t fingerprint, const GraphViewer& graph_viewer,
+          const OrtValueNameIdxMap& ort_value_name_idx_map, const logging::Logger& logger,
+          const SequentialExecutionPlan& plan) {
+  if (!IsSupported(plan)) {
+    LOGS(logger, INFO) << "Not saving execution plan snapshot as the plan synchronizes between streams.";
+    return;
+  }
+
+  for (size_t i = 0; i < plan.allocation_plan.size(); ++i) {
+    const MLDataType value_type = plan.allocation_plan[i].value_type;
+    if (value_type != nullptr &&
+        GetValueType(graph_viewer, ort_value_name_idx_map, static_cast<int>(i)) != value_type) {
+      LOGS(logger, INFO) << "Not saving execution plan snapshot as the type of an OrtValue can't be restored.";
+      return;
+    }
+  }
+
+  // write to a temporary file first so a concurrent reader or a crash never sees a partial file.
+  PathString tmp_path = file_path + ORT_TSTR(".tmp");
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out.is_open()) {
+      LOGS(logger, WARNING) << "Failed to open " << ToUTF8String(tmp_path) << " to save the execution plan.";
+      return;
+    }
+
+    out << kExecutionPlanSnapshotMagic << " " << kExecutionPlanSnapshotVersion << " " << fingerprint << "\n";
+
+    out << plan.allocation_plan.size() << "\n";
+    for (const auto& value_plan : plan.allocation_plan) {
+      out << static_cast<int>(value_plan.alloc_kind) << " " << (value_plan.value_type != nullptr) << " "
+          << static_cast<int>(value_plan.location.Type()) << " " << static_cast<int>(value_plan.location.MemType())
+          << " " << static_cast<int>(value_plan.location.Id()) << " " << value_plan.reused_buffer << " "
+          << value_plan.view_of << " ";
+#ifdef ENABLE_STRIDED_TENSORS
+      out << value_plan.is_strided_tensor << " ";
+#endif
+      WriteIndices(out, value_plan.program_counter.Starts());
+      WriteIndices(out, value_plan.program_counter.Ends());
+    }
+
+    WriteIndices(out, plan.initializer_allocation_order);
+    WriteIndices(out, plan.activation_allocation_order);
+
+    out << plan.execution_plan.size() << "\n";
+    for (const auto& stream : plan.execution_plan) {
+      if (stream == nullptr) {
+        out << "0\n";
+        continue;
+      }
+
+      out << "1 " << static_cast<int>(stream->device_.Type()) << " " << static_cast<int>(stream->device_.MemType())
+          << " " << static_cast<int>(stream->device_.Id()) << " ";
+      std::vector<NodeIndex> node_indices;
+      node_indices.reserve(stream->steps_.size());
+      for (const auto& step : stream->steps_) {
+        node_indices.push_back(step->GetNodeIndex());
+      }
+      WriteIndices(out, node_indices);
+    }
+
+    out << plan.value_to_stream_map.size() << "\n";
+    for (const auto& entry : plan.value_to_stream_map) {
+      out << entry.first << " " << entry.second << "\n";
+    }
+
+    out << plan.release_actions.size() << "\n";
+    for (const auto& release_action : plan.release_actions) {
+      out << release_action.value_index << " " << release_action.ref_count << "\n";
+    }
+
+    out << plan.node_release_list.size() << "\n";
+    for (const auto& release_list : plan.node_release_list) {
+      WriteIndices(out, release_list);
+    }
+
+    WriteIndices(out, plan.node_stream_map_);
+
+    if (!out) {
+      LOGS(logger, WARNING) << "Failed to write the execution plan to " << ToUTF8String(tmp_path);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, file_path, ec);
+  if (ec) {
+    LOGS(logger, WARNING) << "Failed to save the execution plan to " << ToUTF8String(file_path) << ": "
+                          << ec.message();
+  }
+}
+
+}  // namespace execution_plan_snapshot
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/sequential_execution_plan.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class OrtValueNameIdxMap;
+struct SessionOptions;
+namespace logging {
+class Logger;
+}
+
+// Persists the execution plan of the main graph so later sessions of the same model restore it instead of running
+// the allocation planner.
+//
+// Only plans without synchronization between streams can be persisted, i.e. plans that consist of kernel launches,
+// which is the case for models that run on a single execution provider or only on EPs without streams.
+// The snapshot is tagged with a fingerprint of the partitioned graph, the OrtValue indices and the session options
+// that affect planning, and is ignored if it doesn't match.
+namespace execution_plan_snapshot {
+
+uint64_t CalculateFingerprint(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                              const SessionOptions& session_options);
+
+// Restores the plan from file_path. Returns false and leaves plan unset if there is no usable snapshot.
+bool Load(const PathString& file_path, uint64_t fingerprint, const GraphViewer& graph_viewer,
+          const OrtValueNameIdxMap& ort_value_name_idx_map, const logging::Logger& logger,
+          std::optional<SequentialExecutionPlan>& plan);
+
+// Writes the plan to file_path. Does nothing if the plan can't be persisted.
+void Save(const PathString& file_path, uint64_t fingerprint, const GraphViewer& graph_viewer,
+          const OrtValueNameIdxMap& ort_value_name_idx_map, const logging::Logger& logger,
+          const SequentialExecutionPlan& plan);
+
+}  // namespace execution_plan_snapshot
+}  // namespace onnxruntime
@@ -58,6 +58,8 @@ class LaunchKernelStep : public SequentialExecutionPlan::ExecutionStep {
 
   std::string ToString() const override;
 
+  bool LaunchesKernel() const override { return true; }
+
 #if !defined(ORT_MINIMAL_BUILD)
  private:
   std::string node_name_;
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/frozen_state_allocator.h"
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// multiple of the page size of the supported platforms, and of the allocation granularity of Windows.
+constexpr size_t kPageGranularity = 64 * 1024;
+constexpr size_t kSharedRegionSize = 4 * 1024 * 1024;
+// larger allocations get a region of their own, so the memory of an initializer released after pre-packing is
+// returned to the OS.
+constexpr size_t kMaxSharedAllocationSize = kSharedRegionSize / 16;
+constexpr size_t kAlignment = 64;
+
+constexpr size_t RoundUp(size_t size, size_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+FrozenStateAllocator::~FrozenStateAllocator() {
+  const Env& env = Env::Default();
+  for (const auto& region : shared_regions_) {
+    env.FreePages(region.p, region.size);
+  }
+
+  for (const auto& [p, size] : dedicated_regions_) {
+    env.FreePages(p, size);
+  }
+}
+
+void* FrozenStateAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  const Env& env = Env::Default();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ORT_ENFORCE(!frozen_, "The immutable state of the session is frozen, no memory can be allocated from it.");
+
+  if (size > kMaxSharedAllocationSize) {
+    const size_t region_size = RoundUp(size, kPageGranularity);
+    void* p = env.AllocatePages(region_size, 0, -1);
+    ORT_ENFORCE(p != nullptr, "Failed to allocate ", region_size, " bytes of pages for the immutable session state.");
+    dedicated_regions_.emplace(p, region_size);
+    return p;
+  }
+
+  const size_t aligned_size = RoundUp(size, kAlignment);
+  if (shared_regions_.empty() || shared_region_used_ + aligned_size > kSharedRegionSize) {
+    void* p = env.AllocatePages(kSharedRegionSize, 0, -1);
+    ORT_ENFORCE(p != nullptr, "Failed to allocate ", kSharedRegionSize,
+                " bytes of pages for the immutable session state.");
+    shared_regions_.push_back({p, kSharedRegionSize});
+    shared_region_used_ = 0;
+  }
+
+  void* p = static_cast<char*>(shared_regions_.back().p) + shared_region_used_;
+  shared_region_used_ += aligned_size;
+  return p;
+}
+
+void FrozenStateAllocator::Free(void* p) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = dedicated_regions_.find(p);
+  if (it != dedicated_regions_.end()) {
+    Env::Default().FreePages(it->first, it->second);
+    dedicated_regions_.erase(it);
+  }
+}
+
+Status FrozenStateAllocator::Freeze() {
+  const Env& env = Env::Default();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& region : shared_regions_) {
+    ORT_RETURN_IF_NOT(env.ProtectMemoryPagesReadOnly(region.p, region.size),
+                      "Failed to make the immutable session state read only.");
+  }
+
+  for (const auto& [p, size] : dedicated_regions_) {
+    ORT_RETURN_IF_NOT(env.ProtectMemoryPagesReadOnly(p, size),
+                      "Failed to make the immutable session state read only.");
+  }
+
+  frozen_ = true;
+  return Status::OK();
+}
+
+bool FrozenStateAllocator::IsFrozen() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return frozen_;
+}
+
+size_t FrozenStateAllocator::GetMappedBytes() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t bytes = shared_regions_.size() * kSharedRegionSize;
+  for (const auto& entry : dedicated_regions_) {
+    bytes += entry.second;
+  }
+
+  return bytes;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Allocates the state of a session that doesn't change once the session is initialized, i.e. its CPU initializers
+// and pre-packed weights, so that processes forked after the session was created share it.
+//
+// Forked processes share the pages of their parent until either writes to them. Pages of a general purpose allocator
+// or arena also hold the allocator's bookkeeping and buffers of the runs, so the first runs of each child copy most
+// of the weights. This allocator takes its memory directly from the OS in page aligned regions that hold nothing but
+// the immutable state, and Freeze() makes them read only once the session is initialized, so they stay shared.
+class FrozenStateAllocator : public IAllocator {
+ public:
+  FrozenStateAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
+  ~FrozenStateAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  // Makes all the allocated memory read only. Alloc fails afterwards.
+  Status Freeze();
+
+  bool IsFrozen() const;
+
+  // number of bytes taken from the OS.
+  size_t GetMappedBytes() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FrozenStateAllocator);
+
+ private:
+  struct Region {
+    void* p;
+    size_t size;
+  };
+
+  mutable OrtMutex mutex_;
+  // regions shared by the small allocations, which are released with the allocator.
+  std::vector<Region> shared_regions_;
+  size_t shared_region_used_{0};
+  // regions of the large allocations by address, which are released when the allocation is freed.
+  InlinedHashMap<void*, size_t> dedicated_regions_;
+  bool frozen_{false};
+};
+
+}  // namespace onnxruntime
@@ -5,7 +5,9 @@
 
 #include <cassert>
 #include <functional>
+#include <queue>
 
+#include "core/common/parse_string.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/func_kernel.h"
@@ -131,6 +133,9 @@ struct GetCapabilityForEPParams {
   std::reference_wrapper<const layout_transformation::TransformLayoutFunction> transform_layout;
   std::reference_wrapper<const layout_transformation::DebugGraphFn> debug_graph_fn;
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+
+  // partitions of fewer nodes are left to the EPs after current_ep. 0 to take all partitions.
+  size_t min_partition_size = 0;
 };
 
 auto get_capabilities = [](const IExecutionProvider& ep,
@@ -149,6 +154,83 @@ auto get_capabilities = [](const IExecutionProvider& ep,
 };
 }  // namespace
 
+// Removes the capabilities that form partitions of less than min_partition_size nodes, so that a small fragment of
+// the graph runs on the next EP instead of costing copies to and from current_ep.
+// A capability with a MetaDef is a partition by itself. The single node capabilities are grouped in partitions of
+// connected nodes. A partition is kept if the CPU EP has no kernel for one of its nodes, as the nodes may have no
+// other EP to run on.
+static void RemoveSmallPartitions(const Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                                  size_t min_partition_size,
+                                  std::vector<std::unique_ptr<ComputeCapability>>& capabilities) {
+  const KernelLookup cpu_kernel_lookup{kCpuExecutionProvider,
+                                       kernel_registry_mgr.GetKernelRegistriesByProviderType(kCpuExecutionProvider),
+                                       kernel_registry_mgr.GetKernelTypeStrResolver()};
+  auto cpu_can_run_all = [&](gsl::span<const NodeIndex> node_indices) {
+    return std::all_of(node_indices.begin(), node_indices.end(), [&](NodeIndex node_index) {
+      const Node* node = graph.GetNode(node_index);
+      return node != nullptr && cpu_kernel_lookup.LookUpKernel(*node) != nullptr;
+    });
+  };
+
+  InlinedHashMap<NodeIndex, size_t> single_node_capabilities;
+  InlinedHashSet<size_t> capabilities_to_remove;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    const auto& sub_graph = *capabilities[i]->sub_graph;
+    if (sub_graph.GetMetaDef() != nullptr || sub_graph.nodes.size() != 1) {
+      if (sub_graph.nodes.size() < min_partition_size && cpu_can_run_all(sub_graph.nodes)) {
+        capabilities_to_remove.insert(i);
+      }
+    } else {
+      single_node_capabilities.emplace(sub_graph.nodes[0], i);
+    }
+  }
+
+  InlinedHashSet<NodeIndex> visited;
+  for (const auto& [start_node_index, start_capability] : single_node_capabilities) {
+    if (!visited.insert(start_node_index).second) {
+      continue;
+    }
+
+    // collect the connected single node capabilities
+    std::vector<NodeIndex> partition{start_node_index};
+    std::queue<NodeIndex> to_visit;
+    to_visit.push(start_node_index);
+    while (!to_visit.empty()) {
+      const Node* node = graph.GetNode(to_visit.front());
+      to_visit.pop();
+      auto visit = [&](const Node& neighbor) {
+        if (single_node_capabilities.count(neighbor.Index()) != 0 && visited.insert(neighbor.Index()).second) {
+          partition.push_back(neighbor.Index());
+          to_visit.push(neighbor.Index());
+        }
+      };
+      std::for_each(node->InputNodesBegin(), node->InputNodesEnd(), visit);
+      std::for_each(node->OutputNodesBegin(), node->OutputNodesEnd(), visit);
+    }
+
+    if (partition.size() < min_partition_size && cpu_can_run_all(partition)) {
+      for (NodeIndex node_index : partition) {
+        capabilities_to_remove.insert(single_node_capabilities.at(node_index));
+      }
+    }
+  }
+
+  if (capabilities_to_remove.empty()) {
+    return;
+  }
+
+  LOGS_DEFAULT(INFO) << "Leaving " << capabilities_to_remove.size() << " of " << capabilities.size()
+                     << " capabilities in partitions of less than " << min_partition_size << " nodes to other EPs.";
+  std::vector<std::unique_ptr<ComputeCapability>> kept_capabilities;
+  kept_capabilities.reserve(capabilities.size() - capabilities_to_remove.size());
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    if (capabilities_to_remove.count(i) == 0) {
+      kept_capabilities.push_back(std::move(capabilities[i]));
+    }
+  }
+  capabilities = std::move(kept_capabilities);
+}
+
 static Status GetCapabilityForEP(const GetCapabilityForEPParams& params) {
   auto& current_ep = params.current_ep.get();
   const auto& ep_type = current_ep.Type();
@@ -174,6 +256,10 @@ static Status GetCapabilityForEP(const GetCapabilityForEPParams& params) {
     const GraphViewer graph_viewer(graph);
     capabilities = get_capabilities(current_ep, graph_viewer, kernel_lookup);
 
+    if (params.min_partition_size > 1 && ep_type != kCpuExecutionProvider) {
+      RemoveSmallPartitions(graph, kernel_registry_mgr, params.min_partition_size, capabilities);
+    }
+
     if (capabilities.empty()) {
       return Status::OK();
     }
@@ -190,6 +276,11 @@ static Status GetCapabilityForEP(const GetCapabilityForEPParams& params) {
 
     const NodeIndex first_new_node = graph.MaxNodeIndex();
 
+    InlinedHashSet<NodeIndex> nodes_in_first_capabilities;
+    for (const auto& capability : capabilities) {
+      nodes_in_first_capabilities.insert(capability->sub_graph->nodes.begin(), capability->sub_graph->nodes.end());
+    }
+
     // Perform layout transformation on the specific EP assigned graph
     bool modified = false;
     ORT_RETURN_IF_ERROR(params.transform_layout(graph, modified, current_ep, params.debug_graph_fn));
@@ -212,6 +303,20 @@ static Status GetCapabilityForEP(const GetCapabilityForEPParams& params) {
     const GraphViewer graph_viewer(graph);
     capabilities = get_capabilities(current_ep, graph_viewer, kernel_lookup);
 
+    if (params.min_partition_size > 1) {
+      // keep the decision of the first call, which the layout transformation was done for. the new nodes come from
+      // the transformed nodes of the kept partitions.
+      capabilities.erase(std::remove_if(capabilities.begin(), capabilities.end(),
+                                        [&](const std::unique_ptr<ComputeCapability>& capability) {
+                                          const auto& nodes = capability->sub_graph->nodes;
+                                          return std::none_of(nodes.begin(), nodes.end(), [&](NodeIndex node_index) {
+                                            return node_index >= first_new_node ||
+                                                   nodes_in_first_capabilities.count(node_index) != 0;
+                                          });
+                                        }),
+                         capabilities.end());
+    }
+
     // all nodes with an index >= first_new_node with domain of kMSInternalNHWCDomain should be in the capabilities
     InlinedHashSet<NodeIndex> new_nodes_in_capabilities;
     for (const auto& capability : capabilities) {
@@ -359,7 +464,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
                                            GraphPartitioner::Mode mode,
                                            int& fused_node_unique_id,
                                            const layout_transformation::TransformLayoutFunction& transform_layout_fn,
-                                           const layout_transformation::DebugGraphFn& debug_graph_fn) {
+                                           const layout_transformation::DebugGraphFn& debug_graph_fn,
+                                           size_t min_partition_size) {
   // handle testing edge case where optimizers or constant lifting results in graph with no nodes.
   // doing it here saves all providers checking for this in GetCapability
   if (graph.NumberOfNodes() == 0) {
@@ -373,7 +479,7 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       // we pass through the FuncManager from the top level graph
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(*subgraph, func_mgr, kernel_registry_mgr,
                                                        fused_kernel_registry, current_ep, mode, fused_node_unique_id,
-                                                       transform_layout_fn, debug_graph_fn));
+                                                       transform_layout_fn, debug_graph_fn, min_partition_size));
     }
   }
 
@@ -396,7 +502,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       std::ref(capabilities),
       mode,
       std::cref(transform_layout_fn),
-      std::cref(debug_graph_fn)};
+      std::cref(debug_graph_fn),
+      min_partition_size};
 
   ORT_RETURN_IF_ERROR(GetCapabilityForEP(get_capability_params));
   if (capabilities.empty()) {
@@ -727,7 +834,8 @@ static Status CreateEpContextModel(const ExecutionProviders& execution_providers
 
 static Status PartitionOnnxFormatModel(const PartitionParams& partition_params, GraphPartitioner::Mode mode,
                                        const ExecutionProviders& execution_providers,
-                                       KernelRegistryManager& kernel_registry_manager) {
+                                       KernelRegistryManager& kernel_registry_manager,
+                                       size_t min_partition_size) {
   bool modified_graph = false;
 
   auto& graph = partition_params.graph.get();
@@ -742,7 +850,8 @@ static Status PartitionOnnxFormatModel(const PartitionParams& partition_params,
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(graph, func_mgr, kernel_registry_manager,
                                                        fused_kernel_registry, *ep, mode, fused_node_unique_id,
                                                        transform_layout_function,
-                                                       partition_params.debug_graph_fn));
+                                                       partition_params.debug_graph_fn,
+                                                       min_partition_size));
     }
 
     // expand any nodes that have an ONNX function definition but no matching ORT kernel.
@@ -977,8 +1086,14 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
 
   if (mode == Mode::kNormal || mode == Mode::kAssignOnly) {
 #if !defined(ORT_MINIMAL_BUILD)
+    const std::string min_partition_size_string =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsMinEpPartitionSize, "0");
+    size_t min_partition_size = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(min_partition_size_string, min_partition_size),
+                      "Invalid value for ", kOrtSessionOptionsMinEpPartitionSize, ": ", min_partition_size_string);
+
     ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode,
-                                                 providers_, kernel_registry_mgr_));
+                                                 providers_, kernel_registry_mgr_, min_partition_size));
 
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
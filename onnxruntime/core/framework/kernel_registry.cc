@@ -8,6 +8,7 @@
 #include <numeric>
 #include <unordered_map>
 
+#include "core/common/hash_combine.h"
 #include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/session_state.h"
 
@@ -114,6 +115,27 @@ bool MatchKernelDefTypes(const std::unordered_map<std::string, std::vector<MLDat
 
   return match;
 }
+// Get the types of the inputs followed by the outputs of the node. Returns false if an arg exists without a type.
+bool GetArgTypes(const Node& node, InlinedVector<const std::string*>& arg_types) {
+  const auto input_defs = node.InputDefs();
+  const auto output_defs = node.OutputDefs();
+  arg_types.clear();
+  arg_types.reserve(input_defs.size() + output_defs.size());
+  auto add_arg_type = [&arg_types](const NodeArg* arg) {
+    const std::string* arg_type = nullptr;
+    if (arg && arg->Exists()) {
+      arg_type = arg->Type();
+      if (arg_type == nullptr) {
+        return false;
+      }
+    }
+    arg_types.push_back(arg_type);
+    return true;
+  };
+
+  return std::all_of(input_defs.begin(), input_defs.end(), add_arg_type) &&
+         std::all_of(output_defs.begin(), output_defs.end(), add_arg_type);
+}
 }  // namespace
 
 static bool VerifyVersion(int since_ver, const KernelDef& kernel_def, std::string& error_str) {
@@ -185,34 +207,94 @@ Status KernelRegistry::TryFindKernelImpl(const Node& node,
                                          const KernelCreateInfo** out) const {
   const auto& node_provider = node.GetExecutionProviderType();
   const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
-
-  auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
   if (out) *out = nullptr;
 
-  std::vector<std::string> verify_kernel_def_error_strs;
+  // Matching the kernels with the types of the node's args only depends on the signature of the node, so reuse the
+  // match of an earlier node with the same signature.
+  // The explicit type constraints are used by nodes created on the fly, which are not worth caching.
+  InlinedVector<const std::string*> arg_types;
+  const bool use_cache = kernel_type_str_resolver != nullptr && GetArgTypes(node, arg_types);
+  size_t signature_hash = 0;
+  if (use_cache) {
+    HashCombine(std::string_view{node.OpType()}, signature_hash);
+    HashCombine(std::string_view{node.Domain()}, signature_hash);
+    HashCombine(std::string_view{expected_provider}, signature_hash);
+    HashCombine(node.SinceVersion(), signature_hash);
+    for (int input_arg_count : node.InputArgCount()) {
+      HashCombine(input_arg_count, signature_hash);
+    }
+    for (const std::string* arg_type : arg_types) {
+      HashCombine(arg_type, signature_hash);
+    }
+  }
 
-  for (auto i = range.first; i != range.second; ++i) {
-    std::string error_str;
-    if (VerifyKernelDef(node, *i->second.kernel_def, kernel_type_str_resolver, type_constraints, error_str)) {
-      if (out) {
-        *out = &i->second;
+  auto matches_node = [&](const KernelMatch& match) {
+    return match.op_type == node.OpType() && match.domain == node.Domain() && match.provider == expected_provider &&
+           match.since_version == node.SinceVersion() &&
+           std::equal(match.input_arg_counts.begin(), match.input_arg_counts.end(),
+                      node.InputArgCount().begin(), node.InputArgCount().end()) &&
+           match.arg_types == arg_types;
+  };
+
+  const KernelCreateInfo* kernel_create_info = nullptr;
+  std::string errors;
+  bool found_in_cache = false;
+  if (use_cache) {
+    std::lock_guard<std::mutex> lock{kernel_match_cache_mutex_};
+    auto cache_entry = kernel_match_cache_.find(signature_hash);
+    if (cache_entry != kernel_match_cache_.end()) {
+      auto match = std::find_if(cache_entry->second.begin(), cache_entry->second.end(), matches_node);
+      if (match != cache_entry->second.end()) {
+        kernel_create_info = match->kernel_create_info;
+        errors = match->errors;
+        found_in_cache = true;
       }
-      return Status::OK();
     }
+  }
 
-    verify_kernel_def_error_strs.push_back(error_str);
+  if (!found_in_cache) {
+    auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
+    std::ostringstream verify_kernel_def_errors;
+    for (auto i = range.first; i != range.second; ++i) {
+      std::string error_str;
+      if (VerifyKernelDef(node, *i->second.kernel_def, kernel_type_str_resolver, type_constraints, error_str)) {
+        kernel_create_info = &i->second;
+        break;
+      }
+
+      verify_kernel_def_errors << error_str << "\n";
+    }
+
+    if (kernel_create_info == nullptr) {
+      errors = verify_kernel_def_errors.str();
+    }
+
+    if (use_cache) {
+      std::lock_guard<std::mutex> lock{kernel_match_cache_mutex_};
+      auto& matches = kernel_match_cache_[signature_hash];
+      if (std::none_of(matches.begin(), matches.end(), matches_node)) {
+        const auto& input_arg_counts = node.InputArgCount();
+        matches.push_back(KernelMatch{node.OpType(), node.Domain(), expected_provider, node.SinceVersion(),
+                                      InlinedVector<int>(input_arg_counts.begin(), input_arg_counts.end()),
+                                      arg_types, kernel_create_info, errors});
+      }
+    }
   }
 
-  if (!verify_kernel_def_error_strs.empty()) {
+  if (kernel_create_info != nullptr) {
+    if (out) {
+      *out = kernel_create_info;
+    }
+    return Status::OK();
+  }
+
+  if (!errors.empty()) {
     std::ostringstream oss;
     oss << "Op with name (" << node.Name() << ")"
         << " domain (" << node.Domain() << ")"
         << " and type (" << node.OpType() << ")"
         << " kernel is not supported in " << expected_provider << "."
-        << " Encountered following errors: (";
-    std::copy(verify_kernel_def_error_strs.begin(), verify_kernel_def_error_strs.end(),
-              std::ostream_iterator<std::string>(oss, "\n"));
-    oss << ")";
+        << " Encountered following errors: (" << errors << ")";
 
     VLOGS_DEFAULT(2) << "TryFindKernel failed, Reason: " << oss.str();
     return Status(common::ONNXRUNTIME, common::FAIL, oss.str());
@@ -319,6 +401,10 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
   // Register the kernel.
   // Ownership of the KernelDef is transferred to kernel_creator_fn_map_.
   kernel_creator_fn_map_.emplace(key, std::move(create_info));
+
+  // the new kernel may match nodes that matched no kernel or a different one before
+  std::lock_guard<std::mutex> lock{kernel_match_cache_mutex_};
+  kernel_match_cache_.clear();
   return Status::OK();
 }
 
@@ -24,6 +24,10 @@ class MemoryPattern {
  public:
   MemoryPattern() = default;
 
+  // construct from a previously generated pattern, e.g. one loaded from disk.
+  MemoryPattern(InlinedHashMap<int, MemoryBlock> patterns, size_t peak_size)
+      : patterns_{std::move(patterns)}, peak_size_{peak_size} {}
+
   MemoryPattern(MemoryPattern&& rhs) noexcept
       : patterns_{std::move(rhs.patterns_)},
         peak_size_{std::move(rhs.peak_size_)} {}
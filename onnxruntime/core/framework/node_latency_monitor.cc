@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_latency_monitor.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+namespace {
+// weight of a new sample in the baseline is 1/kSmoothing.
+constexpr int64_t kSmoothing = 16;
+}  // namespace
+
+NodeLatencyMonitor::NodeLatencyMonitor(size_t num_nodes, double alert_factor, uint64_t min_alert_ns)
+    : alert_factor_(alert_factor),
+      min_alert_ns_(min_alert_ns),
+      nodes_(std::make_unique<NodeState[]>(num_nodes)) {
+  ORT_ENFORCE(alert_factor_ > 1.0, "The alert factor must be greater than 1. Got ", alert_factor_);
+}
+
+bool NodeLatencyMonitor::Record(NodeIndex node_index, uint64_t duration_ns, Outlier& outlier) noexcept {
+  NodeState& node = nodes_[node_index];
+  const uint64_t num_runs = node.num_runs.fetch_add(1, std::memory_order_relaxed);
+  if (num_runs == 0) {
+    node.baseline_ns.store(duration_ns, std::memory_order_relaxed);
+    return false;
+  }
+
+  const uint64_t baseline_ns = node.baseline_ns.load(std::memory_order_relaxed);
+  const auto alert_threshold_ns = static_cast<uint64_t>(alert_factor_ * static_cast<double>(baseline_ns));
+  const bool is_outlier = num_runs >= kWarmupRuns && duration_ns >= min_alert_ns_ && duration_ns > alert_threshold_ns;
+
+  const auto sample_ns = static_cast<int64_t>(is_outlier ? alert_threshold_ns : duration_ns);
+  const auto new_baseline_ns = static_cast<int64_t>(baseline_ns) +
+                               (sample_ns - static_cast<int64_t>(baseline_ns)) / kSmoothing;
+  node.baseline_ns.store(static_cast<uint64_t>(std::max<int64_t>(new_baseline_ns, 0)), std::memory_order_relaxed);
+
+  if (!is_outlier) {
+    return false;
+  }
+
+  const uint64_t num_outliers = node.num_outliers.fetch_add(1, std::memory_order_relaxed) + 1;
+  outlier.baseline_ns = baseline_ns;
+  outlier.num_outliers = num_outliers;
+  // report the powers of two only
+  return (num_outliers & (num_outliers - 1)) == 0;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+// Flags the runs of a node that take much longer than usual, to find the rare slow paths behind tail latency.
+//
+// Each node keeps a baseline of its compute time, an exponential moving average over about the last 16 runs.
+// After a warmup of kWarmupRuns runs, a run that takes more than alert_factor times the baseline and at least
+// min_alert_ns is an outlier. Outliers enter the baseline clamped to alert_factor times it, so rare slow runs don't
+// inflate it while a lasting slowdown still raises it. Only the 1st, 2nd, 4th, 8th, ... outlier of each node is
+// reported so a node that is often slow doesn't flood the log.
+//
+// Record is lock free. Concurrent runs of the same node may lose an update of the baseline, which only delays it.
+class NodeLatencyMonitor {
+ public:
+  static constexpr uint64_t kWarmupRuns = 32;
+
+  struct Outlier {
+    uint64_t baseline_ns;
+    // number of outliers of the node so far, including this one.
+    uint64_t num_outliers;
+  };
+
+  NodeLatencyMonitor(size_t num_nodes, double alert_factor, uint64_t min_alert_ns);
+
+  // Called by the executor after the kernel of the node computed. Returns true if the run is an outlier that
+  // should be reported, in which case `outlier` is set.
+  bool Record(NodeIndex node_index, uint64_t duration_ns, Outlier& outlier) noexcept;
+
+  uint64_t GetBaselineNs(NodeIndex node_index) const noexcept {
+    return nodes_[node_index].baseline_ns.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetNumberOfOutliers(NodeIndex node_index) const noexcept {
+    return nodes_[node_index].num_outliers.load(std::memory_order_relaxed);
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeLatencyMonitor);
+
+ private:
+  struct NodeState {
+    std::atomic<uint64_t> num_runs{0};
+    std::atomic<uint64_t> baseline_ns{0};
+    std::atomic<uint64_t> num_outliers{0};
+  };
+
+  const double alert_factor_;
+  const uint64_t min_alert_ns_;
+  // indexed by NodeIndex.
+  std::unique_ptr<NodeState[]> nodes_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/parallel_node_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "core/framework/sequential_executor.h"
+#include "core/framework/stream_execution_context.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+// cost used for nodes that haven't been timed yet, so the first run prefers the longest chain of nodes.
+constexpr int64_t kDefaultNodeCostNs = 1000;
+}  // namespace
+
+struct ParallelNodeScheduler::RunState {
+  RunState(StreamExecutionContext& ctx_in, SessionScope& session_scope_in, concurrency::ThreadPool* tp_in,
+           const bool& terminate_flag_in, size_t num_nodes)
+      : ctx(ctx_in),
+        session_scope(session_scope_in),
+        tp(tp_in),
+        terminate_flag(terminate_flag_in),
+        pending(std::make_unique<std::atomic_int[]>(num_nodes)),
+        priorities(num_nodes, 0) {}
+
+  StreamExecutionContext& ctx;
+  SessionScope& session_scope;
+  concurrency::ThreadPool* tp;
+  const bool& terminate_flag;
+  // indexed by NodeIndex. producers that haven't completed yet.
+  std::unique_ptr<std::atomic_int[]> pending;
+  // indexed by NodeIndex. estimated time from the start of the node to the end of the graph.
+  std::vector<int64_t> priorities;
+};
+
+std::unique_ptr<ParallelNodeScheduler> ParallelNodeScheduler::Create(const SequentialExecutionPlan& plan,
+                                                                     const GraphViewer& graph_viewer) {
+  const SequentialExecutionPlan::LogicStream* stream = nullptr;
+  for (const auto& logic_stream : plan.execution_plan) {
+    if (logic_stream && !logic_stream->steps_.empty()) {
+      if (stream != nullptr) {
+        return nullptr;
+      }
+      stream = logic_stream.get();
+    }
+  }
+
+  if (stream == nullptr || stream->device_.Type() != OrtDevice::CPU) {
+    return nullptr;
+  }
+
+  // a single stream has no synchronization steps, so there must be exactly one step per node.
+  if (stream->steps_.size() != static_cast<size_t>(graph_viewer.NumberOfNodes())) {
+    return nullptr;
+  }
+
+  std::unique_ptr<ParallelNodeScheduler> scheduler(new ParallelNodeScheduler());
+  const auto num_node_indices = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+  scheduler->dependency_counts_.assign(num_node_indices, -1);
+  scheduler->successors_.resize(num_node_indices);
+  scheduler->node_costs_ = std::make_unique<std::atomic<int64_t>[]>(num_node_indices);
+  scheduler->nodes_.reserve(stream->steps_.size());
+
+  for (const auto& step : stream->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    const auto* node = graph_viewer.GetNode(node_index);
+    if (node == nullptr || scheduler->dependency_counts_[node_index] != -1) {
+      return nullptr;
+    }
+
+    scheduler->nodes_.push_back(node_index);
+    scheduler->dependency_counts_[node_index] = static_cast<int>(node->GetInputEdgesCount());
+    scheduler->node_costs_[node_index].store(kDefaultNodeCostNs, std::memory_order_relaxed);
+    for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
+      scheduler->successors_[node_index].push_back(it->GetNode().Index());
+    }
+  }
+
+  return scheduler;
+}
+
+int64_t ParallelNodeScheduler::GetNodeCost(NodeIndex node_index) const {
+  return node_costs_[node_index].load(std::memory_order_relaxed);
+}
+
+Status ParallelNodeScheduler::Execute(StreamExecutionContext& ctx, SessionScope& session_scope,
+                                      concurrency::ThreadPool* tp, const bool& terminate_flag) const {
+  RunState state(ctx, session_scope, tp, terminate_flag, dependency_counts_.size());
+
+  // longest path to the end of the graph, walking the topological order backwards.
+  for (auto it = nodes_.rbegin(), end = nodes_.rend(); it != end; ++it) {
+    int64_t longest_successor = 0;
+    for (auto successor : successors_[*it]) {
+      longest_successor = std::max(longest_successor, state.priorities[successor]);
+    }
+    state.priorities[*it] = GetNodeCost(*it) + longest_successor;
+  }
+
+  InlinedVector<NodeIndex> ready;
+  for (auto node_index : nodes_) {
+    state.pending[node_index].store(dependency_counts_[node_index], std::memory_order_relaxed);
+    if (dependency_counts_[node_index] == 0) {
+      ready.push_back(node_index);
+    }
+  }
+
+  std::sort(ready.begin(), ready.end(), [&state](NodeIndex a, NodeIndex b) {
+    return state.priorities[a] > state.priorities[b];
+  });
+
+  // the context was created with one task for the stream. it is completed once all entry nodes are scheduled
+  // so WaitAll can't return before the last node has finished.
+  for (auto node_index : ready) {
+    ctx.AddTask();
+    concurrency::ThreadPool::Schedule(tp, [this, &state, node_index]() {
+      RunNode(state, node_index);
+    });
+  }
+  ctx.CompleteTask();
+
+  ctx.WaitAll();
+  return Status::OK();
+}
+
+void ParallelNodeScheduler::RunNode(RunState& state, NodeIndex node_index) const {
+  auto& ctx = state.ctx;
+  InlinedVector<NodeIndex> ready;
+
+  for (;;) {
+    if (!ctx.TaskStatus().IsOK()) {
+      ctx.CompleteTask();
+      return;
+    }
+
+    if (state.terminate_flag) {
+      Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      ctx.SetStatus(status_made);
+      ctx.CompleteTask();
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Status status;
+    ORT_TRY {
+      status = ExecuteKernel(ctx, node_index, 0, state.terminate_flag, state.session_scope);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    if (!status.IsOK()) {
+      ctx.SetStatus(status);
+      ctx.CompleteTask();
+      return;
+    }
+
+    const int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+    auto& cost = node_costs_[node_index];
+    cost.store((cost.load(std::memory_order_relaxed) * 7 + elapsed) / 8, std::memory_order_relaxed);
+
+    ready.clear();
+    for (auto successor : successors_[node_index]) {
+      if (state.pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ready.push_back(successor);
+      }
+    }
+
+    if (ready.empty()) {
+      ctx.CompleteTask();
+      return;
+    }
+
+    auto most_critical = std::max_element(ready.begin(), ready.end(), [&state](NodeIndex a, NodeIndex b) {
+      return state.priorities[a] < state.priorities[b];
+    });
+    const NodeIndex next = *most_critical;
+
+    for (auto successor : ready) {
+      if (successor != next) {
+        ctx.AddTask();
+        concurrency::ThreadPool::Schedule(state.tp, [this, &state, successor]() {
+          RunNode(state, successor);
+        });
+      }
+    }
+
+    // keep the most critical successor on this thread. the task count carries over to it.
+    node_index = next;
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class SessionScope;
+class StreamExecutionContext;
+
+namespace concurrency {
+class ThreadPool;
+}
+
+// Runs the nodes of a single stream execution plan concurrently on the inter-op thread pool.
+// Used for ORT_PARALLEL sessions whose nodes all run on one CPU stream, where the stream based execution
+// would otherwise run every node on one thread.
+//
+// Each node has a counter of unfinished producers. When a node completes, the successors it makes ready
+// are ordered by the length of their remaining critical path: the longest is continued on the current thread
+// and the others are pushed to the thread pool, whose per-thread work-stealing queues spread them out.
+// The critical path is estimated from the kernel times measured in previous runs.
+class ParallelNodeScheduler {
+ public:
+  // Returns nullptr if the plan isn't suitable, i.e. it is not a single stream of kernel launches.
+  static std::unique_ptr<ParallelNodeScheduler> Create(const SequentialExecutionPlan& plan,
+                                                       const GraphViewer& graph_viewer);
+
+  // Executes all nodes. Must be called with a context created for a single stream.
+  Status Execute(StreamExecutionContext& ctx, SessionScope& session_scope,
+                 concurrency::ThreadPool* tp, const bool& terminate_flag) const;
+
+  // Estimated cost of a node in nanoseconds. Exposed for testing.
+  int64_t GetNodeCost(NodeIndex node_index) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelNodeScheduler);
+
+ private:
+  struct RunState;
+
+  ParallelNodeScheduler() = default;
+
+  void RunNode(RunState& state, NodeIndex node_index) const;
+
+  // nodes in the order of the stream, which is a topological order.
+  InlinedVector<NodeIndex> nodes_;
+  // indexed by NodeIndex. number of input edges from other nodes.
+  std::vector<int> dependency_counts_;
+  // indexed by NodeIndex. one entry per output edge.
+  std::vector<InlinedVector<NodeIndex>> successors_;
+  // indexed by NodeIndex. exponential moving average of the measured kernel time.
+  // updated from all runs without synchronization beyond the atomics as it is only a scheduling hint.
+  std::unique_ptr<std::atomic<int64_t>[]> node_costs_;
+};
+}  // namespace onnxruntime
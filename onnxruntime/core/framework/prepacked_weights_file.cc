@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace {
+constexpr char kPrepackedWeightsFileMagic[8] = {'O', 'R', 'T', 'P', 'R', 'E', 'P', 'K'};
+constexpr uint32_t kPrepackedWeightsFileVersion = 1;
+// buffers are aligned in the file so they are aligned in the mapping, which starts at a page boundary.
+constexpr uint64_t kBufferAlignment = 64;
+
+// the packed layouts depend on the MLAS kernels, which are selected based on the build and the CPU features.
+std::string GetFingerprint() {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream ss;
+  ss << ORT_VERSION << ";" << sizeof(void*)
+     << ";" << cpuid_info.HasAVX() << cpuid_info.HasAVX2() << cpuid_info.HasAVX512f()
+     << cpuid_info.HasAVX512Skylake() << cpuid_info.HasAVX512_BF16() << cpuid_info.HasAMX_BF16()
+     << cpuid_info.HasF16C() << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1()
+     << cpuid_info.HasArmNeonDot() << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM()
+     << cpuid_info.HasArmNeon_BF16();
+  return ss.str();
+}
+
+void HashUpdate(uint32_t (&hash)[4], const void* data, size_t size) {
+  // MurmurHash3 takes an int length, so large initializers are hashed in chunks.
+  constexpr size_t kChunkSize = size_t{1} << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  size_t offset = 0;
+  do {
+    const size_t chunk_size = std::min(kChunkSize, size - offset);
+    MurmurHash3::x86_128(bytes + offset, static_cast<int>(chunk_size), hash[0], hash);
+    offset += chunk_size;
+  } while (offset < size);
+}
+
+void HashUpdate(uint32_t (&hash)[4], const std::string& value) {
+  HashUpdate(hash, value.data(), value.size());
+}
+
+// bounds checked reads from the mapped file.
+struct FileReader {
+  const char* data;
+  size_t size;
+  size_t pos = 0;
+
+  template <typename T>
+  bool Read(T& value) {
+    if (size - pos < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  bool Read(std::string& value, uint32_t length) {
+    if (size - pos < length) {
+      return false;
+    }
+    value.assign(data + pos, length);
+    pos += length;
+    return true;
+  }
+};
+
+template <typename T>
+void Write(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}  // namespace
+
+std::string PrepackedWeightsFile::GenerateKey(const Node& node, int input_idx, const Tensor& tensor) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  HashUpdate(hash, node.Domain());
+  HashUpdate(hash, node.GetExecutionProviderType());
+  const int since_version = node.SinceVersion();
+  HashUpdate(hash, &since_version, sizeof(since_version));
+  HashUpdate(hash, &input_idx, sizeof(input_idx));
+
+  // attributes such as transB change the packed layout.
+  const auto& attributes = node.GetAttributes();
+  std::vector<std::string> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end());
+  for (const auto& name : attribute_names) {
+    HashUpdate(hash, name);
+    HashUpdate(hash, attributes.at(name).SerializeAsString());
+  }
+
+  const int32_t element_type = tensor.GetElementType();
+  HashUpdate(hash, &element_type, sizeof(element_type));
+  const auto dims = tensor.Shape().GetDims();
+  HashUpdate(hash, dims.data(), dims.size_bytes());
+  HashUpdate(hash, tensor.DataRaw(), tensor.SizeInBytes());
+
+  std::ostringstream ss;
+  ss << node.OpType() << "+" << std::hex << std::setfill('0');
+  for (int i = 3; i >= 0; --i) {
+    ss << std::setw(8) << hash[i];
+  }
+  return ss.str();
+}
+
+void PrepackedWeightsFile::Load(const logging::Logger& logger) {
+  std::error_code ec;
+  const auto file_size = std::filesystem::file_size(file_path_, ec);
+  if (ec) {
+    // first session with this file. it is created once the weights are packed.
+    return;
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  auto status = Env::Default().MapFileIntoMemory(file_path_.c_str(), 0, static_cast<size_t>(file_size), mapped_file);
+  if (!status.IsOK()) {
+    LOGS(logger, WARNING) << "Failed to map pre-packed weights file " << ToUTF8String(file_path_) << ": "
+                          << status.ErrorMessage();
+    return;
+  }
+
+  FileReader reader{mapped_file.get(), static_cast<size_t>(file_size)};
+  char magic[sizeof(kPrepackedWeightsFileMagic)];
+  uint32_t version = 0;
+  uint32_t fingerprint_length = 0;
+  std::string fingerprint;
+  if (!reader.Read(magic) || std::memcmp(magic, kPrepackedWeightsFileMagic, sizeof(magic)) != 0 ||
+      !reader.Read(version) || version != kPrepackedWeightsFileVersion ||
+      !reader.Read(fingerprint_length) || !reader.Read(fingerprint, fingerprint_length)) {
+    LOGS(logger, WARNING) << "Ignoring pre-packed weights file " << ToUTF8String(file_path_)
+                          << " as it is not in the expected format.";
+    return;
+  }
+
+  if (fingerprint != GetFingerprint()) {
+    LOGS(logger, INFO) << "Ignoring pre-packed weights file " << ToUTF8String(file_path_)
+                       << " as it was created by another build or for another CPU.";
+    return;
+  }
+
+  uint64_t num_entries = 0;
+  bool valid = reader.Read(num_entries);
+  std::unordered_map<std::string, Entry> entries;
+  for (uint64_t i = 0; valid && i < num_entries; ++i) {
+    uint32_t key_length = 0;
+    uint32_t num_buffers = 0;
+    std::string key;
+    valid = reader.Read(key_length) && reader.Read(key, key_length) && reader.Read(num_buffers);
+
+    Entry entry;
+    for (uint32_t b = 0; valid && b < num_buffers; ++b) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      // never hand out a buffer outside of the mapping
+      valid = reader.Read(offset) && reader.Read(size) && offset <= file_size && size <= file_size - offset;
+      if (valid) {
+        entry.buffers.push_back(size == 0 ? nullptr : mapped_file.get() + offset);
+        entry.buffer_sizes.push_back(static_cast<size_t>(size));
+      }
+    }
+
+    if (valid) {
+      entries.emplace(std::move(key), std::move(entry));
+    }
+  }
+
+  if (!valid) {
+    LOGS(logger, WARNING) << "Ignoring pre-packed weights file " << ToUTF8String(file_path_)
+                          << " as it is truncated or corrupt.";
+    return;
+  }
+
+  mapped_file_ = std::move(mapped_file);
+  entries_ = std::move(entries);
+}
+
+void PrepackedWeightsFile::Save(const logging::Logger& logger) const {
+  if (added_weights_.empty()) {
+    return;
+  }
+
+  const std::string fingerprint = GetFingerprint();
+  uint64_t header_size = sizeof(kPrepackedWeightsFileMagic) + sizeof(uint32_t) * 2 + fingerprint.size() +
+                         sizeof(uint64_t);
+  for (const auto& entry : entries_) {
+    header_size += sizeof(uint32_t) * 2 + entry.first.size() + entry.second.buffers.size() * sizeof(uint64_t) * 2;
+  }
+
+  // write to a temporary file first so a concurrent reader or a crash never sees a partial file.
+  // the loaded entries point into the mapping of the current file, which stays valid after the rename.
+  PathString tmp_path = file_path_ + ORT_TSTR(".tmp");
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      LOGS(logger, WARNING) << "Failed to open " << ToUTF8String(tmp_path) << " to save pre-packed weights.";
+      return;
+    }
+
+    out.write(kPrepackedWeightsFileMagic, sizeof(kPrepackedWeightsFileMagic));
+    Write(out, kPrepackedWeightsFileVersion);
+    Write(out, static_cast<uint32_t>(fingerprint.size()));
+    out.write(fingerprint.data(), fingerprint.size());
+    Write(out, static_cast<uint64_t>(entries_.size()));
+
+    uint64_t offset = header_size;
+    for (const auto& entry : entries_) {
+      Write(out, static_cast<uint32_t>(entry.first.size()));
+      out.write(entry.first.data(), entry.first.size());
+      Write(out, static_cast<uint32_t>(entry.second.buffers.size()));
+      for (size_t size : entry.second.buffer_sizes) {
+        offset = (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+        Write(out, offset);
+        Write(out, static_cast<uint64_t>(size));
+        offset += size;
+      }
+    }
+
+    offset = header_size;
+    const char padding[kBufferAlignment] = {};
+    for (const auto& entry : entries_) {
+      for (size_t b = 0; b < entry.second.buffers.size(); ++b) {
+        const uint64_t aligned_offset = (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+        out.write(padding, static_cast<std::streamsize>(aligned_offset - offset));
+        out.write(static_cast<const char*>(entry.second.buffers[b]),
+                  static_cast<std::streamsize>(entry.second.buffer_sizes[b]));
+        offset = aligned_offset + entry.second.buffer_sizes[b];
+      }
+    }
+
+    if (!out) {
+      LOGS(logger, WARNING) << "Failed to write pre-packed weights to " << ToUTF8String(tmp_path);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, file_path_, ec);
+  if (ec) {
+    LOGS(logger, WARNING) << "Failed to save pre-packed weights to " << ToUTF8String(file_path_) << ": "
+                          << ec.message();
+  }
+}
+
+bool PrepackedWeightsFile::GetBuffers(const std::string& key, std::vector<BufferUniquePtr>& buffers,
+                                      std::vector<size_t>& buffer_sizes) const {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  buffers.clear();
+  for (const void* buffer : it->second.buffers) {
+    // BufferDeleter is nullptr because the buffers are owned by this instance
+    buffers.emplace_back(const_cast<void*>(buffer), BufferDeleter(nullptr));
+  }
+  buffer_sizes = it->second.buffer_sizes;
+  return true;
+}
+
+const PrePackedWeights& PrepackedWeightsFile::AddWeights(const std::string& key, PrePackedWeights&& weights) {
+  added_weights_.push_back(std::make_unique<PrePackedWeights>(std::move(weights)));
+  const auto& added = *added_weights_.back();
+
+  Entry entry;
+  for (size_t i = 0; i < added.buffers_.size(); ++i) {
+    entry.buffers.push_back(added.buffers_[i].get());
+    entry.buffer_sizes.push_back(added.buffer_sizes_[i]);
+  }
+  entries_.insert_or_assign(key, std::move(entry));
+  return added;
+}
+
+}  // namespace onnxruntime
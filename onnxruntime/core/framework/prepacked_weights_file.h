@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+#include "core/platform/path_lib.h"
+
+namespace onnxruntime {
+class Node;
+class Tensor;
+
+namespace logging {
+class Logger;
+}
+
+// Pre-packed weights persisted to a file so later sessions can skip OpKernel::PrePack().
+//
+// Each entry is keyed by the node's op type, domain, version, execution provider and attributes, the input index
+// and a hash of the initializer. The file is mapped into memory when loaded and kernels use the buffers in the
+// mapping directly. The file records the ORT version and the CPU features the weights were packed for, since the
+// packed layouts of MLAS depend on the kernels selected for the CPU. A file written for another build or CPU is
+// ignored and rewritten.
+class PrepackedWeightsFile {
+ public:
+  explicit PrepackedWeightsFile(PathString file_path) : file_path_(std::move(file_path)) {}
+
+  // Maps the file, if it exists. A file that can't be used is ignored with a warning.
+  void Load(const logging::Logger& logger);
+
+  // Writes the loaded and the added weights to the file if any weights were added.
+  void Save(const logging::Logger& logger) const;
+
+  static std::string GenerateKey(const Node& node, int input_idx, const Tensor& tensor);
+
+  // Returns false if there are no weights for the key. The returned buffers don't own the memory.
+  bool GetBuffers(const std::string& key, std::vector<BufferUniquePtr>& buffers,
+                  std::vector<size_t>& buffer_sizes) const;
+
+  // Takes ownership of weights produced by PrePack() so they are saved. The returned reference is valid for the
+  // lifetime of this instance.
+  const PrePackedWeights& AddWeights(const std::string& key, PrePackedWeights&& weights);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFile);
+
+ private:
+  struct Entry {
+    std::vector<const void*> buffers;
+    std::vector<size_t> buffer_sizes;
+  };
+
+  const PathString file_path_;
+  Env::MappedMemoryPtr mapped_file_;
+  std::unordered_map<std::string, Entry> entries_;
+  // owns the buffers of the entries that weren't in the file.
+  std::vector<std::unique_ptr<PrePackedWeights>> added_weights_;
+};
+
+}  // namespace onnxruntime
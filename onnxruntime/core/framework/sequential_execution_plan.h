@@ -35,6 +35,10 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // view_of is valid only if alloc_kind == kReuse. If it is not -1, the data of this OrtValue starts at the data of
+  // the OrtValue view_of instead of the start of reused_buffer. It is set for the outputs that are views of a
+  // sub-range of an input, see KernelDefBuilder::MayViewOutputs(), and for the values reusing such a view.
+  OrtValueIndex view_of{-1};
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   IntervalT life_interval{0, 0};
   IntervalT allocate_interval{0, 0};
@@ -94,6 +98,18 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // The following vector is indexed by OrtValueIndex
   std::vector<AllocPlanPerValue> allocation_plan;
 
+  // Values that use the buffer of an input the kernel updates in place (KernelDef::MayInplace) instead of a buffer
+  // of their own. num_bytes is the memory this saves for the values with a static shape.
+  struct InplaceReuseStats {
+    size_t num_values{0};
+    size_t num_bytes{0};
+  };
+  InplaceReuseStats inplace_reuse_stats;
+
+  // The node order picked by the planner to keep the live set small when the memory aware node order is enabled.
+  // The execution plan and the allocation plan follow it. Empty if the topological order for the ExecutionOrder is used.
+  std::vector<NodeIndex> memory_aware_node_order;
+
   // The following vector contains any initializer tensors that must be allocated sequentially.
   std::vector<OrtValueIndex> initializer_allocation_order;
 
@@ -117,6 +133,8 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
                            const bool& terminate_flag,
                            bool& continue_flag) = 0;
     virtual std::string ToString() const = 0;
+    // true if the step runs the kernel of its node
+    virtual bool LaunchesKernel() const { return false; }
     inline NodeIndex GetNodeIndex() { return node_index_; }
 
    protected:
@@ -10,11 +10,14 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/bfc_arena.h"
+#include "core/framework/cold_initializer_evictor.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/tracepoints.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -90,6 +93,19 @@ static void CalculateTotalOutputSizes(OpKernelContextInternal* op_kernel_context
   output_type_shape = ss.str();
 }
 
+// Output sizes without the type and shape strings of CalculateTotalOutputSizes, cheap enough to run for every kernel.
+static uint64_t CalculateTotalOutputBytes(OpKernelContextInternal& op_kernel_context) {
+  uint64_t total_output_bytes = 0;
+  const int output_count = op_kernel_context.OutputCount();
+  for (int i = 0; i < output_count; i++) {
+    const OrtValue* p_output = op_kernel_context.GetOutputMLValue(i);
+    if (p_output != nullptr && p_output->IsTensor()) {
+      total_output_bytes += p_output->Get<Tensor>().SizeInBytes();
+    }
+  }
+  return total_output_bytes;
+}
+
 static void CalculateTotalInputSizes(const OpKernelContextInternal* op_kernel_context,
                                      const onnxruntime::OpKernel* p_op_kernel,
                                      size_t& input_activation_sizes, size_t& input_parameter_sizes,
@@ -351,6 +367,20 @@ class KernelScope {
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
+      profiled_allocator_ = session_state_.GetAllocator(kernel_.Info().GetDevice(OrtMemTypeDefault));
+      if (profiled_allocator_ != nullptr) {
+        profiled_allocator_->GetStats(&allocator_stats_begin_);
+      }
+    }
+
+    if (auto* evictor = session_state_.GetColdInitializerEvictor(); evictor != nullptr) {
+      evictor->MarkUsed(session_state_.GetColdInitializerSlots(kernel_.Node().Index()));
+    }
+
+    kernel_stats_ = session_state_.GetKernelStatistics(kernel_.Node().Index());
+    latency_monitor_ = session_state_.GetNodeLatencyMonitor();
+    if (kernel_stats_ != nullptr || latency_monitor_ != nullptr) {
+      compute_begin_time_ = std::chrono::steady_clock::now();
     }
   }
 
@@ -361,10 +391,35 @@ class KernelScope {
     node_compute_range_.End();
 #endif
 
+    if (kernel_stats_ != nullptr || latency_monitor_ != nullptr) {
+      const auto duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                         std::chrono::steady_clock::now() - compute_begin_time_)
+                                                         .count());
+      if (kernel_stats_ != nullptr) {
+        kernel_stats_->Record(duration_ns, CalculateTotalOutputBytes(kernel_context_));
+      }
+
+      NodeLatencyMonitor::Outlier outlier;
+      if (latency_monitor_ != nullptr && latency_monitor_->Record(kernel_.Node().Index(), duration_ns, outlier)) {
+        LogNodeLatencyOutlier(duration_ns, outlier);
+      }
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
+      // the arena stats are per allocator, so with parallel execution they include the concurrent nodes
+      AllocatorStats allocator_stats_end;
+      if (profiled_allocator_ != nullptr) {
+        profiled_allocator_->GetStats(&allocator_stats_end);
+      }
+      const int64_t allocated_bytes =
+          allocator_stats_end.total_allocated_bytes - allocator_stats_begin_.total_allocated_bytes;
+      const int64_t freed_bytes =
+          allocated_bytes - (allocator_stats_end.bytes_in_use - allocator_stats_begin_.bytes_in_use);
+      const int64_t peak_increase_bytes =
+          allocator_stats_end.max_bytes_in_use - allocator_stats_begin_.max_bytes_in_use;
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_kernel_time",
                                      kernel_begin_time_,
@@ -378,6 +433,9 @@ class KernelScope {
                                          {"output_size", std::to_string(total_output_sizes_)},
                                          {"input_type_shape", input_type_shape_},
                                          {"output_type_shape", output_type_shape_},
+                                         {"allocated_bytes", std::to_string(allocated_bytes)},
+                                         {"freed_bytes", std::to_string(freed_bytes)},
+                                         {"peak_increase_bytes", std::to_string(peak_increase_bytes)},
                                          {"thread_scheduling_stats",
                                           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
                                      });
@@ -408,6 +466,23 @@ class KernelScope {
   }  //~KernelScope
 
  private:
+  // The shapes are only computed for the outliers that are reported, so the monitor stays cheap.
+  void LogNodeLatencyOutlier(uint64_t duration_ns, const NodeLatencyMonitor::Outlier& outlier) {
+    const auto& node = kernel_.Node();
+    size_t input_activation_sizes = 0;
+    size_t input_parameter_sizes = 0;
+    size_t total_output_sizes = 0;
+    std::string input_type_shape;
+    std::string output_type_shape;
+    CalculateTotalInputSizes(&kernel_context_, &kernel_, input_activation_sizes, input_parameter_sizes,
+                             node.Name(), input_type_shape);
+    CalculateTotalOutputSizes(&kernel_context_, total_output_sizes, node.Name(), output_type_shape);
+    LOGS(session_state_.Logger(), WARNING)
+        << "Slow run of node '" << node.Name() << "' (" << node.OpType() << ", " << node.GetExecutionProviderType()
+        << "): " << duration_ns / 1000 << "us, baseline " << outlier.baseline_ns / 1000 << "us. Outlier "
+        << outlier.num_outliers << " of the node. Inputs: " << input_type_shape << " Outputs: " << output_type_shape;
+  }
+
   TimePoint kernel_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
@@ -419,6 +494,12 @@ class KernelScope {
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
   std::string input_type_shape_;
+  AllocatorPtr profiled_allocator_;
+  AllocatorStats allocator_stats_begin_;
+
+  profiling::KernelStatistics::OpStats* kernel_stats_{};
+  NodeLatencyMonitor* latency_monitor_{};
+  std::chrono::steady_clock::time_point compute_begin_time_;
 
 #ifdef CONCURRENCY_VISUALIZER
   diagnostic::span span_;
@@ -457,10 +538,12 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                      ctx.GetDeviceStream(stream_idx));
   onnxruntime::Status status;
   auto& logger = ctx.GetLogger();
+  ORT_TRACEPOINT(node_start, idx, p_kernel->KernelDef().OpName().c_str(), p_kernel->KernelDef().Provider().c_str());
   if (p_kernel->IsAsync()) {
     ORT_THROW("Async Kernel Support is not implemented yet.");
   } else {
     KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
+    ArenaTracingNodeScope arena_tracing_scope(p_kernel->Node().Name());
     ORT_TRY {
 #ifdef ENABLE_TRAINING
       // AllocateInputsContiguously - is only required for NCCL kernels
@@ -501,6 +584,7 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
       });
     }
   }
+  ORT_TRACEPOINT(node_end, idx, p_kernel->KernelDef().OpName().c_str(), static_cast<int>(status.Code()));
   if (!status.IsOK()) {
     std::ostringstream ss;
     const auto& node = p_kernel->Node();
@@ -578,16 +662,27 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  // run the nodes of a single CPU stream concurrently instead of one after the other
+  const auto* parallel_node_scheduler = session_state.GetParallelNodeScheduler();
+  bool run_nodes_in_parallel = tp != nullptr && parallel_node_scheduler != nullptr;
+#ifdef ENABLE_TRAINING
+  run_nodes_in_parallel = run_nodes_in_parallel && ctx.GetNodeToExecute() == nullptr;
+#endif
+
+  if (run_nodes_in_parallel) {
+    ORT_RETURN_IF_ERROR(parallel_node_scheduler->Execute(ctx, session_scope, tp, terminate_flag));
+  } else {
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
   }
 
@@ -608,6 +703,9 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (ctx.GetExecutionFrame().HasMemoryPatternMiss()) {
+    // the cached pattern for this shape bucket is too small. drop it so the next run traces a larger one.
+    session_state.ResetMemoryPatternGroup(feeds);
   }
 
   return Status::OK();
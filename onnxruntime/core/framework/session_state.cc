@@ -3,17 +3,27 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
+#include "core/common/path_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/cold_initializer_evictor.h"
+#include "core/framework/execution_plan_snapshot.h"
+#include "core/framework/frozen_state_allocator.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/prepacked_weights_file.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -87,6 +97,19 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  mem_pattern_shape_bucket_size_ = ParseStringWithClassicLocale<int64_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternShapeBucketSize, "0"));
+  ORT_ENFORCE(mem_pattern_shape_bucket_size_ >= 0, "Invalid ", kOrtSessionOptionsMemoryPatternShapeBucketSize,
+              " value of ", mem_pattern_shape_bucket_size_);
+  const auto memory_budget = ParseStringWithClassicLocale<int64_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryBudgetBytes, "0"));
+  ORT_ENFORCE(memory_budget >= 0, "Invalid ", kOrtSessionOptionsMemoryBudgetBytes, " value of ", memory_budget);
+  memory_budget_ = static_cast<size_t>(memory_budget);
+  chain_parallel_sections_ =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsChainParallelSections, "0") == "1";
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsParallelInitialization, "0") == "1") {
+    initialization_thread_pool_ = thread_pool_;
+  }
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -114,6 +137,15 @@ AllocatorPtr SessionState::GetAllocator(const OrtDevice& device) const noexcept
   return nullptr;
 }
 
+AllocatorPtr SessionState::GetInitializerAllocator(const OrtDevice& device) const noexcept {
+  if (frozen_state_allocator_ != nullptr && device.Type() == OrtDevice::CPU &&
+      device.MemType() == OrtDevice::MemType::DEFAULT) {
+    return frozen_state_allocator_;
+  }
+
+  return GetAllocator(device);
+}
+
 void SessionState::UpdateAllocatorsWithEnvAllocators(const std::vector<AllocatorPtr>& env_allocators) {
   for (const auto& env_alloc : env_allocators) {
     (*allocators_)[env_alloc->Info().device] = env_alloc;
@@ -222,7 +254,15 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
+    // CPU kernels are created in parallel if enabled. other execution providers may not support concurrent
+    // kernel creation.
+    InlinedVector<const Node*> cpu_nodes;
     for (const auto& node : nodes) {
+      if (initialization_thread_pool_ != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        cpu_nodes.push_back(&node);
+        continue;
+      }
+
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -233,6 +273,17 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       // assumes vector is already resize()'ed to the number of nodes in the graph
       ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
     }
+
+    if (!cpu_nodes.empty()) {
+      const IExecutionProvider& cpu_provider = *execution_providers_.Get(kCpuExecutionProvider);
+      ORT_RETURN_IF_ERROR(session_state_utils::ParallelForWithStatus(
+          initialization_thread_pool_, cpu_nodes.size(), [&](size_t i) -> Status {
+            const Node& node = *cpu_nodes[i];
+            return kernel_registry_manager.CreateKernel(node, cpu_provider, *this,
+                                                        GetNodeKernelCreateInfo(node.Index()),
+                                                        session_kernels_[node.Index()]);
+          }));
+    }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
   return Status::OK();
@@ -396,116 +447,156 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
-                                        bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
-    for (auto& node : GetGraphViewer().Nodes()) {
-      auto kernel = GetMutableKernel(node.Index());
-      int input_idx = 0;
-      for (auto& input_def : node.InputDefs()) {
-        if (input_def->Exists()) {
-          const std::string& input_name = input_def->Name();
-          SessionState* st = this;
-          // subgraph can use the value from outer scope,
-          // so it needs to check if current node uses constant initialized tensor from current and outer graphs
-          do {
-            int ort_value_idx;
-            if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
-              std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
-
-              if (constant_initialized_tensors.count(ort_value_idx)) {
-                bool is_packed = false;
-                const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
-
-                auto iter = initializers_to_share_map.find(input_name);
-                bool is_shared_initializer = (iter != initializers_to_share_map.end());
-
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
-                    node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
-
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
-                  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+  // guards the initializers, the counters and the pre-packed weights file when nodes are pre-packed in parallel.
+  // PrePack() itself runs without holding it.
+  OrtMutex prepack_mutex;
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     &prepack_mutex](const Node& node,
+                                                     bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+    auto kernel = GetMutableKernel(node.Index());
+    int input_idx = 0;
+    for (auto& input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        const std::string& input_name = input_def->Name();
+        SessionState* st = this;
+        // subgraph can use the value from outer scope,
+        // so it needs to check if current node uses constant initialized tensor from current and outer graphs
+        do {
+          int ort_value_idx;
+          if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+            std::unique_lock<OrtMutex> lock(prepack_mutex);
+            std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
+
+            if (constant_initialized_tensors.count(ort_value_idx)) {
+              bool is_packed = false;
+              const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
+
+              auto iter = initializers_to_share_map.find(input_name);
+              bool is_shared_initializer = (iter != initializers_to_share_map.end());
+
+              // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
+              if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                  node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
+
+                AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+                ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+
+                PrePackedWeights weights_to_be_filled_in;
+                // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+                // cached by another instance of the same op_type (for the same constant initializer) is because
+                // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+                // weight with the pre-packed weight generated by this instance of the same op_type because other static
+                // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+                ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
+                                                    is_packed,
+                                                    &weights_to_be_filled_in));
 
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
+                if (is_packed) {
+                  // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+                  ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                              " doesn't have an implementation that can cache computed pre-packed weights");
 
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
+                  const auto& op_type = node.OpType();
 
-                    const auto& op_type = node.OpType();
+                  // Sanity check
+                  // TODO: Check if some version of the ONNX IR allows op_type to be empty
+                  ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
 
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+                  // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+                  // that we just got by invoking PrePack() on this kernel.
 
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
+                  const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                                         weights_to_be_filled_in);
 
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
+                  bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
 
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+                  if (container_contains_packed_weight) {
+                    LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
+                                        << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
 
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                        prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                        node.Name()));
 
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
+                    ++used_shared_pre_packed_weights_counter_;
+                  } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
 
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+                    if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+                      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+                    }
 
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
-                      }
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                        prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                        node.Name()));
+                  }
+                }
 
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-                    }
+              } else if (prepacked_weights_file_ != nullptr &&
+                         node.GetExecutionProviderType() == kCpuExecutionProvider) {  // persisting of pre-packed weights' turned ON
+                lock.unlock();
+                const std::string key = PrepackedWeightsFile::GenerateKey(node, input_idx, const_initialized_tensor);
+                lock.lock();
+
+                std::vector<BufferUniquePtr> persisted_buffers;
+                std::vector<size_t> persisted_buffer_sizes;
+                if (prepacked_weights_file_->GetBuffers(key, persisted_buffers, persisted_buffer_sizes)) {
+                  ORT_RETURN_IF_ERROR(kernel->RestorePrePackedBuffers(const_initialized_tensor, input_idx,
+                                                                      persisted_buffers, persisted_buffer_sizes,
+                                                                      is_packed));
+                  if (is_packed) {
+                    ++used_persisted_pre_packed_weights_counter_;
                   }
+                }
 
-                } else {  // caching of pre-packed weights' turned OFF
-                  AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
-                                                      session_cpu_alloc,  // use allocator tied to this session
+                if (!is_packed) {
+                  AllocatorPtr session_cpu_alloc =
+                      GetInitializerAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                  PrePackedWeights weights_to_be_filled_in;
+                  lock.unlock();
+                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, session_cpu_alloc,
                                                       is_packed,
-                                                      nullptr  // no caching required
-                                                      ));
-                }
-                if (is_packed) {
-                  ++number_of_prepacks_counter_;
+                                                      &weights_to_be_filled_in));
+                  lock.lock();
 
-                  if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
-                    // release the constant initialized tensor
-                    st->initialized_tensors_.erase(ort_value_idx);
-                    constant_initialized_tensors.erase(ort_value_idx);
+                  // kernels that keep the packed data to themselves can't be persisted
+                  if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(
+                        *kernel, input_idx, prepacked_weights_file_->AddWeights(key, std::move(weights_to_be_filled_in)),
+                        node.Name()));
                   }
                 }
+              } else {  // caching of pre-packed weights' turned OFF
+                AllocatorPtr session_cpu_alloc =
+                    GetInitializerAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                lock.unlock();
+                ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                    session_cpu_alloc,  // use allocator tied to this session
+                                                    is_packed,
+                                                    nullptr  // no caching required
+                                                    ));
+                lock.lock();
               }
-              // stop searching in 2 cases:
-              // 1. value is not from OuterScope
-              // 2. value is from OuterScope and the current OuterScope has the value
-              if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
-                break;
+              if (is_packed) {
+                ++number_of_prepacks_counter_;
+
+                if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+                  // release the constant initialized tensor
+                  st->initialized_tensors_.erase(ort_value_idx);
+                  constant_initialized_tensors.erase(ort_value_idx);
+                }
               }
             }
-            st = st->Parent();
-          } while (st);
-        }
-        input_idx++;
+            // stop searching in 2 cases:
+            // 1. value is not from OuterScope
+            // 2. value is from OuterScope and the current OuterScope has the value
+            if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+              break;
+            }
+          }
+          st = st->Parent();
+        } while (st);
       }
+      input_idx++;
     }
 
     return Status::OK();
@@ -517,20 +608,244 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
-  } else {
-    return prepacked_constant_weights(false);
+    for (const auto& node : GetGraphViewer().Nodes()) {
+      ORT_RETURN_IF_ERROR(prepacked_constant_weights(node, true));
+    }
+    return Status::OK();
+  }
+
+  // the kernels of CPU nodes are pre-packed in parallel if enabled. other execution providers may not support it.
+  InlinedVector<const Node*> cpu_nodes;
+  for (const auto& node : GetGraphViewer().Nodes()) {
+    if (initialization_thread_pool_ != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+      cpu_nodes.push_back(&node);
+    } else {
+      ORT_RETURN_IF_ERROR(prepacked_constant_weights(node, false));
+    }
+  }
+
+  return session_state_utils::ParallelForWithStatus(initialization_thread_pool_, cpu_nodes.size(), [&](size_t i) {
+    return prepacked_constant_weights(*cpu_nodes[i], false);
+  });
+}
+
+void SessionState::RegisterColdInitializers(gsl::span<const int> external_initializer_idxs) {
+  // initializers released after pre-packing are no longer mapped.
+  for (int idx : external_initializer_idxs) {
+    auto it = constant_initialized_tensors_.find(idx);
+    if (it != constant_initialized_tensors_.end()) {
+      cold_initializer_slots_.emplace(idx, cold_initializer_evictor_->Register(it->second));
+    }
+  }
+
+  node_cold_initializer_slots_.resize(graph_viewer_->MaxNodeIndex());
+  for (const auto& node : graph_viewer_->Nodes()) {
+    auto& slots = node_cold_initializer_slots_[node.Index()];
+    for (const auto* input_def : node.InputDefs()) {
+      if (!input_def->Exists()) {
+        continue;
+      }
+
+      // subgraphs can consume the initializers of the outer scope, which are registered by the parent already.
+      const std::string& input_name = input_def->Name();
+      for (const SessionState* st = this; st != nullptr; st = st->parent_) {
+        int ort_value_idx;
+        if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+          auto it = st->cold_initializer_slots_.find(ort_value_idx);
+          if (it != st->cold_initializer_slots_.end()) {
+            slots.push_back(it->second);
+          }
+
+          if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+// The key depends on the order of the inputs and on the rank of each shape, so shapes such as {6} and {1, 6}, or
+// {2, 40} and {40, 2}, which need different patterns, don't share a cache entry. Dims in the same bucket do. Keys are saved to the pattern file,
+// so the mixing doesn't depend on std::hash.
+static void AccumulateMemoryPatternsKey(gsl::span<const int64_t> dims, int64_t bucket_size, int64_t& key) {
+  auto mix = [&key](uint64_t value) {
+    uint64_t hash = static_cast<uint64_t>(key);
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    key = static_cast<int64_t>(hash);
+  };
+
+  mix(dims.size());
+  for (auto dim : dims) {
+    if (bucket_size > 1 && dim > 0) {
+      dim = (dim + bucket_size - 1) / bucket_size * bucket_size;
+    }
+    mix(static_cast<uint64_t>(dim));
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
+int64_t SessionState::CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const {
   int64_t key = 0;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    AccumulateMemoryPatternsKey(input.Get<Tensor>().Shape().GetDims(), mem_pattern_shape_bucket_size_, key);
   }
   return key;
 }
 
+namespace {
+constexpr const char* kMemoryPatternsFileMagic = "ORT_MEMORY_PATTERNS";
+// version 2 changed how the keys are calculated.
+constexpr int kMemoryPatternsFileVersion = 2;
+// upper bound on the number of patterns ResetMemoryPatternGroup retires, so a model whose intermediate sizes
+// keep changing within a bucket can't grow the retired list unbounded.
+constexpr size_t kMaxRetiredMemoryPatterns = 16;
+
+// FNV-1a so the fingerprint is stable across processes and builds.
+void Fnv1aUpdate(uint64_t& hash, const void* data, size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+}
+}  // namespace
+
+// The OrtValue indices in a pattern are only meaningful for the graph and plan they were traced with,
+// so a persisted pattern file is tagged with a fingerprint of both.
+uint64_t SessionState::CalculateMemoryPatternsFingerprint() const {
+  uint64_t hash = 14695981039346656037ULL;
+  const int max_idx = ort_value_name_idx_map_.MaxIdx();
+  std::string name;
+  for (int i = 0; i <= max_idx; ++i) {
+    if (ort_value_name_idx_map_.GetName(i, name).IsOK()) {
+      Fnv1aUpdate(hash, &i, sizeof(i));
+      Fnv1aUpdate(hash, name.data(), name.size());
+    }
+  }
+
+  if (p_seq_exec_plan_.has_value()) {
+    for (const auto& per_value_plan : p_seq_exec_plan_->allocation_plan) {
+      const auto alloc_kind = static_cast<int>(per_value_plan.alloc_kind);
+      Fnv1aUpdate(hash, &alloc_kind, sizeof(alloc_kind));
+    }
+  }
+
+  Fnv1aUpdate(hash, &mem_pattern_shape_bucket_size_, sizeof(mem_pattern_shape_bucket_size_));
+  return hash;
+}
+
+void SessionState::LoadMemoryPatterns() {
+  std::ifstream in(mem_pattern_file_path_);
+  if (!in.is_open()) {
+    // first run with this file. it will be created when the first pattern is generated.
+    return;
+  }
+
+  std::string magic;
+  int version = 0;
+  uint64_t fingerprint = 0;
+  size_t num_groups = 0;
+  in >> magic >> version >> fingerprint >> num_groups;
+  if (!in || magic != kMemoryPatternsFileMagic || version != kMemoryPatternsFileVersion) {
+    LOGS(logger_, WARNING) << "Ignoring memory pattern file " << ToUTF8String(mem_pattern_file_path_)
+                           << " as it is not in the expected format.";
+    return;
+  }
+
+  if (fingerprint != CalculateMemoryPatternsFingerprint()) {
+    LOGS(logger_, INFO) << "Ignoring memory pattern file " << ToUTF8String(mem_pattern_file_path_)
+                        << " as it was generated for a different model or bucket size.";
+    return;
+  }
+
+  NodeHashMap<int64_t, MemoryPatternGroup> loaded;
+  const int max_idx = ort_value_name_idx_map_.MaxIdx();
+  for (size_t g = 0; g < num_groups; ++g) {
+    int64_t key = 0;
+    size_t num_locations = 0;
+    in >> key >> num_locations;
+    MemoryPatternGroup group;
+    for (size_t l = 0; in && l < num_locations; ++l) {
+      int device_type = 0, mem_type = 0, device_id = 0;
+      size_t peak_size = 0, num_blocks = 0;
+      in >> device_type >> mem_type >> device_id >> peak_size >> num_blocks;
+      InlinedHashMap<int, MemoryBlock> blocks;
+      blocks.reserve(num_blocks);
+      for (size_t b = 0; in && b < num_blocks; ++b) {
+        int ort_value_idx = 0;
+        MemoryBlock block;
+        in >> ort_value_idx >> block.offset_ >> block.size_;
+        // never hand out a block outside of the buffer allocated for the pattern
+        if (ort_value_idx < 0 || ort_value_idx > max_idx ||
+            block.offset_ > peak_size || block.size_ > peak_size - block.offset_) {
+          in.setstate(std::ios::failbit);
+          break;
+        }
+        blocks.insert_or_assign(ort_value_idx, block);
+      }
+
+      group.locations.emplace_back(static_cast<OrtDevice::DeviceType>(device_type),
+                                   static_cast<OrtDevice::MemoryType>(mem_type),
+                                   static_cast<OrtDevice::DeviceId>(device_id));
+      group.patterns.emplace_back(std::move(blocks), peak_size);
+    }
+
+    if (!in) {
+      LOGS(logger_, WARNING) << "Ignoring memory pattern file " << ToUTF8String(mem_pattern_file_path_)
+                             << " as it is truncated or corrupt.";
+      return;
+    }
+
+    loaded.emplace(key, std::move(group));
+  }
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  for (auto& entry : loaded) {
+    mem_patterns_.emplace(entry.first, std::move(entry.second));
+  }
+}
+
+// Must be called with mem_patterns_lock_ held.
+void SessionState::SaveMemoryPatterns() const {
+  // write to a temporary file first so a concurrent reader or a crash never sees a partial file.
+  PathString tmp_path = mem_pattern_file_path_ + ORT_TSTR(".tmp");
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out.is_open()) {
+      LOGS(logger_, WARNING) << "Failed to open " << ToUTF8String(tmp_path) << " to save memory patterns.";
+      return;
+    }
+
+    out << kMemoryPatternsFileMagic << " " << kMemoryPatternsFileVersion << " "
+        << CalculateMemoryPatternsFingerprint() << " " << mem_patterns_.size() << "\n";
+    for (const auto& entry : mem_patterns_) {
+      const auto& group = entry.second;
+      out << entry.first << " " << group.locations.size() << "\n";
+      for (size_t i = 0; i < group.locations.size(); ++i) {
+        const auto& location = group.locations[i];
+        const auto& blocks = group.patterns[i].GetPatternsMap();
+        out << static_cast<int>(location.Type()) << " " << static_cast<int>(location.MemType()) << " "
+            << static_cast<int>(location.Id()) << " " << group.patterns[i].PeakSize() << " " << blocks.size() << "\n";
+        for (const auto& block : blocks) {
+          out << block.first << " " << block.second.offset_ << " " << block.second.size_ << "\n";
+        }
+      }
+    }
+
+    if (!out) {
+      LOGS(logger_, WARNING) << "Failed to write memory patterns to " << ToUTF8String(tmp_path);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, mem_pattern_file_path_, ec);
+  if (ec) {
+    LOGS(logger_, WARNING) << "Failed to save memory patterns to " << ToUTF8String(mem_pattern_file_path_)
+                           << ": " << ec.message();
+  }
+}
+
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -843,6 +1158,138 @@ void SessionState::ResolveMemoryPatternFlag() {
       }
     }
   }
+
+  // subgraph feeds include the implicit inputs which aren't known until the parent node runs.
+  if (enable_mem_pattern_ && !graph_viewer_->IsSubgraph() &&
+      (memory_budget_ > 0 ||
+       sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsStaticMemoryPlanning, "0") == "1")) {
+    auto status = PlanStaticMemoryPatterns();
+    if (!status.IsOK()) {
+      LOGS(logger_, INFO) << "Static memory planning was not applied: " << status.ErrorMessage();
+    }
+  }
+}
+
+static size_t TotalPeakSize(const MemoryPatternGroup& group) {
+  size_t total = 0;
+  for (const auto& pattern : group.patterns) {
+    total += pattern.PeakSize();
+  }
+  return total;
+}
+
+Status SessionState::ComputeStaticMemoryPatterns(const SequentialExecutionPlan& exe_plan,
+                                                 MemoryPatternGroup& planned_patterns,
+                                                 MemoryPatternGroup& traced_patterns,
+                                                 size_t& num_tensors) const {
+  ORT_RETURN_IF_NOT(exe_plan.execution_plan.size() == 1,
+                    "Static memory planning requires all nodes to run on a single stream.");
+
+  for (const auto* input : graph_viewer_->GetInputs()) {
+    const auto* shape_proto = input->Shape();
+    ORT_RETURN_IF_NOT(shape_proto != nullptr, "Graph input ", input->Name(), " has no shape.");
+    const TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*shape_proto);
+    ORT_RETURN_IF_NOT(shape.Size() >= 0, "Graph input ", input->Name(), " does not have a static shape.");
+  }
+
+  // replay the plan the way the sequential executor runs it, recording when each tensor is allocated and released.
+  // the trace based planner sees the same sequence so the two peaks can be compared.
+  OrtValuePatternPlanner traced_planner(exe_plan);
+  InlinedVector<StaticMemoryPlanValue> values;
+  InlinedHashMap<int, size_t> live_values;
+  const auto& steps = exe_plan.execution_plan[0]->steps_;
+  for (size_t step = 0; step < steps.size(); ++step) {
+    const NodeIndex node_index = steps[step]->GetNodeIndex();
+    const auto* node = graph_viewer_->GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    for (const auto* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+
+      int ort_value_idx = -1;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(output->Name(), ort_value_idx));
+      const auto& per_value_plan = exe_plan.allocation_plan[ort_value_idx];
+      if (per_value_plan.alloc_kind != AllocKind::kAllocate ||
+          per_value_plan.value_type == nullptr || !per_value_plan.value_type->IsTensorType()) {
+        continue;
+      }
+
+      const auto* element_type = static_cast<const TensorTypeBase*>(per_value_plan.value_type)->GetElementType();
+      if (utils::IsDataTypeString(element_type) || output->Shape() == nullptr) {
+        continue;
+      }
+
+      // tensors whose shape is not known are left to the allocator at runtime.
+      const TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*output->Shape());
+      if (shape.Size() < 0) {
+        continue;
+      }
+
+      size_t size = 0;
+      ORT_RETURN_IF_ERROR(Tensor::CalculateTensorStorageSize(element_type, shape, kAllocAlignment, size));
+      ORT_RETURN_IF_ERROR(traced_planner.TraceAllocation(ort_value_idx, size));
+      live_values[ort_value_idx] = values.size();
+      values.push_back(StaticMemoryPlanValue{ort_value_idx, per_value_plan.location, size, step, steps.size()});
+    }
+
+    for (auto action_idx : exe_plan.node_release_list[node_index]) {
+      const auto& action = exe_plan.release_actions[action_idx];
+      auto it = live_values.find(static_cast<int>(action.value_index));
+      if (action.ref_count != 1 || it == live_values.end()) {
+        continue;
+      }
+
+      values[it->second].last_step = step;
+      ORT_RETURN_IF_ERROR(traced_planner.TraceFree(it->first));
+      live_values.erase(it);
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(traced_planner.GeneratePatterns(traced_patterns));
+  ORT_RETURN_IF_ERROR(StaticMemoryPlanner::CreatePatterns(values, planned_patterns));
+  num_tensors = values.size();
+  return Status::OK();
+}
+
+Status SessionState::CalculateStaticPeakSize(const SequentialExecutionPlan& exe_plan, size_t& peak_size) const {
+  MemoryPatternGroup planned_patterns;
+  MemoryPatternGroup traced_patterns;
+  size_t num_tensors = 0;
+  ORT_RETURN_IF_ERROR(ComputeStaticMemoryPatterns(exe_plan, planned_patterns, traced_patterns, num_tensors));
+  peak_size = std::min(TotalPeakSize(planned_patterns), TotalPeakSize(traced_patterns));
+  return Status::OK();
+}
+
+Status SessionState::PlanStaticMemoryPatterns() {
+  const auto* exe_plan = GetExecutionPlan();
+  ORT_RETURN_IF_NOT(exe_plan, "No execution plan.");
+
+  MemoryPatternGroup planned_patterns;
+  MemoryPatternGroup traced_patterns;
+  size_t num_tensors = 0;
+  ORT_RETURN_IF_ERROR(ComputeStaticMemoryPatterns(*exe_plan, planned_patterns, traced_patterns, num_tensors));
+
+  // key the pattern the same way a run with feeds of these shapes will look it up
+  int64_t key = 0;
+  for (const auto* input : graph_viewer_->GetInputs()) {
+    const TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*input->Shape());
+    AccumulateMemoryPatternsKey(shape.GetDims(), mem_pattern_shape_bucket_size_, key);
+  }
+
+  static_memory_plan_stats_.planned_peak_size = TotalPeakSize(planned_patterns);
+  static_memory_plan_stats_.traced_peak_size = TotalPeakSize(traced_patterns);
+  LOGS(logger_, INFO) << "Static memory planning of " << num_tensors << " tensors. Planned peak: "
+                      << static_memory_plan_stats_.planned_peak_size
+                      << " bytes. MemPatternPlanner peak: " << static_memory_plan_stats_.traced_peak_size << " bytes.";
+
+  const bool use_planned = static_memory_plan_stats_.planned_peak_size <= static_memory_plan_stats_.traced_peak_size;
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  mem_patterns_.emplace(key, use_planned ? std::move(planned_patterns) : std::move(traced_patterns));
+  return Status::OK();
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
@@ -851,10 +1298,36 @@ Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> ten
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  const bool inserted = mem_patterns_.emplace(key, std::move(mem_patterns)).second;
+  if (inserted && !mem_pattern_file_path_.empty()) {
+    SaveMemoryPatterns();
+  }
   return Status::OK();
 }
 
+bool SessionState::ResetMemoryPatternGroup(gsl::span<const OrtValue> tensor_inputs) const {
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  if (retired_mem_patterns_.size() >= kMaxRetiredMemoryPatterns) {
+    return false;
+  }
+
+  auto it = mem_patterns_.find(key);
+  if (it == mem_patterns_.end()) {
+    return false;
+  }
+
+  // extract rather than erase so the group stays at the same address for frames still using it
+  retired_mem_patterns_.push_back(mem_patterns_.extract(it));
+  if (retired_mem_patterns_.size() == kMaxRetiredMemoryPatterns) {
+    LOGS(logger_, WARNING) << "Retired " << kMaxRetiredMemoryPatterns << " memory patterns. The cached patterns "
+                           << "will no longer be re-traced when a run needs more memory than they provide. "
+                           << "Consider a smaller " << kOrtSessionOptionsMemoryPatternShapeBucketSize << ".";
+  }
+  return true;
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1051,6 +1524,10 @@ Status SessionState::CreateSubgraphSessionState() {
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
+      subgraph_session_state->SetSharedInitializerStore(shared_initializer_store_);
+      subgraph_session_state->prepacked_weights_file_ = prepacked_weights_file_;
+      subgraph_session_state->cold_initializer_evictor_ = cold_initializer_evictor_;
+      subgraph_session_state->frozen_state_allocator_ = frozen_state_allocator_;
 
       // recurse
       ORT_RETURN_IF_ERROR(subgraph_session_state->CreateSubgraphSessionState());
@@ -1176,6 +1653,26 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
                                           const KernelRegistryManager& kernel_registry_manager,
                                           bool remove_initializers,
                                           bool saving_ort_format) {
+  // created before the subgraph session states so they share it.
+  const PathString prepacked_weights_file_path = ToPathString(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsPrepackedWeightsFilePath, ""));
+  if (!prepacked_weights_file_path.empty()) {
+    prepacked_weights_file_ = std::make_shared<PrepackedWeightsFile>(prepacked_weights_file_path);
+    prepacked_weights_file_->Load(logger_);
+  }
+
+  const auto eviction_runs = ParseStringWithClassicLocale<int64_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsEvictColdInitializersAfterRuns, "0"));
+  ORT_RETURN_IF(eviction_runs < 0, "Invalid ", kOrtSessionOptionsEvictColdInitializersAfterRuns, " value of ",
+                eviction_runs);
+  if (eviction_runs > 0) {
+    cold_initializer_evictor_ = std::make_shared<ColdInitializerEvictor>(static_cast<uint64_t>(eviction_runs));
+  }
+
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsFreezeImmutableState, "0") == "1") {
+    frozen_state_allocator_ = std::make_shared<FrozenStateAllocator>();
+  }
+
   // recursively create the subgraph session state instances and populate the kernel create info in them.
   // it's simpler to handle the kernel create info recursively when deserializing,
   // so also do it recursively when calling PopulateKernelCreateInfo for consistency.
@@ -1186,8 +1683,20 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
 
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
-                                  remove_initializers, constant_initializers_use_count);
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
+                                               remove_initializers, constant_initializers_use_count));
+
+  if (prepacked_weights_file_ != nullptr) {
+    prepacked_weights_file_->Save(logger_);
+  }
+
+  if (frozen_state_allocator_ != nullptr) {
+    ORT_RETURN_IF_ERROR(frozen_state_allocator_->Freeze());
+    LOGS(logger_, INFO) << "Froze " << frozen_state_allocator_->GetMappedBytes()
+                        << " bytes of initializers and pre-packed weights";
+  }
+
+  return Status::OK();
 }
 
 static Status Index(const OrtValueNameIdxMap& ort_value_name_idx_map,
@@ -1376,9 +1885,19 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  const bool use_memory_aware_node_order =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryAwareNodeOrder, "0") == "1";
+  size_t max_streams_per_device = 1;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(
+                        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMaxStreamsPerDevice, "1"),
+                        max_streams_per_device) &&
+                        max_streams_per_device > 0,
+                    "Invalid value for ", kOrtSessionOptionsMaxStreamsPerDevice, ". It must be a positive integer.");
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   use_memory_aware_node_order,
+                                   max_streams_per_device);
 
 #ifdef _WIN32
 
@@ -1394,18 +1913,131 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
 #endif
 
-  auto status = SequentialPlanner::CreatePlan(parent_node, *graph_viewer_, valid_outer_scope_node_args,
-                                              execution_providers_, kernel_create_info_map_,
-                                              subgraphs_kernel_create_info_maps,
-                                              outer_scope_node_arg_to_location_map,
-                                              ort_value_name_idx_map_, context,
+  // the snapshot describes the main graph only. subgraph plans depend on the locations of the outer scope values.
+  const PathString plan_snapshot_file_path =
+      parent_node == nullptr
+          ? ToPathString(session_options.config_options.GetConfigOrDefault(
+                kOrtSessionOptionsExecutionPlanSnapshotFilePath, ""))
+          : PathString();
+  uint64_t plan_snapshot_fingerprint = 0;
+  bool plan_restored = false;
+  if (!plan_snapshot_file_path.empty()) {
+    plan_snapshot_fingerprint = execution_plan_snapshot::CalculateFingerprint(*graph_viewer_, ort_value_name_idx_map_,
+                                                                              session_options);
+    plan_restored = execution_plan_snapshot::Load(plan_snapshot_file_path, plan_snapshot_fingerprint, *graph_viewer_,
+                                                  ort_value_name_idx_map_, logger_, p_seq_exec_plan_);
+  }
+
+  auto create_plan = [&](const SequentialPlannerContext& planner_context,
+                         std::optional<SequentialExecutionPlan>& plan) {
+    return SequentialPlanner::CreatePlan(parent_node, *graph_viewer_, valid_outer_scope_node_args,
+                                         execution_providers_, kernel_create_info_map_,
+                                         subgraphs_kernel_create_info_maps,
+                                         outer_scope_node_arg_to_location_map,
+                                         ort_value_name_idx_map_, planner_context,
 #ifdef ORT_ENABLE_STREAM
-                                              GetStreamHandleRegistryInstance(),
+                                         GetStreamHandleRegistryInstance(),
 #endif
-                                              partition_config_file,
-                                              Logger(),
-                                              p_seq_exec_plan_);
-  ORT_RETURN_IF_ERROR(status);
+                                         partition_config_file,
+                                         Logger(),
+                                         plan);
+  };
+
+  // the budget applies to the main graph. subgraph memory depends on the values the parent node feeds them.
+  const bool apply_memory_budget = memory_budget_ > 0 && parent_node == nullptr;
+  memory_budget_report_ = MemoryBudgetReport{};
+  memory_budget_report_.execution_order = session_options.execution_order;
+
+  if (!plan_restored) {
+    ORT_RETURN_IF_ERROR(create_plan(context, p_seq_exec_plan_));
+
+    if (apply_memory_budget) {
+      size_t peak_size = 0;
+      ORT_RETURN_IF_ERROR(CalculateStaticPeakSize(*p_seq_exec_plan_, peak_size));
+
+#if !defined(ORT_MINIMAL_BUILD)
+      // reorder the nodes using the other topological order and keep the plan with the smaller peak.
+      if (peak_size > memory_budget_ && session_options.execution_order != ExecutionOrder::MEMORY_EFFICIENT) {
+        const ExecutionOrder other_order = session_options.execution_order == ExecutionOrder::DEFAULT
+                                               ? ExecutionOrder::PRIORITY_BASED
+                                               : ExecutionOrder::DEFAULT;
+        SequentialPlannerContext other_context(session_options.execution_mode, other_order,
+                                               session_options.enable_mem_reuse, use_memory_aware_node_order,
+                                               max_streams_per_device);
+        std::optional<SequentialExecutionPlan> other_plan;
+        ORT_RETURN_IF_ERROR(create_plan(other_context, other_plan));
+        size_t other_peak_size = 0;
+        ORT_RETURN_IF_ERROR(CalculateStaticPeakSize(*other_plan, other_peak_size));
+        LOGS(logger_, INFO) << "Peak memory of the plan using execution order " << session_options.execution_order
+                            << ": " << peak_size << " bytes. Using execution order " << other_order << ": "
+                            << other_peak_size << " bytes.";
+        if (other_peak_size < peak_size) {
+          p_seq_exec_plan_ = std::move(other_plan);
+          peak_size = other_peak_size;
+          memory_budget_report_.execution_order = other_order;
+        }
+      }
+#endif
+
+      memory_budget_report_.peak_size = peak_size;
+    }
+
+    if (!plan_snapshot_file_path.empty()) {
+      execution_plan_snapshot::Save(plan_snapshot_file_path, plan_snapshot_fingerprint, *graph_viewer_,
+                                    ort_value_name_idx_map_, logger_, *p_seq_exec_plan_);
+    }
+  }
+
+  if (apply_memory_budget) {
+    if (plan_restored) {
+      ORT_RETURN_IF_ERROR(CalculateStaticPeakSize(*p_seq_exec_plan_, memory_budget_report_.peak_size));
+    }
+
+    memory_budget_report_.budget = memory_budget_;
+    memory_budget_report_.within_budget = memory_budget_report_.peak_size <= memory_budget_;
+    LOGS(logger_, INFO) << "Peak memory of the intermediate tensors: " << memory_budget_report_.peak_size
+                        << " bytes. Budget: " << memory_budget_ << " bytes.";
+    ORT_RETURN_IF_NOT(memory_budget_report_.within_budget,
+                      "The peak memory of the intermediate tensors of ", memory_budget_report_.peak_size,
+                      " bytes exceeds the budget of ", memory_budget_, " bytes set with ",
+                      kOrtSessionOptionsMemoryBudgetBytes);
+  }
+
+  // subgraphs are executed by the thread running the parent node, see utils::ExecuteGraphImpl.
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL && parent_node == nullptr) {
+    parallel_node_scheduler_ = ParallelNodeScheduler::Create(*p_seq_exec_plan_, *graph_viewer_);
+  }
+
+  if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableKernelStatistics, "0") == "1") {
+    auto& kernel_statistics = profiler_.GetKernelStatistics();
+    kernel_statistics_.assign(graph_viewer_->MaxNodeIndex(), nullptr);
+    for (const auto& node : graph_viewer_->Nodes()) {
+      kernel_statistics_[node.Index()] = &kernel_statistics.GetOrAddOpStats(node.OpType(),
+                                                                             node.GetExecutionProviderType());
+    }
+  }
+
+  const auto node_latency_alert_factor = ParseStringWithClassicLocale<double>(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsNodeLatencyAlertFactor, "0"));
+  if (node_latency_alert_factor != 0.0) {
+    ORT_RETURN_IF_NOT(node_latency_alert_factor > 1.0, "Invalid ", kOrtSessionOptionsNodeLatencyAlertFactor,
+                      " value of ", node_latency_alert_factor, ". It must be greater than 1.");
+    const auto node_latency_alert_min_us = ParseStringWithClassicLocale<int64_t>(
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsNodeLatencyAlertMinUs, "100"));
+    ORT_RETURN_IF(node_latency_alert_min_us < 0, "Invalid ", kOrtSessionOptionsNodeLatencyAlertMinUs, " value of ",
+                  node_latency_alert_min_us);
+    node_latency_monitor_ = std::make_unique<NodeLatencyMonitor>(
+        graph_viewer_->MaxNodeIndex(), node_latency_alert_factor, static_cast<uint64_t>(node_latency_alert_min_us) * 1000);
+  }
+
+  // the pattern file describes the main graph only. subgraphs have their own OrtValue indices.
+  if (parent_node == nullptr) {
+    mem_pattern_file_path_ = ToPathString(
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternFilePath, ""));
+    if (!mem_pattern_file_path_.empty()) {
+      LoadMemoryPatterns();
+    }
+  }
 
   // Record the allocation plan
 
@@ -1473,13 +2105,23 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  std::vector<int> external_initializer_idxs;
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
           GetAllocator(OrtDevice()),
           ort_value_name_idx_map_, initializer_allocation_order, *tensor_allocator,
-          [this, remove_initializers](const std::string& name, int idx, const OrtValue& value, const OrtCallback& d,
-                                      bool constant, bool sparse) -> Status {
+          [this, remove_initializers, &external_initializer_idxs](const std::string& name, int idx,
+                                                                  const OrtValue& value, const OrtCallback& d,
+                                                                  bool constant, bool sparse) -> Status {
+            // external data on CPU is memory mapped by SaveInitializedTensors.
+            const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+            if (cold_initializer_evictor_ != nullptr && constant && value.IsTensor() &&
+                value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU &&
+                graph_.GetInitializedTensor(name, tensor_proto) && utils::HasExternalData(*tensor_proto)) {
+              external_initializer_idxs.push_back(idx);
+            }
+
             ORT_RETURN_IF_ERROR(AddInitializedTensor(idx, value, &d, constant, sparse));
             if (remove_initializers) {
               graph_.RemoveInitializedTensor(name);
@@ -1487,7 +2129,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             return Status::OK();
           },
           logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
-          name_to_buffered_tensor_));
+          name_to_buffered_tensor_, shared_initializer_store_, initialization_thread_pool_));
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1508,6 +2150,10 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                                           session_options.initializers_to_share_map));
   }
 
+  if (cold_initializer_evictor_ != nullptr) {
+    RegisterColdInitializers(external_initializer_idxs);
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
 
@@ -30,8 +30,10 @@
 #include "core/framework/mem_pattern.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/node_latency_monitor.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/parallel_node_scheduler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -58,6 +60,10 @@ class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
+class SharedInitializerStore;
+class PrepackedWeightsFile;
+class ColdInitializerEvictor;
+class FrozenStateAllocator;
 class DeviceStreamCollection;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
@@ -129,6 +135,12 @@ class SessionState {
   /** Get the allocator for a given OrtDevice. The first allocator that matches will be returned. */
   AllocatorPtr GetAllocator(const OrtDevice& device) const noexcept;
 
+  /**
+   * Get the allocator for the initializers and the pre-packed weights on the given device. This is the allocator
+   * of the immutable state for the CPU if kOrtSessionOptionsFreezeImmutableState is set, else GetAllocator(device).
+   */
+  AllocatorPtr GetInitializerAllocator(const OrtDevice& device) const noexcept;
+
   /*
    * Get allocators.
    */
@@ -136,6 +148,14 @@ class SessionState {
 
   void UpdateAllocatorsWithEnvAllocators(const std::vector<AllocatorPtr>&);
 
+  /**
+   * Share the constant external data initializers of this and the subgraph session states through the store.
+   * Must be called before FinalizeSessionState.
+   */
+  void SetSharedInitializerStore(SharedInitializerStore* shared_initializer_store) {
+    shared_initializer_store_ = shared_initializer_store;
+  }
+
   const OrtValueNameIdxMap& GetOrtValueNameIdxMap() const noexcept { return ort_value_name_idx_map_; }
 
   /**
@@ -204,6 +224,34 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
+  /**
+  Get the aggregated kernel statistics for the op type of a node.
+  Returns nullptr if kernel statistics are not enabled for the session.
+  */
+  profiling::KernelStatistics::OpStats* GetKernelStatistics(NodeIndex node_index) const noexcept {
+    return node_index < kernel_statistics_.size() ? kernel_statistics_[node_index] : nullptr;
+  }
+
+  /**
+  Get the monitor of the compute time of the nodes that flags slow runs.
+  Returns nullptr unless kOrtSessionOptionsNodeLatencyAlertFactor is set.
+  */
+  NodeLatencyMonitor* GetNodeLatencyMonitor() const noexcept { return node_latency_monitor_.get(); }
+
+  /**
+   * Tracks the use of memory mapped initializers to release the pages of cold ones.
+   * nullptr unless kOrtSessionOptionsEvictColdInitializersAfterRuns is set.
+   */
+  ColdInitializerEvictor* GetColdInitializerEvictor() const noexcept {
+    return cold_initializer_evictor_.get();
+  }
+
+  // slots in the ColdInitializerEvictor of the initializers consumed by the node.
+  gsl::span<const size_t> GetColdInitializerSlots(NodeIndex node_index) const noexcept {
+    return node_index < node_cold_initializer_slots_.size() ? gsl::span<const size_t>(node_cold_initializer_slots_[node_index])
+                                                            : gsl::span<const size_t>();
+  }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler* GetMemoryProfiler() const noexcept { return memory_profiler_; }
 
@@ -234,6 +282,46 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Drop the cached memory pattern for the shape bucket of the given inputs so the next run re-traces it.
+  Used when shape bucketing is enabled and a run in the bucket needed more memory than the cached pattern
+  provides. Existing pointers to the dropped pattern remain valid for the lifetime of the SessionState.
+  Returns false if there is no cached pattern for the bucket, or if the number of dropped patterns has reached
+  its limit, in which case the cached pattern is kept.
+  */
+  bool ResetMemoryPatternGroup(gsl::span<const OrtValue> tensor_inputs) const;
+
+  /**
+  Granularity the input dims are rounded up to when looking up memory patterns. 0 means exact shapes.
+  */
+  int64_t GetMemoryPatternShapeBucketSize() const { return mem_pattern_shape_bucket_size_; }
+
+  /**
+  Whether the executor keeps one parallel section of the intra-op thread pool open across consecutive CPU nodes.
+  */
+  bool ChainParallelSections() const noexcept { return chain_parallel_sections_; }
+
+  // Peak sizes, summed over all locations, of the memory pattern computed by static memory planning
+  // and of the pattern the trace based MemPatternPlanner produces for the same sequence of allocations.
+  // Both are 0 if the graph was not planned statically.
+  struct StaticMemoryPlanStats {
+    size_t planned_peak_size{0};
+    size_t traced_peak_size{0};
+  };
+
+  const StaticMemoryPlanStats& GetStaticMemoryPlanStats() const { return static_memory_plan_stats_; }
+
+  // Peak size of the intermediate tensors of the plan the session uses, compared to the budget set with
+  // kOrtSessionOptionsMemoryBudgetBytes. budget is 0 if no budget was set.
+  struct MemoryBudgetReport {
+    size_t budget{0};
+    size_t peak_size{0};
+    ExecutionOrder execution_order{ExecutionOrder::DEFAULT};
+    bool within_budget{true};
+  };
+
+  const MemoryBudgetReport& GetMemoryBudgetReport() const { return memory_budget_report_; }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -291,6 +379,10 @@ class SessionState {
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
+  // Scheduler that runs the nodes of the plan concurrently. Only created for ORT_PARALLEL sessions
+  // whose nodes all run on a single CPU stream. nullptr otherwise.
+  const ParallelNodeScheduler* GetParallelNodeScheduler() const noexcept { return parallel_node_scheduler_.get(); }
+
   const FuncManager& GetFuncMgr() const noexcept { return fused_funcs_mgr_; }
   FuncManager& GetMutableFuncMgr() noexcept { return fused_funcs_mgr_; }
 
@@ -329,6 +421,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedPersistedPrePackedWeightCounter() const {
+    return used_persisted_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -399,6 +495,30 @@ class SessionState {
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
                                   bool graph_info_already_created = false);
 
+  int64_t CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  uint64_t CalculateMemoryPatternsFingerprint() const;
+
+  // replay exe_plan for the static input shapes of the graph and lay out the tensors with a static shape, using
+  // StaticMemoryPlanner and the trace based MemPatternPlanner.
+  Status ComputeStaticMemoryPatterns(const SequentialExecutionPlan& exe_plan, MemoryPatternGroup& planned_patterns,
+                                     MemoryPatternGroup& traced_patterns, size_t& num_tensors) const;
+
+  // peak size of the memory patterns of exe_plan, the smaller of the planned and the traced one.
+  Status CalculateStaticPeakSize(const SequentialExecutionPlan& exe_plan, size_t& peak_size) const;
+
+  // compute the memory pattern for the static input shapes of the graph when every shape is known.
+  Status PlanStaticMemoryPatterns();
+
+  // read/write the memory pattern cache from/to mem_pattern_file_path_.
+  // failures are logged and otherwise ignored as the cache is only an optimization.
+  void LoadMemoryPatterns();
+
+  // registers the memory mapped initializers in external_initializer_idxs that are still used after pre-packing
+  // with the evictor and records the ones each node consumes.
+  void RegisterColdInitializers(gsl::span<const int> external_initializer_idxs);
+  void SaveMemoryPatterns() const;
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       gsl::span<const OrtValue> inputs,
@@ -478,9 +598,20 @@ class SessionState {
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
+  std::unique_ptr<ParallelNodeScheduler> parallel_node_scheduler_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
+  // indexed by NodeIndex. empty if kernel statistics are not enabled.
+  std::vector<profiling::KernelStatistics::OpStats*> kernel_statistics_;
+  // per session state, as the node indices of subgraphs are separate. nullptr if slow runs are not flagged.
+  std::unique_ptr<NodeLatencyMonitor> node_latency_monitor_;
+
+  // shared by this and the subgraph session states. nullptr if cold initializers are not evicted.
+  std::shared_ptr<ColdInitializerEvictor> cold_initializer_evictor_;
+  // evictor slots of the memory mapped constant initializers by OrtValue index
+  InlinedHashMap<int, size_t> cold_initializer_slots_;
+  std::vector<InlinedVector<size_t>> node_cold_initializer_slots_;
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler* memory_profiler_;
@@ -494,6 +625,21 @@ class SessionState {
   // cache for the generated mem_patterns. key is calculated based on input shapes.
   // must be a node based container as a pointer is cached.
   mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
+  // patterns dropped by ResetMemoryPatternGroup. kept alive as execution frames may still point to them.
+  mutable std::vector<NodeHashMap<int64_t, MemoryPatternGroup>::node_type> retired_mem_patterns_;
+  // round input dims up to a multiple of this value when computing the pattern cache key. 0 to disable.
+  int64_t mem_pattern_shape_bucket_size_{0};
+  // keep a parallel section open across consecutive CPU nodes of a stream.
+  bool chain_parallel_sections_{false};
+  // optional file the pattern cache is loaded from at initialization and saved to when it changes.
+  PathString mem_pattern_file_path_;
+  // intra-op thread pool to deserialize initializers, create CPU kernels and pre-pack their weights with.
+  // nullptr to do it on the calling thread.
+  concurrency::ThreadPool* initialization_thread_pool_{};
+  StaticMemoryPlanStats static_memory_plan_stats_;
+  // peak memory budget of the intermediate tensors of the main graph in bytes. 0 if there is none.
+  size_t memory_budget_{0};
+  MemoryBudgetReport memory_budget_report_;
   // This is mutable under mutex in training scenarios so execution frame would make a copy
   // of the value when created.
 #ifdef ENABLE_TRAINING
@@ -523,6 +669,17 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Environment level store to share constant initializers with other sessions. nullptr if sharing is disabled.
+  SharedInitializerStore* shared_initializer_store_{};
+
+  // Pre-packed weights persisted by earlier sessions, shared by this and the subgraph session states.
+  // nullptr if pre-packed weights are not persisted.
+  std::shared_ptr<PrepackedWeightsFile> prepacked_weights_file_;
+
+  // Allocator of the CPU initializers and pre-packed weights, made read only once the session state is finalized.
+  // Shared by this and the subgraph session states. nullptr if the immutable state is not frozen.
+  std::shared_ptr<FrozenStateAllocator> frozen_state_allocator_;
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -553,6 +710,9 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight persisted by an earlier session was used
+  size_t used_persisted_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -14,6 +14,7 @@
 #include "core/framework/session_state_utils.h"
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/graph_partitioner.h"
@@ -22,12 +23,14 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/bfc_arena.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
@@ -100,7 +103,8 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              bool use_device_allocator_for_initializers = false,
-                                             Tensor* buffered_tensor = nullptr) {
+                                             Tensor* buffered_tensor = nullptr,
+                                             size_t device_load_chunk_size = 0) {
   if (bool(alloc) == (m != nullptr)) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                   "DeserializeTensorProto() takes either pre-allocated buffer or an allocator!");
@@ -148,6 +152,29 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
         return allocate_on_device_status;
       }
 
+#if !defined(__wasm__)
+      // read the file in chunks that are copied to the device while the next one is read, instead of mapping
+      // the whole initializer into CPU memory first
+      if (device_load_chunk_size > 0 && buffered_tensor == nullptr && !utils::HasExternalDataInMemory(tensor_proto)) {
+        const auto* byte_type = DataTypeImpl::GetType<uint8_t>();
+        auto* device_data = static_cast<char*>(p_tensor->MutableDataRaw());
+        const OrtMemoryInfo cpu_info(CPU, OrtAllocatorType::OrtDeviceAllocator);
+        ORT_RETURN_IF_ERROR(utils::ReadExternalDataInChunks(
+            env, proto_path, tensor_proto, device_load_chunk_size,
+            [&](size_t offset, gsl::span<const char> chunk) {
+              const TensorShape chunk_shape({narrow<int64_t>(chunk.size())});
+              const Tensor src(byte_type, chunk_shape, const_cast<char*>(chunk.data()), cpu_info);
+              Tensor dst(byte_type, chunk_shape, device_data + offset, p_tensor->Location());
+              // the chunk is in pageable memory, so the copy completes before CopyTensor returns
+              return data_transfer_mgr.CopyTensor(src, dst);
+            }));
+
+        auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+        ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+        return common::Status::OK();
+      }
+#endif
+
       std::unique_ptr<Tensor> p_deserialize_tensor = std::make_unique<Tensor>(type, TensorShape(), default_cpu_alloc);
 
       OrtCallback ext_data_deleter;
@@ -255,6 +282,29 @@ common::Status CopyTensorFromCPUToDevice(
   }
 }
 
+common::Status ParallelForWithStatus(concurrency::ThreadPool* thread_pool, size_t count,
+                                     const std::function<common::Status(size_t)>& fn) {
+  std::vector<Status> statuses(count);
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, static_cast<std::ptrdiff_t>(count),
+                                                [&fn, &statuses](std::ptrdiff_t i) {
+                                                  auto& status = statuses[static_cast<size_t>(i)];
+                                                  ORT_TRY {
+                                                    status = fn(static_cast<size_t>(i));
+                                                  }
+                                                  ORT_CATCH(const std::exception& ex) {
+                                                    ORT_HANDLE_EXCEPTION([&]() {
+                                                      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+                                                    });
+                                                  }
+                                                });
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_alloc,
@@ -266,7 +316,9 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    SharedInitializerStore* shared_initializer_store,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -361,6 +413,61 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
+  size_t device_load_chunk_size = 0;
+  const auto device_load_chunk_size_str =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsDeviceInitializerLoadChunkSize, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(device_load_chunk_size_str, device_load_chunk_size),
+                    "Invalid ", kOrtSessionOptionsDeviceInitializerLoadChunkSize, " value of ",
+                    device_load_chunk_size_str);
+
+  // with a thread pool, the initializers that are copied into CPU memory are deserialized in parallel first.
+  // memory mapped external data is cheap to load and copies to other devices are left to the loop below.
+  InlinedHashMap<int, OrtValue> deserialized_values;
+  if (thread_pool != nullptr) {
+    struct DeserializeTask {
+      int ort_value_index;
+      const ONNX_NAMESPACE::TensorProto* tensor_proto;
+      std::optional<MemBuffer> m;
+      AllocatorPtr alloc;
+    };
+
+    std::vector<DeserializeTask> tasks;
+    for (const auto& entry : id_to_initialized_tensor) {
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *entry.second;
+      if (tensor_proto.name().empty() || utils::HasExternalData(tensor_proto) ||
+          exec_plan.GetLocation(entry.first).Type() != OrtDevice::CPU ||
+          user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end() ||
+          buffered_tensors.find(tensor_proto.name()) != buffered_tensors.end()) {
+        continue;
+      }
+
+      DeserializeTask task{entry.first, entry.second, std::nullopt, nullptr};
+      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(entry.first, tensor_proto.name(), task.m, task.alloc));
+      tasks.push_back(std::move(task));
+    }
+
+    std::vector<OrtValue> values(tasks.size());
+    ORT_RETURN_IF_ERROR(ParallelForWithStatus(thread_pool, tasks.size(), [&](size_t i) -> Status {
+      const auto& task = tasks[i];
+      Status st = DeserializeTensorProto(env, graph_loc, *task.tensor_proto, task.m.has_value() ? &*task.m : nullptr,
+                                         task.alloc, default_cpu_alloc, values[i], data_transfer_mgr,
+                                         use_device_allocator_for_initializers);
+      if (!st.IsOK()) {
+        std::ostringstream oss;
+        oss << "Deserialize tensor " << task.tensor_proto->name() << " failed." << st.ErrorMessage();
+        return Status(st.Category(), st.Code(), oss.str());
+      }
+      return Status::OK();
+    }));
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      deserialized_values.emplace(tasks[i].ort_value_index, std::move(values[i]));
+    }
+  }
+
   // 3. create weight tensors based on weights buffer
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
@@ -376,6 +483,9 @@ common::Status SaveInitializedTensors(
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
       ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+    } else if (auto deserialized = deserialized_values.find(ort_value_index);
+               deserialized != deserialized_values.end()) {
+      ort_value = std::move(deserialized->second);
     } else {
       const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
@@ -383,8 +493,6 @@ common::Status SaveInitializedTensors(
       AllocatorPtr alloc;
       // TODO: if the tensor need be copied, does it have enough room?
       ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
       Tensor* p_tensor = nullptr;
       if (auto iter = buffered_tensors.find(name);
@@ -395,7 +503,7 @@ common::Status SaveInitializedTensors(
 
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
                                          default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers, p_tensor);
+                                         use_device_allocator_for_initializers, p_tensor, device_load_chunk_size);
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -410,6 +518,15 @@ common::Status SaveInitializedTensors(
     // any outer scope value is shadowed by a local value and can't override it.
     // due to that check_outer_scope is false
     const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
+
+    // replace memory mapped weights with an identical copy that is already used by another session.
+    // non-constant initializers can be overridden or updated, so only constant ones are shared.
+    if (shared_initializer_store != nullptr && constant && utils::HasExternalData(*entry.second) &&
+        user_supplied_initializer_ids.find(entry.first) == user_supplied_initializer_ids.end() &&
+        ort_value.IsTensor() && ort_value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU &&
+        !ort_value.Get<Tensor>().IsDataTypeString()) {
+      ort_value = shared_initializer_store->GetOrAdd(ort_value);
+    }
 #if !defined(DISABLE_SPARSE_TENSORS)
     const bool sparse = graph.GetGraph().IsSparseInitializer(name);
     ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
@@ -24,6 +24,7 @@ class GraphViewer;
 class OrtValueNameIdxMap;
 class DataTransferManager;
 class NodeArg;
+class SharedInitializerStore;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -32,6 +33,10 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
@@ -48,7 +53,17 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    SharedInitializerStore* shared_initializer_store = nullptr,
+    concurrency::ThreadPool* thread_pool = nullptr);
+
+/**
+ * Runs fn for each index in [0, count) on the thread pool, or on the calling thread if thread_pool is nullptr.
+ * Returns the error of the lowest failing index. Exceptions are converted to a status as they can't propagate out of
+ * the thread pool.
+ */
+common::Status ParallelForWithStatus(concurrency::ThreadPool* thread_pool, size_t count,
+                                     const std::function<common::Status(size_t)>& fn);
 
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
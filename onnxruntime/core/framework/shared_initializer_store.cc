@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+uint64_t HashTensor(const Tensor& tensor) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  const auto dims = tensor.Shape().GetDims();
+  MurmurHash3::x86_128(dims.data(), static_cast<int>(dims.size_bytes()),
+                       static_cast<uint32_t>(tensor.GetElementType()), hash);
+
+  // MurmurHash3 takes an int length, so large initializers are hashed in chunks.
+  constexpr size_t kChunkSize = size_t{1} << 30;
+  const auto* data = static_cast<const uint8_t*>(tensor.DataRaw());
+  for (size_t offset = 0, size = tensor.SizeInBytes(); offset < size; offset += kChunkSize) {
+    MurmurHash3::x86_128(data + offset, static_cast<int>(std::min(kChunkSize, size - offset)), hash[0], hash);
+  }
+
+  return (static_cast<uint64_t>(hash[1]) << 32) | hash[0];
+}
+
+bool HaveSameContent(const Tensor& a, const Tensor& b) {
+  return a.DataType() == b.DataType() && a.Shape() == b.Shape() &&
+         (a.DataRaw() == b.DataRaw() || std::memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0);
+}
+
+// an OrtValue with a tensor over the data of the shared value, which is kept alive by the deleter.
+OrtValue MakeSharedValue(std::shared_ptr<const OrtValue> shared) {
+  const Tensor& tensor = shared->Get<Tensor>();
+  auto p_tensor = std::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), const_cast<void*>(tensor.DataRaw()),
+                                           tensor.Location());
+  OrtValue value;
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), [shared = std::move(shared)](void* p) {
+    delete static_cast<Tensor*>(p);
+  });
+  return value;
+}
+}  // namespace
+
+OrtValue SharedInitializerStore::GetOrAdd(const OrtValue& tensor_value) {
+  const Tensor& tensor = tensor_value.Get<Tensor>();
+  ORT_ENFORCE(tensor.Location().device.Type() == OrtDevice::CPU && !tensor.IsDataTypeString(),
+              "Only CPU tensors of numeric types can be shared.");
+
+  // hash outside of the lock as it reads the entire initializer.
+  const uint64_t hash = HashTensor(tensor);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto range = initializers_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto shared = it->second.lock();
+    if (!shared) {
+      it = initializers_.erase(it);
+      continue;
+    }
+
+    if (HaveSameContent(shared->Get<Tensor>(), tensor)) {
+      return MakeSharedValue(std::move(shared));
+    }
+
+    ++it;
+  }
+
+  auto shared = std::make_shared<const OrtValue>(tensor_value);
+  initializers_.emplace(hash, shared);
+  return MakeSharedValue(std::move(shared));
+}
+
+size_t SharedInitializerStore::GetNumberOfElements() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& entry : initializers_) {
+    if (!entry.second.expired()) {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Content addressed store of constant CPU initializers shared by the sessions of an environment.
+//
+// Initializers are keyed by a hash of their element type, shape and data, so sessions of models that contain the
+// same weights use a single copy of them regardless of the file they were loaded from, and replicas of a model
+// don't add memory per session. The store only holds weak references: an entry is released once no session uses it.
+//
+// Sessions add external data initializers after memory mapping them with Env::MapFileIntoMemory. The mapped pages
+// are backed by the file, so processes loading the same file also share the physical memory through the page cache.
+class SharedInitializerStore final {
+ public:
+  SharedInitializerStore() = default;
+
+  // Returns a value for an initializer with the same element type, shape and data as tensor_value.
+  // If no such initializer is alive in the store, tensor_value is added. tensor_value must be a CPU tensor.
+  // The returned value references the shared data and keeps it alive.
+  OrtValue GetOrAdd(const OrtValue& tensor_value);
+
+  // Number of initializers that are currently alive in the store.
+  size_t GetNumberOfElements() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+ private:
+  mutable OrtMutex mutex_;
+  // keyed by content hash. entries with an equal hash are compared byte by byte.
+  std::unordered_multimap<uint64_t, std::weak_ptr<const OrtValue>> initializers_;
+};
+
+}  // namespace onnxruntime
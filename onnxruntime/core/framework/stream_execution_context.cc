@@ -6,6 +6,9 @@
 #include "core/framework/bfc_arena.h"
 #include "core/framework/session_state.h"
 #include "core/common/spin_pause.h"
+#include "core/platform/threadpool.h"
+
+#include <optional>
 
 namespace onnxruntime {
 #ifdef ORT_ENABLE_STREAM
@@ -205,21 +208,45 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
     end = std::min(end, range->stream_pc_range[stream_idx].second);
 #endif
 
+  // With chained parallel sections, a run of consecutive CPU kernels shares one parallel section of the intra-op
+  // thread pool.  It is ended before any other step, and before the task completes as the session may be
+  // released right after that.
+  const auto& session_state = ctx.GetSessionState();
+  concurrency::ThreadPool* chained_section_tp =
+      session_state.ChainParallelSections() ? session_state.GetThreadPool() : nullptr;
+  std::optional<concurrency::ThreadPool::ParallelSection> chained_section;
+  auto complete_task = [&ctx, &chained_section]() {
+    chained_section.reset();
+    ctx.CompleteTask();
+  };
+
   while (since < end) {
     if (!ctx.TaskStatus().IsOK()) {
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     if (terminate_flag) {
       Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
       ctx.SetStatus(status_made);
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
+    auto& step = logic_stream->steps_[since];
+    if (chained_section_tp) {
+      const auto* node = step->LaunchesKernel() ? session_state.GetGraphViewer().GetNode(step->GetNodeIndex())
+                                                : nullptr;
+      if (node && node->GetExecutionProviderType() == kCpuExecutionProvider) {
+        if (!chained_section) {
+          chained_section.emplace(chained_section_tp);
+        }
+      } else {
+        chained_section.reset();
+      }
+    }
     bool continue_flag = true;
     Status status;
     ORT_TRY {
-      status = logic_stream->steps_[since]->Execute(ctx, stream_idx, session_scope, terminate_flag, continue_flag);
+      status = step->Execute(ctx, stream_idx, session_scope, terminate_flag, continue_flag);
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -229,18 +256,18 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
     if (!status.IsOK()) {
       // terminate it
       ctx.SetStatus(status);
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     if (!continue_flag) {
       // break but not terminate
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     since++;
   }
   ORT_ENFORCE(since == end);
-  ctx.CompleteTask();
+  complete_task();
   return;
 }
 
@@ -7,7 +7,7 @@
 namespace onnxruntime {
 
 AllocatorPtr ITensorAllocator::GetAllocator(const OrtDevice& device) {
-  return session_state_.GetAllocator(device);
+  return session_state_.GetInitializerAllocator(device);
 }
 
 std::unique_ptr<ITensorAllocator> ITensorAllocator::Create(bool enable_mem_pattern,
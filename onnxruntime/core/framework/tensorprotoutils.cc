@@ -4,7 +4,10 @@
 #include "core/framework/tensorprotoutils.h"
 
 #include <memory>
+#include <new>
 #include <algorithm>
+#include <array>
+#include <future>
 #include <limits>
 #include <string>
 #include <filesystem>
@@ -219,6 +222,72 @@ Status ReadExternalDataForTensor(const ONNX_NAMESPACE::TensorProto& tensor_proto
   return Status::OK();
 }
 
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  const auto memory_address_tag = ToUTF8String(onnxruntime::utils::kTensorProtoMemoryAddressTag);
+  return HasExternalData(tensor_proto) &&
+         std::any_of(tensor_proto.external_data().cbegin(), tensor_proto.external_data().cend(),
+                     [&memory_address_tag](const ONNX_NAMESPACE::StringStringEntryProto& entry) {
+                       return entry.key() == "location" && entry.value() == memory_address_tag;
+                     });
+}
+
+#if !defined(__wasm__)
+Status ReadExternalDataInChunks(
+    const Env& env, const std::filesystem::path& model_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+    size_t chunk_size, const std::function<Status(size_t offset, gsl::span<const char> chunk)>& process_chunk) {
+  ORT_RETURN_IF(chunk_size == 0, "The chunk size must be positive.");
+
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (!model_path.empty()) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_path, tensor_proto_dir));
+  }
+
+  std::basic_string<ORTCHAR_T> external_file_path;
+  onnxruntime::FileOffsetType file_offset;
+  SafeInt<size_t> tensor_byte_size;
+  ORT_RETURN_IF_ERROR(
+      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset, tensor_byte_size));
+  ORT_RETURN_IF(external_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag,
+                "The external data of ", tensor_proto.name(), " is in memory.");
+
+  const size_t size = tensor_byte_size;
+  const size_t buffer_size = std::min(chunk_size, size);
+  std::array<std::unique_ptr<char[]>, 2> buffers{std::make_unique<char[]>(buffer_size),
+                                                 std::make_unique<char[]>(buffer_size)};
+
+  const auto read_chunk = [&](size_t offset, char* buffer) {
+    const size_t length = std::min(chunk_size, size - offset);
+    return env.ReadFileIntoBuffer(external_file_path.c_str(), file_offset + narrow<FileOffsetType>(offset), length,
+                                  gsl::make_span(buffer, length));
+  };
+
+  if (size > 0) {
+    ORT_RETURN_IF_ERROR(read_chunk(0, buffers[0].get()));
+  }
+
+  // double buffering: the next chunk is read into the other buffer while the current one is processed
+  for (size_t offset = 0, current = 0; offset < size; offset += chunk_size, current ^= 1) {
+    const size_t next_offset = offset + std::min(chunk_size, size - offset);
+    std::future<Status> next_read;
+    if (next_offset < size) {
+      next_read = std::async(std::launch::async, read_chunk, next_offset, buffers[current ^ 1].get());
+    }
+
+    const Status process_status = process_chunk(
+        offset, gsl::make_span(buffers[current].get(), std::min(chunk_size, size - offset)));
+    if (next_read.valid()) {
+      const Status read_status = next_read.get();
+      ORT_RETURN_IF_ERROR(process_status);
+      ORT_RETURN_IF_ERROR(read_status);
+    } else {
+      ORT_RETURN_IF_ERROR(process_status);
+    }
+  }
+
+  return Status::OK();
+}
+#endif
+
 Status TensorProtoToOrtValueImpl(const Env& env, const std::filesystem::path& model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                  AllocatorPtr alloc, OrtValue& value) {
@@ -955,6 +1024,10 @@ static void DeleteCharArray(void* param) noexcept {
 }
 
 #if !defined(__wasm__)
+static void DeleteAlignedCharArray(void* param) noexcept {
+  ::operator delete[](param, std::align_val_t{kAllocAlignment});
+}
+
 static Status GetFileContent(const Env& env, const std::filesystem::path& file_path, FileOffsetType offset,
                              size_t length, void*& raw_buffer, OrtCallback& deleter) {
   // query length if it is 0
@@ -963,23 +1036,25 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
     length = narrow<size_t>(std::filesystem::file_size(file_path));
   }
 
-  // first, try to map into memory
+  // first, try to map into memory. the mapping starts at the offset in the file, so the data is only aligned as
+  // the kernels expect if the offset is. e.g. the initializers streamed from a model file are at arbitrary offsets.
   {
     Env::MappedMemoryPtr mapped_memory{};
     auto status = env.MapFileIntoMemory(file_path.native().c_str(), offset, length, mapped_memory);
-    if (status.IsOK()) {
+    if (status.IsOK() && reinterpret_cast<uintptr_t>(mapped_memory.get()) % kAllocAlignment == 0) {
       deleter = mapped_memory.get_deleter().callback;
       raw_buffer = mapped_memory.release();
       return Status::OK();
     }
   }
 
-  // if that fails, try to copy
-  auto buffer = std::make_unique<char[]>(length);
+  // if that fails or is misaligned, copy into an aligned buffer
+  std::unique_ptr<char[], void (*)(void*) noexcept> buffer{
+      static_cast<char*>(::operator new[](length, std::align_val_t{kAllocAlignment})), DeleteAlignedCharArray};
   ORT_RETURN_IF_ERROR(
       env.ReadFileIntoBuffer(file_path.native().c_str(), offset, length, gsl::make_span(buffer.get(), length)));
 
-  deleter = OrtCallback{DeleteCharArray, buffer.get()};
+  deleter = OrtCallback{DeleteAlignedCharArray, buffer.get()};
   raw_buffer = buffer.release();
   return Status::OK();
 }
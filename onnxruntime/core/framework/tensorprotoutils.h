@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <type_traits>
 #include <string>
@@ -159,6 +160,18 @@ common::Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::
                                          OrtCallback& ext_data_deleter,
                                          Tensor* buffered_tensor = nullptr);
 
+// Returns true if tensor_proto's external file path is kTensorProtoMemoryAddressTag.
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+#if !defined(__wasm__)
+// Read the external data of a tensor proto from its file in chunks of at most chunk_size bytes, calling process_chunk
+// with the offset of each chunk in the tensor data. The next chunk is read while process_chunk runs, and the chunk
+// buffer is reused once process_chunk returns. The data must not be in memory.
+common::Status ReadExternalDataInChunks(
+    const Env& env, const std::filesystem::path& model_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+    size_t chunk_size, const std::function<common::Status(size_t offset, gsl::span<const char> chunk)>& process_chunk);
+#endif
+
 // Convert the AttributeProto from a Constant node into a TensorProto that can be used as an initializer
 // If AttributeProto contains a TensorProto, this tensor proto is converted as is including the case when the
 // the data location is external. i.e. it does not load the external data.
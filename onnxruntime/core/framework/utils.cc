@@ -3,6 +3,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/utils.h"
 
+#include <algorithm>
 #include <iomanip>
 
 #include "core/graph/graph_viewer.h"
@@ -83,14 +84,12 @@ static common::Status AllocateHelper(const AllocatorPtr& allocator,
 
   if (source_mlvalue.IsTensor()) {
     const Tensor& source_tensor = source_mlvalue.Get<Tensor>();
-    if (allocator->Info().alloc_type == OrtArenaAllocator) {
+    if (allocator->IsStreamAware()) {
       void* p_data = nullptr;
 #ifdef ORT_ENABLE_STREAM
-      BFCArena* arena_ptr = static_cast<BFCArena*>(allocator.get());
-      auto* stream_aware_alloc = StreamAwareArena::FromBFCArena(*arena_ptr);
-      if (stream_aware_alloc && target_stream) {
+      if (target_stream) {
         size_t len = Tensor::CalculateTensorStorageSize(source_tensor.DataType(), source_tensor.Shape());
-        p_data = stream_aware_alloc->AllocOnStream(len, target_stream, nullptr);
+        p_data = allocator->AllocOnStream(len, target_stream, nullptr);
       }
 #else
       ORT_UNUSED_PARAMETER(target_stream);
@@ -733,9 +732,65 @@ ExecuteGraphImpl(const SessionState& session_state,
   return Status::OK();
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Non-contiguous feeds, e.g. views created with OrtApi::CreateTensorWithDataAndStridesAsOrtValue, are passed through
+// as-is if every kernel consuming them accepts strided inputs. Otherwise a contiguous copy is made here so kernels
+// that assume contiguous data read the right elements.
+// contiguous_feeds is left empty if no feed needed a copy.
+static common::Status MakeStridedFeedsContiguous(const SessionState& session_state,
+                                                 const FeedsFetchesManager& feeds_fetches_manager,
+                                                 gsl::span<const OrtValue> feeds,
+                                                 std::vector<OrtValue>& contiguous_feeds) {
+  const auto& feed_names = feeds_fetches_manager.GetFeedsFetchesInfo().feed_names;
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (!feeds[i].IsTensor() || feeds[i].Get<Tensor>().IsContiguous()) {
+      continue;
+    }
+
+    InlinedVector<SessionState::NodeInfo> node_info_vec;
+    bool consumers_accept_strided = session_state.GetInputNodeInfo(feed_names[i], node_info_vec).IsOK();
+    for (const auto& node_info : node_info_vec) {
+      if (node_info.p_node == nullptr) {
+        // input that isn't used in the graph
+        continue;
+      }
+
+      // implicit inputs of control flow nodes have an invalid index and are never passed through
+      const KernelDef* kernel_def = node_info.kci != nullptr ? node_info.kci->kernel_def.get() : nullptr;
+      if (kernel_def == nullptr ||
+          std::find(kernel_def->MayStridedInput().begin(), kernel_def->MayStridedInput().end(),
+                    static_cast<int>(node_info.index)) == kernel_def->MayStridedInput().end()) {
+        consumers_accept_strided = false;
+        break;
+      }
+    }
+
+    if (consumers_accept_strided) {
+      continue;
+    }
+
+    if (contiguous_feeds.empty()) {
+      contiguous_feeds.assign(feeds.begin(), feeds.end());
+    }
+
+    const Tensor& strided = feeds[i].Get<Tensor>();
+    auto allocator = session_state.GetAllocator(strided.Location().device);
+    ORT_RETURN_IF(allocator == nullptr, "Failed to find allocator for device ", strided.Location().device.ToString(),
+                  " to make input '", feed_names[i], "' contiguous.");
+    OrtValue contiguous;
+    Tensor::InitOrtValue(strided.DataType(), strided.Shape(), std::move(allocator), contiguous);
+    ORT_RETURN_IF_ERROR(session_state.GetDataTransferMgr().CopyTensor(strided, *contiguous.GetMutable<Tensor>()));
+    contiguous_feeds[i] = std::move(contiguous);
+  }
+
+  return Status::OK();
+}
+#endif
+
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             ExecutionMode execution_mode, const bool& terminate_flag,
                             const logging::Logger& logger,
 #ifdef ORT_ENABLE_STREAM
@@ -745,18 +800,26 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             Stream* parent_stream) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
+#ifdef ENABLE_STRIDED_TENSORS
+  std::vector<OrtValue> contiguous_feeds;
+  ORT_RETURN_IF_ERROR(MakeStridedFeedsContiguous(session_state, feeds_fetches_manager, feeds, contiguous_feeds));
+  if (!contiguous_feeds.empty()) {
+    feeds = contiguous_feeds;
+  }
+#endif
+
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
-  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                                  execution_mode, terminate_flag, logger,
                                  device_stream_collection,
                                  only_execute_path_to_fetches,
                                  parent_stream);
   return retval;
 #else
-  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                           execution_mode, terminate_flag, logger,
                           only_execute_path_to_fetches,
                           parent_stream);
@@ -766,6 +829,7 @@ common::Status ExecuteGraph(const SessionState& session_state,
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             ExecutionMode execution_mode, const RunOptions& run_options,
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
@@ -773,7 +837,7 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             const logging::Logger& logger) {
   return ExecuteGraph(session_state,
                       feeds_fetches_manager,
-                      feeds, fetches,
+                      feeds, fetches, fetch_allocators,
                       execution_mode,
                       run_options.terminate,
                       logger,
@@ -898,16 +962,18 @@ common::Status ExecutePartialGraph(const SessionState& session_state, FeedsFetch
 }
 #endif
 
-common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
-                               gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
-                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
-                               Stream* parent_stream,
-                               bool sync_subgraph_fetches) {
+static common::Status ExecuteSubgraphImpl(const SessionState& session_state,
+                                          const FeedsFetchesManager& feeds_fetches_manager,
+                                          gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                          ExecutionMode execution_mode, const bool& terminate_flag,
+                                          const logging::Logger& logger,
+#ifdef ORT_ENABLE_STREAM
+                                          DeviceStreamCollection* device_stream_collection,
+#endif
+                                          Stream* parent_stream,
+                                          bool sync_subgraph_fetches) {
 #ifdef ORT_ENABLE_STREAM
-  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
-  DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
-
   auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                                  execution_mode, terminate_flag, logger, device_stream_collection, false, parent_stream);
   if (device_stream_collection)
@@ -922,6 +988,53 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
   return retval;
 }
 
+common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                               gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
+                               Stream* parent_stream,
+                               bool sync_subgraph_fetches) {
+#ifdef ORT_ENABLE_STREAM
+  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
+  return ExecuteSubgraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                             execution_mode, terminate_flag, logger, device_stream_collection_holder.p_.get(),
+                             parent_stream, sync_subgraph_fetches);
+#else
+  return ExecuteSubgraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                             execution_mode, terminate_flag, logger, parent_stream, sync_subgraph_fetches);
+#endif
+}
+
+RepeatedSubgraphExecutor::RepeatedSubgraphExecutor(const SessionState& session_state,
+                                                   const FeedsFetchesManager& feeds_fetches_manager,
+                                                   ExecutionMode execution_mode, const bool& terminate_flag,
+                                                   const logging::Logger& logger, Stream* parent_stream)
+    : session_state_(session_state),
+      feeds_fetches_manager_(feeds_fetches_manager),
+      execution_mode_(execution_mode),
+      terminate_flag_(terminate_flag),
+      logger_(logger),
+      parent_stream_(parent_stream)
+#ifdef ORT_ENABLE_STREAM
+      ,
+      device_stream_collection_holder_(&session_state)
+#endif
+{
+}
+
+common::Status RepeatedSubgraphExecutor::Execute(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                                 bool sync_subgraph_fetches) {
+  // the device stream collection is cleaned up at the end of each execution in the same way as ExecuteSubgraph,
+  // so reusing it for the next iteration is equivalent to it being recycled and re-acquired from the SessionState.
+  return ExecuteSubgraphImpl(session_state_, feeds_fetches_manager_, feeds, fetches, fetch_allocators,
+                             execution_mode_, terminate_flag_, logger_,
+#ifdef ORT_ENABLE_STREAM
+                             device_stream_collection_holder_.p_.get(),
+#endif
+                             parent_stream_, sync_subgraph_fetches);
+}
+
 int32_t ONNXTensorElementDataTypeToProtoTensorType(ONNXTensorElementDataType onnx_enum) {
   switch (onnx_enum) {
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
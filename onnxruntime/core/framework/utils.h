@@ -81,8 +81,10 @@ void FinalizeFeedFetchCopyInfo(FeedsFetchesManager& feeds_fetches_manager,
                                gsl::span<const OrtDevice* const> fetch_alloc_info);
 
 // Execute the main graph. The feed_fetches_manager will be finalized based on the provided feeds and fetches.
+// fetch_allocators are optional custom allocators for fetches that are not pre-allocated. key is index in fetches.
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
@@ -92,6 +94,7 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
 
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                             ExecutionMode execution_mode, const RunOptions& run_options,
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
@@ -120,6 +123,34 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                subgraph fetches, i.e. the loop condition*/
                                bool sync_subgraph_fetches = false);
 
+// Execute the same subgraph repeatedly, e.g. once per iteration of a Loop or Scan node.
+// State that does not depend on the feeds (currently the device stream collection) is acquired from the
+// SessionState once for the lifetime of this instance and reused by every call to Execute, rather than being
+// acquired and recycled for each iteration. Each Execute call behaves like an ExecuteSubgraph call.
+class RepeatedSubgraphExecutor {
+ public:
+  RepeatedSubgraphExecutor(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                           ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
+                           Stream* parent_stream);
+
+  common::Status Execute(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                         bool sync_subgraph_fetches = false);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RepeatedSubgraphExecutor);
+
+  const SessionState& session_state_;
+  const FeedsFetchesManager& feeds_fetches_manager_;
+  const ExecutionMode execution_mode_;
+  const bool& terminate_flag_;
+  const logging::Logger& logger_;
+  Stream* const parent_stream_;
+#ifdef ORT_ENABLE_STREAM
+  DeviceStreamCollectionHolder device_stream_collection_holder_;
+#endif
+};
+
 bool IsInputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 bool IsOutputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 
@@ -320,6 +320,23 @@ void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext&
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
   constexpr int use_max_past_present_buffer = -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
+
+  // The present key/value of a paged cache are the updated block pools.
+  if (getAttribute(ctx, "kv_block_size", 0) > 0 && ctx.getNumOutputs() > 2 && hasInputShape(ctx, past_key_index) &&
+      hasInputShape(ctx, past_key_index + 1)) {
+    ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, past_key_index, 1);
+    ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, static_cast<size_t>(past_key_index) + 1, 2);
+  }
+
+  // An int8 key/value cache comes with fp32 scales per token of each head.
+  if (getAttribute(ctx, "kv_cache_bit_width", 0) == 8 && ctx.getNumOutputs() > 1) {
+    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT8);
+    updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::INT8);
+    if (ctx.getNumOutputs() > 4) {
+      updateOutputElemType(ctx, 3, ONNX_NAMESPACE::TensorProto::FLOAT);
+      updateOutputElemType(ctx, 4, ONNX_NAMESPACE::TensorProto::FLOAT);
+    }
+  }
 }
 
 void SparseAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
@@ -1049,6 +1066,9 @@ Supports different number of heads for q and kv for CPU and CUDA.
 Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
+Supports a paged key/value cache addressed through a block table for CPU.
+Supports prompts split into chunks for CPU: a chunk after the first one follows the (seqlens_k + 1 - sequence_length)
+past tokens of its sequence.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1073,6 +1093,19 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "Rotate using interleaved pattern. Default value is 0 (False).",
               AttributeProto::INT,
               OPTIONAL_VALUE)
+        .Attr("kv_cache_bit_width",
+              "Number of bits of the elements of the past and present key/value cache. 0 (default) keeps the cache "
+              "in the type of the inputs; 8 quantizes it to int8 with one scale per token of each head, given by the "
+              "past_key_scale, past_value_scale, present_key_scale and present_value_scale tensors.",
+              AttributeProto::INT,
+              static_cast<int64_t>(0))
+        .Attr("kv_block_size",
+              "Number of tokens per block of a paged key/value cache. 0 (default) keeps the cache of each sequence "
+              "contiguous; otherwise past_key and past_value are pools of blocks with shape (num_blocks, "
+              "kv_num_heads, kv_block_size, head_size) shared by the sequences of the batch, and block_table gives "
+              "the blocks of each sequence.",
+              AttributeProto::INT,
+              static_cast<int64_t>(0))
         .Input(0,
                "query",
                "Query with shape (batch_size, sequence_length, hidden_size), or packed QKV with shape"
@@ -1092,13 +1125,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1119,6 +1152,25 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "past_key_scale",
+               "Scales of the int8 past_key with shape (batch_size, kv_num_heads, past_sequence_length) when "
+               "kv_cache_bit_width is 8.",
+               "T_SCALE",
+               OpSchema::Optional)
+        .Input(10,
+               "past_value_scale",
+               "Scales of the int8 past_value with shape (batch_size, kv_num_heads, past_sequence_length) when "
+               "kv_cache_bit_width is 8.",
+               "T_SCALE",
+               OpSchema::Optional)
+        .Input(11,
+               "block_table",
+               "Blocks of the paged key/value cache used by each sequence, in order, with shape (batch_size, "
+               "max_blocks_per_sequence) when kv_block_size is set. Token t of sequence b is stored at row "
+               "t % kv_block_size of block block_table[b, t / kv_block_size].",
+               "M",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1128,14 +1180,29 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
+        .Output(3,
+                "present_key_scale",
+                "Scales of the int8 present_key with shape (batch_size, kv_num_heads, present_sequence_length) when "
+                "kv_cache_bit_width is 8.",
+                "T_SCALE",
+                OpSchema::Optional)
+        .Output(4,
+                "present_value_scale",
+                "Scales of the int8 present_value with shape (batch_size, kv_num_heads, present_sequence_length) when "
+                "kv_cache_bit_width is 8.",
+                "T_SCALE",
+                OpSchema::Optional)
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain the key/value cache to float tensors, or int8 tensors when kv_cache_bit_width is 8.")
+        .TypeConstraint("T_SCALE", {"tensor(float)"}, "Constrain the scales of the key/value cache to float tensors.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
@@ -1350,6 +1417,33 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "ragged batch inputs or not. Default value is 0",
               AttributeProto::INT,
               OPTIONAL_VALUE)
+        .Attr("rope_theta",
+              "Base of the rotary frequencies when cos_cache and sin_cache are not provided. Default value is 10000.0",
+              AttributeProto::FLOAT,
+              OPTIONAL_VALUE)
+        .Attr("rope_scaling_type",
+              "Scaling of the rotary frequencies when cos_cache and sin_cache are not provided: none, linear, ntk, "
+              "yarn or longrope. Default value is none",
+              AttributeProto::STRING,
+              OPTIONAL_VALUE)
+        .Attr("rope_scaling_factor",
+              "Factor of the context extension of rope_scaling_type. Default value is 1.0",
+              AttributeProto::FLOAT,
+              OPTIONAL_VALUE)
+        .Attr("original_max_position_embeddings",
+              "Context length the model was trained with, required by the yarn and longrope scaling",
+              AttributeProto::INT,
+              OPTIONAL_VALUE)
+        .Attr("long_factor",
+              "Rescale factors of the rotary_embedding_dim / 2 frequencies of the longrope scaling beyond "
+              "original_max_position_embeddings",
+              AttributeProto::FLOATS,
+              OPTIONAL_VALUE)
+        .Attr("short_factor",
+              "Rescale factors of the rotary_embedding_dim / 2 frequencies of the longrope scaling up to "
+              "original_max_position_embeddings",
+              AttributeProto::FLOATS,
+              OPTIONAL_VALUE)
         .Input(0,
                "input",
                "3D tensor with shape (batch_size, sequence_length, hidden_size) or 4D with shape (batch_size, num_heads, sequence_length, head_size)",
@@ -1360,12 +1454,15 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "M")
         .Input(2,
                "cos_cache",
-               "2D tensor with shape (max_sequence_length, head_size / 2) or (max_sequence_length, rotary_embedding_dim / 2)",
-               "T")
+               "2D tensor with shape (max_sequence_length, head_size / 2) or (max_sequence_length, rotary_embedding_dim / 2). "
+               "When cos_cache and sin_cache are absent, the CPU kernel computes them with rope_theta and rope_scaling_type.",
+               "T",
+               OpSchema::Optional)
         .Input(3,
                "sin_cache",
                "2D tensor with shape (max_sequence_length, head_size / 2) or (max_sequence_length, rotary_embedding_dim / 2)",
-               "T")
+               "T",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "tensor with same shape as input.",
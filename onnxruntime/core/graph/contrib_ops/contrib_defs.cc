@@ -761,6 +761,88 @@ ONNX_MS_OPERATOR_SET_SCHEMA(TorchEmbedding, 1,
                                   updateOutputShape(ctx, 0, outputs_shape);
                                 }));
 
+constexpr const char* EmbeddingBag_ver1_doc = R"DOC(
+      Based on Torch operator EmbeddingBag, sums or averages the rows of an embedding table selected by the indices
+      of each bag without materializing the gathered rows. Bag b holds indices[offsets[b]:offsets[b + 1]], the last
+      bag ends at the end of indices, an empty bag gives a row of zeros.
+      )DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(EmbeddingBag, 1,
+                            OpSchema()
+                                .SetDoc(EmbeddingBag_ver1_doc)
+                                .Attr("mode",
+                                      "How the rows of a bag are reduced, 'sum' or 'mean'.",
+                                      AttributeProto::STRING, std::string("sum"))
+                                .Input(0, "weight", "The embedding table of shape (N, M).", "T")
+                                .Input(1, "indices", "1D tensor of the rows to look up, each within [0, N).", "Tind")
+                                .Input(2, "offsets",
+                                       "1D tensor of shape (B) with the start of each bag in indices. It must start at 0 "
+                                       "and be non-decreasing.",
+                                       "Tind")
+                                .Input(3, "per_sample_weights",
+                                       "Optional weights of the same shape as indices that scale each looked up row. "
+                                       "Only supported with mode 'sum'.",
+                                       "T", OpSchema::Optional)
+                                .Output(0, "Y", "The reduced rows of shape (B, M).", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain the table and output to float.")
+                                .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"},
+                                                "Constrain indices and offsets to integer types.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  using namespace ONNX_NAMESPACE;
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+                                    return;
+                                  }
+                                  auto& weight_shape = getInputShape(ctx, 0);
+                                  auto& offsets_shape = getInputShape(ctx, 2);
+                                  if (weight_shape.dim_size() != 2) {
+                                    fail_shape_inference("weight must be 2D");
+                                  }
+                                  if (offsets_shape.dim_size() != 1) {
+                                    fail_shape_inference("offsets must be 1D");
+                                  }
+                                  TensorShapeProto output_shape;
+                                  *output_shape.add_dim() = offsets_shape.dim(0);
+                                  *output_shape.add_dim() = weight_shape.dim(1);
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+      Evaluates a chain of elementwise operators in one pass over the output, as fused by the ElementwiseFusion
+      optimizer. Registers 0 to N - 1 hold the N inputs and register N + i holds the result of the operator i,
+      the result of the last operator is the output. Every input has the shape of the output or a single element.
+      )DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(FusedElementwise, 1,
+                            OpSchema()
+                                .SetDoc(FusedElementwise_ver1_doc)
+                                .Attr("ops",
+                                      "The operators in evaluation order, any of Add, Sub, Mul, Div, Abs, Erf, Exp, "
+                                      "Neg, Relu, Sigmoid, Sqrt and Tanh.",
+                                      AttributeProto::STRINGS)
+                                .Attr("operands",
+                                      "Two registers per operator holding its inputs, the second one is -1 for the "
+                                      "unary operators. An operator can only read the inputs and the results of the "
+                                      "operators before it.",
+                                      AttributeProto::INTS)
+                                .Input(0, "inputs", "The inputs of the chain.", "T", OpSchema::Variadic)
+                                .Output(0, "output", "The result of the last operator.", "T")
+                                .TypeConstraint("T", {"tensor(float)", "tensor(float16)"},
+                                                "Constrain the inputs and output to float tensors.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  using namespace ONNX_NAMESPACE;
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  std::vector<const TensorShapeProto*> shapes;
+                                  for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+                                    if (!hasInputShape(ctx, i)) {
+                                      return;
+                                    }
+                                    shapes.push_back(&getInputShape(ctx, i));
+                                  }
+                                  multidirectionalBroadcastShapeInference(
+                                      shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+                                }));
+
 constexpr const char* Trilu_ver1_doc = R"DOC(
       Returns the upper or lower triangular part of a 2-D matrix, or batches of 2-D matrices. If the attribute "upper" is set to true,
       the upper triangular matrix is retained. Lower triangular matrix is retained otherwise. Default value for upper is true.
@@ -1321,6 +1403,18 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "Smaller decoder subgraph with the inputs, outputs and vocabulary of `decoder`. If present, it proposes "
+                                      "`num_speculative_tokens` tokens that the `decoder` subgraph verifies in one run. "
+                                      "This is relevant only for the GPT2 model and the CPU execution of a single sequence",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens", "The number of tokens proposed by `draft_decoder` in each step.",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
+                                .Attr("prefix_cache_size",
+                                      "The number of prompts whose past state is kept across runs. A prompt that starts with a kept prompt "
+                                      "only runs the `decoder` subgraph on its remaining tokens. Relevant only for the CPU execution of a "
+                                      "single sequence without padding. Default value 0 disables the cache",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1332,6 +1426,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                 .Input(4, "vocab_mask", "Mask of vocabulary. Words that masked with 0 are not allowed to be generated, and 1 is allowed. Shape is (vocab_size)", "I", OpSchema::Optional)
                                 .Input(5, "prefix_vocab_mask", "Mask of vocabulary for first step. Words that masked with 0 are not allowed to be generated, and 1 is allowed. Shape is (batch_size, vocab_size)", "I", OpSchema::Optional)
                                 .Input(6, "attention_mask", "Custom attention mask. Shape is (batch_size, sequence_length)", "I", OpSchema::Optional)
+                                .Input(7, "grammar_transitions", "Token level state machine of constrained decoding. The value at (state, token) is the state after the token, or -1 when the token is not allowed. Generation starts in state 0. Shape is (num_states, vocab_size)", "I", OpSchema::Optional)
                                 .Output(0, "sequences", "Word IDs of generated sequences. Shape is (batch_size, max_sequence_length)", "I")
                                 // TODO(wy): support scores if needed.
                                 .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
@@ -1375,6 +1470,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
                                 .Input(6, "attention_mask", "Custom attention mask. Shape is (batch_size, sequence_length)", "I", OpSchema::Optional)
                                 .Input(7, "presence_mask", "Presence penalty mask. Shape is (batch_size, vocab_size)", "I", OpSchema::Optional)
                                 .Input(8, "seed", "Seed for random number generator. Shape is (1)", "I", OpSchema::Optional)
+                                .Input(9, "grammar_transitions", "Token level state machine of constrained decoding. The value at (state, token) is the state after the token, or -1 when the token is not allowed. Generation starts in state 0. Shape is (num_states, vocab_size)", "I", OpSchema::Optional)
                                 .Output(0, "sequences", "Word IDs of generated sequences. Shape is (batch_size, max_sequence_length)", "I")
                                 .Output(1, "filtered_logits", "Filtered logits as input to the mutinomial function for debug purpose. Shape is (batch_size, vocab_size)", "T", OpSchema::Optional)
                                 .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
@@ -3429,6 +3525,9 @@ Input scales is stored in same type as original type of B(float32, float16) with
 Input zero_points is stored as uint8_t or same as type(A). It has the same packing method as input B.
   - [CeilDiv((N * n_blocks_per_col + 1) *bits, 8)]
   If zero_points has same type as A, it's not packed and has the same shape as Scales.
+
+The optional attribute activation and inputs multiplier and residual fuse the elementwise operations that follow
+the MatMul: Y = activation(A * dequant(B) + bias) * multiplier + residual.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBits)
@@ -3446,12 +3545,20 @@ Input zero_points is stored as uint8_t or same as type(A). It has the same packi
             "computation. 4 means input A can be quantized with the same block_size to int8 internally from "
             "type T1.",
             AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("activation",
+            "Activation applied to the result after the bias is added, can be: gelu, fastgelu or silu "
+            "(default unset). It is set when the following activation is fused into this node.",
+            AttributeProto::STRING, std::string(""))
       .Input(0, "A", "The input tensor, not quantized", "T1")
       .Input(1, "B", "1 or 2 dimensional data blob", "T2")
       .Input(2, "scales", "quantization scale", "T1")
       .Input(3, "zero_points", "quantization zero points", "T3", OpSchema::Optional)
       .Input(4, "g_idx", "group_idx", "T4", OpSchema::Optional)
       .Input(5, "bias", "Bias to add to result. It should have shape [N].", "T1", OpSchema::Optional)
+      .Input(6, "multiplier", "Tensor to multiply the activated result with, e.g., the up projection of a SwiGLU "
+             "block. It should have the same shape as Y.", "T1", OpSchema::Optional)
+      .Input(7, "residual", "Tensor to add to the result last. It should have the same shape as Y.", "T1",
+             OpSchema::Optional)
       .Output(0, "Y", "tensor. The output tensor has the same rank as the input. ", "T1")
       .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float/half_float tensors.")
       .TypeConstraint("T2", {"tensor(uint8)", "tensor(int32)"}, "Constrain quantized weight types to uint8/int32.")
@@ -3553,6 +3660,11 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
   3. During the op execution, `data` and `indices` are first used to generate the quantized output. Then, `scales` and `zero_points` are used
      to dequantize the output.
   4. The `output` and `scales` have the same type. The `data` and `zero_points` have the same type.
+  5. If `data` is uint8, it has the layout of input B of MatMulNBits so that a tied embedding and LM head can share
+     one initializer: `data` is [N, n_blocks_per_row, blob_size] with `bits` bits per element, `scales` has
+     N * n_blocks_per_row elements and `zero_points` is packed like `data`, row by row. `gather_axis` must be 0,
+     `quantize_axis` is ignored, and if `zero_points` is not provided, 2^(bits - 1) is the zero point.
+     The output is of rank q + 1 with the last dimension n_blocks_per_row * block_size.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GatherBlockQuantized)
@@ -3571,6 +3683,8 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
             "(Optional) block size used for weight quantization. It needs to be a power of 2 and not smaller than 16.",
             AttributeProto::INT,
             static_cast<int64_t>(128))
+      .Attr("bits", "(Optional) number of bits of an element of uint8 data, 4 or 8.", AttributeProto::INT,
+            static_cast<int64_t>(4))
       .Input(0, "data", "Tensor of rank r >= 1. Block-wise quantized.", "T1")
       .Input(1,
              "indices",
@@ -3580,7 +3694,7 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
       .Input(2, "scales", "quantization scale", "T2")
       .Input(3, "zero_points", "quantization zero points", "T1", OpSchema::Optional)
       .Output(0, "output", "Dequantized output tensor of rank q + (r - 1).", "T2")
-      .TypeConstraint("T1", {"tensor(int4)", "tensor(uint4)"}, "Constrain quantized types.")
+      .TypeConstraint("T1", {"tensor(int4)", "tensor(uint4)", "tensor(uint8)"}, "Constrain quantized types.")
       .TypeConstraint("T2", {"tensor(float)", "tensor(float16)", "tensor(bfloat16)"}, "Constrain dequantized types.")
       .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -3599,6 +3713,22 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
           fail_shape_inference("data tensor must have rank >= 1");
         }
 
+        if (ctx.getInputType(0)->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+          // MatMulNBits layout, the rows are gathered and unpacked to n_blocks_per_row * block_size elements
+          if (r != 3) {
+            fail_shape_inference("uint8 data must have rank 3");
+          }
+          auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+          for (int i = 0; i < indices_shape.dim_size(); ++i) {
+            *output_shape->add_dim() = indices_shape.dim(i);
+          }
+          auto* last_dim = output_shape->add_dim();
+          if (data_shape.dim(1).has_dim_value()) {
+            last_dim->set_dim_value(data_shape.dim(1).dim_value() * getAttribute(ctx, "block_size", 128));
+          }
+          return;
+        }
+
         int gather_axis = static_cast<int>(getAttribute(ctx, "gather_axis", 0));
         int quantize_axis = static_cast<int>(getAttribute(ctx, "quantize_axis", 1));
         auto block_size = getAttribute(ctx, "block_size", 128);
@@ -1044,6 +1044,48 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float32 tensors.")
         .TypeAndShapeInferenceFunction(EmbedLayerNormalizationShapeInference));
 
+constexpr const char* QSkipLayerNormalization_ver1_doc = R"DOC(
+QSkipLayerNormalization is the fusion of SkipLayerNormalization and the QuantizeLinear that consumes its output.
+The normalized output is quantized per tensor with y_scale and y_zero_point while it is computed, so that it is
+written only once.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    QSkipLayerNormalization, 1,
+    OpSchema()
+        .SetDoc(QSkipLayerNormalization_ver1_doc)
+        .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT,
+              kDefaultSkipLayerNormEpsilon)
+        .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+        .Input(1, "skip",
+               "3D skip tensor with shape (batch_size, sequence_length, hidden_size) or "
+               "(1, sequence_length, hidden_size) or (sequence_length, hidden_size)",
+               "T")
+        .Input(2, "gamma", "1D input tensor with shape (hidden_size)", "T")
+        .Input(3, "beta", "1D skip tensor with shape (hidden_size)", "T", OpSchema::Optional)
+        .Input(4, "bias", "1D bias tensor with shape (hidden_size)", "T", OpSchema::Optional)
+        .Input(5, "y_scale", "Scale of the quantized output. It's a scalar.", "T")
+        .Input(6, "y_zero_point", "Zero point of the quantized output. It's a scalar.", "T2")
+        .Output(0, "output", "3D quantized output tensor with shape (batch_size, sequence_length, hidden_size)", "T2")
+        .Output(1, "input_skip_bias_sum",
+                "Sum of the input and skip inputs (and bias if it exists) with shape "
+                "(batch_size, sequence_length, hidden_size).",
+                "T", OpSchema::Optional)
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input types to float tensors.")
+        .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain output types to int8 tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 6, 0);
+          if (ctx.getNumOutputs() > 1) {
+            propagateElemTypeFromInputToOutput(ctx, 0, 1);
+          }
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+          propagateShapeFromInputToOutput(ctx, 0, 0);
+          if (ctx.getNumOutputs() > 1) {
+            propagateShapeFromInputToOutput(ctx, 0, 1);
+          }
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QuantizeWithOrder, 1,
     OpSchema()
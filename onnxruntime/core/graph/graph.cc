@@ -3,6 +3,7 @@
 
 #include "core/graph/graph.h"
 
+#include <atomic>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -180,6 +181,26 @@ static std::string GenerateSchemaKey(const IndexedSubGraph& subgraph_ptr) {
 }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+static bool ShapesAreEqual(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0, end = lhs.dim_size(); i < end; ++i) {
+    const auto& lhs_dim = lhs.dim(i);
+    const auto& rhs_dim = rhs.dim(i);
+    if (lhs_dim.value_case() != rhs_dim.value_case() || lhs_dim.denotation() != rhs_dim.denotation() ||
+        (utils::HasDimValue(lhs_dim) && lhs_dim.dim_value() != rhs_dim.dim_value()) ||
+        (utils::HasDimParam(lhs_dim) && lhs_dim.dim_param() != rhs_dim.dim_param())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+#endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
 NodeArg::NodeArg(const std::string& name, const TypeProto* p_node_arg_type) {
   node_arg_info_.set_name(name);
@@ -196,6 +217,7 @@ NodeArg::NodeArg(const std::string& name, const TypeProto* p_node_arg_type) {
   } else {
     type_ = nullptr;
   }
+  UpdateVersion();
 }
 #endif  // #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
 
@@ -208,6 +230,7 @@ NodeArg::NodeArg(NodeArgInfo&& node_arg_info) {
   else {
     type_ = nullptr;
   }
+  UpdateVersion();
 }
 
 const std::string& NodeArg::Name() const noexcept {
@@ -290,6 +313,13 @@ bool NodeArg::HasTensorOrScalarShape() const {
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  // keep the version if the shape doesn't change, so the consumers are not inferred again
+  const TensorShapeProto* existing_shape = Shape();
+  if (existing_shape != nullptr && ShapesAreEqual(*existing_shape, shape)) {
+    return;
+  }
+
+  UpdateVersion();
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -321,6 +351,11 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
 }
 
 void NodeArg::ClearShape() {
+  if (Shape() == nullptr) {
+    return;
+  }
+
+  UpdateVersion();
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -384,6 +419,7 @@ common::Status NodeArg::OverrideTypesHelper(const ONNX_NAMESPACE::TypeProto& inp
 
 common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& input_type, bool strict,
                                            bool override_types, const logging::Logger& logger) {
+  UpdateVersion();
   if (!utils::HasType(node_arg_info_)) {
     SetType(input_type);
     return Status::OK();
@@ -507,6 +543,7 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  UpdateVersion();
 }
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -516,10 +553,16 @@ void NodeArg::SetType(DataType p_type) {
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  UpdateVersion();
 }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
+void NodeArg::UpdateVersion() noexcept {
+  static std::atomic<uint64_t> next_version{0};
+  version_ = next_version.fetch_add(1, std::memory_order_relaxed);
+}
+
 bool NodeArg::Exists() const noexcept {
   return exists_;
 }
@@ -949,6 +992,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttributeProto(AttributeProto value) {
   utils::SetNodeAttribute(std::move(value), attributes_);
+  ClearInferredArgs();
   if (graph_) {
     graph_->SetGraphResolveNeeded();
     graph_->SetGraphProtoSyncNeeded();
@@ -999,6 +1043,7 @@ void Node::AddAttribute(std::string attr_name, GraphProto value) {
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  ClearInferredArgs();
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -1007,6 +1052,7 @@ bool Node::ClearAttribute(const std::string& attr_name) {
 int Node::PruneRemovableAttributes(gsl::span<const std::string> removable_attributes) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  ClearInferredArgs();
   int n_removed = 0;
   for (const auto& name : removable_attributes) {
     n_removed += static_cast<int>(attributes_.erase(name));
@@ -1072,6 +1118,58 @@ Status Node::UpdateInputArgCount() {
   return Status::OK();
 }
 
+bool Node::IsTypeAndShapeInferenceCurrent() const {
+  const auto& input_defs = definitions_.input_defs;
+  const auto& output_defs = definitions_.output_defs;
+  if (inferred_args_.size() != input_defs.size() + output_defs.size() || inferred_op_ != op_) {
+    return false;
+  }
+
+  auto inferred_arg = inferred_args_.cbegin();
+  for (const NodeArg* input_def : input_defs) {
+    if (inferred_arg->node_arg != input_def || inferred_arg->version != input_def->version_) {
+      return false;
+    }
+
+    const TensorProto* initializer = nullptr;
+    if (input_def->Exists()) {
+      graph_->GetInitializedTensor(input_def->Name(), initializer);
+    }
+
+    if (inferred_arg->initializer != initializer) {
+      return false;
+    }
+    ++inferred_arg;
+  }
+
+  for (const NodeArg* output_def : output_defs) {
+    if (inferred_arg->node_arg != output_def || inferred_arg->version != output_def->version_) {
+      return false;
+    }
+    ++inferred_arg;
+  }
+
+  return true;
+}
+
+void Node::SetTypeAndShapeInferenceCurrent() {
+  inferred_args_.clear();
+  inferred_args_.reserve(definitions_.input_defs.size() + definitions_.output_defs.size());
+  for (const NodeArg* input_def : definitions_.input_defs) {
+    const TensorProto* initializer = nullptr;
+    if (input_def->Exists()) {
+      graph_->GetInitializedTensor(input_def->Name(), initializer);
+    }
+    inferred_args_.push_back({input_def, input_def->version_, initializer});
+  }
+
+  for (const NodeArg* output_def : definitions_.output_defs) {
+    inferred_args_.push_back({output_def, output_def->version_, nullptr});
+  }
+
+  inferred_op_ = op_;
+}
+
 Graph* Node::GetMutableGraphAttribute(const std::string& attr_name) {
   Graph* subgraph = nullptr;
 
@@ -1465,6 +1563,8 @@ Status Graph::VerifyNoDuplicateName() {
 
   output_args.clear();
   node_name_to_index.clear();
+  output_args.reserve(nodes_.size());
+  node_name_to_index.reserve(nodes_.size());
   // inputs_and_initializers: this is passed in as a parameter, since functions don't have initializers
   // but graphs have them.
 
@@ -3077,6 +3177,13 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     lsc.output_names.insert(std::string(input));
   }
 
+  // an initializer is only constant if it is not a graph input, and inferencing may read the data of the constant
+  // initializers, so the nodes are all inferred again if the graph inputs changed.
+  const bool graph_inputs_changed = graph_inputs_including_initializers_ != inferred_graph_inputs_;
+  if (graph_inputs_changed) {
+    inferred_graph_inputs_ = graph_inputs_including_initializers_;
+  }
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
@@ -3166,7 +3273,16 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    // Skip the type and shape inferencing of a node that is unchanged since the last Resolve, as it would give the
+    // same result. Nodes with subgraphs and nodes in subgraphs depend on the outer scope, so they are always inferred.
+    const bool can_reuse_inferencing = parent_node_ == nullptr && outer_scope_node_arg_names_.empty() &&
+                                       !node.ContainsSubgraph();
+    if (!can_reuse_inferencing || graph_inputs_changed || !node.IsTypeAndShapeInferenceCurrent()) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      if (can_reuse_inferencing) {
+        node.SetTypeAndShapeInferenceCurrent();
+      }
+    }
 
     // Accumulate output names of the iterated Node
     for (const auto& output : node.OutputDefs()) {
@@ -3357,7 +3473,10 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   *(tensor_added) = tensor;
   name_to_initial_tensor_.emplace(tensor.name(), tensor_added);
   SetGraphResolveNeeded();
-  if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
+  if (NodeArg* node_arg = GetNodeArg(tensor.name()); node_arg != nullptr) {
+    // the consumers may read the initializer data during type and shape inferencing
+    node_arg->UpdateVersion();
+  } else if (!is_loaded_from_model_file_) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
     // the shape will be set to the correct value in TypeCheckInputsAndInitializers as we don't yet know whether there
     // will be a matching graph input for this initializer (we prefer shape info from the graph input).
@@ -3448,6 +3567,9 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
     sparse_tensor_names_.erase(tensor_name);
 #endif
     SetGraphResolveNeeded();
+    if (NodeArg* node_arg = GetNodeArg(tensor_name); node_arg != nullptr) {
+      node_arg->UpdateVersion();
+    }
   } else {
 #if !defined(DISABLE_SPARSE_TENSORS)
     ORT_ENFORCE(sparse_tensor_names_.count(tensor_name) == 0,
@@ -3505,6 +3627,11 @@ Status Graph::ReplaceInitializedTensorImpl(ONNX_NAMESPACE::TensorProto new_initi
 
   **existing_entry = std::move(new_initializer);
 
+  // new_initializer was moved from, so get the name from the replacement
+  if (NodeArg* node_arg = GetNodeArg((*existing_entry)->name()); node_arg != nullptr) {
+    node_arg->UpdateVersion();
+  }
+
   return Status::OK();
 }
 
@@ -58,6 +58,7 @@ Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
       ORT_RETURN_IF_ERROR(external_writer(src_type, unpacked_tensor, offset));
       external_data_offset = onnxruntime::narrow<int64_t>(offset);  // offset in fb is int64_t so -1 can mark not in use
     } else {
+      builder.ForceVectorAlignment(unpacked_tensor.size(), sizeof(uint8_t), kInitializerRawDataAlignment);
       raw_data = builder.CreateVector(unpacked_tensor.data(), unpacked_tensor.size());
     }
   }
@@ -299,7 +300,9 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
   } else {
     const auto* fbs_raw_data = fbs_tensor.raw_data();
     if (fbs_raw_data) {
-      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127) {
+      // models saved before the raw data was aligned are copied, as kernels may require aligned data
+      const bool is_aligned = reinterpret_cast<uintptr_t>(fbs_raw_data->Data()) % kInitializerRawDataAlignment == 0;
+      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127 && is_aligned) {
         initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
 
         static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
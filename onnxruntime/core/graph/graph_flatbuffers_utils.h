@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <filesystem>
 
@@ -61,6 +62,13 @@ using ExternalDataReader = std::function<Status(uint64_t offset, gsl::span<uint8
 /// </remarks>
 constexpr uint32_t kMinimumSizeForExternalData = 64;
 
+/// <summary>
+/// Alignment of the raw data of initializers in an ORT format flatbuffer.
+/// </summary>
+/// <remarks>allows initializers to be used in place from a memory mapped model with vectorized kernels.
+/// flatbuffers doesn't support alignments larger than FLATBUFFERS_MAX_ALIGNMENT.</remarks>
+constexpr size_t kInitializerRawDataAlignment = std::min<size_t>(64, FLATBUFFERS_MAX_ALIGNMENT);
+
 /// <summary>
 /// Save an initializer to an ORT format flatbuffer.
 /// </summary>
@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <optional>
 #include "core/common/logging/logging.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
@@ -487,6 +490,197 @@ Status Model::Load(ModelProto&& model_proto,
   return status;
 }
 
+namespace {
+
+// Raw data of initializers of at least this size is referenced in the model file instead of being read.
+constexpr uint64_t kMinimumSizeForStreamedInitializer = 1024;
+
+// protobuf wire format tags of the fields the streaming loader handles
+constexpr uint64_t kModelGraphTag = (7 << 3) | 2;
+constexpr uint64_t kGraphInitializerTag = (5 << 3) | 2;
+constexpr uint64_t kTensorRawDataTag = (9 << 3) | 2;
+
+// Reads protobuf wire format from a stream, tracking a 64-bit position so that files over 2GB can be read.
+class ProtoStreamReader {
+ public:
+  explicit ProtoStreamReader(std::istream& stream) : stream_(stream) {}
+
+  int64_t Position() const { return position_; }
+
+  // Returns false at the end of the stream or if the varint is truncated.
+  bool ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const auto c = stream_.get();
+      if (c == std::char_traits<char>::eof()) {
+        return false;
+      }
+
+      ++position_;
+      value |= static_cast<uint64_t>(c & 0x7F) << shift;
+      if ((c & 0x80) == 0) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  Status ReadBytes(uint64_t length, std::string& out) {
+    const size_t offset = out.size();
+    out.resize(offset + narrow<size_t>(length));
+    stream_.read(out.data() + offset, narrow<std::streamsize>(length));
+    ORT_RETURN_IF_NOT(stream_.good(), "Unexpected end of the protobuf stream.");
+    position_ += narrow<int64_t>(length);
+    return Status::OK();
+  }
+
+  Status Skip(uint64_t length) {
+    stream_.seekg(narrow<std::streamoff>(length), std::ios_base::cur);
+    ORT_RETURN_IF_NOT(stream_.good(), "Unexpected end of the protobuf stream.");
+    position_ += narrow<int64_t>(length);
+    return Status::OK();
+  }
+
+ private:
+  std::istream& stream_;
+  int64_t position_{0};
+};
+
+void AppendVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+Status ReadLength(ProtoStreamReader& reader, uint64_t& length) {
+  ORT_RETURN_IF_NOT(reader.ReadVarint(length), "Unexpected end of the protobuf stream.");
+  return Status::OK();
+}
+
+// Appends the field with the tag that was just read to `fields` in wire format.
+Status CopyField(ProtoStreamReader& reader, uint64_t tag, std::string& fields) {
+  AppendVarint(tag, fields);
+  switch (tag & 7) {
+    case 0: {  // varint
+      uint64_t value = 0;
+      ORT_RETURN_IF_ERROR(ReadLength(reader, value));
+      AppendVarint(value, fields);
+      return Status::OK();
+    }
+    case 1:  // fixed64
+      return reader.ReadBytes(8, fields);
+    case 2: {  // length delimited
+      uint64_t length = 0;
+      ORT_RETURN_IF_ERROR(ReadLength(reader, length));
+      AppendVarint(length, fields);
+      return reader.ReadBytes(length, fields);
+    }
+    case 5:  // fixed32
+      return reader.ReadBytes(4, fields);
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Unsupported protobuf wire type ", tag & 7);
+  }
+}
+
+Status ReadTensorProto(ProtoStreamReader& reader, int64_t end, const std::string& model_file_name,
+                       TensorProto& tensor_proto) {
+  std::string fields;
+  std::optional<std::pair<int64_t, uint64_t>> raw_data_location;
+  uint64_t tag = 0;
+  while (reader.Position() < end && reader.ReadVarint(tag)) {
+    if (tag != kTensorRawDataTag) {
+      ORT_RETURN_IF_ERROR(CopyField(reader, tag, fields));
+      continue;
+    }
+
+    uint64_t length = 0;
+    ORT_RETURN_IF_ERROR(ReadLength(reader, length));
+    if (length >= kMinimumSizeForStreamedInitializer) {
+      raw_data_location.emplace(reader.Position(), length);
+      ORT_RETURN_IF_ERROR(reader.Skip(length));
+    } else {
+      AppendVarint(tag, fields);
+      AppendVarint(length, fields);
+      ORT_RETURN_IF_ERROR(reader.ReadBytes(length, fields));
+    }
+  }
+
+  ORT_RETURN_IF_NOT(reader.Position() == end && tensor_proto.ParseFromString(fields),
+                    "Protobuf parsing failed for an initializer.");
+
+  if (raw_data_location.has_value()) {
+    // the data is read from the model file like external data when the session state is created
+    tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+    auto* entry = tensor_proto.mutable_external_data()->Add();
+    entry->set_key("location");
+    entry->set_value(model_file_name);
+    entry = tensor_proto.mutable_external_data()->Add();
+    entry->set_key("offset");
+    entry->set_value(std::to_string(raw_data_location->first));
+    entry = tensor_proto.mutable_external_data()->Add();
+    entry->set_key("length");
+    entry->set_value(std::to_string(raw_data_location->second));
+  }
+
+  return Status::OK();
+}
+
+Status ReadGraphProto(ProtoStreamReader& reader, int64_t end, const std::string& model_file_name,
+                      GraphProto& graph_proto) {
+  std::string fields;
+  uint64_t tag = 0;
+  while (reader.Position() < end && reader.ReadVarint(tag)) {
+    if (tag == kGraphInitializerTag) {
+      uint64_t length = 0;
+      ORT_RETURN_IF_ERROR(ReadLength(reader, length));
+      ORT_RETURN_IF_ERROR(ReadTensorProto(reader, reader.Position() + narrow<int64_t>(length), model_file_name,
+                                          *graph_proto.add_initializer()));
+    } else {
+      ORT_RETURN_IF_ERROR(CopyField(reader, tag, fields));
+    }
+  }
+
+  ORT_RETURN_IF_NOT(reader.Position() == end && graph_proto.MergeFromString(fields),
+                    "Protobuf parsing failed for the graph.");
+  return Status::OK();
+}
+
+// Loads a model without reading the raw data of its large initializers, which are instead set to reference the data
+// in the model file as external data. Peak memory while loading doesn't include the initializers, and their data is
+// read into its final buffer, or memory mapped on CPU, when the session state is created. This also allows loading
+// model files over the 2GB protobuf limit.
+// The nodes are parsed as usual, so the initializers of subgraphs are read.
+Status LoadModelStreaming(const PathString& file_path, ModelProto& model_proto) {
+  std::ifstream stream(file_path, std::ifstream::in | std::ifstream::binary);
+  if (!stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Load model ", ToUTF8String(file_path),
+                           " failed. File doesn't exist");
+  }
+
+  const std::string model_file_name = ToUTF8String(std::filesystem::path(file_path).filename().native());
+  ProtoStreamReader reader(stream);
+  std::string fields;
+  uint64_t tag = 0;
+  while (reader.ReadVarint(tag)) {
+    if (tag == kModelGraphTag) {
+      uint64_t length = 0;
+      ORT_RETURN_IF_ERROR(ReadLength(reader, length));
+      ORT_RETURN_IF_ERROR(ReadGraphProto(reader, reader.Position() + narrow<int64_t>(length), model_file_name,
+                                         *model_proto.mutable_graph()));
+    } else {
+      ORT_RETURN_IF_ERROR(CopyField(reader, tag, fields));
+    }
+  }
+
+  ORT_RETURN_IF_NOT(stream.eof() && model_proto.MergeFromString(fields), "Protobuf parsing failed.");
+  return Status::OK();
+}
+
+}  // namespace
+
 template <typename T, typename Loader>
 static Status LoadModelHelper(const T& file_path, Loader loader) {
   int fd;
@@ -535,6 +729,12 @@ template <typename T>
 static Status LoadModel(const T& file_path, std::shared_ptr<Model>& p_model,
                         const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                         const logging::Logger& logger, const ModelOptions& options) {
+  if (options.stream_initializers) {
+    ModelProto model_proto;
+    ORT_RETURN_IF_ERROR(LoadModelStreaming(ToPathString(file_path), model_proto));
+    return Model::Load(std::move(model_proto), ToPathString(file_path), p_model, local_registries, logger, options);
+  }
+
   const auto loader = [&file_path, &p_model, local_registries, &logger, &options](int fd) {
     return Model::Load(fd, ToPathString(file_path), p_model, local_registries, logger, options);
   };
@@ -36,6 +36,10 @@ struct ModelOptions {
   // be returned.
   bool strict_shape_type_inference;
 
+  // If true, a model loaded from a file references the raw data of its large initializers in the file as external
+  // data instead of reading it, so that the data is only read when the session state is created.
+  bool stream_initializers{false};
+
   ModelOptions(bool allow_released_opsets_only, bool strict_shape_type_inference)
       : allow_released_opsets_only(allow_released_opsets_only),
         strict_shape_type_inference(strict_shape_type_inference) {}
@@ -94,6 +94,14 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Define the availability of the bfloat16 precision GEMM (SBGEMM) routines.
+//
+
+#if (defined(__aarch64__) && defined(__linux__)) || defined(MLAS_TARGET_AMD64)
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -696,6 +704,129 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Single precision GEMM kernels specialized to the shape of a constant matrix
+// B. The kernel of a shape selects the column blocks and the row unrolling of
+// the compute loops once, instead of at every call, and is cached for the
+// lifetime of the process.
+//
+
+struct MLAS_SGEMM_SPECIALIZED_KERNEL;
+
+/**
+ * @brief  Returns the kernel specialized to the shape of matrix B, or nullptr
+ *         if the shape is too large to benefit and the general path of
+ *         MlasGemmBatch should be used.
+ *
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ */
+const MLAS_SGEMM_SPECIALIZED_KERNEL*
+MLASCALL
+MlasSgemmGetSpecializedKernel(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief  Batched SGEMM using a kernel from MlasSgemmGetSpecializedKernel.
+ *         Matrix A is not transposed and matrix B is not packed.
+ *
+ * @param Kernel     Supplies the kernel specialized to the shape of matrix B.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSgemmSpecializedBatch(
+    const MLAS_SGEMM_SPECIALIZED_KERNEL* Kernel,
+    size_t M,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision GEMM with a constant block sparse matrix B, such as the
+// weights of a block pruned model. The nonzero blocks of 1 row by 4 columns
+// of matrix B are packed, so the zero blocks are skipped instead of
+// multiplied.
+//
+
+/**
+ * @brief  Returns the size of the packed buffer of a block sparse matrix B,
+ *         or zero if matrix B has too many nonzero blocks for the sparse path
+ *         to be faster than the packed path of MlasGemmBatch.
+ *
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param N          Supplies the number of columns of matrix B.
+ * @param K          Supplies the number of rows of matrix B.
+ * @param B          Supplies the address of matrix B.
+ * @param ldb        Supplies the first dimension of matrix B.
+ */
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief  Packs the nonzero blocks of matrix B to a buffer with the size
+ *         returned by MlasSparseGemmPackBSize.
+ *
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param N          Supplies the number of columns of matrix B.
+ * @param K          Supplies the number of rows of matrix B.
+ * @param B          Supplies the address of matrix B.
+ * @param ldb        Supplies the first dimension of matrix B.
+ * @param PackedB    Supplies the address of packed matrix B.
+ */
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief  Batched SGEMM with a block sparse matrix B packed by
+ *         MlasSparseGemmPackB. Matrix A is not transposed and the B member of
+ *         the data parameters is the address of packed matrix B.
+ *
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSparseGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -754,6 +885,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -786,7 +918,13 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileCount;
+            size_t TileBlockSize;
+        } Winograd;
     } u;
+    size_t FilterBitWidth;
+    size_t FilterBlkLen;
 };
 
 void MLASCALL
@@ -805,7 +943,80 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                bool AllowWinograd = false,
+                size_t FilterBitWidth = 0,
+                size_t FilterBlkLen = 0);
+
+//
+// Replaces the algorithm selected by MlasConvPrepare, so that callers can time
+// the candidates on the target machine. Only MlasConvAlgorithmExpandThenGemm
+// and MlasConvAlgorithmExpandThenGemmSegmented can be selected. Returns false
+// if the algorithm is not supported for the convolution.
+//
+
+bool
+MLASCALL
+MlasConvOverrideAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    MLAS_THREADPOOL* ThreadPool,
+    size_t* WorkingBufferSize
+    );
+
+//
+// The Winograd algorithm requires the filter of MlasConv to be transformed by
+// MlasConvWinogradTransformFilter. MlasConvPrepare only selects the algorithm
+// if AllowWinograd is true.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    );
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
+//
+// The filter of MlasConv may be quantized to 4 or 8 bits with one scale per
+// block of FilterBlkLen elements along K by MlasConvQuantizeFilter. The filter
+// is dequantized a block of rows at a time inside the GEMM loop, so only the
+// activations stay in float. MlasConvPrepare then always selects
+// MlasConvAlgorithmExpandThenGemmSegmented. The returned size is in bytes.
+//
+
+size_t
+MLASCALL
+MlasConvQuantizedFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t K,
+    size_t BitWidth,
+    size_t BlkLen
+    );
+
+void
+MLASCALL
+MlasConvQuantizeFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t K,
+    size_t BitWidth,
+    size_t BlkLen,
+    const float* Filter,
+    void* QuantizedFilter
+    );
 
 void
 MLASCALL
@@ -989,6 +1200,16 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeCumulativeSum(
+    const float* Input,
+    float* Output,
+    size_t N,
+    bool Exclusive,
+    bool Reverse
+    );
+
 void
 MLASCALL
 MlasComputeExp(
@@ -1016,6 +1237,23 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Computes the softmax or log softmax function over the middle dimension of a
+// [N, D, Stride] buffer, in place updates are supported.
+//
+
+void
+MLASCALL
+MlasComputeSoftmaxStrided(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t Stride,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -1086,6 +1324,35 @@ MlasTranspose(
     size_t N
     );
 
+/**
+ * @brief  Transposes a tensor by an arbitrary permutation of its axes, using
+ *         cache blocked vector transposes of tiles and multiple threads.
+ *
+ * @param Input         Supplies the input buffer.
+ * @param Output        Supplies the output buffer.
+ * @param ElementSize   Supplies the size in bytes of an element.
+ * @param Rank          Supplies the number of axes of the tensor.
+ * @param InputShape    Supplies the dimensions of the input tensor.
+ * @param Permutation   Supplies the input axis of each output axis.
+ * @param ThreadPool    Supplies the thread pool object to use, else nullptr if
+ *                      the base library threading support should be used.
+ *
+ * @return  true if the tensor was transposed, else false if the element size
+ *          isn't 1, 2, 4 or 8 bytes or the permutation has too many axes, in
+ *          which case the caller should use a generic transpose.
+ */
+bool
+MLASCALL
+MlasTransposeTensor(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1242,6 +1509,39 @@ MlasQuantizeLinearS4(
     int8_t ZeroPoint
     );
 
+/**
+ * @brief Dequantizes a tensor viewed as [M, K, N], where K is the quantized
+ *        axis: Output = (Input - ZeroPoint) * Scale
+ *
+ * @param Input         M x K x N quantized values
+ * @param Output        M x K x N dequantized values
+ * @param M             Total size of the dimensions before the quantized axis
+ * @param K             Size of the quantized axis
+ * @param N             Total size of the dimensions after the quantized axis
+ * @param BlockSize     Zero for per-tensor (K = 1) or per-axis quantization,
+ *                      where Scale and ZeroPoint have K elements. Otherwise
+ *                      the size of the blocks along the quantized axis, where
+ *                      Scale and ZeroPoint have M x ceil(K / BlockSize) x N
+ *                      elements.
+ * @param Scale         Quantization scales
+ * @param ZeroPoint     Optional quantization zero points
+ * @param ThreadPool    Thread pool to use, else nullptr
+ */
+template<typename InputType>
+void
+MLASCALL
+MlasDequantizeLinear(
+    const InputType* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const InputType* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief Requantize a block of the intermediate buffer to the output buffer,
  *        optionally adding the supplied bias
@@ -1432,6 +1732,14 @@ constexpr size_t FP16_SIZE = sizeof(uint16_t);
 bool MLASCALL
 MlasFp16AccelerationSupported();
 
+/**
+ * @brief Whether current CPU has a vectorized half precision GEMM kernel,
+ *        i.e. MlasHalfGemmBatch does not fall back to the reference C++
+ *        implementation.
+*/
+bool MLASCALL
+MlasHalfGemmAccelerationSupported();
+
 /**
  * @brief Interface for half gemm post processors.
  *
@@ -1634,7 +1942,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1845,13 +2153,22 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+    int kv_num_heads = 0;                 /**< number of heads of K and V, 0 if the same as num_heads */
+    bool is_causal = false;               /**< mask the keys past kv_sequence_length - q_sequence_length + row */
+    const MLAS_FP16* query_fp16 = nullptr;  /**< fp16 query, used instead of query when set */
+    const MLAS_FP16* key_fp16 = nullptr;    /**< fp16 key, set together with query_fp16 */
+    const MLAS_FP16* value_fp16 = nullptr;  /**< fp16 value, set together with query_fp16 */
 };
 
 /**
- * @brief Per-thread worker function for fp32 Flash Attention
- * @param thread_id    Thread index
+ * @brief Flash Attention with fp32 accumulation.
+ *        Q is BxNxSxH, K and V are BxN_kvxLxH and the output is BxSxNxH.
+ *        With grouped query attention, query heads [g * N / N_kv, (g + 1) * N / N_kv)
+ *        share the key and value head g. A causal mask requires L >= S; the blocks
+ *        of K and V that are masked out for a block of Q are skipped.
  * @param args         Arguments
- * @return
+ * @param ThreadPool   Thread pool, the blocks of Q are distributed dynamically
+ *                     across args->thread_count threads
 */
 void
 MLASCALL
@@ -1859,3 +2176,203 @@ MlasFlashAttention(
     MlasFlashAttentionThreadedArgs* args,
     MLAS_THREADPOOL* ThreadPool
 );
+
+/**
+ * @brief Returns the size of the scratch buffer needed by each thread of
+ *        MlasFlashAttention, given the block sizes and the input type of args.
+*/
+size_t
+MLASCALL
+MlasFlashAttentionGetBufferSizePerThread(
+    const MlasFlashAttentionThreadedArgs* args
+);
+
+//
+// Attention routines for int8 quantized key/value caches. Each row of the
+// cache holds the head_size elements of one token of one head, quantized
+// symmetrically with one fp32 scale per row.
+//
+
+/**
+ * @brief Quantizes rows of fp32 keys or values into an int8 cache.
+ * @param Input      RowCount x HeadSize fp32 values
+ * @param Output     RowCount x HeadSize int8 values
+ * @param Scales     RowCount scales, Input[r][h] ~= Output[r][h] * Scales[r]
+ * @param RowCount   Number of rows (tokens)
+ * @param HeadSize   Number of elements of each row
+ */
+void
+MLASCALL
+MlasQuantizeKvCacheInt8(
+    const float* Input,
+    int8_t* Output,
+    float* Scales,
+    size_t RowCount,
+    size_t HeadSize
+);
+
+/**
+ * @brief Computes Scores = alpha * Q * K^T from an int8 quantized key cache.
+ * @param Query          M x HeadSize fp32 query rows
+ * @param M              Number of query rows
+ * @param Key            N x HeadSize int8 key rows
+ * @param KeyScales      N scales of the key rows
+ * @param N              Number of key rows
+ * @param HeadSize       Number of elements of each row
+ * @param alpha          Scale applied to the dot products
+ * @param Scores         M x N output
+ * @param ldScores       Leading dimension of Scores
+ */
+void
+MLASCALL
+MlasAttentionQKInt8Kv(
+    const float* Query,
+    size_t M,
+    const int8_t* Key,
+    const float* KeyScales,
+    size_t N,
+    size_t HeadSize,
+    float alpha,
+    float* Scores,
+    size_t ldScores
+);
+
+/**
+ * @brief Computes Output = Probs * V from an int8 quantized value cache.
+ * @param Probs          M x N attention probabilities
+ * @param ldProbs        Leading dimension of Probs
+ * @param M              Number of query rows
+ * @param Value          N x HeadSize int8 value rows
+ * @param ValueScales    N scales of the value rows
+ * @param N              Number of value rows
+ * @param HeadSize       Number of elements of each row
+ * @param Output         M x HeadSize output
+ * @param ldOutput       Leading dimension of Output
+ */
+void
+MLASCALL
+MlasAttentionPVInt8Kv(
+    const float* Probs,
+    size_t ldProbs,
+    size_t M,
+    const int8_t* Value,
+    const float* ValueScales,
+    size_t N,
+    size_t HeadSize,
+    float* Output,
+    size_t ldOutput
+);
+
+//
+// Layer normalization routines. Each call normalizes one row of N elements,
+// accumulating its statistics in a single pass.
+//
+
+/**
+ * @brief Computes the layer normalization of a row:
+ *           X = Input + Skip + Bias
+ *           Output = (X - Mean(X)) * InverseStdDev(X) * Gamma + Beta
+ *        The simplified (RMS) normalization doesn't subtract the mean and
+ *        ignores Beta:
+ *           Output = X / sqrt(Mean(X^2) + Epsilon) * Gamma
+ * @param Input          N input values
+ * @param Skip           Optional N values added to the input
+ * @param Bias           Optional N values added to the input
+ * @param Gamma          N scale values
+ * @param Beta           Optional N shift values
+ * @param Output         N output values, may be the same buffer as Input
+ * @param SkipOutput     Optional N values receiving Input + Skip + Bias
+ * @param N              Number of elements of the row
+ * @param Epsilon        Value added to the variance
+ * @param Simplified     Whether to compute the simplified (RMS) normalization
+ * @param Mean           Optional address receiving the mean of the row, zero if Simplified
+ * @param InverseStdDev  Optional address receiving the inverse standard deviation of the row
+ */
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InverseStdDev
+);
+
+/**
+ * @brief Half precision version of MlasLayerNormalization. The row is
+ *        normalized in fp32 and the statistics are returned in fp32.
+ */
+void
+MLASCALL
+MlasLayerNormalizationFp16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const MLAS_FP16* Bias,
+    const MLAS_FP16* Gamma,
+    const MLAS_FP16* Beta,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InverseStdDev
+);
+
+//
+// Reduction routines. The input is viewed as [OuterCount, ReduceCount,
+// InnerCount] and reduced along the middle axis to [OuterCount, InnerCount],
+// which covers reducing the inner, outer and strided axes of a tensor.
+//
+
+enum MLAS_REDUCE_KIND {
+    MlasReduceSum,
+    MlasReduceMinimum,
+    MlasReduceMaximum,
+};
+
+/**
+ * @brief Reduces the middle axis of a tensor. An empty reduced axis produces
+ *        the identity of the reduction: 0, +inf or -inf.
+ * @param Kind         Reduction to compute
+ * @param Input        OuterCount x ReduceCount x InnerCount input values
+ * @param Output       OuterCount x InnerCount output values
+ * @param OuterCount   Number of elements of the outer axes
+ * @param ReduceCount  Number of elements of the reduced axis
+ * @param InnerCount   Number of elements of the inner axes, 1 if the reduced axis is contiguous
+ * @param ThreadPool   Thread pool to use, else nullptr
+ */
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCE_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+);
+
+/**
+ * @brief Half precision version of MlasReduce. The reduction is accumulated
+ *        in fp32.
+ */
+void
+MLASCALL
+MlasReduceFp16(
+    MLAS_REDUCE_KIND Kind,
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+);
@@ -58,6 +58,58 @@ struct MLAS_SQNBIT_GEMM_DATA_PARAMS {
     MLAS_GEMM_POSTPROCESSOR<float>* PostProcessor = nullptr;
 };
 
+/**
+ * @brief Define activations of the float/n-bit quantized int GEMM epilogue.
+ */
+typedef enum {
+    MlasSQNBitGemmEpilogueIdentity = 0, /*!< no activation */
+    MlasSQNBitGemmEpilogueGelu,         /*!< x * 0.5 * (1 + erf(x / sqrt(2))) */
+    MlasSQNBitGemmEpilogueFastGelu,     /*!< x * 0.5 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))) */
+    MlasSQNBitGemmEpilogueSilu,         /*!< x * sigmoid(x) */
+} MLAS_SQNBIT_GEMM_EPILOGUE_ACTIVATION;
+
+/**
+ * @brief Post processor that fuses the elementwise operations following a float/n-bit quantized int GEMM:
+ *        C = Activation(C) * Multiplier + Residual
+ *        The bias of MLAS_SQNBIT_GEMM_DATA_PARAMS is added before the activation. Multiplier (e.g., the up
+ *        projection of a SwiGLU block) and Residual are optional matrices with the same shape as C, so each
+ *        element of C is written once while it is still in the cache.
+ */
+class MLAS_SQNBIT_GEMM_EPILOGUE_PROCESSOR : public MLAS_GEMM_POSTPROCESSOR<float>
+{
+   public:
+    MLAS_SQNBIT_GEMM_EPILOGUE_PROCESSOR(
+        MLAS_SQNBIT_GEMM_EPILOGUE_ACTIVATION Activation,
+        const float* Multiplier = nullptr,
+        size_t ldMultiplier = 0,
+        const float* Residual = nullptr,
+        size_t ldResidual = 0
+    )
+        : Activation_(Activation),
+          Multiplier_(Multiplier),
+          ldMultiplier_(ldMultiplier),
+          Residual_(Residual),
+          ldResidual_(ldResidual)
+    {
+    }
+
+    void Process(
+        float* C,
+        size_t RangeStartM,
+        size_t RangeStartN,
+        size_t RangeCountM,
+        size_t RangeCountN,
+        size_t ldc
+    ) const override;
+
+   private:
+    MLAS_SQNBIT_GEMM_EPILOGUE_ACTIVATION Activation_;
+    const float* Multiplier_;
+    size_t ldMultiplier_;
+    const float* Residual_;
+    size_t ldResidual_;
+};
+
 /**
  * @brief Batched GEMM:  C = A * B + Bias
  *        A must be a float32 matrix
@@ -77,6 +77,29 @@ struct MLAS_SOFTMAX_WORK_BLOCK {
     size_t D;
 };
 
+//
+// Define the parameters to execute segments of a strided softmax operation on
+// worker threads.
+//
+
+struct MLAS_SOFTMAX_STRIDED_WORK_BLOCK {
+    ptrdiff_t ThreadCount;
+    bool LogSoftmax;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    size_t Stride;
+    size_t BlockCountStride;
+};
+
+//
+// Define the number of columns of a strided softmax operation that are reduced
+// together. The running maximum and sum of each column stay in the L1 cache.
+//
+
+constexpr size_t MlasSoftmaxStridedBlockSize = 64;
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasComputeExpVector(
@@ -275,7 +298,7 @@ Return Value:
 
 --*/
 {
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
     GetMlasPlatform().ComputeExpF32Kernel(Input, Output, N);
 #else
     MlasComputeExpF32Kernel(Input, Output, N);
@@ -872,7 +895,7 @@ Return Value:
         // Find the maximum value for the row.
         //
 
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
         float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Input, D);
 #else
         float Maximum = MlasReduceMaximumF32Kernel(Input, D);
@@ -885,7 +908,7 @@ Return Value:
             // Compute the sum of the exponential functions for the row.
             //
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
             float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
 #else
             float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
@@ -910,7 +933,7 @@ Return Value:
             // compute the sum of these exponential functions.
             //
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
             float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
 #else
             float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
@@ -922,7 +945,7 @@ Return Value:
 
             float Parameters[] = { 1.0f / Accumulation };
 
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
             GetMlasPlatform().ComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
 #else
             MlasComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
@@ -1012,3 +1035,439 @@ Return Value:
 
     MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
 }
+
+void
+MlasComputeSoftmaxStridedBlock(
+    const float* Input,
+    float* Output,
+    size_t D,
+    size_t Stride,
+    size_t CountColumns,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for a block of
+    columns of a strided softmax operation.
+
+Arguments:
+
+    Input - Supplies the input buffer, addressing the first column of the block
+        in the first row.
+
+    Output - Supplies the output buffer, addressing the first column of the
+        block in the first row.
+
+    D - Supplies the number of rows to reduce.
+
+    Stride - Supplies the distance in elements between two rows.
+
+    CountColumns - Supplies the number of columns of the block, up to
+        MlasSoftmaxStridedBlockSize.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float NegativeMaximum[MlasSoftmaxStridedBlockSize], 16);
+    MLAS_DECLSPEC_ALIGN(float Accumulation[MlasSoftmaxStridedBlockSize], 16);
+
+    const size_t CountVector = CountColumns & ~size_t(3);
+
+    //
+    // Find the maximum value of every column.
+    //
+
+    std::copy_n(Input, CountColumns, NegativeMaximum);
+
+    for (size_t d = 1; d < D; d++) {
+
+        const float* Row = Input + d * Stride;
+        size_t c = 0;
+
+        for (; c < CountVector; c += 4) {
+            MLAS_FLOAT32X4 Vector = MlasMaximumFloat32x4(MlasLoadFloat32x4(NegativeMaximum + c), MlasLoadFloat32x4(Row + c));
+            MlasStoreFloat32x4(NegativeMaximum + c, Vector);
+        }
+
+        for (; c < CountColumns; c++) {
+            NegativeMaximum[c] = std::max(NegativeMaximum[c], Row[c]);
+        }
+    }
+
+    for (size_t c = 0; c < CountColumns; c++) {
+        NegativeMaximum[c] = -NegativeMaximum[c];
+        Accumulation[c] = 0.0f;
+    }
+
+    //
+    // Compute the sum of the exponential functions of every column. The
+    // softmax operation stores the exponential functions to the output.
+    //
+
+    for (size_t d = 0; d < D; d++) {
+
+        const float* Row = Input + d * Stride;
+        float* OutputRow = Output + d * Stride;
+        size_t c = 0;
+
+        for (; c < CountVector; c += 4) {
+            MLAS_FLOAT32X4 Vector = MlasComputeSumExpVector(MlasLoadFloat32x4(Row + c), MlasLoadFloat32x4(NegativeMaximum + c));
+            MlasStoreFloat32x4(Accumulation + c, MlasAddFloat32x4(MlasLoadFloat32x4(Accumulation + c), Vector));
+
+            if (!LogSoftmax) {
+                MlasStoreFloat32x4(OutputRow + c, Vector);
+            }
+        }
+
+        for (; c < CountColumns; c++) {
+            float Value = std::exp(Row[c] + NegativeMaximum[c]);
+            Accumulation[c] += Value;
+
+            if (!LogSoftmax) {
+                OutputRow[c] = Value;
+            }
+        }
+    }
+
+    //
+    // Normalize the output. The softmax operation scales the exponential
+    // functions by the reciprocal of the sum, the log softmax operation
+    // subtracts the logarithm of the sum from the shifted input.
+    //
+
+    for (size_t c = 0; c < CountColumns; c++) {
+        if (LogSoftmax) {
+            NegativeMaximum[c] -= std::log(Accumulation[c]);
+        } else {
+            Accumulation[c] = 1.0f / Accumulation[c];
+        }
+    }
+
+    const float* Parameters = LogSoftmax ? NegativeMaximum : Accumulation;
+
+    for (size_t d = 0; d < D; d++) {
+
+        const float* Row = LogSoftmax ? Input + d * Stride : Output + d * Stride;
+        float* OutputRow = Output + d * Stride;
+        size_t c = 0;
+
+        for (; c < CountVector; c += 4) {
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Row + c);
+            MLAS_FLOAT32X4 ParameterVector = MlasLoadFloat32x4(Parameters + c);
+            Vector = LogSoftmax ? MlasAddFloat32x4(Vector, ParameterVector) : MlasMultiplyFloat32x4(Vector, ParameterVector);
+            MlasStoreFloat32x4(OutputRow + c, Vector);
+        }
+
+        for (; c < CountColumns; c++) {
+            OutputRow[c] = LogSoftmax ? Row[c] + Parameters[c] : Row[c] * Parameters[c];
+        }
+    }
+}
+
+void
+MlasComputeSoftmaxStridedThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    strided softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_STRIDED_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the blocks of columns of every outer row.
+    //
+
+    const size_t BlockCountStride = WorkBlock->BlockCountStride;
+
+    size_t Block;
+    size_t CountBlocks;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->N * BlockCountStride, &Block, &CountBlocks);
+
+    const size_t D = WorkBlock->D;
+    const size_t Stride = WorkBlock->Stride;
+
+    while (CountBlocks > 0) {
+
+        const size_t n = Block / BlockCountStride;
+        const size_t Column = (Block % BlockCountStride) * MlasSoftmaxStridedBlockSize;
+        const size_t CountColumns = std::min(MlasSoftmaxStridedBlockSize, Stride - Column);
+        const size_t Offset = n * D * Stride + Column;
+
+        MlasComputeSoftmaxStridedBlock(WorkBlock->Input + Offset, WorkBlock->Output + Offset, D, Stride,
+                                       CountColumns, WorkBlock->LogSoftmax);
+
+        Block++;
+        CountBlocks--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxStrided(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t Stride,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function over the middle
+    dimension of a [N, D, Stride] buffer, which avoids transposing the reduced
+    axis to the innermost dimension. The D elements of every reduction are
+    Stride elements apart and the columns are reduced together with vector
+    operations.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of outer rows to process.
+
+    D - Supplies the number of elements of the reduced dimension.
+
+    Stride - Supplies the number of elements of the inner dimensions.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Stride == 1) {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, ThreadPool);
+        return;
+    }
+
+    MLAS_SOFTMAX_STRIDED_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the softmax parameters to the work block.
+    //
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Stride = Stride;
+    WorkBlock.BlockCountStride = (Stride + MlasSoftmaxStridedBlockSize - 1) / MlasSoftmaxStridedBlockSize;
+
+    //
+    // Compute the number of target threads given the complexity of the softmax
+    // operation. Limit the number of threads to the number of column blocks and
+    // try to keep each thread processing a minimum number of elements before
+    // using another thread.
+    //
+
+    const size_t TotalBlocks = N * WorkBlock.BlockCountStride;
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalBlocks) {
+        ThreadCount = ptrdiff_t(TotalBlocks);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D * Stride) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxStridedThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+
+template<unsigned Lanes>
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasShiftUpFloat32x4(MLAS_FLOAT32X4 Vector)
+/*++
+
+Routine Description:
+
+    This routine moves every element to the lane Lanes above, the lowest lanes
+    are zero.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(Vector), Lanes * sizeof(float)));
+#else
+    return vextq_f32(vdupq_n_f32(0.0f), Vector, 4 - Lanes);
+#endif
+}
+
+template<unsigned Lanes>
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasShiftDownFloat32x4(MLAS_FLOAT32X4 Vector)
+/*++
+
+Routine Description:
+
+    This routine moves every element to the lane Lanes below, the highest
+    lanes are zero.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(Vector), Lanes * sizeof(float)));
+#else
+    return vextq_f32(Vector, vdupq_n_f32(0.0f), Lanes);
+#endif
+}
+
+#endif
+
+void
+MLASCALL
+MlasComputeCumulativeSum(
+    const float* Input,
+    float* Output,
+    size_t N,
+    bool Exclusive,
+    bool Reverse
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the cumulative sum of a row of elements. The sums of
+    every four elements are computed in registers with two shift and add steps
+    and the running sum is carried from vector to vector.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Exclusive - Supplies true if an element is excluded from its sum, else
+        false.
+
+    Reverse - Supplies true if the sums are accumulated from the last element
+        to the first one, else false.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Carry = 0.0f;
+
+    if (!Reverse) {
+
+        size_t i = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+        MLAS_FLOAT32X4 CarryVector = MlasZeroFloat32x4();
+
+        for (; i + 4 <= N; i += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + i);
+            Vector = MlasAddFloat32x4(Vector, MlasShiftUpFloat32x4<1>(Vector));
+            Vector = MlasAddFloat32x4(Vector, MlasShiftUpFloat32x4<2>(Vector));
+
+            MLAS_FLOAT32X4 Sum = Exclusive ? MlasShiftUpFloat32x4<1>(Vector) : Vector;
+            MlasStoreFloat32x4(Output + i, MlasAddFloat32x4(Sum, CarryVector));
+
+            CarryVector = MlasAddFloat32x4(CarryVector, MlasBroadcastFloat32x4(MlasExtractLaneFloat32x4<3>(Vector)));
+        }
+
+        Carry = MlasExtractLaneFloat32x4<0>(CarryVector);
+#endif
+
+        for (; i < N; i++) {
+            float Value = Input[i];
+            Output[i] = Exclusive ? Carry : Carry + Value;
+            Carry += Value;
+        }
+
+    } else {
+
+        size_t i = N;
+
+        //
+        // The last elements that do not fill a vector are accumulated first.
+        //
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+        const size_t VectorEnd = N & ~size_t(3);
+#else
+        const size_t VectorEnd = 0;
+#endif
+
+        for (; i > VectorEnd; i--) {
+            float Value = Input[i - 1];
+            Output[i - 1] = Exclusive ? Carry : Carry + Value;
+            Carry += Value;
+        }
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+        MLAS_FLOAT32X4 CarryVector = MlasBroadcastFloat32x4(Carry);
+
+        for (; i >= 4; i -= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + i - 4);
+            Vector = MlasAddFloat32x4(Vector, MlasShiftDownFloat32x4<1>(Vector));
+            Vector = MlasAddFloat32x4(Vector, MlasShiftDownFloat32x4<2>(Vector));
+
+            MLAS_FLOAT32X4 Sum = Exclusive ? MlasShiftDownFloat32x4<1>(Vector) : Vector;
+            MlasStoreFloat32x4(Output + i - 4, MlasAddFloat32x4(Sum, CarryVector));
+
+            CarryVector = MlasAddFloat32x4(CarryVector, MlasBroadcastFloat32x4(MlasExtractLaneFloat32x4<0>(Vector)));
+        }
+#endif
+    }
+}
@@ -481,6 +481,321 @@ Return Value:
     }
 }
 
+//
+// Define the number of elements of the buffer used to dequantize a block of
+// rows of a quantized filter.
+//
+
+#define MLAS_CONV_QUANTIZED_FILTER_BUFFER_SIZE  8192
+
+MLAS_FORCEINLINE
+size_t
+MlasConvQuantizedFilterRowSize(
+    size_t K,
+    size_t BitWidth,
+    size_t BlkLen
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of bytes of a row of a quantized filter.
+    The row is stored as the float scales of each block followed by the
+    quantized values, padded to a multiple of the size of a float so that
+    each row and group starts aligned to a float.
+
+Arguments:
+
+    K - Supplies the number of elements of a row of the filter.
+
+    BitWidth - Supplies the number of bits of the quantized values.
+
+    BlkLen - Supplies the number of elements that share a scale.
+
+Return Value:
+
+    Returns the number of bytes of a row.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t DataBytes = (BlockCountK * BlkLen * BitWidth / 8 + sizeof(float) - 1) & ~(sizeof(float) - 1);
+
+    return BlockCountK * sizeof(float) + DataBytes;
+}
+
+size_t
+MLASCALL
+MlasConvQuantizedFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t K,
+    size_t BitWidth,
+    size_t BlkLen
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of bytes of the filter of a convolution
+    quantized by MlasConvQuantizeFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    K - Supplies the number of elements of each filter, which is the number of
+        input channels per group times the kernel size.
+
+    BitWidth - Supplies the number of bits of the quantized values (4 or 8).
+
+    BlkLen - Supplies the number of elements along K that share a scale.
+
+Return Value:
+
+    Returns the number of bytes of the quantized filter.
+
+--*/
+{
+    return GroupCount * FilterCount * MlasConvQuantizedFilterRowSize(K, BitWidth, BlkLen);
+}
+
+void
+MLASCALL
+MlasConvQuantizeFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t K,
+    size_t BitWidth,
+    size_t BlkLen,
+    const float* Filter,
+    void* QuantizedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes the filter of a convolution with symmetric blocks
+    of BlkLen elements along K. The values of the 4-bit filter are stored as
+    unsigned nibbles offset by 8.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    K - Supplies the number of elements of each filter.
+
+    BitWidth - Supplies the number of bits of the quantized values (4 or 8).
+
+    BlkLen - Supplies the number of elements along K that share a scale.
+
+    Filter - Supplies the filter tensor.
+
+    QuantizedFilter - Supplies the buffer sized to the number of bytes
+        returned by MlasConvQuantizedFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if ((BitWidth != 4 && BitWidth != 8) || BlkLen == 0) {
+        MLAS_THROW_EX(std::invalid_argument, "unsupported filter quantization");
+    }
+
+    const size_t RowSize = MlasConvQuantizedFilterRowSize(K, BitWidth, BlkLen);
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const float QuantizedMaximum = (BitWidth == 4) ? 7.0f : 127.0f;
+
+    uint8_t* Row = static_cast<uint8_t*>(QuantizedFilter);
+
+    std::fill_n(Row, GroupCount * FilterCount * RowSize, uint8_t(0));
+
+    for (size_t f = 0; f < GroupCount * FilterCount; f++) {
+
+        float* Scales = reinterpret_cast<float*>(Row);
+        uint8_t* Data = Row + BlockCountK * sizeof(float);
+
+        for (size_t b = 0; b < BlockCountK; b++) {
+
+            const size_t StartK = b * BlkLen;
+            const size_t CountK = std::min(BlkLen, K - StartK);
+
+            float Maximum = 0.0f;
+
+            for (size_t k = 0; k < CountK; k++) {
+                Maximum = std::max(Maximum, std::fabs(Filter[StartK + k]));
+            }
+
+            const float Scale = Maximum / QuantizedMaximum;
+            const float InverseScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+
+            Scales[b] = Scale;
+
+            for (size_t k = 0; k < CountK; k++) {
+
+                float q = std::nearbyint(Filter[StartK + k] * InverseScale);
+                q = std::min(std::max(q, -QuantizedMaximum), QuantizedMaximum);
+
+                const size_t Index = StartK + k;
+
+                if (BitWidth == 8) {
+                    Data[Index] = uint8_t(int8_t(q));
+                } else {
+                    Data[Index / 2] |= uint8_t((int32_t(q) + 8) << ((Index & 1) * 4));
+                }
+            }
+        }
+
+        Filter += K;
+        Row += RowSize;
+    }
+}
+
+void
+MlasConvDequantizeFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const uint8_t* QuantizedFilter,
+    size_t RowCount,
+    size_t k,
+    size_t CountK,
+    float* Buffer
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a block of rows and columns of a quantized filter.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    QuantizedFilter - Supplies the first row of the quantized filter.
+
+    RowCount - Supplies the number of rows to dequantize.
+
+    k - Supplies the K to begin dequantizing.
+
+    CountK - Supplies the count of K to dequantize.
+
+    Buffer - Supplies the buffer that receives RowCount by CountK elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t K = Parameters->K;
+    const size_t BitWidth = Parameters->FilterBitWidth;
+    const size_t BlkLen = Parameters->FilterBlkLen;
+    const size_t RowSize = MlasConvQuantizedFilterRowSize(K, BitWidth, BlkLen);
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        const float* Scales = reinterpret_cast<const float*>(QuantizedFilter);
+        const uint8_t* Data = QuantizedFilter + BlockCountK * sizeof(float);
+
+        size_t Index = k;
+
+        while (Index < k + CountK) {
+
+            const size_t BlockEnd = std::min((Index / BlkLen + 1) * BlkLen, k + CountK);
+            const float Scale = Scales[Index / BlkLen];
+
+            if (BitWidth == 8) {
+                for (; Index < BlockEnd; Index++) {
+                    *Buffer++ = float(int8_t(Data[Index])) * Scale;
+                }
+            } else {
+                for (; Index < BlockEnd; Index++) {
+                    const int32_t q = int32_t((Data[Index / 2] >> ((Index & 1) * 4)) & 0x0F) - 8;
+                    *Buffer++ = float(q) * Scale;
+                }
+            }
+        }
+
+        QuantizedFilter += RowSize;
+    }
+}
+
+void
+MlasConvQuantizedFilterGemm(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    size_t k,
+    size_t CountK,
+    const float* ColumnBuffer,
+    size_t CountN,
+    float beta,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of a quantized filter with a slice of the
+    expanded input. The filter is dequantized a block of rows at a time into a
+    stack buffer that stays in the cache while the block is multiplied.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the quantized filter of the group.
+
+    k - Supplies the K to begin the slice.
+
+    CountK - Supplies the count of K of the slice.
+
+    ColumnBuffer - Supplies the expanded input of CountK by CountN elements.
+
+    CountN - Supplies the count of N of the slice.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    Output - Supplies the output slice.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float FilterBuffer[MLAS_CONV_QUANTIZED_FILTER_BUFFER_SIZE], 64);
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t RowSize = MlasConvQuantizedFilterRowSize(Parameters->K, Parameters->FilterBitWidth,
+        Parameters->FilterBlkLen);
+    const size_t StrideM = std::max(size_t(1), MLAS_CONV_QUANTIZED_FILTER_BUFFER_SIZE / CountK);
+
+    const uint8_t* QuantizedFilter = reinterpret_cast<const uint8_t*>(Filter);
+
+    size_t CountM;
+
+    for (size_t m = 0; m < FilterCount; m += CountM) {
+
+        CountM = std::min(FilterCount - m, StrideM);
+
+        MlasConvDequantizeFilter(Parameters, QuantizedFilter + m * RowSize, CountM, k,
+            CountK, FilterBuffer);
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, CountM, CountN, CountK, 1.0f,
+            FilterBuffer, CountK, ColumnBuffer, CountN, beta, Output + m * OutputSize,
+            OutputSize);
+    }
+}
+
 void
 MlasConvOperation(
     const MLAS_CONV_PARAMETERS* Parameters,
@@ -590,9 +905,14 @@ Return Value:
                     SegmentStartN + n, CountN);
             }
 
-            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
-                CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+            if (Parameters->FilterBitWidth != 0) {
+                MlasConvQuantizedFilterGemm(Parameters, Filter, k, CountK, ColumnBuffer,
+                    CountN, beta, SegmentOutput);
+            } else {
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
+                    CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
+                    SegmentOutput, OutputSize);
+            }
 
             beta = 1.0f;
         }
@@ -613,120 +933,594 @@ MlasConvOperationThreaded(
     )
 /*++
 
-Routine Description:
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    float* ColumnBuffer =
+        WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+
+    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
+        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
+        Segment->CountN);
+}
+
+void
+MlasConvGemmDirectThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of indices to use for this thread.
+    //
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+    const float Beta = Parameters->Beta;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, BatchGroupCount,
+        &BatchGroupStart, &BatchGroupRemaining);
+
+    size_t BatchGroupEnd = BatchGroupStart + BatchGroupRemaining;
+
+    //
+    // Iterate over the batch and groups allocated to this thread.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputGroupSize;
+        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        //
+        // Invoke the non-threaded GEMM directly with the input tensor.
+        //
+
+        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
+                           K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
+                           OutputSize);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, FilterCount,
+            OutputSize, OutputSize);
+    }
+}
+
+//
+// Winograd F(4x4, 3x3) convolution. Each 6x6 tile of the input produces a 4x4
+// tile of the output. The filters and the input tiles are transformed to the
+// 36 points of the Winograd domain, where the convolution reduces to one GEMM
+// per point over the input channels, and the products are transformed back.
+// This computes a 4x4 output tile with 36 multiplies per channel pair instead
+// of the 144 of the direct convolution.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_SIZE            4
+#define MLAS_CONV_WINOGRAD_INPUT_TILE_SIZE      6
+#define MLAS_CONV_WINOGRAD_POINT_COUNT          36
+
+//
+// Define the minimum number of input channels and filters to use the Winograd
+// algorithm.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS     16
+
+//
+// Define the number of working buffer elements per thread used to size the
+// block of tiles transformed at a time.
+//
+
+#define MLAS_CONV_WINOGRAD_BUFFER_SIZE_PER_THREAD   (1024 * 1024)
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements of the transformed filter of a
+    convolution using MlasConvAlgorithmWinograd.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter.
+
+--*/
+{
+    return GroupCount * MLAS_CONV_WINOGRAD_POINT_COUNT * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filters of a convolution to the Winograd
+    domain, U = G * g * G^T. The transformed filter of each group is stored as
+    36 matrices of FilterCount rows and InputChannels columns.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    Filter - Supplies the filter tensor in the layout of MlasConv.
+
+    TransformedFilter - Receives the transformed filter, sized to the number of
+        elements returned by MlasConvWinogradFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PointStride = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* g = Filter + (f * InputChannels + c) * 9;
+
+                //
+                // Compute G * g.
+                //
+
+                float t[6][3];
+
+                for (size_t j = 0; j < 3; j++) {
+                    const float g0 = g[0 * 3 + j];
+                    const float g1 = g[1 * 3 + j];
+                    const float g2 = g[2 * 3 + j];
+                    t[0][j] = g0 / 4.0f;
+                    t[1][j] = -(g0 + g1 + g2) / 6.0f;
+                    t[2][j] = -(g0 - g1 + g2) / 6.0f;
+                    t[3][j] = g0 / 24.0f + g1 / 12.0f + g2 / 6.0f;
+                    t[4][j] = g0 / 24.0f - g1 / 12.0f + g2 / 6.0f;
+                    t[5][j] = g2;
+                }
+
+                //
+                // Compute (G * g) * G^T.
+                //
+
+                float* u = TransformedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < 6; i++) {
+                    const float t0 = t[i][0];
+                    const float t1 = t[i][1];
+                    const float t2 = t[i][2];
+                    u[(i * 6 + 0) * PointStride] = t0 / 4.0f;
+                    u[(i * 6 + 1) * PointStride] = -(t0 + t1 + t2) / 6.0f;
+                    u[(i * 6 + 2) * PointStride] = -(t0 - t1 + t2) / 6.0f;
+                    u[(i * 6 + 3) * PointStride] = t0 / 24.0f + t1 / 12.0f + t2 / 6.0f;
+                    u[(i * 6 + 4) * PointStride] = t0 / 24.0f - t1 / 12.0f + t2 / 6.0f;
+                    u[(i * 6 + 5) * PointStride] = t2;
+                }
+            }
+        }
+
+        Filter += FilterCount * InputChannels * 9;
+        TransformedFilter += MLAS_CONV_WINOGRAD_POINT_COUNT * PointStride;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradInputTransform6(
+    const float* d,
+    size_t Stride,
+    float* v,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the 1D input transform B^T to six elements.
+
+--*/
+{
+    const float d0 = d[0 * Stride];
+    const float d1 = d[1 * Stride];
+    const float d2 = d[2 * Stride];
+    const float d3 = d[3 * Stride];
+    const float d4 = d[4 * Stride];
+    const float d5 = d[5 * Stride];
+
+    v[0 * OutputStride] = 4.0f * d0 - 5.0f * d2 + d4;
+    v[1 * OutputStride] = -4.0f * (d1 + d2) + d3 + d4;
+    v[2 * OutputStride] = 4.0f * (d1 - d2) - d3 + d4;
+    v[3 * OutputStride] = 2.0f * (d3 - d1) - d2 + d4;
+    v[4 * OutputStride] = 2.0f * (d1 - d3) - d2 + d4;
+    v[5 * OutputStride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    size_t TileStart,
+    size_t TileCount,
+    float* TransformedInput
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of the input tiles to the Winograd domain,
+    V = B^T * d * B. The transformed block is stored as 36 matrices of
+    InputChannels rows and TileCount columns.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    TransformedInput - Receives the transformed block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t TilesW = (Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_TILE_SIZE - 1) / MLAS_CONV_WINOGRAD_TILE_SIZE;
+    const size_t PointStride = InputChannels * TileCount;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+
+        for (size_t t = 0; t < TileCount; t++) {
+
+            const size_t Tile = TileStart + t;
+            const ptrdiff_t ih0 = ptrdiff_t((Tile / TilesW) * MLAS_CONV_WINOGRAD_TILE_SIZE) - ptrdiff_t(Parameters->Padding[0]);
+            const ptrdiff_t iw0 = ptrdiff_t((Tile % TilesW) * MLAS_CONV_WINOGRAD_TILE_SIZE) - ptrdiff_t(Parameters->Padding[1]);
+
+            //
+            // Gather the tile with the zero padding outside of the input.
+            //
+
+            float d[6][6];
+
+            for (size_t i = 0; i < 6; i++) {
+
+                const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+
+                for (size_t j = 0; j < 6; j++) {
+
+                    const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+
+                    if (size_t(ih) < InputHeight && size_t(iw) < InputWidth) {
+                        d[i][j] = input[size_t(ih) * InputWidth + size_t(iw)];
+                    } else {
+                        d[i][j] = 0.0f;
+                    }
+                }
+            }
+
+            //
+            // Transform the columns and then the rows of the tile.
+            //
+
+            float tmp[6][6];
+
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradInputTransform6(&d[0][j], 6, &tmp[0][j], 6);
+            }
+
+            float* v = TransformedInput + c * TileCount + t;
+
+            for (size_t i = 0; i < 6; i++) {
+                MlasConvWinogradInputTransform6(&tmp[i][0], 1, v + i * 6 * PointStride, PointStride);
+            }
+        }
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradOutputTransform6(
+    const float* m,
+    size_t Stride,
+    float* o,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the 1D output transform A^T to six elements.
+
+--*/
+{
+    const float m0 = m[0 * Stride];
+    const float m1 = m[1 * Stride];
+    const float m2 = m[2 * Stride];
+    const float m3 = m[3 * Stride];
+    const float m4 = m[4 * Stride];
+    const float m5 = m[5 * Stride];
+
+    const float Sum12 = m1 + m2;
+    const float Difference12 = m1 - m2;
+    const float Sum34 = m3 + m4;
+    const float Difference34 = m3 - m4;
+
+    o[0 * OutputStride] = m0 + Sum12 + Sum34;
+    o[1 * OutputStride] = Difference12 + 2.0f * Difference34;
+    o[2 * OutputStride] = Sum12 + 4.0f * Sum34;
+    o[3 * OutputStride] = Difference12 + 8.0f * Difference34 + m5;
+}
+
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    size_t TileStart,
+    size_t TileCount,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of the output tiles from the Winograd
+    domain, Y = A^T * M * A, and stores the part of each tile that is inside
+    the output. The output is scaled by Beta and accumulated, if Beta is not
+    zero.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransformedOutput - Supplies the block as 36 matrices of FilterCount rows
+        and TileCount columns.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    Output - Supplies the output tensor of the batch and group.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesW = (OutputWidth + MLAS_CONV_WINOGRAD_TILE_SIZE - 1) / MLAS_CONV_WINOGRAD_TILE_SIZE;
+    const size_t PointStride = FilterCount * TileCount;
+    const float Beta = Parameters->Beta;
+
+    for (size_t f = 0; f < FilterCount; f++) {
 
-    This routine is invoked from a worker thread to execute a segment of a
-    convolution operation.
+        float* output = Output + f * OutputSize;
 
-Arguments:
+        for (size_t t = 0; t < TileCount; t++) {
 
-    Context - Supplies the pointer to the context for the threaded operation.
+            const size_t Tile = TileStart + t;
+            const size_t oh0 = (Tile / TilesW) * MLAS_CONV_WINOGRAD_TILE_SIZE;
+            const size_t ow0 = (Tile % TilesW) * MLAS_CONV_WINOGRAD_TILE_SIZE;
 
-    Index - Supplies the current index of the threaded operation.
+            const float* m = TransformedOutput + f * TileCount + t;
 
-Return Value:
+            //
+            // Transform the columns and then the rows of the tile.
+            //
 
-    None.
+            float tmp[4][6];
 
---*/
-{
-    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradOutputTransform6(m + j * PointStride, 6 * PointStride, &tmp[0][j], 6);
+            }
 
-    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+            float y[4][4];
 
-    float* ColumnBuffer =
-        WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+            for (size_t i = 0; i < 4; i++) {
+                MlasConvWinogradOutputTransform6(&tmp[i][0], 1, &y[i][0], 1);
+            }
 
-    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
-        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
-        Segment->CountN);
+            const size_t RowCount = std::min(OutputHeight - oh0, size_t(MLAS_CONV_WINOGRAD_TILE_SIZE));
+            const size_t ColumnCount = std::min(OutputWidth - ow0, size_t(MLAS_CONV_WINOGRAD_TILE_SIZE));
+
+            for (size_t i = 0; i < RowCount; i++) {
+
+                float* row = output + (oh0 + i) * OutputWidth + ow0;
+
+                for (size_t j = 0; j < ColumnCount; j++) {
+                    row[j] = (Beta != 0.0f) ? y[i][j] + Beta * row[j] : y[i][j];
+                }
+            }
+        }
+    }
 }
 
 void
-MlasConvGemmDirectThreaded(
-    void* Context,
-    ptrdiff_t Index
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* TransformedFilter,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    convolution operation.
+    This routine implements the Winograd convolution of a batch and group. The
+    blocks of tiles are partitioned across the threads.
 
 Arguments:
 
-    Context - Supplies the pointer to the context for the threaded operation.
-
-    Index - Supplies the current index of the threaded operation.
-
-Return Value:
-
-    None.
-
---*/
-{
-    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
 
-    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+    Input - Supplies the input tensor of the batch and group.
 
-    //
-    // Compute the range of indices to use for this thread.
-    //
+    TransformedFilter - Supplies the transformed filter of the group.
 
-    const size_t GroupCount = Parameters->GroupCount;
-    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
-    const float Beta = Parameters->Beta;
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
 
-    size_t BatchGroupStart;
-    size_t BatchGroupRemaining;
+    Output - Supplies the output tensor of the batch and group.
 
-    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, BatchGroupCount,
-        &BatchGroupStart, &BatchGroupRemaining);
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
 
-    size_t BatchGroupEnd = BatchGroupStart + BatchGroupRemaining;
+Return Value:
 
-    //
-    // Iterate over the batch and groups allocated to this thread.
-    //
+    None.
 
+--*/
+{
     const size_t FilterCount = Parameters->FilterCount;
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t K = Parameters->K;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t TileCount = Parameters->u.Winograd.TileCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+    const size_t BufferSizePerThread =
+        MLAS_CONV_WINOGRAD_POINT_COUNT * (InputChannels + FilterCount) * TileBlockSize;
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    ptrdiff_t TargetThreadCount = Parameters->ThreadCount;
 
-    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+    if (size_t(TargetThreadCount) > TileBlockCount) {
+        TargetThreadCount = ptrdiff_t(TileBlockCount);
+    }
 
-        size_t group = bg % GroupCount;
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t BlockStart;
+        size_t BlockCount;
 
-        const float* input = WorkBlock->Input + bg * InputGroupSize;
-        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
-        float* output = WorkBlock->Output + bg * OutputGroupSize;
+        MlasPartitionWork(tid, TargetThreadCount, TileBlockCount, &BlockStart, &BlockCount);
 
-        //
-        // Invoke the non-threaded GEMM directly with the input tensor.
-        //
+        float* TransformedInput = WorkingBuffer + tid * BufferSizePerThread;
+        float* TransformedOutput = TransformedInput + MLAS_CONV_WINOGRAD_POINT_COUNT * InputChannels * TileBlockSize;
 
-        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
-                           K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
-                           OutputSize);
+        for (size_t block = BlockStart; block < BlockStart + BlockCount; block++) {
 
-        //
-        // Apply the activation with optional bias.
-        //
+            const size_t TileStart = block * TileBlockSize;
+            const size_t CountTiles = std::min(TileCount - TileStart, TileBlockSize);
 
-        const float* bias = WorkBlock->Bias;
+            MlasConvWinogradTransformInput(Parameters, Input, TileStart, CountTiles, TransformedInput);
 
-        if (bias != nullptr) {
-            bias += group * FilterCount;
-        }
+            for (size_t p = 0; p < MLAS_CONV_WINOGRAD_POINT_COUNT; p++) {
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTiles, InputChannels, 1.0f,
+                                   TransformedFilter + p * FilterCount * InputChannels, InputChannels,
+                                   TransformedInput + p * InputChannels * CountTiles, CountTiles, 0.0f,
+                                   TransformedOutput + p * FilterCount * CountTiles, CountTiles);
+            }
 
-        MlasActivation(Parameters->Activation, output, bias, FilterCount,
-            OutputSize, OutputSize);
-    }
+            MlasConvWinogradTransformOutput(Parameters, TransformedOutput, TileStart, CountTiles, Output);
+        }
+    });
 }
 
 inline
@@ -843,7 +1637,8 @@ Arguments:
 
     Input - Supplies the input tensor.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the filter tensor, or the filter quantized by
+        MlasConvQuantizeFilter if the parameters specify a filter bit width.
 
     Bias - Optionally supplies the bias vector.
 
@@ -867,7 +1662,10 @@ Return Value:
 
     const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
     const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    const size_t FilterGroupSize = (Parameters->FilterBitWidth != 0) ?
+        MlasConvQuantizedFilterSize(1, FilterCount, K, Parameters->FilterBitWidth,
+            Parameters->FilterBlkLen) / sizeof(float) :
+        FilterCount * K;
 
     const size_t BatchCount = Parameters->BatchCount;
     const size_t GroupCount = Parameters->GroupCount;
@@ -976,6 +1774,22 @@ Return Value:
                     break;
                 }
 
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // The filter was transformed by MlasConvWinogradTransformFilter.
+                    //
+
+                    MlasConvWinograd(Parameters, Input,
+                                     Filter + group * MlasConvWinogradFilterSize(1, FilterCount, Parameters->InputChannels),
+                                     WorkingBuffer, Output, ThreadPool);
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
                 case MlasConvAlgorithmDepthwise:
@@ -1023,6 +1837,93 @@ Return Value:
 // Chance of arithmetic overflow could be reduced
 #pragma warning(disable : 26451)
 #endif
+void
+MlasConvPrepareSegmented(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool,
+    size_t* WorkingBufferSize
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the MlasConvAlgorithmExpandThenGemmSegmented
+    algorithm and computes its threading parameters.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Segment the operation across multiple threads by slicing the N
+    // dimension (see MlasSgemmTryMultithread).
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation. Small requests should run using the single
+    // threaded path.
+    //
+
+    ptrdiff_t TargetThreadCount;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Compute the thread stride for slicing the N dimension.
+    //
+
+    size_t StrideN = OutputSize / TargetThreadCount;
+
+    if ((StrideN * TargetThreadCount) != OutputSize) {
+        StrideN++;
+    }
+
+    if (TargetThreadCount > 1) {
+
+        StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        if (StrideN >= OutputSize) {
+            TargetThreadCount = 1;
+        } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
+            TargetThreadCount--;
+        }
+    }
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
+    Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+
+    *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+}
+
 void
 MLASCALL
 MlasConvPrepare(
@@ -1041,7 +1942,10 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    bool AllowWinograd,
+    size_t FilterBitWidth,
+    size_t FilterBlkLen
     )
 /*++
 
@@ -1088,6 +1992,16 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    AllowWinograd - Supplies true if the caller supports the Winograd
+        algorithm, which requires the filter transformed by
+        MlasConvWinogradTransformFilter.
+
+    FilterBitWidth - Supplies the number of bits of the filter quantized by
+        MlasConvQuantizeFilter, else zero if the filter is float.
+
+    FilterBlkLen - Supplies the number of elements along K that share a scale
+        of the quantized filter.
+
 Return Value:
 
     None.
@@ -1104,6 +2018,10 @@ Return Value:
     Parameters->InputChannels = InputChannels;
     Parameters->FilterCount = FilterCount;
     Parameters->Beta = Beta;
+    Parameters->FilterBitWidth = FilterBitWidth;
+    Parameters->FilterBlkLen = FilterBlkLen;
+
+    const bool QuantizedFilter = (FilterBitWidth != 0);
 
     size_t InputSize = 1;
     size_t OutputSize = 1;
@@ -1168,7 +2086,68 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
-    if (AllStridesAreOne && AllPaddingIsZero) {
+    //
+    // Use the Winograd algorithm for 3x3 convolutions with unit strides and
+    // dilations. The transforms of the input and output tiles are amortized
+    // over the filters and the input channels, so the channel counts must be
+    // large enough.
+    //
+
+    if (!QuantizedFilter && AllowWinograd && Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        Parameters->OutputShape[0] >= MLAS_CONV_WINOGRAD_TILE_SIZE &&
+        Parameters->OutputShape[1] >= MLAS_CONV_WINOGRAD_TILE_SIZE) {
+
+        const size_t TileCount =
+            ((Parameters->OutputShape[0] + MLAS_CONV_WINOGRAD_TILE_SIZE - 1) / MLAS_CONV_WINOGRAD_TILE_SIZE) *
+            ((Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_TILE_SIZE - 1) / MLAS_CONV_WINOGRAD_TILE_SIZE);
+
+        //
+        // Size the block of tiles transformed at a time to the working buffer
+        // of a thread.
+        //
+
+        size_t TileBlockSize = MLAS_CONV_WINOGRAD_BUFFER_SIZE_PER_THREAD /
+            (MLAS_CONV_WINOGRAD_POINT_COUNT * (InputChannels + FilterCount));
+
+        TileBlockSize = std::min(std::max(TileBlockSize, size_t(8)), size_t(64));
+        TileBlockSize = std::min(TileBlockSize, TileCount);
+
+        const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+        ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+        ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        if (size_t(TargetThreadCount) > TileBlockCount) {
+            TargetThreadCount = ptrdiff_t(TileBlockCount);
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.TileCount = TileCount;
+        Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+
+        *WorkingBufferSize = size_t(TargetThreadCount) * MLAS_CONV_WINOGRAD_POINT_COUNT *
+            (InputChannels + FilterCount) * TileBlockSize;
+
+        return;
+    }
+
+    //
+    // The quantized filter is only dequantized by the segmented algorithm.
+    //
+
+    if (!QuantizedFilter && AllStridesAreOne && AllPaddingIsZero) {
 
         //
         // Detect a pointwise convolution.
@@ -1211,7 +2190,7 @@ Return Value:
         }
     }
 
-    if (FilterCount > OutputSize) {
+    if (!QuantizedFilter && FilterCount > OutputSize) {
 
         //
         // The filter count is larger than the output dimensions, so perform the
@@ -1230,7 +2209,7 @@ Return Value:
         // Currently only support 3x3 kernel with padding <=1 and dilations = 1.
         // TODO: support more general depthwise convolution.
 
-        if (Dimensions == 2
+        if (!QuantizedFilter && Dimensions == 2
                 && Parameters->FilterCount == 1 && Parameters->InputChannels == 1
                 && Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3
                 && Parameters->Padding[0] <= 1 && Parameters->Padding[1] <= 1
@@ -1244,59 +2223,89 @@ Return Value:
 
 #endif
 
-        //
-        // Segment the operation across multiple threads by slicing the N
-        // dimension (see MlasSgemmTryMultithread).
-        //
-        // Compute the number of target threads given the complexity of the
-        // convolution operation. Small requests should run using the single
-        // threaded path.
-        //
+        MlasConvPrepareSegmented(Parameters, ThreadPool, WorkingBufferSize);
+    }
+}
 
-        ptrdiff_t TargetThreadCount;
-        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+bool
+MLASCALL
+MlasConvOverrideAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    MLAS_THREADPOOL* ThreadPool,
+    size_t* WorkingBufferSize
+    )
+/*++
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-            TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-        } else {
-            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-        }
+Routine Description:
 
-        ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    This routine replaces the algorithm selected by MlasConvPrepare with
+    another algorithm that computes the same convolution, for callers that
+    measure the candidates on the target machine.
 
-        if (TargetThreadCount >= MaximumThreadCount) {
-            TargetThreadCount = MaximumThreadCount;
-        }
+    Only the expand then GEMM algorithms can be selected, as the other
+    algorithms depend on the shape of the convolution or on a transformed
+    filter.
 
-        //
-        // Compute the thread stride for slicing the N dimension.
-        //
+Arguments:
 
-        size_t StrideN = OutputSize / TargetThreadCount;
+    Parameters - Supplies the structure returned by MlasConvPrepare.
 
-        if ((StrideN * TargetThreadCount) != OutputSize) {
-            StrideN++;
-        }
+    Algorithm - Supplies the algorithm to use.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+Return Value:
+
+    Returns true if the algorithm is supported for the convolution, else
+    false and the parameters are unchanged.
+
+--*/
+{
+#if defined(MLAS_TARGET_WASM_SCALAR)
+    if (Parameters->Algorithm == MlasConvAlgorithmDepthwise) {
+        return false;
+    }
+#endif
 
-        if (TargetThreadCount > 1) {
+    switch (Algorithm) {
 
-            StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+        case MlasConvAlgorithmExpandThenGemm:
+        {
+            //
+            // The quantized filter is only dequantized by the segmented
+            // algorithm.
+            //
 
-            if (StrideN >= OutputSize) {
-                TargetThreadCount = 1;
-            } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
-                TargetThreadCount--;
+            if (Parameters->FilterBitWidth != 0) {
+                return false;
             }
+
+            Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+
+            *WorkingBufferSize = Parameters->OutputSize * Parameters->K;
+
+            return true;
         }
 
-        Parameters->ThreadCount = TargetThreadCount;
+        case MlasConvAlgorithmExpandThenGemmSegmented:
+        {
+            MlasConvPrepareSegmented(Parameters, ThreadPool, WorkingBufferSize);
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
-        Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+            return true;
+        }
 
-        *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+        default:
+        {
+            return false;
+        }
     }
 }
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
-#endif
\ No newline at end of file
+#endif
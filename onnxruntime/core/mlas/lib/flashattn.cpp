@@ -1,83 +1,214 @@
+#include <atomic>
 #include <numeric>
 
 #include "mlasi.h"
 
+//
+// Shared state of the threads of a flash attention operation. The tasks are
+// handed out from a single counter so that threads that finish early pick up
+// the remaining work instead of idling on a static split.
+//
+
+struct MLAS_FLASH_ATTENTION_CONTEXT {
+    const MlasFlashAttentionThreadedArgs* Args;
+    std::atomic<ptrdiff_t> NextTask;
+};
+
+MLAS_FORCEINLINE
+void
+MlasFlashAttentionScaleRow(
+    float* Row,
+    float Scale,
+    size_t Count
+)
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (Count >= 4) {
+        MlasStoreFloat32x4(Row, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Row), ScaleVector));
+        Row += 4;
+        Count -= 4;
+    }
+
+    while (Count > 0) {
+        *Row++ *= Scale;
+        Count -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasFlashAttentionScaleRow(
+    const float* Input,
+    float* Output,
+    float Scale,
+    size_t Count
+)
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (Count >= 4) {
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Input), ScaleVector));
+        Input += 4;
+        Output += 4;
+        Count -= 4;
+    }
+
+    while (Count > 0) {
+        *Output++ = *Input++ * Scale;
+        Count -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasFlashAttentionConvertRows(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+)
+{
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(Source), Destination, Count);
+}
+
+size_t
+MLASCALL
+MlasFlashAttentionGetBufferSizePerThread(
+    const MlasFlashAttentionThreadedArgs* args
+)
+{
+    const size_t q_block_size = static_cast<size_t>(args->q_block_size);
+    const size_t kv_block_size = static_cast<size_t>(args->kv_block_size);
+    const size_t qk_head_size = static_cast<size_t>(args->qk_head_size);
+    const size_t v_head_size = static_cast<size_t>(args->v_head_size);
+
+    // l, m, QK^T and the temporary output.
+    size_t buffer_elements = q_block_size * 2 + q_block_size * kv_block_size + q_block_size * v_head_size;
+
+    // fp32 copies of the blocks of Q, K and V.
+    if (args->query_fp16 != nullptr) {
+        buffer_elements += q_block_size * qk_head_size + kv_block_size * (qk_head_size + v_head_size);
+    }
+
+    return buffer_elements * sizeof(float);
+}
+
 void
 MlasFlashAttentionThreaded(
     void* argptr,
     std::ptrdiff_t thread_id
 )
 {
-    const MlasFlashAttentionThreadedArgs* args = reinterpret_cast<MlasFlashAttentionThreadedArgs*>(argptr);
+    MLAS_FLASH_ATTENTION_CONTEXT* context = reinterpret_cast<MLAS_FLASH_ATTENTION_CONTEXT*>(argptr);
+    const MlasFlashAttentionThreadedArgs* args = context->Args;
     ptrdiff_t q_block_size = static_cast<ptrdiff_t>(args->q_block_size);
     ptrdiff_t kv_block_size = static_cast<ptrdiff_t>(args->kv_block_size);
     ptrdiff_t batch_size = static_cast<ptrdiff_t>(args->batch_size);
     ptrdiff_t num_heads = static_cast<ptrdiff_t>(args->num_heads);
+    ptrdiff_t kv_num_heads = (args->kv_num_heads > 0) ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
     ptrdiff_t q_sequence_length = static_cast<ptrdiff_t>(args->q_sequence_length);
     ptrdiff_t kv_sequence_length = static_cast<ptrdiff_t>(args->kv_sequence_length);
     ptrdiff_t qk_head_size = static_cast<ptrdiff_t>(args->qk_head_size);
     ptrdiff_t v_head_size = static_cast<ptrdiff_t>(args->v_head_size);
     float* buffer = args->buffer;
     ptrdiff_t buffer_size_per_thread = static_cast<ptrdiff_t>(args->buffer_size_per_thread);
-    ptrdiff_t thread_count = static_cast<ptrdiff_t>(args->thread_count);
+    const bool is_causal = args->is_causal;
+    const bool is_fp16 = args->query_fp16 != nullptr;
     const float* query = args->query;
     const float* key = args->key;
     const float* value = args->value;
     float* output = args->output;
 
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+    // Query heads [g * group, (g + 1) * group) share the key and value head g.
+    ptrdiff_t kv_group_size = num_heads / kv_num_heads;
+
+    // Query row i attends to the key columns [0, i + causal_offset] with a causal mask.
+    ptrdiff_t causal_offset = kv_sequence_length - q_sequence_length;
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
     auto&& mlas_platform = GetMlasPlatform();
 #endif
 
-    ptrdiff_t q_chunk_count = (q_sequence_length + (q_block_size - 1)) / q_block_size;
+    char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
+    float* l = reinterpret_cast<float*>(buffer_current_thread);
+    float* m = l + q_block_size;
+    float* intermediate = m + q_block_size;
+    float* temp_output = intermediate + q_block_size * kv_block_size;
+    float* query_block = temp_output + q_block_size * v_head_size;
+    float* key_block = query_block + q_block_size * qk_head_size;
+    float* value_block = key_block + kv_block_size * qk_head_size;
 
-    ptrdiff_t task_start = 0;
-    ptrdiff_t task_end = 0;
+    ptrdiff_t q_chunk_count = (q_sequence_length + (q_block_size - 1)) / q_block_size;
     ptrdiff_t total_task_count = batch_size * num_heads * q_chunk_count;
-    ptrdiff_t quotient = total_task_count / thread_count;
-    ptrdiff_t remainder = total_task_count % thread_count;
-    if (thread_id < remainder) {
-        task_start = (quotient + 1) * thread_id;
-        task_end = task_start + quotient + 1;
-    } else {
-        task_start = quotient * thread_id + remainder;
-        task_end = task_start + quotient;
-    }
 
-    for (ptrdiff_t task_index = task_start; task_index < task_end; ++task_index) {
-        ptrdiff_t batch_idx = task_index;
-        ptrdiff_t q_idx = (batch_idx % q_chunk_count) * q_block_size;
-        batch_idx /= q_chunk_count;
-        ptrdiff_t head_idx = batch_idx % num_heads;
-        batch_idx /= num_heads;
+    for (;;) {
+        ptrdiff_t task_index = context->NextTask.fetch_add(1, std::memory_order_relaxed);
+        if (task_index >= total_task_count) {
+            break;
+        }
+
+        //
+        // Hand out the chunks of the last rows of Q first: with a causal mask
+        // they attend to the most keys, so the cheaper chunks fill in the gaps
+        // at the end. The heads sharing a K/V head are handed out together.
+        //
+        ptrdiff_t q_idx = (q_chunk_count - 1 - task_index / (batch_size * num_heads)) * q_block_size;
+        ptrdiff_t h = task_index % (batch_size * num_heads);
+        ptrdiff_t batch_idx = h / num_heads;
+        ptrdiff_t head_idx = h % num_heads;
+        ptrdiff_t kv_h = batch_idx * kv_num_heads + head_idx / kv_group_size;
+
+        size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
 
-        char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
-        float* l = reinterpret_cast<float*>(buffer_current_thread);
-        float* m = l + q_block_size;
         for (ptrdiff_t t = 0; t < q_block_size; ++t) {
+            l[t] = 0.0f;
             m[t] = std::numeric_limits<float>::lowest();
         }
-        float* intermediate = m + q_block_size;
-        float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        const float* inputQ;
+        if (is_fp16) {
+            MlasFlashAttentionConvertRows(args->query_fp16 + (h * q_sequence_length + q_idx) * qk_head_size,
+                                          query_block, row_size_q_capped * static_cast<size_t>(qk_head_size));
+            inputQ = query_block;
+        } else {
+            inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
+        }
+
+        //
+        // Skip the blocks of K and V that are masked out for every row of this
+        // chunk of Q.
+        //
+        ptrdiff_t kv_end = kv_sequence_length;
+        if (is_causal) {
+            kv_end = std::min(kv_end, q_idx + static_cast<ptrdiff_t>(row_size_q_capped) + causal_offset);
+        }
+
+        for (ptrdiff_t ir = 0; ir < kv_end; ir += kv_block_size) {
             /*
-                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
+                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
                 m = max(m, rowmax(S))
                 diff = old_m - m
                 S = exp(S - m)
                 l = exp(diff) * l + rowsum(S)
-                O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
+                O = diag(exp(diff)) * O + S * V[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            const float* inputK;
+            const float* inputV;
+            if (is_fp16) {
+                MlasFlashAttentionConvertRows(args->key_fp16 + (kv_h * kv_sequence_length + ir) * qk_head_size,
+                                              key_block, row_size_kv_capped * static_cast<size_t>(qk_head_size));
+                MlasFlashAttentionConvertRows(args->value_fp16 + (kv_h * kv_sequence_length + ir) * v_head_size,
+                                              value_block, row_size_kv_capped * static_cast<size_t>(v_head_size));
+                inputK = key_block;
+                inputV = value_block;
+            } else {
+                inputK = key + (kv_h * kv_sequence_length + ir) * qk_head_size;
+                inputV = value + (kv_h * kv_sequence_length + ir) * v_head_size;
+            }
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,20 +227,36 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
+                //
+                // The columns past the diagonal of a causal mask get zero
+                // probability, and a row without any visible column in this
+                // block keeps its state.
+                //
+                size_t row_size_kv_visible = row_size_kv_capped;
+                if (is_causal) {
+                    ptrdiff_t visible = q_idx + irow + causal_offset + 1 - ir;
+                    row_size_kv_visible = static_cast<size_t>(
+                        std::clamp(visible, ptrdiff_t(0), static_cast<ptrdiff_t>(row_size_kv_capped)));
+                    std::fill(p + row_size_kv_visible, p + row_size_kv_capped, 0.0f);
+                    if (row_size_kv_visible == 0) {
+                        continue;
+                    }
+                }
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
+                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_visible);
 #else
-                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_visible);
 #endif
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
                 negmax = -m[irow];
                 m_diff -= m[irow];  // old - new (less than 0)
 
-#if defined(MLAS_TARGET_AMD64)
-                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
+                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_visible, &negmax);
 #else
-                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_visible, &negmax);
 #endif
 
                 // Note: for ir == 0, there is actually no need to calculate exp_diff
@@ -117,9 +264,7 @@ MlasFlashAttentionThreaded(
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
-                    for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                        temp_output[irow * v_head_size + icol] = exp_diff * temp_output[irow * v_head_size + icol];
-                    }
+                    MlasFlashAttentionScaleRow(temp_output + irow * v_head_size, exp_diff, static_cast<size_t>(v_head_size));
                 } else {
                     l[irow] = rowsum;
                     // When ir == 0, there is no need to scale the old result because it is zero.
@@ -141,12 +286,9 @@ MlasFlashAttentionThreaded(
         }
 
         float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
-        // TODO: leverage advanced instruction sets
-        for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
-            for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
-            }
+        for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
+            MlasFlashAttentionScaleRow(temp_output + irow * v_head_size, output_row, 1.0f / l[irow],
+                                       static_cast<size_t>(v_head_size));
             output_row += num_heads * v_head_size;
         }
     }
@@ -159,9 +301,13 @@ MlasFlashAttention(
     MLAS_THREADPOOL* ThreadPool
 )
 {
+    MLAS_FLASH_ATTENTION_CONTEXT context;
+    context.Args = args;
+    context.NextTask.store(0, std::memory_order_relaxed);
+
     MlasExecuteThreaded(
         MlasFlashAttentionThreaded,
-        static_cast<void *>(args),
+        static_cast<void *>(&context),
         static_cast<std::ptrdiff_t>(args->thread_count),
         ThreadPool);
 }
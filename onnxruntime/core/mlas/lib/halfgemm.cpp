@@ -32,6 +32,16 @@ MlasFp16AccelerationSupported()
 #endif
 }
 
+bool MLASCALL
+MlasHalfGemmAccelerationSupported()
+{
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
+    return MlasFp16AccelerationSupported();
+#else
+    return MlasHalfGemmGetDispatch() != &MlasHalfGemmDispatchDefault;
+#endif
+}
+
 
 void
 MLASCALL
@@ -509,6 +509,9 @@ MlasHalfGemmGetDispatch()
 {
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
     return &MlasHalfGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    const MLAS_HALFGEMM_DISPATCH* dispatch = GetMlasPlatform().HalfGemmDispatch;
+    return (dispatch != nullptr) ? dispatch : &MlasHalfGemmDispatchDefault;
 #else
     return &MlasHalfGemmDispatchDefault;
 #endif
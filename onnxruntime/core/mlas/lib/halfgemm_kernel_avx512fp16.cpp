@@ -0,0 +1,304 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX512-FP16.
+
+    This module must be compiled with AVX512-FP16 support (e.g. -mavx512fp16)
+    and is only used when the processor reports AVX512-FP16 support at runtime.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#if defined(MLAS_USE_AVX512FP16)
+
+#include <immintrin.h>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Define the number of fp16 elements in a vector.
+//
+
+constexpr size_t MlasHalfGemmAvx512Fp16VectorLength = 32;
+
+MLAS_FORCEINLINE
+__mmask32
+MlasHalfGemmAvx512Fp16TailMask(
+    size_t len
+    )
+{
+    return (len >= 32) ? __mmask32(0xFFFFFFFF) : __mmask32((1u << len) - 1);
+}
+
+MLAS_FORCEINLINE
+__m512h
+MlasHalfGemmAvx512Fp16Load(
+    const _mlas_fp16_* Buffer,
+    __mmask32 Mask
+    )
+{
+    return _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Mask, Buffer));
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmAvx512Fp16Store(
+    _mlas_fp16_* Buffer,
+    __m512h Vector,
+    __mmask32 Mask
+    )
+{
+    _mm512_mask_storeu_epi16(Buffer, Mask, _mm512_castph_si512(Vector));
+}
+
+/**
+ * @brief Compute a block of RowCount rows and up to two vectors of columns.
+ *
+ * @tparam RowCount     # of rows of A and C to process
+ * @tparam VectorCount  # of column vectors of B and C to process
+ * @param Mask          Mask of the valid columns of the last vector
+*/
+template<size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmAvx512Fp16Block(
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode,
+    __mmask32 Mask
+    )
+{
+    static_assert(VectorCount == 1 || VectorCount == 2, "unsupported vector count");
+
+    const __mmask32 Masks[2] = {
+        VectorCount == 1 ? Mask : __mmask32(0xFFFFFFFF),
+        Mask,
+    };
+
+    __m512h Accumulators[RowCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const __m512h BiasVector = (Bias == nullptr)
+            ? _mm512_setzero_ph()
+            : MlasHalfGemmAvx512Fp16Load(Bias + v * MlasHalfGemmAvx512Fp16VectorLength, Masks[v]);
+
+        for (size_t m = 0; m < RowCount; m++) {
+            Accumulators[m][v] = BiasVector;
+            if (!ZeroMode) {
+                Accumulators[m][v] = _mm512_add_ph(
+                    Accumulators[m][v],
+                    MlasHalfGemmAvx512Fp16Load(C + m * ldc + v * MlasHalfGemmAvx512Fp16VectorLength, Masks[v]));
+            }
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        __m512h BElements[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BElements[v] = MlasHalfGemmAvx512Fp16Load(B + v * MlasHalfGemmAvx512Fp16VectorLength, Masks[v]);
+        }
+
+        for (size_t m = 0; m < RowCount; m++) {
+            const __m512h AElement = _mm512_castsi512_ph(_mm512_set1_epi16(static_cast<short>(A[m * lda + k])));
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[m][v] = _mm512_fmadd_ph(AElement, BElements[v], Accumulators[m][v]);
+            }
+        }
+
+        B += ldb;
+    }
+
+    for (size_t m = 0; m < RowCount; m++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            MlasHalfGemmAvx512Fp16Store(C + m * ldc + v * MlasHalfGemmAvx512Fp16VectorLength, Accumulators[m][v], Masks[v]);
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasHalfGemmAvx512Fp16Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    constexpr size_t VectorLength = MlasHalfGemmAvx512Fp16VectorLength;
+
+    while (CountN >= 2 * VectorLength) {
+        MlasHalfGemmAvx512Fp16Block<RowCount, 2>(
+            CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode, __mmask32(0xFFFFFFFF));
+        C += 2 * VectorLength;
+        B += 2 * VectorLength;
+        Bias = (Bias == nullptr) ? nullptr : Bias + 2 * VectorLength;
+        CountN -= 2 * VectorLength;
+    }
+
+    if (CountN > VectorLength) {
+        MlasHalfGemmAvx512Fp16Block<RowCount, 2>(
+            CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode,
+            MlasHalfGemmAvx512Fp16TailMask(CountN - VectorLength));
+    } else if (CountN > 0) {
+        MlasHalfGemmAvx512Fp16Block<RowCount, 1>(
+            CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode,
+            MlasHalfGemmAvx512Fp16TailMask(CountN));
+    }
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 16) {
+        const __m256i Half = _mm512_cvtps_ph(_mm512_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), Half);
+        src += 16;
+        dest += 16;
+        len -= 16;
+    }
+
+    if (len > 0) {
+        const __mmask16 Mask = static_cast<__mmask16>((1u << len) - 1);
+        const __m256i Half = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(Mask, src), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_mask_storeu_epi16(dest, Mask, Half);
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        const size_t len = CntRow * CntCol;
+        CvtFloat2Half(dest, src, len);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2Half(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmAvx512Fp16Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmAvx512Fp16Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmAvx512Fp16Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmAvx512Fp16Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmAvx512Fp16Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmAvx512Fp16Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0 // kernel uses masked loads and never reads beyond the buffer end
+};
+
+#endif // MLAS_USE_AVX512FP16
@@ -0,0 +1,222 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    kvcache_int8.cpp
+
+Abstract:
+
+    This module implements the attention routines that read the key and
+    value caches quantized to int8.
+
+    Each row of a cache holds one token of one head and is quantized
+    symmetrically with one fp32 scale. The rows are converted to fp32 a block
+    at a time while they are in the cache, so the memory traffic of the cache
+    is a quarter of the fp32 cache.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of elements of a cache row converted to fp32 at a time.
+//
+
+constexpr size_t MlasKvCacheInt8BlockSize = 64;
+
+MLAS_FORCEINLINE
+void
+MlasKvCacheInt8ToFloat(
+    const int8_t* Input,
+    float* Output,
+    size_t Count
+    )
+{
+    for (size_t i = 0; i < Count; i++) {
+        Output[i] = static_cast<float>(Input[i]);
+    }
+}
+
+MLAS_FORCEINLINE
+float
+MlasKvCacheInt8Dot(
+    const float* A,
+    const float* B,
+    size_t Count
+    )
+{
+    MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+    while (Count >= 4) {
+        Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(A), MlasLoadFloat32x4(B), Accumulator);
+        A += 4;
+        B += 4;
+        Count -= 4;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(Accumulator);
+
+    while (Count > 0) {
+        Sum += *A++ * *B++;
+        Count -= 1;
+    }
+
+    return Sum;
+}
+
+MLAS_FORCEINLINE
+void
+MlasKvCacheInt8Axpy(
+    float Alpha,
+    const float* X,
+    float* Y,
+    size_t Count
+    )
+{
+    MLAS_FLOAT32X4 AlphaVector = MlasBroadcastFloat32x4(Alpha);
+
+    while (Count >= 4) {
+        MlasStoreFloat32x4(Y, MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(X), AlphaVector, MlasLoadFloat32x4(Y)));
+        X += 4;
+        Y += 4;
+        Count -= 4;
+    }
+
+    while (Count > 0) {
+        *Y++ += Alpha * *X++;
+        Count -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasQuantizeKvCacheInt8(
+    const float* Input,
+    int8_t* Output,
+    float* Scales,
+    size_t RowCount,
+    size_t HeadSize
+    )
+{
+    for (size_t r = 0; r < RowCount; r++) {
+
+        float AbsMaximum = 0.0f;
+        for (size_t h = 0; h < HeadSize; h++) {
+            AbsMaximum = std::max(AbsMaximum, std::fabs(Input[h]));
+        }
+
+        const float Scale = AbsMaximum / 127.0f;
+        const float ReciprocalScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+
+        for (size_t h = 0; h < HeadSize; h++) {
+            const float Value = std::nearbyint(Input[h] * ReciprocalScale);
+            Output[h] = static_cast<int8_t>(std::clamp(Value, -127.0f, 127.0f));
+        }
+
+        Scales[r] = Scale;
+        Input += HeadSize;
+        Output += HeadSize;
+    }
+}
+
+void
+MLASCALL
+MlasAttentionQKInt8Kv(
+    const float* Query,
+    size_t M,
+    const int8_t* Key,
+    const float* KeyScales,
+    size_t N,
+    size_t HeadSize,
+    float alpha,
+    float* Scores,
+    size_t ldScores
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float KeyBlock[MlasKvCacheInt8BlockSize], 64);
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t m = 0; m < M; m++) {
+            Scores[m * ldScores + n] = 0.0f;
+        }
+
+        //
+        // Convert a block of the key row once and use it for all the query
+        // rows, which is a single row when decoding.
+        //
+
+        for (size_t h = 0; h < HeadSize; h += MlasKvCacheInt8BlockSize) {
+
+            const size_t Count = std::min(HeadSize - h, MlasKvCacheInt8BlockSize);
+            MlasKvCacheInt8ToFloat(Key + h, KeyBlock, Count);
+
+            for (size_t m = 0; m < M; m++) {
+                Scores[m * ldScores + n] += MlasKvCacheInt8Dot(Query + m * HeadSize + h, KeyBlock, Count);
+            }
+        }
+
+        const float Scale = alpha * KeyScales[n];
+        for (size_t m = 0; m < M; m++) {
+            Scores[m * ldScores + n] *= Scale;
+        }
+
+        Key += HeadSize;
+    }
+}
+
+void
+MLASCALL
+MlasAttentionPVInt8Kv(
+    const float* Probs,
+    size_t ldProbs,
+    size_t M,
+    const int8_t* Value,
+    const float* ValueScales,
+    size_t N,
+    size_t HeadSize,
+    float* Output,
+    size_t ldOutput
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float ValueBlock[MlasKvCacheInt8BlockSize], 64);
+
+    for (size_t m = 0; m < M; m++) {
+        std::fill_n(Output + m * ldOutput, HeadSize, 0.0f);
+    }
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t h = 0; h < HeadSize; h += MlasKvCacheInt8BlockSize) {
+
+            const size_t Count = std::min(HeadSize - h, MlasKvCacheInt8BlockSize);
+            bool Converted = false;
+
+            for (size_t m = 0; m < M; m++) {
+
+                //
+                // The causal mask leaves zero probabilities for the tokens
+                // past each query row.
+                //
+
+                const float Probability = Probs[m * ldProbs + n];
+                if (Probability == 0.0f) {
+                    continue;
+                }
+
+                if (!Converted) {
+                    MlasKvCacheInt8ToFloat(Value + h, ValueBlock, Count);
+                    Converted = true;
+                }
+
+                MlasKvCacheInt8Axpy(Probability * ValueScales[n], ValueBlock, Output + m * ldOutput + h, Count);
+            }
+        }
+
+        Value += HeadSize;
+    }
+}
@@ -0,0 +1,443 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements the layer normalization routines, including the
+    simplified (RMS) normalization and the normalization of the sum of an
+    input, a skip connection and a bias.
+
+    The statistics of a row are accumulated in a single pass using Welford's
+    algorithm, one running mean and sum of squared differences per vector
+    lane. The lanes are combined once at the end of the row, so the variance
+    doesn't suffer from the cancellation of E[x^2] - E[x]^2.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of elements of a half precision row converted to fp32 at a time.
+//
+
+constexpr size_t MlasLayerNormFp16BlockSize = 64;
+
+//
+// Accumulates the statistics of a row, 8 elements (two vectors) at a time.
+//
+
+template<bool Simplified>
+struct MLAS_LAYERNORM_ACCUMULATOR;
+
+template<>
+struct MLAS_LAYERNORM_ACCUMULATOR<false>
+{
+    MLAS_FLOAT32X4 Mean0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Mean1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 M2_0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 M2_1 = MlasZeroFloat32x4();
+    size_t LaneCount = 0;
+
+    MLAS_FORCEINLINE
+    void
+    Update(
+        MLAS_FLOAT32X4 Value0,
+        MLAS_FLOAT32X4 Value1
+        )
+    {
+        LaneCount++;
+        MLAS_FLOAT32X4 Reciprocal = MlasBroadcastFloat32x4(1.0f / float(LaneCount));
+
+        MLAS_FLOAT32X4 Delta0 = MlasSubtractFloat32x4(Value0, Mean0);
+        MLAS_FLOAT32X4 Delta1 = MlasSubtractFloat32x4(Value1, Mean1);
+        Mean0 = MlasMultiplyAddFloat32x4(Delta0, Reciprocal, Mean0);
+        Mean1 = MlasMultiplyAddFloat32x4(Delta1, Reciprocal, Mean1);
+        M2_0 = MlasMultiplyAddFloat32x4(Delta0, MlasSubtractFloat32x4(Value0, Mean0), M2_0);
+        M2_1 = MlasMultiplyAddFloat32x4(Delta1, MlasSubtractFloat32x4(Value1, Mean1), M2_1);
+    }
+
+    //
+    // Combines the lanes with the remaining Count elements of Tail and
+    // returns the mean and the inverse standard deviation of the row.
+    //
+
+    MLAS_FORCEINLINE
+    void
+    Finalize(
+        const float* Tail,
+        size_t Count,
+        size_t N,
+        float Epsilon,
+        float& Mean,
+        float& InverseStdDev
+        )
+    {
+        float RowMean = 0.0f;
+        float RowM2 = 0.0f;
+
+        if (LaneCount > 0) {
+
+            MLAS_FLOAT32X4 LaneMean = MlasMultiplyFloat32x4(MlasAddFloat32x4(Mean0, Mean1), MlasBroadcastFloat32x4(0.5f));
+            RowMean = MlasReduceAddFloat32x4(LaneMean) * 0.25f;
+
+            MLAS_FLOAT32X4 RowMeanVector = MlasBroadcastFloat32x4(RowMean);
+            MLAS_FLOAT32X4 Difference0 = MlasSubtractFloat32x4(Mean0, RowMeanVector);
+            MLAS_FLOAT32X4 Difference1 = MlasSubtractFloat32x4(Mean1, RowMeanVector);
+            MLAS_FLOAT32X4 Spread = MlasMultiplyFloat32x4(Difference0, Difference0);
+            Spread = MlasMultiplyAddFloat32x4(Difference1, Difference1, Spread);
+
+            RowM2 = MlasReduceAddFloat32x4(MlasAddFloat32x4(M2_0, M2_1)) +
+                    MlasReduceAddFloat32x4(Spread) * float(LaneCount);
+        }
+
+        size_t RowCount = LaneCount * 8;
+
+        for (size_t i = 0; i < Count; i++) {
+            RowCount++;
+            const float Delta = Tail[i] - RowMean;
+            RowMean += Delta / float(RowCount);
+            RowM2 += Delta * (Tail[i] - RowMean);
+        }
+
+        Mean = RowMean;
+        InverseStdDev = 1.0f / std::sqrt(std::max(RowM2 / float(N), 0.0f) + Epsilon);
+    }
+};
+
+template<>
+struct MLAS_LAYERNORM_ACCUMULATOR<true>
+{
+    MLAS_FLOAT32X4 SumSquares0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquares1 = MlasZeroFloat32x4();
+
+    MLAS_FORCEINLINE
+    void
+    Update(
+        MLAS_FLOAT32X4 Value0,
+        MLAS_FLOAT32X4 Value1
+        )
+    {
+        SumSquares0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquares0);
+        SumSquares1 = MlasMultiplyAddFloat32x4(Value1, Value1, SumSquares1);
+    }
+
+    MLAS_FORCEINLINE
+    void
+    Finalize(
+        const float* Tail,
+        size_t Count,
+        size_t N,
+        float Epsilon,
+        float& Mean,
+        float& InverseStdDev
+        )
+    {
+        float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquares0, SumSquares1));
+
+        for (size_t i = 0; i < Count; i++) {
+            SumSquares += Tail[i] * Tail[i];
+        }
+
+        Mean = 0.0f;
+        InverseStdDev = 1.0f / std::sqrt(SumSquares / float(N) + Epsilon);
+    }
+};
+
+//
+// Computes Output = Input + Skip + Bias when either addend is present,
+// optionally storing the sum to SkipOutput, and accumulates the statistics
+// of the row. Returns the row that is to be normalized.
+//
+
+template<bool Simplified>
+const float*
+MlasLayerNormAccumulate(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float& Mean,
+    float& InverseStdDev
+    )
+{
+    MLAS_LAYERNORM_ACCUMULATOR<Simplified> Accumulator;
+
+    const bool HasAddends = (Skip != nullptr || Bias != nullptr);
+    const float* Row = HasAddends ? Output : Input;
+    size_t n = 0;
+
+    for (; n + 8 <= N; n += 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLoadFloat32x4(Input + n);
+        MLAS_FLOAT32X4 Value1 = MlasLoadFloat32x4(Input + n + 4);
+
+        if (HasAddends) {
+
+            if (Skip != nullptr) {
+                Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Skip + n));
+                Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(Skip + n + 4));
+            }
+
+            if (Bias != nullptr) {
+                Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Bias + n));
+                Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(Bias + n + 4));
+            }
+
+            MlasStoreFloat32x4(Output + n, Value0);
+            MlasStoreFloat32x4(Output + n + 4, Value1);
+
+            if (SkipOutput != nullptr) {
+                MlasStoreFloat32x4(SkipOutput + n, Value0);
+                MlasStoreFloat32x4(SkipOutput + n + 4, Value1);
+            }
+        }
+
+        Accumulator.Update(Value0, Value1);
+    }
+
+    if (HasAddends) {
+
+        for (size_t i = n; i < N; i++) {
+
+            float Value = Input[i];
+
+            if (Skip != nullptr) {
+                Value += Skip[i];
+            }
+
+            if (Bias != nullptr) {
+                Value += Bias[i];
+            }
+
+            Output[i] = Value;
+
+            if (SkipOutput != nullptr) {
+                SkipOutput[i] = Value;
+            }
+        }
+    }
+
+    Accumulator.Finalize(Row + n, N - n, N, Epsilon, Mean, InverseStdDev);
+
+    return Row;
+}
+
+//
+// Computes Output = (Input - Mean) * InverseStdDev * Gamma + Beta.
+//
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormApply(
+    const float* Input,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Mean,
+    float InverseStdDev
+    )
+{
+    MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    MLAS_FLOAT32X4 InverseStdDevVector = MlasBroadcastFloat32x4(InverseStdDev);
+
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Normalized =
+            MlasMultiplyFloat32x4(MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + n), MeanVector), InverseStdDevVector);
+
+        if (Beta != nullptr) {
+            Normalized = MlasMultiplyAddFloat32x4(Normalized, MlasLoadFloat32x4(Gamma + n), MlasLoadFloat32x4(Beta + n));
+        } else {
+            Normalized = MlasMultiplyFloat32x4(Normalized, MlasLoadFloat32x4(Gamma + n));
+        }
+
+        MlasStoreFloat32x4(Output + n, Normalized);
+    }
+
+    for (; n < N; n++) {
+
+        float Normalized = (Input[n] - Mean) * InverseStdDev * Gamma[n];
+
+        if (Beta != nullptr) {
+            Normalized += Beta[n];
+        }
+
+        Output[n] = Normalized;
+    }
+}
+
+template<bool Simplified>
+void
+MlasLayerNormalizationRow(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InverseStdDev
+    )
+{
+    float RowMean;
+    float RowInverseStdDev;
+
+    const float* Row = MlasLayerNormAccumulate<Simplified>(
+        Input, Skip, Bias, Output, SkipOutput, N, Epsilon, RowMean, RowInverseStdDev);
+
+    MlasLayerNormApply(Row, Gamma, Simplified ? nullptr : Beta, Output, N, RowMean, RowInverseStdDev);
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+
+    if (InverseStdDev != nullptr) {
+        *InverseStdDev = RowInverseStdDev;
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InverseStdDev
+    )
+{
+    if (Simplified) {
+        MlasLayerNormalizationRow<true>(
+            Input, Skip, Bias, Gamma, Beta, Output, SkipOutput, N, Epsilon, Mean, InverseStdDev);
+    } else {
+        MlasLayerNormalizationRow<false>(
+            Input, Skip, Bias, Gamma, Beta, Output, SkipOutput, N, Epsilon, Mean, InverseStdDev);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormConvertFp16(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(Source), Destination, Count);
+}
+
+void
+MLASCALL
+MlasLayerNormalizationFp16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const MLAS_FP16* Bias,
+    const MLAS_FP16* Gamma,
+    const MLAS_FP16* Beta,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InverseStdDev
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float InputBlock[MlasLayerNormFp16BlockSize], 64);
+    MLAS_DECLSPEC_ALIGN(float AddendBlock[MlasLayerNormFp16BlockSize], 64);
+    MLAS_DECLSPEC_ALIGN(float GammaBlock[MlasLayerNormFp16BlockSize], 64);
+    MLAS_DECLSPEC_ALIGN(float BetaBlock[MlasLayerNormFp16BlockSize], 64);
+
+    //
+    // The row is kept in fp32 between the two passes, so the sum of the input,
+    // skip and bias is only rounded to half precision for SkipOutput.
+    //
+
+    MlasThreadedBufAlloc(N * sizeof(float));
+    float* Row = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+    for (size_t n = 0; n < N; n += MlasLayerNormFp16BlockSize) {
+
+        const size_t Count = std::min(N - n, MlasLayerNormFp16BlockSize);
+        MlasLayerNormConvertFp16(Input + n, Row + n, Count);
+
+        if (Skip != nullptr) {
+            MlasLayerNormConvertFp16(Skip + n, AddendBlock, Count);
+            for (size_t i = 0; i < Count; i++) {
+                Row[n + i] += AddendBlock[i];
+            }
+        }
+
+        if (Bias != nullptr) {
+            MlasLayerNormConvertFp16(Bias + n, AddendBlock, Count);
+            for (size_t i = 0; i < Count; i++) {
+                Row[n + i] += AddendBlock[i];
+            }
+        }
+
+        if (SkipOutput != nullptr) {
+            for (size_t i = 0; i < Count; i++) {
+                SkipOutput[n + i] = MLAS_FP16(Row[n + i]);
+            }
+        }
+    }
+
+    float RowMean;
+    float RowInverseStdDev;
+
+    if (Simplified) {
+        MlasLayerNormAccumulate<true>(Row, nullptr, nullptr, nullptr, nullptr, N, Epsilon, RowMean, RowInverseStdDev);
+    } else {
+        MlasLayerNormAccumulate<false>(Row, nullptr, nullptr, nullptr, nullptr, N, Epsilon, RowMean, RowInverseStdDev);
+    }
+
+    for (size_t n = 0; n < N; n += MlasLayerNormFp16BlockSize) {
+
+        const size_t Count = std::min(N - n, MlasLayerNormFp16BlockSize);
+        const bool HasBeta = (Beta != nullptr && !Simplified);
+
+        MlasLayerNormConvertFp16(Gamma + n, GammaBlock, Count);
+
+        if (HasBeta) {
+            MlasLayerNormConvertFp16(Beta + n, BetaBlock, Count);
+        }
+
+        MlasLayerNormApply(Row + n, GammaBlock, HasBeta ? BetaBlock : nullptr, InputBlock, Count, RowMean,
+                           RowInverseStdDev);
+
+        for (size_t i = 0; i < Count; i++) {
+            Output[n + i] = MLAS_FP16(InputBlock[i]);
+        }
+    }
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+
+    if (InverseStdDev != nullptr) {
+        *InverseStdDev = RowInverseStdDev;
+    }
+}
@@ -59,6 +59,10 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -80,6 +84,7 @@ MLASCPUIDInfo::MLASCPUIDInfo()
     has_fp16_ = has_arm_neon_dot_;
 
     has_arm_neon_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_I8MM) != 0);
+    has_arm_sve_ = ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0);
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
@@ -452,6 +457,17 @@ Return Value:
                         this->FpQ4GemmDispatch = &MlasFpQ4GemmDispatchAvx512;
                         this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512;
 
+#if defined(MLAS_USE_AVX512FP16)
+                        //
+                        // Check if the processor supports AVX512-FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif
+
                         //
                         // Check if the processor supports AVX512VNNI.
                         //
@@ -481,6 +497,19 @@ Return Value:
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
                     }
                 }
+
+                //
+                // Check if the processor supports AMX-TILE, AMX-BF16 and
+                // AVX512-BF16 features.
+                //
+                if ((Cpuid7[3] & 0b1 << 24) != 0 &&
+                    (Cpuid7[3] & 0b1 << 22) != 0 &&
+                    (Cpuid7_1[0] & 0x20) != 0 &&
+                    (xcr0 & XFEATURE_MASK_XTILE) == XFEATURE_MASK_XTILE) {
+                    if (MlasInitAMX()) {
+                        this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
+                    }
+                }
 #endif // __APPLE__
 
 #endif // ORT_MINIMAL_BUILD
@@ -503,6 +532,24 @@ Return Value:
     this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchNeon;
     this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchNeon;
 
+    this->GemmFloatKernelZero = MlasSgemmKernelZero;
+    this->GemmFloatKernelAdd = MlasSgemmKernelAdd;
+    this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
+    this->LogisticKernelRoutine = MlasLogisticKernel;
+    this->TanhKernelRoutine = MlasTanhKernel;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
+    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
+
+    this->ConvNchwFloatKernel = MlasConvNchwFloatKernelNeon;
+    this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelNeon;
+    this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelNeon;
+    this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelNeon;
+    this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelNeon;
+    this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelNeon;
+    this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelNeon;
+    this->NchwcBlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+
     //
     // Check if the processor supports ASIMD dot product instructions.
     //
@@ -544,6 +591,28 @@ Return Value:
         this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
+
+        // MlasSQNBitGemmDispatchNeonI8mm falls back to the dot product kernel for odd sized tiles
+        if (HasDotProductInstructions) {
+            this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchNeonI8mm;
+        }
+    }
+#endif
+
+#if defined(MLAS_USE_SVE)
+    //
+    // Check if the processor supports SVE instructions. The SVE kernels are
+    // vector length agnostic and use the full width of the vectors.
+    //
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmSVE()) {
+        this->GemmFloatKernelZero = MlasSgemmKernelZeroSve;
+        this->GemmFloatKernelAdd = MlasSgemmKernelAddSve;
+        this->ComputeExpF32Kernel = MlasComputeExpF32KernelSve;
+        this->LogisticKernelRoutine = MlasLogisticKernelSve;
+        this->TanhKernelRoutine = MlasTanhKernelSve;
+        this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelSve;
+        this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32KernelSve;
+        this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelSve;
     }
 #endif
 
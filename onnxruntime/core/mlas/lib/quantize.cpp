@@ -20,6 +20,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <cstring>
+
 #if defined(MLAS_NEON64_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS) || \
     defined(MLAS_LSX_INTRINSICS)
 
@@ -2119,3 +2121,373 @@ Return Value:
     MlasReduceMinimumMaximumF32Kernel(Input, Min, Max, N);
 #endif
 }
+
+//
+// Define the minimum number of elements dequantized by each thread.
+//
+
+constexpr size_t MlasDequantizeLinearThreadElements = 65536;
+
+template<typename InputType>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasDequantizeLinearWiden4(
+    const InputType* Input
+    )
+/*++
+
+Routine Description:
+
+    This routine loads 4 quantized values and widens them to 32-bit integers.
+
+Arguments:
+
+    Input - Supplies the quantized values.
+
+Return Value:
+
+    Returns the widened values.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    const __m128i ZeroVector = _mm_setzero_si128();
+
+    if constexpr (sizeof(InputType) == 1) {
+        int32_t Packed;
+        memcpy(&Packed, Input, sizeof(Packed));
+        __m128i Vector = _mm_cvtsi32_si128(Packed);
+        if constexpr (std::is_signed_v<InputType>) {
+            Vector = _mm_unpacklo_epi8(Vector, Vector);
+            return _mm_srai_epi32(_mm_unpacklo_epi16(Vector, Vector), 24);
+        } else {
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(Vector, ZeroVector), ZeroVector);
+        }
+    } else {
+        __m128i Vector = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Input));
+        if constexpr (std::is_signed_v<InputType>) {
+            return _mm_srai_epi32(_mm_unpacklo_epi16(Vector, Vector), 16);
+        } else {
+            return _mm_unpacklo_epi16(Vector, ZeroVector);
+        }
+    }
+#elif defined(MLAS_NEON64_INTRINSICS)
+    if constexpr (sizeof(InputType) == 1) {
+        uint32_t Packed;
+        memcpy(&Packed, Input, sizeof(Packed));
+        const uint8x8_t Vector = vreinterpret_u8_u32(vdup_n_u32(Packed));
+        if constexpr (std::is_signed_v<InputType>) {
+            return vmovl_s16(vget_low_s16(vmovl_s8(vreinterpret_s8_u8(Vector))));
+        } else {
+            return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(Vector))));
+        }
+    } else {
+        if constexpr (std::is_signed_v<InputType>) {
+            return vmovl_s16(vld1_s16(Input));
+        } else {
+            return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(Input)));
+        }
+    }
+#else
+    const int32_t Values[4] = {int32_t(Input[0]), int32_t(Input[1]), int32_t(Input[2]), int32_t(Input[3])};
+    return MlasLoadInt32x4(Values);
+#endif
+}
+
+template<typename InputType>
+void
+MlasDequantizeLinearRow(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a row of values that share a scale and a zero
+    point.
+
+Arguments:
+
+    Input - Supplies the quantized values.
+
+    Output - Supplies the dequantized values.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const MLAS_INT32X4 ZeroPointVector = MlasBroadcastInt32x4(ZeroPoint);
+
+    while (N >= 8) {
+
+        MLAS_INT32X4 IntegerVector0 = MlasDequantizeLinearWiden4(Input);
+        MLAS_INT32X4 IntegerVector1 = MlasDequantizeLinearWiden4(Input + 4);
+
+        IntegerVector0 = MlasSubtractInt32x4(IntegerVector0, ZeroPointVector);
+        IntegerVector1 = MlasSubtractInt32x4(IntegerVector1, ZeroPointVector);
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasCastToFloat32x4(IntegerVector0), ScaleVector));
+        MlasStoreFloat32x4(Output + 4, MlasMultiplyFloat32x4(MlasCastToFloat32x4(IntegerVector1), ScaleVector));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N >= 4) {
+
+        MLAS_INT32X4 IntegerVector = MlasDequantizeLinearWiden4(Input);
+        IntegerVector = MlasSubtractInt32x4(IntegerVector, ZeroPointVector);
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasCastToFloat32x4(IntegerVector), ScaleVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = float(int32_t(Input[n]) - ZeroPoint) * Scale;
+    }
+}
+
+template<typename InputType>
+void
+MlasDequantizeLinearColumns(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    const float* Scale,
+    const InputType* ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a row of values where each value has its own
+    scale and zero point.
+
+Arguments:
+
+    Input - Supplies the quantized values.
+
+    Output - Supplies the dequantized values.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scales.
+
+    ZeroPoint - Optionally supplies the quantization zero points.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_INT32X4 IntegerVector = MlasDequantizeLinearWiden4(Input + n);
+
+        if (ZeroPoint != nullptr) {
+            IntegerVector = MlasSubtractInt32x4(IntegerVector, MlasDequantizeLinearWiden4(ZeroPoint + n));
+        }
+
+        MlasStoreFloat32x4(Output + n,
+                           MlasMultiplyFloat32x4(MlasCastToFloat32x4(IntegerVector), MlasLoadFloat32x4(Scale + n)));
+    }
+
+    for (; n < N; n++) {
+        const int32_t zp = (ZeroPoint != nullptr) ? int32_t(ZeroPoint[n]) : 0;
+        Output[n] = float(int32_t(Input[n]) - zp) * Scale[n];
+    }
+}
+
+template<typename InputType>
+void
+MLASCALL
+MlasDequantizeLinear(
+    const InputType* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const InputType* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a tensor with per-tensor, per-axis or blocked
+    quantization parameters.
+
+    The elements are partitioned across threads in contiguous ranges. Each
+    range is processed in segments that share either a single scale and zero
+    point or a contiguous vector of scales and zero points.
+
+Arguments:
+
+    See the declaration in mlas.h.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t KN = K * N;
+    const size_t TotalElements = M * KN;
+
+    if (TotalElements == 0) {
+        return;
+    }
+
+    const size_t BlockCountK = (BlockSize != 0) ? (K + BlockSize - 1) / BlockSize : 0;
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(TotalElements / MlasDequantizeLinearThreadElements) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t Index;
+        size_t Remaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TotalElements, &Index, &Remaining);
+
+        while (Remaining > 0) {
+
+            const size_t m = Index / KN;
+            const size_t k = (Index / N) % K;
+            const size_t n = Index % N;
+
+            size_t Count;
+
+            if (N > 1) {
+
+                //
+                // The segment is the rest of the row of the inner dimensions.
+                //
+
+                Count = std::min(N - n, Remaining);
+
+                if (BlockSize == 0) {
+                    const int32_t zp = (ZeroPoint != nullptr) ? int32_t(ZeroPoint[k]) : 0;
+                    MlasDequantizeLinearRow(Input + Index, Output + Index, Count, Scale[k], zp);
+                } else {
+                    const size_t ParameterIndex = (m * BlockCountK + k / BlockSize) * N + n;
+                    MlasDequantizeLinearColumns(Input + Index, Output + Index, Count, Scale + ParameterIndex,
+                                                ZeroPoint != nullptr ? ZeroPoint + ParameterIndex : nullptr);
+                }
+
+            } else if (BlockSize == 0) {
+
+                //
+                // The quantized axis is contiguous and each element has its
+                // own scale.
+                //
+
+                Count = std::min(K - k, Remaining);
+                MlasDequantizeLinearColumns(Input + Index, Output + Index, Count, Scale + k,
+                                            ZeroPoint != nullptr ? ZeroPoint + k : nullptr);
+
+            } else {
+
+                //
+                // The quantized axis is contiguous and the segment is the rest
+                // of the block.
+                //
+
+                Count = std::min(std::min(BlockSize - k % BlockSize, K - k), Remaining);
+
+                const size_t ParameterIndex = m * BlockCountK + k / BlockSize;
+                const int32_t zp = (ZeroPoint != nullptr) ? int32_t(ZeroPoint[ParameterIndex]) : 0;
+                MlasDequantizeLinearRow(Input + Index, Output + Index, Count, Scale[ParameterIndex], zp);
+            }
+
+            Index += Count;
+            Remaining -= Count;
+        }
+    });
+}
+
+template
+void
+MLASCALL
+MlasDequantizeLinear<int8_t>(
+    const int8_t* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const int8_t* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasDequantizeLinear<uint8_t>(
+    const uint8_t* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const uint8_t* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasDequantizeLinear<int16_t>(
+    const int16_t* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const int16_t* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasDequantizeLinear<uint16_t>(
+    const uint16_t* Input,
+    float* Output,
+    size_t M,
+    size_t K,
+    size_t N,
+    size_t BlockSize,
+    const float* Scale,
+    const uint16_t* ZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
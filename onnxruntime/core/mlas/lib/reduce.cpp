@@ -0,0 +1,517 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements the sum, minimum and maximum reductions of a
+    tensor viewed as [OuterCount, ReduceCount, InnerCount] along the middle
+    axis.
+
+    If InnerCount is one, the reduced axis is contiguous and each row is
+    reduced with vector accumulators. Otherwise, the rows of the reduced axis
+    are combined a block of columns at a time, so the block of the output
+    stays in the cache while the rows stream through it.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of columns of the output combined at a time when the reduced axis
+// isn't contiguous. This is also the number of elements of a half precision
+// row converted to fp32 at a time.
+//
+
+constexpr size_t MlasReduceBlockSize = 1024;
+
+//
+// Number of rows of the reduced axis combined with a block of the output per
+// pass over the block.
+//
+
+constexpr size_t MlasReduceRowBlockSize = 32;
+
+//
+// Minimum number of input elements processed by each thread.
+//
+
+constexpr size_t MlasReduceThreadElements = 16384;
+
+struct MLAS_REDUCE_SUM {
+
+    static float Identity() { return 0.0f; }
+
+    static float Combine(float Value1, float Value2) { return Value1 + Value2; }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceAddFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_MINIMUM {
+
+    static float Identity() { return std::numeric_limits<float>::infinity(); }
+
+    static float Combine(float Value1, float Value2) { return std::min(Value1, Value2); }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMinimumFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_MAXIMUM {
+
+    static float Identity() { return -std::numeric_limits<float>::infinity(); }
+
+    static float Combine(float Value1, float Value2) { return std::max(Value1, Value2); }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMaximumFloat32x4(Vector); }
+};
+
+template<typename Operator>
+float
+MlasReduceContiguous(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a contiguous row of elements.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    N - Supplies the number of elements of the row.
+
+Return Value:
+
+    Returns the reduction of the row.
+
+--*/
+{
+    float Value = Operator::Identity();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasBroadcastFloat32x4(Value);
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 Accumulator1 = Accumulator0;
+            MLAS_FLOAT32X4 Accumulator2 = Accumulator0;
+            MLAS_FLOAT32X4 Accumulator3 = Accumulator0;
+
+            while (N >= 16) {
+
+                Accumulator0 = Operator::Combine(Accumulator0, MlasLoadFloat32x4(Input));
+                Accumulator1 = Operator::Combine(Accumulator1, MlasLoadFloat32x4(Input + 4));
+                Accumulator2 = Operator::Combine(Accumulator2, MlasLoadFloat32x4(Input + 8));
+                Accumulator3 = Operator::Combine(Accumulator3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            Accumulator0 = Operator::Combine(Accumulator0, Accumulator1);
+            Accumulator2 = Operator::Combine(Accumulator2, Accumulator3);
+            Accumulator0 = Operator::Combine(Accumulator0, Accumulator2);
+        }
+
+        while (N >= 4) {
+
+            Accumulator0 = Operator::Combine(Accumulator0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Value = Operator::Reduce(Accumulator0);
+    }
+
+    while (N > 0) {
+
+        Value = Operator::Combine(Value, *Input++);
+        N -= 1;
+    }
+
+    return Value;
+}
+
+template<typename Operator>
+void
+MlasReduceRows(
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowStride,
+    size_t CountN,
+    bool Accumulate
+    )
+/*++
+
+Routine Description:
+
+    This routine combines the corresponding columns of a block of rows.
+
+Arguments:
+
+    Input - Supplies the first row of the block.
+
+    Output - Supplies the output block of CountN elements.
+
+    RowCount - Supplies the number of rows of the block.
+
+    RowStride - Supplies the number of elements between the rows.
+
+    CountN - Supplies the number of columns of the block.
+
+    Accumulate - Supplies true if the rows are combined with the existing
+        contents of the output, else false if the output is overwritten.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t n = 0;
+
+    for (; n + 8 <= CountN; n += 8) {
+
+        const float* input = Input + n;
+
+        MLAS_FLOAT32X4 Accumulator0;
+        MLAS_FLOAT32X4 Accumulator1;
+        size_t r = 0;
+
+        if (Accumulate) {
+            Accumulator0 = MlasLoadFloat32x4(Output + n);
+            Accumulator1 = MlasLoadFloat32x4(Output + n + 4);
+        } else {
+            Accumulator0 = MlasLoadFloat32x4(input);
+            Accumulator1 = MlasLoadFloat32x4(input + 4);
+            input += RowStride;
+            r = 1;
+        }
+
+        for (; r < RowCount; r++) {
+            Accumulator0 = Operator::Combine(Accumulator0, MlasLoadFloat32x4(input));
+            Accumulator1 = Operator::Combine(Accumulator1, MlasLoadFloat32x4(input + 4));
+            input += RowStride;
+        }
+
+        MlasStoreFloat32x4(Output + n, Accumulator0);
+        MlasStoreFloat32x4(Output + n + 4, Accumulator1);
+    }
+
+    for (; n < CountN; n++) {
+
+        const float* input = Input + n;
+
+        float Value = Accumulate ? Output[n] : Operator::Identity();
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Value = Operator::Combine(Value, *input);
+            input += RowStride;
+        }
+
+        Output[n] = Value;
+    }
+}
+
+template<typename Operator>
+void
+MlasReduceWorkItems(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t WorkIndex,
+    size_t WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a range of work items. A work item is a row of the
+    outer axis if the reduced axis is contiguous, else a block of columns of
+    a row of the outer axis.
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ReduceCount - Supplies the number of elements of the reduced axis.
+
+    InnerCount - Supplies the number of elements of the inner axes.
+
+    WorkIndex - Supplies the first work item to reduce.
+
+    WorkRemaining - Supplies the number of work items to reduce.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (InnerCount == 1) {
+
+        for (size_t o = WorkIndex; o < WorkIndex + WorkRemaining; o++) {
+            Output[o] = MlasReduceContiguous<Operator>(Input + o * ReduceCount, ReduceCount);
+        }
+
+        return;
+    }
+
+    const size_t BlockCountN = (InnerCount + MlasReduceBlockSize - 1) / MlasReduceBlockSize;
+
+    for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+        const size_t o = w / BlockCountN;
+        const size_t n = (w % BlockCountN) * MlasReduceBlockSize;
+        const size_t CountN = std::min(InnerCount - n, MlasReduceBlockSize);
+
+        const float* input = Input + o * ReduceCount * InnerCount + n;
+        float* output = Output + o * InnerCount + n;
+
+        for (size_t r = 0; r < ReduceCount; r += MlasReduceRowBlockSize) {
+
+            const size_t RowCount = std::min(ReduceCount - r, MlasReduceRowBlockSize);
+
+            MlasReduceRows<Operator>(input + r * InnerCount, output, RowCount, InnerCount, CountN, r > 0);
+        }
+    }
+}
+
+template<typename Operator>
+void
+MlasReduceWorkItemsFp16(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t WorkIndex,
+    size_t WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a range of work items of a half precision tensor.
+    The elements are converted to fp32 a block at a time and the reduction
+    is accumulated in fp32.
+
+Arguments:
+
+    See MlasReduceWorkItems.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float InputBlock[MlasReduceBlockSize], 64);
+    MLAS_DECLSPEC_ALIGN(float OutputBlock[MlasReduceBlockSize], 64);
+
+    if (InnerCount == 1) {
+
+        for (size_t o = WorkIndex; o < WorkIndex + WorkRemaining; o++) {
+
+            const MLAS_FP16* input = Input + o * ReduceCount;
+            float Value = Operator::Identity();
+
+            for (size_t r = 0; r < ReduceCount; r += MlasReduceBlockSize) {
+
+                const size_t CountR = std::min(ReduceCount - r, MlasReduceBlockSize);
+
+                MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(input + r), InputBlock, CountR);
+                Value = Operator::Combine(Value, MlasReduceContiguous<Operator>(InputBlock, CountR));
+            }
+
+            Output[o] = MLAS_FP16(Value);
+        }
+
+        return;
+    }
+
+    const size_t BlockCountN = (InnerCount + MlasReduceBlockSize - 1) / MlasReduceBlockSize;
+
+    for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+        const size_t o = w / BlockCountN;
+        const size_t n = (w % BlockCountN) * MlasReduceBlockSize;
+        const size_t CountN = std::min(InnerCount - n, MlasReduceBlockSize);
+
+        const MLAS_FP16* input = Input + o * ReduceCount * InnerCount + n;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+
+            MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(input + r * InnerCount), InputBlock,
+                                         CountN);
+            MlasReduceRows<Operator>(InputBlock, OutputBlock, 1, CountN, CountN, r > 0);
+        }
+
+        MLAS_FP16* output = Output + o * InnerCount + n;
+
+        for (size_t i = 0; i < CountN; i++) {
+            output[i] = MLAS_FP16(OutputBlock[i]);
+        }
+    }
+}
+
+template<typename T, typename Operator>
+void
+MlasReduceOperation(
+    const T* Input,
+    T* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine partitions the work items of a reduction across threads.
+
+Arguments:
+
+    See MlasReduce.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OuterCount == 0 || InnerCount == 0) {
+        return;
+    }
+
+    if (ReduceCount == 0) {
+        std::fill_n(Output, OuterCount * InnerCount, T(Operator::Identity()));
+        return;
+    }
+
+    const size_t BlockCountN = (InnerCount == 1) ? 1 :
+        (InnerCount + MlasReduceBlockSize - 1) / MlasReduceBlockSize;
+    const size_t WorkCount = OuterCount * BlockCountN;
+
+    //
+    // Compute the number of target threads given the number of input
+    // elements. Small reductions run on a single thread.
+    //
+
+    const double Complexity = double(OuterCount) * double(ReduceCount) * double(InnerCount);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MlasReduceThreadElements)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        if constexpr (std::is_same_v<T, float>) {
+            MlasReduceWorkItems<Operator>(Input, Output, ReduceCount, InnerCount, WorkIndex, WorkRemaining);
+        } else {
+            MlasReduceWorkItemsFp16<Operator>(Input, Output, ReduceCount, InnerCount, WorkIndex, WorkRemaining);
+        }
+    });
+}
+
+template<typename T>
+void
+MlasReduceDispatch(
+    MLAS_REDUCE_KIND Kind,
+    const T* Input,
+    T* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    switch (Kind) {
+
+        case MlasReduceSum:
+            MlasReduceOperation<T, MLAS_REDUCE_SUM>(Input, Output, OuterCount, ReduceCount, InnerCount, ThreadPool);
+            break;
+
+        case MlasReduceMinimum:
+            MlasReduceOperation<T, MLAS_REDUCE_MINIMUM>(Input, Output, OuterCount, ReduceCount, InnerCount,
+                                                        ThreadPool);
+            break;
+
+        case MlasReduceMaximum:
+            MlasReduceOperation<T, MLAS_REDUCE_MAXIMUM>(Input, Output, OuterCount, ReduceCount, InnerCount,
+                                                        ThreadPool);
+            break;
+    }
+}
+
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCE_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasReduceDispatch(Kind, Input, Output, OuterCount, ReduceCount, InnerCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReduceFp16(
+    MLAS_REDUCE_KIND Kind,
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasReduceDispatch(Kind, Input, Output, OuterCount, ReduceCount, InnerCount, ThreadPool);
+}
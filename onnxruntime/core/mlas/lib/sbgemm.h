@@ -30,8 +30,6 @@ Abstract:
         MLAS_SBGEMM_STRIDES Strides{128, 128, 256};
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #pragma once
 
 #include <cassert>
@@ -39,6 +37,13 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+#if defined(MLAS_TARGET_AMD64)
+// bfloat16 values are stored as the upper 16 bits of the fp32 encoding.
+typedef uint16_t bfloat16_t;
+#endif
+
 /**
  * @brief Define the default striding parameters for
  *        the bfloat16 precision gemm operation
@@ -283,7 +288,9 @@ struct MLAS_SBGEMM_DISPATCH {
     size_t BufOverRead;
 };
 
+#if defined(MLAS_TARGET_ARM64)
 extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+#endif
 
 MLAS_FORCEINLINE
 const MLAS_SBGEMM_DISPATCH*
@@ -291,6 +298,8 @@ MlasSBGemmGetDispatch()
 {
 #if defined(MLAS_TARGET_ARM64)
     return &MlasSBGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().SBGemmDispatch;
 #else
     std::cerr << "SBGemm Kernel is supported only on ARM64 platform.";
     exit(1);
@@ -396,4 +405,4 @@ MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t Bat
         }
     );
 }
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
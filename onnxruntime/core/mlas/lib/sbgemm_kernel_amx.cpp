@@ -0,0 +1,403 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AMX.
+
+    Matrix A is converted to bfloat16 a panel of rows at a time and matrix B
+    is packed into 16 column blocks in the VNNI layout expected by the tile
+    dot product instruction: each pair of rows along the K dimension is
+    interleaved, and the K dimension is padded to 32 elements per tile.
+
+    This module must be compiled with AVX512-BF16 support (e.g. -mavx512bf16)
+    and is only used when the processor reports AMX-BF16 support at runtime.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+#include "amx_common.h"
+
+#include <atomic>
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 32
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 2 * TILE_M;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = TILE_K;
+    static constexpr size_t PackedN = TILE_N;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{2 * TILE_M, 256, 256};  // M:N:K
+};
+
+bool MLASCALL
+MlasBf16AccelerationSupported()
+{
+    return GetMlasPlatform().SBGemmDispatch != nullptr;
+}
+
+//
+// The tile intrinsics are emitted as opaque assembly, so the compiler must not
+// move the accesses of the buffers they read or write across them.
+//
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmAmxCompilerBarrier()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmAmxLoadTileConfig()
+{
+    struct tileconfig_t current_tc = {0};
+    tile_storeconfig(&current_tc);
+    MlasSBGemmAmxCompilerBarrier();
+
+    bool configured = (current_tc.palette_id == 1);
+    for (int t = 0; configured && t < 8; t++) {
+        configured = (current_tc.rows[t] == TILE_M) && (current_tc.colb[t] == 64);
+    }
+
+    if (!configured) {
+        struct tileconfig_t tc = {0};
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = TILE_M;
+            tc.colb[t] = 64;
+        }
+        MlasSBGemmAmxCompilerBarrier();
+        tile_loadconfig(&tc);
+    }
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasSBGemmAmxPaddedK(size_t CountK)
+{
+    return (CountK + TILE_K - 1) & ~(TILE_K - 1);
+}
+
+/*
+    This routine converts fp32 to bf16 and copies a slice of rows from the
+    source matrix to the destination packed buffer.
+
+    Each block of 16 columns is stored as PaddedK / 2 rows of 16 pairs of
+    elements from consecutive rows. The remaining rows and columns are padded
+    with zeroes.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertCopyPackBAmx(bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    const size_t PaddedK = MlasSBGemmAmxPaddedK(CountK);
+
+    //
+    // Interleave the elements of the two rows converted by _mm512_cvtne2ps_pbh
+    // to form the pairs along the K dimension.
+    //
+    const __m512i InterleaveIndex = _mm512_set_epi16(
+        31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8,
+        23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0
+    );
+
+    for (size_t n = 0; n < CountN; n += TILE_N) {
+        const size_t ColumnsRemaining = std::min(CountN - n, size_t(TILE_N));
+        const __mmask16 ColumnMask = __mmask16((1u << ColumnsRemaining) - 1);
+
+        const float* b = B + n;
+
+        for (size_t k = 0; k < PaddedK; k += 2) {
+            const __m512 Row0 = (k < CountK) ? _mm512_maskz_loadu_ps(ColumnMask, b) : _mm512_setzero_ps();
+            const __m512 Row1 = (k + 1 < CountK) ? _mm512_maskz_loadu_ps(ColumnMask, b + ldb) : _mm512_setzero_ps();
+
+            const __m512i Pairs = _mm512_permutexvar_epi16(
+                InterleaveIndex, (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0)
+            );
+            _mm512_storeu_si512(D, Pairs);
+
+            D += 2 * TILE_N;
+            b += 2 * ldb;
+        }
+    }
+}
+
+/*
+    This routine converts fp32 to bf16 and copies a panel of rows of matrix A
+    to a buffer with a leading dimension of PaddedK. The columns past CountK
+    and the rows past CountM up to the tile height are zeroed.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertCopyPackAAmx(bfloat16_t* D, const float* A, size_t lda, size_t CountM, size_t CountK, size_t PaddedK)
+{
+    const size_t PaddedM = (CountM + TILE_M - 1) & ~size_t(TILE_M - 1);
+
+    for (size_t m = 0; m < PaddedM; m++) {
+        bfloat16_t* d = D + m * PaddedK;
+
+        if (m >= CountM) {
+            std::fill_n(d, PaddedK, bfloat16_t(0));
+            continue;
+        }
+
+        const float* a = A + m * lda;
+
+        for (size_t k = 0; k < PaddedK; k += 2 * TILE_N) {
+            const size_t Remaining = (k < CountK) ? (CountK - k) : 0;
+            const __mmask16 Mask0 = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+            const size_t Remaining1 = (Remaining > 16) ? (Remaining - 16) : 0;
+            const __mmask16 Mask1 = (Remaining1 >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining1) - 1);
+
+            const __m512 Low = _mm512_maskz_loadu_ps(Mask0, a + k);
+            const __m512 High = _mm512_maskz_loadu_ps(Mask1, a + k + 16);
+
+            _mm512_storeu_si512(d + k, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    const size_t AlignedN = (CountN + TILE_N - 1) & ~size_t(TILE_N - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+    size_t K_block_size;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackBAmx(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB = PackedB + AlignedN * MlasSBGemmAmxPaddedK(K_block_size);
+    }
+}
+
+/*
+    This routine adds a tile of results to matrix C. The tile is added to the
+    bias or to the existing contents of matrix C depending on ZeroMode.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmAmxAccumulateTile(
+    const float* Tile, float* C, size_t ldc, size_t CountM, size_t CountN, const float* Bias, bool ZeroMode
+)
+{
+    const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+    const __m512 BiasVector = (Bias == nullptr) ? _mm512_setzero_ps() : _mm512_maskz_loadu_ps(Mask, Bias);
+
+    for (size_t m = 0; m < CountM; m++) {
+        __m512 Accumulator = _mm512_loadu_ps(Tile + m * TILE_N);
+        Accumulator = _mm512_add_ps(Accumulator, ZeroMode ? BiasVector : _mm512_maskz_loadu_ps(Mask, C));
+        _mm512_mask_storeu_ps(C, Mask, Accumulator);
+        C += ldc;
+    }
+}
+
+template <>
+void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    const size_t PaddedK = MlasSBGemmAmxPaddedK(CountK);
+    const size_t PackedBlockSize = PaddedK * TILE_N;
+
+    MLAS_DECLSPEC_ALIGN(bfloat16_t PanelA[MLAS_SBGEMM_KERNEL_AMX::KernelMaxM * MLAS_SBGEMM_KERNEL_AMX::Strides.K], 64);
+    MLAS_DECLSPEC_ALIGN(float Tiles[4][TILE_M * TILE_N], 64);
+
+    MlasSBGemmAmxLoadTileConfig();
+
+    while (CountM > 0) {
+        const size_t RowsHandled = std::min(CountM, MLAS_SBGEMM_KERNEL_AMX::KernelMaxM);
+        const bool TwoRowTiles = RowsHandled > TILE_M;
+
+        MlasSBGemmConvertCopyPackAAmx(PanelA, A, lda, RowsHandled, CountK, PaddedK);
+        MlasSBGemmAmxCompilerBarrier();
+
+        const bfloat16_t* b = B;
+
+        for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+            const size_t ColumnsHandled = std::min(CountN - n, size_t(2 * TILE_N));
+            const bool TwoColumnTiles = ColumnsHandled > TILE_N;
+
+            tile_zero(TMM0);
+            tile_zero(TMM1);
+            tile_zero(TMM2);
+            tile_zero(TMM3);
+
+            for (size_t k = 0; k < PaddedK; k += TILE_K) {
+                tile_loadd(TMM4, PanelA + k, PaddedK * sizeof(bfloat16_t));
+                tile_loadd(TMM6, b + k * TILE_N, 2 * TILE_N * sizeof(bfloat16_t));
+                tile_dpbf16ps(TMM0, TMM4, TMM6);
+
+                if (TwoColumnTiles) {
+                    tile_loadd(TMM7, b + PackedBlockSize + k * TILE_N, 2 * TILE_N * sizeof(bfloat16_t));
+                    tile_dpbf16ps(TMM1, TMM4, TMM7);
+                }
+
+                if (TwoRowTiles) {
+                    tile_loadd(TMM5, PanelA + TILE_M * PaddedK + k, PaddedK * sizeof(bfloat16_t));
+                    tile_dpbf16ps(TMM2, TMM5, TMM6);
+
+                    if (TwoColumnTiles) {
+                        tile_dpbf16ps(TMM3, TMM5, TMM7);
+                    }
+                }
+            }
+
+            tile_stored(TMM0, Tiles[0], TILE_N * sizeof(float));
+            tile_stored(TMM1, Tiles[1], TILE_N * sizeof(float));
+            tile_stored(TMM2, Tiles[2], TILE_N * sizeof(float));
+            tile_stored(TMM3, Tiles[3], TILE_N * sizeof(float));
+            MlasSBGemmAmxCompilerBarrier();
+
+            const size_t RowsTile0 = std::min(RowsHandled, size_t(TILE_M));
+            const size_t ColumnsTile0 = std::min(ColumnsHandled, size_t(TILE_N));
+            const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+            MlasSBGemmAmxAccumulateTile(Tiles[0], C + n, ldc, RowsTile0, ColumnsTile0, bias, ZeroMode);
+
+            if (TwoColumnTiles) {
+                MlasSBGemmAmxAccumulateTile(Tiles[1], C + n + TILE_N, ldc, RowsTile0, ColumnsHandled - TILE_N,
+                                            (bias == nullptr) ? nullptr : bias + TILE_N, ZeroMode);
+            }
+
+            if (TwoRowTiles) {
+                MlasSBGemmAmxAccumulateTile(Tiles[2], C + TILE_M * ldc + n, ldc, RowsHandled - TILE_M, ColumnsTile0,
+                                            bias, ZeroMode);
+
+                if (TwoColumnTiles) {
+                    MlasSBGemmAmxAccumulateTile(Tiles[3], C + TILE_M * ldc + n + TILE_N, ldc, RowsHandled - TILE_M,
+                                                ColumnsHandled - TILE_N, (bias == nullptr) ? nullptr : bias + TILE_N,
+                                                ZeroMode);
+                }
+            }
+
+            b += 2 * PackedBlockSize;
+        }
+
+        A += lda * RowsHandled;
+        C += ldc * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+//
+// The packed layout pads every slice along the K dimension to the tile depth,
+// so the packed offsets of the shared drivers do not apply.
+//
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmPackedOperation<MLAS_SBGEMM_KERNEL_AMX>(size_t M, size_t RangeStartN, size_t RangeCountN, size_t AlignedN, size_t K, const float* A, size_t lda, const void* PackedB, float* C, size_t ldc, const float* Bias, void* PostProcessor)
+{
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+    size_t PackedStrideN = Strides.N;
+    size_t PackedStrideK = Strides.K;
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+    size_t CountN;
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+        const size_t SliceStartN = RangeStartN + n;
+        CountN = std::min(RangeCountN - n, PackedStrideN);
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+        size_t CountK;
+        for (size_t k = 0; k < K; k += CountK) {
+            bool ZeroMode = (k == 0);
+            CountK = std::min(K - k, PackedStrideK);
+
+            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + MlasSBGemmAmxPaddedK(CountK) * SliceStartN;
+            float* c = C + n;
+            const float* pbias = ((nullptr == Bias) ? nullptr : Bias + RangeStartN + n);
+            MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(M, CountN, CountK, A + k, lda, pb, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
+        }
+        if (PostProcessor != nullptr) {
+            ((MLAS_SBGEMM_POSTPROCESSOR*)PostProcessor)
+                ->Process(C + n, M, SliceStartN, M, CountN, ldc);
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmNonPackedOperation<MLAS_SBGEMM_KERNEL_AMX>(size_t M, size_t N, size_t K, const float* A, size_t lda, const float* B, size_t ldb, float* C, size_t ldc, const float* Bias, void* PostProcessor)
+{
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+    const size_t StrideN = Strides.N;
+    const size_t StrideK = Strides.K;
+
+    constexpr size_t packBSize = UpAlignSize(Strides.N * Strides.K * sizeof(bfloat16_t));
+    MlasThreadedBufAlloc(packBSize);
+    uint8_t* p = ThreadedBufHolder.get();
+    auto* PanelB = reinterpret_cast<bfloat16_t*>(p);
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+    size_t CountN;
+    for (size_t n = 0; n < N; n += CountN) {
+        CountN = std::min(N - n, StrideN);
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+        size_t CountK;
+        for (size_t k = 0; k < K; k += CountK) {
+            CountK = std::min(K - k, StrideK);
+
+            //
+            // Copy a panel of matrix B to a local packed buffer.
+            //
+            MlasSBGemmConvertCopyPackBAmx(PanelB, B + n + k * ldb, ldb, CountN, CountK);
+
+            auto* c = C + n;
+            const float* pbias = ((nullptr == Bias) ? nullptr : Bias + n);
+
+            bool ZeroMode = (k == 0);
+            MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(M, CountN, CountK, A + k, lda, PanelB, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
+        }
+        if (PostProcessor != nullptr) {
+            ((MLAS_SBGEMM_POSTPROCESSOR*)PostProcessor)->Process(C + n, M, N, M, CountN, ldc);
+        }
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0  // kernel never reads beyond buffer end
+};
@@ -17,6 +17,10 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
 //
@@ -1063,6 +1067,12 @@ Return Value:
 
 #if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)
         RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+#elif defined(MLAS_TARGET_ARM64)
+        if (ZeroMode) {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        } else {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelAdd(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        }
 #else
         if (ZeroMode) {
             RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
@@ -1318,6 +1328,147 @@ Return Value:
     }
 }
 
+void
+MlasSgemmPackedGemv(
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t StrideA,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/vector multiply
+    operation for a single row of matrix A and a packed matrix B, as used by
+    the decode step of a transformer model.
+
+    Each block of 16 columns of matrix C is accumulated over all of the slices
+    of packed matrix B along the K dimension before being stored, so matrix C
+    is read and written once and packed matrix B is streamed from memory
+    without the overhead of the general kernel loop.
+
+Arguments:
+
+    RangeStartN - Supplies the starting column from packed matrix B.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the row of matrix A.
+
+    StrideA - Supplies the distance between the elements of the row of matrix
+        A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    AlignedN - Supplies the total number of aligned columns for packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the row of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+    const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(beta);
+
+    for (size_t n = 0; n < RangeCountN; n += 16) {
+
+        const size_t CountN = std::min(RangeCountN - n, size_t(16));
+
+        //
+        // Two sets of accumulators are used to break the dependency chain of
+        // the multiply/add instructions.
+        //
+
+        MLAS_FLOAT32X4 Accumulators[2][4];
+
+        for (size_t i = 0; i < 2; i++) {
+            for (size_t v = 0; v < 4; v++) {
+                Accumulators[i][v] = MlasZeroFloat32x4();
+            }
+        }
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+            const float* a = A + k * StrideA;
+            const float* b = PackedB + AlignedN * k + CountK * (RangeStartN + n);
+            size_t kk = 0;
+
+            for (; kk + 2 <= CountK; kk += 2) {
+
+                MLAS_FLOAT32X4 AElement0 = MlasBroadcastFloat32x4(a);
+                MLAS_FLOAT32X4 AElement1 = MlasBroadcastFloat32x4(a + StrideA);
+
+                for (size_t v = 0; v < 4; v++) {
+                    Accumulators[0][v] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(b + v * 4), AElement0, Accumulators[0][v]);
+                    Accumulators[1][v] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(b + 16 + v * 4), AElement1, Accumulators[1][v]);
+                }
+
+                a += 2 * StrideA;
+                b += 32;
+            }
+
+            if (kk < CountK) {
+
+                MLAS_FLOAT32X4 AElement0 = MlasBroadcastFloat32x4(a);
+
+                for (size_t v = 0; v < 4; v++) {
+                    Accumulators[0][v] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(b + v * 4), AElement0, Accumulators[0][v]);
+                }
+            }
+        }
+
+        //
+        // Apply alpha and beta and store the block of matrix C. The padded
+        // columns of a partial block are computed through a local buffer.
+        //
+
+        MLAS_DECLSPEC_ALIGN(float Output[16], 16);
+        float* c = C + n;
+        float* Destination = (CountN == 16) ? c : Output;
+
+        if (CountN < 16 && beta != 0.0f) {
+            std::copy_n(c, CountN, Output);
+        }
+
+        for (size_t v = 0; v < 4; v++) {
+
+            MLAS_FLOAT32X4 Result = MlasMultiplyFloat32x4(
+                MlasAddFloat32x4(Accumulators[0][v], Accumulators[1][v]), AlphaBroadcast);
+
+            if (beta != 0.0f) {
+                Result = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Destination + v * 4), BetaBroadcast, Result);
+            }
+
+            MlasStoreFloat32x4(Destination + v * 4, Result);
+        }
+
+        if (CountN < 16) {
+            std::copy_n(Output, CountN, c);
+        }
+    }
+}
+
 void
 MlasSgemmPackedOperation(
     CBLAS_TRANSPOSE TransA,
@@ -1380,6 +1531,19 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    //
+    // Handle the special case of a single row of matrix A, which is bound by
+    // the bandwidth of streaming packed matrix B.
+    //
+
+    if (M == 1) {
+
+        MlasSgemmPackedGemv(RangeStartN, RangeCountN, K, alpha, A, (TransA == CblasNoTrans) ? 1 : lda,
+            (const float*)PackedB, AlignedN, beta, C);
+
+        return;
+    }
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
@@ -1453,41 +1617,58 @@ Return Value:
     }
 }
 
-void
-MlasSgemmThreaded(
-    const ptrdiff_t ThreadCountM,
-    const ptrdiff_t ThreadCountN,
-    const CBLAS_TRANSPOSE TransA,
-    const CBLAS_TRANSPOSE TransB,
-    const size_t M,
-    const size_t N,
-    const size_t K,
+//
+// Define the limits of the small matrix path of MlasGemmBatch. Batches of
+// problems within these limits, such as the per head or per expert GEMMs of
+// attention and mixture of experts models, are computed directly from the
+// unpacked matrices with one thread per range of the batch.
+//
 
-    const MLAS_SGEMM_DATA_PARAMS* DataParams,
-    ptrdiff_t ThreadId
+#define MLAS_SGEMM_SMALL_MAXIMUM_M          64
+#define MLAS_SGEMM_SMALL_MAXIMUM_N          64
+#define MLAS_SGEMM_SMALL_MAXIMUM_K          256
+
+template<size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernelNoTransB(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    SGEMM operation.
+    This routine computes a block of RowCount rows and VectorCount * 4 columns
+    of matrix C with matrix B not transposed. The loops over the rows and the
+    vectors of the block are unrolled at compile time.
 
 Arguments:
 
-    ThreadCountM - Supplies the total thread partition on the M dimension.
+    A - Supplies the address of the block of matrix A.
 
-    ThreadCountN - Supplies the total thread partition on the N dimension.
+    lda - Supplies the first dimension of matrix A.
 
-    TransA - Supplies the transpose operation on A matrix
+    B - Supplies the address of the block of matrix B.
 
-    TransB - Supplies the transpose operation on B matrix
+    ldb - Supplies the first dimension of matrix B.
 
-    M, N, K - Supplies the shape of the multiplication
+    C - Supplies the address of the block of matrix C.
 
-    DataParams - Supplies the data position and layout of the matrices
+    ldc - Supplies the first dimension of matrix C.
 
-    ThreadId - Supplies the current index of the threaded operation.
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
 Return Value:
 
@@ -1495,81 +1676,740 @@ Return Value:
 
 --*/
 {
+    MLAS_FLOAT32X4 Accumulators[RowCount][VectorCount];
 
-    const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
-    const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[r][v] = MlasZeroFloat32x4();
+        }
+    }
 
-    //
-    // Partition the operation along the M dimension.
-    //
+    for (size_t k = 0; k < K; k++) {
 
-    size_t RangeStartM;
-    size_t RangeCountM;
+        MLAS_FLOAT32X4 BElements[VectorCount];
 
-    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+        for (size_t v = 0; v < VectorCount; v++) {
+            BElements[v] = MlasLoadFloat32x4(B + k * ldb + v * 4);
+        }
 
-    //
-    // Partition the operation along the N dimension.
-    //
+        for (size_t r = 0; r < RowCount; r++) {
+            MLAS_FLOAT32X4 AElement = MlasBroadcastFloat32x4(A + r * lda + k);
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[r][v] = MlasMultiplyAddFloat32x4(BElements[v], AElement, Accumulators[r][v]);
+            }
+        }
+    }
 
-    size_t RangeStartN;
-    size_t RangeCountN;
+    MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+    MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(beta);
 
-    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            float* c = C + r * ldc + v * 4;
+            MLAS_FLOAT32X4 Result = MlasMultiplyFloat32x4(Accumulators[r][v], AlphaBroadcast);
+            if (beta != 0.0f) {
+                Result = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(c), BetaBroadcast, Result);
+            }
+            MlasStoreFloat32x4(c, Result);
+        }
+    }
+}
 
-    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN,
-        &RangeCountN);
+template<size_t RowCount, size_t ColumnCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernelTransB(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
 
-    RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-    RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+Routine Description:
 
-    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+    This routine computes a block of RowCount rows and ColumnCount columns of
+    matrix C with matrix B transposed. The rows of matrix A and matrix B are
+    both contiguous along K, so each element of the block is accumulated as a
+    vector dot product. The loops over the rows and the columns of the block
+    are unrolled at compile time.
 
-    //
-    // Dispatch the partitioned operation.
-    //
+Arguments:
 
-    const size_t lda = DataParams->lda;
-    const size_t ldc = DataParams->ldc;
+    See MlasSgemmSmallKernelNoTransB.
 
-    const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
-    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+Return Value:
 
-    if (DataParams->BIsPacked) {
+    None.
 
-        MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
-            K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[RowCount][ColumnCount];
 
-    } else {
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+            Accumulators[r][c] = MlasZeroFloat32x4();
+        }
+    }
 
-        const size_t ldb = DataParams->ldb;
+    size_t k = 0;
 
-        const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
+    for (; k + 4 <= K; k += 4) {
 
-        MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+        MLAS_FLOAT32X4 BElements[ColumnCount];
+
+        for (size_t c = 0; c < ColumnCount; c++) {
+            BElements[c] = MlasLoadFloat32x4(B + c * ldb + k);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            MLAS_FLOAT32X4 AElements = MlasLoadFloat32x4(A + r * lda + k);
+            for (size_t c = 0; c < ColumnCount; c++) {
+                Accumulators[r][c] = MlasMultiplyAddFloat32x4(AElements, BElements[c], Accumulators[r][c]);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+
+            float Sum = MlasReduceAddFloat32x4(Accumulators[r][c]);
+
+            for (size_t kk = k; kk < K; kk++) {
+                Sum += A[r * lda + kk] * B[c * ldb + kk];
+            }
+
+            float* Output = C + r * ldc + c;
+            *Output = (beta != 0.0f) ? alpha * Sum + beta * *Output : alpha * Sum;
+        }
     }
 }
-#if defined(_MSC_VER) && !defined(__clang__)
-#pragma warning(push)
-// Chance of arithmetic overflow could be reduced
-#pragma warning(disable : 26451)
-#endif
+
+template<size_t RowCount>
 void
-MLASCALL
-MlasGemmBatch(
-    CBLAS_TRANSPOSE TransA,
+MlasSgemmSmallRows(
     CBLAS_TRANSPOSE TransB,
-    size_t M,
     size_t N,
     size_t K,
-    const MLAS_SGEMM_DATA_PARAMS* Data,
-    size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta
     )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of matrix C by stepping through the
+    columns with the widest block that fits.
+
+Arguments:
+
+    See MlasSgemmSmallOperation.
+
+Return Value:
+
+    None.
+
+--*/
 {
+    size_t n = 0;
+
+    if (TransB == CblasNoTrans) {
+
+        for (; n + 16 <= N; n += 16) {
+            MlasSgemmSmallKernelNoTransB<RowCount, 4>(A, lda, B + n, ldb, C + n, ldc, K, alpha, beta);
+        }
+
+        if (n + 8 <= N) {
+            MlasSgemmSmallKernelNoTransB<RowCount, 2>(A, lda, B + n, ldb, C + n, ldc, K, alpha, beta);
+            n += 8;
+        }
+
+        if (n + 4 <= N) {
+            MlasSgemmSmallKernelNoTransB<RowCount, 1>(A, lda, B + n, ldb, C + n, ldc, K, alpha, beta);
+            n += 4;
+        }
+
+        for (; n < N; n++) {
+            for (size_t r = 0; r < RowCount; r++) {
+                float Sum = 0.0f;
+                for (size_t k = 0; k < K; k++) {
+                    Sum += A[r * lda + k] * B[k * ldb + n];
+                }
+                float* Output = C + r * ldc + n;
+                *Output = (beta != 0.0f) ? alpha * Sum + beta * *Output : alpha * Sum;
+            }
+        }
+
+    } else {
+
+        for (; n + 4 <= N; n += 4) {
+            MlasSgemmSmallKernelTransB<RowCount, 4>(A, lda, B + n * ldb, ldb, C + n, ldc, K, alpha, beta);
+        }
+
+        for (; n < N; n++) {
+            MlasSgemmSmallKernelTransB<RowCount, 1>(A, lda, B + n * ldb, ldb, C + n, ldc, K, alpha, beta);
+        }
+    }
+}
+
+void
+MlasSgemmSmallOperation(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* DataParams
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a small problem with matrix A not transposed and
+    matrix B not packed. Matrix B is read in place, avoiding the packing that
+    dominates the cost of a small problem.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    DataParams - Supplies the data position and layout of the matrices.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* A = DataParams->A;
+    const size_t lda = DataParams->lda;
+    const float* B = DataParams->B;
+    const size_t ldb = DataParams->ldb;
+    float* C = DataParams->C;
+    const size_t ldc = DataParams->ldc;
+    const float alpha = DataParams->alpha;
+    const float beta = DataParams->beta;
+
+    if (K == 0) {
+        MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        return;
+    }
+
+    size_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        MlasSgemmSmallRows<4>(TransB, N, K, A + m * lda, lda, B, ldb, C + m * ldc, ldc, alpha, beta);
+    }
+
+    switch (M - m) {
+        case 3:
+            MlasSgemmSmallRows<3>(TransB, N, K, A + m * lda, lda, B, ldb, C + m * ldc, ldc, alpha, beta);
+            break;
+        case 2:
+            MlasSgemmSmallRows<2>(TransB, N, K, A + m * lda, lda, B, ldb, C + m * ldc, ldc, alpha, beta);
+            break;
+        case 1:
+            MlasSgemmSmallRows<1>(TransB, N, K, A + m * lda, lda, B, ldb, C + m * ldc, ldc, alpha, beta);
+            break;
+    }
+}
+
+bool
+MlasSgemmTrySmallBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a batch of small SGEMM operations if the problems
+    are within the limits of the small matrix path. The batch is partitioned
+    across the threads rather than each problem.
+
+Arguments:
+
+    See MlasGemmBatch.
+
+Return Value:
+
+    Returns true if the batch was computed, else false if the caller should
+    use the general path.
+
+--*/
+{
+    if (BatchSize < 2 || TransA != CblasNoTrans || M > MLAS_SGEMM_SMALL_MAXIMUM_M ||
+        N > MLAS_SGEMM_SMALL_MAXIMUM_N || K > MLAS_SGEMM_SMALL_MAXIMUM_K) {
+        return false;
+    }
+
+    for (size_t i = 0; i < BatchSize; i++) {
+        if (Data[i].BIsPacked) {
+            return false;
+        }
+    }
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > BatchSize) {
+        TargetThreadCount = ptrdiff_t(BatchSize);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t GemmIdx;
+        size_t GemmCount;
+
+        MlasPartitionWork(tid, TargetThreadCount, BatchSize, &GemmIdx, &GemmCount);
+
+        for (size_t i = GemmIdx; i < GemmIdx + GemmCount; i++) {
+            MlasSgemmSmallOperation(TransB, M, N, K, &Data[i]);
+        }
+    });
+
+    return true;
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernelColumnNoTransB(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single column of RowCount rows of matrix C with
+    matrix B not transposed.
+
+Arguments:
+
+    See MlasSgemmSmallKernelNoTransB.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t r = 0; r < RowCount; r++) {
+        float Sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+            Sum += A[r * lda + k] * B[k * ldb];
+        }
+        float* Output = C + r * ldc;
+        *Output = (beta != 0.0f) ? alpha * Sum + beta * *Output : alpha * Sum;
+    }
+}
+
+//
+// A kernel specialized to the shape of matrix B is the list of the column
+// blocks of matrix C, each with the routines that compute one to four rows of
+// the block.
+//
+
+typedef
+void
+(MLAS_SGEMM_SMALL_BLOCK_ROUTINE)(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta
+    );
+
+#define MLAS_SGEMM_SMALL_BLOCK_ROUTINES(Kernel, ColumnCount) \
+    { Kernel<1, ColumnCount>, Kernel<2, ColumnCount>, Kernel<3, ColumnCount>, Kernel<4, ColumnCount> }
+
+struct MLAS_SGEMM_SPECIALIZED_BLOCK {
+    size_t ColumnOffset;
+    MLAS_SGEMM_SMALL_BLOCK_ROUTINE* Routines[4];
+};
+
+struct MLAS_SGEMM_SPECIALIZED_KERNEL {
+    CBLAS_TRANSPOSE TransB;
+    size_t N;
+    size_t K;
+    size_t BlockCount;
+    MLAS_SGEMM_SPECIALIZED_BLOCK Blocks[MLAS_SGEMM_SMALL_MAXIMUM_N];
+};
+
+void
+MlasSgemmSpecializeKernel(
+    MLAS_SGEMM_SPECIALIZED_KERNEL* Kernel
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the column blocks of a kernel, using the widest block
+    that fits as MlasSgemmSmallRows does at every call.
+
+Arguments:
+
+    Kernel - Supplies the kernel with the shape of matrix B and receives the
+        column blocks.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static constexpr MLAS_SGEMM_SPECIALIZED_BLOCK NoTransBlocks[] = {
+        {16, MLAS_SGEMM_SMALL_BLOCK_ROUTINES(MlasSgemmSmallKernelNoTransB, 4)},
+        {8, MLAS_SGEMM_SMALL_BLOCK_ROUTINES(MlasSgemmSmallKernelNoTransB, 2)},
+        {4, MLAS_SGEMM_SMALL_BLOCK_ROUTINES(MlasSgemmSmallKernelNoTransB, 1)},
+        {1, {MlasSgemmSmallKernelColumnNoTransB<1>, MlasSgemmSmallKernelColumnNoTransB<2>,
+             MlasSgemmSmallKernelColumnNoTransB<3>, MlasSgemmSmallKernelColumnNoTransB<4>}},
+    };
+
+    static constexpr MLAS_SGEMM_SPECIALIZED_BLOCK TransBlocks[] = {
+        {4, MLAS_SGEMM_SMALL_BLOCK_ROUTINES(MlasSgemmSmallKernelTransB, 4)},
+        {1, MLAS_SGEMM_SMALL_BLOCK_ROUTINES(MlasSgemmSmallKernelTransB, 1)},
+    };
+
+    //
+    // The column counts of the block templates are stored in ColumnOffset.
+    //
+
+    const MLAS_SGEMM_SPECIALIZED_BLOCK* Templates = (Kernel->TransB == CblasNoTrans) ? NoTransBlocks : TransBlocks;
+    const size_t TemplateCount = (Kernel->TransB == CblasNoTrans) ? sizeof(NoTransBlocks) / sizeof(NoTransBlocks[0])
+                                                                  : sizeof(TransBlocks) / sizeof(TransBlocks[0]);
+
+    size_t n = 0;
+    Kernel->BlockCount = 0;
+
+    for (size_t t = 0; t < TemplateCount; t++) {
+
+        const size_t ColumnCount = Templates[t].ColumnOffset;
+
+        while (n + ColumnCount <= Kernel->N) {
+
+            MLAS_SGEMM_SPECIALIZED_BLOCK& Block = Kernel->Blocks[Kernel->BlockCount++];
+
+            Block = Templates[t];
+            Block.ColumnOffset = n;
+            n += ColumnCount;
+        }
+    }
+}
+
+const MLAS_SGEMM_SPECIALIZED_KERNEL*
+MLASCALL
+MlasSgemmGetSpecializedKernel(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the kernel specialized to the shape of matrix B.
+
+    The kernels are built once per shape and cached for the lifetime of the
+    process, so the kernels of the sessions that share a shape are shared.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+Return Value:
+
+    Returns the kernel, else nullptr if the shape is outside the limits of the
+    small matrix path.
+
+--*/
+{
+    if (N == 0 || N > MLAS_SGEMM_SMALL_MAXIMUM_N || K == 0 || K > MLAS_SGEMM_SMALL_MAXIMUM_K) {
+        return nullptr;
+    }
+
+    static std::mutex CacheMutex;
+    static std::unordered_map<size_t, std::unique_ptr<MLAS_SGEMM_SPECIALIZED_KERNEL>> Cache;
+
+    const size_t Key = ((K * (MLAS_SGEMM_SMALL_MAXIMUM_N + 1)) + N) * 2 + (TransB == CblasNoTrans ? 0 : 1);
+
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+
+    std::unique_ptr<MLAS_SGEMM_SPECIALIZED_KERNEL>& Kernel = Cache[Key];
+
+    if (Kernel == nullptr) {
+        Kernel = std::make_unique<MLAS_SGEMM_SPECIALIZED_KERNEL>();
+        Kernel->TransB = TransB;
+        Kernel->N = N;
+        Kernel->K = K;
+        MlasSgemmSpecializeKernel(Kernel.get());
+    }
+
+    return Kernel.get();
+}
+
+void
+MLASCALL
+MlasSgemmSpecializedBatch(
+    const MLAS_SGEMM_SPECIALIZED_KERNEL* Kernel,
+    size_t M,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a batch of SGEMM operations with a kernel specialized
+    to the shape of matrix B. The blocks of four rows of all the operations of
+    the batch are partitioned across the threads.
+
+Arguments:
+
+    Kernel - Supplies the kernel specialized to the shape of matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    Data - Supplies the data position and layout of the matrices.
+
+    BatchSize - Supplies the number of operations of the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t N = Kernel->N;
+    const size_t K = Kernel->K;
+    const bool TransB = (Kernel->TransB != CblasNoTrans);
+
+    const size_t RowBlockCount = (M + 3) / 4;
+    const size_t WorkCount = RowBlockCount * BatchSize;
+
+    if (WorkCount == 0) {
+        return;
+    }
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+            const MLAS_SGEMM_DATA_PARAMS& Params = Data[w / RowBlockCount];
+            const size_t m = (w % RowBlockCount) * 4;
+            const size_t RowCount = std::min(M - m, size_t(4));
+
+            const float* A = Params.A + m * Params.lda;
+            float* C = Params.C + m * Params.ldc;
+
+            for (size_t b = 0; b < Kernel->BlockCount; b++) {
+
+                const MLAS_SGEMM_SPECIALIZED_BLOCK& Block = Kernel->Blocks[b];
+                const size_t n = Block.ColumnOffset;
+
+                Block.Routines[RowCount - 1](A, Params.lda, Params.B + (TransB ? n * Params.ldb : n), Params.ldb,
+                                             C + n, Params.ldc, K, Params.alpha, Params.beta);
+            }
+        }
+    });
+}
+
+void
+MlasSgemmThreaded(
+    const ptrdiff_t ThreadCountM,
+    const ptrdiff_t ThreadCountN,
+    const CBLAS_TRANSPOSE TransA,
+    const CBLAS_TRANSPOSE TransB,
+    const size_t M,
+    const size_t N,
+    const size_t K,
+
+    const MLAS_SGEMM_DATA_PARAMS* DataParams,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation.
+
+Arguments:
+
+    ThreadCountM - Supplies the total thread partition on the M dimension.
+
+    ThreadCountN - Supplies the total thread partition on the N dimension.
+
+    TransA - Supplies the transpose operation on A matrix
+
+    TransB - Supplies the transpose operation on B matrix
+
+    M, N, K - Supplies the shape of the multiplication
+
+    DataParams - Supplies the data position and layout of the matrices
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+
+    const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
+    const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN,
+        &RangeCountN);
+
+    RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+    //
+    // Dispatch the partitioned operation.
+    //
+
+    const size_t lda = DataParams->lda;
+    const size_t ldc = DataParams->ldc;
+
+    const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
+    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+
+    if (DataParams->BIsPacked) {
+
+        MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
+            K, DataParams->alpha, A, lda, DataParams->B,
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+
+    } else {
+
+        const size_t ldb = DataParams->ldb;
+
+        const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
+
+        MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+    }
+}
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma warning(push)
+// Chance of arithmetic overflow could be reduced
+#pragma warning(disable : 26451)
+#endif
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+
+    //
+    // Handle the special case of a batch of small problems, which would
+    // otherwise spend most of the time packing matrix B and dispatching the
+    // threads of each problem.
+    //
+
+    if (MlasSgemmTrySmallBatch(TransA, TransB, M, N, K, Data, BatchSize, ThreadPool)) {
+        return;
+    }
 
     //
     // Compute the number of target threads given the complexity of the SGEMM
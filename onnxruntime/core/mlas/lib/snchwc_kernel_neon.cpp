@@ -0,0 +1,893 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the single precision convolution and pooling
+    kernels for the NCHWc blocking format on ARM64.
+
+    Each block of MLAS_NEON_NCHWC_BLOCK_SIZE channels is held in two 128-bit
+    vectors. The kernels follow the calling conventions of the x64 kernels:
+    strides are in bytes, and the outputs affected by padding are computed
+    with bounds checks on each kernel element while the remaining outputs are
+    computed without them.
+
+--*/
+
+#include "mlasi.h"
+
+constexpr size_t BlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+
+static_assert(BlockSize == 8, "kernels hold a block of channels in two vectors");
+
+//
+// Define the number of filter blocks computed at a time. This matches
+// MLAS_NCHWC_GROUPED_CONV_ALGORITHM::FilterSetSize.
+//
+
+constexpr size_t MaximumFilterCount = 4;
+
+MLAS_FORCEINLINE
+const float*
+MlasNchwcOffsetBytes(
+    const float* Pointer,
+    size_t Bytes
+    )
+{
+    return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(Pointer) + Bytes);
+}
+
+MLAS_FORCEINLINE
+float*
+MlasNchwcOffsetBytes(
+    float* Pointer,
+    size_t Bytes
+    )
+{
+    return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(Pointer) + Bytes);
+}
+
+MLAS_FORCEINLINE
+bool
+MlasNchwcIsInsideRow(
+    const float* Input,
+    const float* RowBase,
+    size_t InputWidth
+    )
+/*++
+
+Routine Description:
+
+    This routine tests whether an input element is inside the input row that
+    starts at RowBase and spans InputWidth bytes. Elements in the padding to
+    the left of the row compute a negative offset, which wraps around to a
+    value larger than InputWidth.
+
+--*/
+{
+    return size_t(reinterpret_cast<const uint8_t*>(Input) - reinterpret_cast<const uint8_t*>(RowBase)) < InputWidth;
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvNchwcNeonStoreOutput(
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][2],
+    float* Output,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine stores the accumulators of one or more output positions of
+    one or more filter blocks, applying the accumulate, bias, and ReLU kernel
+    flags.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ZeroVector = MlasZeroFloat32x4();
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = MlasNchwcOffsetBytes(Output, f * OutputStride);
+
+        for (size_t o = 0; o < OutputCount; o++) {
+
+            MLAS_FLOAT32X4 Value0 = Accumulators[o][f][0];
+            MLAS_FLOAT32X4 Value1 = Accumulators[o][f][1];
+
+            if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT) != 0) {
+                Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(&output[o * BlockSize]));
+                Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(&output[o * BlockSize + 4]));
+            }
+
+            if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION) != 0) {
+                Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(&Bias[f * BlockSize]));
+                Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(&Bias[f * BlockSize + 4]));
+            }
+
+            if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION) != 0) {
+                Value0 = MlasMaximumFloat32x4(Value0, ZeroVector);
+                Value1 = MlasMaximumFloat32x4(Value1, ZeroVector);
+            }
+
+            MlasStoreFloat32x4(&output[o * BlockSize], Value0);
+            MlasStoreFloat32x4(&output[o * BlockSize + 4], Value1);
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount, size_t InputChannels, bool CheckBounds>
+MLAS_FORCEINLINE
+void
+MlasConvNchwcNeonComputeOutput(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine computes one or more consecutive output positions of one or
+    more filter blocks for the direct convolution kernels.
+
+    Each kernel element reads InputChannels values: a block of channels for
+    the NCHWc kernel or a single channel for the NCHW kernel. The filter of
+    each kernel element holds one block of output channels for each of these
+    input values.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][2];
+
+    for (size_t o = 0; o < OutputCount; o++) {
+        for (size_t f = 0; f < FilterCount; f++) {
+            Accumulators[o][f][0] = MlasZeroFloat32x4();
+            Accumulators[o][f][1] = MlasZeroFloat32x4();
+        }
+    }
+
+    const float* input = Input;
+    const float* RowBase = InputBase;
+    const float* filter = Filter;
+
+    for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+            if (!CheckBounds || MlasNchwcIsInsideRow(input, RowBase, InputWidth)) {
+
+                for (size_t ic = 0; ic < InputChannels; ic++) {
+
+                    MLAS_FLOAT32X4 InputVector[OutputCount];
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+                        InputVector[o] = MlasBroadcastFloat32x4(MlasNchwcOffsetBytes(input, o * StrideWidth) + ic);
+                    }
+
+                    for (size_t f = 0; f < FilterCount; f++) {
+
+                        const float* w = MlasNchwcOffsetBytes(filter, f * FilterStride) + ic * BlockSize;
+                        const MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(w);
+                        const MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(w + 4);
+
+                        for (size_t o = 0; o < OutputCount; o++) {
+                            Accumulators[o][f][0] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector0, Accumulators[o][f][0]);
+                            Accumulators[o][f][1] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector1, Accumulators[o][f][1]);
+                        }
+                    }
+                }
+            }
+
+            input = MlasNchwcOffsetBytes(input, DilationWidth);
+            filter += InputChannels * BlockSize;
+        }
+
+        input = MlasNchwcOffsetBytes(input, InputStride);
+        RowBase = MlasNchwcOffsetBytes(RowBase, DilatedInputWidth);
+    }
+
+    MlasConvNchwcNeonStoreOutput<FilterCount, OutputCount>(Accumulators, Output, OutputStride, Bias, KernelFlags);
+}
+
+template<size_t FilterCount, size_t InputChannels>
+void
+MlasConvNchwcNeonFilterSet(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an output row of a set of filter blocks. The
+    outputs without padding are computed two at a time to reuse the filter
+    vectors.
+
+--*/
+{
+    const size_t OutputCountWithPad = OutputCountLeftPad + OutputCount;
+    const size_t TotalOutputCount = OutputCountWithPad + OutputCountRightPad;
+
+    size_t ow = 0;
+
+    auto ComputePadded = [&](size_t Position) {
+        MlasConvNchwcNeonComputeOutput<FilterCount, 1, InputChannels, true>(
+            MlasNchwcOffsetBytes(Input, Position * StrideWidth), Filter, Output + Position * BlockSize,
+            StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride, KernelHeight, KernelWidth,
+            InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    };
+
+    for (; ow < OutputCountLeftPad; ow++) {
+        ComputePadded(ow);
+    }
+
+    for (; ow + 2 <= OutputCountWithPad; ow += 2) {
+        MlasConvNchwcNeonComputeOutput<FilterCount, 2, InputChannels, false>(
+            MlasNchwcOffsetBytes(Input, ow * StrideWidth), Filter, Output + ow * BlockSize,
+            StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride, KernelHeight, KernelWidth,
+            InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    }
+
+    for (; ow < OutputCountWithPad; ow++) {
+        MlasConvNchwcNeonComputeOutput<FilterCount, 1, InputChannels, false>(
+            MlasNchwcOffsetBytes(Input, ow * StrideWidth), Filter, Output + ow * BlockSize,
+            StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride, KernelHeight, KernelWidth,
+            InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    }
+
+    for (; ow < TotalOutputCount; ow++) {
+        ComputePadded(ow);
+    }
+}
+
+template<size_t InputChannels>
+void
+MlasConvNchwcNeonDispatch(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    decltype(&MlasConvNchwcNeonFilterSet<1, InputChannels>) FilterSetRoutine;
+
+    switch (FilterCount) {
+        case 1:
+            FilterSetRoutine = MlasConvNchwcNeonFilterSet<1, InputChannels>;
+            break;
+        case 2:
+            FilterSetRoutine = MlasConvNchwcNeonFilterSet<2, InputChannels>;
+            break;
+        case 3:
+            FilterSetRoutine = MlasConvNchwcNeonFilterSet<3, InputChannels>;
+            break;
+        default:
+            FilterSetRoutine = MlasConvNchwcNeonFilterSet<MaximumFilterCount, InputChannels>;
+            break;
+    }
+
+    FilterSetRoutine(Input, Filter, Output, StrideWidth, DilationWidth, InputStride, FilterStride,
+        OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvNchwcFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows, where the input is in NCHWc
+    format.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer, which points to the
+        input element of the first output position, including the padding.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation width.
+
+    FilterCount - Supplies the number of filter blocks to process, from one to
+        four.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row.
+
+    FilterStride - Supplies the length in bytes of each filter block.
+
+    OutputStride - Supplies the length in bytes of each output block.
+
+    KernelHeight - Supplies the height of the kernel to apply. This height may
+        be less than the original kernel height after removing any padding
+        rows.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer of the first
+        input row, used to test whether a kernel element is in the padding.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+    Bias - Supplies the address of the bias buffer.
+
+    KernelFlags - Supplies additional flags controlling the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvNchwcNeonDispatch<BlockSize>(Input, Filter, Output, StrideWidth, DilationWidth, FilterCount,
+        InputStride, FilterStride, OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth,
+        DilatedInputWidth, OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvNchwFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows, where the input is a single
+    channel in NCHW format.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernelNeon. The strides and widths of the input are
+    in bytes of the unblocked input.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvNchwcNeonDispatch<1>(Input, Filter, Output, StrideWidth, DilationWidth, FilterCount,
+        InputStride, FilterStride, OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth,
+        DilatedInputWidth, OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, KernelFlags);
+}
+
+template<bool CheckBounds>
+MLAS_FORCEINLINE
+void
+MlasConvDepthwiseNeonComputeOutput(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    MLAS_FLOAT32X4 Accumulators[1][1][2] = {{{MlasZeroFloat32x4(), MlasZeroFloat32x4()}}};
+
+    const float* input = Input;
+    const float* RowBase = InputBase;
+    const float* filter = Filter;
+
+    for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+            if (!CheckBounds || MlasNchwcIsInsideRow(input, RowBase, InputWidth)) {
+                Accumulators[0][0][0] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input),
+                    MlasLoadFloat32x4(filter), Accumulators[0][0][0]);
+                Accumulators[0][0][1] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input + 4),
+                    MlasLoadFloat32x4(filter + 4), Accumulators[0][0][1]);
+            }
+
+            input = MlasNchwcOffsetBytes(input, DilationWidth);
+            filter += BlockSize;
+        }
+
+        input = MlasNchwcOffsetBytes(input, InputStride);
+        RowBase = MlasNchwcOffsetBytes(RowBase, DilatedInputWidth);
+    }
+
+    MlasConvNchwcNeonStoreOutput<1, 1>(Accumulators, Output, 0, Bias, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvDepthwiseFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a depthwise convolution for the
+    elements of an output row for a block of channels, where the input and the
+    output are in NCHWc format.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernelNeon.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t OutputCountWithPad = OutputCountLeftPad + OutputCount;
+    const size_t TotalOutputCount = OutputCountWithPad + OutputCountRightPad;
+
+    for (size_t ow = 0; ow < TotalOutputCount; ow++) {
+
+        const float* input = MlasNchwcOffsetBytes(Input, ow * StrideWidth);
+        float* output = Output + ow * BlockSize;
+
+        if (ow < OutputCountLeftPad || ow >= OutputCountWithPad) {
+            MlasConvDepthwiseNeonComputeOutput<true>(input, Filter, output, DilationWidth, InputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+        } else {
+            MlasConvDepthwiseNeonComputeOutput<false>(input, Filter, output, DilationWidth, InputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvPointwiseNeonComputeOutput(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][2];
+
+    for (size_t o = 0; o < OutputCount; o++) {
+        for (size_t f = 0; f < FilterCount; f++) {
+            Accumulators[o][f][0] = MlasZeroFloat32x4();
+            Accumulators[o][f][1] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (size_t icb = 0; icb < InputChannels; icb++) {
+
+        const float* input = MlasNchwcOffsetBytes(Input, icb * InputStride);
+        const float* filter = Filter + icb * BlockSize * BlockSize;
+
+        for (size_t ic = 0; ic < BlockSize; ic++) {
+
+            MLAS_FLOAT32X4 InputVector[OutputCount];
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                InputVector[o] = MlasBroadcastFloat32x4(MlasNchwcOffsetBytes(input, o * StrideWidth) + ic);
+            }
+
+            for (size_t f = 0; f < FilterCount; f++) {
+
+                const float* w = MlasNchwcOffsetBytes(filter, f * FilterStride) + ic * BlockSize;
+                const MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(w);
+                const MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(w + 4);
+
+                for (size_t o = 0; o < OutputCount; o++) {
+                    Accumulators[o][f][0] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector0, Accumulators[o][f][0]);
+                    Accumulators[o][f][1] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector1, Accumulators[o][f][1]);
+                }
+            }
+        }
+    }
+
+    MlasConvNchwcNeonStoreOutput<FilterCount, OutputCount>(Accumulators, Output, OutputStride, Bias, KernelFlags);
+}
+
+template<size_t FilterCount>
+void
+MlasConvPointwiseNeonFilterSet(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    size_t ow = 0;
+
+    for (; ow + 2 <= OutputCount; ow += 2) {
+        MlasConvPointwiseNeonComputeOutput<FilterCount, 2>(MlasNchwcOffsetBytes(Input, ow * StrideWidth),
+            Filter, Output + ow * BlockSize, StrideWidth, InputChannels, InputStride, FilterStride,
+            OutputStride, Bias, KernelFlags);
+    }
+
+    if (ow < OutputCount) {
+        MlasConvPointwiseNeonComputeOutput<FilterCount, 1>(MlasNchwcOffsetBytes(Input, ow * StrideWidth),
+            Filter, Output + ow * BlockSize, StrideWidth, InputChannels, InputStride, FilterStride,
+            OutputStride, Bias, KernelFlags);
+    }
+}
+
+void
+MLASCALL
+MlasConvPointwiseFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a pointwise convolution for the
+    elements of an output row for a set of filter rows, where the input and the
+    output are in NCHWc format.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    InputChannels - Supplies the number of input channel blocks to process.
+
+    FilterCount - Supplies the number of filter blocks to process, from one to
+        four.
+
+    InputStride - Supplies the length in bytes of each input block.
+
+    FilterStride - Supplies the length in bytes of each filter block.
+
+    OutputStride - Supplies the length in bytes of each output block.
+
+    OutputCount - Supplies the number of output elements.
+
+    Bias - Supplies the address of the bias buffer.
+
+    KernelFlags - Supplies additional flags controlling the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+        case 1:
+            MlasConvPointwiseNeonFilterSet<1>(Input, Filter, Output, StrideWidth, InputChannels,
+                InputStride, FilterStride, OutputStride, OutputCount, Bias, KernelFlags);
+            break;
+        case 2:
+            MlasConvPointwiseNeonFilterSet<2>(Input, Filter, Output, StrideWidth, InputChannels,
+                InputStride, FilterStride, OutputStride, OutputCount, Bias, KernelFlags);
+            break;
+        case 3:
+            MlasConvPointwiseNeonFilterSet<3>(Input, Filter, Output, StrideWidth, InputChannels,
+                InputStride, FilterStride, OutputStride, OutputCount, Bias, KernelFlags);
+            break;
+        default:
+            MlasConvPointwiseNeonFilterSet<MaximumFilterCount>(Input, Filter, Output, StrideWidth,
+                InputChannels, InputStride, FilterStride, OutputStride, OutputCount, Bias, KernelFlags);
+            break;
+    }
+}
+
+template<MLAS_POOLING_KIND PoolingKind>
+void
+MlasPoolFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute pooling for the elements of an
+    output row for a block of channels, where the input and the output are in
+    NCHWc format.
+
+    Maximum pooling ignores the padding elements. Average pooling divides by
+    the number of elements inside the input when excluding the padding, else
+    by ActualKernelSize, the size of the kernel before removing the padding
+    rows.
+
+--*/
+{
+    const size_t OutputCountWithPad = OutputCountLeftPad + OutputCount;
+    const size_t TotalOutputCount = OutputCountWithPad + OutputCountRightPad;
+
+    const MLAS_FLOAT32X4 InitialVector = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+
+    for (size_t ow = 0; ow < TotalOutputCount; ow++) {
+
+        const bool CheckBounds = (ow < OutputCountLeftPad || ow >= OutputCountWithPad);
+
+        const float* input = MlasNchwcOffsetBytes(Input, ow * StrideWidth);
+        const float* RowBase = InputBase;
+
+        MLAS_FLOAT32X4 Value0 = InitialVector;
+        MLAS_FLOAT32X4 Value1 = InitialVector;
+        size_t ElementCount = 0;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckBounds || MlasNchwcIsInsideRow(input, RowBase, InputWidth)) {
+
+                    if (PoolingKind == MlasMaximumPooling) {
+                        Value0 = MlasMaximumFloat32x4(Value0, MlasLoadFloat32x4(input));
+                        Value1 = MlasMaximumFloat32x4(Value1, MlasLoadFloat32x4(input + 4));
+                    } else {
+                        Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(input));
+                        Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(input + 4));
+                    }
+
+                    ElementCount++;
+                }
+
+                input = MlasNchwcOffsetBytes(input, DilationWidth);
+            }
+
+            input = MlasNchwcOffsetBytes(input, InputStride);
+            RowBase = MlasNchwcOffsetBytes(RowBase, DilatedInputWidth);
+        }
+
+        if (PoolingKind != MlasMaximumPooling) {
+
+            const size_t Divisor = (PoolingKind == MlasAveragePoolingExcludePad) ? ElementCount : ActualKernelSize;
+
+            if (Divisor > 0) {
+                const MLAS_FLOAT32X4 Scale = MlasBroadcastFloat32x4(1.0f / float(Divisor));
+                Value0 = MlasMultiplyFloat32x4(Value0, Scale);
+                Value1 = MlasMultiplyFloat32x4(Value1, Scale);
+            }
+        }
+
+        MlasStoreFloat32x4(&Output[ow * BlockSize], Value0);
+        MlasStoreFloat32x4(&Output[ow * BlockSize + 4], Value1);
+    }
+}
+
+void
+MLASCALL
+MlasPoolMaximumFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasMaximumPooling>(Input, Output, StrideWidth, DilationWidth, InputStride,
+        ActualKernelSize, KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageExcludePadFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasAveragePoolingExcludePad>(Input, Output, StrideWidth, DilationWidth,
+        InputStride, ActualKernelSize, KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageIncludePadFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasAveragePoolingIncludePad>(Input, Output, StrideWidth, DilationWidth,
+        InputStride, ActualKernelSize, KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad);
+}
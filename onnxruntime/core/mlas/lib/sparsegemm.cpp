@@ -0,0 +1,479 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a constant block sparse matrix B.
+
+    Matrix B is divided into blocks of 1 row by 4 columns. The nonzero blocks
+    are packed by column block along with the index of their row, so the
+    pruned weights of a model are skipped instead of multiplied. Block pruned
+    weights with blocks of 4x4 or of 1x4 along the columns map directly to
+    this layout.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of a block of matrix B.
+//
+
+#define MLAS_SPARSE_GEMM_BLOCK_COLUMNS          4
+
+//
+// Define the maximum fraction of nonzero blocks of matrix B for which the
+// sparse path is faster than the dense packed path of MlasGemmBatch.
+//
+
+#define MLAS_SPARSE_GEMM_MAXIMUM_DENSITY        0.4
+
+//
+// Define the number of column blocks of matrix C computed by a unit of work
+// of the threaded operation.
+//
+
+#define MLAS_SPARSE_GEMM_STRIDEN_BLOCKS         16
+
+//
+// Define the layout of packed matrix B. The header is followed by the offsets
+// of the first nonzero block of each column block, the row index of each
+// nonzero block and then the aligned values of the nonzero blocks.
+//
+
+struct MLAS_SPARSE_GEMM_PACKED_B {
+    size_t N;
+    size_t K;
+    size_t BlockCount;
+    size_t NonzeroCount;
+};
+
+struct MLAS_SPARSE_GEMM_PACKED_B_VIEW {
+    const uint32_t* Offsets;
+    const uint32_t* Indices;
+    const float* Values;
+};
+
+size_t
+MlasSparseGemmValuesOffset(
+    size_t BlockCount,
+    size_t NonzeroCount
+    )
+{
+    const size_t Offset = sizeof(MLAS_SPARSE_GEMM_PACKED_B) +
+        (BlockCount + 1 + NonzeroCount) * sizeof(uint32_t);
+
+    return (Offset + MLAS_SPARSE_GEMM_BLOCK_COLUMNS * sizeof(float) - 1) &
+        ~(MLAS_SPARSE_GEMM_BLOCK_COLUMNS * sizeof(float) - 1);
+}
+
+MLAS_FORCEINLINE
+float
+MlasSparseGemmLoadB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    if (n >= N) {
+        return 0.0f;
+    }
+
+    return (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer
+    of a block sparse matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer, else zero if
+    matrix B is not sparse enough for the sparse path to be faster than the
+    dense path of MlasGemmBatch.
+
+--*/
+{
+    if (N == 0 || K == 0 || K > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t BlockCount = (N + MLAS_SPARSE_GEMM_BLOCK_COLUMNS - 1) / MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+    size_t NonzeroCount = 0;
+
+    for (size_t j = 0; j < BlockCount; j++) {
+        for (size_t k = 0; k < K; k++) {
+            for (size_t n = j * MLAS_SPARSE_GEMM_BLOCK_COLUMNS; n < (j + 1) * MLAS_SPARSE_GEMM_BLOCK_COLUMNS; n++) {
+                if (MlasSparseGemmLoadB(TransB, N, B, ldb, k, n) != 0.0f) {
+                    NonzeroCount++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (double(NonzeroCount) > MLAS_SPARSE_GEMM_MAXIMUM_DENSITY * double(BlockCount) * double(K) ||
+        NonzeroCount > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    return MlasSparseGemmValuesOffset(BlockCount, NonzeroCount) +
+        NonzeroCount * MLAS_SPARSE_GEMM_BLOCK_COLUMNS * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the nonzero blocks of matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B, with a size returned by
+        MlasSparseGemmPackBSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCount = (N + MLAS_SPARSE_GEMM_BLOCK_COLUMNS - 1) / MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+
+    uint32_t* Offsets = reinterpret_cast<uint32_t*>(
+        reinterpret_cast<uint8_t*>(PackedB) + sizeof(MLAS_SPARSE_GEMM_PACKED_B));
+    uint32_t* Indices = Offsets + BlockCount + 1;
+
+    //
+    // Collect the row indices of the nonzero blocks, which determines the
+    // location of the values.
+    //
+
+    size_t NonzeroCount = 0;
+
+    for (size_t j = 0; j < BlockCount; j++) {
+
+        Offsets[j] = uint32_t(NonzeroCount);
+
+        for (size_t k = 0; k < K; k++) {
+            for (size_t n = j * MLAS_SPARSE_GEMM_BLOCK_COLUMNS; n < (j + 1) * MLAS_SPARSE_GEMM_BLOCK_COLUMNS; n++) {
+                if (MlasSparseGemmLoadB(TransB, N, B, ldb, k, n) != 0.0f) {
+                    Indices[NonzeroCount++] = uint32_t(k);
+                    break;
+                }
+            }
+        }
+    }
+
+    Offsets[BlockCount] = uint32_t(NonzeroCount);
+
+    MLAS_SPARSE_GEMM_PACKED_B* Header = reinterpret_cast<MLAS_SPARSE_GEMM_PACKED_B*>(PackedB);
+
+    Header->N = N;
+    Header->K = K;
+    Header->BlockCount = BlockCount;
+    Header->NonzeroCount = NonzeroCount;
+
+    float* Values = reinterpret_cast<float*>(
+        reinterpret_cast<uint8_t*>(PackedB) + MlasSparseGemmValuesOffset(BlockCount, NonzeroCount));
+
+    for (size_t j = 0; j < BlockCount; j++) {
+        for (size_t e = Offsets[j]; e < Offsets[j + 1]; e++) {
+            for (size_t c = 0; c < MLAS_SPARSE_GEMM_BLOCK_COLUMNS; c++) {
+                *Values++ = MlasSparseGemmLoadB(TransB, N, B, ldb, Indices[e], j * MLAS_SPARSE_GEMM_BLOCK_COLUMNS + c);
+            }
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasSparseGemmKernel(
+    const float* A,
+    size_t lda,
+    const MLAS_SPARSE_GEMM_PACKED_B_VIEW& PackedB,
+    size_t StartBlock,
+    size_t CountBlock,
+    size_t N,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of a range of column blocks of matrix
+    C. Each nonzero block of matrix B is loaded once and multiplied by the
+    broadcast elements of all of the rows of matrix A.
+
+Arguments:
+
+    A - Supplies the address of the rows of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the view of packed matrix B.
+
+    StartBlock - Supplies the first column block to compute.
+
+    CountBlock - Supplies the number of column blocks to compute.
+
+    N - Supplies the number of columns of matrix C.
+
+    C - Supplies the address of the rows of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+    const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(beta);
+
+    for (size_t j = StartBlock; j < StartBlock + CountBlock; j++) {
+
+        MLAS_FLOAT32X4 Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = MlasZeroFloat32x4();
+        }
+
+        const float* Values = PackedB.Values + size_t(PackedB.Offsets[j]) * MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+
+        for (size_t e = PackedB.Offsets[j]; e < PackedB.Offsets[j + 1]; e++) {
+
+            const size_t k = PackedB.Indices[e];
+            const MLAS_FLOAT32X4 BElements = MlasLoadFloat32x4(Values);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r] = MlasMultiplyAddFloat32x4(BElements, MlasBroadcastFloat32x4(A + r * lda + k),
+                                                           Accumulators[r]);
+            }
+
+            Values += MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+        }
+
+        const size_t n = j * MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+        const size_t CountN = std::min(N - n, size_t(MLAS_SPARSE_GEMM_BLOCK_COLUMNS));
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            float* c = C + r * ldc + n;
+
+            MLAS_FLOAT32X4 Result = MlasMultiplyFloat32x4(Accumulators[r], AlphaBroadcast);
+
+            if (CountN == MLAS_SPARSE_GEMM_BLOCK_COLUMNS) {
+
+                if (beta != 0.0f) {
+                    Result = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(c), BetaBroadcast, Result);
+                }
+
+                MlasStoreFloat32x4(c, Result);
+
+            } else {
+
+                MLAS_DECLSPEC_ALIGN(float Output[MLAS_SPARSE_GEMM_BLOCK_COLUMNS], 16);
+
+                MlasStoreAlignedFloat32x4(Output, Result);
+
+                for (size_t i = 0; i < CountN; i++) {
+                    c[i] = (beta != 0.0f) ? Output[i] + beta * c[i] : Output[i];
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSparseGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a batch of SGEMM operations with a block sparse
+    matrix B packed by MlasSparseGemmPackB. Matrix A is not transposed. The
+    blocks of four rows and of MLAS_SPARSE_GEMM_STRIDEN_BLOCKS column blocks of
+    all the operations of the batch are partitioned across the threads, so a
+    single row of matrix A is partitioned along the N dimension.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    Data - Supplies the data position and layout of the matrices. The B member
+        supplies the address of packed matrix B.
+
+    BatchSize - Supplies the number of operations of the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    const size_t RowBlockCount = (M + 3) / 4;
+    const size_t BlockCount = (N + MLAS_SPARSE_GEMM_BLOCK_COLUMNS - 1) / MLAS_SPARSE_GEMM_BLOCK_COLUMNS;
+    const size_t ColumnChunkCount = (BlockCount + MLAS_SPARSE_GEMM_STRIDEN_BLOCKS - 1) / MLAS_SPARSE_GEMM_STRIDEN_BLOCKS;
+    const size_t WorkPerGemm = RowBlockCount * ColumnChunkCount;
+    const size_t WorkCount = WorkPerGemm * BatchSize;
+
+    //
+    // Compute the number of target threads given the number of nonzero
+    // multiplications of the operations.
+    //
+
+    const MLAS_SPARSE_GEMM_PACKED_B* Header = reinterpret_cast<const MLAS_SPARSE_GEMM_PACKED_B*>(Data[0].B);
+
+    const double Complexity = double(M) * double(Header->NonzeroCount) *
+        double(MLAS_SPARSE_GEMM_BLOCK_COLUMNS) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+            const MLAS_SGEMM_DATA_PARAMS& Params = Data[w / WorkPerGemm];
+
+            //
+            // Step through the rows of a column chunk first so the nonzero
+            // blocks of the chunk are reused from the cache.
+            //
+
+            const size_t Chunk = (w % WorkPerGemm) / RowBlockCount;
+            const size_t m = ((w % WorkPerGemm) % RowBlockCount) * 4;
+            const size_t RowCount = std::min(M - m, size_t(4));
+
+            const size_t StartBlock = Chunk * MLAS_SPARSE_GEMM_STRIDEN_BLOCKS;
+            const size_t CountBlock = std::min(BlockCount - StartBlock, size_t(MLAS_SPARSE_GEMM_STRIDEN_BLOCKS));
+
+            const MLAS_SPARSE_GEMM_PACKED_B* PackedHeader =
+                reinterpret_cast<const MLAS_SPARSE_GEMM_PACKED_B*>(Params.B);
+
+            MLAS_SPARSE_GEMM_PACKED_B_VIEW PackedB;
+
+            PackedB.Offsets = reinterpret_cast<const uint32_t*>(
+                reinterpret_cast<const uint8_t*>(Params.B) + sizeof(MLAS_SPARSE_GEMM_PACKED_B));
+            PackedB.Indices = PackedB.Offsets + PackedHeader->BlockCount + 1;
+            PackedB.Values = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(Params.B) +
+                MlasSparseGemmValuesOffset(PackedHeader->BlockCount, PackedHeader->NonzeroCount));
+
+            const float* A = Params.A + m * Params.lda;
+            float* C = Params.C + m * Params.ldc;
+
+            switch (RowCount) {
+                case 1:
+                    MlasSparseGemmKernel<1>(A, Params.lda, PackedB, StartBlock, CountBlock, N, C, Params.ldc, Params.alpha, Params.beta);
+                    break;
+                case 2:
+                    MlasSparseGemmKernel<2>(A, Params.lda, PackedB, StartBlock, CountBlock, N, C, Params.ldc, Params.alpha, Params.beta);
+                    break;
+                case 3:
+                    MlasSparseGemmKernel<3>(A, Params.lda, PackedB, StartBlock, CountBlock, N, C, Params.ldc, Params.alpha, Params.beta);
+                    break;
+                default:
+                    MlasSparseGemmKernel<4>(A, Params.lda, PackedB, StartBlock, CountBlock, N, C, Params.ldc, Params.alpha, Params.beta);
+                    break;
+            }
+        }
+    });
+}
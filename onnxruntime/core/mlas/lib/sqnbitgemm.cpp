@@ -769,3 +769,86 @@ MlasSQNBitGemmBatch(
         }
     });
 }
+
+void
+MLAS_SQNBIT_GEMM_EPILOGUE_PROCESSOR::Process(
+    float* C,
+    size_t RangeStartM,
+    size_t RangeStartN,
+    size_t RangeCountM,
+    size_t RangeCountN,
+    size_t ldc
+) const
+{
+    constexpr float Sqrt1_2 = 0.70710678118654752440f;
+    constexpr float Sqrt2_Pi = 0.79788456080286535588f;
+    constexpr float FastGeluB = 0.044715f;
+
+    //
+    // Step through each row in chunks that fit in a stack buffer so the tile
+    // of C is still in the cache for the multiplier and the residual.
+    //
+
+    constexpr size_t StrideN = 128;
+    MLAS_DECLSPEC_ALIGN(float Buffer[StrideN], 64);
+
+    for (size_t m = RangeStartM; m < RangeStartM + RangeCountM; m++) {
+
+        size_t CountN;
+        for (size_t n = RangeStartN; n < RangeStartN + RangeCountN; n += CountN) {
+
+            CountN = std::min(RangeStartN + RangeCountN - n, StrideN);
+            float* c = C + m * ldc + n;
+
+            switch (Activation_) {
+                case MlasSQNBitGemmEpilogueIdentity: {
+                    break;
+                }
+
+                case MlasSQNBitGemmEpilogueGelu: {
+                    for (size_t i = 0; i < CountN; i++) {
+                        Buffer[i] = c[i] * Sqrt1_2;
+                    }
+                    MlasComputeErf(Buffer, Buffer, CountN);
+                    for (size_t i = 0; i < CountN; i++) {
+                        c[i] = 0.5f * c[i] * (1.0f + Buffer[i]);
+                    }
+                    break;
+                }
+
+                case MlasSQNBitGemmEpilogueFastGelu: {
+                    for (size_t i = 0; i < CountN; i++) {
+                        Buffer[i] = Sqrt2_Pi * c[i] * (1.0f + FastGeluB * c[i] * c[i]);
+                    }
+                    MlasComputeTanh(Buffer, Buffer, CountN);
+                    for (size_t i = 0; i < CountN; i++) {
+                        c[i] = 0.5f * c[i] * (1.0f + Buffer[i]);
+                    }
+                    break;
+                }
+
+                case MlasSQNBitGemmEpilogueSilu: {
+                    MlasComputeLogistic(c, Buffer, CountN);
+                    for (size_t i = 0; i < CountN; i++) {
+                        c[i] *= Buffer[i];
+                    }
+                    break;
+                }
+            }
+
+            if (Multiplier_ != nullptr) {
+                const float* multiplier = Multiplier_ + m * ldMultiplier_ + n;
+                for (size_t i = 0; i < CountN; i++) {
+                    c[i] *= multiplier[i];
+                }
+            }
+
+            if (Residual_ != nullptr) {
+                const float* residual = Residual_ + m * ldResidual_ + n;
+                for (size_t i = 0; i < CountN; i++) {
+                    c[i] += residual[i];
+                }
+            }
+        }
+    }
+}
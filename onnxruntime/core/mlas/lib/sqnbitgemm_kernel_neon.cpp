@@ -192,3 +192,11 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon = []() {
 
     return d;
 }();
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeonI8mm = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d = MlasSQNBitGemmDispatchNeon;
+
+    d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8_I8mm;
+
+    return d;
+}();
@@ -90,6 +90,24 @@ SQ4BitGemmKernel_CompInt8(
     const float* Bias
 );
 
+// CompInt8 declarations for the I8MM extension
+
+size_t
+SQ4BitGemmKernel_CompInt8_I8mm(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+);
+
 //
 // General helpers.
 //
@@ -0,0 +1,362 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_neon_int8_i8mm.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernel for ARM NEON with the I8MM extension specific to
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE CompInt8.
+
+    The kernel uses SMMLA, which multiplies a 2x8 tile of A by an 8x2 tile
+    of B, so a 2x2 tile of the output is computed with half the instructions
+    of the dot product kernel. The remaining row and column of an odd sized
+    output are computed by the dot product kernel.
+
+--*/
+
+#include <arm_neon.h>
+
+#include <cassert>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_neon.h"
+#include "sqnbitgemm_q8_block.h"
+
+namespace sqnbitgemm_neon
+{
+
+namespace
+{
+
+//
+// Interleaves the low or the high 8 elements of two vectors, which makes a 2x8 operand of SMMLA.
+//
+
+MLAS_FORCEINLINE int8x16_t
+ZipLow(int8x16_t v0, int8x16_t v1)
+{
+    return vreinterpretq_s8_s64(vzip1q_s64(vreinterpretq_s64_s8(v0), vreinterpretq_s64_s8(v1)));
+}
+
+MLAS_FORCEINLINE int8x16_t
+ZipHigh(int8x16_t v0, int8x16_t v1)
+{
+    return vreinterpretq_s8_s64(vzip2q_s64(vreinterpretq_s64_s8(v0), vreinterpretq_s64_s8(v1)));
+}
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemm_CompInt8_I8mm_Compute2x2(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    const float* BiasPtr,
+    float* SumPtr,
+    size_t BlockCountK,
+    size_t StrideQuantA,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    size_t ldc
+)
+{
+    const std::byte* QuantAPtr = QuantARowPtr;
+    const std::byte* QuantBDataPtr = QuantBDataColPtr;
+    const float* QuantBScalePtr = QuantBScaleColPtr;
+    const std::byte* QuantBZeroPointPtr = QuantBZeroPointColPtr;
+
+    // the lanes are | row0 col0 | row0 col1 | row1 col0 | row1 col1 |, the layout of the SMMLA result
+    float32x4_t acc{};
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        const std::byte* QuantABlkRow0 = QuantAPtr;
+        const std::byte* QuantABlkRow1 = QuantAPtr + StrideQuantA;
+
+        const float QuantBScaleCol0 = *QuantBScalePtr;
+        const float QuantBScaleCol1 = *(QuantBScalePtr + StrideQuantBScale);
+
+        // compute combined scales
+        const float scales[4] = {
+            Q8BlkScale(QuantABlkRow0) * QuantBScaleCol0,
+            Q8BlkScale(QuantABlkRow0) * QuantBScaleCol1,
+            Q8BlkScale(QuantABlkRow1) * QuantBScaleCol0,
+            Q8BlkScale(QuantABlkRow1) * QuantBScaleCol1,
+        };
+
+        // load B zero point
+        int8_t bzp_col0;
+        int8_t bzp_col1;
+        if constexpr (HasZeroPoint) {
+            const std::byte QuantBZeroPointByteCol0 = *QuantBZeroPointPtr;
+            const std::byte QuantBZeroPointByteCol1 = *(QuantBZeroPointPtr + StrideQuantBZeroPoint);
+            if ((k_blk_idx & 1) == 0) {
+                bzp_col0 = std::to_integer<int8_t>(QuantBZeroPointByteCol0 & std::byte{0x0F});
+                bzp_col1 = std::to_integer<int8_t>(QuantBZeroPointByteCol1 & std::byte{0x0F});
+            } else {
+                bzp_col0 = std::to_integer<int8_t>(QuantBZeroPointByteCol0 >> 4);
+                bzp_col1 = std::to_integer<int8_t>(QuantBZeroPointByteCol1 >> 4);
+            }
+        } else {
+            bzp_col0 = 8;
+            bzp_col1 = 8;
+        }
+
+        const int8_t* QuantADataPtrRow0 = Q8BlkData(QuantABlkRow0);
+        const int8_t* QuantADataPtrRow1 = Q8BlkData(QuantABlkRow1);
+
+        int32x4_t dot{};
+
+        if (BlkLen == 16) {
+            // B is packed in 16-element sub-blocks, elements 0-7 in the low nibbles and 8-15 in the high nibbles
+            const uint8_t* QuantBDataPtrCol0 = reinterpret_cast<const uint8_t*>(QuantBDataPtr);
+            const uint8x8_t bv_packed_col0 = vld1_u8(QuantBDataPtrCol0);
+            const uint8x8_t bv_packed_col1 = vld1_u8(QuantBDataPtrCol0 + StrideQuantBData);
+
+            const uint8x8_t LowMaskU8x8 = vdup_n_u8(0x0F);
+            const int8x16_t bzp = vcombine_s8(vdup_n_s8(bzp_col0), vdup_n_s8(bzp_col1));
+
+            // columns 0 and 1 of elements 0-7, and of elements 8-15
+            const uint8x16_t bv_packed_0 =
+                vcombine_u8(vand_u8(bv_packed_col0, LowMaskU8x8), vand_u8(bv_packed_col1, LowMaskU8x8));
+            const uint8x16_t bv_packed_1 = vcombine_u8(vshr_n_u8(bv_packed_col0, 4), vshr_n_u8(bv_packed_col1, 4));
+            const int8x16_t bv_0 = vsubq_s8(vreinterpretq_s8_u8(bv_packed_0), bzp);
+            const int8x16_t bv_1 = vsubq_s8(vreinterpretq_s8_u8(bv_packed_1), bzp);
+
+            const int8x16_t av_row0 = vld1q_s8(QuantADataPtrRow0);
+            const int8x16_t av_row1 = vld1q_s8(QuantADataPtrRow1);
+
+            dot = vmmlaq_s32(dot, ZipLow(av_row0, av_row1), bv_0);
+            dot = vmmlaq_s32(dot, ZipHigh(av_row0, av_row1), bv_1);
+
+            QuantBDataPtr += 8;
+        } else {
+            // B is packed in 32-element sub-blocks, elements 0-15 in the low nibbles and 16-31 in the high nibbles
+            for (size_t k = 0; k < BlkLen; k += 32) {
+                const uint8_t* QuantBDataPtrCol0 = reinterpret_cast<const uint8_t*>(QuantBDataPtr);
+                const uint8x16_t bv_packed_col0 = vld1q_u8(QuantBDataPtrCol0);
+                const uint8x16_t bv_packed_col1 = vld1q_u8(QuantBDataPtrCol0 + StrideQuantBData);
+
+                const uint8x16_t LowMaskU8x16 = vdupq_n_u8(0x0F);
+
+                int8x16_t bv_col0_0 = vreinterpretq_s8_u8(vandq_u8(bv_packed_col0, LowMaskU8x16));
+                int8x16_t bv_col0_1 = vreinterpretq_s8_u8(vshrq_n_u8(bv_packed_col0, 4));
+                int8x16_t bv_col1_0 = vreinterpretq_s8_u8(vandq_u8(bv_packed_col1, LowMaskU8x16));
+                int8x16_t bv_col1_1 = vreinterpretq_s8_u8(vshrq_n_u8(bv_packed_col1, 4));
+
+                // subtract B zero point
+                bv_col0_0 = vsubq_s8(bv_col0_0, vdupq_n_s8(bzp_col0));
+                bv_col0_1 = vsubq_s8(bv_col0_1, vdupq_n_s8(bzp_col0));
+                bv_col1_0 = vsubq_s8(bv_col1_0, vdupq_n_s8(bzp_col1));
+                bv_col1_1 = vsubq_s8(bv_col1_1, vdupq_n_s8(bzp_col1));
+
+                // load A
+                const int8x16_t av_row0_0 = vld1q_s8(QuantADataPtrRow0 + k);
+                const int8x16_t av_row0_1 = vld1q_s8(QuantADataPtrRow0 + k + 16);
+                const int8x16_t av_row1_0 = vld1q_s8(QuantADataPtrRow1 + k);
+                const int8x16_t av_row1_1 = vld1q_s8(QuantADataPtrRow1 + k + 16);
+
+                // quantized matrix multiply of the 2x32 tile of A and the 32x2 tile of B
+                dot = vmmlaq_s32(dot, ZipLow(av_row0_0, av_row1_0), ZipLow(bv_col0_0, bv_col1_0));
+                dot = vmmlaq_s32(dot, ZipHigh(av_row0_0, av_row1_0), ZipHigh(bv_col0_0, bv_col1_0));
+                dot = vmmlaq_s32(dot, ZipLow(av_row0_1, av_row1_1), ZipLow(bv_col0_1, bv_col1_1));
+                dot = vmmlaq_s32(dot, ZipHigh(av_row0_1, av_row1_1), ZipHigh(bv_col0_1, bv_col1_1));
+
+                QuantBDataPtr += 16;
+            }
+        }
+
+        // multiply by scale and update accumulator
+        acc = vfmaq_f32(acc, vcvtq_f32_s32(dot), vld1q_f32(scales));
+
+        // increment other block pointers
+
+        QuantAPtr += Q8BlkSize(BlkLen);
+        QuantBScalePtr += 1;
+
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointPtr += ((k_blk_idx & 1) == 0) ? 0 : 1;
+        }
+    }
+
+    if (BiasPtr != nullptr) {
+        const float32x2_t bias = vld1_f32(BiasPtr);
+        acc = vaddq_f32(acc, vcombine_f32(bias, bias));
+    }
+
+    vst1_f32(SumPtr, vget_low_f32(acc));
+    vst1_f32(SumPtr + ldc, vget_high_f32(acc));
+}
+
+template <bool HasZeroPoint>
+void
+SQ4BitGemmKernel_CompInt8_I8mm_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t StrideQuantA = BlockCountK * Q8BlkSize(BlkLen);
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    const size_t CountM2 = CountM & ~size_t{1};
+    const size_t CountN2 = CountN & ~size_t{1};
+
+    const std::byte* QuantARowPtr = QuantA;
+
+    float* SumRowPtr = C;
+
+    for (size_t m = 0; m < CountM2; m += 2) {
+        const std::byte* QuantBDataColPtr = QuantBData;
+        const float* QuantBScaleColPtr = QuantBScale;
+        const std::byte* QuantBZeroPointColPtr = QuantBZeroPoint;
+
+        const float* BiasPtr = Bias;
+
+        float* SumPtr = SumRowPtr;
+
+        for (size_t n = 0; n < CountN2; n += 2) {
+            // Compute 2x2 tiles of output
+            SQ4BitGemm_CompInt8_I8mm_Compute2x2<HasZeroPoint>(
+                BlkLen,
+                QuantARowPtr,
+                QuantBDataColPtr,
+                QuantBScaleColPtr,
+                QuantBZeroPointColPtr,
+                BiasPtr,
+                SumPtr,
+                BlockCountK,
+                StrideQuantA,
+                StrideQuantBData,
+                StrideQuantBScale,
+                StrideQuantBZeroPoint,
+                ldc
+            );
+
+            // Move to next 2 columns
+            QuantBDataColPtr += 2 * StrideQuantBData;
+            QuantBScaleColPtr += 2 * StrideQuantBScale;
+            if constexpr (HasZeroPoint) {
+                QuantBZeroPointColPtr += 2 * StrideQuantBZeroPoint;
+            }
+
+            BiasPtr += BiasPtr != nullptr ? 2 : 0;
+            SumPtr += 2;
+        }
+
+        // Move to next 2 rows
+        QuantARowPtr += 2 * StrideQuantA;
+        SumRowPtr += 2 * ldc;
+    }
+
+    // Compute the last column of the even rows and the last row with the dot product kernel
+    if (CountM2 > 0 && CountN2 < CountN) {
+        SQ4BitGemmKernel_CompInt8(
+            BlkLen,
+            QuantA,
+            QuantBData + CountN2 * StrideQuantBData,
+            QuantBScale + CountN2 * StrideQuantBScale,
+            HasZeroPoint ? QuantBZeroPoint + CountN2 * StrideQuantBZeroPoint : nullptr,
+            C + CountN2,
+            CountM2,
+            CountN - CountN2,
+            0,
+            BlockCountK,
+            ldc,
+            Bias != nullptr ? Bias + CountN2 : nullptr
+        );
+    }
+
+    if (CountM2 < CountM) {
+        SQ4BitGemmKernel_CompInt8(
+            BlkLen,
+            QuantARowPtr,
+            QuantBData,
+            QuantBScale,
+            QuantBZeroPoint,
+            SumRowPtr,
+            CountM - CountM2,
+            CountN,
+            0,
+            BlockCountK,
+            ldc,
+            Bias
+        );
+    }
+}
+
+}  // namespace
+
+size_t
+SQ4BitGemmKernel_CompInt8_I8mm(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        constexpr bool HasZeroPoint = true;
+        SQ4BitGemmKernel_CompInt8_I8mm_Impl<HasZeroPoint>(
+            BlkLen,
+            QuantA,
+            QuantBData,
+            QuantBScale,
+            QuantBZeroPoint,
+            C,
+            CountM,
+            CountN,
+            BlockCountK,
+            ldc,
+            Bias
+        );
+    } else {
+        constexpr bool HasZeroPoint = false;
+        SQ4BitGemmKernel_CompInt8_I8mm_Impl<HasZeroPoint>(
+            BlkLen,
+            QuantA,
+            QuantBData,
+            QuantBScale,
+            QuantBZeroPoint,
+            C,
+            CountM,
+            CountN,
+            BlockCountK,
+            ldc,
+            Bias
+        );
+    }
+
+    return CountM;
+}
+
+}  // namespace sqnbitgemm_neon
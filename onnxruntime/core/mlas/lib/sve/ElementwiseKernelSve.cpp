@@ -0,0 +1,532 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    ElementwiseKernelSve.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential, logistic and
+    hyperbolic tangent functions and for the softmax operation using ARM SVE
+    intrinsics.
+
+    The kernels are vector length agnostic and process the tail of a buffer
+    with a predicate instead of a scalar loop. They use the same polynomial
+    approximations and constants as the generic kernels.
+
+    This module must be compiled with SVE support (e.g. -march=armv8.2-a+sve)
+    and is only used when the processor reports SVE support at runtime.
+
+--*/
+
+#include "../mlasi.h"
+
+#if defined(MLAS_USE_SVE)
+
+#include <arm_sve.h>
+
+//
+// Layouts of the constants defined in compute.cpp, logistic.cpp and tanh.cpp.
+//
+
+struct MLAS_SVE_EXP_CONSTANTS {
+    float LowerRange;
+    float UpperRange;
+    float LowerRangeSumExp;
+    float UpperRangeSumExp;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_56;
+    int32_t MinimumExponent;
+    int32_t MaximumExponent;
+};
+
+struct MLAS_SVE_LOGISTIC_CONSTANTS {
+    float LowerRange;
+    float UpperRange;
+    float alpha_9;
+    float alpha_7;
+    float alpha_5;
+    float alpha_3;
+    float alpha_1;
+    float beta_10;
+    float beta_8;
+    float beta_6;
+    float beta_4;
+    float beta_2;
+    float beta_0;
+    float one_half;
+};
+
+struct MLAS_SVE_TANH_CONSTANTS {
+    float LowerRange;
+    float UpperRange;
+    float alpha_13;
+    float alpha_11;
+    float alpha_9;
+    float alpha_7;
+    float alpha_5;
+    float alpha_3;
+    float alpha_1;
+    float beta_6;
+    float beta_4;
+    float beta_2;
+    float beta_0;
+};
+
+MLAS_INTERNAL_DATA const MLAS_SVE_EXP_CONSTANTS MlasExpConstants;
+MLAS_INTERNAL_DATA const MLAS_SVE_LOGISTIC_CONSTANTS MlasLogisticConstants;
+MLAS_INTERNAL_DATA const MLAS_SVE_TANH_CONSTANTS MlasTanhConstants;
+
+MLAS_FORCEINLINE
+svbool_t
+MlasSveWhileLessThan(
+    size_t Index,
+    size_t N
+    )
+{
+    return svwhilelt_b32_u64(uint64_t(Index), uint64_t(N));
+}
+
+MLAS_FORCEINLINE
+svfloat32_t
+MlasSveComputeExpVector(
+    svbool_t pg,
+    svfloat32_t Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for the supplied vector.
+
+    See MlasComputeExpVector for the details of the algorithm.
+
+Arguments:
+
+    pg - Supplies the predicate of the active elements.
+
+    Vector - Supplies the values to operate on.
+
+Return Value:
+
+    Returns the exponential function of the input.
+
+--*/
+{
+    const auto& Constants = MlasExpConstants;
+
+    Vector = svmax_n_f32_x(pg, Vector, Constants.LowerRange);
+    Vector = svmin_n_f32_x(pg, Vector, Constants.UpperRange);
+
+    //
+    // Range reduction of the input by computing "(2 ^ m) * exp(reduced)".
+    //
+
+    const svfloat32_t RoundingBias = svdup_n_f32(Constants.RoundingBias);
+
+    svfloat32_t biased = svmla_n_f32_x(pg, RoundingBias, Vector, Constants.Log2Reciprocal);
+    svfloat32_t m = svsub_f32_x(pg, biased, RoundingBias);
+
+    Vector = svmla_n_f32_x(pg, Vector, m, Constants.Log2High);
+    Vector = svmla_n_f32_x(pg, Vector, m, Constants.Log2Low);
+
+    //
+    // Compute the two scaling factors used to reconstruct the "(2 ^ m)" value
+    // for exponents [-150, 128].
+    //
+
+    svint32_t overflow = svlsl_n_s32_x(pg, svreinterpret_s32_f32(biased), 23);
+    svint32_t normal = svmin_n_s32_x(pg, overflow, Constants.MaximumExponent);
+    normal = svmax_n_s32_x(pg, normal, Constants.MinimumExponent);
+    overflow = svsub_s32_x(pg, overflow, normal);
+    overflow = svadd_n_s32_x(pg, overflow, Constants.MaximumExponent);
+    normal = svadd_n_s32_x(pg, normal, Constants.MaximumExponent);
+
+    //
+    // Compute the polynomial approximation of exp(reduced) and reconstruct
+    // the final result using the above scaling factors.
+    //
+
+    svfloat32_t p = svdup_n_f32(Constants.poly_0);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_1);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_2);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_3);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_4);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_56);
+
+    Vector = svmul_f32_x(pg, Vector, svreinterpret_f32_s32(overflow));
+    p = svmad_f32_x(pg, p, Vector, svreinterpret_f32_s32(overflow));
+    p = svmul_f32_x(pg, p, svreinterpret_f32_s32(normal));
+
+    return p;
+}
+
+MLAS_FORCEINLINE
+svfloat32_t
+MlasSveComputeSumExpVector(
+    svbool_t pg,
+    svfloat32_t Vector,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for the supplied vector
+    after subtracting the maximum value.
+
+    See MlasComputeSumExpVector for the details of the algorithm.
+
+Arguments:
+
+    pg - Supplies the predicate of the active elements.
+
+    Vector - Supplies the values to operate on.
+
+    NegativeMaximum - Supplies the negative maximum value that is added to
+        each element before computing the exponential function.
+
+Return Value:
+
+    Returns the exponential function of the input.
+
+--*/
+{
+    const auto& Constants = MlasExpConstants;
+
+    Vector = svadd_n_f32_x(pg, Vector, NegativeMaximum);
+    Vector = svmax_n_f32_x(pg, Vector, Constants.LowerRangeSumExp);
+
+    const svfloat32_t RoundingBias = svdup_n_f32(Constants.RoundingBias);
+
+    svfloat32_t biased = svmla_n_f32_x(pg, RoundingBias, Vector, Constants.Log2Reciprocal);
+    svfloat32_t m = svsub_f32_x(pg, biased, RoundingBias);
+
+    Vector = svmla_n_f32_x(pg, Vector, m, Constants.Log2High);
+    Vector = svmla_n_f32_x(pg, Vector, m, Constants.Log2Low);
+
+    svint32_t normal = svlsl_n_s32_x(pg, svreinterpret_s32_f32(biased), 23);
+    normal = svadd_n_s32_x(pg, normal, Constants.MaximumExponent);
+
+    svfloat32_t p = svdup_n_f32(Constants.poly_0);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_1);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_2);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_3);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_4);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_56);
+    p = svmad_n_f32_x(pg, p, Vector, Constants.poly_56);
+
+    p = svmul_f32_x(pg, p, svreinterpret_f32_s32(normal));
+
+    return p;
+}
+
+void
+MLASCALL
+MlasComputeExpF32KernelSve(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        svst1_f32(pg, Output + i, MlasSveComputeExpVector(pg, svld1_f32(pg, Input + i)));
+    }
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32KernelSve(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel for the sum of exponential
+    functions.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. When used for Softmax,
+        the output buffer is used to store the intermediate exp() results. When
+        used for LogSoftmax, the intermediate exp() results are not required.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the address of the negative maximum
+        value that is added to each element before computing the exponential
+        function.
+
+Return Value:
+
+    Returns the sum of the exponential functions.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const float NegativeMaximumValue = *NegativeMaximum;
+
+    //
+    // N.B. The inactive elements of the last vector are not accumulated.
+    //
+
+    svfloat32_t Accumulator = svdup_n_f32(0.0f);
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        svfloat32_t Vector = MlasSveComputeSumExpVector(pg, svld1_f32(pg, Input + i), NegativeMaximumValue);
+        Accumulator = svadd_f32_m(pg, Accumulator, Vector);
+
+        if (Output != nullptr) {
+            svst1_f32(pg, Output + i, Vector);
+        }
+    }
+
+    return svaddv_f32(svptrue_b32(), Accumulator);
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32KernelSve(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel to find the maximum value of the
+    supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value of the supplied buffer.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+
+    svfloat32_t Maximum = svdup_n_f32(std::numeric_limits<float>::lowest());
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        Maximum = svmax_f32_m(pg, Maximum, svld1_f32(pg, Input + i));
+    }
+
+    return svmaxv_f32(svptrue_b32(), Maximum);
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32KernelSve(
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel to produce the final output for
+    the softmax operation.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the scale value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const float Scale = Parameters[0];
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        svst1_f32(pg, Output + i, svmul_n_f32_x(pg, svld1_f32(pg, Output + i), Scale));
+    }
+}
+
+void
+MLASCALL
+MlasLogisticKernelSve(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel for the logistic function.
+
+    N.B. FMAX and FMIN propagate a NaN input to the output as required.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto& Constants = MlasLogisticConstants;
+    const size_t VectorLength = svcntw();
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        svfloat32_t Value = svld1_f32(pg, Input + i);
+
+        Value = svmax_n_f32_x(pg, Value, Constants.LowerRange);
+        Value = svmin_n_f32_x(pg, Value, Constants.UpperRange);
+
+        const svfloat32_t ValueSquared = svmul_f32_x(pg, Value, Value);
+
+        svfloat32_t p = svdup_n_f32(Constants.alpha_9);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_7);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_5);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_3);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_1);
+        p = svmul_f32_x(pg, p, Value);
+
+        svfloat32_t q = svdup_n_f32(Constants.beta_10);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_8);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_6);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_4);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_2);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_0);
+
+        svst1_f32(pg, Output + i, svadd_n_f32_x(pg, svdiv_f32_x(pg, p, q), Constants.one_half));
+    }
+}
+
+void
+MLASCALL
+MlasTanhKernelSve(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel for the hyperbolic tangent function.
+
+    N.B. FMAX and FMIN propagate a NaN input to the output as required.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto& Constants = MlasTanhConstants;
+    const size_t VectorLength = svcntw();
+
+    for (size_t i = 0; i < N; i += VectorLength) {
+
+        const svbool_t pg = MlasSveWhileLessThan(i, N);
+
+        svfloat32_t Value = svld1_f32(pg, Input + i);
+
+        Value = svmax_n_f32_x(pg, Value, Constants.LowerRange);
+        Value = svmin_n_f32_x(pg, Value, Constants.UpperRange);
+
+        const svfloat32_t ValueSquared = svmul_f32_x(pg, Value, Value);
+
+        svfloat32_t p = svdup_n_f32(Constants.alpha_13);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_11);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_9);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_7);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_5);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_3);
+        p = svmad_n_f32_x(pg, p, ValueSquared, Constants.alpha_1);
+        p = svmul_f32_x(pg, p, Value);
+
+        svfloat32_t q = svdup_n_f32(Constants.beta_6);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_4);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_2);
+        q = svmad_n_f32_x(pg, q, ValueSquared, Constants.beta_0);
+
+        svst1_f32(pg, Output + i, svdiv_f32_x(pg, p, q));
+    }
+}
+
+#endif // MLAS_USE_SVE
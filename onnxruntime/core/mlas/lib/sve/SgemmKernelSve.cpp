@@ -0,0 +1,310 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    SgemmKernelSve.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision matrix/matrix
+    multiply operation (SGEMM) using ARM SVE intrinsics.
+
+    The kernels are vector length agnostic: each 16 column block of the packed
+    matrix B is processed in chunks of the hardware vector length, and the
+    columns past the end of a partial block are masked off with a predicate.
+
+    This module must be compiled with SVE support (e.g. -march=armv8.2-a+sve)
+    and is only used when the processor reports SVE support at runtime.
+
+--*/
+
+#include "../mlasi.h"
+
+#if defined(MLAS_USE_SVE)
+
+#include <arm_sve.h>
+
+//
+// Define the width of a block of columns of the packed matrix B, see
+// MlasSgemmCopyPackB.
+//
+
+constexpr size_t MlasSgemmSvePackedStrideN = 16;
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmSveStoreRow(
+    svbool_t pg,
+    svfloat32_t Accumulator,
+    float* C,
+    float alpha
+    )
+{
+    svfloat32_t Result = svmul_n_f32_x(pg, Accumulator, alpha);
+
+    if (!ZeroMode) {
+        Result = svadd_f32_x(pg, Result, svld1_f32(pg, C));
+    }
+
+    svst1_f32(pg, C, Result);
+}
+
+template<size_t RowCount, bool ZeroMode>
+void
+MlasSgemmSveKernelRows(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for
+    RowCount rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(RowCount >= 1 && RowCount <= 4, "unsupported row count");
+
+    //
+    // N.B. The operations of a chunk are limited to the width of a block for
+    // vector lengths wider than 512 bits.
+    //
+
+    const size_t VectorLength = std::min<size_t>(svcntw(), MlasSgemmSvePackedStrideN);
+
+    while (CountN > 0) {
+
+        const size_t BlockColumns = std::min(CountN, MlasSgemmSvePackedStrideN);
+
+        for (size_t n = 0; n < BlockColumns; n += VectorLength) {
+
+            const svbool_t pg = svwhilelt_b32_u64(uint64_t(n), uint64_t(std::min(BlockColumns, n + VectorLength)));
+
+            svfloat32_t Row0Block = svdup_n_f32(0.0f);
+            svfloat32_t Row1Block = svdup_n_f32(0.0f);
+            svfloat32_t Row2Block = svdup_n_f32(0.0f);
+            svfloat32_t Row3Block = svdup_n_f32(0.0f);
+
+            const float* a = A;
+            const float* b = B + n;
+
+            for (size_t k = CountK; k > 0; k--) {
+
+                const svfloat32_t BElements = svld1_f32(pg, b);
+
+                Row0Block = svmla_n_f32_x(pg, Row0Block, BElements, a[0]);
+
+                if (RowCount >= 2) {
+                    Row1Block = svmla_n_f32_x(pg, Row1Block, BElements, a[lda]);
+                }
+
+                if (RowCount >= 3) {
+                    Row2Block = svmla_n_f32_x(pg, Row2Block, BElements, a[lda * 2]);
+                }
+
+                if (RowCount >= 4) {
+                    Row3Block = svmla_n_f32_x(pg, Row3Block, BElements, a[lda * 3]);
+                }
+
+                a += 1;
+                b += MlasSgemmSvePackedStrideN;
+            }
+
+            MlasSgemmSveStoreRow<ZeroMode>(pg, Row0Block, C + n, alpha);
+
+            if (RowCount >= 2) {
+                MlasSgemmSveStoreRow<ZeroMode>(pg, Row1Block, C + ldc + n, alpha);
+            }
+
+            if (RowCount >= 3) {
+                MlasSgemmSveStoreRow<ZeroMode>(pg, Row2Block, C + ldc * 2 + n, alpha);
+            }
+
+            if (RowCount >= 4) {
+                MlasSgemmSveStoreRow<ZeroMode>(pg, Row3Block, C + ldc * 3 + n, alpha);
+            }
+        }
+
+        B += CountK * MlasSgemmSvePackedStrideN;
+        C += BlockColumns;
+        CountN -= BlockColumns;
+    }
+}
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+size_t
+MlasSgemmSveKernel(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasSgemmSveKernelRows<1, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            return 1;
+        case 2:
+            MlasSgemmSveKernelRows<2, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            return 2;
+        case 3:
+            MlasSgemmSveKernelRows<3, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            return 3;
+        default:
+            MlasSgemmSveKernelRows<4, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            return 4;
+    }
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelZeroSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows, overwriting the output matrix.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmSveKernel<true>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelAddSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows, accumulating into the output matrix.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmSveKernel<false>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+#endif // MLAS_USE_SVE
@@ -542,10 +542,11 @@ MlasTranspose8xNVector(
 }
 
 void
-MLASCALL
-MlasTranspose(
+MlasTransposeStrided(
     const uint32_t* Input,
+    size_t InputStride,
     uint32_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -554,14 +555,21 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns), where the rows of both matrices may
+    be strided within a larger tensor.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -592,9 +600,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -603,15 +611,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -628,9 +636,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -639,17 +647,53 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeStrided(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -668,10 +712,11 @@ MlasTranspose(
 
 
 void
-MLASCALL
-MlasTranspose(
+MlasTransposeStrided(
     const uint16_t* Input,
+    size_t InputStride,
     uint16_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -680,14 +725,21 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns), where the rows of both matrices may
+    be strided within a larger tensor.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -717,9 +769,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -728,15 +780,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -753,9 +805,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -764,23 +816,60 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
-
 void
 MLASCALL
 MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeStrided(Input, N, Output, M, M, N);
+}
+
+
+void
+MlasTransposeStrided(
     const uint8_t* Input,
+    size_t InputStride,
     uint8_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -789,14 +878,21 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns), where the rows of both matrices may
+    be strided within a larger tensor.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -823,24 +919,24 @@ Return Value:
         size_t m = M;
         while (m >= 16) {
 
-            MlasTranspose16x16Block(s, N, d, M);
+            MlasTranspose16x16Block(s, InputStride, d, OutputStride);
 
-            s += N * 16;
+            s += InputStride * 16;
             d += 16;
             m -= 16;
         }
 
         while (m > 0) {
 
-            MlasTranspose16xNVector(s, 1, d, M);
+            MlasTranspose16xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 16;
-        Output += M * 16;
+        Output += OutputStride * 16;
         n -= 16;
     }
 #endif
@@ -854,9 +950,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8x8Block(s, N, d, M);
+            MlasTranspose8x8Block(s, InputStride, d, OutputStride);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -865,15 +961,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose8xNVector(s, 1, d, M);
+            MlasTranspose8xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 8;
-        Output += M * 8;
+        Output += OutputStride * 8;
         n -= 8;
     }
 
@@ -890,9 +986,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8xNVector(s, N, d, 1);
+            MlasTranspose8xNVector(s, InputStride, d, 1);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -901,17 +997,53 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeStrided(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -926,3 +1058,389 @@ MlasTranspose(
         M,
         N);
 }
+
+void
+MlasTransposeStrided(
+    const uint64_t* Input,
+    size_t InputStride,
+    uint64_t* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) of 8-byte
+    elements to the output matrix (N rows by M columns). There is no vector
+    block transpose for 8-byte elements, so the columns are transposed four at
+    a time to keep four output rows streaming.
+
+Arguments:
+
+    See the 4-byte element variant.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t n = N;
+
+    while (n >= 4) {
+
+        const uint64_t* s = Input;
+        uint64_t* d = Output;
+        size_t m = M;
+
+        while (m > 0) {
+
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
+
+            s += InputStride;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += 4;
+        Output += OutputStride * 4;
+        n -= 4;
+    }
+
+    while (n > 0) {
+
+        const uint64_t* s = Input;
+        uint64_t* d = Output;
+        size_t m = M;
+
+        while (m > 0) {
+
+            d[0] = s[0];
+
+            s += InputStride;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += 1;
+        Output += OutputStride;
+        n -= 1;
+    }
+}
+
+//
+// Define the maximum number of axes of a tensor to transpose after the axes
+// of size one are removed and the adjacent axes that stay in order are merged.
+//
+
+#define MLAS_TRANSPOSE_MAXIMUM_AXES             16
+
+//
+// Define the number of rows and columns of a tile of the two dimensional
+// transposes, so that the rows of a tile stay in the caches.
+//
+
+#define MLAS_TRANSPOSE_TILE_SIZE                64
+
+//
+// Define the minimum number of bytes to transpose per thread.
+//
+
+#define MLAS_TRANSPOSE_THREAD_BYTES             (size_t(64) * size_t(1024))
+
+template<typename ElementType>
+void
+MlasTransposeTiles(
+    const ElementType* Input,
+    ElementType* Output,
+    size_t AxisCount,
+    const size_t* Dims,
+    const size_t* InputStrides,
+    const size_t* OutputStrides,
+    size_t InnerAxis,
+    size_t WorkIndex,
+    size_t WorkCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a range of the tiles of a tensor. The input axis
+    with unit stride (InnerAxis) and the output axis with unit stride (the last
+    axis) form the tiles, which are transposed by MlasTransposeStrided, and the
+    remaining axes index the tiles.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    AxisCount - Supplies the number of axes.
+
+    Dims - Supplies the dimensions of the output axes.
+
+    InputStrides - Supplies the input strides of the output axes.
+
+    OutputStrides - Supplies the output strides of the output axes.
+
+    InnerAxis - Supplies the output axis with unit input stride.
+
+    WorkIndex - Supplies the index of the first tile to transpose.
+
+    WorkCount - Supplies the number of tiles to transpose.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t LastAxis = AxisCount - 1;
+    const size_t TilesM = (Dims[LastAxis] + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+    const size_t TilesN = (Dims[InnerAxis] + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+
+    for (size_t w = WorkIndex; w < WorkIndex + WorkCount; w++) {
+
+        //
+        // Decode the tile within the plane of the two axes and then the
+        // position of the plane from the other axes.
+        //
+
+        const size_t tm = w % TilesM;
+        const size_t tn = (w / TilesM) % TilesN;
+        size_t Outer = w / (TilesM * TilesN);
+
+        size_t InputOffset = tm * MLAS_TRANSPOSE_TILE_SIZE * InputStrides[LastAxis] + tn * MLAS_TRANSPOSE_TILE_SIZE;
+        size_t OutputOffset = tn * MLAS_TRANSPOSE_TILE_SIZE * OutputStrides[InnerAxis] + tm * MLAS_TRANSPOSE_TILE_SIZE;
+
+        for (size_t a = LastAxis; a-- > 0;) {
+            if (a != InnerAxis) {
+                const size_t Index = Outer % Dims[a];
+                Outer /= Dims[a];
+                InputOffset += Index * InputStrides[a];
+                OutputOffset += Index * OutputStrides[a];
+            }
+        }
+
+        const size_t CountM = std::min(Dims[LastAxis] - tm * MLAS_TRANSPOSE_TILE_SIZE, size_t(MLAS_TRANSPOSE_TILE_SIZE));
+        const size_t CountN = std::min(Dims[InnerAxis] - tn * MLAS_TRANSPOSE_TILE_SIZE, size_t(MLAS_TRANSPOSE_TILE_SIZE));
+
+        MlasTransposeStrided(Input + InputOffset, InputStrides[LastAxis], Output + OutputOffset,
+            OutputStrides[InnerAxis], CountM, CountN);
+    }
+}
+
+bool
+MLASCALL
+MlasTransposeTensor(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a tensor by an arbitrary permutation of its axes.
+
+    The axes of size one are removed and the adjacent output axes that are
+    also adjacent and in order in the input are merged. If the merged last
+    axis is contiguous in the input, the rows of that axis are copied.
+    Otherwise the tensor is transposed as tiles formed by the last output axis
+    and the output axis that is contiguous in the input. The rows or the tiles
+    are partitioned across the threads.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    ElementSize - Supplies the size in bytes of an element, one of 1, 2, 4 or
+        8.
+
+    Rank - Supplies the number of axes of the tensor.
+
+    InputShape - Supplies the dimensions of the input tensor.
+
+    Permutation - Supplies the input axis of each output axis.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the tensor was transposed, else false if the element size
+    is not supported or the permutation has too many axes after merging, in
+    which case the caller should use a generic transpose.
+
+--*/
+{
+    size_t Dims[MLAS_TRANSPOSE_MAXIMUM_AXES];
+    size_t InputStrides[MLAS_TRANSPOSE_MAXIMUM_AXES];
+    size_t OutputStrides[MLAS_TRANSPOSE_MAXIMUM_AXES];
+    size_t AxisCount = 0;
+    size_t ElementCount = 1;
+
+    if (ElementSize != 1 && ElementSize != 2 && ElementSize != 4 && ElementSize != 8) {
+        return false;
+    }
+
+    for (size_t i = 0; i < Rank; i++) {
+
+        const size_t Axis = Permutation[i];
+        const size_t Dim = InputShape[Axis];
+
+        ElementCount *= Dim;
+
+        if (Dim == 1) {
+            continue;
+        }
+
+        size_t InputStride = 1;
+
+        for (size_t j = Axis + 1; j < Rank; j++) {
+            InputStride *= InputShape[j];
+        }
+
+        //
+        // Merge the axis into the previous output axis if the two axes are
+        // adjacent in the input.
+        //
+
+        if (AxisCount > 0 && InputStrides[AxisCount - 1] == InputStride * Dim) {
+            Dims[AxisCount - 1] *= Dim;
+            InputStrides[AxisCount - 1] = InputStride;
+            continue;
+        }
+
+        if (AxisCount == MLAS_TRANSPOSE_MAXIMUM_AXES) {
+            return false;
+        }
+
+        Dims[AxisCount] = Dim;
+        InputStrides[AxisCount] = InputStride;
+        AxisCount++;
+    }
+
+    if (ElementCount == 0) {
+        return true;
+    }
+
+    //
+    // Handle the case of a copy, in which the order of the axes is unchanged.
+    //
+
+    if (AxisCount <= 1) {
+        std::copy_n(static_cast<const uint8_t*>(Input), ElementCount * ElementSize, static_cast<uint8_t*>(Output));
+        return true;
+    }
+
+    size_t OutputStride = 1;
+
+    for (size_t a = AxisCount; a-- > 0;) {
+        OutputStrides[a] = OutputStride;
+        OutputStride *= Dims[a];
+    }
+
+    const size_t LastAxis = AxisCount - 1;
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(ElementCount * ElementSize / MLAS_TRANSPOSE_THREAD_BYTES) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (InputStrides[LastAxis] == 1) {
+
+        //
+        // Copy the rows of the last axis, which are contiguous in both the
+        // input and the output.
+        //
+
+        const size_t RowCount = ElementCount / Dims[LastAxis];
+        const size_t RowBytes = Dims[LastAxis] * ElementSize;
+
+        if (size_t(TargetThreadCount) > RowCount) {
+            TargetThreadCount = ptrdiff_t(RowCount);
+        }
+
+        MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+            size_t RowIndex;
+            size_t RowRemaining;
+
+            MlasPartitionWork(tid, TargetThreadCount, RowCount, &RowIndex, &RowRemaining);
+
+            for (size_t r = RowIndex; r < RowIndex + RowRemaining; r++) {
+
+                size_t Outer = r;
+                size_t InputOffset = 0;
+
+                for (size_t a = LastAxis; a-- > 0;) {
+                    InputOffset += (Outer % Dims[a]) * InputStrides[a];
+                    Outer /= Dims[a];
+                }
+
+                std::copy_n(static_cast<const uint8_t*>(Input) + InputOffset * ElementSize, RowBytes,
+                            static_cast<uint8_t*>(Output) + r * RowBytes);
+            }
+        });
+
+        return true;
+    }
+
+    //
+    // Find the output axis which is contiguous in the input. The merging of
+    // the adjacent axes leaves exactly one such axis and it is not the last.
+    //
+
+    size_t InnerAxis = 0;
+
+    while (InputStrides[InnerAxis] != 1) {
+        InnerAxis++;
+    }
+
+    const size_t TilesM = (Dims[LastAxis] + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+    const size_t TilesN = (Dims[InnerAxis] + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+    const size_t TileCount = TilesM * TilesN * (ElementCount / (Dims[LastAxis] * Dims[InnerAxis]));
+
+    if (size_t(TargetThreadCount) > TileCount) {
+        TargetThreadCount = ptrdiff_t(TileCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t TileIndex;
+        size_t TileRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TileCount, &TileIndex, &TileRemaining);
+
+        switch (ElementSize) {
+            case 1:
+                MlasTransposeTiles(static_cast<const uint8_t*>(Input), static_cast<uint8_t*>(Output),
+                    AxisCount, Dims, InputStrides, OutputStrides, InnerAxis, TileIndex, TileRemaining);
+                break;
+            case 2:
+                MlasTransposeTiles(static_cast<const uint16_t*>(Input), static_cast<uint16_t*>(Output),
+                    AxisCount, Dims, InputStrides, OutputStrides, InnerAxis, TileIndex, TileRemaining);
+                break;
+            case 4:
+                MlasTransposeTiles(static_cast<const uint32_t*>(Input), static_cast<uint32_t*>(Output),
+                    AxisCount, Dims, InputStrides, OutputStrides, InnerAxis, TileIndex, TileRemaining);
+                break;
+            default:
+                MlasTransposeTiles(static_cast<const uint64_t*>(Input), static_cast<uint64_t*>(Output),
+                    AxisCount, Dims, InputStrides, OutputStrides, InnerAxis, TileIndex, TileRemaining);
+                break;
+        }
+    });
+
+    return true;
+}
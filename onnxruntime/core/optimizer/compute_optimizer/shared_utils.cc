@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 
 #include <onnx/defs/attr_proto_util.h>
 #include "core/framework/random_seed.h"
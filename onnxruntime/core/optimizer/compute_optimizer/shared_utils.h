@@ -3,7 +3,7 @@
 
 // The optimization here ideally is applicable to both training and inferencing,
 // while so far we mainly validate on training during cooking the optimization.
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 #pragma once
 
 #include <initializer_list>
@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 
 #include <onnx/defs/attr_proto_util.h>
 #include "core/common/string_utils.h"
@@ -52,9 +52,16 @@ UpStreamGatherGraphTransformer::UpStreamGatherGraphTransformer(
       {utils::GetFullQualifiedOpName("MatMul", kOnnxDomain),
        OpPassThroughConfig<UpStreamGatherOperatorActorBase>(std::make_shared<MatMulGatherActor>(),
                                                             opset_13_9_1)},
+      {utils::GetFullQualifiedOpName("MatMulNBits", kMSDomain),
+       OpPassThroughConfig<UpStreamGatherOperatorActorBase>(std::make_shared<MatMulNBitsGatherActor>(),
+                                                            opset_1)},
       {utils::GetFullQualifiedOpName("Reshape", kOnnxDomain),
        OpPassThroughConfig<UpStreamGatherOperatorActorBase>(std::make_shared<ReshapeGatherActor>(),
                                                             opset_19_14_13_5_1)},
+      {// Be noted, this is our own implementation of ONNX domain op.
+       utils::GetFullQualifiedOpName("SimplifiedLayerNormalization", kOnnxDomain),
+       OpPassThroughConfig<UpStreamGatherOperatorActorBase>(std::make_shared<LayerNormalizationGatherActor>(),
+                                                            opset_1)},
       {utils::GetFullQualifiedOpName("Softmax", kOnnxDomain),
        OpPassThroughConfig<UpStreamGatherOperatorActorBase>(std::make_shared<SoftmaxGatherActor>(),
                                                             opset_13_11_1)},
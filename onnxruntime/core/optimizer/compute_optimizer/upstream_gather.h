@@ -1,9 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-// The optimization here ideally applies to both training and inferencing,
-// while so far we mainly validate training during cooking the optimization.
-#ifdef ENABLE_TRAINING
+// The optimization here applies to both training and inferencing. Inference sessions run it at Level2.
+#if !defined(ORT_MINIMAL_BUILD)
 #pragma once
 
 #include "core/optimizer/compute_optimizer/upstream_transformer_base.h"
@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 
 #include <onnx/defs/attr_proto_util.h>
 #include "core/graph/graph_utils.h"
@@ -16,6 +16,24 @@ namespace onnxruntime::optimizer::compute_optimizer {
 // Put some utils in anonymous namespace
 namespace {
 
+// LayerNormalization and SimplifiedLayerNormalization normalize over the last dimension by default.
+int64_t GetLayerNormAxis(const Node& node) {
+  const auto& attributes = node.GetAttributes();
+  auto axis_it = attributes.find("axis");
+  return axis_it != attributes.end() ? static_cast<int64_t>(axis_it->second.i()) : -1;
+}
+
+// Softmax before opset 13 defaults to axis 1 and normalizes over the input flattened to 2D at the axis.
+// Since opset 13 it defaults to the last dimension.
+int64_t GetSoftmaxAxis(const Node& node) {
+  const auto& attributes = node.GetAttributes();
+  auto axis_it = attributes.find("axis");
+  if (axis_it != attributes.end()) {
+    return static_cast<int64_t>(axis_it->second.i());
+  }
+  return node.SinceVersion() < 13 ? 1 : -1;
+}
+
 /**
  * @brief From given TensorShape, update specified dimension with given value.
  * If no new_dim is provided, the dimension will be removed.
@@ -425,7 +443,7 @@ bool LayerNormalizationGatherActor::PreCheck(const Graph& /* graph */,
                                              std::unordered_map<int, int>& propagate_input_indices,
                                              std::unordered_map<int, std::vector<DimCompare>>& all_input_cmp_rets,
                                              std::function<void(Node& node)>& shape_update_func) {
-  auto axis = static_cast<int64_t>(current_node.GetAttributes().at("axis").i());
+  auto axis = GetLayerNormAxis(current_node);
   axis = axis < 0 ? axis + current_node.InputDefs()[0]->Shape()->dim_size() : axis;
 
   // Make sure LayerNormalization's reduction happens after the axis we want to slice.
@@ -471,7 +489,7 @@ bool LayerNormalizationGatherActor::PostProcess(Graph& /*graph*/, Node& current_
                                                 const std::unordered_map<int, SliceInfo>& /*new_gather_infos*/) {
   // Update LayerNormalization's axis attribute if it is scalar slice.
   if (info_without_node.is_scalar_slice) {
-    auto axis = static_cast<int64_t>(current_node.GetAttributes().at("axis").i());
+    auto axis = GetLayerNormAxis(current_node);
     auto original_ln_input_rank = info_without_node.input_rank;
     axis = axis < 0 ? axis + original_ln_input_rank : axis;
     auto new_axis = axis - 1;
@@ -488,7 +506,7 @@ bool SoftmaxGatherActor::PreCheck(const Graph& graph, const Node& current_node,
                                   std::unordered_map<int, int>& propagate_input_indices,
                                   std::unordered_map<int, std::vector<DimCompare>>& all_input_cmp_rets,
                                   std::function<void(Node& node)>& shape_update_func) {
-  auto axis = static_cast<int64_t>(current_node.GetAttributes().at("axis").i());
+  auto axis = GetSoftmaxAxis(current_node);
   axis = axis < 0 ? axis + current_node.InputDefs()[0]->Shape()->dim_size() : axis;
 
   // Make sure Softmax's reduction happens after the axis we want to slice.
@@ -510,7 +528,7 @@ bool SoftmaxGatherActor::PostProcess(Graph& graph, Node& current_node, const Sli
 
   // Update Softmax's axis attribute if it is scalar slice.
   if (info_without_node.is_scalar_slice) {
-    auto axis = static_cast<int64_t>(current_node.GetAttributes().at("axis").i());
+    auto axis = GetSoftmaxAxis(current_node);
     auto original_ln_input_rank = info_without_node.input_rank;
     axis = axis < 0 ? axis + original_ln_input_rank : axis;
     auto new_axis = axis - 1;
@@ -768,6 +786,39 @@ bool MatMulGatherActor::PostProcess(
   return true;
 }
 
+bool MatMulNBitsGatherActor::PreCheck(const Graph& /* graph */, const Node& current_node, const SliceInfo& info,
+                                      const logging::Logger& logger,
+                                      std::unordered_map<int, int>& propagate_input_indices,
+                                      std::unordered_map<int, std::vector<DimCompare>>& all_input_cmp_rets,
+                                      std::function<void(Node& node)>& shape_update_func) {
+  LOG_DEBUG_INFO(logger, "Enter MatMulNBitsGatherActor::PreCheck for node " + current_node.Name());
+  const auto* lhs_shape = current_node.InputDefs()[0]->Shape();
+  if (lhs_shape == nullptr || lhs_shape->dim_size() != info.input_rank) {
+    LOG_DEBUG_INFO(logger, "MatMulNBits input A rank is unknown or differs from the output rank, skip.");
+    return false;
+  }
+
+  // The last dimension of the output is computed from the packed weight, which cannot be sliced.
+  if (info.non_negative_axis == info.input_rank - 1) {
+    LOG_DEBUG_INFO(logger, "MatMulNBits slicing on the last dimension is not supported, skip.");
+    return false;
+  }
+
+  shape_update_func = [&info](Node& node) -> void {
+    for (size_t output_idx = 0; output_idx < node.MutableOutputDefs().size(); ++output_idx) {
+      UpdateSliceOutputShape(*node.MutableOutputDefs()[output_idx], info.non_negative_axis,
+                             info.output_dim_on_axis);
+    }
+  };
+
+  // Input A has the same rank as the output, and all its dimensions but the last one are kept in the output.
+  propagate_input_indices.clear();
+  all_input_cmp_rets.clear();
+  propagate_input_indices[0] = info.non_negative_axis;
+  all_input_cmp_rets[0] = {};
+  return true;
+}
+
 template class SimplePointwiseGatherActor<true>;
 template class SimplePointwiseGatherActor<false>;
 
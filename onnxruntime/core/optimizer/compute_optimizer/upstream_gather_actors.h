@@ -1,9 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-// The optimization here ideally applies to both training and inferencing,
-// while so far we mainly validate training during cooking the optimization.
-#ifdef ENABLE_TRAINING
+// The optimization here applies to both training and inferencing. For inferencing, it is enabled at Level2 to
+// compute only the needed rows of the ops before a Gather/Slice, e.g. the last token logits of a decoder.
+#if !defined(ORT_MINIMAL_BUILD)
 #pragma once
 
 #include "core/optimizer/compute_optimizer/shared_utils.h"
@@ -271,6 +271,22 @@ class MatMulGatherActor : public SimplePointwiseGatherActor<false> {
                    const std::unordered_map<int, SliceInfo>& new_gather_infos) override;
 };
 
+/**
+ * @brief MatMulNBits has a packed weight, so the slicing can only be propagated to input A, which is possible
+ * for all dimensions but the last one. The scalar slice adaption is the same as MatMul's.
+ */
+class MatMulNBitsGatherActor : public MatMulGatherActor {
+ public:
+  MatMulNBitsGatherActor() = default;
+  ~MatMulNBitsGatherActor() = default;
+
+  bool PreCheck(const Graph& graph, const Node& current_node, const SliceInfo& info,
+                const logging::Logger& logger,
+                std::unordered_map<int, int>& propagate_input_indices,
+                std::unordered_map<int, std::vector<DimCompare>>& all_input_cmp_rets,
+                std::function<void(Node& node)>& shape_update_func) override;
+};
+
 /**
  * @brief Update the dim value using given new dim value at specified axis.
  *
@@ -3,7 +3,7 @@
 
 // The optimization here ideally applies to both training and inference,
 // while so far we mainly validate training during cooking the optimization.
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 #pragma once
 
 #include "core/optimizer/compute_optimizer/upstream_transformer_base.h"
@@ -3,7 +3,7 @@
 
 // The optimization here ideally applies to both training and inferencing,
 // while so far we mainly validate training during cooking the optimization.
-#ifdef ENABLE_TRAINING
+#if !defined(ORT_MINIMAL_BUILD)
 #pragma once
 
 #include "core/optimizer/graph_transformer.h"
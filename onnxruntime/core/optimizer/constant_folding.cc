@@ -3,6 +3,7 @@
 
 #include <limits>
 
+#include "core/common/parse_string.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/utils.h"
@@ -11,6 +12,7 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace onnxruntime::common;
 
@@ -131,7 +133,38 @@ static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Log
   return status;
 }
 
+// Returns true if the outputs of a folded node are too large compared to its constant inputs
+static Status IsFoldedOutputTooLarge(const InitializedTensorSet& constant_inputs, gsl::span<const OrtValue> outputs,
+                                     float max_output_size_ratio, bool& too_large) {
+  // folding small tensors does not grow the model noticeably
+  constexpr size_t kMinOutputBytesToLimit = 1024;
+
+  size_t output_bytes = 0;
+  for (const auto& output : outputs) {
+    output_bytes += output.Get<Tensor>().SizeInBytes();
+  }
+
+  size_t input_bytes = 0;
+  for (const auto& [name, tensor_proto] : constant_inputs) {
+    size_t size = 0;
+    ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(*tensor_proto, &size));
+    input_bytes += size;
+  }
+
+  too_large = output_bytes > kMinOutputBytesToLimit &&
+              static_cast<double>(output_bytes) > static_cast<double>(input_bytes) * max_output_size_ratio;
+  return Status::OK();
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  const std::string max_output_size_ratio_string =
+      config_options_.GetConfigOrDefault(kOrtSessionOptionsConstantFoldingMaxOutputSizeRatio, "0");
+  float max_output_size_ratio = 0.f;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_output_size_ratio_string, max_output_size_ratio) &&
+                        max_output_size_ratio >= 0.f,
+                    "Invalid value for ", kOrtSessionOptionsConstantFoldingMaxOutputSizeRatio, ": ",
+                    max_output_size_ratio_string);
+
   bool have_updated_nodes = false;
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -301,6 +334,17 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
+      if (converted_to_constant && max_output_size_ratio > 0.f) {
+        bool too_large = false;
+        ORT_RETURN_IF_ERROR(IsFoldedOutputTooLarge(constant_inputs, fetches, max_output_size_ratio, too_large));
+        if (too_large) {
+          LOGS(logger, INFO) << "Not constant folding " << node->OpType() << " node '" << node->Name()
+                             << "' as its outputs are more than " << max_output_size_ratio
+                             << " times the size of its inputs.";
+          converted_to_constant = false;
+        }
+      }
+
       if (converted_to_constant) {
         for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
           OrtValue& ort_value = fetches[fetch_idx];
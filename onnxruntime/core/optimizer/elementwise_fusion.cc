@@ -0,0 +1,256 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <limits>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+struct FusibleOp {
+  const char* op_type;
+  std::vector<ONNX_NAMESPACE::OperatorSetVersion> versions;
+  bool unary;
+};
+
+const FusibleOp* GetFusibleOp(const Node& node) {
+  static const FusibleOp fusible_ops[] = {
+      {"Add", {7, 13, 14}, false},
+      {"Sub", {7, 13, 14}, false},
+      {"Mul", {7, 13, 14}, false},
+      {"Div", {7, 13, 14}, false},
+      {"Abs", {6, 13}, true},
+      {"Erf", {9, 13}, true},
+      {"Exp", {6, 13}, true},
+      {"Neg", {6, 13}, true},
+      {"Relu", {6, 13, 14}, true},
+      {"Sigmoid", {6, 13}, true},
+      {"Sqrt", {6, 13}, true},
+      {"Tanh", {6, 13}, true},
+  };
+  for (const auto& op : fusible_ops) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, op.op_type, op.versions)) {
+      // the CUDA kernel also computes float16 chains in float
+      const auto* type = node.OutputDefs()[0]->TypeAsProto();
+      const int32_t elem_type = type != nullptr ? type->tensor_type().elem_type() : TensorProto_DataType_UNDEFINED;
+      if (elem_type != TensorProto_DataType_FLOAT &&
+          (elem_type != TensorProto_DataType_FLOAT16 || node.GetExecutionProviderType() != kCudaExecutionProvider)) {
+        return nullptr;
+      }
+      return node.InputDefs().size() == (op.unary ? 1u : 2u) ? &op : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+// Same dims, symbolic dims must have the same name.
+bool IsSameShape(const TensorShapeProto& shape, const TensorShapeProto& other) {
+  if (shape.dim_size() != other.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    const auto& dim = shape.dim(i);
+    const auto& other_dim = other.dim(i);
+    if (utils::HasDimValue(dim) && utils::HasDimValue(other_dim)) {
+      if (dim.dim_value() != other_dim.dim_value()) {
+        return false;
+      }
+    } else if (!utils::HasDimParam(dim) || !utils::HasDimParam(other_dim) ||
+               dim.dim_param() != other_dim.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether `arg` can be an input of a chain with the output shape `shape`.
+bool IsValidChainInput(const NodeArg& arg, const TensorShapeProto& shape) {
+  const auto* arg_shape = arg.Shape();
+  if (arg_shape == nullptr) {
+    return false;
+  }
+  if (IsSameShape(*arg_shape, shape)) {
+    return true;
+  }
+  // a single element broadcast to all the output without changing its rank
+  if (arg_shape->dim_size() > shape.dim_size()) {
+    return false;
+  }
+  for (const auto& dim : arg_shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class ChainBuilder {
+ public:
+  ChainBuilder(Graph& graph, const Node& last_node, const InlinedHashSet<std::string_view>& compatible_eps)
+      : graph_(graph),
+        shape_(*last_node.OutputDefs()[0]->Shape()),
+        execution_provider_(last_node.GetExecutionProviderType()),
+        compatible_eps_(compatible_eps) {}
+
+  // Adds `node` and, recursively, the producers of its inputs that can be fused. Returns false if `node` can not
+  // be in the chain.
+  bool Add(Node& node) {
+    if (nodes_.size() == ElementwiseFusion::kMaxFusedNodes || GetFusibleOp(node) == nullptr ||
+        !graph_utils::IsSupportedProvider(node, compatible_eps_) ||
+        node.GetExecutionProviderType() != execution_provider_) {
+      return false;
+    }
+    const auto* output_shape = node.OutputDefs()[0]->Shape();
+    if (output_shape == nullptr || !IsSameShape(*output_shape, shape_)) {
+      return false;
+    }
+    for (const NodeArg* input : node.InputDefs()) {
+      if (!IsValidChainInput(*input, shape_)) {
+        return false;
+      }
+    }
+
+    nodes_.insert(node.Index());
+    for (int i = 0; i < static_cast<int>(node.InputDefs().size()); ++i) {
+      const Node* producer = graph_utils::GetInputNode(node, i);
+      if (producer != nullptr && producer->GetOutputEdgesCount() == 1 && !graph_.NodeProducesGraphOutput(*producer) &&
+          nodes_.count(producer->Index()) == 0) {
+        ORT_IGNORE_RETURN_VALUE(Add(*graph_.GetNode(producer->Index())));
+      }
+    }
+    return true;
+  }
+
+  size_t Size() const { return nodes_.size(); }
+
+  // Replaces the chain ending at `last_node` with a FusedElementwise node.
+  void Fuse(Node& last_node) {
+    InlinedVector<std::reference_wrapper<Node>> chain;
+    const int64_t last_register = Emit(last_node, chain);
+    ORT_ENFORCE(last_register == static_cast<int64_t>(chain.size()) - 1);
+
+    // the registers of the results follow the inputs
+    const int64_t input_count = static_cast<int64_t>(inputs_.size());
+    for (auto& operand : operands_) {
+      if (operand == kNoOperand) {
+        operand = -1;
+      } else if (operand >= 0) {
+        operand += input_count;
+      } else {
+        operand = -operand - 1;
+      }
+    }
+
+    Node& fused_node = graph_.AddNode(graph_.GenerateNodeName(last_node.Name() + "/ElementwiseFusion/"),
+                                      "FusedElementwise", "fused elementwise chain", inputs_,
+                                      last_node.MutableOutputDefs(), nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops_);
+    fused_node.AddAttribute("operands", operands_);
+    fused_node.SetExecutionProviderType(execution_provider_);
+
+    // keep the edges so that the producers of the inputs are not fused into another chain as single consumers
+    for (const auto& edge : input_edges_) {
+      graph_.AddEdge(edge.src_node, fused_node.Index(), edge.src_arg_index, edge.dst_arg_index);
+    }
+    graph_utils::ReplaceDownstreamNodeInput(graph_, last_node, 0, fused_node, 0);
+
+    for (Node& node : chain) {
+      graph_utils::RemoveNodeOutputEdges(graph_, node);
+      graph_.RemoveNode(node.Index());
+    }
+  }
+
+ private:
+  static constexpr int64_t kNoOperand = std::numeric_limits<int64_t>::min();
+
+  // Appends the instructions computing `node` after the ones of its inputs in the chain and returns the index of
+  // its result. Operands are stored as result indices or as -(input index + 1) until the input count is known.
+  int64_t Emit(Node& node, InlinedVector<std::reference_wrapper<Node>>& chain) {
+    InlinedVector<int64_t, 2> operands;
+    for (int i = 0; i < static_cast<int>(node.InputDefs().size()); ++i) {
+      const Node* producer = graph_utils::GetInputNode(node, i);
+      if (producer != nullptr && nodes_.count(producer->Index()) != 0) {
+        operands.push_back(Emit(*graph_.GetNode(producer->Index()), chain));
+        continue;
+      }
+      NodeArg* input = node.MutableInputDefs()[i];
+      auto it = input_indices_.find(input->Name());
+      if (it == input_indices_.end()) {
+        it = input_indices_.emplace(input->Name(), static_cast<int64_t>(inputs_.size())).first;
+        if (const auto* edge = graph_utils::GetInputEdge(node, i); edge != nullptr) {
+          input_edges_.push_back({edge->GetNode().Index(), edge->GetSrcArgIndex(), static_cast<int>(inputs_.size())});
+        }
+        inputs_.push_back(input);
+      }
+      operands.push_back(-it->second - 1);
+    }
+
+    ops_.push_back(node.OpType());
+    operands_.push_back(operands[0]);
+    operands_.push_back(operands.size() > 1 ? operands[1] : kNoOperand);
+    chain.push_back(node);
+    return static_cast<int64_t>(chain.size()) - 1;
+  }
+
+  Graph& graph_;
+  const TensorShapeProto shape_;
+  const std::string execution_provider_;
+  const InlinedHashSet<std::string_view>& compatible_eps_;
+  InlinedHashSet<NodeIndex> nodes_;
+
+  struct InputEdge {
+    NodeIndex src_node;
+    int src_arg_index;
+    int dst_arg_index;
+  };
+
+  InlinedVector<NodeArg*> inputs_;
+  InlinedVector<InputEdge> input_edges_;
+  InlinedHashMap<std::string, int64_t> input_indices_;
+  std::vector<std::string> ops_;
+  std::vector<int64_t> operands_;
+};
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // Visit the last nodes of the chains first, the nodes fused into a chain are removed from the graph.
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    Node* p_node = graph.GetNode(*it);
+    if (p_node == nullptr) {
+      continue;
+    }
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (GetFusibleOp(node) == nullptr || node.OutputDefs()[0]->Shape() == nullptr) {
+      continue;
+    }
+
+    ChainBuilder chain(graph, node, GetCompatibleExecutionProviders());
+    if (!chain.Add(node) || chain.Size() < 2) {
+      continue;
+    }
+    chain.Fuse(node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuses chains of float elementwise operators (Add, Sub, Mul, Div, Abs, Erf, Exp, Neg, Relu, Sigmoid, Sqrt and Tanh)
+into one com.microsoft.FusedElementwise node that evaluates them in a single pass over the output. On the CUDA EP the
+chain is computed by a single kernel launch, and float16 chains are fused as well.
+A chain is grown backwards from its last node through the producers whose only consumer is in the chain. Every node
+of the chain has the output shape of the chain, and its other inputs have this shape or a single element.
+It runs after the pattern based fusions so that the chains they recognize keep their dedicated kernels.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  // The program of a fused node is limited to this many operators.
+  static constexpr size_t kMaxFusedNodes = 32;
+
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/float16_conversion.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+
+#include "core/framework/data_types.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// Ops that do most of the compute of a model. A converted region starts from these.
+constexpr std::array<std::string_view, 4> kComputeOps = {"MatMul", "Gemm", "Conv", "ConvTranspose"};
+
+// Ops that are precise enough in float16 to join a converted region they are connected to.
+constexpr std::array<std::string_view, 17> kPropagatedOps = {
+    "Add", "Sub", "Mul", "Relu", "LeakyRelu", "Sigmoid", "Tanh",
+    "Transpose", "Reshape", "Concat", "Gather", "Slice", "Squeeze", "Unsqueeze", "Flatten",
+    "MaxPool", "AveragePool"};
+
+bool IsOneOf(std::string_view op_type, gsl::span<const std::string_view> op_types) {
+  return std::find(op_types.begin(), op_types.end(), op_type) != op_types.end();
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// Check if the node exchanges a float tensor with a node of the converted set.
+bool IsConnectedTo(const Node& node, const InlinedHashSet<NodeIndex>& nodes) {
+  for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+    if (nodes.count(it->GetNode().Index()) > 0 && IsFloatTensor(*node.InputDefs()[it->GetDstArgIndex()])) {
+      return true;
+    }
+  }
+
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    if (nodes.count(it->GetNode().Index()) > 0 && IsFloatTensor(*node.OutputDefs()[it->GetSrcArgIndex()])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
+bool Float16Conversion::HasKernel(const Node& node, const std::string& provider_type,
+                                  const KernelRegistry::TypeConstraintMap& type_constraints) const {
+  for (const KernelRegistry* registry : kernel_registry_manager_.GetKernelRegistriesByProviderType(provider_type)) {
+    const KernelCreateInfo* kernel_create_info = nullptr;
+    if (registry->TryFindKernel(node, provider_type, type_constraints, &kernel_create_info).IsOK() &&
+        kernel_create_info != nullptr) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool Float16Conversion::CanConvert(const Node& node) const {
+  // the first input of all the supported ops has the "T" type constraint
+  if (node.Domain() != kOnnxDomain ||
+      (!IsOneOf(node.OpType(), kComputeOps) && !IsOneOf(node.OpType(), kPropagatedOps)) ||
+      op_block_list_.count(node.OpType()) > 0 ||
+      node.GetExecutionProviderType().empty() ||
+      node.ContainsSubgraph() ||
+      node.InputDefs().empty() ||
+      !IsFloatTensor(*node.InputDefs()[0])) {
+    return false;
+  }
+
+  MLDataType type = use_bfloat16_ ? DataTypeImpl::GetTensorType<BFloat16>() : DataTypeImpl::GetTensorType<MLFloat16>();
+  return HasKernel(node, node.GetExecutionProviderType(), {{"T", type}});
+}
+
+Status Float16Conversion::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashSet<NodeIndex> converted;
+  InlinedVector<NodeIndex> candidates;
+  for (auto index : order) {
+    const Node* node = graph.GetNode(index);
+    if (node == nullptr || !CanConvert(*node)) {
+      continue;
+    }
+
+    if (IsOneOf(node->OpType(), kComputeOps)) {
+      converted.insert(index);
+    } else {
+      candidates.push_back(index);
+    }
+  }
+
+  if (converted.empty()) {
+    return Status::OK();
+  }
+
+  // grow the converted regions over the connected candidates, so that the Casts end up at the region boundaries
+  for (bool grown = true; grown;) {
+    grown = false;
+    for (auto it = candidates.begin(); it != candidates.end();) {
+      if (IsConnectedTo(*graph.GetNode(*it), converted)) {
+        converted.insert(*it);
+        it = candidates.erase(it);
+        grown = true;
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  const auto target_type = use_bfloat16_ ? TensorProto_DataType_BFLOAT16 : TensorProto_DataType_FLOAT16;
+  const char* const suffix = use_bfloat16_ ? "_bf16" : "_fp16";
+
+  const auto& graph_output_list = graph.GetOutputs();
+  InlinedHashSet<const NodeArg*> graph_outputs(graph_output_list.cbegin(), graph_output_list.cend());
+
+  // the float args of the converted nodes and their float16 replacements
+  InlinedHashMap<const NodeArg*, NodeArg*> converted_args;
+  // the added Cast nodes and the EP of the converted node they are for
+  InlinedVector<std::pair<NodeIndex, std::string>> cast_nodes;
+
+  auto make_arg = [&](const NodeArg& arg) -> NodeArg& {
+    TypeProto type = *arg.TypeAsProto();
+    type.mutable_tensor_type()->set_elem_type(target_type);
+    return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + suffix), &type);
+  };
+
+  auto add_cast = [&](NodeArg& input, NodeArg& output, int64_t to, const std::string& provider_type) {
+    Node& cast = graph.AddNode(graph.GenerateNodeName("Float16Conversion_Cast"), "Cast",
+                               "Cast added by Float16Conversion", {&input}, {&output});
+    cast.AddAttribute("to", to);
+    cast_nodes.emplace_back(cast.Index(), provider_type);
+  };
+
+  for (auto index : order) {
+    if (converted.count(index) == 0) {
+      continue;
+    }
+
+    Node& node = *graph.GetNode(index);
+    const auto& provider_type = node.GetExecutionProviderType();
+    std::map<const NodeArg*, NodeArg*> replacements;
+
+    for (NodeArg* input : node.MutableInputDefs()) {
+      if (!IsFloatTensor(*input)) {
+        continue;
+      }
+
+      auto it = converted_args.find(input);
+      if (it == converted_args.end()) {
+        NodeArg* new_input = nullptr;
+        if (const auto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false)) {
+          Initializer values{*initializer, graph.ModelPath()};
+          const std::string name = graph.GenerateNodeArgName(input->Name() + suffix);
+          new_input = &graph_utils::AddInitializer(graph, use_bfloat16_ ? values.ToBFloat16(name)
+                                                                        : values.ToFP16(name));
+        } else {
+          new_input = &make_arg(*input);
+          add_cast(*input, *new_input, target_type, provider_type);
+        }
+
+        it = converted_args.emplace(input, new_input).first;
+      }
+
+      replacements[input] = it->second;
+    }
+
+    for (NodeArg* output : node.MutableOutputDefs()) {
+      if (!IsFloatTensor(*output)) {
+        continue;
+      }
+
+      NodeArg& new_output = make_arg(*output);
+      converted_args.emplace(output, &new_output);
+      replacements[output] = &new_output;
+
+      // the consumer lookup is not updated until the graph is resolved, so these are the original consumers
+      const auto consumers = graph.GetConsumerNodes(output->Name());
+      const bool float_needed = graph_outputs.count(output) > 0 ||
+                                std::any_of(consumers.cbegin(), consumers.cend(), [&](const Node* consumer) {
+                                  return converted.count(consumer->Index()) == 0;
+                                });
+      if (float_needed) {
+        add_cast(new_output, *output, TensorProto_DataType_FLOAT, provider_type);
+      }
+    }
+
+    node.ReplaceDefs(replacements);
+  }
+
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  // run the Casts on the EP of the converted node if it can, otherwise on the CPU EP
+  const auto type_of = [](const NodeArg& arg) { return DataTypeImpl::TypeFromProto(*arg.TypeAsProto()); };
+  for (const auto& [index, provider_type] : cast_nodes) {
+    Node& cast = *graph.GetNode(index);
+    const bool supported = HasKernel(cast, provider_type,
+                                     {{"T1", type_of(*cast.InputDefs()[0])}, {"T2", type_of(*cast.OutputDefs()[0])}});
+    cast.SetExecutionProviderType(supported ? provider_type : kCpuExecutionProvider);
+  }
+
+  LOGS(logger, INFO) << "Float16Conversion converted " << converted.size() << " nodes to "
+                     << (use_bfloat16_ ? "bfloat16" : "float16") << " and added " << cast_nodes.size() << " Casts";
+
+  modified = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
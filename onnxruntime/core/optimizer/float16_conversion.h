@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class Float16Conversion
+
+Transformer that runs the compute heavy parts of a float model in float16 or bfloat16 on the EPs the nodes are
+assigned to, without converting the model offline.
+
+The nodes of the ONNX domain compute ops (MatMul, Gemm, Conv, ConvTranspose) are converted if the kernel of their EP
+supports the target type. The conversion is then propagated to the neighbouring nodes of a set of element-wise and
+data movement ops, so that the Casts are placed at the boundaries of the converted regions and not around each node.
+All other ops, including the numerically sensitive ones such as Softmax, the normalizations, the reductions, Exp, Log
+and Pow, stay in float, as do the ops of the block list. Float initializers of the converted nodes are converted, and
+the graph inputs and outputs keep their types.
+
+Must run after partitioning, as it checks the kernels of the assigned EPs. Subgraphs are left as is.
+*/
+class Float16Conversion : public GraphTransformer {
+ public:
+  Float16Conversion(const KernelRegistryManager& kernel_registry_manager, bool use_bfloat16,
+                    InlinedHashSet<std::string> op_block_list = {}) noexcept
+      : GraphTransformer("Float16Conversion"),
+        kernel_registry_manager_(kernel_registry_manager),
+        use_bfloat16_(use_bfloat16),
+        op_block_list_(std::move(op_block_list)) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool CanConvert(const Node& node) const;
+  bool HasKernel(const Node& node, const std::string& provider_type,
+                 const KernelRegistry::TypeConstraintMap& type_constraints) const;
+
+  const KernelRegistryManager& kernel_registry_manager_;
+  const bool use_bfloat16_;
+  const InlinedHashSet<std::string> op_block_list_;
+};
+
+}  // namespace onnxruntime
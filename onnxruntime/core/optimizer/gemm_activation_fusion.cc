@@ -36,6 +36,13 @@ bool IsFusableActivation(const Node& node) {
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
+
+// FusedGemm on CUDA applies the activation with a cuBLASLt epilogue, which only exists for Relu and for the tanh
+// approximation of Gelu that FastGelu computes.
+bool IsCudaFusableActivation(const Node& node) {
+  return IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}, kOnnxDomain) ||
+         (IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) && node.InputDefs().size() == 1);
+}
 }  // namespace
 
 Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
@@ -56,15 +63,18 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
+    const bool is_cuda = node.GetExecutionProviderType() == kCudaExecutionProvider;
     NodeArg* node_output = node.MutableOutputDefs()[0];
     auto data_type = node_output->TypeAsProto()->tensor_type().elem_type();
-    if (data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-      // FusedGemm is only registered for float data type in fused_gemm.cc!
+    if (data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+        !(is_cuda && data_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16)) {
+      // FusedGemm is only registered for float data type in fused_gemm.cc, and for float and float16 on CUDA.
       continue;
     }
 
     const Node& next_node = *(node.OutputNodesBegin());
-    if (!IsFusableActivation(next_node) || next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    if (!(is_cuda ? IsCudaFusableActivation(next_node) : IsFusableActivation(next_node)) ||
+        next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
       continue;
     }
 
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <optional>
+
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -26,14 +29,52 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  const bool profiling_enabled = profiler_ != nullptr && profiler_->IsEnabled();
+
+  // a transformer that did not modify the graph would not modify it again until another transformer modifies it.
+  // count the modifications, and skip a transformer if there was none since its last run without modification.
+  size_t num_modifications = 0;
+  InlinedVector<std::optional<size_t>> num_modifications_at_unmodified_run(transformers->second.size());
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < transformers->second.size(); ++i) {
+      const auto& transformer = transformers->second[i];
       if (step > 0 && transformer->ShouldOnlyApplyOnce())
         continue;
 
+      if (num_modifications_at_unmodified_run[i] == num_modifications) {
+        LOGS(logger, VERBOSE) << "Skipping GraphTransformer " << transformer->Name()
+                              << " as the graph is unchanged since it last ran.";
+        continue;
+      }
+
+      const int node_count_before = graph.NumberOfNodes();
+      TimePoint start_time;
+      if (profiling_enabled) {
+        start_time = profiler_->Start();
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+
+      if (profiling_enabled) {
+        profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name() + "_graph_transformer",
+                                         start_time,
+                                         {{"level", std::to_string(static_cast<int>(level))},
+                                          {"step", std::to_string(step)},
+                                          {"modified", modified ? "1" : "0"},
+                                          {"node_count_before", std::to_string(node_count_before)},
+                                          {"node_count_after", std::to_string(graph.NumberOfNodes())}});
+      }
+
+      if (modified) {
+        ++num_modifications;
+        num_modifications_at_unmodified_run[i].reset();
+      } else {
+        num_modifications_at_unmodified_run[i] = num_modifications;
+      }
+
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
@@ -24,6 +24,7 @@
 #include "core/optimizer/bias_softmax_fusion.h"
 #include "core/optimizer/cast_elimination.h"
 #include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/compute_optimizer/upstream_gather.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/constant_sharing.h"
 #include "core/optimizer/conv_add_act_fusion.h"
@@ -34,6 +35,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -63,13 +65,17 @@
 #include "core/optimizer/qdq_transformer/avx2_weight_s8_to_u8.h"
 #endif
 #include "core/optimizer/qdq_transformer/clip_quantizelinear.h"
+#include "core/optimizer/qdq_transformer/dq_matmul_float8_fusion.h"
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
 #include "core/optimizer/qdq_transformer/qdq_propagation.h"
 #include "core/optimizer/qdq_transformer/qdq_s8_to_u8.h"
 #include "core/optimizer/qdq_transformer/relu_quantizelinear.h"
+#include "core/optimizer/qdq_transformer/skip_layer_norm_quantizelinear.h"
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
+#include "core/optimizer/shared_input_matmul_fusion.h"
+#include "core/optimizer/symbolic_shape_propagation.h"
 #include "core/optimizer/rocm_blas_alt_impl.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
@@ -139,6 +145,9 @@ InlinedVector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(
     case TransformerLevel::Level2:
       rules.push_back(std::make_unique<ClipQuantFusion>());
       rules.push_back(std::make_unique<ReluQuantFusion>());
+#ifndef DISABLE_CONTRIB_OPS
+      rules.push_back(std::make_unique<SkipLayerNormQuantFusion>());
+#endif
       rules.push_back(std::make_unique<GemmTransposeFusion>());
       break;
 
@@ -231,6 +240,7 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<ConstantFolding>(cpu_execution_provider, !disable_quant_qdq,
                                                                   session_options.config_options));
       transformers.emplace_back(std::make_unique<MatMulAddFusion>());
+      transformers.emplace_back(std::make_unique<SymbolicShapePropagation>());
       transformers.emplace_back(std::make_unique<ReshapeFusion>());
       transformers.emplace_back(std::make_unique<FreeDimensionOverrideTransformer>(
           session_options.free_dimension_overrides));
@@ -272,7 +282,11 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                             QDQIsInt8Allowed() ? "1" : "0") == "1";
       const bool enable_gelu_approximation =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGeluApproximation, "0") == "1";
+      const bool enable_elementwise_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseFusion, "0") == "1";
 
+      const InlinedHashSet<std::string_view> cpu_cuda_eps = {onnxruntime::kCpuExecutionProvider,
+                                                             onnxruntime::kCudaExecutionProvider};
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_cuda_rocm_eps = {onnxruntime::kCpuExecutionProvider,
@@ -319,7 +333,16 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                                                  p_buffered_tensors));
       }
 
-      transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_ep));
+      // Move Gather/Slice before the ops producing their input, so that e.g. the LM head MatMul of a decoder only
+      // computes the logits of the tokens that are used.
+      transformers.emplace_back(std::make_unique<UpStreamGatherGraphTransformer>(cpu_cuda_rocm_eps));
+
+      transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_cuda_eps));
+      if (!disable_quant_qdq &&
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableDQMatMulFloat8Fusion, "0") == "1") {
+        const InlinedHashSet<std::string_view> cuda_ep = {onnxruntime::kCudaExecutionProvider};
+        transformers.emplace_back(std::make_unique<DQMatMulFloat8Fusion>(cuda_ep));
+      }
       transformers.emplace_back(std::make_unique<MatMulIntegerToFloatFusion>(cpu_dml_eps));
       transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(cpu_ep));
 
@@ -377,6 +400,14 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<MatMulNBitsFusion>(cpu_ep));
 #endif  // !defined(ORT_NEURAL_SPEED)
 
+      // SharedInputMatMulFusion runs after AttentionFusion, which matches the separate Q, K and V MatMuls.
+      transformers.emplace_back(std::make_unique<SharedInputMatMulFusion>(cpu_cuda_rocm_eps));
+
+      // ElementwiseFusion runs after the pattern based fusions so that it only fuses the remaining chains.
+      if (enable_elementwise_fusion) {
+        transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_cuda_eps));
+      }
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
       // The QDQFinalCleanupTransformer must run AFTER other transformers that fuse Q/DQ nodes. Otherwise, their
       // fusions might be prevented if this one removes a Q/DQ node too early.
@@ -5,7 +5,10 @@
 
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
+#include <algorithm>
+
 #include "core/common/common.h"
+#include "core/common/logging/logging.h"
 #include "core/optimizer/transpose_optimization/ort_transpose_optimization.h"
 #include "core/optimizer/transpose_optimization/ort_optimizer_utils.h"
 
@@ -14,6 +17,18 @@ using namespace onnx_transpose_optimization;
 namespace onnxruntime {
 namespace layout_transformation {
 namespace {
+// Pushing the layout transposes through binary ops and Concat adds Transposes on the other inputs, which can take
+// another pass of the transpose optimizer to cancel out.
+constexpr size_t kTransposeOptimizationMaxPasses = 4;
+
+size_t CountTransposes(const api::GraphRef& graph) {
+  const auto nodes = graph.Nodes();
+  return static_cast<size_t>(std::count_if(nodes.begin(), nodes.end(),
+                                           [](const std::unique_ptr<api::NodeRef>& node) {
+                                             return node->IsOp("Transpose");
+                                           }));
+}
+
 // Cost check for aggressively pushing the Transpose nodes involved in the layout transformation further out.
 CostCheckResult PostLayoutTransformCostCheck(const api::GraphRef& graph, const api::NodeRef& node,
                                              const std::vector<int64_t>& perm,
@@ -128,6 +143,7 @@ Status TransformLayoutForEP(Graph& graph, bool& modified, const IExecutionProvid
   // TransformLayoutForEP returns.
   // sub graph recurse will be added later
   auto api_graph = MakeApiGraph(graph, cpu_allocator, /*new_node_ep*/ nullptr);
+  const size_t num_transposes_before = CountTransposes(*api_graph);
 
   // to convert to NHWC we need to wrap layout sensitive nodes to Transpose from NCHW to NHWC and back.
   for (auto& node : api_graph->Nodes()) {
@@ -203,14 +219,23 @@ Status TransformLayoutForEP(Graph& graph, bool& modified, const IExecutionProvid
   }
 
   const auto max_node_idx = graph.MaxNodeIndex();
+  const size_t num_transposes_added = CountTransposes(*api_graph) - num_transposes_before;
   OptimizeResult result = onnx_transpose_optimization::Optimize(*api_graph, execution_provider.Type(),
-                                                                PostLayoutTransformCostCheck, OrtExtendedHandlers());
+                                                                PostLayoutTransformCostCheck, OrtExtendedHandlers(),
+                                                                kTransposeOptimizationMaxPasses);
 
   if (result.error_msg) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Layout/Transpose optimization for ", execution_provider.Type(),
                            " failed: ", result.error_msg.value());
   }
 
+  if (num_transposes_added > 0) {
+    LOGS_DEFAULT(INFO) << "Layout transformation for " << execution_provider.Type() << " added "
+                       << num_transposes_added << " Transpose nodes. The transpose optimizer removed "
+                       << result.num_transposes_removed << " Transpose nodes, " << CountTransposes(*api_graph)
+                       << " remain in the graph.";
+  }
+
   modified = modified || (graph.MaxNodeIndex() > max_node_idx);
 
   // debug transpose optimization for the current EP
@@ -3,6 +3,8 @@
 
 #include "core/optimizer/matmul_nbits_fusion.h"
 
+#include <string>
+
 #include "core/common/common.h"
 #include "core/optimizer/selectors_actions/actions.h"
 
@@ -16,17 +18,72 @@ namespace onnxruntime {
 
 namespace {
 
+// MatMulNBits input indices of the fused bias and epilogue.
+constexpr size_t kBiasInputIndex = 5;
+constexpr size_t kMultiplierInputIndex = 6;
+constexpr size_t kResidualInputIndex = 7;
+
 #if !defined(ORT_MINIMAL_BUILD)
 
+bool HasInput(const Node& node, size_t input_index) {
+  const auto input_defs = node.InputDefs();
+  return input_defs.size() > input_index && input_defs[input_index]->Exists();
+}
+
+bool HasActivation(const Node& node) {
+  const auto* activation = graph_utils::GetNodeAttribute(node, "activation");
+  return activation != nullptr && !activation->s().empty();
+}
+
+// Checks that the two values have the same shape, so an elementwise operation between them does not broadcast.
+bool HaveSameShape(const NodeArg& arg, const NodeArg& other_arg) {
+  const auto* shape = arg.Shape();
+  const auto* other_shape = other_arg.Shape();
+  if (shape == nullptr || other_shape == nullptr || shape->dim_size() != other_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const auto& other_dim = other_shape->dim(i);
+    const bool same_value = utils::HasDimValue(dim) && utils::HasDimValue(other_dim) &&
+                            dim.dim_value() == other_dim.dim_value();
+    const bool same_param = utils::HasDimParam(dim) && utils::HasDimParam(other_dim) &&
+                            dim.dim_param() == other_dim.dim_param();
+    if (!same_value && !same_param) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Returns the single consumer of the MatMulNBits output if it is one of the given ops on the same EP.
+const Node* GetSingleConsumer(const GraphViewer& graph_viewer, const Node& node, const std::string& op_type,
+                              std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion> versions,
+                              std::string_view domain = kOnnxDomain) {
+  if (!optimizer_utils::CheckOutputEdges(graph_viewer.GetGraph(), node, 1)) {
+    return nullptr;
+  }
+
+  const auto& next_node = node.OutputEdgesBegin()->GetNode();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, op_type, versions, domain) ||
+      node.GetExecutionProviderType() != next_node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  return &next_node;
+}
+
 namespace selectors {
 
 class BiasFusion : public NodeSelector {
  public:
   std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer,
                                                const Node& node) const override {
-    // check if MatMulNBits node already has a bias input
-    if (const auto input_defs = node.InputDefs();
-        input_defs.size() > 5 && input_defs[5]->Exists()) {
+    // check if MatMulNBits node already has a bias input, or an epilogue that has to follow the bias
+    if (HasInput(node, kBiasInputIndex) || HasActivation(node) ||
+        HasInput(node, kMultiplierInputIndex) || HasInput(node, kResidualInputIndex)) {
       return std::nullopt;
     }
 
@@ -71,6 +128,110 @@ class BiasFusion : public NodeSelector {
   }
 };
 
+// MatMulNBits + Gelu/FastGelu -> MatMulNBits with activation
+class ActivationFusion : public NodeSelector {
+ public:
+  std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer,
+                                               const Node& node) const override {
+    if (HasActivation(node) || HasInput(node, kMultiplierInputIndex) || HasInput(node, kResidualInputIndex)) {
+      return std::nullopt;
+    }
+
+    const Node* next_node = GetSingleConsumer(graph_viewer, node, "Gelu", {20});
+    if (next_node == nullptr) {
+      next_node = GetSingleConsumer(graph_viewer, node, "Gelu", {1}, kMSDomain);
+    }
+    if (next_node == nullptr) {
+      next_node = GetSingleConsumer(graph_viewer, node, "FastGelu", {1}, kMSDomain);
+      // FastGelu with its own bias input is left alone
+      if (next_node != nullptr && HasInput(*next_node, 1)) {
+        return std::nullopt;
+      }
+    }
+    if (next_node == nullptr) {
+      return std::nullopt;
+    }
+
+    NodesToOptimizeIndicesBuilder builder{};
+    builder.target_node = node.Index();
+    builder.output_nodes = {next_node->Index()};
+    return builder.Build();
+  }
+};
+
+// MatMulNBits + Sigmoid + Mul (SiLU) -> MatMulNBits with activation
+class SiluFusion : public NodeSelector {
+ public:
+  std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer,
+                                               const Node& node) const override {
+    if (HasActivation(node) || HasInput(node, kMultiplierInputIndex) || HasInput(node, kResidualInputIndex)) {
+      return std::nullopt;
+    }
+
+    if (!optimizer_utils::CheckOutputEdges(graph_viewer.GetGraph(), node, 2)) {
+      return std::nullopt;
+    }
+
+    const Node* sigmoid = nullptr;
+    const Node* mul = nullptr;
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      const Node& next_node = it->GetNode();
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Sigmoid", {6, 13})) {
+        sigmoid = &next_node;
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Mul", {7, 13, 14})) {
+        mul = &next_node;
+      }
+    }
+
+    if (sigmoid == nullptr || mul == nullptr ||
+        node.GetExecutionProviderType() != sigmoid->GetExecutionProviderType() ||
+        node.GetExecutionProviderType() != mul->GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph_viewer.GetGraph(), *sigmoid, 1) ||
+        sigmoid->OutputEdgesBegin()->GetNode().Index() != mul->Index()) {
+      return std::nullopt;
+    }
+
+    NodesToOptimizeIndicesBuilder builder{};
+    builder.target_node = node.Index();
+    builder.output_nodes = {sigmoid->Index(), mul->Index()};
+    return builder.Build();
+  }
+};
+
+// MatMulNBits + Mul or Add with a tensor of the output shape -> MatMulNBits with multiplier or residual input
+class ElementwiseFusion : public NodeSelector {
+ public:
+  ElementwiseFusion(std::string op_type, size_t input_index)
+      : op_type_{std::move(op_type)}, input_index_{input_index} {}
+
+  std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer,
+                                               const Node& node) const override {
+    // the multiplier is applied before the residual is added
+    if (HasInput(node, kResidualInputIndex) || HasInput(node, input_index_)) {
+      return std::nullopt;
+    }
+
+    const Node* next_node = GetSingleConsumer(graph_viewer, node, op_type_, {7, 13, 14});
+    if (next_node == nullptr) {
+      return std::nullopt;
+    }
+
+    const auto other_index = node.OutputEdgesBegin()->GetDstArgIndex() == 0 ? 1 : 0;
+    if (!HaveSameShape(*node.OutputDefs()[0], *next_node->InputDefs()[other_index])) {
+      return std::nullopt;
+    }
+
+    NodesToOptimizeIndicesBuilder builder{};
+    builder.target_node = node.Index();
+    builder.output_nodes = {next_node->Index()};
+    return builder.Build();
+  }
+
+ private:
+  const std::string op_type_;
+  const size_t input_index_;
+};
+
 }  // namespace selectors
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -90,14 +251,68 @@ struct BiasFusion : MergeIntoTarget {
     NTO::NodeLocation add_location{NTO::NodeType::kOutput, 0};
 
     std::vector<NodeAndMoveInfo> value_moves{
-        MoveToSlot(add_location, ArgType::kInput, bias_index, ArgType::kInput, 5),  // move bias input from Add
-        MoveToSlot(add_location, ArgType::kOutput, 0, ArgType::kOutput, 0),         // move output from Add
+        // move bias input from Add
+        MoveToSlot(add_location, ArgType::kInput, bias_index, ArgType::kInput, static_cast<int>(kBiasInputIndex)),
+        // move output from Add
+        MoveToSlot(add_location, ArgType::kOutput, 0, ArgType::kOutput, 0),
     };
 
     return value_moves;
   }
 };
 
+// Sets the activation attribute of the target from the last selected output node.
+struct ActivationFusion : MergeIntoTarget {
+  Status Run(Graph& graph, const NodesToOptimize& selected_nodes) const override {
+    const Node& activation_node = *selected_nodes.Output(static_cast<int>(selected_nodes.num_outputs) - 1);
+
+    std::string activation;
+    if (activation_node.OpType() == "Mul") {
+      activation = "silu";
+    } else if (activation_node.OpType() == "FastGelu") {
+      activation = "fastgelu";
+    } else {
+      // ONNX Gelu has an approximate attribute, the contrib Gelu is always exact
+      const auto& attributes = activation_node.GetAttributes();
+      const auto approximate = attributes.find("approximate");
+      activation = (approximate != attributes.end() && approximate->second.s() == "tanh") ? "fastgelu" : "gelu";
+    }
+
+    Node& target = selected_nodes.Target();
+    ORT_RETURN_IF_ERROR(MergeIntoTarget::Run(graph, selected_nodes));
+    target.AddAttribute("activation", activation);
+    return Status::OK();
+  }
+
+ private:
+  std::vector<NodeAndMoveInfo> ValueMoves(const RuntimeState& runtime_state) const override {
+    // move output from the last node of the activation
+    NTO::NodeLocation last_location{NTO::NodeType::kOutput,
+                                    static_cast<int>(runtime_state.selected_nodes.num_outputs) - 1};
+    return {MoveToSlot(last_location, ArgType::kOutput, 0, ArgType::kOutput, 0)};
+  }
+};
+
+struct ElementwiseFusion : MergeIntoTarget {
+  explicit ElementwiseFusion(size_t input_index) : input_index_{input_index} {}
+
+ private:
+  std::vector<NodeAndMoveInfo> ValueMoves(const RuntimeState& runtime_state) const override {
+    const Node& target = runtime_state.selected_nodes.Target();
+    ORT_ENFORCE(target.GetOutputEdgesCount() == 1);
+    const auto other_index = target.OutputEdgesBegin()->GetDstArgIndex() == 0 ? 1 : 0;
+
+    NTO::NodeLocation next_location{NTO::NodeType::kOutput, 0};
+
+    return {
+        MoveToSlot(next_location, ArgType::kInput, other_index, ArgType::kInput, static_cast<int>(input_index_)),
+        MoveToSlot(next_location, ArgType::kOutput, 0, ArgType::kOutput, 0),
+    };
+  }
+
+  const size_t input_index_;
+};
+
 }  // namespace actions
 
 void BiasFusionRule(SelectorActionRegistry& registry) {
@@ -121,12 +336,80 @@ void BiasFusionRule(SelectorActionRegistry& registry) {
 #endif
 }
 
+void ActivationFusionRule(SelectorActionRegistry& registry) {
+  constexpr const char* name = "FuseActivation";
+
+  auto action = std::make_unique<actions::ActivationFusion>();
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+  auto selector = std::make_unique<selectors::ActivationFusion>();
+
+  registry.RegisterSelectorAndAction(name,
+                                     {{SelectorActionRegistry::OpVersionsMapKey("MatMulNBits", kMSDomain), {}}},
+                                     std::move(selector),
+                                     std::move(action));
+
+#else
+
+  registry.RegisterAction(name, std::move(action));
+
+#endif
+}
+
+void SiluFusionRule(SelectorActionRegistry& registry) {
+  constexpr const char* name = "FuseSilu";
+
+  auto action = std::make_unique<actions::ActivationFusion>();
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+  auto selector = std::make_unique<selectors::SiluFusion>();
+
+  registry.RegisterSelectorAndAction(name,
+                                     {{SelectorActionRegistry::OpVersionsMapKey("MatMulNBits", kMSDomain), {}}},
+                                     std::move(selector),
+                                     std::move(action));
+
+#else
+
+  registry.RegisterAction(name, std::move(action));
+
+#endif
+}
+
+void ElementwiseFusionRule(SelectorActionRegistry& registry, const char* name, const char* op_type,
+                           size_t input_index) {
+  auto action = std::make_unique<actions::ElementwiseFusion>(input_index);
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+  auto selector = std::make_unique<selectors::ElementwiseFusion>(op_type, input_index);
+
+  registry.RegisterSelectorAndAction(name,
+                                     {{SelectorActionRegistry::OpVersionsMapKey("MatMulNBits", kMSDomain), {}}},
+                                     std::move(selector),
+                                     std::move(action));
+
+#else
+
+  ORT_UNUSED_PARAMETER(op_type);
+  registry.RegisterAction(name, std::move(action));
+
+#endif
+}
+
 }  // namespace
 
 SelectorActionRegistry MatMulNBitsFusion::CreateSelectorActionRegistry() const {
   SelectorActionRegistry registry{};
 
+  // the bias is tried first as an Add with a [N] shaped input is a bias rather than a residual
   BiasFusionRule(registry);
+  ActivationFusionRule(registry);
+  SiluFusionRule(registry);
+  ElementwiseFusionRule(registry, "FuseMultiplier", "Mul", kMultiplierInputIndex);
+  ElementwiseFusionRule(registry, "FuseResidual", "Add", kResidualInputIndex);
 
   return registry;
 }
@@ -10,6 +10,9 @@ namespace onnxruntime {
 // Performs node fusions with MatMulNBits.
 // Currently supports these fusions:
 // - MatMulNBits + Add -> MatMulNBits with bias input
+// - MatMulNBits + Gelu/FastGelu or Sigmoid + Mul (SiLU) -> MatMulNBits with activation
+// - MatMulNBits + Mul -> MatMulNBits with multiplier input, e.g., SwiGLU
+// - MatMulNBits + Add with an input of the output shape -> MatMulNBits with residual input
 class MatMulNBitsFusion : public SelectorActionTransformer {
  public:
   MatMulNBitsFusion(const InlinedHashSet<std::string_view>& compatible_eps = {},
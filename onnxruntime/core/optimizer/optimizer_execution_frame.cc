@@ -175,6 +175,16 @@ OptimizerExecutionFrame::OptimizerExecutionFrame(const Info& info,
   Init(gsl::span<const int>(), gsl::span<const OrtValue>(), info.GetInitializers(), info.GetSparseInitializerLookupFunc(), fetches);
 }
 
+OptimizerExecutionFrame::OptimizerExecutionFrame(const Info& info,
+                                                 gsl::span<const int> feed_mlvalue_idxs,
+                                                 gsl::span<const OrtValue> feeds,
+                                                 const std::vector<int>& fetch_mlvalue_idxs,
+                                                 const std::vector<OrtValue>& fetches)
+    : IExecutionFrame(info.GetMLValueNameIdxMap(), info.GetNodeIndexInfo(), fetch_mlvalue_idxs),
+      info_(info) {
+  Init(feed_mlvalue_idxs, feeds, info.GetInitializers(), info.GetSparseInitializerLookupFunc(), fetches);
+}
+
 AllocatorPtr OptimizerExecutionFrame::GetAllocatorImpl(const OrtDevice&) const {
   return info_.GetAllocator();
 }
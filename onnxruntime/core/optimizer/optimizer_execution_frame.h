@@ -84,6 +84,13 @@ class OptimizerExecutionFrame final : public IExecutionFrame {
                           const std::vector<int>& fetch_mlvalue_idxs,
                           const std::vector<OrtValue>& fetches = {});
 
+  // feeds the values of the nodes' inputs that are not initializers, so that the Info can be reused across runs
+  OptimizerExecutionFrame(const Info& info,
+                          gsl::span<const int> feed_mlvalue_idxs,
+                          gsl::span<const OrtValue> feeds,
+                          const std::vector<int>& fetch_mlvalue_idxs,
+                          const std::vector<OrtValue>& fetches = {});
+
   ~OptimizerExecutionFrame() override = default;
 
  private:
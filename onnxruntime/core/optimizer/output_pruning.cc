@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/output_pruning.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+Status OutputPruning::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                const logging::Logger& logger) const {
+  const auto& graph_outputs = graph.GetOutputs();
+  for (const auto& name : outputs_to_keep_) {
+    const bool found = std::any_of(graph_outputs.cbegin(), graph_outputs.cend(),
+                                   [&name](const NodeArg* output) { return output->Name() == name; });
+    ORT_RETURN_IF_NOT(found, "Output to keep '", name, "' is not an output of the graph.");
+  }
+
+  if (outputs_to_keep_.size() == graph_outputs.size()) {
+    return Status::OK();
+  }
+
+  // keep the order of the outputs in the model
+  InlinedVector<const NodeArg*> kept_outputs;
+  InlinedVector<const Node*> kept_producers;
+  for (const NodeArg* output : graph_outputs) {
+    if (outputs_to_keep_.count(output->Name()) > 0) {
+      kept_outputs.push_back(output);
+      if (const Node* producer = graph.GetProducerNode(output->Name())) {
+        kept_producers.push_back(producer);
+      }
+    }
+  }
+
+  InlinedHashSet<NodeIndex> needed_nodes;
+  graph.ReverseDFSFrom(kept_producers, [&needed_nodes](const Node* node) { needed_nodes.insert(node->Index()); },
+                       nullptr);
+
+  const size_t num_outputs_removed = graph_outputs.size() - kept_outputs.size();
+  graph.SetOutputs(kept_outputs);
+
+  // remove the consumers first, as a node can only be removed once it has no output edges. the consumers of a node
+  // that is not needed are not needed either.
+  size_t num_nodes_removed = 0;
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto it = order.crbegin(), end = order.crend(); it != end; ++it) {
+    if (needed_nodes.count(*it) == 0 && graph.RemoveNode(*it)) {
+      ++num_nodes_removed;
+    }
+  }
+
+  LOGS(logger, INFO) << "OutputPruning removed " << num_outputs_removed << " graph outputs and "
+                     << num_nodes_removed << " nodes";
+
+  modified = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class OutputPruning
+
+Transformer that removes the graph outputs an application does not fetch, together with the nodes that are only
+needed to compute them.
+
+The kept outputs must be outputs of the main graph. The nodes that the kept outputs do not depend on are removed,
+including their subgraphs, and the initializers that are no longer used are removed when the graph is resolved.
+The graph inputs are kept, so that the feeds of the application stay valid.
+*/
+class OutputPruning : public GraphTransformer {
+ public:
+  OutputPruning(InlinedHashSet<std::string> outputs_to_keep) noexcept
+      : GraphTransformer("OutputPruning"), outputs_to_keep_(std::move(outputs_to_keep)) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const InlinedHashSet<std::string> outputs_to_keep_;
+};
+
+}  // namespace onnxruntime
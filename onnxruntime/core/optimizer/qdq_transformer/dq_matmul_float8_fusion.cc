@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer/dq_matmul_float8_fusion.h"
+
+#include <algorithm>
+
+#include "core/common/safeint.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+#if !defined(DISABLE_FLOAT8_TYPES)
+namespace {
+
+bool IsFloat8(int32_t elem_type) {
+  return elem_type == TensorProto_DataType_FLOAT8E4M3FN || elem_type == TensorProto_DataType_FLOAT8E5M2;
+}
+
+int32_t ElemType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() ? type->tensor_type().elem_type()
+                                                    : TensorProto_DataType_UNDEFINED;
+}
+
+bool HasRank2(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() == 2;
+}
+
+// Returns the DQ node producing the given MatMul input if it dequantizes a 2D float 8 tensor with a constant scalar
+// float scale and no zero point, and has no other consumer.
+const Node* GetFloat8DQ(const Graph& graph, const Node& matmul, int input_index) {
+  const Node* dq = graph.GetProducerNode(matmul.InputDefs()[input_index]->Name());
+  if (dq == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*dq, "DequantizeLinear", {19, 21}) ||
+      !optimizer_utils::CheckOutputEdges(graph, *dq, 1)) {
+    return nullptr;
+  }
+
+  const auto dq_inputs = dq->InputDefs();
+  if (!IsFloat8(ElemType(*dq_inputs[0])) || !HasRank2(*dq_inputs[0])) {
+    return nullptr;
+  }
+
+  // The GemmFloat8 scales have to be float scalars. They are required to be initializers because the input edges
+  // of the DQ nodes are not moved to the fused node.
+  const NodeArg& scale = *dq_inputs[1];
+  if (ElemType(scale) != TensorProto_DataType_FLOAT || !optimizer_utils::IsScalar(scale) ||
+      !graph_utils::IsConstantInitializer(graph, scale.Name())) {
+    return nullptr;
+  }
+
+  if (dq_inputs.size() > 2 && dq_inputs[2]->Exists()) {
+    const auto* zero_point = graph_utils::GetConstantInitializer(graph, dq_inputs[2]->Name());
+    if (zero_point == nullptr) {
+      return nullptr;
+    }
+    std::vector<uint8_t> zero_point_data;
+    if (!utils::UnpackInitializerData(*zero_point, graph.ModelPath(), zero_point_data).IsOK() ||
+        std::any_of(zero_point_data.begin(), zero_point_data.end(), [](uint8_t v) { return v != 0; })) {
+      return nullptr;
+    }
+  }
+
+  return dq;
+}
+
+// Adds the transpose of the 2D float 8 initializer as a new initializer.
+NodeArg* AddTransposedFloat8Initializer(Graph& graph, const TensorProto& initializer) {
+  std::vector<uint8_t> data;
+  if (!utils::UnpackInitializerData(initializer, graph.ModelPath(), data).IsOK()) {
+    return nullptr;
+  }
+
+  const int64_t rows = initializer.dims(0);
+  const int64_t cols = initializer.dims(1);
+  std::vector<uint8_t> transposed(data.size());
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      transposed[SafeInt<size_t>(c) * rows + r] = data[SafeInt<size_t>(r) * cols + c];
+    }
+  }
+
+  TensorProto transposed_initializer;
+  transposed_initializer.set_name(graph.GenerateNodeArgName(initializer.name() + "_transposed"));
+  transposed_initializer.set_data_type(initializer.data_type());
+  transposed_initializer.add_dims(cols);
+  transposed_initializer.add_dims(rows);
+  utils::SetRawDataInTensorProto(transposed_initializer, transposed.data(), transposed.size());
+  return &graph_utils::AddInitializer(graph, transposed_initializer);
+}
+
+}  // namespace
+#endif  // !defined(DISABLE_FLOAT8_TYPES)
+
+Status DQMatMulFloat8Fusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+#if !defined(DISABLE_FLOAT8_TYPES)
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : order) {
+    auto* node_ptr = graph.GetNode(index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        ElemType(*node.OutputDefs()[0]) != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    const Node* dq_a = GetFloat8DQ(graph, node, 0);
+    const Node* dq_b = GetFloat8DQ(graph, node, 1);
+    if (dq_a == nullptr || dq_b == nullptr || dq_a == dq_b) {
+      continue;
+    }
+
+    Node& dq_a_node = *graph.GetNode(dq_a->Index());
+    Node& dq_b_node = *graph.GetNode(dq_b->Index());
+
+    // cuBLASLt has no float 8 GEMM of two E5M2 tensors.
+    NodeArg* input_a = dq_a_node.MutableInputDefs()[0];
+    const NodeArg* input_b = dq_b_node.InputDefs()[0];
+    if (ElemType(*input_a) == TensorProto_DataType_FLOAT8E5M2 &&
+        ElemType(*input_b) == TensorProto_DataType_FLOAT8E5M2) {
+      continue;
+    }
+
+    const auto* b_initializer = graph_utils::GetConstantInitializer(graph, input_b->Name());
+    if (b_initializer == nullptr || b_initializer->dims_size() != 2) {
+      continue;
+    }
+
+    NodeArg* transposed_b = AddTransposedFloat8Initializer(graph, *b_initializer);
+    if (transposed_b == nullptr) {
+      continue;
+    }
+
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    InlinedVector<NodeArg*> inputs{input_a, transposed_b, &empty_arg,
+                                   dq_a_node.MutableInputDefs()[1], dq_b_node.MutableInputDefs()[1]};
+
+    Node& gemm = graph.AddNode(graph.GenerateNodeName(node.Name() + "_GemmFloat8"), "GemmFloat8",
+                               "fused DequantizeLinear and MatMul " + node.Name(), inputs, {}, nullptr, kMSDomain);
+    gemm.AddAttribute("transA", static_cast<int64_t>(0));
+    gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    gemm.AddAttribute("dtype", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+    gemm.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // The input edge of A moves from the first DQ, B and the scales are initializers without edges.
+    graph_utils::FinalizeNodeFusion(graph, {dq_a_node, dq_b_node, node}, gemm);
+
+    modified = true;
+  }
+#else
+  ORT_UNUSED_PARAMETER(graph);
+  ORT_UNUSED_PARAMETER(modified);
+  ORT_UNUSED_PARAMETER(graph_level);
+  ORT_UNUSED_PARAMETER(logger);
+#endif  // !defined(DISABLE_FLOAT8_TYPES)
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
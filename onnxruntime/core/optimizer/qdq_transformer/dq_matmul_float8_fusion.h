@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * Graph transformer that fuses a MatMul of two per tensor dequantized float 8 tensors into a GemmFloat8, so that
+ * the GEMM runs on the float 8 data with the scales applied by cuBLASLt instead of on the dequantized values.
+ *
+ * Before:
+ *
+ *   A (float8) -> DQ -> MatMul -> Y
+ *                        ^
+ *   B (float8) -> DQ ----+
+ *
+ * After:
+ *
+ *   A, transposed B, scale_A, scale_B -> GemmFloat8(transB=1) -> Y
+ *
+ * A and B must be 2D and B must be a constant initializer. Both DQ nodes must have scalar float scales and no
+ * zero point, or an all zero one, and E5M2 inputs are only fused with an E4M3FN input as cuBLASLt requires.
+ */
+class DQMatMulFloat8Fusion : public GraphTransformer {
+ public:
+  DQMatMulFloat8Fusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DQMatMulFloat8Fusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
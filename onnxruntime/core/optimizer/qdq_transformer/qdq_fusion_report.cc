@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer/qdq_fusion_report.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/qdq_transformer/qdq_util.h"
+#include "core/optimizer/qdq_transformer/selectors_actions/qdq_selector_action_transformer.h"
+
+namespace onnxruntime {
+
+QDQFusionReport::QDQFusionReport(bool is_int8_allowed)
+    : GraphTransformer("QDQFusionReport"),
+      selector_action_registry_{CreateQDQSelectorActionRegistry(is_int8_allowed)} {
+}
+
+std::string QDQFusionReport::GetReason(const GraphViewer& graph_viewer, const Node& node) const {
+  const auto& provider_type = node.GetExecutionProviderType();
+  if (provider_type != kCpuExecutionProvider && provider_type != kDmlExecutionProvider) {
+    return "assigned to " + provider_type + ", and the QDQ fusions only run for the CPU and DML EPs";
+  }
+
+  const auto entries = selector_action_registry_.LookUpByOpTypeAndDomain(node.OpType(), node.Domain());
+  if (entries.empty()) {
+    return "no QDQ fusion for the op type";
+  }
+
+  const std::string key = SelectorActionRegistry::OpVersionsMapKey(node.OpType(), node.Domain());
+  std::string rejected_by;
+  for (const auto& entry : entries) {
+    const auto& versions = entry->ops_and_versions.find(key)->second;
+    if (!versions.empty() &&
+        std::find(versions.cbegin(), versions.cend(), node.SinceVersion()) == versions.cend()) {
+      continue;
+    }
+
+    if (entry->selector->Select(graph_viewer, node).has_value()) {
+      // the group can be fused, so the transformer did not run on it
+      return "fusible by the '" + entry->name + "' QDQ fusion, which did not run";
+    }
+
+    rejected_by += (rejected_by.empty() ? "'" : ", '") + entry->name + "'";
+  }
+
+  if (rejected_by.empty()) {
+    return "no QDQ fusion for opset version " + std::to_string(node.SinceVersion()) + " of the op type";
+  }
+
+  return "rejected by the " + rejected_by +
+         " QDQ fusion, e.g. because of the quantization types, the scales or zero points, or an output that is used"
+         " outside of the group";
+}
+
+Status QDQFusionReport::ApplyImpl(Graph& graph, bool& /*modified*/, int /*graph_level*/,
+                                  const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  size_t num_unfused_groups = 0;
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph.GetNode(index);
+    if (node == nullptr || QDQ::MatchDQNode(*node) || QDQ::MatchQNode(*node)) {
+      continue;
+    }
+
+    const bool has_dq_input = std::any_of(node->InputNodesBegin(), node->InputNodesEnd(),
+                                          [](const Node& input) { return QDQ::MatchDQNode(input); });
+    const bool has_q_output = std::any_of(node->OutputNodesBegin(), node->OutputNodesEnd(),
+                                          [](const Node& output) { return QDQ::MatchQNode(output); });
+    if (!has_dq_input || !has_q_output) {
+      continue;
+    }
+
+    ++num_unfused_groups;
+    LOGS(logger, WARNING) << "Unfused QDQ group around " << node->OpType() << " node '" << node->Name()
+                          << "': " << GetReason(graph_viewer, *node);
+  }
+
+  LOGS(logger, WARNING) << "QDQFusionReport found " << num_unfused_groups << " unfused QDQ groups";
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/selectors_actions/selector_action_transformer.h"
+
+namespace onnxruntime {
+
+/**
+    @Class QDQFusionReport
+
+    Logs the DQ -> op -> Q groups that are left in the graph after the QDQ fusions, and why they were not fused.
+    Such an op runs in float, with a DQ and a Q around it, which is where the quantized model loses throughput.
+
+    The reasons are:
+    - the op is assigned to an EP the QDQSelectorActionTransformer does not run for.
+    - there is no QDQ fusion for the op type or its opset version.
+    - the selectors of the QDQ fusions for the op type rejected the group, e.g. because of the quantization types,
+      non-constant or mismatched scales and zero points, or a float output that is also used outside of the group.
+
+    The graph is not modified. Should run after the level 2 optimizations.
+    */
+class QDQFusionReport : public GraphTransformer {
+ public:
+  QDQFusionReport(bool is_int8_allowed);
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::string GetReason(const GraphViewer& graph_viewer, const Node& node) const;
+
+  SelectorActionRegistry selector_action_registry_;
+};
+
+}  // namespace onnxruntime
@@ -39,6 +39,7 @@ void DropQDQNodesRules(SelectorActionRegistry& qdq_selector_action_registry) {
   const std::string drop_action_name{"drop"};
   const std::string drop_action_no_int16_name{"drop_no_int16_support"};
   const std::string drop_action_no_int16_and_positive_scale_name{"drop_no_int16_support_and_positive_scale"};
+  const std::string drop_pad_action_name{"dropPad"};
   NTO::NodeLocation dq{NTO::NodeType::kInput, 0};
   NTO::NodeLocation q{NTO::NodeType::kOutput, 0};
 
@@ -52,6 +53,8 @@ void DropQDQNodesRules(SelectorActionRegistry& qdq_selector_action_registry) {
       std::vector<NodeAndMoveInfo>(moves));  // Copy before std::move(moves)
   std::unique_ptr<Action> drop_action_no_int16_and_positive_scale = std::make_unique<MergeIntoTargetFixed>(
       std::vector<NodeAndMoveInfo>(moves));  // Copy before std::move(moves)
+  std::unique_ptr<Action> drop_pad_action = std::make_unique<MergeIntoTargetFixed>(
+      std::vector<NodeAndMoveInfo>(moves));  // Copy before std::move(moves)
   std::unique_ptr<Action> drop_action = std::make_unique<MergeIntoTargetFixed>(std::move(moves));
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -76,6 +79,13 @@ void DropQDQNodesRules(SelectorActionRegistry& qdq_selector_action_registry) {
                                                          std::move(selector_no_16bit_and_positive_scale),
                                                          std::move(drop_action_no_int16_and_positive_scale));
 
+  // Pad has 8-bit kernels only, and can only use its padding value if that is the zero point.
+  std::unique_ptr<NodeSelector> pad_selector = std::make_unique<QDQ::DropPadQDQNodesSelector>();
+  qdq_selector_action_registry.RegisterSelectorAndAction(drop_pad_action_name,
+                                                         {{"Pad", {11, 13, 18, 19, 21}}},
+                                                         std::move(pad_selector),
+                                                         std::move(drop_pad_action));
+
   std::unique_ptr<NodeSelector> selector = std::make_unique<QDQ::DropQDQNodesSelector>(true);
   qdq_selector_action_registry.RegisterSelectorAndAction(drop_action_name,
                                                          {{"Gather", {}},
@@ -90,6 +100,7 @@ void DropQDQNodesRules(SelectorActionRegistry& qdq_selector_action_registry) {
   qdq_selector_action_registry.RegisterAction(
       drop_action_no_int16_and_positive_scale_name,
       std::move(drop_action_no_int16_and_positive_scale));
+  qdq_selector_action_registry.RegisterAction(drop_pad_action_name, std::move(drop_pad_action));
   qdq_selector_action_registry.RegisterAction(drop_action_name, std::move(drop_action));
 #endif
 }
@@ -317,7 +328,9 @@ void WhereQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
 #endif
 }
 
-SelectorActionRegistry CreateSelectorActionRegistry(
+}  // namespace
+
+SelectorActionRegistry CreateQDQSelectorActionRegistry(
     bool is_int8_allowed,
     int64_t qdq_matmulnbits_accuracy_level,
     concurrency::ThreadPool* intra_op_thread_pool,
@@ -341,8 +354,6 @@ SelectorActionRegistry CreateSelectorActionRegistry(
   return qdq_selector_action_registry;
 }
 
-}  // namespace
-
 QDQSelectorActionTransformer::QDQSelectorActionTransformer(
     bool is_int8_allowed,
     const SatApplyContextVariant& apply_context,
@@ -351,8 +362,8 @@ QDQSelectorActionTransformer::QDQSelectorActionTransformer(
     std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors)
     : SelectorActionTransformer{
           "QDQSelectorActionTransformer",
-          CreateSelectorActionRegistry(is_int8_allowed, qdq_matmulnbits_accuracy_level,
-                                       intra_op_thread_pool, p_buffered_tensors),
+          CreateQDQSelectorActionRegistry(is_int8_allowed, qdq_matmulnbits_accuracy_level,
+                                          intra_op_thread_pool, p_buffered_tensors),
           apply_context,
           // this transformer is only compatible with the CPU and DML EP
           {kCpuExecutionProvider, kDmlExecutionProvider}} {
@@ -21,6 +21,13 @@ inline constexpr bool QDQIsInt8Allowed() {
 #endif
 }
 
+// Creates the selectors and actions of the QDQSelectorActionTransformer.
+SelectorActionRegistry CreateQDQSelectorActionRegistry(
+    bool is_int8_allowed,
+    int64_t qdq_matmulnbits_accuracy_level = 4,
+    concurrency::ThreadPool* intra_op_thread_pool = nullptr,
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr);
+
 /**
 Transformer that fuses QDQ and fp32 ops into quantized ops.
 */
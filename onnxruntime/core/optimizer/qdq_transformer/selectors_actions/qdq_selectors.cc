@@ -5,6 +5,8 @@
 
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 
+#include <algorithm>
+
 #include "core/graph/graph.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/qdq_transformer/qdq_util.h"
@@ -160,6 +162,43 @@ bool DropQDQNodeGroupSelector::Check(const GraphViewer& graph_viewer,
   return IsQDQPairSupported(q_node, dq_node, get_const_initializer, graph_viewer.ModelPath());
 }
 
+bool DropPadQDQNodeGroupSelector::Check(const GraphViewer& graph_viewer,
+                                        const Node& node,
+                                        const std::vector<const Node*>& dq_nodes,
+                                        const std::vector<const Node*>& q_nodes) const {
+  // the float constant_value can't be used by the quantized Pad
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    return false;
+  }
+
+  if (!DropQDQNodeGroupSelector::Check(graph_viewer, node, dq_nodes, q_nodes)) {
+    return false;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  const auto mode_it = attributes.find("mode");
+  if (mode_it != attributes.end() && mode_it->second.s() != "constant") {
+    return true;
+  }
+
+  // the float padding value 0 is quantized to the zero point, which is only the same as 0 if the zero point is 0
+  const auto& dq_input_defs = dq_nodes[0]->InputDefs();
+  if (dq_input_defs.size() <= InputIndex::ZERO_POINT_ID || !dq_input_defs[InputIndex::ZERO_POINT_ID]->Exists()) {
+    return true;
+  }
+
+  const auto* zero_point_tensor_proto =
+      graph_viewer.GetConstantInitializer(dq_input_defs[InputIndex::ZERO_POINT_ID]->Name(), true);
+  if (zero_point_tensor_proto == nullptr) {
+    return false;
+  }
+
+  Initializer zero_point(*zero_point_tensor_proto, graph_viewer.ModelPath());
+  const auto zero_point_bytes = zero_point.DataAsByteSpan();
+  return std::all_of(zero_point_bytes.begin(), zero_point_bytes.end(), [](uint8_t b) { return b == 0; });
+}
+
 bool DropDQNodeGroupSelector::Check(const GraphViewer& graph_viewer,
                                     const Node& node,
                                     const std::vector<const Node*>& dq_nodes,
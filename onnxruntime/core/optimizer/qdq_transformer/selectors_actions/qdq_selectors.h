@@ -52,16 +52,29 @@ class DropQDQNodeGroupSelector : public NodeGroupSelector {
                                     bool allow_nonpositive_scale = true)
       : allow_16bit_(allow_16bit), allow_4bit_(allow_4bit), allow_nonpositive_scale_(allow_nonpositive_scale) {}
 
- private:
+ protected:
   bool Check(const GraphViewer& graph_viewer, const Node& node,
              const std::vector<const Node*>& dq_nodes,
              const std::vector<const Node*>& q_nodes) const override;
 
+ private:
   bool allow_16bit_;
   bool allow_4bit_;
   bool allow_nonpositive_scale_;
 };
 
+// Single DQ -> Pad -> Q. In addition to the DropQDQNodeGroupSelector checks, the Pad must not have a
+// constant_value input, and in constant mode the zero point must be 0, as the quantized Pad pads with 0.
+class DropPadQDQNodeGroupSelector : public DropQDQNodeGroupSelector {
+ public:
+  DropPadQDQNodeGroupSelector() : DropQDQNodeGroupSelector(false, false) {}
+
+ private:
+  bool Check(const GraphViewer& graph_viewer, const Node& node,
+             const std::vector<const Node*>& dq_nodes,
+             const std::vector<const Node*>& q_nodes) const override;
+};
+
 // Single DQ -> node.
 class DropDQNodeGroupSelector : public NodeGroupSelector {
  public:
@@ -306,6 +319,11 @@ class DropQDQNodesSelector : public BaseSelector {
       : BaseSelector(std::make_unique<DropQDQNodeGroupSelector>(allow_16bit, allow_4bit, allow_nonpositive_scale)) {}
 };
 
+class DropPadQDQNodesSelector : public BaseSelector {
+ public:
+  DropPadQDQNodesSelector() : BaseSelector(std::make_unique<DropPadQDQNodeGroupSelector>()) {}
+};
+
 class DropDQNodesSelector : public BaseSelector {
  public:
   explicit DropDQNodesSelector(bool allow_16bit = false, bool allow_4bit = false)
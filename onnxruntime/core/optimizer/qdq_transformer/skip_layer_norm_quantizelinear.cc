@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer/skip_layer_norm_quantizelinear.h"
+
+#include "core/optimizer/qdq_transformer/qdq_util.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// the single consumer of the normalized output, or nullptr if there isn't exactly one
+static const Node* GetSingleOutputConsumer(const Node& node) {
+  const Node* consumer = nullptr;
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() == 0) {
+      if (consumer != nullptr) {
+        return nullptr;
+      }
+      consumer = &it->GetNode();
+    }
+  }
+
+  return consumer;
+}
+
+bool SkipLayerNormQuantFusion::SatisfyCondition(const Graph& graph, const Node& node,
+                                                const logging::Logger& /*logger*/) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "SkipLayerNormalization", {1}, kMSDomain) ||
+      !graph_utils::IsSupportedProvider(node, {kCpuExecutionProvider}) ||
+      graph.NodeProducesGraphOutput(node)) {
+    return false;
+  }
+
+  const auto* input_type = node.InputDefs()[0]->TypeAsProto();
+  if (input_type == nullptr || input_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  // the mean and inv_std_var outputs are not produced by the fused node
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() == 1 || it->GetSrcArgIndex() == 2) {
+      return false;
+    }
+  }
+
+  const Node* q_node = GetSingleOutputConsumer(node);
+  if (q_node == nullptr ||
+      !graph_utils::IsSupportedProvider(*q_node, {kCpuExecutionProvider}) ||
+      !QDQ::MatchQNode(*q_node)) {
+    return false;
+  }
+
+  bool zero_point_exists = false;
+  if (!QDQ::QOrDQNodeHasConstantScalarScaleAndZeroPoint(
+          *q_node,
+          [&graph](const std::string& name) { return graph_utils::GetConstantInitializer(graph, name); },
+          zero_point_exists) ||
+      !zero_point_exists) {
+    return false;
+  }
+
+  const auto* q_output_type = q_node->OutputDefs()[0]->TypeAsProto();
+  return q_output_type != nullptr &&
+         (q_output_type->tensor_type().elem_type() == TensorProto_DataType_UINT8 ||
+          q_output_type->tensor_type().elem_type() == TensorProto_DataType_INT8);
+}
+
+Status SkipLayerNormQuantFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect,
+                                       const logging::Logger&) const {
+  Node& q_node = *graph.GetNode(GetSingleOutputConsumer(node)->Index());
+
+  const auto& input_defs = node.InputDefs();
+  const auto& q_input_defs = q_node.InputDefs();
+  NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+
+  std::vector<NodeArg*> fused_input_defs;
+  for (size_t i = 0; i < 5; ++i) {
+    fused_input_defs.push_back(i < input_defs.size() ? input_defs[i] : &empty_arg);
+  }
+  fused_input_defs.push_back(q_input_defs[QDQ::InputIndex::SCALE_ID]);
+  fused_input_defs.push_back(q_input_defs[QDQ::InputIndex::ZERO_POINT_ID]);
+
+  // the sum of the input, skip and bias is still produced for the nodes that consume it
+  constexpr int sum_output_idx = 3;
+  const auto& output_defs = node.OutputDefs();
+  NodeArg* sum_output_def = nullptr;
+  if (output_defs.size() > sum_output_idx && output_defs[sum_output_idx]->Exists()) {
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (it->GetSrcArgIndex() == sum_output_idx) {
+        sum_output_def = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output_defs[sum_output_idx]->Name()),
+                                                   output_defs[sum_output_idx]->TypeAsProto());
+        break;
+      }
+    }
+  }
+
+  std::vector<NodeArg*> fused_output_defs{q_node.MutableOutputDefs()[0]};
+  if (sum_output_def != nullptr) {
+    fused_output_defs.push_back(sum_output_def);
+  }
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "/SkipLayerNormQuantFusion/"),
+                                   "QSkipLayerNormalization",
+                                   "Fused SkipLayerNormalization with QuantizeLinear",
+                                   fused_input_defs,
+                                   {},
+                                   {},
+                                   kMSDomain);
+  const auto& attributes = node.GetAttributes();
+  if (auto it = attributes.find("epsilon"); it != attributes.end()) {
+    fused_node.AddAttribute("epsilon", it->second.f());
+  }
+  fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  if (sum_output_def != nullptr) {
+    graph_utils::ReplaceDownstreamNodeInput(graph, node, sum_output_idx, fused_node, 1);
+  }
+
+  graph_utils::FinalizeNodeFusion(graph, {node, q_node}, fused_node);
+
+  // FinalizeNodeFusion replaces the outputs of the fused node with the outputs of the QuantizeLinear
+  if (sum_output_def != nullptr) {
+    fused_node.MutableOutputDefs().push_back(sum_output_def);
+  }
+
+  rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+    @Class SkipLayerNormQuantFusion
+
+    Rewrite rule that fuses SkipLayerNormalization and the QuantizeLinear of its output into QSkipLayerNormalization
+ */
+class SkipLayerNormQuantFusion : public RewriteRule {
+ public:
+  SkipLayerNormQuantFusion() noexcept : RewriteRule("SkipLayerNormQuantRewrite") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"SkipLayerNormalization"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger& logger) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
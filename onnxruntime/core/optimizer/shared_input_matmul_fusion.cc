@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/shared_input_matmul_fusion.h"
+
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/node_attr_utils.h"
+#include "core/optimizer/initializer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// The MatMulNBits inputs that are concatenated: B, scales and zero_points. They all have N in their first dimension.
+constexpr size_t kMatMulNBitsNumFusedInputs = 4;
+
+bool IsMatMulNBits(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain);
+}
+
+// The packed zero points of MatMulNBits are concatenated byte by byte, which only keeps them in place when the zero
+// points of each column start on a byte, like the kernels expect. Zero points packed across the columns are not, and
+// when a node has an odd number of 4 bit zero points, the ones of the next node would be shifted by a nibble.
+bool HasConcatenableZeroPoints(const Graph& graph, const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() <= 3 || !input_defs[3]->Exists()) {
+    return true;
+  }
+
+  const auto* zero_points = graph_utils::GetConstantInitializer(graph, input_defs[3]->Name());
+  if (zero_points == nullptr || zero_points->data_type() != ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    // the zero points of the type of A are not packed
+    return zero_points != nullptr;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  const auto get_attribute = [&attributes](const char* name, int64_t default_value) {
+    const auto it = attributes.find(name);
+    return it != attributes.end() ? it->second.i() : default_value;
+  };
+  const int64_t n = get_attribute("N", 0);
+  const int64_t k = get_attribute("K", 0);
+  const int64_t bits = get_attribute("bits", 4);
+  const int64_t block_size = get_attribute("block_size", 0);
+  if (n <= 0 || k <= 0 || bits <= 0 || block_size <= 0) {
+    return false;
+  }
+
+  const int64_t blocks_per_column = (k + block_size - 1) / block_size;
+  const int64_t zero_point_bytes_per_column = (blocks_per_column * bits + 7) / 8;
+  return utils::GetTensorShapeFromTensorProto(*zero_points).Size() == n * zero_point_bytes_per_column;
+}
+
+// Returns a key that is the same for the nodes that can be fused together, or an empty string if the node can't be.
+std::string GetFusionKey(const Graph& graph, const Node& node, const NodeArg& input,
+                         const InlinedHashSet<std::string_view>& compatible_execution_providers) {
+  const auto& input_defs = node.InputDefs();
+  if (!graph_utils::IsSupportedProvider(node, compatible_execution_providers) || input_defs[0] != &input) {
+    return {};
+  }
+
+  std::ostringstream key;
+  key << node.OpType() << ":" << node.GetExecutionProviderType();
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    const auto* weight = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+    if (weight == nullptr || weight->dims_size() != 2) {
+      return {};
+    }
+
+    key << ":" << weight->data_type() << ":" << weight->dims(0);
+    return key.str();
+  }
+
+  if (IsMatMulNBits(node)) {
+    if (!HasConcatenableZeroPoints(graph, node)) {
+      return {};
+    }
+
+    for (size_t i = 1; i < input_defs.size(); ++i) {
+      if (!input_defs[i]->Exists()) {
+        key << ":-";
+        continue;
+      }
+
+      // g_idx, bias and the other optional inputs are not split along N in their first dimension
+      const auto* weight = i < kMatMulNBitsNumFusedInputs
+                               ? graph_utils::GetConstantInitializer(graph, input_defs[i]->Name())
+                               : nullptr;
+      if (weight == nullptr) {
+        return {};
+      }
+
+      // the other dimensions don't depend on N
+      key << ":" << weight->data_type();
+      for (int dim = 1; dim < weight->dims_size(); ++dim) {
+        key << "x" << weight->dims(dim);
+      }
+    }
+
+    const std::map<std::string, ONNX_NAMESPACE::AttributeProto> attributes(node.GetAttributes().cbegin(),
+                                                                           node.GetAttributes().cend());
+    for (const auto& [name, attribute] : attributes) {
+      if (name != "N") {
+        key << ":" << name << "=" << attribute.SerializeAsString();
+      }
+    }
+
+    return key.str();
+  }
+
+  return {};
+}
+
+// Concatenates the input_index-th constant input of the nodes along axis 0 or 1.
+ONNX_NAMESPACE::TensorProto ConcatenateWeights(Graph& graph, gsl::span<Node* const> nodes, size_t input_index,
+                                               int axis) {
+  InlinedVector<std::unique_ptr<Initializer>> weights;
+  int64_t concatenated_dim = 0;
+  for (const Node* node : nodes) {
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, node->InputDefs()[input_index]->Name());
+    weights.push_back(std::make_unique<Initializer>(*tensor_proto, graph.ModelPath()));
+    concatenated_dim += weights.back()->dims()[axis];
+  }
+
+  // copy the rows of the weights one after the other. along axis 0, each weight is a single row.
+  const auto first_dims = weights[0]->dims();
+  const int64_t num_rows = axis == 0 ? 1 : first_dims[0];
+  std::string data;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    for (const auto& weight : weights) {
+      const auto bytes = weight->DataAsByteSpan();
+      const size_t row_size = bytes.size() / narrow<size_t>(num_rows);
+      data.append(reinterpret_cast<const char*>(bytes.data()) + row * row_size, row_size);
+    }
+  }
+
+  ONNX_NAMESPACE::TensorProto concatenated;
+  concatenated.set_name(graph.GenerateNodeArgName(nodes[0]->InputDefs()[input_index]->Name() + "_concat"));
+  concatenated.set_data_type(weights[0]->data_type());
+  for (int dim = 0; dim < static_cast<int>(first_dims.size()); ++dim) {
+    concatenated.add_dims(dim == axis ? concatenated_dim : first_dims[dim]);
+  }
+
+  utils::SetRawDataInTensorProto(concatenated, std::move(data));
+  return concatenated;
+}
+
+void FuseNodes(Graph& graph, NodeArg& input, gsl::span<Node* const> nodes) {
+  const Node& first_node = *nodes[0];
+  const bool is_matmul_nbits = IsMatMulNBits(first_node);
+
+  InlinedVector<int64_t> split_sizes;
+  for (const Node* node : nodes) {
+    split_sizes.push_back(
+        is_matmul_nbits ? node->GetAttributes().at("N").i()
+                        : graph_utils::GetConstantInitializer(graph, node->InputDefs()[1]->Name())->dims(1));
+  }
+
+  InlinedVector<NodeArg*> fused_inputs{&input};
+  NodeAttributes fused_attributes = first_node.GetAttributes();
+  if (is_matmul_nbits) {
+    for (size_t i = 1; i < first_node.InputDefs().size() && i < kMatMulNBitsNumFusedInputs; ++i) {
+      fused_inputs.push_back(first_node.InputDefs()[i]->Exists()
+                                 ? &graph_utils::AddInitializer(graph, ConcatenateWeights(graph, nodes, i, 0))
+                                 : &graph.GetOrCreateNodeArg("", nullptr));
+    }
+
+    const int64_t fused_n = std::accumulate(split_sizes.begin(), split_sizes.end(), int64_t{0});
+    fused_attributes["N"] = utils::MakeAttribute("N", fused_n);
+  } else {
+    fused_inputs.push_back(&graph_utils::AddInitializer(graph, ConcatenateWeights(graph, nodes, 1, 1)));
+  }
+
+  // the shape of the fused output is inferred when the graph is resolved
+  ONNX_NAMESPACE::TypeProto fused_output_type = *first_node.OutputDefs()[0]->TypeAsProto();
+  fused_output_type.mutable_tensor_type()->clear_shape();
+  NodeArg& fused_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("shared_input_matmul"),
+                                                   &fused_output_type);
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(first_node.Name() + "/SharedInputMatMulFusion"),
+                                   first_node.OpType(), "MatMul nodes with a shared input fused", fused_inputs,
+                                   {&fused_output}, &fused_attributes, first_node.Domain());
+  fused_node.SetExecutionProviderType(first_node.GetExecutionProviderType());
+
+  ONNX_NAMESPACE::TensorProto split_initializer_proto;
+  split_initializer_proto.set_name(graph.GenerateNodeArgName("splits"));
+  split_initializer_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  split_initializer_proto.add_dims(static_cast<int64_t>(split_sizes.size()));
+  split_initializer_proto.mutable_int64_data()->Add(split_sizes.begin(), split_sizes.end());
+  NodeArg* split_initializer_arg = &graph_utils::AddInitializer(graph, split_initializer_proto);
+
+  InlinedVector<NodeArg*> split_outputs;
+  for (Node* node : nodes) {
+    split_outputs.push_back(node->MutableOutputDefs()[0]);
+  }
+
+  Node& split_node = graph.AddNode(graph.GenerateNodeName(first_node.Name() + "/SharedInputMatMulFusion/Split"),
+                                   "Split", "Split for fused MatMul nodes with a shared input",
+                                   {&fused_output, split_initializer_arg}, split_outputs);
+  split_node.AddAttribute("axis", static_cast<int64_t>(-1));
+  split_node.SetExecutionProviderType(first_node.GetExecutionProviderType());
+
+  for (Node* node : nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+}
+
+}  // namespace
+
+Status SharedInputMatMulFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  // Split has the split sizes as an input since OpSet 13. To make code simple, support OpSet >= 13 only.
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_opset_it = domain_to_version.find(kOnnxDomain);
+  if (onnx_opset_it == domain_to_version.end() || onnx_opset_it->second < 13) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedVector<NodeArg*> shared_inputs;
+  for (const NodeArg* graph_input : graph.GetInputs()) {
+    shared_inputs.push_back(graph.GetNodeArg(graph_input->Name()));
+  }
+
+  for (auto node_index : node_topology_list) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;  // node was removed
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    for (NodeArg* output : node->MutableOutputDefs()) {
+      if (output->Exists()) {
+        shared_inputs.push_back(output);
+      }
+    }
+  }
+
+  for (NodeArg* input : shared_inputs) {
+    // group the consumers that can be fused together. std::map for a deterministic order.
+    std::map<std::string, InlinedVector<Node*>> groups;
+    for (Node* consumer : graph.GetMutableConsumerNodes(input->Name())) {
+      auto key = GetFusionKey(graph, *consumer, *input, GetCompatibleExecutionProviders());
+      if (!key.empty()) {
+        groups[key].push_back(consumer);
+      }
+    }
+
+    for (const auto& [key, nodes] : groups) {
+      if (nodes.size() < 2) {
+        continue;
+      }
+
+      LOGS(logger, VERBOSE) << "SharedInputMatMulFusion fused " << nodes.size() << " " << nodes[0]->OpType()
+                            << " nodes consuming " << input->Name();
+      FuseNodes(graph, *input, nodes);
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
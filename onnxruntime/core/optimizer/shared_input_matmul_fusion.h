@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SharedInputMatMulFusion
+
+Fuse the MatMul nodes that multiply the same input with different constant weights, e.g. the Q/K/V projections of an
+attention block or the gate/up projections of an MLP, into one MatMul followed by a Split of the last dimension:
+
+        X                              X
+     /  |  \                           |
+MatMul MatMul MatMul   ->   MatMul (concatenated weights)
+  |     |      |                       |
+  Y0    Y1     Y2                    Split
+                                    /  |  \
+                                  Y0   Y1  Y2
+
+The weights are concatenated along N when the graph is loaded, so that the input is only read once and the GEMM is
+larger. MatMul weights must be 2D. MatMulNBits nodes are fused if they have the same attributes other than N, and
+no inputs other than the weights, scales and zero points.
+
+Should run after the fusions that match individual MatMul nodes, e.g. AttentionFusion.
+*/
+class SharedInputMatMulFusion : public GraphTransformer {
+ public:
+  SharedInputMatMulFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SharedInputMatMulFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,346 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/symbolic_shape_propagation.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/parse_string.h"
+#include "core/common/safeint.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// A dimension value as the product of an integer and symbolic dimensions. The symbols are sorted and may repeat.
+struct SymbolicDim {
+  int64_t factor{1};
+  std::vector<std::string> symbols;
+
+  bool IsConstant() const { return symbols.empty(); }
+
+  // "12", "seq", "batch*seq", "12*seq"
+  std::string ToString() const {
+    std::string result = factor != 1 || symbols.empty() ? std::to_string(factor) : std::string{};
+    for (const auto& symbol : symbols) {
+      if (!result.empty()) {
+        result += "*";
+      }
+      result += symbol;
+    }
+    return result;
+  }
+};
+
+using SymbolicValues = InlinedVector<std::optional<SymbolicDim>>;
+
+// the values of the shape tensors by name. a node based map as the values of several inputs are looked up at once.
+using SymbolicValuesMap = NodeHashMap<std::string, SymbolicValues>;
+
+// a dim_param such as "batch*seq" set by an earlier run of the transformer is parsed back into its factors so that
+// the algebra stays consistent
+std::optional<SymbolicDim> FromDimension(const TensorShapeProto_Dimension& dim) {
+  if (utils::HasDimValue(dim)) {
+    return SymbolicDim{dim.dim_value(), {}};
+  }
+  if (!utils::HasDimParam(dim)) {
+    return std::nullopt;
+  }
+
+  SymbolicDim result;
+  const auto& dim_param = dim.dim_param();
+  size_t begin = 0;
+  while (begin <= dim_param.size()) {
+    const size_t end = std::min(dim_param.find('*', begin), dim_param.size());
+    const std::string token = dim_param.substr(begin, end - begin);
+    if (token.empty()) {
+      // not an expression we created, use the whole dim_param as the symbol
+      return SymbolicDim{1, {dim_param}};
+    }
+    int64_t number = 0;
+    if (std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; }) &&
+        TryParseStringWithClassicLocale(token, number)) {
+      result.factor = SafeInt<int64_t>(result.factor) * number;
+    } else {
+      result.symbols.push_back(token);
+    }
+    begin = end + 1;
+  }
+  std::sort(result.symbols.begin(), result.symbols.end());
+  return result;
+}
+
+SymbolicDim Multiply(const SymbolicDim& a, const SymbolicDim& b) {
+  SymbolicDim result{SafeInt<int64_t>(a.factor) * b.factor, {}};
+  std::merge(a.symbols.begin(), a.symbols.end(), b.symbols.begin(), b.symbols.end(),
+             std::back_inserter(result.symbols));
+  return result;
+}
+
+// returns a / b, or nullopt if b does not divide a
+std::optional<SymbolicDim> Divide(const SymbolicDim& a, const SymbolicDim& b) {
+  if (b.factor == 0 || a.factor % b.factor != 0 ||
+      !std::includes(a.symbols.begin(), a.symbols.end(), b.symbols.begin(), b.symbols.end())) {
+    return std::nullopt;
+  }
+  SymbolicDim result{a.factor / b.factor, {}};
+  std::set_difference(a.symbols.begin(), a.symbols.end(), b.symbols.begin(), b.symbols.end(),
+                      std::back_inserter(result.symbols));
+  return result;
+}
+
+// Returns the values of a 0-D or 1-D int64 tensor, or nullptr if they are not known
+const SymbolicValues* GetValues(const Graph& graph, const NodeArg& node_arg,
+                                SymbolicValuesMap& values) {
+  if (auto it = values.find(node_arg.Name()); it != values.end()) {
+    return &it->second;
+  }
+
+  const TensorProto* initializer = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  InlinedVector<int64_t> data;
+  if (initializer == nullptr || initializer->dims_size() > 1 ||
+      !optimizer_utils::AppendTensorFromInitializer(graph, node_arg, data, true)) {
+    return nullptr;
+  }
+
+  SymbolicValues& initializer_values = values[node_arg.Name()];
+  for (int64_t value : data) {
+    initializer_values.push_back(SymbolicDim{value, {}});
+  }
+  return &initializer_values;
+}
+
+// Computes the values of the output of a node which operates on shape tensors. Returns false if they are not known.
+bool ComputeValues(const Graph& graph, const Node& node, SymbolicValuesMap& values,
+                   SymbolicValues& output_values) {
+  const auto& inputs = node.InputDefs();
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Shape", {1, 13, 15, 19, 21})) {
+    const auto* shape = inputs[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+
+    const int64_t rank = shape->dim_size();
+    auto get_bound = [&](const char* name, int64_t default_value) {
+      const auto* attr = graph_utils::GetNodeAttribute(node, name);
+      int64_t bound = attr != nullptr && attr->has_i() ? attr->i() : default_value;
+      bound = bound < 0 ? bound + rank : bound;
+      return std::clamp<int64_t>(bound, 0, rank);
+    };
+    const int64_t start = get_bound("start", 0);
+    const int64_t end = get_bound("end", rank);
+    for (int64_t i = start; i < end; ++i) {
+      output_values.push_back(FromDimension(shape->dim(static_cast<int>(i))));
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    const auto* attr = graph_utils::GetNodeAttribute(node, "axis");
+    if (attr != nullptr && attr->has_i() && attr->i() != 0) {
+      return false;
+    }
+
+    const SymbolicValues* data = GetValues(graph, *inputs[0], values);
+    InlinedVector<int64_t> indices;
+    if (data == nullptr || !optimizer_utils::AppendTensorFromInitializer(graph, *inputs[1], indices, true)) {
+      return false;
+    }
+
+    const int64_t size = static_cast<int64_t>(data->size());
+    for (int64_t index : indices) {
+      index = index < 0 ? index + size : index;
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      output_values.push_back((*data)[static_cast<size_t>(index)]);
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1, 11, 13, 21}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1, 11, 13, 21})) {
+    // the elements of a shape tensor are not changed by adding or removing dimensions of size 1
+    const SymbolicValues* data = GetValues(graph, *inputs[0], values);
+    if (data == nullptr) {
+      return false;
+    }
+    output_values = *data;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13, 19, 21})) {
+    const auto* attr = graph_utils::GetNodeAttribute(node, "to");
+    const SymbolicValues* data = GetValues(graph, *inputs[0], values);
+    if (attr == nullptr || !attr->has_i() || data == nullptr ||
+        (attr->i() != TensorProto_DataType_INT64 && attr->i() != TensorProto_DataType_INT32)) {
+      return false;
+    }
+    output_values = *data;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {1, 4, 11, 13})) {
+    // shape tensors are at most 1-D, so axis is 0 or -1
+    for (const auto* input : inputs) {
+      const SymbolicValues* data = GetValues(graph, *input, values);
+      if (data == nullptr) {
+        return false;
+      }
+      output_values.insert(output_values.end(), data->begin(), data->end());
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14})) {
+    const SymbolicValues* a = GetValues(graph, *inputs[0], values);
+    const SymbolicValues* b = GetValues(graph, *inputs[1], values);
+    if (a == nullptr || b == nullptr || (a->size() != b->size() && a->size() != 1 && b->size() != 1)) {
+      return false;
+    }
+
+    const size_t size = std::max(a->size(), b->size());
+    for (size_t i = 0; i < size; ++i) {
+      const auto& a_value = (*a)[a->size() == 1 ? 0 : i];
+      const auto& b_value = (*b)[b->size() == 1 ? 0 : i];
+      output_values.push_back(a_value && b_value ? std::optional<SymbolicDim>{Multiply(*a_value, *b_value)}
+                                                 : std::nullopt);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// Computes the output dimensions of a Reshape node and sets the ones that are unknown in its output.
+// Returns true if the output shape was updated.
+bool UpdateReshapeOutputShape(const Graph& graph, Node& reshape, SymbolicValuesMap& values) {
+  const auto* attr = graph_utils::GetNodeAttribute(reshape, "allowzero");
+  if (attr != nullptr && attr->has_i() && attr->i() != 0) {
+    return false;
+  }
+
+  const SymbolicValues* target_shape = GetValues(graph, *reshape.InputDefs()[1], values);
+  if (target_shape == nullptr) {
+    return false;
+  }
+
+  const auto* data_shape = reshape.InputDefs()[0]->Shape();
+  SymbolicValues output_dims;
+  std::optional<size_t> inferred_dim_index;
+  for (size_t i = 0; i < target_shape->size(); ++i) {
+    const auto& value = (*target_shape)[i];
+    if (value && value->IsConstant() && value->factor == 0) {
+      // copy the dimension from the input
+      if (data_shape == nullptr || static_cast<int>(i) >= data_shape->dim_size()) {
+        return false;
+      }
+      output_dims.push_back(FromDimension(data_shape->dim(static_cast<int>(i))));
+    } else if (value && value->IsConstant() && value->factor == -1) {
+      inferred_dim_index = i;
+      output_dims.push_back(std::nullopt);
+    } else {
+      output_dims.push_back(value);
+    }
+  }
+
+  if (inferred_dim_index && data_shape != nullptr) {
+    // the inferred dimension is the element count of the input divided by the other output dimensions
+    std::optional<SymbolicDim> element_count = SymbolicDim{};
+    for (const auto& dim : data_shape->dim()) {
+      const auto input_dim = FromDimension(dim);
+      element_count = input_dim && element_count ? std::optional<SymbolicDim>{Multiply(*element_count, *input_dim)}
+                                                 : std::nullopt;
+    }
+    for (size_t i = 0; i < output_dims.size() && element_count; ++i) {
+      if (i != *inferred_dim_index) {
+        element_count = output_dims[i] ? Divide(*element_count, *output_dims[i]) : std::nullopt;
+      }
+    }
+    output_dims[*inferred_dim_index] = element_count;
+  }
+
+  NodeArg& output = *reshape.MutableOutputDefs()[0];
+  TensorShapeProto output_shape;
+  if (const auto* existing_shape = output.Shape(); existing_shape != nullptr) {
+    if (existing_shape->dim_size() != static_cast<int>(output_dims.size())) {
+      return false;
+    }
+    output_shape = *existing_shape;
+  } else {
+    for (size_t i = 0; i < output_dims.size(); ++i) {
+      output_shape.add_dim();
+    }
+  }
+
+  bool updated = false;
+  for (size_t i = 0; i < output_dims.size(); ++i) {
+    auto& dim = *output_shape.mutable_dim(static_cast<int>(i));
+    const auto& output_dim = output_dims[i];
+    if (utils::HasDimValue(dim) || utils::HasDimParam(dim) || !output_dim || output_dim->factor < 0) {
+      continue;
+    }
+
+    if (output_dim->IsConstant()) {
+      dim.set_dim_value(output_dim->factor);
+    } else {
+      dim.set_dim_param(output_dim->ToString());
+    }
+    updated = true;
+  }
+
+  if (updated) {
+    output.SetShape(output_shape);
+  }
+  return updated;
+}
+
+}  // namespace
+
+Status SymbolicShapePropagation::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                           const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  SymbolicValuesMap values;
+  int updated_count = 0;
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5, 13, 14, 19, 21})) {
+      if (UpdateReshapeOutputShape(graph, node, values)) {
+        LOGS(logger, VERBOSE) << "Set the symbolic shape of Reshape output " << node.OutputDefs()[0]->Name();
+        ++updated_count;
+        modified = true;
+      }
+      continue;
+    }
+
+    SymbolicValues output_values;
+    if (node.OutputDefs().size() == 1 && ComputeValues(graph, node, values, output_values)) {
+      values.insert_or_assign(node.OutputDefs()[0]->Name(), std::move(output_values));
+    }
+  }
+
+  if (updated_count > 0) {
+    LOGS(logger, INFO) << "Total Reshape outputs with propagated symbolic shapes: " << updated_count;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
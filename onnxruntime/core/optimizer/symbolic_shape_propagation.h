@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SymbolicShapePropagation
+
+Transformer that computes the output shapes of Reshape nodes whose target shape is built at runtime from the
+symbolic dimensions of other tensors, e.g. Shape -> Gather -> Unsqueeze -> Concat -> Reshape, which ONNX shape
+inference cannot do.
+
+The values of the int64 shape tensors are tracked as products of an integer and symbolic dimensions through
+Shape, Gather, Unsqueeze, Squeeze, Concat, Mul and Cast. The dimensions of a Reshape output that shape inference left
+unknown are set to the computed values, using dim_params such as "batch*seq" for the symbolic ones. Shape inference
+propagates them further when the graph is resolved, so that fusions can match the shapes of dynamic models.
+*/
+class SymbolicShapePropagation : public GraphTransformer {
+ public:
+  SymbolicShapePropagation(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SymbolicShapePropagation", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -2860,10 +2860,17 @@ static bool TryConstantFoldNode(OptimizerCtx& ctx, api::NodeRef& node) {
   return true;
 }
 
-// Performs optimization. General algorithm: iterate over nodes in topological order. If a node has a transpose
-// as input, push it through if the transpose cost does not increase and is likely to decrease.
-OptimizeResult OptimizeImpl(OptimizerCtx& ctx) {
-  OptimizeResult result{};
+static size_t CountTransposes(const std::vector<std::unique_ptr<api::NodeRef>>& nodes) {
+  return static_cast<size_t>(std::count_if(nodes.begin(), nodes.end(),
+                                           [](const std::unique_ptr<api::NodeRef>& node) {
+                                             return node->IsOp("Transpose");
+                                           }));
+}
+
+// Runs a single pass over the graph. General algorithm: iterate over nodes in topological order. If a node has a
+// transpose as input, push it through if the transpose cost does not increase and is likely to decrease.
+// Returns true if the graph was modified. Sets have_dq if the graph has a DequantizeLinear node.
+static bool PushTransposes(OptimizerCtx& ctx, bool& have_dq) {
   const std::vector<std::unique_ptr<api::NodeRef>> nodes = ctx.graph.Nodes();
 
   std::unordered_set<std::string> outputs_leading_to_transpose;
@@ -2894,7 +2901,6 @@ OptimizeResult OptimizeImpl(OptimizerCtx& ctx) {
   }
 
   bool changed = false;
-  bool have_dq = false;
 
   // 3 Scenarios:
   //
@@ -2962,8 +2968,34 @@ OptimizeResult OptimizeImpl(OptimizerCtx& ctx) {
       }
     }
   }
+
+  return changed;
+}
+
+OptimizeResult OptimizeImpl(OptimizerCtx& ctx, size_t max_passes) {
+  OptimizeResult result{};
+  const size_t num_transposes_before = CountTransposes(ctx.graph.Nodes());
+
+  bool have_dq = false;
+  bool changed = PushTransposes(ctx, have_dq);
+
+  // Pushing a Transpose can leave new Transposes before nodes that were already visited, e.g. on the other inputs of
+  // a binary op, and these can only be pushed by another pass. The additional passes only use the default cost
+  // check, as it requires the cost to strictly decrease. A custom cost check may push a Transpose regardless, which
+  // could move it back and forth between the inputs of a node on every pass. Stop once a pass makes no change.
+  if (changed && max_passes > 1) {
+    OptimizerCtx default_cost_check_ctx{ctx.opset, ctx.graph, ctx.provider_type, nullptr, ctx.extended_handlers};
+    for (size_t pass = 1; pass < max_passes; ++pass) {
+      if (!PushTransposes(default_cost_check_ctx, have_dq)) {
+        break;
+      }
+    }
+  }
+
   if (!have_dq) {
     result.graph_modified = changed;
+    result.num_transposes_removed = static_cast<int64_t>(num_transposes_before) -
+                                    static_cast<int64_t>(CountTransposes(ctx.graph.Nodes()));
     return result;
   }
 
@@ -3016,6 +3048,8 @@ OptimizeResult OptimizeImpl(OptimizerCtx& ctx) {
   }
 
   result.graph_modified = changed;
+  result.num_transposes_removed = static_cast<int64_t>(num_transposes_before) -
+                                  static_cast<int64_t>(CountTransposes(ctx.graph.Nodes()));
   return result;
 }
 
@@ -3041,7 +3075,7 @@ const std::unordered_set<std::string_view>& GetLayoutSensitiveOps() {
 }
 
 OptimizeResult Optimize(api::GraphRef& graph, const std::string& provider_type, CostCheckFn cost_check_fn,
-                        const HandlerMap& extended_handlers) {
+                        const HandlerMap& extended_handlers, size_t max_passes) {
   OptimizeResult result{};
 
   std::string error_msg;
@@ -3055,7 +3089,7 @@ OptimizeResult Optimize(api::GraphRef& graph, const std::string& provider_type,
     return result;
   }
 
-  return OptimizeImpl(*ctx);
+  return OptimizeImpl(*ctx, max_passes);
 }
 
 }  // namespace onnx_transpose_optimization
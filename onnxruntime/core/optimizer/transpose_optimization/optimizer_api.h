@@ -490,6 +490,8 @@ const std::unordered_set<std::string_view>& GetLayoutSensitiveOps();
 struct OptimizeResult {
   std::optional<std::string> error_msg;  // set if there was an error
   bool graph_modified{false};
+  // net number of Transpose nodes removed. negative if more were added than removed.
+  int64_t num_transposes_removed{0};
 };
 
 // see transpose_optimizer.h if you wish to provide extended handlers
@@ -515,11 +517,15 @@ using HandlerMap = std::unordered_map<std::string_view, const HandlerInfo&>;
 /// <param name="extended_handlers">Map of handlers for non-ONNX operators and/or ONNX operators where special handling
 /// is required (e.g. ONNX Resize is layout agnostic but may be implemented in a layout sensitive way).
 /// </param>
+/// <param name="max_passes">Maximum number of passes over the graph. A pass may leave Transposes before nodes it
+/// already visited, which a later pass can push further. Passes stop early once one makes no change.
+/// </param>
 /// <returns>OptimizeResult. If error_msg is set the Optimize failed. If not set, graph_modified indicates whether
 /// any changes were required during optimization.</returns>
 OptimizeResult Optimize(api::GraphRef& graph,
                         const std::string& provider_type = "",
                         CostCheckFn cost_check_fn = nullptr,
-                        const HandlerMap& extended_handlers = {});
+                        const HandlerMap& extended_handlers = {},
+                        size_t max_passes = 1);
 
 }  // namespace onnx_transpose_optimization
@@ -37,6 +37,10 @@ Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_lev
     LOGS(logger, WARNING) << "Transpose optimizer failed: " << result.error_msg.value();
   }
 
+  if (result.num_transposes_removed != 0) {
+    LOGS(logger, VERBOSE) << "Transpose optimizer removed " << result.num_transposes_removed << " Transpose nodes";
+  }
+
   if (result.graph_modified) {
     modified = true;
   }
@@ -34,6 +34,21 @@ std::ostream& operator<<(std::ostream& os, gsl::span<const LogicalProcessors> af
 
 Env::Env() = default;
 
+void* Env::AllocatePages(size_t /*size*/, size_t /*huge_page_size*/, int /*numa_node*/) const {
+  return nullptr;
+}
+
+void Env::FreePages(void* /*p*/, size_t /*size*/) const {
+}
+
+bool Env::ReleaseMemoryPages(const void* /*p*/, size_t /*size*/) const {
+  return false;
+}
+
+bool Env::ProtectMemoryPagesReadOnly(void* /*p*/, size_t /*size*/) const {
+  return false;
+}
+
 std::pair<int, std::string> GetErrnoInfo() {
   auto err = errno;
   std::string msg;
@@ -62,6 +62,10 @@ class EnvThread {
 /// Type that holds a collection of logical processors IDs used for setting affinities.
 using LogicalProcessors = std::vector<int>;
 
+/// Throughput of an efficient core (E-core) relative to a performance core (P-core) of a hybrid CPU, for platforms
+/// that report the class of each core but not its capacity.
+constexpr float kEfficientCoreThroughputWeight = 0.5f;
+
 // Parameters that are required to create a set of threads for a thread pool
 struct ThreadOptions {
   // Stack size for a new thread. If it is 0, the operating system uses the same value as the stack that's specified for
@@ -84,6 +88,27 @@ struct ThreadOptions {
   // The process that owns the thread may consider setting its affinity.
   std::vector<LogicalProcessors> affinities;
 
+  // Relative throughput of the core each entry of affinities binds a thread to, 1.0 for the fastest cores.
+  // On hybrid CPUs the thread pool uses it to size the blocks of parallel loops so the threads on the slower cores
+  // do not become stragglers. Ignored unless it has one entry per affinity.
+  std::vector<float> throughput_weights;
+
+  // NUMA node of the core each entry of affinities binds a thread to. When the threads span several nodes the
+  // thread pool gives the threads of each node a contiguous part of the iterations of a loop, and with
+  // numa_local_stealing only steals work from the queues of threads on the same node.
+  // Ignored unless it has one entry per affinity.
+  std::vector<int> numa_nodes;
+  bool numa_local_stealing = true;
+
+  // Measure the cost of the iterations of each ParallelFor call site at runtime and size its blocks and the number
+  // of threads it enlists from the measurements instead of the cost estimated by the caller.
+  bool calibrate_loop_costs = false;
+
+  // Divide the threads of the pool equally among the threads outside the pool that run parallel loops on it at the
+  // same time, e.g. the inter-op threads of a session using parallel execution, instead of each loop enlisting all
+  // the threads. Keeps the number of busy threads bounded by the size of the pool.
+  bool lease_workers_to_callers = false;
+
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
@@ -91,6 +116,9 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // If spinning is allowed, adapt how long each thread spins to the idle time between its tasks.
+  bool adaptive_spinning = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -140,13 +168,30 @@ class Env {
   static Env& Default();
 
   /// <summary>
-  /// The API returns the number of different physical cores on the system
+  /// The API returns the number of different physical cores on the system that the process can use.
+  /// On Linux this accounts for the affinity mask of the process (e.g. a cgroup cpuset) and the cgroup CPU quota.
   /// </summary>
   /// <returns>Number of physical cores</returns>
   virtual int GetNumPhysicalCpuCores() const = 0;
 
+  /// <summary>
+  /// The API returns the logical processors of each physical core counted by GetNumPhysicalCpuCores().
+  /// </summary>
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// <summary>
+  /// The API returns the relative throughput of each core returned by GetDefaultThreadAffinities(),
+  /// 1.0 for the fastest cores, e.g. the performance cores of a hybrid CPU.
+  /// </summary>
+  /// <returns>One weight per core, or an empty vector if the cores are not known to differ</returns>
+  virtual std::vector<float> GetCoreThroughputWeights() const { return {}; }
+
+  /// <summary>
+  /// The API returns the NUMA node of each core returned by GetDefaultThreadAffinities().
+  /// </summary>
+  /// <returns>One node per core, or an empty vector if the system has a single node or it is not known</returns>
+  virtual std::vector<int> GetCoreNumaNodes() const { return {}; }
+
   virtual int GetL2CacheSize() const = 0;
 
   /// \brief Returns the number of micro-seconds since the Unix epoch.
@@ -194,6 +239,41 @@ class Env {
   virtual common::Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                            MappedMemoryPtr& mapped_memory) const = 0;
 
+  /**
+   * Allocates memory directly from the OS.
+   * @param size The number of bytes to allocate. Should be a multiple of huge_page_size if that is not 0.
+   * @param huge_page_size The huge page size to back the memory with, e.g. 2MB or 1GB. 0 to use regular pages.
+   *        If huge pages of that size are not available regular pages are used instead, with transparent huge
+   *        pages requested where the platform supports them.
+   * @param numa_node The NUMA node to bind the memory to, or -1 to use the default placement policy.
+   * @return The allocated memory, or nullptr if it could not be allocated or the platform doesn't support it.
+   *         Must be released with FreePages.
+   */
+  virtual void* AllocatePages(size_t size, size_t huge_page_size, int numa_node) const;
+
+  /**
+   * Releases memory allocated by AllocatePages.
+   * @param p The pointer returned by AllocatePages.
+   * @param size The size that was passed to AllocatePages.
+   */
+  virtual void FreePages(void* p, size_t size) const;
+
+  /**
+   * Asks the OS to reclaim the resident pages of a memory range, e.g. a mapping created by MapFileIntoMemory that
+   * won't be accessed for a while. The content is preserved: pages backed by a file are read from it again and
+   * other pages are swapped out. Pages that the range only partially covers are included.
+   * @return false if the platform doesn't support it or the request failed.
+   */
+  virtual bool ReleaseMemoryPages(const void* p, size_t size) const;
+
+  /**
+   * Makes memory allocated by AllocatePages read only. Writes to it fault afterwards.
+   * @param p A page aligned pointer into memory returned by AllocatePages.
+   * @param size The number of bytes to protect. Pages that the range only partially covers are included.
+   * @return false if the platform doesn't support it or the request failed.
+   */
+  virtual bool ProtectMemoryPagesReadOnly(void* p, size_t size) const;
+
 #ifdef _WIN32
   /// \brief Returns true if the directory exists.
   virtual bool FolderExists(const std::wstring& path) const = 0;
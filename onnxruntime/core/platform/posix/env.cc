@@ -26,14 +26,19 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sched.h>
 #if !defined(_AIX)
 #include <sys/syscall.h>
 #endif
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <thread>
+#include <unordered_map>
 #include <utility>  // for std::forward
 #include <vector>
 
@@ -89,6 +94,91 @@ struct FileDescriptorTraits {
   }
 };
 
+#if defined(__linux__)
+// Reads a sysfs CPU list such as "0-3,8,10-11". Returns an empty list if the file does not exist.
+[[maybe_unused]] std::vector<int> ReadCpuList(const char* file_path) {
+  std::vector<int> cpus;
+  std::ifstream file(file_path);
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    int first = 0;
+    int last = 0;
+    char separator = 0;
+    std::istringstream range_stream(range);
+    if (!(range_stream >> first)) {
+      break;
+    }
+    last = (range_stream >> separator >> last) && separator == '-' ? last : first;
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// Returns the number of CPUs the CFS bandwidth quota of the cgroup of this process allows, rounded up,
+// or 0 if there is no quota. Both cgroup v2 (cpu.max) and cgroup v1 (cpu.cfs_quota_us) are supported.
+[[maybe_unused]] int GetCgroupCpuQuota() {
+  auto to_cpus = [](long long quota, long long period) {
+    return quota > 0 && period > 0 ? static_cast<int>((quota + period - 1) / period) : 0;
+  };
+
+  // cgroup v2: the entry of the unified hierarchy in /proc/self/cgroup is "0::<path>"
+  std::vector<std::string> cpu_max_paths;
+  std::ifstream cgroup_file("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(cgroup_file, line)) {
+    if (line.rfind("0::", 0) == 0 && line.size() > 4) {
+      cpu_max_paths.push_back("/sys/fs/cgroup" + line.substr(3) + "/cpu.max");
+    }
+  }
+  cpu_max_paths.push_back("/sys/fs/cgroup/cpu.max");
+  for (const auto& path : cpu_max_paths) {
+    std::ifstream cpu_max_file(path);
+    std::string quota;
+    long long period = 0;
+    if (cpu_max_file >> quota >> period) {
+      return quota == "max" ? 0 : to_cpus(std::atoll(quota.c_str()), period);
+    }
+  }
+
+  // cgroup v1, with a quota of -1 meaning unlimited
+  std::ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+  std::ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+  long long quota = 0;
+  long long period = 0;
+  if ((quota_file >> quota) && (period_file >> period)) {
+    return to_cpus(quota, period);
+  }
+  return 0;
+}
+
+#endif
+
+// Returns the logical processors this process may run on, e.g. as limited by a cgroup cpuset or taskset.
+// Returns an empty list if that cannot be determined.
+[[maybe_unused]] std::vector<int> GetAllowedLogicalProcessors() {
+  std::vector<int> processors;
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (int id = 0; id < CPU_SETSIZE; ++id) {
+      if (CPU_ISSET(id, &cpuset)) {
+        processors.push_back(id);
+      }
+    }
+  }
+#endif
+  return processors;
+}
+
+// An empty list of allowed logical processors means that all of them are allowed.
+[[maybe_unused]] bool IsAllowedLogicalProcessor(const std::vector<int>& allowed_processors, int linux_id) {
+  return allowed_processors.empty() ||
+         std::binary_search(allowed_processors.begin(), allowed_processors.end(), linux_id);
+}
+
 // Note: File descriptor cleanup may fail but this class doesn't expose a way to check if it failed.
 //       If that's important, consider using another cleanup method.
 using ScopedFileDescriptor = ScopedResource<FileDescriptorTraits>;
@@ -276,26 +366,41 @@ class PosixEnv : public Env {
   int GetNumPhysicalCpuCores() const override {
 #ifdef ORT_USE_CPUINFO
     if (cpuinfo_available_) {
-      return narrow<int>(cpuinfo_get_cores_count());
+      return narrow<int>(GetUsableCores().size());
     }
 #endif  // ORT_USE_CPUINFO
-    return DefaultNumCores();
+    int num_cores = DefaultNumCores();
+#if defined(__linux__)
+    // assume the same 2 logical processors per core for the processors we are allowed to run on
+    const auto num_allowed_processors = GetAllowedLogicalProcessors().size();
+    if (num_allowed_processors > 0) {
+      num_cores = std::min(num_cores, std::max(1, static_cast<int>(num_allowed_processors / 2)));
+    }
+    const int cpu_quota = GetCgroupCpuQuota();
+    if (cpu_quota > 0) {
+      num_cores = std::min(num_cores, cpu_quota);
+    }
+#endif
+    return num_cores;
   }
 
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override {
     std::vector<LogicalProcessors> ret;
 #ifdef ORT_USE_CPUINFO
     if (cpuinfo_available_) {
-      auto num_phys_cores = cpuinfo_get_cores_count();
-      ret.reserve(num_phys_cores);
-      for (uint32_t i = 0; i < num_phys_cores; ++i) {
+      const auto allowed_processors = GetAllowedLogicalProcessors();
+      const auto usable_cores = GetUsableCores();
+      ret.reserve(usable_cores.size());
+      for (uint32_t i : usable_cores) {
         const auto* core = cpuinfo_get_core(i);
         LogicalProcessors th_aff;
         th_aff.reserve(core->processor_count);
         auto log_proc_idx = core->processor_start;
         for (uint32_t count = 0; count < core->processor_count; count++, ++log_proc_idx) {
           const auto* log_proc = cpuinfo_get_processor(log_proc_idx);
-          th_aff.push_back(log_proc->linux_id);
+          if (IsAllowedLogicalProcessor(allowed_processors, log_proc->linux_id)) {
+            th_aff.push_back(log_proc->linux_id);
+          }
         }
         ret.push_back(std::move(th_aff));
       }
@@ -308,6 +413,71 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<float> GetCoreThroughputWeights() const override {
+    std::vector<float> weights;
+#if defined(ORT_USE_CPUINFO) && defined(__linux__)
+    if (cpuinfo_available_) {
+      // cores of the efficient class of Intel hybrid CPUs, they have their own PMU.
+      const auto efficient_cpus = ReadCpuList("/sys/devices/cpu_atom/cpus");
+      const auto usable_cores = GetUsableCores();
+      weights.reserve(usable_cores.size());
+      for (uint32_t i : usable_cores) {
+        const auto linux_id = cpuinfo_get_processor(cpuinfo_get_core(i)->processor_start)->linux_id;
+        // cpu_capacity is set for asymmetric CPUs, e.g. ARM big.LITTLE, with 1024 for the fastest cores.
+        float weight = 0.0f;
+        std::ifstream capacity_file("/sys/devices/system/cpu/cpu" + std::to_string(linux_id) + "/cpu_capacity");
+        if (!(capacity_file >> weight) || weight <= 0.0f) {
+          weight = std::find(efficient_cpus.begin(), efficient_cpus.end(), static_cast<int>(linux_id)) !=
+                           efficient_cpus.end()
+                       ? kEfficientCoreThroughputWeight
+                       : 1.0f;
+        }
+        weights.push_back(weight);
+      }
+
+      const auto [min_weight, max_weight] = std::minmax_element(weights.begin(), weights.end());
+      if (*min_weight == *max_weight) {
+        return {};
+      }
+      const float fastest = *max_weight;
+      for (auto& weight : weights) {
+        weight /= fastest;
+      }
+    }
+#endif
+    return weights;
+  }
+
+  std::vector<int> GetCoreNumaNodes() const override {
+    std::vector<int> nodes;
+#if defined(ORT_USE_CPUINFO) && defined(__linux__)
+    if (cpuinfo_available_) {
+      const auto online_nodes = ReadCpuList("/sys/devices/system/node/online");
+      if (online_nodes.size() <= 1) {
+        return nodes;
+      }
+      std::unordered_map<int, int> node_of_cpu;
+      for (int node : online_nodes) {
+        const auto cpu_list_path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        for (int cpu : ReadCpuList(cpu_list_path.c_str())) {
+          node_of_cpu[cpu] = node;
+        }
+      }
+      const auto usable_cores = GetUsableCores();
+      nodes.reserve(usable_cores.size());
+      for (uint32_t i : usable_cores) {
+        const auto linux_id = cpuinfo_get_processor(cpuinfo_get_core(i)->processor_start)->linux_id;
+        auto it = node_of_cpu.find(static_cast<int>(linux_id));
+        if (it == node_of_cpu.end()) {
+          return {};
+        }
+        nodes.push_back(it->second);
+      }
+    }
+#endif
+    return nodes;
+  }
+
   int GetL2CacheSize() const override {
 #ifdef _SC_LEVEL2_CACHE_SIZE
     return static_cast<int>(sysconf(_SC_LEVEL2_CACHE_SIZE));
@@ -349,6 +519,87 @@ class PosixEnv : public Env {
     return getpid();
   }
 
+  void* AllocatePages(size_t size, size_t huge_page_size, int numa_node) const override {
+    void* p = MAP_FAILED;
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (huge_page_size > 0) {
+      // log2 of the page size goes in the bits above MAP_HUGE_SHIFT. 0 selects the system default huge page size.
+      constexpr int kMapHugeShift = 26;
+      int page_size_log2 = 0;
+      while ((size_t{1} << (page_size_log2 + 1)) <= huge_page_size) {
+        ++page_size_log2;
+      }
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (page_size_log2 << kMapHugeShift), -1, 0);
+    }
+#endif
+
+    if (p == MAP_FAILED) {
+      // no (or not enough) huge pages reserved. fall back to regular pages.
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) {
+        return nullptr;
+      }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      if (huge_page_size > 0) {
+        // best effort. has no effect if transparent huge pages are disabled.
+        madvise(p, size, MADV_HUGEPAGE);
+      }
+#endif
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    if (numa_node >= 0) {
+      constexpr int kMpolBind = 2;
+      constexpr size_t kBitsPerMask = 8 * sizeof(unsigned long);
+      std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMask + 1, 0);
+      node_mask[static_cast<size_t>(numa_node) / kBitsPerMask] |= 1UL << (static_cast<size_t>(numa_node) % kBitsPerMask);
+      if (syscall(SYS_mbind, p, size, kMpolBind, node_mask.data(), node_mask.size() * kBitsPerMask + 1, 0) != 0) {
+        auto [err_no, err_msg] = GetErrnoInfo();
+        LOGS_DEFAULT(WARNING) << "mbind to NUMA node " << numa_node << " failed. error code: " << err_no
+                              << " error msg: " << err_msg;
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+
+    return p;
+  }
+
+  void FreePages(void* p, size_t size) const override {
+    if (munmap(p, size) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      LOGS_DEFAULT(ERROR) << "munmap failed. error code: " << err_no << " error msg: " << err_msg;
+    }
+  }
+
+  bool ReleaseMemoryPages(const void* p, size_t size) const override {
+#if defined(__linux__)
+    // MADV_PAGEOUT (Linux 5.4) reclaims the pages right away. unlike MADV_DONTNEED it never discards the content.
+    constexpr int kMadvPageout = 21;
+    constexpr int kMadvCold = 20;
+    if (size == 0) {
+      return true;
+    }
+
+    static const uintptr_t page_size = narrow<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(p) / page_size * page_size;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(p) + size + page_size - 1) / page_size * page_size;
+    void* const pages = reinterpret_cast<void*>(begin);
+    // older kernels only support deactivating the pages so they are reclaimed first under memory pressure.
+    return madvise(pages, end - begin, kMadvPageout) == 0 || madvise(pages, end - begin, kMadvCold) == 0;
+#else
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+    return false;
+#endif
+  }
+
+  bool ProtectMemoryPagesReadOnly(void* p, size_t size) const override {
+    return size == 0 || mprotect(p, size, PROT_READ) == 0;
+  }
+
   Status GetFileLength(const PathChar* file_path, size_t& length) const override {
     ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
     return GetFileLength(file_descriptor.Get(), length);
@@ -600,6 +851,32 @@ class PosixEnv : public Env {
       LOGS_DEFAULT(INFO) << "cpuinfo_initialize failed";
     }
   }
+
+  // The indices of the cpuinfo cores this process can use, i.e. the cores with a logical processor that is allowed
+  // by the affinity mask of the process (e.g. a cgroup cpuset), limited to the CPUs of the cgroup CPU quota.
+  std::vector<uint32_t> GetUsableCores() const {
+    const auto allowed_processors = GetAllowedLogicalProcessors();
+    const auto num_phys_cores = cpuinfo_get_cores_count();
+    std::vector<uint32_t> cores;
+    cores.reserve(num_phys_cores);
+    for (uint32_t i = 0; i < num_phys_cores; ++i) {
+      const auto* core = cpuinfo_get_core(i);
+      for (uint32_t count = 0; count < core->processor_count; ++count) {
+        const auto* log_proc = cpuinfo_get_processor(core->processor_start + count);
+        if (IsAllowedLogicalProcessor(allowed_processors, log_proc->linux_id)) {
+          cores.push_back(i);
+          break;
+        }
+      }
+    }
+#if defined(__linux__)
+    const int cpu_quota = GetCgroupCpuQuota();
+    if (cpu_quota > 0 && static_cast<size_t>(cpu_quota) < cores.size()) {
+      cores.resize(static_cast<size_t>(cpu_quota));
+    }
+#endif
+    return cores;
+  }
   bool cpuinfo_available_{false};
 #endif  // ORT_USE_CPUINFO
 };
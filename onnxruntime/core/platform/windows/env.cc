@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -303,6 +304,24 @@ std::vector<LogicalProcessors> WindowsEnv::GetDefaultThreadAffinities() const {
   return cores_.empty() ? std::vector<LogicalProcessors>(DefaultNumCores(), LogicalProcessors{}) : cores_;
 }
 
+std::vector<float> WindowsEnv::GetCoreThroughputWeights() const {
+  if (core_efficiency_classes_.size() != cores_.size() || cores_.empty()) {
+    return {};
+  }
+  const auto [min_class, max_class] = std::minmax_element(core_efficiency_classes_.begin(),
+                                                          core_efficiency_classes_.end());
+  if (*min_class == *max_class) {
+    return {};
+  }
+  // windows reports the class of each core but not how much faster the higher classes are.
+  std::vector<float> weights;
+  weights.reserve(core_efficiency_classes_.size());
+  for (auto efficiency_class : core_efficiency_classes_) {
+    weights.push_back(efficiency_class == *max_class ? 1.0f : kEfficientCoreThroughputWeight);
+  }
+  return weights;
+}
+
 int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
@@ -473,6 +492,42 @@ Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
   return Status::OK();
 }
 
+void* WindowsEnv::AllocatePages(size_t size, size_t huge_page_size, int numa_node) const {
+  const DWORD node = numa_node >= 0 ? static_cast<DWORD>(numa_node) : NUMA_NO_PREFERRED_NODE;
+  void* p = nullptr;
+  if (huge_page_size > 0) {
+    // Requires the SeLockMemoryPrivilege and a size that is a multiple of GetLargePageMinimum().
+    p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                           PAGE_READWRITE, node);
+  }
+
+  if (p == nullptr) {
+    p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+  }
+
+  return p;
+}
+
+void WindowsEnv::FreePages(void* p, size_t /*size*/) const {
+  if (!VirtualFree(p, 0, MEM_RELEASE)) {
+    const auto error_code = GetLastError();
+    LOGS_DEFAULT(ERROR) << "VirtualFree failed. error code: " << error_code;
+  }
+}
+
+bool WindowsEnv::ReleaseMemoryPages(const void* p, size_t size) const {
+  // unlocking pages that are not locked removes them from the working set of the process.
+  if (VirtualUnlock(const_cast<void*>(p), size)) {
+    return true;
+  }
+  return GetLastError() == ERROR_NOT_LOCKED;
+}
+
+bool WindowsEnv::ProtectMemoryPagesReadOnly(void* p, size_t size) const {
+  DWORD old_protect = 0;
+  return size == 0 || VirtualProtect(p, size, PAGE_READONLY, &old_protect) != 0;
+}
+
 bool WindowsEnv::FolderExists(const std::wstring& path) const {
   DWORD attributes = GetFileAttributesW(path.c_str());
   return (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
@@ -925,6 +980,7 @@ void WindowsEnv::InitializeCpuInfo() {
         }
       }
       cores_.push_back(std::move(core_global_proc_ids));
+      core_efficiency_classes_.push_back(static_cast<int>(processor_info->Processor.EfficiencyClass));
       core_id++;
     }
     iter += size;
@@ -55,6 +55,7 @@ class WindowsEnv : public Env {
   static int DefaultNumCores();
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
+  std::vector<float> GetCoreThroughputWeights() const override;
   int GetL2CacheSize() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
@@ -66,6 +67,10 @@ class WindowsEnv : public Env {
                            FileOffsetType offset,
                            size_t length,
                            MappedMemoryPtr& mapped_memory) const override;
+  void* AllocatePages(size_t size, size_t huge_page_size, int numa_node) const override;
+  void FreePages(void* p, size_t size) const override;
+  bool ReleaseMemoryPages(const void* p, size_t size) const override;
+  bool ProtectMemoryPagesReadOnly(void* p, size_t size) const override;
   bool FolderExists(const std::wstring& path) const override;
   bool FolderExists(const std::string& path) const override;
   common::Status CreateFolder(const std::wstring& path) const override;
@@ -115,6 +120,12 @@ class WindowsEnv : public Env {
    */
   std::vector<LogicalProcessors> cores_;
 
+  /*
+   * "core_efficiency_classes_" hosts the efficiency class of each core in "cores_".
+   * A core with a higher class has a higher performance, e.g. the P-cores of a hybrid CPU.
+   */
+  std::vector<int> core_efficiency_classes_;
+
   int l2_cache_size_;
   /*
    * "global_processor_info_map_" is a map of:
@@ -84,6 +84,7 @@ Status ActivationOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder,
     // https://apple.github.io/coremltools/source/coremltools.converters.mil.mil.ops.defs.html#module-coremltools.converters.mil.mil.ops.defs.iOS15.activation
     std::string_view coreml_op_type;
     bool add_alpha = false;
+    bool add_gelu_mode = false;
     if (op_type == "Sigmoid") {
       coreml_op_type = "sigmoid";
     } else if (op_type == "Tanh") {
@@ -93,6 +94,9 @@ Status ActivationOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder,
     } else if (op_type == "LeakyRelu") {
       coreml_op_type = "leaky_relu";
       add_alpha = true;
+    } else if (op_type == "Gelu") {
+      coreml_op_type = "gelu";
+      add_gelu_mode = true;
     } else {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "ActivationOpBuilder::AddToModelBuilderImpl, unknown op: ", op_type);
@@ -107,6 +111,14 @@ Status ActivationOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder,
       AddOperationInput(*op, "alpha", model_builder.AddScalarConstant(op->type(), "alpha", alpha));
     }
 
+    if (add_gelu_mode) {
+      // the com.microsoft Gelu has no 'approximate' attribute and is the exact version
+      NodeAttrHelper helper(node);
+      const auto approximate = helper.Get("approximate", std::string("none"));
+      const std::string mode = approximate == "tanh" ? "TANH_APPROXIMATION" : "EXACT";
+      AddOperationInput(*op, "mode", model_builder.AddScalarConstant(op->type(), "mode", mode));
+    }
+
     AddOperationOutput(*op, *node.OutputDefs()[0]);
 
     model_builder.AddOperation(std::move(op));
@@ -215,6 +227,11 @@ bool ActivationOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInp
   } else
 #endif  // (COREML_ENABLE_MLPROGRAM)
   {
+    if (op_type == "Gelu") {
+      LOGS(logger, VERBOSE) << "Gelu is only supported in an ML Program";
+      return false;
+    }
+
     if (op_type == "PRelu") {
       return IsPReluOpSupported(node, input_params, logger);
     }
@@ -223,7 +240,12 @@ bool ActivationOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInp
   return true;
 }
 
-int ActivationOpBuilder::GetMinSupportedOpSet(const Node& /* node */) const {
+int ActivationOpBuilder::GetMinSupportedOpSet(const Node& node) const {
+  // Gelu is ONNX opset 20 or com.microsoft opset 1, which has no consumed_inputs attribute
+  if (node.OpType() == "Gelu") {
+    return 1;
+  }
+
   // All ops opset 5- uses consumed_inputs attribute which is not supported for now
   return 6;
 }
@@ -239,6 +261,7 @@ void CreateActivationOpBuilder(const std::string& op_type, OpBuilderRegistration
           "Relu",
           "PRelu",
           "LeakyRelu",
+          "Gelu",
       };
 
   op_registrations.builders.push_back(std::make_unique<ActivationOpBuilder>());
@@ -4,6 +4,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/common.h"
 #include "core/providers/coreml/builders/impl/base_op_builder.h"
+#include "core/providers/coreml/builders/impl/builder_utils.h"
 #include "core/providers/coreml/builders/model_builder.h"
 #include "core/providers/coreml/builders/op_builder_factory.h"
 #include "core/providers/coreml/shape_utils.h"
@@ -18,12 +19,13 @@ class SoftmaxOpBuilder : public BaseOpBuilder {
 
   bool IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& input_params,
                          const logging::Logger& logger) const override;
+
+  bool SupportsMLProgram() const override { return true; }
 };
 
 Status SoftmaxOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder,
                                                const Node& node,
                                                const logging::Logger& logger) const {
-  std::unique_ptr<COREML_SPEC::NeuralNetworkLayer> layer = model_builder.CreateNNLayer(node);
   const auto& input_name = node.InputDefs()[0]->Name();
   const auto& output_name = node.OutputDefs()[0]->Name();
 
@@ -35,6 +37,51 @@ Status SoftmaxOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder,
   const auto axis = helper.Get("axis", axis_default_value);
   const auto axis_nonnegative = HandleNegativeAxis(axis, data_shape.size());
 
+#if defined(COREML_ENABLE_MLPROGRAM)
+  if (model_builder.CreateMLProgram()) {
+    using namespace CoreML::Specification::MILSpec;
+    // https://apple.github.io/coremltools/source/coremltools.converters.mil.mil.ops.defs.html#coremltools.converters.mil.mil.ops.defs.iOS15.activation.softmax
+    if (node.SinceVersion() >= 13 || (data_shape.size() == 2)) {
+      auto softmax = model_builder.CreateOperation(node, "softmax");
+      AddOperationInput(*softmax, "x", input_name);
+      AddOperationInput(*softmax, "axis", model_builder.AddScalarConstant(softmax->type(), "axis", int64_t{axis}));
+      AddOperationOutput(*softmax, *node.OutputDefs()[0]);
+      model_builder.AddOperation(std::move(softmax));
+    } else {
+      // as for the NeuralNetwork layers below, coerce the input to 2D based on axis and apply softmax to axis -1.
+      const int32_t elem_type = static_cast<int32_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      TensorShape input_shape(data_shape);
+      std::vector<int64_t> target_shape = {input_shape.SizeToDimension(axis_nonnegative),
+                                           input_shape.SizeFromDimension(axis_nonnegative)};
+
+      auto reshape1 = model_builder.CreateOperation(node, "reshape", "pre");
+      AddOperationInput(*reshape1, "x", input_name);
+      AddOperationInput(*reshape1, "shape", model_builder.AddConstant(reshape1->type(), "shape", target_shape));
+      const auto& reshape1_output = model_builder.GetUniqueName(node, "reshape1");
+      AddIntermediateOperationOutput(*reshape1, reshape1_output, elem_type, target_shape);
+
+      auto softmax = model_builder.CreateOperation(node, "softmax");
+      AddOperationInput(*softmax, "x", reshape1_output);
+      AddOperationInput(*softmax, "axis", model_builder.AddScalarConstant(softmax->type(), "axis", int64_t{-1}));
+      const auto& softmax_output = model_builder.GetUniqueName(node, "softmax");
+      AddIntermediateOperationOutput(*softmax, softmax_output, elem_type, target_shape);
+
+      auto reshape2 = model_builder.CreateOperation(node, "reshape", "post");
+      AddOperationInput(*reshape2, "x", softmax_output);
+      AddOperationInput(*reshape2, "shape", model_builder.AddConstant(reshape2->type(), "shape", data_shape));
+      AddOperationOutput(*reshape2, *node.OutputDefs()[0]);
+
+      model_builder.AddOperation(std::move(reshape1));
+      model_builder.AddOperation(std::move(softmax));
+      model_builder.AddOperation(std::move(reshape2));
+    }
+
+    return Status::OK();
+  }
+#endif  // defined(COREML_ENABLE_MLPROGRAM)
+
+  std::unique_ptr<COREML_SPEC::NeuralNetworkLayer> layer = model_builder.CreateNNLayer(node);
+
   if (node.SinceVersion() >= 13 || (data_shape.size() == 2)) {
     auto* coreml_softmaxnd = layer->mutable_softmaxnd();
     coreml_softmaxnd->set_axis(axis);
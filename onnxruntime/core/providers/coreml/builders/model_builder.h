@@ -29,14 +29,15 @@ class IOpBuilder;
 class ModelBuilder {
  private:
   ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
-               int32_t coreml_version, uint32_t coreml_flags,
+               int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                std::vector<std::string>&& onnx_input_names,
                std::vector<std::string>&& onnx_output_names);
 
  public:
-  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`
+  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`.
+  // If model_cache_dir is not empty, the compiled model is taken from or added to that directory.
   static Status Build(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                      int32_t coreml_version, uint32_t coreml_flags,
+                      int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                       std::vector<std::string>&& onnx_input_names,
                       std::vector<std::string>&& onnx_output_names,
                       std::unique_ptr<Model>& model);
@@ -210,6 +211,7 @@ class ModelBuilder {
   const logging::Logger& logger_;
   const int32_t coreml_version_;
   const uint32_t coreml_flags_;
+  const std::string model_cache_dir_;
   const bool create_ml_program_;         // ML Program (CoreML5, iOS 15+, macOS 12+) or NeuralNetwork (old)
   const std::string model_output_path_;  // create_ml_program_ ? dir for mlpackage : filename for mlmodel
 
@@ -21,6 +21,7 @@ static OpBuilderRegistrations CreateOpBuilderRegistrations() {
   CreateActivationOpBuilder("Relu", op_registrations);
   CreateActivationOpBuilder("PRelu", op_registrations);
   CreateActivationOpBuilder("LeakyRelu", op_registrations);
+  CreateActivationOpBuilder("Gelu", op_registrations);
 
   // Unary ops
   CreateUnaryOpBuilder("Reciprocal", op_registrations);
@@ -3,6 +3,7 @@
 
 #include "core/providers/coreml/model/model.h"
 
+#import <CommonCrypto/CommonDigest.h>
 #import <CoreML/CoreML.h>
 #import <Foundation/Foundation.h>
 
@@ -245,6 +246,73 @@ Status CopyMLMultiArrayBuffer(const void* mlmultiarray_buffer, void* tensor_buff
   }
   return Status::OK();
 }
+
+void UpdateSha256(CC_SHA256_CTX& context, NSData* data) {
+  // CC_SHA256_Update takes a 32-bit length
+  constexpr NSUInteger kMaxChunkSize = 1u << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data.bytes);
+  for (NSUInteger offset = 0; offset < data.length; offset += kMaxChunkSize) {
+    const NSUInteger chunk_size = std::min(kMaxChunkSize, data.length - offset);
+    CC_SHA256_Update(&context, bytes + offset, static_cast<CC_LONG>(chunk_size));
+  }
+}
+
+// Returns the name of the compiled model in the model cache, or nil if the model could not be read.
+// The name is a hash of the CoreML model at `path`, which is an .mlmodel file or an .mlpackage directory, and of the
+// OS version, as the compiled model is specific to the CoreML compiler of the OS.
+NSString* GetCachedModelName(NSString* path) {
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  BOOL is_package = NO;
+  if (![file_manager fileExistsAtPath:path isDirectory:&is_package]) {
+    return nil;
+  }
+
+  // paths relative to the package, sorted so the hash doesn't depend on the enumeration order.
+  // the package manifest is skipped as it holds identifiers that are generated for each package.
+  NSMutableArray<NSString*>* relative_paths = [NSMutableArray array];
+  if (is_package) {
+    for (NSString* relative_path in [file_manager enumeratorAtPath:path]) {
+      BOOL is_directory = NO;
+      if ([relative_path isEqualToString:@"Manifest.json"] ||
+          ![file_manager fileExistsAtPath:[path stringByAppendingPathComponent:relative_path]
+                              isDirectory:&is_directory] ||
+          is_directory) {
+        continue;
+      }
+      [relative_paths addObject:relative_path];
+    }
+    [relative_paths sortUsingSelector:@selector(compare:)];
+  } else {
+    [relative_paths addObject:@""];
+  }
+
+  CC_SHA256_CTX context;
+  CC_SHA256_Init(&context);
+  UpdateSha256(context, [[[NSProcessInfo processInfo] operatingSystemVersionString]
+                            dataUsingEncoding:NSUTF8StringEncoding]);
+
+  for (NSString* relative_path in relative_paths) {
+    NSString* file_path = is_package ? [path stringByAppendingPathComponent:relative_path] : path;
+    NSData* data = [NSData dataWithContentsOfFile:file_path options:NSDataReadingMappedIfSafe error:nil];
+    if (data == nil) {
+      return nil;
+    }
+
+    UpdateSha256(context, [relative_path dataUsingEncoding:NSUTF8StringEncoding]);
+    UpdateSha256(context, data);
+  }
+
+  unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256_Final(digest, &context);
+
+  NSMutableString* name = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2 + 9];
+  for (unsigned char byte : digest) {
+    [name appendFormat:@"%02x", byte];
+  }
+  [name appendString:@".mlmodelc"];
+
+  return name;
+}
 }  // namespace
 
 NS_ASSUME_NONNULL_BEGIN
@@ -256,13 +324,15 @@ NS_ASSUME_NONNULL_BEGIN
 @interface CoreMLExecution : NSObject {
   NSString* coreml_model_path_;
   NSString* compiled_model_path_;
+  NSString* _Nullable model_cache_dir_;
   const logging::Logger* logger_;
   uint32_t coreml_flags_;
 }
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags;
+                coreml_flags:(uint32_t)coreml_flags
+             model_cache_dir:(const std::string&)model_cache_dir;
 - (void)cleanup;
 - (void)dealloc;
 - (Status)loadModel API_AVAILABLE_COREML3;
@@ -279,9 +349,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags {
+                coreml_flags:(uint32_t)coreml_flags
+             model_cache_dir:(const std::string&)model_cache_dir {
   if (self = [super init]) {
     coreml_model_path_ = util::Utf8StringToNSString(path.c_str());
+    model_cache_dir_ = model_cache_dir.empty() ? nil : util::Utf8StringToNSString(model_cache_dir.c_str());
     logger_ = &logger;
     coreml_flags_ = coreml_flags;
   }
@@ -333,14 +405,52 @@ NS_ASSUME_NONNULL_BEGIN
   // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
   // background. We will have to check for completion in `predict` and block until it is done.
   NSError* error = nil;
-  NSURL* compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
-
-  if (error != nil) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error compiling model: ",
-                           [[error localizedDescription] UTF8String]);
+  NSURL* compileUrl = nil;
+
+  NSString* cached_model_path = nil;
+  if (model_cache_dir_ != nil) {
+    NSString* cached_model_name = GetCachedModelName(coreml_model_path_);
+    if (cached_model_name != nil) {
+      cached_model_path = [model_cache_dir_ stringByAppendingPathComponent:cached_model_name];
+      if ([[NSFileManager defaultManager] fileExistsAtPath:cached_model_path]) {
+        LOGS(*logger_, VERBOSE) << "Using the cached compiled model: " << [cached_model_path UTF8String];
+        compileUrl = [NSURL fileURLWithPath:cached_model_path];
+      }
+    } else {
+      LOGS(*logger_, WARNING) << "Failed to read the model to cache: " << [coreml_model_path_ UTF8String];
+    }
   }
 
-  compiled_model_path_ = [compileUrl path];
+  if (compileUrl == nil) {
+    compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
+
+    if (error != nil) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error compiling model: ",
+                             [[error localizedDescription] UTF8String]);
+    }
+
+    compiled_model_path_ = [compileUrl path];
+
+    if (cached_model_path != nil) {
+      // the move fails if another session added the same model meanwhile. the compiled model is then used from
+      // its temporary location and removed in cleanup.
+      NSFileManager* file_manager = [NSFileManager defaultManager];
+      NSError* cache_error = nil;
+      if ([file_manager createDirectoryAtPath:model_cache_dir_
+                  withIntermediateDirectories:YES
+                                   attributes:nil
+                                        error:&cache_error] &&
+          [file_manager moveItemAtPath:compiled_model_path_ toPath:cached_model_path error:&cache_error]) {
+        compiled_model_path_ = nil;
+        compileUrl = [NSURL fileURLWithPath:cached_model_path];
+      } else {
+        LOGS(*logger_, WARNING) << "Failed to add the compiled model to the cache: " << [cached_model_path UTF8String]
+                                << (cache_error != nil
+                                        ? MakeString(", error: ", [[cache_error localizedDescription] UTF8String])
+                                        : "");
+      }
+    }
+  }
 
   MLModelConfiguration* config = [MLModelConfiguration alloc];
   config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
@@ -501,7 +611,8 @@ Status GetMLMultiArrayCopyInfo(const MLMultiArray* _Nonnull array,
 // This class will bridge Model (c++) with CoreMLExecution (objective c++)
 class Execution {
  public:
-  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags);
+  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+            const std::string& model_cache_dir);
   ~Execution() {};
 
   Status LoadModel();
@@ -514,11 +625,13 @@ class Execution {
   CoreMLExecution* execution_;
 };
 
-Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags) {
+Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+                     const std::string& model_cache_dir) {
   @autoreleasepool {
     execution_ = [[CoreMLExecution alloc] initWithPath:path
                                                 logger:logger
-                                          coreml_flags:coreml_flags];
+                                          coreml_flags:coreml_flags
+                                       model_cache_dir:model_cache_dir];
   }
 }
 
@@ -562,8 +675,9 @@ Model::Model(const std::string& path,
              std::unordered_set<std::string>&& scalar_outputs,
              std::unordered_set<std::string>&& int64_outputs,
              const logging::Logger& logger,
-             uint32_t coreml_flags)
-    : execution_(std::make_unique<Execution>(path, logger, coreml_flags)),
+             uint32_t coreml_flags,
+             const std::string& model_cache_dir)
+    : execution_(std::make_unique<Execution>(path, logger, coreml_flags, model_cache_dir)),
       model_input_names_(std::move(model_input_names)),
       model_output_names_(std::move(model_output_names)),
       input_output_info_(std::move(input_output_info)),
@@ -23,6 +23,8 @@
 #include "core/framework/TensorSeq.h"
 #include "core/providers/utils.h"
 
+#include <algorithm>
+
 #include <gsl/gsl>
 
 #ifdef _MSC_VER
@@ -193,6 +195,23 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  const auto& condition_input_name = subgraph_input_names[1];
+  const auto& condition_output_name = subgraph_output_names[0];
+  const auto* condition_producer = subgraph.GetProducerNode(condition_output_name);
+  condition_is_loop_invariant = condition_output_name == condition_input_name ||
+                                (condition_producer != nullptr &&
+                                 condition_producer->OpType() == "Identity" &&
+                                 condition_producer->Domain() == kOnnxDomain &&
+                                 condition_producer->InputDefs()[0]->Name() == condition_input_name);
+
+  can_write_scan_output_in_place.reserve(static_cast<size_t>(num_outputs) - num_loop_carried_vars);
+  for (int i = num_loop_carried_vars + 1; i < num_subgraph_outputs; ++i) {
+    const auto& name = subgraph_output_names[i];
+    can_write_scan_output_in_place.push_back(
+        subgraph.GetProducerNode(name) != nullptr &&
+        std::count(subgraph_output_names.begin(), subgraph_output_names.end(), name) == 1);
+  }
 }
 
 class LoopImpl {
@@ -211,7 +230,13 @@ class LoopImpl {
 
  private:
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  Status SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+
+  // set up the fetches for the next iteration, adding the slices of the Loop outputs written in place
+  void CreateFetches(int64_t iter_num, std::vector<OrtValue>& fetches);
+
+  // allocate the Loop output for all iterations and copy the output of the first iteration into it
+  Status AllocateLoopOutput(const OrtValue& first_output, int output_index);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
@@ -232,6 +257,11 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // Loop outputs written in place by each iteration when the trip count is known up front.
+  // nullptr if the output is concatenated from loop_output_tensors_ after the last iteration.
+  std::vector<Tensor*> in_place_loop_outputs_;
+  bool write_loop_outputs_in_place_{false};
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -433,6 +463,13 @@ Status LoopImpl::Initialize() {
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank != 0);
 
   loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+  in_place_loop_outputs_.resize(loop_output_tensors_.size(), nullptr);
+
+  // if the trip count is known the Loop outputs can be allocated after the first iteration, and each later
+  // iteration writes its output directly into its slice instead of being concatenated at the end.
+  // INT64_MAX means there was no 'M' input.
+  write_loop_outputs_in_place_ = info_.condition_is_loop_invariant && condition_ &&
+                                 max_trip_count_ > 1 && max_trip_count_ != INT64_MAX;
 
   return status;
 }
@@ -455,8 +492,8 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
-                                         std::vector<OrtValue>& next_inputs) {
+Status LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
+                                           std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
@@ -465,11 +502,67 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
-  // save loop outputs as we have to concatenate at the end
+  // save loop outputs as we have to concatenate at the end, unless they are written in place
   for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    ORT_RETURN_IF_NOT(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
+    const auto output_idx = j - info_.num_loop_carried_vars;
+    if (write_loop_outputs_in_place_ && info_.can_write_scan_output_in_place[output_idx]) {
+      if (in_place_loop_outputs_[output_idx] == nullptr) {
+        ORT_RETURN_IF_ERROR(AllocateLoopOutput(last_outputs[j + 1], static_cast<int>(j)));  // skip 'cond' in output
+      }
+    } else {
+      loop_output_tensors_[output_idx].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    }
   }
+
+  return Status::OK();
+}
+
+void LoopImpl::CreateFetches(int64_t iter_num, std::vector<OrtValue>& fetches) {
+  fetches.clear();
+  if (!write_loop_outputs_in_place_) {
+    return;
+  }
+
+  // empty entries are allocated by the subgraph execution
+  fetches.resize(info_.num_subgraph_outputs);
+  for (size_t i = 0, end = in_place_loop_outputs_.size(); i < end; ++i) {
+    Tensor* output = in_place_loop_outputs_[i];
+    if (output == nullptr) {
+      continue;
+    }
+
+    const auto bytes_per_iteration = output->SizeInBytes() / gsl::narrow<size_t>(max_trip_count_);
+    auto* iteration_data = static_cast<gsl::byte*>(output->MutableDataRaw()) +
+                           gsl::narrow<size_t>(iter_num) * bytes_per_iteration;
+    // skip 'cond' and the loop carried vars in the subgraph outputs
+    Tensor::InitOrtValue(output->DataType(), output->Shape().Slice(1), iteration_data, output->Location(),
+                         fetches[i + info_.num_loop_carried_vars + 1]);
+  }
+}
+
+Status LoopImpl::AllocateLoopOutput(const OrtValue& first_output, int output_index) {
+  const auto& per_iteration_dims = first_output.Get<Tensor>().Shape().GetDims();
+
+  std::vector<int64_t> dims;
+  dims.reserve(1 + per_iteration_dims.size());
+
+  // first dimension is number of iterations
+  dims.push_back(max_trip_count_);
+  std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+
+  Tensor* output = context_.Output(output_index, TensorShape(dims));
+  ORT_RETURN_IF(output == nullptr, "Failed to allocate Loop output ", output_index);
+
+  // copy the first iteration into the start of the output
+  std::vector<OrtValue> per_iteration_output{first_output};
+  Stream* ort_stream = context_.GetComputeStream();
+  ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, per_iteration_output,
+                                          output->MutableDataRaw(),
+                                          output->SizeInBytes() / gsl::narrow<size_t>(max_trip_count_)));
+
+  in_place_loop_outputs_[static_cast<size_t>(output_index) - info_.num_loop_carried_vars] = output;
+  return Status::OK();
 }
 
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
@@ -502,18 +595,20 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
+  utils::RepeatedSubgraphExecutor subgraph_executor(session_state_, ffm, ExecutionMode::ORT_SEQUENTIAL,
+                                                    context_.GetTerminateFlag(), context_.Logger(),
+                                                    context_.GetComputeStream());
+
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
-      SaveOutputsAndUpdateFeeds(fetches, feeds);
-      fetches.clear();
+      ORT_RETURN_IF_ERROR(SaveOutputsAndUpdateFeeds(fetches, feeds));
+      CreateFetches(iter_num_value, fetches);
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
-                                    ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
-                                    context_.GetComputeStream(),
-                                    // because the fetch[0] is the loop condition which we need to access on CPU,
-                                    // have to perofrm a stream sync to make sure the data arrived.
-                                    true);
+    status = subgraph_executor.Execute(feeds, fetches, {},
+                                       // because the fetch[0] is the loop condition which we need to access on CPU,
+                                       // have to perofrm a stream sync to make sure the data arrived.
+                                       true);
     ORT_RETURN_IF_ERROR(status);
 
     condition_mlvalue_ = fetches[0];
@@ -594,6 +689,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+      // the last iteration wrote directly into the output
+      if (in_place_loop_outputs_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars] != nullptr) {
+        continue;
+      }
+
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
@@ -38,6 +38,13 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // true if the subgraph passes the 'cond' input through unchanged, so the trip count is 'M' if 'cond' is true.
+    bool condition_is_loop_invariant;
+
+    // for each Loop scan output, true if the subgraph output is produced by a node in the subgraph and is not
+    // another subgraph output, so each iteration can write it directly into its slice of the Loop output.
+    std::vector<bool> can_write_scan_output_in_place;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
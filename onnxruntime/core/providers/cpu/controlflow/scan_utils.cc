@@ -208,6 +208,10 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     feeds[num_variadic_inputs + i] = *implicit_inputs[i];
   }
 
+  utils::RepeatedSubgraphExecutor subgraph_executor(session_state, ffm, ExecutionMode::ORT_SEQUENTIAL,
+                                                    context.GetTerminateFlag(), context.Logger(),
+                                                    context.GetComputeStream());
+
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
     for (int input = 0; input < num_variadic_inputs; ++input) {
@@ -269,10 +273,8 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
       }
     }
 
-    // Create Executor and run graph.
-    status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
-                                    ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger(),
-                                    context.GetComputeStream());
+    // Run graph.
+    status = subgraph_executor.Execute(feeds, fetches, fetch_allocators);
 
     ORT_RETURN_IF_ERROR(status);
 
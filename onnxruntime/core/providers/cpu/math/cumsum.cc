@@ -3,50 +3,69 @@
 
 #include "cumsum.h"
 #include "core/providers/common.h"
-#include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
 
 using namespace onnxruntime;
 
 namespace {
-// static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(onnxruntime::narrow<size_t>(rank), 0);
-  starts[onnxruntime::narrow<size_t>(axis)] = index;
-  return starts;
-}
+
+// Columns of the inner dimensions scanned together by one task.
+constexpr size_t kColumnBlockSize = 256;
+
+// Cumulative sum of a row of contiguous elements, the running sum stays in a register.
 template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
+void CumSumRow(const T* input, T* output, size_t dim, bool exclusive, bool reverse) {
+  T sum{};
+  for (size_t k = 0; k < dim; ++k) {
+    const size_t j = reverse ? dim - 1 - k : k;
+    const T value = input[j];
+    if (exclusive) {
+      output[j] = sum;
+      sum += value;
+    } else {
+      sum += value;
+      output[j] = sum;
+    }
   }
 }
-template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
-  }
+
+template <>
+void CumSumRow<float>(const float* input, float* output, size_t dim, bool exclusive, bool reverse) {
+  MlasComputeCumulativeSum(input, output, dim, exclusive, reverse);
 }
+
+// Cumulative sum of `count` contiguous columns along an axis with `inner` elements between its consecutive entries.
+// Every output row is the previous output row plus an input row.
 template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
+void CumSumColumns(const T* input, T* output, size_t dim, size_t inner, size_t count, bool exclusive, bool reverse) {
+  const std::ptrdiff_t step = reverse ? -static_cast<std::ptrdiff_t>(inner) : static_cast<std::ptrdiff_t>(inner);
+  const std::ptrdiff_t first = reverse ? static_cast<std::ptrdiff_t>((dim - 1) * inner) : 0;
+
+  const T* x = input + first;
+  T* y = output + first;
+  if (exclusive) {
+    std::fill_n(y, count, T{});
+  } else {
+    std::copy_n(x, count, y);
+  }
+
+  for (size_t d = 1; d < dim; ++d) {
+    const T* previous_y = y;
+    // the exclusive sum adds the input row of the previous output row
+    const T* addend = exclusive ? x : x + step;
+    x += step;
+    y += step;
+    for (size_t k = 0; k < count; ++k) {
+      y[k] = previous_y[k] + addend[k];
+    }
   }
 }
+
 }  // namespace
 
 namespace onnxruntime {
@@ -200,64 +219,38 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   int64_t axis = 0;
   ORT_THROW_IF_ERROR(cumsum_op::GetAxis(axis_tensor, rank, axis));
 
-  auto dim(output_tensor.Shape()[onnxruntime::narrow<size_t>(axis)]);  // dimension size for the axis
-  TensorShape slice_shape(input->Shape());                             // the shape of one slice of input/output for the given value of the axis
-  slice_shape[onnxruntime::narrow<size_t>(axis)] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(onnxruntime::narrow<size_t>(rank), 1);  // steps for the slice -- always set to 1
-
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    if (index < dim) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    if (index >= 0) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  }
+  // The input is viewed as [outer, dim, inner] and the sums along dim are independent for every outer row and inner
+  // column. An innermost axis is scanned row by row, any other axis by blocks of contiguous columns.
+  const size_t axis_index = onnxruntime::narrow<size_t>(axis);
+  const size_t dim = onnxruntime::narrow<size_t>(output_shape[axis_index]);
+  const size_t outer = onnxruntime::narrow<size_t>(output_shape.SizeToDimension(axis_index));
+  const size_t inner = onnxruntime::narrow<size_t>(output_shape.SizeFromDimension(axis_index + 1));
+  const size_t column_blocks = (inner + kColumnBlockSize - 1) / kColumnBlockSize;
+  const size_t block_size = inner == 1 ? 1 : std::min(inner, kColumnBlockSize);
+
+  const T* input_data = input->Data<T>();
+  T* output_data = output_tensor.MutableData<T>();
+  const bool exclusive = exclusive_ != 0;
+  const bool reverse = reverse_ != 0;
+
+  const TensorOpCost cost{static_cast<double>(dim * block_size * sizeof(T)),
+                          static_cast<double>(dim * block_size * sizeof(T)),
+                          static_cast<double>(dim * block_size)};
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(outer * column_blocks), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const size_t o = static_cast<size_t>(task) / column_blocks;
+          const size_t column = (static_cast<size_t>(task) % column_blocks) * kColumnBlockSize;
+          const size_t offset = o * dim * inner + column;
+          if (inner == 1) {
+            CumSumRow(input_data + offset, output_data + offset, dim, exclusive, reverse);
+          } else {
+            CumSumColumns(input_data + offset, output_data + offset, dim, inner,
+                          std::min(kColumnBlockSize, inner - column), exclusive, reverse);
+          }
+        }
+      });
 
   return Status::OK();
 }
@@ -13,6 +13,11 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
 #include "einsum_auxiliary_ops.h"
 
 namespace onnxruntime {
@@ -41,6 +46,30 @@ inline int64_t LetterToIndex(char ch) {
   return -1;
 }
 
+// Order of the pair-wise contractions of the operands. Each step contracts the operands at the positions
+// `first` < `second` of the list of remaining operands, the result replaces `first` and `second` is removed.
+using ContractionPath = std::vector<std::pair<size_t, size_t>>;
+
+// Keeps the contraction path found for the last input shapes, so that it is searched again only when they change.
+class ContractionPathCache {
+ public:
+  ContractionPath Get(const std::vector<int64_t>& key, const std::function<ContractionPath()>& find_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!valid_ || key != key_) {
+      path_ = find_path();
+      key_ = key;
+      valid_ = true;
+    }
+    return path_;
+  }
+
+ private:
+  std::mutex mutex_;
+  bool valid_ = false;
+  std::vector<int64_t> key_;
+  ContractionPath path_;
+};
+
 }  // namespace EinsumOp
 
 struct EinsumEquationPreprocessor {
@@ -76,11 +105,13 @@ struct EinsumEquationPreprocessor {
   }
 
   // Holds the pre-processed equation string
-  // In theory, we could re-write the einsum equation to lower overall cost of intermediate arrays
-  // See numpy.einsum_path for details/examples
-  // These are very advanced optimizations that we don't require for the average use-case
   std::string einsum_preprocessed_equation_;
 
+  // Contraction path of the operands for the last input shapes (see numpy.einsum_path),
+  // shared by the copies of this struct held by each Compute()
+  std::shared_ptr<EinsumOp::ContractionPathCache> contraction_path_cache_ =
+      std::make_shared<EinsumOp::ContractionPathCache>();
+
   // In explicit form, holds the left side of the einsum equation
   // (e.g.) Einsum equation = 'i,j->i', then left_equation_ = 'i,j'
   // In implicit form, holds the entire einsum equation
@@ -142,6 +173,9 @@ class EinsumComputePreprocessor final {
   // Get the number of subscript indices (subscript labels) in the einsum equation
   int64_t GetNumSubscriptIndices() const;
 
+  // Get the cache of the contraction path shared by every Compute() of the kernel
+  EinsumOp::ContractionPathCache& GetContractionPathCache();
+
   // Pass-in device specific functions
   // (Pass-in CPU implementation or CUDA implementation function depending on the kernel using this class)
   void SetDeviceHelpers(const EinsumOp::DeviceHelpers::Diagonal& diagonal_func,
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "einsum_typed_compute_processor.h"
+
+#include <algorithm>
+
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
@@ -343,6 +346,144 @@ void EinsumTypedComputeProcessor<T>::SetDeviceHelpers(const EinsumOp::DeviceHelp
   device_data_copy_func_ = device_data_copy_func;
 }
 
+// Computes the dims of the result of contracting the operands `first` and `second` of `operand_dims`.
+// A label is reduced by the contraction if it is not in the output and no other remaining operand has it,
+// the reduced labels are added to `reduced_dims` (in ascending order) if it is given.
+static void ContractOperandDims(const std::vector<TensorShapeVector>& operand_dims, size_t first, size_t second,
+                                const std::vector<int64_t>& subscript_indices_to_output_indices,
+                                TensorShapeVector& result_dims, TensorShapeVector* reduced_dims) {
+  const size_t num_labels = operand_dims[first].size();
+  result_dims.resize(num_labels);
+  for (size_t label = 0; label < num_labels; ++label) {
+    int64_t dim = std::max(operand_dims[first][label], operand_dims[second][label]);
+    if (dim > 1 && subscript_indices_to_output_indices[label] == -1) {
+      bool is_needed = false;
+      for (size_t other = 0; other < operand_dims.size() && !is_needed; ++other) {
+        is_needed = other != first && other != second && operand_dims[other][label] > 1;
+      }
+      if (!is_needed) {
+        dim = 1;
+        if (reduced_dims != nullptr) {
+          reduced_dims->push_back(static_cast<int64_t>(label));
+        }
+      }
+    }
+    result_dims[label] = dim;
+  }
+}
+
+// Number of multiply-adds of the contraction of two operands.
+static double ContractionCost(const TensorShapeVector& left_dims, const TensorShapeVector& right_dims) {
+  double cost = 1.0;
+  for (size_t label = 0; label < left_dims.size(); ++label) {
+    cost *= static_cast<double>(std::max(left_dims[label], right_dims[label]));
+  }
+  return cost;
+}
+
+static double OperandSize(const TensorShapeVector& dims) {
+  double size = 1.0;
+  for (int64_t dim : dims) {
+    size *= static_cast<double>(dim);
+  }
+  return size;
+}
+
+// Contracts at every step the pair of operands that shrinks the intermediate results the most,
+// preferring the pairs sharing a label over outer products.
+static EinsumOp::ContractionPath FindGreedyContractionPath(std::vector<TensorShapeVector> operand_dims,
+                                                           const std::vector<int64_t>& subscript_indices_to_output_indices,
+                                                           double& total_cost) {
+  EinsumOp::ContractionPath path;
+  total_cost = 0.0;
+  TensorShapeVector result_dims;
+  TensorShapeVector best_result_dims;
+  while (operand_dims.size() > 1) {
+    size_t best_first = 0;
+    size_t best_second = 1;
+    bool best_is_shared = false;
+    double best_removed = 0.0;
+    double best_cost = 0.0;
+    bool found = false;
+    for (size_t first = 0; first < operand_dims.size(); ++first) {
+      for (size_t second = first + 1; second < operand_dims.size(); ++second) {
+        const auto& left_dims = operand_dims[first];
+        const auto& right_dims = operand_dims[second];
+        bool is_shared = false;
+        for (size_t label = 0; label < left_dims.size() && !is_shared; ++label) {
+          is_shared = left_dims[label] > 1 && right_dims[label] > 1;
+        }
+        ContractOperandDims(operand_dims, first, second, subscript_indices_to_output_indices, result_dims, nullptr);
+        double removed = OperandSize(result_dims) - OperandSize(left_dims) - OperandSize(right_dims);
+        double cost = ContractionCost(left_dims, right_dims);
+        bool is_better = !found ||
+                         (is_shared != best_is_shared ? is_shared
+                                                      : (removed != best_removed ? removed < best_removed
+                                                                                 : cost < best_cost));
+        if (is_better) {
+          found = true;
+          best_first = first;
+          best_second = second;
+          best_is_shared = is_shared;
+          best_removed = removed;
+          best_cost = cost;
+          best_result_dims = result_dims;
+        }
+      }
+    }
+    path.emplace_back(best_first, best_second);
+    total_cost += best_cost;
+    operand_dims[best_first] = best_result_dims;
+    operand_dims.erase(operand_dims.begin() + best_second);
+  }
+  return path;
+}
+
+// Tries every order of the pair-wise contractions and keeps the one with the fewest multiply-adds.
+static void FindOptimalContractionPath(const std::vector<TensorShapeVector>& operand_dims,
+                                       const std::vector<int64_t>& subscript_indices_to_output_indices,
+                                       double cost, EinsumOp::ContractionPath& path,
+                                       double& best_cost, EinsumOp::ContractionPath& best_path) {
+  if (operand_dims.size() == 1) {
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_path = path;
+    }
+    return;
+  }
+  for (size_t first = 0; first < operand_dims.size(); ++first) {
+    for (size_t second = first + 1; second < operand_dims.size(); ++second) {
+      double step_cost = cost + ContractionCost(operand_dims[first], operand_dims[second]);
+      if (step_cost >= best_cost) {
+        continue;
+      }
+      std::vector<TensorShapeVector> next_operand_dims = operand_dims;
+      ContractOperandDims(operand_dims, first, second, subscript_indices_to_output_indices,
+                          next_operand_dims[first], nullptr);
+      next_operand_dims.erase(next_operand_dims.begin() + second);
+      path.emplace_back(first, second);
+      FindOptimalContractionPath(next_operand_dims, subscript_indices_to_output_indices, step_cost, path,
+                                 best_cost, best_path);
+      path.pop_back();
+    }
+  }
+}
+
+// Up to this many operands, every contraction order is tried.
+static constexpr size_t kMaxOperandsForOptimalContractionPath = 5;
+
+static EinsumOp::ContractionPath FindContractionPath(const std::vector<TensorShapeVector>& operand_dims,
+                                                     const std::vector<int64_t>& subscript_indices_to_output_indices) {
+  double best_cost = 0.0;
+  EinsumOp::ContractionPath best_path = FindGreedyContractionPath(operand_dims, subscript_indices_to_output_indices,
+                                                                  best_cost);
+  if (operand_dims.size() <= kMaxOperandsForOptimalContractionPath) {
+    EinsumOp::ContractionPath path;
+    FindOptimalContractionPath(operand_dims, subscript_indices_to_output_indices, 0.0, path, best_cost, best_path);
+  }
+  return best_path;
+}
+
 template <typename T>
 Status EinsumTypedComputeProcessor<T>::Run() {
   const auto& mapped_indices_to_last_input_index = einsum_compute_preprocessor_.GetMappedSubscriptIndicesToLastInputIndex();
@@ -398,6 +539,66 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     }
   }
 
+  // With more than 2 operands, the order of the pair-wise contractions decides the size of the intermediate
+  // results, so the operands are contracted along the cheapest path instead of from left to right.
+  // Empty operands keep the left to right order as a dim of 0 is not seen as a label of the operand.
+  if (num_inputs > 2) {
+    std::vector<const Tensor*> operands(onnxruntime::narrow<size_t>(num_inputs));
+    std::vector<TensorShape> operand_shapes(operands.size());
+    std::vector<std::unique_ptr<const Tensor>> intermediate_results(operands.size());
+    std::vector<TensorShapeVector> operand_dims(operands.size());
+    std::vector<int64_t> path_key{num_subscript_labels};
+    bool has_empty_operand = false;
+    for (size_t input = 0; input < operands.size(); ++input) {
+      if (input == 0 && result) {
+        intermediate_results[0] = std::move(result);
+        operands[0] = intermediate_results[0].get();
+        operand_shapes[0] = operands[0]->Shape();
+      } else {
+        operands[input] = preprocessed_inputs[input] ? preprocessed_inputs[input].get() : raw_inputs[input];
+        operand_shapes[input] = homogenized_input_dims[input];
+      }
+      operand_dims[input] = operand_shapes[input].AsShapeVector();
+      for (int64_t dim : operand_dims[input]) {
+        has_empty_operand = has_empty_operand || dim == 0;
+        path_key.push_back(dim);
+      }
+    }
+
+    if (!has_empty_operand) {
+      const auto& subscript_indices_to_output_indices =
+          einsum_compute_preprocessor_.GetMappedSubscriptIndicesToOutputindices();
+      EinsumOp::ContractionPath path = einsum_compute_preprocessor_.GetContractionPathCache().Get(
+          path_key, [&]() { return FindContractionPath(operand_dims, subscript_indices_to_output_indices); });
+
+      TensorShapeVector result_dims;
+      for (size_t step = 0; step < path.size(); ++step) {
+        const size_t first = path[step].first;
+        const size_t second = path[step].second;
+        TensorShapeVector reduced_dims;
+        ContractOperandDims(operand_dims, first, second, subscript_indices_to_output_indices, result_dims,
+                            &reduced_dims);
+        const bool is_final_pair = step + 1 == path.size();
+        auto contracted = PairwiseOperandProcess(*operands[first], operand_shapes[first],
+                                                 *operands[second], operand_shapes[second],
+                                                 reduced_dims, is_final_pair);
+        if (!is_final_pair) {
+          operand_shapes[first] = contracted->Shape();
+          operand_dims[first] = result_dims;
+          intermediate_results[first] = std::move(contracted);
+          operands[first] = intermediate_results[first].get();
+          operands.erase(operands.begin() + second);
+          operand_shapes.erase(operand_shapes.begin() + second);
+          operand_dims.erase(operand_dims.begin() + second);
+          intermediate_results.erase(intermediate_results.begin() + second);
+        }
+      }
+      return Status::OK();
+    }
+
+    result = std::move(intermediate_results[0]);
+  }
+
   // Process the operands in a pair-wise fashion
   {
     bool is_final_pair = false;
@@ -153,110 +153,166 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
           .TypeConstraint("T1", T2_CONSTRAINTS),                                                 \
       KERNEL_CLASS);
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, double, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int32_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int64_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, float, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, double, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int32_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int64_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int64_t, Add);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, float, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, double, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int32_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int64_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, float, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, double, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int32_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int64_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int64_t, Sub);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, float, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, double, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int32_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int64_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, float, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, double, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int32_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int64_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int64_t, Mul);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, float, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, double, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int32_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int64_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, float, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, double, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int32_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int64_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int64_t, Div);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, float, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, double, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int8_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int16_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int32_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int64_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint8_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint16_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint32_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint64_t, Abs);
-
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, float, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, double, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int64_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint64_t, Abs);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, float, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, double, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int8_t, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int32_t, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int64_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, float, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, double, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int8_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int32_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int64_t, Neg);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, float, Floor);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, double, Floor);
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 13, float, Floor);
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 13, double, Floor);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, float, Ceil);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, double, Ceil);
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 13, float, Ceil);
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 13, double, Ceil);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, float, Reciprocal);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, double, Reciprocal);
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 13, float, Reciprocal);
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 13, double, Reciprocal);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, float, Sqrt);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, double, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 13, float, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 13, double, Sqrt);
+// Kernels that compute each output element from the input elements at the same position, so the output may use the
+// buffer of an input of the same size. The allocation planner checks the sizes match before reusing an input.
+#define REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS, ...) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                       \
+      OP_TYPE,                                                                          \
+      VERSION,                                                                          \
+      TYPE,                                                                             \
+      KernelDefBuilder()                                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>())                     \
+          __VA_ARGS__,                                                                  \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_ELEMENTWISE_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS, ...) \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                                                         \
+      OP_TYPE,                                                                                                      \
+      VERSION_FROM, VERSION_TO,                                                                                     \
+      TYPE,                                                                                                         \
+      KernelDefBuilder()                                                                                            \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>())                                                 \
+          __VA_ARGS__,                                                                                              \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_UNARY_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS, .MayInplace(0, 0))
+
+#define REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
+  REG_ELEMENTWISE_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS, .MayInplace(0, 0))
+
+// either input may be in-place with the output as long as it is not broadcast.
+#define REG_BINARY_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS, .MayInplace(0, 0).MayInplace(1, 0))
+
+#define REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
+  REG_ELEMENTWISE_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS,  \
+                                                 .MayInplace(0, 0).MayInplace(1, 0))
+
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, double, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int32_t, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int64_t, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, float, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, double, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int32_t, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int64_t, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, float, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, double, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, int32_t, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, int64_t, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, MLFloat16, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, MLFloat16, Add);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, BFloat16, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, MLFloat16, Add);
+REG_BINARY_INPLACE_TYPED_KERNEL(Add, 14, BFloat16, Add);
+
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, float, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, double, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int32_t, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int64_t, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, float, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, double, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int32_t, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int64_t, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, float, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, double, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, int32_t, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, int64_t, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, MLFloat16, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, MLFloat16, Sub);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, BFloat16, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, MLFloat16, Sub);
+REG_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, BFloat16, Sub);
+
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, float, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, double, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int32_t, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int64_t, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, float, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, double, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int32_t, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int64_t, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, float, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, double, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, int32_t, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, int64_t, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, MLFloat16, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, MLFloat16, Mul);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, BFloat16, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, MLFloat16, Mul);
+REG_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, BFloat16, Mul);
+
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, float, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, double, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int32_t, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int64_t, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, float, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, double, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int32_t, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int64_t, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, float, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, double, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, int32_t, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, int64_t, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, MLFloat16, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, MLFloat16, Div);
+REG_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, BFloat16, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, MLFloat16, Div);
+REG_BINARY_INPLACE_TYPED_KERNEL(Div, 14, BFloat16, Div);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, float, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, double, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int8_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int16_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int32_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int64_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint8_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint16_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint32_t, Abs);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint64_t, Abs);
+
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, float, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, double, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int8_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int16_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int32_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int64_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint8_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint16_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint32_t, Abs);
+REG_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint64_t, Abs);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, float, Neg);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, double, Neg);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int8_t, Neg);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int32_t, Neg);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int64_t, Neg);
+REG_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, float, Neg);
+REG_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, double, Neg);
+REG_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int8_t, Neg);
+REG_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int32_t, Neg);
+REG_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int64_t, Neg);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, float, Floor);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, double, Floor);
+REG_UNARY_INPLACE_TYPED_KERNEL(Floor, 13, float, Floor);
+REG_UNARY_INPLACE_TYPED_KERNEL(Floor, 13, double, Floor);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, float, Ceil);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, double, Ceil);
+REG_UNARY_INPLACE_TYPED_KERNEL(Ceil, 13, float, Ceil);
+REG_UNARY_INPLACE_TYPED_KERNEL(Ceil, 13, double, Ceil);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, float, Reciprocal);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, double, Reciprocal);
+REG_UNARY_INPLACE_TYPED_KERNEL(Reciprocal, 13, float, Reciprocal);
+REG_UNARY_INPLACE_TYPED_KERNEL(Reciprocal, 13, double, Reciprocal);
+
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, float, Sqrt);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, double, Sqrt);
+REG_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 13, float, Sqrt);
+REG_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 13, double, Sqrt);
 
 REG_ELEMENTWISE_VERSIONED_KERNEL_NONT(Pow, 7, 11, Pow,
                                       BuildKernelDefConstraintsFromTypeList<EnabledPow7Types>());
@@ -273,15 +329,15 @@ REG_ELEMENTWISE_KERNEL_NONT_2(Pow, 15, Pow,
                               BuildKernelDefConstraintsFromTypeList<EnabledPow12BaseTypes>(),
                               BuildKernelDefConstraintsFromTypeList<EnabledPow12ExpTypes>());
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, float, Exp);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, double, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 13, float, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 13, double, Exp);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, float, Exp);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, double, Exp);
+REG_UNARY_INPLACE_TYPED_KERNEL(Exp, 13, float, Exp);
+REG_UNARY_INPLACE_TYPED_KERNEL(Exp, 13, double, Exp);
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Log, 6, 12, float, Log);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Log, 6, 12, double, Log);
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 13, float, Log);
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 13, double, Log);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Log, 6, 12, float, Log);
+REG_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Log, 6, 12, double, Log);
+REG_UNARY_INPLACE_TYPED_KERNEL(Log, 13, float, Log);
+REG_UNARY_INPLACE_TYPED_KERNEL(Log, 13, double, Log);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, float, Sum_6);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, double, Sum_6);
@@ -533,6 +589,99 @@ Status Div<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+namespace {
+
+// ORT float16 types don't support Eigen arithmetic, so map them to the Eigen ones. Their packet conversions to and
+// from float are vectorized, with F16C on x86.
+template <typename T>
+struct EigenHalfType;
+
+template <>
+struct EigenHalfType<MLFloat16> {
+  using type = Eigen::half;
+};
+
+template <>
+struct EigenHalfType<BFloat16> {
+  using type = Eigen::bfloat16;
+};
+
+// The 16-bit float inputs are widened to float and the result is rounded once, which is the correctly rounded result
+// of Add/Sub/Mul/Div. The widening, the operation and the narrowing are fused in one Eigen expression per span.
+template <typename T, typename Op>
+void HalfBinaryBroadcast(OpKernelContext& context) {
+  using HalfT = typename EigenHalfType<T>::type;
+  ProcessBroadcastSpanFuncs funcs{
+      [](BroadcastHelper& per_iter_bh) {
+        const float input0 = per_iter_bh.ScalarInput0<T>().ToFloat();
+        const auto input1 = per_iter_bh.SpanInput1<T>();
+        auto output = per_iter_bh.OutputSpan<T>();
+        ConstEigenVectorMap<HalfT> input1_map(reinterpret_cast<const HalfT*>(input1.data()), input1.size());
+        EigenVectorMap<HalfT> output_map(reinterpret_cast<HalfT*>(output.data()), output.size());
+        output_map = Op{}(input0, input1_map.template cast<float>().array()).template cast<HalfT>();
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        const auto input0 = per_iter_bh.SpanInput0<T>();
+        const float input1 = per_iter_bh.ScalarInput1<T>().ToFloat();
+        auto output = per_iter_bh.OutputSpan<T>();
+        ConstEigenVectorMap<HalfT> input0_map(reinterpret_cast<const HalfT*>(input0.data()), input0.size());
+        EigenVectorMap<HalfT> output_map(reinterpret_cast<HalfT*>(output.data()), output.size());
+        output_map = Op{}(input0_map.template cast<float>().array(), input1).template cast<HalfT>();
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        const auto input0 = per_iter_bh.SpanInput0<T>();
+        const auto input1 = per_iter_bh.SpanInput1<T>();
+        auto output = per_iter_bh.OutputSpan<T>();
+        ConstEigenVectorMap<HalfT> input0_map(reinterpret_cast<const HalfT*>(input0.data()), input0.size());
+        ConstEigenVectorMap<HalfT> input1_map(reinterpret_cast<const HalfT*>(input1.data()), input1.size());
+        EigenVectorMap<HalfT> output_map(reinterpret_cast<HalfT*>(output.data()), output.size());
+        output_map = Op{}(input0_map.template cast<float>().array(), input1_map.template cast<float>().array())
+                         .template cast<HalfT>();
+      }};
+
+  UntypedBroadcastTwo(context, funcs, 1.0);
+}
+
+struct HalfAdd {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a + b; }
+};
+
+struct HalfSub {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a - b; }
+};
+
+struct HalfMul {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a * b; }
+};
+
+struct HalfDiv {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a / b; }
+};
+
+}  // namespace
+
+#define HALF_BINARY_COMPUTE(OP_TYPE, TYPE)                             \
+  template <>                                                          \
+  Status OP_TYPE<TYPE>::Compute(OpKernelContext* context) const {      \
+    HalfBinaryBroadcast<TYPE, Half##OP_TYPE>(*context);                \
+    return Status::OK();                                               \
+  }
+
+HALF_BINARY_COMPUTE(Add, MLFloat16)
+HALF_BINARY_COMPUTE(Add, BFloat16)
+HALF_BINARY_COMPUTE(Sub, MLFloat16)
+HALF_BINARY_COMPUTE(Sub, BFloat16)
+HALF_BINARY_COMPUTE(Mul, MLFloat16)
+HALF_BINARY_COMPUTE(Mul, BFloat16)
+HALF_BINARY_COMPUTE(Div, MLFloat16)
+HALF_BINARY_COMPUTE(Div, BFloat16)
+
+#undef HALF_BINARY_COMPUTE
+
 namespace pow_internal {
 
 template <typename T, typename E>
@@ -748,7 +897,7 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
 
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_1 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput1<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_1_vec_map(input_1, num_elements);
@@ -763,7 +912,7 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
         }
       },
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
@@ -778,7 +927,7 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
         }
       },
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
@@ -857,12 +1006,7 @@ struct Max_8::ComputeImpl {
         }};
 
     int input_count = inst.Node().InputArgCount().front();
-    // TODO: Parallelize across spans in UntypedBroadcastVariadic to avoid specific logic here
-    if (input_count == 2) {
-      UntypedBroadcastTwo(*context, funcs, 1.0);
-    } else {
-      UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
-    }
+    UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
 
     return Status::OK();
   }
@@ -1945,17 +2089,11 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
   BroadcastLooper(broadcast_helper, funcs);
 }
 
-// Variant of UntypedBroadcastTwo that will parallelize.
-// Operator usage is the same as the parallelization is opaque to the operator.
-// unit_cost must be a valid cost value.
-void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
-                         void* user_data) {
-  const Tensor& input0_tensor = *context.Input<Tensor>(0);
-  const Tensor& input1_tensor = *context.Input<Tensor>(1);
-  InputBroadcaster input_broadcaster(input0_tensor, input1_tensor);
-
-  Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
-
+// Broadcast the inputs of input_broadcaster into output_tensor, parallelizing within the span if there is only one,
+// or across spans otherwise.
+static void ParallelizeBroadcast(InputBroadcaster& input_broadcaster, Tensor& output_tensor,
+                                 const ProcessBroadcastSpanFuncs& funcs, concurrency::ThreadPool* tp,
+                                 double unit_cost, void* user_data) {
   size_t span_size = input_broadcaster.GetSpanSize();
   size_t output_size = static_cast<ptrdiff_t>(output_tensor.Shape().Size());
 
@@ -1964,8 +2102,6 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
     return;
   }
 
-  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
-
   if (span_size == output_size) {  // Input data will be processed in a single span, so parallelize within the span
     OutputBroadcaster output_broadcaster(span_size, output_tensor);
     BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data, tp, unit_cost);
@@ -1997,6 +2133,21 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
   }
 }
 
+// Variant of UntypedBroadcastTwo that will parallelize.
+// Operator usage is the same as the parallelization is opaque to the operator.
+// unit_cost must be a valid cost value.
+void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
+                         void* user_data) {
+  const Tensor& input0_tensor = *context.Input<Tensor>(0);
+  const Tensor& input1_tensor = *context.Input<Tensor>(1);
+  InputBroadcaster input_broadcaster(input0_tensor, input1_tensor);
+
+  Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
+
+  ParallelizeBroadcast(input_broadcaster, output_tensor, funcs, context.GetOperatorThreadPool(), unit_cost,
+                       user_data);
+}
+
 // allocate_tensor should allocate a tensor of the output type with the given shape
 static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
                                      AllocateTensorFunc allocate_tensor,
@@ -2031,10 +2182,7 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
       p_output = temp_output.get();
     }
 
-    OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *p_output);
-    BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster);
-
-    BroadcastLooper(broadcast_helper, funcs);
+    ParallelizeBroadcast(input_broadcaster, *p_output, funcs, context.GetOperatorThreadPool(), 1.0, nullptr);
 
     temp_input = std::move(temp_output);
   }
@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/narrow.h"
@@ -1023,6 +1027,134 @@ void BroadcastLooper(TBroadcastHelper& helper, const ProcessBroadcastSpanFuncs&
   }
 }
 
+// Broadcasts N inputs to their common output shape for kernels that read all of them in one pass.
+// Axes of size 1 are dropped and adjacent axes are merged when every input is either broadcast along both of them or
+// along neither, so the output is walked as spans of the innermost merged axis. Along a span every input has a
+// stride of 0 or 1, and moving to the next span only updates one offset per input instead of doing index math
+// for every element.
+template <size_t N>
+class MultiBroadcaster {
+ public:
+  using Offsets = std::array<size_t, N>;
+
+  explicit MultiBroadcaster(const std::array<gsl::span<const int64_t>, N>& shapes) {
+    size_t rank = 0;
+    for (const auto& shape : shapes) {
+      rank = std::max(rank, shape.size());
+    }
+    output_shape_.resize(rank);
+
+    // element count of every input over the merged axes processed so far
+    Offsets sizes;
+    sizes.fill(1);
+    uint32_t previous_pattern = 0;
+    for (size_t axis = 0; axis < rank; ++axis) {  // from the innermost axis
+      int64_t largest = 1;
+      int64_t smallest = std::numeric_limits<int64_t>::max();
+      for (const auto& shape : shapes) {
+        int64_t dim = axis < shape.size() ? shape[shape.size() - 1 - axis] : 1;
+        largest = std::max(largest, dim);
+        smallest = std::min(smallest, dim);
+      }
+      int64_t output_dim = largest;
+      if (smallest == 0) {
+        ORT_ENFORCE(largest <= 1, "Can broadcast 0 by 0 or 1. ", largest, " is invalid.");
+        output_dim = 0;
+      }
+      output_shape_[rank - 1 - axis] = output_dim;
+      if (output_dim == 1) {
+        continue;
+      }
+
+      // bit i is set if input i is not broadcast along this axis
+      uint32_t pattern = 0;
+      for (size_t i = 0; i < N; ++i) {
+        int64_t dim = axis < shapes[i].size() ? shapes[i][shapes[i].size() - 1 - axis] : 1;
+        ORT_ENFORCE(dim == 1 || dim == output_dim, "Attempting to broadcast an axis by a dimension other than 1. ",
+                    dim, " by ", output_dim);
+        if (dim == output_dim) {
+          pattern |= 1u << i;
+        }
+      }
+
+      if (!dims_.empty() && pattern == previous_pattern) {
+        dims_.back() *= static_cast<size_t>(output_dim);
+      } else {
+        Offsets strides;
+        for (size_t i = 0; i < N; ++i) {
+          strides[i] = (pattern >> i) & 1 ? sizes[i] : 0;
+        }
+        dims_.push_back(static_cast<size_t>(output_dim));
+        strides_.push_back(strides);
+        previous_pattern = pattern;
+      }
+      for (size_t i = 0; i < N; ++i) {
+        if ((pattern >> i) & 1) {
+          sizes[i] *= static_cast<size_t>(output_dim);
+        }
+      }
+    }
+
+    if (dims_.empty()) {  // all the inputs are scalars
+      dims_.push_back(1);
+      strides_.push_back(Offsets{});
+    }
+  }
+
+  const TensorShapeVector& GetOutputShape() const { return output_shape_; }
+
+  size_t GetSpanSize() const { return dims_.front(); }
+
+  size_t NumSpans() const {
+    size_t count = 1;
+    for (size_t d = 1; d < dims_.size(); ++d) {
+      count *= dims_[d];
+    }
+    return count;
+  }
+
+  // 0 if input `i` is broadcast along a span, 1 otherwise.
+  size_t SpanStride(size_t i) const { return strides_.front()[i]; }
+
+  // Calls fn(input_offsets, output_offset) with the element offsets of the start of the spans [first, last).
+  template <typename TFunc>
+  void ForEachSpan(size_t first, size_t last, TFunc&& fn) const {
+    InlinedVector<size_t, kTensorShapeSmallBufferElementsSize> counters(dims_.size(), 0);
+    Offsets offsets{};
+    size_t remainder = first;
+    for (size_t d = 1; d < dims_.size(); ++d) {
+      counters[d] = remainder % dims_[d];
+      remainder /= dims_[d];
+      for (size_t i = 0; i < N; ++i) {
+        offsets[i] += counters[d] * strides_[d][i];
+      }
+    }
+
+    const size_t span_size = dims_.front();
+    for (size_t span = first; span < last; ++span) {
+      fn(static_cast<const Offsets&>(offsets), span * span_size);
+      for (size_t d = 1; d < dims_.size(); ++d) {
+        for (size_t i = 0; i < N; ++i) {
+          offsets[i] += strides_[d][i];
+        }
+        if (++counters[d] < dims_[d]) {
+          break;
+        }
+        for (size_t i = 0; i < N; ++i) {
+          offsets[i] -= counters[d] * strides_[d][i];
+        }
+        counters[d] = 0;
+      }
+    }
+  }
+
+ private:
+  TensorShapeVector output_shape_;
+  // merged axes from the innermost and the stride of every input along them
+  InlinedVector<size_t, kTensorShapeSmallBufferElementsSize> dims_;
+  InlinedVector<Offsets, kTensorShapeSmallBufferElementsSize> strides_;
+};
+
 struct TensorAllocator {
   TensorAllocator(OpKernelContext& context) {
     auto status = context.GetTempSpaceAllocator(&allocator_);
@@ -138,6 +138,66 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+bool GemmPackBSparseFp32(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         IAllocatorUniquePtr<void>& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+
+  packed_b_size = MlasSparseGemmPackBSize(trans_b ? CblasTrans : CblasNoTrans, N, K, tensor_b.Data<float>(),
+                                          trans_b ? K : N);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = packed_b.get();
+
+  // Zero the alignment padding for the same reason as GemmPackBFp32.
+  memset(packed_b_data, 0, packed_b_size);
+
+  MlasSparseGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                      N,
+                      K,
+                      tensor_b.Data<float>(),
+                      trans_b ? K : N,
+                      packed_b_data);
+  return true;
+}
+
+bool GemmRestorePackedBFp32(const Tensor& tensor_b,
+                            bool trans_b,
+                            size_t packed_b_size,
+                            TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+  if (packed_b_size == 0 || packed_b_size != MlasGemmPackBSize(N, K)) {
+    return false;
+  }
+
+  // A block sparse tensor_b was packed by GemmPackBSparseFp32, so let PrePack() pack it again.
+  if (MlasSparseGemmPackBSize(trans_b ? CblasTrans : CblasNoTrans, N, K, tensor_b.Data<float>(),
+                              trans_b ? K : N) != 0) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+  return true;
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -189,7 +249,7 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 #if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
 #pragma GCC diagnostic pop
 #endif
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
   bool support_mlas = false;
   if (c_shape == nullptr) {
     support_mlas = true;
@@ -198,7 +258,8 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
   } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
     support_mlas = true;
   }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
+  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0 &&
+      MlasHalfGemmAccelerationSupported()) {
     MLAS_HALF_GEMM_DATA_PARAMS data;
     data.A = a_data;
     data.lda = K;
@@ -253,7 +314,10 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    sparse_b_ = trans_A_ == CblasNoTrans &&
+                GemmPackBSparseFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    is_packed = sparse_b_ ||
+                GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -284,6 +348,30 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::RestorePrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                        std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                        gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                        /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                            std::vector<BufferUniquePtr>& prepacked_buffers,
+                                            gsl::span<const size_t> prepacked_buffer_sizes,
+                                            /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+
+  if (input_idx == 1 && prepacked_buffers.size() == 1 &&
+      GemmRestorePackedBFp32(tensor, trans_B_ != CblasNoTrans, prepacked_buffer_sizes[0], b_shape_)) {
+    used_prepacked_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -411,6 +499,17 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   if (B) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
+  } else if (sparse_b_) {
+    GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(K);
+    data.B = static_cast<const float*>(packed_b_.get());
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = c_data != nullptr ? beta_ : 0.0f;
+    MlasSparseGemmBatch(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), &data, 1, thread_pool);
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
     MlasGemm(
@@ -28,6 +28,11 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                 gsl::span<const size_t> prepacked_buffer_sizes,
+                                 /*out*/ bool& used_prepacked_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -40,6 +45,8 @@ class Gemm : protected GemmBase, public OpKernel {
  protected:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // packed_b_ holds the nonzero blocks of a block sparse B for MlasSparseGemmBatch
+  bool sparse_b_ = false;
 
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
@@ -14,4 +14,20 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Packs the nonzero blocks of a block sparse 2D tensor_b for MlasSparseGemmBatch.
+// Returns false if tensor_b doesn't have enough zero blocks for the sparse path to be faster.
+bool GemmPackBSparseFp32(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         IAllocatorUniquePtr<void>& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape);
+
+// Validates a buffer packed by GemmPackBFp32 for tensor_b in an earlier session and restores b_shape.
+// Returns false if the buffer doesn't match the packed size for tensor_b.
+bool GemmRestorePackedBFp32(const Tensor& tensor_b,
+                            bool trans_b,
+                            size_t packed_b_size,
+                            TensorShape& b_shape);
+
 };  // namespace onnxruntime
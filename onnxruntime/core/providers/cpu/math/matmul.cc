@@ -132,7 +132,7 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -171,6 +171,18 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+// Returns the MLAS kernel specialized to the shape of the constant B, or nullptr if B should be packed.
+static const MLAS_SGEMM_SPECIALIZED_KERNEL* GetSpecializedKernel(const Tensor& tensor, bool trans_b) {
+  const auto& b_shape = tensor.Shape();
+  if (b_shape.NumDimensions() != 2) {
+    return nullptr;
+  }
+
+  const size_t K = static_cast<size_t>(trans_b ? b_shape[1] : b_shape[0]);
+  const size_t N = static_cast<size_t>(trans_b ? b_shape[0] : b_shape[1]);
+  return MlasSgemmGetSpecializedKernel(trans_b ? CblasTrans : CblasNoTrans, N, K);
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -179,7 +191,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -194,7 +206,13 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
     } else
 #endif
     {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      specialized_kernel_ = use_specialized_kernel_ ? GetSpecializedKernel(tensor, trans_b_attr_ != 0) : nullptr;
+      if (specialized_kernel_ == nullptr) {
+        sparse_b_ = trans_a_attr_ == 0 &&
+                    GemmPackBSparseFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+        is_packed = sparse_b_ ||
+                    GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -219,6 +237,32 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                              std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              gsl::span<const size_t> prepacked_buffer_sizes,
+                                              /*out*/ bool& used_prepacked_buffers) {
+  used_prepacked_buffers = false;
+
+  if (input_idx != 1 || prepacked_buffers.size() != 1) {
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // the bfloat16 packed layout is not validated, so let PrePack() pack it again.
+  if (use_fastmath_mode_ && (trans_b_attr_ == 0) && tensor.Shape().NumDimensions() == 2 &&
+      static_cast<size_t>(tensor.Shape().Size()) >= kFastMathModeKernelsizeThreshold) {
+    return Status::OK();
+  }
+#endif
+
+  if (GemmRestorePackedBFp32(tensor, trans_b_attr_ != 0, prepacked_buffer_sizes[0], b_shape_)) {
+    used_prepacked_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -248,7 +292,7 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
@@ -279,8 +323,14 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    if (specialized_kernel_ != nullptr && !trans_a && b_shape.NumDimensions() == 2) {
+      MlasSgemmSpecializedBatch(specialized_kernel_, M, data.data(), max_len, thread_pool);
+    } else if (sparse_b_) {
+      MlasSparseGemmBatch(M, N, K, data.data(), max_len, thread_pool);
+    } else {
+      MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
+                    M, N, K, data.data(), max_len, thread_pool);
+    }
   }
   return Status::OK();
 }
@@ -29,9 +29,15 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    use_specialized_kernel_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasShapeSpecializedGemm, "0") == "1";
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
+#if defined(__aarch64__)
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
+#else
+    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathX64Bfloat16);
+#endif
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
 #endif
   }
@@ -43,12 +49,24 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                 gsl::span<const size_t> prepacked_buffer_sizes,
+                                 /*out*/ bool& used_prepacked_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // kernel specialized to the shape of a small constant B, which is then not packed
+  bool use_specialized_kernel_;
+  const MLAS_SGEMM_SPECIALIZED_KERNEL* specialized_kernel_ = nullptr;
+
+  // packed_b_ holds the nonzero blocks of a block sparse B for MlasSparseGemmBatch
+  bool sparse_b_ = false;
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -56,7 +74,7 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
   // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
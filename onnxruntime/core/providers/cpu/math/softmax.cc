@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/math/softmax.h"
 #include "core/providers/cpu/tensor/transpose.h"
+#include "core/mlas/inc/mlas.h"
 #include <vector>
 #include <numeric>
 
@@ -58,6 +59,14 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+// The float16 kernels compute in float.
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Softmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     LogSoftmax,
     1,
@@ -108,6 +117,27 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    LogSoftmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+namespace {
+
+// opset-13 softmax of float data. An axis that is not the innermost one is reduced in place with the strided MLAS
+// kernel instead of being transposed.
+void SoftmaxFloatOpset13(const float* input, float* output, const TensorShape& shape, size_t axis, bool log_softmax,
+                         concurrency::ThreadPool* thread_pool) {
+  const size_t N = onnxruntime::narrow<size_t>(shape.SizeToDimension(axis));
+  const size_t D = onnxruntime::narrow<size_t>(shape[axis]);
+  const size_t stride = onnxruntime::narrow<size_t>(shape.SizeFromDimension(axis + 1));
+  MlasComputeSoftmaxStrided(input, output, N, D, stride, log_softmax, thread_pool);
+}
+
+}  // namespace
+
 // opset-12 and below
 template <typename T>
 Status Softmax<T>::ComputeImpl(const Tensor& input, Tensor& output, size_t axis,
@@ -187,6 +217,14 @@ Status Softmax<T>::ComputeImplOpset13(const Tensor& input, Tensor& output, size_
   return Status::OK();
 }
 
+template <>
+Status Softmax<float>::ComputeImplOpset13(const Tensor& input, Tensor& output, size_t axis,
+                                          concurrency::ThreadPool* thread_pool, OpKernelContext* /*ctx*/) const {
+  SoftmaxFloatOpset13(input.Data<float>(), output.MutableData<float>(), input.Shape(), axis, log_softmax_,
+                      thread_pool);
+  return Status::OK();
+}
+
 // compute method of Softmax
 template <typename T>
 Status Softmax<T>::Compute(OpKernelContext* ctx) const {
@@ -210,4 +248,33 @@ Status Softmax<T>::Compute(OpKernelContext* ctx) const {
   }
 }
 
+template <>
+Status Softmax<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  const auto* X = ctx->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  size_t rank = X_shape.NumDimensions();
+  auto* Y = ctx->Output(0, X_shape);
+
+  if (X_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t axis = static_cast<size_t>(HandleNegativeAxis(axis_, rank));
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  const size_t size = onnxruntime::narrow<size_t>(X_shape.Size());
+  auto buffer = IAllocator::MakeUniquePtr<float>(alloc, size);
+
+  MlasConvertHalfToFloatBuffer(&X->Data<MLFloat16>()[0].val, buffer.get(), size);
+  SoftmaxFloatOpset13(buffer.get(), buffer.get(), X_shape, axis, log_softmax_, ctx->GetOperatorThreadPool());
+
+  MLFloat16* Y_data = Y->MutableData<MLFloat16>();
+  for (size_t i = 0; i < size; ++i) {
+    Y_data[i] = MLFloat16(buffer[i]);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -48,4 +48,12 @@ class Softmax final : public OpKernel {
   bool log_softmax_;
 };
 
+// float reduces a non innermost axis without transposing, float16 computes in float.
+template <>
+Status Softmax<float>::ComputeImplOpset13(const Tensor& input, Tensor& output, size_t axis,
+                                          concurrency::ThreadPool* thread_pool, OpKernelContext* ctx) const;
+
+template <>
+Status Softmax<MLFloat16>::Compute(OpKernelContext* ctx) const;
+
 }  // namespace onnxruntime
@@ -117,6 +117,48 @@ static void HeapifyIthPosition(int64_t* heap, size_t i, size_t k, const HeapCmp&
   }
 }
 
+// Smallest part of a row whose top k is selected by one thread when the rows are split.
+constexpr int64_t kTopKMinChunkSize = 16 * 1024;
+
+// Values of a contiguous axis are tested against the current worst of the top k in blocks of this size.
+constexpr int64_t kTopKThresholdBlockSize = 64;
+
+// Returns whether any of the kTopKThresholdBlockSize values beats `threshold`.
+// There is no early exit and the trip count is fixed so that the loop is vectorized.
+template <class Comparator>
+static bool AnyValueBeats(const Comparator& comparer, const typename Comparator::DataType* values,
+                          typename Comparator::DataType threshold) {
+  int beats = 0;
+  for (int64_t i = 0; i < kTopKThresholdBlockSize; ++i) {
+    beats |= static_cast<int>(comparer.CompareValueOnly(values[i], threshold));
+  }
+  return beats != 0;
+}
+
+// Inserts the values in [begin, end) of a contiguous axis into the heap of the top k values.
+// Once the heap holds good candidates most values of a long axis cannot enter it, so whole blocks are first
+// tested against the top of the heap and only the blocks holding a better value are inserted one by one.
+template <class Comparator>
+static void InsertContiguousIntoHeap(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                                     int64_t begin, int64_t end, int64_t* heap, const unsigned k) {
+  auto top = input_data[heap[0]];
+  int64_t cur_idx = begin;
+  while (cur_idx < end) {
+    const int64_t block_end = std::min(cur_idx + kTopKThresholdBlockSize, end);
+    if (block_end - cur_idx < kTopKThresholdBlockSize || AnyValueBeats(comparer, input_data + cur_idx, top)) {
+      for (; cur_idx < block_end; ++cur_idx) {
+        // if the current value is equal to the top of the heap it won't replace it as the index will be higher.
+        if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+          heap[0] = cur_idx;
+          HeapifyIthPosition(heap, 0, k, comparer);
+          top = input_data[heap[0]];
+        }
+      }
+    }
+    cur_idx = block_end;
+  }
+}
+
 // Static helpers that implement the core logic for each of the 'TopK' operator flavor
 
 // Selects the top k elements (largest or smallest based on template parameter)
@@ -179,6 +221,52 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   //            k = [ 1, 2, 4, 6, 8, 16, 24, 32, 48, 64, 128 ]
   bool use_priority_queue = k != 1 && (k < 4 || (std::log2(k) / std::log2(num_blocks)) < 0.725);
 
+  // Splitting on rows leaves most threads idle for a few long rows, e.g. the logits over the vocabulary of each beam
+  // in beam search. Each row is then split into chunks, the top k of the chunks are selected in parallel and merged.
+  if (use_priority_queue && block_slice == 1 && rows < tp_threads) {
+    const int64_t min_chunk_size = std::max(kTopKMinChunkSize, 4 * static_cast<int64_t>(k));
+    const int64_t chunks_per_row = std::min((tp_threads + rows - 1) / rows, num_blocks / min_chunk_size);
+    if (chunks_per_row > 1) {
+      std::vector<int64_t> candidates(SafeInt<size_t>(rows) * chunks_per_row * k);
+
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows * chunks_per_row),
+          [input_data, cols, num_blocks, chunks_per_row, k, &candidates](std::ptrdiff_t task) {
+            Comparator comparer(input_data);
+            const int64_t chunk = task % chunks_per_row;
+            const int64_t row_offset = (task / chunks_per_row) * cols;
+            // every chunk holds at least min_chunk_size values
+            const int64_t begin = row_offset + chunk * num_blocks / chunks_per_row;
+            const int64_t end = row_offset + (chunk + 1) * num_blocks / chunks_per_row;
+
+            int64_t* heap = candidates.data() + task * k;
+            for (unsigned l = 0; l < k; ++l) {
+              heap[k - l - 1] = begin + l;
+              HeapifyIthPosition(heap, k - l - 1, k, comparer);
+            }
+            InsertContiguousIntoHeap(comparer, input_data, begin + k, end, heap, k);
+          });
+
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows),
+          [input_data, cols, chunks_per_row, k, sorted, &candidates, &values_map, &indices_map](std::ptrdiff_t i) {
+            // the comparer orders by value and then index, so the top k of the chunks' top k are those of the row
+            Comparator comparer(input_data);
+            auto row_candidates = candidates.begin() + i * chunks_per_row * k;
+            std::nth_element(row_candidates, row_candidates + (k - 1), row_candidates + chunks_per_row * k, comparer);
+            if (sorted) {
+              std::sort(row_candidates, row_candidates + k, comparer);
+            }
+            for (unsigned l = 0; l < k; ++l) {
+              int64_t idx = row_candidates[l];
+              values_map(i, l) = input_data[idx];
+              indices_map(i, l) = idx - i * cols;
+            }
+          });
+      return;
+    }
+  }
+
   std::function<void(std::ptrdiff_t batch)> find_top_k;
 
   if (k == 1) {
@@ -242,18 +330,22 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
               }
 
               // insert remainder if the next value would replace the top of the heap (current worst top k value)
-              // save top so we only have one load in the CompareValueOnly call
-              auto top = input_data[indices[0]];
-              for (; l < num_blocks; ++l) {
-                // we can compare value only. if the current value is equal to the top of the heap it won't
-                // replace it as the index will be higher.
-                if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
-                  indices[0] = cur_idx;
-                  HeapifyIthPosition(indices, 0, k, comparer);
-                  top = input_data[indices[0]];
+              if (block_slice == 1) {
+                InsertContiguousIntoHeap(comparer, input_data, cur_idx, row_offset + num_blocks, indices, k);
+              } else {
+                // save top so we only have one load in the CompareValueOnly call
+                auto top = input_data[indices[0]];
+                for (; l < num_blocks; ++l) {
+                  // we can compare value only. if the current value is equal to the top of the heap it won't
+                  // replace it as the index will be higher.
+                  if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+                    indices[0] = cur_idx;
+                    HeapifyIthPosition(indices, 0, k, comparer);
+                    top = input_data[indices[0]];
+                  }
+
+                  cur_idx += block_slice;
                 }
-
-                cur_idx += block_slice;
               }
 
               if (sorted) {
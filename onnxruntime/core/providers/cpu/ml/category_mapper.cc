@@ -35,13 +35,10 @@ Status CategoryMapper::Compute(OpKernelContext* context) const {
     auto output = gsl::make_span(Y.MutableData<int64_t>(), onnxruntime::narrow<size_t>(shape.Size()));
     auto out = output.begin();
 
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
     std::for_each(input.begin(), input.end(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
+                  [&out, this](const std::string& value) {
+                    const int64_t* map_to = string_to_int_map_.Find(value);
+                    *out = map_to == nullptr ? default_int_ : *map_to;
                     ++out;
                   });
   } else {
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Read-only map from strings to values built once when the kernel is created.
+// The keys are stored back to back in one buffer and the slots of the open addressing table only hold
+// their hash, position and length, so a lookup hashes the string view in place and probes a flat array
+// without following any pointer until the hashes match.
+template <typename TValue>
+class FlatStringMap {
+ public:
+  FlatStringMap() = default;
+
+  // Builds the table, `keep_last` tells which value is kept when a key appears several times.
+  void Build(const std::vector<std::string>& keys, const std::vector<TValue>& values, bool keep_last) {
+    ORT_ENFORCE(keys.size() == values.size());
+    ORT_ENFORCE(keys.size() < static_cast<size_t>(kEmpty));
+
+    size_t capacity = 16;
+    while (capacity < 2 * keys.size()) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_.assign(capacity, Slot{0, 0, 0, kEmpty});
+    key_bytes_.clear();
+    values_.clear();
+    values_.reserve(keys.size());
+
+    size_t total_bytes = 0;
+    for (const auto& key : keys) {
+      total_bytes += key.size();
+    }
+    key_bytes_.reserve(total_bytes);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      std::string_view key(keys[i]);
+      uint64_t hash = Hash(key);
+      size_t position = static_cast<size_t>(hash) & mask_;
+      while (slots_[position].value != kEmpty && !Matches(slots_[position], hash, key)) {
+        position = (position + 1) & mask_;
+      }
+      Slot& slot = slots_[position];
+      if (slot.value != kEmpty) {
+        if (keep_last) {
+          values_[slot.value] = values[i];
+        }
+        continue;
+      }
+      ORT_ENFORCE(key_bytes_.size() + key.size() <= std::numeric_limits<uint32_t>::max(),
+                  "The keys of the map are too long.");
+      slot.hash = hash;
+      slot.offset = static_cast<uint32_t>(key_bytes_.size());
+      slot.length = static_cast<uint32_t>(key.size());
+      slot.value = static_cast<uint32_t>(values_.size());
+      key_bytes_.append(key.data(), key.size());
+      values_.push_back(values[i]);
+    }
+  }
+
+  // Returns the value of `key` or nullptr if the key is not in the map.
+  const TValue* Find(std::string_view key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+    uint64_t hash = Hash(key);
+    size_t position = static_cast<size_t>(hash) & mask_;
+    while (slots_[position].value != kEmpty) {
+      if (Matches(slots_[position], hash, key)) {
+        return &values_[slots_[position].value];
+      }
+      position = (position + 1) & mask_;
+    }
+    return nullptr;
+  }
+
+  size_t size() const { return values_.size(); }
+
+  // Hashes 8 bytes at a time (64-bit MurmurHash2).
+  static uint64_t Hash(std::string_view key) {
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+    const char* data = key.data();
+    size_t length = key.size();
+    uint64_t h = 0x9747b28c ^ (length * m);
+
+    for (; length >= 8; data += 8, length -= 8) {
+      uint64_t k;
+      std::memcpy(&k, data, sizeof(k));
+      k *= m;
+      k ^= k >> r;
+      k *= m;
+      h ^= k;
+      h *= m;
+    }
+    if (length > 0) {
+      uint64_t k = 0;
+      std::memcpy(&k, data, length);
+      h ^= k;
+      h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+  }
+
+ private:
+  static constexpr uint32_t kEmpty = 0xFFFFFFFF;
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t value;
+  };
+
+  bool Matches(const Slot& slot, uint64_t hash, std::string_view key) const {
+    return slot.hash == hash && slot.length == key.size() &&
+           std::memcmp(key_bytes_.data() + slot.offset, key.data(), key.size()) == 0;
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  std::string key_bytes_;
+  std::vector<TValue> values_;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
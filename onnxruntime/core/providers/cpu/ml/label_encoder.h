@@ -5,6 +5,7 @@
 #include <filesystem>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/flat_string_map.h"
 #include "core/providers/cpu/ml/ml_common.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/common/safeint.h"
@@ -24,21 +25,20 @@ class LabelEncoder final : public OpKernel {
 
     auto num_entries = string_classes.size();
 
-    string_to_int_map_.reserve(num_entries);
     int_to_string_map_.reserve(num_entries);
 
+    std::vector<int64_t> indices(num_entries);
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
+      indices[i] = static_cast<int64_t>(i);
+      int_to_string_map_[i] = string_classes[i];
     }
+    string_to_int_map_.Build(string_classes, indices, /*keep_last*/ true);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
+  FlatStringMap<int64_t> string_to_int_map_;
   std::unordered_map<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
@@ -63,8 +63,12 @@ class LabelEncoder_2 final : public OpKernel {
     ORT_ENFORCE(num_keys == num_values, "The ", key_field_name_, " and ", value_field_name_,
                 " attributes in LabelEncoder ", "(name: ", info.node().Name(), ") must have the same length. ",
                 "However, the number of key is ", num_keys, " and the number of ", "values is ", num_values, ".");
-    map_.reserve(num_keys);
-    for (size_t i = 0; i < num_keys; ++i) map_.emplace(keys[i], values[i]);
+    if constexpr (std::is_same_v<TKey, std::string>) {
+      map_.Build(keys, values, /*keep_last*/ false);
+    } else {
+      map_.reserve(num_keys);
+      for (size_t i = 0; i < num_keys; ++i) map_.emplace(keys[i], values[i]);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -77,8 +81,13 @@ class LabelEncoder_2 final : public OpKernel {
     auto input_iter = input.begin();
     auto output_iter = output.begin();
     while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
+      if constexpr (std::is_same_v<TKey, std::string>) {
+        const TValue* found = map_.Find(*input_iter);
+        *output_iter = found == nullptr ? default_value_ : *found;
+      } else {
+        const auto found = map_.find(*input_iter);
+        *output_iter = found == map_.end() ? default_value_ : found->second;
+      }
       ++output_iter;
       ++input_iter;
     }
@@ -94,7 +103,8 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If map_ doesn't contain "a_key", we use default_value_ as its output.
-  InlinedHashMap<TKey, TValue> map_;
+  // String keys are looked up in place in a flat table.
+  std::conditional_t<std::is_same_v<TKey, std::string>, FlatStringMap<TValue>, InlinedHashMap<TKey, TValue>> map_;
   TValue default_value_;
   // ONNX attribute name to load keys.
   std::string key_field_name_;
@@ -202,8 +212,12 @@ class LabelEncoder_4 final : public OpKernel {
     auto keys = GetAttribute<TKey>(kernel_info, key_field_name_, "keys_tensor");
     auto values = GetAttribute<TValue>(kernel_info, value_field_name_, "values_tensor");
     ORT_ENFORCE(keys.size() == values.size(), "Keys and values must have the same length.");
-    for (size_t i = 0; i < keys.size(); ++i) {
-      map_.emplace(keys[i], values[i]);
+    if constexpr (std::is_same_v<TKey, std::string>) {
+      map_.Build(keys, values, /*keep_last*/ false);
+    } else {
+      for (size_t i = 0; i < keys.size(); ++i) {
+        map_.emplace(keys[i], values[i]);
+      }
     }
   }
   Status Compute(OpKernelContext* context) const override {
@@ -216,8 +230,13 @@ class LabelEncoder_4 final : public OpKernel {
     auto input_iter = input.begin();
     auto output_iter = output.begin();
     while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
+      if constexpr (std::is_same_v<TKey, std::string>) {
+        const TValue* found = map_.Find(*input_iter);
+        *output_iter = found == nullptr ? default_value_ : *found;
+      } else {
+        const auto found = map_.find(*input_iter);
+        *output_iter = found == map_.end() ? default_value_ : found->second;
+      }
       ++output_iter;
       ++input_iter;
     }
@@ -226,7 +245,9 @@ class LabelEncoder_4 final : public OpKernel {
 
  private:
   void InitializeAttrFields(const OpKernelInfo& kernel_info);
-  HashMap<TKey, TValue, NaNHash<TKey>, NaNEqual<TKey>> map_;
+  std::conditional_t<std::is_same_v<TKey, std::string>, FlatStringMap<TValue>,
+                     HashMap<TKey, TValue, NaNHash<TKey>, NaNEqual<TKey>>>
+      map_;
   TValue default_value_;
   std::string key_field_name_;
   std::string value_field_name_;
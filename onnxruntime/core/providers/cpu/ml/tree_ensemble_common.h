@@ -6,12 +6,21 @@
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "tree_ensemble_compiled.h"
 #include "tree_ensemble_helper.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// Number of rows evaluated together on every tree with the structure of arrays layout.
+constexpr int64_t kTreeEnsembleBlockRows = 16;
+
 class TreeEnsembleCommonAttributes {
  public:
   int64_t get_target_or_class_count() const { return this->n_targets_or_classes_; }
@@ -48,6 +57,33 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // QuickScorer layout, used instead of walking the trees node by node when every tree has at most 64 leaves.
+  // Every tree keeps a bitvector of its leaves still reachable, ordered from the true-most leaf to the false-most one.
+  // For every feature, the nodes are sorted so that the nodes whose condition is false for a given value form a
+  // prefix. Each false node clears the leaves of its true subtree and the exit leaf is the lowest bit left.
+  bool use_quick_scorer_ = false;
+  NODE_MODE quick_scorer_mode_ = NODE_MODE::BRANCH_LEQ;
+  std::vector<size_t> qs_feature_offsets_;
+  std::vector<ThresholdType> qs_thresholds_;
+  std::vector<uint32_t> qs_tree_ids_;
+  std::vector<uint64_t> qs_masks_;
+  std::vector<size_t> qs_leaf_offsets_;
+  std::vector<TreeNodeElement<ThresholdType>*> qs_leaves_;
+
+  // Structure of arrays layout of nodes_, used to evaluate a block of rows at once on every tree. A leaf points to
+  // itself on both sides so that every row of the block walks the tree for the same number of steps without branches.
+  bool use_node_arrays_ = false;
+  std::vector<int32_t> na_feature_ids_;
+  std::vector<ThresholdType> na_thresholds_;
+  std::vector<uint32_t> na_truenode_ids_;
+  std::vector<uint32_t> na_falsenode_ids_;
+  std::vector<uint32_t> na_roots_;
+  std::vector<int32_t> na_tree_depths_;
+
+  // Straight-line code compiled from the trees, loaded from the directory given by the session options.
+  TreeEnsembleCompiledLibrary compiled_library_;
+  TreeEnsembleCompiledFunction<InputType> compiled_leaves_ = nullptr;
+
  public:
   TreeEnsembleCommon() {}
 
@@ -86,12 +122,31 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
+  void ProcessQuickScorerLeaves(const InputType* x_data, uint64_t* bitvectors,
+                                const TreeNodeElement<ThresholdType>** leaves) const;
+
+  void ProcessTreeNodeLeavesBlock(size_t tree, const InputType* x_data, int64_t stride, size_t n_rows,
+                                  uint32_t* leaves) const;
+
+  template <typename AGG>
+  void ComputeAggByBlocks(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                          int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const;
+
+  template <typename AGG>
+  void ComputeAggByRows(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                             int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const;
+
  private:
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
                   const std::vector<ThresholdType>& nodes_values_as_tensor, const std::vector<float>& node_values,
                   const std::vector<int64_t>& nodes_missing_value_tracks_true, std::vector<size_t>& updated_mapping,
                   int64_t tree_id, const InlinedVector<TreeNodeElementId>& node_tree_ids);
+  void InitQuickScorer();
+  void InitNodeArrays();
+
+ protected:
+  void InitCompiled(const OpKernelInfo& info);
 };
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -105,7 +160,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "target_weights_as_tensor", target_weights_as_tensor));
 #endif
 
-  return Init(
+  ORT_RETURN_IF_ERROR(Init(
       80,
       128,
       50,
@@ -129,7 +184,9 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
       info.GetAttrsOrDefault<int64_t>("target_nodeids"),
       info.GetAttrsOrDefault<int64_t>("target_treeids"),
       info.GetAttrsOrDefault<float>("target_weights"),
-      target_weights_as_tensor);
+      target_weights_as_tensor));
+  InitCompiled(info);
+  return Status::OK();
 }
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -338,6 +395,8 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  InitQuickScorer();
+  InitNodeArrays();
   return Status::OK();
 }
 
@@ -396,6 +455,203 @@ size_t TreeEnsembleCommon<InputType, ThresholdType, OutputType>::AddNodes(
   return node_pos;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitQuickScorer() {
+  // Shallow trees are cheap to walk, the bitvectors only pay off once mispredicted branches dominate.
+  constexpr int64_t kQuickScorerMinDepth = 4;
+  constexpr size_t kQuickScorerMaxLeaves = 64;
+
+  use_quick_scorer_ = false;
+  qs_feature_offsets_.clear();
+  qs_thresholds_.clear();
+  qs_tree_ids_.clear();
+  qs_masks_.clear();
+  qs_leaf_offsets_.clear();
+  qs_leaves_.clear();
+
+  // The nodes of a feature can only be sorted by their threshold if they all use the same inequality.
+  if (!same_mode_ || has_missing_tracks_ || n_trees_ == 0 ||
+      n_trees_ >= static_cast<int64_t>(std::numeric_limits<uint32_t>::max())) {
+    return;
+  }
+  auto first_branch = std::find_if(nodes_.begin(), nodes_.end(),
+                                   [](const TreeNodeElement<ThresholdType>& node) { return node.is_not_leaf(); });
+  if (first_branch == nodes_.end()) {
+    return;
+  }
+  quick_scorer_mode_ = first_branch->mode();
+  if (quick_scorer_mode_ != NODE_MODE::BRANCH_LEQ && quick_scorer_mode_ != NODE_MODE::BRANCH_LT &&
+      quick_scorer_mode_ != NODE_MODE::BRANCH_GTE && quick_scorer_mode_ != NODE_MODE::BRANCH_GT) {
+    return;
+  }
+
+  struct QuickScorerNode {
+    int feature_id;
+    ThresholdType threshold;
+    uint32_t tree_id;
+    uint64_t mask;
+  };
+  std::vector<QuickScorerNode> branches;
+  std::vector<size_t> leaf_offsets;
+  std::vector<TreeNodeElement<ThresholdType>*> leaves;
+  std::vector<bool> visited(nodes_.size(), false);
+  leaf_offsets.reserve(onnxruntime::narrow<size_t>(n_trees_) + 1);
+  int64_t max_depth = 0;
+  uint32_t tree_id = 0;
+  size_t tree_begin = 0;
+
+  // Leaves are numbered depth first, true branch first. The recursion is bounded by the number of leaves.
+  auto visit = [&](auto& self, TreeNodeElement<ThresholdType>* node, int64_t depth) -> bool {
+    size_t position = static_cast<size_t>(node - nodes_.data());
+    if (visited[position]) {
+      // Shared subtrees cannot be described with one bit per leaf.
+      return false;
+    }
+    visited[position] = true;
+    if (!node->is_not_leaf()) {
+      if (leaves.size() - tree_begin >= kQuickScorerMaxLeaves) {
+        return false;
+      }
+      leaves.push_back(node);
+      max_depth = std::max(max_depth, depth);
+      return true;
+    }
+    if (node->feature_id < 0) {
+      return false;
+    }
+    size_t true_begin = leaves.size();
+    if (!self(self, node->truenode_or_weight.ptr, depth + 1)) {
+      return false;
+    }
+    size_t true_end = leaves.size();
+    // The false subtree holds at least one leaf, the true subtree never fills the 64 bits.
+    uint64_t true_leaves = ((uint64_t(1) << (true_end - true_begin)) - 1) << (true_begin - tree_begin);
+    branches.push_back({node->feature_id, node->value_or_unique_weight, tree_id, ~true_leaves});
+    return self(self, node + 1, depth + 1);
+  };
+
+  for (auto* root : roots_) {
+    tree_begin = leaves.size();
+    leaf_offsets.push_back(tree_begin);
+    if (!visit(visit, root, 0)) {
+      return;
+    }
+    ++tree_id;
+  }
+  if (max_depth < kQuickScorerMinDepth) {
+    return;
+  }
+
+  // For every feature, the nodes evaluated to false for a value come first.
+  bool ascending = quick_scorer_mode_ == NODE_MODE::BRANCH_LEQ || quick_scorer_mode_ == NODE_MODE::BRANCH_LT;
+  std::stable_sort(branches.begin(), branches.end(),
+                   [ascending](const QuickScorerNode& a, const QuickScorerNode& b) {
+                     if (a.feature_id != b.feature_id) return a.feature_id < b.feature_id;
+                     return ascending ? a.threshold < b.threshold : b.threshold < a.threshold;
+                   });
+
+  qs_feature_offsets_.resize(onnxruntime::narrow<size_t>(max_feature_id_) + 2, 0);
+  qs_thresholds_.reserve(branches.size());
+  qs_tree_ids_.reserve(branches.size());
+  qs_masks_.reserve(branches.size());
+  for (const auto& branch : branches) {
+    ++qs_feature_offsets_[static_cast<size_t>(branch.feature_id) + 1];
+    qs_thresholds_.push_back(branch.threshold);
+    qs_tree_ids_.push_back(branch.tree_id);
+    qs_masks_.push_back(branch.mask);
+  }
+  for (size_t f = 1; f < qs_feature_offsets_.size(); ++f) {
+    qs_feature_offsets_[f] += qs_feature_offsets_[f - 1];
+  }
+  qs_leaf_offsets_ = std::move(leaf_offsets);
+  qs_leaves_ = std::move(leaves);
+  use_quick_scorer_ = true;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitNodeArrays() {
+  // Every row of a block walks the deepest path of the tree, deep trees are better walked row by row.
+  constexpr int32_t kNodeArraysMaxDepth = 32;
+
+  use_node_arrays_ = false;
+  if (!same_mode_ || has_missing_tracks_ || n_trees_ == 0) {
+    return;
+  }
+
+  size_t n_nodes = nodes_.size();
+  std::vector<int32_t> feature_ids(n_nodes);
+  std::vector<ThresholdType> thresholds(n_nodes);
+  std::vector<uint32_t> truenode_ids(n_nodes);
+  std::vector<uint32_t> falsenode_ids(n_nodes);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    const auto& node = nodes_[i];
+    if (node.is_not_leaf()) {
+      feature_ids[i] = node.feature_id;
+      thresholds[i] = node.value_or_unique_weight;
+      truenode_ids[i] = static_cast<uint32_t>(node.truenode_or_weight.ptr - nodes_.data());
+      falsenode_ids[i] = static_cast<uint32_t>(i + 1);
+    } else {
+      feature_ids[i] = 0;
+      thresholds[i] = 0;
+      truenode_ids[i] = static_cast<uint32_t>(i);
+      falsenode_ids[i] = static_cast<uint32_t>(i);
+    }
+  }
+
+  // The depth of a node is the number of steps to its deepest leaf, the recursion stops beyond the maximum depth.
+  std::vector<int32_t> depths(n_nodes, -1);
+  auto depth_of = [&](auto& self, size_t i, int32_t level) -> int32_t {
+    if (level > kNodeArraysMaxDepth) {
+      return level;
+    }
+    if (depths[i] < 0) {
+      depths[i] = nodes_[i].is_not_leaf()
+                      ? 1 + std::max(self(self, truenode_ids[i], level + 1), self(self, falsenode_ids[i], level + 1))
+                      : 0;
+    }
+    return depths[i];
+  };
+
+  std::vector<uint32_t> roots;
+  std::vector<int32_t> tree_depths;
+  roots.reserve(roots_.size());
+  tree_depths.reserve(roots_.size());
+  for (auto* root : roots_) {
+    size_t position = static_cast<size_t>(root - nodes_.data());
+    int32_t depth = depth_of(depth_of, position, 0);
+    if (depth > kNodeArraysMaxDepth) {
+      return;
+    }
+    roots.push_back(static_cast<uint32_t>(position));
+    tree_depths.push_back(depth);
+  }
+
+  na_feature_ids_ = std::move(feature_ids);
+  na_thresholds_ = std::move(thresholds);
+  na_truenode_ids_ = std::move(truenode_ids);
+  na_falsenode_ids_ = std::move(falsenode_ids);
+  na_roots_ = std::move(roots);
+  na_tree_depths_ = std::move(tree_depths);
+  use_node_arrays_ = true;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitCompiled(const OpKernelInfo& info) {
+  std::string directory = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsTreeEnsembleCompiledDir, "");
+  if (directory.empty()) {
+    return;
+  }
+  std::string body = TreeEnsembleCodeGenerator<ThresholdType>(nodes_).Generate(roots_);
+  if (body.empty()) {
+    LOGS_DEFAULT(INFO) << "The tree ensemble has shared, too deep or non-finite nodes and is not compiled.";
+    return;
+  }
+  const char* input_type = TreeEnsembleCompiledInputType<InputType>();
+  std::string name = TreeEnsembleCompiledName(input_type, body);
+  compiled_leaves_ = reinterpret_cast<TreeEnsembleCompiledFunction<InputType>>(compiled_library_.Load(
+      directory, name, [&]() { return TreeEnsembleCompiledSource(name, input_type, body); }));
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKernelContext* ctx,
                                                                          const Tensor* X,
@@ -453,6 +709,14 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
 
   const InputType* x_data = X->Data<InputType>();
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
+  if (use_quick_scorer_ || compiled_leaves_ != nullptr) {
+    ComputeAggByRows(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
+  if (use_node_arrays_ && N >= 4 * kTreeEnsembleBlockRows) {
+    ComputeAggByBlocks(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
   if (n_targets_or_classes_ == 1) {
@@ -669,6 +933,119 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggByBlocks(
+    concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data, int64_t* label_data, int64_t N,
+    int64_t stride, const AGG& agg) const {
+  // Every tree is evaluated on a block of rows before moving to the next tree, the blocks are split across
+  // the threads.
+  int64_t n_blocks = (N + kTreeEnsembleBlockRows - 1) / kTreeEnsembleBlockRows;
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+  auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_blocks));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, x_data, z_data, label_data, N, n_blocks, stride](ptrdiff_t batch_num) {
+        uint32_t leaves[kTreeEnsembleBlockRows];
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads),
+                                                           onnxruntime::narrow<ptrdiff_t>(n_blocks));
+        if (n_targets_or_classes_ == 1) {
+          ScoreValue<ThresholdType> scores[kTreeEnsembleBlockRows];
+          for (auto b = work.start; b < work.end; ++b) {
+            int64_t begin = b * kTreeEnsembleBlockRows;
+            size_t n_rows = static_cast<size_t>(std::min(kTreeEnsembleBlockRows, N - begin));
+            std::fill(scores, scores + n_rows, ScoreValue<ThresholdType>({0, 0}));
+            for (size_t j = 0, limit = na_roots_.size(); j < limit; ++j) {
+              ProcessTreeNodeLeavesBlock(j, x_data + begin * stride, stride, n_rows, leaves);
+              for (size_t r = 0; r < n_rows; ++r) {
+                agg.ProcessTreeNodePrediction1(scores[r], nodes_[leaves[r]]);
+              }
+            }
+            for (size_t r = 0; r < n_rows; ++r) {
+              int64_t i = begin + static_cast<int64_t>(r);
+              agg.FinalizeScores1(z_data + i, scores[r], label_data == nullptr ? nullptr : (label_data + i));
+            }
+          }
+        } else {
+          std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(
+              kTreeEnsembleBlockRows,
+              InlinedVector<ScoreValue<ThresholdType>>(onnxruntime::narrow<size_t>(n_targets_or_classes_)));
+          for (auto b = work.start; b < work.end; ++b) {
+            int64_t begin = b * kTreeEnsembleBlockRows;
+            size_t n_rows = static_cast<size_t>(std::min(kTreeEnsembleBlockRows, N - begin));
+            for (size_t r = 0; r < n_rows; ++r) {
+              std::fill(scores[r].begin(), scores[r].end(), ScoreValue<ThresholdType>({0, 0}));
+            }
+            for (size_t j = 0, limit = na_roots_.size(); j < limit; ++j) {
+              ProcessTreeNodeLeavesBlock(j, x_data + begin * stride, stride, n_rows, leaves);
+              for (size_t r = 0; r < n_rows; ++r) {
+                agg.ProcessTreeNodePrediction(scores[r], nodes_[leaves[r]], weights_);
+              }
+            }
+            for (size_t r = 0; r < n_rows; ++r) {
+              int64_t i = begin + static_cast<int64_t>(r);
+              agg.FinalizeScores(scores[r], z_data + i * n_targets_or_classes_, -1,
+                                 label_data == nullptr ? nullptr : (label_data + i));
+            }
+          }
+        }
+      });
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggByRows(
+    concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data, int64_t* label_data, int64_t N,
+    int64_t stride, const AGG& agg) const {
+  // Every row goes through all the trees at once, with the compiled code or the QuickScorer bitvectors.
+  // The computation is parallelized by rows.
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+  auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+        size_t n_trees = onnxruntime::narrow<size_t>(n_trees_);
+        std::vector<uint64_t> bitvectors(compiled_leaves_ == nullptr ? n_trees : 0);
+        std::vector<uint32_t> leaf_ids(compiled_leaves_ == nullptr ? 0 : n_trees);
+        std::vector<const TreeNodeElement<ThresholdType>*> leaves(n_trees);
+        auto process_leaves = [this, &bitvectors, &leaf_ids, &leaves, n_trees](const InputType* x) {
+          if (compiled_leaves_ != nullptr) {
+            compiled_leaves_(x, leaf_ids.data());
+            for (size_t j = 0; j < n_trees; ++j) {
+              leaves[j] = &nodes_[leaf_ids[j]];
+            }
+          } else {
+            ProcessQuickScorerLeaves(x, bitvectors.data(), leaves.data());
+          }
+        };
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads),
+                                                           onnxruntime::narrow<ptrdiff_t>(N));
+        if (n_targets_or_classes_ == 1) {
+          for (auto i = work.start; i < work.end; ++i) {
+            ScoreValue<ThresholdType> score = {0, 0};
+            process_leaves(x_data + i * stride);
+            for (auto* leaf : leaves) {
+              agg.ProcessTreeNodePrediction1(score, *leaf);
+            }
+            agg.FinalizeScores1(z_data + i, score, label_data == nullptr ? nullptr : (label_data + i));
+          }
+        } else {
+          InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+          for (auto i = work.start; i < work.end; ++i) {
+            std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
+            process_leaves(x_data + i * stride);
+            for (auto* leaf : leaves) {
+              agg.ProcessTreeNodePrediction(scores, *leaf, weights_);
+            }
+            agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
+                               label_data == nullptr ? nullptr : (label_data + i));
+          }
+        }
+      });
+}
+
 #define TREE_FIND_VALUE(CMP)                                                                           \
   if (has_missing_tracks_) {                                                                           \
     while (root->is_not_leaf()) {                                                                      \
@@ -767,6 +1144,99 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+// The rows of the block are independent, the compiler turns the comparison into a select and may
+// vectorize the loop over the rows with gathers.
+#define TREE_BLOCK_FIND_VALUE(CMP)                                                                   \
+  for (int32_t d = 0; d < depth; ++d) {                                                              \
+    for (size_t r = 0; r < n_rows; ++r) {                                                            \
+      uint32_t node = leaves[r];                                                                     \
+      leaves[r] = x_data[static_cast<int64_t>(r) * stride + na_feature_ids_[node]] CMP na_thresholds_[node] \
+                      ? na_truenode_ids_[node]                                                       \
+                      : na_falsenode_ids_[node];                                                     \
+    }                                                                                                \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeavesBlock(
+    size_t tree, const InputType* x_data, int64_t stride, size_t n_rows, uint32_t* leaves) const {
+  std::fill(leaves, leaves + n_rows, na_roots_[tree]);
+  int32_t depth = na_tree_depths_[tree];
+  switch (nodes_[na_roots_[tree]].mode()) {
+    case NODE_MODE::BRANCH_LEQ:
+      TREE_BLOCK_FIND_VALUE(<=)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      TREE_BLOCK_FIND_VALUE(<)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      TREE_BLOCK_FIND_VALUE(>=)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      TREE_BLOCK_FIND_VALUE(>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      TREE_BLOCK_FIND_VALUE(==)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      TREE_BLOCK_FIND_VALUE(!=)
+      break;
+    case NODE_MODE::LEAF:
+      break;
+  }
+}
+
+inline uint32_t _lowest_bit_(uint64_t x) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<uint32_t>(index);
+#elif defined(_MSC_VER)
+  uint32_t index = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++index;
+  }
+  return index;
+#else
+  return static_cast<uint32_t>(__builtin_ctzll(x));
+#endif
+}
+
+#define QUICK_SCORER_MASK(CMP)                                                                     \
+  for (size_t f = 0, n_features = qs_feature_offsets_.size() - 1; f < n_features; ++f) {           \
+    val = x_data[f];                                                                               \
+    for (size_t k = qs_feature_offsets_[f], end = qs_feature_offsets_[f + 1];                      \
+         k < end && !(val CMP qs_thresholds_[k]); ++k) {                                           \
+      bitvectors[qs_tree_ids_[k]] &= qs_masks_[k];                                                 \
+    }                                                                                              \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessQuickScorerLeaves(
+    const InputType* x_data, uint64_t* bitvectors, const TreeNodeElement<ThresholdType>** leaves) const {
+  InputType val;
+  std::fill(bitvectors, bitvectors + n_trees_, ~uint64_t(0));
+  switch (quick_scorer_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      QUICK_SCORER_MASK(<=)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      QUICK_SCORER_MASK(<)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      QUICK_SCORER_MASK(>=)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      QUICK_SCORER_MASK(>)
+      break;
+    default:
+      ORT_THROW("Unexpected node mode ", static_cast<int>(quick_scorer_mode_), " for the QuickScorer evaluation.");
+  }
+  for (size_t j = 0, limit = static_cast<size_t>(n_trees_); j < limit; ++j) {
+    leaves[j] = qs_leaves_[qs_leaf_offsets_[j] + _lowest_bit_(bitvectors[j])];
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -821,7 +1291,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "class_weights_as_tensor", class_weights_as_tensor));
 #endif
 
-  return Init(
+  ORT_RETURN_IF_ERROR(Init(
       80,
       128,
       50,
@@ -846,7 +1316,9 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
       info.GetAttrsOrDefault<float>("class_weights"),
       class_weights_as_tensor,
       info.GetAttrsOrDefault<std::string>("classlabels_strings"),
-      info.GetAttrsOrDefault<int64_t>("classlabels_int64s"));
+      info.GetAttrsOrDefault<int64_t>("classlabels_int64s")));
+  this->InitCompiled(info);
+  return Status::OK();
 }
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_compiled.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+#include "core/common/logging/logging.h"
+#include "core/common/path_string.h"
+#include "core/framework/murmurhash3.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+namespace {
+#if defined(_WIN32)
+constexpr const char* kLibraryPrefix = "";
+constexpr const char* kLibrarySuffix = ".dll";
+#elif defined(__APPLE__)
+constexpr const char* kLibraryPrefix = "lib";
+constexpr const char* kLibrarySuffix = ".dylib";
+#else
+constexpr const char* kLibraryPrefix = "lib";
+constexpr const char* kLibrarySuffix = ".so";
+#endif
+}  // namespace
+
+TreeEnsembleCompiledLibrary::~TreeEnsembleCompiledLibrary() {
+  if (handle_ != nullptr) {
+    auto status = Env::Default().UnloadDynamicLibrary(handle_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to unload the compiled tree ensemble: " << status.ErrorMessage();
+    }
+  }
+}
+
+void* TreeEnsembleCompiledLibrary::Load(const std::string& directory, const std::string& name,
+                                        const std::function<std::string()>& source) {
+  std::filesystem::path dir(ToPathString(directory));
+  std::filesystem::path library_path = dir / ToPathString(kLibraryPrefix + name + kLibrarySuffix);
+
+  std::error_code ec;
+  if (std::filesystem::exists(library_path, ec)) {
+    void* handle = nullptr;
+    void* symbol = nullptr;
+    auto status = Env::Default().LoadDynamicLibrary(library_path.native(), false, &handle);
+    if (status.IsOK()) {
+      status = Env::Default().GetSymbolFromLibrary(handle, name, &symbol);
+      if (!status.IsOK()) {
+        ORT_IGNORE_RETURN_VALUE(Env::Default().UnloadDynamicLibrary(handle));
+      }
+    }
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to load the compiled tree ensemble " << PathToUTF8String(library_path.native())
+                            << ", the trees are interpreted: " << status.ErrorMessage();
+      return nullptr;
+    }
+    handle_ = handle;
+    return symbol;
+  }
+
+  std::filesystem::path source_path = dir / ToPathString(name + ".c");
+  if (!std::filesystem::exists(source_path, ec)) {
+    // write to a temporary file first so that a concurrent session never sees a partial file.
+    std::filesystem::path tmp_path = dir / ToPathString(name + ".c.tmp");
+    {
+      std::ofstream out(tmp_path, std::ios::trunc);
+      if (!out.is_open()) {
+        LOGS_DEFAULT(WARNING) << "Failed to open " << PathToUTF8String(tmp_path.native())
+                              << " to save the tree ensemble source.";
+        return nullptr;
+      }
+      out << source();
+    }
+    std::filesystem::rename(tmp_path, source_path, ec);
+    if (ec) {
+      LOGS_DEFAULT(WARNING) << "Failed to save the tree ensemble source " << PathToUTF8String(source_path.native())
+                            << ": " << ec.message();
+      std::filesystem::remove(tmp_path, ec);
+      return nullptr;
+    }
+  }
+  LOGS_DEFAULT(INFO) << "The tree ensemble is interpreted until " << PathToUTF8String(source_path.native())
+                     << " is compiled into " << PathToUTF8String(library_path.native());
+  return nullptr;
+}
+
+std::string TreeEnsembleCompiledName(const char* input_type, const std::string& body) {
+  std::string key = std::string(input_type) + "\n" + body;
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(key.data(), static_cast<int>(key.size()), 0, hash);
+  std::ostringstream name;
+  name << "ort_tree_ensemble_" << std::hex << std::setfill('0');
+  for (uint32_t h : hash) {
+    name << std::setw(8) << h;
+  }
+  return name.str();
+}
+
+std::string TreeEnsembleCompiledSource(const std::string& name, const char* input_type, const std::string& body) {
+  std::ostringstream source;
+  source << "// Generated by onnxruntime from a TreeEnsemble model, build it as a shared library named\n"
+         << "// " << kLibraryPrefix << name << kLibrarySuffix << ", e.g. cc -O2 -shared -fPIC " << name << ".c -o "
+         << kLibraryPrefix << name << kLibrarySuffix << "\n"
+         << "#include <stdint.h>\n"
+         << "#if defined(_WIN32)\n"
+         << "__declspec(dllexport)\n"
+         << "#else\n"
+         << "__attribute__((visibility(\"default\")))\n"
+         << "#endif\n"
+         << "void " << name << "(const " << input_type << "* x, uint32_t* leaves) {\n"
+         << body
+         << "}\n";
+  return source.str();
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Signature of the compiled evaluation function, it stores for every tree the position of the leaf reached by one row
+// in `TreeEnsembleCommon::nodes_`.
+template <typename InputType>
+using TreeEnsembleCompiledFunction = void (*)(const InputType* x, uint32_t* leaves);
+
+// Owns the shared library holding the compiled evaluation function of one tree ensemble.
+class TreeEnsembleCompiledLibrary {
+ public:
+  TreeEnsembleCompiledLibrary() = default;
+  ~TreeEnsembleCompiledLibrary();
+
+  // Loads the function `name` from the shared library `name` in `directory`. If the library does not exist yet,
+  // the C source returned by `source` is written next to it so that it can be compiled for the next sessions,
+  // and nullptr is returned.
+  void* Load(const std::string& directory, const std::string& name, const std::function<std::string()>& source);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TreeEnsembleCompiledLibrary);
+
+  void* handle_ = nullptr;
+};
+
+// Returns the name of the compiled function, derived from the input type and the generated code so that a library
+// is never used with another model.
+std::string TreeEnsembleCompiledName(const char* input_type, const std::string& body);
+
+// Returns the C source of a shared library exporting the function `name` with the body `body`.
+std::string TreeEnsembleCompiledSource(const std::string& name, const char* input_type, const std::string& body);
+
+template <typename T>
+const char* TreeEnsembleCompiledInputType();
+template <>
+inline const char* TreeEnsembleCompiledInputType<float>() { return "float"; }
+template <>
+inline const char* TreeEnsembleCompiledInputType<double>() { return "double"; }
+template <>
+inline const char* TreeEnsembleCompiledInputType<int64_t>() { return "int64_t"; }
+template <>
+inline const char* TreeEnsembleCompiledInputType<int32_t>() { return "int32_t"; }
+
+template <typename ThresholdType>
+class TreeEnsembleCodeGenerator {
+ public:
+  // The generated code is nested too deeply for the compilers beyond this depth.
+  static constexpr int kMaxDepth = 200;
+
+  explicit TreeEnsembleCodeGenerator(const std::vector<TreeNodeElement<ThresholdType>>& nodes)
+      : nodes_(nodes), visited_(nodes.size(), false) {}
+
+  // Returns the body of the evaluation function, every tree becomes a nest of branches with the thresholds
+  // as immediates. Returns an empty string if the trees cannot be compiled.
+  std::string Generate(const std::vector<TreeNodeElement<ThresholdType>*>& roots) {
+    code_ << std::hexfloat;
+    for (size_t tree = 0; tree < roots.size(); ++tree) {
+      if (!Emit(roots[tree], tree, 1)) {
+        return std::string();
+      }
+    }
+    return code_.str();
+  }
+
+ private:
+  bool Emit(const TreeNodeElement<ThresholdType>* node, size_t tree, int depth) {
+    size_t position = static_cast<size_t>(node - nodes_.data());
+    // Shared subtrees would be duplicated.
+    if (depth > kMaxDepth || visited_[position]) {
+      return false;
+    }
+    visited_[position] = true;
+    std::string indent(static_cast<size_t>(depth) * 2, ' ');
+    if (!node->is_not_leaf()) {
+      code_ << indent << "leaves[" << tree << "] = " << position << "u;\n";
+      return true;
+    }
+    if (!std::isfinite(node->value_or_unique_weight)) {
+      return false;
+    }
+
+    const char* cmp;
+    switch (node->mode()) {
+      case NODE_MODE::BRANCH_LEQ:
+        cmp = " <= ";
+        break;
+      case NODE_MODE::BRANCH_LT:
+        cmp = " < ";
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        cmp = " >= ";
+        break;
+      case NODE_MODE::BRANCH_GT:
+        cmp = " > ";
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        cmp = " == ";
+        break;
+      case NODE_MODE::BRANCH_NEQ:
+        cmp = " != ";
+        break;
+      default:
+        return false;
+    }
+    code_ << indent << "if (x[" << node->feature_id << "]" << cmp << node->value_or_unique_weight
+          << (std::is_same<ThresholdType, float>::value ? "f" : "");
+    if (node->is_missing_track_true()) {
+      code_ << " || x[" << node->feature_id << "] != x[" << node->feature_id << "]";
+    }
+    code_ << ") {\n";
+    if (!Emit(node->truenode_or_weight.ptr, tree, depth + 1)) {
+      return false;
+    }
+    code_ << indent << "} else {\n";
+    if (!Emit(node + 1, tree, depth + 1)) {
+      return false;
+    }
+    code_ << indent << "}\n";
+    return true;
+  }
+
+  const std::vector<TreeNodeElement<ThresholdType>>& nodes_;
+  std::vector<bool> visited_;
+  std::ostringstream code_;
+};
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -17,13 +17,100 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <sstream>
+
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 using ConvPadVector = ConvAttributes::ConvPadVector;
 
+// number of filter elements along K that share a scale of the weight only quantized filter
+constexpr size_t kConvQuantizedFilterBlkLen = 32;
+
+namespace {
+
+struct MlasConvParams : cpu::tunable::OpParams {
+  std::string Signature() const override {
+    const auto dims = [](std::ostringstream& oss, const size_t* values, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        oss << (i == 0 ? "" : "x") << values[i];
+      }
+    };
+    std::ostringstream oss;
+    oss << "N" << parameters->BatchCount << "_G" << parameters->GroupCount << "_C" << parameters->InputChannels
+        << "_M" << parameters->FilterCount << "_I";
+    dims(oss, parameters->InputShape, parameters->Dimensions);
+    oss << "_K";
+    dims(oss, parameters->KernelShape, parameters->Dimensions);
+    oss << "_D";
+    dims(oss, parameters->DilationShape, parameters->Dimensions);
+    oss << "_P";
+    dims(oss, parameters->Padding, parameters->Dimensions * 2);
+    oss << "_S";
+    dims(oss, parameters->StrideShape, parameters->Dimensions);
+    oss << "_Q" << parameters->FilterBitWidth << "_A" << static_cast<int>(parameters->Algorithm)
+        << "_T" << concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+    return oss.str();
+  }
+
+  const MLAS_CONV_PARAMETERS* parameters;
+  size_t working_buffer_size;
+  const float* input;
+  // the original or the quantized filter, and the filter transformed for the Winograd algorithm if any
+  const float* filter;
+  const float* winograd_filter;
+  const float* bias;
+  float* output;
+  AllocatorPtr alloc;
+  concurrency::ThreadPool* thread_pool;
+};
+
+Status RunMlasConv(const MlasConvParams* params, const MLAS_CONV_PARAMETERS* parameters, size_t working_buffer_size) {
+  auto* working_data = working_buffer_size > 0
+                           ? params->alloc->Alloc(sizeof(float) * SafeInt<size_t>(working_buffer_size))
+                           : nullptr;
+  BufferUniquePtr working_buffer(working_data, BufferDeleter(params->alloc));
+
+  MlasConv(parameters,
+           params->input,
+           parameters->Algorithm == MlasConvAlgorithmWinograd ? params->winograd_filter : params->filter,
+           params->bias,
+           static_cast<float*>(working_buffer.get()),
+           params->output,
+           params->thread_pool);
+  return Status::OK();
+}
+
+// the algorithm selected by the heuristics of MlasConvPrepare
+Status MlasConvDefault(const MlasConvParams* params) {
+  return RunMlasConv(params, params->parameters, params->working_buffer_size);
+}
+
+template <MLAS_CONV_ALGORITHM Algorithm>
+Status MlasConvWithAlgorithm(const MlasConvParams* params) {
+  MLAS_CONV_PARAMETERS parameters = *params->parameters;
+  size_t working_buffer_size;
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+      !MlasConvOverrideAlgorithm(&parameters, Algorithm, params->thread_pool, &working_buffer_size),
+      "MLAS convolution algorithm ", static_cast<int>(Algorithm), " is not supported for ", params->Signature());
+  return RunMlasConv(params, &parameters, working_buffer_size);
+}
+
+// Times the MLAS convolution algorithms per shape when TunableOp tuning is enabled for the CPU execution provider.
+class MlasConvTunableOp : public cpu::tunable::TunableOp<MlasConvParams> {
+ public:
+  MlasConvTunableOp() {
+    this->RegisterOp(MlasConvDefault);
+    this->RegisterOp(MlasConvWithAlgorithm<MlasConvAlgorithmExpandThenGemm>);
+    this->RegisterOp(MlasConvWithAlgorithm<MlasConvAlgorithmExpandThenGemmSegmented>);
+  }
+};
+
+}  // namespace
+
 template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -153,20 +240,80 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* /*prepacked_weights*/) {
+  is_packed = false;
+
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  // The quantized filter replaces the original filter, which is only used by the MLAS convolution of 1 to 3
+  // dimensional kernels.
+  if (filter_bit_width_ != 0) {
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() < 3 || shape.NumDimensions() > 5 || conv_attrs_.group <= 0 ||
+        shape[0] % conv_attrs_.group != 0) {
+      return Status::OK();
+    }
+
+    const size_t group_count = narrow<size_t>(conv_attrs_.group);
+    const size_t filter_count = narrow<size_t>(shape[0] / conv_attrs_.group);
+    const size_t k = narrow<size_t>(shape.SizeFromDimension(1));
+
+    const size_t filter_size =
+        MlasConvQuantizedFilterSize(group_count, filter_count, k, filter_bit_width_, kConvQuantizedFilterBlkLen);
+    quantized_filter_ = IAllocator::MakeUniquePtr<void>(alloc, filter_size, true);
+    MlasConvQuantizeFilter(group_count, filter_count, k, filter_bit_width_, kConvQuantizedFilterBlkLen,
+                           tensor.Data<float>(), quantized_filter_.get());
+
+    filter_shape_ = shape;
+    is_packed = true;
+    return Status::OK();
+  }
+
+  if (!use_winograd_) {
+    return Status::OK();
+  }
+
+  // Only 2D 3x3 filters with enough input channels and filters per group are computed with the Winograd algorithm.
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() != 4 || shape[2] != 3 || shape[3] != 3 || conv_attrs_.group <= 0 ||
+      shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t filter_count = narrow<size_t>(shape[0] / conv_attrs_.group);
+  const size_t input_channels = narrow<size_t>(shape[1]);
+  if (filter_count < 16 || input_channels < 16) {
+    return Status::OK();
+  }
+
+  const size_t filter_size = MlasConvWinogradFilterSize(group_count, filter_count, input_channels);
+  winograd_filter_ = IAllocator::MakeUniquePtr<float>(alloc, filter_size, true);
+  MlasConvWinogradTransformFilter(group_count, filter_count, input_channels, tensor.Data<float>(),
+                                  winograd_filter_.get());
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* W = quantized_filter_ ? nullptr : context->Input<Tensor>(1);
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
+  const TensorShape& W_shape = W != nullptr ? W->Shape() : filter_shape_;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -231,19 +378,31 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &activation_,
                     &WorkingBufferSize,
                     Beta,
-                    thread_pool);
-
-    auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
-                                               : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
-
-    MlasConv(&Parameters,
-             Xdata.data(),
-             W->Data<float>(),
-             Bdata,
-             static_cast<float*>(working_buffer.get()),
-             Ydata.data(),
-             thread_pool);
+                    thread_pool,
+                    winograd_filter_ != nullptr,
+                    quantized_filter_ ? filter_bit_width_ : 0,
+                    kConvQuantizedFilterBlkLen);
+
+    MlasConvParams params;
+    params.parameters = &Parameters;
+    params.working_buffer_size = WorkingBufferSize;
+    params.input = Xdata.data();
+    params.filter = quantized_filter_ ? static_cast<const float*>(quantized_filter_.get()) : W->Data<float>();
+    params.winograd_filter = winograd_filter_.get();
+    params.bias = Bdata;
+    params.output = Ydata.data();
+    params.alloc = std::move(alloc);
+    params.thread_pool = thread_pool;
+
+    // The candidates are run several times while tuning, so the output must not accumulate into the sum input.
+    auto* tuning_ctx = Info().GetExecutionProvider()->GetTuningContext();
+    if (tuning_ctx != nullptr && tuning_ctx->IsTunableOpEnabled() && Beta == 0.0f) {
+      static MlasConvTunableOp tunable_op;
+      params.tuning_ctx = tuning_ctx;
+      return tunable_op(&params);
+    }
+
+    ORT_RETURN_IF_ERROR(MlasConvDefault(&params));
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,14 +27,34 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    use_winograd_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasConvWinograd, "0") == "1";
+    const std::string quantization_bits =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasConvWeightOnlyQuantizationBits, "0");
+    ORT_ENFORCE(quantization_bits == "0" || quantization_bits == "4" || quantization_bits == "8",
+                "Invalid Conv weight only quantization bits: ", quantization_bits);
+    filter_bit_width_ = static_cast<size_t>(std::stoi(quantization_bits));
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // filter transformed for the Winograd algorithm, the original filter is kept for the other algorithms
+  bool use_winograd_;
+  IAllocatorUniquePtr<float> winograd_filter_;
+
+  // filter quantized for weight only quantization, which replaces the original filter
+  size_t filter_bit_width_;
+  IAllocatorUniquePtr<void> quantized_filter_;
+  TensorShape filter_shape_;
 };
 
 }  // namespace onnxruntime
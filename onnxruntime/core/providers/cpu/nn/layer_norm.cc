@@ -10,10 +10,12 @@ namespace onnxruntime {
   ONNX_CPU_OPERATOR_TYPED_KERNEL(LayerNormalization, 17, T,                                      \
                                  KernelDefBuilder()                                              \
                                      .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())      \
-                                     .TypeConstraint("U", DataTypeImpl::GetTensorType<float>()), \
+                                     .TypeConstraint("U", DataTypeImpl::GetTensorType<float>())  \
+                                     .MayInplace(0, 0),                                          \
                                  LayerNorm);
 
 REGISTER_ONNX_KERNEL_TYPED(float)
 REGISTER_ONNX_KERNEL_TYPED(double)
+REGISTER_ONNX_KERNEL_TYPED(MLFloat16)
 
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -18,6 +19,80 @@ LayerNormImpl::LayerNormImpl(const OpKernelInfo& op_kernel_info, bool simplified
 }
 
 namespace {
+template <typename T, typename U>
+void ComputeJob(const T* p_input, const T* scale_data, const T* bias_data, T* p_output, int64_t norm_size,
+                float epsilon, bool simplified, U* mean_data, U* inv_std_dev_data) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / norm_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    if (simplified) {
+      p_output[h] = p_input[h] / mean_square * scale_data[h];
+    } else if (nullptr == bias_data) {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+    } else {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+    }
+  }
+
+  if (mean_data != nullptr) {
+    // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
+    *mean_data = gsl::narrow_cast<U>(mean);
+  }
+
+  if (inv_std_dev_data != nullptr) {
+    *inv_std_dev_data = gsl::narrow_cast<U>(1 / mean_square);
+  }
+}
+
+// float and MLFloat16 rows are normalized by MLAS, which accumulates the statistics in a single vectorized pass.
+template <typename U>
+void ComputeJob(const float* p_input, const float* scale_data, const float* bias_data, float* p_output,
+                int64_t norm_size, float epsilon, bool simplified, U* mean_data, U* inv_std_dev_data) {
+  float mean;
+  float inv_std_dev;
+  MlasLayerNormalization(p_input, nullptr, nullptr, scale_data, bias_data, p_output, nullptr,
+                         onnxruntime::narrow<size_t>(norm_size), epsilon, simplified, &mean, &inv_std_dev);
+
+  if (mean_data != nullptr) {
+    *mean_data = static_cast<U>(mean);
+  }
+
+  if (inv_std_dev_data != nullptr) {
+    *inv_std_dev_data = static_cast<U>(inv_std_dev);
+  }
+}
+
+template <typename U>
+void ComputeJob(const MLFloat16* p_input, const MLFloat16* scale_data, const MLFloat16* bias_data,
+                MLFloat16* p_output, int64_t norm_size, float epsilon, bool simplified, U* mean_data,
+                U* inv_std_dev_data) {
+  float mean;
+  float inv_std_dev;
+  MlasLayerNormalizationFp16(p_input, nullptr, nullptr, scale_data, bias_data, p_output, nullptr,
+                             onnxruntime::narrow<size_t>(norm_size), epsilon, simplified, &mean, &inv_std_dev);
+
+  if (mean_data != nullptr) {
+    *mean_data = U(mean);
+  }
+
+  if (inv_std_dev_data != nullptr) {
+    *inv_std_dev_data = U(inv_std_dev);
+  }
+}
+
 template <typename T, typename U>
 Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, bool simplified) {
   // Inputs
@@ -77,42 +152,10 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
       [&](ptrdiff_t task_idx) {
-        const T* p_input = X_data + task_idx * norm_size;
-        T* p_output = Y_data + task_idx * norm_size;
-
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
-          } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-          }
-        }
-
-        if (mean_data != nullptr) {
-          // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-          mean_data[task_idx] = gsl::narrow_cast<U>(mean);
-        }
-
-        if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
-        }
+        ComputeJob(X_data + task_idx * norm_size, scale_data, bias_data, Y_data + task_idx * norm_size,
+                   norm_size, epsilon, simplified,
+                   mean_data != nullptr ? mean_data + task_idx : nullptr,
+                   inv_std_dev_data != nullptr ? inv_std_dev_data + task_idx : nullptr);
       },
       0);
 
@@ -141,7 +184,7 @@ struct SrcDispatcher {
 Status LayerNormImpl::Compute(OpKernelContext* p_ctx) const {
   const auto elem_type = p_ctx->Input<Tensor>(0)->GetElementType();
 
-  using SupportedTypeList = boost::mp11::mp_list<float, double>;
+  using SupportedTypeList = boost::mp11::mp_list<float, double, MLFloat16>;
 
   utils::MLTypeCallDispatcherFromTypeList<SupportedTypeList> t_disp(elem_type);
   return t_disp.InvokeRet<Status, SrcDispatcher>(p_ctx, axis_, epsilon_, simplified_, contrib_op_);
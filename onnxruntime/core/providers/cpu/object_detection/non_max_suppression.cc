@@ -17,6 +17,7 @@ limitations under the License.
 #include <utility>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +119,209 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+  inline bool operator<(const BoxInfoPtr& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+// Corners and areas of boxes kept in separate arrays, so that the overlaps of one box with many others are
+// computed by one loop the compiler can vectorize.
+struct BoxCorners {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  size_t size() const { return area.size(); }
+
+  void clear() {
+    x_min.clear();
+    y_min.clear();
+    x_max.clear();
+    y_max.clear();
+    area.clear();
+  }
+
+  // Appends a box in the input format, the corners are computed as in SuppressByIOU.
+  void Append(const float* box, int64_t center_point_box) {
+    float box_x_min, box_y_min, box_x_max, box_y_max;
+    if (0 == center_point_box) {
+      MaxMin(box[1], box[3], box_x_min, box_x_max);
+      MaxMin(box[0], box[2], box_y_min, box_y_max);
+    } else {
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      box_x_min = box[0] - width_half;
+      box_x_max = box[0] + width_half;
+      box_y_min = box[1] - height_half;
+      box_y_max = box[1] + height_half;
+    }
+    x_min.push_back(box_x_min);
+    y_min.push_back(box_y_min);
+    x_max.push_back(box_x_max);
+    y_max.push_back(box_y_max);
+    area.push_back((box_x_max - box_x_min) * (box_y_max - box_y_min));
+  }
+
+  void Append(const BoxCorners& other, size_t index) {
+    x_min.push_back(other.x_min[index]);
+    y_min.push_back(other.y_min[index]);
+    x_max.push_back(other.x_max[index]);
+    y_max.push_back(other.y_max[index]);
+    area.push_back(other.area[index]);
+  }
+};
+
+// Sets suppressed[j - begin] to whether box `index` of `boxes` overlaps box j of `others` by more than
+// `iou_threshold`, for j in [begin, end). The arithmetic is the one of SuppressByIOU without its early returns.
+void ComputeSuppressed(const BoxCorners& boxes, size_t index, const BoxCorners& others, size_t begin, size_t end,
+                       float iou_threshold, uint8_t* suppressed) {
+  const float x_min = boxes.x_min[index];
+  const float y_min = boxes.y_min[index];
+  const float x_max = boxes.x_max[index];
+  const float y_max = boxes.y_max[index];
+  const float area = boxes.area[index];
+  const float* others_x_min = others.x_min.data();
+  const float* others_y_min = others.y_min.data();
+  const float* others_x_max = others.x_max.data();
+  const float* others_y_max = others.y_max.data();
+  const float* others_area = others.area.data();
+
+  for (size_t j = begin; j < end; ++j) {
+    const float intersection_x_min = std::max(x_min, others_x_min[j]);
+    const float intersection_x_max = std::min(x_max, others_x_max[j]);
+    const float intersection_y_min = std::max(y_min, others_y_min[j]);
+    const float intersection_y_max = std::min(y_max, others_y_max[j]);
+    const float intersection_area = (intersection_x_max - intersection_x_min) *
+                                    (intersection_y_max - intersection_y_min);
+    const float union_area = area + others_area[j] - intersection_area;
+    suppressed[j - begin] = static_cast<uint8_t>((intersection_x_max > intersection_x_min) &
+                                                 (intersection_y_max > intersection_y_min) &
+                                                 (intersection_area > .0f) & (area > .0f) &
+                                                 (others_area[j] > .0f) & (union_area > .0f) &
+                                                 (intersection_area / union_area > iou_threshold));
+  }
+}
+
+// Whether box `index` of `boxes` is suppressed by any of the `selected` boxes. The selected boxes are checked by
+// blocks so that the search still stops early.
+bool IsSuppressed(const BoxCorners& boxes, size_t index, const BoxCorners& selected, float iou_threshold) {
+  constexpr size_t kBlockSize = 16;
+  uint8_t suppressed[kBlockSize];
+  for (size_t begin = 0; begin < selected.size(); begin += kBlockSize) {
+    const size_t end = std::min(begin + kBlockSize, selected.size());
+    ComputeSuppressed(boxes, index, selected, begin, end, iou_threshold, suppressed);
+    uint8_t any = 0;
+    for (size_t j = 0; j < end - begin; ++j) {
+      any |= suppressed[j];
+    }
+    if (any) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Gathers the boxes of one class whose score is above the threshold.
+std::vector<BoxInfoPtr> GetCandidates(const float* class_scores, int64_t num_boxes, bool has_score_threshold,
+                                      float score_threshold) {
+  std::vector<BoxInfoPtr> candidate_boxes;
+  candidate_boxes.reserve(onnxruntime::narrow<size_t>(num_boxes));
+  for (int64_t box_index = 0; box_index < num_boxes; ++box_index, ++class_scores) {
+    if (!has_score_threshold || *class_scores > score_threshold) {
+      candidate_boxes.emplace_back(*class_scores, box_index);
+    }
+  }
+  return candidate_boxes;
+}
+
+// Greedy selection, the candidates are taken by decreasing score and compared to the boxes already selected.
+void SelectGreedy(std::vector<BoxInfoPtr> candidate_boxes, const BoxCorners& batch_corners, int64_t batch_index,
+                  int64_t class_index, int64_t max_output_boxes_per_class, float iou_threshold,
+                  std::vector<SelectedIndex>& selected_indices) {
+  std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
+
+  BoxCorners selected_corners;
+  // Get the next box with top score, filter by iou_threshold
+  while (!sorted_boxes.empty() && static_cast<int64_t>(selected_corners.size()) < max_output_boxes_per_class) {
+    const BoxInfoPtr& next_top_score = sorted_boxes.top();
+    const auto box_index = static_cast<size_t>(next_top_score.index_);
+
+    // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
+    if (!IsSuppressed(batch_corners, box_index, selected_corners, iou_threshold)) {
+      selected_corners.Append(batch_corners, box_index);
+      selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+    }
+    sorted_boxes.pop();
+  }
+}
+
+// Sorted bitmask selection. The candidates are sorted, then every candidate computes in parallel the bitmask of the
+// lower scored candidates it suppresses, and the selection only combines the bitmasks of the selected candidates.
+// The result is the one of the greedy selection.
+void SelectWithBitmask(std::vector<BoxInfoPtr> candidate_boxes, const BoxCorners& batch_corners, int64_t batch_index,
+                       int64_t class_index, int64_t max_output_boxes_per_class, float iou_threshold,
+                       concurrency::ThreadPool* thread_pool, std::vector<SelectedIndex>& selected_indices) {
+  std::sort(candidate_boxes.begin(), candidate_boxes.end(),
+            [](const BoxInfoPtr& lhs, const BoxInfoPtr& rhs) { return rhs < lhs; });
+  const size_t num_candidates = candidate_boxes.size();
+  const size_t num_words = (num_candidates + 63) / 64;
+
+  BoxCorners sorted_corners;
+  for (const auto& candidate : candidate_boxes) {
+    sorted_corners.Append(batch_corners, static_cast<size_t>(candidate.index_));
+  }
+
+  std::vector<uint64_t> masks(num_candidates * num_words, 0);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_candidates),
+      TensorOpCost{static_cast<double>(num_candidates * 5 * sizeof(float)) / 2,
+                   static_cast<double>(num_words * sizeof(uint64_t)) / 2,
+                   static_cast<double>(num_candidates * 10) / 2},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        uint8_t suppressed[64];
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          uint64_t* mask = masks.data() + static_cast<size_t>(i) * num_words;
+          for (size_t word = static_cast<size_t>(i + 1) / 64; word < num_words; ++word) {
+            const size_t begin = std::max(word * 64, static_cast<size_t>(i + 1));
+            const size_t end = std::min((word + 1) * 64, num_candidates);
+            ComputeSuppressed(sorted_corners, static_cast<size_t>(i), sorted_corners, begin, end, iou_threshold,
+                              suppressed);
+            uint64_t bits = 0;
+            for (size_t j = begin; j < end; ++j) {
+              bits |= static_cast<uint64_t>(suppressed[j - begin]) << (j % 64);
+            }
+            mask[word] = bits;
+          }
+        }
+      });
+
+  std::vector<uint64_t> removed(num_words, 0);
+  int64_t num_selected = 0;
+  for (size_t i = 0; i < num_candidates && num_selected < max_output_boxes_per_class; ++i) {
+    if ((removed[i / 64] >> (i % 64)) & 1) {
+      continue;
+    }
+    selected_indices.emplace_back(batch_index, class_index, candidate_boxes[i].index_);
+    ++num_selected;
+    const uint64_t* mask = masks.data() + i * num_words;
+    for (size_t word = i / 64; word < num_words; ++word) {
+      removed[word] |= mask[word];
+    }
+  }
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -136,74 +340,72 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
 
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
+  const auto center_point_box = GetCenterPointBox();
 
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  // The corners of the boxes are computed once per batch and shared by the classes.
+  std::vector<BoxCorners> batch_corners(onnxruntime::narrow<size_t>(pc.num_batches_));
+  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
+    const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
+    auto& corners = batch_corners[onnxruntime::narrow<size_t>(batch_index)];
+    for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+      corners.Append(batch_boxes + box_index * 4, center_point_box);
     }
-  };
-
-  const auto center_point_box = GetCenterPointBox();
+  }
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
+  // Every class of every batch is selected independently, the results are concatenated in order.
+  const auto num_tasks = onnxruntime::narrow<size_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<SelectedIndex>> selected_per_task(num_tasks);
+  auto* thread_pool = ctx->GetOperatorThreadPool();
+  auto get_candidates = [&](size_t task) {
+    const int64_t box_score_offset = static_cast<int64_t>(task) * pc.num_boxes_;
+    return GetCandidates(scores_data + box_score_offset, pc.num_boxes_, pc.score_threshold_ != nullptr,
+                         score_threshold);
+  };
 
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
-          }
-        }
+  if (use_sorted_bitmask_) {
+    for (size_t task = 0; task < num_tasks; ++task) {
+      const int64_t batch_index = static_cast<int64_t>(task) / pc.num_classes_;
+      const int64_t class_index = static_cast<int64_t>(task) % pc.num_classes_;
+      auto candidate_boxes = get_candidates(task);
+      const auto& corners = batch_corners[onnxruntime::narrow<size_t>(batch_index)];
+      if (candidate_boxes.size() <= kMaxSortedBitmaskCandidates) {
+        SelectWithBitmask(std::move(candidate_boxes), corners, batch_index, class_index, max_output_boxes_per_class,
+                          iou_threshold, thread_pool, selected_per_task[task]);
       } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
+        SelectGreedy(std::move(candidate_boxes), corners, batch_index, class_index, max_output_boxes_per_class,
+                     iou_threshold, selected_per_task[task]);
       }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+    }
+  } else {
+    const double num_boxes = static_cast<double>(pc.num_boxes_);
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(num_tasks),
+        TensorOpCost{num_boxes * sizeof(float), num_boxes * sizeof(BoxInfoPtr), num_boxes * 20},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; ++task) {
+            const int64_t batch_index = static_cast<int64_t>(task) / pc.num_classes_;
+            const int64_t class_index = static_cast<int64_t>(task) % pc.num_classes_;
+            SelectGreedy(get_candidates(static_cast<size_t>(task)),
+                         batch_corners[onnxruntime::narrow<size_t>(batch_index)], batch_index, class_index,
+                         max_output_boxes_per_class, iou_threshold, selected_per_task[static_cast<size_t>(task)]);
           }
-        }
+        });
+  }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-        sorted_boxes.pop();
-      }  // while
-    }  // for class_index
-  }  // for batch_index
+  size_t num_selected = 0;
+  for (const auto& selected : selected_per_task) {
+    num_selected += selected.size();
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (const auto& selected : selected_per_task) {
+    memcpy(output_data, selected.data(), selected.size() * sizeof(SelectedIndex));
+    output_data += selected.size();
+  }
 
   return Status::OK();
 }
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -35,8 +36,16 @@ class NonMaxSuppressionBase {
 class NonMaxSuppression final : public OpKernel, public NonMaxSuppressionBase {
  public:
   explicit NonMaxSuppression(const OpKernelInfo& info) : OpKernel(info), NonMaxSuppressionBase(info) {
+    use_sorted_bitmask_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsNonMaxSuppressionSortedBitmask, "0") == "1";
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // Classes with more candidates use the greedy selection, the bitmasks would take num_candidates^2 / 8 bytes.
+  static constexpr size_t kMaxSortedBitmaskCandidates = 16384;
+
+  bool use_sorted_bitmask_;
 };
 }  // namespace onnxruntime
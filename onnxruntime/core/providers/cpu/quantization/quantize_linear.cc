@@ -501,7 +501,14 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   if (to == ONNX_NAMESPACE::TensorProto::FLOAT) {
     const float* scale = x_scale.Data<float>();
     float* output = y.MutableData<float>();
-    if (block_size_) {
+    if constexpr (boost::mp11::mp_contains<TypeList<int8_t, uint8_t, int16_t, uint16_t>, T>::value) {
+      MlasDequantizeLinear<T>(input, output,
+                              static_cast<size_t>(process_block_count),
+                              static_cast<size_t>(broadcast_dim),
+                              static_cast<size_t>(process_block_size),
+                              static_cast<size_t>(block_size_),
+                              scale, zero_point, ctx->GetOperatorThreadPool());
+    } else if (block_size_) {
       DequantizeLinearApply<T, float, is_4bit>().op(static_cast<size_t>(process_block_count),
                                                     static_cast<size_t>(broadcast_dim),
                                                     static_cast<size_t>(process_block_size),
@@ -8,6 +8,7 @@
 #include "core/common/common.h"
 #include "core/common/optional.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/containers.h"
 #include "core/util/math.h"
 #endif
@@ -151,6 +152,33 @@ inline bool reduce_isnan<int32_t>(int32_t) { return false; }
 template <>
 inline bool reduce_isnan<int64_t>(int64_t) { return false; }
 
+enum class MlasFastReduceKind {
+  kSum,
+  kMin,
+  kMax,
+};
+
+// Reduces the middle axis of a tensor viewed as [outer, reduce, inner] with the vectorized MLAS kernels.
+// Returns false for the types without MLAS kernels, which keep the Eigen based implementations.
+template <typename T>
+inline bool TryMlasFastReduce(MlasFastReduceKind, const Tensor&, int64_t, int64_t, int64_t, Tensor&,
+                              concurrency::ThreadPool*) {
+  return false;
+}
+
+#ifndef SHARED_PROVIDER
+template <>
+inline bool TryMlasFastReduce<float>(MlasFastReduceKind kind, const Tensor& input, int64_t outer, int64_t reduce,
+                                     int64_t inner, Tensor& output, concurrency::ThreadPool* tp) {
+  const MLAS_REDUCE_KIND mlas_kind = kind == MlasFastReduceKind::kSum   ? MlasReduceSum
+                                     : kind == MlasFastReduceKind::kMin ? MlasReduceMinimum
+                                                                        : MlasReduceMaximum;
+  MlasReduce(mlas_kind, input.Data<float>(), output.MutableData<float>(), onnxruntime::narrow<size_t>(outer),
+             onnxruntime::narrow<size_t>(reduce), onnxruntime::narrow<size_t>(inner), tp);
+  return true;
+}
+#endif
+
 class ReduceAggregatorBase {
  public:
   // Fast reduction: see OptimizeShapeForFastReduce's comment.
@@ -231,6 +259,9 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kSum, input, fast_shape[0], fast_shape[1], 1, output, tp)) {
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -245,6 +276,9 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kSum, input, 1, fast_shape[0], fast_shape[1], output, tp)) {
+      return;
+    }
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
@@ -263,6 +297,9 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kSum, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp)) {
+      return;
+    }
     int64_t N = fast_shape[2];
     const T* data = input.Data<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -391,6 +428,9 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMax, input, fast_shape[0], fast_shape[1], 1, output, tp)) {
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -415,6 +455,9 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMax, input, 1, fast_shape[0], fast_shape[1], output, tp)) {
+      return;
+    }
     int64_t n_rows = fast_shape[0];
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
@@ -441,6 +484,9 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMax, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp)) {
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -601,6 +647,9 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMin, input, fast_shape[0], fast_shape[1], 1, output, tp)) {
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -625,6 +674,9 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMin, input, 1, fast_shape[0], fast_shape[1], output, tp)) {
+      return;
+    }
     int64_t n_rows = fast_shape[0];
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
@@ -651,6 +703,9 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if (TryMlasFastReduce<T>(MlasFastReduceKind::kMin, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp)) {
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -3,10 +3,13 @@
 
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
+#include <atomic>
 #include <cmath>
 #include <cstring>
+#include <exception>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <stdlib.h>
 #include <string>
 #include <unordered_map>
@@ -14,6 +17,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/Barrier.h"
 #include "core/providers/cpu/rnn/rnn_activation_functors.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -190,6 +194,60 @@ ActivationFuncs::ActivationFuncs(const std::vector<std::string>& funcs,
   }
 }
 
+namespace {
+struct ReverseDirectionTask {
+  // set by whichever of the scheduled task and the caller gets to run the reverse direction
+  std::atomic<bool> claimed{false};
+  Notification done;
+  std::exception_ptr exception;
+};
+}  // namespace
+
+void ComputeBidirectional(concurrency::ThreadPool* thread_pool, const std::function<void()>& forward,
+                          const std::function<void()>& reverse) {
+  if (concurrency::ThreadPool::DegreeOfParallelism(thread_pool) < 2) {
+    forward();
+    reverse();
+    return;
+  }
+
+  // The task may only run after this function returned if the caller ran the reverse direction itself,
+  // so its state is shared and `reverse` is only used once the task has claimed it.
+  auto task = std::make_shared<ReverseDirectionTask>();
+  concurrency::ThreadPool::Schedule(thread_pool, [task, &reverse]() {
+    if (task->claimed.exchange(true)) {
+      return;
+    }
+    ORT_TRY {
+      reverse();
+    }
+    ORT_CATCH(...) {
+      ORT_HANDLE_EXCEPTION([&]() { task->exception = std::current_exception(); });
+    }
+    task->done.Notify();
+  });
+
+  bool run_reverse = false;
+  {
+    // wait for the reverse direction if it has started, even when the forward direction throws.
+    auto wait_for_reverse = gsl::finally([&task, &run_reverse]() {
+      if (task->claimed.exchange(true)) {
+        task->done.Wait();
+      } else {
+        // no worker picked the task up while the forward direction ran.
+        task->done.Notify();
+        run_reverse = true;
+      }
+    });
+    forward();
+  }
+  if (run_reverse) {
+    reverse();
+  } else if (task->exception) {
+    std::rethrow_exception(task->exception);
+  }
+}
+
 #if defined(DUMP_MATRIXES)
 void DumpMatrixImpl(const std::string& name, const float* src, int row, int col, int offset, int col_width) {
   std::cout << "Dump matrix: " << name << std::endl;
@@ -18,6 +18,8 @@
 #include "core/common/safeint.h"
 #include "core/platform/threadpool.h"
 
+#include <functional>
+
 #include <gsl/gsl>
 
 namespace onnxruntime {
@@ -325,6 +327,12 @@ T* SafeRawPointer(typename gsl::span<T> span, size_t offset, size_t size) {
 void DumpMatrixImpl(const std::string& name, const float* src, int row, int col,
                     int offset = 0, int col_width = -1);
 
+// Runs the forward and the reverse direction of a bidirectional RNN at the same time. The reverse direction is
+// scheduled on the thread pool, and both directions keep using the pool for their own GEMMs. The caller runs the
+// reverse direction after the forward one if no worker has started it by then.
+void ComputeBidirectional(concurrency::ThreadPool* thread_pool, const std::function<void()>& forward,
+                          const std::function<void()>& reverse);
+
 // Helper class to wrap the processing of the activation funcs and any alpha/beta values.
 // The alpha/beta values are consumed in the order of the activation funcs. once they run out
 // defaults will be used as needed.
@@ -3,16 +3,19 @@
 
 #include "core/providers/cpu/signal/dft.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <functional>
 #include <limits>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
 #include "core/framework/op_kernel.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/signal/fft.h"
 #include "core/providers/cpu/signal/utils.h"
 #include "core/util/math_cpuonly.h"
 #include "Eigen/src/Core/Map.h"
@@ -199,6 +202,61 @@ T next_power_of_2(T in) {
   return out;
 }
 
+// Number of complex values of scratch space used by fft_planned.
+static size_t fft_planned_scratch_size(size_t dft_length) {
+  return 2 * dft_length + 2;
+}
+
+template <typename T>
+static TensorOpCost fft_planned_cost(size_t dft_length, size_t dft_output_size, size_t input_element_size) {
+  const double n = static_cast<double>(dft_length);
+  return TensorOpCost{n * static_cast<double>(input_element_size),
+                      static_cast<double>(dft_output_size * sizeof(std::complex<T>)),
+                      5.0 * n * std::max(1.0, std::log2(n))};
+}
+
+// Transforms one signal with a planned mixed radix FFT. Real signals of even length are transformed as complex
+// signals of half length.
+template <typename T, typename U>
+static void fft_planned(const signal::FftPlan<T>& plan, const U* X_data, size_t X_stride, size_t number_of_samples,
+                        const T* window_data, std::complex<T>* Y_data, size_t Y_stride, size_t dft_output_size,
+                        std::complex<T>* scratch) {
+  const size_t dft_length = plan.Length();
+  const size_t input_size = std::min(dft_length, number_of_samples);
+  std::complex<T>* result = scratch;
+  std::complex<T>* input = scratch + dft_length + 1;
+
+  bool is_real_transform = false;
+  if constexpr (std::is_same_v<U, T>) {
+    if (plan.IsRealSupported()) {
+      is_real_transform = true;
+      T* real_input = reinterpret_cast<T*>(input);
+      for (size_t i = 0; i < input_size; i++) {
+        real_input[i] = X_data[i * X_stride] * (window_data ? window_data[i] : static_cast<T>(1));
+      }
+      std::fill(real_input + input_size, real_input + dft_length, static_cast<T>(0));
+      plan.TransformReal(real_input, result, input + dft_length / 2);
+      // the remaining bins of a real signal are the conjugates of the first ones
+      for (size_t i = (dft_length >> 1) + 1; i < dft_output_size; i++) {
+        result[i] = std::conj(result[dft_length - i]);
+      }
+    }
+  }
+
+  if (!is_real_transform) {
+    for (size_t i = 0; i < input_size; i++) {
+      input[i] = std::complex<T>(X_data[i * X_stride]) * (window_data ? window_data[i] : static_cast<T>(1));
+    }
+    std::fill(input + input_size, input + dft_length, std::complex<T>(0, 0));
+    plan.Transform(input, 1, result);
+  }
+
+  const T scale = plan.IsInverse() ? static_cast<T>(1) / static_cast<T>(dft_length) : static_cast<T>(1);
+  for (size_t i = 0; i < dft_output_size; i++) {
+    Y_data[i * Y_stride] = result[i] * scale;
+  }
+}
+
 template <typename T, typename U>
 static Status dft_bluestein_z_chirp(
     OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp, size_t X_offset, size_t X_stride, size_t Y_offset, size_t Y_stride,
@@ -316,6 +374,7 @@ static Status dft_bluestein_z_chirp(
 template <typename T, typename U>
 static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp,
                                          int64_t axis, int64_t dft_length, const Tensor* window, bool is_onesided, bool inverse,
+                                         const signal::FftPlan<T>* plan,
                                          InlinedVector<std::complex<T>>& V,
                                          InlinedVector<std::complex<T>>& temp_output) {
   // Get shape
@@ -333,9 +392,10 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   }
 
   // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
-    size_t X_offset = 0;
-    size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+  auto compute_offsets = [&](size_t i, size_t& X_offset, size_t& Y_offset) {
+    X_offset = 0;
     size_t cumulative_packed_stride = total_dfts;
     size_t temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -348,8 +408,7 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
     }
 
-    size_t Y_offset = 0;
-    size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+    Y_offset = 0;
     cumulative_packed_stride = total_dfts;
     temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -361,6 +420,33 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       temp -= (index * cumulative_packed_stride);
       Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
     }
+  };
+
+  if (plan != nullptr && plan->IsSupported()) {
+    // The plan is read only, so the signals are transformed in parallel.
+    const size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+    const size_t dft_output_size = static_cast<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+    const auto* X_data = reinterpret_cast<const U*>(X->DataRaw());
+    auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+    const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+        fft_planned_cost<T>(plan->Length(), dft_output_size, sizeof(U)),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<std::complex<T>> scratch(fft_planned_scratch_size(plan->Length()));
+          for (std::ptrdiff_t i = first; i < last; i++) {
+            size_t X_offset, Y_offset;
+            compute_offsets(static_cast<size_t>(i), X_offset, Y_offset);
+            fft_planned(*plan, X_data + X_offset, X_stride, number_of_samples, window_data, Y_data + Y_offset, Y_stride,
+                        dft_output_size, scratch.data());
+          }
+        });
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < total_dfts; i++) {
+    size_t X_offset, Y_offset;
+    compute_offsets(i, X_offset, Y_offset);
 
     if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
       ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
@@ -374,7 +460,8 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   return Status::OK();
 }
 
-static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, bool is_onesided, bool inverse) {
+static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, bool is_onesided, bool inverse,
+                                         signal::FftPlanCache& plan_cache) {
   // Get input shape
   const auto* X = ctx->Input<Tensor>(0);
   const auto* dft_length = ctx->Input<Tensor>(1);
@@ -413,12 +500,13 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   if (element_size == sizeof(float)) {
     InlinedVector<std::complex<float>> V;
     InlinedVector<std::complex<float>> temp_output;
+    auto plan = plan_cache.Get<float>(onnxruntime::narrow<size_t>(number_of_samples), inverse);
     if (is_real_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                    is_onesided, inverse, V, temp_output)));
+                                                                    is_onesided, inverse, plan.get(), V, temp_output)));
     } else if (is_complex_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, plan.get(), V, temp_output)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -429,12 +517,13 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   } else if (element_size == sizeof(double)) {
     InlinedVector<std::complex<double>> V;
     InlinedVector<std::complex<double>> temp_output;
+    auto plan = plan_cache.Get<double>(onnxruntime::narrow<size_t>(number_of_samples), inverse);
     if (is_real_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                      is_onesided, inverse, V, temp_output)));
+                                                                      is_onesided, inverse, plan.get(), V, temp_output)));
     } else if (is_complex_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, plan.get(), V, temp_output)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -456,12 +545,13 @@ Status DFT::Compute(OpKernelContext* ctx) const {
     axis = axes_tensor->Data<int64_t>()[0];
   }
 
-  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, axis, is_onesided_, is_inverse_));
+  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, axis, is_onesided_, is_inverse_, plan_cache_));
   return Status::OK();
 }
 
 template <typename T, typename U>
-static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_onesided, bool /*inverse*/) {
+static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_onesided, bool /*inverse*/,
+                                           signal::FftPlanCache& plan_cache) {
   // Attr("onesided"): default = 1
   // Input(0, "signal") type = T1
   // Input(1, "frame_length") type = T2
@@ -529,6 +619,30 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   auto dft_input_shape = onnxruntime::TensorShape({1, window_size, signal_components});
   auto dft_output_shape = onnxruntime::TensorShape({1, dft_output_size, output_components});
 
+  auto plan = plan_cache.Get<T>(onnxruntime::narrow<size_t>(window_size), false);
+  if (plan->IsSupported()) {
+    // Every frame is transformed independently with the shared plan.
+    const size_t frame_count = onnxruntime::narrow<size_t>(batch_size * n_dfts);
+    const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+    auto* spectra = reinterpret_cast<std::complex<T>*>(Y_data);
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(frame_count),
+        fft_planned_cost<T>(plan->Length(), onnxruntime::narrow<size_t>(dft_output_size), sizeof(U)),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<std::complex<T>> scratch(fft_planned_scratch_size(plan->Length()));
+          for (std::ptrdiff_t frame = first; frame < last; frame++) {
+            const int64_t batch_idx = frame / n_dfts;
+            const int64_t i = frame % n_dfts;
+            // U already holds both components of a complex signal
+            const U* input_frame_begin = signal_data + (batch_idx * signal_size) + (i * frame_step);
+            std::complex<T>* output_frame_begin = spectra + frame * dft_output_size;
+            fft_planned(*plan, input_frame_begin, 1, onnxruntime::narrow<size_t>(window_size), window_data,
+                        output_frame_begin, 1, onnxruntime::narrow<size_t>(dft_output_size), scratch.data());
+          }
+        });
+    return Status::OK();
+  }
+
   Tensor b_fft, chirp;
   InlinedVector<std::complex<T>> V;
   InlinedVector<std::complex<T>> temp_output;
@@ -549,7 +663,7 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
 
       // Run individual dft
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
-                                                            false, V, temp_output)));
+                                                            false, nullptr, V, temp_output)));
     }
   }
 
@@ -576,9 +690,9 @@ Status STFT::Compute(OpKernelContext* ctx) const {
   const auto element_size = data_type->Size();
   if (element_size == sizeof(float)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, is_onesided_, false, plan_cache_)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, is_onesided_, false, plan_cache_)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -588,9 +702,9 @@ Status STFT::Compute(OpKernelContext* ctx) const {
     }
   } else if (element_size == sizeof(double)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, is_onesided_, false, plan_cache_)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(ctx, is_onesided_, false, plan_cache_)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -0,0 +1,273 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace signal {
+
+// Mixed radix FFT of a fixed length. The length is split into factors of 4, 2, 3 and 5 first and any other prime
+// factor up to kMaxRadix, each stage applies the butterflies of one factor with twiddles computed once by the plan.
+// Lengths with a larger prime factor are not supported and go through the Bluestein algorithm instead.
+// A plan is immutable once built, so it can be shared by the threads transforming different frames.
+template <typename T>
+class FftPlan {
+ public:
+  static constexpr size_t kMaxRadix = 31;
+
+  FftPlan(size_t length, bool inverse) : length_(length), inverse_(inverse) {
+    ORT_ENFORCE(length > 0, "The FFT length must be positive.");
+    size_t n = length;
+    for (size_t p : {size_t{4}, size_t{2}, size_t{3}, size_t{5}}) {
+      while (n % p == 0) {
+        factors_.push_back(p);
+        n /= p;
+      }
+    }
+    for (size_t p = 7; p * p <= n; p += 2) {
+      while (n % p == 0) {
+        factors_.push_back(p);
+        n /= p;
+      }
+    }
+    if (n > 1) {
+      factors_.push_back(n);
+    }
+    for (size_t p : factors_) {
+      supported_ = supported_ && p <= kMaxRadix;
+    }
+    if (!supported_) {
+      return;
+    }
+
+    // the stage of a factor p works on sub-transforms of length m, the product of the following factors.
+    strides_.resize(factors_.size());
+    size_t m = length;
+    for (size_t i = 0; i < factors_.size(); ++i) {
+      m /= factors_[i];
+      strides_[i] = m;
+    }
+
+    const double sign = inverse ? 1.0 : -1.0;
+    twiddles_.resize(length);
+    for (size_t k = 0; k < length; ++k) {
+      const double angle = sign * 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(length);
+      twiddles_[k] = std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+    }
+
+    if (length % 2 == 0) {
+      half_ = std::make_unique<FftPlan<T>>(length / 2, inverse);
+    }
+  }
+
+  size_t Length() const { return length_; }
+  bool IsInverse() const { return inverse_; }
+  bool IsSupported() const { return supported_; }
+  // Whether TransformReal can be used.
+  bool IsRealSupported() const { return half_ != nullptr; }
+
+  // out[k] = sum_j in[j * in_stride] * exp(-+2 pi i j k / n) for k < n. `out` must not overlap `in`.
+  void Transform(const std::complex<T>* in, size_t in_stride, std::complex<T>* out) const {
+    Work(out, in, 1, in_stride, 0);
+  }
+
+  // Transform of n real values, writes the n / 2 + 1 first bins, the others are their conjugates.
+  // `scratch` holds n / 2 values and must not overlap `in` or `out`.
+  void TransformReal(const T* in, std::complex<T>* out, std::complex<T>* scratch) const {
+    // The even and odd values are transformed together as the real and imaginary parts of one signal of half length.
+    const size_t half = length_ / 2;
+    half_->Transform(reinterpret_cast<const std::complex<T>*>(in), 1, scratch);
+    out[0] = std::complex<T>(scratch[0].real() + scratch[0].imag(), 0);
+    out[half] = std::complex<T>(scratch[0].real() - scratch[0].imag(), 0);
+    const std::complex<T> half_i(0, static_cast<T>(-0.5));
+    for (size_t k = 1; k < half; ++k) {
+      const std::complex<T> z = scratch[k];
+      const std::complex<T> z_conj = std::conj(scratch[half - k]);
+      const std::complex<T> even = static_cast<T>(0.5) * (z + z_conj);
+      const std::complex<T> odd = half_i * (z - z_conj);
+      out[k] = even + twiddles_[k] * odd;
+    }
+  }
+
+ private:
+  void Work(std::complex<T>* out, const std::complex<T>* in, size_t fstride, size_t in_stride, size_t stage) const {
+    if (stage == factors_.size()) {
+      *out = *in;
+      return;
+    }
+    const size_t p = factors_[stage];
+    const size_t m = strides_[stage];
+    if (m == 1) {
+      for (size_t q = 0; q < p; ++q) {
+        out[q] = in[q * fstride * in_stride];
+      }
+    } else {
+      for (size_t q = 0; q < p; ++q) {
+        Work(out + q * m, in + q * fstride * in_stride, fstride * p, in_stride, stage + 1);
+      }
+    }
+
+    switch (p) {
+      case 2:
+        Butterfly2(out, fstride, m);
+        break;
+      case 3:
+        Butterfly3(out, fstride, m);
+        break;
+      case 4:
+        Butterfly4(out, fstride, m);
+        break;
+      case 5:
+        Butterfly5(out, fstride, m);
+        break;
+      default:
+        ButterflyGeneric(out, fstride, m, p);
+        break;
+    }
+  }
+
+  void Butterfly2(std::complex<T>* out, size_t fstride, size_t m) const {
+    std::complex<T>* out2 = out + m;
+    for (size_t k = 0; k < m; ++k) {
+      const std::complex<T> t = out2[k] * twiddles_[k * fstride];
+      out2[k] = out[k] - t;
+      out[k] += t;
+    }
+  }
+
+  void Butterfly3(std::complex<T>* out, size_t fstride, size_t m) const {
+    const T epi3 = twiddles_[fstride * m].imag();
+    for (size_t k = 0; k < m; ++k) {
+      const std::complex<T> s1 = out[k + m] * twiddles_[k * fstride];
+      const std::complex<T> s2 = out[k + 2 * m] * twiddles_[2 * k * fstride];
+      const std::complex<T> s3 = s1 + s2;
+      const std::complex<T> s0 = (s1 - s2) * epi3;
+      const std::complex<T> base = out[k] - static_cast<T>(0.5) * s3;
+      out[k] += s3;
+      out[k + m] = std::complex<T>(base.real() - s0.imag(), base.imag() + s0.real());
+      out[k + 2 * m] = std::complex<T>(base.real() + s0.imag(), base.imag() - s0.real());
+    }
+  }
+
+  void Butterfly4(std::complex<T>* out, size_t fstride, size_t m) const {
+    for (size_t k = 0; k < m; ++k) {
+      const std::complex<T> s0 = out[k + m] * twiddles_[k * fstride];
+      const std::complex<T> s1 = out[k + 2 * m] * twiddles_[2 * k * fstride];
+      const std::complex<T> s2 = out[k + 3 * m] * twiddles_[3 * k * fstride];
+      const std::complex<T> s5 = out[k] - s1;
+      const std::complex<T> s6 = out[k] + s1;
+      const std::complex<T> s3 = s0 + s2;
+      const std::complex<T> s4 = s0 - s2;
+      out[k] = s6 + s3;
+      out[k + 2 * m] = s6 - s3;
+      // s4 rotated by -+90 degrees
+      const std::complex<T> r = inverse_ ? std::complex<T>(-s4.imag(), s4.real())
+                                         : std::complex<T>(s4.imag(), -s4.real());
+      out[k + m] = s5 + r;
+      out[k + 3 * m] = s5 - r;
+    }
+  }
+
+  void Butterfly5(std::complex<T>* out, size_t fstride, size_t m) const {
+    const std::complex<T> ya = twiddles_[fstride * m];
+    const std::complex<T> yb = twiddles_[2 * fstride * m];
+    for (size_t k = 0; k < m; ++k) {
+      const std::complex<T> s0 = out[k];
+      const std::complex<T> s1 = out[k + m] * twiddles_[k * fstride];
+      const std::complex<T> s2 = out[k + 2 * m] * twiddles_[2 * k * fstride];
+      const std::complex<T> s3 = out[k + 3 * m] * twiddles_[3 * k * fstride];
+      const std::complex<T> s4 = out[k + 4 * m] * twiddles_[4 * k * fstride];
+      const std::complex<T> s7 = s1 + s4;
+      const std::complex<T> s10 = s1 - s4;
+      const std::complex<T> s8 = s2 + s3;
+      const std::complex<T> s9 = s2 - s3;
+
+      out[k] = s0 + s7 + s8;
+
+      const std::complex<T> s5 = s0 + s7 * ya.real() + s8 * yb.real();
+      const std::complex<T> s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                               -s10.real() * ya.imag() - s9.real() * yb.imag());
+      out[k + m] = s5 - s6;
+      out[k + 4 * m] = s5 + s6;
+
+      const std::complex<T> s11 = s0 + s7 * yb.real() + s8 * ya.real();
+      const std::complex<T> s12(-s10.imag() * yb.imag() + s9.imag() * ya.imag(),
+                                s10.real() * yb.imag() - s9.real() * ya.imag());
+      out[k + 2 * m] = s11 + s12;
+      out[k + 3 * m] = s11 - s12;
+    }
+  }
+
+  void ButterflyGeneric(std::complex<T>* out, size_t fstride, size_t m, size_t p) const {
+    std::array<std::complex<T>, kMaxRadix> scratch;
+    for (size_t u = 0; u < m; ++u) {
+      for (size_t q = 0; q < p; ++q) {
+        scratch[q] = out[u + q * m];
+      }
+      for (size_t q1 = 0; q1 < p; ++q1) {
+        const size_t k = u + q1 * m;
+        size_t twiddle_index = 0;
+        std::complex<T> sum = scratch[0];
+        for (size_t q = 1; q < p; ++q) {
+          twiddle_index += fstride * k;
+          if (twiddle_index >= length_) {
+            twiddle_index %= length_;
+          }
+          sum += scratch[q] * twiddles_[twiddle_index];
+        }
+        out[k] = sum;
+      }
+    }
+  }
+
+  size_t length_;
+  bool inverse_;
+  bool supported_ = true;
+  std::vector<size_t> factors_;
+  // length of the sub-transforms combined by the stage of each factor
+  std::vector<size_t> strides_;
+  std::vector<std::complex<T>> twiddles_;
+  // plan of the half length for the real input transform
+  std::unique_ptr<FftPlan<T>> half_;
+};
+
+// Keeps the plans of the last length used by a kernel so that the twiddles are computed once.
+class FftPlanCache {
+ public:
+  template <typename T>
+  std::shared_ptr<const FftPlan<T>> Get(size_t length, bool inverse) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto& plan = Plan<T>(inverse);
+    if (plan == nullptr || plan->Length() != length) {
+      plan = std::make_shared<const FftPlan<T>>(length, inverse);
+    }
+    return plan;
+  }
+
+ private:
+  template <typename T>
+  std::shared_ptr<const FftPlan<T>>& Plan(bool inverse) {
+    if constexpr (std::is_same_v<T, float>) {
+      return float_plans_[inverse ? 1 : 0];
+    } else {
+      return double_plans_[inverse ? 1 : 0];
+    }
+  }
+
+  OrtMutex mutex_;
+  std::shared_ptr<const FftPlan<float>> float_plans_[2];
+  std::shared_ptr<const FftPlan<double>> double_plans_[2];
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -3,6 +3,11 @@
 
 #include "core/providers/cpu/tensor/compress.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <numeric>
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -25,6 +30,13 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Compress);
 
+namespace {
+
+// Entries of the condition counted and scattered by one task, the passes are split in at most one chunk per thread.
+constexpr int64_t kMinChunkSize = 16384;
+
+}  // namespace
+
 Status Compress::Compute(OpKernelContext* ctx) const {
   const auto* input_tensor = ctx->Input<Tensor>(0);
   size_t rank = input_tensor->Shape().NumDimensions();
@@ -38,17 +50,27 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[onnxruntime::narrow<size_t>(axis)] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
-    }
-  }
+  // The positive entries of the condition are counted per chunk, the output offset of a chunk is the count of the
+  // chunks before it.
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(valid_condition_length / kMinChunkSize,
+                           concurrency::ThreadPool::DegreeOfParallelism(thread_pool)));
+  auto chunk_begin = [valid_condition_length, num_chunks](int64_t chunk) {
+    return (valid_condition_length / num_chunks) * chunk + std::min(chunk, valid_condition_length % num_chunks);
+  };
+
+  std::vector<int64_t> chunk_offsets(onnxruntime::narrow<size_t>(num_chunks + 1), 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, num_chunks, [&](std::ptrdiff_t chunk) {
+    chunk_offsets[static_cast<size_t>(chunk) + 1] =
+        std::count(condition_data + chunk_begin(chunk), condition_data + chunk_begin(chunk + 1), true);
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  const int64_t positive_condition_count = chunk_offsets.back();
 
   std::vector<int64_t> output_dims(input_dimensions.begin(), input_dimensions.end());
   if (has_axis_) {
@@ -68,7 +90,6 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->IsDataTypeString();
-  int64_t output_index = 0;
 
   if (has_axis_) {
     int64_t axes_left_stride = 1;
@@ -88,35 +109,49 @@ Status Compress::Compute(OpKernelContext* ctx) const {
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
+
+    // every outer row of the output holds positive_condition_count slices
+    const int64_t output_row_stride = positive_condition_count * axes_right_stride;
+    const TensorOpCost cost{static_cast<double>(output_row_stride * element_bytes),
+                            static_cast<double>(output_row_stride * element_bytes),
+                            static_cast<double>(valid_condition_length)};
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, axes_left_stride, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            int64_t output_index = i * output_row_stride;
+            for (int64_t j = 0; j < valid_condition_length; ++j) {
+              if (!condition_data[j]) {
+                continue;
+              }
+              if (is_string_type) {
+                for (int64_t idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
+                  reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
+                      reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
+                }
+              } else {
+                memcpy(output_data + output_index * element_bytes,
+                       input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes,
+                       axes_right_stride_bytes);
+              }
+              output_index += axes_right_stride;
+            }
+          }
+        });
+  } else {
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, num_chunks, [&](std::ptrdiff_t chunk) {
+      int64_t output_index = chunk_offsets[static_cast<size_t>(chunk)];
+      for (int64_t i = chunk_begin(chunk), end = chunk_begin(chunk + 1); i < end; ++i) {
+        if (!condition_data[i]) {
           continue;
         }
         if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-                reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
-          }
-          output_index += axes_right_stride;
+          reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
         } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
+          memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
         }
+        ++output_index;
       }
-    }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
-      }
-      ++output_index;
-    }
+    });
   }
 
   return Status::OK();
@@ -102,6 +102,28 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
+  if (M == 1 && !is_string_type) {
+    // Lookup of rows from a table (e.g. embeddings): each thread copies a range of indices in order and
+    // prefetches the rows of the upcoming indices.
+    const size_t row_bytes = narrow<size_t>(block_size);
+    auto row_of = [indices_data, axis_dim_limit, src_base, block_size](ptrdiff_t i) {
+      Tin idx = indices_data[i];
+      idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+      return src_base + idx * block_size;
+    };
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<ptrdiff_t>(N), TensorOpCost{static_cast<double>(block_size), static_cast<double>(block_size), 1.0},
+        [&](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t i = first; i < last; ++i) {
+            if (i + kGatherPrefetchDistance < last) {
+              PrefetchGatherRow(row_of(i + kGatherPrefetchDistance), row_bytes);
+            }
+            CopyGatherRow(dst_base + i * block_size, row_of(i), row_bytes);
+          }
+        });
+    return Status::OK();
+  }
+
   auto lambda = [&](int64_t index) {
     int64_t batch = index / N;
     int64_t i = index % N;
@@ -122,7 +144,7 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
   };
   concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
                                           [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
+                                            for (ptrdiff_t index = first; index < last; ++index) {
                                               lambda(index);
                                             }
                                           });
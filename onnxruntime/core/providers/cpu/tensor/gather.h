@@ -3,6 +3,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
@@ -10,6 +17,37 @@
 
 namespace onnxruntime {
 
+// Rows of a lookup table are prefetched this many indices ahead.
+constexpr ptrdiff_t kGatherPrefetchDistance = 8;
+
+// Asks for the first cache lines of a table row that will be read soon. The rows of a large embedding table
+// are rarely in cache and the indices are random, so the hardware prefetcher cannot guess them.
+inline void PrefetchGatherRow(const void* row, size_t row_bytes) {
+  const char* p = static_cast<const char*>(row);
+  const size_t prefetch_bytes = std::min<size_t>(row_bytes, 256);
+  for (size_t offset = 0; offset < prefetch_bytes; offset += 64) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p + offset);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(p + offset, _MM_HINT_T0);
+#else
+    ORT_UNUSED_PARAMETER(p);
+#endif
+  }
+}
+
+// Copies one gathered row. Small rows of a multiple of 16 bytes are copied with fixed size moves that the compiler
+// inlines instead of calling memcpy.
+inline void CopyGatherRow(uint8_t* dst, const uint8_t* src, size_t row_bytes) {
+  if (row_bytes <= 256 && row_bytes % 16 == 0) {
+    for (size_t offset = 0; offset < row_bytes; offset += 16) {
+      memcpy(dst + offset, src + offset, 16);
+    }
+  } else {
+    memcpy(dst, src, row_bytes);
+  }
+}
+
 class Gather : public OpKernel, public GatherBase {
  public:
   Gather(const OpKernelInfo& info) : OpKernel(info), GatherBase(info) {}
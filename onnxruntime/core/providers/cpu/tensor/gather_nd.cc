@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include <core/common/safeint.h>
 #include "gather_nd.h"
+#include "core/providers/cpu/tensor/gather.h"
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
@@ -177,15 +178,19 @@ Status GatherND::Compute(OpKernelContext* context) const {
 }
 
 Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
-  auto lambda = [&](int64_t slice_idx) {
-    memcpy(p.output_base + slice_idx * p.bytes_per_slice, p.input_base + p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx)] * p.element_bytes,
-           onnxruntime::narrow<size_t>(p.bytes_per_slice));
-  };
+  const size_t bytes_per_slice = onnxruntime::narrow<size_t>(p.bytes_per_slice);
   concurrency::ThreadPool::TryParallelFor(
-      tp, p.slice_offsets.size(), static_cast<double>(p.bytes_per_slice),
-      [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
-          lambda(slice_idx);
+      tp, p.slice_offsets.size(),
+      TensorOpCost{static_cast<double>(p.bytes_per_slice), static_cast<double>(p.bytes_per_slice), 1.0},
+      [&p, bytes_per_slice](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
+          // the slices of a lookup are scattered over the input, prefetch the upcoming ones
+          if (slice_idx + kGatherPrefetchDistance < last) {
+            PrefetchGatherRow(p.input_base + p.slice_offsets[slice_idx + kGatherPrefetchDistance] * p.element_bytes,
+                              bytes_per_slice);
+          }
+          CopyGatherRow(p.output_base + slice_idx * p.bytes_per_slice,
+                        p.input_base + p.slice_offsets[slice_idx] * p.element_bytes, bytes_per_slice);
         }
       });
   return Status::OK();
@@ -3,10 +3,12 @@
 
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <vector>
-#include <core/common/safeint.h>
-#include "core/util/math_cpuonly.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -51,6 +53,13 @@ NONZERO_TYPED_KERNEL(float)
 #undef NONZERO_9_TYPED_KERNEL
 #undef NONZERO_TYPED_KERNEL
 
+namespace {
+
+// Elements of X counted and scattered by one task, the passes are split in at most one chunk per thread.
+constexpr size_t kMinChunkSize = 16384;
+
+}  // namespace
+
 template <typename T>
 Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto X = context->Input<Tensor>(0);
@@ -59,59 +68,86 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : onnxruntime::narrow<Eigen::Index>(X_shape.NumDimensions());
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(SafeInt<size_t>(X_shape.Size()) * coordinate_size);
-
   const T* data = X->Data<T>();
 
   if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
-    }
-  } else {
-    std::vector<int64_t> coordinate(coordinate_size, 0);
-
-    // as we iterate the entries, increment the coordinate for the current entry
-    // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (Eigen::Index idx = coordinate_size - 1; idx >= 0; --idx) {
-        int64_t& cur_coord = coordinate[idx];
-        if (cur_coord != X_shape[idx] - 1) {
-          ++cur_coord;
-          break;
-        }
-        cur_coord = 0;
-      }
-    };
-
-    for (size_t i = 0, end = onnxruntime::narrow<size_t>(X_shape.Size()); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
-      }
-
-      increment_coordinate();
+    const int64_t num_non_zero_values = *data != T{} ? 1 : 0;
+    Tensor* const Y = context->Output(0, {1, num_non_zero_values});
+    ORT_ENFORCE(Y, "failed to get first output!");
+    if (num_non_zero_values != 0) {
+      Y->MutableData<int64_t>()[0] = 0;
     }
+    return Status::OK();
   }
 
-  const Eigen::Index num_non_zero_values = onnxruntime::narrow<Eigen::Index>(non_zero_indices_buffer.size()) / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
+  const size_t coordinate_size = X_shape.NumDimensions();
+  const size_t size = onnxruntime::narrow<size_t>(X_shape.Size());
+  concurrency::ThreadPool* const thread_pool = context->GetOperatorThreadPool();
+
+  // The first pass counts the non zero values of every chunk of X, the second one writes the coordinates of each
+  // chunk to the output at the offset given by the counts of the chunks before it.
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(size / kMinChunkSize,
+                          static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool))));
+  auto chunk_begin = [size, num_chunks](size_t chunk) {
+    return (size / num_chunks) * chunk + std::min(chunk, size % num_chunks);
+  };
+
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_chunks), [&](std::ptrdiff_t chunk) {
+        const size_t end = chunk_begin(static_cast<size_t>(chunk) + 1);
+        int64_t count = 0;
+        for (size_t i = chunk_begin(static_cast<size_t>(chunk)); i < end; ++i) {
+          count += data[i] != T{} ? 1 : 0;
+        }
+        chunk_offsets[static_cast<size_t>(chunk) + 1] = count;
+      });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
 
-  Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
+  const int64_t num_non_zero_values = chunk_offsets[num_chunks];
+  Tensor* const Y = context->Output(0, {static_cast<int64_t>(coordinate_size), num_non_zero_values});
   ORT_ENFORCE(Y, "failed to get first output!");
+  if (num_non_zero_values == 0) {
+    return Status::OK();
+  }
 
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+  // the output is [coordinate_size, num_non_zero_values], one row per dimension
+  int64_t* const y_data = Y->MutableData<int64_t>();
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_chunks), [&](std::ptrdiff_t chunk) {
+        const size_t begin = chunk_begin(static_cast<size_t>(chunk));
+        const size_t end = chunk_begin(static_cast<size_t>(chunk) + 1);
+
+        // coordinate of the first entry of the chunk
+        InlinedVector<int64_t> coordinate(coordinate_size, 0);
+        for (size_t idx = coordinate_size, remain = begin; idx-- > 0 && remain != 0;) {
+          const size_t dim = onnxruntime::narrow<size_t>(X_shape[idx]);
+          coordinate[idx] = static_cast<int64_t>(remain % dim);
+          remain /= dim;
+        }
+
+        int64_t* y = y_data + chunk_offsets[static_cast<size_t>(chunk)];
+        for (size_t i = begin; i < end; ++i) {
+          if (data[i] != T{}) {
+            for (size_t idx = 0; idx < coordinate_size; ++idx) {
+              y[idx * static_cast<size_t>(num_non_zero_values)] = coordinate[idx];
+            }
+            ++y;
+          }
+
+          // as we iterate the entries, increment the coordinate for the current entry
+          // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
+          for (size_t idx = coordinate_size; idx-- > 0;) {
+            int64_t& cur_coord = coordinate[idx];
+            if (cur_coord != X_shape[idx] - 1) {
+              ++cur_coord;
+              break;
+            }
+            cur_coord = 0;
+          }
+        }
+      });
 
   return Status::OK();
 }
@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "core/common/narrow.h"
+#include "core/common/safeint.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
@@ -42,7 +43,9 @@ using EnabledIndicesTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuE
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     1, 9,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
+        .MayViewOutputs(0),
     Slice1);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
@@ -50,7 +53,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10, 10,
     KernelDefBuilder()
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
-        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
+        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>())
+        .MayViewOutputs(0),
     Slice10);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
@@ -59,7 +63,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     12,
     KernelDefBuilder()
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
-        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
+        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>())
+        .MayViewOutputs(0),
     Slice10);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -67,7 +72,8 @@ ONNX_CPU_OPERATOR_KERNEL(
     13,
     KernelDefBuilder()
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
-        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
+        .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>())
+        .MayViewOutputs(0),
     Slice10);
 
 // Coalesce contiguous non-slice dimensions into a single dimension.
@@ -226,6 +232,43 @@ Status SliceBase::FillVectorsFromInput(const Tensor& start_tensor,
   return Status::OK();
 }
 
+// Moves the start of the output to the sliced region when the allocation planner made the output a view of the input,
+// which it only does for regions that are contiguous in the input.
+static Status SetSliceView(const Tensor& input_tensor, Tensor& output_tensor,
+                           const SliceOp::PrepareForComputeMetadata& compute_metadata) {
+  // the starts and steps match the coalesced dims if there are some
+  gsl::span<const int64_t> input_dims = compute_metadata.p_flattened_input_dims_
+                                            ? gsl::make_span(compute_metadata.flattened_input_dims_)
+                                            : input_tensor.Shape().GetDims();
+  gsl::span<const int64_t> output_dims = compute_metadata.p_flattened_output_dims_
+                                             ? gsl::make_span(compute_metadata.flattened_output_dims_)
+                                             : gsl::make_span(compute_metadata.output_dims_);
+  const auto& starts = compute_metadata.starts_;
+  const auto& steps = compute_metadata.steps_;
+
+  // contiguous if the dims before the first sliced one have a single element and the dims after it are complete
+  size_t axis = 0;
+  while (axis < output_dims.size() && output_dims[axis] == 1) {
+    ++axis;
+  }
+  bool contiguous = axis == output_dims.size() || steps[axis] == 1;
+  for (size_t i = axis + 1; contiguous && i < output_dims.size(); ++i) {
+    contiguous = output_dims[i] == input_dims[i] && steps[i] == 1;
+  }
+  ORT_RETURN_IF_NOT(contiguous, "Slice output with shape ", output_tensor.Shape(),
+                    " can not be a view of the input with shape ", input_tensor.Shape());
+
+  SafeInt<ptrdiff_t> offset = 0;
+  SafeInt<ptrdiff_t> pitch = 1;
+  for (size_t i = input_dims.size(); i-- > 0;) {
+    offset += pitch * starts[i];
+    pitch *= input_dims[i];
+  }
+  const ptrdiff_t byte_offset = offset * static_cast<ptrdiff_t>(input_tensor.DataType()->Size());
+  output_tensor.SetByteOffset(output_tensor.ByteOffset() + byte_offset);
+  return Status::OK();
+}
+
 template <typename T>
 static Status SliceImpl(OpKernelContext* ctx,
                         const Tensor& input_tensor,
@@ -237,6 +280,10 @@ static Status SliceImpl(OpKernelContext* ctx,
   if (output_shape.Size() == 0)
     return Status::OK();
 
+  if (output_tensor.DataRaw() == input_tensor.DataRaw()) {
+    return SetSliceView(input_tensor, output_tensor, compute_metadata);
+  }
+
   // use MutableDataRaw as actual data type in tensor may not match as we templatize on data size
   T* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
   const auto* output_end = output + output_tensor.Shape().Size();
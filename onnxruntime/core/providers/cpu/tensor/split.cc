@@ -32,8 +32,9 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     2,
     10,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>())
+        .MayViewOutputs(0),
     Split_1_13);
 
 // Opset 11 starts to support Neg Axis.
@@ -41,8 +42,9 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     11,
     12,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>())
+        .MayViewOutputs(0),
     Split_1_13);
 
 // Opset 13 starts to supports 'split' as optional input.
@@ -50,16 +52,18 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     13,
     17,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>())
+        .MayViewOutputs(0),
     Split_1_13);
 
 // TODO: support unequal split and num_outputs
 ONNX_CPU_OPERATOR_KERNEL(
     Split,
     18,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    KernelDefBuilder()
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>())
+        .MayViewOutputs(0),
     Split_18);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -159,6 +163,17 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
     output_dimensions[narrow<size_t>(axis)] = split_size;
 
     Tensor* output = context->Output(i, TensorShape{output_dimensions});
+    if (output->DataRaw() == input.DataRaw() && output->Shape().Size() != 0) {
+      // the allocation planner made the output a view of the input, which it only does when the split axis is the
+      // outermost one with more than one element
+      ORT_RETURN_IF_NOT(before_dims == 1, "Split output ", i, " can not be a view of the input with shape ",
+                        input_shape, " split on axis ", axis);
+      const ptrdiff_t byte_offset = input_offset * static_cast<ptrdiff_t>(input.DataType()->Size());
+      output->SetByteOffset(output->ByteOffset() + byte_offset);
+      input_offset += SafeInt<ptrdiff_t>(split_size) * after_dims_excluding_split;
+      continue;
+    }
+
     const auto output_strides = StridesForTensor(*output);
 
     ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
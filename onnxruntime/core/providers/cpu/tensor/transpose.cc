@@ -4,6 +4,7 @@
 #include "core/providers/cpu/tensor/transpose.h"
 
 #include <memory>
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/utils.h"
 #include "core/framework/transpose_helper.h"
@@ -367,6 +368,16 @@ static Status TransposeImpl(const gsl::span<const size_t>& permutations, const T
     return Status::OK();
   }
 
+  if (!input.IsDataTypeString()) {
+    // the MLAS transpose handles any permutation of elements of 1, 2, 4 or 8 bytes with blocked and threaded copies
+    const auto dims = shape.GetDims();
+    InlinedVector<size_t> input_dims(dims.begin(), dims.end());
+    if (MlasTransposeTensor(input.DataRaw(), output.MutableDataRaw(), input.DataType()->Size(), input_dims.size(),
+                            input_dims.data(), permutations.data(), tp)) {
+      return Status::OK();
+    }
+  }
+
   // fall back to default implementation
   return DoUntypedTranspose(permutations, input, output, input_shape_override);
 }
@@ -450,21 +461,42 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  if (!X.IsContiguous()) {
+    // transposing a strided view, e.g. a slice of a larger buffer fed by the caller, is a strided copy that reads
+    // the input with its strides permuted, so the view doesn't have to be made contiguous first.
+    const auto input_strides = X.Strides();
+    TensorShapeVector src_strides(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      src_strides[i] = input_strides[(*p_perm)[i]];
+    }
+
+    return DispatchStridedCopy<EnabledDataTypesAllOpsets>(ctx->GetOperatorThreadPool(), Y, 0, StridesForTensor(Y),
+                                                          output_shape, X, 0, src_strides);
+  }
+#endif
+
   return DoTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool());
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define TRANSPOSE_KERNEL_DEF_BUILDER() KernelDefBuilder().MayStridedInput(0)
+#else
+#define TRANSPOSE_KERNEL_DEF_BUILDER() KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    TRANSPOSE_KERNEL_DEF_BUILDER().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     13,
     20,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    TRANSPOSE_KERNEL_DEF_BUILDER().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 // Opset 21 added support for float8e4m3fnuz, float8e5m2, float8e5m2fnuz, int4 and uint4.
@@ -472,7 +504,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     21,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
+    TRANSPOSE_KERNEL_DEF_BUILDER().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
     Transpose);
 
 }  // namespace onnxruntime
@@ -2,10 +2,17 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/unique.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <core/common/safeint.h>
 #include <gsl/gsl>
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/providers/op_kernel_type_control.h"
 
@@ -298,6 +305,103 @@ static void CreateOutput(OpKernelContext& context,
   }
 }
 
+// Flattened unique of a numeric input. Every chunk of the input is counted in its own hash map in parallel, the maps
+// are merged in input order so that the first occurrences are kept, and the inverse indices are written in parallel.
+template <typename T>
+static void ComputeFlattenedParallel(OpKernelContext& context, gsl::span<const T> data, bool sorted) {
+  struct Entry {
+    int64_t first;     // index of the first occurrence
+    int64_t count;     // number of occurrences
+    int64_t position;  // index in the output
+  };
+
+  // elements scanned by one task, there is at most one chunk per thread
+  constexpr size_t kMinChunkSize = 16384;
+
+  concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
+  const size_t size = data.size();
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(size / kMinChunkSize,
+                          static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool))));
+  auto chunk_begin = [size, num_chunks](size_t chunk) {
+    return (size / num_chunks) * chunk + std::min(chunk, size % num_chunks);
+  };
+
+  std::vector<InlinedHashMap<T, Entry>> chunk_entries(num_chunks);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_chunks), [&](std::ptrdiff_t chunk) {
+        auto& entries = chunk_entries[static_cast<size_t>(chunk)];
+        for (size_t i = chunk_begin(static_cast<size_t>(chunk)), end = chunk_begin(static_cast<size_t>(chunk) + 1);
+             i < end; ++i) {
+          auto result = entries.try_emplace(data[i], Entry{static_cast<int64_t>(i), 0, 0});
+          ++result.first->second.count;
+        }
+      });
+
+  InlinedHashMap<T, Entry> entries = std::move(chunk_entries[0]);
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    for (const auto& chunk_entry : chunk_entries[chunk]) {
+      auto result = entries.try_emplace(chunk_entry.first, chunk_entry.second);
+      if (!result.second) {
+        result.first->second.count += chunk_entry.second.count;
+      }
+    }
+    InlinedHashMap<T, Entry>().swap(chunk_entries[chunk]);
+  }
+
+  // order the unique values by value or by first occurrence
+  std::vector<std::pair<T, Entry*>> unique_values;
+  unique_values.reserve(entries.size());
+  for (auto& entry : entries) {
+    unique_values.emplace_back(entry.first, &entry.second);
+  }
+  if (sorted) {
+    // NaN values are distinct, they are ordered after the other values to keep the comparison a strict weak order
+    std::sort(unique_values.begin(), unique_values.end(), [](const auto& lhs, const auto& rhs) {
+      if constexpr (std::is_floating_point<T>::value) {
+        return std::isnan(rhs.first) ? !std::isnan(lhs.first) : lhs.first < rhs.first;
+      } else {
+        return lhs.first < rhs.first;
+      }
+    });
+  } else {
+    std::sort(unique_values.begin(), unique_values.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.second->first < rhs.second->first; });
+  }
+
+  const int64_t num_unique = static_cast<int64_t>(unique_values.size());
+  Tensor& Y = *context.Output(0, {num_unique});
+  Tensor* indices_out = context.Output(1, {num_unique});
+  Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(size)});
+  Tensor* counts = context.Output(3, {num_unique});
+
+  T* Y_data = Y.MutableData<T>();
+  int64_t* indices_data = indices_out != nullptr ? indices_out->MutableData<int64_t>() : nullptr;
+  int64_t* counts_data = counts != nullptr ? counts->MutableData<int64_t>() : nullptr;
+  for (size_t i = 0; i < unique_values.size(); ++i) {
+    Entry& entry = *unique_values[i].second;
+    entry.position = static_cast<int64_t>(i);
+    Y_data[i] = unique_values[i].first;
+    if (indices_data) {
+      indices_data[i] = entry.first;
+    }
+    if (counts_data) {
+      counts_data[i] = entry.count;
+    }
+  }
+
+  if (inverse_indices) {
+    int64_t* inverse_indices_data = inverse_indices->MutableData<int64_t>();
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(num_chunks), [&](std::ptrdiff_t chunk) {
+          for (size_t i = chunk_begin(static_cast<size_t>(chunk)), end = chunk_begin(static_cast<size_t>(chunk) + 1);
+               i < end; ++i) {
+            inverse_indices_data[i] = entries.find(data[i])->second.position;
+          }
+        });
+  }
+}
+
 template <typename T>
 Status Unique::ComputeImpl(OpKernelContext& context) const {
   if (!utils::HasType<EnabledUniqueDataTypes, T>()) {
@@ -307,6 +411,13 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
   const Tensor& input = *context.Input<Tensor>(0);
   auto data = input.DataAsSpan<T>();
 
+  if constexpr (!std::is_same<T, std::string>::value) {
+    if (flatten_) {
+      ComputeFlattenedParallel<T>(context, data, sort_);
+      return Status::OK();
+    }
+  }
+
   if (flatten_) {
     std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
     std::vector<std::vector<int64_t>> indices;
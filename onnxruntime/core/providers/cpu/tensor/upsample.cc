@@ -918,45 +918,61 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
-
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+// Interpolation table of one dimension for bicubic mode. For every output position it holds the 4 input positions
+// of the grid, clamped to the input, and their coefficients.
+struct CubicTable {
+  std::vector<int64_t> indices;
+  std::vector<float> coeffs;
+  // sum of the coefficients, 1 unless exclude_outside is set
+  std::vector<float> coeff_sums;
+  // whether the output is set to the extrapolation value
+  std::vector<uint8_t> extrapolate;
+};
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
+static CubicTable SetupCubicTable(int64_t output_size, int64_t input_size, float scale, float roi_start,
+                                  float roi_end, float cubic_coeff_a, bool use_extrapolation, bool exclude_outside,
+                                  const GetOriginalCoordinateFunc& get_original_coordinate) {
+  CubicTable table;
+  table.indices.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+  table.coeffs.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+  table.coeff_sums.resize(narrow<size_t>(output_size));
+  table.extrapolate.resize(narrow<size_t>(output_size));
+
+  for (int64_t i = 0; i < output_size; ++i) {
+    const float in = scale == 1 ? static_cast<float>(i)
+                                : get_original_coordinate(static_cast<float>(i), scale,
+                                                          static_cast<float>(output_size),
+                                                          static_cast<float>(input_size),
+                                                          roi_start, roi_end);
+    // when use_extrapolation is set and original index is out of the dim range
+    // then use extrapolation_value as the output value.
+    table.extrapolate[narrow<size_t>(i)] =
+        use_extrapolation && (in < 0 || in > static_cast<float>(input_size - 1));
+
+    const auto in_int = static_cast<int64_t>(std::floor(in));
+    const auto coeffs = GetCubicCoeffs(in - in_int, cubic_coeff_a);
+    float coeff_sum = 1;
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sum = 0;
+    }
+    for (size_t j = 0; j < CubicModeGridLength; ++j) {
+      const int64_t val = in_int - 1 + static_cast<int64_t>(j);
+      float coeff = coeffs[j];
+      if (exclude_outside) {
+        coeff = (val < 0 || val >= static_cast<float>(input_size)) ? 0.0f : coeffs[j];
+        coeff_sum += coeff;
+      }
+      table.indices[narrow<size_t>(i) * CubicModeGridLength + j] =
+          std::max(static_cast<int64_t>(0), std::min(val, input_size - 1));
+      table.coeffs[narrow<size_t>(i) * CubicModeGridLength + j] = coeff;
+    }
+    table.coeff_sums[narrow<size_t>(i)] = coeff_sum;
   }
-  cache[grid_start_pos] = result;
-
-  return result;
+  return table;
 }
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 6001)
@@ -977,134 +993,81 @@ void ResizeBiCubic(int64_t batch_size,
                    gsl::span<const float> roi,
                    const T* Xdata,
                    T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
-  std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
+  const CubicTable y_table = SetupCubicTable(output_height, input_height, height_scale, roi[roi_y_start],
+                                             roi[roi_y_end], cubic_coeff_a, use_extrapolation, exclude_outside,
+                                             get_original_coordinate);
+  CubicTable x_table = SetupCubicTable(output_width, input_width, width_scale, roi[roi_x_start], roi[roi_x_end],
+                                       cubic_coeff_a, use_extrapolation, exclude_outside, get_original_coordinate);
+  // the cubic interpolation in x dimension divides every coefficient by their sum
+  for (size_t i = 0; i < x_table.coeffs.size(); ++i) {
+    x_table.coeffs[i] /= x_table.coeff_sums[i / CubicModeGridLength];
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
+  const auto width = narrow<size_t>(output_width);
+  const std::ptrdiff_t num_rows = SafeInt<std::ptrdiff_t>(batch_size) * num_channels * output_height;
+  const double cost = static_cast<double>(output_width) * CubicModeGridLength * 4;
+
+  // Every output row is computed from 4 input rows interpolated in x dimension. Consecutive output rows mostly use
+  // the same input rows, so every block of rows keeps the last 4 interpolated input rows.
+  concurrency::ThreadPool::TryParallelFor(tp, num_rows, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<float> interpolated_rows(CubicModeGridLength * width);
+    std::array<std::ptrdiff_t, CubicModeGridLength> interpolated_row_ids;
+    interpolated_row_ids.fill(-1);
+
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const auto y = narrow<size_t>(row % output_height);
+      const std::ptrdiff_t n_c = row / output_height;
+      T* const output = Ydata + row * output_width;
+
+      if (y_table.extrapolate[y]) {
+        for (size_t x = 0; x < width; ++x) {
+          output[x] = static_cast<T>(extrapolation_value);
         }
+        continue;
+      }
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
-          }
-        }
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
-
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
+      const T* const input = Xdata + n_c * input_height * input_width;
+      std::array<const float*, CubicModeGridLength> rows;
+      for (size_t i = 0; i < CubicModeGridLength; ++i) {
+        const int64_t in_y = y_table.indices[y * CubicModeGridLength + i];
+        // The 4 input rows are consecutive apart from the clamping, so that they never share a slot.
+        const std::ptrdiff_t row_id = n_c * input_height + in_y;
+        float* interpolated = interpolated_rows.data() + narrow<size_t>(row_id % CubicModeGridLength) * width;
+        if (interpolated_row_ids[narrow<size_t>(row_id % CubicModeGridLength)] != row_id) {
+          interpolated_row_ids[narrow<size_t>(row_id % CubicModeGridLength)] = row_id;
+          const T* const input_row = input + in_y * input_width;
+          for (size_t x = 0; x < width; ++x) {
+            const int64_t* x_indices = x_table.indices.data() + x * CubicModeGridLength;
+            const float* x_coeffs = x_table.coeffs.data() + x * CubicModeGridLength;
+            float result = 0;
+            for (size_t j = 0; j < CubicModeGridLength; ++j) {
+              result += x_coeffs[j] * input_row[x_indices[j]];
             }
+            interpolated[x] = result;
           }
-
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
-          }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
+        rows[i] = interpolated;
       }
 
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
+      // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
+      const float* y_coeffs = y_table.coeffs.data() + y * CubicModeGridLength;
+      const float y_coeff_sum = y_table.coeff_sums[y];
+      for (size_t x = 0; x < width; ++x) {
+        float result = 0;
+        for (size_t i = 0; i < CubicModeGridLength; ++i) {
+          result += rows[i][x] * y_coeffs[i] / y_coeff_sum;
+        }
+        output[x] = x_table.extrapolate[x] ? static_cast<T>(extrapolation_value) : static_cast<T>(result);
+      }
     }
-  }
+  });
 }
 #if defined(_MSC_VER)
 #pragma warning(pop)
@@ -1352,7 +1315,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                       extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      Y->MutableData<float>(), get_original_coordinate_,
+                      output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
       }
       return Status::OK();
     }
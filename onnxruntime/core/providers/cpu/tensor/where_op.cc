@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <type_traits>
 
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/element_wise_ops.h"  // for broadcast utilities
 
 namespace onnxruntime {
@@ -61,219 +62,75 @@ WHERE_TYPED_KERNEL_WITH_TYPE_NAME(std::string, string)
 
 namespace {
 
-template <typename T, typename R>
-using EnableIfEigenScalar = typename std::enable_if<std::is_arithmetic<T>::value, R>::type;
-
-template <typename T, typename R>
-using EnableIfEigenNotScalar = typename std::enable_if<!std::is_arithmetic<T>::value, R>::type;
-
-template <typename T>
-ProcessBroadcastSpanFuncs CreateScalarBroadcastFuncs() {
-  return ProcessBroadcastSpanFuncs{
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        bool condition = per_iter_bh.ScalarInput0<bool>();
-        auto value = per_iter_bh.EigenInput1<T>();
-        auto output = per_iter_bh.OutputEigen<T>();
-        if (condition == target) {
-          output = value;
-        } else {
-          output = EigenVectorMap<T>::PlainObject::Constant(value.size(), T{});
-        }
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        auto condition = per_iter_bh.EigenInput0<bool>();
-        const T& value = per_iter_bh.ScalarInput1<T>();
-        auto output = per_iter_bh.OutputEigen<T>();
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        auto condition = per_iter_bh.EigenInput0<bool>();
-        auto value = per_iter_bh.EigenInput1<T>();
-        auto output = per_iter_bh.OutputEigen<T>();
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      }};
-}
-
+// Selects one span of the output, a stride of 0 broadcasts the first element of the input along the span.
 template <typename T>
-ProcessBroadcastSpanFuncs CreateNonScalarBroadcastFuncs() {
-  return ProcessBroadcastSpanFuncs{
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        bool condition = per_iter_bh.ScalarInput0<bool>();
-        auto value = per_iter_bh.SpanInput1<T>();
-        auto output = per_iter_bh.OutputSpan<T>();
-        if (condition == target) {
-          std::copy(value.begin(), value.end(), output.begin());
-        } else {
-          std::fill(output.begin(), output.end(), T{});
-        }
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        auto condition = per_iter_bh.SpanInput0<bool>();
-        const T& value = per_iter_bh.ScalarInput1<T>();
-        auto output = per_iter_bh.OutputSpan<T>();
-        std::transform(condition.begin(), condition.end(), output.begin(),
-                       [target, &value](bool condition_element) {
-                         return condition_element == target ? value : T{};
-                       });
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        bool target = (per_iter_bh.GetUserData() != nullptr);
-        auto condition = per_iter_bh.SpanInput0<bool>();
-        auto value = per_iter_bh.SpanInput1<T>();
-        auto output = per_iter_bh.OutputSpan<T>();
-        std::transform(condition.begin(), condition.end(), value.begin(), output.begin(),
-                       [target](bool condition_element, const T& value_element) {
-                         return condition_element == target ? value_element : T{};
-                       });
-      }};
-}
-
-template <typename T>
-EnableIfEigenScalar<T, ProcessBroadcastSpanFuncs> SelectBroadcastFuncs() {
-  // NOTE: Workaround a VS2017 bug by calling a separate function to create the broadcast funcs.
-  // If we create them directly here it doesn't bring in the definitions of the Eigen classes leading to
-  // a 'class has no constructors' error
-  return CreateScalarBroadcastFuncs<T>();
-}
-
-template <typename T>
-EnableIfEigenNotScalar<T, ProcessBroadcastSpanFuncs> SelectBroadcastFuncs() {
-  return CreateNonScalarBroadcastFuncs<T>();
-}
-
-template <typename T>
-void MergeScalarAndVector(EigenVectorMap<T> output, const T& scalar_value, ConstEigenVectorMap<T> vector_value) {
-  if (scalar_value != T{}) {
-    output = EigenVectorMap<T>::PlainObject::Constant(vector_value.size(), scalar_value);
-  } else {
-    output = vector_value;
+void WhereSpan(const bool* condition, size_t condition_stride, const T* X, size_t X_stride, const T* Y,
+               size_t Y_stride, T* output, size_t count) {
+  if (condition_stride == 0) {
+    const T* values = *condition ? X : Y;
+    if ((*condition ? X_stride : Y_stride) == 0) {
+      std::fill_n(output, count, *values);
+    } else {
+      std::copy_n(values, count, output);
+    }
+    return;
   }
-};
-
-template <typename T>
-EnableIfEigenScalar<T, ProcessBroadcastSpanFuncs> MergeBroadcastFuncs() {
-  return ProcessBroadcastSpanFuncs{
-      [](BroadcastHelper& per_iter_bh) {
-        MergeScalarAndVector(per_iter_bh.OutputEigen<T>(),
-                             per_iter_bh.ScalarInput0<T>(),  // X selection
-                             per_iter_bh.EigenInput1<T>());  // Y selection
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        MergeScalarAndVector(per_iter_bh.OutputEigen<T>(),
-                             per_iter_bh.ScalarInput1<T>(),  // Y selection
-                             per_iter_bh.EigenInput0<T>());  // X selection
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto X_selection = per_iter_bh.EigenInput0<T>();
-        auto Y_selection = per_iter_bh.EigenInput1<T>();
-        per_iter_bh.OutputEigen<T>() = X_selection.binaryExpr(Y_selection,
-                                                              [](T x, T y) -> T {
-                                                                return x != T{} ? x : y;
-                                                              });
-      }};
-}
 
-template <typename T>
-void MergeScalarAndVector(gsl::span<T> output, const T& scalar_value, gsl::span<const T> vector_value) {
-  if (!scalar_value.empty()) {
-    std::fill(output.begin(), output.end(), scalar_value);
-  } else {
-    std::copy(vector_value.begin(), vector_value.end(), output.begin());
+  if constexpr (std::is_arithmetic<T>::value) {
+    if (X_stride == 1 && Y_stride == 1) {
+      // both values are loaded so that the selection is vectorized
+      for (size_t i = 0; i < count; ++i) {
+        const T x = X[i];
+        const T y = Y[i];
+        output[i] = condition[i] ? x : y;
+      }
+      return;
+    }
   }
-};
-
-template <typename T>
-EnableIfEigenNotScalar<T, ProcessBroadcastSpanFuncs> MergeBroadcastFuncs() {
-  return ProcessBroadcastSpanFuncs{
-      [](BroadcastHelper& per_iter_bh) {
-        MergeScalarAndVector(per_iter_bh.OutputSpan<T>(),
-                             per_iter_bh.ScalarInput0<T>(),  // X selection
-                             per_iter_bh.SpanInput1<T>());   // Y selection
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        MergeScalarAndVector(per_iter_bh.OutputSpan<T>(),
-                             per_iter_bh.ScalarInput1<T>(),  // Y selection
-                             per_iter_bh.SpanInput0<T>());   // X selection
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto X_selection = per_iter_bh.SpanInput0<T>();
-        auto Y_selection = per_iter_bh.SpanInput1<T>();
-        auto output = per_iter_bh.OutputSpan<T>();
-        std::transform(X_selection.begin(), X_selection.end(), Y_selection.begin(), output.begin(),
-                       [](const T& x, const T& y) { return !x.empty() ? x : y; });
-      }};
-}
-
-// function pointer to create typed tensor from type agnostic code whilst avoiding the overhead of std::function
-using AllocTensorFunc = std::unique_ptr<Tensor> (*)(const TensorAllocator& allocator, const TensorShape& shape);
-
-static std::unique_ptr<Tensor> UntypedSelect(OpKernelContext& context, bool target,
-                                             const TensorAllocator& allocator, AllocTensorFunc allocate_tensor,
-                                             const ProcessBroadcastSpanFuncs& functors) {
-  const auto& condition = *context.Input<Tensor>(0);
-  // select the X input (input 1) for 'true', and Y input (input 2) for 'false'
-  const auto& values = *context.Input<Tensor>(target ? 1 : 2);
-
-  InputBroadcaster input_broadcaster(condition, values);
-
-  std::unique_ptr<Tensor> selection_tensor = allocate_tensor(allocator, input_broadcaster.GetOutputShape());
-  OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *selection_tensor);
-
-  // store value of 'target' directly in void* for user_data so it's accessible in the state-less functors
-  BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, reinterpret_cast<void*>(target));
 
-  BroadcastLooper(broadcast_helper, functors);
-
-  return selection_tensor;
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = condition[i] ? X[i * X_stride] : Y[i * Y_stride];
+  }
 }
 
-static void UntypedMerge(OpKernelContext& context,
-                         const Tensor& X_selection_tensor, const Tensor& Y_selection_tensor,
-                         const ProcessBroadcastSpanFuncs& functors) {
-  InputBroadcaster merge_broadcaster{X_selection_tensor, Y_selection_tensor};
-  Tensor& output = *context.Output(0, merge_broadcaster.GetOutputShape());
-
-  OutputBroadcaster output_broadcaster{merge_broadcaster.GetSpanSize(), output};
-  BroadcastHelper broadcast_helper(merge_broadcaster, output_broadcaster);
-
-  BroadcastLooper(broadcast_helper, functors);
-}
 }  // namespace
 
 template <typename T>
 Status Where<T>::Compute(OpKernelContext* context) const {
-  // we use a func pointer to save the overhead of std::function, so we can't capture tensor_allocator here
-  const auto typed_tensor_allocation = [](const TensorAllocator& allocator,
-                                          const TensorShape& shape) {
-    return allocator.Allocate<T>(shape);
-  };
-
-  TensorAllocator tensor_allocator{*context};
-  ProcessBroadcastSpanFuncs funcs = SelectBroadcastFuncs<T>();
-
-  // The current implementation is limited to broadcasting over two tensors at once.
-  // So, we first broadcast over condition and X to select the values from X:
-  //   X_selection = condition ? X : default value
-  // Similarly, we broadcast over condition and Y to select the values from Y:
-  //   Y_selection = !condition ? Y : default value
-  //
-  // These selections are handled within UntypedSelect.
-  //
-  // Finally, we broadcast over and merge X_selection and Y_selection:
-  //   output = (X_selection != default value) ? X_selection : Y_selection
-  //
-  // The merging is handled within UntypedMerge.
-  auto X_selection_tensor = UntypedSelect(*context, true, tensor_allocator, typed_tensor_allocation, funcs);
-  auto Y_selection_tensor = UntypedSelect(*context, false, tensor_allocator, typed_tensor_allocation, funcs);
+  const auto& condition = *context->Input<Tensor>(0);
+  const auto& X = *context->Input<Tensor>(1);
+  const auto& Y = *context->Input<Tensor>(2);
+
+  // The three inputs are broadcast together so that the output is written in a single pass.
+  MultiBroadcaster<3> broadcaster({condition.Shape().GetDims(), X.Shape().GetDims(), Y.Shape().GetDims()});
+  Tensor& output = *context->Output(0, broadcaster.GetOutputShape());
+  if (output.Shape().Size() == 0) {
+    return Status::OK();
+  }
 
-  UntypedMerge(*context, *X_selection_tensor, *Y_selection_tensor, MergeBroadcastFuncs<T>());
+  const bool* condition_data = condition.Data<bool>();
+  const T* X_data = X.Data<T>();
+  const T* Y_data = Y.Data<T>();
+  T* output_data = output.MutableData<T>();
+
+  const size_t span_size = broadcaster.GetSpanSize();
+  const size_t condition_stride = broadcaster.SpanStride(0);
+  const size_t X_stride = broadcaster.SpanStride(1);
+  const size_t Y_stride = broadcaster.SpanStride(2);
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(broadcaster.NumSpans()),
+      TensorOpCost{static_cast<double>(span_size * (sizeof(bool) + 2 * sizeof(T))),
+                   static_cast<double>(span_size * sizeof(T)),
+                   static_cast<double>(span_size)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        broadcaster.ForEachSpan(
+            static_cast<size_t>(first), static_cast<size_t>(last),
+            [&](const MultiBroadcaster<3>::Offsets& offsets, size_t output_offset) {
+              WhereSpan(condition_data + offsets[0], condition_stride, X_data + offsets[1], X_stride,
+                        Y_data + offsets[2], Y_stride, output_data + output_offset, span_size);
+            });
+      });
 
   return Status::OK();
 }
@@ -3,6 +3,7 @@
 
 #include "regex_full_match.h"
 #include "core/common/common.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
@@ -13,8 +14,14 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<bool>()),
     RegexFullMatch);
 
+namespace {
+// Length of the bounds computed for the prefilter, longer bounds reject more inputs but cost more to compare.
+constexpr int kMatchRangeMaxLength = 16;
+}  // namespace
+
 RegexFullMatch::RegexFullMatch(const OpKernelInfo& info) : OpKernel(info), re_{info.GetAttr<std::string>("pattern")} {
   ORT_ENFORCE(re_.ok(), "Invalid regex pattern: ", re_.pattern());
+  has_match_range_ = re_.PossibleMatchRange(&match_min_, &match_max_, kMatchRangeMaxLength);
 }
 
 Status RegexFullMatch::Compute(OpKernelContext* context) const {
@@ -22,13 +29,30 @@ Status RegexFullMatch::Compute(OpKernelContext* context) const {
   const auto input_data = input_tensor->template DataAsSpan<std::string>();
   auto* output_tensor = context->Output(0, input_tensor->Shape());
   auto output_data = output_tensor->template MutableDataAsSpan<bool>();
-  auto output_iter = output_data.begin();
-  auto input_iter = input_data.begin();
-  while (input_iter != input_data.end()) {
-    *output_iter = RE2::FullMatch(*input_iter, re_);
-    input_iter++;
-    output_iter++;
+  if (input_data.empty()) {
+    return Status::OK();
+  }
+
+  size_t total_length = 0;
+  for (const auto& str : input_data) {
+    total_length += str.size();
   }
+  const double average_length = static_cast<double>(total_length) / static_cast<double>(input_data.size());
+
+  // RE2 objects are thread safe, the elements are matched in parallel.
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(input_data.size()),
+      TensorOpCost{average_length, 1.0, 10.0 * average_length},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const std::string& str = input_data[static_cast<size_t>(i)];
+          if (has_match_range_ && (str < match_min_ || str > match_max_)) {
+            output_data[static_cast<size_t>(i)] = false;
+          } else {
+            output_data[static_cast<size_t>(i)] = RE2::FullMatch(str, re_);
+          }
+        }
+      });
   return Status::OK();
 }
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "core/framework/op_kernel.h"
 #include "re2/re2.h"
 
@@ -15,6 +17,10 @@ class RegexFullMatch final : public OpKernel {
 
  private:
   RE2 re_;
+  // Every full match lies between these strings, inputs outside the range are rejected without running the regex.
+  bool has_match_range_ = false;
+  std::string match_min_;
+  std::string match_max_;
 };
 
 }  // namespace onnxruntime
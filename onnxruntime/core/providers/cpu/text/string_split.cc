@@ -69,14 +69,15 @@ Status StringSplit::Compute(OpKernelContext* context) const {
   auto num_tokens_data = context->Output(1, input->Shape())->template MutableDataAsSpan<int64_t>();
   auto num_tokens_iter = num_tokens_data.begin();
 
-  InlinedVector<InlinedVector<std::string_view>> input_slices;
+  // The substrings of all the elements are stored back to back, the token counts delimit them.
+  InlinedVector<std::string_view> input_slices;
   input_slices.reserve(input_data.size());
   size_t last_dim = 0;
 
   for (const auto& s : input_data) {
-    auto& substrs = input_slices.emplace_back();
-    ComputeSubstrings(s, delimiter_, maxsplit_, substrs);
-    auto substr_count = substrs.size();
+    auto prev_count = input_slices.size();
+    ComputeSubstrings(s, delimiter_, maxsplit_, input_slices);
+    auto substr_count = input_slices.size() - prev_count;
     last_dim = std::max(last_dim, substr_count);
     *num_tokens_iter = static_cast<int64_t>(substr_count);
     ++num_tokens_iter;
@@ -88,8 +89,11 @@ Status StringSplit::Compute(OpKernelContext* context) const {
 
   auto splits_data = context->Output(0, splits_shape)->template MutableDataAsSpan<std::string>();
   auto slices_iter = input_slices.begin();
-  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++slices_iter) {
-    std::copy(slices_iter->begin(), slices_iter->end(), output_splits_iter);
+  num_tokens_iter = num_tokens_data.begin();
+  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++num_tokens_iter) {
+    for (int64_t i = 0; i < *num_tokens_iter; ++i, ++slices_iter) {
+      output_splits_iter[i].assign(slices_iter->data(), slices_iter->size());
+    }
   }
 
   return Status::OK();
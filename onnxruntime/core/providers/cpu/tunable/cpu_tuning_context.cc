@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/tuning_context.h"
+#define TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context_impl.h"
+#undef TUNING_CONTEXT_IMPL
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// The fastest kernel depends on the vector extensions and the number of cores of the CPU, so the tuning results
+// are only reused on a machine with the same features.
+std::string CpuTuningResultsValidator::GetCpuIsa() const {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream oss;
+  oss << "SSE3=" << cpuid_info.HasSSE3() << "|"
+      << "SSE4_1=" << cpuid_info.HasSSE4_1() << "|"
+      << "AVX=" << cpuid_info.HasAVX() << "|"
+      << "AVX2=" << cpuid_info.HasAVX2() << "|"
+      << "AVX512F=" << cpuid_info.HasAVX512f() << "|"
+      << "AVX512_SKYLAKE=" << cpuid_info.HasAVX512Skylake() << "|"
+      << "AMX_BF16=" << cpuid_info.HasAMX_BF16() << "|"
+      << "ARM_NEON_DOT=" << cpuid_info.HasArmNeonDot() << "|"
+      << "ARM_NEON_I8MM=" << cpuid_info.HasArmNeon_I8MM() << "|"
+      << "ARM_SVE=" << cpuid_info.HasArmSVE() << "|"
+      << "FP16_VECTOR=" << cpuid_info.HasFp16VectorAcceleration() << "|"
+      << "HYBRID=" << cpuid_info.IsHybrid() << "|";
+  return oss.str();
+}
+
+Status CpuTuningResultsValidator::ValidateCpuIsa(const std::string& value) const {
+  auto current = GetCpuIsa();
+  ORT_RETURN_IF(current != value, "CPU features mismatch: tuning results produced with CPU ", value,
+                ", onnxruntime currently run with CPU ", current);
+  return Status::OK();
+}
+
+std::string CpuTuningResultsValidator::GetCpuCoreCount() const {
+  return std::to_string(std::thread::hardware_concurrency());
+}
+
+Status CpuTuningResultsValidator::ValidateCpuCoreCount(const std::string& value) const {
+  auto current = GetCpuCoreCount();
+  ORT_RETURN_IF(current != value, "CPU core count mismatch: tuning results produced with ", value,
+                " cores, onnxruntime currently run with ", current, " cores");
+  return Status::OK();
+}
+
+CpuTuningResultsValidator::CpuTuningResultsValidator() {
+  RegisterValidator(
+      "CPU_ISA",
+      [this]() { return GetCpuIsa(); },
+      [this](const std::string& value) { return ValidateCpuIsa(value); });
+  RegisterValidator(
+      "CPU_CORE_COUNT",
+      [this]() { return GetCpuCoreCount(); },
+      [this](const std::string& value) { return ValidateCpuCoreCount(value); });
+}
+
+CpuTuningContext::CpuTuningContext(IExecutionProvider* ep, TunableOpInfo* info)
+    : ITuningContext(ep), info_(info) {}
+
+void CpuTuningContext::EnableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp for CPU Execution Provider";
+  info_->enable = true;
+}
+
+void CpuTuningContext::DisableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp for CPU Execution Provider";
+  info_->enable = false;
+}
+
+bool CpuTuningContext::IsTunableOpEnabled() const {
+  return info_->enable;
+}
+
+void CpuTuningContext::EnableTuning() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = true;
+}
+
+void CpuTuningContext::DisableTuning() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = false;
+}
+
+bool CpuTuningContext::IsTuningEnabled() const {
+  return info_->tuning_enable;
+}
+
+void CpuTuningContext::SetMaxTuningDurationMs(int max_duration_ms) {
+  info_->max_tuning_duration_ms = max_duration_ms;
+}
+
+int CpuTuningContext::GetMaxTuningDurationMs() const {
+  return info_->max_tuning_duration_ms > 0 ? info_->max_tuning_duration_ms : std::numeric_limits<int>::max();
+}
+
+TuningResultsManager& CpuTuningContext::GetTuningResultsManager() {
+  return manager_;
+}
+
+const TuningResultsManager& CpuTuningContext::GetTuningResultsManager() const {
+  return manager_;
+}
+
+const TuningResultsValidator& CpuTuningContext::GetTuningResultsValidator() const {
+  return validator_;
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
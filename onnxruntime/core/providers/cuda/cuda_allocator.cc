@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "cuda_allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
 #include "cuda_common.h"
 #include "gpu_data_transfer.h"
 
@@ -55,6 +60,261 @@ void CUDAAllocator::Free(void* p) {
   cudaFree(p);         // do not throw error since it's OK for cudaFree to fail during shutdown
 }
 
+CUDADeviceMemoryBudget& CUDADeviceMemoryBudget::Get(OrtDevice::DeviceId device_id) {
+  // The budgets are never destroyed, allocators may still be freeing memory during shutdown.
+  static OrtMutex budgets_lock;
+  static auto* budgets = new InlinedHashMap<OrtDevice::DeviceId, std::unique_ptr<CUDADeviceMemoryBudget>>();
+  std::lock_guard<OrtMutex> lock(budgets_lock);
+  auto& budget = (*budgets)[device_id];
+  if (!budget) {
+    budget = std::make_unique<CUDADeviceMemoryBudget>();
+  }
+  return *budget;
+}
+
+void CUDADeviceMemoryBudget::AddLimit(size_t limit) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  limits_.insert(limit);
+  limit_ = *limits_.begin();
+}
+
+void CUDADeviceMemoryBudget::RemoveLimit(size_t limit) {
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = limits_.find(limit);
+    if (it != limits_.end()) {
+      limits_.erase(it);
+    }
+    limit_ = limits_.empty() ? 0 : *limits_.begin();
+  }
+  // A larger budget may let waiting allocations through.
+  released_.notify_all();
+}
+
+bool CUDADeviceMemoryBudget::Acquire(size_t size, int wait_ms) {
+  std::unique_lock<OrtMutex> lock(lock_);
+  const auto fits = [this, size]() { return limit_ == 0 || (size <= limit_ && in_use_ <= limit_ - size); };
+  if (!fits()) {
+    bool available = false;
+    if (wait_ms > 0 && size <= limit_) {
+      ++num_waits_;
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait_ms);
+      do {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+          break;
+        }
+        released_.wait_for(lock, deadline - now);
+        available = fits();
+      } while (!available);
+    }
+    if (!available) {
+      ++num_failures_;
+      return false;
+    }
+  }
+
+  in_use_ += size;
+  ++num_allocs_;
+  max_in_use_ = std::max(max_in_use_, in_use_);
+  max_alloc_size_ = std::max(max_alloc_size_, size);
+  return true;
+}
+
+void CUDADeviceMemoryBudget::Release(size_t size) {
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    in_use_ -= std::min(size, in_use_);
+  }
+  released_.notify_all();
+}
+
+void CUDADeviceMemoryBudget::GetStats(AllocatorStats* stats) const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  stats->num_allocs = num_allocs_;
+  stats->bytes_in_use = static_cast<int64_t>(in_use_);
+  stats->total_allocated_bytes = static_cast<int64_t>(in_use_);
+  stats->max_bytes_in_use = static_cast<int64_t>(max_in_use_);
+  stats->max_alloc_size = static_cast<int64_t>(max_alloc_size_);
+  stats->bytes_limit = static_cast<int64_t>(limit_);
+  // The arena fields have no meaning here, they report how often allocations had to wait for and were refused memory.
+  stats->num_arena_extensions = num_waits_;
+  stats->num_arena_shrinkages = num_failures_;
+}
+
+CUDADeviceBudgetAllocator::CUDADeviceBudgetAllocator(OrtDevice::DeviceId device_id, const char* name,
+                                                     size_t device_mem_limit, int device_mem_wait_ms)
+    : CUDAAllocator(device_id, name),
+      budget_(CUDADeviceMemoryBudget::Get(device_id)),
+      limit_(device_mem_limit),
+      wait_ms_(device_mem_wait_ms) {
+  budget_.AddLimit(limit_);
+}
+
+CUDADeviceBudgetAllocator::~CUDADeviceBudgetAllocator() {
+  budget_.RemoveLimit(limit_);
+}
+
+void* CUDADeviceBudgetAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  if (!budget_.Acquire(size, wait_ms_)) {
+    AllocatorStats stats;
+    budget_.GetStats(&stats);
+    ORT_THROW("Allocating ", size, " bytes exceeds the device memory budget of device ", Info().id, ": ",
+              stats.bytes_in_use, " of ", stats.bytes_limit, " bytes are in use by the sessions on the device.");
+  }
+
+  SetDevice(true);
+  CheckDevice(true);
+  void* p = nullptr;
+  auto cuda_err = cudaMalloc(&p, size);
+  if (cuda_err != cudaSuccess) {
+    budget_.Release(size);
+    CUDA_CALL_THROW(cuda_err);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  sizes_[p] = size;
+  return p;
+}
+
+void CUDADeviceBudgetAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  size_t size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = sizes_.find(p);
+    if (it != sizes_.end()) {
+      size = it->second;
+      sizes_.erase(it);
+    }
+  }
+
+  CUDAAllocator::Free(p);
+  budget_.Release(size);
+}
+
+void CUDADeviceBudgetAllocator::GetStats(AllocatorStats* stats) {
+  budget_.GetStats(stats);
+}
+
+CUDAMempoolAllocator::CUDAMempoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold)
+    : CUDAAllocator(device_id, name) {
+  SetDevice(true);
+  cudaMemPool_t pool;
+  CUDA_CALL_THROW(cudaDeviceGetDefaultMemPool(&pool, device_id));
+
+  // The pool is shared by the whole process, so never lower a threshold another session asked for.
+  uint64_t threshold = 0;
+  CUDA_CALL_THROW(cudaMemPoolGetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+  if (threshold < static_cast<uint64_t>(release_threshold)) {
+    threshold = static_cast<uint64_t>(release_threshold);
+    CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+  }
+  pool_ = pool;
+}
+
+void* CUDAMempoolAllocator::AllocFromPool(size_t size, void* stream_handle) {
+  auto pool = static_cast<cudaMemPool_t>(pool_);
+  auto stream = static_cast<cudaStream_t>(stream_handle);
+  void* p = nullptr;
+  auto cuda_err = cudaMallocFromPoolAsync(&p, size, pool, stream);
+  if (cuda_err == cudaErrorMemoryAllocation) {
+    // Hand the memory cached by the pool back to the driver once all pending frees completed, and retry.
+    ORT_IGNORE_RETURN_VALUE(cudaGetLastError());
+    CUDA_CALL_THROW(cudaDeviceSynchronize());
+    CUDA_CALL_THROW(cudaMemPoolTrimTo(pool, 0));
+    cuda_err = cudaMallocFromPoolAsync(&p, size, pool, stream);
+  }
+  CUDA_CALL_THROW(cuda_err);
+  return p;
+}
+
+void* CUDAMempoolAllocator::Alloc(size_t size) {
+  SetDevice(true);
+  CheckDevice(true);
+  void* p = nullptr;
+  if (size > 0) {
+    // Without a stream the memory has to be usable from any stream once returned.
+    p = AllocFromPool(size, nullptr);
+    CUDA_CALL_THROW(cudaStreamSynchronize(nullptr));
+  }
+  return p;
+}
+
+void* CUDAMempoolAllocator::AllocOnStream(size_t size, Stream* stream, WaitNotificationFn /*wait_fn*/) {
+  void* stream_handle = stream ? stream->GetHandle() : nullptr;
+  if (stream_handle == nullptr) {
+    return Alloc(size);
+  }
+
+  SetDevice(true);
+  CheckDevice(true);
+  void* p = nullptr;
+  if (size > 0) {
+    p = AllocFromPool(size, stream_handle);
+    std::lock_guard<OrtMutex> lock(lock_);
+    alloc_streams_[p] = stream_handle;
+  }
+  return p;
+}
+
+void CUDAMempoolAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  void* stream_handle = nullptr;
+  bool on_stream = false;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = alloc_streams_.find(p);
+    if (it != alloc_streams_.end()) {
+      stream_handle = it->second;
+      on_stream = true;
+      alloc_streams_.erase(it);
+    }
+  }
+
+  SetDevice(false);
+  CheckDevice(false);
+  // do not throw error since it's OK for the free to fail during shutdown
+  if (on_stream) {
+    cudaFreeAsync(p, static_cast<cudaStream_t>(stream_handle));
+  } else {
+    // cudaFree synchronizes the device before returning memory of the pool, as the stream it was used on is unknown.
+    cudaFree(p);
+  }
+}
+
+void CUDAMempoolAllocator::ReleaseStreamBuffers(Stream* stream) {
+  void* stream_handle = stream ? stream->GetHandle() : nullptr;
+  if (stream_handle == nullptr) {
+    return;
+  }
+
+  // Memory that outlives the stream, e.g. graph outputs, is freed on the legacy default stream once the work
+  // queued on the stream completed.
+  std::lock_guard<OrtMutex> lock(lock_);
+  bool synchronized = false;
+  for (auto& alloc_stream : alloc_streams_) {
+    if (alloc_stream.second == stream_handle) {
+      if (!synchronized) {
+        SetDevice(false);
+        cudaStreamSynchronize(static_cast<cudaStream_t>(stream_handle));
+        synchronized = true;
+      }
+      alloc_stream.second = cudaStreamLegacy;
+    }
+  }
+}
+
 void* CUDAExternalAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <set>
+
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/platform/ort_mutex.h"
@@ -19,11 +21,88 @@ class CUDAAllocator : public IAllocator {
   void* Alloc(size_t size) override;
   void Free(void* p) override;
 
- private:
+ protected:
   void CheckDevice(bool throw_when_fail) const;
   void SetDevice(bool throw_when_fail) const;
 };
 
+// Device memory budget shared by every CUDADeviceBudgetAllocator of a device, i.e. by all the sessions of the process
+// that run on it. The budget is the smallest limit of the allocators alive. An allocation that does not fit in the
+// budget waits for other sessions to free memory instead of failing right away.
+class CUDADeviceMemoryBudget {
+ public:
+  static CUDADeviceMemoryBudget& Get(OrtDevice::DeviceId device_id);
+
+  void AddLimit(size_t limit);
+  void RemoveLimit(size_t limit);
+
+  // Accounts size bytes against the budget, waiting up to wait_ms milliseconds for them to become available.
+  // Returns false if they did not.
+  bool Acquire(size_t size, int wait_ms);
+  void Release(size_t size);
+
+  void GetStats(AllocatorStats* stats) const;
+
+ private:
+  mutable OrtMutex lock_;
+  OrtCondVar released_;
+  std::multiset<size_t> limits_;
+  size_t limit_{0};  // 0 if there is no limit
+  size_t in_use_{0};
+  size_t max_in_use_{0};
+  size_t max_alloc_size_{0};
+  int64_t num_allocs_{0};
+  int64_t num_waits_{0};
+  int64_t num_failures_{0};
+};
+
+// CUDAAllocator whose allocations are accounted against the CUDADeviceMemoryBudget of the device.
+// An allocation that cannot be accounted throws, like a failed cudaMalloc, so the arena on top of it can retry with
+// a smaller extension.
+class CUDADeviceBudgetAllocator : public CUDAAllocator {
+ public:
+  CUDADeviceBudgetAllocator(OrtDevice::DeviceId device_id, const char* name, size_t device_mem_limit,
+                            int device_mem_wait_ms);
+  ~CUDADeviceBudgetAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  // Reports the memory in use by all the sessions on the device and the budget.
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  CUDADeviceMemoryBudget& budget_;
+  const size_t limit_;
+  const int wait_ms_;
+  OrtMutex lock_;
+  InlinedHashMap<void*, size_t> sizes_;
+};
+
+// Allocates from the default CUDA memory pool of the device with cudaMallocFromPoolAsync and frees with
+// cudaFreeAsync on the stream the memory was allocated on, so every stream and session using the device shares
+// the pool and the driver reclaims memory above the release threshold at each synchronization.
+// No arena should be put on top of it.
+class CUDAMempoolAllocator : public CUDAAllocator {
+ public:
+  CUDAMempoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  bool IsStreamAware() const override { return true; }
+  void* AllocOnStream(size_t size, Stream* stream, WaitNotificationFn wait_fn) override;
+  void ReleaseStreamBuffers(Stream* stream) override;
+
+ private:
+  void* AllocFromPool(size_t size, void* stream_handle);
+
+  void* pool_;
+  mutable OrtMutex lock_;
+  // stream of each allocation made by AllocOnStream, which is where it has to be freed.
+  InlinedHashMap<void*, void*> alloc_streams_;
+};
+
 class CUDAExternalAllocator : public CUDAAllocator {
   typedef void* (*ExternalAlloc)(size_t size);
   typedef void (*ExternalFree)(void* p);
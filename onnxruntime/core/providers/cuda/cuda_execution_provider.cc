@@ -137,7 +137,9 @@ AllocatorPtr CUDAExecutionProvider::CreateCudaAllocator(OrtDevice::DeviceId devi
                                                         size_t gpu_mem_limit,
                                                         ArenaExtendStrategy arena_extend_strategy,
                                                         CUDAExecutionProviderExternalAllocatorInfo external_allocator_info,
-                                                        const OrtArenaCfg* default_memory_arena_cfg) {
+                                                        const OrtArenaCfg* default_memory_arena_cfg,
+                                                        size_t device_mem_limit,
+                                                        int device_mem_wait_ms) {
   if (external_allocator_info.UseExternalAllocator()) {
     AllocatorCreationInfo default_memory_info(
         [external_allocator_info](OrtDevice::DeviceId id) {
@@ -152,7 +154,10 @@ AllocatorPtr CUDAExecutionProvider::CreateCudaAllocator(OrtDevice::DeviceId devi
     return CreateAllocator(default_memory_info);
   } else {
     AllocatorCreationInfo default_memory_info(
-        [](OrtDevice::DeviceId id) {
+        [device_mem_limit, device_mem_wait_ms](OrtDevice::DeviceId id) -> std::unique_ptr<IAllocator> {
+          if (device_mem_limit > 0) {
+            return std::make_unique<CUDADeviceBudgetAllocator>(id, CUDA, device_mem_limit, device_mem_wait_ms);
+          }
           return std::make_unique<CUDAAllocator>(id, CUDA);
         },
         device_id,
@@ -240,6 +245,12 @@ Status CUDAExecutionProvider::PerThreadContext::ReplayGraph(CudaGraphAnnotation_
   return cuda_graph_.Replay(graph_annotation_id);
 }
 
+void CUDAExecutionProvider::PerThreadContext::ReleaseGraph(CudaGraphAnnotation_t graph_annotation_id) {
+  cuda_graph_.Release(graph_annotation_id);
+  // the regular runs needed before the capture start over when the annotation id is captured again.
+  graph_id_to_run_count_.erase(graph_annotation_id);
+}
+
 void CUDAExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture(
     CudaGraphAnnotation_t cuda_graph_annotation_id) {
   if (graph_id_to_run_count_.find(cuda_graph_annotation_id) == graph_id_to_run_count_.end()) {
@@ -476,6 +487,11 @@ Status CUDAExecutionProvider::ReplayGraph(int graph_annotation_id) {
   return GetPerThreadContext().ReplayGraph(graph_annotation_id);
 }
 
+Status CUDAExecutionProvider::ReleaseGraph(int graph_annotation_id) {
+  GetPerThreadContext().ReleaseGraph(graph_annotation_id);
+  return Status::OK();
+}
+
 namespace cuda {
 // opset 1 to 9
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
@@ -2625,9 +2641,25 @@ std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
       // correct to use the GPU device id, unless we wanted to share the pinned memory allocator across devices,
       // at the risk the lifetime isn't managed correctly if one of those devices go away.
       0);
+  AllocatorPtr cuda_allocator;
+  if (info_.use_cuda_mempool && !info_.external_allocator_info.UseExternalAllocator()) {
+    ORT_ENFORCE(!info_.enable_cuda_graph, "use_cuda_mempool cannot be combined with enable_cuda_graph.");
+    // The memory pool already caches and reuses memory per stream, so it is not wrapped in an arena.
+    AllocatorCreationInfo mempool_memory_info(
+        [release_threshold = info_.cuda_mempool_release_threshold](OrtDevice::DeviceId id) {
+          return std::make_unique<CUDAMempoolAllocator>(id, CUDA, release_threshold);
+        },
+        info_.device_id,
+        false);
+    cuda_allocator = CreateAllocator(mempool_memory_info);
+  } else {
+    cuda_allocator = CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
+                                         info_.external_allocator_info, info_.default_memory_arena_cfg,
+                                         info_.device_mem_limit, info_.device_mem_wait_ms);
+  }
+
   return std::vector<AllocatorPtr>{
-      CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
-                          info_.external_allocator_info, info_.default_memory_arena_cfg),
+      cuda_allocator,
       CreateAllocator(pinned_memory_info),
   };
 }
@@ -36,6 +36,11 @@ constexpr const char* kUseEPLevelUnifiedStream = "use_ep_level_unified_stream";
 constexpr const char* kUseTF32 = "use_tf32";
 constexpr const char* kFuseConvBias = "fuse_conv_bias";
 constexpr const char* kSdpaKernel = "sdpa_kernel";
+constexpr const char* kUseCudaMempool = "use_cuda_mempool";
+constexpr const char* kCudaMempoolReleaseThreshold = "cuda_mempool_release_threshold";
+constexpr const char* kPinnedStagingBufferSize = "pinned_staging_buffer_size";
+constexpr const char* kDeviceMemLimit = "device_mem_limit";
+constexpr const char* kDeviceMemWaitMs = "device_mem_wait_ms";
 
 }  // namespace provider_option_names
 }  // namespace cuda
@@ -121,6 +126,13 @@ CUDAExecutionProviderInfo CUDAExecutionProviderInfo::FromProviderOptions(const P
           .AddAssignmentToReference(cuda::provider_option_names::kUseTF32, info.use_tf32)
           .AddAssignmentToReference(cuda::provider_option_names::kSdpaKernel, info.sdpa_kernel)
           .AddAssignmentToReference(cuda::provider_option_names::kFuseConvBias, info.fuse_conv_bias)
+          .AddAssignmentToReference(cuda::provider_option_names::kUseCudaMempool, info.use_cuda_mempool)
+          .AddAssignmentToReference(cuda::provider_option_names::kCudaMempoolReleaseThreshold,
+                                    info.cuda_mempool_release_threshold)
+          .AddAssignmentToReference(cuda::provider_option_names::kPinnedStagingBufferSize,
+                                    info.pinned_staging_buffer_size)
+          .AddAssignmentToReference(cuda::provider_option_names::kDeviceMemLimit, info.device_mem_limit)
+          .AddAssignmentToReference(cuda::provider_option_names::kDeviceMemWaitMs, info.device_mem_wait_ms)
           .AddValueParser(
               cuda::provider_option_names::kTunableOpEnable,
               [&info](const std::string& value_str) -> Status {
@@ -176,6 +188,12 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const CUDAExecution
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
       {cuda::provider_option_names::kSdpaKernel, MakeStringWithClassicLocale(info.sdpa_kernel)},
       {cuda::provider_option_names::kFuseConvBias, MakeStringWithClassicLocale(info.fuse_conv_bias)},
+      {cuda::provider_option_names::kUseCudaMempool, MakeStringWithClassicLocale(info.use_cuda_mempool)},
+      {cuda::provider_option_names::kCudaMempoolReleaseThreshold,
+       MakeStringWithClassicLocale(info.cuda_mempool_release_threshold)},
+      {cuda::provider_option_names::kPinnedStagingBufferSize, MakeStringWithClassicLocale(info.pinned_staging_buffer_size)},
+      {cuda::provider_option_names::kDeviceMemLimit, MakeStringWithClassicLocale(info.device_mem_limit)},
+      {cuda::provider_option_names::kDeviceMemWaitMs, MakeStringWithClassicLocale(info.device_mem_wait_ms)},
   };
 
   return options;
@@ -200,6 +218,12 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const OrtCUDAProvid
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
       {cuda::provider_option_names::kFuseConvBias, MakeStringWithClassicLocale(info.fuse_conv_bias)},
       {cuda::provider_option_names::kSdpaKernel, MakeStringWithClassicLocale(info.sdpa_kernel)},
+      {cuda::provider_option_names::kUseCudaMempool, MakeStringWithClassicLocale(info.use_cuda_mempool)},
+      {cuda::provider_option_names::kCudaMempoolReleaseThreshold,
+       MakeStringWithClassicLocale(info.cuda_mempool_release_threshold)},
+      {cuda::provider_option_names::kPinnedStagingBufferSize, MakeStringWithClassicLocale(info.pinned_staging_buffer_size)},
+      {cuda::provider_option_names::kDeviceMemLimit, MakeStringWithClassicLocale(info.device_mem_limit)},
+      {cuda::provider_option_names::kDeviceMemWaitMs, MakeStringWithClassicLocale(info.device_mem_wait_ms)},
   };
 
   return options;
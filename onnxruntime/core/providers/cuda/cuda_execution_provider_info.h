@@ -82,6 +82,22 @@ struct CUDAExecutionProviderInfo {
 
   int sdpa_kernel{0};
 
+  // Allocate device memory from the stream-ordered CUDA memory pool of the device (cudaMallocAsync) instead of a
+  // BFCArena. The pool keeps at most cuda_mempool_release_threshold bytes cached across synchronizations.
+  bool use_cuda_mempool{false};
+  size_t cuda_mempool_release_threshold{0};
+
+  // Copies between pageable host memory and the device on a stream, e.g. the CPU inputs and outputs of a Run or of
+  // an IOBinding, go through two pinned buffers of this size per stream, so the host copy of a chunk overlaps the
+  // transfer of the previous one and an input copy returns once the data is staged. 0 disables the staging.
+  size_t pinned_staging_buffer_size{0};
+
+  // Budget in bytes for the device memory allocated by all the CUDA EPs of the process on the device, of which the
+  // smallest non-zero one applies. An allocation above it waits up to device_mem_wait_ms for other sessions to free
+  // memory before it fails. 0 disables the budget.
+  size_t device_mem_limit{0};
+  int device_mem_wait_ms{0};
+
   static CUDAExecutionProviderInfo FromProviderOptions(const ProviderOptions& options);
   static ProviderOptions ToProviderOptions(const CUDAExecutionProviderInfo& info);
   static ProviderOptions ToProviderOptions(const OrtCUDAProviderOptionsV2& info);
@@ -115,6 +131,11 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
     onnxruntime::HashCombine(info.sdpa_kernel, value);
+    onnxruntime::HashCombine(info.use_cuda_mempool, value);
+    onnxruntime::HashCombine(info.cuda_mempool_release_threshold, value);
+    onnxruntime::HashCombine(info.pinned_staging_buffer_size, value);
+    onnxruntime::HashCombine(info.device_mem_limit, value);
+    onnxruntime::HashCombine(info.device_mem_wait_ms, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
@@ -29,6 +29,14 @@ void CudaGraphSet::Put(CudaGraphAnnotation_t cuda_graph_annotation_id, cudaGraph
   cuda_graphs_.emplace(cuda_graph_annotation_id, graph_exec);
 }
 
+void CudaGraphSet::Remove(CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  auto it = cuda_graphs_.find(cuda_graph_annotation_id);
+  if (it != cuda_graphs_.end()) {
+    CUDA_CALL_THROW(cudaGraphExecDestroy(it->second));
+    cuda_graphs_.erase(it);
+  }
+}
+
 cudaGraphExec_t CudaGraphSet::Get(CudaGraphAnnotation_t cuda_graph_annotation_id) const {
   ORT_ENFORCE(Contains(cuda_graph_annotation_id));
   return cuda_graphs_.at(cuda_graph_annotation_id);
@@ -85,6 +93,10 @@ Status CUDAGraphManager::Replay(CudaGraphAnnotation_t cuda_graph_annotation_id)
   return Status::OK();
 }
 
+void CUDAGraphManager::Release(CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  cuda_graph_set_.Remove(cuda_graph_annotation_id);
+}
+
 bool CUDAGraphManager::IsGraphCaptureAllowedOnRun(CudaGraphAnnotation_t cuda_graph_annotation_id) const {
   return cuda_graph_annotation_id != kCudaGraphAnnotationSkip;
 }
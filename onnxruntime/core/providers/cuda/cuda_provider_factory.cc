@@ -228,6 +228,11 @@ struct CUDA_Provider : Provider {
     info.use_ep_level_unified_stream = params->use_ep_level_unified_stream != 0;
     info.use_tf32 = params->use_tf32 != 0;
     info.sdpa_kernel = params->sdpa_kernel;
+    info.use_cuda_mempool = params->use_cuda_mempool != 0;
+    info.cuda_mempool_release_threshold = params->cuda_mempool_release_threshold;
+    info.pinned_staging_buffer_size = params->pinned_staging_buffer_size;
+    info.device_mem_limit = params->device_mem_limit;
+    info.device_mem_wait_ms = params->device_mem_wait_ms;
 
     return std::make_shared<CUDAProviderFactory>(info);
   }
@@ -264,6 +269,11 @@ struct CUDA_Provider : Provider {
     cuda_options.use_tf32 = internal_options.use_tf32;
     cuda_options.sdpa_kernel = internal_options.sdpa_kernel;
     cuda_options.fuse_conv_bias = internal_options.fuse_conv_bias;
+    cuda_options.use_cuda_mempool = internal_options.use_cuda_mempool;
+    cuda_options.cuda_mempool_release_threshold = internal_options.cuda_mempool_release_threshold;
+    cuda_options.pinned_staging_buffer_size = internal_options.pinned_staging_buffer_size;
+    cuda_options.device_mem_limit = internal_options.device_mem_limit;
+    cuda_options.device_mem_wait_ms = internal_options.device_mem_wait_ms;
   }
 
   ProviderOptions GetProviderOptions(const void* provider_options) override {
@@ -5,6 +5,8 @@
 #include "core/providers/cuda/cuda_common.h"
 #include "core/common/spin_pause.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 
 DeferredCpuAllocator::DeferredCpuAllocator(CudaStream& cuda_stream) : cuda_stream_(cuda_stream) {
@@ -89,6 +91,15 @@ CudaStream::CudaStream(cudaStream_t stream,
 
 CudaStream::~CudaStream() {
   ORT_IGNORE_RETURN_VALUE(CleanUpOnRunEnd());
+  for (size_t i = 0; i < staging_buffers_.size(); ++i) {
+    if (staging_events_[i]) {
+      cudaEventSynchronize(staging_events_[i]);
+      cudaEventDestroy(staging_events_[i]);
+    }
+    if (staging_buffers_[i]) {
+      cudaFreeHost(staging_buffers_[i]);
+    }
+  }
 #ifndef USE_CUDA_MINIMAL
   if (own_stream_) {
     cublasDestroy(cublas_handle_);
@@ -116,6 +127,81 @@ void CudaStream::EnqueDeferredCPUBuffer(void* cpu_buffer) {
   deferred_cpu_buffers_.push_back(cpu_buffer);
 }
 
+bool CudaStream::UsePinnedStaging() const {
+  if (ep_info_.pinned_staging_buffer_size == 0) {
+    return false;
+  }
+  // the host copies and event waits of the staging cannot be captured in a CUDA graph
+  cudaStreamCaptureStatus capture_status = cudaStreamCaptureStatusNone;
+  return cudaStreamIsCapturing(static_cast<cudaStream_t>(GetHandle()), &capture_status) == cudaSuccess &&
+         capture_status == cudaStreamCaptureStatusNone;
+}
+
+Status CudaStream::EnsureStagingBuffers() {
+  // stream is per thread, so don't need lock
+  for (size_t i = 0; i < staging_buffers_.size(); ++i) {
+    if (!staging_buffers_[i]) {
+      CUDA_RETURN_IF_ERROR(cudaMallocHost(&staging_buffers_[i], ep_info_.pinned_staging_buffer_size));
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&staging_events_[i], cudaEventDisableTiming));
+    }
+  }
+  return Status::OK();
+}
+
+Status CudaStream::CopyHostToDeviceStaged(void* dst, const void* src, size_t bytes) {
+  ORT_RETURN_IF_ERROR(EnsureStagingBuffers());
+  auto stream = static_cast<cudaStream_t>(GetHandle());
+  const size_t chunk_size = ep_info_.pinned_staging_buffer_size;
+  for (size_t offset = 0; offset < bytes; offset += chunk_size) {
+    const size_t chunk_bytes = std::min(chunk_size, bytes - offset);
+    const size_t buffer = next_staging_buffer_;
+    next_staging_buffer_ = 1 - buffer;
+
+    // the buffer can be refilled once its previous transfer completed
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging_events_[buffer]));
+    memcpy(staging_buffers_[buffer], static_cast<const char*>(src) + offset, chunk_bytes);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, staging_buffers_[buffer], chunk_bytes,
+                                         cudaMemcpyHostToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(staging_events_[buffer], stream));
+  }
+  return Status::OK();
+}
+
+Status CudaStream::CopyDeviceToHostStaged(void* dst, const void* src, size_t bytes) {
+  ORT_RETURN_IF_ERROR(EnsureStagingBuffers());
+  auto stream = static_cast<cudaStream_t>(GetHandle());
+  const size_t chunk_size = ep_info_.pinned_staging_buffer_size;
+
+  // the chunk whose transfer was queued last, which is copied out while the transfer of the next one runs
+  size_t pending_buffer = 0;
+  size_t pending_offset = 0;
+  size_t pending_bytes = 0;
+  for (size_t offset = 0; offset < bytes; offset += chunk_size) {
+    const size_t chunk_bytes = std::min(chunk_size, bytes - offset);
+    const size_t buffer = next_staging_buffer_;
+    next_staging_buffer_ = 1 - buffer;
+
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging_events_[buffer]));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(staging_buffers_[buffer], static_cast<const char*>(src) + offset,
+                                         chunk_bytes, cudaMemcpyDeviceToHost, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(staging_events_[buffer], stream));
+
+    if (pending_bytes > 0) {
+      CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging_events_[pending_buffer]));
+      memcpy(static_cast<char*>(dst) + pending_offset, staging_buffers_[pending_buffer], pending_bytes);
+    }
+    pending_buffer = buffer;
+    pending_offset = offset;
+    pending_bytes = chunk_bytes;
+  }
+
+  if (pending_bytes > 0) {
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging_events_[pending_buffer]));
+    memcpy(static_cast<char*>(dst) + pending_offset, staging_buffers_[pending_buffer], pending_bytes);
+  }
+  return Status::OK();
+}
+
 struct CpuBuffersInfo {
   // This struct stores the information needed
   // to release CPU buffers allocated for GPU kernels.
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <array>
+
 #include "core/providers/cuda/cuda_pch.h"
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 #include "core/providers/cuda/shared_inc/cuda_call.h"
@@ -50,12 +52,26 @@ struct CudaStream : Stream {
 
   WaitNotificationFn GetWaitNotificationFn() const override { return WaitCudaNotificationOnDevice; }
 
+  // Copies between pageable host memory and the device through the two pinned staging buffers of the stream.
+  // The host copy of each chunk overlaps the transfer of the previous chunk. CopyHostToDeviceStaged returns once the
+  // source is staged, CopyDeviceToHostStaged once the destination is written.
+  // see CUDAExecutionProviderInfo::pinned_staging_buffer_size
+  bool UsePinnedStaging() const;
+  Status CopyHostToDeviceStaged(void* dst, const void* src, size_t bytes);
+  Status CopyDeviceToHostStaged(void* dst, const void* src, size_t bytes);
+
  private:
+  Status EnsureStagingBuffers();
+
   std::vector<void*> deferred_cpu_buffers_;
   AllocatorPtr cpu_allocator_;
   bool release_cpu_buffer_on_cuda_stream_{true};
   DeferredCpuAllocator deferred_cpu_allocator_;
   const CUDAExecutionProviderInfo ep_info_;
+  // pinned staging buffers, and the events recorded after the last transfer of each of them
+  std::array<void*, 2> staging_buffers_{};
+  std::array<cudaEvent_t, 2> staging_events_{};
+  size_t next_staging_buffer_{0};
 };
 
 void RegisterCudaStreamHandles(IStreamCommandHandleRegistry& stream_handle_registry,
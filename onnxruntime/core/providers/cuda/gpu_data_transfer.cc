@@ -4,6 +4,7 @@
 #include "core/providers/shared_library/provider_api.h"
 
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/cuda_stream_handle.h"
 #include "cuda_common.h"
 
 namespace onnxruntime {
@@ -57,8 +58,15 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   auto& src_device = src.Location().device;
   auto& dst_device = dst.Location().device;
 
+  // copies between pageable memory and GPU are staged through the pinned buffers of the stream when enabled
+  auto* cuda_stream = dynamic_cast<CudaStream*>(&stream);
+  const bool use_pinned_staging = cuda_stream != nullptr && cuda_stream->UsePinnedStaging();
+
   if (dst_device.Type() == OrtDevice::GPU) {
     if (src_device.Type() == OrtDevice::CPU) {
+      if (use_pinned_staging && src_device.MemType() != OrtDevice::MemType::CUDA_PINNED) {
+        return cuda_stream->CopyHostToDeviceStaged(dst_data, src_data, bytes);
+      }
       // copy from pinned memory to GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
     } else if (src_device.Type() == OrtDevice::GPU) {
@@ -69,6 +77,9 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU) {
+      if (use_pinned_staging && dst_device.MemType() != OrtDevice::MemType::CUDA_PINNED) {
+        return cuda_stream->CopyDeviceToHostStaged(dst_data, src_data, bytes);
+      }
       // copying from GPU to pinned memory, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, static_cast<cudaStream_t>(stream.GetHandle())));
     }
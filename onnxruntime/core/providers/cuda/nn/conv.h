@@ -6,6 +6,8 @@
 
 #include <list>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -131,6 +133,47 @@ class lru_unordered_map {
 // cached cudnn descriptors
 constexpr size_t MAX_CACHED_ALGO_PERF_RESULTS = 10000;
 
+// The results of the cuDNN algorithm searches are also recorded in the TuningResultsManager of the EP, so they are
+// saved with the tuning results and a later session can load them instead of searching again. The kernel id of a
+// result packs the algorithm and the math type, the workspace size is queried again when a result is loaded.
+constexpr int kConvAlgoMathTypeBits = 8;
+
+inline int PackConvAlgoSearchResult(int algo, cudnnMathType_t math_type) {
+  return (algo << kConvAlgoMathTypeBits) | static_cast<int>(math_type);
+}
+
+inline int UnpackConvAlgo(int kernel_id) {
+  return kernel_id >> kConvAlgoMathTypeBits;
+}
+
+inline cudnnMathType_t UnpackConvMathType(int kernel_id) {
+  return static_cast<cudnnMathType_t>(kernel_id & ((1 << kConvAlgoMathTypeBits) - 1));
+}
+
+// Params signature of an algorithm search, made of everything that is set on the cuDNN descriptors.
+inline std::string ConvAlgoSearchSignature(cudnnDataType_t data_type, bool channels_last, bool use_tf32,
+                                           gsl::span<const int64_t> x_dims, gsl::span<const int64_t> w_dims,
+                                           gsl::span<const int64_t> y_dims, gsl::span<const int64_t> pads,
+                                           gsl::span<const int64_t> strides, gsl::span<const int64_t> dilations,
+                                           int64_t group) {
+  std::ostringstream oss;
+  auto append = [&oss](const char* name, gsl::span<const int64_t> values) {
+    oss << "_" << name;
+    for (size_t i = 0; i < values.size(); ++i) {
+      oss << (i == 0 ? "" : "x") << values[i];
+    }
+  };
+  oss << static_cast<int>(data_type) << (channels_last ? "_NHWC" : "_NCHW") << (use_tf32 ? "_TF32" : "");
+  append("x", x_dims);
+  append("w", w_dims);
+  append("y", y_dims);
+  append("p", pads);
+  append("s", strides);
+  append("d", dilations);
+  oss << "_g" << group;
+  return oss.str();
+}
+
 template <typename AlgoPerfType>
 struct CudnnConvState {
   // if x/w dims changed, update algo and cudnnTensors
@@ -253,9 +253,6 @@ Status ConvTranspose<T, NHWC>::DoConvTranspose(OpKernelContext* context, bool dy
       y_data = reinterpret_cast<CudaT*>(p.Y->MutableData<T>());
 
       if (!s_.cached_benchmark_results.contains(x_dims)) {
-        IAllocatorUniquePtr<void> algo_search_workspace =
-            GetScratchBuffer<void>(AlgoSearchWorkspaceSize, context->GetComputeStream());
-
         // set math type to tensor core before algorithm search
         if constexpr (std::is_same<T, MLFloat16>::value) {
           CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
@@ -266,10 +263,29 @@ Status ConvTranspose<T, NHWC>::DoConvTranspose(OpKernelContext* context, bool dy
         }
 
         cudnnConvolutionBwdDataAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
-            GetCudnnHandle(context), s_.w_desc, w_data, s_.x_tensor, x_data, s_.conv_desc, s_.y_tensor, y_data, 1,
-            &algo_count, &perf, algo_search_workspace.get(), AlgoSearchWorkspaceSize));
+        auto& tuning_results = GetTuningContext()->GetTuningResultsManager();
+        const std::string op_signature = "CudnnConvTransposeBackwardData";
+        const std::string params_signature = ConvAlgoSearchSignature(
+            CudnnTensor::GetDataType<CudaT>(), NHWC, UseTF32(), x_dims, w_dims, y_dims, p.pads, p.strides,
+            p.dilations, conv_transpose_attrs_.group);
+        const int tuned_id = tuning_results.Lookup(op_signature, params_signature);
+        if (tuned_id >= 0) {
+          // the algorithm was found by a previous search, possibly in another process
+          perf.algo = static_cast<cudnnConvolutionBwdDataAlgo_t>(UnpackConvAlgo(tuned_id));
+          perf.mathType = UnpackConvMathType(tuned_id);
+          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.mathType));
+          CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionBackwardDataWorkspaceSize(
+              GetCudnnHandle(context), s_.w_desc, s_.x_tensor, s_.conv_desc, s_.y_tensor, perf.algo, &perf.memory));
+        } else {
+          IAllocatorUniquePtr<void> algo_search_workspace =
+              GetScratchBuffer<void>(AlgoSearchWorkspaceSize, context->GetComputeStream());
+          int algo_count = 1;
+          CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
+              GetCudnnHandle(context), s_.w_desc, w_data, s_.x_tensor, x_data, s_.conv_desc, s_.y_tensor, y_data, 1,
+              &algo_count, &perf, algo_search_workspace.get(), AlgoSearchWorkspaceSize));
+          tuning_results.Add(op_signature, params_signature,
+                             PackConvAlgoSearchResult(static_cast<int>(perf.algo), perf.mathType));
+        }
         s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
       }
 
@@ -28,6 +28,17 @@ static Status ValidateCudaVersion(const std::string& value) {
   return Status::OK();
 }
 
+static std::string GetCudnnVersion() {
+  return std::to_string(cudnnGetVersion());
+}
+
+static Status ValidateCudnnVersion(const std::string& value) {
+  auto current = GetCudnnVersion();
+  ORT_RETURN_IF(current != value, "cuDNN version mismatch: tuning results produced with cuDNN ", value,
+                ", onnxruntime currently run with cuDNN ", current);
+  return Status::OK();
+}
+
 std::string CudaTuningResultsValidator::GetOrtBuildConfig() const {
   std::ostringstream oss;
 #ifdef ENABLE_TRITON
@@ -52,6 +63,7 @@ Status CudaTuningResultsValidator::ValidateDeviceModel(const std::string& value)
 
 CudaTuningResultsValidator::CudaTuningResultsValidator(CUDAExecutionProvider* ep) : ep_(ep) {
   RegisterValidator("CUDA_VERSION", GetCudaVersion, ValidateCudaVersion);
+  RegisterValidator("CUDNN_VERSION", GetCudnnVersion, ValidateCudnnVersion);
   RegisterValidator(
       "DEVICE_MODEL",
       [this]() { return GetDeviceModel(); },
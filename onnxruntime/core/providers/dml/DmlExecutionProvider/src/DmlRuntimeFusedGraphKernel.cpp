@@ -14,6 +14,21 @@ namespace Dml
 {
     class DmlRuntimeFusedGraphKernel : public onnxruntime::OpKernel
     {
+        // A graph compiled for one shape signature, with the resources and the command lists recorded for it
+        struct CompiledGraph
+        {
+            ComPtr<IDMLCompiledOperator> compiledExecutionPlanOperator;
+            std::optional<DML_BUFFER_BINDING> persistentResourceBinding;
+            ComPtr<ID3D12Resource> persistentResource;
+            ComPtr<IUnknown> persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
+            std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> ownedCpuInputs;
+            std::vector<bool> inputsUsed;
+            Windows::AI::MachineLearning::Adapter::EdgeShapes outputShapes;
+            std::vector<uint8_t> isInputsUploadedByDmlEP;
+            std::vector<ComPtr<ID3D12Resource>> nonOwnedGraphInputsFromInitializers;
+            std::deque<std::unique_ptr<DmlReusedCommandListState>> reusedCommandLists;
+        };
+
     public:
         DmlRuntimeFusedGraphKernel() = delete;
 
@@ -62,24 +77,24 @@ namespace Dml
             }
         }
 
-        void TranslateAndCompileGraph(const onnxruntime::OpKernelInfo& kernelInfo, std::vector<DML_BUFFER_BINDING> initInputBindings) const
+        void TranslateAndCompileGraph(const onnxruntime::OpKernelInfo& kernelInfo, CompiledGraph& compiledGraph, std::vector<DML_BUFFER_BINDING> initInputBindings) const
         {
             // Allocate a persistent resource and initialize the operator
-            UINT64 persistentResourceSize = m_compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
+            UINT64 persistentResourceSize = compiledGraph.compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
             if (persistentResourceSize > 0)
             {
                 ORT_THROW_IF_FAILED(m_provider->AllocatePooledResource(
                     static_cast<size_t>(persistentResourceSize),
                     AllocatorRoundingMode::Disabled,
-                    m_persistentResource.ReleaseAndGetAddressOf(),
-                    m_persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
+                    compiledGraph.persistentResource.ReleaseAndGetAddressOf(),
+                    compiledGraph.persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
 
-                m_persistentResourceBinding = DML_BUFFER_BINDING { m_persistentResource.Get(), 0, persistentResourceSize };
+                compiledGraph.persistentResourceBinding = DML_BUFFER_BINDING { compiledGraph.persistentResource.Get(), 0, persistentResourceSize };
             }
 
             ORT_THROW_IF_FAILED(m_provider->InitializeOperator(
-                m_compiledExecutionPlanOperator.Get(),
-                m_persistentResourceBinding ? &*m_persistentResourceBinding : nullptr,
+                compiledGraph.compiledExecutionPlanOperator.Get(),
+                compiledGraph.persistentResourceBinding ? &*compiledGraph.persistentResourceBinding : nullptr,
                 gsl::make_span(initInputBindings)));
         }
 
@@ -91,75 +106,61 @@ namespace Dml
 
             ORT_THROW_HR_IF(E_UNEXPECTED, static_cast<ptrdiff_t>(m_subgraphInputs.size()) != kernelContext->InputCount());
 
-            bool recompileNeeded = m_compiledExecutionPlanOperator == nullptr;
+            // The compiled graph depends on the input shapes and on the content of the CPU inputs, which are baked into
+            // the graph as constants, so both are part of the key of the compiled graph cache
+            std::string shapeSignature;
+            std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> cpuInputs;
 
             for (int inputIndex = 0; inputIndex < kernelContext->InputCount(); ++inputIndex)
             {
                 const auto& input = kernelContext->RequiredInput<onnxruntime::Tensor>(inputIndex);
                 const std::string& inputName = m_subgraphInputs[inputIndex]->Name();
-                auto shapeIter = m_inferredInputShapes.find(inputName);
 
-                if (shapeIter == m_inferredInputShapes.end())
-                {
-                    m_inferredInputShapes[inputName] = input.Shape();
-                    recompileNeeded = true;
-                }
-                else if (shapeIter->second != input.Shape())
-                {
-                    shapeIter->second = input.Shape();
-                    recompileNeeded = true;
-                }
+                shapeSignature += input.Shape().ToString();
 
                 // If we have CPU inputs that are not initializers (i.e. they were computed at runtime), add them to the initializer list
                 if (input.Location().device.Type() == OrtDevice::CPU)
                 {
                     auto inputProto = onnxruntime::utils::TensorToTensorProto(input, inputName);
+                    shapeSignature += inputProto.raw_data();
+                    cpuInputs.push_back(std::make_unique<ONNX_NAMESPACE::TensorProto>(std::move(inputProto)));
+                }
 
-                    // We can only avoid recompiling the graph when all CPU inputs are identical
-                    auto initializerIter = m_isInitializerTransferable.find(inputName);
+                shapeSignature += ';';
+            }
 
-                    if (initializerIter != m_isInitializerTransferable.end())
-                    {
-                        if (initializerIter->second.first->raw_data().length() == inputProto.raw_data().length())
-                        {
-                            for (int i = 0; i < inputProto.raw_data().length(); ++i)
-                            {
-                                if (initializerIter->second.first->raw_data()[i] != inputProto.raw_data()[i])
-                                {
-                                    recompileNeeded = true;
-                                    break;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            recompileNeeded = true;
-                        }
-                    }
-                    else
-                    {
-                        recompileNeeded = true;
-                    }
+            auto cachedGraphIter = m_compiledGraphLookup.find(shapeSignature);
+            if (cachedGraphIter != m_compiledGraphLookup.end())
+            {
+                // Move the graph to the front of the LRU list
+                m_compiledGraphs.splice(m_compiledGraphs.begin(), m_compiledGraphs, cachedGraphIter->second);
+            }
+            else
+            {
+                auto compiledGraph = std::make_unique<CompiledGraph>();
+                compiledGraph->ownedCpuInputs = std::move(cpuInputs);
 
-                    m_ownedCpuInputs.push_back(std::make_unique<ONNX_NAMESPACE::TensorProto>(std::move(inputProto)));
-                    m_isInitializerTransferable[inputName] = std::make_pair(m_ownedCpuInputs.back().get(), false);
+                for (const auto& cpuInput : compiledGraph->ownedCpuInputs)
+                {
+                    m_isInitializerTransferable[cpuInput->name()] = std::make_pair(cpuInput.get(), false);
                 }
-            }
 
-            if (recompileNeeded)
-            {
                 // Go through all the node args and replace their shapes with the real ones
                 for (auto& nodeArg : m_intermediateNodeArgs)
                 {
-                    auto iter = m_inferredInputShapes.find(nodeArg->Name());
-                    if (iter != m_inferredInputShapes.end())
+                    auto iter = std::find_if(m_subgraphInputs.begin(), m_subgraphInputs.end(), [&nodeArg](const onnxruntime::NodeArg* input) {
+                        return input->Name() == nodeArg->Name();
+                    });
+
+                    if (iter != m_subgraphInputs.end())
                     {
+                        const auto& inputShape = kernelContext->RequiredInput<onnxruntime::Tensor>(gsl::narrow_cast<int>(iter - m_subgraphInputs.begin())).Shape();
                         auto tensorShape = *nodeArg->Shape();
-                        ORT_THROW_HR_IF(E_UNEXPECTED, tensorShape.dim_size() != static_cast<ptrdiff_t>(iter->second.NumDimensions()));
+                        ORT_THROW_HR_IF(E_UNEXPECTED, tensorShape.dim_size() != static_cast<ptrdiff_t>(inputShape.NumDimensions()));
 
                         for (int i = 0; i < tensorShape.dim_size(); ++i)
                         {
-                            tensorShape.mutable_dim(i)->set_dim_value(iter->second.GetDims()[i]);
+                            tensorShape.mutable_dim(i)->set_dim_value(inputShape.GetDims()[i]);
                         }
 
                         nodeArg->SetShape(tensorShape);
@@ -201,23 +202,23 @@ namespace Dml
                     serializedGraphLargeConstantNameToSubgraphInputIndex,
                     smallConstantData);
 
-                m_outputShapes = graphDesc.outputShapes;
+                compiledGraph->outputShapes = graphDesc.outputShapes;
 
                 // Walk through each graph edge and mark used inputs
-                m_inputsUsed = std::vector<bool>(fusedNodeInputCount);
+                compiledGraph->inputsUsed = std::vector<bool>(fusedNodeInputCount);
                 for (auto it = serializedGraphInputIndexToSubgraphInputIndex.begin(); it != serializedGraphInputIndexToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
+                    compiledGraph->inputsUsed[it->second] = true;
                 }
                 for (auto it = serializedGraphLargeConstantNameToSubgraphInputIndex.begin(); it != serializedGraphLargeConstantNameToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
+                    compiledGraph->inputsUsed[it->second] = true;
                 }
 
-                m_isInputsUploadedByDmlEP.resize(fusedNodeInputCount, 0);
-                m_nonOwnedGraphInputsFromInitializers.resize(fusedNodeInputCount);
+                compiledGraph->isInputsUploadedByDmlEP.resize(fusedNodeInputCount, 0);
+                compiledGraph->nonOwnedGraphInputsFromInitializers.resize(fusedNodeInputCount);
                 graphDesc.reuseCommandList = true;
 
                 // Compile the operator
-                m_compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
+                compiledGraph->compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
                     graphDesc,
                     *m_indexedSubGraph,
                     providerImpl,
@@ -225,28 +226,37 @@ namespace Dml
                     &serializedGraphLargeConstantNameToSubgraphInputIndex);
 
                 // Queue references to objects which must be kept alive until resulting GPU work completes
-                m_winmlProvider->QueueReference(m_compiledExecutionPlanOperator.Get());
+                m_winmlProvider->QueueReference(compiledGraph->compiledExecutionPlanOperator.Get());
 
-                TranslateAndCompileGraph(Info(), initInputBindings);
+                TranslateAndCompileGraph(Info(), *compiledGraph, initInputBindings);
 
-                std::vector<DML_BUFFER_BINDING> inputBindings(kernelContext->InputCount());
-                std::vector<DML_BINDING_DESC> inputBindingDescs(kernelContext->InputCount());
+                // Evict the least recently used graph. Its command lists may still be executing, so the GPU objects are
+                // kept alive until the queued work completes.
+                if (m_compiledGraphs.size() >= c_maxCachedCompiledGraphs)
+                {
+                    ReleaseCompiledGraph(*m_compiledGraphs.back().second);
+                    m_compiledGraphLookup.erase(m_compiledGraphs.back().first);
+                    m_compiledGraphs.pop_back();
+                }
 
-                m_reusedCommandLists.clear();
+                m_compiledGraphs.emplace_front(shapeSignature, std::move(compiledGraph));
+                m_compiledGraphLookup[shapeSignature] = m_compiledGraphs.begin();
             }
 
+            CompiledGraph& compiledGraph = *m_compiledGraphs.front().second;
+
             // When we are capturing a graph, we don't pool the command list and instead transfer it to the execution provider. Captured graph
             // have the same bindings for their entire lifetime.
             if (providerImpl->GraphCaptureEnabled() && providerImpl->GetCurrentGraphAnnotationId() != -1 && !providerImpl->GraphCaptured(providerImpl->GetCurrentGraphAnnotationId()))
             {
                 auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                     m_provider.Get(),
-                    m_compiledExecutionPlanOperator.Get(),
-                    m_persistentResource.Get(),
-                    m_persistentResourceBinding);
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
+                    compiledGraph.persistentResource.Get(),
+                    compiledGraph.persistentResourceBinding);
 
-                reusableCommandList->persistentResource = m_persistentResource;
-                reusableCommandList->persistentResourceAllocatorUnknown = m_persistentResourceAllocatorUnknown;
+                reusableCommandList->persistentResource = compiledGraph.persistentResource;
+                reusableCommandList->persistentResourceAllocatorUnknown = compiledGraph.persistentResourceAllocatorUnknown;
 
                 // Keep the temporary resource alive since we won't call ExecuteReusableCommandList again, but will merely replay
                 // the graph in the future. Therefore, all executions of the graph will use the same temporary resource that was
@@ -256,31 +266,32 @@ namespace Dml
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
                     *reusableCommandList,
-                    m_compiledExecutionPlanOperator.Get(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
-                    m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
-                    m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.isInputsUploadedByDmlEP,
+                    compiledGraph.inputsUsed,
+                    compiledGraph.nonOwnedGraphInputsFromInitializers,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get(),
+                    compiledGraph.persistentResourceAllocatorUnknown.Get(),
                     keepTemporaryResourceAlive);
 
                 providerImpl->AppendCapturedGraph(providerImpl->GetCurrentGraphAnnotationId(), std::move(reusableCommandList));
             }
             else
             {
-                if (m_reusedCommandLists.empty() ||
-                    m_reusedCommandLists.front()->fence && m_reusedCommandLists.front()->fence->GetCompletedValue() < m_reusedCommandLists.front()->completionValue)
+                auto& reusedCommandLists = compiledGraph.reusedCommandLists;
+                if (reusedCommandLists.empty() ||
+                    reusedCommandLists.front()->fence && reusedCommandLists.front()->fence->GetCompletedValue() < reusedCommandLists.front()->completionValue)
                 {
                     auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                         m_provider.Get(),
-                        m_compiledExecutionPlanOperator.Get(),
-                        m_persistentResource.Get(),
-                        m_persistentResourceBinding);
+                        compiledGraph.compiledExecutionPlanOperator.Get(),
+                        compiledGraph.persistentResource.Get(),
+                        compiledGraph.persistentResourceBinding);
 
-                    m_reusedCommandLists.push_front(std::move(reusableCommandList));
+                    reusedCommandLists.push_front(std::move(reusableCommandList));
                 }
 
                 // We don't need to keep a reference on the temporary resource once we have recorded into the command list, so the
@@ -289,30 +300,55 @@ namespace Dml
 
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
-                    *m_reusedCommandLists.front(),
-                    m_compiledExecutionPlanOperator.Get(),
+                    *reusedCommandLists.front(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
-                    m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
-                    m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.isInputsUploadedByDmlEP,
+                    compiledGraph.inputsUsed,
+                    compiledGraph.nonOwnedGraphInputsFromInitializers,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get(),
+                    compiledGraph.persistentResourceAllocatorUnknown.Get(),
                     keepTemporaryResourceAlive);
 
-                m_reusedCommandLists.push_back(std::move(m_reusedCommandLists.front()));
-                m_reusedCommandLists.pop_front();
+                reusedCommandLists.push_back(std::move(reusedCommandLists.front()));
+                reusedCommandLists.pop_front();
             }
 
             return onnxruntime::Status::OK();
         }
 
     private:
+        void ReleaseCompiledGraph(CompiledGraph& compiledGraph) const
+        {
+            m_winmlProvider->QueueReference(compiledGraph.compiledExecutionPlanOperator.Get());
+            if (compiledGraph.persistentResource)
+            {
+                m_winmlProvider->QueueReference(compiledGraph.persistentResource.Get());
+                m_winmlProvider->QueueReference(compiledGraph.persistentResourceAllocatorUnknown.Get());
+            }
+
+            for (const auto& commandList : compiledGraph.reusedCommandLists)
+            {
+                m_winmlProvider->QueueReference(commandList->graphicsCommandList.Get());
+                m_winmlProvider->QueueReference(commandList->commandAllocator.Get());
+                m_winmlProvider->QueueReference(commandList->heap.Get());
+                m_winmlProvider->QueueReference(commandList->bindingTable.Get());
+                if (commandList->temporaryResource)
+                {
+                    m_winmlProvider->QueueReference(commandList->temporaryResource.Get());
+                }
+            }
+        }
+
+        // Number of shape signatures for which a compiled graph is kept, so that alternating between a few shapes
+        // (e.g. the prompt and the token generation of a decoder) doesn't recompile the graph on every change
+        static constexpr size_t c_maxCachedCompiledGraphs = 8;
+
         ComPtr<IWinmlExecutionProvider> m_winmlProvider;
         ComPtr<Dml::IExecutionProvider> m_provider;
 
-        mutable std::optional<DML_BUFFER_BINDING> m_persistentResourceBinding;
         std::shared_ptr<const onnxruntime::IndexedSubGraph> m_indexedSubGraph;
         const std::filesystem::path& m_modelPath;
 
@@ -325,17 +361,9 @@ namespace Dml
         mutable std::unordered_map<std::string, std::pair<const ONNX_NAMESPACE::TensorProto*, bool>> m_isInitializerTransferable;
         std::vector<const onnxruntime::Node*> m_subgraphNodePointers;
 
-        // Bindings from previous executions of a re-used command list
-        mutable std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> m_ownedCpuInputs;
-        mutable ComPtr<IDMLCompiledOperator> m_compiledExecutionPlanOperator;
-        mutable std::vector<bool> m_inputsUsed;
-        mutable ComPtr<ID3D12Resource> m_persistentResource;
-        mutable ComPtr<IUnknown> m_persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
-        mutable Windows::AI::MachineLearning::Adapter::EdgeShapes m_outputShapes;
-        mutable std::unordered_map<std::string, onnxruntime::TensorShape> m_inferredInputShapes;
-        mutable std::deque<std::unique_ptr<DmlReusedCommandListState>> m_reusedCommandLists;
-        mutable std::vector<uint8_t> m_isInputsUploadedByDmlEP;
-        mutable std::vector<ComPtr<ID3D12Resource>> m_nonOwnedGraphInputsFromInitializers;
+        // Compiled graphs by shape signature, most recently used first
+        mutable std::list<std::pair<std::string, std::unique_ptr<CompiledGraph>>> m_compiledGraphs;
+        mutable std::unordered_map<std::string, std::list<std::pair<std::string, std::unique_ptr<CompiledGraph>>>::iterator> m_compiledGraphLookup;
     };
 
     onnxruntime::OpKernel* CreateRuntimeFusedGraphKernel(
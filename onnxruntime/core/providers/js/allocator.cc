@@ -3,27 +3,69 @@
 
 #include <emscripten.h>
 
+#include <algorithm>
+
 #include "core/framework/session_state.h"
 #include "core/providers/js/allocator.h"
 
 namespace onnxruntime {
 namespace js {
 
+JsCustomAllocator::~JsCustomAllocator() {
+  for (auto& [size_class, buffers] : pool_) {
+    for (void* p : buffers) {
+      EM_ASM({ Module.jsepFree($0); }, p);
+    }
+  }
+}
+
+size_t JsCustomAllocator::GetSizeClass(size_t size) {
+  // small buffers share size classes of 256 bytes to keep the number of classes low
+  constexpr size_t kMinPooledSizeClassStep = 256;
+  size_t power_of_two = 1;
+  while (power_of_two <= size / 2) {
+    power_of_two *= 2;
+  }
+
+  const size_t step = std::max(power_of_two / 4, kMinPooledSizeClassStep);
+  return (size + step - 1) / step * step;
+}
+
 void* JsCustomAllocator::Alloc(size_t size) {
   if (size == 0) {
     return nullptr;
   }
 
-  void* p = EM_ASM_PTR({ return Module.jsepAlloc($0); }, size);
+  const size_t size_class = GetSizeClass(size);
+  void* p = nullptr;
+  if (auto it = pool_.find(size_class); it != pool_.end() && !it->second.empty()) {
+    p = it->second.back();
+    it->second.pop_back();
+    pooled_bytes_ -= size_class;
+  } else {
+    p = EM_ASM_PTR({ return Module.jsepAlloc($0); }, size_class);
+  }
+
+  buffer_sizes_[p] = size_class;
   stats_.num_allocs++;
-  stats_.bytes_in_use += size;
+  stats_.bytes_in_use += size_class;
   return p;
 }
 
 void JsCustomAllocator::Free(void* p) {
   if (p != nullptr) {
-    size_t size = (size_t)(void*)EM_ASM_PTR({ return Module.jsepFree($0); }, p);
-    stats_.bytes_in_use -= size;
+    auto it = buffer_sizes_.find(p);
+    ORT_ENFORCE(it != buffer_sizes_.end(), "Freeing a buffer that was not allocated by JsCustomAllocator");
+    const size_t size_class = it->second;
+    buffer_sizes_.erase(it);
+    stats_.bytes_in_use -= size_class;
+
+    if (pooled_bytes_ + size_class <= max_pooled_bytes_) {
+      pool_[size_class].push_back(p);
+      pooled_bytes_ += size_class;
+    } else {
+      EM_ASM({ Module.jsepFree($0); }, p);
+    }
   }
 }
 
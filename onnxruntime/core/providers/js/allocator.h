@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/framework/ortdevice.h"
 
@@ -18,21 +19,41 @@ class JsCPUAllocator : public CPUAllocator {
                           0, OrtMemTypeCPU)) {};
 };
 
+// Allocates GPU buffers through the JS side. Freed buffers are kept in a pool by size class, up to
+// max_pooled_bytes in total, and handed out again instead of creating a new GPU buffer for the next allocation of
+// the same size class.
 class JsCustomAllocator : public IAllocator {
  public:
-  JsCustomAllocator()
+  // Upper bound of the bytes held by freed buffers in the pool.
+  static constexpr size_t kDefaultMaxPooledBytes = 256 * 1024 * 1024;
+
+  explicit JsCustomAllocator(size_t max_pooled_bytes = kDefaultMaxPooledBytes)
       : IAllocator(
             OrtMemoryInfo("JsCustomAllocator", OrtAllocatorType::OrtDeviceAllocator,
                           OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0),
-                          0, OrtMemTypeDefault)) {
+                          0, OrtMemTypeDefault)),
+        max_pooled_bytes_(max_pooled_bytes) {
   }
 
+  ~JsCustomAllocator() override;
+
   virtual void* Alloc(size_t size) override;
   virtual void Free(void* p) override;
   void GetStats(AllocatorStats* stats) override;
 
  private:
+  // Rounds size up to a size class. Classes are spaced by a quarter of the power of two below the size, so that at
+  // most 25% of a buffer is unused.
+  static size_t GetSizeClass(size_t size);
+
   AllocatorStats stats_;
+
+  const size_t max_pooled_bytes_;
+  size_t pooled_bytes_ = 0;
+  // freed buffers by size class
+  InlinedHashMap<size_t, InlinedVector<void*>> pool_;
+  // size class of the buffers in use
+  InlinedHashMap<void*, size_t> buffer_sizes_;
 };
 
 }  // namespace js
@@ -729,7 +729,9 @@ JsExecutionProvider::JsExecutionProvider(const JsExecutionProviderInfo& info, co
 
 std::vector<AllocatorPtr> JsExecutionProvider::CreatePreferredAllocators() {
   AllocatorCreationInfo customAllocatorCreationInfo([&](int) {
-    return std::make_unique<js::JsCustomAllocator>();
+    // a captured graph replays with the buffers it was captured with, so freed buffers can't be handed out again
+    return std::make_unique<js::JsCustomAllocator>(
+        enable_graph_capture_ ? 0 : js::JsCustomAllocator::kDefaultMaxPooledBytes);
   },
                                                     0, false);  // TODO(leca): REVIEW: need JsCPUAllocator?
   return std::vector<AllocatorPtr>{CreateAllocator(customAllocatorCreationInfo)};
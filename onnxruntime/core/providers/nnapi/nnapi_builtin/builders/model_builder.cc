@@ -11,8 +11,10 @@
 #include "core/common/safeint.h"
 #include "core/common/status.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_unit.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_proto_serializer.h"
 #include "core/graph/graph_viewer.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
@@ -520,6 +522,47 @@ Status ModelBuilder::AddOperation(int op, const InlinedVector<uint32_t>& input_i
   return Status::OK();
 }
 
+Status ModelBuilder::GetCacheToken(std::vector<uint8_t>& token) const {
+  // the token needs to change with the model and with the options the model is built and compiled with.
+  // the initializers are hashed separately as their data may be stored outside of the TensorProto.
+  ONNX_NAMESPACE::GraphProto graph_proto;
+  GraphViewerToProto(graph_viewer_, graph_proto, /*include_initializer*/ false, /*include_outer_scope_args*/ false);
+  std::string model_string;
+  graph_proto.SerializeToString(&model_string);
+  model_string += MakeString(use_nchw_, use_fp16_, static_cast<int32_t>(exe_pref_),
+                             static_cast<int32_t>(target_device_option_), GetDevicesDescription(nnapi_target_devices_));
+
+  std::vector<uint32_t> hashes(4);
+  MurmurHash3::x86_128(model_string.data(), gsl::narrow_cast<int>(model_string.size()), 0, hashes.data());
+
+  const auto& initializers = GetInitializerTensors();
+  std::vector<std::string> initializer_names;
+  initializer_names.reserve(initializers.size());
+  for (const auto& [name, tensor] : initializers) {
+    initializer_names.push_back(name);
+  }
+  std::sort(initializer_names.begin(), initializer_names.end());
+
+  for (const auto& name : initializer_names) {
+    std::vector<uint8_t> unpacked_tensor;
+    ORT_RETURN_IF_ERROR(onnxruntime::utils::UnpackInitializerData(*initializers.at(name), graph_viewer_.ModelPath(),
+                                                                  unpacked_tensor));
+    const size_t offset = hashes.size();
+    hashes.resize(offset + 8);
+    MurmurHash3::x86_128(name.data(), gsl::narrow_cast<int>(name.size()), 0, &hashes[offset]);
+    MurmurHash3::x86_128(unpacked_tensor.data(), gsl::narrow_cast<int>(unpacked_tensor.size()), 0,
+                         &hashes[offset + 4]);
+  }
+
+  // NNAPI takes a token of ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN (32) bytes, fill it with two 128 bit hashes
+  constexpr size_t kCacheTokenByteSize = 32;
+  token.resize(kCacheTokenByteSize);
+  const int hashes_byte_size = gsl::narrow_cast<int>(hashes.size() * sizeof(uint32_t));
+  MurmurHash3::x86_128(hashes.data(), hashes_byte_size, 0, token.data());
+  MurmurHash3::x86_128(hashes.data(), hashes_byte_size, 1, token.data() + 16);
+  return Status::OK();
+}
+
 Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
   ORT_RETURN_IF_ERROR(Prepare());
 
@@ -644,10 +687,33 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
           nnapi_model_->compilation_, static_cast<int32_t>(exe_pref_)),
       "on setPreference");
 
+  // compilation caching is only available on API 29+
+  if (!cache_dir_.empty()) {
+    if (nnapi_effective_feature_level_ >= ANEURALNETWORKS_FEATURE_LEVEL_3 &&
+        nnapi_.ANeuralNetworksCompilation_setCaching != nullptr) {
+      std::vector<uint8_t> token;
+      ORT_RETURN_IF_ERROR(GetCacheToken(token));
+      RETURN_STATUS_ON_ERROR_WITH_NOTE(
+          nnapi_.ANeuralNetworksCompilation_setCaching(nnapi_model_->compilation_, cache_dir_.c_str(), token.data()),
+          "on setCaching");
+    } else {
+      LOGS_DEFAULT(WARNING) << "NNAPI compilation caching requires Android API level 29+, the cache directory ["
+                            << cache_dir_ << "] is ignored.";
+    }
+  }
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_.ANeuralNetworksCompilation_finish(nnapi_model_->compilation_),
       "on compilation finish");
 
+  // burst execution is only available on API 29+
+  if (use_burst_ && nnapi_effective_feature_level_ >= ANEURALNETWORKS_FEATURE_LEVEL_3 &&
+      nnapi_.ANeuralNetworksBurst_create != nullptr) {
+    RETURN_STATUS_ON_ERROR_WITH_NOTE(
+        nnapi_.ANeuralNetworksBurst_create(nnapi_model_->compilation_, &nnapi_model_->burst_),
+        "on burst create");
+  }
+
   model.reset(nnapi_model_.release());
   return Status::OK();
 }
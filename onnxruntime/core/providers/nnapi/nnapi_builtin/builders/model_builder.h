@@ -75,6 +75,14 @@ class ModelBuilder {
   // It is off by default
   void SetUseFp16(bool use_fp16) { use_fp16_ = use_fp16; }
 
+  // Run the compiled model with an ANeuralNetworksBurst
+  // It is off by default
+  void SetUseBurst(bool use_burst) { use_burst_ = use_burst; }
+
+  // Cache the compilation in the given directory, an empty directory disables the caching
+  // It is off by default
+  void SetCacheDir(const std::string& cache_dir) { cache_dir_ = cache_dir; }
+
   // Set NNAPI execution preference
   // Default preference is PREFER_FAST_SINGLE_ANSWER
   void SetExecutePreference(
@@ -123,6 +131,8 @@ class ModelBuilder {
 
   bool use_nchw_{false};
   bool use_fp16_{false};
+  bool use_burst_{false};
+  std::string cache_dir_;
   android::nn::wrapper::ExecutePreference exe_pref_{
       android::nn::wrapper::ExecutePreference::PREFER_FAST_SINGLE_ANSWER};
 
@@ -176,6 +186,9 @@ class ModelBuilder {
   // Convert the ONNX model to ANeuralNetworksModel
   common::Status Prepare();
 
+  // Get the token which identifies the compilation of this model in the cache directory
+  common::Status GetCacheToken(std::vector<uint8_t>& token) const;
+
   // If a NNAPI operation will use initializers directly, we will add the initializers to the skip list
   void PreprocessInitializers();
   // Preprocess all the activation nodes (Relu/Relu1/Relu6) for easy query later
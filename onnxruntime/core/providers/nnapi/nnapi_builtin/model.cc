@@ -22,6 +22,10 @@ namespace nnapi {
 Model::Model(const NnApi& nnapi_handle) : nnapi_(nnapi_handle) {}
 
 Model::~Model() {
+  // the burst must be freed before the compilation it was created from
+  if (burst_) {
+    nnapi_.ANeuralNetworksBurst_free(burst_);
+  }
   nnapi_.ANeuralNetworksCompilation_free(compilation_);
   nnapi_.ANeuralNetworksModel_free(model_);
 }
@@ -101,7 +105,8 @@ Status Model::PrepareForExecution(std::unique_ptr<Execution>& execution) {
   RETURN_STATUS_ON_ERROR(
       nnapi_.ANeuralNetworksExecution_create(compilation_, &nnapi_execution));
 
-  execution = std::make_unique<Execution>(*nnapi_execution /*, shaper_*/, nnapi_);
+  // the burst can only be used by one execution at a time, which is ensured by the caller holding the model mutex
+  execution = std::make_unique<Execution>(*nnapi_execution /*, shaper_*/, nnapi_, burst_);
   return Status::OK();
 }
 
@@ -144,9 +149,10 @@ Model::NNMemory::NNMemory(const NnApi& /*nnapi_handle*/, const char* name, size_
 #pragma region Execution
 
 Execution::Execution(ANeuralNetworksExecution& execution /*, const Shaper& shaper */,
-                     const NnApi& nnapi_handle)
+                     const NnApi& nnapi_handle, ANeuralNetworksBurst* burst)
     : nnapi_(nnapi_handle),
-      execution_(&execution) {
+      execution_(&execution),
+      burst_(burst) {
 }
 
 Execution::~Execution() {
@@ -188,7 +194,9 @@ Status Execution::SetOutputBuffer(const int32_t index, const OutputBuffer& outpu
 }
 
 Status Execution::Predict(const std::vector<int32_t>& dynamic_outputs, std::vector<Shaper::Shape>& dynamic_output_shapes) {
-  {
+  if (burst_) {
+    RETURN_STATUS_ON_ERROR(nnapi_.ANeuralNetworksExecution_burstCompute(execution_, burst_));
+  } else {
     ANeuralNetworksEvent* event = nullptr;
     RETURN_STATUS_ON_ERROR(nnapi_.ANeuralNetworksExecution_startCompute(execution_, &event));
     auto free_event = gsl::finally([&]() { nnapi_.ANeuralNetworksEvent_free(event); });
@@ -112,6 +112,8 @@ class Model {
   int32_t nnapi_effective_feature_level_{0};
   ANeuralNetworksModel* model_{nullptr};
   ANeuralNetworksCompilation* compilation_{nullptr};
+  // Reused by the executions of this model if burst execution is enabled, null otherwise
+  ANeuralNetworksBurst* burst_{nullptr};
 
   size_t dynamic_output_buffer_size_{1024};
 
@@ -158,7 +160,9 @@ class Execution {
   };
 
  public:
-  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle);
+  // burst is the ANeuralNetworksBurst of the model to compute with, or null to compute without a burst
+  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle,
+                     ANeuralNetworksBurst* burst = nullptr);
   ~Execution();
   Execution(const Execution&) = delete;
   Execution& operator=(const Execution&) = delete;
@@ -182,6 +186,7 @@ class Execution {
 
   const NnApi& nnapi_;
   ANeuralNetworksExecution* execution_;
+  ANeuralNetworksBurst* burst_;
   /* Shaper shaper_; */
 };
 
@@ -51,10 +51,12 @@ std::unordered_set<std::string> GetPartitioningStopOps(const optional<std::strin
 }  // namespace
 
 NnapiExecutionProvider::NnapiExecutionProvider(uint32_t nnapi_flags,
-                                               const optional<std::string>& partitioning_stop_ops_list)
+                                               const optional<std::string>& partitioning_stop_ops_list,
+                                               const std::string& cache_dir)
     : IExecutionProvider{onnxruntime::kNnapiExecutionProvider},
       nnapi_flags_(nnapi_flags),
-      partitioning_stop_ops_(GetPartitioningStopOps(partitioning_stop_ops_list)) {
+      partitioning_stop_ops_(GetPartitioningStopOps(partitioning_stop_ops_list)),
+      cache_dir_(cache_dir) {
   nnapi_handle_ = NnApiImplementation();
   ORT_ENFORCE(nnapi_handle_ != nullptr, "Failed to get NnApiImplementation");
 
@@ -280,6 +282,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<FusedNodeAndGra
     nnapi::ModelBuilder builder(graph_viewer, *nnapi_handle_, nnapi_target_devices_, target_device_option_);
     builder.SetUseNCHW(nnapi_flags_ & NNAPI_FLAG_USE_NCHW);
     builder.SetUseFp16(nnapi_flags_ & NNAPI_FLAG_USE_FP16);
+    builder.SetUseBurst(nnapi_flags_ & NNAPI_FLAG_USE_BURST);
+    builder.SetCacheDir(cache_dir_);
 
     std::unique_ptr<nnapi::Model> nnapi_model;
     ORT_RETURN_IF_ERROR(builder.Compile(nnapi_model));
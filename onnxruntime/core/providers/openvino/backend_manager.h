@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/providers/openvino/ov_interface.h"
@@ -49,6 +50,8 @@ class BackendManager {
 
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
+  // guards backend_map_, which concurrent Run calls look up and extend
+  std::mutex backend_map_mutex_;
   std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
   SubGraphContext subgraph_context_;
   GlobalContext global_context_;
@@ -1,6 +1,7 @@
 // Copyright (C) Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -119,7 +120,14 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
     ORT_THROW(msg);
   }
 
-  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, 1));
+  // With several streams, keep as many infer requests as the device needs to keep the streams busy, so that
+  // concurrent Run calls execute in parallel instead of waiting for the single idle request
+  size_t nireq = 1;
+  if (global_context_.num_streams > 1) {
+    nireq = std::max<size_t>(exe_network_.GetOptimalNumberOfInferRequests(), global_context_.num_streams);
+    LOGS_DEFAULT(INFO) << log_tag << "Number of infer requests: " << nireq;
+  }
+  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, nireq));
 }
 
 bool BasicBackend::ValidateSubgraph(std::map<std::string, std::shared_ptr<ov::Node>>& const_outputs_map) {
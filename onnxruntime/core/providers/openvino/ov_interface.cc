@@ -182,6 +182,15 @@ void OVCore::SetStreams(const std::string& device_type, int num_streams) {
   oe.set_property(device_type, {ov::num_streams(num_streams)});
 }
 
+uint32_t OVExeNetwork::GetOptimalNumberOfInferRequests() {
+  try {
+    return obj.get_property(ov::optimal_number_of_infer_requests);
+  } catch (const Exception& e) {
+    LOGS_DEFAULT(WARNING) << log_tag << "Couldn't query the optimal number of infer requests: " << e.what();
+    return 0;
+  }
+}
+
 OVInferRequest OVExeNetwork::CreateInferRequest() {
   try {
     auto infReq = obj.create_infer_request();
@@ -80,6 +80,8 @@ class OVExeNetwork {
   OVExeNetwork() : obj(ov::CompiledModel()) {}
   ov::CompiledModel& Get() { return obj; }
   OVInferRequest CreateInferRequest();
+  // Number of infer requests that keeps all the streams of the compiled model busy, or 0 if the device doesn't report it
+  uint32_t GetOptimalNumberOfInferRequests();
 };
 
 class OVInferRequest {
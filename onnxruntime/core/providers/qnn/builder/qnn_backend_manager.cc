@@ -597,7 +597,8 @@ std::unique_ptr<unsigned char[]> QnnBackendManager::GetContextBinaryBuffer(uint6
 
 Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
                                                          std::string node_name,
-                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                                         bool share_ep_contexts) {
   bool result = nullptr == qnn_sys_interface_.systemContextCreate ||
                 nullptr == qnn_sys_interface_.systemContextGetBinaryInfo ||
                 nullptr == qnn_sys_interface_.systemContextFree;
@@ -660,6 +661,12 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
     for (uint32_t i = 0; i < graph_count; ++i) {
       std::string graph_name(graphs_info[i].graphInfoV1.graphName);
       auto qnn_model_pos = qnn_models.find(graph_name);
+      if (qnn_model_pos == qnn_models.end() && share_ep_contexts) {
+        // the graph belongs to another session sharing this context, which may outlive the logger of this session
+        qnn_model_pos = qnn_models.emplace(graph_name,
+                                           std::make_unique<qnn::QnnModel>(logging::LoggingManager::DefaultLogger(), this))
+                            .first;
+      }
       ORT_RETURN_IF(qnn_model_pos == qnn_models.end(), graph_name + " does not match any EPContext node names.");
       ORT_RETURN_IF_ERROR(qnn_model_pos->second->DeserializeGraphInfoFromBinaryInfo(graphs_info[i], context));
     }
@@ -206,6 +206,9 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     // User can set this context_node_name_prefix for each split pieces to avoid that happens.
     context_node_name_prefix_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionEpContextNodeNamePrefix, "");
     LOGS_DEFAULT(VERBOSE) << "User specified QNN context node name prefix: " << context_node_name_prefix_;
+
+    share_ep_contexts_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionShareEpContexts, "0") == "1";
+    LOGS_DEFAULT(VERBOSE) << "User specified option - share EP contexts across sessions: " << share_ep_contexts_;
   }
 
   static const std::string BACKEND_PATH = "backend_path";
@@ -385,7 +388,16 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     LOGS_DEFAULT(VERBOSE) << "User specified enable_htp_fp16_precision: " << enable_HTP_FP16_precision_;
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
+  // The sessions sharing EP contexts use the backend created by the first of them, along with its options
+  if (share_ep_contexts_) {
+    qnn_backend_manager_ = SharedContext::GetInstance().GetSharedQnnBackendManager();
+    if (qnn_backend_manager_) {
+      LOGS_DEFAULT(VERBOSE) << "Use the QNN backend shared with other sessions.";
+      return;
+    }
+  }
+
+  qnn_backend_manager_ = std::make_shared<qnn::QnnBackendManager>(
       std::move(backend_path),
       profiling_level_etw,
       profiling_level,
@@ -395,6 +407,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
       device_id_,
       htp_arch,
       soc_model);
+
+  if (share_ep_contexts_) {
+    SharedContext::GetInstance().SetSharedQnnBackendManager(qnn_backend_manager_);
+  }
 }
 
 QNNExecutionProvider::~QNNExecutionProvider() {
@@ -410,6 +426,10 @@ QNNExecutionProvider::~QNNExecutionProvider() {
 #ifdef _WIN32
   logging::EtwRegistrationManager::Instance().UnregisterInternalCallback(callback_ETWSink_provider_);
 #endif
+
+  if (share_ep_contexts_) {
+    SharedContext::GetInstance().ReleaseSharedQnnBackendManagerIfUnused();
+  }
 }
 
 // Logs information about the supported/unsupported nodes.
@@ -811,14 +831,31 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
     ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
                                                 logger, main_context_pos_list, qnn_models));
 
-    for (auto main_context_pos : main_context_pos_list) {
-      const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
-      // Create QNN context from the cached binary, deserialize the QNN graph from the binary
-      ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
-                                                       context_cache_path,
-                                                       qnn_backend_manager_.get(),
-                                                       qnn_models,
-                                                       logger));
+    // Take the graphs another session has already loaded from a shared context binary
+    bool all_graphs_shared = share_ep_contexts_;
+    if (share_ep_contexts_) {
+      for (auto& qnn_model : qnn_models) {
+        auto shared_qnn_model = SharedContext::GetInstance().GetSharedQnnModel(qnn_model.first);
+        if (shared_qnn_model) {
+          LOGS(logger, VERBOSE) << "Use the QNN graph shared with other sessions: " << qnn_model.first;
+          qnn_model.second = std::move(shared_qnn_model);
+        } else {
+          all_graphs_shared = false;
+        }
+      }
+    }
+
+    if (!all_graphs_shared) {
+      for (auto main_context_pos : main_context_pos_list) {
+        const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
+        // Create QNN context from the cached binary, deserialize the QNN graph from the binary
+        ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
+                                                         context_cache_path,
+                                                         qnn_backend_manager_.get(),
+                                                         qnn_models,
+                                                         logger,
+                                                         share_ep_contexts_));
+      }
     }
 
     for (auto fused_node_and_graph : fused_nodes_and_graphs) {
@@ -839,6 +876,15 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
       ORT_RETURN_IF_ERROR(CreateComputeFunc(node_compute_funcs, logger));
     }
 
+    // Keep the graphs of the context binary this session doesn't use for the sessions created later
+    if (share_ep_contexts_) {
+      for (auto& qnn_model : qnn_models) {
+        if (qnn_model.second) {
+          SharedContext::GetInstance().AddSharedQnnModel(qnn_model.first, std::move(qnn_model.second));
+        }
+      }
+    }
+
     return Status::OK();
   }
 
@@ -886,22 +932,90 @@ QNNExecutionProvider::PerThreadContext::PerThreadContext(qnn::QnnBackendManager*
   // set it once only for each thread as default so user don't need to set it for every session run
   if (is_htp_power_config_id_valid_) {
     if (qnn::HtpPerformanceMode::kHtpDefault != default_htp_performance_mode) {
-      ORT_IGNORE_RETURN_VALUE(qnn_backend_manager_->SetHtpPowerConfig(htp_power_config_id_,
-                                                                      default_htp_performance_mode));
+      ORT_IGNORE_RETURN_VALUE(SetHtpPerformanceMode(default_htp_performance_mode));
     }
     if (default_rpc_control_latency > 0) {
-      ORT_IGNORE_RETURN_VALUE(qnn_backend_manager_->SetRpcControlLatency(htp_power_config_id_,
-                                                                         default_rpc_control_latency));
+      ORT_IGNORE_RETURN_VALUE(SetRpcControlLatency(default_rpc_control_latency));
     }
   }
 }
 
 QNNExecutionProvider::PerThreadContext::~PerThreadContext() {
+  if (idle_vote_thread_.joinable()) {
+    {
+      std::lock_guard<OrtMutex> lock(vote_mutex_);
+      stop_idle_vote_thread_ = true;
+    }
+    vote_cv_.notify_one();
+    idle_vote_thread_.join();
+  }
+
   if (is_htp_power_config_id_valid_) {
     ORT_IGNORE_RETURN_VALUE(qnn_backend_manager_->DestroyHTPPowerConfigID(htp_power_config_id_));
   }
 }
 
+Status QNNExecutionProvider::PerThreadContext::SetHtpPerformanceMode(qnn::HtpPerformanceMode htp_performance_mode) {
+  std::lock_guard<OrtMutex> lock(vote_mutex_);
+  has_pending_vote_ = false;
+  if (htp_performance_mode != voted_htp_performance_mode_) {
+    ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(htp_power_config_id_, htp_performance_mode));
+    voted_htp_performance_mode_ = htp_performance_mode;
+  }
+
+  return Status::OK();
+}
+
+Status QNNExecutionProvider::PerThreadContext::SetRpcControlLatency(uint32_t rpc_control_latency) {
+  std::lock_guard<OrtMutex> lock(vote_mutex_);
+  if (rpc_control_latency != voted_rpc_control_latency_) {
+    ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetRpcControlLatency(htp_power_config_id_, rpc_control_latency));
+    voted_rpc_control_latency_ = rpc_control_latency;
+  }
+
+  return Status::OK();
+}
+
+void QNNExecutionProvider::PerThreadContext::ScheduleHtpPerformanceMode(qnn::HtpPerformanceMode htp_performance_mode,
+                                                                        std::chrono::milliseconds idle_timeout) {
+  {
+    std::lock_guard<OrtMutex> lock(vote_mutex_);
+    has_pending_vote_ = true;
+    pending_htp_performance_mode_ = htp_performance_mode;
+    pending_vote_deadline_ = std::chrono::steady_clock::now() + idle_timeout;
+    if (!idle_vote_thread_.joinable()) {
+      idle_vote_thread_ = std::thread(&PerThreadContext::IdleVoteLoop, this);
+    }
+  }
+  vote_cv_.notify_one();
+}
+
+void QNNExecutionProvider::PerThreadContext::IdleVoteLoop() {
+  std::unique_lock<OrtMutex> lock(vote_mutex_);
+  while (!stop_idle_vote_thread_) {
+    if (!has_pending_vote_) {
+      vote_cv_.wait(lock);
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < pending_vote_deadline_) {
+      vote_cv_.wait_for(lock, pending_vote_deadline_ - now);
+      continue;
+    }
+
+    has_pending_vote_ = false;
+    if (pending_htp_performance_mode_ != voted_htp_performance_mode_) {
+      Status status = qnn_backend_manager_->SetHtpPowerConfig(htp_power_config_id_, pending_htp_performance_mode_);
+      if (status.IsOK()) {
+        voted_htp_performance_mode_ = pending_htp_performance_mode_;
+      } else {
+        LOGS_DEFAULT(WARNING) << "Failed to set the HTP performance mode after the idle timeout: " << status.ErrorMessage();
+      }
+    }
+  }
+}
+
 QNNExecutionProvider::PerThreadContext& QNNExecutionProvider::GetPerThreadContext() const {
   const auto& per_thread_context_cache = PerThreadContextCache();
 
@@ -979,14 +1093,13 @@ Status QNNExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_optio
   }
 
   if (GetPerThreadContext().IsHtpPowerConfigIdValid()) {
+    // the vote is skipped when the mode is already voted, e.g. in a burst of runs with a post-run idle timeout
     if (qnn::HtpPerformanceMode::kHtpDefault != htp_performance_mode) {
-      ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(GetPerThreadContext().GetHtpPowerConfigId(),
-                                                                  htp_performance_mode));
+      ORT_RETURN_IF_ERROR(GetPerThreadContext().SetHtpPerformanceMode(htp_performance_mode));
     }
 
     if (rpc_control_latency > 0) {
-      ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetRpcControlLatency(GetPerThreadContext().GetHtpPowerConfigId(),
-                                                                     rpc_control_latency));
+      ORT_RETURN_IF_ERROR(GetPerThreadContext().SetRpcControlLatency(rpc_control_latency));
     }
   }
 
@@ -1010,8 +1123,20 @@ Status QNNExecutionProvider::OnRunEnd(bool /*sync_stream*/, const onnxruntime::R
     if (!GetPerThreadContext().IsHtpPowerConfigIdValid()) {
       return Status::OK();
     }
-    ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(GetPerThreadContext().GetHtpPowerConfigId(),
-                                                                htp_performance_mode));
+
+    std::string idle_timeout_string = "";
+    uint32_t idle_timeout_ms = 0;
+    if (run_options.config_options.TryGetConfigEntry(kOrtRunOptionsConfigQnnPerfModePostRunIdleTimeout,
+                                                     idle_timeout_string)) {
+      idle_timeout_ms = static_cast<uint32_t>(std::stoul(idle_timeout_string));
+    }
+
+    if (idle_timeout_ms > 0) {
+      GetPerThreadContext().ScheduleHtpPerformanceMode(htp_performance_mode,
+                                                       std::chrono::milliseconds(idle_timeout_ms));
+    } else {
+      ORT_RETURN_IF_ERROR(GetPerThreadContext().SetHtpPerformanceMode(htp_performance_mode));
+    }
   }
 
   return Status::OK();
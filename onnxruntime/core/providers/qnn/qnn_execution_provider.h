@@ -12,8 +12,10 @@
 #include "core/providers/qnn/builder/qnn_model.h"
 #include "core/providers/qnn/builder/qnn_configs_helper.h"
 #include "HTP/QnnHtpGraph.h"
+#include <chrono>
 #include <vector>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #ifdef _WIN32
 #include "core/platform/windows/logging/etw_sink.h"
@@ -23,6 +25,61 @@ namespace onnxruntime {
 
 void RunOnUnload(std::function<void()> function);
 
+// The QNN backend and the graphs shared by the sessions that enable ep.share_ep_contexts.
+// Graphs are loaded from a context binary by the first session that needs one of them. The other graphs of the binary
+// are kept here until a later session with an EPContext node of the same name takes them.
+class SharedContext {
+ public:
+  static SharedContext& GetInstance() {
+    static SharedContext instance;
+    return instance;
+  }
+
+  std::shared_ptr<qnn::QnnBackendManager> GetSharedQnnBackendManager() {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    return qnn_backend_manager_;
+  }
+
+  void SetSharedQnnBackendManager(std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    qnn_backend_manager_ = std::move(qnn_backend_manager);
+  }
+
+  // Drops the reference to the backend once there are no graphs left for later sessions. The sessions that use the
+  // backend keep it alive.
+  void ReleaseSharedQnnBackendManagerIfUnused() {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    if (shared_qnn_models_.empty()) {
+      qnn_backend_manager_.reset();
+    }
+  }
+
+  void AddSharedQnnModel(const std::string& graph_name, std::unique_ptr<qnn::QnnModel> qnn_model) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    shared_qnn_models_.emplace(graph_name, std::move(qnn_model));
+  }
+
+  // Takes the graph out of the shared context, returns nullptr if there is none with the name
+  std::unique_ptr<qnn::QnnModel> GetSharedQnnModel(const std::string& graph_name) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    auto it = shared_qnn_models_.find(graph_name);
+    if (it == shared_qnn_models_.end()) {
+      return nullptr;
+    }
+    auto qnn_model = std::move(it->second);
+    shared_qnn_models_.erase(it);
+    return qnn_model;
+  }
+
+ private:
+  SharedContext() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedContext);
+
+  OrtMutex mtx_;
+  std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> shared_qnn_models_;
+};
+
 // Logical device representation.
 class QNNExecutionProvider : public IExecutionProvider {
  public:
@@ -73,9 +130,10 @@ class QNNExecutionProvider : public IExecutionProvider {
 
  private:
   qnn::HtpGraphFinalizationOptimizationMode htp_graph_finalization_opt_mode_ = qnn::HtpGraphFinalizationOptimizationMode::kDefault;
-  std::unique_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
   std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> qnn_models_;
   bool context_cache_enabled_ = false;
+  bool share_ep_contexts_ = false;
   std::string context_cache_path_cfg_ = "";
   std::string context_node_name_prefix_ = "";
   bool disable_cpu_ep_fallback_ = false;  // True if CPU EP fallback has been disabled for this session.
@@ -104,10 +162,33 @@ class QNNExecutionProvider : public IExecutionProvider {
 
     uint32_t GetHtpPowerConfigId() { return htp_power_config_id_; }
 
+    // Votes the HTP performance mode, unless it is the mode voted last, and cancels the pending post-run vote.
+    Status SetHtpPerformanceMode(qnn::HtpPerformanceMode htp_performance_mode);
+
+    Status SetRpcControlLatency(uint32_t rpc_control_latency);
+
+    // Votes the HTP performance mode once no run has started on this thread for idle_timeout. A burst of runs keeps
+    // the performance mode of the runs instead of voting before and after each of them.
+    void ScheduleHtpPerformanceMode(qnn::HtpPerformanceMode htp_performance_mode,
+                                    std::chrono::milliseconds idle_timeout);
+
    private:
+    void IdleVoteLoop();
+
     bool is_htp_power_config_id_valid_ = false;
     uint32_t htp_power_config_id_ = 0;
     qnn::QnnBackendManager* qnn_backend_manager_;
+
+    // guards the members below, which are shared with idle_vote_thread_
+    OrtMutex vote_mutex_;
+    OrtCondVar vote_cv_;
+    qnn::HtpPerformanceMode voted_htp_performance_mode_ = qnn::HtpPerformanceMode::kHtpDefault;
+    uint32_t voted_rpc_control_latency_ = 0;
+    bool has_pending_vote_ = false;
+    qnn::HtpPerformanceMode pending_htp_performance_mode_ = qnn::HtpPerformanceMode::kHtpDefault;
+    std::chrono::steady_clock::time_point pending_vote_deadline_;
+    bool stop_idle_vote_thread_ = false;
+    std::thread idle_vote_thread_;
   };
 
   using PerThreadContextMap = std::unordered_map<const QNNExecutionProvider*, std::weak_ptr<PerThreadContext>>;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/common/inlined_containers.h"
+#include "core/common/parse_string.h"
 #include "core/providers/shared_library/provider_api.h"
 #include "core/platform/env_var_utils.h"
 #include "core/providers/rocm/rocm_execution_provider.h"
@@ -10,6 +11,7 @@
 #include "core/providers/rocm/rocm_fwd.h"
 #include "core/providers/rocm/gpu_data_transfer.h"
 #include "core/providers/rocm/rocm_profiler.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
 
 #ifndef DISABLE_CONTRIB_OPS
 #include "contrib_ops/rocm/rocm_contrib_kernels.h"
@@ -187,32 +189,66 @@ ROCMExecutionProvider::PerThreadContext::~PerThreadContext() {
   ORT_IGNORE_RETURN_VALUE(MIOPEN_CALL(miopenDestroy(miopen_handle_)));
 }
 
-bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptureAllowed() const {
-  return regular_run_count_before_graph_capture_ >= min_num_runs_before_hip_graph_capture_;
+bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptureAllowed(
+    RocmGraphAnnotation_t hip_graph_annotation_id) const {
+  if (!IsGraphCaptureAllowedOnRun(hip_graph_annotation_id)) {
+    return false;
+  }
+  if (graph_id_to_run_count_.find(hip_graph_annotation_id) == graph_id_to_run_count_.end()) {
+    return false;
+  }
+  return graph_id_to_run_count_.at(hip_graph_annotation_id) >= min_num_runs_before_hip_graph_capture_;
 }
 
-void ROCMExecutionProvider::PerThreadContext::CaptureBegin(int) {
-  hip_graph_.Reset();
-  hip_graph_.CaptureBegin(0);
+bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptureAllowedOnRun(
+    RocmGraphAnnotation_t hip_graph_annotation_id) const {
+  return hip_graph_.IsGraphCaptureAllowedOnRun(hip_graph_annotation_id);
 }
 
-void ROCMExecutionProvider::PerThreadContext::CaptureEnd(int) {
-  hip_graph_.CaptureEnd(0);
-  is_graph_captured_ = true;
+RocmGraphAnnotation_t ROCMExecutionProvider::PerThreadContext::GetRocmGraphAnnotationId(
+    const onnxruntime::RunOptions& run_options) const {
+  auto graph_annotation_str =
+      run_options.GetConfigOptions().GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation);
+  // If graph annotation is not provided, fall back to the one hip graph per session behavior
+  RocmGraphAnnotation_t hip_graph_annotation_id = 0;
+  if (graph_annotation_str.has_value()) {
+    ORT_ENFORCE(TryParseStringWithClassicLocale<int>(*graph_annotation_str, hip_graph_annotation_id),
+                "Failed to parse the hip graph annotation id: ",
+                *graph_annotation_str);
+  }
+
+  return hip_graph_annotation_id;
 }
 
-bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptured(int) const {
-  return is_graph_captured_;
+void ROCMExecutionProvider::PerThreadContext::CaptureBegin(RocmGraphAnnotation_t hip_graph_annotation_id) {
+  hip_graph_.CaptureBegin(hip_graph_annotation_id);
 }
 
-Status ROCMExecutionProvider::PerThreadContext::ReplayGraph(int graph_annotation_id) {
-  ORT_ENFORCE(IsGraphCaptured(graph_annotation_id));
+void ROCMExecutionProvider::PerThreadContext::CaptureEnd(RocmGraphAnnotation_t hip_graph_annotation_id) {
+  hip_graph_.CaptureEnd(hip_graph_annotation_id);
+}
+
+bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptured(RocmGraphAnnotation_t hip_graph_annotation_id) const {
+  return hip_graph_.IsGraphCaptured(hip_graph_annotation_id);
+}
 
-  return hip_graph_.Replay(graph_annotation_id);
+Status ROCMExecutionProvider::PerThreadContext::ReplayGraph(RocmGraphAnnotation_t hip_graph_annotation_id) {
+  return hip_graph_.Replay(hip_graph_annotation_id);
 }
 
-void ROCMExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture() {
-  ++regular_run_count_before_graph_capture_;
+void ROCMExecutionProvider::PerThreadContext::ReleaseGraph(RocmGraphAnnotation_t hip_graph_annotation_id) {
+  hip_graph_.Release(hip_graph_annotation_id);
+  // the regular runs needed before the capture start over when the annotation id is captured again.
+  graph_id_to_run_count_.erase(hip_graph_annotation_id);
+}
+
+void ROCMExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture(
+    RocmGraphAnnotation_t hip_graph_annotation_id) {
+  if (graph_id_to_run_count_.find(hip_graph_annotation_id) == graph_id_to_run_count_.end()) {
+    graph_id_to_run_count_[hip_graph_annotation_id] = 1;
+    return;
+  }
+  graph_id_to_run_count_[hip_graph_annotation_id]++;
 }
 
 void OverrideTunableOpInfoByEnv(ROCMExecutionProviderInfo& info) {
@@ -364,26 +400,28 @@ Status ROCMExecutionProvider::Sync() const {
   return Status::OK();
 }
 
-Status ROCMExecutionProvider::OnRunStart(const onnxruntime::RunOptions& /*run_options*/) {
+Status ROCMExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_options) {
   // always set ROCM device when session::Run() in case it runs in a worker thread
   HIP_RETURN_IF_ERROR(hipSetDevice(GetDeviceId()));
-  if (IsGraphCaptureEnabled() && GetPerThreadContext().IsGraphCaptureAllowed() &&
-      !GetPerThreadContext().IsGraphCaptured(0)) {
-    LOGS_DEFAULT(INFO) << "Capturing the hip graph for this model";
-    GetPerThreadContext().CaptureBegin(0);
+  RocmGraphAnnotation_t hip_graph_annotation_id = GetPerThreadContext().GetRocmGraphAnnotationId(run_options);
+  if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured(hip_graph_annotation_id) &&
+      GetPerThreadContext().IsGraphCaptureAllowed(hip_graph_annotation_id)) {
+    LOGS(*GetLogger(), INFO) << "Capturing the hip graph for this model";
+    GetPerThreadContext().CaptureBegin(hip_graph_annotation_id);
   }
   return Status::OK();
 }
 
-Status ROCMExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& /*run_options*/) {
-  if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured(0)) {
-    if (GetPerThreadContext().IsGraphCaptureAllowed()) {
-      GetPerThreadContext().CaptureEnd(0);
+Status ROCMExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& run_options) {
+  RocmGraphAnnotation_t hip_graph_annotation_id = GetPerThreadContext().GetRocmGraphAnnotationId(run_options);
+  if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured(hip_graph_annotation_id)) {
+    if (GetPerThreadContext().IsGraphCaptureAllowed(hip_graph_annotation_id)) {
+      GetPerThreadContext().CaptureEnd(hip_graph_annotation_id);
       // HIP work issued to a capturing stream doesn’t actually run on the GPU,
       // so run the captured graph here to actually execute the work.
-      ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph(0));
+      ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph(hip_graph_annotation_id));
     } else {
-      GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture();
+      GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture(hip_graph_annotation_id);
     }
   }
 
@@ -412,12 +450,17 @@ bool ROCMExecutionProvider::IsGraphCaptureEnabled() const {
   return info_.enable_hip_graph;
 }
 
-bool ROCMExecutionProvider::IsGraphCaptured(int) const {
-  return GetPerThreadContext().IsGraphCaptured(0);
+bool ROCMExecutionProvider::IsGraphCaptured(RocmGraphAnnotation_t graph_annotation_id) const {
+  return GetPerThreadContext().IsGraphCaptured(graph_annotation_id);
 }
 
-Status ROCMExecutionProvider::ReplayGraph(int /*graph_annotation_id*/) {
-  return GetPerThreadContext().ReplayGraph(0);
+Status ROCMExecutionProvider::ReplayGraph(RocmGraphAnnotation_t graph_annotation_id) {
+  return GetPerThreadContext().ReplayGraph(graph_annotation_id);
+}
+
+Status ROCMExecutionProvider::ReleaseGraph(RocmGraphAnnotation_t graph_annotation_id) {
+  GetPerThreadContext().ReleaseGraph(graph_annotation_id);
+  return Status::OK();
 }
 
 namespace rocm {
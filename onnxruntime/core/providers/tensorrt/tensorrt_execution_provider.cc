@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <list>
+#include <thread>
 #include <unordered_set>
 #include "core/providers/shared_library/provider_api.h"
 #define ORT_API_MANUAL_INIT
@@ -248,6 +251,63 @@ inline void saveTimingCacheFile(const std::string outFileName, const nvinfer1::I
   oFile.write((char*)blob->data(), blob->size());
   oFile.close();
 }
+
+// Timing cache shared by the engine builds of all the TRT EP instances of the process.
+// A timing cache saved to disk is keyed by its path and loaded on first use. Otherwise it is keyed by the compute capability.
+struct SharedTimingCache {
+  OrtMutex mutex;
+  bool loaded = false;
+  std::vector<char> data;
+};
+
+SharedTimingCache& GetSharedTimingCache(const std::string& key) {
+  static OrtMutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<SharedTimingCache>> caches;
+  std::lock_guard<OrtMutex> lock(mutex);
+  auto& cache = caches[key];
+  if (cache == nullptr) {
+    cache = std::make_unique<SharedTimingCache>();
+  }
+  return *cache;
+}
+
+// Create a timing cache for an engine build from the shared timing cache
+std::unique_ptr<nvinfer1::ITimingCache> CreateTimingCacheFromSharedCache(nvinfer1::IBuilderConfig& trt_config,
+                                                                         const std::string& key,
+                                                                         const std::string& timing_cache_path) {
+  auto& shared_cache = GetSharedTimingCache(key);
+  std::lock_guard<OrtMutex> lock(shared_cache.mutex);
+  if (!shared_cache.loaded && !timing_cache_path.empty()) {
+    shared_cache.data = loadTimingCacheFile(timing_cache_path);
+  }
+  shared_cache.loaded = true;
+  return std::unique_ptr<nvinfer1::ITimingCache>(
+      trt_config.createTimingCache(static_cast<const void*>(shared_cache.data.data()), shared_cache.data.size()));
+}
+
+// Merge the timing cache of an engine build into the shared timing cache and save it to timing_cache_path if it is not empty.
+// The shared timing cache may have been updated by concurrent builds since the build started, so the caches are combined.
+bool MergeTimingCacheIntoSharedCache(nvinfer1::IBuilderConfig& trt_config,
+                                     const std::string& key,
+                                     const std::string& timing_cache_path) {
+  auto& shared_cache = GetSharedTimingCache(key);
+  std::lock_guard<OrtMutex> lock(shared_cache.mutex);
+  std::unique_ptr<nvinfer1::ITimingCache> merged_cache{
+      trt_config.createTimingCache(static_cast<const void*>(shared_cache.data.data()), shared_cache.data.size())};
+  if (merged_cache == nullptr || !merged_cache->combine(*trt_config.getTimingCache(), true /* ignore mismatch */)) {
+    return false;
+  }
+  std::unique_ptr<nvinfer1::IHostMemory> timing_cache_host_data{merged_cache->serialize()};
+  if (timing_cache_host_data == nullptr) {
+    return false;
+  }
+  const char* data = static_cast<const char*>(timing_cache_host_data->data());
+  shared_cache.data.assign(data, data + timing_cache_host_data->size());
+  if (!timing_cache_path.empty()) {
+    saveTimingCacheFile(timing_cache_path, timing_cache_host_data.get());
+  }
+  return true;
+}
 }  // namespace
 
 namespace google {
@@ -772,6 +832,95 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
   return Status::OK();
 }
 
+/*
+ * Set the min/max/opt shapes of an optimization profile from the shape ranges of the dynamic shape inputs.
+ */
+void SetProfileShapesFromShapeRanges(nvinfer1::IOptimizationProfile& trt_profile,
+                                     nvinfer1::INetworkDefinition& trt_network,
+                                     const ShapeRangesMap& shape_ranges) {
+  for (int i = 0, end = trt_network.getNbInputs(); i < end; ++i) {
+    auto input = trt_network.getInput(i);
+    const std::string& input_name = input->getName();
+    const auto iter = shape_ranges.find(input_name);
+    if (iter == shape_ranges.end()) {
+      continue;
+    }
+    const auto& shape_ranges_per_input = iter->second;
+    if (input->isShapeTensor()) {
+      // shape tensor
+      int shape_size = static_cast<int>(shape_ranges_per_input.size());
+      std::vector<int32_t> shapes_min(shape_size), shapes_opt(shape_size), shapes_max(shape_size);
+      for (const auto& [j, shape_range] : shape_ranges_per_input) {
+        shapes_min[j] = static_cast<int32_t>(shape_range[0][0]);
+        shapes_max[j] = static_cast<int32_t>(shape_range[0][1]);
+        shapes_opt[j] = static_cast<int32_t>(shape_range[0][2]);
+      }
+      trt_profile.setShapeValues(input_name.c_str(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], shape_size);
+      trt_profile.setShapeValues(input_name.c_str(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], shape_size);
+      trt_profile.setShapeValues(input_name.c_str(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], shape_size);
+    } else {
+      // execution tensor
+      nvinfer1::Dims dims = input->getDimensions();
+      nvinfer1::Dims dims_min(dims), dims_opt(dims), dims_max(dims);
+      for (const auto& [j, shape_range] : shape_ranges_per_input) {
+        dims_min.d[j] = static_cast<int32_t>(shape_range[0][0]);
+        dims_max.d[j] = static_cast<int32_t>(shape_range[0][1]);
+        dims_opt.d[j] = static_cast<int32_t>(shape_range[0][2]);
+      }
+      trt_profile.setDimensions(input_name.c_str(), nvinfer1::OptProfileSelector::kMIN, dims_min);
+      trt_profile.setDimensions(input_name.c_str(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+      trt_profile.setDimensions(input_name.c_str(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
+    }
+  }
+}
+
+/*
+ * Propose shape ranges for the dynamic shape inputs of a fused node from the input shapes observed by its runs.
+ *
+ * The min/max shapes of the current shape ranges already cover every observed shape, so only the opt shapes change.
+ * The opt shape of an execution tensor becomes its most frequent shape rather than the largest one, since TRT picks
+ * the kernels of the engine for the opt shapes.
+ */
+ShapeRangesMap ProposeShapeRanges(const ShapeRangesMap& shape_ranges, const ShapeHistogram& shape_histogram) {
+  ShapeRangesMap proposed_shape_ranges = shape_ranges;
+  for (const auto& [input_name, shape_counts] : shape_histogram.shape_counts) {
+    auto iter = proposed_shape_ranges.find(input_name);
+    if (iter == proposed_shape_ranges.end() || shape_counts.empty()) {
+      continue;
+    }
+    const auto& most_frequent_shape = std::max_element(shape_counts.begin(), shape_counts.end(),
+                                                       [](const auto& a, const auto& b) { return a.second < b.second; })
+                                          ->first;
+    for (auto& [j, shape_range] : iter->second) {
+      auto& range = shape_range[0];  // only has one profile
+      if (j < most_frequent_shape.size() && most_frequent_shape[j] >= range[0] && most_frequent_shape[j] <= range[1]) {
+        range[2] = most_frequent_shape[j];
+      }
+    }
+  }
+  return proposed_shape_ranges;
+}
+
+/*
+ * Check whether the min/max shapes of an engine cover the current shape ranges of a fused node.
+ */
+bool ShapeRangesCover(const ShapeRangesMap& engine_shape_ranges, const ShapeRangesMap& shape_ranges) {
+  for (const auto& [input_name, shape_ranges_per_input] : shape_ranges) {
+    auto iter = engine_shape_ranges.find(input_name);
+    if (iter == engine_shape_ranges.end()) {
+      return false;
+    }
+    for (const auto& [j, shape_range] : shape_ranges_per_input) {
+      auto range_iter = iter->second.find(j);
+      if (range_iter == iter->second.end() ||
+          range_iter->second[0][0] > shape_range[0][0] || range_iter->second[0][1] < shape_range[0][1]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 #define CASE_GET_INPUT_TENSOR(DATA_TYPE, SrcT)                                              \
   case DATA_TYPE: {                                                                         \
     auto input_tensor_ptr = input_tensor.GetTensorData<SrcT>();                             \
@@ -1379,6 +1528,8 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     profile_opt_shapes = info.profile_opt_shapes;
     cuda_graph_enable_ = info.cuda_graph_enable;
     engine_hw_compatible_ = info.engine_hw_compatible;
+    engine_refit_enable_ = info.engine_refit_enable;
+    profile_auto_update_runs_ = info.profile_auto_update_runs;
   } else {
     try {
       const std::string max_partition_iterations_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kMaxPartitionIterations);
@@ -1633,6 +1784,26 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
 #endif
   }
 
+  // Engine refit: weight-stripped engines are always refitted, and the weights are only compared against engine caches
+  if (engine_refit_enable_) {
+#if NV_TENSORRT_MAJOR >= 10
+    if (weight_stripped_engine_enable_ || !engine_cache_enable_ || engine_decryption_enable_) {
+      LOGS_DEFAULT(WARNING) << "Engine refit requires an unencrypted engine cache of engines that are not weight-stripped. ";
+      engine_refit_enable_ = false;
+    }
+#else
+    LOGS_DEFAULT(WARNING) << "Engine refit cannot be enabled as TRT < 10.0. ";
+    engine_refit_enable_ = false;
+#endif
+  }
+
+  // Profile auto update: a captured CUDA graph would keep launching the replaced engine, and weight-stripped engines
+  // need a refit before they can run
+  if (profile_auto_update_runs_ > 0 && (cuda_graph_enable_ || weight_stripped_engine_enable_)) {
+    LOGS_DEFAULT(WARNING) << "Profile auto update cannot be enabled with CUDA graph or weight-stripped engines. ";
+    profile_auto_update_runs_ = 0;
+  }
+
   if (engine_cache_enable_ || int8_enable_ || timing_cache_enable_) {
     if (!cache_path_.empty() && !fs::is_directory(cache_path_)) {
       if (!fs::create_directory(cache_path_)) {
@@ -1762,10 +1933,19 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
                         << ", trt_ep_context_embed_mode: " << ep_context_embed_mode_
                         << ", trt_cache_prefix: " << cache_prefix_
                         << ", trt_engine_hw_compatible: " << engine_hw_compatible_
+                        << ", trt_engine_refit_enable: " << engine_refit_enable_
+                        << ", trt_profile_auto_update_runs: " << profile_auto_update_runs_
                         << ", trt_onnx_model_bytestream_size_: " << onnx_model_bytestream_size_;
 }
 
 TensorrtExecutionProvider::~TensorrtExecutionProvider() {
+  // wait for the engine builds in the background, which use the TRT objects of the fused nodes
+  for (auto& background_engine_build : background_engine_builds_) {
+    if (background_engine_build.second.valid()) {
+      background_engine_build.second.wait();
+    }
+  }
+
   // clean up thread local context caches
   {
     std::lock_guard<OrtMutex> lock(context_state_.mutex);
@@ -2681,37 +2861,100 @@ common::Status TensorrtExecutionProvider::RefitEngine(std::string onnx_model_fil
 
 common::Status TensorrtExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
                                                   std::vector<NodeComputeInfo>& node_compute_funcs) {
+  // The engines of independent fused nodes are built concurrently unless sequential engine build is forced.
+  // Fused nodes with a precompiled engine are always handled on this thread.
+  size_t num_engine_builds = 0;
   for (auto& fused_node_graph : fused_nodes_and_graphs) {
-    const GraphViewer& graph_body_viewer = fused_node_graph.filtered_graph;
-    const Node& fused_node = fused_node_graph.fused_node;
+    if (!GraphHasCtxNode(fused_node_graph.filtered_graph)) {
+      ++num_engine_builds;
+    }
+  }
+  const bool parallel_engine_build = !force_sequential_engine_build_ && num_engine_builds > 1;
+
+  std::vector<std::vector<NodeComputeInfo>> fused_node_compute_funcs(fused_nodes_and_graphs.size());
+  std::vector<Status> statuses(fused_nodes_and_graphs.size());
+  auto compile_fused_node = [&](size_t i) {
+    const GraphViewer& graph_body_viewer = fused_nodes_and_graphs[i].filtered_graph;
+    const Node& fused_node = fused_nodes_and_graphs[i].fused_node;
     // Build map from input name to its index in input definitions
     std::unordered_map<std::string, size_t> input_map;
     const auto& input_defs = fused_node.InputDefs();
     input_map.reserve(input_defs.size());
-    for (size_t i = 0, end = input_defs.size(); i < end; ++i) {
-      input_map[input_defs[i]->Name()] = i;
+    for (size_t j = 0, end = input_defs.size(); j < end; ++j) {
+      input_map[input_defs[j]->Name()] = j;
     }
 
     // Build map from output name to its index in output definitions
     std::unordered_map<std::string, size_t> output_map;
     const auto& output_defs = fused_node.OutputDefs();
     output_map.reserve(output_defs.size());
-    for (size_t i = 0, end = output_defs.size(); i < end; ++i) {
-      output_map[output_defs[i]->Name()] = i;
+    for (size_t j = 0, end = output_defs.size(); j < end; ++j) {
+      output_map[output_defs[j]->Name()] = j;
     }
 
-    Status status;
     if (GraphHasCtxNode(graph_body_viewer)) {
-      status = CreateNodeComputeInfoFromPrecompiledEngine(graph_body_viewer,
-                                                          fused_node,
-                                                          input_map,
-                                                          output_map,
-                                                          node_compute_funcs);
+      statuses[i] = CreateNodeComputeInfoFromPrecompiledEngine(graph_body_viewer,
+                                                               fused_node,
+                                                               input_map,
+                                                               output_map,
+                                                               fused_node_compute_funcs[i]);
     } else {
-      status = CreateNodeComputeInfoFromGraph(graph_body_viewer, fused_node, input_map, output_map, node_compute_funcs);
+      statuses[i] = CreateNodeComputeInfoFromGraph(graph_body_viewer, fused_node, input_map, output_map,
+                                                   fused_node_compute_funcs[i], parallel_engine_build);
+    }
+  };
+
+  if (parallel_engine_build) {
+    std::vector<size_t> engine_builds;
+    for (size_t i = 0; i < fused_nodes_and_graphs.size(); ++i) {
+      if (GraphHasCtxNode(fused_nodes_and_graphs[i].filtered_graph)) {
+        compile_fused_node(i);
+      } else {
+        engine_builds.push_back(i);
+      }
+    }
+
+    std::atomic<size_t> next_engine_build{0};
+    auto engine_build_worker = [&]() {
+      for (size_t k = next_engine_build++; k < engine_builds.size(); k = next_engine_build++) {
+        const size_t i = engine_builds[k];
+        ORT_TRY {
+          // TRT builds on the current device of the calling thread
+          CUDA_CALL_THROW(cudaSetDevice(device_id_));
+          compile_fused_node(i);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, ex.what());
+          });
+        }
+      }
+    };
+
+    const size_t num_threads = std::min<size_t>(engine_builds.size(), std::max(1U, std::thread::hardware_concurrency()));
+    std::vector<std::thread> engine_build_threads;
+    engine_build_threads.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      engine_build_threads.emplace_back(engine_build_worker);
+    }
+    for (auto& engine_build_thread : engine_build_threads) {
+      engine_build_thread.join();
+    }
+  } else {
+    for (size_t i = 0; i < fused_nodes_and_graphs.size(); ++i) {
+      compile_fused_node(i);
+      if (statuses[i] != Status::OK()) {
+        break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < fused_nodes_and_graphs.size(); ++i) {
+    if (statuses[i] != Status::OK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, statuses[i].ErrorMessage());
     }
-    if (status != Status::OK()) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, status.ErrorMessage());
+    for (auto& compute_info : fused_node_compute_funcs[i]) {
+      node_compute_funcs.push_back(std::move(compute_info));
     }
   }
   return Status::OK();
@@ -2721,7 +2964,13 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
                                                                  const Node& fused_node,
                                                                  std::unordered_map<std::string, size_t>& input_map,
                                                                  std::unordered_map<std::string, size_t>& output_map,
-                                                                 std::vector<NodeComputeInfo>& node_compute_funcs) {
+                                                                 std::vector<NodeComputeInfo>& node_compute_funcs,
+                                                                 bool parallel_engine_build) {
+  std::unique_lock<OrtMutex> compile_lock(compile_mu_, std::defer_lock);
+  if (parallel_engine_build) {
+    compile_lock.lock();
+  }
+
   // Reconstruct graph proto from fused node's function body
   auto model = graph_body_viewer.CreateModel(*GetLogger());
   auto model_proto = model->ToProto();
@@ -2742,7 +2991,15 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
   }
 
   TensorrtLogger& trt_logger = GetTensorrtLogger(detailed_build_log_);
-  auto trt_builder = GetBuilder(trt_logger);
+  nvinfer1::IBuilder* trt_builder = nullptr;
+  if (parallel_engine_build) {
+    // A builder may only be used by one thread at a time
+    auto& builder = builders_[fused_node.Name()];
+    builder = std::unique_ptr<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(trt_logger));
+    trt_builder = builder.get();
+  } else {
+    trt_builder = GetBuilder(trt_logger);
+  }
   auto network_flags = 0;
 #if NV_TENSORRT_MAJOR > 8
   network_flags |= fp16_enable_ || int8_enable_ ? 0 : 1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kSTRONGLY_TYPED);
@@ -3020,6 +3277,11 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
 #endif
   }
 
+  if (engine_refit_enable_) {
+    trt_config->setFlag(nvinfer1::BuilderFlag::kREFIT);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] REFIT is enabled";
+  }
+
   // limit used tactic sources
   if (!tactic_sources_.empty()) {
     nvinfer1::TacticSources tactics = trt_config->getTacticSources();
@@ -3061,6 +3323,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
   std::string engine_cache_path = cache_path_prefix + ".engine";
   const std::string encrypted_engine_cache_path = engine_cache_path + ".encrypted";
   const std::string profile_cache_path = cache_path_prefix + ".profile";
+  const std::string weights_cache_path = cache_path_prefix + ".weights";
 
   // If weight-stripped engine is enabled and refitted engine cache is not present,
   // TRT EP will use the engine cache with ".stripped.engine" appended to the end.
@@ -3081,6 +3344,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     if (timing_cache_enable_) {
       timing_cache_path = GetTimingCachePath(global_cache_path_, compute_capability_);
     }
+    const std::string timing_cache_key = timing_cache_enable_ ? timing_cache_path : "sm" + compute_capability_;
     {
       // ifstream file check, engine serialization/deserialization and engine build are in critical section. It needs lock protection to prevent race condition when inferencing with multithreading.
       auto lock = GetApiLock();
@@ -3129,7 +3393,42 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                  "TensorRT EP could not deserialize engine from encrypted cache: " + encrypted_engine_cache_path);
         }
-      } else {
+      }
+
+      // The engine cache name doesn't depend on the weights. If the weights of the fused node have changed since the
+      // engine was built, refit the engine with the current weights instead of rebuilding it.
+      std::string weights_hash;
+      if (engine_refit_enable_) {
+        weights_hash = GetWeightsHash(string_buf);
+        if (trt_engine != nullptr && !CompareWeightsHash(weights_cache_path, weights_hash)) {
+          auto status = trt_engine->isRefittable()
+                            ? Status::OK()
+                            : ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP engine cache is not refittable: " + engine_cache_path);
+          if (status == Status::OK()) {
+            status = RefitEngine(model_path_,
+                                 onnx_model_folder_path_,
+                                 engine_cache_path,
+                                 false /* path check for security */,
+                                 string_buf.data(),
+                                 string_buf.size(),
+                                 trt_engine.get(),
+                                 false /* serialize refitted engine to disk */,
+                                 detailed_build_log_);
+          }
+          if (status == Status::OK()) {
+            std::unique_ptr<nvinfer1::IHostMemory> serialized_engine{trt_engine->serialize()};
+            std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
+            file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
+            SerializeWeightsHash(weights_cache_path, weights_hash);
+            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized refitted engine " + engine_cache_path;
+          } else {
+            LOGS_DEFAULT(WARNING) << "[TensorRT EP] " << status.ErrorMessage() << ". The engine will be rebuilt.";
+            trt_engine.reset();
+          }
+        }
+      }
+
+      if (trt_engine == nullptr) {
         // Set INT8 per tensor dynamic range
         if (int8_enable_ && trt_builder->platformHasFastInt8() && int8_calibration_cache_available_) {
 #if defined(_MSC_VER)
@@ -3146,27 +3445,31 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
           }
         }
 
-        // Load timing cache from file. Create a fresh cache if the file doesn't exist
-        std::unique_ptr<nvinfer1::ITimingCache> timing_cache = nullptr;
-        if (timing_cache_enable_) {
-          std::vector<char> loaded_timing_cache = loadTimingCacheFile(timing_cache_path);
-          timing_cache.reset(trt_config->createTimingCache(static_cast<const void*>(loaded_timing_cache.data()), loaded_timing_cache.size()));
-          if (timing_cache == nullptr) {
-            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                   "TensorRT EP could not create timing cache: " + timing_cache_path);
-          }
-          trt_config->setTimingCache(*timing_cache, force_timing_cache_match_);
-          if (detailed_build_log_) {
-            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Deserialized timing cache from " + timing_cache_path;
-          }
+        // Start from the timing cache shared within the process, which is loaded from file if timing cache is enabled
+        std::unique_ptr<nvinfer1::ITimingCache> timing_cache = CreateTimingCacheFromSharedCache(*trt_config, timing_cache_key, timing_cache_path);
+        if (timing_cache == nullptr) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                 "TensorRT EP could not create timing cache: " + timing_cache_key);
+        }
+        trt_config->setTimingCache(*timing_cache, force_timing_cache_match_);
+        if (detailed_build_log_ && timing_cache_enable_) {
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Deserialized timing cache from " + timing_cache_path;
         }
 
-        // Build engine
+        // Build engine. The engines of other fused nodes may be built meanwhile.
         std::chrono::steady_clock::time_point engine_build_start;
         if (detailed_build_log_) {
           engine_build_start = std::chrono::steady_clock::now();
         }
+        if (parallel_engine_build) {
+          lock.unlock();
+          compile_lock.unlock();
+        }
         std::unique_ptr<nvinfer1::IHostMemory> serialized_engine{trt_builder->buildSerializedNetwork(*trt_network, *trt_config)};
+        if (parallel_engine_build) {
+          compile_lock.lock();
+          lock.lock();
+        }
         if (serialized_engine == nullptr) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                  "TensorRT EP failed to create engine from network for fused node: " + fused_node.Name());
@@ -3203,20 +3506,18 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
             file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized engine " + engine_cache_path;
           }
-        }
-        // serialize and save timing cache
-        if (timing_cache_enable_) {
-          auto timing_cache = trt_config->getTimingCache();
-          std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
-          if (timingCacheHostData == nullptr) {
-            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                   "TensorRT EP could not serialize timing cache: " + timing_cache_path);
-          }
-          saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
-          if (detailed_build_log_) {
-            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
+          if (engine_refit_enable_) {
+            SerializeWeightsHash(weights_cache_path, weights_hash);
           }
         }
+        // merge the timing cache into the shared timing cache and save it
+        if (!MergeTimingCacheIntoSharedCache(*trt_config, timing_cache_key, timing_cache_path)) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                 "TensorRT EP could not serialize timing cache: " + timing_cache_key);
+        }
+        if (detailed_build_log_ && timing_cache_enable_) {
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
+        }
         // dump EP context node model
         if (dump_ep_context_model_) {
           // "ep_cache_context" node attribute should be a relative path to context model directory
@@ -3357,7 +3658,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     if (!tactic_sources_.empty()) {
       tactics = GetTacticSourceFromString(tactic_sources_);
     }
-    *p = {context->allocate_func, context->release_func, context->allocator_handle, context->node_name, builder_.get(),
+    *p = {context->allocate_func, context->release_func, context->allocator_handle, context->node_name, trt_builder,
           &parsers_[context->node_name], &engines_[context->node_name], &contexts_[context->node_name],
           &networks_[context->node_name], input_info_[context->node_name], output_info_[context->node_name],
           input_shape_ranges_[context->node_name], &tensorrt_mu_, fp16_enable_, int8_enable_, int8_calibration_cache_available_,
@@ -3447,6 +3748,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     if (timing_cache_enable_) {
       timing_cache_path = GetTimingCachePath(global_cache_path_, compute_capability_);
     }
+    const std::string timing_cache_key = timing_cache_enable_ ? timing_cache_path : "sm" + compute_capability_;
 
     // If weight-stripped engine is enabled and refitted engine cache is not present,
     // TRT EP will use the engine cache with ".stripped.engine" appended to the end.
@@ -3514,7 +3816,33 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       }
     }
 
+    // Swap in the engine built in the background for the observed input shapes, unless the shape ranges have been
+    // extended since the build started. The runs used the previous engine while it was being built.
+    auto& background_engine_build = background_engine_builds_[fused_node_name];
+    if (background_engine_build.valid() &&
+        background_engine_build.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      BackgroundEngineBuild engine_build = background_engine_build.get();
+      if (engine_build.status != Status::OK()) {
+        LOGS_DEFAULT(WARNING) << "[TensorRT EP] " << engine_build.status.ErrorMessage();
+      } else if (ShapeRangesCover(engine_build.shape_ranges, shape_ranges)) {
+        // Destroy the IExecutionContext objects before destroying an engine object, otherwise it will lead to undefined behavior.
+        trt_state->context->reset();
+        *(trt_state->engine) = std::move(engine_build.engine);
+        shape_ranges = std::move(engine_build.shape_ranges);
+        trt_engine = trt_state->engine->get();
+        context_update = true;
+        LOGS_DEFAULT(INFO) << "[TensorRT EP] Swapped in the engine built for the most frequent input shapes of " << fused_node_name;
+        if (trt_state->engine_cache_enable && !trt_state->engine_decryption_enable) {
+          SerializeProfileV2(profile_cache_path, shape_ranges);
+          std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
+          file.write(reinterpret_cast<char*>(engine_build.serialized_engine->data()), engine_build.serialized_engine->size());
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
+        }
+      }
+    }
+
     // Check and update shape ranges for dynamic shape inputs.
+    auto& shape_histogram = shape_histograms_[fused_node_name];
     for (int i = 0, end = num_inputs; i < end; ++i) {
       auto input = trt_state->network->get()->getInput(i);
       const std::string& input_name = input->getName();
@@ -3527,6 +3855,29 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
         if (status != Status::OK()) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to parse input tensor and generate optimization profiles.");
         }
+
+        // Record the input shape in the shape histogram
+        if (profile_auto_update_runs_ > 0 && !input->isShapeTensor()) {
+          size_t input_index = 0;
+          const auto iter = input_indexes.find(input_name);
+          if (iter != input_indexes.end()) {
+            input_index = iter->second;
+          }
+          auto input_tensor = ctx.GetInput(input_index);
+          ++shape_histogram.shape_counts[input_name][input_tensor.GetTensorTypeAndShapeInfo().GetShape()];
+        }
+      }
+    }
+
+    // Rebuild the engine in the background when the most frequent input shapes are not the opt shapes of the engine
+    if (profile_auto_update_runs_ > 0 && !shape_ranges.empty() &&
+        ++shape_histogram.num_runs % profile_auto_update_runs_ == 0 && !background_engine_build.valid()) {
+      ShapeRangesMap proposed_shape_ranges = ProposeShapeRanges(shape_ranges, shape_histogram);
+      if (proposed_shape_ranges != shape_ranges) {
+        LOGS_DEFAULT(INFO) << "[TensorRT EP] Building the engine of " << fused_node_name
+                           << " in the background for the most frequent input shapes";
+        background_engine_build = std::async(std::launch::async, &TensorrtExecutionProvider::BuildEngineForShapeRanges,
+                                             this, trt_state, std::move(proposed_shape_ranges));
       }
     }
 
@@ -3535,114 +3886,26 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // Destroy the IExecutionContext objects before destroying an engine object, otherwise it will lead to undefined behavior.
       trt_state->context->reset();
       trt_state->engine->reset();
+      // The builder and the network are shared with the engine builds in the background
+      std::lock_guard<OrtMutex> engine_build_lock(engine_build_mu_);
       auto trt_config = std::unique_ptr<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
-      if (max_workspace_size_ > 0) {
-        trt_config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, max_workspace_size_);
-      }
       for (auto trt_profile : trt_profiles) {
         trt_config->addOptimizationProfile(trt_profile);
       }
-
-      // Set INT8 Per Tensor Dynamic range
-      if (trt_state->int8_enable && trt_builder->platformHasFastInt8() && trt_state->int8_calibration_cache_available) {
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#endif
-        trt_config->setInt8Calibrator(nullptr);
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
-        if (!SetDynamicRange(*trt_state->network->get(), trt_state->dynamic_range_map)) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to set INT8 dynamic range.");
-        }
-      }
-
-      // Set precision
-      if (trt_state->fp16_enable && trt_state->int8_enable) {
-        trt_config->setFlags(1U << static_cast<uint32_t>(nvinfer1::BuilderFlag::kFP16) | 1U << static_cast<uint32_t>(nvinfer1::BuilderFlag::kINT8));
-      } else if (trt_state->fp16_enable) {
-        trt_config->setFlag(nvinfer1::BuilderFlag::kFP16);
-      } else if (trt_state->int8_enable) {
-        trt_config->setFlag(nvinfer1::BuilderFlag::kINT8);
-      }
-
-      // Set DLA (DLA can only run with FP16 or INT8)
-      if ((trt_state->fp16_enable || trt_state->int8_enable) && trt_state->dla_enable) {
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] use DLA core " << trt_state->dla_core;
-        trt_config->setFlag(nvinfer1::BuilderFlag::kGPU_FALLBACK);
-        trt_config->setDefaultDeviceType(nvinfer1::DeviceType::kDLA);
-        trt_config->setDLACore(trt_state->dla_core);
-      }
-
-      // enable sparse weights
-      if (trt_state->sparsity_enable) {
-        trt_config->setFlag(nvinfer1::BuilderFlag::kSPARSE_WEIGHTS);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Sparse weights are allowed";
-      }
-#if NV_TENSORRT_MAJOR == 8 && NV_TENSORRT_MINOR == 5
-      // enable builder heuristics
-      if (trt_state->build_heuristics_enable) {
-        trt_config->setFlag(nvinfer1::BuilderFlag::kENABLE_TACTIC_HEURISTIC);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Builder heuristics are enabled";
-      }
-#elif NV_TENSORRT_MAJOR == 8 && NV_TENSORRT_MINOR > 5 || NV_TENSORRT_MAJOR > 8
-      // switch optimizaion level
-      if (trt_state->builder_optimization_level != 3) {
-        trt_config->setBuilderOptimizationLevel(trt_state->builder_optimization_level);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Builder optimization level is set to " << builder_optimization_level_;
-      }
-
-      // limit auxiliary streams
-      if (trt_state->auxiliary_streams >= 0) {
-        trt_config->setMaxAuxStreams(trt_state->auxiliary_streams);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Auxiliary streams are se to " << trt_state->auxiliary_streams;
-      }
-#else
-      if (trt_state->builder_optimization_level != 3) {
-        LOGS_DEFAULT(WARNING) << "[TensorRT EP] Builder optimization level can only be used on TRT 8.6 onwards!";
-      }
-      if (trt_state->auxiliary_streams >= 0) {
-        LOGS_DEFAULT(WARNING) << "[TensorRT EP] Auxiliary streams can only be set on TRT 8.6 onwards!";
-      }
-#endif
-      if (weight_stripped_engine_enable_) {
-#if NV_TENSORRT_MAJOR >= 10
-        trt_config->setFlag(nvinfer1::BuilderFlag::kSTRIP_PLAN);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] STRIP_PLAN is enabled";
-        trt_config->setFlag(nvinfer1::BuilderFlag::kREFIT_IDENTICAL);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] REFIT_IDENTICAL is enabled";
-#else
-        LOGS_DEFAULT(WARNING) << "[TensorRT EP] weight-stripped engines can only be used on TRT 10.0 onwards!";
-#endif
-      }
-      // limit used tactic sources
-      if (trt_state->filter_tactic_sources) {
-        nvinfer1::TacticSources tactics = trt_config->getTacticSources();
-        tactics |= trt_state->tactic_sources;
-        trt_config->setTacticSources(tactics);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Tactic sources are limited using bitmask " << tactics;
+      auto status = SetRuntimeBuilderConfig(*trt_state, *trt_config);
+      if (status != Status::OK()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, status.ErrorMessage());
       }
 
-      // Load timing cache from file. Create a fresh cache if the file doesn't exist
-      std::unique_ptr<nvinfer1::ITimingCache> timing_cache = nullptr;
-      if (trt_state->timing_cache_enable) {
-        std::vector<char> loaded_timing_cache = loadTimingCacheFile(timing_cache_path);
-        timing_cache.reset(trt_config->createTimingCache(static_cast<const void*>(loaded_timing_cache.data()), loaded_timing_cache.size()));
-        if (timing_cache == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                 "TensorRT EP could not create timing cache: " + timing_cache_path);
-        }
-        trt_config->setTimingCache(*timing_cache, force_timing_cache_match_);
-        if (detailed_build_log_) {
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Deserialized timing cache from " + timing_cache_path;
-        }
+      // Start from the timing cache shared within the process, which is loaded from file if timing cache is enabled
+      std::unique_ptr<nvinfer1::ITimingCache> timing_cache = CreateTimingCacheFromSharedCache(*trt_config, timing_cache_key, timing_cache_path);
+      if (timing_cache == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                               "TensorRT EP could not create timing cache: " + timing_cache_key);
       }
-
-      // Enable hardware compatility mode if assigned
-      if (trt_state->engine_hw_compatible) {
-        trt_config->setHardwareCompatibilityLevel(nvinfer1::HardwareCompatibilityLevel::kAMPERE_PLUS);
-        LOGS_DEFAULT(INFO) << "[TensorRT EP] Re-generate engine with hardware compatibility enabled.";
+      trt_config->setTimingCache(*timing_cache, force_timing_cache_match_);
+      if (detailed_build_log_ && trt_state->timing_cache_enable) {
+        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Deserialized timing cache from " + timing_cache_path;
       }
 
       // Build engine
@@ -3696,18 +3959,13 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
         }
       }
 
-      // serialize and save timing cache
-      if (trt_state->timing_cache_enable) {
-        auto timing_cache = trt_config->getTimingCache();
-        std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
-        if (timingCacheHostData == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                 "TensorRT EP could not serialize timing cache: " + timing_cache_path);
-        }
-        saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
-        if (detailed_build_log_) {
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
-        }
+      // merge the timing cache into the shared timing cache and save it
+      if (!MergeTimingCacheIntoSharedCache(*trt_config, timing_cache_key, timing_cache_path)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                               "TensorRT EP could not serialize timing cache: " + timing_cache_key);
+      }
+      if (detailed_build_log_ && trt_state->timing_cache_enable) {
+        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
       }
 
       // dump ep context model
@@ -3936,6 +4194,152 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
   return Status::OK();
 }
 
+Status TensorrtExecutionProvider::SetRuntimeBuilderConfig(const TensorrtFuncState& trt_state, nvinfer1::IBuilderConfig& trt_config) const {
+  auto trt_builder = trt_state.builder;
+  if (max_workspace_size_ > 0) {
+    trt_config.setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, max_workspace_size_);
+  }
+
+  // Set INT8 Per Tensor Dynamic range
+  if (trt_state.int8_enable && trt_builder->platformHasFastInt8() && trt_state.int8_calibration_cache_available) {
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#endif
+    trt_config.setInt8Calibrator(nullptr);
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+    if (!SetDynamicRange(*trt_state.network->get(), trt_state.dynamic_range_map)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to set INT8 dynamic range.");
+    }
+  }
+
+  // Set precision
+  if (trt_state.fp16_enable && trt_state.int8_enable) {
+    trt_config.setFlags(1U << static_cast<uint32_t>(nvinfer1::BuilderFlag::kFP16) | 1U << static_cast<uint32_t>(nvinfer1::BuilderFlag::kINT8));
+  } else if (trt_state.fp16_enable) {
+    trt_config.setFlag(nvinfer1::BuilderFlag::kFP16);
+  } else if (trt_state.int8_enable) {
+    trt_config.setFlag(nvinfer1::BuilderFlag::kINT8);
+  }
+
+  // Set DLA (DLA can only run with FP16 or INT8)
+  if ((trt_state.fp16_enable || trt_state.int8_enable) && trt_state.dla_enable) {
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] use DLA core " << trt_state.dla_core;
+    trt_config.setFlag(nvinfer1::BuilderFlag::kGPU_FALLBACK);
+    trt_config.setDefaultDeviceType(nvinfer1::DeviceType::kDLA);
+    trt_config.setDLACore(trt_state.dla_core);
+  }
+
+  // enable sparse weights
+  if (trt_state.sparsity_enable) {
+    trt_config.setFlag(nvinfer1::BuilderFlag::kSPARSE_WEIGHTS);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Sparse weights are allowed";
+  }
+#if NV_TENSORRT_MAJOR == 8 && NV_TENSORRT_MINOR == 5
+  // enable builder heuristics
+  if (trt_state.build_heuristics_enable) {
+    trt_config.setFlag(nvinfer1::BuilderFlag::kENABLE_TACTIC_HEURISTIC);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Builder heuristics are enabled";
+  }
+#elif NV_TENSORRT_MAJOR == 8 && NV_TENSORRT_MINOR > 5 || NV_TENSORRT_MAJOR > 8
+  // switch optimizaion level
+  if (trt_state.builder_optimization_level != 3) {
+    trt_config.setBuilderOptimizationLevel(trt_state.builder_optimization_level);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Builder optimization level is set to " << builder_optimization_level_;
+  }
+
+  // limit auxiliary streams
+  if (trt_state.auxiliary_streams >= 0) {
+    trt_config.setMaxAuxStreams(trt_state.auxiliary_streams);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Auxiliary streams are se to " << trt_state.auxiliary_streams;
+  }
+#else
+  if (trt_state.builder_optimization_level != 3) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Builder optimization level can only be used on TRT 8.6 onwards!";
+  }
+  if (trt_state.auxiliary_streams >= 0) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Auxiliary streams can only be set on TRT 8.6 onwards!";
+  }
+#endif
+  if (weight_stripped_engine_enable_) {
+#if NV_TENSORRT_MAJOR >= 10
+    trt_config.setFlag(nvinfer1::BuilderFlag::kSTRIP_PLAN);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] STRIP_PLAN is enabled";
+    trt_config.setFlag(nvinfer1::BuilderFlag::kREFIT_IDENTICAL);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] REFIT_IDENTICAL is enabled";
+#else
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] weight-stripped engines can only be used on TRT 10.0 onwards!";
+#endif
+  }
+  // limit used tactic sources
+  if (trt_state.filter_tactic_sources) {
+    nvinfer1::TacticSources tactics = trt_config.getTacticSources();
+    tactics |= trt_state.tactic_sources;
+    trt_config.setTacticSources(tactics);
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Tactic sources are limited using bitmask " << tactics;
+  }
+
+  // Enable hardware compatility mode if assigned
+  if (trt_state.engine_hw_compatible) {
+    trt_config.setHardwareCompatibilityLevel(nvinfer1::HardwareCompatibilityLevel::kAMPERE_PLUS);
+    LOGS_DEFAULT(INFO) << "[TensorRT EP] Re-generate engine with hardware compatibility enabled.";
+  }
+  return Status::OK();
+}
+
+BackgroundEngineBuild TensorrtExecutionProvider::BuildEngineForShapeRanges(TensorrtFuncState* trt_state, ShapeRangesMap shape_ranges) {
+  BackgroundEngineBuild engine_build;
+  engine_build.shape_ranges = std::move(shape_ranges);
+  auto build_engine = [&]() -> Status {
+    CUDA_RETURN_IF_ERROR(cudaSetDevice(device_id_));
+    std::lock_guard<OrtMutex> lock(engine_build_mu_);
+    auto trt_builder = trt_state->builder;
+    auto trt_network = trt_state->network->get();
+    auto trt_config = std::unique_ptr<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
+    nvinfer1::IOptimizationProfile* trt_profile = trt_builder->createOptimizationProfile();
+    SetProfileShapesFromShapeRanges(*trt_profile, *trt_network, engine_build.shape_ranges);
+    trt_config->addOptimizationProfile(trt_profile);
+    ORT_RETURN_IF_ERROR(SetRuntimeBuilderConfig(*trt_state, *trt_config));
+
+    std::string timing_cache_path = "";
+    if (timing_cache_enable_) {
+      timing_cache_path = GetTimingCachePath(global_cache_path_, compute_capability_);
+    }
+    const std::string timing_cache_key = timing_cache_enable_ ? timing_cache_path : "sm" + compute_capability_;
+    std::unique_ptr<nvinfer1::ITimingCache> timing_cache = CreateTimingCacheFromSharedCache(*trt_config, timing_cache_key, timing_cache_path);
+    if (timing_cache == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP could not create timing cache: " + timing_cache_key);
+    }
+    trt_config->setTimingCache(*timing_cache, force_timing_cache_match_);
+
+    engine_build.serialized_engine = std::unique_ptr<nvinfer1::IHostMemory>(trt_builder->buildSerializedNetwork(*trt_network, *trt_config));
+    if (engine_build.serialized_engine == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to create engine in the background for fused node: " + trt_state->fused_node_name);
+    }
+    engine_build.engine = std::unique_ptr<nvinfer1::ICudaEngine>(
+        trt_state->runtime->deserializeCudaEngine(engine_build.serialized_engine->data(), engine_build.serialized_engine->size()));
+    if (engine_build.engine == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to deserialize engine built in the background for fused node: " + trt_state->fused_node_name);
+    }
+    if (!MergeTimingCacheIntoSharedCache(*trt_config, timing_cache_key, timing_cache_path)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP could not serialize timing cache: " + timing_cache_key);
+    }
+    return Status::OK();
+  };
+
+  ORT_TRY {
+    engine_build.status = build_engine();
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      engine_build.status = ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, ex.what());
+    });
+  }
+  return engine_build;
+}
+
 Status TensorrtExecutionProvider::CreateNodeComputeInfoFromPrecompiledEngine(const GraphViewer& graph_body_viewer,
                                                                              const Node& fused_node,
                                                                              std::unordered_map<std::string, size_t>& input_map,
@@ -3,6 +3,8 @@
 
 #pragma once
 #include <ctime>
+#include <future>
+#include <map>
 #ifndef USE_CUDA_MINIMAL
 #include <cudnn.h>
 #else
@@ -155,6 +157,23 @@ class OutputAllocator : public nvinfer1::IOutputAllocator {
  */
 using ShapeRangesMap = std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::vector<int64_t>>>>;
 
+/*
+ * Input shapes observed by the runs of a fused node with dynamic shape inputs:
+ * tensor name -> ( shape -> count )
+ */
+struct ShapeHistogram {
+  size_t num_runs = 0;
+  std::unordered_map<std::string, std::map<std::vector<int64_t>, size_t>> shape_counts;
+};
+
+// Engine of a fused node built in the background for the shape ranges proposed from its shape histogram.
+struct BackgroundEngineBuild {
+  Status status;
+  ShapeRangesMap shape_ranges;
+  std::unique_ptr<nvinfer1::IHostMemory> serialized_engine;
+  std::unique_ptr<nvinfer1::ICudaEngine> engine;
+};
+
 // Information to construct kernel function state.
 struct TensorrtFuncState {
   AllocateFunc test_allocate_func = nullptr;
@@ -313,6 +332,8 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   std::string global_cache_path_, cache_path_, engine_decryption_lib_path_;
   std::unique_ptr<nvinfer1::IRuntime> runtime_ = nullptr;
   OrtMutex tensorrt_mu_;
+  OrtMutex compile_mu_;
+  OrtMutex engine_build_mu_;
   int device_id_;
   std::string compute_capability_;
   bool context_memory_sharing_enable_ = false;
@@ -329,6 +350,8 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   bool cuda_graph_enable_ = false;
   std::string cache_prefix_;
   bool engine_hw_compatible_ = false;
+  bool engine_refit_enable_ = false;
+  int profile_auto_update_runs_ = 0;
 
   // The OrtAllocator object will be get during ep compute time
   // and should be kept for the lifetime of TRT EP object.
@@ -365,6 +388,9 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   std::unordered_map<std::string, ShapeRangesMap> input_shape_ranges_;  // The profile shape ranges that the engine is built with
   std::unordered_map<std::string, std::vector<nvinfer1::IOptimizationProfile*>> profiles_;
   std::unordered_map<std::string, DDSOutputAllocatorMap> dds_output_allocator_maps_;
+  std::unordered_map<std::string, ShapeHistogram> shape_histograms_;
+  // Declared after the TRT objects that the background engine builds use, so that they are destroyed first
+  std::unordered_map<std::string, std::future<BackgroundEngineBuild>> background_engine_builds_;
 
   // for external stream, we need to create its cudnn/cublass handle before cuda EP enable cuda graph capture
   cudnnHandle_t external_cudnn_handle_ = nullptr;
@@ -568,12 +594,27 @@ class TensorrtExecutionProvider : public IExecutionProvider {
 
   /**
    * Create a vector of NodeComputeInfo instances from graph.
+   * With parallel_engine_build, other fused nodes are compiled concurrently: the fused node gets its own builder
+   * and everything but the engine build is serialized by compile_mu_.
    */
   Status CreateNodeComputeInfoFromGraph(const GraphViewer& graph_body_viewer,
                                         const Node& fused_node,
                                         std::unordered_map<std::string, size_t>& input_map,
                                         std::unordered_map<std::string, size_t>& output_map,
-                                        std::vector<NodeComputeInfo>& node_compute_funcs);
+                                        std::vector<NodeComputeInfo>& node_compute_funcs,
+                                        bool parallel_engine_build = false);
+
+  /**
+   * Set the builder config flags of an engine build at inference time from the kernel function state.
+   */
+  Status SetRuntimeBuilderConfig(const TensorrtFuncState& trt_state, nvinfer1::IBuilderConfig& trt_config) const;
+
+  /**
+   * Build the engine of a fused node with a single optimization profile covering shape_ranges.
+   * It runs in the background of the inference runs, and shares the builder and the network of the fused node
+   * with the engine builds at inference time under engine_build_mu_.
+   */
+  BackgroundEngineBuild BuildEngineForShapeRanges(TensorrtFuncState* trt_state, ShapeRangesMap shape_ranges);
 
   bool IsGraphCaptureAllowed() const;
   void CaptureBegin(int graph_annotation_id);
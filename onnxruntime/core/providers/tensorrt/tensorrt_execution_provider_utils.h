@@ -480,6 +480,39 @@ std::string GetTimingCachePath(const std::string& root, std::string& compute_cap
   return GetCachePath(root, timing_cache_name);
 }
 
+/*
+ * Get the hash of the weights of a fused node from its serialized model
+ *
+ * The engine cache name only depends on the graph, so the hash is saved next to the engine cache to tell
+ * whether the engine was built with the current weights. Weights stored as external data are hashed by location.
+ */
+std::string GetWeightsHash(const std::string& serialized_model) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(serialized_model.data(), gsl::narrow_cast<int32_t>(serialized_model.size()), hash[0], &hash);
+  std::ostringstream hash_str;
+  hash_str << std::hex;
+  for (auto h : hash) {
+    hash_str << h;
+  }
+  return hash_str.str();
+}
+
+void SerializeWeightsHash(const std::string& file_name, const std::string& weights_hash) {
+  std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+  file << weights_hash;
+}
+
+/*
+ * Compare the weights hash saved with an engine cache to the hash of the current weights
+ *
+ * \return true if the engine cache was built with the current weights
+ */
+bool CompareWeightsHash(const std::string& file_name, const std::string& weights_hash) {
+  std::ifstream file(file_name);
+  std::string saved_weights_hash;
+  return file && (file >> saved_weights_hash) && saved_weights_hash == weights_hash;
+}
+
 /*
  * Get cache by type
  *
@@ -2,7 +2,10 @@
 // Copyright (c) Intel Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <array>
 #include <fstream>
+#include <list>
 
 #include "model_builder.h"
 #include "model.h"
@@ -10,7 +13,10 @@
 #include "op_builder_factory.h"
 
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_proto_serializer.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/common.h"
 #include "core/providers/shared/utils/utils.h"
 
@@ -19,6 +25,35 @@
 namespace onnxruntime {
 namespace webnn {
 
+namespace {
+using GraphKey = std::array<uint32_t, 4>;
+
+// WebNN graphs built by earlier sessions of the process. WebNN has no API to serialize a graph, so the graphs can't
+// be kept across processes. A graph is only valid in the MLContext it was built in.
+struct CachedGraph {
+  GraphKey key;
+  emscripten::val context;
+  emscripten::val graph;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  InlinedHashMap<std::string, OnnxTensorInfo> input_output_info;
+};
+
+// Number of graphs kept once their sessions are released.
+constexpr size_t kMaxCachedGraphs = 4;
+
+struct GraphCache {
+  OrtMutex mutex;
+  // most recently used first
+  std::list<CachedGraph> graphs;
+};
+
+GraphCache& GetGraphCache() {
+  static GraphCache cache;
+  return cache;
+}
+}  // namespace
+
 ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
                            const emscripten::val& context, const DataLayout preferred_layout,
                            const WebnnDeviceType wnn_device_type)
@@ -35,6 +70,41 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
   }
 }
 
+Status ModelBuilder::GetGraphKey(GraphKey& key) {
+  // the nodes, inputs and outputs of the graph, and the data of its initializers. the initializers are hashed
+  // separately as their data may be referenced by address instead of being held by the TensorProto.
+  ONNX_NAMESPACE::GraphProto graph_proto;
+  GraphViewerToProto(graph_viewer_, graph_proto, /*include_initializer*/ false, /*include_outer_scope_args*/ false);
+  std::string graph_string;
+  graph_proto.SerializeToString(&graph_string);
+  graph_string += std::to_string(static_cast<int>(preferred_layout_));
+  graph_string += std::to_string(static_cast<int>(wnn_device_type_));
+
+  std::vector<uint32_t> hashes(4);
+  MurmurHash3::x86_128(graph_string.data(), gsl::narrow_cast<int>(graph_string.size()), 0, hashes.data());
+
+  const auto initializers = GetInitializerTensors();
+  std::vector<std::string> initializer_names;
+  initializer_names.reserve(initializers.size());
+  for (const auto& [name, tensor] : initializers) {
+    initializer_names.push_back(name);
+  }
+  std::sort(initializer_names.begin(), initializer_names.end());
+
+  for (const auto& name : initializer_names) {
+    std::vector<uint8_t> unpacked_tensor;
+    ORT_RETURN_IF_ERROR(onnxruntime::utils::UnpackInitializerData(*initializers.at(name), unpacked_tensor));
+    const size_t offset = hashes.size();
+    hashes.resize(offset + 8);
+    MurmurHash3::x86_128(name.data(), gsl::narrow_cast<int>(name.size()), 0, &hashes[offset]);
+    MurmurHash3::x86_128(unpacked_tensor.data(), gsl::narrow_cast<int>(unpacked_tensor.size()), 0,
+                         &hashes[offset + 4]);
+  }
+
+  MurmurHash3::x86_128(hashes.data(), gsl::narrow_cast<int>(hashes.size() * sizeof(uint32_t)), 0, key.data());
+  return Status::OK();
+}
+
 Status ModelBuilder::Initialize() {
   PreprocessInitializers();
   ORT_RETURN_IF_ERROR(RegisterInitializers());
@@ -321,6 +391,26 @@ Status ModelBuilder::RegisterModelOutputs() {
 }
 
 Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
+  GraphKey key;
+  ORT_RETURN_IF_ERROR(GetGraphKey(key));
+
+  auto& cache = GetGraphCache();
+  std::lock_guard<OrtMutex> lock(cache.mutex);
+  auto cached_graph = std::find_if(cache.graphs.begin(), cache.graphs.end(), [&](const CachedGraph& entry) {
+    return entry.key == key && entry.context.strictlyEquals(wnn_context_);
+  });
+  if (cached_graph != cache.graphs.end()) {
+    LOGS(logger_, VERBOSE) << "Reusing the WebNN graph built by an earlier session.";
+    cache.graphs.splice(cache.graphs.begin(), cache.graphs, cached_graph);
+    wnn_builder_ = emscripten::val::undefined();
+    model.reset(new Model(std::move(wnn_context_), cached_graph->graph, logger_));
+    model->SetInputs(std::vector<std::string>(cached_graph->input_names));
+    model->SetOutputs(std::vector<std::string>(cached_graph->output_names));
+    model->SetInputOutputInfo(InlinedHashMap<std::string, OnnxTensorInfo>(cached_graph->input_output_info));
+    model->AllocateInputOutputBuffers();
+    return Status::OK();
+  }
+
   ORT_RETURN_IF_ERROR(Initialize());
   emscripten::val named_operands = emscripten::val::object();
   for (auto& name : output_names_) {
@@ -333,6 +423,12 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
   }
   // Explicitly release the WebNN builder to free memory.
   wnn_builder_ = emscripten::val::undefined();
+
+  cache.graphs.push_front(CachedGraph{key, wnn_context_, wnn_graph, input_names_, output_names_, input_output_info_});
+  if (cache.graphs.size() > kMaxCachedGraphs) {
+    cache.graphs.pop_back();
+  }
+
   model.reset(new Model(std::move(wnn_context_), std::move(wnn_graph), logger_));
   model->SetInputs(std::move(input_names_));
   model->SetOutputs(std::move(output_names_));
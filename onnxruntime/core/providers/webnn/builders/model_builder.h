@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "core/common/inlined_containers.h"
 #include <core/graph/graph_viewer.h>
 
@@ -79,6 +81,9 @@ class ModelBuilder {
   uint32_t name_token_{0};
   InlinedHashSet<std::string> unique_names_;
 
+  // Hash identifying the WebNN graph built from graph_viewer_, to look it up in the graphs built by earlier sessions.
+  Status GetGraphKey(std::array<uint32_t, 4>& key) ORT_MUST_USE_RESULT;
+
   // Convert the onnx model to WebNN operands
   Status Initialize() ORT_MUST_USE_RESULT;
 
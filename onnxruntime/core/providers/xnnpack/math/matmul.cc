@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "matmul.h"
+#include "core/common/cpuid_info.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/xnnpack/xnnpack_init.h"
 
 // Todo -
 // 1. Integrate activation layers - Cliping & Relu
@@ -13,6 +15,33 @@
 namespace onnxruntime {
 namespace xnnpack {
 
+namespace {
+// the batch dims of A and B must match as xnn_batch_matrix_multiply doesn't broadcast
+bool BatchDimsMatch(const ONNX_NAMESPACE::TensorShapeProto& A_shape, const ONNX_NAMESPACE::TensorShapeProto& B_shape) {
+  for (int i = 0, end = A_shape.dim_size() - 2; i < end; ++i) {
+    const auto& a_dim = A_shape.dim(i);
+    const auto& b_dim = B_shape.dim(i);
+    if (a_dim.has_dim_value() && b_dim.has_dim_value()) {
+      if (a_dim.dim_value() != b_dim.dim_value()) {
+        return false;
+      }
+    } else if (!a_dim.has_dim_param() || !b_dim.has_dim_param() || a_dim.dim_param() != b_dim.dim_param()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<MLDataType> MatMulTypeConstraints() {
+#ifdef XNNPACK_FP16_SUPPORTED
+  return {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<MLFloat16>()};
+#else
+  return {DataTypeImpl::GetTensorType<float>()};
+#endif
+}
+}  // namespace
+
 bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph) {
   bool supported = false;
   const onnxruntime::Node& node = node_unit.GetNode();
@@ -28,13 +57,38 @@ bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& g
     const auto& A_arg = *input_defs[0];
     const auto& B_arg = *input_defs[1];
 
-    // Support only float
+    // Support float, and float16 where the CPU has fp16 arithmetic
     const auto* A_type = A_arg.TypeAsProto();
 
     const auto* A_shape = A_arg.Shape();
     const auto* B_shape = B_arg.Shape();
 
-    if (A_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    const auto elem_type = A_type->tensor_type().elem_type();
+    const bool is_fp16 = elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+    if (elem_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT && !is_fp16) {
+      break;
+    }
+
+#ifdef XNNPACK_FP16_SUPPORTED
+    if (is_fp16 && !CPUIDInfo::GetCPUIDInfo().HasFp16VectorAcceleration()) {
+      break;
+    }
+#else
+    if (is_fp16) {
+      break;
+    }
+#endif
+
+    if (!graph.IsConstantInitializer(B_arg.Name(), true)) {
+      // B matrix is an activation, e.g. Q*K^T and the product with V in attention.
+      // A and B must have the same rank and batch dims.
+      if (is_fp16 || A_shape == nullptr || B_shape == nullptr ||
+          A_shape->dim_size() < 2 || A_shape->dim_size() != B_shape->dim_size() ||
+          !BatchDimsMatch(*A_shape, *B_shape)) {
+        break;
+      }
+
+      supported = true;
       break;
     }
 
@@ -50,11 +104,6 @@ bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& g
       break;
     }
 
-    // B matrix must be constant
-    if (!graph.IsConstantInitializer(B_arg.Name(), true)) {
-      break;
-    }
-
     supported = true;
 
   } while (false);
@@ -62,14 +111,35 @@ bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& g
   return supported;
 }
 
-MatMul::MatMul(const OpKernelInfo& info) : XnnpackKernel(info, /*enable_caches*/ true) {}
+MatMul::MatMul(const OpKernelInfo& info) : XnnpackKernel(info, /*enable_caches*/ true) {
+  const auto& node = info.node();
+  int32_t a_dtype = 0;
+  ORT_ENFORCE(GetType(*node.InputDefs()[0], a_dtype));
+  if (a_dtype == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    op_type_ = OpComputeType::op_compute_type_fp32;
+  } else if (a_dtype == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) {
+    op_type_ = OpComputeType::op_compute_type_fp16;
+  } else {
+    auto stype = DataTypeImpl::ToString(DataTypeImpl::TypeFromProto(*node.InputDefs()[0]->TypeAsProto()));
+    ORT_THROW("unsupported MatMul in XnnpackEP, we have FLOAT|FLOAT16, but got ", stype);
+  }
+
+  const Tensor* B = nullptr;
+  dynamic_b_ = !info.TryGetConstantInput(1, &B);
+  if (dynamic_b_) {
+    struct xnn_operator* p = nullptr;
+    xnn_status status = xnn_create_batch_matrix_multiply_nc_f32(/*flags*/ 0, &p);
+    ORT_ENFORCE(status == xnn_status_success, "xnn_create_batch_matrix_multiply_nc_f32 returned ", status);
+    op0_.reset(p);
+  }
+}
 
 Status MatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
                        /*out*/ bool& is_packed,
                        /*out*/ PrePackedWeights* /*Not used*/) {
   is_packed = false;
 
-  if (input_idx == 0 || input_idx == 2) {
+  if (input_idx == 0 || input_idx == 2 || dynamic_b_) {
     return Status::OK();
   }
 
@@ -88,27 +158,50 @@ Status MatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
   if (b_shape_.NumDimensions() == 1) {
     shape_broadcast.push_back(1);
   }
-  status = xnn_create_fully_connected_nc_f32(
-      shape_broadcast[0],    // size_t input_channels,
-      shape_broadcast[1],    // size_t output_channels,
-      shape_broadcast[0],    // size_t input_stride,
-      shape_broadcast[1],    // size_t output_stride,
-      tensor.Data<float>(),  // const float* kernel,
-      nullptr,               // const float* bias,
-      output_min,
-      output_max,
-      flags,
+
+  if (op_type_ == OpComputeType::op_compute_type_fp32) {
+    status = xnn_create_fully_connected_nc_f32(
+        shape_broadcast[0],    // size_t input_channels,
+        shape_broadcast[1],    // size_t output_channels,
+        shape_broadcast[0],    // size_t input_stride,
+        shape_broadcast[1],    // size_t output_stride,
+        tensor.Data<float>(),  // const float* kernel,
+        nullptr,               // const float* bias,
+        output_min,
+        output_max,
+        flags,
+#ifdef XNN_CACHE_ENABLE
+        GetCodeCache(),
+        GetWeightsCache(),
+#else
+        nullptr,
+        nullptr,
+#endif
+        &p);
+  } else {
+    status = xnn_create_fully_connected_nc_f16(
+        shape_broadcast[0],  // size_t input_channels,
+        shape_broadcast[1],  // size_t output_channels,
+        shape_broadcast[0],  // size_t input_stride,
+        shape_broadcast[1],  // size_t output_stride,
+        tensor.DataRaw(),    // const void* kernel,
+        nullptr,             // const void* bias,
+        output_min,
+        output_max,
+        flags,
 #ifdef XNN_CACHE_ENABLE
-      GetCodeCache(),
-      GetWeightsCache(),
+        GetCodeCache(),
+        GetWeightsCache(),
 #else
-      nullptr,
-      nullptr,
+        nullptr,
+        nullptr,
 #endif
-      &p);
+        &p);
+  }
 
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_", OpTypeToString(op_type_),
+                           " returned ", status);
   }
 
   op0_.reset(p);
@@ -120,22 +213,75 @@ Status MatMul::Compute(OpKernelContext* ctx) const {
   const Tensor* a = ctx->Input<Tensor>(0);
   pthreadpool_t threadpool = GetThreadPool();
   MatMulComputeHelper helper;
+
+  if (dynamic_b_) {
+    const Tensor* b = ctx->Input<Tensor>(1);
+    ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+    Tensor* y = ctx->Output(0, helper.OutputShape());
+
+    if (y->Shape().Size() == 0)
+      return Status::OK();
+
+    // IsOnnxNodeSupported has checked that A and B have the same rank and batch dims
+    const size_t rank = a->Shape().NumDimensions();
+    const size_t batch_size = gsl::narrow<size_t>(a->Shape().SizeToDimension(rank - 2));
+    ORT_RETURN_IF_NOT(batch_size == gsl::narrow<size_t>(b->Shape().SizeToDimension(rank - 2)),
+                      "XNNPACK MatMul requires the batch dims of A and B to match. A: ", a->Shape(), " B: ", b->Shape());
+
+    size_t workspace_size = 0;
+    size_t workspace_alignment = 0;
+    xnn_allocator* allocator = GetStoredAllocator().second;
+    auto deallocator = [allocator](void* ptr) { allocator->aligned_deallocate(allocator->context, ptr); };
+    std::unique_ptr<void, decltype(deallocator)> workspace(nullptr, deallocator);
+
+    xnn_status status = xnn_reshape_batch_matrix_multiply_nc_f32(
+        op0_.get(), batch_size,
+        static_cast<size_t>(helper.M()), static_cast<size_t>(helper.K()), static_cast<size_t>(helper.N()),
+        &workspace_size, &workspace_alignment, threadpool);
+    if (status != xnn_status_success) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_batch_matrix_multiply_nc_f32 returned ", status);
+    }
+
+    workspace.reset(allocator->aligned_allocate(allocator->context, XNN_ALLOCATION_ALIGNMENT, workspace_size));
+
+    status = xnn_setup_batch_matrix_multiply_nc_f32(op0_.get(), workspace.get(),
+                                                    a->Data<float>(), b->Data<float>(), y->MutableData<float>());
+    if (status != xnn_status_success) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_batch_matrix_multiply_nc_f32 returned ", status);
+    }
+
+    status = xnn_run_operator(op0_.get(), threadpool);
+    if (status != xnn_status_success) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+    }
+    return Status::OK();
+  }
+
   ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape_));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
   if (y->Shape().Size() == 0)
     return Status::OK();
 
-  auto* y_data = y->MutableData<float>();
-
-  xnn_status status = xnn_reshape_fully_connected_nc_f32(op0_.get(), a->Shape()[0], threadpool);
+  xnn_status status = xnn_status::xnn_status_uninitialized;
+  if (op_type_ == OpComputeType::op_compute_type_fp32) {
+    status = xnn_reshape_fully_connected_nc_f32(op0_.get(), a->Shape()[0], threadpool);
+  } else {
+    status = xnn_reshape_fully_connected_nc_f16(op0_.get(), a->Shape()[0], threadpool);
+  }
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_fully_connected_nc_", OpTypeToString(op_type_),
+                           " returned ", status);
   }
 
-  status = xnn_setup_fully_connected_nc_f32(op0_.get(), a->Data<float>(), y_data);
+  if (op_type_ == OpComputeType::op_compute_type_fp32) {
+    status = xnn_setup_fully_connected_nc_f32(op0_.get(), a->Data<float>(), y->MutableData<float>());
+  } else {
+    status = xnn_setup_fully_connected_nc_f16(op0_.get(), a->DataRaw(), y->MutableDataRaw());
+  }
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_fully_connected_nc_", OpTypeToString(op_type_),
+                           " returned ", status);
   }
 
   status = xnn_run_operator(op0_.get(), nullptr);
@@ -146,15 +292,15 @@ Status MatMul::Compute(OpKernelContext* ctx) const {
 }
 
 ONNX_OPERATOR_VERSIONED_KERNEL_EX(MatMul, kOnnxDomain, 1, 8, kXnnpackExecutionProvider,
-                                  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                                  KernelDefBuilder().TypeConstraint("T", MatMulTypeConstraints()),
                                   MatMul);
 
 ONNX_OPERATOR_VERSIONED_KERNEL_EX(MatMul, kOnnxDomain, 9, 12, kXnnpackExecutionProvider,
-                                  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                                  KernelDefBuilder().TypeConstraint("T", MatMulTypeConstraints()),
                                   MatMul);
 
 ONNX_OPERATOR_KERNEL_EX(MatMul, kOnnxDomain, 13, kXnnpackExecutionProvider,
-                        KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                        KernelDefBuilder().TypeConstraint("T", MatMulTypeConstraints()),
                         MatMul);
 
 }  // namespace xnnpack
@@ -30,6 +30,9 @@ class MatMul : public XnnpackKernel {
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
   AllocatorPtr myAlloc;
+  OpComputeType op_type_ = OpComputeType::op_compute_type_invalid;
+  // B is not a constant initializer, e.g. the K or V of attention, so it is read by a batch matrix multiply in Compute
+  bool dynamic_b_ = false;
 
   XnnpackOperator op0_ = nullptr;
 };
@@ -46,6 +46,12 @@ namespace xnnpack {
 #define XNN_ALLOCATION_ALIGNMENT 16
 #endif
 
+// XNNPACK fp16 kernels use the ARMv8.2 half precision arithmetic. Whether the CPU has it is checked at runtime with
+// CPUIDInfo::HasFp16VectorAcceleration() before a node is assigned.
+#if (defined(__aarch64__) || defined(_M_ARM64)) && !defined(_M_ARM64EC)
+#define XNNPACK_FP16_SUPPORTED
+#endif
+
 std::pair<AllocatorPtr&, xnn_allocator*> GetStoredAllocator();
 
 }  // namespace xnnpack
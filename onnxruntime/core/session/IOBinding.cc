@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/session/IOBinding.h"
+
+#include <algorithm>
+
 #include "core/common/logging/logging.h"
+#include "core/framework/data_types_internal.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
@@ -87,6 +91,51 @@ common::Status IOBinding::BindOutput(const std::string& name, OrtDevice device)
   return BindOutputImpl(name, {}, device);
 }
 
+common::Status IOBinding::BindOutput(const std::string& name, const OrtMemoryInfo& location,
+                                     OutputBufferAllocator allocator) {
+  ORT_RETURN_IF_NOT(allocator, "An output buffer allocator is required to bind output ", name);
+
+  const auto& graph_outputs = session_state_.GetGraphViewer().GetOutputs();
+  auto output = std::find_if(graph_outputs.begin(), graph_outputs.end(),
+                             [&name](const NodeArg* node_arg) { return node_arg->Name() == name; });
+  if (output == graph_outputs.end() || (*output)->TypeAsProto() == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can't bind an output buffer allocator to ", name,
+                           " as it is not a graph output with type information.");
+  }
+
+  MLDataType type = DataTypeImpl::TypeFromProto(*(*output)->TypeAsProto());
+  if (type == nullptr || !type->IsTensorType() ||
+      utils::IsDataTypeString(type->AsTensorType()->GetElementType())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can't bind an output buffer allocator to ", name,
+                           " as only non-string tensor outputs are supported.");
+  }
+
+  MLDataType element_type = type->AsTensorType()->GetElementType();
+  IExecutor::CustomAllocator custom_allocator =
+      [name, element_type, location, allocator = std::move(allocator)](
+          const TensorShape& shape, const OrtDevice& device, OrtValue& ort_value, bool& allocated) -> Status {
+    allocated = false;
+    if (device != location.device) {
+      // the output is copied to location so the regular allocation is used for the value produced by the graph.
+      return Status::OK();
+    }
+
+    const size_t size_in_bytes = Tensor::CalculateTensorStorageSize(element_type, shape);
+    void* buffer = nullptr;
+    ORT_RETURN_IF_ERROR(allocator(shape, size_in_bytes, buffer));
+    ORT_RETURN_IF(buffer == nullptr && size_in_bytes > 0,
+                  "The output buffer allocator for ", name, " returned a null buffer.");
+
+    Tensor::InitOrtValue(element_type, shape, buffer, location, ort_value);
+    allocated = true;
+    return Status::OK();
+  };
+
+  ORT_RETURN_IF_ERROR(BindOutputImpl(name, {}, location.device));
+  outputs_allocators_[mapped_output_names_[name]] = std::move(custom_allocator);
+  return Status::OK();
+}
+
 common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device) {
   auto it = mapped_output_names_.emplace(name, output_names_.size());
   size_t index = it.first->second;
@@ -97,6 +146,7 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
   } else {
     outputs_[index] = ml_value;
     outputs_device_info_[index] = device;
+    outputs_allocators_.erase(index);
   }
   ORT_ENFORCE(mapped_output_names_.size() == output_names_.size(), "Size mismatch", mapped_output_names_.size(), "!=", output_names_.size());
 
@@ -108,6 +158,7 @@ void IOBinding::ClearOutputs() {
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  outputs_allocators_.clear();
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
@@ -120,6 +171,10 @@ const std::vector<OrtDevice>& IOBinding::GetOutputsDeviceInfo() const {
   return outputs_device_info_;
 }
 
+const std::unordered_map<size_t, IExecutor::CustomAllocator>& IOBinding::GetOutputsAllocators() const {
+  return outputs_allocators_;
+}
+
 const std::vector<std::string>& IOBinding::GetInputNames() const { return feed_names_; }
 
 const std::vector<OrtValue>& IOBinding::GetInputs() const { return feeds_; }
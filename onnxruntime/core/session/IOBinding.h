@@ -2,11 +2,13 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "core/framework/execution_provider.h"
+#include "core/framework/iexecutor.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ort_value.h"
@@ -71,6 +73,27 @@ class IOBinding {
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  /**
+   * Provides the buffer for an output once its shape is known.
+   * @param shape Shape of the output.
+   * @param size_in_bytes Size of the buffer required.
+   * @param buffer Set to the buffer to write the output to. The buffer is not owned by ORT and must remain valid
+   *        until the output OrtValue is released.
+   */
+  using OutputBufferAllocator =
+      std::function<common::Status(const TensorShape& shape, size_t size_in_bytes, void*& buffer)>;
+
+  /**
+   * Bind an output name to a callback that is invoked during Run() once the output shape is known,
+   * so outputs whose shape isn't known ahead of time can be written straight into caller owned memory.
+   * The output must be a tensor and not a string tensor.
+   *
+   * @param location Location of the buffers returned by the allocator.
+   * The allocator is only used if the output is produced on location.device. Otherwise the output is allocated
+   * by ORT and copied to location.device, as if it was bound with BindOutput(name, location.device).
+   */
+  common::Status BindOutput(const std::string& name, const OrtMemoryInfo& location, OutputBufferAllocator allocator);
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
    */
@@ -106,12 +129,17 @@ class IOBinding {
   std::unordered_map<std::string, size_t> mapped_output_names_;
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
+  // allocators for outputs bound to an OutputBufferAllocator. key is the index in outputs_.
+  std::unordered_map<size_t, IExecutor::CustomAllocator> outputs_allocators_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
   const std::vector<OrtDevice>& GetOutputsDeviceInfo() const;
 
+  // custom allocators for outputs. only used by InferenceSession if the output is not pre-allocated.
+  const std::unordered_map<size_t, IExecutor::CustomAllocator>& GetOutputsAllocators() const;
+
   // The implementation for the BindOutput() overloads
   common::Status BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device);
 };
@@ -4,6 +4,7 @@
 #include "core/session/environment.h"
 #include "core/session/allocator_adapters.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 
@@ -55,6 +56,10 @@ std::once_flag schemaRegistrationOnceFlag;
 ProviderInfo_CUDA& GetProviderInfo_CUDA();
 #endif  // USE_CUDA
 
+Environment::Environment() : shared_initializer_store_(std::make_unique<SharedInitializerStore>()) {}
+
+Environment::~Environment() = default;
+
 Status Environment::Create(std::unique_ptr<logging::LoggingManager> logging_manager,
                            std::unique_ptr<Environment>& environment,
                            const OrtThreadingOptions* tp_options,
@@ -137,6 +142,11 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int thread_cache_max_chunks = -1;
+    int64_t shrink_half_life_ms = -1L;
+    int64_t huge_page_size = -1L;
+    int numa_node = -1;
+    int enable_tracing = -1;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -154,10 +164,16 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_max_chunks = arena_cfg->thread_cache_max_chunks;
+      shrink_half_life_ms = arena_cfg->shrink_half_life_ms;
+      huge_page_size = arena_cfg->huge_page_size;
+      numa_node = arena_cfg->numa_node;
+      enable_tracing = arena_cfg->enable_tracing;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
-                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes, thread_cache_max_chunks,
+                            shrink_half_life_ms, huge_page_size, numa_node, enable_tracing};
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
@@ -4,6 +4,9 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -20,6 +23,7 @@
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/cold_initializer_evictor.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -38,11 +42,15 @@
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/optimizer/float16_conversion.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/output_pruning.h"
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
+#include "core/optimizer/qdq_transformer/qdq_fusion_report.h"
+#include "core/optimizer/qdq_transformer/selectors_actions/qdq_selector_action_transformer.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/selectors_actions/selector_action_transformer_apply_contexts.h"
 #include "core/optimizer/transformer_memcpy.h"
@@ -71,6 +79,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/request_batcher.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -454,6 +463,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_THROW_IF_ERROR(graph_transformer_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps));
+  graph_transformer_mgr_.SetProfiler(&session_profiler_);
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -505,6 +515,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning,
+                                                               "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -515,6 +528,19 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.performance_cores_only =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly,
+                                                               "0") == "1";
+        to.numa_local_stealing =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaLocalStealing,
+                                                               "1") == "1";
+        to.calibrate_loop_costs =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpCalibrateLoopCosts,
+                                                               "0") == "1";
+        to.lease_workers_to_callers =
+            session_options_.config_options.GetConfigOrDefault(
+                kOrtSessionOptionsConfigIntraOpLeaseWorkersToCallers,
+                session_options_.execution_mode == ExecutionMode::ORT_PARALLEL ? "1" : "0") == "1";
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -567,9 +593,49 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+
+    const int64_t shared_pool_quota = ParseStringWithClassicLocale<int64_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSharedIntraOpPoolQuota, "0"));
+    ORT_ENFORCE(shared_pool_quota >= 0 && shared_pool_quota <= std::numeric_limits<int>::max(),
+                "Invalid ", kOrtSessionOptionsConfigSharedIntraOpPoolQuota, " value of ", shared_pool_quota);
+    const std::string shared_pool_priority =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSharedIntraOpPoolPriority,
+                                                           "normal");
+    ORT_ENFORCE(shared_pool_priority == "normal" || shared_pool_priority == "high",
+                "Invalid ", kOrtSessionOptionsConfigSharedIntraOpPoolPriority, " value of ", shared_pool_priority);
+    if (intra_op_thread_pool_from_env_ && (shared_pool_quota > 0 || shared_pool_priority == "high")) {
+      intra_op_thread_pool_view_ = std::make_unique<concurrency::ThreadPool>(
+          *intra_op_thread_pool_from_env_, static_cast<int>(shared_pool_quota),
+          shared_pool_priority == "high" ? concurrency::ThreadPool::SchedulingPriority::kHigh
+                                         : concurrency::ThreadPool::SchedulingPriority::kNormal);
+      LOGS(*session_logger_, INFO) << "Using the global intra-op threadpool with a quota of " << shared_pool_quota
+                                   << " threads and " << shared_pool_priority << " priority";
+    }
+  }
+
+  const int64_t async_run_num_threads = ParseStringWithClassicLocale<int64_t>(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsAsyncRunNumThreads, "0"));
+  ORT_ENFORCE(async_run_num_threads >= 0, "Invalid ", kOrtSessionOptionsAsyncRunNumThreads, ": ",
+              async_run_num_threads);
+  if (async_run_num_threads > 0) {
+    OrtThreadPoolParams to;
+    std::basic_stringstream<ORTCHAR_T> ss;
+    ss << ORT_TSTR("session-") << session_id_ << ORT_TSTR("-async-run");
+    async_run_thread_pool_name_ = ss.str();
+    to.name = async_run_thread_pool_name_.c_str();
+    // the pool counts the thread calling into it, which never happens for Schedule-only use.
+    to.thread_pool_size = static_cast<int>(async_run_num_threads) + 1;
+    to.allow_spinning = false;
+    to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
+    to.custom_thread_creation_options = session_options.custom_thread_creation_options;
+    to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
+    async_run_thread_pool_ =
+        concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
   }
 
   session_profiler_.Initialize(session_logger_);
+  session_profiler_.EnableNodeSummary(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingNodeSummary, "0") == "1");
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -704,6 +770,12 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  {
+    // queued RunAsync calls use this session.
+    std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+    async_runs_cv_.wait(lock, [this]() { return async_runs_in_flight_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -723,6 +795,25 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  const std::string tuning_results_file =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsFile, "");
+  if (is_inited_ && !tuning_results_file.empty()) {
+    ORT_TRY {
+      auto status = inference_session_utils::SaveTuningResultsToFile(GetTuningResults(),
+                                                                     ToPathString(tuning_results_file));
+      if (!status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Tuning results are not saved: " << status.ErrorMessage();
+      }
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "Error while saving the tuning results: " << e.what();
+      });
+    }
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
   // Unregister the session and ETW callbacks
 #ifdef _WIN32
   std::lock_guard<OrtMutex> lock(active_sessions_mutex_);
@@ -982,9 +1073,11 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    ModelOptions model_options(true, strict_shape_type_inference);
+    model_options.stream_initializers = session_options_.config_options.GetConfigOrDefault(
+                                            kOrtSessionOptionsStreamInitializersFromModelFile, "0") == "1";
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_,
-                                    ModelOptions(true, strict_shape_type_inference));
+                                    *session_logger_, model_options);
   };
 
   common::Status st = LoadWithLoader(loader, "model_loading_uri");
@@ -1202,6 +1295,19 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     return transformer.Apply(graph, modified, logger);
   };
 
+  // remove the outputs the application does not fetch, and the nodes only needed for them, before optimizing them
+  if (const auto outputs_to_keep_string =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsOutputsToKeep, "");
+      !outputs_to_keep_string.empty()) {
+    InlinedHashSet<std::string> outputs_to_keep;
+    for (const auto& name : utils::SplitString(outputs_to_keep_string, ";")) {
+      outputs_to_keep.emplace(name);
+    }
+
+    OutputPruning output_pruning{std::move(outputs_to_keep)};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(output_pruning, *session_logger_, graph));
+  }
+
   // ensure potential QDQ node units have unique DQ nodes
   if (const bool disable_quant_qdq =
           session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsDisableQuantQDQ, "0") == "1";
@@ -1293,6 +1399,38 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
         graph_transformer_mgr_.ApplyTransformers(graph, static_cast<TransformerLevel>(i), *session_logger_));
   }
 
+  // report the QDQ groups that the optimizations left unfused
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsQDQFusionReport, "0") == "1") {
+    const bool qdq_is_int8_allowed =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsQDQIsInt8Allowed,
+                                                           QDQIsInt8Allowed() ? "1" : "0") == "1";
+    QDQFusionReport qdq_fusion_report{qdq_is_int8_allowed};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(qdq_fusion_report, *session_logger_, graph));
+  }
+
+  // Convert to float16/bfloat16 if requested. Needs the node assignments, and must run before the casts for the
+  // fp16 nodes that have no kernel are inserted.
+  if (session_options_.graph_optimization_level >= TransformerLevel::Level2) {
+    const auto float16_conversion = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsFloat16Conversion, "");
+    if (!float16_conversion.empty()) {
+      ORT_RETURN_IF_NOT(float16_conversion == "fp16" || float16_conversion == "bf16",
+                        "Invalid value for ", kOrtSessionOptionsFloat16Conversion, ": ", float16_conversion,
+                        ". Expected \"fp16\" or \"bf16\".");
+
+      InlinedHashSet<std::string> op_block_list;
+      const auto op_block_list_string = session_options_.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsFloat16ConversionOpBlockList, "");
+      for (const auto& op_type : utils::SplitString(op_block_list_string, ";")) {
+        op_block_list.emplace(op_type);
+      }
+
+      Float16Conversion float16_conversion_transformer{kernel_registry_manager_, float16_conversion == "bf16",
+                                                       std::move(op_block_list)};
+      ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(float16_conversion_transformer, *session_logger_, graph));
+    }
+  }
+
   // Insert cast node/s.
   {
     const InlinedVector<gsl::not_null<const KernelRegistry*>> kernel_regs =
@@ -1324,8 +1462,12 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerApplyConfig, "");
     const std::string probe_config =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerProbeConfig, "0:0");
+    const std::string memory_budget_mb =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerBudgetMB, "");
+    const std::string dim_values =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerDimValues, "");
 
-    MemoryOptimizer mem_transformer{memory_optimizer_config_file, probe_config};
+    MemoryOptimizer mem_transformer{memory_optimizer_config_file, probe_config, memory_budget_mb, dim_values};
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(mem_transformer, *session_logger_, graph));
   }
 #endif
@@ -1356,12 +1498,31 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+static Status MapOrtModelBytes(const PathString& model_uri,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_bytes) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_bytes));
+
+  bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
-        ORT_RETURN_IF_ERROR(
-            LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+        const auto use_mmap =
+            GetSessionOptions().config_options.GetConfigOrDefault(kOrtSessionOptionsUseMmapForOrtModel, "1") == "1";
+        if (use_mmap) {
+          ORT_RETURN_IF_ERROR(
+              MapOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_mapped_bytes_));
+        } else {
+          ORT_RETURN_IF_ERROR(
+              LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+        }
         return Status::OK();
       });
 }
@@ -1467,11 +1628,14 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // a memory mapped model is owned by the session, so its initializers are used in place by default.
   const auto& config_options = session_options_.config_options;
+  const bool is_mapped = ort_format_model_mapped_bytes_ != nullptr;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
           ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers,
+                                            is_mapped ? "1" : "0") == "1";
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1743,6 +1907,11 @@ common::Status InferenceSession::Initialize() {
       session_state_->UpdateAllocatorsWithEnvAllocators(environment_.GetRegisteredSharedAllocators());
     }
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsShareInitializersWithEnv, "0") == "1") {
+      LOGS(*session_logger_, INFO) << "This session will share external initializers through the environment.";
+      session_state_->SetSharedInitializerStore(environment_.GetSharedInitializerStore());
+    }
+
     for (auto& ep : execution_providers_) {
       auto tuning_ctx = ep->GetTuningContext();
       if (nullptr != tuning_ctx) {
@@ -1750,6 +1919,18 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    if (auto* cpu_tuning_ctx = execution_providers_.Get(kCpuExecutionProvider)->GetTuningContext();
+        nullptr != cpu_tuning_ctx) {
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOpAndTuning();
+      } else if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOp();
+      }
+      cpu_tuning_ctx->SetMaxTuningDurationMs(ParseStringWithClassicLocale<int>(
+          config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "0")));
+    }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
     session_state_->SetMemoryProfiler(&memory_profiler_);
@@ -2069,16 +2250,38 @@ common::Status InferenceSession::Initialize() {
     if (found_tuning_results) {
       ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true));
     }
+
+    const std::string tuning_results_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsFile, "");
+    if (!tuning_results_file.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(inference_session_utils::ParseTuningResultsFromFile(
+          ToPathString(tuning_results_file), tuning_results, found_tuning_results));
+      if (found_tuning_results) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false,
+                                                        /*auto_enable*/ true));
+      }
+    }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(InitStateTensors());
+
+    const std::string graph_capture_max_shapes =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsGraphCaptureMaxShapes, "0");
+    if (!TryParseStringWithClassicLocale<size_t>(graph_capture_max_shapes, graph_capture_max_shapes_)) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ",
+                                                     kOrtSessionOptionsGraphCaptureMaxShapes, " value of ",
+                                                     graph_capture_max_shapes));
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
       ort_format_model_bytes_ = gsl::span<const uint8_t>();
       std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+      ort_format_model_mapped_bytes_.reset();
     }
 
     // once the model is saved, we may remove unnecessary attributes for inference
@@ -2123,6 +2326,18 @@ common::Status InferenceSession::Initialize() {
     }
   }
 
+  if (status.IsOK()) {
+    const size_t max_batch_size = ParseStringWithClassicLocale<size_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsRequestBatchingMaxBatchSize, "0"));
+    if (max_batch_size > 0) {
+      RequestBatcher::Options batching_options;
+      batching_options.max_batch_size = max_batch_size;
+      batching_options.max_delay = std::chrono::microseconds(ParseStringWithClassicLocale<int64_t>(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsRequestBatchingMaxDelayUs, "1000")));
+      status = RequestBatcher::Create(*this, batching_options, request_batcher_);
+    }
+  }
+
   return status;
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -2457,12 +2672,124 @@ struct ThreadPoolSpinningSwitch {
     }
   }
 };
+
+// Tracks the runs of sessions with a high priority in a shared threadpool
+struct SharedThreadPoolRun {
+  concurrency::ThreadPool* tp_{nullptr};
+  explicit SharedThreadPoolRun(concurrency::ThreadPool* tp) noexcept : tp_(tp) {
+    concurrency::ThreadPool::BeginRun(tp_);
+  }
+  ~SharedThreadPoolRun() {
+    concurrency::ThreadPool::EndRun(tp_);
+  }
+};
 }  // namespace
 
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
-                             const std::vector<OrtDevice>* p_fetches_device_info) {
+                             const std::vector<OrtDevice>* p_fetches_device_info,
+                             const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators) {
+  // the inputs of the selected LoRA adapter that the caller does not feed are fed from the adapter.
+  InlinedVector<std::string> adapter_feed_names;
+  InlinedVector<OrtValue> adapter_feeds;
+  const std::string adapter_name =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigLoraAdapter, "");
+  if (!adapter_name.empty()) {
+    adapter_feed_names.assign(feed_names.begin(), feed_names.end());
+    adapter_feeds.assign(feeds.begin(), feeds.end());
+    {
+      std::lock_guard<OrtMutex> lock(lora_adapters_mutex_);
+      auto it = lora_adapters_.find(adapter_name);
+      if (it == lora_adapters_.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The LoRA adapter ", adapter_name,
+                               " is not registered in the session.");
+      }
+      for (size_t i = 0, end = it->second.input_names.size(); i < end; ++i) {
+        if (std::find(feed_names.begin(), feed_names.end(), it->second.input_names[i]) == feed_names.end()) {
+          adapter_feed_names.push_back(it->second.input_names[i]);
+          adapter_feeds.push_back(it->second.values[i]);
+        }
+      }
+    }
+    feed_names = adapter_feed_names;
+    feeds = adapter_feeds;
+  }
+
+  if (state_tensors_.empty()) {
+    if (graph_capture_max_shapes_ != 0 && cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
+        p_fetches_device_info == nullptr && p_fetch_allocators == nullptr &&
+        run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigCudaGraphAnnotation, "").empty()) {
+      return RunWithGraphCaptureShapes(run_options, feed_names, feeds, output_names, p_fetches);
+    }
+    return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                   p_fetch_allocators);
+  }
+
+  // Every run consumes the states produced by the previous one, so the runs are serialized.
+  std::lock_guard<OrtMutex> state_lock(state_tensors_mutex_);
+  if (run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigResetStateTensors, "0") == "1") {
+    for (auto& state_value : state_values_) {
+      state_value = OrtValue();
+    }
+  }
+
+  InlinedVector<std::string> all_feed_names(feed_names.begin(), feed_names.end());
+  InlinedVector<OrtValue> all_feeds(feeds.begin(), feeds.end());
+  InlinedVector<std::string> all_output_names(output_names.begin(), output_names.end());
+  std::vector<OrtDevice> all_fetches_device_info =
+      p_fetches_device_info ? *p_fetches_device_info : std::vector<OrtDevice>(output_names.size());
+  const bool fetches_allocated = !p_fetches->empty();
+  InlinedVector<size_t> state_fetch_indices;
+  state_fetch_indices.reserve(state_tensors_.size());
+
+  for (size_t i = 0, end = state_tensors_.size(); i < end; ++i) {
+    const auto& state = state_tensors_[i];
+    // a state fed by the caller takes precedence over the stored one.
+    if (state_values_[i].IsAllocated() &&
+        std::find(feed_names.begin(), feed_names.end(), state.input_name) == feed_names.end()) {
+      all_feed_names.push_back(state.input_name);
+      all_feeds.push_back(state_values_[i]);
+    }
+
+    auto output_it = std::find(output_names.begin(), output_names.end(), state.output_name);
+    if (output_it != output_names.end()) {
+      const size_t output_index = static_cast<size_t>(output_it - output_names.begin());
+      if (fetches_allocated && (*p_fetches)[output_index].IsAllocated()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state tensor output ", state.output_name,
+                               " cannot be fetched into a pre-allocated buffer as it is fed to the next run.");
+      }
+      state_fetch_indices.push_back(output_index);
+    } else {
+      // fetch the state on the device that consumes it so that it never leaves the device.
+      state_fetch_indices.push_back(all_output_names.size());
+      all_output_names.push_back(state.output_name);
+      all_fetches_device_info.push_back(state.device);
+      if (fetches_allocated) {
+        p_fetches->emplace_back();
+      }
+    }
+  }
+
+  Status status = RunImpl(run_options, all_feed_names, all_feeds, all_output_names, p_fetches,
+                          &all_fetches_device_info, p_fetch_allocators);
+  if (status.IsOK()) {
+    for (size_t i = 0, end = state_tensors_.size(); i < end; ++i) {
+      state_values_[i] = (*p_fetches)[state_fetch_indices[i]];
+    }
+  }
+  if (p_fetches->size() > output_names.size()) {
+    p_fetches->resize(output_names.size());
+  }
+  return status;
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators,
+                                 FeedsFetchesManager* prepared_feeds_fetches_manager) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2486,6 +2813,27 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
   }
 
+  int run_intra_op_num_threads = 0;
+  const std::string& run_intra_op_num_threads_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigIntraOpNumThreads, "0");
+  if (!TryParseStringWithClassicLocale<int>(run_intra_op_num_threads_str, run_intra_op_num_threads) ||
+      run_intra_op_num_threads < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", kOrtRunOptionsConfigIntraOpNumThreads,
+                           " value of ", run_intra_op_num_threads_str);
+  }
+
+  std::optional<concurrency::ThreadPool::SchedulingPriority> run_intra_op_priority;
+  const std::string& run_intra_op_priority_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigIntraOpPriority, "");
+  if (run_intra_op_priority_str == "normal") {
+    run_intra_op_priority = concurrency::ThreadPool::SchedulingPriority::kNormal;
+  } else if (run_intra_op_priority_str == "high") {
+    run_intra_op_priority = concurrency::ThreadPool::SchedulingPriority::kHigh;
+  } else if (!run_intra_op_priority_str.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", kOrtRunOptionsConfigIntraOpPriority,
+                           " value of ", run_intra_op_priority_str);
+  }
+
   // Increment/decrement concurrent_num_runs_ and control
   // session threads spinning as configured. Do nothing for graph replay except the counter.
   const bool control_spinning = use_per_session_threads_ &&
@@ -2494,6 +2842,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* intra_tp = (control_spinning) ? thread_pool_.get() : nullptr;
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
+  // the priority of the run, if set, replaces the one of the session's view of the shared pool
+  SharedThreadPoolRun shared_tp_run(run_intra_op_priority.has_value() ? nullptr : intra_op_thread_pool_view_.get());
+  concurrency::ThreadPool::RunScope tp_run_scope(GetIntraOpThreadPoolToUse(), run_intra_op_num_threads,
+                                                 run_intra_op_priority);
 
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
@@ -2528,8 +2880,13 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      std::optional<FeedsFetchesManager> owned_feeds_fetches_manager;
+      if (prepared_feeds_fetches_manager == nullptr) {
+        FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+        owned_feeds_fetches_manager.emplace(std::move(info));
+      }
+      FeedsFetchesManager& feeds_fetches_manager =
+          prepared_feeds_fetches_manager ? *prepared_feeds_fetches_manager : *owned_feeds_fetches_manager;
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
@@ -2589,7 +2946,9 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #endif
 
       if (retval.IsOK()) {
+        static const std::unordered_map<size_t, IExecutor::CustomAllocator> no_fetch_allocators;
         retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                     p_fetch_allocators ? *p_fetch_allocators : no_fetch_allocators,
                                      session_options_.execution_mode,
                                      run_options,
 #ifdef ORT_ENABLE_STREAM
@@ -2628,6 +2987,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
     if (!arenas_to_shrink.empty()) {
       ShrinkMemoryArenas(arenas_to_shrink);
     }
+
+    if (auto* evictor = session_state_->GetColdInitializerEvictor(); evictor != nullptr) {
+      evictor->OnRunEnd();
+    }
   }
 
   // keep track of telemetry
@@ -2666,11 +3029,55 @@ Status InferenceSession::Run(const RunOptions& run_options,
       cached_execution_provider_for_graph_replay_.AllowGraphCaptureOnRun(graph_annotation_id) &&
       !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                p_fetch_allocators, prepared_feeds_fetches_manager));
   }
   return retval;
 }
 
+Status InferenceSession::PrepareRun(gsl::span<const std::string> feed_names,
+                                    gsl::span<const std::string> output_names,
+                                    std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager) const {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session not initialized.");
+  }
+
+  if (output_names.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  for (const auto& name : feed_names) {
+    if (input_def_map_.count(name) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", name);
+    }
+  }
+
+  for (const auto& name : output_names) {
+    if (output_def_map_.count(name) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name: ", name);
+    }
+  }
+
+  return FeedsFetchesManager::Create(feed_names, output_names, session_state_->GetOrtValueNameIdxMap(),
+                                     feeds_fetches_manager);
+}
+
+Status InferenceSession::RunPrepared(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                     gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) {
+  // both change the feeds and fetches of each run, which the prepared names cannot account for
+  if (!state_tensors_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Prepared runs do not support models with state tensors.");
+  }
+
+  if (!run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigLoraAdapter, "").empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Prepared runs do not support LoRA adapters.");
+  }
+
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  return RunImpl(run_options, info.feed_names, feeds, info.output_names, &fetches, nullptr, nullptr,
+                 &feeds_fetches_manager);
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const char* const> feed_names,
                              gsl::span<const OrtValue* const> feeds,
@@ -2717,7 +3124,13 @@ Status InferenceSession::Run(const RunOptions& run_options,
   }
 
   Status status;
-  status = Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, &fetch_vec, nullptr);
+  // pre-allocated outputs can't be filled from a batched run without a copy, so those runs are not batched.
+  if (request_batcher_ != nullptr &&
+      std::all_of(fetches.begin(), fetches.end(), [](const OrtValue* fetch) { return fetch == nullptr; })) {
+    status = request_batcher_->Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, fetch_vec);
+  } else {
+    status = Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, &fetch_vec, nullptr);
+  }
 
   if (!status.IsOK())
     return status;
@@ -2750,18 +3163,63 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           RunAsyncCallbackFn callback,
                                           void* user_data) {
   size_t num_fetches = fetch_names.size();
-  auto* tp = GetIntraOpThreadPoolToUse();
-  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
+  auto* tp = async_run_thread_pool_ ? async_run_thread_pool_.get() : GetIntraOpThreadPoolToUse();
+  if (!async_run_thread_pool_ && (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "intra op thread pool must have at least one thread for RunAsync unless ",
+                           kOrtSessionOptionsAsyncRunNumThreads, " is set");
+  }
+
+  // copy the names and inputs so the caller can release them once RunAsync returns.
+  struct AsyncRunRequest {
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> fetch_names;
+  };
+
+  auto request = std::make_shared<AsyncRunRequest>();
+  request->feed_names.reserve(feed_names.size());
+  request->feeds.reserve(feeds.size());
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    if (feed_names[i] == nullptr || feeds[i] == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Null input name or value supplied for input ", i);
+    }
+    request->feed_names.emplace_back(feed_names[i]);
+    request->feeds.push_back(*feeds[i]);
+  }
+
+  request->fetch_names.reserve(num_fetches);
+  for (size_t i = 0; i < num_fetches; ++i) {
+    if (fetch_names[i] == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Null output name supplied for output ", i);
+    }
+    request->fetch_names.emplace_back(fetch_names[i]);
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    ++async_runs_in_flight_;
   }
+
   std::function<void()> run_fn = [=]() {
+    InlinedVector<const char*> feed_name_ptrs;
+    InlinedVector<const OrtValue*> feed_ptrs;
+    InlinedVector<const char*> fetch_name_ptrs;
+    for (size_t i = 0; i < request->feeds.size(); ++i) {
+      feed_name_ptrs.push_back(request->feed_names[i].c_str());
+      feed_ptrs.push_back(&request->feeds[i]);
+    }
+    for (const auto& fetch_name : request->fetch_names) {
+      fetch_name_ptrs.push_back(fetch_name.c_str());
+    }
+
     Status status = Status::OK();
     ORT_TRY {
       if (run_options) {
-        status = Run(*run_options, feed_names, feeds, fetch_names, fetches);
+        status = Run(*run_options, feed_name_ptrs, feed_ptrs, fetch_name_ptrs, fetches);
       } else {
         RunOptions default_run_options;
-        status = Run(default_run_options, feed_names, feeds, fetch_names, fetches);
+        status = Run(default_run_options, feed_name_ptrs, feed_ptrs, fetch_name_ptrs, fetches);
       }
     }
     ORT_CATCH(const std::exception& ex) {
@@ -2773,6 +3231,11 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
       status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
     }
     callback(user_data, fetches.data(), status.IsOK() ? num_fetches : 0, ToOrtStatus(status));
+
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    if (--async_runs_in_flight_ == 0) {
+      async_runs_cv_.notify_all();
+    }
   };  // run_fn
   concurrency::ThreadPool::Schedule(tp, run_fn);
   return Status::OK();
@@ -2800,6 +3263,55 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
 }
 
+common::Status InferenceSession::RunBatch(const RunOptions& run_options, gsl::span<const NameMLValMap> feeds,
+                                          gsl::span<const std::string> output_names,
+                                          std::vector<std::vector<OrtValue>>& fetches) {
+  const size_t num_requests = feeds.size();
+  fetches.clear();
+  fetches.resize(num_requests);
+  std::vector<Status> statuses(num_requests);
+
+  auto run_request = [&](size_t i) {
+    ORT_TRY {
+      statuses[i] = Run(run_options, feeds[i], output_names, &fetches[i]);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    ORT_CATCH(...) {
+      statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+    }
+  };
+
+  if (num_requests == 0) {
+    return Status::OK();
+  }
+
+  // schedule the requests as independent tasks like RunAsync does. running them inside a parallel section of the
+  // intra-op pool would make the kernels of the requests that parallelize their work use nested parallelism.
+  auto* tp = async_run_thread_pool_ ? async_run_thread_pool_.get() : GetIntraOpThreadPoolToUse();
+  Barrier barrier(static_cast<unsigned int>(num_requests - 1));
+  for (size_t i = 1; i < num_requests; ++i) {
+    concurrency::ThreadPool::Schedule(tp, [&run_request, &barrier, i]() {
+      run_request(i);
+      barrier.Notify();
+    });
+  }
+
+  run_request(0);
+  barrier.Wait();
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    if (!statuses[i].IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Request ", i, " of the batch failed: ", statuses[i].ErrorMessage());
+    }
+  }
+
+  return Status::OK();
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -2866,8 +3378,14 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
+  // outputs bound to a buffer allocator request a new buffer for every run instead of reusing the previous output.
+  const auto& outputs_allocators = io_binding.GetOutputsAllocators();
+  for (const auto& entry : outputs_allocators) {
+    io_binding.GetOutputs()[entry.first] = OrtValue();
+  }
+
   return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo(), &outputs_allocators);
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -2913,6 +3431,146 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetKernelStatistics(bool reset, std::string& json) {
+  ORT_RETURN_IF_NOT(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableKernelStatistics, "0") == "1",
+      "Kernel statistics are not enabled. Set ", kOrtSessionOptionsEnableKernelStatistics, " to 1.");
+
+  auto& kernel_statistics = session_profiler_.GetKernelStatistics();
+  json = kernel_statistics.ToJson();
+  if (reset) {
+    // kernels completing in between are dropped, which is fine for monitoring.
+    kernel_statistics.Reset();
+  }
+
+  return Status::OK();
+}
+
+namespace {
+void ThreadPoolStatisticsToJson(const concurrency::ThreadPool* tp, std::ostringstream& ss) {
+  ss << "[";
+  bool first = true;
+  for (const auto& stats : concurrency::ThreadPool::GetProfilingStats(tp)) {
+    ss << (first ? "" : ",")
+       << "{\"num_runs\":" << stats.num_runs
+       << ",\"num_steals\":" << stats.num_steals
+       << ",\"busy_us\":" << stats.busy_us
+       << ",\"elapsed_us\":" << stats.elapsed_us
+       << ",\"steal_rate\":" << stats.StealRate()
+       << ",\"idle_percentage\":" << stats.IdlePercentage()
+       << ",\"avg_run_us\":" << stats.AverageRunMicros()
+       << "}";
+    first = false;
+  }
+  ss << "]";
+}
+}  // namespace
+
+common::Status InferenceSession::GetThreadPoolStatistics(std::string& json) const {
+  ORT_RETURN_IF_NOT(session_profiler_.IsEnabled() || session_profiler_.GetStartTimeNs() != 0,
+                    "Thread pool statistics are collected while profiling is enabled. Enable profiling first.");
+
+  std::ostringstream ss;
+  ss << "{\"intra_op\":";
+  ThreadPoolStatisticsToJson(GetIntraOpThreadPoolToUse(), ss);
+  ss << ",\"inter_op\":";
+  ThreadPoolStatisticsToJson(GetInterOpThreadPoolToUse(), ss);
+  ss << "}";
+  json = ss.str();
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetArenaReport(const OrtMemoryInfo& mem_info, std::string& json) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    ORT_RETURN_IF_NOT(is_inited_, "Session not initialized.");
+  }
+
+  auto alloc = GetAllocator(mem_info);
+  if (alloc == nullptr || alloc->Info().alloc_type != OrtAllocatorType::OrtArenaAllocator) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no arena based allocator for ",
+                           mem_info.ToString());
+  }
+
+  json = static_cast<BFCArena*>(alloc.get())->GetReport();
+  return Status::OK();
+}
+
+common::Status InferenceSession::Warmup(const RunOptions& run_options, gsl::span<const std::string> input_names,
+                                        gsl::span<const TensorShapeVector> shapes) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    ORT_RETURN_IF_NOT(is_inited_, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_NOT(input_names.empty() ? shapes.empty() : shapes.size() % input_names.size() == 0,
+                    "The number of shapes (", shapes.size(), ") must be a multiple of the number of inputs (",
+                    input_names.size(), ").");
+
+  const auto& graph = model_->MainGraph();
+  const auto& input_defs = graph.GetInputs();
+  for (const auto& input_name : input_names) {
+    ORT_RETURN_IF_NOT(std::any_of(input_defs.cbegin(), input_defs.cend(),
+                                  [&input_name](const NodeArg* def) { return def->Name() == input_name; }),
+                      "Invalid warmup input name: ", input_name);
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<std::string> output_names;
+  feed_names.reserve(input_defs.size());
+  for (const NodeArg* def : input_defs) {
+    feed_names.push_back(def->Name());
+  }
+  for (const NodeArg* def : graph.GetOutputs()) {
+    output_names.push_back(def->Name());
+  }
+
+  // the feeds are created on the CPU, as by the callers, so the copies to the devices are warmed up too.
+  AllocatorPtr cpu_allocator = session_state_->GetAllocator(OrtDevice());
+  const size_t num_shape_sets = input_names.empty() ? 1 : shapes.size() / input_names.size();
+  for (size_t set = 0; set < num_shape_sets; ++set) {
+    std::vector<OrtValue> feeds(input_defs.size());
+    for (size_t i = 0, end = input_defs.size(); i < end; ++i) {
+      const NodeArg& def = *input_defs[i];
+      MLDataType type = DataTypeImpl::TypeFromProto(*def.TypeAsProto());
+      ORT_RETURN_IF_NOT(type->IsTensorType(), "Warmup only supports tensor inputs. Input ", def.Name(),
+                        " is not a tensor.");
+
+      TensorShapeVector dims;
+      auto name = std::find(input_names.begin(), input_names.end(), def.Name());
+      if (name != input_names.end()) {
+        dims = shapes[set * input_names.size() + static_cast<size_t>(name - input_names.begin())];
+      } else if (const auto* shape = def.Shape(); shape != nullptr) {
+        for (const auto& dim : shape->dim()) {
+          dims.push_back(utils::HasDimValue(dim) ? dim.dim_value() : 1);
+        }
+      }
+
+      Tensor::InitOrtValue(type->AsTensorType()->GetElementType(), TensorShape(dims), cpu_allocator, feeds[i]);
+      Tensor& tensor = *feeds[i].GetMutable<Tensor>();
+      if (!tensor.IsDataTypeString()) {
+        memset(tensor.MutableDataRaw(), 0, tensor.SizeInBytes());
+      }
+    }
+
+    // the memory patterns are created by the first run of a shape and used from the second one.
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < 2; ++run) {
+      std::vector<OrtValue> fetches;
+      ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, &fetches));
+    }
+
+    LOGS(*session_logger_, INFO) << "Warmup of shape set " << set << " took "
+                                 << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count()
+                                 << " ms";
+  }
+
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -3048,6 +3706,173 @@ common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model)
 }
 #endif
 
+common::Status InferenceSession::AddLoraAdapter(const std::string& adapter_name,
+                                                gsl::span<const std::string> input_names,
+                                                gsl::span<const OrtValue> values) {
+  if (!is_model_loaded_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The model must be loaded before registering LoRA adapters.");
+  }
+  if (adapter_name.empty() || input_names.size() != values.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid LoRA adapter '", adapter_name, "' with ",
+                           input_names.size(), " inputs and ", values.size(), " values.");
+  }
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    if (input_def_map_.find(input_names[i]) == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The LoRA adapter input ", input_names[i],
+                             " is not an input of the graph.");
+    }
+    if (!values[i].IsAllocated()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The value of the LoRA adapter input ", input_names[i],
+                             " is not allocated.");
+    }
+  }
+
+  LoraAdapter adapter{InlinedVector<std::string>(input_names.begin(), input_names.end()),
+                      InlinedVector<OrtValue>(values.begin(), values.end())};
+  std::lock_guard<OrtMutex> lock(lora_adapters_mutex_);
+  lora_adapters_[adapter_name] = std::move(adapter);
+  return Status::OK();
+}
+
+common::Status InferenceSession::RemoveLoraAdapter(const std::string& adapter_name) {
+  std::lock_guard<OrtMutex> lock(lora_adapters_mutex_);
+  if (lora_adapters_.erase(adapter_name) == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The LoRA adapter ", adapter_name,
+                           " is not registered in the session.");
+  }
+  return Status::OK();
+}
+
+common::Status InferenceSession::InitStateTensors() {
+  const std::string state_tensors_string =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsStateTensors, "");
+  state_tensors_.clear();
+  for (const auto& pair : utils::SplitString(state_tensors_string, ";")) {
+    const auto names = utils::SplitString(pair, ":", true);
+    if (names.size() != 2 || names[0].empty() || names[1].empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid state tensor '", pair,
+                             "', expected <output name>:<input name>.");
+    }
+    StateTensor state{std::string(names[0]), std::string(names[1]), OrtDevice()};
+    if (output_def_map_.find(state.output_name) == output_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state tensor output ", state.output_name,
+                             " is not an output of the graph.");
+    }
+    if (input_def_map_.find(state.input_name) == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state tensor input ", state.input_name,
+                             " is not an input of the graph.");
+    }
+    InlinedVector<SessionState::NodeInfo> node_info_vec;
+    if (session_state_->GetInputNodeInfo(state.input_name, node_info_vec).IsOK() && !node_info_vec.empty() &&
+        node_info_vec.front().device != nullptr) {
+      state.device = *node_info_vec.front().device;
+    }
+    state_tensors_.push_back(std::move(state));
+  }
+  state_values_.assign(state_tensors_.size(), OrtValue());
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunWithGraphCaptureShapes(const RunOptions& run_options,
+                                                           gsl::span<const std::string> feed_names,
+                                                           gsl::span<const OrtValue> feeds,
+                                                           gsl::span<const std::string> output_names,
+                                                           std::vector<OrtValue>* p_fetches) {
+  RunOptions graph_run_options = run_options;
+  std::ostringstream key;
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (!feeds[i].IsTensor()) {
+      ORT_RETURN_IF_ERROR(graph_run_options.config_options.AddConfigEntry(
+          kOrtRunOptionsConfigCudaGraphAnnotation,
+          std::to_string(CachedExecutionProviderForGraphReplay::kGraphAnnotationSkip).c_str()));
+      return RunImpl(graph_run_options, feed_names, feeds, output_names, p_fetches, nullptr, nullptr);
+    }
+    const Tensor& tensor = feeds[i].Get<Tensor>();
+    key << feed_names[i] << ':' << tensor.GetElementType() << tensor.Shape() << ';';
+  }
+  for (const auto& output_name : output_names) {
+    key << output_name << ';';
+  }
+
+  const std::string key_string = key.str();
+
+  // the graph replays are serialized as the staged inputs and the outputs of a graph are shared by its runs.
+  std::lock_guard<OrtMutex> lock(graph_capture_shapes_mutex_);
+  auto shapes = std::find_if(graph_capture_shapes_.begin(), graph_capture_shapes_.end(),
+                             [&key_string](const GraphCaptureShapes& s) { return s.key == key_string; });
+  if (shapes != graph_capture_shapes_.end()) {
+    graph_capture_shapes_.splice(graph_capture_shapes_.begin(), graph_capture_shapes_, shapes);
+  } else {
+    if (graph_capture_shapes_.size() >= graph_capture_max_shapes_) {
+      ORT_RETURN_IF_ERROR(
+          cached_execution_provider_for_graph_replay_.ReleaseGraph(graph_capture_shapes_.back().graph_annotation_id));
+      graph_capture_shapes_.pop_back();
+    }
+
+    GraphCaptureShapes new_shapes{key_string, next_graph_annotation_id_++, {}, {}};
+    new_shapes.staged_feeds.resize(feeds.size());
+    for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+      const Tensor& tensor = feeds[i].Get<Tensor>();
+      // stage the input on the device of the nodes consuming it, else where the caller keeps it.
+      OrtDevice device = tensor.Location().device;
+      InlinedVector<SessionState::NodeInfo> node_info_vec;
+      if (session_state_->GetInputNodeInfo(feed_names[i], node_info_vec).IsOK() && !node_info_vec.empty() &&
+          node_info_vec.front().device != nullptr) {
+        device = *node_info_vec.front().device;
+      }
+      AllocatorPtr allocator = session_state_->GetAllocator(device);
+      ORT_RETURN_IF(allocator == nullptr, "No allocator to stage the input ", feed_names[i], " on ",
+                    device.ToString());
+      Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), std::move(allocator), new_shapes.staged_feeds[i]);
+    }
+    graph_capture_shapes_.push_front(std::move(new_shapes));
+  }
+
+  GraphCaptureShapes& current = graph_capture_shapes_.front();
+  const DataTransferManager& data_transfer_mgr = session_state_->GetDataTransferMgr();
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(feeds[i].Get<Tensor>(),
+                                                     *current.staged_feeds[i].GetMutable<Tensor>()));
+  }
+
+  // the outputs are fetched on the devices producing them, a copy to another device can't be captured.
+  std::vector<OrtDevice> fetches_device_info(output_names.size());
+  for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+    InlinedVector<SessionState::NodeInfo> node_info_vec;
+    if (session_state_->GetOutputNodeInfo(output_names[i], node_info_vec).IsOK() && !node_info_vec.empty() &&
+        node_info_vec.front().device != nullptr) {
+      fetches_device_info[i] = *node_info_vec.front().device;
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(graph_run_options.config_options.AddConfigEntry(
+      kOrtRunOptionsConfigCudaGraphAnnotation, std::to_string(current.graph_annotation_id).c_str()));
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(RunImpl(graph_run_options, feed_names, current.staged_feeds, output_names, &fetches,
+                              &fetches_device_info, nullptr));
+  if (current.fetches.empty() &&
+      cached_execution_provider_for_graph_replay_.IsGraphCaptured(current.graph_annotation_id)) {
+    // the captured graph writes every replay into the outputs of the capturing run, keep them out of the arena.
+    current.fetches = std::move(fetches);
+  }
+  const std::vector<OrtValue>& results = current.fetches.empty() ? fetches : current.fetches;
+  if (p_fetches->empty()) {
+    p_fetches->resize(output_names.size());
+  }
+
+  for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+    ORT_RETURN_IF_NOT(results[i].IsTensor(), "The graph output ", output_names[i], " is not a tensor.");
+    const Tensor& src = results[i].Get<Tensor>();
+    OrtValue& dst = (*p_fetches)[i];
+    if (!dst.IsAllocated()) {
+      // the outputs that are not pre-allocated are returned on the CPU as by the other runs.
+      Tensor::InitOrtValue(src.DataType(), src.Shape(), session_state_->GetAllocator(OrtDevice()), dst);
+    }
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(src, *dst.GetMutable<Tensor>()));
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::SaveModelMetadata(const onnxruntime::Model& model) {
   VLOGS(*session_logger_, 1) << "Saving model metadata";
   const onnxruntime::Graph& graph = model.MainGraph();
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 #include <optional>
 #include <string>
@@ -28,6 +29,7 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -52,6 +54,7 @@ class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
 struct Notification;
+class RequestBatcher;
 
 #ifdef ENABLE_TRAINING
 struct PartialGraphExecutionState;
@@ -332,7 +335,9 @@ class InferenceSession {
   [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
                                    gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches,
-                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr);
+                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators =
+                                       nullptr);
 
   [[nodiscard]] common::Status Run(const RunOptions& run_options,
                                    gsl::span<const char* const> feed_names,
@@ -340,6 +345,12 @@ class InferenceSession {
                                    gsl::span<const char* const> fetch_names,
                                    gsl::span<OrtValue*> fetches);
 
+  /**
+   * Queue a run and return without waiting for it. callback is invoked from a worker thread once the run completes.
+   * The names and input values are copied so only run_options and the fetches array need to stay valid until
+   * callback is invoked. Runs are executed on the threads configured with kOrtSessionOptionsAsyncRunNumThreads,
+   * or on the intra-op thread pool if it is not set.
+   */
   [[nodiscard]] common::Status RunAsync(const RunOptions* run_options,
                                         gsl::span<const char* const> feed_names,
                                         gsl::span<const OrtValue* const> feeds,
@@ -370,6 +381,37 @@ class InferenceSession {
                                    gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches);
 
+  /**
+   * Run a batch of independent requests concurrently and wait for all of them.
+   * The requests are executed on the threads configured with kOrtSessionOptionsAsyncRunNumThreads, or on the
+   * intra-op thread pool if it is not set, as for RunAsync. The calling thread runs requests too.
+   * @param feeds the named inputs of each request.
+   * @param output_names output names, the same for every request.
+   * @param fetches the output values of each request in the order specified by output_names.
+   * @return OK if all requests succeeded, else the error of the first failed request.
+   */
+  [[nodiscard]] common::Status RunBatch(const RunOptions& run_options, gsl::span<const NameMLValMap> feeds,
+                                        gsl::span<const std::string> output_names,
+                                        std::vector<std::vector<OrtValue>>& fetches);
+
+  /**
+   * Resolve the feed and fetch names of a run once, for runs that use the same names repeatedly.
+   * @param feeds_fetches_manager Set to the resolved names, for use with RunPrepared.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status PrepareRun(gsl::span<const std::string> feed_names,
+                                          gsl::span<const std::string> output_names,
+                                          std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager) const;
+
+  /**
+   * Run with the names resolved by PrepareRun, skipping the name to index mapping of Run.
+   * The feeds and fetches are in the order of the names given to PrepareRun.
+   * A FeedsFetchesManager holds per run state, so it must not be used by concurrent runs.
+   * Models with state tensors and runs with a LoRA adapter are not supported.
+   */
+  [[nodiscard]] common::Status RunPrepared(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                           gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches);
+
   /**
    * Creates a new binding object for binding inputs and outputs.
    * @param provider_type specifies the location where the inputs need to be potentially copied.
@@ -486,6 +528,42 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Get the aggregated kernel statistics collected when kOrtSessionOptionsEnableKernelStatistics is set.
+    @param reset clear the statistics after reading them, so the next call only covers the runs in between.
+    @param json the statistics as a JSON array with one entry per op type and execution provider.
+    @return an error if kernel statistics are not enabled for this session.
+    */
+  common::Status GetKernelStatistics(bool reset, std::string& json);
+
+  /**
+    * Get the scheduling statistics of the threads of the intra-op and inter-op thread pools, accumulated since
+    * profiling of the session was first started, without stopping it.
+    @param json the statistics as a JSON object with an "intra_op" and an "inter_op" array with one entry per thread.
+    @return an error if profiling was never enabled for this session.
+    */
+  common::Status GetThreadPoolStatistics(std::string& json) const;
+
+  /**
+    * Get the report of the arena the session allocates from for the given memory info. See BFCArena::GetReport().
+    @param json the report as a JSON object. It includes the allocation size histogram and the extensions of the
+           arena if it was created with tracing enabled.
+    @return an error if the session has no arena based allocator for mem_info.
+    */
+  common::Status GetArenaReport(const OrtMemoryInfo& mem_info, std::string& json) const;
+
+  /**
+    * Run the session on zero filled inputs for each of the given shape sets, so that the first requests with these
+    * shapes don't pay for the kernel algorithm searches, the arena growth, the memory pattern creation, the graph
+    * captures and the lazy loading of device code.
+    @param input_names the inputs the shapes are given for. The other inputs use their model shape, with 1 for the
+           dimensions that are not fixed.
+    @param shapes input_names.size() shapes per shape set, the shapes of a set are in the order of input_names.
+    @return OK once every shape set ran, i.e. the session is warm for them.
+    */
+  [[nodiscard]] common::Status Warmup(const RunOptions& run_options, gsl::span<const std::string> input_names,
+                                      gsl::span<const TensorShapeVector> shapes);
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -536,6 +614,23 @@ class InferenceSession {
    */
   Status AddPrePackedWeightsContainer(PrepackedWeightsContainer* prepacked_weights_container);
 
+  /**
+   * Register a named set of LoRA adapter tensors, e.g. the low rank A and B matrices of one fine tune of the model.
+   * A Run that selects the set with the "run.lora_adapter" run option is fed these tensors for the graph inputs of
+   * the same names, unless the caller feeds them. The tensors are shared by the runs, a set replaces the one with the
+   * same name.
+   * @param adapter_name Name of the adapter set.
+   * @param input_names Graph inputs fed by the adapter set.
+   * @param values Values of the inputs, in the order of input_names.
+   */
+  [[nodiscard]] common::Status AddLoraAdapter(const std::string& adapter_name, gsl::span<const std::string> input_names,
+                                              gsl::span<const OrtValue> values);
+
+  /**
+   * Unregister the LoRA adapter set registered with AddLoraAdapter. Runs in progress keep using its tensors.
+   */
+  [[nodiscard]] common::Status RemoveLoraAdapter(const std::string& adapter_name);
+
  protected:
 #if !defined(ORT_MINIMAL_BUILD)
 
@@ -573,7 +668,7 @@ class InferenceSession {
         return thread_pool_.get();
       }
     } else {
-      return intra_op_thread_pool_from_env_;
+      return intra_op_thread_pool_view_ ? intra_op_thread_pool_view_.get() : intra_op_thread_pool_from_env_;
     }
   }
 
@@ -659,6 +754,23 @@ class InferenceSession {
   [[nodiscard]] common::Status CheckShapes(const std::string& input_name, const TensorShape& input_shape,
                                            const TensorShape& expected_shape, const char* input_output_moniker) const;
 
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators,
+                                       FeedsFetchesManager* prepared_feeds_fetches_manager = nullptr);
+
+  // Parses kOrtSessionOptionsStateTensors.
+  [[nodiscard]] common::Status InitStateTensors();
+
+  // Runs with the graph captured for the shapes of the feeds, see kOrtSessionOptionsGraphCaptureMaxShapes.
+  [[nodiscard]] common::Status RunWithGraphCaptureShapes(const RunOptions& run_options,
+                                                         gsl::span<const std::string> feed_names,
+                                                         gsl::span<const OrtValue> feeds,
+                                                         gsl::span<const std::string> output_names,
+                                                         std::vector<OrtValue>* p_fetches);
+
   [[nodiscard]] common::Status ValidateInputs(gsl::span<const std::string> feed_names,
                                               gsl::span<const OrtValue> feeds) const;
 
@@ -749,11 +861,28 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Dedicated threads for RunAsync, so queued runs neither occupy intra-op threads nor run inline on the
+  // caller's thread. nullptr if kOrtSessionOptionsAsyncRunNumThreads is not set.
+  std::basic_string<ORTCHAR_T> async_run_thread_pool_name_;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;
+
+  // Number of RunAsync calls that haven't invoked their callback yet. The destructor waits for them.
+  OrtMutex async_runs_mutex_;
+  OrtCondVar async_runs_cv_;
+  size_t async_runs_in_flight_{0};
+
+  // batches concurrent Run calls if kOrtSessionOptionsRequestBatchingMaxBatchSize is set.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
 
+  // View of the global intra-op threadpool that applies the quota and the priority of this session to its loops.
+  // Set if kOrtSessionOptionsConfigSharedIntraOpPoolQuota or kOrtSessionOptionsConfigSharedIntraOpPoolPriority is.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> intra_op_thread_pool_view_;
+
   // External threadpools.
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
   onnxruntime::concurrency::ThreadPool* external_inter_op_thread_pool_{};
@@ -781,6 +910,42 @@ class InferenceSession {
   InputOutputDefMetaMap input_def_map_;
   InputOutputDefMetaMap output_def_map_;
 
+  // Graph outputs fed back to graph inputs by the next Run, see kOrtSessionOptionsStateTensors.
+  struct StateTensor {
+    std::string output_name;
+    std::string input_name;
+    // device of the nodes consuming the input, where the output is kept between runs.
+    OrtDevice device;
+  };
+  InlinedVector<StateTensor> state_tensors_;
+  // The states produced by the last Run, in the order of state_tensors_. Empty until the first Run or after a reset.
+  std::vector<OrtValue> state_values_;     // GUARDED_BY(state_tensors_mutex_)
+  onnxruntime::OrtMutex state_tensors_mutex_;
+
+  // The graphs captured per input shapes, see kOrtSessionOptionsGraphCaptureMaxShapes.
+  struct GraphCaptureShapes {
+    // feed names, types and shapes, and output names of the runs replaying the graph.
+    std::string key;
+    int graph_annotation_id;
+    // inputs read by the graph, in the order of the feeds.
+    std::vector<OrtValue> staged_feeds;
+    // outputs written by the graph, empty until it is captured.
+    std::vector<OrtValue> fetches;
+  };
+  size_t graph_capture_max_shapes_{0};
+  int next_graph_annotation_id_{1};  // GUARDED_BY(graph_capture_shapes_mutex_)
+  // The most recently used shapes first.
+  std::list<GraphCaptureShapes> graph_capture_shapes_;  // GUARDED_BY(graph_capture_shapes_mutex_)
+  onnxruntime::OrtMutex graph_capture_shapes_mutex_;
+
+  // LoRA adapter sets registered with AddLoraAdapter, by name.
+  struct LoraAdapter {
+    InlinedVector<std::string> input_names;
+    InlinedVector<OrtValue> values;
+  };
+  std::unordered_map<std::string, LoraAdapter> lora_adapters_;  // GUARDED_BY(lora_adapters_mutex_)
+  onnxruntime::OrtMutex lora_adapters_mutex_;
+
   // Data transfer manager.
   DataTransferManager data_transfer_mgr_;
 
@@ -848,6 +1013,11 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // The memory mapped ORT format model file if the session is started with a model_uri and
+  // "session.use_mmap_for_ort_model" is not set to "0". It is kept until the InferenceSession goes away if
+  // initializers use it in place, otherwise it is unmapped after Initialize.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
   // Container to store pre-packed weights to share between sessions.
@@ -887,6 +1057,13 @@ class InferenceSession {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached EP instance for graph replay is not set yet before calling ReplayGraph()");
     }
 
+    Status ReleaseGraph(int graph_annotation_id) {
+      if (cached_execution_provider_for_graph_replay_) {
+        return cached_execution_provider_for_graph_replay_->ReleaseGraph(graph_annotation_id);
+      }
+      return Status::OK();
+    }
+
     const std::string& Type() const {
       return cached_execution_provider_for_graph_replay_->Type();
     }
@@ -5,6 +5,8 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <fstream>
+
 namespace onnxruntime {
 
 //---------------------
@@ -110,6 +112,11 @@ void from_json(const json& j, TuningResults& trs) {
   j.at("validators").get_to(trs.validators);
 }
 
+// This function is called by nlohmann/json
+void to_json(json& j, const TuningResults& trs) {
+  j = json{{"ep", trs.ep}, {"results", trs.results}, {"validators", trs.validators}};
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -264,6 +271,42 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+Status ParseTuningResultsFromFile(const std::filesystem::path& file_path,
+                                  std::vector<TuningResults>& results,
+                                  bool& file_found) {
+  results.clear();
+  file_found = false;
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    return Status::OK();
+  }
+
+  file_found = true;
+  LOGS_DEFAULT(INFO) << "Found tuning results in " << file_path << " to be used while loading the model";
+
+  Status status;
+  ORT_TRY {
+    results = json::parse(file).get<std::vector<TuningResults>>();
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results stored in ", file_path,
+                               " cannot be parsed. Error message: ", e.what(), ". Ignoring...");
+    });
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
+Status SaveTuningResultsToFile(const std::vector<TuningResults>& results, const std::filesystem::path& file_path) {
+  std::ofstream file(file_path, std::ios::trunc);
+  ORT_RETURN_IF_NOT(file.is_open(), "Cannot open ", file_path, " to save the tuning results.");
+  file << json(results).dump();
+  ORT_RETURN_IF_NOT(file.good(), "Failed to write the tuning results to ", file_path);
+  return Status::OK();
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
@@ -9,6 +9,8 @@
 //
 // Includes to parse json session config from onnx model file
 //
+#include <filesystem>
+
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 #include "core/framework/session_options.h"
@@ -62,6 +64,15 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ std::vector<TuningResults>& results,
                                            /*out*/ bool& key_found);
 
+// Parses the tuning results saved by SaveTuningResultsToFile. file_found is false if the file cannot be opened,
+// e.g. on the first run before any results were saved.
+Status ParseTuningResultsFromFile(const std::filesystem::path& file_path,
+                                  /*out*/ std::vector<TuningResults>& results,
+                                  /*out*/ bool& file_found);
+
+// Saves the tuning results as json, in the same format as the "tuning_results" model metadata.
+Status SaveTuningResultsToFile(const std::vector<TuningResults>& results, const std::filesystem::path& file_path);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
@@ -241,6 +241,75 @@ ORT_API_STATUS_IMPL(OrtApis::CreateTensorWithDataAsOrtValue, _In_ const OrtMemor
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateTensorWithDataAndStridesAsOrtValue, _In_ const OrtMemoryInfo* info,
+                    _Inout_ void* p_data, size_t p_data_len, _In_ const int64_t* shape, size_t shape_len,
+                    _In_ const int64_t* strides, size_t strides_len, ONNXTensorElementDataType type,
+                    _Outptr_ OrtValue** out) {
+  API_IMPL_BEGIN
+  if (strides_len != shape_len) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "the number of strides must match the number of dimensions");
+  }
+
+  auto ml_type = DataTypeImpl::TensorTypeFromONNXEnum(type)->GetElementType();
+  TensorShape tensor_shape(shape, shape_len);
+  if (std::any_of(tensor_shape.GetDims().begin(), tensor_shape.GetDims().end(), [](int64_t v) { return v < 0; })) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "tried creating tensor with negative value in shape");
+  }
+
+  gsl::span<const int64_t> tensor_strides(strides, strides_len);
+  bool is_contiguous = true;
+  int64_t expected_stride = 1;
+  // index of the last element the view refers to
+  SafeInt<int64_t> max_offset = 0;
+  for (size_t i = shape_len; i > 0; --i) {
+    const int64_t dim = tensor_shape[i - 1];
+    const int64_t stride = tensor_strides[i - 1];
+    if (stride < 0) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "negative strides are not supported");
+    }
+    if (dim != 1 && stride != expected_stride) {
+      is_contiguous = false;
+    }
+    expected_stride *= dim;
+    if (dim > 0) {
+      max_offset += SafeInt<int64_t>(dim - 1) * stride;
+    }
+  }
+
+  if (is_contiguous) {
+    auto value = std::make_unique<OrtValue>();
+    ORT_API_RETURN_IF_ERROR(CreateTensorImpl(ml_type, shape, shape_len, info, p_data, p_data_len, *value));
+    *out = value.release();
+    return nullptr;
+  }
+
+#ifdef ENABLE_STRIDED_TENSORS
+  if (ml_type->AsPrimitiveDataType()->HasSubElems()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "sub-byte element types can't be strided");
+  }
+
+  const size_t required_len = tensor_shape.Size() == 0
+                                  ? 0
+                                  : SafeInt<size_t>(static_cast<int64_t>(max_offset) + 1) * ml_type->Size();
+  if (required_len > p_data_len) {
+    std::ostringstream oss;
+    oss << "not enough space: expected " << required_len << ", got " << p_data_len;
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, oss.str().c_str());
+  }
+
+  auto value = std::make_unique<OrtValue>();
+  Tensor::InitOrtValue(ml_type, tensor_shape, p_data, *info, *value, 0, tensor_strides);
+  *out = value.release();
+  return nullptr;
+#else
+  ORT_UNUSED_PARAMETER(p_data);
+  ORT_UNUSED_PARAMETER(p_data_len);
+  ORT_UNUSED_PARAMETER(info);
+  return OrtApis::CreateStatus(ORT_NOT_IMPLEMENTED, "strided tensors are not supported in this build");
+#endif
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
                     _In_ const int64_t* shape, size_t shape_len, ONNXTensorElementDataType type,
                     _Outptr_ OrtValue** out) {
@@ -911,6 +980,120 @@ ORT_API(void, OrtApis::ReleaseIoBinding, _Frees_ptr_opt_ OrtIoBinding* binding_p
   delete binding_ptr;
 }
 
+struct OrtPreparedRun {
+  // the indices and copy info of the FeedsFetchesManager are only valid for the session that prepared the run
+  const ::onnxruntime::InferenceSession* session_{nullptr};
+  std::unique_ptr<::onnxruntime::FeedsFetchesManager> feeds_fetches_manager_;
+  // reused by every run so that it does not allocate them
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+  OrtPreparedRun() = default;
+  OrtPreparedRun(const OrtPreparedRun&) = delete;
+  OrtPreparedRun& operator=(const OrtPreparedRun&) = delete;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> input_name_vec;
+  input_name_vec.reserve(input_len);
+  for (size_t i = 0; i < input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    input_name_vec.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_name_vec;
+  output_name_vec.reserve(output_names_len);
+  for (size_t i = 0; i < output_names_len; ++i) {
+    if (output_names[i] == nullptr || output_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_name_vec.emplace_back(output_names[i]);
+  }
+
+  auto prepared_run = std::make_unique<OrtPreparedRun>();
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->PrepareRun(input_name_vec, output_name_vec,
+                                                      prepared_run->feeds_fetches_manager_));
+  prepared_run->session_ = session;
+  prepared_run->feeds_.resize(input_len);
+  prepared_run->fetches_.resize(output_names_len);
+  *out = prepared_run.release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run) {
+  delete prepared_run;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run, _In_reads_(input_len) const OrtValue* const* inputs,
+                    size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& feeds = prepared_run->feeds_;
+  auto& fetches = prepared_run->fetches_;
+
+  if (prepared_run->session_ != session) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The prepared run was created for a different session");
+  }
+
+  if (input_len != feeds.size() || output_len != fetches.size()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "The number of inputs and outputs must match the names of the prepared run");
+  }
+
+  for (size_t i = 0; i < input_len; ++i) {
+    if (inputs[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "NULL input supplied to a prepared run");
+    }
+    feeds[i] = *inputs[i];
+  }
+
+  // the session resizes the fetches only if the number of outputs differs, so they keep their storage
+  fetches.resize(output_len);
+  for (size_t i = 0; i < output_len; ++i) {
+    fetches[i] = outputs[i] != nullptr ? *outputs[i] : OrtValue();
+  }
+
+  const RunOptions default_run_options;
+  Status status = session->RunPrepared(run_options ? *run_options : default_run_options,
+                                       *prepared_run->feeds_fetches_manager_, feeds, fetches);
+
+  if (status.IsOK()) {
+    // We do it in two loops to make sure copy __ctors does not throw
+    InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs(output_len);
+    for (size_t i = 0; i < output_len; ++i) {
+      if (outputs[i] == nullptr) {
+        fetch_unique_ptrs[i] = std::make_unique<OrtValue>(fetches[i]);
+      }
+    }
+
+    for (size_t i = 0; i < output_len; ++i) {
+      if (outputs[i] == nullptr) {
+        outputs[i] = fetch_unique_ptrs[i].release();
+      }
+    }
+  }
+
+  // don't keep the caller's values alive until the next run
+  for (auto& feed : feeds) {
+    feed = OrtValue();
+  }
+  for (auto& fetch : fetches) {
+    fetch = OrtValue();
+  }
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr) {
   API_IMPL_BEGIN
   auto st = binding_ptr->binding_->BindInput(name, *val_ptr);
@@ -941,6 +1124,32 @@ ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_p
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToAllocatorFn, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr, _In_ OrtOutputBufferAllocatorFn allocator_fn,
+                    _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (allocator_fn == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "allocator_fn must not be null");
+  }
+
+  auto allocator = [output_name = std::string(name), allocator_fn, user_data](
+                       const TensorShape& shape, size_t size_in_bytes, void*& buffer) -> Status {
+    const auto dims = shape.GetDims();
+    OrtStatus* status = allocator_fn(user_data, output_name.c_str(), dims.data(), dims.size(), size_in_bytes,
+                                     &buffer);
+    if (status != nullptr) {
+      auto ort_status = ToStatus(status);
+      OrtApis::ReleaseStatus(status);
+      return ort_status;
+    }
+    return Status::OK();
+  };
+
+  ORT_API_RETURN_IF_STATUS_NOT_OK(binding_ptr->binding_->BindOutput(name, *mem_info_ptr, std::move(allocator)));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputNames, _In_ const OrtIoBinding* binding_ptr, _In_ OrtAllocator* allocator,
                     _Out_ char** buffer, _Outptr_result_maybenull_ size_t** lengths, _Out_ size_t* count) {
   API_IMPL_BEGIN
@@ -1103,6 +1312,27 @@ ORT_API_STATUS_IMPL(OrtApis::FillStringTensor, _Inout_ OrtValue* value, _In_ con
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_ const void* s, size_t s_len,
+                    _In_ const size_t* offsets, size_t offsets_len) {
+  TENSOR_READWRITE_API_BEGIN
+  auto* dst = tensor->MutableData<std::string>();
+  const auto len = static_cast<size_t>(tensor->Shape().Size());
+  if (offsets_len != len) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "offsets array doesn't equal tensor size");
+  }
+  const char* p = static_cast<const char*>(s);
+  for (size_t i = 0; i != len; ++i) {
+    const size_t end = i + 1 < len ? offsets[i + 1] : s_len;
+    if (offsets[i] > end || end > s_len) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "offsets must not decrease and must be within the buffer");
+    }
+    // one copy per element, the length comes from the offsets
+    dst[i].assign(p + offsets[i], end - offsets[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::FillStringTensorElement, _Inout_ OrtValue* value, _In_ const char* s, size_t index) {
   TENSOR_READWRITE_API_BEGIN
   auto* dst = tensor->MutableData<std::string>();
@@ -1363,6 +1593,60 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetKernelStatistics, _In_ OrtSession* sess, _In_ int reset,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::string kernel_statistics;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetKernelStatistics(reset != 0, kernel_statistics));
+  *out = StrDup(kernel_statistics, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetThreadPoolStatistics, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string thread_pool_statistics;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetThreadPoolStatistics(thread_pool_statistics));
+  *out = StrDup(thread_pool_statistics, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetArenaReport, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* mem_info,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string arena_report;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetArenaReport(*mem_info, arena_report));
+  *out = StrDup(arena_report, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionWarmup, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(num_inputs) const char* const* input_names, size_t num_inputs,
+                    _In_reads_(num_shape_sets* num_inputs) const int64_t* const* shapes,
+                    _In_reads_(num_shape_sets* num_inputs) const size_t* shape_lens, size_t num_shape_sets) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> input_name_vec(input_names, input_names + num_inputs);
+  std::vector<TensorShapeVector> shape_vec;
+  shape_vec.reserve(num_shape_sets * num_inputs);
+  for (size_t i = 0, end = num_shape_sets * num_inputs; i < end; ++i) {
+    shape_vec.emplace_back(shapes[i], shapes[i] + shape_lens[i]);
+  }
+
+  const RunOptions default_run_options;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->Warmup(run_options ? *run_options : default_run_options, input_name_vec,
+                                                  shape_vec));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2229,6 +2513,16 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_chunks") == 0) {
+      cfg->thread_cache_max_chunks = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "shrink_half_life_ms") == 0) {
+      cfg->shrink_half_life_ms = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "huge_page_size") == 0) {
+      cfg->huge_page_size = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "numa_node") == 0) {
+      cfg->numa_node = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "enable_tracing") == 0) {
+      cfg->enable_tracing = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2730,6 +3024,17 @@ static constexpr OrtApi ort_api_1_to_20 = {
     &OrtApis::KernelInfoGetAllocator,
     &OrtApis::AddExternalInitializersFromFilesInMemory,
     // End of Version 18 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::SessionGetKernelStatistics,
+    &OrtApis::BindOutputToAllocatorFn,
+    &OrtApis::CreateTensorWithDataAndStridesAsOrtValue,
+    &OrtApis::SessionGetThreadPoolStatistics,
+    &OrtApis::FillStringTensorFromBuffer,
+    &OrtApis::SessionWarmup,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::SessionGetArenaReport,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
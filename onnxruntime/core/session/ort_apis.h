@@ -351,6 +351,40 @@ ORT_API_STATUS_IMPL(AddExternalInitializersFromFilesInMemory, _In_ OrtSessionOpt
                     _In_reads_(num_external_initializer_files) const size_t* file_lengths,
                     size_t num_external_initializer_files);
 
+ORT_API_STATUS_IMPL(SessionGetKernelStatistics, _In_ OrtSession* sess, _In_ int reset,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(BindOutputToAllocatorFn, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr, _In_ OrtOutputBufferAllocatorFn allocator_fn,
+                    _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(CreateTensorWithDataAndStridesAsOrtValue, _In_ const OrtMemoryInfo* info, _Inout_ void* p_data,
+                    size_t p_data_len, _In_ const int64_t* shape, size_t shape_len, _In_ const int64_t* strides,
+                    size_t strides_len, ONNXTensorElementDataType type, _Outptr_ OrtValue** out);
+
+ORT_API_STATUS_IMPL(SessionGetThreadPoolStatistics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_reads_bytes_(s_len) const void* s,
+                    size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+
+ORT_API_STATUS_IMPL(SessionWarmup, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(num_inputs) const char* const* input_names, size_t num_inputs,
+                    _In_reads_(num_shape_sets* num_inputs) const int64_t* const* shapes,
+                    _In_reads_(num_shape_sets* num_inputs) const size_t* shape_lens, size_t num_shape_sets);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run, _In_reads_(input_len) const OrtValue* const* inputs,
+                    size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+ORT_API_STATUS_IMPL(SessionGetArenaReport, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* mem_info,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
 ORT_API_STATUS_IMPL(CreateOpAttr,
                     _In_ const char* name,
                     _In_ const void* data,
@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/ort_value_tensor_slicer.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/node_arg.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+struct RequestBatcher::Request {
+  const RunOptions* run_options;
+  gsl::span<const std::string> feed_names;
+  gsl::span<const OrtValue> feeds;
+  gsl::span<const std::string> output_names;
+  std::vector<OrtValue>* fetches;
+
+  Clock::time_point arrival;
+  // first dimension shared by all feeds, or -1 if the request can only run on its own.
+  int64_t batch_size;
+
+  Status status;
+  bool done = false;
+};
+
+namespace {
+int64_t GetRequestBatchSize(gsl::span<const OrtValue> feeds) {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return -1;
+    }
+
+    const Tensor& tensor = feed.Get<Tensor>();
+    // strings can't be concatenated with a memcpy, and inputs on other devices would need a copy to the CPU first.
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        tensor.Shape().NumDimensions() == 0 || tensor.Shape()[0] < 1 ||
+        (batch_size != -1 && tensor.Shape()[0] != batch_size)) {
+      return -1;
+    }
+
+    batch_size = tensor.Shape()[0];
+  }
+
+  return batch_size;
+}
+
+Status CheckBatchDimension(const NodeArg& arg, std::string& batch_dim_param) {
+  const auto* shape = arg.Shape();
+  ORT_RETURN_IF(shape == nullptr || shape->dim_size() == 0 || !utils::HasDimParam(shape->dim(0)),
+                "Request batching requires the first dimension of '", arg.Name(), "' to be symbolic.");
+
+  if (batch_dim_param.empty()) {
+    batch_dim_param = shape->dim(0).dim_param();
+  }
+
+  ORT_RETURN_IF(shape->dim(0).dim_param() != batch_dim_param,
+                "Request batching requires all model inputs and outputs to share the first dimension. '",
+                arg.Name(), "' has '", shape->dim(0).dim_param(), "' instead of '", batch_dim_param, "'.");
+  return Status::OK();
+}
+}  // namespace
+
+Status RequestBatcher::Create(InferenceSession& session, const Options& options,
+                              std::unique_ptr<RequestBatcher>& batcher) {
+  ORT_RETURN_IF(options.max_batch_size < 1, "max_batch_size must be at least 1.");
+
+  auto inputs = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+  auto outputs = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs.first);
+
+  std::string batch_dim_param;
+  for (const auto* input : *inputs.second) {
+    ORT_RETURN_IF_ERROR(CheckBatchDimension(*input, batch_dim_param));
+  }
+
+  for (const auto* output : *outputs.second) {
+    ORT_RETURN_IF_ERROR(CheckBatchDimension(*output, batch_dim_param));
+  }
+
+  batcher.reset(new RequestBatcher(session, options));
+  return Status::OK();
+}
+
+Status RequestBatcher::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                           gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                           std::vector<OrtValue>& fetches) {
+  ORT_RETURN_IF(feed_names.size() != feeds.size(), "The number of feed names and feeds must match.");
+
+  fetches.clear();
+  fetches.resize(output_names.size());
+
+  Request request{&run_options, feed_names, feeds, output_names, &fetches, Clock::now(),
+                  GetRequestBatchSize(feeds)};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  queue_.push_back(&request);
+  // wake the caller that is collecting a batch in case this request completes it.
+  cv_.notify_all();
+
+  while (!request.done) {
+    if (has_leader_) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    has_leader_ = true;
+    const auto deadline = queue_.front()->arrival + options_.max_delay;
+    for (auto now = Clock::now(); GetQueuedBatchSize() < options_.max_batch_size && now < deadline;
+         now = Clock::now()) {
+      cv_.wait_for(lock, deadline - now);
+    }
+
+    auto batch = TakeBatch();
+    has_leader_ = false;
+    // let one of the remaining callers collect the next batch while this one runs.
+    if (!queue_.empty()) {
+      cv_.notify_all();
+    }
+
+    lock.unlock();
+    Status status = ExecuteBatch(batch);
+    lock.lock();
+
+    for (auto* batch_request : batch) {
+      batch_request->status = status;
+      batch_request->done = true;
+    }
+    cv_.notify_all();
+  }
+
+  return request.status;
+}
+
+bool RequestBatcher::CanBatch(const Request& a, const Request& b) {
+  if (a.batch_size == -1 || b.batch_size == -1 ||
+      !std::equal(a.feed_names.begin(), a.feed_names.end(), b.feed_names.begin(), b.feed_names.end()) ||
+      !std::equal(a.output_names.begin(), a.output_names.end(), b.output_names.begin(), b.output_names.end())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.feeds.size(); ++i) {
+    const Tensor& a_tensor = a.feeds[i].Get<Tensor>();
+    const Tensor& b_tensor = b.feeds[i].Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() || a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t RequestBatcher::GetQueuedBatchSize() const {
+  const Request& first = *queue_.front();
+  if (first.batch_size == -1) {
+    return options_.max_batch_size;
+  }
+
+  size_t batch_size = 0;
+  for (const auto* request : queue_) {
+    if (CanBatch(first, *request) && batch_size + request->batch_size <= options_.max_batch_size) {
+      batch_size += request->batch_size;
+    }
+  }
+
+  // a single request can exceed the maximum and is then run on its own.
+  return std::max(batch_size, static_cast<size_t>(first.batch_size));
+}
+
+InlinedVector<RequestBatcher::Request*> RequestBatcher::TakeBatch() {
+  InlinedVector<Request*> batch{queue_.front()};
+  const Request& first = *queue_.front();
+  size_t batch_size = static_cast<size_t>(std::max<int64_t>(first.batch_size, 0));
+
+  auto remaining = queue_.begin() + 1;
+  for (auto it = queue_.begin() + 1, end = queue_.end(); it != end; ++it) {
+    if (CanBatch(first, **it) && batch_size + (*it)->batch_size <= options_.max_batch_size) {
+      batch_size += (*it)->batch_size;
+      batch.push_back(*it);
+    } else {
+      *remaining++ = *it;
+    }
+  }
+
+  queue_.erase(remaining, queue_.end());
+  queue_.erase(queue_.begin());
+  return batch;
+}
+
+Status RequestBatcher::ExecuteBatch(gsl::span<Request* const> batch) const {
+  const Request& first = *batch[0];
+  if (batch.size() == 1) {
+    return session_.Run(*first.run_options, first.feed_names, first.feeds, first.output_names, first.fetches);
+  }
+
+  int64_t total_batch_size = 0;
+  for (const auto* request : batch) {
+    total_batch_size += request->batch_size;
+  }
+
+  // concatenate the inputs along the first dimension. requests in a batch have identical trailing dimensions so
+  // the rows of each request are a contiguous block of the batched input.
+  auto allocator = session_.GetAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator));
+  ORT_RETURN_IF(allocator == nullptr, "No CPU allocator is registered for the session.");
+
+  std::vector<OrtValue> feeds;
+  feeds.reserve(first.feeds.size());
+  for (size_t i = 0; i < first.feeds.size(); ++i) {
+    const Tensor& first_tensor = first.feeds[i].Get<Tensor>();
+    TensorShape shape = first_tensor.Shape();
+    shape[0] = total_batch_size;
+
+    OrtValue batched;
+    Tensor::InitOrtValue(first_tensor.DataType(), shape, allocator, batched);
+    auto* dst = static_cast<char*>(batched.GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto* request : batch) {
+      const Tensor& tensor = request->feeds[i].Get<Tensor>();
+      memcpy(dst, tensor.DataRaw(), tensor.SizeInBytes());
+      dst += tensor.SizeInBytes();
+    }
+
+    feeds.push_back(std::move(batched));
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(session_.Run(*first.run_options, first.feed_names, feeds, first.output_names, &fetches));
+
+  // each request gets a view of its rows. the views share ownership of the batched output.
+  const auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const OrtValue& batched = fetches[i];
+    ORT_RETURN_IF_NOT(batched.IsTensor(), "Output '", first.output_names[i], "' is not a tensor and can't be split.");
+
+    const Tensor& batched_tensor = batched.Get<Tensor>();
+    const auto& batched_shape = batched_tensor.Shape();
+    ORT_RETURN_IF(batched_shape.NumDimensions() == 0 || batched_shape[0] != total_batch_size,
+                  "The first dimension of output '", first.output_names[i], "' with shape ", batched_shape,
+                  " doesn't match the batch size ", total_batch_size, ".");
+
+    auto rows = OrtValueTensorSlicer<const OrtValue>::Create(batched).begin();
+    for (auto* request : batch) {
+      TensorShape shape = batched_shape;
+      shape[0] = request->batch_size;
+      const Tensor& first_row = (*rows).Get<Tensor>();
+      auto tensor = std::make_unique<Tensor>(batched_tensor.DataType(), shape, const_cast<void*>(first_row.DataRaw()),
+                                             batched_tensor.Location());
+      (*request->fetches)[i].Init(tensor.release(), ml_tensor, [batched](void* p) {
+        delete static_cast<Tensor*>(p);
+      });
+      rows += request->batch_size;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
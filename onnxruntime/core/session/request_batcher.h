@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class InferenceSession;
+struct RunOptions;
+
+/**
+ * Combines concurrent Run requests into a single run of the session.
+ *
+ * The inputs of requests with the same input and output names, element types and shapes other than
+ * the first dimension are concatenated along dimension 0, the session is run once and each request
+ * gets a view of its rows of the outputs. No data is copied for the outputs.
+ *
+ * There is no background thread. The first blocked caller waits until either max_batch_size rows are
+ * queued or the oldest request has waited max_delay, then runs the batch for everyone on its thread.
+ * Requires every model input and output to have the same symbolic first dimension.
+ */
+class RequestBatcher {
+ public:
+  struct Options {
+    // maximum number of rows, i.e. the sum of the first dimension of the inputs of the requests, in a batch.
+    size_t max_batch_size = 8;
+    // maximum time the oldest request waits for other requests before the batch is run.
+    std::chrono::microseconds max_delay{1000};
+  };
+
+  static Status Create(InferenceSession& session, const Options& options, std::unique_ptr<RequestBatcher>& batcher);
+
+  /**
+   * Run the request as part of a batch. Blocks until the outputs are available.
+   * Requests in a batch are executed with the run options of the first request of the batch.
+   * @param fetches receives the outputs in the order of output_names. Must be empty OrtValues.
+   */
+  Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+             std::vector<OrtValue>& fetches);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  struct Request;
+
+  RequestBatcher(InferenceSession& session, const Options& options) : session_(session), options_(options) {}
+
+  static bool CanBatch(const Request& a, const Request& b);
+
+  // takes the oldest request and the compatible requests that follow it from the queue. must hold mutex_.
+  InlinedVector<Request*> TakeBatch();
+  // number of rows that TakeBatch would return. must hold mutex_.
+  size_t GetQueuedBatchSize() const;
+
+  Status ExecuteBatch(gsl::span<Request* const> batch) const;
+
+  InferenceSession& session_;
+  const Options options_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::vector<Request*> queue_;
+  // true while a caller is waiting for the batch at the front of the queue to fill up.
+  bool has_leader_ = false;
+};
+
+}  // namespace onnxruntime
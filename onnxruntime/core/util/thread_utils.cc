@@ -19,9 +19,14 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " thread_pool_size: " << params.thread_pool_size;
   os << " auto_set_affinity: " << params.auto_set_affinity;
   os << " allow_spinning: " << params.allow_spinning;
+  os << " adaptive_spinning: " << params.adaptive_spinning;
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " performance_cores_only: " << params.performance_cores_only;
+  os << " numa_local_stealing: " << params.numa_local_stealing;
+  os << " calibrate_loop_costs: " << params.calibrate_loop_costs;
+  os << " lease_workers_to_callers: " << params.lease_workers_to_callers;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -92,6 +97,35 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
+  if (options.performance_cores_only) {
+    ORT_ENFORCE(options.affinity_str.empty(), "Thread affinities cannot be set when using the performance cores only");
+    auto default_affinities = Env::Default().GetDefaultThreadAffinities();
+    const auto throughput_weights = Env::Default().GetCoreThroughputWeights();
+    const auto numa_nodes = Env::Default().GetCoreNumaNodes();
+    const bool has_numa_nodes = numa_nodes.size() == default_affinities.size();
+    // the weights are empty if all the cores are the same
+    if (throughput_weights.size() == default_affinities.size()) {
+      std::vector<LogicalProcessors> performance_cores;
+      for (size_t i = 0; i < default_affinities.size(); ++i) {
+        if (throughput_weights[i] >= 1.0f) {
+          performance_cores.push_back(std::move(default_affinities[i]));
+          if (has_numa_nodes) {
+            to.numa_nodes.push_back(numa_nodes[i]);
+          }
+        }
+      }
+      if (options.thread_pool_size <= 0 || static_cast<size_t>(options.thread_pool_size) > performance_cores.size()) {
+        options.thread_pool_size = static_cast<int>(performance_cores.size());
+      }
+      performance_cores.resize(static_cast<size_t>(options.thread_pool_size));
+      if (has_numa_nodes) {
+        to.numa_nodes.resize(performance_cores.size());
+      }
+      // the first thread is the caller, which is not bound to a core
+      to.affinities = std::move(performance_cores);
+    }
+  }
+
   if (options.thread_pool_size <= 0) {  // default
     if (options.auto_set_affinity) {
 #ifdef _WIN32
@@ -105,6 +139,8 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
         }
         options.thread_pool_size = static_cast<int>(default_affinities.size());
         to.affinities = std::move(default_affinities);
+        to.throughput_weights = Env::Default().GetCoreThroughputWeights();
+        to.numa_nodes = Env::Default().GetCoreNumaNodes();
       } else {
         options.thread_pool_size = Env::Default().GetNumPhysicalCpuCores();
       }
@@ -115,6 +151,8 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
       }
       options.thread_pool_size = static_cast<int>(default_affinities.size());
       to.affinities = std::move(default_affinities);
+      to.throughput_weights = Env::Default().GetCoreThroughputWeights();
+      to.numa_nodes = Env::Default().GetCoreNumaNodes();
 #endif
     } else {
       options.thread_pool_size = Env::Default().GetNumPhysicalCpuCores();
@@ -151,6 +189,10 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   to.custom_thread_creation_options = options.custom_thread_creation_options;
   to.custom_join_thread_fn = options.custom_join_thread_fn;
   to.dynamic_block_base_ = options.dynamic_block_base_;
+  to.adaptive_spinning = options.adaptive_spinning;
+  to.numa_local_stealing = options.numa_local_stealing;
+  to.calibrate_loop_costs = options.calibrate_loop_costs;
+  to.lease_workers_to_callers = options.lease_workers_to_callers;
   if (to.custom_create_thread_fn) {
     ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set");
   }
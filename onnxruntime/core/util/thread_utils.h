@@ -21,6 +21,10 @@ struct OrtThreadPoolParams {
   // If it is true, the thread pool will spin a while after the queue became empty.
   bool allow_spinning = true;
 
+  // If it is true and spinning is allowed, each thread spins for a time based on the idle time it observed between
+  // its previous tasks, and blocks right away when they are far apart.
+  bool adaptive_spinning = false;
+
   // It it is non-negative, thread pool will split a task by a decreasing block size
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
@@ -37,6 +41,23 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is true and the CPU is hybrid, bind the threads to the performance cores (P-cores) only.
+  // With thread_pool_size = 0 the pool gets one thread per P-core, a larger thread_pool_size is capped to it.
+  // Cannot be combined with affinity_str.
+  bool performance_cores_only = false;
+
+  // If it is true and the threads are bound to the cores of several NUMA nodes, only steal work from the queues of
+  // threads on the same node.
+  bool numa_local_stealing = true;
+
+  // If it is true, the cost of the iterations of each parallel loop is measured at runtime and used to partition
+  // its later calls instead of the cost estimated by the kernel.
+  bool calibrate_loop_costs = false;
+
+  // If it is true, the threads of the pool are divided among the threads that concurrently run parallel loops on it,
+  // e.g. the inter-op threads of a session, instead of each loop enlisting all of them.
+  bool lease_workers_to_callers = false;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
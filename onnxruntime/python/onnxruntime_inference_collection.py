@@ -228,6 +228,29 @@ class Session:
                 return self._sess.run(output_names, input_feed, run_options)
             raise
 
+    def run_batch(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions of several independent requests concurrently.
+
+        The inputs of all the requests are converted and the requests are run in a single native call,
+        which releases the GIL once for the whole batch. The requests run on the threads configured with the
+        session config entry "session.async_run_num_threads", or on the intra op thread pool.
+
+        :param output_names: name of the outputs, the same for every request
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``, one per request
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: a list with the list of results of each request
+
+        ::
+
+            sess.run_batch([output_name], [{input_name: x0}, {input_name: x1}])
+        """
+        for input_feed in input_feeds:
+            self._validate_input(list(input_feed.keys()))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_batch(output_names, input_feeds, run_options)
+
     def run_async(self, output_names, input_feed, callback, user_data, run_options=None):
         """
         Compute the predictions asynchronously in a separate cxx thread from ort intra-op threadpool.
@@ -299,6 +322,29 @@ class Session:
                 return invoke(self._sess, output_names, input_dict_ort_values, run_options)
             raise
 
+    def run_with_ortvaluevector(self, output_names, input_names, input_ort_values, run_options=None):
+        """
+        Compute the predictions without converting the inputs and outputs from and to python objects.
+
+        This is the fastest way to run a session with `OrtValue`, e.g. in a serving loop.
+
+        :param output_names: name of the outputs
+        :param input_names: name of the inputs, in the order of *input_ort_values*
+        :param input_ort_values: a `C.OrtValueVector` holding the inputs
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: a `C.OrtValueVector` holding the outputs in the order of *output_names*
+
+        ::
+
+            feeds = C.OrtValueVector()
+            feeds.push_back(OrtValue.ortvalue_from_numpy(x)._get_c_value())
+            outputs = sess.run_with_ortvaluevector([output_name], [input_name], feeds)
+        """
+        self._validate_input(input_names)
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_with_ortvaluevector(input_names, input_ort_values, output_names, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -711,6 +757,20 @@ class OrtValue:
             numpy_obj if device_type.lower() == "cpu" else None,
         )
 
+    @staticmethod
+    def from_dlpack(data, is_bool_tensor=False):
+        """
+        Factory method to construct an OrtValue sharing the memory of a tensor of another framework,
+        e.g. PyTorch or CuPy, on the CPU or on a CUDA device without a copy.
+
+        :param data: an object implementing the ``__dlpack__`` protocol or a DLPack capsule
+        :param is_bool_tensor: DLPack does not distinguish boolean from uint8 tensors,
+            set it to True to create a boolean tensor
+        """
+        if hasattr(data, "__dlpack__"):
+            data = data.__dlpack__()
+        return OrtValue(C.OrtValue.from_dlpack(data, is_bool_tensor))
+
     @staticmethod
     def ortvalue_from_shape_and_type(shape=None, element_type=None, device_type="cpu", device_id=0):
         """
@@ -814,6 +874,41 @@ class OrtValue:
         """
         return self._ortvalue.numpy()
 
+    def __array__(self, dtype=None, copy=None):
+        """
+        Returns a Numpy object viewing the memory of a Tensor on the CPU without a copy,
+        or a copy of it for a Tensor on another device.
+        """
+        import numpy as np
+
+        if self._numpy_obj is not None:
+            array = self._numpy_obj
+        elif self.device_name() == "cpu":
+            array = np.asarray(self._ortvalue)
+        else:
+            array = self._ortvalue.numpy()
+        if dtype is not None and array.dtype != dtype:
+            return array.astype(dtype)
+        return array.copy() if copy else array
+
+    def to_dlpack(self):
+        """
+        Returns a DLPack capsule sharing the memory of the Tensor, to be consumed by another framework
+        """
+        return self._ortvalue.to_dlpack()
+
+    def __dlpack__(self, stream=None):
+        """
+        Returns a DLPack capsule sharing the memory of the Tensor (part of the ``__dlpack__`` protocol)
+        """
+        return self._ortvalue.__dlpack__(stream)
+
+    def __dlpack_device__(self):
+        """
+        Returns the DLPack device type and index of the Tensor (part of the ``__dlpack__`` protocol)
+        """
+        return self._ortvalue.__dlpack_device__()
+
     def update_inplace(self, np_arr):
         """
         Update the OrtValue in place with a new Numpy array. The numpy contents
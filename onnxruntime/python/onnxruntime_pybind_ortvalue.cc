@@ -13,7 +13,7 @@
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 #include "core/framework/TensorSeq.h"
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
 #include "core/dlpack/dlpack_converter.h"
 #endif
 namespace onnxruntime {
@@ -21,8 +21,45 @@ namespace python {
 
 namespace py = pybind11;
 
+namespace {
+
+// Format of the tensor elements in the buffer protocol, as defined by the struct module.
+std::string GetBufferFormat(const Tensor& tensor) {
+  switch (tensor.GetElementType()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      return py::format_descriptor<float>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      return py::format_descriptor<double>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      return "e";
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+      return py::format_descriptor<bool>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+      return py::format_descriptor<int8_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return py::format_descriptor<uint8_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+      return py::format_descriptor<int16_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+      return py::format_descriptor<uint16_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+      return py::format_descriptor<int32_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+      return py::format_descriptor<uint32_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      return py::format_descriptor<int64_t>::format();
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+      return py::format_descriptor<uint64_t>::format();
+    default:
+      throw std::runtime_error("The buffer protocol is not supported for tensors of type " +
+                               std::string(DataTypeImpl::ToString(tensor.DataType())));
+  }
+}
+
+}  // namespace
+
 void addOrtValueMethods(pybind11::module& m) {
-  py::class_<OrtValue> ortvalue_binding(m, "OrtValue");
+  py::class_<OrtValue> ortvalue_binding(m, "OrtValue", py::buffer_protocol());
   ortvalue_binding
       // Factory method to create an OrtValue (Tensor) from the given Numpy object
       // The Tensor allocates and manages its own memory (on the specified device) and copies data from the Numpy data buffer
@@ -300,7 +337,37 @@ void addOrtValueMethods(pybind11::module& m) {
         py::object obj = GetPyObjFromTensor(*ml_value, nullptr, nullptr);
 #endif
         return obj; })
-#ifdef ENABLE_TRAINING
+      // Exposes the memory of a tensor on the CPU without a copy, e.g. to numpy.asarray() or memoryview().
+      .def_buffer([](OrtValue& ort_value) -> py::buffer_info {
+        if (!ort_value.IsTensor()) {
+          throw std::runtime_error("Only OrtValues that are Tensors support the buffer protocol");
+        }
+
+        Tensor& tensor = *ort_value.GetMutable<Tensor>();
+        if (tensor.Location().device.Type() != OrtDevice::CPU) {
+          throw std::runtime_error("The buffer protocol is only supported for tensors on the CPU");
+        }
+
+        const auto item_size = static_cast<py::ssize_t>(tensor.DataType()->Size());
+        const auto dims = tensor.Shape().GetDims();
+        std::vector<py::ssize_t> shape(dims.begin(), dims.end());
+        std::vector<py::ssize_t> strides(shape.size());
+#ifdef ENABLE_STRIDED_TENSORS
+        const auto tensor_strides = tensor.Strides();
+        for (size_t i = 0; i < strides.size(); ++i) {
+          strides[i] = static_cast<py::ssize_t>(tensor_strides[i]) * item_size;
+        }
+#else
+        py::ssize_t stride = item_size;
+        for (size_t i = strides.size(); i-- > 0;) {
+          strides[i] = stride;
+          stride *= shape[i];
+        }
+#endif
+        return py::buffer_info(tensor.MutableDataRaw(), item_size, GetBufferFormat(tensor),
+                               static_cast<py::ssize_t>(shape.size()), std::move(shape), std::move(strides));
+      })
+#ifdef ENABLE_DLPACK
       .def("to_dlpack", [](OrtValue* ort_value) -> py::object { return py::reinterpret_steal<py::object>(ToDlpack(*ort_value)); },
            "Returns a DLPack representing the tensor. This method does not copy the pointer shape, "
            "instead, it copies the pointer value. The OrtValue must be persist until the dlpack structure "
@@ -323,8 +390,10 @@ void addOrtValueMethods(pybind11::module& m) {
       .def("push_back", [](std::vector<OrtValue>* v, const OrtValue& ortvalue) {
         v->push_back(ortvalue);
       })
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
       .def("push_back", [](std::vector<OrtValue>* v, py::object dlpack_tensor, const bool is_bool_tensor) { v->push_back(FromDlpack(dlpack_tensor.ptr(), is_bool_tensor)); }, "Add a new OrtValue after being ownership was transferred from the DLPack structure.", py::arg("dlpack_tensor"), py::arg("is_bool_tensor") = false)
+#endif
+#ifdef ENABLE_TRAINING
       .def("push_back_batch", [](std::vector<OrtValue>* v, std::vector<py::object>& torch_tensors, std::vector<int64_t>& data_ptrs, std::vector<py::object>& element_types, const std::vector<std::vector<int64_t>>& shapes, const std::vector<OrtDevice>& devices) {
             for (size_t i = 0; i < torch_tensors.size(); ++i) {
               py::object& element_type = element_types.at(i);
@@ -365,7 +434,7 @@ void addOrtValueMethods(pybind11::module& m) {
            "In case of a boolean tensor, method to_dlpacks returns a uint8 tensor instead of a boolean tensor. "
            "If torch consumes the dlpack structure, `.to(torch.bool)` must be applied to the torch tensor "
            "to get a boolean tensor.")
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
       .def("dlpack_at", [](std::vector<OrtValue>* v, const size_t idx) { return py::reinterpret_steal<py::object>(ToDlpack(v->at(idx))); })
 #endif
       .def("element_type_at", [](std::vector<OrtValue>* v, const size_t idx) -> int32_t { return GetTensorProtoType(v->at(idx)); },
@@ -374,7 +443,7 @@ void addOrtValueMethods(pybind11::module& m) {
            "(such as onnx.TensorProto.FLOAT)."
            "Raises an exception in any other case.",
            py::arg("idx"))
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
       .def("to_dlpacks", [](const std::vector<OrtValue>& v, py::object to_tensor) -> py::list {
             if (v.size() == 0)
               return py::list();
@@ -444,7 +513,7 @@ for every transferred tensor.
 #endif
       ;
 
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
   m.def(
       "is_dlpack_uint8_tensor", [](py::capsule cap) -> bool {
         // case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
@@ -809,6 +809,20 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
             } else {
               ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_engine_hw_compatible' should be 'True' or 'False'. Default value is 'False'.\n");
             }
+          } else if (option.first == "trt_engine_refit_enable") {
+            if (option.second == "True" || option.second == "true") {
+              params.trt_engine_refit_enable = true;
+            } else if (option.second == "False" || option.second == "false") {
+              params.trt_engine_refit_enable = false;
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_engine_refit_enable' should be 'True' or 'False'. Default value is 'False'.\n");
+            }
+          } else if (option.first == "trt_profile_auto_update_runs") {
+            if (!option.second.empty()) {
+              params.trt_profile_auto_update_runs = std::stoi(option.second);
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_profile_auto_update_runs' should be a positive integer number i.e. '1000'.\n");
+            }
           } else {
             ORT_THROW("Invalid TensorRT EP option: ", option.first);
           }
@@ -1569,6 +1583,16 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_max_chunks") {
+            ort_arena_cfg->thread_cache_max_chunks = kvp.second.cast<int>();
+          } else if (key == "shrink_half_life_ms") {
+            ort_arena_cfg->shrink_half_life_ms = kvp.second.cast<int64_t>();
+          } else if (key == "huge_page_size") {
+            ort_arena_cfg->huge_page_size = kvp.second.cast<int64_t>();
+          } else if (key == "numa_node") {
+            ort_arena_cfg->numa_node = kvp.second.cast<int>();
+          } else if (key == "enable_tracing") {
+            ort_arena_cfg->enable_tracing = kvp.second.cast<int>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1580,7 +1604,12 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_max_chunks", &OrtArenaCfg::thread_cache_max_chunks)
+      .def_readwrite("shrink_half_life_ms", &OrtArenaCfg::shrink_half_life_ms)
+      .def_readwrite("huge_page_size", &OrtArenaCfg::huge_page_size)
+      .def_readwrite("numa_node", &OrtArenaCfg::numa_node)
+      .def_readwrite("enable_tracing", &OrtArenaCfg::enable_tracing);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -2043,6 +2072,60 @@ including arg name, arg type (contains both type and shape).)pbdoc")
              }
              return result;
            })
+      .def("run_batch",
+           [](PyInferenceSession* sess, const std::vector<std::string>& output_names,
+              const std::vector<std::map<std::string, const py::object>>& pyfeeds_list,
+              RunOptions* run_options = nullptr) -> py::list {
+             auto px = sess->GetSessionHandle()->GetModelInputs();
+             if (!px.first.IsOK() || !px.second) {
+               throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+             }
+
+             // all the feeds are converted before the GIL is released once for the whole batch.
+             std::vector<NameMLValMap> feeds_list(pyfeeds_list.size());
+             for (size_t i = 0; i < pyfeeds_list.size(); ++i) {
+               feeds_list[i].reserve(pyfeeds_list[i].size());
+               for (const auto& feed : pyfeeds_list[i]) {
+                 if (!feed.second.is(py::none())) {
+                   OrtValue ml_value;
+                   CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
+                   ThrowIfPyErrOccured();
+                   feeds_list[i].emplace(feed.first, std::move(ml_value));
+                 }
+               }
+             }
+
+             std::vector<std::vector<OrtValue>> fetches_list;
+             {
+               // release GIL to allow the requests, and other python threads, to run in parallel.
+               py::gil_scoped_release release;
+               const RunOptions default_run_options;
+               OrtPybindThrowIfError(sess->GetSessionHandle()->RunBatch(
+                   run_options != nullptr ? *run_options : default_run_options, feeds_list, output_names, fetches_list));
+             }
+
+             py::list results;
+             for (const auto& fetches : fetches_list) {
+               py::list result;
+               size_t pos = 0;
+               for (const auto& fet : fetches) {
+                 if (fet.IsAllocated()) {
+                   if (fet.IsTensor()) {
+                     result.append(AddTensorAsPyObj(fet, nullptr, nullptr));
+                   } else if (fet.IsSparseTensor()) {
+                     result.append(GetPyObjectFromSparseTensor(pos, fet, nullptr));
+                   } else {
+                     result.append(AddNonTensorAsPyObj(fet, nullptr, nullptr));
+                   }
+                 } else {  // Send back None because the corresponding OrtValue was empty
+                   result.append(py::none());
+                 }
+                 ++pos;
+               }
+               results.append(std::move(result));
+             }
+             return results;
+           })
       .def("run_async",
            [](PyInferenceSession* sess,
               const std::vector<std::string>& output_names,
@@ -2122,6 +2205,19 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         py::gil_scoped_release release;
         OrtPybindThrowIfError(sess->GetSessionHandle()->Run(run_options, feed_names, feeds, fetch_names, &fetches, &fetch_devices));
       })
+      .def("run_with_ortvaluevector", [](PyInferenceSession* sess, const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds, const std::vector<std::string>& fetch_names, RunOptions* run_options = nullptr) -> std::vector<OrtValue> {
+        // feeds and the result are OrtValueVector, so the values are not converted from or to python objects.
+        std::vector<OrtValue> fetches;
+        fetches.reserve(fetch_names.size());
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          const RunOptions default_run_options;
+          OrtPybindThrowIfError(sess->GetSessionHandle()->Run(run_options != nullptr ? *run_options : default_run_options,
+                                                              feed_names, feeds, fetch_names, &fetches));
+        }
+        return fetches;
+      })
       .def("end_profiling", [](const PyInferenceSession* sess) -> std::string {
         return sess->GetSessionHandle()->EndProfiling();
       })
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static const std::vector<float> kEmbeddingBagTable = {0.f, 1.f, 2.f,
+                                                      10.f, 11.f, 12.f,
+                                                      20.f, 21.f, 22.f,
+                                                      30.f, 31.f, 32.f};
+
+TEST(ContribOpTest, EmbeddingBag_Sum) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagTable);
+  test.AddInput<int64_t>("indices", {5}, {0, 2, 3, 3, 1});
+  test.AddInput<int64_t>("offsets", {3}, {0, 2, 2});
+  // the second bag is empty
+  test.AddOutput<float>("Y", {3, 3}, {20.f, 22.f, 24.f,
+                                      0.f, 0.f, 0.f,
+                                      70.f, 73.f, 76.f});
+  test.Run();
+}
+
+TEST(ContribOpTest, EmbeddingBag_Mean_Int32) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagTable);
+  test.AddInput<int32_t>("indices", {5}, {0, 2, 3, 3, 1});
+  test.AddInput<int32_t>("offsets", {3}, {0, 2, 2});
+  test.AddOutput<float>("Y", {3, 3}, {10.f, 11.f, 12.f,
+                                      0.f, 0.f, 0.f,
+                                      70.f / 3, 73.f / 3, 76.f / 3});
+  test.Run();
+}
+
+TEST(ContribOpTest, EmbeddingBag_PerSampleWeights) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagTable);
+  test.AddInput<int64_t>("indices", {4}, {1, 1, 2, 0});
+  test.AddInput<int64_t>("offsets", {2}, {0, 3});
+  test.AddInput<float>("per_sample_weights", {4}, {0.5f, 1.5f, -1.f, 2.f});
+  test.AddOutput<float>("Y", {2, 3}, {0.f, 1.f, 2.f,
+                                      0.f, 2.f, 4.f});
+  test.Run();
+}
+
+// Compares with the rows summed one by one for bags spread over several threads.
+TEST(ContribOpTest, EmbeddingBag_ManyBags) {
+  constexpr int64_t num_rows = 5000;
+  constexpr int64_t row_size = 24;
+  constexpr int64_t num_bags = 400;
+  std::vector<float> table(num_rows * row_size);
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = static_cast<float>(i % 97) - 48.f;
+  }
+
+  std::vector<int64_t> indices;
+  std::vector<int64_t> offsets;
+  std::vector<float> expected(num_bags * row_size, 0.f);
+  for (int64_t b = 0; b < num_bags; ++b) {
+    offsets.push_back(static_cast<int64_t>(indices.size()));
+    for (int64_t i = 0; i < b % 7; ++i) {
+      int64_t row = (b * 131 + i * 17) % num_rows;
+      indices.push_back(row);
+      for (int64_t j = 0; j < row_size; ++j) {
+        expected[b * row_size + j] += table[row * row_size + j];
+      }
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {num_rows, row_size}, table);
+  test.AddInput<int64_t>("indices", {static_cast<int64_t>(indices.size())}, indices);
+  test.AddInput<int64_t>("offsets", {num_bags}, offsets);
+  test.AddOutput<float>("Y", {num_bags, row_size}, expected);
+  test.Run();
+}
+
+TEST(ContribOpTest, EmbeddingBag_InvalidOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagTable);
+  test.AddInput<int64_t>("indices", {3}, {0, 1, 2});
+  test.AddInput<int64_t>("offsets", {2}, {0, 4});
+  test.AddOutput<float>("Y", {2, 3}, std::vector<float>(6, 0.f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "offsets must start at 0");
+}
+
+TEST(ContribOpTest, EmbeddingBag_InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 3}, kEmbeddingBagTable);
+  test.AddInput<int64_t>("indices", {3}, {0, 4, 2});
+  test.AddInput<int64_t>("offsets", {1}, {0});
+  test.AddOutput<float>("Y", {1, 3}, std::vector<float>(3, 0.f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
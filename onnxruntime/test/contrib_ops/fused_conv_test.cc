@@ -236,6 +236,104 @@ TEST(FusedConvTest, Cpu_Conv2D_Bias_Z_Relu) {
   RunConvOp(attrs, {X, W, B, Z}, {X_shape, W_shape, B_shape, Z_shape}, expected_vals, Y_shape, false, true, true);
 }
 
+void RunNhwcFusedConvOp(const ConvOpAndTestAttributes& attributes,
+                        const vector<vector<float>>& inputs,
+                        const vector<vector<int64_t>>& input_shapes,
+                        const std::initializer_list<float>& expected_output,
+                        const vector<int64_t>& expected_output_shape) {
+  for (bool weight_is_initializer : {false, true}) {
+    OpTester test("NhwcFusedConv", 1, onnxruntime::kMSDomain);
+    test.AddAttribute("group", attributes.group);
+    test.AddAttribute("kernel_shape", attributes.kernel_shape);
+    test.AddAttribute("dilations", attributes.dilations);
+    test.AddAttribute("pads", attributes.pads);
+    test.AddAttribute("strides", attributes.strides);
+    test.AddAttribute("activation", attributes.activation);
+
+    const char* szNames[] = {"X", "W", "B", "Z"};
+    test.AddInput<float>(szNames[0], input_shapes[0], inputs[0]);
+    test.AddInput<float>(szNames[1], input_shapes[1], inputs[1], weight_is_initializer);
+    for (size_t i = 2; i < inputs.size(); i++) {
+      test.AddInput<float>(szNames[i], input_shapes[i], inputs[i]);
+    }
+    test.AddOutput<float>("Y", expected_output_shape, expected_output);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+TEST(FusedConvTest, Cpu_NhwcConv2D_Bias_Z_Relu) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      "Relu"                        // activation
+  };
+
+  // Cpu_Conv2D_Bias_Z_Relu in the channels last layout.
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+  vector<int64_t> X_shape = {1, 3, 3, 1};
+  vector<float> W = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+  vector<int64_t> W_shape = {2, 1, 2, 2};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  vector<float> B = {1.0f, -1.0f};
+  vector<int64_t> B_shape = {2};
+  vector<float> Z = {-1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+  vector<int64_t> Z_shape = {1, 2, 2, 2};
+  auto expected_vals = {12.0f, 11.0f, 17.0f, 15.0f, 25.0f, 23.0f, 29.0f, 28.0f};
+  RunNhwcFusedConvOp(attrs, {X, W, B, Z}, {X_shape, W_shape, B_shape, Z_shape}, expected_vals, Y_shape);
+}
+
+TEST(FusedConvTest, Cpu_NhwcPointwiseGroup_Bias_Z_Relu) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      2,                            // group
+      vector<int64_t>{1, 1},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      "Relu"                        // activation
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {2.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 1, 1, 1};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  vector<float> B = {0.5f, 1.0f};
+  vector<int64_t> B_shape = {2};
+  vector<float> Z = {10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, -10.0f};
+  vector<int64_t> Z_shape = {1, 2, 2, 2};
+  auto expected_vals = {12.5f, 9.0f, 16.5f, 7.0f, 20.5f, 5.0f, 24.5f, 0.0f};
+  RunNhwcFusedConvOp(attrs, {X, W, B, Z}, {X_shape, W_shape, B_shape, Z_shape}, expected_vals, Y_shape);
+}
+
+TEST(FusedConvTest, Cpu_NhwcConv2D_Pads_Relu) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{1, 1, 0, 0},  // pads
+      vector<int64_t>{2, 2},        // strides
+      "Relu"                        // activation
+  };
+
+  vector<float> X = {1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f, 4.0f, -4.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                     0.0f, 0.0f, 0.0f, 0.0f, -1.0f, -1.0f, -1.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<int64_t> Y_shape = {1, 1, 1, 2};
+  auto expected_vals = {1.0f, 1.0f};
+  RunNhwcFusedConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
+}
+
 #endif
 
 }  // namespace test
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedElementwise_SiLUChain) {
+  // x * Sigmoid(x * s + y)
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "Add", "Sigmoid", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1, 5, 0});
+  test.AddInput<float>("X", {2, 3}, {-1.5f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f});
+  test.AddInput<float>("s", {}, {2.0f});
+  test.AddInput<float>("Y", {2, 3}, {0.25f, -1.0f, 3.0f, -2.0f, 0.5f, -0.75f});
+  test.AddOutput<float>("output", {2, 3},
+                        {-0.09012998f, -0.05960146f, 0.0f, 0.1344707f, 0.9241418f, 1.925346f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_AllOperatorsAcrossTiles) {
+  // sqrt(abs(x)) - tanh(x) / s + relu(-x) * exp(erf(x)) on several tiles and a partial one
+  constexpr int64_t size = 1000;
+  constexpr float s = 3.0f;
+  std::vector<float> X(size);
+  std::vector<float> expected(size);
+  for (int64_t i = 0; i < size; ++i) {
+    const float x = static_cast<float>(i - size / 2) / 100.0f;
+    X[i] = x;
+    expected[i] = std::sqrt(std::fabs(x)) - std::tanh(x) / s + std::max(-x, 0.0f) * std::exp(std::erf(x));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Tanh", "Div", "Abs", "Sqrt", "Sub", "Neg", "Relu", "Erf",
+                                                    "Exp", "Mul", "Add"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, -1, 2, 1, 0, -1, 4, -1, 5, 3, 0, -1,
+                                                     7, -1, 0, -1, 9, -1, 8, 10, 6, 11});
+  test.AddInput<float>("X", {size}, X);
+  test.AddInput<float>("s", {1}, {s});
+  test.AddOutput<float>("output", {size}, expected);
+  test.SetOutputTolerance(1e-5f);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_InvalidRegister) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // the Add reads its own result
+  test.AddAttribute("ops", std::vector<std::string>{"Add"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1});
+  test.AddInput<float>("X", {2}, {1.0f, 2.0f});
+  test.AddOutput<float>("output", {2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "invalid register");
+}
+
+TEST(ContribOpTest, FusedElementwise_InvalidBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+  test.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("bias", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("output", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "can not be broadcast");
+}
+
+#if defined(USE_CUDA)
+TEST(ContribOpTest, FusedElementwise_CudaFloat16) {
+  if (!HasCudaEnvironment(530)) {
+    return;
+  }
+
+  // x * Sigmoid(x * s + y) over more elements than one block, computed in float by the kernel
+  constexpr int64_t size = 3000;
+  std::vector<float> X(size);
+  std::vector<float> Y(size);
+  std::vector<float> expected(size);
+  for (int64_t i = 0; i < size; ++i) {
+    X[i] = static_cast<float>(i % 97 - 48) / 16.0f;
+    Y[i] = static_cast<float>(i % 13 - 6) / 4.0f;
+    const float x = MLFloat16(X[i]).ToFloat();
+    const float y = MLFloat16(Y[i]).ToFloat();
+    expected[i] = x / (1.0f + std::exp(-(x * 2.0f + y)));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "Add", "Sigmoid", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1, 5, 0});
+  test.AddInput<MLFloat16>("X", {3, 1000}, ToFloat16(X));
+  test.AddInput<MLFloat16>("s", {1, 1}, ToFloat16({2.0f}));
+  test.AddInput<MLFloat16>("Y", {3, 1000}, ToFloat16(Y));
+  test.AddOutput<MLFloat16>("output", {3, 1000}, ToFloat16(expected));
+  test.SetOutputTolerance(0.005f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
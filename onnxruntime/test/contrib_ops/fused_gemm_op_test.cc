@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+#if defined(USE_CUDA)
+namespace {
+
+// Reference Y = activation(alpha * A x B + beta * C) with C broadcast from c_dims.
+std::vector<float> ReferenceFusedGemm(const std::vector<float>& a, const std::vector<float>& b,
+                                      const std::vector<float>& c, const std::vector<int64_t>& c_dims,
+                                      int64_t M, int64_t N, int64_t K, float alpha, float beta,
+                                      const std::string& activation) {
+  std::vector<float> y(static_cast<size_t>(M * N));
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+
+      float bias = 0.0f;
+      if (!c.empty()) {
+        const int64_t c_rows = c_dims.size() == 2 ? c_dims[0] : 1;
+        const int64_t c_cols = c_dims.empty() ? 1 : c_dims.back();
+        bias = c[(c_rows == 1 ? 0 : m) * c_cols + (c_cols == 1 ? 0 : n)];
+      }
+
+      float value = alpha * sum + beta * bias;
+      if (activation == "Relu") {
+        value = std::max(value, 0.0f);
+      } else if (activation == "FastGelu") {
+        value = 0.5f * value * (1.0f + std::tanh(0.7978845608f * (value + 0.044715f * value * value * value)));
+      }
+      y[m * N + n] = value;
+    }
+  }
+  return y;
+}
+
+void RunFusedGemmCudaTest(int64_t M, int64_t N, int64_t K, const std::vector<int64_t>& c_dims, float alpha,
+                          float beta, const std::string& activation, bool use_float16) {
+  if (!HasCudaEnvironment(use_float16 ? 530 : 0)) {
+    return;
+  }
+
+  const std::vector<float> a = ValueRange<float>(static_cast<size_t>(M * K), -1.0f, 0.125f);
+  const std::vector<float> b = ValueRange<float>(static_cast<size_t>(K * N), 1.0f, -0.0625f);
+  int64_t c_size = 1;
+  for (auto dim : c_dims) {
+    c_size *= dim;
+  }
+  const std::vector<float> c = ValueRange<float>(static_cast<size_t>(c_size), -0.5f, 0.25f);
+  const std::vector<float> y = ReferenceFusedGemm(a, b, c, c_dims, M, N, K, alpha, beta, activation);
+
+  OpTester tester("FusedGemm", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("transA", 0);
+  tester.AddAttribute<int64_t>("transB", 0);
+  tester.AddAttribute<float>("alpha", alpha);
+  tester.AddAttribute<float>("beta", beta);
+  tester.AddAttribute<std::string>("activation", activation);
+  if (use_float16) {
+    tester.AddInput<MLFloat16>("A", {M, K}, ToFloat16(a));
+    tester.AddInput<MLFloat16>("B", {K, N}, ToFloat16(b));
+    tester.AddInput<MLFloat16>("C", c_dims, ToFloat16(c));
+    tester.AddOutput<MLFloat16>("Y", {M, N}, ToFloat16(y));
+    tester.SetOutputTolerance(0.02f);
+  } else {
+    tester.AddInput<float>("A", {M, K}, a);
+    tester.AddInput<float>("B", {K, N}, b);
+    tester.AddInput<float>("C", c_dims, c);
+    tester.AddOutput<float>("Y", {M, N}, y);
+    tester.SetOutputTolerance(0.005f);
+  }
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(FusedGemmTest, CudaBiasEpilogueRelu) {
+  RunFusedGemmCudaTest(7, 24, 16, {24}, 1.0f, 1.0f, "Relu", false);
+  RunFusedGemmCudaTest(7, 24, 16, {1, 24}, 1.0f, 1.0f, "Relu", true);
+}
+
+TEST(FusedGemmTest, CudaBiasEpilogueFastGelu) {
+  RunFusedGemmCudaTest(5, 32, 8, {32}, 0.5f, 1.0f, "FastGelu", false);
+  RunFusedGemmCudaTest(5, 32, 8, {32}, 0.5f, 1.0f, "FastGelu", true);
+}
+
+TEST(FusedGemmTest, CudaMatrixAndBroadcastBias) {
+  // (M, N) bias read through the C descriptor.
+  RunFusedGemmCudaTest(6, 12, 4, {6, 12}, 1.0f, 0.5f, "Relu", false);
+  // (M, 1) and scaled (N) bias broadcast into the output first.
+  RunFusedGemmCudaTest(6, 12, 4, {6, 1}, 1.0f, 1.0f, "Relu", false);
+  RunFusedGemmCudaTest(6, 12, 4, {12}, 1.0f, 2.0f, "FastGelu", false);
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -123,7 +123,6 @@ void Test_Fail_WithZeroPoints(int64_t gather_axis,
 
 TEST(GatherBlockQuantizedOpTest, UnsupportedTypes) {
   Test_Fail_WithZeroPoints<int8_t, float, int32_t>(0, 2, 16);
-  Test_Fail_WithZeroPoints<uint8_t, float, int32_t>(0, 2, 16);
   Test_Fail_WithZeroPoints<int16_t, float, int32_t>(0, 2, 16);
   Test_Fail_WithZeroPoints<uint16_t, float, int32_t>(0, 2, 16);
   Test_Fail_WithZeroPoints<int32_t, float, int32_t>(0, 2, 16);
@@ -464,5 +463,73 @@ TEST(GatherBlockQuantizedOpTest, GatherAxis2) {
   Test_GatherAxis2_WithZeroPoints<Int4x2, MLFloat16, int64_t>();
 }
 
+// uint8 data in the layout of the B input of MatMulNBits, (N, k_blocks, blob_size)
+template <typename T2>
+void Test_MatMulNBitsLayout(int64_t bits, bool has_zero_points) {
+  constexpr int64_t N = 3;
+  constexpr int64_t k_blocks = 2;
+  constexpr int64_t block_size = 16;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t elements_per_byte = 8 / bits;
+  const int64_t zero_points_row_size = (k_blocks * bits + 7) / 8;
+  const int max_val = (1 << bits) - 1;
+
+  std::vector<int> values(N * k_blocks * block_size);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>((i * 7 + 3) % (max_val + 1));
+  }
+  std::vector<uint8_t> data(N * k_blocks * blob_size, 0);
+  for (size_t i = 0; i < values.size(); ++i) {
+    data[i / elements_per_byte] |= static_cast<uint8_t>(values[i] << (i % elements_per_byte * bits));
+  }
+
+  std::vector<float> scales(N * k_blocks);
+  std::vector<int> zps(N * k_blocks, 1 << (bits - 1));
+  std::vector<uint8_t> zero_points(N * zero_points_row_size, 0);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t blk = 0; blk < k_blocks; ++blk) {
+      scales[n * k_blocks + blk] = 0.25f * static_cast<float>(n * k_blocks + blk + 1);
+      if (has_zero_points) {
+        zps[n * k_blocks + blk] = static_cast<int>((n * 5 + blk * 3) % (max_val + 1));
+        zero_points[n * zero_points_row_size + blk / elements_per_byte] |=
+            static_cast<uint8_t>(zps[n * k_blocks + blk] << (blk % elements_per_byte * bits));
+      }
+    }
+  }
+
+  const std::vector<int64_t> indices = {2, 0, -1, 1};
+  std::vector<float> output;
+  for (int64_t index : indices) {
+    const int64_t n = index < 0 ? index + N : index;
+    for (int64_t k = 0; k < k_blocks * block_size; ++k) {
+      const int64_t blk = n * k_blocks + k / block_size;
+      output.push_back(static_cast<float>(values[n * k_blocks * block_size + k] - zps[blk]) * scales[blk]);
+    }
+  }
+
+  OpTester test("GatherBlockQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddInput<uint8_t>("data", {N, k_blocks, blob_size}, data, true);
+  test.AddInput<int64_t>("indices", {2, 2}, indices);
+  test.AddInput<T2>("scales", {N * k_blocks}, ToType<T2>(scales), true);
+  if (has_zero_points) {
+    test.AddInput<uint8_t>("zero_points", {N * zero_points_row_size}, zero_points, true);
+  }
+  test.AddOutput<T2>("output", {2, 2, k_blocks * block_size}, ToType<T2>(output));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> eps;
+  eps.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &eps);
+}
+
+TEST(GatherBlockQuantizedOpTest, MatMulNBitsLayout) {
+  Test_MatMulNBitsLayout<float>(4, true);
+  Test_MatMulNBitsLayout<float>(4, false);
+  Test_MatMulNBitsLayout<MLFloat16>(4, true);
+  Test_MatMulNBitsLayout<float>(8, true);
+  Test_MatMulNBitsLayout<float>(8, false);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int kHeadSize = 8;
+constexpr int kBlockSize = 2;
+constexpr int kNumBlocks = 4;
+
+std::vector<float> MakeData(size_t size, float offset) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(static_cast<float>(i) * 0.37f + offset);
+  }
+  return data;
+}
+
+// Causal attention of one query head over the keys and values of its sequence, rows of head_size elements.
+void ReferenceAttention(const float* q, const std::vector<std::vector<float>>& keys,
+                        const std::vector<std::vector<float>>& values, int key_count, float* output,
+                        int head_size = kHeadSize) {
+  std::vector<float> scores(key_count);
+  for (int t = 0; t < key_count; ++t) {
+    float dot = 0.0f;
+    for (int h = 0; h < head_size; ++h) {
+      dot += q[h] * keys[t][h];
+    }
+    scores[t] = dot / std::sqrt(static_cast<float>(head_size));
+  }
+  const float max_score = *std::max_element(scores.begin(), scores.end());
+  float sum = 0.0f;
+  for (auto& score : scores) {
+    score = std::exp(score - max_score);
+    sum += score;
+  }
+  for (int h = 0; h < head_size; ++h) {
+    float value = 0.0f;
+    for (int t = 0; t < key_count; ++t) {
+      value += scores[t] / sum * values[t][h];
+    }
+    output[h] = value;
+  }
+}
+
+// Runs GroupQueryAttention with 2 query heads sharing 1 key/value head. With a paged cache of kNumBlocks blocks, the
+// tokens of the past sequences are in the past pools at the positions given by the block table. Without it, the
+// past of each sequence holds total_sequence_length tokens. The new tokens of a sequence follow the
+// seqlens_k + 1 - sequence_length past ones, if any.
+void RunGroupQueryAttention(int sequence_length, const std::vector<int32_t>& seqlens_k,
+                            const std::vector<int32_t>& block_table, bool paged = true) {
+  constexpr int num_heads = 2;
+  const int batch_size = static_cast<int>(seqlens_k.size());
+  const int max_blocks = paged ? static_cast<int>(block_table.size()) / batch_size : 0;
+  const int32_t total_sequence_length = *std::max_element(seqlens_k.begin(), seqlens_k.end()) + 1;
+  const std::vector<int64_t> cache_dims = paged ? std::vector<int64_t>{kNumBlocks, 1, kBlockSize, kHeadSize}
+                                                : std::vector<int64_t>{batch_size, 1, total_sequence_length, kHeadSize};
+  const size_t cache_size = static_cast<size_t>(cache_dims[0] * cache_dims[2] * kHeadSize);
+
+  const std::vector<float> query = MakeData(static_cast<size_t>(batch_size) * sequence_length * num_heads * kHeadSize,
+                                            0.0f);
+  const std::vector<float> key = MakeData(static_cast<size_t>(batch_size) * sequence_length * kHeadSize, 1.0f);
+  const std::vector<float> value = MakeData(static_cast<size_t>(batch_size) * sequence_length * kHeadSize, 2.0f);
+  const std::vector<float> past_key = MakeData(cache_size, 3.0f);
+  const std::vector<float> past_value = MakeData(cache_size, 4.0f);
+
+  // the paged cache keeps the other blocks, the present state of a contiguous cache only has the sequences
+  std::vector<float> present_key = paged ? past_key : std::vector<float>(cache_size);
+  std::vector<float> present_value = paged ? past_value : std::vector<float>(cache_size);
+  std::vector<float> output(static_cast<size_t>(batch_size) * sequence_length * num_heads * kHeadSize);
+  for (int b = 0; b < batch_size; ++b) {
+    const int total_seqlen = seqlens_k[b] + 1;
+    const int past_seqlen = std::max(total_seqlen - sequence_length, 0);
+    auto row = [&](int t) {
+      if (!paged) {
+        return (b * total_sequence_length + t) * kHeadSize;
+      }
+      return (block_table[b * max_blocks + t / kBlockSize] * kBlockSize + t % kBlockSize) * kHeadSize;
+    };
+
+    for (int t = 0; t < past_seqlen; ++t) {
+      std::copy_n(past_key.begin() + row(t), kHeadSize, present_key.begin() + row(t));
+      std::copy_n(past_value.begin() + row(t), kHeadSize, present_value.begin() + row(t));
+    }
+    for (int s = 0; s < sequence_length; ++s) {
+      const size_t input_offset = (static_cast<size_t>(b) * sequence_length + s) * kHeadSize;
+      std::copy_n(key.begin() + input_offset, kHeadSize, present_key.begin() + row(past_seqlen + s));
+      std::copy_n(value.begin() + input_offset, kHeadSize, present_value.begin() + row(past_seqlen + s));
+    }
+
+    std::vector<std::vector<float>> keys;
+    std::vector<std::vector<float>> values;
+    for (int t = 0; t < total_seqlen; ++t) {
+      keys.emplace_back(present_key.begin() + row(t), present_key.begin() + row(t) + kHeadSize);
+      values.emplace_back(present_value.begin() + row(t), present_value.begin() + row(t) + kHeadSize);
+    }
+    for (int s = 0; s < sequence_length; ++s) {
+      for (int n = 0; n < num_heads; ++n) {
+        const size_t offset = ((static_cast<size_t>(b) * sequence_length + s) * num_heads + n) * kHeadSize;
+        ReferenceAttention(query.data() + offset, keys, values, past_seqlen + s + 1, output.data() + offset);
+      }
+    }
+  }
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", 1);
+  if (paged) {
+    test.AddAttribute<int64_t>("kv_block_size", kBlockSize);
+  }
+  test.AddInput<float>("query", {batch_size, sequence_length, num_heads * kHeadSize}, query);
+  test.AddInput<float>("key", {batch_size, sequence_length, kHeadSize}, key);
+  test.AddInput<float>("value", {batch_size, sequence_length, kHeadSize}, value);
+  test.AddInput<float>("past_key", cache_dims, past_key);
+  test.AddInput<float>("past_value", cache_dims, past_value);
+  test.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  if (paged) {
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+    test.AddInput<int32_t>("block_table", {batch_size, max_blocks}, block_table);
+  }
+  test.AddOutput<float>("output", {batch_size, sequence_length, num_heads * kHeadSize}, output);
+  test.AddOutput<float>("present_key", cache_dims, present_key);
+  test.AddOutput<float>("present_value", cache_dims, present_value);
+  test.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Rotary embedding without interleaving of one head of head_size elements at a position of the caches.
+std::vector<float> ReferenceRotary(const float* x, int head_size, const std::vector<float>& cos_cache,
+                                   const std::vector<float>& sin_cache, int position) {
+  const int half = head_size / 2;
+  std::vector<float> rotated(head_size);
+  for (int i = 0; i < head_size; ++i) {
+    const int cache_index = position * half + i % half;
+    const float other = i < half ? -x[i + half] : x[i - half];
+    rotated[i] = x[i] * cos_cache[cache_index] + other * sin_cache[cache_index];
+  }
+  return rotated;
+}
+
+// Runs the prompt of 3 tokens of one sequence with 2 query heads sharing 1 key/value head, rotary embedding on the
+// whole heads of 16 elements, and Q, K and V either packed in the query or separated.
+void RunGroupQueryAttentionWithRotary(bool packed_qkv) {
+  constexpr int num_heads = 2;
+  constexpr int head_size = 16;
+  constexpr int sequence_length = 3;
+  const std::vector<float> query = MakeData(sequence_length * num_heads * head_size, 0.0f);
+  const std::vector<float> key = MakeData(sequence_length * head_size, 1.0f);
+  const std::vector<float> value = MakeData(sequence_length * head_size, 2.0f);
+  std::vector<float> cos_cache(sequence_length * head_size / 2);
+  std::vector<float> sin_cache(cos_cache.size());
+  for (size_t i = 0; i < cos_cache.size(); ++i) {
+    const float angle = static_cast<float>(i / (head_size / 2)) / static_cast<float>(1 + i % (head_size / 2));
+    cos_cache[i] = std::cos(angle);
+    sin_cache[i] = std::sin(angle);
+  }
+
+  std::vector<std::vector<float>> keys;
+  std::vector<std::vector<float>> values;
+  std::vector<float> present_key;
+  for (int s = 0; s < sequence_length; ++s) {
+    keys.push_back(ReferenceRotary(key.data() + s * head_size, head_size, cos_cache, sin_cache, s));
+    values.emplace_back(value.begin() + s * head_size, value.begin() + (s + 1) * head_size);
+    present_key.insert(present_key.end(), keys.back().begin(), keys.back().end());
+  }
+  std::vector<float> output(query.size());
+  for (int s = 0; s < sequence_length; ++s) {
+    for (int n = 0; n < num_heads; ++n) {
+      const int offset = (s * num_heads + n) * head_size;
+      const std::vector<float> q = ReferenceRotary(query.data() + offset, head_size, cos_cache, sin_cache, s);
+      ReferenceAttention(q.data(), keys, values, s + 1, output.data() + offset, head_size);
+    }
+  }
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", 1);
+  test.AddAttribute<int64_t>("do_rotary", 1);
+  if (packed_qkv) {
+    std::vector<float> qkv;
+    for (int s = 0; s < sequence_length; ++s) {
+      qkv.insert(qkv.end(), query.begin() + s * num_heads * head_size, query.begin() + (s + 1) * num_heads * head_size);
+      qkv.insert(qkv.end(), key.begin() + s * head_size, key.begin() + (s + 1) * head_size);
+      qkv.insert(qkv.end(), value.begin() + s * head_size, value.begin() + (s + 1) * head_size);
+    }
+    test.AddInput<float>("query", {1, sequence_length, (num_heads + 2) * head_size}, qkv);
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  } else {
+    test.AddInput<float>("query", {1, sequence_length, num_heads * head_size}, query);
+    test.AddInput<float>("key", {1, sequence_length, head_size}, key);
+    test.AddInput<float>("value", {1, sequence_length, head_size}, value);
+  }
+  test.AddInput<float>("past_key", {1, 1, sequence_length, head_size}, std::vector<float>(key.size()));
+  test.AddInput<float>("past_value", {1, 1, sequence_length, head_size}, std::vector<float>(value.size()));
+  test.AddInput<int32_t>("seqlens_k", {1}, {sequence_length - 1});
+  test.AddInput<int32_t>("total_sequence_length", {1}, {sequence_length});
+  test.AddInput<float>("cos_cache", {sequence_length, head_size / 2}, cos_cache);
+  test.AddInput<float>("sin_cache", {sequence_length, head_size / 2}, sin_cache);
+  test.AddOutput<float>("output", {1, sequence_length, num_heads * head_size}, output);
+  test.AddOutput<float>("present_key", {1, 1, sequence_length, head_size}, present_key);
+  test.AddOutput<float>("present_value", {1, 1, sequence_length, head_size}, value);
+  test.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(GroupQueryAttentionTest, Rotary) {
+  RunGroupQueryAttentionWithRotary(false);
+}
+
+TEST(GroupQueryAttentionTest, Rotary_PackedQKV) {
+  RunGroupQueryAttentionWithRotary(true);
+}
+
+TEST(GroupQueryAttentionTest, PagedKvCache_Prompt) {
+  // the 3 tokens of the prompt go to blocks 2 and 0
+  RunGroupQueryAttention(3, {2}, {2, 0});
+}
+
+TEST(GroupQueryAttentionTest, PagedKvCache_TokenGeneration) {
+  // sequence 0 has 3 past tokens in blocks 3 and 1, sequence 1 has 1 past token in block 0
+  RunGroupQueryAttention(1, {3, 1}, {3, 1, 0, 2});
+}
+
+TEST(GroupQueryAttentionTest, PagedKvCache_ChunkedPrompt) {
+  // the second chunk of 2 tokens follows the 3 tokens of the first chunk in blocks 3, 1 and 0
+  RunGroupQueryAttention(2, {4}, {3, 1, 0});
+}
+
+TEST(GroupQueryAttentionTest, ChunkedPrompt) {
+  // sequence 0 appends 3 tokens to its 2 past tokens, sequence 1 appends 3 tokens to its 4 past tokens
+  RunGroupQueryAttention(3, {4, 6}, {}, false);
+}
+
+TEST(GroupQueryAttentionTest, PagedKvCache_InvalidBlock) {
+  const std::vector<float> pool(kNumBlocks * kBlockSize * kHeadSize);
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", 1);
+  test.AddAttribute<int64_t>("kv_num_heads", 1);
+  test.AddAttribute<int64_t>("kv_block_size", kBlockSize);
+  test.AddInput<float>("query", {1, 1, kHeadSize}, std::vector<float>(kHeadSize, 1.0f));
+  test.AddInput<float>("key", {1, 1, kHeadSize}, std::vector<float>(kHeadSize, 1.0f));
+  test.AddInput<float>("value", {1, 1, kHeadSize}, std::vector<float>(kHeadSize, 1.0f));
+  test.AddInput<float>("past_key", {kNumBlocks, 1, kBlockSize, kHeadSize}, pool);
+  test.AddInput<float>("past_value", {kNumBlocks, 1, kBlockSize, kHeadSize}, pool);
+  test.AddInput<int32_t>("seqlens_k", {1}, {2});
+  test.AddInput<int32_t>("total_sequence_length", {1}, {3});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int32_t>("block_table", {1, 2}, {0, kNumBlocks});
+  test.AddOutput<float>("output", {1, 1, kHeadSize}, std::vector<float>(kHeadSize));
+  test.AddOutput<float>("present_key", {kNumBlocks, 1, kBlockSize, kHeadSize}, pool);
+  test.AddOutput<float>("present_value", {kNumBlocks, 1, kBlockSize, kHeadSize}, pool);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectFailure, "out of the range", {}, nullptr, &execution_providers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
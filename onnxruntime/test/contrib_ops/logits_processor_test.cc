@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+#include <vector>
+#include "gtest/gtest.h"
+#include <gsl/gsl>
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+#include "contrib_ops/cpu/transformers/sequences.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::GrammarLogitsProcessor;
+using contrib::transformers::NextTokenScores;
+using contrib::transformers::Sequences;
+
+TEST(LogitsProcessorTest, GrammarLogitsProcessor) {
+  constexpr int batch_beam_size = 2;
+  constexpr int prompt_length = 2;
+  constexpr int max_length = 5;
+  constexpr int vocab_size = 4;
+  constexpr int num_states = 2;
+  constexpr float masked = std::numeric_limits<float>::lowest();
+
+  // state 0 allows the tokens 0 (to state 1) and 2 (to state 0),
+  // state 1 allows the tokens 1 (to state 0) and 3 (to state 1).
+  const std::vector<int32_t> transitions{1, -1, 0, -1,
+                                         -1, 0, -1, 1};
+  GrammarLogitsProcessor<float> processor(transitions, num_states);
+
+  // the prompts are not walked through the state machine
+  std::vector<int32_t> sequences_buffer(2 * batch_beam_size * max_length, 3);
+  Sequences sequences;
+  sequences.Init(sequences_buffer, batch_beam_size, prompt_length, max_length);
+
+  std::vector<float> scores_buffer(batch_beam_size * vocab_size);
+  gsl::span<float> scores(scores_buffer);
+  auto process = [&]() {
+    std::fill(scores_buffer.begin(), scores_buffer.end(), 1.f);
+    NextTokenScores<float> next_token_scores{scores, batch_beam_size, vocab_size};
+    processor.Process(&sequences, next_token_scores);
+  };
+
+  std::vector<int32_t> beam_indices{0, 1};
+  gsl::span<int32_t> beam_indices_span(beam_indices);
+  auto append = [&](std::vector<int32_t> next_tokens) {
+    gsl::span<int32_t> next_tokens_span(next_tokens);
+    sequences.AppendNextTokenToSequences(beam_indices_span, next_tokens_span);
+  };
+
+  // both sequences start in state 0
+  process();
+  EXPECT_EQ(scores_buffer, (std::vector<float>{1.f, masked, 1.f, masked,
+                                               1.f, masked, 1.f, masked}));
+
+  // the first sequence moves to state 1 and the second one stays in state 0
+  append({0, 2});
+  process();
+  EXPECT_EQ(scores_buffer, (std::vector<float>{masked, 1.f, masked, 1.f,
+                                               1.f, masked, 1.f, masked}));
+
+  // the first sequence moves back to state 0, the second one leaves the state machine and is not masked any more
+  append({1, 1});
+  process();
+  EXPECT_EQ(scores_buffer, (std::vector<float>{1.f, masked, 1.f, masked,
+                                               1.f, 1.f, 1.f, 1.f}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,7 +3,9 @@
 
 #ifndef ORT_MINIMAL_BUILD
 
+#include <cmath>
 #include <optional>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -81,6 +83,11 @@ struct TestOptions {
   bool has_g_idx{false};
   bool has_bias{false};
 
+  // fused epilogue: Y = activation(A * B + bias) * multiplier + residual
+  std::string activation{};
+  bool has_multiplier{false};
+  bool has_residual{false};
+
   std::optional<float> output_abs_error{};
 };
 
@@ -91,7 +98,10 @@ std::ostream& operator<<(std::ostream& os, const TestOptions& opts) {
             << ", has_zero_point:" << opts.has_zero_point
             << ", zp_is_4bit:" << opts.zp_is_4bit
             << ", has_g_idx:" << opts.has_g_idx
-            << ", has_bias:" << opts.has_bias;
+            << ", has_bias:" << opts.has_bias
+            << ", activation:" << opts.activation
+            << ", has_multiplier:" << opts.has_multiplier
+            << ", has_residual:" << opts.has_residual;
 }
 
 template <typename T1>
@@ -170,12 +180,40 @@ void RunTest(const TestOptions& opts,
     }
   }
 
+  const auto multiplier = [&]() -> std::optional<std::vector<float>> {
+    if (opts.has_multiplier) {
+      return random.Uniform(AsSpan({M, N}), -2.0f, 2.0f);
+    }
+    return std::nullopt;
+  }();
+  const auto residual = [&]() -> std::optional<std::vector<float>> {
+    if (opts.has_residual) {
+      return random.Uniform(AsSpan({M, N}), -2.0f, 2.0f);
+    }
+    return std::nullopt;
+  }();
+
+  for (size_t i = 0; i < expected_vals.size(); i++) {
+    float& y = expected_vals[i];
+    if (opts.activation == "gelu") {
+      y = 0.5f * y * (1.0f + std::erf(y * 0.7071067812f));
+    } else if (opts.activation == "fastgelu") {
+      y = 0.5f * y * (1.0f + std::tanh(0.7978845608f * (y + 0.044715f * y * y * y)));
+    } else if (opts.activation == "silu") {
+      y = y / (1.0f + std::exp(-y));
+    }
+    y = y * (multiplier.has_value() ? (*multiplier)[i] : 1.0f) + (residual.has_value() ? (*residual)[i] : 0.0f);
+  }
+
   OpTester test("MatMulNBits", 1, kMSDomain);
   test.AddAttribute<int64_t>("K", K);
   test.AddAttribute<int64_t>("N", N);
   test.AddAttribute<int64_t>("block_size", opts.block_size);
   test.AddAttribute<int64_t>("bits", QBits);
   test.AddAttribute<int64_t>("accuracy_level", opts.accuracy_level);
+  if (!opts.activation.empty()) {
+    test.AddAttribute<std::string>("activation", opts.activation);
+  }
 
   if constexpr (use_float16) {
     test.AddInput<T1>("A", {M, K}, ToFloat16(input0_vals), false);
@@ -243,6 +281,16 @@ void RunTest(const TestOptions& opts,
     test.AddOptionalInputEdge<T1>();
   }
 
+  if (multiplier.has_value()) {
+    test.AddInput<T1>("multiplier", {M, N}, *multiplier, false);
+  } else if (residual.has_value()) {
+    test.AddOptionalInputEdge<T1>();
+  }
+
+  if (residual.has_value()) {
+    test.AddInput<T1>("residual", {M, N}, *residual, false);
+  }
+
   if constexpr (use_float16) {
     test.AddOutput<T1>("Y", {M, N}, ToFloat16(expected_vals));
   } else {
@@ -320,6 +368,37 @@ TEST(MatMulNBits, Float32) {
   }
 }
 
+TEST(MatMulNBits, Float32Epilogue) {
+  for (auto M : {1, 3, 100}) {
+    for (auto N : {1, 32, 288}) {
+      for (auto K : {64, 93}) {
+        for (auto accuracy_level : {0, 4}) {
+          for (const char* activation : {"", "gelu", "fastgelu", "silu"}) {
+            for (bool has_multiplier : {false, true}) {
+              for (bool has_residual : {false, true}) {
+                TestOptions opts{};
+                opts.M = M, opts.N = N, opts.K = K;
+                opts.accuracy_level = accuracy_level;
+                opts.has_bias = true;
+                opts.activation = activation;
+                opts.has_multiplier = has_multiplier;
+                opts.has_residual = has_residual;
+                opts.output_abs_error = accuracy_level == 4 ? 0.1f : 0.001f;
+
+                // only enabled for CPU EP for now
+                std::vector<std::unique_ptr<IExecutionProvider>> explicit_eps;
+                explicit_eps.emplace_back(DefaultCpuExecutionProvider());
+
+                RunTest<float>(opts, std::move(explicit_eps));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 
 namespace {
@@ -412,6 +491,23 @@ TEST(MatMulNBits, Float16Large) {
   }
 }
 
+#if defined(USE_CUDA)
+TEST(MatMulNBits, Float16Prefill) {
+  // Enough rows for the tensor core GEMM, with partial row tiles and a K that is not a multiple of the block size.
+  for (auto M : {32, 100, 300}) {
+    for (auto N : {128, 384}) {
+      for (auto K : {64, 96, 512}) {
+        for (auto block_size : {32, 64, 128}) {
+          for (auto symmetric : {false, true}) {
+            RunTest(M, N, K, block_size, 0, !symmetric, true, false, true, 0.05f);
+          }
+        }
+      }
+    }
+  }
+}
+#endif  // defined(USE_CUDA)
+
 #endif  // defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 
 #if defined(ORT_NEURAL_SPEED)
@@ -20,7 +20,12 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
   constexpr int max_cuda_arch = 900;
 
   bool enable_cuda = HasCudaEnvironment(min_cuda_arch) && !NeedSkipIfCudaArchGreaterEqualThan(max_cuda_arch);
-  if (enable_cuda) {
+  // the CPU kernel only supports float
+  for (bool use_cuda : {true, false}) {
+    if ((use_cuda && !enable_cuda) || (!use_cuda && use_float16)) {
+      continue;
+    }
+
     OpTester tester("MoE", 1, onnxruntime::kMSDomain);
     tester.AddAttribute<int64_t>("k", static_cast<int64_t>(top_k));
     tester.AddAttribute<std::string>("activation_type", activation_type);
@@ -78,7 +83,7 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
     }
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    execution_providers.push_back(use_cuda ? DefaultCudaExecutionProvider() : DefaultCpuExecutionProvider());
     tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -13,6 +13,7 @@
 #include "test/providers/provider_test_utils.h"
 #include "core/util/qmath.h"
 #include "core/quantization/quantization.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -43,7 +44,8 @@ void RunQAttention(const std::vector<float>& input_data,
                    int number_of_heads,
                    bool is_unidirectional = false,
                    bool use_float16 = false,
-                   int input_hidden_size = 0) {
+                   int input_hidden_size = 0,
+                   bool int8_scores = false) {
   input_hidden_size = (input_hidden_size == 0) ? hidden_size : input_hidden_size;
 
   OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
@@ -109,6 +111,17 @@ void RunQAttention(const std::vector<float>& input_data,
   tester.AddInput<QInput>("input_zero_point", {1}, {input_quant_params.zero_point});
   tester.AddInput<QWeight>("weight_zero_point", {1}, {weight_quant_params.zero_point});
 
+  if (int8_scores) {
+    // the probabilities are quantized with a step of 1/255
+    tester.SetOutputTolerance(0.05f);
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsQAttentionInt8Scores, "1"));
+    tester.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+    return;
+  }
+
   std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
   if constexpr (ep == EP::CUDA) {
     execution_providers.push_back(DefaultCudaExecutionProvider());
@@ -520,6 +533,43 @@ TEST(QAttentionTest, QAttentionMaskPartialSequence) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+TEST(QAttentionTest, QAttentionInt8Scores) {
+  int batch_size = 2;
+  int sequence_length = 2;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  // the second sequence only attends its first token
+  std::vector<int32_t> mask_index_data = {2L, 1L};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      8.6899995803833008f, -0.13000002503395081f, 4.25f, 5.6499996185302734f,
+      8.6899995803833008f, -0.13000002503395081f, 4.2499995231628418f, 5.6499991416931152f};
+
+  quantization::Params<uint8_t> input_quant_params(/*scale=*/0.0f, /*zero_point=*/0);
+  quantization::Params<int8_t> weights_quant_params(/*scale=*/0.0f, /*zero_point=*/0);
+  RunQAttention<uint8_t, int8_t, EP::CPU>(
+      input_data, weight_data, bias_data, mask_index_data, output_data, input_quant_params, weights_quant_params,
+      batch_size, sequence_length, hidden_size, number_of_heads, false, false, 0, true);
+}
+
 // oneDNN EP only supports 2D raw mask
 #ifdef USE_DNNL
 TEST(QAttentionTest, QAttentionDNNLMaskPartialSequence) {
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include <cassert>
+#include <cmath>
+#include <functional>
 #include "gtest/gtest.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -790,5 +792,81 @@ TEST(RotaryEmbeddingTest, RotaryEmbedding_CustomRotaryDim_SmallData_Phi_Packed_B
            true /*disable_dml*/);
 }
 
+// Runs RotaryEmbedding on CPU without cos_cache and sin_cache from position first_position. The expected output is
+// computed with the given frequency of each of the head_size / 2 dimensions and attention factor.
+static void RunComputedCacheTest(int64_t first_position, const std::vector<double>& inv_freq, double attention_factor,
+                                 const std::function<void(OpTester&)>& add_attributes) {
+  constexpr int num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int sequence_length = 3;
+  constexpr int half = head_size / 2;
+  std::vector<float> input_data(sequence_length * num_heads * head_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = std::sin(static_cast<float>(i) * 0.7f);
+  }
+
+  std::vector<float> output_data(input_data.size());
+  for (int s = 0; s < sequence_length; s++) {
+    for (int n = 0; n < num_heads; n++) {
+      const float* x = input_data.data() + (s * num_heads + n) * head_size;
+      float* y = output_data.data() + (s * num_heads + n) * head_size;
+      for (int i = 0; i < head_size; i++) {
+        const double angle = static_cast<double>(first_position + s) * inv_freq[i % half];
+        const double other = i < half ? -x[i + half] : x[i - half];
+        y[i] = static_cast<float>((x[i] * std::cos(angle) + other * std::sin(angle)) * attention_factor);
+      }
+    }
+  }
+
+  OpTester test("RotaryEmbedding", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  add_attributes(test);
+  test.AddInput<float>("input", {1, sequence_length, num_heads * head_size}, input_data);
+  test.AddInput<int64_t>("position_ids", {1}, {first_position});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddOutput<float>("output", {1, sequence_length, num_heads * head_size}, output_data);
+  test.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(RotaryEmbeddingTest, RotaryEmbedding_ComputedCache_Linear) {
+  std::vector<double> inv_freq;
+  for (int i = 0; i < 4; i++) {
+    inv_freq.push_back(1.0 / std::pow(500.0, i / 4.0) / 2.0);
+  }
+  RunComputedCacheTest(5, inv_freq, 1.0, [](OpTester& test) {
+    test.AddAttribute<float>("rope_theta", 500.0f);
+    test.AddAttribute<std::string>("rope_scaling_type", "linear");
+    test.AddAttribute<float>("rope_scaling_factor", 2.0f);
+  });
+}
+
+TEST(RotaryEmbeddingTest, RotaryEmbedding_ComputedCache_LongRope) {
+  const std::vector<float> short_factor = {1.0f, 1.5f, 2.0f, 3.0f};
+  const std::vector<float> long_factor = {1.0f, 4.0f, 8.0f, 16.0f};
+  auto add_attributes = [&](OpTester& test) {
+    test.AddAttribute<std::string>("rope_scaling_type", "longrope");
+    test.AddAttribute<float>("rope_scaling_factor", 4.0f);
+    test.AddAttribute<int64_t>("original_max_position_embeddings", 16);
+    test.AddAttribute<std::vector<float>>("short_factor", short_factor);
+    test.AddAttribute<std::vector<float>>("long_factor", long_factor);
+  };
+  const double attention_factor = std::sqrt(1.0 + std::log(4.0) / std::log(16.0));
+
+  // the positions within the original context use the short factors, the ones beyond it the long factors
+  std::vector<double> short_inv_freq;
+  std::vector<double> long_inv_freq;
+  for (int i = 0; i < 4; i++) {
+    short_inv_freq.push_back(1.0 / std::pow(10000.0, i / 4.0) / short_factor[i]);
+    long_inv_freq.push_back(1.0 / std::pow(10000.0, i / 4.0) / long_factor[i]);
+  }
+  RunComputedCacheTest(5, short_inv_freq, attention_factor, add_attributes);
+  RunComputedCacheTest(20, long_inv_freq, attention_factor, add_attributes);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
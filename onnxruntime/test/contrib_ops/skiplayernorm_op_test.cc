@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -96,9 +99,7 @@ static void RunOneTest(
       execution_providers.push_back(DefaultCpuExecutionProvider());
     }
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
-  } else if (HasCudaEnvironment(530 /*min_cuda_architecture*/) ||
-             dml_ep != nullptr ||
-             rocm_ep != nullptr) {
+  } else {
     OpTester test(op_type.c_str(), 1, onnxruntime::kMSDomain);
     test.AddInput<MLFloat16>("input", input_dims, ToFloat16(input_data));
     test.AddInput<MLFloat16>("skip", skip_dims, ToFloat16(skip_data));
@@ -136,6 +137,8 @@ static void RunOneTest(
       execution_providers.push_back(DefaultDmlExecutionProvider());
     } else if (rocm_ep != nullptr) {
       execution_providers.push_back(DefaultRocmExecutionProvider());
+    } else if (!HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
     } else {
       if (strict) {
         const auto& api = Ort::GetApi();
@@ -861,5 +864,65 @@ TEST(SkipLayerNormTest, SkipLayerNormBatch2_Skip_Broadcast_Batch_Size_1) {
 }
 #endif
 
+TEST(SkipLayerNormTest, QSkipLayerNormBatch2_Bias) {
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t sequence_length = 2;
+  constexpr int64_t hidden_size = 4;
+
+  std::vector<float> input_data = {
+      0.7f, -0.4f, -0.2f, 1.2f,
+      0.4f, 0.3f, 0.1f, -0.4f,
+      0.7f, -0.4f, -0.2f, 1.2f,
+      0.4f, 0.3f, 0.1f, -0.4f};
+
+  std::vector<float> skip_data = {
+      0.1f, -0.2f, 0.3f, 1.0f,
+      0.5f, 0.1f, 0.4f, 1.6f,
+      1.8f, -0.3f, 0.0f, 1.f,
+      -0.5f, 0.4f, 0.8f, -0.6f};
+
+  std::vector<float> gamma_data = {
+      0.3f, 0.2f, 4.0f, 2.2f};
+
+  std::vector<float> beta_data = {
+      0.2f, 0.1f, 0.4f, 1.6f};
+
+  std::vector<float> bias_data = {
+      0.1f, -0.1f, 0.2f, -0.2f};
+
+  std::vector<float> output_data = {
+      0.28433859348297119f, -0.17090578377246857f, -0.92897164821624756f, 4.6924152374267578f,
+      0.46111652255058289f, -0.21333980560302734f, -0.29631003737449646f, 3.5148544311523438f,
+      0.55470430850982666f, -0.15080101788043976f, -2.3229825496673584f, 3.255286693572998f,
+      0.15631480515003204f, 0.21066918969154358f, 4.9432611465454102f, -1.7957965135574341f};
+
+  constexpr float y_scale = 0.05f;
+  constexpr uint8_t y_zero_point = 128;
+  std::vector<uint8_t> quantized_output_data;
+  for (float value : output_data) {
+    const float quantized = std::nearbyint(value / y_scale) + static_cast<float>(y_zero_point);
+    quantized_output_data.push_back(static_cast<uint8_t>(std::clamp(quantized, 0.0f, 255.0f)));
+  }
+
+  std::vector<float> input_skip_bias_add_output_data(input_data.size());
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_skip_bias_add_output_data[i] = input_data[i] + skip_data[i] + bias_data[i % hidden_size];
+  }
+
+  const std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  OpTester test("QSkipLayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", epsilon_);
+  test.AddInput<float>("input", input_dims, input_data);
+  test.AddInput<float>("skip", input_dims, skip_data);
+  test.AddInput<float>("gamma", {hidden_size}, gamma_data);
+  test.AddInput<float>("beta", {hidden_size}, beta_data);
+  test.AddInput<float>("bias", {hidden_size}, bias_data);
+  test.AddInput<float>("y_scale", {}, {y_scale});
+  test.AddInput<uint8_t>("y_zero_point", {}, {y_zero_point});
+  test.AddOutput<uint8_t>("output", input_dims, quantized_output_data);
+  test.AddOutput<float>("input_skip_bias_sum", input_dims, input_skip_bias_add_output_data);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -113,15 +114,19 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool use_memory_aware_node_order = false)
+      : shape_map_(shape_map), use_memory_aware_node_order_(use_memory_aware_node_order) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool UseMemoryAwareNodeOrder() const override { return use_memory_aware_node_order_; }
+
  private:
   ShapeMap* shape_map_;
+  bool use_memory_aware_node_order_;
 };
 
 class ParallelPlannerTestContext : public SequentialPlannerTestContext {
@@ -148,6 +153,7 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;               // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;          // a unary kernel with in-place
   std::unique_ptr<::onnxruntime::KernelDef> external_outputs_kernel_;  // an unary kernel with external outputs
+  std::unique_ptr<::onnxruntime::KernelDef> split_kernel_;             // a Split kernel with outputs that may be views
 #ifdef ENABLE_STRIDED_TENSORS
   std::unique_ptr<::onnxruntime::KernelDef> may_strided_input_kernel_;   // an uinary kernel with may_strided_input
   std::unique_ptr<::onnxruntime::KernelDef> may_strided_output_kernel_;  // an unary kernel with may_strided_output
@@ -164,6 +170,7 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<SessionOptions> sess_options_;
   std::unique_ptr<SessionState> state_;
   ShapeMap shape_map_;
+  bool use_memory_aware_node_order_{false};
   std::optional<SequentialExecutionPlan> plan_;
 
  public:
@@ -177,6 +184,8 @@ class PlannerTest : public ::testing::Test {
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
     external_outputs_kernel_ =
         KernelDefBuilder().SetName("Tanh").Provider(kCpuExecutionProvider).SinceVersion(1, 10).ExternalOutputs().Build();
+    split_kernel_ =
+        KernelDefBuilder().SetName("Split").Provider(kCpuExecutionProvider).SinceVersion(2, 10).MayViewOutputs(0).Build();
 #ifdef ENABLE_STRIDED_TENSORS
     may_strided_input_kernel_ = KernelDefBuilder()
                                     .SetName("Abs")
@@ -238,6 +247,14 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*external_outputs_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddSplitNode(std::string& input, std::string& output1, std::string& output2, int64_t axis) {
+    std::string node_name = "node" + std::to_string(NodeCounter::Next());
+    std::vector<onnxruntime::NodeArg*> inputs{Arg(input)}, outputs{Arg(output1), Arg(output2)};
+    auto* p_node = AddNode(*split_kernel_, node_name, inputs, outputs);
+    p_node->AddAttribute("axis", axis);
+    return p_node;
+  }
+
 #ifdef ENABLE_STRIDED_TENSORS
   onnxruntime::Node* AddMayStridedInputNode(std::string& input, std::string& output) {
     return AddNode(*may_strided_input_kernel_, input, output);
@@ -305,7 +322,7 @@ class PlannerTest : public ::testing::Test {
     status = state_->FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager, {}, remove_initializers);
 
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, use_memory_aware_node_order_);
     plan_.emplace();
 
     class MockStreamHandleRegsitry : public IStreamCommandHandleRegistry {
@@ -356,6 +373,14 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckViewOf(const std::string& name, const std::string& view_of) {
+    int id;
+    index(name, id);
+    int view_of_id;
+    index(view_of, view_of_id);
+    EXPECT_EQ(plan_->allocation_plan[id].view_of, view_of_id) << "Error in view for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // TODO: add the checker for new implementation of release plan
     //// create set and check equality
@@ -385,7 +410,14 @@ class PlannerTest : public ::testing::Test {
   void SetNodePartitionConfigFilePath(const char* config_file_path) {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
+  void SetMaxStreamsPerDevice(const char* max_streams_per_device) {
+    ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kOrtSessionOptionsMaxStreamsPerDevice,
+                                                                    max_streams_per_device));
+  }
   std::unique_ptr<::onnxruntime::KernelDef>& GetStdKernel() { return std_kernel_; }
+  void SetUseMemoryAwareNodeOrder(bool use_memory_aware_node_order) {
+    use_memory_aware_node_order_ = use_memory_aware_node_order;
+  }
 #ifdef USE_CUDA
   void MemcpyToHostInCuda_TransposeInCudaAndCpu(const char* partitionConfigFile = nullptr) {
     std::unique_ptr<::onnxruntime::KernelDef> cudaKernel = KernelDefBuilder().SetName("MemcpyToHost").Provider(kCudaExecutionProvider).SetDefaultOutputMemoryType(OrtMemTypeCPUOutput).Build();
@@ -512,6 +544,120 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(0, {});
   CheckFreed(1, {});
   CheckFreed(2, {X2});
+
+  // the size of X3 is not known statically
+  EXPECT_EQ(GetPlan().inplace_reuse_stats.num_values, 1U);
+  EXPECT_EQ(GetPlan().inplace_reuse_stats.num_bytes, 0U);
+}
+
+TEST_F(PlannerTest, InPlaceStatsTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: temporary
+  AddInplaceNode(X3, X4);  // may-in-place operator; X4: temporary
+  AddNormalNode(X4, X5);   // no in-place operator; X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{4, 8};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X4, AllocKind::kReuse);
+
+  EXPECT_EQ(GetPlan().inplace_reuse_stats.num_values, 2U);
+  EXPECT_EQ(GetPlan().inplace_reuse_stats.num_bytes, 2 * 4 * 8 * sizeof(float));
+}
+
+TEST_F(PlannerTest, SplitViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), Y1("Y1"), Y2("Y2"), Z1("Z1"), Z2("Z2");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddSplitNode(X2, Y1, Y2, 1);  // the dim before the split axis has a single element, Y1 and Y2 are views of X2
+  AddNormalNode(Y1, Z1);
+  AddNormalNode(Y2, Z2);
+
+  // simulate shape-inference results:
+  Shape input_shape{1, 4, 2};
+  Shape output_shape{1, 2, 2};
+  SetShape({{X1, &input_shape.value}, {X2, &input_shape.value}, {Y1, &output_shape.value},
+            {Y2, &output_shape.value}, {Z1, &output_shape.value}, {Z2, &output_shape.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(Y1, AllocKind::kReuse);
+  CheckAllocKind(Y2, AllocKind::kReuse);
+  CheckViewOf(Y1, X2);
+  CheckViewOf(Y2, X2);
+}
+
+TEST_F(PlannerTest, SplitNoViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), Y1("Y1"), Y2("Y2"), Z1("Z1"), Z2("Z2");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddSplitNode(X2, Y1, Y2, 1);  // the outputs are strided in X2 and need their own buffers
+  AddNormalNode(Y1, Z1);
+  AddNormalNode(Y2, Z2);
+
+  // simulate shape-inference results:
+  Shape input_shape{2, 4, 2};
+  Shape output_shape{2, 2, 2};
+  SetShape({{X1, &input_shape.value}, {X2, &input_shape.value}, {Y1, &output_shape.value},
+            {Y2, &output_shape.value}, {Z1, &output_shape.value}, {Z2, &output_shape.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(Y1, AllocKind::kAllocate);
+  CheckAllocKind(Y2, AllocKind::kAllocate);
+}
+
+TEST_F(PlannerTest, MemoryAwareNodeOrderTest) {
+  // tensor variables:
+  std::string X1("X1"), A1("A1"), A2("A2"), B1("B1"), B2("B2");
+
+  // graph structure: two branches that each produce a large temporary and reduce it to a small output.
+  auto* a_expand = AddNormalNode(X1, A1);
+  auto* a_reduce = AddNormalNode(A1, A2);
+  auto* b_expand = AddNormalNode(X1, B1);
+  auto* b_reduce = AddNormalNode(B1, B2);
+
+  // simulate shape-inference results:
+  Shape small_shape{2};
+  Shape large_shape{1024};
+  SetShape({{X1, &small_shape.value}, {A1, &large_shape.value}, {A2, &small_shape.value},
+            {B1, &large_shape.value}, {B2, &small_shape.value}});
+
+  SetUseMemoryAwareNodeOrder(true);
+  CreatePlan();
+
+  // each large temporary is consumed right after it is produced so only one of them is live at a time.
+  const auto& node_order = GetPlan().memory_aware_node_order;
+  ASSERT_EQ(node_order.size(), 4U);
+  auto position = [&node_order](const Node* node) {
+    return std::distance(node_order.begin(), std::find(node_order.begin(), node_order.end(), node->Index()));
+  };
+  EXPECT_EQ(position(a_reduce), position(a_expand) + 1);
+  EXPECT_EQ(position(b_reduce), position(b_expand) + 1);
+
+  // the execution plan follows the chosen order.
+  ASSERT_EQ(GetPlan().execution_plan.size(), 1U);
+  std::vector<NodeIndex> executed;
+  for (const auto& step : GetPlan().execution_plan[0]->steps_) {
+    executed.push_back(step->GetNodeIndex());
+  }
+  EXPECT_EQ(executed, node_order);
 }
 
 TEST_F(PlannerTest, ExternalOutputsTest) {
@@ -1443,6 +1589,45 @@ TEST_F(PlannerTest, MultiStream2NodesSameStreamConsumedBy1NodeInDifferentStream)
   EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[1]->steps_[3]).name(), "WaitOnEPStep"), nullptr) << "3rd step: WaitOnEPStep for node 2, for ActivateNotificationStep in stream 0";
   EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[1]->steps_[4]).name(), "LaunchKernelStep"), nullptr) << "4th step: LaunchKernelStep for node 3";
 }
+
+// Test execution plan for the graph without a partition config and up to 2 streams per device:
+// node1   node2
+//   \       /
+//    \     /
+//      node3
+//        |
+//      node4
+// All 4 nodes are CUDA EP. node3 and node4 continue the stream of node1, and the independent node2 gets a second stream.
+TEST_F(PlannerTest, MultiStreamIndependentBranchesOnOneDevice) {
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernel = KernelDefBuilder().SetName("Transpose").Provider(kCudaExecutionProvider).SinceVersion(1, 10).Build();
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernelAdd = KernelDefBuilder().SetName("Add").Provider(kCudaExecutionProvider).SinceVersion(1, 10).Build();
+  std::string Graph_input1("Graph_input1"), Graph_input2("Graph_input2"), Arg1("Arg1"), Arg2("Arg2"), Arg3("Arg3"), Arg4("Arg4"), node1("node1"), node2("node2"), node3("node3"), node4("node4");
+  std::vector<onnxruntime::NodeArg*> input1{Arg(Graph_input1)}, input2{Arg(Graph_input2)}, output1{Arg(Arg1)}, output2{Arg(Arg2)}, input3{Arg(Arg1), Arg(Arg2)}, output3{Arg(Arg3)}, output4{Arg(Arg4)};
+  AddNode(*cudaKernel, node1, input1, output1);
+  AddNode(*cudaKernel, node2, input2, output2);
+  AddNode(*cudaKernelAdd, node3, input3, output3);
+  AddNode(*cudaKernel, node4, output3, output4);
+
+  CUDAExecutionProviderInfo epi;
+  onnxruntime::ProviderInfo_CUDA& ep = onnxruntime::GetProviderInfo_CUDA();
+  auto epFactory = ep.CreateExecutionProviderFactory(epi);
+  std::unique_ptr<IExecutionProvider> execution_provider = epFactory->CreateProvider();
+  ORT_THROW_IF_ERROR(GetExecutionProviders().Add("CUDAExecutionProvider", std::move(execution_provider)));
+
+  SetMaxStreamsPerDevice("2");
+  CreatePlan({}, false);
+
+  const auto& execution_plan = GetState().GetExecutionPlan()->execution_plan;
+  ASSERT_EQ(execution_plan.size(), 2) << "2 logic streams on the CUDA device";
+  auto count_steps = [](const SequentialExecutionPlan::LogicStream& stream, const char* step_type) {
+    return std::count_if(stream.steps_.begin(), stream.steps_.end(),
+                         [step_type](const auto& step) { return strstr(typeid(*step).name(), step_type) != nullptr; });
+  };
+  EXPECT_EQ(count_steps(*execution_plan[0], "LaunchKernelStep"), 3) << "stream 0 runs node1, node3 and node4";
+  EXPECT_EQ(count_steps(*execution_plan[0], "WaitOnEPStep"), 1) << "node3 waits for node2 in stream 1";
+  EXPECT_EQ(count_steps(*execution_plan[1], "LaunchKernelStep"), 1) << "stream 1 runs node2";
+  EXPECT_EQ(count_steps(*execution_plan[1], "ActivateNotificationStep"), 1) << "node2 notifies node3";
+}
 #endif
 
 #if !defined(__wasm__) && defined(ORT_ENABLE_STREAM)
@@ -2128,5 +2313,50 @@ TEST(AllocationPlannerTest, AvoidReuseOfBufferForNodeOutputWithNoConsumers) {
 }
 #endif
 
+TEST(AllocationPlannerTest, StaticMemoryPlannerIntervalColoring) {
+  const OrtDevice cpu;
+  const OrtDevice gpu(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0);
+  const std::vector<StaticMemoryPlanValue> values{
+      {0, cpu, 128, 0, 1},
+      {1, cpu, 64, 1, 2},
+      {2, cpu, 128, 2, 3},
+      {3, cpu, 64, 0, 3},
+      {4, gpu, 256, 0, 0},
+      {5, gpu, 256, 1, 1},
+  };
+
+  MemoryPatternGroup group;
+  ASSERT_STATUS_OK(StaticMemoryPlanner::CreatePatterns(values, group));
+  ASSERT_EQ(group.locations.size(), 2u);
+  ASSERT_EQ(group.patterns.size(), 2u);
+
+  // 0 and 2 don't overlap in time so they share an offset. 3 lives the whole time and 1 overlaps all others.
+  const auto* cpu_pattern = group.GetPatterns(cpu);
+  ASSERT_NE(cpu_pattern, nullptr);
+  EXPECT_EQ(cpu_pattern->PeakSize(), 256u);
+  EXPECT_EQ(cpu_pattern->GetBlock(0)->offset_, cpu_pattern->GetBlock(2)->offset_);
+
+  for (const auto& a : values) {
+    for (const auto& b : values) {
+      if (a.index >= b.index || !(a.location == b.location) ||
+          a.first_step > b.last_step || b.first_step > a.last_step) {
+        continue;
+      }
+
+      const auto* pattern = group.GetPatterns(a.location);
+      const auto* block_a = pattern->GetBlock(a.index);
+      const auto* block_b = pattern->GetBlock(b.index);
+      EXPECT_TRUE(block_a->offset_ + block_a->size_ <= block_b->offset_ ||
+                  block_b->offset_ + block_b->size_ <= block_a->offset_)
+          << "OrtValues " << a.index << " and " << b.index << " are live at the same time but overlap in memory";
+    }
+  }
+
+  // the two gpu values are never live at the same time
+  const auto* gpu_pattern = group.GetPatterns(gpu);
+  ASSERT_NE(gpu_pattern, nullptr);
+  EXPECT_EQ(gpu_pattern->PeakSize(), 256u);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 #include <absl/base/config.h>
 
 #include "core/framework/allocator.h"
+#include "core/framework/allocator_utils.h"
+#include "core/framework/bfc_arena.h"
 
 #include "test_utils.h"
 #include "gtest/gtest.h"
@@ -32,6 +34,31 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   cpu_arena->Free(bytes);
   // todo: test the used / max api.
 }
+TEST(AllocatorTest, CPUArenaWithHugePagesAndNumaNode) {
+  // huge pages may not be reserved and NUMA binding may not be supported on the test machine,
+  // in which case the arena falls back to regular pages/placement. Either way the memory must be usable.
+  OrtArenaCfg arena_cfg;
+  arena_cfg.huge_page_size = 2 * 1024 * 1024;
+  arena_cfg.numa_node = 0;
+  arena_cfg.initial_chunk_size_bytes = 2 * 1024 * 1024;
+  AllocatorCreationInfo creation_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, arena_cfg};
+  auto allocator = CreateAllocator(creation_info);
+  ASSERT_NE(allocator, nullptr);
+  EXPECT_EQ(allocator->Info().alloc_type, OrtAllocatorType::OrtArenaAllocator);
+
+  for (size_t size : {size_t{1024}, size_t{3 * 1024 * 1024}}) {
+    void* bytes = allocator->Alloc(size);
+    ASSERT_NE(bytes, nullptr);
+    memset(bytes, -1, size);
+    EXPECT_EQ(static_cast<unsigned char*>(bytes)[size - 1], 0xFF);
+    allocator->Free(bytes);
+  }
+
+  EXPECT_TRUE(static_cast<BFCArena*>(allocator.get())->Shrink().IsOK());
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(disable : 26400)
 #endif
@@ -7,7 +7,9 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
+#include "core/framework/device_stream_collection.h"
 
 namespace onnxruntime {
 namespace test {
@@ -307,6 +309,123 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_chunks*/ 4);
+  void* p = a.Alloc(1024);
+  a.Free(p);
+  // the chunk is parked in this thread's cache so it is still accounted as in use
+  CheckStats(&a, 1, 1024, 1024, 1024);
+
+  // a request that rounds to the same size is served from the cache without going to the arena
+  void* q = a.Alloc(1000);
+  EXPECT_EQ(p, q);
+  CheckStats(&a, 1, 1024, 1024, 1024);
+  a.Free(q);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+  for (void* ptr : ptrs) {
+    a.Free(ptr);
+  }
+
+  // the cache is trimmed in batches once it holds more than 4 chunks for a bin
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_use, 4 * 1024);
+
+  // Shrink returns the chunks cached by the calling thread
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // allocations that are too large for the cache go straight to the arena
+  void* large = a.Alloc(4 * 1024 * 1024);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheCrossThreadFree) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_chunks*/ 4);
+  AllocatorStats stats;
+
+  // allocated here, freed on another thread: the chunk goes back to the shared bins
+  void* p = a.Alloc(2048);
+  std::thread([&a, p]() { a.Free(p); }).join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // the pointer may be handed out again and must not be mistaken for a stale cache entry
+  void* q = a.Alloc(2048);
+  a.Free(q);
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // chunks cached by a thread are returned when the thread exits
+  std::thread([&a]() {
+    void* r = a.Alloc(512);
+    a.Free(r);
+  }).join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+// BFCArena with a clock that only moves when the test advances it.
+class ManualClockBFCArena : public BFCArena {
+ public:
+  explicit ManualClockBFCArena(int64_t shrink_half_life_ms)
+      : BFCArena(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+                 BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                 BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                 BFCArena::DEFAULT_THREAD_CACHE_MAX_CHUNKS, shrink_half_life_ms),
+        now_(std::chrono::steady_clock::now()) {}
+
+  void Advance(int64_t ms) { now_ += std::chrono::milliseconds(ms); }
+
+ protected:
+  std::chrono::steady_clock::time_point Now() const override { return now_; }
+
+ private:
+  std::chrono::steady_clock::time_point now_;
+};
+
+TEST(BFCArenaTest, TestShrinkToDecayedHighWaterMark) {
+  AllocatorStats stats;
+  ManualClockBFCArena a(/*shrink_half_life_ms*/ 1000);
+  void* p1k = a.Alloc(1024);
+  void* p10M = a.Alloc(10 * 1024 * 1024);
+  EXPECT_EQ(a.DecayedHighWaterMark(), 10 * 1024 * 1024 + 1024);
+  a.Free(p10M);
+
+  // the policy is not evaluated until a quarter of the half-life has passed
+  a.Advance(100);
+  a.Free(a.Alloc(512));
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024 + 1024);
+  EXPECT_EQ(a.DecayedHighWaterMark(), 10 * 1024 * 1024 + 1024);
+
+  // after more than a half-life the high-water mark is below the size of the unused 10M region,
+  // so the next Free releases it without an explicit Shrink()
+  a.Advance(1000);
+  a.Free(a.Alloc(512));
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 1024) << "Expect only the 1K region to be left but actually "
+                                               << stats.total_allocated_bytes << " bytes";
+  EXPECT_LT(a.DecayedHighWaterMark(), 10 * 1024 * 1024);
+  a.Free(p1k);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -414,6 +533,36 @@ TEST(StreamAwareArenaTest, TestSecureTheChunk) {
   EXPECT_TRUE(waitFunctionInvoked) << "wait function should be invoked";
   a.Free(p2);
 }
+
+TEST(StreamAwareArenaTest, ReusedDeviceStreamCollectionIsResetBetweenRuns) {
+  auto arena = std::make_shared<StreamAwareArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, false);
+  const OrtDevice& device = arena->Info().device;
+  AllocatorMap allocators{{device, arena}};
+
+  // a subgraph collection that is held across iterations, as utils::RepeatedSubgraphExecutor does
+  DeviceStreamCollection collection(1, allocators, false);
+  collection.AddDeviceStream(0, std::make_unique<StreamMock>(device));
+  Stream* run_stream = collection.GetStream(0);
+  StreamMock other_stream(device);
+
+  for (int run = 0; run < 3; ++run) {
+    void* run_chunk = arena->AllocOnStream(4096, run_stream, nullptr);
+    arena->Free(run_chunk);
+
+    // the freed chunk stays bound to the stream of the collection during the run
+    void* other_chunk = arena->AllocOnStream(4096, &other_stream, nullptr);
+    EXPECT_NE(other_chunk, run_chunk) << "run " << run;
+    arena->Free(other_chunk);
+    arena->ReleaseStreamBuffers(&other_stream);
+
+    // cleaning up at the end of the run unbinds it, so the next run starts from a reset collection
+    ASSERT_TRUE(collection.CleanUp(false).IsOK());
+    other_chunk = arena->AllocOnStream(4096, &other_stream, nullptr);
+    EXPECT_EQ(other_chunk, run_chunk) << "run " << run;
+    arena->Free(other_chunk);
+    arena->ReleaseStreamBuffers(&other_stream);
+  }
+}
 #endif
 
 TEST(BFCArenaTest, TestExtendStrategy) {
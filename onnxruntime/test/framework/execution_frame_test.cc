@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "core/common/span_utils.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
@@ -8,6 +10,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -366,6 +369,345 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternShapeBucketTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      input_def3("X3", &tensor_float),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  const std::string pattern_file = "mem_pattern_shape_bucket_test.patterns";
+  std::filesystem::remove(pattern_file);
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsMemoryPatternShapeBucketSize, "32"));
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsMemoryPatternFilePath,
+                                                              pattern_file.c_str()));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  ASSERT_EQ(state.GetMemoryPatternShapeBucketSize(), 32);
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+  int x1_idx = -1, x2_idx = -1, x3_idx = -1;
+  int t1_idx = -1, t2_idx = -1, t3_idx = -1;
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X1", x1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X2", x2_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X3", x3_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T1", t1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T2", t2_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T3", t3_idx));
+  const std::vector<int> feed_idxs{x1_idx, x2_idx, x3_idx};
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  auto make_feeds = [&cpu_allocator](int64_t n) {
+    std::vector<OrtValue> feeds(3);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{1, n},
+                         std::vector<float>(static_cast<size_t>(n), 1.0f), &feeds[0]);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{n, n},
+                         std::vector<float>(static_cast<size_t>(n * n), 1.0f), &feeds[1]);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{n, 3},
+                         std::vector<float>(static_cast<size_t>(n * 3), 1.0f), &feeds[2]);
+    return feeds;
+  };
+
+  // trace a pattern with n = 2. T1 is {1, 2} and T2 is {1, 3}, so both take a single aligned block.
+  std::vector<OrtValue> small_feeds = make_feeds(2);
+  MemoryPatternGroup traced;
+  {
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(feed_idxs, small_feeds, AsSpan({t3_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    ASSERT_TRUE(frame.HasMemoryPatternPlanner());
+
+    OrtValue t1, t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1, t1_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{1, 2})));
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2, t2_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{1, 3})));
+    ASSERT_STATUS_OK(frame.GeneratePatterns(traced));
+  }
+  const size_t peak_size = traced.GetPatterns(cpu_allocator->Info().device)->PeakSize();
+  ASSERT_EQ(peak_size, 2u * kAllocAlignment);
+  ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(small_feeds, std::move(traced)));
+  ASSERT_TRUE(std::filesystem::exists(pattern_file));
+
+  // n = 20 is in the same bucket as n = 2, n = 40 is not.
+  std::vector<OrtValue> large_feeds = make_feeds(20);
+  const InlinedHashMap<int, TensorShape>* inferred_shapes = nullptr;
+  ASSERT_NE(state.GetMemoryPatternGroup(large_feeds, feed_idxs, inferred_shapes), nullptr);
+#ifndef ENABLE_TRAINING
+  ASSERT_EQ(state.GetMemoryPatternGroup(make_feeds(40), feed_idxs, inferred_shapes), nullptr);
+
+  // the same dims with a different rank land in the same buckets, but need a different pattern so they must not
+  // share the cache entry.
+  std::vector<OrtValue> reshaped_feeds(3);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{1, 1, 2}, std::vector<float>(2, 1.0f), &reshaped_feeds[0]);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &reshaped_feeds[1]);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &reshaped_feeds[2]);
+  ASSERT_EQ(state.GetMemoryPatternGroup(reshaped_feeds, feed_idxs, inferred_shapes), nullptr);
+
+  // a shape in a different bucket than the cached one must not share it either.
+  std::vector<OrtValue> rebucketed_feeds = make_feeds(2);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{40, 3}, std::vector<float>(120, 1.0f),
+                       &rebucketed_feeds[2]);
+  ASSERT_EQ(state.GetMemoryPatternGroup(rebucketed_feeds, feed_idxs, inferred_shapes), nullptr);
+#endif
+
+  {
+    // T1 is {1, 20} now which doesn't fit in the block traced for {1, 2}
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(feed_idxs, large_feeds, AsSpan({t3_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    ASSERT_FALSE(frame.HasMemoryPatternPlanner());
+
+    OrtValue t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2, t2_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{1, 3})));
+    ASSERT_FALSE(frame.HasMemoryPatternMiss());
+
+    OrtValue t1;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1, t1_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{1, 20})));
+    ASSERT_TRUE(frame.HasMemoryPatternMiss());
+  }
+
+  // a new session state for the same model picks up the persisted pattern.
+  SessionState restored_state(graph, execution_providers, &tp_, nullptr, dtm,
+                              DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(restored_state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  const auto* restored = restored_state.GetMemoryPatternGroup(small_feeds, feed_idxs, inferred_shapes);
+  ASSERT_NE(restored, nullptr);
+  const auto* restored_pattern = restored->GetPatterns(cpu_allocator->Info().device);
+  ASSERT_NE(restored_pattern, nullptr);
+  ASSERT_EQ(restored_pattern->PeakSize(), peak_size);
+  ASSERT_NE(restored_pattern->GetBlock(t1_idx), nullptr);
+  ASSERT_NE(restored_pattern->GetBlock(t2_idx), nullptr);
+
+#ifndef ENABLE_TRAINING
+  // dropping the pattern for the bucket makes the next run trace again.
+  ASSERT_TRUE(restored_state.ResetMemoryPatternGroup(large_feeds));
+  ASSERT_EQ(restored_state.GetMemoryPatternGroup(small_feeds, feed_idxs, inferred_shapes), nullptr);
+  ASSERT_FALSE(restored_state.ResetMemoryPatternGroup(large_feeds));
+
+  // once 16 patterns have been dropped, the cached pattern is kept.
+  for (int i = 1; i < 16; ++i) {
+    ASSERT_STATUS_OK(restored_state.UpdateMemoryPatternGroupCache(small_feeds, MemoryPatternGroup{}));
+    ASSERT_TRUE(restored_state.ResetMemoryPatternGroup(large_feeds));
+  }
+  ASSERT_STATUS_OK(restored_state.UpdateMemoryPatternGroupCache(small_feeds, MemoryPatternGroup{}));
+  ASSERT_FALSE(restored_state.ResetMemoryPatternGroup(large_feeds));
+  ASSERT_NE(restored_state.GetMemoryPatternGroup(small_feeds, feed_idxs, inferred_shapes), nullptr);
+#endif
+
+  std::filesystem::remove(pattern_file);
+}
+
+TEST_F(ExecutionFrameTest, StaticMemoryPlanningTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto x1_type = make_type({1, 2}), x2_type = make_type({2, 2}), x3_type = make_type({2, 3});
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &x1_type),
+      input_def2("X2", &x2_type),
+      input_def3("X3", &x3_type),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  // shape inference makes the shapes of T1 and T2 static as well
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsStaticMemoryPlanning, "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  state.ResolveMemoryPatternFlag();
+
+  const auto& stats = state.GetStaticMemoryPlanStats();
+  EXPECT_EQ(stats.planned_peak_size, 2u * kAllocAlignment);
+  EXPECT_LE(stats.planned_peak_size, stats.traced_peak_size);
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+  int x1_idx = -1, x2_idx = -1, x3_idx = -1, t1_idx = -1, t2_idx = -1;
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X1", x1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X2", x2_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X3", x3_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T1", t1_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T2", t2_idx));
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  OrtValue v1, v2, v3;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{1, 2}, std::vector<float>(2, 1.0f), &v1);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+
+  // the pattern is available before anything has run
+  const InlinedHashMap<int, TensorShape>* inferred_shapes = nullptr;
+  const auto* group = state.GetMemoryPatternGroup(AsSpan({v1, v2, v3}), AsSpan({x1_idx, x2_idx, x3_idx}),
+                                                  inferred_shapes);
+  ASSERT_NE(group, nullptr);
+  const auto* pattern = group->GetPatterns(cpu_allocator->Info().device);
+  ASSERT_NE(pattern, nullptr);
+  ASSERT_NE(pattern->GetBlock(t1_idx), nullptr);
+  ASSERT_NE(pattern->GetBlock(t2_idx), nullptr);
+  EXPECT_EQ(pattern->PeakSize(), stats.planned_peak_size);
+}
+
+TEST_F(ExecutionFrameTest, MemoryBudgetTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto x1_type = make_type({1, 2}), x2_type = make_type({2, 2}), x3_type = make_type({2, 3});
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &x1_type),
+      input_def2("X2", &x2_type),
+      input_def3("X3", &x3_type),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  // T1 and T2 are live at the same time
+  const size_t peak_size = 2 * kAllocAlignment;
+
+  {
+    SessionOptions sess_options;
+    ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsMemoryBudgetBytes,
+                                                                std::to_string(peak_size).c_str()));
+    SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                       DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+    ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+    const auto& report = state.GetMemoryBudgetReport();
+    EXPECT_EQ(report.budget, peak_size);
+    EXPECT_EQ(report.peak_size, peak_size);
+    EXPECT_TRUE(report.within_budget);
+
+    // the budget implies static memory planning
+    state.ResolveMemoryPatternFlag();
+    EXPECT_EQ(state.GetStaticMemoryPlanStats().planned_peak_size, peak_size);
+  }
+
+  {
+    SessionOptions sess_options;
+    ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsMemoryBudgetBytes,
+                                                                std::to_string(peak_size - 1).c_str()));
+    SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                       DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+    auto status = state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager);
+    ASSERT_FALSE(status.IsOK());
+    EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("exceeds the budget"));
+    EXPECT_FALSE(state.GetMemoryBudgetReport().within_budget);
+  }
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
@@ -6,8 +6,10 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <filesystem>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <thread>
 #include <fstream>
 
@@ -434,6 +436,99 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, StateTensors) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StateTensors";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsStateTensors, "Y:X"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<std::string> output_names{"Y"};
+  RunOptions run_options;
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  // X is the Y of the previous run.
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {1.0f, 8.0f, 27.0f, 64.0f, 125.0f, 216.0f});
+
+  // the state is kept when the output is not requested, and a fed input replaces it.
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, std::vector<std::string>{}, &fetches));
+  ASSERT_TRUE(fetches.empty());
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  // after a reset X must be fed again.
+  RunOptions reset_options;
+  ASSERT_STATUS_OK(reset_options.config_options.AddConfigEntry(kOrtRunOptionsConfigResetStateTensors, "1"));
+  fetches.clear();
+  ASSERT_FALSE(session_object.Run(reset_options, NameMLValMap{}, output_names, &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, InvalidStateTensors) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InvalidStateTensors";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsStateTensors, "Y:Z"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  auto status = session_object.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_NE(status.ErrorMessage().find("is not an input of the graph"), std::string::npos);
+}
+
+TEST(InferenceSessionTests, LoraAdapters) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.LoraAdapters";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue adapter_x;
+  CreateMLValue<float>(allocator, dims_mul_x, {2.0f, 2.0f, 2.0f, 3.0f, 3.0f, 3.0f}, &adapter_x);
+  const std::vector<std::string> adapter_inputs{"X"};
+  ASSERT_STATUS_OK(session_object.AddLoraAdapter("a", adapter_inputs, std::vector<OrtValue>{adapter_x}));
+
+  // an adapter input can not be a graph output.
+  const std::vector<std::string> invalid_inputs{"Y"};
+  ASSERT_FALSE(session_object.AddLoraAdapter("b", invalid_inputs, std::vector<OrtValue>{adapter_x}).IsOK());
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigLoraAdapter, "a"));
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {4.0f, 4.0f, 4.0f, 9.0f, 9.0f, 9.0f});
+
+  // a fed input takes precedence over the adapter.
+  OrtValue x;
+  CreateMLValue<float>(allocator, dims_mul_x, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{{"X", x}}, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  ASSERT_STATUS_OK(session_object.RemoveLoraAdapter("a"));
+  fetches.clear();
+  auto status = session_object.Run(run_options, NameMLValMap{}, output_names, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_NE(status.ErrorMessage().find("is not registered"), std::string::npos);
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -680,6 +775,89 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
 #endif
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerNodeSummary) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerNodeSummary";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_node_summary_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingNodeSummary, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  // the node events have the memory deltas
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string profile_content((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+  EXPECT_NE(profile_content.find("allocated_bytes"), std::string::npos);
+  EXPECT_NE(profile_content.find("peak_increase_bytes"), std::string::npos);
+
+  // the summary has a header and a line per node of the model, which ran twice
+  ASSERT_EQ(profile_file.substr(profile_file.size() - 5), ".json");
+  std::ifstream summary(profile_file.substr(0, profile_file.size() - 5) + "_summary.csv");
+  ASSERT_TRUE(summary);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(summary, line);) {
+    lines.push_back(line);
+  }
+
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_EQ(lines[0].rfind("node,op_name,provider,count,cpu_time_us", 0), 0u);
+  EXPECT_NE(lines[1].find(",Mul,CPUExecutionProvider,2,"), std::string::npos);
+}
+
+TEST(InferenceSessionTests, ChainParallelSections) {
+  SessionOptions so;
+  so.session_logid = "ChainParallelSections";
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsChainParallelSections, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+}
+
+TEST(InferenceSessionTests, GetThreadPoolStatistics) {
+  SessionOptions so;
+  so.session_logid = "GetThreadPoolStatistics";
+  so.intra_op_param.thread_pool_size = 2;
+
+  InferenceSession session_disabled(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_disabled.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_disabled.Initialize());
+  std::string json;
+  ASSERT_STATUS_NOT_OK(session_disabled.GetThreadPoolStatistics(json));
+
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_thread_pool_statistics");
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // queried while profiling, one entry per thread of the intra-op pool
+  ASSERT_STATUS_OK(session_object.GetThreadPoolStatistics(json));
+  ASSERT_NE(json.find("\"intra_op\":[{"), std::string::npos);
+  ASSERT_NE(json.find("\"steal_rate\""), std::string::npos);
+  ASSERT_NE(json.find("\"idle_percentage\""), std::string::npos);
+  ASSERT_NE(json.find("\"avg_run_us\""), std::string::npos);
+  session_object.EndProfiling();
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions2) {
   SessionOptions so;
 
@@ -806,6 +984,284 @@ TEST(InferenceSessionTests, CheckRunProfilerStartTime) {
   ASSERT_TRUE(before_start_time <= profiling_start_time && profiling_start_time <= after_start_time);
 }
 
+TEST(InferenceSessionTests, CheckKernelStatistics) {
+  SessionOptions so;
+  so.session_logid = "CheckKernelStatistics";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsEnableKernelStatistics, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // no profile file is written for kernel statistics
+  ASSERT_FALSE(session_object.GetProfiling().IsEnabled());
+
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetKernelStatistics(/*reset*/ true, json));
+  EXPECT_NE(json.find("\"op_type\":\"Mul\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"provider\":\"CPUExecutionProvider\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"count\":3"), std::string::npos) << json;
+  // 3 float outputs of 3x2
+  EXPECT_NE(json.find("\"output_bytes\":72"), std::string::npos) << json;
+
+  ASSERT_STATUS_OK(session_object.GetKernelStatistics(/*reset*/ false, json));
+  EXPECT_EQ(json, "[]");
+
+  SessionOptions so_disabled;
+  InferenceSession session_disabled(so_disabled, GetEnvironment());
+  ASSERT_STATUS_OK(session_disabled.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_disabled.Initialize());
+  ASSERT_STATUS_NOT_OK(session_disabled.GetKernelStatistics(/*reset*/ false, json));
+}
+
+TEST(InferenceSessionTests, Warmup) {
+  SessionOptions so;
+  so.session_logid = "Warmup";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsEnableKernelStatistics, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+
+  RunOptions run_options;
+  const std::vector<std::string> input_names{"X"};
+  const std::vector<TensorShapeVector> shapes{{3, 2}, {4, 2}};
+  ASSERT_STATUS_NOT_OK(session_object.Warmup(run_options, input_names, shapes));
+
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_STATUS_OK(session_object.Warmup(run_options, input_names, shapes));
+
+  // each shape set is run twice
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetKernelStatistics(/*reset*/ true, json));
+  EXPECT_NE(json.find("\"count\":4"), std::string::npos) << json;
+
+  // the session still computes the right results afterwards
+  RunModel(session_object, run_options);
+
+  const std::vector<std::string> unknown_input_names{"unknown"};
+  ASSERT_STATUS_NOT_OK(session_object.Warmup(run_options, unknown_input_names, shapes));
+  const std::vector<std::string> two_input_names{"X", "X"};
+  const std::vector<TensorShapeVector> one_shape{{3, 2}};
+  ASSERT_STATUS_NOT_OK(session_object.Warmup(run_options, two_input_names, one_shape));
+}
+
+TEST(InferenceSessionTests, RunBatch) {
+  SessionOptions so;
+  so.session_logid = "RunBatch";
+  so.intra_op_param.thread_pool_size = 2;
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  constexpr int num_requests = 4;
+  std::vector<NameMLValMap> feeds(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    const float value = static_cast<float>(i + 1);
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                         std::vector<float>(6, value), &ml_value);
+    feeds[i].emplace("X", ml_value);
+  }
+
+  RunOptions run_options;
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> fetches;
+  ASSERT_STATUS_OK(session_object.RunBatch(run_options, feeds, output_names, fetches));
+  ASSERT_EQ(fetches.size(), static_cast<size_t>(num_requests));
+  for (int i = 0; i < num_requests; ++i) {
+    const float value = static_cast<float>(i + 1);
+    VerifyOutputs(fetches[i], {3, 2}, std::vector<float>(6, value * value));
+  }
+
+  // a failing request fails the batch
+  feeds[2].clear();
+  feeds[2].emplace("unknown", feeds[0].at("X"));
+  ASSERT_STATUS_NOT_OK(session_object.RunBatch(run_options, feeds, output_names, fetches));
+}
+
+TEST(InferenceSessionTests, RunPrepared) {
+  SessionOptions so;
+  so.session_logid = "RunPrepared";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ASSERT_STATUS_OK(session_object.PrepareRun(feed_names, output_names, feeds_fetches_manager));
+
+  RunOptions run_options;
+  for (int i = 1; i <= 3; ++i) {
+    const float value = static_cast<float>(i);
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                         std::vector<float>(6, value), &feeds[0]);
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.RunPrepared(run_options, *feeds_fetches_manager, feeds, fetches));
+    VerifyOutputs(fetches, {3, 2}, std::vector<float>(6, value * value));
+  }
+
+  const std::vector<std::string> unknown_names{"unknown"};
+  ASSERT_STATUS_NOT_OK(session_object.PrepareRun(unknown_names, output_names, feeds_fetches_manager));
+}
+
+// the MatMul parallelizes over the intra-op pool that runs the requests, and there are more requests than threads.
+TEST(InferenceSessionTests, RunBatchWithParallelKernel) {
+  constexpr int64_t dim = 256;
+  const PathString model_file_name = ORT_TSTR("run_batch_parallel_kernel_test.onnx");
+  {
+    onnxruntime::Model model("run_batch_parallel_kernel", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+    auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+    auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+    graph.AddNode("matmul", "MatMul", "", {&a, &b}, {&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  SessionOptions so;
+  so.session_logid = "RunBatchWithParallelKernel";
+  so.intra_op_param.thread_pool_size = 2;
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // A is all ones so each element of the output is the sum of a column of B.
+  OrtValue a_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {dim, dim},
+                       std::vector<float>(dim * dim, 1.f), &a_value);
+
+  constexpr int num_requests = 8;
+  std::vector<NameMLValMap> feeds(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    OrtValue b_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {dim, dim},
+                         std::vector<float>(dim * dim, static_cast<float>(i)), &b_value);
+    feeds[i].emplace("A", a_value);
+    feeds[i].emplace("B", b_value);
+  }
+
+  RunOptions run_options;
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> fetches;
+  ASSERT_STATUS_OK(session_object.RunBatch(run_options, feeds, output_names, fetches));
+  ASSERT_EQ(fetches.size(), static_cast<size_t>(num_requests));
+  for (int i = 0; i < num_requests; ++i) {
+    VerifyOutputs(fetches[i], {dim, dim}, std::vector<float>(dim * dim, static_cast<float>(i * dim)));
+  }
+
+  std::filesystem::remove(model_file_name);
+}
+
+TEST(InferenceSessionTests, KernelStatisticsPercentiles) {
+  profiling::KernelStatistics kernel_statistics;
+  auto& stats = kernel_statistics.GetOrAddOpStats("Op", "Provider");
+  EXPECT_EQ(&stats, &kernel_statistics.GetOrAddOpStats("Op", "Provider"));
+
+  // 98 fast calls and 2 slow ones
+  for (int i = 0; i < 98; ++i) {
+    stats.Record(1000, 16);
+  }
+  stats.Record(1000000, 16);
+  stats.Record(1000000, 16);
+
+  auto summaries = kernel_statistics.GetSummaries();
+  ASSERT_EQ(summaries.size(), 1u);
+  const auto& summary = summaries[0];
+  EXPECT_EQ(summary.count, 100u);
+  EXPECT_EQ(summary.total_output_bytes, 1600u);
+  EXPECT_EQ(summary.max_ns, 1000000u);
+  // values are reported at the middle of their bucket, which is within 1/8 of the recorded value.
+  EXPECT_NEAR(static_cast<double>(summary.p50_ns), 1000.0, 1000.0 / 8);
+  EXPECT_NEAR(static_cast<double>(summary.p99_ns), 1000000.0, 1000000.0 / 8);
+
+  for (uint64_t value : {0ull, 15ull, 16ull, 1000ull, 123456789ull, ~0ull}) {
+    const auto bucket = profiling::KernelStatistics::GetBucketIndex(value);
+    ASSERT_LT(bucket, profiling::KernelStatistics::kNumBuckets);
+    EXPECT_EQ(profiling::KernelStatistics::GetBucketIndex(profiling::KernelStatistics::GetBucketValue(bucket)), bucket);
+  }
+}
+
+TEST(InferenceSessionTests, RequestBatching) {
+  onnxruntime::Model model("request_batching", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("neg", "Neg", "", {&input}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+  PathString model_file_name = ORT_TSTR("request_batching_test.onnx");
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RequestBatching";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsEnableKernelStatistics, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsRequestBatchingMaxBatchSize, "6"));
+  // long enough that the batch is only run once it is full.
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsRequestBatchingMaxDelayUs, "10000000"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // requests with 1, 2 and 3 rows fill the batch.
+  std::vector<std::thread> threads;
+  for (int64_t rows = 1; rows <= 3; ++rows) {
+    threads.emplace_back([&session_object, rows]() {
+      std::vector<float> values(static_cast<size_t>(rows) * 2);
+      std::iota(values.begin(), values.end(), static_cast<float>(rows * 10));
+      OrtValue input_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {rows, 2}, values,
+                           &input_value);
+
+      RunOptions run_options;
+      const char* input_names[] = {"X"};
+      const OrtValue* inputs[] = {&input_value};
+      const char* output_names[] = {"Y"};
+      OrtValue* outputs[] = {nullptr};
+      ASSERT_STATUS_OK(session_object.Run(run_options, input_names, inputs, output_names, outputs));
+
+      std::unique_ptr<OrtValue> output_value(outputs[0]);
+      const auto& output_tensor = output_value->Get<Tensor>();
+      ASSERT_EQ(output_tensor.Shape(), TensorShape({rows, 2}));
+      for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(output_tensor.Data<float>()[i], -values[i]);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // all requests were served by a single run of the model.
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetKernelStatistics(/*reset*/ false, json));
+  EXPECT_NE(json.find("\"count\":1,"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"output_bytes\":48"), std::string::npos) << json;
+
+  // the model used by the other tests has a fixed first dimension.
+  InferenceSession static_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(static_session.Load(MODEL_URI));
+  ASSERT_STATUS_NOT_OK(static_session.Initialize());
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -1073,6 +1529,52 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingOutputBufferAllocator) {
+  SessionOptions so;
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+  OrtValue input;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &input);
+  ASSERT_STATUS_OK(io_binding->BindInput("X", input));
+
+  // hand out consecutive slots of a ring buffer
+  std::vector<float> ring(12);
+  size_t next_slot = 0;
+  std::vector<TensorShape> requested_shapes;
+  auto allocator = [&](const TensorShape& shape, size_t size_in_bytes, void*& buffer) -> Status {
+    requested_shapes.push_back(shape);
+    ORT_RETURN_IF_NOT(size_in_bytes == 6 * sizeof(float), "Unexpected size ", size_in_bytes);
+    buffer = ring.data() + (next_slot++ % 2) * 6;
+    return Status::OK();
+  };
+
+  OrtMemoryInfo cpu_location(CPU, OrtDeviceAllocator);
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y", cpu_location, allocator));
+  ASSERT_STATUS_NOT_OK(io_binding->BindOutput("not_an_output", cpu_location, allocator));
+
+  const std::vector<float> expected_values = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (size_t run = 0; run < 2; ++run) {
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, *io_binding));
+    ASSERT_EQ(requested_shapes.size(), run + 1);
+    EXPECT_EQ(requested_shapes.back(), TensorShape({3, 2}));
+
+    const auto& output = io_binding->GetOutputs()[0].Get<Tensor>();
+    ASSERT_EQ(output.Data<float>(), ring.data() + run * 6);
+    ASSERT_TRUE(std::equal(expected_values.begin(), expected_values.end(), ring.begin() + run * 6));
+  }
+
+  // binding a device replaces the allocator
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y"));
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, *io_binding));
+  EXPECT_EQ(requested_shapes.size(), 2u);
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -3008,5 +3510,236 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
 }
 #endif
 
+TEST(InferenceSessionTests, ExecutionPlanSnapshot) {
+  const std::string snapshot_file = "inference_session_test_execution_plan.snapshot";
+  std::filesystem::remove(snapshot_file);
+
+  SessionOptions so;
+  so.session_logid = "ExecutionPlanSnapshot";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsExecutionPlanSnapshotFilePath,
+                                                    snapshot_file.c_str()));
+
+  // the first session runs the planner and saves the plan
+  InferenceSessionWrapper session_1{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_1.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_1.Initialize());
+  ASSERT_TRUE(std::filesystem::exists(snapshot_file));
+
+  // the second session restores it
+  InferenceSessionWrapper session_2{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_2.Initialize());
+
+  const auto& plan_1 = *session_1.GetSessionState().GetExecutionPlan();
+  const auto& plan_2 = *session_2.GetSessionState().GetExecutionPlan();
+  ASSERT_EQ(plan_1.allocation_plan.size(), plan_2.allocation_plan.size());
+  for (size_t i = 0; i < plan_1.allocation_plan.size(); ++i) {
+    EXPECT_EQ(plan_1.allocation_plan[i].alloc_kind, plan_2.allocation_plan[i].alloc_kind);
+    EXPECT_EQ(plan_1.allocation_plan[i].value_type, plan_2.allocation_plan[i].value_type);
+    EXPECT_EQ(plan_1.allocation_plan[i].location, plan_2.allocation_plan[i].location);
+    EXPECT_EQ(plan_1.allocation_plan[i].reused_buffer, plan_2.allocation_plan[i].reused_buffer);
+  }
+  ASSERT_EQ(plan_1.execution_plan.size(), plan_2.execution_plan.size());
+  for (size_t i = 0; i < plan_1.execution_plan.size(); ++i) {
+    ASSERT_EQ(plan_1.execution_plan[i]->steps_.size(), plan_2.execution_plan[i]->steps_.size());
+    for (size_t j = 0; j < plan_1.execution_plan[i]->steps_.size(); ++j) {
+      EXPECT_EQ(plan_1.execution_plan[i]->steps_[j]->ToString(), plan_2.execution_plan[i]->steps_[j]->ToString());
+    }
+  }
+  ASSERT_EQ(plan_1.release_actions.size(), plan_2.release_actions.size());
+  ASSERT_EQ(plan_1.node_release_list, plan_2.node_release_list);
+
+  RunOptions run_options;
+  RunModel(session_2, run_options);
+
+  // a truncated snapshot is ignored and the plan is created again
+  std::string header;
+  {
+    std::ifstream in(snapshot_file);
+    std::getline(in, header);
+  }
+  {
+    std::ofstream out(snapshot_file, std::ios::trunc);
+    out << header << "\n";
+  }
+  InferenceSessionWrapper session_3{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_3.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_3.Initialize());
+  RunModel(session_3, run_options);
+
+  std::filesystem::remove(snapshot_file);
+}
+
+// the outputs of a Split are planned as views of its input, and reused in place by the Relu consuming them.
+// the views must be restored from the snapshot or the Relus write to the wrong buffers.
+TEST(InferenceSessionTests, ExecutionPlanSnapshotWithViews) {
+  const PathString model_file_name = ORT_TSTR("execution_plan_snapshot_views_test.onnx");
+  {
+    onnxruntime::Model model("execution_plan_snapshot_views", false, ModelMetaData(), PathString(),
+                             IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                             DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto input_type;
+    input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+    ONNX_NAMESPACE::TypeProto split_type;
+    split_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    split_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    split_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+    split_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+    auto& abs = graph.GetOrCreateNodeArg("abs", &input_type);
+    auto& split_0 = graph.GetOrCreateNodeArg("split_0", &split_type);
+    auto& split_1 = graph.GetOrCreateNodeArg("split_1", &split_type);
+    auto& relu_0 = graph.GetOrCreateNodeArg("relu_0", &split_type);
+    auto& relu_1 = graph.GetOrCreateNodeArg("relu_1", &split_type);
+    auto& y = graph.GetOrCreateNodeArg("Y", &split_type);
+    graph.AddNode("abs", "Abs", "", {&x}, {&abs});
+    graph.AddNode("split", "Split", "", {&abs}, {&split_0, &split_1}).AddAttribute("axis", static_cast<int64_t>(1));
+    graph.AddNode("relu_0", "Relu", "", {&split_0}, {&relu_0});
+    graph.AddNode("relu_1", "Relu", "", {&split_1}, {&relu_1});
+    graph.AddNode("sub", "Sub", "", {&relu_0, &relu_1}, {&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  const std::string snapshot_file = "inference_session_test_execution_plan_views.snapshot";
+  std::filesystem::remove(snapshot_file);
+
+  auto run = [&model_file_name](const SessionOptions& so, std::vector<float>& output,
+                                const SequentialExecutionPlan** plan, std::unique_ptr<InferenceSessionWrapper>& session) {
+    session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+    ASSERT_STATUS_OK(session->Load(model_file_name));
+    ASSERT_STATUS_OK(session->Initialize());
+    *plan = session->GetSessionState().GetExecutionPlan();
+
+    OrtValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1, 4, 2},
+                         {1.f, -2.f, 3.f, -4.f, 5.f, -6.f, 7.f, -9.f}, &input_value);
+    NameMLValMap feeds{{"X", input_value}};
+    const std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session->Run(RunOptions{}, feeds, output_names, &fetches));
+    const auto& output_tensor = fetches[0].Get<Tensor>();
+    output.assign(output_tensor.Data<float>(), output_tensor.Data<float>() + output_tensor.Shape().Size());
+  };
+
+  SessionOptions so;
+  so.session_logid = "ExecutionPlanSnapshotWithViews";
+  so.graph_optimization_level = TransformerLevel::Default;
+
+  // reference without a snapshot
+  std::vector<float> expected;
+  const SequentialExecutionPlan* plan_0 = nullptr;
+  std::unique_ptr<InferenceSessionWrapper> session_0;
+  run(so, expected, &plan_0, session_0);
+  ASSERT_EQ(expected, (std::vector<float>{-4.f, -4.f, -4.f, -5.f}));
+  ASSERT_TRUE(std::any_of(plan_0->allocation_plan.begin(), plan_0->allocation_plan.end(),
+                          [](const AllocPlanPerValue& value_plan) { return value_plan.view_of != -1; }));
+
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsExecutionPlanSnapshotFilePath,
+                                                    snapshot_file.c_str()));
+
+  // the first session saves the plan and the second one restores it
+  std::vector<float> output_1, output_2;
+  const SequentialExecutionPlan* plan_1 = nullptr;
+  const SequentialExecutionPlan* plan_2 = nullptr;
+  std::unique_ptr<InferenceSessionWrapper> session_1, session_2;
+  run(so, output_1, &plan_1, session_1);
+  ASSERT_TRUE(std::filesystem::exists(snapshot_file));
+  run(so, output_2, &plan_2, session_2);
+
+  ASSERT_EQ(plan_1->allocation_plan.size(), plan_2->allocation_plan.size());
+  for (size_t i = 0; i < plan_1->allocation_plan.size(); ++i) {
+    EXPECT_EQ(plan_1->allocation_plan[i].reused_buffer, plan_2->allocation_plan[i].reused_buffer);
+    EXPECT_EQ(plan_1->allocation_plan[i].view_of, plan_2->allocation_plan[i].view_of);
+  }
+  EXPECT_EQ(output_1, expected);
+  EXPECT_EQ(output_2, expected);
+
+  std::filesystem::remove(snapshot_file);
+  std::filesystem::remove(model_file_name);
+}
+
+// the frozen initializers and pre-packed weights must give the same results as the regular ones, in every run
+TEST(InferenceSessionTests, FreezeImmutableState) {
+  constexpr int64_t M = 4, K = 64, N = 32;
+  std::string model_data;
+  {
+    onnxruntime::Model model("freeze_immutable_state", false, ModelMetaData(), PathString(),
+                             IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                             DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto input_type;
+    input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(M);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+    ONNX_NAMESPACE::TypeProto output_type;
+    output_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    output_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(M);
+    output_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(N);
+
+    // the constant B of MatMul is pre-packed by the CPU kernel
+    ONNX_NAMESPACE::TensorProto b;
+    b.set_name("B");
+    b.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    b.add_dims(K);
+    b.add_dims(N);
+    for (int64_t i = 0; i < K * N; ++i) {
+      b.add_float_data(static_cast<float>(i % 7 - 3) * 0.25f);
+    }
+    graph.AddInitializedTensor(b);
+
+    auto& a = graph.GetOrCreateNodeArg("A", &input_type);
+    auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+    graph.AddNode("matmul", "MatMul", "", {&a, graph.GetNodeArg("B")}, {&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+    model.ToProto().SerializeToString(&model_data);
+  }
+
+  std::vector<float> a_data(M * K);
+  for (size_t i = 0; i < a_data.size(); ++i) {
+    a_data[i] = static_cast<float>(i % 5) - 2.f;
+  }
+
+  auto run = [&](bool freeze_immutable_state, std::vector<std::vector<float>>& outputs) {
+    SessionOptions so;
+    so.session_logid = "FreezeImmutableState";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsFreezeImmutableState,
+                                                      freeze_immutable_state ? "1" : "0"));
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+
+    // the initializers only have an allocator of their own when the state is frozen
+    const auto& session_state = session.GetSessionState();
+    const OrtDevice cpu_device;
+    EXPECT_EQ(session_state.GetInitializerAllocator(cpu_device) != session_state.GetAllocator(cpu_device),
+              freeze_immutable_state);
+
+    for (auto& output : outputs) {
+      OrtValue input_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {M, K}, a_data, &input_value);
+      NameMLValMap feeds{{"A", input_value}};
+      const std::vector<std::string> output_names{"Y"};
+      std::vector<OrtValue> fetches;
+      ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+      const auto& output_tensor = fetches[0].Get<Tensor>();
+      output.assign(output_tensor.Data<float>(), output_tensor.Data<float>() + output_tensor.Shape().Size());
+    }
+  };
+
+  std::vector<std::vector<float>> expected(3), outputs(3);
+  run(false, expected);
+  run(true, outputs);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    EXPECT_EQ(expected[i], expected[0]);
+    EXPECT_EQ(outputs[i], expected[0]) << "run " << i;
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -272,7 +272,7 @@ TEST(TransformerTest, InsertCastNodeTwice) {
 }
 
 // Test that a node processing fp16 input with a subgraph does not get forced to fp32,
-// and that the subgraph is processed to insert casts
+// and that the fp16 nodes of the subgraph with CPU kernels are left alone
 TEST(TransformerTest, Fp16NodeWithSubgraph) {
   auto model_uri = MODEL_FOLDER ORT_TSTR("fp16model_loop.onnx");
 
@@ -306,7 +306,8 @@ TEST(TransformerTest, Fp16NodeWithSubgraph) {
   std::map<std::string, int> new_subgraph_ops = CountOpsInGraph(subgraph, recurse_into_subgraphs);
 
   EXPECT_EQ(new_graph_ops.find("Cast"), new_graph_ops.cend()) << "Main graph should not have been altered.";
-  EXPECT_EQ(new_subgraph_ops.find("Cast")->second, 3) << "'Add' node in subgraph should have had Casts added";
+  EXPECT_EQ(new_subgraph_ops.find("Cast"), new_subgraph_ops.cend())
+      << "'Add' node in subgraph has an fp16 CPU kernel and should not have had Casts added";
 }
 
 TEST(TransformerTest, IsIsolatedFp16NodeOnCpuTest) {
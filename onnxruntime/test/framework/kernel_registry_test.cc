@@ -6,7 +6,10 @@
 #include <gtest/gtest.h>
 
 #include "asserts.h"
+#include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
 
 namespace onnxruntime::test {
 
@@ -101,4 +104,49 @@ TEST(KernelRegistryTests, two_versions4) {
   ASSERT_STATUS_NOT_OK(RegKernels(r, function_table, CreateFakeKernel));
 }
 
+// Nodes with the same signature share the kernel match, and registering a kernel updates the matches.
+TEST(KernelRegistryTests, find_kernel_for_nodes_with_same_signature) {
+  Model model("graph", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  auto add_elu_node = [&graph](const std::string& name, ONNX_NAMESPACE::TensorProto_DataType elem_type) -> Node& {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    auto& input = graph.GetOrCreateNodeArg(name + "_in", &type);
+    auto& output = graph.GetOrCreateNodeArg(name + "_out", &type);
+    return graph.AddNode(name, "Elu", "", {&input}, {&output});
+  };
+  const Node& float_node_1 = add_elu_node("float_node_1", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  const Node& float_node_2 = add_elu_node("float_node_2", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  const Node& double_node = add_elu_node("double_node", ONNX_NAMESPACE::TensorProto_DataType_DOUBLE);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistry r;
+  std::vector<std::unique_ptr<KernelDef>> function_table;
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+
+  const OpSchemaKernelTypeStrResolver kernel_type_str_resolver{};
+  const KernelCreateInfo* float_kernel_1 = nullptr;
+  const KernelCreateInfo* float_kernel_2 = nullptr;
+  const KernelCreateInfo* double_kernel = nullptr;
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node_1, kCpuExecutionProvider, kernel_type_str_resolver, &float_kernel_1));
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node_2, kCpuExecutionProvider, kernel_type_str_resolver, &float_kernel_2));
+  ASSERT_NE(float_kernel_1, nullptr);
+  EXPECT_EQ(float_kernel_1, float_kernel_2);
+
+  for (int i = 0; i < 2; ++i) {
+    const auto status = r.TryFindKernel(double_node, kCpuExecutionProvider, kernel_type_str_resolver, &double_kernel);
+    ASSERT_FALSE(status.IsOK());
+    EXPECT_NE(status.ErrorMessage().find("double_node"), std::string::npos);
+    EXPECT_EQ(double_kernel, nullptr);
+  }
+
+  function_table.clear();
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+  ASSERT_STATUS_OK(r.TryFindKernel(double_node, kCpuExecutionProvider, kernel_type_str_resolver, &double_kernel));
+  ASSERT_NE(double_kernel, nullptr);
+  EXPECT_NE(double_kernel, float_kernel_1);
+}
+
 }  // namespace onnxruntime::test
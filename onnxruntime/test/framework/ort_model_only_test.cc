@@ -533,6 +533,13 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModel) {
   RunOrtModel(test_info);
 }
 
+// Read the model file into a buffer instead of memory mapping it
+TEST(OrtModelOnlyTests, LoadOrtFormatModelNoMmap) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsUseMmapForOrtModel, "0"));
+  RunOrtModel(test_info);
+}
+
 // Load the model from a buffer instead of a file path
 TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBuffer) {
   OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
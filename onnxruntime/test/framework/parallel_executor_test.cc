@@ -1,11 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <sstream>
+
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/framework/parallel_node_scheduler.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 
 #include "gtest/gtest.h"
 
@@ -117,6 +124,68 @@ TEST(ParallelExecutor, TestStatusPropagation) {
   }
 }
 
+// a CPU-only graph with independent branches should run through the ParallelNodeScheduler
+// and produce the same result on every run while the node costs are re-measured.
+TEST(ParallelExecutor, TestParallelNodeScheduler) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  onnxruntime::Model model("parallel_node_scheduler", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &float_tensor);
+  auto& abs_out = graph.GetOrCreateNodeArg("abs_out", &float_tensor);
+  auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("relu", "Relu", "relu", {&x}, {&relu_out});
+  graph.AddNode("abs", "Abs", "abs", {&x}, {&abs_out});
+  graph.AddNode("neg", "Neg", "neg", {&x}, {&neg_out});
+  graph.AddNode("sum", "Sum", "sum", {&relu_out, &abs_out, &neg_out}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_str;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_str));
+  std::stringstream model_stream(model_str);
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.TestParallelNodeScheduler";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* scheduler = session.GetSessionState().GetParallelNodeScheduler();
+  ASSERT_NE(scheduler, nullptr);
+
+  std::vector<int64_t> dims = {2, 3};
+  std::vector<float> values = {-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+  // relu(x) + abs(x) - x
+  std::vector<float> expected_values = {4.0f, 2.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+  std::vector<std::string> output_names{"Y"};
+
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape(dims));
+    auto output_values = output.DataAsSpan<float>();
+    ASSERT_TRUE(std::equal(output_values.begin(), output_values.end(), expected_values.begin()));
+  }
+
+  for (const auto& node : session.GetGraph().Nodes()) {
+    EXPECT_GT(scheduler->GetNodeCost(node.Index()), 0);
+  }
+}
+
 class ParallelExecutorThreadPoolTest : public testing::TestWithParam<int> {
 };
 
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
 #include <iostream>
 #include <absl/base/config.h>
 
@@ -10,7 +11,11 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/cold_initializer_evictor.h"
+#include "core/framework/frozen_state_allocator.h"
+#include "core/framework/node_latency_monitor.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -389,8 +394,24 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  Status RestorePrePackedBuffers(const Tensor& tensor, int input_idx,
+                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                 gsl::span<const size_t> prepacked_buffer_sizes,
+                                 /*out*/ bool& used_prepacked_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    used_prepacked_buffers = prepacked_buffers.size() == 1 && prepacked_buffer_sizes[0] == 8;
+    if (used_prepacked_buffers) {
+      weight_packed_ = std::move(prepacked_buffers[0]);
+      ++restore_pre_packed_weight_calls_count;
+    }
+    return Status::OK();
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int restore_pre_packed_weight_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
 };
 
@@ -983,6 +1004,103 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + pre-packed weights file = the second session uses the weights persisted by the first
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, PersistedPrePackedWeights) {
+  const PathString file_path = ORT_TSTR("session_state_test_prepacked_weights.bin");
+  std::filesystem::remove(file_path);
+
+  SessionOptions sess_options;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsPrepackedWeightsFilePath] = ToUTF8String(file_path);
+
+  auto finalize_session_state = [&](std::unique_ptr<Model>& model, std::unique_ptr<SessionState>& session_state) {
+    model = std::make_unique<Model>("graph_main", false, ModelMetaData(), PathString(),
+                                    IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                    std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                                    DefaultLoggingManager().DefaultLogger());
+    CreateSimpleGraph(model->MainGraph());
+    PlaceAllNodesToCPUEP(model->MainGraph());
+    session_state = std::make_unique<SessionState>(model->MainGraph(), execution_providers, tp.get(), nullptr, dtm,
+                                                   DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+    ASSERT_STATUS_OK(session_state->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+  };
+
+  // first session packs the weight and writes it to the file
+  std::unique_ptr<Model> model_1;
+  std::unique_ptr<SessionState> session_state_1;
+  finalize_session_state(model_1, session_state_1);
+  const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_1->GetKernel(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 1);
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(session_state_1->GetUsedPersistedPrePackedWeightCounter(), static_cast<size_t>(0));
+  ASSERT_TRUE(std::filesystem::exists(file_path));
+
+  // second session uses the weight from the file without calling PrePack()
+  std::unique_ptr<Model> model_2;
+  std::unique_ptr<SessionState> session_state_2;
+  finalize_session_state(model_2, session_state_2);
+  kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_2->GetKernel(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 0);
+  ASSERT_EQ(kernel->restore_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(session_state_2->GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(session_state_2->GetUsedPersistedPrePackedWeightCounter(), static_cast<size_t>(1));
+
+  const float* restored = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+  EXPECT_EQ(restored[0], 1.2345f);
+  EXPECT_EQ(restored[1], 1.2345f * 2.f);
+
+  session_state_2.reset();
+  std::filesystem::remove(file_path);
+}
+
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, ParallelInitialization) {
+  SessionOptions sess_options;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsParallelInitialization] = "1";
+
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  // a chain of nodes that all consume the same initializer, which is released once every node has packed it.
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  constexpr int num_nodes = 16;
+  NodeArg* input_arg = &graph.GetOrCreateNodeArg("input", &type);
+  NodeArg* weight_arg = &graph.GetOrCreateNodeArg("weight", &type);
+  for (int i = 0; i < num_nodes; ++i) {
+    NodeArg* output_arg = &graph.GetOrCreateNodeArg("output_" + std::to_string(i), &type);
+    graph.AddNode("node_" + std::to_string(i), "PrePackingTest", "node", {input_arg, weight_arg}, {output_arg});
+    input_arg = output_arg;
+  }
+
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(1);
+  tensor.add_float_data(1.0f);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_name("weight");
+  graph.AddInitializedTensor(tensor);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  PlaceAllNodesToCPUEP(graph);
+  SessionState session_state(graph, execution_providers, tp.get(), nullptr, dtm,
+                             DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager));
+
+  ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(num_nodes));
+  for (const auto& node : graph.Nodes()) {
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(node.Index()));
+    ASSERT_NE(kernel, nullptr);
+    ASSERT_EQ(kernel->prepack_calls_count, 1);
+  }
+  ASSERT_TRUE(session_state.GetConstantInitializedTensors().empty());
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -991,5 +1109,153 @@ INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                                          PrepackingTestParam{true, true}));
 #endif
 
+TEST(SessionStateTest, SharedInitializerStore) {
+  SharedInitializerStore store;
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  auto create_value = [&cpu_allocator](std::vector<float> values) {
+    OrtValue value;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({static_cast<int64_t>(values.size())}),
+                         cpu_allocator, value);
+    std::copy(values.begin(), values.end(), value.GetMutable<Tensor>()->MutableData<float>());
+    return value;
+  };
+
+  OrtValue shared = store.GetOrAdd(create_value({1.f, 2.f, 3.f}));
+  ASSERT_EQ(store.GetNumberOfElements(), 1u);
+
+  // the same data in another buffer resolves to the first one.
+  OrtValue duplicate = store.GetOrAdd(create_value({1.f, 2.f, 3.f}));
+  EXPECT_EQ(duplicate.Get<Tensor>().DataRaw(), shared.Get<Tensor>().DataRaw());
+  EXPECT_EQ(store.GetNumberOfElements(), 1u);
+
+  // different data or a different shape is not shared.
+  OrtValue different_data = store.GetOrAdd(create_value({1.f, 2.f, 4.f}));
+  EXPECT_NE(different_data.Get<Tensor>().DataRaw(), shared.Get<Tensor>().DataRaw());
+  OrtValue different_shape = store.GetOrAdd(create_value({1.f, 2.f}));
+  EXPECT_NE(different_shape.Get<Tensor>().DataRaw(), shared.Get<Tensor>().DataRaw());
+  EXPECT_EQ(store.GetNumberOfElements(), 3u);
+
+  // entries are released with the last value that uses them.
+  shared = OrtValue();
+  EXPECT_EQ(store.GetNumberOfElements(), 3u);
+  duplicate = OrtValue();
+  EXPECT_EQ(store.GetNumberOfElements(), 2u);
+}
+
+TEST(SessionStateTest, ColdInitializerEvictor) {
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  auto create_value = [&cpu_allocator](float fill_value) {
+    OrtValue value;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4096}), cpu_allocator, value);
+    auto data = value.GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    std::fill(data.begin(), data.end(), fill_value);
+    return value;
+  };
+
+  OrtValue hot = create_value(1.f);
+  OrtValue cold = create_value(2.f);
+  const Tensor& cold_tensor = cold.Get<Tensor>();
+  const bool can_release = Env::Default().ReleaseMemoryPages(cold_tensor.DataRaw(), cold_tensor.SizeInBytes());
+
+  ColdInitializerEvictor evictor(2);
+  const size_t hot_slot = evictor.Register(hot);
+  const size_t cold_slot = evictor.Register(cold);
+  // the same data is tracked once
+  EXPECT_EQ(evictor.Register(hot), hot_slot);
+  EXPECT_EQ(evictor.GetNumberOfTrackedInitializers(), 2u);
+
+  const size_t used[] = {hot_slot};
+  for (int run = 0; run < 6; ++run) {
+    evictor.MarkUsed(used);
+    evictor.OnRunEnd();
+  }
+
+  // only the unused initializer is released, and only once while it stays unused
+  EXPECT_EQ(evictor.GetNumberOfEvictions(), can_release ? 1u : 0u);
+
+  // the content is preserved
+  for (float value : cold_tensor.DataAsSpan<float>()) {
+    ASSERT_EQ(value, 2.f);
+  }
+
+  // a released initializer that is used again becomes resident and can be released again
+  const size_t used_again[] = {cold_slot};
+  evictor.MarkUsed(used_again);
+  for (int run = 0; run < 4; ++run) {
+    evictor.OnRunEnd();
+  }
+  EXPECT_EQ(evictor.GetNumberOfEvictions(), can_release ? 3u : 0u);
+}
+
+TEST(SessionStateTest, FrozenStateAllocator) {
+  FrozenStateAllocator allocator;
+
+  // small allocations share regions, large ones get their own
+  auto* small_a = static_cast<float*>(allocator.Alloc(16 * sizeof(float)));
+  auto* small_b = static_cast<float*>(allocator.Alloc(16 * sizeof(float)));
+  constexpr size_t kLargeCount = 1024 * 1024;
+  auto* large = static_cast<float*>(allocator.Alloc(kLargeCount * sizeof(float)));
+  ASSERT_NE(small_a, nullptr);
+  ASSERT_NE(small_b, nullptr);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(small_b) % 64, 0u);
+  std::fill(small_a, small_a + 16, 1.f);
+  std::fill(small_b, small_b + 16, 2.f);
+  std::fill(large, large + kLargeCount, 3.f);
+
+  // a released large allocation returns its pages
+  const size_t mapped_bytes = allocator.GetMappedBytes();
+  void* released = allocator.Alloc(kLargeCount * sizeof(float));
+  EXPECT_GT(allocator.GetMappedBytes(), mapped_bytes);
+  allocator.Free(released);
+  EXPECT_EQ(allocator.GetMappedBytes(), mapped_bytes);
+
+  ASSERT_STATUS_OK(allocator.Freeze());
+  EXPECT_TRUE(allocator.IsFrozen());
+  EXPECT_THROW(allocator.Alloc(16), OnnxRuntimeException);
+
+  // the content stays readable
+  EXPECT_EQ(small_a[15], 1.f);
+  EXPECT_EQ(small_b[0], 2.f);
+  EXPECT_EQ(large[kLargeCount - 1], 3.f);
+  allocator.Free(small_a);
+  allocator.Free(large);
+}
+
+TEST(SessionStateTest, NodeLatencyMonitor) {
+  NodeLatencyMonitor monitor(3, /*alert_factor*/ 5.0, /*min_alert_ns*/ 1000);
+  NodeLatencyMonitor::Outlier outlier{};
+
+  // no outliers during the warmup
+  EXPECT_FALSE(monitor.Record(0, 10000, outlier));
+  EXPECT_FALSE(monitor.Record(0, 1000000, outlier));
+  for (uint64_t i = 0; i < NodeLatencyMonitor::kWarmupRuns; ++i) {
+    EXPECT_FALSE(monitor.Record(1, 10000, outlier));
+    EXPECT_FALSE(monitor.Record(2, 100, outlier));
+  }
+  EXPECT_EQ(monitor.GetBaselineNs(1), 10000u);
+
+  // up to 5x the baseline is not an outlier
+  EXPECT_FALSE(monitor.Record(1, 50000, outlier));
+  EXPECT_EQ(monitor.GetBaselineNs(1), 12500u);
+
+  // the 1st and 2nd outliers are reported, the 3rd isn't. outliers enter the baseline clamped to 5x it.
+  EXPECT_TRUE(monitor.Record(1, 1000000, outlier));
+  EXPECT_EQ(outlier.baseline_ns, 12500u);
+  EXPECT_EQ(outlier.num_outliers, 1u);
+  EXPECT_EQ(monitor.GetBaselineNs(1), 12500u + (62500u - 12500u) / 16);
+  EXPECT_TRUE(monitor.Record(1, 1000000, outlier));
+  EXPECT_EQ(outlier.num_outliers, 2u);
+  EXPECT_FALSE(monitor.Record(1, 1000000, outlier));
+  EXPECT_TRUE(monitor.Record(1, 1000000, outlier));
+  EXPECT_EQ(outlier.num_outliers, 4u);
+  EXPECT_EQ(monitor.GetNumberOfOutliers(1), 4u);
+
+  // short kernels are not flagged below the minimum time
+  EXPECT_FALSE(monitor.Record(2, 900, outlier));
+  EXPECT_EQ(monitor.GetNumberOfOutliers(2), 0u);
+  EXPECT_EQ(monitor.GetNumberOfOutliers(0), 0u);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
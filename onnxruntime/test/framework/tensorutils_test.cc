@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
 #include "core/graph/onnx_protobuf.h"
 #include "test/util/include/asserts.h"
 #include "file_util.h"
@@ -9,6 +10,9 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <cstring>
+#include <numeric>
+
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -211,6 +215,37 @@ TEST(TensorProtoUtilsTest, UnpackTensorWithExternalData) {
   TestUnpackExternalTensor<bool>(TensorProto_DataType_BOOL, model_path);
 }
 
+#if !defined(__wasm__)
+TEST(TensorProtoUtilsTest, ReadExternalDataInChunks) {
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  TensorProto tensor_proto;
+  std::vector<int32_t> test_data(100);
+  std::iota(test_data.begin(), test_data.end(), 0);
+  CreateTensorWithExternalData<int32_t>(TensorProto_DataType_INT32, test_data, filename, tensor_proto);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+
+  // the size of the data is not a multiple of the chunk size
+  std::vector<int32_t> read_data(test_data.size());
+  size_t num_chunks = 0;
+  ASSERT_STATUS_OK(utils::ReadExternalDataInChunks(
+      Env::Default(), std::filesystem::path{}, tensor_proto, 64,
+      [&](size_t offset, gsl::span<const char> chunk) {
+        EXPECT_LE(chunk.size(), 64u);
+        std::memcpy(reinterpret_cast<char*>(read_data.data()) + offset, chunk.data(), chunk.size());
+        ++num_chunks;
+        return Status::OK();
+      }));
+
+  EXPECT_EQ(num_chunks, 7u);
+  if constexpr (endian::native != endian::little) {
+    ConvertEndianessForVector(read_data);
+  }
+  EXPECT_THAT(read_data, ::testing::ContainerEq(test_data));
+  EXPECT_FALSE(utils::HasExternalDataInMemory(tensor_proto));
+}
+#endif
+
 template <typename T>
 static NodeProto CreateConstantNode(const std::string& attrib_name, AttributeProto_AttributeType type,
                                     std::function<void(AttributeProto&)> add_data) {
@@ -4,12 +4,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <chrono>
+#include <filesystem>
 
 #include "core/common/common.h"
 #include "core/framework/tunable.h"
-#define TUNING_CONTEXT_IMPL
-#include "core/framework/tuning_context_impl.h"
-#undef TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#if !defined(ORT_MINIMAL_BUILD)
+#include "core/session/inference_session_utils.h"
+#endif
+#include "test/util/include/asserts.h"
 
 using namespace std::chrono_literals;
 
@@ -734,6 +738,49 @@ TEST(TuningContext, GetAndLoadTuningResults) {
 #endif
 }
 
+TEST(TuningContext, CpuTuningResultsValidation) {
+  CPUExecutionProvider ep{CPUExecutionProviderInfo{}};
+  auto* ctx = ep.GetTuningContext();
+  ASSERT_NE(ctx, nullptr);
+  ASSERT_FALSE(ctx->IsTunableOpEnabled());
+
+  auto trs = ctx->GetTuningResults();
+  ASSERT_EQ(trs.ep, kCpuExecutionProvider);
+  ASSERT_THAT(trs.validators, ::testing::Contains(::testing::Key("CPU_ISA")));
+  ASSERT_THAT(trs.validators, ::testing::Contains(::testing::Key("CPU_CORE_COUNT")));
+  ASSERT_STATUS_OK(ctx->LoadTuningResults(trs));
+
+  // The results tuned on a different CPU are rejected.
+  trs.validators["CPU_ISA"] = "OTHER_CPU";
+  ASSERT_FALSE(ctx->LoadTuningResults(trs).IsOK());
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(TuningContext, SaveAndParseTuningResultsFile) {
+  const std::filesystem::path file_path{ORT_TSTR("tuning_results_file_test.json")};
+  std::filesystem::remove(file_path);
+
+  std::vector<TuningResults> results;
+  bool file_found = true;
+  ASSERT_STATUS_OK(inference_session_utils::ParseTuningResultsFromFile(file_path, results, file_found));
+  ASSERT_FALSE(file_found);
+
+  TuningResults trs;
+  trs.ep = "TestEP";
+  trs.validators["ORT_VERSION"] = "1";
+  trs.results["CudnnConvForward_0"]["1_NCHW_x1x3x8x8"] = 7;
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile({trs}, file_path));
+
+  ASSERT_STATUS_OK(inference_session_utils::ParseTuningResultsFromFile(file_path, results, file_found));
+  std::filesystem::remove(file_path);
+  ASSERT_TRUE(file_found);
+  ASSERT_EQ(results.size(), 1u);
+  ASSERT_EQ(results[0].ep, trs.ep);
+  ASSERT_EQ(results[0].validators, trs.validators);
+  ASSERT_EQ(results[0].results, trs.results);
+}
+#endif
+
 }  // namespace tuning_context
 
 }  // namespace test
@@ -1507,6 +1507,43 @@ TEST_F(GraphTest, ShapeInferenceErrorHandling) {
                                       "Node (node_1) Op (ShapeInferenceThrowsOp) [ShapeInferenceError] try harder");
 }
 
+// Resolve only re-infers the nodes whose inputs changed, and the changes propagate to the nodes downstream.
+TEST_F(GraphTest, IncrementalTypeAndShapeInference) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+
+  auto& input_arg = graph.GetOrCreateNodeArg("x", &tensor_float);
+  auto& identity_out = graph.GetOrCreateNodeArg("y", nullptr);
+  auto& relu_out = graph.GetOrCreateNodeArg("z", nullptr);
+  graph.AddNode("identity", "Identity", "", {&input_arg}, {&identity_out});
+  graph.AddNode("relu", "Relu", "", {&identity_out}, {&relu_out});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_NE(relu_out.Shape(), nullptr);
+  ASSERT_EQ(relu_out.Shape()->dim_size(), 1);
+  EXPECT_EQ(relu_out.Shape()->dim(0).dim_param(), "N");
+
+  // a second Resolve without changes keeps the inferred shapes
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(relu_out.Shape()->dim(0).dim_param(), "N");
+
+  TensorShapeProto concrete_shape;
+  concrete_shape.add_dim()->set_dim_value(4);
+  input_arg.SetShape(concrete_shape);
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_TRUE(utils::HasDimValue(identity_out.Shape()->dim(0)));
+  EXPECT_EQ(identity_out.Shape()->dim(0).dim_value(), 4);
+  ASSERT_TRUE(utils::HasDimValue(relu_out.Shape()->dim(0)));
+  EXPECT_EQ(relu_out.Shape()->dim(0).dim_value(), 4);
+}
+
 TEST_F(GraphTest, AddTensorAttribute) {
   OPERATOR_SCHEMA(__Constant)
       .SetDoc("Constant Op.")
@@ -2,8 +2,13 @@
 // Licensed under the MIT License.
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
 #include "core/platform/env.h"
+#include "core/framework/callback.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
@@ -178,6 +183,75 @@ TEST_F(ONNXModelsTest, TestIRv4NonInputInitializers) {
   ASSERT_STATUS_OK(model->MainGraph().Resolve());
 }
 
+// test that the raw data of large initializers is referenced in the model file when streaming initializers
+TEST_F(ONNXModelsTest, LoadModelStreamingInitializers) {
+  const auto model_dir = std::filesystem::temp_directory_path() / ORT_TSTR("ort_stream_initializers_test");
+  std::filesystem::create_directories(model_dir);
+  const auto model_path = model_dir / ORT_TSTR("stream_initializers_test.onnx");
+  const std::vector<float> large_values(1024, 2.f);
+  const std::vector<float> small_values{1.f, 2.f};
+  {
+    ModelProto model_proto;
+    model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+    model_proto.add_opset_import()->set_version(13);
+    auto& graph_proto = *model_proto.mutable_graph();
+    graph_proto.set_name("stream_initializers");
+    for (const auto& [name, values] : {std::make_pair("large", &large_values), std::make_pair("small", &small_values)}) {
+      auto& initializer = *graph_proto.add_initializer();
+      initializer.set_name(name);
+      initializer.set_data_type(TensorProto_DataType_FLOAT);
+      initializer.add_dims(static_cast<int64_t>(values->size()));
+      initializer.set_raw_data(values->data(), values->size() * sizeof(float));
+    }
+
+    auto& node = *graph_proto.add_node();
+    node.set_op_type("Add");
+    node.add_input("large");
+    node.add_input("large");
+    node.add_output("output");
+    auto& output = *graph_proto.add_output();
+    output.set_name("output");
+    output.mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+    std::ofstream stream(model_path, std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&stream));
+  }
+
+  ModelOptions options;
+  options.stream_initializers = true;
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path.native(), model, nullptr, *logger_, options));
+
+  const TensorProto* large = nullptr;
+  const TensorProto* small = nullptr;
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("large", large));
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("small", small));
+  EXPECT_TRUE(utils::HasExternalData(*large));
+  EXPECT_FALSE(utils::HasExternalData(*small));
+
+  std::vector<uint8_t> unpacked;
+  ASSERT_STATUS_OK(utils::UnpackInitializerData(*large, model_path, unpacked));
+  ASSERT_EQ(unpacked.size(), large_values.size() * sizeof(float));
+  EXPECT_EQ(std::memcmp(unpacked.data(), large_values.data(), unpacked.size()), 0);
+  EXPECT_EQ(model->MainGraph().NumberOfNodes(), 1);
+
+  // the data is at an arbitrary offset in the model file, but is aligned when read for the kernels
+  void* ext_data = nullptr;
+  SafeInt<size_t> ext_data_len = 0;
+  OrtCallback ext_data_deleter{nullptr, nullptr};
+  ASSERT_STATUS_OK(utils::GetExtDataFromTensorProto(Env::Default(), model_path, *large, ext_data, ext_data_len,
+                                                    ext_data_deleter));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ext_data) % kAllocAlignment, 0u);
+  ASSERT_EQ(static_cast<size_t>(ext_data_len), large_values.size() * sizeof(float));
+  EXPECT_EQ(std::memcmp(ext_data, large_values.data(), ext_data_len), 0);
+  if (ext_data_deleter.f != nullptr) {
+    ext_data_deleter.f(ext_data_deleter.param);
+  }
+
+  model.reset();
+  std::filesystem::remove_all(model_dir);
+}
+
 // test a model that has an op with a FunctionBody and one of the nodes within the FunctionBody has a subgraph in it.
 // The test model has is an opset-11 op with a 'Range' node.
 // 'Range' has a FunctionBody and has a 'Loop' node with a subgraph.
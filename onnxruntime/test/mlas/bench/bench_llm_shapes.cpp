@@ -0,0 +1,312 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Shape driven benchmarks of the MLAS entry points used by transformer models.
+//
+// The shapes come from the model configurations below. More models can be given in a JSON file named by the
+// ORT_MLAS_BENCH_SHAPES environment variable:
+//
+//   {"models": [{"name": "llama3_8b", "hidden_size": 4096, "num_heads": 32, "kv_num_heads": 8,
+//                "head_size": 128, "intermediate_size": 14336, "sequence_lengths": [1, 128, 2048]}]}
+//
+// Each benchmark reports FLOPS and Bytes (per second) and the arithmetic intensity. When the peak compute and memory
+// bandwidth of the machine are given by ORT_MLAS_BENCH_PEAK_GFLOPS and ORT_MLAS_BENCH_PEAK_GBPS, it also reports the
+// fraction of the roofline attained, so results of different CPUs and kernel changes can be compared directly.
+// The MLAS kernels are dispatched to the best ISA of the machine, so running the suite on each SKU compares the
+// ISA paths.
+
+#include "mlas.h"
+#include "mlas_q4.h"
+#include "mlas_qnbit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "nlohmann/json.hpp"
+
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+#include "core/platform/env_var_utils.h"
+
+namespace {
+
+struct LlmShape {
+  std::string name;
+  size_t hidden_size;
+  size_t num_heads;
+  size_t kv_num_heads;
+  size_t head_size;
+  size_t intermediate_size;
+  std::vector<size_t> sequence_lengths;
+};
+
+std::vector<LlmShape> DefaultLlmShapes() {
+  return {
+      {"llama2_7b", 4096, 32, 32, 128, 11008, {1, 128, 1024}},
+      {"llama3_8b", 4096, 32, 8, 128, 14336, {1, 128, 1024}},
+      {"phi3_mini", 3072, 32, 32, 96, 8192, {1, 128, 1024}},
+      {"bert_base", 768, 12, 12, 64, 3072, {128, 384}},
+      {"whisper_large", 1280, 20, 20, 64, 5120, {1, 448, 1500}},
+  };
+}
+
+std::vector<LlmShape> LoadLlmShapes() {
+  const auto path = onnxruntime::ParseEnvironmentVariableWithDefault<std::string>("ORT_MLAS_BENCH_SHAPES", "");
+  if (path.empty()) {
+    return DefaultLlmShapes();
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    throw std::invalid_argument("Failed to open the shapes file " + path);
+  }
+
+  const auto json = nlohmann::json::parse(file);
+
+  std::vector<LlmShape> shapes;
+  for (const auto& model : json.at("models")) {
+    LlmShape shape;
+    shape.name = model.at("name").get<std::string>();
+    shape.hidden_size = model.at("hidden_size").get<size_t>();
+    shape.num_heads = model.at("num_heads").get<size_t>();
+    shape.kv_num_heads = model.value("kv_num_heads", shape.num_heads);
+    shape.head_size = model.value("head_size", shape.hidden_size / shape.num_heads);
+    shape.intermediate_size = model.at("intermediate_size").get<size_t>();
+    shape.sequence_lengths = model.at("sequence_lengths").get<std::vector<size_t>>();
+    shapes.push_back(std::move(shape));
+  }
+
+  return shapes;
+}
+
+std::unique_ptr<onnxruntime::concurrency::ThreadPool> CreateBenchThreadPool() {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = onnxruntime::ParseEnvironmentVariableWithDefault<int>("ORT_MLAS_BENCH_THREADS", 8);
+  tpo.auto_set_affinity = true;
+
+  return onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo,
+                                                    onnxruntime::concurrency::ThreadPoolType::INTRA_OP);
+}
+
+// Reports the work of one iteration. The rate counters are divided by the elapsed time by the benchmark library.
+void SetWorkCounters(benchmark::State& state, double flops, double bytes) {
+  static const double peak_gflops =
+      onnxruntime::ParseEnvironmentVariableWithDefault<double>("ORT_MLAS_BENCH_PEAK_GFLOPS", 0.0);
+  static const double peak_gbps =
+      onnxruntime::ParseEnvironmentVariableWithDefault<double>("ORT_MLAS_BENCH_PEAK_GBPS", 0.0);
+
+  state.counters["FLOPS"] = benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate,
+                                               benchmark::Counter::OneK::kIs1000);
+  state.counters["Bytes"] = benchmark::Counter(bytes, benchmark::Counter::kIsIterationInvariantRate,
+                                               benchmark::Counter::OneK::kIs1024);
+  state.counters["FLOP/Byte"] = flops / bytes;
+
+  // The attainable time of an iteration is bound by compute or by memory, whichever is slower. A rate counter of
+  // that time is the fraction of the roofline attained.
+  double attainable_seconds = 0.0;
+  if (peak_gflops > 0.0) {
+    attainable_seconds = std::max(attainable_seconds, flops / (peak_gflops * 1e9));
+  }
+  if (peak_gbps > 0.0) {
+    attainable_seconds = std::max(attainable_seconds, bytes / (peak_gbps * 1e9));
+  }
+  if (attainable_seconds > 0.0) {
+    state.counters["Roofline"] = benchmark::Counter(attainable_seconds,
+                                                    benchmark::Counter::kIsIterationInvariantRate);
+  }
+}
+
+void FlashAttention(benchmark::State& state, const LlmShape& shape, size_t sequence_length) {
+  const size_t S = sequence_length, H = shape.head_size;
+  const size_t q_elements = shape.num_heads * S * H;
+  const size_t kv_elements = shape.kv_num_heads * S * H;
+
+  auto tp = CreateBenchThreadPool();
+
+  const auto query = RandomVectorUniform(q_elements, -1.0f, 1.0f);
+  const auto key = RandomVectorUniform(kv_elements, -1.0f, 1.0f);
+  const auto value = RandomVectorUniform(kv_elements, -1.0f, 1.0f);
+  std::vector<float> output(q_elements);
+
+  MlasFlashAttentionThreadedArgs args;
+  args.batch_size = 1;
+  args.num_heads = static_cast<int>(shape.num_heads);
+  args.kv_num_heads = static_cast<int>(shape.kv_num_heads);
+  args.q_sequence_length = static_cast<int>(S);
+  args.kv_sequence_length = static_cast<int>(S);
+  args.qk_head_size = static_cast<int>(H);
+  args.v_head_size = static_cast<int>(H);
+  args.q_block_size = static_cast<int>(std::min<size_t>(S, 64));
+  args.kv_block_size = static_cast<int>(std::min<size_t>(S, 256));
+  args.scale = 1.0f / std::sqrt(static_cast<float>(H));
+  args.thread_count = onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  args.is_causal = true;
+  args.query = query.data();
+  args.key = key.data();
+  args.value = value.data();
+  args.output = output.data();
+
+  args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(&args);
+  std::vector<float> buffer(args.buffer_size_per_thread * args.thread_count / sizeof(float));
+  args.buffer = buffer.data();
+
+  // warm up run
+  MlasFlashAttention(&args, tp.get());
+
+  for (auto _ : state) {
+    MlasFlashAttention(&args, tp.get());
+  }
+
+  // QK and PV of the causal half of the scores
+  const double flops = 2.0 * 2.0 * shape.num_heads * S * (S + 1) / 2 * H;
+  const double bytes = sizeof(float) * (2.0 * q_elements + 2.0 * kv_elements);
+  SetWorkCounters(state, flops, bytes);
+}
+
+void Softmax(benchmark::State& state, const LlmShape& shape, size_t sequence_length) {
+  const size_t N = shape.num_heads * sequence_length, D = sequence_length;
+
+  auto tp = CreateBenchThreadPool();
+
+  const auto input = RandomVectorUniform(N * D, -10.0f, 10.0f);
+  std::vector<float> output(N * D);
+
+  // warm up run
+  MlasComputeSoftmax(input.data(), output.data(), N, D, false, tp.get());
+
+  for (auto _ : state) {
+    MlasComputeSoftmax(input.data(), output.data(), N, D, false, tp.get());
+  }
+
+  // maximum, exponent, sum and scale of each element
+  const double flops = 4.0 * N * D;
+  const double bytes = sizeof(float) * 2.0 * N * D;
+  SetWorkCounters(state, flops, bytes);
+}
+
+void Transpose(benchmark::State& state, const LlmShape& shape, size_t sequence_length) {
+  const size_t M = sequence_length, N = shape.hidden_size;
+
+  const auto input = RandomVectorUniform(M * N, -1.0f, 1.0f);
+  std::vector<float> output(M * N);
+
+  // warm up run
+  MlasTranspose(input.data(), output.data(), M, N);
+
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), M, N);
+  }
+
+  SetWorkCounters(state, 0.0, sizeof(float) * 2.0 * M * N);
+}
+
+void SQNBitGemm(benchmark::State& state, size_t M, size_t N, size_t K, MLAS_SQNBIT_GEMM_COMPUTE_TYPE compute_type) {
+  constexpr size_t BlkBitWidth = 4;
+  constexpr size_t BlkLen = 32;
+
+  if (!MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen, compute_type)) {
+    state.SkipWithMessage("SQNBitGemm is not available with the given configuration on the current machine.");
+    return;
+  }
+
+  size_t quant_b_data_size, quant_b_scale_size, quant_b_zero_point_size;
+  MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, static_cast<int>(BlkLen), /* columnwise */ true,
+                                    static_cast<int>(K), static_cast<int>(N),
+                                    quant_b_data_size, quant_b_scale_size, &quant_b_zero_point_size);
+
+  auto tp = CreateBenchThreadPool();
+
+  const auto A = RandomVectorUniform(M * K, -1.0f, 1.0f);
+  const auto B = RandomVectorUniform(K * N, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+
+  std::vector<uint8_t> quant_b_data(quant_b_data_size);
+  std::vector<float> quant_b_scale(quant_b_scale_size);
+  MlasQuantizeBlockwise<float, BlkBitWidth>(quant_b_data.data(), quant_b_scale.data(), nullptr, B.data(),
+                                            static_cast<int>(BlkLen), /* columnwise */ true,
+                                            static_cast<int>(K), static_cast<int>(N), static_cast<int>(N),
+                                            tp.get());
+
+  std::unique_ptr<std::byte[]> workspace;
+  if (const auto workspace_size = MlasSQNBitGemmBatchWorkspaceSize(M, N, K, 1, BlkBitWidth, BlkLen, compute_type);
+      workspace_size > 0) {
+    workspace = std::make_unique<std::byte[]>(workspace_size);
+  }
+
+  std::unique_ptr<std::byte[]> packed_quant_b_data;
+  if (const auto packed_size = MlasSQNBitGemmPackQuantBDataSize(N, K, BlkBitWidth, BlkLen, compute_type);
+      packed_size > 0) {
+    packed_quant_b_data = std::make_unique<std::byte[]>(packed_size);
+    MlasSQNBitGemmPackQuantBData(N, K, BlkBitWidth, BlkLen, compute_type, quant_b_data.data(),
+                                 packed_quant_b_data.get(), quant_b_scale.data(), false, nullptr, tp.get());
+  }
+
+  MLAS_SQNBIT_GEMM_DATA_PARAMS params{};
+  params.A = A.data();
+  params.lda = K;
+  params.QuantBDataWorkspace = packed_quant_b_data != nullptr
+                                   ? static_cast<const void*>(packed_quant_b_data.get())
+                                   : static_cast<const void*>(quant_b_data.data());
+  params.PackedQuantBData = packed_quant_b_data.get();
+  params.QuantBScale = quant_b_scale.data();
+  params.C = C.data();
+  params.ldc = N;
+
+  // warm up run
+  MlasSQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, compute_type, &params, workspace.get(), tp.get());
+
+  for (auto _ : state) {
+    MlasSQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, compute_type, &params, workspace.get(), tp.get());
+  }
+
+  const double flops = 2.0 * M * N * K;
+  const double bytes = sizeof(float) * (double(M) * K + double(M) * N) + quant_b_data_size +
+                       sizeof(float) * quant_b_scale_size;
+  SetWorkCounters(state, flops, bytes);
+}
+
+void RegisterLlmShapeBenchmarks() {
+  for (const auto& shape : LoadLlmShapes()) {
+    const size_t qkv_size = (shape.num_heads + 2 * shape.kv_num_heads) * shape.head_size;
+
+    // the projections of a decoder layer as {name, N, K}
+    const struct {
+      const char* name;
+      size_t N;
+      size_t K;
+    } projections[] = {
+        {"qkv", qkv_size, shape.hidden_size},
+        {"o", shape.hidden_size, shape.num_heads * shape.head_size},
+        {"gate_up", 2 * shape.intermediate_size, shape.hidden_size},
+        {"down", shape.hidden_size, shape.intermediate_size},
+    };
+
+    for (const size_t S : shape.sequence_lengths) {
+      const std::string suffix = "/" + shape.name + "/S:" + std::to_string(S);
+
+      benchmark::RegisterBenchmark(("LLM_FLASHATTENTION" + suffix).c_str(), FlashAttention, shape, S)
+          ->UseRealTime();
+      benchmark::RegisterBenchmark(("LLM_SOFTMAX" + suffix).c_str(), Softmax, shape, S)->UseRealTime();
+      benchmark::RegisterBenchmark(("LLM_TRANSPOSE" + suffix).c_str(), Transpose, shape, S)->UseRealTime();
+
+      for (const auto& projection : projections) {
+        for (const auto compute_type : {CompFp32, CompInt8}) {
+          const std::string name = std::string("LLM_SQNBITGEMM_") + projection.name + suffix +
+                                   "/ComputeType:" + std::to_string(static_cast<int>(compute_type));
+          benchmark::RegisterBenchmark(name.c_str(), SQNBitGemm, S, projection.N, projection.K, compute_type)
+              ->UseRealTime();
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+[[maybe_unused]] static const bool llm_shape_benchmarks_registered = (RegisterLlmShapeBenchmarks(), true);
@@ -70,6 +70,12 @@ class FgemmShortExecuteTest : public MlasTestFixture<MlasFgemmTest<T, Packed, Th
     test_registered += RegisterTestTransposeABProduct(128, 3072, 768, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(128, 768, 3072, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(25, 81, 79, 7, 1.0f, 0.0f);
+
+    // batches of small matrices, e.g. per head or per expert
+    test_registered += RegisterTestTransposeABProduct(16, 64, 64, 12, 1.0f, 0.0f);
+    test_registered += RegisterTestTransposeABProduct(1, 17, 64, 9, 1.0f, 0.0f);
+    test_registered += RegisterTestTransposeABProduct(7, 13, 33, 5, 0.5f, 1.5f);
+    test_registered += RegisterTestTransposeABProduct(64, 64, 256, 4, 1.0f, 1.0f);
     return test_registered;
   }
 
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<MLFp16> BufferQueryFp16;
+  MatrixGuardBuffer<MLFp16> BufferKeyFp16;
+  MatrixGuardBuffer<MLFp16> BufferValueFp16;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferScratch;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BatchSize, size_t NumHeads, size_t KvNumHeads, size_t QSequenceLength, size_t KvSequenceLength,
+            size_t HeadSize, size_t QBlockSize, size_t KvBlockSize, bool IsCausal, bool IsFp16) {
+    const size_t QueryElements = BatchSize * NumHeads * QSequenceLength * HeadSize;
+    const size_t KeyElements = BatchSize * KvNumHeads * KvSequenceLength * HeadSize;
+
+    float* Query = BufferQuery.GetBuffer(QueryElements);
+    float* Key = BufferKey.GetBuffer(KeyElements);
+    float* Value = BufferValue.GetBuffer(KeyElements);
+    float* Output = BufferOutput.GetBuffer(QueryElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(QueryElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(QueryElements + KeyElements));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < QueryElements; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < KeyElements; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = static_cast<int>(BatchSize);
+    args.num_heads = static_cast<int>(NumHeads);
+    args.kv_num_heads = static_cast<int>(KvNumHeads);
+    args.q_sequence_length = static_cast<int>(QSequenceLength);
+    args.kv_sequence_length = static_cast<int>(KvSequenceLength);
+    args.qk_head_size = static_cast<int>(HeadSize);
+    args.v_head_size = static_cast<int>(HeadSize);
+    args.q_block_size = static_cast<int>(QBlockSize);
+    args.kv_block_size = static_cast<int>(KvBlockSize);
+    args.scale = 1.0f / std::sqrt(static_cast<float>(HeadSize));
+    args.thread_count = Threaded ? 4 : 1;
+    args.is_causal = IsCausal;
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+
+    if (IsFp16) {
+      MLFp16* QueryFp16 = BufferQueryFp16.GetBuffer(QueryElements);
+      MLFp16* KeyFp16 = BufferKeyFp16.GetBuffer(KeyElements);
+      MLFp16* ValueFp16 = BufferValueFp16.GetBuffer(KeyElements);
+
+      // The reference uses the rounded values.
+      for (size_t i = 0; i < QueryElements; i++) {
+        QueryFp16[i] = MLFp16(Query[i]);
+        Query[i] = QueryFp16[i].ToFloat();
+      }
+      for (size_t i = 0; i < KeyElements; i++) {
+        KeyFp16[i] = MLFp16(Key[i]);
+        Key[i] = KeyFp16[i].ToFloat();
+        ValueFp16[i] = MLFp16(Value[i]);
+        Value[i] = ValueFp16[i].ToFloat();
+      }
+
+      args.query_fp16 = reinterpret_cast<const MLAS_FP16*>(QueryFp16);
+      args.key_fp16 = reinterpret_cast<const MLAS_FP16*>(KeyFp16);
+      args.value_fp16 = reinterpret_cast<const MLAS_FP16*>(ValueFp16);
+      args.query = nullptr;
+      args.key = nullptr;
+      args.value = nullptr;
+    }
+
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(&args);
+    args.buffer = BufferScratch.GetBuffer(args.buffer_size_per_thread * args.thread_count / sizeof(float));
+
+    MlasFlashAttention(&args, threadpool_);
+    ReferenceAttention(Query, Key, Value, OutputReference, BatchSize, NumHeads, KvNumHeads, QSequenceLength,
+                       KvSequenceLength, HeadSize, args.scale, IsCausal);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t i = 0; i < QueryElements; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "@" << i << " of B=" << BatchSize << " N=" << NumHeads << " N_kv=" << KvNumHeads
+          << " S=" << QSequenceLength << " L=" << KvSequenceLength << " H=" << HeadSize
+          << " Br=" << QBlockSize << " Bc=" << KvBlockSize << " causal=" << IsCausal << " fp16=" << IsFp16
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  void ReferenceAttention(const float* Query, const float* Key, const float* Value, float* Output,
+                          size_t BatchSize, size_t NumHeads, size_t KvNumHeads, size_t QSequenceLength,
+                          size_t KvSequenceLength, size_t HeadSize, float Scale, bool IsCausal) {
+    std::vector<double> Scores(KvSequenceLength);
+
+    for (size_t b = 0; b < BatchSize; b++) {
+      for (size_t n = 0; n < NumHeads; n++) {
+        const size_t kv_n = n / (NumHeads / KvNumHeads);
+        const float* q = Query + (b * NumHeads + n) * QSequenceLength * HeadSize;
+        const float* k = Key + (b * KvNumHeads + kv_n) * KvSequenceLength * HeadSize;
+        const float* v = Value + (b * KvNumHeads + kv_n) * KvSequenceLength * HeadSize;
+
+        for (size_t s = 0; s < QSequenceLength; s++) {
+          const size_t VisibleLength = IsCausal ? s + KvSequenceLength - QSequenceLength + 1 : KvSequenceLength;
+
+          double MaximumValue = std::numeric_limits<double>::lowest();
+          for (size_t t = 0; t < VisibleLength; t++) {
+            double dot = 0.0;
+            for (size_t h = 0; h < HeadSize; h++) {
+              dot += double(q[s * HeadSize + h]) * double(k[t * HeadSize + h]);
+            }
+            Scores[t] = dot * Scale;
+            MaximumValue = (std::max)(MaximumValue, Scores[t]);
+          }
+
+          double Sum = 0.0;
+          for (size_t t = 0; t < VisibleLength; t++) {
+            Scores[t] = std::exp(Scores[t] - MaximumValue);
+            Sum += Scores[t];
+          }
+
+          // The output is BxSxNxH.
+          float* o = Output + ((b * QSequenceLength + s) * NumHeads + n) * HeadSize;
+          for (size_t h = 0; h < HeadSize; h++) {
+            double Accumulation = 0.0;
+            for (size_t t = 0; t < VisibleLength; t++) {
+              Accumulation += Scores[t] * double(v[t * HeadSize + h]);
+            }
+            o[h] = float(Accumulation / Sum);
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool IsFp16 : {false, true}) {
+      for (bool IsCausal : {false, true}) {
+        Test(1, 1, 1, 1, 1, 8, 1, 1, IsCausal, IsFp16);
+        Test(2, 4, 4, 17, 17, 16, 8, 8, IsCausal, IsFp16);
+        Test(1, 8, 2, 33, 33, 32, 16, 7, IsCausal, IsFp16);
+        Test(2, 6, 1, 5, 40, 24, 4, 16, IsCausal, IsFp16);
+        Test(1, 4, 2, 64, 64, 64, 32, 64, IsCausal, IsFp16);
+        Test(3, 2, 2, 19, 23, 13, 5, 6, IsCausal, IsFp16);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasKvCacheInt8Test : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferCache;
+  MatrixGuardBuffer<int8_t> BufferQuantizedCache;
+  MatrixGuardBuffer<float> BufferScales;
+  MatrixGuardBuffer<float> BufferScores;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  void Test(size_t M, size_t N, size_t HeadSize) {
+    const size_t ldScores = N + 3;
+    const size_t ldOutput = HeadSize + 5;
+
+    float* Query = BufferQuery.GetBuffer(M * HeadSize);
+    float* Cache = BufferCache.GetBuffer(N * HeadSize);
+    int8_t* QuantizedCache = BufferQuantizedCache.GetBuffer(N * HeadSize);
+    float* Scales = BufferScales.GetBuffer(N);
+    float* Scores = BufferScores.GetBuffer(M * ldScores);
+    float* Output = BufferOutput.GetBuffer(M * ldOutput);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * HeadSize));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t i = 0; i < M * HeadSize; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N * HeadSize; i++) {
+      Cache[i] = distribution(generator);
+    }
+    // A row of zeroes gets a zero scale.
+    std::fill_n(Cache, HeadSize, 0.0f);
+
+    MlasQuantizeKvCacheInt8(Cache, QuantizedCache, Scales, N, HeadSize);
+
+    for (size_t n = 0; n < N; n++) {
+      for (size_t h = 0; h < HeadSize; h++) {
+        const float Dequantized = QuantizedCache[n * HeadSize + h] * Scales[n];
+        ASSERT_LE(std::fabs(Dequantized - Cache[n * HeadSize + h]), Scales[n] * 0.5f + 1e-6f)
+            << "quantize @[" << n << "," << h << "] of " << N << "x" << HeadSize;
+      }
+    }
+
+    const float alpha = 0.125f;
+    MlasAttentionQKInt8Kv(Query, M, QuantizedCache, Scales, N, HeadSize, alpha, Scores, ldScores);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Reference = 0.0;
+        for (size_t h = 0; h < HeadSize; h++) {
+          Reference += double(Query[m * HeadSize + h]) * double(QuantizedCache[n * HeadSize + h]) * double(Scales[n]);
+        }
+        Reference *= alpha;
+        ASSERT_NEAR(Scores[m * ldScores + n], Reference, 1e-4 * (1.0 + std::fabs(Reference)))
+            << "QK @[" << m << "," << n << "] of " << M << "x" << N << "x" << HeadSize;
+      }
+    }
+
+    // Use the scores as probabilities, with the causal zeroes of a prompt.
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        Scores[m * ldScores + n] = (n <= m + N - M) ? std::fabs(Scores[m * ldScores + n]) : 0.0f;
+      }
+    }
+
+    MlasAttentionPVInt8Kv(Scores, ldScores, M, QuantizedCache, Scales, N, HeadSize, Output, ldOutput);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t h = 0; h < HeadSize; h++) {
+        double Reference = 0.0;
+        for (size_t n = 0; n < N; n++) {
+          Reference += double(Scores[m * ldScores + n]) * double(QuantizedCache[n * HeadSize + h]) * double(Scales[n]);
+        }
+        ASSERT_NEAR(Output[m * ldOutput + h], Reference, 1e-4 * (1.0 + std::fabs(Reference)))
+            << "PV @[" << m << "," << h << "] of " << M << "x" << N << "x" << HeadSize;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("KvCacheInt8");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    Test(1, 1, 1);
+    Test(1, 17, 64);
+    Test(1, 130, 128);
+    Test(7, 7, 80);
+    Test(5, 33, 96);
+    Test(16, 20, 3);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasKvCacheInt8Test>::RegisterShortExecute();
+  }
+  return count;
+});
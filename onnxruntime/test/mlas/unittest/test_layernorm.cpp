@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferGamma;
+  MatrixGuardBuffer<float> BufferBeta;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferSkipOutput;
+  MatrixGuardBuffer<MLFp16> BufferInputFp16;
+  MatrixGuardBuffer<MLFp16> BufferSkipFp16;
+  MatrixGuardBuffer<MLFp16> BufferBiasFp16;
+  MatrixGuardBuffer<MLFp16> BufferGammaFp16;
+  MatrixGuardBuffer<MLFp16> BufferBetaFp16;
+  MatrixGuardBuffer<MLFp16> BufferOutputFp16;
+  MatrixGuardBuffer<MLFp16> BufferSkipOutputFp16;
+
+  void Test(size_t N, bool Simplified, bool HasSkip, bool HasBias, bool HasBeta, bool IsFp16) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Skip = BufferSkip.GetBuffer(N);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* Gamma = BufferGamma.GetBuffer(N);
+    float* Beta = BufferBeta.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+    float* SkipOutput = BufferSkipOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // The offset of the input exercises the cancellation that a single pass E[x^2] - E[x]^2 suffers from.
+    for (size_t i = 0; i < N; i++) {
+      Input[i] = distribution(generator) * 4.0f + 50.0f;
+      Skip[i] = distribution(generator);
+      Bias[i] = distribution(generator);
+      Gamma[i] = distribution(generator);
+      Beta[i] = distribution(generator);
+    }
+
+    const float Epsilon = 1e-5f;
+    float Mean = 0.0f;
+    float InverseStdDev = 0.0f;
+
+    if (IsFp16) {
+      MLFp16* InputFp16 = BufferInputFp16.GetBuffer(N);
+      MLFp16* SkipFp16 = BufferSkipFp16.GetBuffer(N);
+      MLFp16* BiasFp16 = BufferBiasFp16.GetBuffer(N);
+      MLFp16* GammaFp16 = BufferGammaFp16.GetBuffer(N);
+      MLFp16* BetaFp16 = BufferBetaFp16.GetBuffer(N);
+      MLFp16* OutputFp16 = BufferOutputFp16.GetBuffer(N);
+      MLFp16* SkipOutputFp16 = BufferSkipOutputFp16.GetBuffer(N);
+
+      // The reference uses the rounded values.
+      for (size_t i = 0; i < N; i++) {
+        InputFp16[i] = MLFp16(Input[i]);
+        Input[i] = InputFp16[i].ToFloat();
+        SkipFp16[i] = MLFp16(Skip[i]);
+        Skip[i] = SkipFp16[i].ToFloat();
+        BiasFp16[i] = MLFp16(Bias[i]);
+        Bias[i] = BiasFp16[i].ToFloat();
+        GammaFp16[i] = MLFp16(Gamma[i]);
+        Gamma[i] = GammaFp16[i].ToFloat();
+        BetaFp16[i] = MLFp16(Beta[i]);
+        Beta[i] = BetaFp16[i].ToFloat();
+      }
+
+      MlasLayerNormalizationFp16(reinterpret_cast<const MLAS_FP16*>(InputFp16),
+                                 HasSkip ? reinterpret_cast<const MLAS_FP16*>(SkipFp16) : nullptr,
+                                 HasBias ? reinterpret_cast<const MLAS_FP16*>(BiasFp16) : nullptr,
+                                 reinterpret_cast<const MLAS_FP16*>(GammaFp16),
+                                 HasBeta ? reinterpret_cast<const MLAS_FP16*>(BetaFp16) : nullptr,
+                                 reinterpret_cast<MLAS_FP16*>(OutputFp16),
+                                 HasSkip ? reinterpret_cast<MLAS_FP16*>(SkipOutputFp16) : nullptr,
+                                 N, Epsilon, Simplified, &Mean, &InverseStdDev);
+
+      for (size_t i = 0; i < N; i++) {
+        Output[i] = OutputFp16[i].ToFloat();
+        SkipOutput[i] = SkipOutputFp16[i].ToFloat();
+      }
+    } else {
+      MlasLayerNormalization(Input, HasSkip ? Skip : nullptr, HasBias ? Bias : nullptr, Gamma,
+                             HasBeta ? Beta : nullptr, Output, HasSkip ? SkipOutput : nullptr,
+                             N, Epsilon, Simplified, &Mean, &InverseStdDev);
+    }
+
+    std::vector<double> Values(N);
+    double ReferenceMean = 0.0;
+    for (size_t i = 0; i < N; i++) {
+      Values[i] = double(Input[i]) + (HasSkip ? double(Skip[i]) : 0.0) + (HasBias ? double(Bias[i]) : 0.0);
+      ReferenceMean += Values[i];
+    }
+    ReferenceMean = Simplified ? 0.0 : ReferenceMean / N;
+
+    double Variance = 0.0;
+    for (size_t i = 0; i < N; i++) {
+      Variance += (Values[i] - ReferenceMean) * (Values[i] - ReferenceMean);
+    }
+    const double ReferenceInverseStdDev = 1.0 / std::sqrt(Variance / N + Epsilon);
+
+    ASSERT_NEAR(Mean, ReferenceMean, 1e-4 * (1.0 + std::fabs(ReferenceMean)))
+        << "N=" << N << " simplified=" << Simplified << " fp16=" << IsFp16;
+    ASSERT_NEAR(InverseStdDev, ReferenceInverseStdDev, 1e-4 * ReferenceInverseStdDev)
+        << "N=" << N << " simplified=" << Simplified << " fp16=" << IsFp16;
+
+    const double Tolerance = IsFp16 ? 1e-2 : 1e-4;
+
+    for (size_t i = 0; i < N; i++) {
+      double Reference = (Values[i] - ReferenceMean) * ReferenceInverseStdDev * Gamma[i];
+      if (HasBeta && !Simplified) {
+        Reference += Beta[i];
+      }
+      ASSERT_NEAR(Output[i], Reference, Tolerance * (1.0 + std::fabs(Reference)))
+          << "@" << i << " of N=" << N << " simplified=" << Simplified << " skip=" << HasSkip
+          << " bias=" << HasBias << " beta=" << HasBeta << " fp16=" << IsFp16;
+      if (HasSkip) {
+        ASSERT_NEAR(SkipOutput[i], Values[i], Tolerance * (1.0 + std::fabs(Values[i])))
+            << "sum @" << i << " of N=" << N << " bias=" << HasBias << " fp16=" << IsFp16;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LayerNorm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool IsFp16 : {false, true}) {
+      for (bool Simplified : {false, true}) {
+        for (size_t N : {1, 3, 8, 13, 64, 100, 768, 4097}) {
+          Test(N, Simplified, false, false, false, IsFp16);
+          Test(N, Simplified, false, false, true, IsFp16);
+          Test(N, Simplified, true, false, true, IsFp16);
+          Test(N, Simplified, true, true, false, IsFp16);
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -181,6 +181,79 @@ class MlasQuantizeLinear4BitTest : public MlasTestBase {
   }
 };
 
+template <typename QuantInt>
+class MlasDequantizeLinearTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<QuantInt> BufferInput;
+  MatrixGuardBuffer<QuantInt> BufferZeroPoint;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  void Test(size_t M, size_t K, size_t N, size_t BlockSize, bool HasZeroPoint) {
+    const size_t ElementCount = M * K * N;
+    const size_t BlockCountK = BlockSize == 0 ? K : (K + BlockSize - 1) / BlockSize;
+    const size_t ParameterCount = BlockSize == 0 ? K : M * BlockCountK * N;
+
+    QuantInt* Input = BufferInput.GetBuffer(ElementCount);
+    QuantInt* ZeroPoint = BufferZeroPoint.GetBuffer(ParameterCount);
+    float* Scale = BufferScale.GetBuffer(ParameterCount);
+    float* Output = BufferOutput.GetBuffer(ElementCount);
+
+    std::default_random_engine generator(static_cast<unsigned>(ElementCount + BlockSize));
+    std::uniform_int_distribution<int32_t> int_distribution(std::numeric_limits<QuantInt>::min(),
+                                                            std::numeric_limits<QuantInt>::max());
+    std::uniform_real_distribution<float> scale_distribution(0.001f, 2.0f);
+
+    for (size_t i = 0; i < ElementCount; i++) {
+      Input[i] = static_cast<QuantInt>(int_distribution(generator));
+    }
+    for (size_t i = 0; i < ParameterCount; i++) {
+      Scale[i] = scale_distribution(generator);
+      ZeroPoint[i] = static_cast<QuantInt>(int_distribution(generator));
+    }
+
+    MlasDequantizeLinear<QuantInt>(Input, Output, M, K, N, BlockSize, Scale, HasZeroPoint ? ZeroPoint : nullptr,
+                                   GetMlasThreadPool());
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+          const size_t Index = (m * K + k) * N + n;
+          const size_t Parameter = BlockSize == 0 ? k : (m * BlockCountK + k / BlockSize) * N + n;
+          const int32_t Zp = HasZeroPoint ? static_cast<int32_t>(ZeroPoint[Parameter]) : 0;
+          const float Reference = static_cast<float>(static_cast<int32_t>(Input[Index]) - Zp) * Scale[Parameter];
+          ASSERT_EQ(Output[Index], Reference) << "@[" << m << "," << k << "," << n << "] M=" << M << " K=" << K
+                                              << " N=" << N << " BlockSize=" << BlockSize;
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("DequantizeLinear") +
+                                          (std::is_signed<QuantInt>::value ? "S" : "U") +
+                                          std::to_string(int(sizeof(QuantInt) * 8));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool HasZeroPoint : {false, true}) {
+      for (size_t n = 1; n <= 67; n++) {
+        Test(1, 1, n, 0, HasZeroPoint);
+      }
+      Test(1, 1, 100000, 0, HasZeroPoint);
+      Test(3, 5, 17, 0, HasZeroPoint);
+      Test(4, 9, 1, 0, HasZeroPoint);
+      Test(2, 64, 300, 0, HasZeroPoint);
+      Test(3, 70, 1, 32, HasZeroPoint);
+      Test(2, 33, 1, 16, HasZeroPoint);
+      Test(5, 17, 9, 4, HasZeroPoint);
+      Test(2, 64, 129, 32, HasZeroPoint);
+    }
+  }
+};
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
@@ -190,6 +263,10 @@ static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_exe
     count += MlasDirectShortExecuteTests<MlasQuantizeLinearTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasQuantizeLinear4BitTest<false>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasQuantizeLinear4BitTest<true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasDequantizeLinearTest<int8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasDequantizeLinearTest<uint8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasDequantizeLinearTest<int16_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasDequantizeLinearTest<uint16_t>>::RegisterShortExecute();
   }
   return count;
 });
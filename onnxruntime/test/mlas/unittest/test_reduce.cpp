@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<MLFp16> BufferInputFp16;
+  MatrixGuardBuffer<MLFp16> BufferOutputFp16;
+
+  void Test(MLAS_REDUCE_KIND Kind, size_t OuterCount, size_t ReduceCount, size_t InnerCount, bool IsFp16) {
+    const size_t InputCount = OuterCount * ReduceCount * InnerCount;
+    const size_t OutputCount = OuterCount * InnerCount;
+
+    float* Input = BufferInput.GetBuffer(InputCount);
+    float* Output = BufferOutput.GetBuffer(OutputCount);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputCount + Kind));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < InputCount; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    if (IsFp16) {
+      MLFp16* InputFp16 = BufferInputFp16.GetBuffer(InputCount);
+      MLFp16* OutputFp16 = BufferOutputFp16.GetBuffer(OutputCount);
+
+      // The reference uses the rounded values.
+      for (size_t i = 0; i < InputCount; i++) {
+        InputFp16[i] = MLFp16(Input[i]);
+        Input[i] = InputFp16[i].ToFloat();
+      }
+
+      MlasReduceFp16(Kind, reinterpret_cast<const MLAS_FP16*>(InputFp16), reinterpret_cast<MLAS_FP16*>(OutputFp16),
+                     OuterCount, ReduceCount, InnerCount, GetMlasThreadPool());
+
+      for (size_t i = 0; i < OutputCount; i++) {
+        Output[i] = OutputFp16[i].ToFloat();
+      }
+    } else {
+      MlasReduce(Kind, Input, Output, OuterCount, ReduceCount, InnerCount, GetMlasThreadPool());
+    }
+
+    for (size_t o = 0; o < OuterCount; o++) {
+      for (size_t i = 0; i < InnerCount; i++) {
+        double Reference = (Kind == MlasReduceSum)       ? 0.0
+                           : (Kind == MlasReduceMinimum) ? std::numeric_limits<double>::infinity()
+                                                         : -std::numeric_limits<double>::infinity();
+        for (size_t r = 0; r < ReduceCount; r++) {
+          const double Value = Input[(o * ReduceCount + r) * InnerCount + i];
+          if (Kind == MlasReduceSum) {
+            Reference += Value;
+          } else if (Kind == MlasReduceMinimum) {
+            Reference = std::min(Reference, Value);
+          } else {
+            Reference = std::max(Reference, Value);
+          }
+        }
+
+        const float Result = Output[o * InnerCount + i];
+
+        if (std::isinf(Reference)) {
+          ASSERT_EQ(Result, Reference) << "empty @[" << o << "," << i << "]";
+          continue;
+        }
+
+        // The half precision sum is rounded once at the end, so the tolerance covers the output rounding.
+        const double Tolerance = IsFp16 ? 1e-3 : (Kind == MlasReduceSum ? 1e-5 * ReduceCount : 0.0);
+
+        ASSERT_NEAR(Result, Reference, Tolerance * (1.0 + std::fabs(Reference)))
+            << "@[" << o << "," << i << "] outer=" << OuterCount << " reduce=" << ReduceCount
+            << " inner=" << InnerCount << " kind=" << Kind << " fp16=" << IsFp16;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool IsFp16 : {false, true}) {
+      for (MLAS_REDUCE_KIND Kind : {MlasReduceSum, MlasReduceMinimum, MlasReduceMaximum}) {
+        Test(Kind, 1, 1, 1, IsFp16);
+        Test(Kind, 3, 17, 1, IsFp16);
+        Test(Kind, 5, 1000, 1, IsFp16);
+        Test(Kind, 1000, 8, 1, IsFp16);
+        Test(Kind, 2, 3, 4, IsFp16);
+        Test(Kind, 7, 64, 9, IsFp16);
+        Test(Kind, 1, 33, 2000, IsFp16);
+        Test(Kind, 3, 100, 1031, IsFp16);
+        Test(Kind, 4, 0, 5, IsFp16);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+
+  void Test(size_t M, size_t N, size_t K, bool TransB, size_t BlockRows, size_t BlockColumns, float alpha, float beta) {
+    const float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(K * N);
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    //
+    // Prune three quarters of the blocks of BlockRows x BlockColumns of the
+    // logical K x N matrix B.
+    //
+
+    for (size_t k = 0; k < K; k += BlockRows) {
+      for (size_t n = 0; n < N; n += BlockColumns) {
+        const bool Pruned = (generator() % 4) != 0;
+        for (size_t kk = k; kk < std::min(K, k + BlockRows); kk++) {
+          for (size_t nn = n; nn < std::min(N, n + BlockColumns); nn++) {
+            B[TransB ? nn * K + kk : kk * N + nn] = Pruned ? 0.0f : distribution(generator);
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < M * N; i++) {
+      C[i] = distribution(generator);
+      CReference[i] = C[i];
+    }
+
+    const size_t ldb = TransB ? K : N;
+    const CBLAS_TRANSPOSE Trans = TransB ? CblasTrans : CblasNoTrans;
+
+    const size_t PackedBSize = MlasSparseGemmPackBSize(Trans, N, K, B, ldb);
+    ASSERT_NE(PackedBSize, size_t(0)) << "M=" << M << " N=" << N << " K=" << K;
+
+    void* PackedB = BufferPackedB.GetBuffer(PackedBSize, true);
+    MlasSparseGemmPackB(Trans, N, K, B, ldb, PackedB);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.B = static_cast<const float*>(PackedB);
+    Data.C = C;
+    Data.ldc = N;
+    Data.alpha = alpha;
+    Data.beta = beta;
+
+    MlasSparseGemmBatch(M, N, K, &Data, 1, GetMlasThreadPool());
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          Sum += A[m * K + k] * B[TransB ? n * K + k : k * N + n];
+        }
+        const float Reference = alpha * Sum + beta * CReference[m * N + n];
+        ASSERT_NEAR(C[m * N + n], Reference, 1e-4f * (1.0f + std::fabs(Reference)))
+            << "@[" << m << "," << n << "] M=" << M << " N=" << N << " K=" << K << " TransB=" << TransB
+            << " Block=" << BlockRows << "x" << BlockColumns;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SparseGemm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool TransB : {false, true}) {
+      for (size_t M : {1, 3, 4, 9}) {
+        Test(M, 64, 64, TransB, 1, 4, 1.0f, 0.0f);
+        Test(M, 70, 33, TransB, 4, 4, 1.0f, 0.0f);
+        Test(M, 256, 128, TransB, 4, 4, 0.5f, 1.0f);
+        Test(M, 13, 100, TransB, 1, 4, 1.0f, 0.25f);
+      }
+    }
+  }
+
+  void ExecuteLong(void) override {
+    for (bool TransB : {false, true}) {
+      for (size_t M : {1, 16, 33}) {
+        Test(M, 768, 768, TransB, 4, 4, 1.0f, 0.0f);
+        Test(M, 3072, 768, TransB, 1, 4, 1.0f, 0.0f);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSparseGemmTest>::RegisterShortExecute();
+  } else {
+    count += MlasLongExecuteTests<MlasSparseGemmTest>::RegisterLongExecute();
+  }
+  return count;
+});
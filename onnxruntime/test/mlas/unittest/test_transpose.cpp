@@ -45,12 +45,85 @@ class MlasTransposeTest : public MlasTestBase {
   }
 };
 
+template <typename ElementType>
+class MlasTransposeTensorTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<ElementType> BufferInput;
+  MatrixGuardBuffer<ElementType> BufferOutput;
+  MatrixGuardBuffer<ElementType> BufferOutputReference;
+
+  void Test(const std::vector<size_t>& Shape, const std::vector<size_t>& Permutation) {
+    const size_t Rank = Shape.size();
+    size_t ElementCount = 1;
+    for (size_t d : Shape) {
+      ElementCount *= d;
+    }
+
+    ElementType* Input = BufferInput.GetBuffer(ElementCount);
+    ElementType* Output = BufferOutput.GetBuffer(ElementCount);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(ElementCount);
+
+    for (size_t i = 0; i < ElementCount; i++) {
+      Input[i] = static_cast<ElementType>(i * 2654435761u + 7);
+    }
+
+    ASSERT_TRUE(MlasTransposeTensor(Input, Output, sizeof(ElementType), Rank, Shape.data(), Permutation.data(),
+                                    GetMlasThreadPool()));
+
+    std::vector<size_t> InputStrides(Rank, 1);
+    for (size_t i = Rank - 1; i > 0; i--) {
+      InputStrides[i - 1] = InputStrides[i] * Shape[i];
+    }
+
+    std::vector<size_t> Index(Rank, 0);
+    for (size_t o = 0; o < ElementCount; o++) {
+      size_t Offset = 0;
+      for (size_t i = 0; i < Rank; i++) {
+        Offset += Index[i] * InputStrides[Permutation[i]];
+      }
+      OutputReference[o] = Input[Offset];
+      for (size_t i = Rank; i > 0; i--) {
+        if (++Index[i - 1] < Shape[Permutation[i - 1]]) {
+          break;
+        }
+        Index[i - 1] = 0;
+      }
+    }
+
+    ASSERT_EQ(memcmp(Output, OutputReference, ElementCount * sizeof(ElementType)), 0) << " rank " << Rank;
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("TransposeTensor_Size") + std::to_string(int(sizeof(ElementType)));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    Test({2, 3, 4, 5}, {0, 2, 1, 3});
+    Test({2, 3, 4, 5}, {0, 2, 3, 1});
+    Test({2, 3, 4, 5}, {3, 2, 1, 0});
+    Test({1, 12, 64, 64}, {0, 2, 1, 3});
+    Test({2, 70, 130}, {2, 0, 1});
+    Test({130, 67}, {1, 0});
+    Test({3, 1, 5, 1, 7}, {4, 2, 0, 1, 3});
+    Test({2, 3, 4, 5, 6}, {0, 3, 1, 4, 2});
+    Test({2, 3, 4, 5, 6}, {4, 3, 2, 1, 0});
+    Test({8, 16, 1, 9}, {1, 3, 0, 2});
+    Test({1, 1}, {1, 0});
+  }
+};
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint32_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeTensorTest<uint64_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeTensorTest<uint32_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeTensorTest<uint16_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeTensorTest<uint8_t>>::RegisterShortExecute();
   }
   return count;
 });
@@ -21,6 +21,8 @@
 #include <iostream>
 #include <unordered_map>
 
+#include "model_ops.h"
+
 const OrtApi* g_ort = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 OrtEnv* env = nullptr;
 
@@ -75,11 +77,17 @@ BENCHMARK(BM_ResolveGraph);
   } while (0);
 
 int main(int argc, char** argv) {
+  if (!ParseModelOpBenchmarkFlags(&argc, argv))
+    return -1;
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
-  ::benchmark::RunSpecifiedBenchmarks();
+  if (!RegisterModelOpBenchmarks()) {
+    g_ort->ReleaseEnv(env);
+    return -1;
+  }
+  RunSpecifiedBenchmarksWithModelOpRanking();
   g_ort->ReleaseEnv(env);
   return 0;
 }
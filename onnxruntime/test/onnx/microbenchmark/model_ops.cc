@@ -0,0 +1,412 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_ops.h"
+
+#include <benchmark/benchmark.h>
+#include <core/framework/data_types.h>
+#include <core/graph/model.h>
+#include <core/optimizer/initializer.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern OrtEnv* env;
+
+using namespace onnxruntime;
+
+namespace {
+
+// initializers up to this size are part of the key of a node, as they are usually shapes, axes or indices that
+// change the work of the kernel
+constexpr size_t kMaxKeyInitializerBytes = 1024;
+
+constexpr const char* kBenchmarkPrefix = "BM_ModelOp/";
+
+struct ModelOpBenchmarkFlags {
+  std::string model_path;
+  std::vector<std::string> eps{"cpu"};
+  std::unordered_map<std::string, int64_t> dims;
+};
+
+ModelOpBenchmarkFlags& GetFlags() {
+  static ModelOpBenchmarkFlags flags;
+  return flags;
+}
+
+// A distinct node of the model as a single node model.
+struct ModelOp {
+  std::string name;
+  std::string model_bytes;
+  std::vector<std::string> input_names;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::vector<ONNXTensorElementDataType> input_types;
+  std::vector<std::string> output_names;
+  size_t occurrences{0};
+};
+
+std::vector<std::string> Split(const std::string& value, char delimiter) {
+  std::vector<std::string> parts;
+  std::istringstream stream(value);
+  std::string part;
+  while (std::getline(stream, part, delimiter)) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+// Returns the static shape of a tensor arg, or false if it is not a tensor or its shape is not fully known.
+bool GetStaticShape(const NodeArg& arg, std::vector<int64_t>& shape, int32_t& elem_type) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape_proto = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape_proto == nullptr) {
+    return false;
+  }
+
+  shape.clear();
+  for (const auto& dim : shape_proto->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    shape.push_back(dim.dim_value());
+  }
+  elem_type = type->tensor_type().elem_type();
+  return elem_type != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         elem_type != ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+}
+
+std::string ShapeToString(const std::vector<int64_t>& shape) {
+  std::ostringstream out;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    out << (i == 0 ? "" : "x") << shape[i];
+  }
+  return shape.empty() ? "scalar" : out.str();
+}
+
+// Fills the nodes with the distinct nodes of the main graph. Nodes with subgraphs or shapes that are not static
+// after the free dimensions of the inputs are set are skipped.
+Status ExtractModelOps(const ModelOpBenchmarkFlags& flags, std::vector<ModelOp>& ops, size_t& skipped) {
+  const PathString model_path = ToPathString(flags.model_path);
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(Model::Load(model_path, model_proto));
+
+  // set the free dimensions of the inputs so that shape inference makes the shapes of the nodes static
+  for (auto& input : *model_proto.mutable_graph()->mutable_input()) {
+    if (!input.type().has_tensor_type()) {
+      continue;
+    }
+    for (auto& dim : *input.mutable_type()->mutable_tensor_type()->mutable_shape()->mutable_dim()) {
+      if (!dim.has_dim_value()) {
+        auto it = dim.has_dim_param() ? flags.dims.find(dim.dim_param()) : flags.dims.end();
+        dim.set_dim_value(it != flags.dims.end() ? it->second : 1);
+      }
+    }
+  }
+
+  auto logger = env->GetLoggingManager()->CreateLogger("model_ops");
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(model_proto, model_path, model, nullptr, *logger));
+  const Graph& graph = model->MainGraph();
+
+  std::unordered_map<std::string, size_t> op_indices;
+  for (const Node& node : graph.Nodes()) {
+    if (node.ContainsSubgraph()) {
+      ++skipped;
+      continue;
+    }
+
+    std::ostringstream key;
+    key << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << ":" << node.OutputDefs().size();
+    const std::map<std::string, ONNX_NAMESPACE::AttributeProto> attributes(node.GetAttributes().cbegin(),
+                                                                           node.GetAttributes().cend());
+    for (const auto& [name, attribute] : attributes) {
+      key << ":" << attribute.SerializeAsString();
+    }
+
+    ModelOp op;
+    ONNX_NAMESPACE::ModelProto op_model;
+    op_model.set_ir_version(model_proto.ir_version());
+    *op_model.mutable_opset_import() = model_proto.opset_import();
+    auto& op_graph = *op_model.mutable_graph();
+    op_graph.set_name(node.OpType());
+    node.ToProto(*op_graph.add_node());
+
+    bool is_static = true;
+    std::ostringstream shapes;
+    for (const NodeArg* input : node.InputDefs()) {
+      if (!input->Exists()) {
+        key << ":-";
+        continue;
+      }
+
+      std::vector<int64_t> shape;
+      int32_t elem_type = 0;
+      if (!GetStaticShape(*input, shape, elem_type)) {
+        is_static = false;
+        break;
+      }
+      key << ":" << elem_type << "[" << ShapeToString(shape) << "]";
+      shapes << (shapes.tellp() == 0 ? "" : ",") << ShapeToString(shape);
+
+      // an arg can be an input of the node more than once
+      const auto& name = input->Name();
+      if (std::find(op.input_names.cbegin(), op.input_names.cend(), name) != op.input_names.cend() ||
+          std::any_of(op_graph.initializer().cbegin(), op_graph.initializer().cend(),
+                      [&name](const auto& initializer) { return initializer.name() == name; })) {
+        continue;
+      }
+
+      // constant initializers stay initializers, so that the kernels can prepack them as in the model
+      if (const auto* initializer = graph.GetConstantInitializer(name, false)) {
+        Initializer values{*initializer, graph.ModelPath()};
+        auto& tensor = *op_graph.add_initializer();
+        values.ToProto(tensor);
+        tensor.set_name(name);
+        if (tensor.ByteSizeLong() <= kMaxKeyInitializerBytes) {
+          key << "=" << tensor.raw_data();
+        }
+      } else {
+        *op_graph.add_input() = input->ToProto();
+        op.input_names.push_back(name);
+        op.input_shapes.push_back(std::move(shape));
+        op.input_types.push_back(static_cast<ONNXTensorElementDataType>(elem_type));
+      }
+    }
+
+    if (!is_static) {
+      ++skipped;
+      continue;
+    }
+
+    auto it = op_indices.find(key.str());
+    if (it != op_indices.end()) {
+      ++ops[it->second].occurrences;
+      continue;
+    }
+
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (output->Exists()) {
+        *op_graph.add_output() = output->ToProto();
+        op.output_names.push_back(output->Name());
+      }
+    }
+
+    op.name = node.OpType() + "[" + shapes.str() + "]#" + std::to_string(ops.size());
+    op.model_bytes = op_model.SerializeAsString();
+    op.occurrences = 1;
+    op_indices.emplace(key.str(), ops.size());
+    ops.push_back(std::move(op));
+  }
+
+  return Status::OK();
+}
+
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& ep) {
+  if (ep == "cpu") {
+    return;
+  }
+
+  // a node the EP does not support must fail rather than be benchmarked on the CPU EP
+  session_options.AddConfigEntry(kOrtSessionOptionsDisableCPUEPFallback, "1");
+  if (ep == "cuda") {
+    session_options.AppendExecutionProvider_CUDA(OrtCUDAProviderOptions{});
+  } else {
+    session_options.AppendExecutionProvider(ep, {});
+  }
+}
+
+void BM_ModelOp(benchmark::State& state, const ModelOp& op, const std::string& ep) {
+  std::vector<Ort::Value> inputs;
+  std::vector<const char*> input_names;
+  std::vector<const char*> output_names;
+  std::unique_ptr<Ort::Session> session;
+  Ort::Env ort_env{env};
+
+  ORT_TRY {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    AppendExecutionProvider(session_options, ep);
+    session = std::make_unique<Ort::Session>(ort_env, op.model_bytes.data(), op.model_bytes.size(), session_options);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < op.input_names.size(); ++i) {
+      const auto& shape = op.input_shapes[i];
+      auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), op.input_types[i]);
+      const size_t count = value.GetTensorTypeAndShapeInfo().GetElementCount();
+      if (op.input_types[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        float* data = value.GetTensorMutableData<float>();
+        std::generate(data, data + count, [&]() { return dist(gen); });
+      } else {
+        // zeros are valid indices and sizes for most ops
+        const size_t element_size = DataTypeImpl::TensorTypeFromONNXEnum(op.input_types[i])->GetElementType()->Size();
+        std::memset(value.GetTensorMutableRawData(), 0, count * element_size);
+      }
+      inputs.push_back(std::move(value));
+      input_names.push_back(op.input_names[i].c_str());
+    }
+    for (const auto& name : op.output_names) {
+      output_names.push_back(name.c_str());
+    }
+
+    // warm up, which also reports the errors of the node before the timing starts
+    session->Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(), inputs.size(), output_names.data(),
+                 output_names.size());
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+  // the env is owned by main
+  ort_env.release();
+  if (!session) {
+    return;
+  }
+
+  for (auto _ : state) {
+    auto outputs = session->Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(), inputs.size(),
+                                output_names.data(), output_names.size());
+    benchmark::DoNotOptimize(outputs);
+  }
+  state.counters["occurrences"] = static_cast<double>(op.occurrences);
+}
+
+// Prints the results as the console reporter does and keeps the model op ones to rank them.
+class ModelOpRankingReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override {
+    for (const auto& run : reports) {
+      auto occurrences = run.counters.find("occurrences");
+      if (run.run_type == Run::RT_Iteration && occurrences != run.counters.end()) {
+        const double seconds = run.GetAdjustedRealTime() / benchmark::GetTimeUnitMultiplier(run.time_unit);
+        results_.push_back({run.benchmark_name(), seconds, static_cast<double>(occurrences->second)});
+      }
+    }
+    ConsoleReporter::ReportRuns(reports);
+  }
+
+  void PrintRanking() const {
+    if (results_.empty()) {
+      return;
+    }
+
+    std::vector<Result> ranking = results_;
+    std::sort(ranking.begin(), ranking.end(),
+              [](const Result& a, const Result& b) { return a.Total() > b.Total(); });
+    double total = 0;
+    for (const auto& result : ranking) {
+      total += result.Total();
+    }
+
+    std::cout << "\nModel ops ranked by time x occurrences:\n"
+              << std::left << std::setw(64) << "Benchmark" << std::right << std::setw(12) << "Time (us)"
+              << std::setw(12) << "Count" << std::setw(14) << "Total (us)" << std::setw(10) << "Share" << "\n";
+    for (const auto& result : ranking) {
+      std::cout << std::left << std::setw(64) << result.name.substr(0, 63) << std::right << std::fixed
+                << std::setprecision(2) << std::setw(12) << result.seconds * 1e6 << std::setw(12)
+                << static_cast<int64_t>(result.occurrences) << std::setw(14) << result.Total() * 1e6
+                << std::setw(9) << (total > 0 ? result.Total() / total * 100 : 0) << "%\n";
+    }
+    std::cout << std::endl;
+  }
+
+ private:
+  struct Result {
+    std::string name;
+    double seconds;
+    double occurrences;
+
+    double Total() const { return seconds * occurrences; }
+  };
+
+  std::vector<Result> results_;
+};
+
+}  // namespace
+
+bool ParseModelOpBenchmarkFlags(int* argc, char** argv) {
+  auto& flags = GetFlags();
+  auto value_of = [](const std::string& arg, const std::string& flag, std::string& value) {
+    if (arg.rfind(flag + "=", 0) != 0) {
+      return false;
+    }
+    value = arg.substr(flag.size() + 1);
+    return true;
+  };
+
+  int kept = 1;
+  for (int i = 1; i < *argc; ++i) {
+    const std::string arg = argv[i];
+    std::string value;
+    if (value_of(arg, "--model_ops_model", value)) {
+      flags.model_path = value;
+    } else if (value_of(arg, "--model_ops_eps", value)) {
+      flags.eps = Split(value, ',');
+    } else if (value_of(arg, "--model_ops_dims", value)) {
+      for (const auto& dim : Split(value, ',')) {
+        const auto pos = dim.rfind(':');
+        if (pos == std::string::npos || pos == 0) {
+          std::cerr << "invalid --model_ops_dims entry: " << dim << std::endl;
+          return false;
+        }
+        ORT_TRY {
+          flags.dims[dim.substr(0, pos)] = std::stoll(dim.substr(pos + 1));
+        }
+        ORT_CATCH(...) {
+          std::cerr << "invalid --model_ops_dims entry: " << dim << std::endl;
+          return false;
+        }
+      }
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  *argc = kept;
+  return true;
+}
+
+bool RegisterModelOpBenchmarks() {
+  const auto& flags = GetFlags();
+  if (flags.model_path.empty()) {
+    return true;
+  }
+
+  // the benchmarks refer to the ops until the end of the program
+  static std::vector<ModelOp> ops;
+  size_t skipped = 0;
+  auto status = ExtractModelOps(flags, ops, skipped);
+  if (!status.IsOK()) {
+    std::cerr << "Failed to extract the nodes of " << flags.model_path << ": " << status.ErrorMessage() << std::endl;
+    return false;
+  }
+  std::cout << flags.model_path << ": " << ops.size() << " distinct nodes, " << skipped
+            << " nodes skipped as they have subgraphs or shapes that are not static" << std::endl;
+
+  for (const auto& ep : flags.eps) {
+    for (const auto& op : ops) {
+      benchmark::RegisterBenchmark((kBenchmarkPrefix + ep + "/" + op.name).c_str(), BM_ModelOp, op, ep);
+    }
+  }
+  return true;
+}
+
+void RunSpecifiedBenchmarksWithModelOpRanking() {
+  ModelOpRankingReporter reporter;
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+  reporter.PrintRanking();
+}
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+// Benchmarks of the distinct (op, attributes, input shapes) nodes of a model, each run as a single node session.
+// They are enabled by the flags below, which are removed from the arguments before Google Benchmark parses them:
+//   --model_ops_model=<path>         model to extract the nodes from
+//   --model_ops_eps=<ep>[,<ep>...]   EPs to benchmark the nodes on: cpu (default), cuda or any name accepted by
+//                                    SessionOptions::AppendExecutionProvider, e.g. XNNPACK or QNN
+//   --model_ops_dims=<name>:<value>[,<name>:<value>...]  values of the free dimensions of the model inputs,
+//                                    which are 1 if not set
+// After the benchmarks ran, the nodes are ranked by their time multiplied by the number of times they occur in
+// the model, so the kernels that contribute the most to the model are listed first.
+
+// Removes the flags from argv. Returns false if one of them is invalid.
+bool ParseModelOpBenchmarkFlags(int* argc, char** argv);
+
+// Registers the benchmarks of the model given by the flags, if any. Requires the global env.
+bool RegisterModelOpBenchmarks();
+
+// Runs the benchmarks that match the filter and prints the ranking of the model op benchmarks, if any were run.
+void RunSpecifiedBenchmarksWithModelOpRanking();
@@ -26,6 +26,28 @@ class DummyGraphTransformer : public GraphTransformer {
   }
 };
 
+// Dummy graph transformer that does nothing, but reports the graph as modified for the first num_modifying_runs runs
+// and counts its runs
+class CountingGraphTransformer : public GraphTransformer {
+ public:
+  CountingGraphTransformer(const std::string& name, int num_modifying_runs) noexcept
+      : GraphTransformer(name), num_modifying_runs_(num_modifying_runs) {}
+
+  int NumRuns() const {
+    return num_runs_;
+  }
+
+ private:
+  const int num_modifying_runs_;
+  mutable int num_runs_{0};
+
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/, const logging::Logger&) const override {
+    modified = num_runs_ < num_modifying_runs_;
+    ++num_runs_;
+    return Status::OK();
+  }
+};
+
 // Dummy graph transformer that does nothing, but just sets the modified value
 // This is currently used to test custom transformer selection feature
 class DummyRewriteRule : public RewriteRule {
@@ -19,6 +19,7 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/mlas/inc/mlas_q4.h"
 #include "core/optimizer/attention_fusion.h"
 #include "core/optimizer/bias_dropout_fusion.h"
@@ -38,6 +39,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gather_fusion.h"
@@ -62,6 +64,7 @@
 #include "core/optimizer/matmul_transpose_fusion.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
+#include "core/optimizer/output_pruning.h"
 #include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/pre_shape_node_elimination.h"
 #include "core/optimizer/propagate_cast_ops.h"
@@ -69,7 +72,9 @@
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
+#include "core/optimizer/symbolic_shape_propagation.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/shared_input_matmul_fusion.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
@@ -822,6 +827,43 @@ TEST_F(GraphTransformationTests, ConstantFoldingForOpsWithMissingOptionalInputs)
   ASSERT_TRUE(op_to_count["Reshape"] == 1);
 }
 
+TEST_F(GraphTransformationTests, ConstantFoldingWithMaxOutputSizeRatio) {
+  // Expand a single element to 64 x 64 elements
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({64, 64}, -1.f, 1.f);
+    auto* expand_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* expand_input = builder.MakeInitializer<float>({1}, {1.f});
+    auto* expand_shape = builder.MakeInitializer<int64_t>({2}, {64, 64});
+    builder.AddNode("Expand", {expand_input, expand_shape}, {expand_out});
+    builder.AddNode("Add", {input_arg, expand_out}, {output_arg});
+  };
+
+  auto check_expand_count = [](int expected_count) {
+    return [expected_count](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Expand"] == expected_count);
+      return Status::OK();
+    };
+  };
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+
+  // the 16 KiB output is more than 4 times the size of the inputs
+  ConfigOptions config_options;
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsConstantFoldingMaxOutputSizeRatio, "4"));
+  ASSERT_STATUS_OK(TestGraphTransformer(
+      build_test_case, 13, *logger_,
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, config_options),
+      TransformerLevel::Level1, 1, check_expand_count(1), check_expand_count(1)));
+
+  // no limit by default
+  const ConfigOptions empty_config_options;
+  ASSERT_STATUS_OK(TestGraphTransformer(
+      build_test_case, 13, *logger_,
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, empty_config_options),
+      TransformerLevel::Level1, 1, check_expand_count(1), check_expand_count(0)));
+}
+
 static void VerifyConstantFoldingWithDequantizeLinear(const std::unordered_map<std::string, int>& expected_op_count,
                                                       Graph& graph,
                                                       SessionOptions& session_options,
@@ -3490,6 +3532,72 @@ TEST_F(GraphTransformationTests, ReluClip11FusionGHIssue9753) {
   ASSERT_TRUE(op_to_count["Clip"] == 1);
 }
 
+// Reshape nodes with target shapes computed from the symbolic dimensions of the input:
+// [batch, seq, 768] -> [batch * seq, -1] and [batch, seq, 12, -1]
+TEST_F(GraphTransformationTests, SymbolicShapePropagationReshapeTest) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", "seq", 768});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* batch_out = builder.MakeIntermediate();
+    auto* seq_out = builder.MakeIntermediate();
+    auto* batch_seq_out = builder.MakeIntermediate();
+    auto* unsqueeze_batch_out = builder.MakeIntermediate();
+    auto* unsqueeze_seq_out = builder.MakeIntermediate();
+    auto* unsqueeze_batch_seq_out = builder.MakeIntermediate();
+    auto* concat_2d_out = builder.MakeIntermediate();
+    auto* concat_4d_out = builder.MakeIntermediate();
+    auto* reshape_2d_out = builder.MakeOutput();
+    auto* reshape_4d_out = builder.MakeOutput();
+
+    auto* axes = builder.MakeInitializer<int64_t>({1}, {0});
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(0)}, {batch_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(1)}, {seq_out});
+    builder.AddNode("Mul", {batch_out, seq_out}, {batch_seq_out});
+    builder.AddNode("Unsqueeze", {batch_out, axes}, {unsqueeze_batch_out});
+    builder.AddNode("Unsqueeze", {seq_out, axes}, {unsqueeze_seq_out});
+    builder.AddNode("Unsqueeze", {batch_seq_out, axes}, {unsqueeze_batch_seq_out});
+    builder.AddNode("Concat", {unsqueeze_batch_seq_out, builder.MakeInitializer<int64_t>({1}, {-1})},
+                    {concat_2d_out})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Concat", {unsqueeze_batch_out, unsqueeze_seq_out, builder.MakeInitializer<int64_t>({2}, {12, -1})},
+                    {concat_4d_out})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Reshape", {input_arg, concat_2d_out}, {reshape_2d_out});
+    builder.AddNode("Reshape", {input_arg, concat_4d_out}, {reshape_4d_out});
+  };
+
+  auto check_output_shape = [](const Graph& graph, const std::vector<std::variant<int64_t, std::string>>& expected) {
+    for (const auto& node : graph.Nodes()) {
+      const auto* shape = node.OutputDefs()[0]->Shape();
+      if (node.OpType() != "Reshape" || shape == nullptr || shape->dim_size() != static_cast<int>(expected.size())) {
+        continue;
+      }
+      for (int i = 0; i < shape->dim_size(); ++i) {
+        const auto& dim = shape->dim(i);
+        if (std::holds_alternative<int64_t>(expected[i]) ? dim.dim_value() != std::get<int64_t>(expected[i])
+                                                         : dim.dim_param() != std::get<std::string>(expected[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  };
+
+  auto pre_graph_checker = [&](Graph&) { return Status::OK(); };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(check_output_shape(graph, {"batch*seq", 768}));
+    TEST_RETURN_IF_NOT(check_output_shape(graph, {"batch", "seq", 12, 64}));
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SymbolicShapePropagation>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer), TransformerLevel::Level1,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
 // Test Reshape Fusion with 2 constant initializers for Concat inputs.
 TEST_F(GraphTransformationTests, ReshapeFusionTest) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/reshape.onnx";
@@ -5310,10 +5418,10 @@ struct BiasSoftmaxFusionTester {
   }
 };
 
-TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_GpuOnly) {
+TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Simple_Cpu) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/bias_softmax_fusion_simple.onnx";
   BiasSoftmaxFusionTester tester(model_uri, logger_.get(), kCpuExecutionProvider);
-  tester.TestNoFusionOccurs();
+  tester.TestFusionOccurs(1, true);
 }
 
 TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Simple_Rocm) {
@@ -5456,8 +5564,8 @@ TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_OpSet13InValidAxis) {
   };
 
   std::unique_ptr<GraphTransformer> transformer = std::make_unique<BiasSoftmaxFusion>();
-  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2, 1,
-                                        pre_graph_checker, post_graph_checker));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
 }
 
 static void TestBiasDropoutFusion(const PathString& file_path, const logging::Logger& logger, const int add_count = 0) {
@@ -6313,6 +6421,275 @@ TEST_F(GraphTransformationTests, PropagateCastOpsTests_Softmax) {
 
 #endif
 
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+// Conv and the Relu that follows it run in float16 on the CPU EP, the Softmax stays in float.
+TEST_F(GraphTransformationTests, Float16ConversionTest) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 8, 6, 6}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({8, 8, 3, 3}, -0.5f, 0.5f);
+    auto* bias_arg = builder.MakeInitializer<float>({8}, -0.5f, 0.5f);
+    auto* conv_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Conv", {input_arg, weight_arg, bias_arg}, {conv_out});
+    builder.AddNode("Relu", {conv_out}, {relu_out});
+    builder.AddNode("Softmax", {relu_out}, {output_arg});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Conv"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 1);
+    // the graph input is cast to float16 and the Relu output back to float
+    EXPECT_EQ(op_to_count["Cast"], 2);
+
+    for (const auto& node : graph.Nodes()) {
+      const auto elem_type = node.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
+      if (node.OpType() == "Conv" || node.OpType() == "Relu") {
+        EXPECT_EQ(elem_type, ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+      } else if (node.OpType() == "Softmax") {
+        EXPECT_EQ(elem_type, ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      }
+    }
+  };
+
+  auto add_session_options = [](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsFloat16Conversion, "fp16"));
+  };
+
+  // the conversion only runs at Level2 and above, so the baseline runs in float
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    0.01, 0.01, nullptr, add_session_options, {"ConvActivationFusion"});
+}
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+#if !defined(DISABLE_CONTRIB_OPS)
+// The Gather of the last token logits is moved before the LM head MatMul and the normalization, so that they only
+// compute one row per batch.
+TEST_F(GraphTransformationTests, UpStreamGatherForInference) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 16}, -1.f, 1.f);
+    auto* scale_arg = builder.MakeInitializer<float>({16}, 0.5f, 1.5f);
+    auto* weight_arg = builder.MakeInitializer<float>({16, 32}, -0.5f, 0.5f);
+    auto* indices_arg = builder.MakeScalarInitializer<int64_t>(-1);
+    auto* norm_out = builder.MakeIntermediate();
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("SimplifiedLayerNormalization", {input_arg, scale_arg}, {norm_out});
+    builder.AddNode("MatMul", {norm_out, weight_arg}, {matmul_out});
+    builder.AddNode("Gather", {matmul_out, indices_arg}, {output_arg}).AddAttribute("axis", static_cast<int64_t>(1));
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Gather"], 1);
+    EXPECT_EQ(op_to_count["SimplifiedLayerNormalization"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Gather") {
+        EXPECT_EQ(node.InputDefs()[0]->Name(), graph.GetInputs()[0]->Name());
+      }
+    }
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13);
+}
+
+// The MatMuls sharing the input are fused into one MatMul with the concatenated weights, followed by a Split.
+TEST_F(GraphTransformationTests, SharedInputMatMulFusion) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, 8}, -1.f, 1.f);
+    for (int64_t n : {4, 6, 4}) {
+      auto* weight_arg = builder.MakeInitializer<float>({8, n}, -0.5f, 0.5f);
+      builder.AddNode("MatMul", {input_arg, weight_arg}, {builder.MakeOutput()});
+    }
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+    EXPECT_EQ(op_to_count["Split"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13);
+}
+
+// The Gather on the sequence dimension is moved before MatMulNBits, which then only computes the gathered rows.
+TEST_F(GraphTransformationTests, UpStreamGatherForInferenceMatMulNBits) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    constexpr size_t qbits = 4;
+    constexpr size_t block_size = 16;
+    constexpr int64_t K = 16, N = 32;
+
+    int q_rows, q_cols;
+    MlasBlockwiseQuantizedShape<float, qbits>(block_size, /* columnwise */ true, K, N, q_rows, q_cols);
+    size_t q_data_size_in_bytes, q_scale_size, q_zp_size_in_bytes;
+    MlasBlockwiseQuantizedBufferSizes(qbits, block_size, /* columnwise */ true, K, N,
+                                      q_data_size_in_bytes, q_scale_size, &q_zp_size_in_bytes);
+
+    auto* input_arg = builder.MakeInput<float>({2, 8, K}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<uint8_t>({int64_t{q_rows}, int64_t{q_cols}}, uint8_t{0}, uint8_t{255});
+    auto* scales_arg = builder.MakeInitializer<float>({static_cast<int64_t>(q_scale_size)}, 0.5f, 1.5f);
+    auto* indices_arg = builder.MakeScalarInitializer<int64_t>(-1);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    auto& matmul = builder.AddNode("MatMulNBits", {input_arg, weight_arg, scales_arg}, {matmul_out}, kMSDomain);
+    matmul.AddAttribute("N", N);
+    matmul.AddAttribute("K", K);
+    matmul.AddAttribute("block_size", static_cast<int64_t>(block_size));
+    matmul.AddAttribute("bits", static_cast<int64_t>(qbits));
+    builder.AddNode("Gather", {matmul_out, indices_arg}, {output_arg}).AddAttribute("axis", static_cast<int64_t>(1));
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Gather"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Gather") {
+        EXPECT_EQ(node.InputDefs()[0]->Name(), graph.GetInputs()[0]->Name());
+      }
+    }
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 21);
+}
+
+// Adds MatMulNBits nodes consuming input_arg with 4 bit weights of shape [K, n] for each n in ns, and with zero points
+// of zero_point_sizes[i] bytes.
+static void AddSharedInputMatMulNBits(ModelTestBuilder& builder, NodeArg* input_arg, int64_t K, int64_t block_size,
+                                      const std::vector<int64_t>& ns, const std::vector<int64_t>& zero_point_sizes) {
+  const int64_t blocks_per_column = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * 4 / 8;
+  for (size_t i = 0; i < ns.size(); ++i) {
+    auto* weight_arg = builder.MakeInitializer<uint8_t>({ns[i], blocks_per_column, blob_size}, uint8_t{0}, uint8_t{255});
+    auto* scales_arg = builder.MakeInitializer<float>({ns[i] * blocks_per_column}, 0.5f, 1.5f);
+    auto* zero_points_arg = builder.MakeInitializer<uint8_t>({zero_point_sizes[i]}, uint8_t{0}, uint8_t{255});
+    auto& matmul = builder.AddNode("MatMulNBits", {input_arg, weight_arg, scales_arg, zero_points_arg},
+                                   {builder.MakeOutput()}, kMSDomain);
+    matmul.AddAttribute("N", ns[i]);
+    matmul.AddAttribute("K", K);
+    matmul.AddAttribute("block_size", block_size);
+    matmul.AddAttribute("bits", static_cast<int64_t>(4));
+  }
+}
+
+// The MatMulNBits nodes sharing the input are fused, including the zero points of odd numbers of 4 bit values.
+TEST_F(GraphTransformationTests, SharedInputMatMulNBitsFusion) {
+  // 3 blocks per column, so each column has an odd number of zero points, padded to 2 bytes
+  constexpr int64_t K = 48, block_size = 16;
+  const std::vector<int64_t> ns{5, 3, 8};
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, K}, -1.f, 1.f);
+    AddSharedInputMatMulNBits(builder, input_arg, K, block_size, ns, {ns[0] * 2, ns[1] * 2, ns[2] * 2});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+    EXPECT_EQ(op_to_count["Split"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 21,
+                    1e-5, 1e-5);
+}
+
+// Zero points packed across the columns can't be concatenated byte by byte, so the nodes are not fused.
+TEST_F(GraphTransformationTests, SharedInputMatMulNBitsFusionZeroPointsPackedAcrossColumns) {
+  constexpr int64_t K = 48, block_size = 16;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, K}, -1.f, 1.f);
+    // (N * blocks_per_column + 1) / 2 bytes
+    AddSharedInputMatMulNBits(builder, input_arg, K, block_size, {5, 3}, {8, 5});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.MatMulNBits"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Split"] == 0);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 21, *logger_, std::make_unique<SharedInputMatMulFusion>(),
+                                        TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+}
+#endif  // !defined(DISABLE_CONTRIB_OPS)
+
+// Softmax before opset 13 normalizes over the dims from axis 1 on by default, so a Gather on dim 1 of its output
+// can't be moved before it.
+TEST_F(GraphTransformationTests, UpStreamGatherForInferenceSoftmaxOpset11DefaultAxis) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 16}, -1.f, 1.f);
+    auto* indices_arg = builder.MakeScalarInitializer<int64_t>(-1);
+    auto* softmax_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Softmax", {input_arg}, {softmax_out});
+    builder.AddNode("Gather", {softmax_out, indices_arg}, {output_arg}).AddAttribute("axis", static_cast<int64_t>(1));
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Gather"], 1);
+    EXPECT_EQ(op_to_count["Softmax"], 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Gather") {
+        EXPECT_EQ(graph.GetProducerNode(node.InputDefs()[0]->Name())->OpType(), "Softmax");
+      }
+    }
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 11);
+}
+
+TEST_F(GraphTransformationTests, OutputPruning) {
+  Model model("OutputPruning", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 13}}, {}, *logger_);
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder builder(graph);
+
+  auto* input_arg = builder.MakeInput<float>({2, 3}, -1.f, 1.f);
+  auto* scale_arg = builder.MakeInitializer<float>({2, 3}, -1.f, 1.f);
+  auto* sigmoid_out = builder.MakeIntermediate();
+  auto* kept_output_arg = builder.MakeOutput();
+  auto* pruned_output_arg = builder.MakeOutput();
+  builder.AddNode("Relu", {input_arg}, {kept_output_arg});
+  builder.AddNode("Sigmoid", {input_arg}, {sigmoid_out});
+  builder.AddNode("Mul", {sigmoid_out, scale_arg}, {pruned_output_arg});
+  builder.SetGraphOutputs();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<OutputPruning>(InlinedHashSet<std::string>{kept_output_arg->Name()}), TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  auto op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Sigmoid"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), kept_output_arg->Name());
+  EXPECT_EQ(graph.GetAllInitializedTensors().size(), 0u);
+
+  // an output that is not in the graph is an error
+  GraphTransformerManager invalid_output_mgr{1};
+  ASSERT_STATUS_OK(invalid_output_mgr.Register(
+      std::make_unique<OutputPruning>(InlinedHashSet<std::string>{"unknown"}), TransformerLevel::Level1));
+  ASSERT_STATUS_NOT_OK(invalid_output_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+}
+
 /*
 Test graph include multiple equivalent subgraphs as below.
            graph input [1, 1, 256, 256] (int64_t)
@@ -7733,6 +8110,169 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, MatMulNBitsEpilogueFusion) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    constexpr size_t qbits = 4;
+    constexpr size_t block_size = 32;
+
+    constexpr int64_t M = 2, K = 4, N = 8;
+
+    int q_rows, q_cols;
+    MlasBlockwiseQuantizedShape<float, qbits>(block_size, /* columnwise */ true,
+                                              K, N,
+                                              q_rows, q_cols);
+
+    size_t q_data_size_in_bytes, q_scale_size, q_zp_size_in_bytes;
+    MlasBlockwiseQuantizedBufferSizes(qbits, block_size, /* columnwise */ true,
+                                      K, N,
+                                      q_data_size_in_bytes, q_scale_size, &q_zp_size_in_bytes);
+
+    auto* A = builder.MakeInput<float>(std::vector{M, K}, "A");
+
+    auto* B_data = builder.MakeInitializer<uint8_t>({int64_t{q_rows}, int64_t{q_cols}},
+                                                    uint8_t{0}, uint8_t{255});
+    auto* B_scales = builder.MakeInitializer<float>({static_cast<int64_t>(q_scale_size)},
+                                                    1.0f, 2.0f);
+
+    auto* matmul_output = builder.MakeIntermediate();
+
+    auto& matmul = builder.AddNode("MatMulNBits",
+                                   {A, B_data, B_scales},
+                                   {matmul_output},
+                                   kMSDomain);
+    matmul.AddAttribute("N", N);
+    matmul.AddAttribute("K", K);
+    matmul.AddAttribute("block_size", static_cast<int64_t>(block_size));
+    matmul.AddAttribute("bits", static_cast<int64_t>(qbits));
+
+    // bias, then the SiLU of a SwiGLU block, then the residual connection
+    auto* Bias = builder.MakeInput<float>(std::vector{N}, "Bias");
+    auto* Up = builder.MakeInput<float>(std::vector{M, N}, "Up");
+    auto* Residual = builder.MakeInput<float>(std::vector{M, N}, "Residual");
+
+    auto* bias_output = builder.MakeIntermediate(std::vector{M, N});
+    auto* sigmoid_output = builder.MakeIntermediate(std::vector{M, N});
+    auto* silu_output = builder.MakeIntermediate(std::vector{M, N});
+    auto* mul_output = builder.MakeIntermediate(std::vector{M, N});
+    auto* graph_output = builder.MakeOutput();
+
+    builder.AddNode("Add", {matmul_output, Bias}, {bias_output});
+    builder.AddNode("Sigmoid", {bias_output}, {sigmoid_output});
+    builder.AddNode("Mul", {bias_output, sigmoid_output}, {silu_output});
+    builder.AddNode("Mul", {Up, silu_output}, {mul_output});
+    builder.AddNode("Add", {mul_output, Residual}, {graph_output});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_count["Add"], 2);
+    EXPECT_EQ(op_count["Sigmoid"], 1);
+    EXPECT_EQ(op_count["Mul"], 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_count["Add"], 0);
+    EXPECT_EQ(op_count["Sigmoid"], 0);
+    EXPECT_EQ(op_count["Mul"], 0);
+    EXPECT_EQ(op_count["com.microsoft.MatMulNBits"], 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "MatMulNBits") {
+        EXPECT_EQ(node.GetAttributes().at("activation").s(), "silu");
+        EXPECT_EQ(node.InputDefs().size(), size_t{8});
+        EXPECT_EQ(node.InputDefs()[6]->Name(), "Up");
+        EXPECT_EQ(node.InputDefs()[7]->Name(), "Residual");
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 21, *logger_, std::make_unique<MatMulNBitsFusion>(),
+                                        TransformerLevel::Level2, 5, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({{2, 3, 4}});
+    auto* y_arg = builder.MakeInput<float>({{2, 3, 4}});
+    auto* scale_arg = builder.MakeScalarInitializer<float>(2.0f);
+    auto* bias_arg = builder.MakeInitializer<float>({4}, {1.0f, 2.0f, 3.0f, 4.0f});
+
+    // x * Sigmoid(x * 2 + y) is fused into one node
+    auto* mul_out_0 = builder.MakeIntermediate();
+    auto* add_out_0 = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    auto* mul_out_1 = builder.MakeOutput();
+    builder.AddNode("Mul", {x_arg, scale_arg}, {mul_out_0});
+    builder.AddNode("Add", {mul_out_0, y_arg}, {add_out_0});
+    builder.AddNode("Sigmoid", {add_out_0}, {sigmoid_out});
+    builder.AddNode("Mul", {sigmoid_out, x_arg}, {mul_out_1});
+
+    // the bias is broadcast so the chain starts after the Add
+    auto* add_out_1 = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeOutput();
+    builder.AddNode("Add", {x_arg, bias_arg}, {add_out_1});
+    builder.AddNode("Tanh", {add_out_1}, {tanh_out});
+    builder.AddNode("Relu", {tanh_out}, {relu_out});
+
+    // the Neg has two consumers so it is not fused, and neither is any of them alone
+    auto* neg_out = builder.MakeIntermediate();
+    auto* exp_out = builder.MakeOutput();
+    auto* abs_out = builder.MakeOutput();
+    builder.AddNode("Neg", {x_arg}, {neg_out});
+    builder.AddNode("Exp", {neg_out}, {exp_out});
+    builder.AddNode("Abs", {neg_out}, {abs_out});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Tanh"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Tanh"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Neg"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Exp"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Abs"] == 1);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() != "FusedElementwise") {
+        continue;
+      }
+      const auto& attrs = node.GetAttributes();
+      const auto& ops = attrs.at("ops").strings();
+      const auto& operands = attrs.at("operands").ints();
+      if (ops.size() == 4) {
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 3);
+        TEST_RETURN_IF_NOT(ops[0] == "Mul" && ops[1] == "Add" && ops[2] == "Sigmoid" && ops[3] == "Mul");
+        const std::vector<int64_t> expected_operands{0, 1, 3, 2, 4, -1, 5, 0};
+        TEST_RETURN_IF_NOT(std::vector<int64_t>(operands.begin(), operands.end()) == expected_operands);
+      } else {
+        TEST_RETURN_IF_NOT(ops.size() == 2 && ops[0] == "Tanh" && ops[1] == "Relu");
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 1);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
@@ -516,6 +516,45 @@ TEST(NhwcTransformerTests, ConvMixTensorRanks) {
                     TransformerLevel::Level3);
 }
 
+TEST(NhwcTransformerTests, ConvAddReluFloat) {
+  if (MlasNchwcGetBlockSize() > 1) {
+    GTEST_SKIP() << "Skipping test because float convolutions are taken by the NCHWc transformer.";
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 16, 13, 13}, -1.5f, 1.5f);
+    auto* conv1_output_arg = builder.MakeIntermediate();
+    auto* conv2_output_arg = builder.MakeIntermediate();
+    auto* add_output_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* conv1_weight_arg = builder.MakeInitializer<float>({16, 16, 3, 3}, -0.5f, 0.5f);
+    auto* conv2_weight_arg = builder.MakeInitializer<float>({16, 16, 3, 3}, -0.5f, 0.5f);
+    auto* conv2_bias_arg = builder.MakeInitializer<float>({16}, -0.5f, 0.5f);
+
+    Node& conv1_node = builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    Node& conv2_node = builder.AddNode("Conv", {conv1_output_arg, conv2_weight_arg, conv2_bias_arg},
+                                       {conv2_output_arg});
+    conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    builder.AddNode("Add", {conv2_output_arg, conv1_output_arg}, {add_output_arg});
+    builder.AddNode("Relu", {add_output_arg}, {output_arg});
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 2);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12, 0.0001, 0.000001);
+}
+
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
 
 static std::vector<MLFloat16> ARangeOfFP16Values(const std::vector<int64_t>& shape, MLFloat16 min, MLFloat16 max) {
@@ -7,10 +7,12 @@
 #include "core/framework/compute_capability.h"
 #include "core/framework/node_unit.h"
 #include "core/framework/int4.h"
+#include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/optimizer/double_qdq_pairs_remover.h"
+#include "core/optimizer/qdq_transformer/dq_matmul_float8_fusion.h"
 #include "core/optimizer/qdq_transformer/qdq_final_cleanup.h"
 #include "core/optimizer/qdq_transformer/qdq_propagation.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
@@ -980,6 +982,43 @@ TEST(QDQTransformerTests, ReshapeDropQDQ) {
   RunReshapeDropQDQTestCase<uint16_t>({1, 3, 2, 2}, {1, 12}, false, 21);  // Use int16 ONNX QDQ ops
 }
 
+// Runs a test case that checks if Q/DQ nodes are dropped from DQ -> Pad -> Q.
+template <typename QuantType>
+static void RunPadDropQDQTestCase(const std::string& mode, QuantType zero_point, bool expect_drop) {
+  auto build_test_case = [mode, zero_point](ModelTestBuilder& builder) {
+    constexpr QuantType qmin = std::numeric_limits<QuantType>::min();
+    constexpr QuantType qmax = std::numeric_limits<QuantType>::max();
+
+    auto* input_arg = builder.MakeInput<QuantType>({1, 3, 4, 4}, qmin, qmax);
+    auto* pads_arg = builder.Make1DInitializer<int64_t>({0, 0, 1, 1, 0, 0, 1, 1});
+    auto* output_arg = builder.MakeOutput();
+    auto* input_arg_dq = builder.MakeIntermediate();
+    auto* pad_output = builder.MakeIntermediate();
+
+    builder.AddDequantizeLinearNode<QuantType>(input_arg, .003f, zero_point, input_arg_dq);
+    builder.AddNode("Pad", {input_arg_dq, pads_arg}, {pad_output}).AddAttribute("mode", mode);
+    builder.AddQuantizeLinearNode<QuantType>(pad_output, .003f, zero_point, output_arg);
+  };
+
+  auto check_graph = [expect_drop](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["Pad"], 1);
+    EXPECT_EQ(op_to_count["QuantizeLinear"], expect_drop ? 0 : 1);
+    EXPECT_EQ(op_to_count["DequantizeLinear"], expect_drop ? 0 : 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13);
+}
+
+TEST(QDQTransformerTests, PadDropQDQ) {
+  RunPadDropQDQTestCase<uint8_t>("constant", 0, true);
+  RunPadDropQDQTestCase<int8_t>("constant", 0, true);
+  RunPadDropQDQTestCase<uint8_t>("reflect", 128, true);
+  RunPadDropQDQTestCase<uint8_t>("edge", 128, true);
+  // the quantized Pad would pad with 0 instead of the zero point
+  RunPadDropQDQTestCase<uint8_t>("constant", 128, false);
+}
+
 // Runs a test case that checks if Q/DQ nodes are *not* dropped from DQ -> MaxPool -> Q if the quantization scale is
 // negative.
 template <typename QuantType>
@@ -2861,6 +2900,64 @@ TEST(QDQTransformerTests, ReluQuantFusion_Level2Only) {
   test_case(TransformerLevel::Level3, 0);     // Will not fuse Relu into QuantizeLinear due to zero-point != -128
 }
 
+#if !defined(DISABLE_CONTRIB_OPS)
+TEST(QDQTransformerTests, SkipLayerNormQuantFusion) {
+  auto test_case = [&](bool produce_sum) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({2, 3, 16}, -1.0f, 1.0f);
+      auto* skip_arg = builder.MakeInput<float>({2, 3, 16}, -1.0f, 1.0f);
+      auto* gamma_arg = builder.MakeInitializer<float>({16}, 0.5f, 1.5f);
+      auto* beta_arg = builder.MakeInitializer<float>({16}, -0.5f, 0.5f);
+      auto* output_arg = builder.MakeOutput();
+
+      // add SkipLayerNormalization, optionally consuming its sum output
+      auto* sln_output = builder.MakeIntermediate();
+      std::vector<NodeArg*> sln_outputs{sln_output};
+      NodeArg* sum_output = nullptr;
+      if (produce_sum) {
+        sum_output = builder.MakeIntermediate();
+        sln_outputs.push_back(builder.MakeEmptyInput());
+        sln_outputs.push_back(builder.MakeEmptyInput());
+        sln_outputs.push_back(sum_output);
+      }
+      Node& sln_node = builder.AddNode("SkipLayerNormalization", {input_arg, skip_arg, gamma_arg, beta_arg},
+                                       sln_outputs, kMSDomain);
+      sln_node.AddAttribute("epsilon", 1e-5f);
+
+      // add Q + DQ
+      auto* q_output = builder.MakeIntermediate();
+      builder.AddQuantizeLinearNode<uint8_t>(sln_output, 0.02f, 128, q_output);
+      if (produce_sum) {
+        auto* dq_output = builder.MakeIntermediate();
+        builder.AddDequantizeLinearNode<uint8_t>(q_output, 0.02f, 128, dq_output);
+        builder.AddNode("Add", {dq_output, sum_output}, {output_arg});
+      } else {
+        builder.AddDequantizeLinearNode<uint8_t>(q_output, 0.02f, 128, output_arg);
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      const QDQOpKeys qdq_keys = GetQDQOpKeys(false);
+      EXPECT_EQ(op_to_count["com.microsoft.QSkipLayerNormalization"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.SkipLayerNormalization"], 0);
+      EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 0);
+      EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      18,
+                      0.02f,
+                      0.02f);
+  };
+
+  test_case(false);
+  test_case(true);
+}
+#endif  // !defined(DISABLE_CONTRIB_OPS)
+
 TEST(QDQTransformerTests, Concat) {
   auto test_case = [&](const std::vector<std::vector<int64_t>>& input_shapes,
                        int64_t axis,
@@ -3274,6 +3371,36 @@ TEST(QDQTransformerTests, QDQPropagation_DQForward) {
 #endif
 }
 
+TEST(QDQTransformerTests, QDQPropagation_DQForwardGather) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<uint8_t>({4, 8}, std::numeric_limits<uint8_t>::min(),
+                                                 std::numeric_limits<uint8_t>::max());
+    auto* indices_arg = builder.MakeInitializer<int64_t>({2, 3}, 0, 3);
+    auto* output_arg = builder.MakeOutput();
+
+    auto* dq_output = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<uint8_t>(input_arg, 0.004f, 129, dq_output);
+
+    auto* gather_output = builder.MakeIntermediate();
+    builder.AddNode("Gather", {dq_output, indices_arg}, {gather_output});
+
+    // add Sign as boundary for QDQ propagation
+    builder.AddNode("Sign", {gather_output}, {output_arg});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    const std::vector<std::string> expected_op_types_in_order{
+        "DequantizeLinear",
+        "Gather",
+        "QuantizeLinear", "DequantizeLinear",
+        "Sign"};
+    const auto op_types_in_order = GetNodeOpTypesInTopologicalOrder(session.GetGraph(), true);
+    EXPECT_EQ(op_types_in_order, expected_op_types_in_order);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level1, 13);
+}
+
 TEST(QDQTransformerTests, QDQPropagation_StopAtOtherQDQ) {
   auto test_case = [&](const std::vector<int64_t>& input_shape, bool same_scale, bool same_zp,
                        bool use_contrib_qdq) {
@@ -4555,5 +4682,69 @@ TEST(QDQTransformerTests, DropDQSelectorWithDQProducingGraphOutput) {
 }
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
+#if !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_FLOAT8_TYPES)
+// A (float8) -> DQ -> MatMul <- DQ <- B (float8 initializer or input)
+TEST(QDQTransformerTests, DQMatMulFloat8Fusion) {
+  auto test_case = [&](bool b_is_initializer) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      std::vector<Float8E4M3FN> a_data;
+      std::vector<Float8E4M3FN> b_data;
+      for (int i = 0; i < 4 * 8; ++i) {
+        a_data.emplace_back(static_cast<float>(i % 5) - 2.0f);
+      }
+      for (int i = 0; i < 8 * 3; ++i) {
+        b_data.emplace_back(static_cast<float>(i % 3) - 1.0f);
+      }
+
+      auto* a_arg = builder.MakeInput<Float8E4M3FN>({4, 8}, a_data);
+      auto* b_arg = b_is_initializer ? builder.MakeInitializer<Float8E4M3FN>({8, 3}, b_data)
+                                     : builder.MakeInput<Float8E4M3FN>({8, 3}, b_data);
+      auto* a_dq = builder.MakeIntermediate();
+      auto* b_dq = builder.MakeIntermediate();
+      builder.AddNode("DequantizeLinear", {a_arg, builder.MakeScalarInitializer<float>(0.5f)}, {a_dq});
+      builder.AddNode("DequantizeLinear", {b_arg, builder.MakeScalarInitializer<float>(0.25f)}, {b_dq});
+      builder.AddNode("MatMul", {a_dq, b_dq}, {builder.MakeOutput()});
+    };
+
+    auto pre_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 2);
+      TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      if (!b_is_initializer) {
+        TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 2);
+        TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 0);
+        return Status::OK();
+      }
+
+      TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 1);
+      for (const auto& node : graph.Nodes()) {
+        if (node.OpType() == "GemmFloat8") {
+          // B is transposed to (N, K).
+          const auto* b_initializer = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+          TEST_RETURN_IF_NOT(b_initializer != nullptr);
+          TEST_RETURN_IF_NOT(b_initializer->dims(0) == 3 && b_initializer->dims(1) == 8);
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "transB")->i() == 1);
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 21, DefaultLoggingManager().DefaultLogger(),
+                                          std::make_unique<DQMatMulFloat8Fusion>(), TransformerLevel::Level2, 1,
+                                          pre_graph_checker, post_graph_checker));
+  };
+
+  test_case(true);
+  test_case(false);
+}
+#endif  // !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_FLOAT8_TYPES)
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -71,5 +71,31 @@ TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   ASSERT_STATUS_OK(graph_transformation_mgr.GetSteps(steps_queried));
   ASSERT_EQ(steps_queried, static_cast<unsigned>(10));
 }
+
+TEST(RuleBasedGraphTransformerTest, TestSkippingTransformersOnUnchangedGraph) {
+  auto model_uri = ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx");
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  Graph& graph = model->MainGraph();
+
+  // the first transformer modifies the graph in its first two runs, the second one never does
+  auto modifying_transformer = std::make_unique<CountingGraphTransformer>("ModifyingTransformer", 2);
+  const auto* modifying_transformer_ptr = modifying_transformer.get();
+  auto unmodifying_transformer = std::make_unique<CountingGraphTransformer>("UnmodifyingTransformer", 0);
+  const auto* unmodifying_transformer_ptr = unmodifying_transformer.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(modifying_transformer), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(unmodifying_transformer), TransformerLevel::Level2));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2,
+                                                              DefaultLoggingManager().DefaultLogger()));
+
+  // the modifying transformer runs until it no longer modifies the graph. the unmodifying transformer runs once
+  // after each modification, and is skipped in the step where the graph did not change before it.
+  ASSERT_EQ(modifying_transformer_ptr->NumRuns(), 3);
+  ASSERT_EQ(unmodifying_transformer_ptr->NumRuns(), 2);
+}
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
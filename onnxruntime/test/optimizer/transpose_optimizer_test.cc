@@ -4988,5 +4988,97 @@ TEST(TransposeOptimizerTests, SharedInitializerHandlingBroadcast2) {
   ASSERT_THAT(fetches_orig[0].Get<Tensor>().DataAsSpan<float>(),
               testing::ContainerEq(fetches[0].Get<Tensor>().DataAsSpan<float>()));
 }
+
+// Optimize reports the net number of Transpose nodes it removed. Additional passes must not undo the first one.
+TEST(TransposeOptimizerTests, ReportRemovedTransposes) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 15}};
+  Model model("TransposeOptimizerTests", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder builder(graph);
+
+  auto* input_arg = builder.MakeInput<float>({1, 2, 3, 4}, 0.0f, 1.0f);
+  auto* transpose_1_out = builder.MakeIntermediate();
+  auto* relu_out = builder.MakeIntermediate();
+  auto* transpose_2_out = builder.MakeIntermediate();
+  auto* output_arg = builder.MakeOutput();
+  builder.AddNode("Transpose", {input_arg}, {transpose_1_out}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  builder.AddNode("Relu", {transpose_1_out}, {relu_out});
+  builder.AddNode("Transpose", {relu_out}, {transpose_2_out}).AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  builder.AddNode("Identity", {transpose_2_out}, {output_arg});
+  builder.SetGraphOutputs();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  using namespace onnx_transpose_optimization;
+  auto api_graph = MakeApiGraph(graph, TestCPUExecutionProvider()->CreatePreferredAllocators()[0],
+                                /*new_node_ep*/ nullptr);
+
+  OptimizeResult result = Optimize(*api_graph, /*provider_type*/ "", /*cost_check_fn*/ nullptr,
+                                   /*extended_handlers*/ {}, /*max_passes*/ 3);
+
+  ASSERT_EQ(result.error_msg, std::nullopt);
+  ASSERT_TRUE(result.graph_modified);
+  EXPECT_EQ(result.num_transposes_removed, 2);
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(CountOpsInGraph(graph)["Transpose"], 0);
+}
+
+// Pushing the Transposes through the Concat leaves a Transpose on its input from the Relu, which was already visited.
+// Only a second pass pushes the Transpose before the Relu through it, where it cancels with the new one.
+TEST(TransposeOptimizerTests, AdditionalPassesRemoveTransposesBeforeVisitedNodes) {
+  auto optimize = [](size_t max_passes, int64_t& num_transposes_removed, int& num_transposes_left) {
+    std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 15}};
+    Model model("TransposeOptimizerTests", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+    Graph& graph = model.MainGraph();
+    ModelTestBuilder builder(graph);
+
+    // Concat(Transpose(x0), Transpose(x1), Transpose(x2), Relu(Transpose(x3)))
+    // the output of the Relu leads to no Transpose when the first pass starts, so the Relu is not changed by it.
+    std::vector<NodeArg*> concat_inputs;
+    for (int i = 0; i < 4; ++i) {
+      auto* input_arg = builder.MakeInput<float>({1, 2, 3, 4}, 0.0f, 1.0f);
+      auto* transpose_out = builder.MakeIntermediate();
+      builder.AddNode("Transpose", {input_arg}, {transpose_out})
+          .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+      if (i == 3) {
+        auto* relu_out = builder.MakeIntermediate();
+        builder.AddNode("Relu", {transpose_out}, {relu_out});
+        transpose_out = relu_out;
+      }
+      concat_inputs.push_back(transpose_out);
+    }
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("Concat", concat_inputs, {output_arg}).AddAttribute("axis", static_cast<int64_t>(3));
+    builder.SetGraphOutputs();
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    using namespace onnx_transpose_optimization;
+    auto api_graph = MakeApiGraph(graph, TestCPUExecutionProvider()->CreatePreferredAllocators()[0],
+                                  /*new_node_ep*/ nullptr);
+
+    OptimizeResult result = Optimize(*api_graph, /*provider_type*/ "", /*cost_check_fn*/ nullptr,
+                                     /*extended_handlers*/ {}, max_passes);
+
+    ASSERT_EQ(result.error_msg, std::nullopt);
+    ASSERT_TRUE(result.graph_modified);
+    ASSERT_STATUS_OK(graph.Resolve());
+    num_transposes_removed = result.num_transposes_removed;
+    num_transposes_left = CountOpsInGraph(graph)["Transpose"];
+  };
+
+  int64_t num_transposes_removed = 0;
+  int num_transposes_left = 0;
+
+  // the Transposes before and after the Relu are left, and one after the Concat is added
+  optimize(1, num_transposes_removed, num_transposes_left);
+  EXPECT_EQ(num_transposes_removed, 1);
+  EXPECT_EQ(num_transposes_left, 3);
+
+  // only the Transpose after the Concat is left
+  optimize(3, num_transposes_removed, num_transposes_left);
+  EXPECT_EQ(num_transposes_removed, 3);
+  EXPECT_EQ(num_transposes_left, 1);
+}
 }  // namespace test
 }  // namespace onnxruntime
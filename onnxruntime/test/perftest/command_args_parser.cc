@@ -5,6 +5,7 @@
 #include "command_args_parser.h"
 
 #include <string.h>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string_view>
@@ -113,9 +114,11 @@ namespace perftest {
       "\t    [TensorRT only] [trt_engine_cache_path]: Specify engine cache path.\n"
       "\t    [TensorRT only] [trt_engine_cache_prefix]: Customize engine cache prefix when trt_engine_cache_enable is true.\n"
       "\t    [TensorRT only] [trt_engine_hw_compatible]: Enable hardware compatibility. Engines ending with '_sm80+' can be re-used across all Ampere+ GPU (a hardware-compatible engine may have lower throughput and/or higher latency than its non-hardware-compatible counterpart).\n"
+      "\t    [TensorRT only] [trt_engine_refit_enable]: Refit a cached engine instead of rebuilding it when only the weights of its subgraph have changed.\n"
       "\t    [TensorRT only] [trt_weight_stripped_engine_enable]: Enable weight-stripped engine build.\n"
       "\t    [TensorRT only] [trt_onnx_model_folder_path]: Folder path for the ONNX model with weights.\n"
-      "\t    [TensorRT only] [trt_force_sequential_engine_build]: Force TensorRT engines to be built sequentially.\n"
+      "\t    [TensorRT only] [trt_profile_auto_update_runs]: Every this many runs, rebuild the engines of subgraphs with dynamic shape inputs in the background, optimized for the most frequent input shapes.\n"
+      "\t    [TensorRT only] [trt_force_sequential_engine_build]: Force TensorRT engines to be built sequentially. By default the engines of independent subgraphs are built concurrently.\n"
       "\t    [TensorRT only] [trt_context_memory_sharing_enable]: Enable TensorRT context memory sharing between subgraphs.\n"
       "\t    [TensorRT only] [trt_layer_norm_fp32_fallback]: Force Pow + Reduce ops in layer norm to run in FP32 to avoid overflow.\n"
       "\t    [Example] [For TensorRT EP] -e tensorrt -i 'trt_fp16_enable|true trt_int8_enable|true trt_int8_calibration_table_name|calibration.flatbuffers trt_int8_use_native_calibration_table|false trt_force_sequential_engine_build|false'\n"
@@ -124,6 +127,7 @@ namespace perftest {
       "\t    [NNAPI only] [NNAPI_FLAG_USE_NCHW]: Use the NCHW layout in NNAPI EP.\n"
       "\t    [NNAPI only] [NNAPI_FLAG_CPU_DISABLED]: Prevent NNAPI from using CPU devices.\n"
       "\t    [NNAPI only] [NNAPI_FLAG_CPU_ONLY]: Using CPU only in NNAPI EP.\n"
+      "\t    [NNAPI only] [NNAPI_FLAG_USE_BURST]: Run the NNAPI model with an ANeuralNetworksBurst.\n"
       "\t    [Example] [For NNAPI EP] -e nnapi -i \"NNAPI_FLAG_USE_FP16 NNAPI_FLAG_USE_NCHW NNAPI_FLAG_CPU_DISABLED\"\n"
       "\n"
       "\t    [CoreML only] [COREML_FLAG_CREATE_MLPROGRAM]: Create an ML Program model instead of Neural Network.\n"
@@ -144,6 +148,18 @@ namespace perftest {
       "\t-Z [Force thread to stop spinning between runs]: disallow thread from spinning during runs to reduce cpu usage.\n"
       "\t-n [Exit after session creation]: allow user to measure session creation time to measure impact of enabling any initialization optimizations.\n"
       "\t-l Provide file as binary in memory by using fopen before session creation.\n"
+      "\t-W [sweep]: Runs the test for every combination of the listed values instead of once, as key-value pairs of\n"
+      "\t    comma separated lists: -W \"concurrency|1,2,4 intra_op|1,4 batch|1,8\"\n"
+      "\t    'concurrency' overrides -c, 'intra_op' overrides -x and 'batch' sets the first dimension of the inputs\n"
+      "\t    if it is free, which requires -I. Each point reports P50/P90/P99/P99.9 latency, throughput, CPU usage and\n"
+      "\t    the peak working set size of the process so far.\n"
+      "\t-R [sweep_report_file]: Writes the results of the -W points to a .json or .csv file. Default: printed as CSV.\n"
+      "\t-Q [target_qps]: Runs open-loop: requests arrive as a Poisson process with this mean rate, independently of\n"
+      "\t    the completion of the previous ones, and are run by -c workers. The latencies include the queueing time.\n"
+      "\t    The test stops issuing requests after -t seconds in 'duration' mode or -r requests in 'times' mode.\n"
+      "\t-H [shape_distribution_file]: Generates the inputs of the runs from a distribution of free dimension values, which\n"
+      "\t    requires -I. Each line is a weight followed by dimension_name:value pairs, e.g. '30 sequence_length:128'.\n"
+      "\t    Each run draws a line with probability proportional to its weight. Lines starting with '#' are ignored.\n"
       "\t-h: help\n");
 }
 #ifdef _WIN32
@@ -204,9 +220,56 @@ static bool ParseSessionConfigs(const std::string& configs_string,
   return true;
 }
 
+template <typename T>
+static bool ParseSweepValues(const std::string& values_string, std::vector<T>& values) {
+  std::istringstream ss(values_string);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    ORT_TRY {
+      size_t end = 0;
+      const long long value = std::stoll(token, &end);
+      if (end != token.size() || value < 0) {
+        return false;
+      }
+      values.push_back(static_cast<T>(value));
+    }
+    ORT_CATCH(...) {
+      return false;
+    }
+  }
+  return !values.empty();
+}
+
+static bool ParseSweepConfig(const std::string& sweep_string, SweepConfig& sweep_config) {
+  std::unordered_map<std::string, std::string> axes;
+  if (!ParseSessionConfigs(sweep_string, axes)) {
+    return false;
+  }
+
+  for (const auto& [axis, values] : axes) {
+    bool parsed = false;
+    if (axis == "concurrency") {
+      parsed = ParseSweepValues(values, sweep_config.concurrent_session_runs);
+    } else if (axis == "intra_op") {
+      parsed = ParseSweepValues(values, sweep_config.intra_op_num_threads);
+    } else if (axis == "batch") {
+      parsed = ParseSweepValues(values, sweep_config.batch_sizes);
+    }
+    if (!parsed) {
+      return false;
+    }
+  }
+
+  // a concurrency or batch size of 0 makes no sense, while 0 intra-op threads lets ORT pick the number
+  auto is_zero = [](auto value) { return value == 0; };
+  return std::none_of(sweep_config.concurrent_session_runs.begin(), sweep_config.concurrent_session_runs.end(),
+                      is_zero) &&
+         std::none_of(sweep_config.batch_sizes.begin(), sweep_config.batch_sizes.end(), is_zero);
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznl"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:W:R:Q:H:AMPIDZvhsqznl"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -381,6 +444,28 @@ static bool ParseSessionConfigs(const std::string& configs_string,
         }
         break;
       }
+      case 'W':
+        if (!ParseSweepConfig(ToUTF8String(optarg), test_config.sweep_config)) {
+          return false;
+        }
+        break;
+      case 'R':
+        test_config.sweep_config.report_file_path = optarg;
+        break;
+      case 'Q':
+        ORT_TRY {
+          test_config.run_config.target_qps = std::stod(optarg);
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'H':
+        test_config.run_config.shape_distribution_file = optarg;
+        break;
       case 'D':
         test_config.run_config.disable_spinning = true;
         break;
@@ -417,6 +502,12 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
   test_config.model_info.model_file_path = argv[0];
 
+  // the batch size and the shape distribution are only applied to generated inputs
+  if ((!test_config.sweep_config.batch_sizes.empty() || !test_config.run_config.shape_distribution_file.empty()) &&
+      !test_config.run_config.generate_model_input_binding) {
+    return false;
+  }
+
   return true;
 }
 
@@ -3,7 +3,9 @@
 
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
+#include <iostream>
 #include <random>
+#include <vector>
 #include "command_args_parser.h"
 #include "performance_runner.h"
 #include <google/protobuf/stubs/common.h>
@@ -11,6 +13,44 @@
 using namespace onnxruntime;
 const OrtApi* g_ort = NULL;
 
+// Runs the test for every combination of the values of the sweep config, with a new session for each.
+static int RunSweep(Ort::Env& env, const perftest::PerformanceTestConfig& test_config, std::random_device& rd) {
+  const auto& sweep_config = test_config.sweep_config;
+  const auto& run_config = test_config.run_config;
+  // an axis that is not swept keeps the value of the run config
+  auto values_or = [](const auto& values, auto value) {
+    return values.empty() ? std::vector<decltype(value)>{value} : values;
+  };
+  const auto concurrency_values = values_or(sweep_config.concurrent_session_runs, run_config.concurrent_session_runs);
+  const auto intra_op_values = values_or(sweep_config.intra_op_num_threads, run_config.intra_op_num_threads);
+  const auto batch_values = values_or(sweep_config.batch_sizes, run_config.batch_size);
+
+  std::vector<perftest::SweepPointResult> points;
+  for (const int64_t batch_size : batch_values) {
+    for (const int intra_op_num_threads : intra_op_values) {
+      for (const size_t concurrent_session_runs : concurrency_values) {
+        perftest::PerformanceTestConfig point_config = test_config;
+        point_config.run_config.batch_size = batch_size;
+        point_config.run_config.intra_op_num_threads = intra_op_num_threads;
+        point_config.run_config.concurrent_session_runs = concurrent_session_runs;
+        std::cout << "\nSweep point: concurrency " << concurrent_session_runs << ", intra_op_num_threads "
+                  << intra_op_num_threads << ", batch_size " << batch_size << std::endl;
+
+        perftest::PerformanceRunner perf_runner(env, point_config, rd);
+        auto status = perf_runner.Run();
+        if (!status.IsOK()) {
+          printf("Run failed:%s\n", status.ErrorMessage().c_str());
+          return -1;
+        }
+        points.emplace_back(perf_runner.GetResult(), point_config.run_config);
+      }
+    }
+  }
+
+  perftest::DumpSweepResults(points, sweep_config.report_file_path);
+  return 0;
+}
+
 #ifdef _WIN32
 int real_main(int argc, wchar_t* argv[]) {
 #else
@@ -42,6 +82,10 @@ int real_main(int argc, char* argv[]) {
       return -1;
   }
   std::random_device rd;
+  if (test_config.sweep_config.IsEnabled()) {
+    return RunSweep(env, test_config, rd);
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
 
   // Exit if user enabled -n option so that user can measure session creation time
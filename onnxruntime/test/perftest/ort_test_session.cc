@@ -33,8 +33,11 @@ namespace perftest {
 std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
   // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
   const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
-  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
-  auto& input = test_inputs_.at(id);
+  return Run(static_cast<size_t>(dist_(rand_engine_, p)));
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::Run(size_t test_data_id) {
+  auto& input = test_inputs_.at(test_data_id);
   auto start = std::chrono::high_resolution_clock::now();
   auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
                                     output_names_raw_ptr.data(), output_names_raw_ptr.size());
@@ -43,6 +46,11 @@ std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
   return duration_seconds;
 }
 
+std::string OnnxRuntimeTestSession::EndProfiling() {
+  Ort::AllocatorWithDefaultOptions allocator;
+  return session_.EndProfilingAllocated(allocator).get();
+}
+
 OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd,
                                                const PerformanceTestConfig& performance_test_config,
                                                const TestModelInfo& m)
@@ -387,12 +395,15 @@ select from 'TF8', 'TF16', 'UINT8', 'FLOAT', 'ITENSOR'. \n)");
         nnapi_flags |= NNAPI_FLAG_CPU_DISABLED;
       } else if (key == "NNAPI_FLAG_CPU_ONLY") {
         nnapi_flags |= NNAPI_FLAG_CPU_ONLY;
+      } else if (key == "NNAPI_FLAG_USE_BURST") {
+        nnapi_flags |= NNAPI_FLAG_USE_BURST;
       } else if (key.empty()) {
       } else {
         ORT_THROW(
             "[ERROR] [NNAPI] wrong key type entered. Choose from the following runtime key options "
             "that are available for NNAPI. "
-            "['NNAPI_FLAG_USE_FP16', 'NNAPI_FLAG_USE_NCHW', 'NNAPI_FLAG_CPU_DISABLED', 'NNAPI_FLAG_CPU_ONLY'] \n");
+            "['NNAPI_FLAG_USE_FP16', 'NNAPI_FLAG_USE_NCHW', 'NNAPI_FLAG_CPU_DISABLED', 'NNAPI_FLAG_CPU_ONLY', "
+            "'NNAPI_FLAG_USE_BURST'] \n");
       }
     }
     Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nnapi(session_options, nnapi_flags));
@@ -645,6 +656,7 @@ select from 'TF8', 'TF16', 'UINT8', 'FLOAT', 'ITENSOR'. \n)");
   session_options.SetGraphOptimizationLevel(performance_test_config.run_config.optimization_level);
   if (!performance_test_config.run_config.profile_file.empty()) {
     session_options.EnableProfiling(performance_test_config.run_config.profile_file.c_str());
+    session_options.AddConfigEntry(kOrtSessionOptionsProfilingNodeSummary, "1");
   }
   if (!performance_test_config.run_config.optimized_model_path.empty()) {
     session_options.SetOptimizedModelFilePath(performance_test_config.run_config.optimized_model_path.c_str());
@@ -936,7 +948,9 @@ static void InitializeTensorWithSeed(int32_t seed, Ort::Value& tensor) {
 #undef CASE_FOR_TYPE
 }
 
-bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
+bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed, int64_t batch_size,
+                                                            const std::map<std::string, int64_t>& dim_values,
+                                                            size_t test_data_id) {
   // iterate over all input nodes
   for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
     Ort::TypeInfo type_info = session_.GetInputTypeInfo(i);
@@ -944,11 +958,19 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
     if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
       auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
       std::vector<int64_t> input_node_dim = tensor_info.GetShape();
+      std::vector<const char*> dim_names(input_node_dim.size(), nullptr);
+      tensor_info.GetSymbolicDimensions(dim_names.data(), dim_names.size());
 
-      // free dimensions are treated as 1 if not overridden
-      for (int64_t& dim : input_node_dim) {
+      // free dimensions are treated as 1 if not overridden, except a free batch dimension if a batch size is set
+      for (size_t dim_idx = 0; dim_idx < input_node_dim.size(); ++dim_idx) {
+        int64_t& dim = input_node_dim[dim_idx];
         if (dim == -1) {
-          dim = 1;
+          auto value = dim_names[dim_idx] != nullptr ? dim_values.find(dim_names[dim_idx]) : dim_values.end();
+          if (value != dim_values.end()) {
+            dim = value->second;
+          } else {
+            dim = dim_idx == 0 && batch_size > 0 ? batch_size : 1;
+          }
         }
       }
 
@@ -956,7 +978,7 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
       Ort::Value input_tensor = Ort::Value::CreateTensor(allocator, (const int64_t*)input_node_dim.data(),
                                                          input_node_dim.size(), tensor_info.GetElementType());
       InitializeTensorWithSeed(seed, input_tensor);
-      PreLoadTestData(0, i, std::move(input_tensor));
+      PreLoadTestData(test_data_id, i, std::move(input_tensor));
     }
   }
   return true;
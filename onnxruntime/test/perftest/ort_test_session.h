@@ -3,6 +3,7 @@
 
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
+#include <map>
 #include <random>
 #include "test_configuration.h"
 #include "test_session.h"
@@ -25,11 +26,17 @@ class OnnxRuntimeTestSession : public TestSession {
     test_inputs_[test_data_id][input_id] = std::move(value);
   }
 
-  bool PopulateGeneratedInputTestData(int32_t seed);
+  // batch_size: size of the first dimension of the inputs if it is free, 0 to treat it as 1 like the other free ones
+  // dim_values: values of free dimensions by name, which take precedence over batch_size
+  bool PopulateGeneratedInputTestData(int32_t seed, int64_t batch_size = 0,
+                                      const std::map<std::string, int64_t>& dim_values = {}, size_t test_data_id = 0);
 
   ~OnnxRuntimeTestSession() = default;
 
   std::chrono::duration<double> Run() override;
+  std::chrono::duration<double> Run(size_t test_data_id) override;
+
+  std::string EndProfiling() override;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
@@ -7,7 +7,13 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -111,11 +117,123 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+SweepPointResult::SweepPointResult(const PerformanceResult& result, const RunConfig& run_config)
+    : concurrent_session_runs(run_config.concurrent_session_runs),
+      intra_op_num_threads(run_config.intra_op_num_threads),
+      batch_size(run_config.batch_size),
+      runs(result.time_costs.size()),
+      average_CPU_usage(result.average_CPU_usage),
+      peak_workingset_size(result.peak_workingset_size) {
+  if (runs == 0) {
+    return;
+  }
+
+  std::vector<double> sorted_time = result.time_costs;
+  std::sort(sorted_time.begin(), sorted_time.end());
+  // same indices as the statistics of PerformanceResult::DumpToFile
+  p50 = sorted_time[static_cast<size_t>(runs * 0.5)];
+  p90 = sorted_time[static_cast<size_t>(runs * 0.9)];
+  p99 = sorted_time[static_cast<size_t>(runs * 0.99)];
+  p999 = sorted_time[static_cast<size_t>(runs * 0.999)];
+
+  const std::chrono::duration<double> duration = result.end - result.start;
+  inferences_per_second = runs / duration.count();
+}
+
+void DumpSweepResults(const std::vector<SweepPointResult>& points, const std::basic_string<ORTCHAR_T>& path) {
+  std::ofstream outfile;
+  if (!path.empty()) {
+    outfile.open(path, std::ofstream::out | std::ofstream::trunc);
+    if (!outfile.good()) {
+      std::cerr << "failed to open sweep report file '" << ToUTF8String(path.c_str()) << "'. will dump it to output.\n";
+    }
+  }
+  std::ostream& out = outfile.is_open() && outfile.good() ? static_cast<std::ostream&>(outfile) : std::cout;
+
+  const std::basic_string<ORTCHAR_T> json_extension = ORT_TSTR(".json");
+  const bool json = path.size() >= json_extension.size() &&
+                    path.compare(path.size() - json_extension.size(), json_extension.size(), json_extension) == 0;
+
+  // a batch size of 0 means the free batch dimensions are 1
+  auto samples_per_second = [](const SweepPointResult& point) {
+    return point.inferences_per_second * static_cast<double>(std::max<int64_t>(point.batch_size, 1));
+  };
+
+  if (json) {
+    out << "[\n";
+    for (size_t i = 0; i < points.size(); ++i) {
+      const auto& point = points[i];
+      out << "  {\"concurrency\": " << point.concurrent_session_runs
+          << ", \"intra_op_num_threads\": " << point.intra_op_num_threads
+          << ", \"batch_size\": " << point.batch_size
+          << ", \"runs\": " << point.runs
+          << ", \"p50_latency_s\": " << point.p50
+          << ", \"p90_latency_s\": " << point.p90
+          << ", \"p99_latency_s\": " << point.p99
+          << ", \"p999_latency_s\": " << point.p999
+          << ", \"inferences_per_second\": " << point.inferences_per_second
+          << ", \"samples_per_second\": " << samples_per_second(point)
+          << ", \"avg_cpu_usage_percent\": " << point.average_CPU_usage
+          << ", \"peak_working_set_bytes\": " << point.peak_workingset_size
+          << "}" << (i + 1 < points.size() ? "," : "") << "\n";
+    }
+    out << "]" << std::endl;
+  } else {
+    out << "concurrency,intra_op_num_threads,batch_size,runs,p50_latency_s,p90_latency_s,p99_latency_s,"
+           "p999_latency_s,inferences_per_second,samples_per_second,avg_cpu_usage_percent,peak_working_set_bytes\n";
+    for (const auto& point : points) {
+      out << point.concurrent_session_runs << "," << point.intra_op_num_threads << "," << point.batch_size << ","
+          << point.runs << "," << point.p50 << "," << point.p90 << "," << point.p99 << "," << point.p999 << ","
+          << point.inferences_per_second << "," << samples_per_second(point) << "," << point.average_CPU_usage << ","
+          << point.peak_workingset_size << "\n";
+    }
+    out << std::flush;
+  }
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
 }
 
+// Prints the node summary table that the profiler writes next to the profile file.
+static void PrintProfileSummary(const std::string& profile_file) {
+  if (profile_file.empty()) {
+    return;
+  }
+
+  std::string summary_file = profile_file;
+  const std::string json_extension = ".json";
+  if (summary_file.size() >= json_extension.size() &&
+      summary_file.compare(summary_file.size() - json_extension.size(), json_extension.size(), json_extension) == 0) {
+    summary_file.resize(summary_file.size() - json_extension.size());
+  }
+  summary_file += "_summary.csv";
+
+  std::ifstream stream(summary_file);
+  if (!stream) {
+    return;
+  }
+
+  std::cout << "Profile: " << profile_file << "\nNode summary: " << summary_file << "\n";
+  constexpr size_t kMaxPrintedNodes = 20;
+  std::string line;
+  for (size_t i = 0; i <= kMaxPrintedNodes && std::getline(stream, line); ++i) {
+    std::istringstream fields(line);
+    std::string field;
+    for (size_t column = 0; std::getline(fields, field, ','); ++column) {
+      // node, op_name and provider are left aligned, the numbers right aligned
+      if (column < 3) {
+        std::cout << std::left << std::setw(column == 0 ? 40 : 24) << field.substr(0, column == 0 ? 39 : 23);
+      } else {
+        std::cout << std::right << std::setw(20) << field;
+      }
+    }
+    std::cout << std::left << "\n";
+  }
+  std::cout << std::endl;
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
@@ -131,15 +249,19 @@ Status PerformanceRunner::Run() {
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -147,8 +269,9 @@ Status PerformanceRunner::Run() {
   performance_result_.peak_workingset_size = utils::GetPeakWorkingSetSize();
 
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
-  // TODO: end profiling
-  // if (!performance_test_config_.run_config.profile_file.empty()) session_object->EndProfiling();
+  if (!performance_test_config_.run_config.profile_file.empty()) {
+    PrintProfileSummary(session_->EndProfiling());
+  }
   auto first_inference_duration =
       std::chrono::duration_cast<std::chrono::milliseconds>(initial_inference_result_.end - initial_inference_result_.start).count();
   std::chrono::duration<double> inference_duration = performance_result_.end - performance_result_.start;
@@ -164,6 +287,14 @@ Status PerformanceRunner::Run() {
             << "Avg CPU usage: " << performance_result_.average_CPU_usage << " %\n"
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
+  if (performance_test_config_.run_config.target_qps > 0) {
+    std::cout << "Target inferences per second: " << performance_test_config_.run_config.target_qps << std::endl;
+    if (!performance_result_.time_costs.empty()) {
+      std::cout << "Average queueing time: "
+                << performance_result_.total_queue_time_cost / performance_result_.time_costs.size() * 1000 << " ms"
+                << std::endl;
+    }
+  }
 
   return Status::OK();
 }
@@ -255,6 +386,137 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // the requests wait in an unbounded queue while the workers are all busy. the arrival thread only enqueues them,
+  // so it keeps the arrival times even when the model is overloaded.
+  struct Request {
+    size_t test_data_id;
+    std::chrono::high_resolution_clock::time_point arrival;
+  };
+  std::deque<Request> queue;
+  bool arrivals_done = false;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  std::vector<std::thread> workers;
+  const size_t num_workers = std::max<size_t>(run_config.concurrent_session_runs, 1);
+  workers.reserve(num_workers);
+  for (size_t i = 0; i != num_workers; ++i) {
+    workers.emplace_back([this, &queue, &arrivals_done, &m, &cv]() {
+      for (;;) {
+        Request request;
+        {
+          std::unique_lock<OrtMutex> lock(m);
+          cv.wait(lock, [&queue, &arrivals_done]() { return !queue.empty() || arrivals_done; });
+          if (queue.empty()) {
+            return;
+          }
+          request = queue.front();
+          queue.pop_front();
+        }
+
+        auto status = RunOneIteration<false>(request.test_data_id, request.arrival);
+        if (!status.IsOK())
+          std::cerr << status.ErrorMessage();
+      }
+    });
+  }
+
+  std::exponential_distribution<double> inter_arrival_seconds(run_config.target_qps);
+  const auto start = std::chrono::high_resolution_clock::now();
+  auto arrival = start;
+  for (size_t requests = 0;; ++requests) {
+    // the arrivals do not depend on the completion of the previous requests
+    arrival += std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+        std::chrono::duration<double>(inter_arrival_seconds(rand_engine_)));
+    const bool done = run_config.test_mode == TestMode::kFixDurationMode
+                          ? std::chrono::duration<double>(arrival - start).count() >= run_config.duration_in_seconds
+                          : requests >= run_config.repeated_times;
+    if (done) {
+      break;
+    }
+
+    std::this_thread::sleep_until(arrival);
+    const size_t test_data_id = NextTestDataId();
+    {
+      std::lock_guard<OrtMutex> lg(m);
+      queue.push_back(Request{test_data_id, arrival});
+    }
+    cv.notify_one();
+  }
+
+  // Join
+  {
+    std::lock_guard<OrtMutex> lg(m);
+    arrivals_done = true;
+  }
+  cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return Status::OK();
+}
+
+// Reads the lines of weight followed by dimension_name:value pairs of a -H file.
+static bool LoadShapeDistribution(const std::basic_string<ORTCHAR_T>& path, std::vector<double>& weights,
+                                  std::vector<std::map<std::string, int64_t>>& dim_values) {
+  std::ifstream stream(path);
+  if (!stream) {
+    std::cout << "failed to open shape distribution file '" << ToUTF8String(path.c_str()) << "'" << std::endl;
+    return false;
+  }
+
+  std::string line;
+  for (size_t line_number = 1; std::getline(stream, line); ++line_number) {
+    std::istringstream fields(line);
+    std::string field;
+    if (!(fields >> field) || field[0] == '#') {
+      continue;
+    }
+
+    std::map<std::string, int64_t> values;
+    double weight = 0;
+    ORT_TRY {
+      weight = std::stod(field);
+      while (fields >> field) {
+        const auto pos = field.rfind(':');
+        if (pos == std::string::npos || pos == 0) {
+          weight = -1;
+          break;
+        }
+        const int64_t value = std::stoll(field.substr(pos + 1));
+        if (value <= 0) {
+          weight = -1;
+          break;
+        }
+        values[field.substr(0, pos)] = value;
+      }
+    }
+    ORT_CATCH(...) {
+      weight = -1;
+    }
+
+    if (weight < 0) {
+      std::cout << "invalid line " << line_number << " in shape distribution file '" << ToUTF8String(path.c_str())
+                << "'" << std::endl;
+      return false;
+    }
+
+    weights.push_back(weight);
+    dim_values.push_back(std::move(values));
+  }
+
+  if (weights.empty() || std::all_of(weights.cbegin(), weights.cend(), [](double weight) { return weight == 0; })) {
+    std::cout << "shape distribution file '" << ToUTF8String(path.c_str()) << "' has no weighted shapes" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
@@ -276,6 +538,7 @@ PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig&
   session_create_start_ = std::chrono::high_resolution_clock::now();
   session_ = std::make_unique<OnnxRuntimeTestSession>(env, rd, performance_test_config_, *test_model_info_);
   session_create_end_ = std::chrono::high_resolution_clock::now();
+  rand_engine_.seed(rd());
 }
 
 PerformanceRunner::~PerformanceRunner() = default;
@@ -299,10 +562,28 @@ bool PerformanceRunner::Initialize() {
   TestModelInfo* test_model_info = test_model_info_.get();
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
-  if (performance_test_config_.run_config.generate_model_input_binding) {
-    return static_cast<OnnxRuntimeTestSession*>(
-               session_.get())
-        ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data);
+  const auto& run_config = performance_test_config_.run_config;
+  if (run_config.generate_model_input_binding) {
+    auto* session = static_cast<OnnxRuntimeTestSession*>(session_.get());
+    if (run_config.shape_distribution_file.empty()) {
+      test_data_dist_ = std::discrete_distribution<size_t>{1.0};
+      return session->PopulateGeneratedInputTestData(run_config.random_seed_for_input_data, run_config.batch_size);
+    }
+
+    // one set of test data per shape, drawn with the weight of the shape
+    std::vector<double> weights;
+    std::vector<std::map<std::string, int64_t>> dim_values;
+    if (!LoadShapeDistribution(run_config.shape_distribution_file, weights, dim_values)) {
+      return false;
+    }
+    for (size_t test_data_id = 0; test_data_id != weights.size(); ++test_data_id) {
+      if (!session->PopulateGeneratedInputTestData(run_config.random_seed_for_input_data, run_config.batch_size,
+                                                   dim_values[test_data_id], test_data_id)) {
+        return false;
+      }
+    }
+    test_data_dist_ = std::discrete_distribution<size_t>(weights.cbegin(), weights.cend());
+    return true;
   }
 
   // TODO: Place input tensor on cpu memory if dnnl provider type to avoid CopyTensor logic in CopyInputAcrossDevices
@@ -326,6 +607,8 @@ bool PerformanceRunner::Initialize() {
       session_->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
     }
   }
+  const std::vector<double> weights(test_data_count, 1.0);
+  test_data_dist_ = std::discrete_distribution<size_t>(weights.cbegin(), weights.cend());
 
   return true;
 }
@@ -33,12 +33,35 @@ struct PerformanceResult {
   size_t peak_workingset_size{0};
   short average_CPU_usage{0};
   double total_time_cost{0};
+  // part of total_time_cost the requests of the open-loop mode waited for a worker
+  double total_queue_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
 };
 
+// The measurements of one combination of the values of a SweepConfig.
+struct SweepPointResult {
+  size_t concurrent_session_runs{1};
+  int intra_op_num_threads{0};
+  int64_t batch_size{0};
+  size_t runs{0};
+  // latency percentiles in seconds
+  double p50{0};
+  double p90{0};
+  double p99{0};
+  double p999{0};
+  double inferences_per_second{0};
+  short average_CPU_usage{0};
+  size_t peak_workingset_size{0};
+
+  SweepPointResult(const PerformanceResult& result, const RunConfig& run_config);
+};
+
+// Writes the points as JSON if path ends with .json, otherwise as CSV. Prints them as CSV if path is empty.
+void DumpSweepResults(const std::vector<SweepPointResult>& points, const std::basic_string<ORTCHAR_T>& path);
+
 class PerformanceRunner {
  public:
   PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
@@ -59,13 +82,30 @@ class PerformanceRunner {
  private:
   bool Initialize();
 
+  size_t NextTestDataId() {
+    std::lock_guard<OrtMutex> guard(rand_mutex_);
+    return test_data_dist_(rand_engine_);
+  }
+
   template <bool isWarmup>
   Status RunOneIteration() {
+    return RunOneIteration<isWarmup>(NextTestDataId(), {});
+  }
+
+  // arrival: time the request of the open-loop mode was issued, which the time cost is measured from if set.
+  template <bool isWarmup>
+  Status RunOneIteration(size_t test_data_id, std::chrono::high_resolution_clock::time_point arrival) {
     std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
+    std::chrono::duration<double> queue_seconds(std::chrono::seconds(0));
 
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      const auto dequeued = std::chrono::high_resolution_clock::now();
+      duration_seconds = session_->Run(test_data_id);
+      if (arrival != std::chrono::high_resolution_clock::time_point{}) {
+        queue_seconds = dequeued - arrival;
+        duration_seconds += queue_seconds;
+      }
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -78,6 +118,7 @@ class PerformanceRunner {
       std::lock_guard<OrtMutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
       performance_result_.total_time_cost += duration_seconds.count();
+      performance_result_.total_queue_time_cost += queue_seconds.count();
       if (performance_test_config_.run_config.f_verbose) {
         std::cout << "iteration:" << performance_result_.time_costs.size() << ","
                   << "time_cost:" << performance_result_.time_costs.back() << std::endl;
@@ -90,6 +131,7 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -117,6 +159,11 @@ class PerformanceRunner {
   std::unique_ptr<ITestCase> test_case_;
 
   OrtMutex results_mutex_;
+
+  // draws the preloaded test data of the runs
+  std::mt19937 rand_engine_;
+  std::discrete_distribution<size_t> test_data_dist_;
+  OrtMutex rand_mutex_;
 };
 }  // namespace perftest
 }  // namespace onnxruntime
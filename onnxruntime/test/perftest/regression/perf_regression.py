@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+# Copyright (c) Microsoft Corporation.  All rights reserved.
+# Licensed under the MIT License.
+"""Runs a set of models through onnxruntime_perf_test and the MLAS benchmarks and compares the results with a baseline.
+
+The baseline is a JSON file of the samples of an earlier run on the same machine, so the suite can run on any
+hardware, e.g. before and after upgrading ORT. A benchmark regresses if its median slowed down by more than the
+threshold and a one-sided Mann-Whitney U test finds the slowdown significant. The script exits with 1 if any
+benchmark regressed.
+
+    # record the baseline with the current build
+    python perf_regression.py --build_dir build/Linux/Release --model_dir ~/models --baseline baseline.json --update
+    # compare a later build with it
+    python perf_regression.py --build_dir build/Linux/Release --model_dir ~/models --baseline baseline.json
+"""
+import argparse
+import json
+import math
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        "--build_dir", required=True, help="Directory of onnxruntime_perf_test and onnxruntime_mlas_benchmark."
+    )
+    parser.add_argument("--model_dir", default="", help="Directory the model paths of the config are relative to.")
+    parser.add_argument(
+        "--config", default=os.path.join(SCRIPT_DIR, "models.json"), help="JSON file of the models and MLAS benchmarks."
+    )
+    parser.add_argument("--baseline", required=True, help="JSON file of the baseline samples.")
+    parser.add_argument("--update", action="store_true", help="Write the samples of this run to the baseline.")
+    parser.add_argument("--output", default="", help="Also write the samples of this run to this JSON file.")
+    parser.add_argument("--threshold", type=float, default=0.05, help="Relative slowdown of the median that fails.")
+    parser.add_argument("--alpha", type=float, default=0.01, help="Significance level of the test.")
+    parser.add_argument("--filter", default="", help="Only run the benchmarks whose name contains this.")
+    return parser.parse_args()
+
+
+def find_binary(build_dir, name):
+    for config in ("", "Release", "RelWithDebInfo"):
+        for candidate in (name, name + ".exe"):
+            path = os.path.join(build_dir, config, candidate)
+            if os.path.isfile(path):
+                return path
+    return None
+
+
+def run_perftest(perf_test, model_path, entry):
+    """Returns the latencies in seconds of the runs of the model."""
+    with tempfile.TemporaryDirectory() as temp_dir:
+        result_file = os.path.join(temp_dir, "result.csv")
+        command = [
+            perf_test,
+            "-m",
+            "times",
+            "-r",
+            str(entry.get("runs", 200)),
+            "-e",
+            entry.get("ep", "cpu"),
+            *entry.get("args", []),
+            model_path,
+            result_file,
+        ]
+        subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+
+        # the result file has one model,time_cost,peak_working_set,cpu_usage,run line per run
+        samples = []
+        with open(result_file) as f:
+            for line in f:
+                fields = line.strip().split(",")
+                if len(fields) == 5:
+                    samples.append(float(fields[1]))
+        return samples
+
+
+def run_mlas_benchmarks(mlas_benchmark, config):
+    """Returns the times in seconds of the repetitions of the MLAS benchmarks that match the filter, by name."""
+    with tempfile.TemporaryDirectory() as temp_dir:
+        result_file = os.path.join(temp_dir, "result.json")
+        command = [
+            mlas_benchmark,
+            "--benchmark_filter=" + config.get("filter", "."),
+            "--benchmark_repetitions=" + str(config.get("repetitions", 10)),
+            "--benchmark_out_format=json",
+            "--benchmark_out=" + result_file,
+        ]
+        subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+        with open(result_file) as f:
+            results = json.load(f)
+
+    multipliers = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+    samples = {}
+    for benchmark in results["benchmarks"]:
+        if benchmark.get("run_type", "iteration") != "iteration" or "error_occurred" in benchmark:
+            continue
+        name = "mlas/" + benchmark["run_name"]
+        samples.setdefault(name, []).append(benchmark["real_time"] * multipliers[benchmark["time_unit"]])
+    return samples
+
+
+def mann_whitney_greater(current, baseline):
+    """Returns the p-value of the one-sided Mann-Whitney U test that current tends to be larger than baseline.
+
+    Uses the normal approximation with the tie correction, which is accurate enough for the sample counts here.
+    """
+    n1, n2 = len(current), len(baseline)
+    values = sorted([(value, 0) for value in current] + [(value, 1) for value in baseline])
+
+    # average ranks of the ties
+    ranks = [0.0] * len(values)
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        tie_term += (j - i + 1) ** 3 - (j - i + 1)
+        i = j + 1
+
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, values) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2
+    n = n1 + n2
+    variance = n1 * n2 / 12 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (u - n1 * n2 / 2 - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def compare(samples, baseline, threshold, alpha):
+    """Prints the comparison of the samples with the baseline and returns the names of the regressed benchmarks."""
+    regressions = []
+    print(f"{'Benchmark':<60}{'Baseline':>14}{'Current':>14}{'Change':>10}{'p-value':>10}")
+    for name, current in sorted(samples.items()):
+        if not current:
+            print(f"{name[:59]:<60}{'no samples':>28}")
+            continue
+        if name not in baseline or len(current) < 3 or len(baseline[name]) < 3:
+            print(f"{name[:59]:<60}{'-':>14}{statistics.median(current):>14.6g}{'new':>10}")
+            continue
+
+        base_median = statistics.median(baseline[name])
+        current_median = statistics.median(current)
+        change = current_median / base_median - 1
+        p_value = mann_whitney_greater(current, baseline[name])
+        regressed = change > threshold and p_value < alpha
+        if regressed:
+            regressions.append(name)
+        print(
+            f"{name[:59]:<60}{base_median:>14.6g}{current_median:>14.6g}{change:>+10.1%}{p_value:>10.3g}"
+            + ("  REGRESSION" if regressed else "")
+        )
+    return regressions
+
+
+def main():
+    args = parse_arguments()
+    with open(args.config) as f:
+        config = json.load(f)
+
+    samples = {}
+    perf_test = find_binary(args.build_dir, "onnxruntime_perf_test")
+    for entry in config.get("perftest", []):
+        name = "perftest/" + entry["name"]
+        if args.filter not in name:
+            continue
+        model_path = os.path.join(args.model_dir, entry["model"])
+        if perf_test is None or not os.path.isfile(model_path):
+            print(f"skipping {name}: " + ("no onnxruntime_perf_test" if perf_test is None else f"no {model_path}"))
+            continue
+        print(f"running {name}")
+        samples[name] = run_perftest(perf_test, model_path, entry)
+
+    mlas_benchmark = find_binary(args.build_dir, "onnxruntime_mlas_benchmark")
+    if "mlas" in config and mlas_benchmark is not None:
+        print("running the MLAS benchmarks")
+        for name, values in run_mlas_benchmarks(mlas_benchmark, config["mlas"]).items():
+            if args.filter in name:
+                samples[name] = values
+
+    run = {"machine": platform.node(), "processor": platform.processor() or platform.machine(), "samples": samples}
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(run, f, indent=1)
+
+    if args.update or not os.path.isfile(args.baseline):
+        # keep the samples of the benchmarks that did not run
+        baseline = {"samples": {}}
+        if os.path.isfile(args.baseline):
+            with open(args.baseline) as f:
+                baseline = json.load(f)
+        baseline.update({key: value for key, value in run.items() if key != "samples"})
+        baseline["samples"].update(samples)
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=1)
+        print(f"wrote the baseline of {len(samples)} benchmarks to {args.baseline}")
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    if baseline.get("machine") != run["machine"]:
+        print(f"warning: the baseline was recorded on {baseline.get('machine')}, not on {run['machine']}")
+
+    regressions = compare(samples, baseline["samples"], args.threshold, args.alpha)
+    if regressions:
+        print(f"\n{len(regressions)} benchmarks regressed by more than {args.threshold:.0%}: " + ", ".join(regressions))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
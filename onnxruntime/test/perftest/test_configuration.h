@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -65,12 +66,33 @@ struct RunConfig {
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
   bool exit_after_session_creation = false;
+  // size of the first dimension of the generated inputs if it is free, 0 to treat it as 1 like the other free ones.
+  int64_t batch_size{0};
+  // mean rate of the Poisson arrivals of the open-loop mode, 0 to run closed-loop.
+  double target_qps{0};
+  // weighted values of free dimensions to generate the inputs of the runs from, see -H.
+  std::basic_string<ORTCHAR_T> shape_distribution_file;
+};
+
+// Values of the run configuration to measure every combination of, in addition to the single configuration.
+// An empty list keeps the value of the run configuration.
+struct SweepConfig {
+  std::vector<size_t> concurrent_session_runs;
+  std::vector<int> intra_op_num_threads;
+  std::vector<int64_t> batch_sizes;
+  // .json or .csv file the results of the points are written to, printed as CSV if empty.
+  std::basic_string<ORTCHAR_T> report_file_path;
+
+  bool IsEnabled() const {
+    return !concurrent_session_runs.empty() || !intra_op_num_threads.empty() || !batch_sizes.empty();
+  }
 };
 
 struct PerformanceTestConfig {
   ModelInfo model_info;
   MachineConfig machine_config;
   RunConfig run_config;
+  SweepConfig sweep_config;
 };
 
 }  // namespace perftest
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <stdlib.h>
+#include <string>
 
 #include "OrtValueList.h"
 
@@ -11,12 +12,17 @@ namespace perftest {
 class TestSession {
  public:
   virtual std::chrono::duration<double> Run() = 0;
+  // Runs with the inputs preloaded as test_data_id. Unlike Run(), it can be called concurrently.
+  virtual std::chrono::duration<double> Run(size_t test_data_id) = 0;
   // TODO: implement it
   // This function won't return duration, because it may vary largely.
   // Please measure the perf at a higher level.
   void ThreadSafeRun() { abort(); }
   virtual void PreLoadTestData(size_t test_data_id, size_t input_id, Ort::Value&& value) = 0;
 
+  // Ends profiling and returns the profile file name, or an empty string if profiling is not supported.
+  virtual std::string EndProfiling() { return {}; }
+
   virtual ~TestSession() = default;
 };
 }  // namespace perftest
@@ -208,8 +208,10 @@ class TensorflowTestSession : public TestSession {
   std::chrono::duration<double> Run() override {
     // Randomly pick one OrtValueArray from feed_tensors_. (NOT ThreadSafe)
     const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(feed_tensors_.size() - 1));
-    const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
-    std::vector<TF_Tensor*>& feed_tensors = feed_tensors_.at(id);
+    return Run(static_cast<size_t>(dist_(rand_engine_, p)));
+  }
+  std::chrono::duration<double> Run(size_t test_data_id) override {
+    std::vector<TF_Tensor*>& feed_tensors = feed_tensors_.at(test_data_id);
 
     TF_Status* s = TF_NewStatus();
     std::vector<TF_Tensor*> output_tensors(fetches_.size());
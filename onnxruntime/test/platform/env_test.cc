@@ -5,6 +5,10 @@
 
 #include <fstream>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "gtest/gtest.h"
 
 #include "core/common/path_string.h"
@@ -53,5 +57,39 @@ TEST(PlatformEnvTest, GetErrnoInfo) {
 #pragma warning(pop)
 #endif
 }
+
+TEST(PlatformEnvTest, AllocatePages) {
+  const auto& env = Env::Default();
+  constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+  for (size_t huge_page_size : {size_t{0}, kHugePageSize}) {
+    void* p = env.AllocatePages(kHugePageSize, huge_page_size, -1);
+#if defined(_WIN32) || defined(__linux__) || defined(__APPLE__)
+    ASSERT_NE(p, nullptr);
+#endif
+    if (p != nullptr) {
+      memset(p, 0x7F, kHugePageSize);
+      EXPECT_EQ(static_cast<unsigned char*>(p)[kHugePageSize - 1], 0x7F);
+      env.FreePages(p, kHugePageSize);
+    }
+  }
+}
+
+#if defined(__linux__)
+TEST(PlatformEnvTest, DefaultThreadAffinitiesFollowProcessAffinity) {
+  const auto& env = Env::Default();
+  const auto affinities = env.GetDefaultThreadAffinities();
+  ASSERT_EQ(affinities.size(), static_cast<size_t>(env.GetNumPhysicalCpuCores()));
+
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpuset), 0);
+  ASSERT_LE(affinities.size(), static_cast<size_t>(CPU_COUNT(&cpuset)));
+  for (const auto& processors : affinities) {
+    for (int processor : processors) {
+      EXPECT_TRUE(CPU_ISSET(processor, &cpuset)) << "processor " << processor << " is not allowed";
+    }
+  }
+}
+#endif
 }  // namespace test
 }  // namespace onnxruntime
@@ -12,8 +12,11 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <functional>
+#include <future>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -510,6 +513,305 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestAdaptiveSpinPolicy) {
+  AdaptiveSpinPolicy policy;
+  // spin until the first idle time is known
+  ASSERT_EQ(policy.SpinMicros(), AdaptiveSpinPolicy::kMaxSpinMicros);
+
+  // back-to-back tasks keep the worker spinning, but not for less than the minimum.
+  policy.RecordIdleTime(2);
+  ASSERT_EQ(policy.SpinMicros(), AdaptiveSpinPolicy::kMinSpinMicros);
+  for (int i = 0; i < 64; ++i) {
+    policy.RecordIdleTime(100);
+  }
+  ASSERT_GE(policy.SpinMicros(), 150);
+  ASSERT_LE(policy.SpinMicros(), 200);
+
+  // long gaps make the worker block right away.
+  for (int i = 0; i < 64; ++i) {
+    policy.RecordIdleTime(100000);
+  }
+  ASSERT_EQ(policy.SpinMicros(), 0);
+
+  // and it resumes spinning once the tasks get close again.
+  for (int i = 0; i < 128; ++i) {
+    policy.RecordIdleTime(10);
+  }
+  ASSERT_GE(policy.SpinMicros(), AdaptiveSpinPolicy::kMinSpinMicros);
+  ASSERT_LE(policy.SpinMicros(), 40);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_spinning = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, 4, true);
+  for (int run = 0; run < 10; ++run) {
+    auto test_data = CreateTestData(100);
+    ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestThroughputWeights) {
+  constexpr int num_threads = 4;
+  onnxruntime::ThreadOptions thread_options;
+  // empty affinities leave the threads unbound
+  thread_options.affinities.resize(num_threads);
+
+  // two threads run at half the speed of the others, so blocks are twice as fine as for a plain hybrid CPU.
+  thread_options.throughput_weights = {1.0f, 1.0f, 0.5f, 0.5f};
+  auto hybrid_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads,
+                                                true);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(hybrid_tp.get()), num_threads * 8);
+
+  auto test_data = CreateTestData(1000);
+  ThreadPool::TryParallelFor(hybrid_tp.get(), 1000, 1.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      IncrementElement(*test_data, i);
+    }
+  });
+  ValidateTestData(*test_data);
+
+  // the same speed for all the threads, e.g. a pool bound to the performance cores only.
+  thread_options.throughput_weights = {1.0f, 1.0f, 1.0f, 1.0f};
+  auto uniform_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads,
+                                                 true, true);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(uniform_tp.get()), num_threads);
+}
+
+TEST(ThreadPoolTest, TestNestedParallelSections) {
+  constexpr int num_tasks = 1024;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr, 4,
+                                         true);
+  auto other_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                               4, true);
+  auto test_data = CreateTestData(num_tasks);
+  auto other_test_data = CreateTestData(num_tasks);
+  {
+    // e.g. the section of the executor spanning several nodes, and the one of a kernel
+    ThreadPool::ParallelSection outer(tp.get());
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    {
+      ThreadPool::ParallelSection inner(tp.get());
+      ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks,
+                                       [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    }
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    // loops on another pool run in the caller
+    ThreadPool::TrySimpleParallelFor(other_tp.get(), num_tasks,
+                                     [&](std::ptrdiff_t i) { IncrementElement(*other_test_data, i); });
+  }
+  ValidateTestData(*test_data, 3);
+  ValidateTestData(*other_test_data);
+}
+
+TEST(ThreadPoolTest, TestNumaNodes) {
+  constexpr int num_threads = 4;
+  for (bool numa_local_stealing : {true, false}) {
+    onnxruntime::ThreadOptions thread_options;
+    // empty affinities leave the threads unbound, the first entry is for the caller
+    thread_options.affinities.resize(num_threads + 1);
+    thread_options.numa_nodes = {0, 0, 0, 3, 3};
+    thread_options.numa_local_stealing = numa_local_stealing;
+    auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads + 1,
+                                           true);
+    ASSERT_EQ(tp->NumThreads(), num_threads);
+
+    // each node claims its own part of the iterations first, every iteration still runs once
+    for (int i = 0; i < 10; ++i) {
+      auto test_data = CreateTestData(1000);
+      ThreadPool::TryBatchParallelFor(
+          tp.get(), 1000, [&](std::ptrdiff_t idx) { IncrementElement(*test_data, idx); }, 0);
+      ValidateTestData(*test_data);
+    }
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(tp.get(), 1000, 1.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestCalibratedLoopCosts) {
+  constexpr int num_threads = 4;
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.calibrate_loop_costs = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads + 1,
+                                         true);
+
+  // a loop of cheap iterations with a far too high cost estimate
+  constexpr std::ptrdiff_t num_iterations = 100;
+  const auto caller_id = std::this_thread::get_id();
+  bool ran_on_other_thread = false;
+  OrtMutex mutex;
+  auto run_loop = [&]() {
+    auto test_data = CreateTestData(num_iterations);
+    ThreadPool::TryParallelFor(tp.get(), num_iterations, 1e6, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      if (std::this_thread::get_id() != caller_id) {
+        std::lock_guard<OrtMutex> lock(mutex);
+        ran_on_other_thread = true;
+      }
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  };
+
+  // the first calls are measured, after that the loop runs in the caller only
+  for (int i = 0; i < 10; ++i) {
+    run_loop();
+  }
+  ran_on_other_thread = false;
+  run_loop();
+  ASSERT_FALSE(ran_on_other_thread);
+}
+
+TEST(ThreadPoolTest, TestProfilingStats) {
+  constexpr int num_threads = 4;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                         num_threads + 1, true);
+  // nothing is collected until profiling starts
+  ASSERT_TRUE(ThreadPool::GetProfilingStats(tp.get()).empty());
+  ASSERT_TRUE(ThreadPool::GetProfilingStats(nullptr).empty());
+
+  ThreadPool::StartProfiling(tp.get());
+  auto test_data = CreateTestData(10000);
+  for (int i = 0; i < 10; ++i) {
+    ThreadPool::TrySimpleParallelFor(tp.get(), 10000, [&](std::ptrdiff_t idx) {
+      IncrementElement(*test_data, idx);
+    });
+  }
+  ThreadPool::StopProfiling(tp.get());
+
+  // statistics can still be read after a profiled section ends
+  auto stats = ThreadPool::GetProfilingStats(tp.get());
+#if defined(ORT_MINIMAL_BUILD)
+  ASSERT_TRUE(stats.empty());
+#else
+  ASSERT_EQ(stats.size(), static_cast<size_t>(num_threads));
+  uint64_t num_runs = 0;
+  for (const auto& thread_stats : stats) {
+    num_runs += thread_stats.num_runs;
+    ASSERT_LE(thread_stats.num_steals, thread_stats.num_runs);
+    ASSERT_LE(thread_stats.StealRate(), 1.0);
+    ASSERT_GE(thread_stats.IdlePercentage(), 0.0);
+    ASSERT_LE(thread_stats.IdlePercentage(), 100.0);
+  }
+  ASSERT_GT(num_runs, 0u);
+#endif
+}
+
+TEST(ThreadPoolTest, TestSharedPoolViews) {
+  constexpr int num_threads = 4;
+  auto shared_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                num_threads + 1, true);
+  ASSERT_EQ(shared_tp->NumThreads(), num_threads);
+  // 1, or the task granularity factor of a hybrid CPU
+  const int granularity = ThreadPool::DegreeOfParallelism(shared_tp.get()) / (num_threads + 1);
+
+  ThreadPool quota_view(*shared_tp, 2, ThreadPool::SchedulingPriority::kNormal);
+  ThreadPool normal_view(*shared_tp, 0, ThreadPool::SchedulingPriority::kNormal);
+  ThreadPool high_view(*shared_tp, 0, ThreadPool::SchedulingPriority::kHigh);
+  ASSERT_EQ(quota_view.NumThreads(), num_threads);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&quota_view), 2 * granularity);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&normal_view), (num_threads + 1) * granularity);
+
+  // normal priority views get half of the pool while a high priority run is in progress
+  ThreadPool::BeginRun(&high_view);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&normal_view), ((num_threads + 1) / 2) * granularity);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&high_view), (num_threads + 1) * granularity);
+  ThreadPool::EndRun(&high_view);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&normal_view), (num_threads + 1) * granularity);
+
+  // a quota of 1 runs the loops on the calling thread
+  ThreadPool serial_view(*shared_tp, 1, ThreadPool::SchedulingPriority::kNormal);
+  for (ThreadPool* view : {&quota_view, &serial_view}) {
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(view, 1000, 1.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestRunScope) {
+  constexpr int num_threads = 4;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                         num_threads + 1, true);
+  // 1, or the task granularity factor of a hybrid CPU
+  const int granularity = ThreadPool::DegreeOfParallelism(tp.get()) / (num_threads + 1);
+
+  {
+    ThreadPool::RunScope scope(tp.get(), 2, std::nullopt);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2 * granularity);
+    {
+      ThreadPool::RunScope inner_scope(tp.get(), 1, std::nullopt);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), granularity);
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2 * granularity);
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), (num_threads + 1) * granularity);
+
+  // the runs of normal priority get half of the pool while a high priority run is in progress on another thread
+  std::atomic<bool> high_run_started{false};
+  std::atomic<bool> high_run_done{false};
+  std::thread high_run([&]() {
+    ThreadPool::RunScope scope(tp.get(), 0, ThreadPool::SchedulingPriority::kHigh);
+    EXPECT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), (num_threads + 1) * granularity);
+    high_run_started = true;
+    while (!high_run_done) {
+      std::this_thread::yield();
+    }
+  });
+  while (!high_run_started) {
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), ((num_threads + 1) / 2) * granularity);
+  high_run_done = true;
+  high_run.join();
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), (num_threads + 1) * granularity);
+}
+
+TEST(ThreadPoolTest, TestCallerLeases) {
+  constexpr int num_threads = 4;
+  ThreadOptions to;
+  to.lease_workers_to_callers = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, num_threads + 1, true);
+  // 1, or the task granularity factor of a hybrid CPU
+  const int granularity = ThreadPool::DegreeOfParallelism(tp.get()) / (num_threads + 1);
+
+  std::promise<void> other_caller_started;
+  std::promise<void> other_caller_done;
+  std::thread other_caller([&]() {
+    ThreadPool::ParallelSection ps(tp.get());
+    other_caller_started.set_value();
+    other_caller_done.get_future().wait();
+  });
+  other_caller_started.get_future().wait();
+
+  {
+    // the two concurrent callers get half of the threads each
+    ThreadPool::ParallelSection ps(tp.get());
+    EXPECT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), ((num_threads + 1) / 2) * granularity);
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(tp.get(), 1000, 1.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+
+  other_caller_done.set_value();
+  other_caller.join();
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), (num_threads + 1) * granularity);
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
@@ -1042,6 +1042,74 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// The subgraph passes 'cond' through, so the trip count is 'M' and the scan outputs are written in place.
+// The same subgraph value is also used for two scan outputs, which are concatenated.
+TEST(Loop, FixedTripCountScanOutputs) {
+  auto create_subgraph = []() {
+    Model model("Fixed trip count subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    /* Inputs: iter_num, cond_in.
+
+         iter_num_in    cond_in
+             |             |
+           [Add]           |
+             |             |
+        doubled_out    cond_in
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& iter_num_out = graph.GetOrCreateNodeArg("iter_num_out", &int64_scalar);
+    auto& doubled_out = graph.GetOrCreateNodeArg("doubled_out", &int64_scalar);
+
+    graph.AddNode("iter_num_identity", "Identity", "Forward iter_num_in to iter_num_out",
+                  {&iter_num_in}, {&iter_num_out});
+    graph.AddNode("double", "Add", "Double iter_num_in", {&iter_num_in, &iter_num_in}, {&doubled_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in});
+    graph.SetOutputs({&cond_in, &iter_num_out, &doubled_out, &doubled_out});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  auto run_test = [&create_subgraph](int64_t max_iterations) {
+    OpTester test("Loop", 11);
+    auto body = create_subgraph();
+    test.AddAttribute<GraphProto>("body", body);
+    test.AddInput<int64_t>("M", {1}, {max_iterations});
+    test.AddInput<bool>("cond", {1}, {true});
+
+    std::vector<int64_t> iter_nums;
+    std::vector<int64_t> doubled;
+    for (int64_t i = 0; i < max_iterations; ++i) {
+      iter_nums.push_back(i);
+      doubled.push_back(i * 2);
+    }
+
+    test.AddOutput<int64_t>("iter_nums", {max_iterations, 1}, iter_nums);
+    test.AddOutput<int64_t>("doubled_0", {max_iterations, 1}, doubled);
+    test.AddOutput<int64_t>("doubled_1", {max_iterations, 1}, doubled);
+
+    // Disable TensorRT on unsupported data type BOOL
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  };
+
+  run_test(1);
+  run_test(5);
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -247,5 +247,72 @@ TEST(CumSumTest, _1DTestdouble_WithInt64Axis) {
   test.AddOutput<double>("y", {5}, {1., 3., 6., 10., 15.});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+
+// Reference cumulative sum of a [outer, dim, inner] tensor along dim.
+template <typename T>
+static std::vector<T> ReferenceCumSum(const std::vector<T>& x, int64_t outer, int64_t dim, int64_t inner,
+                                      bool exclusive, bool reverse) {
+  std::vector<T> y(x.size());
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t c = 0; c < inner; ++c) {
+      T sum{};
+      for (int64_t k = 0; k < dim; ++k) {
+        const int64_t d = reverse ? dim - 1 - k : k;
+        const size_t i = static_cast<size_t>((o * dim + d) * inner + c);
+        if (exclusive) {
+          y[i] = sum;
+          sum += x[i];
+        } else {
+          sum += x[i];
+          y[i] = sum;
+        }
+      }
+    }
+  }
+  return y;
+}
+
+// rows that do not fill the vectors of the scan, in every mode
+TEST(CumSumTest, _2DTestLongRowsAllModes) {
+  constexpr int64_t batch = 3, length = 1001;
+  std::vector<float> x(batch * length);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(static_cast<int>(i * 13 % 7) - 3);
+  }
+  for (int64_t exclusive : {0, 1}) {
+    for (int64_t reverse : {0, 1}) {
+      OpTester test("CumSum", 14, onnxruntime::kOnnxDomain);
+      test.AddAttribute<int64_t>("exclusive", exclusive);
+      test.AddAttribute<int64_t>("reverse", reverse);
+      test.AddInput<float>("x", {batch, length}, x);
+      test.AddInput<int64_t>("axis", {}, {-1});
+      test.AddOutput<float>("y", {batch, length},
+                            ReferenceCumSum(x, batch, length, 1, exclusive != 0, reverse != 0));
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    }
+  }
+}
+
+// inner dims spanning several blocks of columns and a partial one
+TEST(CumSumTest, _3DTestWideInnerDimsAllModes) {
+  constexpr int64_t outer = 2, dim = 5, inner = 600;
+  std::vector<int64_t> x(outer * dim * inner);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<int64_t>(i * 31 % 17) - 8;
+  }
+  for (int64_t exclusive : {0, 1}) {
+    for (int64_t reverse : {0, 1}) {
+      OpTester test("CumSum", 14, onnxruntime::kOnnxDomain);
+      test.AddAttribute<int64_t>("exclusive", exclusive);
+      test.AddAttribute<int64_t>("reverse", reverse);
+      test.AddInput<int64_t>("x", {outer, dim, inner}, x);
+      test.AddInput<int32_t>("axis", {}, {1});
+      test.AddOutput<int64_t>("y", {outer, dim, inner},
+                              ReferenceCumSum(x, outer, dim, inner, exclusive != 0, reverse != 0));
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -571,6 +571,28 @@ TEST(Einsum, ExplicitEinsumAsTensorContractionSameInput) {
 }
 
 // Implicit
+// The vector is contracted first, the intermediate results never hold more than the output
+TEST(Einsum, ExplicitEinsumAsMatmulChain_ContractionPath) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 4}, {-5.f, -4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("z", {4}, {1.f, -1.f, 2.f, 0.5f});
+  test.AddOutput<float>("o", {2}, {32.f, 50.f});
+  test.Run();
+}
+
+TEST(Einsum, ExplicitEinsumAsMatmulChain_ContractionPath_OutputTransposed) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,cd,d->da");
+  test.AddInput<float>("x", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("y", {2, 3}, {1.f, 0.f, 2.f, -1.f, 1.f, 3.f});
+  test.AddInput<float>("z", {3, 2}, {2.f, 1.f, 0.f, 1.f, 1.f, -2.f});
+  test.AddInput<float>("w", {2}, {3.f, -1.f});
+  test.AddOutput<float>("o", {2, 2}, {18.f, 48.f, 15.f, 33.f});
+  test.Run();
+}
+
 TEST(Einsum, ImplicitEinsumAsTensorContraction) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "abcd,ea");
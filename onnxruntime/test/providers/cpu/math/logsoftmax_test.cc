@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -291,5 +292,29 @@ TEST(LogSoftmaxOperator, 2DInputReduceOnAxis1WithLargeDim) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
+TEST(LogSoftmaxOperator, StridedAxisWithLargeInnerDim_opset13) {
+  // the inner dims of axis 1 span several blocks of columns of the strided kernel and a partial one
+  constexpr int64_t outer = 2, d = 7, inner = 130;
+  std::vector<float> x_vals(static_cast<size_t>(outer * d * inner));
+  std::vector<float> expected_vals(x_vals.size());
+  for (size_t i = 0; i < x_vals.size(); ++i) {
+    x_vals[i] = static_cast<float>((i * 5) % 19) / 3.0f - 3.0f;
+  }
+  for (int64_t n = 0; n < outer; ++n) {
+    for (int64_t c = 0; c < inner; ++c) {
+      float sum = 0.0f;
+      for (int64_t j = 0; j < d; ++j) {
+        sum += std::exp(x_vals[(n * d + j) * inner + c]);
+      }
+      for (int64_t j = 0; j < d; ++j) {
+        const int64_t i = (n * d + j) * inner + c;
+        expected_vals[i] = x_vals[i] - std::log(sum);
+      }
+    }
+  }
+
+  RunTest(x_vals, expected_vals, {outer, d, inner}, /*opset*/ 13, /*axis*/ 1, false);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
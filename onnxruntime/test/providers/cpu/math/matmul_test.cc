@@ -2,11 +2,13 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
+#include "test/util/include/asserts.h"
 #include "default_providers.h"
 
 namespace onnxruntime {
@@ -145,7 +147,8 @@ std::vector<MatMulTestData<T>> GenerateTestCases() {
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant) {
+void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant,
+                   bool use_specialized_gemm = false) {
   for (auto t : GenerateTestCases<T>()) {
     SCOPED_TRACE("test case: " + t.name);
 
@@ -172,6 +175,12 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
       excluded_providers.insert(kNnapiExecutionProvider);
     }
 
+    if (use_specialized_gemm) {
+      SessionOptions so;
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasShapeSpecializedGemm, "1"));
+      test.Config(so);
+    }
+
     test.ConfigExcludeEps(excluded_providers)
         .Config(run_with_tunable_op)
         .RunWithConfig();
@@ -203,6 +212,14 @@ TEST(MathOpTest, MatMulFloatTypeInitializer) {
   RunMatMulTest<float>(7, false, true);
 }
 
+TEST(MathOpTest, MatMulFloatTypeInitializerShapeSpecializedGemm) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: Assertion failed: m_bufferTensorDesc.TotalTensorSizeInBytes >= ComputeByteSizeFromDimensions(nonBroadcastDimensions, dataType)";
+  }
+  RunMatMulTest<float>(7, false, true, true);
+}
+
 TEST(MathOpTest, MatMulInt32Type) {
   RunMatMulTest<int32_t>(9);
 }
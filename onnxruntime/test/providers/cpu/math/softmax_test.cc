@@ -49,7 +49,6 @@ TEST(SoftmaxOperator, Simple) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
-#if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(SoftmaxOperator, Simple_fp16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -76,7 +75,6 @@ TEST(SoftmaxOperator, Simple_fp16) {
   test.AddOutput<MLFloat16>("Y", dimensions, f_Y);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
-#endif
 
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(SoftmaxOperator, Simple_bfloat16) {
@@ -405,6 +403,54 @@ TEST(SoftmaxOperator, 2DInputReduceOnAxis1WithLargeDim) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
+// The inner dims of a non innermost axis span several blocks of columns of the strided kernel and a partial one.
+static void GetStridedSoftmaxTestData(std::vector<float>& x_vals, std::vector<float>& expected_vals,
+                                      int64_t outer, int64_t d, int64_t inner) {
+  x_vals.resize(static_cast<size_t>(outer * d * inner));
+  expected_vals.resize(x_vals.size());
+  for (size_t i = 0; i < x_vals.size(); ++i) {
+    x_vals[i] = static_cast<float>((i * 7) % 23) / 4.0f - 2.5f;
+  }
+  for (int64_t n = 0; n < outer; ++n) {
+    for (int64_t c = 0; c < inner; ++c) {
+      float sum = 0.0f;
+      for (int64_t j = 0; j < d; ++j) {
+        sum += std::exp(x_vals[(n * d + j) * inner + c]);
+      }
+      for (int64_t j = 0; j < d; ++j) {
+        const int64_t i = (n * d + j) * inner + c;
+        expected_vals[i] = std::exp(x_vals[i]) / sum;
+      }
+    }
+  }
+}
+
+TEST(SoftmaxOperator, StridedAxisWithLargeInnerDim_opset13) {
+  std::vector<float> x_vals;
+  std::vector<float> expected_vals;
+  GetStridedSoftmaxTestData(x_vals, expected_vals, 2, 9, 150);
+
+  RunTest(x_vals, expected_vals, {2, 9, 3, 50}, /*opset*/ 13, /*axis*/ 1,
+          {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+TEST(SoftmaxOperator, StridedAxis_fp16) {
+  std::vector<float> x_vals;
+  std::vector<float> expected_vals;
+  GetStridedSoftmaxTestData(x_vals, expected_vals, 2, 5, 70);
+
+  std::vector<MLFloat16> f_X(x_vals.size());
+  std::vector<MLFloat16> f_Y(expected_vals.size());
+  ConvertFloatToMLFloat16(x_vals.data(), f_X.data(), x_vals.size());
+  ConvertFloatToMLFloat16(expected_vals.data(), f_Y.data(), expected_vals.size());
+
+  OpTester test("Softmax", 13);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddInput<MLFloat16>("X", {2, 5, 70}, f_X);
+  test.AddOutput<MLFloat16>("Y", {2, 5, 70}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 // Regression test for NNAPI handling of a Softmax with opset < 13 where the input has been converted to NHWC.
 // The NNAPI handling of the axis is different so we need to manually coerce the input to 2D, which will negate the
 // layout change. Test model has a GlobalAveragePool -> Softmax which will trigger the layout change due to
@@ -861,5 +861,32 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded<double>(k, n, batch_size);
 }
 
+// a few long rows are split into chunks whose top k are merged. the values repeat so the ties across chunks must
+// resolve to the lowest index.
+TEST(TopKOperator, PriorityQueueLongRows) {
+  constexpr int64_t k = 24;
+  constexpr int64_t rows = 2;
+  constexpr int64_t cols = 150000;
+  std::vector<float> input_vals(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    input_vals[i] = static_cast<float>((i * 7919) % 5003);
+  }
+
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t row = 0; row < rows; ++row) {
+    std::vector<int64_t> order(cols);
+    std::iota(order.begin(), order.end(), 0);
+    const float* row_vals = input_vals.data() + row * cols;
+    std::stable_sort(order.begin(), order.end(), [row_vals](int64_t a, int64_t b) { return row_vals[a] > row_vals[b]; });
+    for (int64_t l = 0; l < k; ++l) {
+      expected_vals.push_back(row_vals[order[l]]);
+      expected_indices.push_back(order[l]);
+    }
+  }
+
+  RunTest(11, k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k}, false);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
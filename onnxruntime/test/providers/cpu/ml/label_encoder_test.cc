@@ -511,5 +511,32 @@ TEST(LabelEncoder, DoubleNaNsMappedTogetherOpset4) {
   test.Run();
 }
 
+TEST(LabelEncoder, ManyStringKeysOpset2) {
+  // Enough keys to grow the table several times, with shared prefixes, an empty key and a duplicated key
+  // whose first value is kept.
+  std::vector<std::string> keys{"", "dup"};
+  std::vector<std::int64_t> values{-1, 7};
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back("category_" + std::to_string(i));
+    values.push_back(i);
+  }
+  keys.push_back("dup");
+  values.push_back(8);
+
+  std::vector<std::string> input{"category_0", "", "category_999", "category_1000", "dup", "category_12",
+                                 "category_", "category_5000"};
+  std::vector<std::int64_t> output{0, -1, 999, 42, 7, 12, 42, 42};
+  std::vector<std::int64_t> dims{2, 4};
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)42);
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,8 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/default_providers.h"
+#include "test/util/include/temp_dir.h"
 
 namespace onnxruntime {
 namespace test {
@@ -760,5 +766,134 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+
+// Full trees of depth 6 (64 leaves) are evaluated with the QuickScorer bitvectors, deeper trees by blocks of rows
+// on large batches. The expected values come from walking the same trees node by node.
+void GenDeepTreesAndRunTest(const std::string& mode, int64_t depth, int64_t n_targets, int64_t n_obs,
+                            const std::string& compiled_dir = "") {
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  const int64_t n_trees = 100;
+  const int64_t n_features = 5;
+  const int64_t n_branches = (int64_t(1) << depth) - 1;
+  const int64_t n_nodes = 2 * n_branches + 1;
+
+  std::vector<int64_t> nodes_truenodeids, nodes_falsenodeids, nodes_treeids, nodes_nodeids, nodes_featureids;
+  std::vector<float> nodes_values;
+  std::vector<std::string> nodes_modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t t = 0; t < n_trees; ++t) {
+    for (int64_t k = 0; k < n_nodes; ++k) {
+      bool is_leaf = k >= n_branches;
+      nodes_treeids.push_back(t);
+      nodes_nodeids.push_back(k);
+      nodes_truenodeids.push_back(is_leaf ? 0 : 2 * k + 1);
+      nodes_falsenodeids.push_back(is_leaf ? 0 : 2 * k + 2);
+      nodes_featureids.push_back(is_leaf ? 0 : (t + k) % n_features);
+      nodes_values.push_back(is_leaf ? 0.f : static_cast<float>((t * 31 + k * 17) % 13) / 4.f - 1.5f);
+      nodes_modes.push_back(is_leaf ? "LEAF" : mode);
+      if (is_leaf) {
+        for (int64_t c = 0; c < n_targets; ++c) {
+          target_treeids.push_back(t);
+          target_nodeids.push_back(k);
+          target_ids.push_back(c);
+          target_weights.push_back(static_cast<float>((t * 7 + k * 3 + c * 5) % 11) - 5.f);
+        }
+      }
+    }
+  }
+
+  std::vector<float> X(n_obs * n_features);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 37) % 17) / 4.f - 2.f;
+  }
+
+  std::vector<float> Y(n_obs * n_targets, 0.f);
+  for (int64_t i = 0; i < n_obs; ++i) {
+    for (int64_t t = 0; t < n_trees; ++t) {
+      int64_t k = 0;
+      while (k < n_branches) {
+        size_t node = static_cast<size_t>(t * n_nodes + k);
+        float x = X[i * n_features + nodes_featureids[node]];
+        float threshold = nodes_values[node];
+        bool is_true = mode == "BRANCH_LEQ"   ? x <= threshold
+                       : mode == "BRANCH_LT"  ? x < threshold
+                       : mode == "BRANCH_GTE" ? x >= threshold
+                                              : x > threshold;
+        k = is_true ? nodes_truenodeids[node] : nodes_falsenodeids[node];
+      }
+      for (int64_t c = 0; c < n_targets; ++c) {
+        Y[i * n_targets + c] += target_weights[((t * (n_branches + 1)) + (k - n_branches)) * n_targets + c];
+      }
+    }
+  }
+
+  test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+  test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+  test.AddAttribute("nodes_treeids", nodes_treeids);
+  test.AddAttribute("nodes_nodeids", nodes_nodeids);
+  test.AddAttribute("nodes_featureids", nodes_featureids);
+  test.AddAttribute("nodes_values", nodes_values);
+  test.AddAttribute("nodes_modes", nodes_modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", n_targets);
+
+  test.AddInput<float>("X", {n_obs, n_features}, X);
+  test.AddOutput<float>("Y", {n_obs, n_targets}, Y);
+  if (compiled_dir.empty()) {
+    test.Run();
+  } else {
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleCompiledDir, compiled_dir.c_str()));
+    test.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  }
+}
+
+TEST(MLOpTest, TreeRegressorDeepTreesSingleTarget) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT"}) {
+    GenDeepTreesAndRunTest(mode, 6, 1, 1);
+    GenDeepTreesAndRunTest(mode, 6, 1, 67);
+  }
+}
+
+TEST(MLOpTest, TreeRegressorDeepTreesMultiTarget) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_GTE"}) {
+    GenDeepTreesAndRunTest(mode, 6, 3, 1);
+    GenDeepTreesAndRunTest(mode, 6, 3, 67);
+  }
+}
+
+TEST(MLOpTest, TreeRegressorDeepTreesBlocks) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_GT"}) {
+    GenDeepTreesAndRunTest(mode, 7, 1, 67);
+    GenDeepTreesAndRunTest(mode, 7, 3, 200);
+  }
+}
+
+TEST(MLOpTest, TreeRegressorCompiledSource) {
+  // The library is not built by the test, the trees are interpreted and their source is saved for compilation.
+  TemporaryDirectory tmp_dir(ORT_TSTR("tree_ensemble_compiled_test"));
+  auto count_sources = [&tmp_dir]() {
+    size_t n_sources = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(tmp_dir.Path())) {
+      n_sources += entry.path().extension() == ORT_TSTR(".c") ? 1 : 0;
+    }
+    return n_sources;
+  };
+
+  GenDeepTreesAndRunTest("BRANCH_LEQ", 6, 1, 8, PathToUTF8String(tmp_dir.Path()));
+  ASSERT_EQ(count_sources(), 1u);
+
+  // The same model maps to the same source.
+  GenDeepTreesAndRunTest("BRANCH_LEQ", 6, 1, 8, PathToUTF8String(tmp_dir.Path()));
+  ASSERT_EQ(count_sources(), 1u);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -403,6 +406,176 @@ TEST(ConvTest, Conv2D_Bias_2) {
   TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape, true);
 }
 
+// The Winograd algorithm is opt-in and computes 3x3 filters with at least 16 input channels and filters per group.
+TEST(ConvTest, Conv2D_Winograd) {
+  const int64_t N = 2, C = 16, H = 9, W = 7, M = 20;
+  const int64_t pad = 1;
+  const int64_t OH = H + 2 * pad - 2, OW = W + 2 * pad - 2;
+
+  vector<float> X(N * C * H * W);
+  vector<float> Wt(M * C * 3 * 3);
+  vector<float> B(M);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(static_cast<int>(i * 7 % 13) - 6) / 8.0f;
+  }
+  for (size_t i = 0; i < Wt.size(); i++) {
+    Wt[i] = static_cast<float>(static_cast<int>(i * 5 % 11) - 5) / 16.0f;
+  }
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<float>(i) / 4.0f;
+  }
+
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          double sum = B[m];
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = oh + kh - pad, iw = ow + kw - pad;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += double(X[((n * C + c) * H + ih) * W + iw]) * double(Wt[((m * C + c) * 3 + kh) * 3 + kw]);
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  OpTester test("Conv", 11);
+  test.AddAttribute("group", int64_t(1));
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{pad, pad, pad, pad});
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+  test.AddInput<float>("B", {M}, B, true);
+  test.AddOutput<float>("Y", {N, M, OH, OW}, Y);
+  test.SetOutputTolerance(1e-4f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasConvWinograd, "1"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(ConvTest, Conv2D_WeightOnlyQuantizedFilter) {
+  const int64_t N = 2, C = 6, H = 7, W = 5, M = 18;
+  const int64_t pad = 1;
+  const int64_t OH = H + 2 * pad - 2, OW = W + 2 * pad - 2;
+
+  // Every block of 32 filter elements holds the multiples of 1/8 from -7/8 to 7/8, so the 4-bit quantization is exact.
+  vector<float> X(N * C * H * W);
+  vector<float> Wt(M * C * 3 * 3);
+  vector<float> B(M);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(static_cast<int>(i * 7 % 13) - 6) / 8.0f;
+  }
+  for (size_t i = 0; i < Wt.size(); i++) {
+    Wt[i] = static_cast<float>(static_cast<int>(i % 15) - 7) / 8.0f;
+  }
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<float>(i) / 4.0f;
+  }
+
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          double sum = B[m];
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = oh + kh - pad, iw = ow + kw - pad;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += double(X[((n * C + c) * H + ih) * W + iw]) * double(Wt[((m * C + c) * 3 + kh) * 3 + kw]);
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  OpTester test("Conv", 11);
+  test.AddAttribute("group", int64_t(1));
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{pad, pad, pad, pad});
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+  test.AddInput<float>("B", {M}, B, true);
+  test.AddOutput<float>("Y", {N, M, OH, OW}, Y);
+  test.SetOutputTolerance(1e-4f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasConvWeightOnlyQuantizationBits, "4"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(ConvTest, Conv2D_CpuTunableOp) {
+  const int64_t N = 2, C = 5, H = 4, W = 6, M = 30;
+  const int64_t pad = 1;
+  const int64_t OH = H + 2 * pad - 2, OW = W + 2 * pad - 2;
+
+  vector<float> X(N * C * H * W);
+  vector<float> Wt(M * C * 3 * 3);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(static_cast<int>(i * 7 % 13) - 6) / 8.0f;
+  }
+  for (size_t i = 0; i < Wt.size(); i++) {
+    Wt[i] = static_cast<float>(static_cast<int>(i % 15) - 7) / 8.0f;
+  }
+
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          double sum = 0.0;
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = oh + kh - pad, iw = ow + kw - pad;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += double(X[((n * C + c) * H + ih) * W + iw]) * double(Wt[((m * C + c) * 3 + kh) * 3 + kw]);
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  // Every candidate algorithm is run while tuning, and the output of the fastest is checked.
+  OpTester test("Conv", 11);
+  test.AddAttribute("group", int64_t(1));
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{pad, pad, pad, pad});
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+  test.AddOutput<float>("Y", {N, M, OH, OW}, Y);
+  test.SetOutputTolerance(1e-4f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpTuningEnable, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "1"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
 TEST(ConvTest, Conv2D_AutoPad1) {
   ConvOpAndTestAttributes attrs = {
       "SAME_UPPER",           // auto_pad
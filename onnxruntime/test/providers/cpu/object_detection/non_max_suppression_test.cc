@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -383,5 +386,60 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+// A grid of disjoint boxes, each with a shifted copy of lower score that it suppresses.
+static void TestManyBoxes(bool sorted_bitmask) {
+  constexpr int64_t num_batches = 2;
+  constexpr int64_t num_classes = 2;
+  constexpr int64_t grid_size = 10;
+  constexpr int64_t num_kept = grid_size * grid_size;
+  constexpr int64_t num_boxes = 2 * num_kept;
+
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  std::vector<int64_t> expected;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (float shift : {0.0f, 0.05f}) {
+      for (int64_t i = 0; i < num_kept; ++i) {
+        const float y = static_cast<float>(i / grid_size) * 2 + shift;
+        const float x = static_cast<float>(i % grid_size) * 2 + shift;
+        boxes.insert(boxes.end(), {y, x, y + 1.0f, x + 1.0f});
+      }
+    }
+    for (int64_t c = 0; c < num_classes; ++c) {
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        // the classes rank the kept boxes in opposite orders
+        const int64_t rank = c == 0 ? i % num_kept : num_kept - 1 - i % num_kept;
+        scores.push_back((i < num_kept ? 1.0f : 0.5f) - static_cast<float>(rank) * 0.001f);
+      }
+      for (int64_t rank = 0; rank < num_kept; ++rank) {
+        expected.insert(expected.end(), {batch, c, c == 0 ? rank : num_kept - 1 - rank});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {num_boxes});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * num_kept, 3}, expected);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsNonMaxSuppressionSortedBitmask,
+                                                    sorted_bitmask ? "1" : "0"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(NonMaxSuppressionOpTest, ManyBoxes) {
+  TestManyBoxes(false);
+}
+
+TEST(NonMaxSuppressionOpTest, ManyBoxesSortedBitmask) {
+  TestManyBoxes(true);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
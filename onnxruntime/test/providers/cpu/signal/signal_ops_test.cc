@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -233,6 +234,76 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// Reference DFT of every frame of `frame_length` values starting every `frame_step` values.
+static vector<float> NaiveFramesDFT(const vector<float>& signal, const vector<float>& window, int64_t num_frames,
+                                    int64_t frame_step, int64_t frame_length, int64_t output_size) {
+  vector<float> output;
+  for (int64_t frame = 0; frame < num_frames; frame++) {
+    for (int64_t k = 0; k < output_size; k++) {
+      double real = 0, imag = 0;
+      for (int64_t j = 0; j < frame_length; j++) {
+        const double x = signal[frame * frame_step + j] * (window.empty() ? 1.0 : window[j]);
+        const double angle = -2.0 * M_PI * static_cast<double>((j * k) % frame_length) / frame_length;
+        real += x * std::cos(angle);
+        imag += x * std::sin(angle);
+      }
+      output.push_back(static_cast<float>(real));
+      output.push_back(static_cast<float>(imag));
+    }
+  }
+  return output;
+}
+
+static void TestMixedRadixDFTFloat(bool onesided, int64_t dft_length) {
+  OpTester test("DFT", kOpsetVersion20);
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t num_batches = 3;
+  vector<int64_t> shape{num_batches, dft_length, 1};
+  vector<float> input = random.Uniform<float>(shape, -1.f, 1.f);
+  const int64_t output_size = onesided ? (dft_length >> 1) + 1 : dft_length;
+
+  test.AddInput<float>("input", shape, input);
+  test.AddInput<int64_t>("dft_length", {}, {dft_length});
+  test.AddInput<int64_t>("axis", {}, {1});
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddOutput<float>("output", {num_batches, output_size, 2},
+                        NaiveFramesDFT(input, {}, num_batches, dft_length, dft_length, output_size));
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix) {
+  for (int64_t dft_length : {12, 15, 400}) {
+    TestMixedRadixDFTFloat(false, dft_length);
+    TestMixedRadixDFTFloat(true, dft_length);
+  }
+}
+
+TEST(SignalOpsTest, STFTFloat_MixedRadix) {
+  OpTester test("STFT", kMinOpsetVersion);
+
+  constexpr int64_t signal_length = 1600;
+  constexpr int64_t frame_length = 400;
+  constexpr int64_t frame_step = 160;
+  constexpr int64_t num_frames = (signal_length - frame_length) / frame_step + 1;
+  constexpr int64_t output_size = frame_length / 2 + 1;
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<int64_t> signal_shape{1, signal_length, 1};
+  vector<int64_t> window_shape{frame_length};
+  vector<float> signal = random.Uniform<float>(signal_shape, -1.f, 1.f);
+  vector<float> window = random.Uniform<float>(window_shape, 0.f, 1.f);
+  test.AddInput<float>("signal", signal_shape, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", window_shape, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+
+  test.AddOutput<float>("output", {1, num_frames, output_size, 2},
+                        NaiveFramesDFT(signal, window, num_frames, frame_step, frame_length, output_size));
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
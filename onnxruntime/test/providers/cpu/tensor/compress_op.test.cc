@@ -148,5 +148,46 @@ TEST(CompressTest, Compress_3dims_neg_axis) {
   test.Run();
 }
 
+// large enough to be counted and scattered in several chunks
+TEST(CompressTest, Compress_default_axis_large_input) {
+  constexpr int64_t size = 100000;
+  std::vector<int32_t> input(size);
+  std::unique_ptr<bool[]> condition = std::make_unique<bool[]>(size);
+  std::vector<int32_t> output;
+  for (int64_t i = 0; i < size; ++i) {
+    input[i] = static_cast<int32_t>(i);
+    condition[i] = i % 3 == 0 || i > size - 100;
+    if (condition[i]) {
+      output.push_back(input[i]);
+    }
+  }
+
+  OpTester test("Compress", 11);
+  test.AddInput<int32_t>("input", {size / 4, 4}, input);
+  test.AddInput<bool>("condition", {size}, condition.get(), size);
+  test.AddOutput<int32_t>("output", {static_cast<int64_t>(output.size())}, output);
+  test.Run();
+}
+
+TEST(CompressTest, Compress_axis_many_rows) {
+  constexpr int64_t rows = 1000, cols = 8;
+  const bool condition[cols] = {true, false, false, true, true, false, true, false};
+  std::vector<float> input(rows * cols);
+  std::vector<float> output;
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    input[i] = static_cast<float>(i);
+    if (condition[i % cols]) {
+      output.push_back(input[i]);
+    }
+  }
+
+  OpTester test("Compress", 11);
+  test.AddAttribute("axis", int64_t(1));
+  test.AddInput<float>("input", {rows, cols}, input);
+  test.AddInput<bool>("condition", {cols}, condition, cols);
+  test.AddOutput<float>("output", {rows, 4}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
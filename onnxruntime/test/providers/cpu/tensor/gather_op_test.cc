@@ -369,6 +369,29 @@ TEST(GatherOpTest, Gather_perf) {
   test.Run();
 }
 
+// rows of 16 floats are copied with fixed size moves, negative and repeated indices included
+TEST(GatherOpTest, Gather_axis0_embedding_lookup) {
+  constexpr int64_t num_rows = 1000;
+  constexpr int64_t row_size = 16;
+  std::vector<float> table(num_rows * row_size);
+  std::iota(table.begin(), table.end(), 0.0f);
+
+  std::vector<int64_t> indices(300);
+  std::vector<float> output;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    int64_t row = static_cast<int64_t>((i * 37) % num_rows);
+    indices[i] = i % 3 == 0 ? row - num_rows : row;
+    output.insert(output.end(), table.begin() + row * row_size, table.begin() + (row + 1) * row_size);
+  }
+
+  OpTester test("Gather", 13);
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {num_rows, row_size}, table);
+  test.AddInput<int64_t>("indices", {static_cast<int64_t>(indices.size())}, indices);
+  test.AddOutput<float>("output", {static_cast<int64_t>(indices.size()), row_size}, output);
+  test.Run();
+}
+
 TEST(GatherOpTest, Gather_axis1_neg_indices2d_int8) {
   OpTester test("Gather", 11);
   test.AddAttribute<int64_t>("axis", 1LL);
@@ -99,5 +99,31 @@ TEST(NonZeroOpTest, EmptyInput) {
   test.Run();
 }
 
+// large enough to be counted and scattered in several chunks
+TEST(NonZeroOpTest, LargeInput) {
+  const std::vector<int64_t> X_dims{4, 250, 100};
+  const int64_t size = 4 * 250 * 100;
+  std::vector<int32_t> X(size);
+  std::vector<std::vector<int64_t>> coordinates(3);
+  for (int64_t i = 0; i < size; ++i) {
+    X[i] = (i % 7 == 0 || (i > size / 2 && i % 3 == 0)) ? static_cast<int32_t>(i % 5 + 1) : 0;
+    if (X[i] != 0) {
+      coordinates[0].push_back(i / 25000);
+      coordinates[1].push_back(i / 100 % 250);
+      coordinates[2].push_back(i % 100);
+    }
+  }
+
+  std::vector<int64_t> Y;
+  for (const auto& row : coordinates) {
+    Y.insert(Y.end(), row.begin(), row.end());
+  }
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<int32_t>("X", X_dims, X);
+  test.AddOutput<int64_t>("Y", {3, static_cast<int64_t>(coordinates[0].size())}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1558,6 +1558,32 @@ TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel) {
   test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
   test.Run();
 }
+TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_ManyImages) {
+  // Every image is constant, so that a row interpolated from another image shows in the output.
+  OpTester test("Resize", 13);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 1.0f, 2.5f, 1.5f};
+
+  test.AddAttribute("mode", "cubic");
+
+  constexpr int64_t N = 2, C = 3, H = 20, W = 16;
+  constexpr int64_t OH = 50, OW = 24;
+  std::vector<float> X;
+  std::vector<float> Y;
+  for (int64_t image = 0; image < N * C; ++image) {
+    X.insert(X.end(), H * W, static_cast<float>(image + 1));
+    Y.insert(Y.end(), OH * OW, static_cast<float>(image + 1));
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  test.AddOutput<float>("Y", {N, C, OH, OW}, Y);
+  test.SetOutputAbsErr("Y", 0.0001f);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_tf_half_pixel_for_nn) {
   // tf_half_pixel_for_nn has been deprecated since opset 13
   OpTester test("Resize", 12);
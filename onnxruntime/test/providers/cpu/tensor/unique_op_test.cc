@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <map>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -394,5 +397,44 @@ TEST(Unique, EmptyInput) {
   test.Run();
 }
 
+// large enough to be counted in several chunks, the first occurrences of some values are in later chunks
+TEST(Unique, Flatten_LargeInput) {
+  constexpr int64_t size = 100000;
+  std::vector<int64_t> X(size);
+  for (int64_t i = 0; i < size; ++i) {
+    X[i] = (i * 7919) % (i < size / 2 ? 1000 : 1500);
+  }
+
+  for (bool sorted : {false, true}) {
+    std::map<int64_t, int64_t> first;
+    std::vector<int64_t> order;
+    for (int64_t i = 0; i < size; ++i) {
+      if (first.emplace(X[i], i).second) {
+        order.push_back(X[i]);
+      }
+    }
+    std::vector<int64_t> Y = order;
+    if (sorted) {
+      std::sort(Y.begin(), Y.end());
+    }
+    std::map<int64_t, int64_t> position;
+    std::vector<int64_t> indices;
+    for (size_t i = 0; i < Y.size(); ++i) {
+      position[Y[i]] = static_cast<int64_t>(i);
+      indices.push_back(first[Y[i]]);
+    }
+    std::vector<int64_t> inverse_indices(size);
+    std::vector<int64_t> counts(Y.size(), 0);
+    for (int64_t i = 0; i < size; ++i) {
+      inverse_indices[i] = position[X[i]];
+      ++counts[position[X[i]]];
+    }
+
+    const int64_t num_unique = static_cast<int64_t>(Y.size());
+    RunUniqueTest<int64_t>({4, size / 4}, X, nullptr, sorted, {num_unique}, Y, {num_unique}, indices,
+                           {size}, inverse_indices, {num_unique}, counts);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "gtest/gtest.h"
 
+#include <numeric>
+
 #include <gsl/gsl>
 
 #include "test/providers/provider_test_utils.h"
@@ -146,5 +148,32 @@ TEST(WhereOpTest, BroadcastWithScalar) {
   test.Run();
 }
 
+TEST(WhereOpTest, BroadcastAcrossInterleavedDims) {
+  // the condition, X and Y are broadcast along different axes, the output is [2, 4, 3, 5]
+  OpTester test{kOpName, kOpVersion};
+
+  test.AddInput<bool>("condition", {2, 1, 3, 1}, {true, false, true, false, false, true});
+  std::vector<float> X(20);
+  std::iota(X.begin(), X.end(), 0.0f);
+  test.AddInput<float>("X", {1, 4, 1, 5}, X);
+  test.AddInput<float>("Y", {2, 4, 1, 1}, {-1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f, -7.0f, -8.0f});
+
+  test.AddOutput<float>("output", {2, 4, 3, 5},
+                        {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f,
+                         0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                         -2.0f, -2.0f, -2.0f, -2.0f, -2.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                         10.0f, 11.0f, 12.0f, 13.0f, 14.0f, -3.0f, -3.0f, -3.0f, -3.0f, -3.0f,
+                         10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f, 17.0f, 18.0f, 19.0f,
+                         -4.0f, -4.0f, -4.0f, -4.0f, -4.0f, 15.0f, 16.0f, 17.0f, 18.0f, 19.0f,
+                         -5.0f, -5.0f, -5.0f, -5.0f, -5.0f, -5.0f, -5.0f, -5.0f, -5.0f, -5.0f,
+                         0.0f, 1.0f, 2.0f, 3.0f, 4.0f, -6.0f, -6.0f, -6.0f, -6.0f, -6.0f,
+                         -6.0f, -6.0f, -6.0f, -6.0f, -6.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                         -7.0f, -7.0f, -7.0f, -7.0f, -7.0f, -7.0f, -7.0f, -7.0f, -7.0f, -7.0f,
+                         10.0f, 11.0f, 12.0f, 13.0f, 14.0f, -8.0f, -8.0f, -8.0f, -8.0f, -8.0f,
+                         -8.0f, -8.0f, -8.0f, -8.0f, -8.0f, 15.0f, 16.0f, 17.0f, 18.0f, 19.0f});
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -115,5 +115,37 @@ TEST(RegexFullMatch, NonUtf8Pattern) {
                        });
   test.Run(BaseTester::ExpectResult::kExpectFailure, "Invalid regex pattern");
 }
+TEST(RegexFullMatch, LargeBatch) {
+  // Enough elements to be split across threads, most of them fall outside the range of the possible matches.
+  constexpr int64_t count = 1000;
+  std::vector<std::string> input;
+  std::unique_ptr<bool[]> output = std::make_unique<bool[]>(count);
+  for (int64_t i = 0; i < count; ++i) {
+    switch (i % 4) {
+      case 0:
+        input.push_back("item_" + std::to_string(i));
+        output[i] = true;
+        break;
+      case 1:
+        input.push_back("item_" + std::to_string(i) + "x");
+        output[i] = false;
+        break;
+      case 2:
+        input.push_back("a" + std::to_string(i));
+        output[i] = false;
+        break;
+      default:
+        input.push_back("zz" + std::to_string(i));
+        output[i] = false;
+        break;
+    }
+  }
+  OpTester test("RegexFullMatch", 20, kOnnxDomain);
+  test.AddAttribute("pattern", std::string(R"(item_[0-9]+)"));
+  test.AddInput<std::string>("Input", {count}, input);
+  test.AddOutput<bool>("Output", {count}, output.get(), count);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,10 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <vector>
+
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/framework/allocator.h"
+#include "core/framework/stream_handles.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_common.h"
 
@@ -113,5 +116,83 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+TEST(AllocatorTest, CUDAMempoolAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+
+  AllocatorCreationInfo mempool_memory_info(
+      [](OrtDevice::DeviceId id) { return std::make_unique<CUDAMempoolAllocator>(id, CUDA, 1 << 20); },
+      cuda_device_id, false);
+  auto cuda_allocator = CreateAllocator(mempool_memory_info);
+
+  EXPECT_STREQ(cuda_allocator->Info().name, CUDA);
+  EXPECT_EQ(cuda_allocator->Info().alloc_type, OrtDeviceAllocator);
+  EXPECT_TRUE(cuda_allocator->IsStreamAware());
+
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+  const OrtDevice& device = cuda_allocator->Info().device;
+  auto stream = std::make_unique<Stream>(cuda_stream, device);
+
+  size_t size = 1024;
+  std::vector<int> cpu_data(size / sizeof(int), -1);
+  std::vector<int> cpu_result(size / sizeof(int), 0);
+
+  // memory allocated on a stream is ordered on it, both for its use and for its release
+  void* stream_addr = AllocateBufferWithOptions(*cuda_allocator, size, false, stream.get(), nullptr);
+  EXPECT_TRUE(stream_addr);
+  CUDA_CALL_THROW(cudaMemcpyAsync(stream_addr, cpu_data.data(), size, cudaMemcpyHostToDevice, cuda_stream));
+  CUDA_CALL_THROW(cudaMemcpyAsync(cpu_result.data(), stream_addr, size, cudaMemcpyDeviceToHost, cuda_stream));
+  cuda_allocator->Free(stream_addr);
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  EXPECT_EQ(cpu_result, cpu_data);
+
+  // memory still in use when its stream is released can be freed after the stream is gone
+  void* outliving_addr = AllocateBufferWithOptions(*cuda_allocator, size, false, stream.get(), nullptr);
+  EXPECT_TRUE(outliving_addr);
+  cuda_allocator->ReleaseStreamBuffers(stream.get());
+  stream.reset();
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+
+  void* addr = cuda_allocator->Alloc(size);
+  EXPECT_TRUE(addr);
+  CUDA_CALL_THROW(cudaMemcpy(addr, outliving_addr, size, cudaMemcpyDeviceToDevice));
+  cuda_allocator->Free(outliving_addr);
+  cuda_allocator->Free(addr);
+  CUDA_CALL_THROW(cudaDeviceSynchronize());
+}
+
+TEST(AllocatorTest, CUDADeviceBudgetAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+
+  const size_t size = 1 << 20;
+  auto allocator = std::make_unique<CUDADeviceBudgetAllocator>(cuda_device_id, CUDA, 2 * size, 0);
+  // the smaller budget of another session on the device applies to both
+  auto other_allocator = std::make_unique<CUDADeviceBudgetAllocator>(cuda_device_id, CUDA, 3 * size / 2, 10);
+
+  void* addr = allocator->Alloc(size);
+  EXPECT_TRUE(addr);
+  EXPECT_THROW(other_allocator->Alloc(size), OnnxRuntimeException);
+
+  AllocatorStats stats;
+  other_allocator->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, static_cast<int64_t>(size));
+  EXPECT_EQ(stats.bytes_limit, static_cast<int64_t>(3 * size / 2));
+
+  // memory freed by one session is available to the other
+  allocator->Free(addr);
+  void* other_addr = other_allocator->Alloc(size);
+  EXPECT_TRUE(other_addr);
+  other_allocator->Free(other_addr);
+
+  // the budget goes with the last allocator that asked for it
+  other_allocator.reset();
+  void* addrs[2] = {allocator->Alloc(size), allocator->Alloc(size)};
+  EXPECT_TRUE(addrs[0] && addrs[1]);
+  allocator->Free(addrs[0]);
+  allocator->Free(addrs[1]);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include <iostream>
+#include <vector>
 
 #include "core/framework/run_options.h"
 #include "core/providers/cuda/cuda_allocator.h"
@@ -90,6 +91,34 @@ TEST(TestDeferredRelease, WithoutArena) {
   ORT_THROW_IF_ERROR(ep.OnRunEnd(true, run_opts));
 }
 
+TEST(TestPinnedStaging, RoundTrip) {
+  // Stage through two buffers that do not divide the copied size, so the last chunk is partial.
+  CUDAExecutionProviderInfo info;
+  info.pinned_staging_buffer_size = 1000;
+  CUDAExecutionProvider ep(info);
+  AllocatorPtr gpu_alloctor = ep.CreatePreferredAllocators()[0];
+  AllocatorPtr cpu_pinned_alloc = ep.CreatePreferredAllocators()[1];
+  CudaStream stream(nullptr, gpu_alloctor->Info().device, cpu_pinned_alloc, false, true, nullptr, nullptr, info);
+  ASSERT_TRUE(stream.UsePinnedStaging());
+
+  std::vector<int> input(2500);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<int>(i);
+  }
+  std::vector<int> output(input.size(), -1);
+  const size_t n_bytes = input.size() * sizeof(int);
+  auto gpu_buffer = IAllocator::MakeUniquePtr<void>(gpu_alloctor, n_bytes);
+
+  ORT_THROW_IF_ERROR(stream.CopyHostToDeviceStaged(gpu_buffer.get(), input.data(), n_bytes));
+  // the input is staged, so the caller can reuse it before the transfer completes
+  std::fill(input.begin(), input.end(), 0);
+  ORT_THROW_IF_ERROR(stream.CopyDeviceToHostStaged(output.data(), gpu_buffer.get(), n_bytes));
+
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(output[i], static_cast<int>(i));
+  }
+}
+
 }  // namespace test
 }  // namespace cuda
 }  // namespace onnxruntime
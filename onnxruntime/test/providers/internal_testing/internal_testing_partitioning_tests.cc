@@ -6,7 +6,9 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/utils.h"
+#include "core/graph/model.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "test/framework/test_utils.h"
 #include "test/test_environment.h"
@@ -129,6 +131,114 @@ TEST(InternalTestingEP, TestDependenciesCorrectlyHandled) {
   ASSERT_EQ(num_other_nodes, 2);
 }
 
+// Creates a model with a chain of unary nodes of the given op types, and returns the serialized model.
+static std::string CreateUnaryChainModel(const std::vector<std::string>& op_types,
+                                         ONNX_NAMESPACE::TensorProto_DataType elem_type) {
+  onnxruntime::Model model("unary_chain", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  NodeArg* input = &graph.GetOrCreateNodeArg("X", &type);
+  for (size_t i = 0; i < op_types.size(); ++i) {
+    const std::string name = i + 1 == op_types.size() ? "Y" : "node_" + std::to_string(i);
+    NodeArg* output = &graph.GetOrCreateNodeArg(name, &type);
+    graph.AddNode(name, op_types[i], "", {input}, {output});
+    input = output;
+  }
+
+  ORT_ENFORCE(graph.Resolve().IsOK());
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+// Gets the number of partitions assigned to the internal testing EP, and the op types of the other nodes.
+static void GetInternalTestingEPNodes(InferenceSessionWrapper& session, std::vector<std::string>& other_op_types,
+                                      int& num_partitions) {
+  other_op_types.clear();
+  num_partitions = 0;
+  for (const auto& node : session.GetGraph().Nodes()) {
+    if (node.GetExecutionProviderType() == utils::kInternalTestingExecutionProvider) {
+      ++num_partitions;
+    } else {
+      other_op_types.push_back(node.OpType());
+    }
+  }
+}
+
+// partitions smaller than session.min_ep_partition_size should be left to the CPU EP
+TEST(InternalTestingEP, TestMinPartitionSizeFallsBackToCPU) {
+  // Abs -> Neg form a partition of 2 nodes, and the last Abs a partition of 1 node
+  const auto model_data = CreateUnaryChainModel({"Abs", "Neg", "Relu", "Abs"},
+                                                ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  const std::unordered_set<std::string> supported_ops{"Abs", "Neg"};
+
+  auto create_session = [&](const char* min_partition_size, std::unique_ptr<InferenceSessionWrapper>& session) {
+    SessionOptions so;
+    if (min_partition_size != nullptr) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMinEpPartitionSize, min_partition_size));
+    }
+
+    session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+    ASSERT_STATUS_OK(session->RegisterExecutionProvider(
+        std::make_unique<InternalTestingExecutionProvider>(supported_ops)));
+    ASSERT_STATUS_OK(session->Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session->Initialize());
+  };
+
+  std::vector<std::string> other_op_types;
+  int num_partitions{0};
+
+  // by default every partition is taken
+  std::unique_ptr<InferenceSessionWrapper> session;
+  create_session(nullptr, session);
+  GetInternalTestingEPNodes(*session, other_op_types, num_partitions);
+  EXPECT_EQ(num_partitions, 2);
+  EXPECT_THAT(other_op_types, ::testing::ElementsAre("Relu"));
+
+  // the single node partition falls back to CPU
+  create_session("2", session);
+  GetInternalTestingEPNodes(*session, other_op_types, num_partitions);
+  EXPECT_EQ(num_partitions, 1);
+  EXPECT_THAT(other_op_types, ::testing::UnorderedElementsAre("Relu", "Abs"));
+  for (const auto& node : session->GetGraph().Nodes()) {
+    if (node.OpType() == "Abs") {
+      EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+    }
+  }
+
+  // both partitions fall back to CPU
+  create_session("3", session);
+  GetInternalTestingEPNodes(*session, other_op_types, num_partitions);
+  EXPECT_EQ(num_partitions, 0);
+  EXPECT_THAT(other_op_types, ::testing::UnorderedElementsAre("Abs", "Neg", "Relu", "Abs"));
+}
+
+// a partition below session.min_ep_partition_size is kept if the CPU EP has no kernel for one of its nodes
+TEST(InternalTestingEP, TestMinPartitionSizeKeepsNodesWithoutCPUKernel) {
+  // the CPU EP has no float16 Abs kernel
+  const auto model_data = CreateUnaryChainModel({"Abs"}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+  const std::unordered_set<std::string> supported_ops{"Abs"};
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMinEpPartitionSize, "2"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.RegisterExecutionProvider(
+      std::make_unique<InternalTestingExecutionProvider>(supported_ops)));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::vector<std::string> other_op_types;
+  int num_partitions{0};
+  GetInternalTestingEPNodes(session, other_op_types, num_partitions);
+  EXPECT_EQ(num_partitions, 1);
+  EXPECT_TRUE(other_op_types.empty());
+}
+
 // Infrastructure that was used to check NNAPI coverage.
 // Ideally this could be updated to read the model paths, supported ops and stop ops from input files
 // and provide info on the partitions so no code changes are required to investigate different scenarios.
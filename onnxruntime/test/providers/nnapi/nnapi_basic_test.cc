@@ -72,6 +72,37 @@ TEST(NnapiExecutionProviderTest, ReshapeFlattenTest) {
 #endif
 }
 
+// Same as ReshapeFlattenTest, with the NNAPI model computed using an ANeuralNetworksBurst
+TEST(NnapiExecutionProviderTest, BurstExecutionTest) {
+  const ORTCHAR_T* model_file_name = ORT_TSTR("testdata/nnapi_reshape_flatten_test.onnx");
+
+#if defined(__ANDROID__)
+  std::vector<int64_t> dims_mul_x = {2, 1, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f};
+  std::vector<int64_t> dims_mul_y = {3, 2, 2};
+  std::vector<float> values_mul_y = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+  OrtValue ml_value_x;
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  CreateMLValue<float>(cpu_allocator, dims_mul_x, values_mul_x,
+                       &ml_value_x);
+  OrtValue ml_value_y;
+  CreateMLValue<float>(cpu_allocator, dims_mul_y, values_mul_y,
+                       &ml_value_y);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+  feeds.insert(std::make_pair("Y", ml_value_y));
+
+  RunAndVerifyOutputsWithEP(model_file_name,
+                            CurrentTestName(),
+                            std::make_unique<NnapiExecutionProvider>(NNAPI_FLAG_USE_BURST),
+                            feeds);
+#else
+  // test load only
+  TestModelLoad(model_file_name, std::make_unique<NnapiExecutionProvider>(NNAPI_FLAG_USE_BURST),
+                ExpectedEPNodeAssignment::Some);
+#endif
+}
+
 TEST(NnapiExecutionProviderTest, SigmoidSupportedInputRankTest) {
   const ORTCHAR_T* model_file_name = ORT_TSTR("testdata/nnapi_sigmoid_input_rank_test.onnx");
 
@@ -371,6 +371,38 @@ TEST(TensorrtExecutionProviderTest, TRTModelIdGeneratorUsingModelHashing) {
   ASSERT_EQ(model_hash, model_hash3) << "model 1&3 are same models and they have same hash, no matter where they are loaded";
 }
 
+TEST(TensorrtExecutionProviderTest, WeightsHashForEngineRefit) {
+  // Load the same model twice and change an initializer of the second one
+  auto model_path = ORT_TSTR("testdata/mnist.onnx");
+  std::ifstream model_file_stream(model_path, std::ios::in | std::ios::binary);
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(model_file_stream, &model_proto));
+  std::string serialized_model;
+  ASSERT_TRUE(model_proto.SerializeToString(&serialized_model));
+
+  auto* initializer = model_proto.mutable_graph()->mutable_initializer(0);
+  if (initializer->has_raw_data()) {
+    initializer->mutable_raw_data()->at(0) ^= 1;
+  } else {
+    initializer->set_float_data(0, initializer->float_data(0) + 1.0f);
+  }
+  std::string serialized_refitted_model;
+  ASSERT_TRUE(model_proto.SerializeToString(&serialized_refitted_model));
+
+  const std::string weights_hash = GetWeightsHash(serialized_model);
+  ASSERT_EQ(weights_hash, GetWeightsHash(serialized_model));
+  ASSERT_NE(weights_hash, GetWeightsHash(serialized_refitted_model));
+
+  // The saved hash only matches the weights the engine was built with
+  const std::string weights_cache_path = "trt_execution_provider_refit_test.weights";
+  std::filesystem::remove(weights_cache_path);
+  ASSERT_FALSE(CompareWeightsHash(weights_cache_path, weights_hash));
+  SerializeWeightsHash(weights_cache_path, weights_hash);
+  ASSERT_TRUE(CompareWeightsHash(weights_cache_path, weights_hash));
+  ASSERT_FALSE(CompareWeightsHash(weights_cache_path, GetWeightsHash(serialized_refitted_model)));
+  std::filesystem::remove(weights_cache_path);
+}
+
 TEST(TensorrtExecutionProviderTest, EPContextNode) {
   std::string model_name_str = "EPContextNode_test.onnx";
   PathString model_name = ToPathString(model_name_str);
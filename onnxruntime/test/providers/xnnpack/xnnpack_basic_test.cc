@@ -379,6 +379,32 @@ TEST(XnnpackEP, TestSoftMax_axisLast) {
                {ExpectedEPNodeAssignment::All});
 }
 
+// B is an activation, as in the Q*K^T and attention*V MatMuls of a transformer
+TEST(XnnpackEP, TestMatMul_DynamicB) {
+  auto modelCreater = [](ModelTestBuilder& builder) {
+    auto* a_arg = builder.MakeInput<float>({2, 3, 4}, -1.f, 1.f);
+    auto* b_arg = builder.MakeInput<float>({2, 4, 5}, -1.f, 1.f);
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("MatMul", {a_arg, b_arg}, {output_arg});
+  };
+  RunModelTest(modelCreater,
+               "xnnpack_test_graph_matmul_dynamic_b",
+               {ExpectedEPNodeAssignment::All});
+}
+
+// xnn_batch_matrix_multiply doesn't broadcast the batch dims, so the node is left to the CPU EP
+TEST(XnnpackEP, TestMatMul_DynamicB_Broadcast) {
+  auto modelCreater = [](ModelTestBuilder& builder) {
+    auto* a_arg = builder.MakeInput<float>({2, 3, 4}, -1.f, 1.f);
+    auto* b_arg = builder.MakeInput<float>({1, 4, 5}, -1.f, 1.f);
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("MatMul", {a_arg, b_arg}, {output_arg});
+  };
+  RunModelTest(modelCreater,
+               "xnnpack_test_graph_matmul_dynamic_b_broadcast",
+               {ExpectedEPNodeAssignment::None});
+}
+
 TEST(XnnpackEP, TestQDQSoftMax_axisLast) {
   RunModelTest(BuildQDQSoftMaxTestCase<uint8_t, uint8_t>(
                    {1, 2, 3, 5} /* input_shape */,
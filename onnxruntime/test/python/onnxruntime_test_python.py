@@ -0,0 +1,110 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+# -*- coding: UTF-8 -*-
+import unittest
+
+import numpy as np
+from onnx import TensorProto, helper
+
+import onnxruntime as onnxrt
+from onnxruntime.capi import _pybind_state as C
+
+
+def create_mul_model():
+    # Y = X * 2
+    graph = helper.make_graph(
+        [helper.make_node("Mul", ["X", "two"], ["Y"])],
+        "mul",
+        [helper.make_tensor_value_info("X", TensorProto.FLOAT, [3, 2])],
+        [helper.make_tensor_value_info("Y", TensorProto.FLOAT, [3, 2])],
+        [helper.make_tensor("two", TensorProto.FLOAT, [], [2.0])],
+    )
+    return helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)]).SerializeToString()
+
+
+class TestInferenceSession(unittest.TestCase):
+    def test_ortvalue_buffer_protocol_shares_memory(self):
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ortvalue = onnxrt.OrtValue.ortvalue_from_numpy(x)
+        c_ortvalue = ortvalue._get_c_value()
+
+        # numpy.asarray views the memory of the OrtValue without a copy
+        view = np.asarray(c_ortvalue)
+        self.assertEqual(view.dtype, np.float32)
+        self.assertEqual(view.shape, (3, 2))
+        np.testing.assert_equal(view, x)
+        self.assertEqual(view.__array_interface__["data"][0], ortvalue.data_ptr())
+
+        # so does a memoryview
+        memory = memoryview(c_ortvalue)
+        self.assertEqual(memory.format, "f")
+        self.assertEqual(memory.shape, (3, 2))
+        self.assertEqual(memory.strides, (8, 4))
+
+        # a write through one view is visible through the others
+        view[1, 1] = 42.0
+        self.assertEqual(memory[1, 1], 42.0)
+        self.assertEqual(ortvalue.numpy()[1, 1], 42.0)
+
+        # the python OrtValue implements __array__ on top of it
+        array = np.asarray(onnxrt.OrtValue.ortvalue_from_shape_and_type([3, 2], np.float32))
+        self.assertEqual(array.shape, (3, 2))
+        self.assertFalse(np.shares_memory(np.array(ortvalue, copy=True), view))
+
+    def test_ortvalue_buffer_protocol_of_a_session_output(self):
+        sess = onnxrt.InferenceSession(create_mul_model(), providers=["CPUExecutionProvider"])
+        x = np.arange(6, dtype=np.float32).reshape((3, 2))
+        outputs = sess.run_with_ort_values(["Y"], {"X": onnxrt.OrtValue.ortvalue_from_numpy(x)})
+        y = np.asarray(outputs[0]._get_c_value())
+        self.assertEqual(y.__array_interface__["data"][0], outputs[0].data_ptr())
+        np.testing.assert_equal(y, x * 2)
+
+    def test_run_with_ortvaluevector(self):
+        sess = onnxrt.InferenceSession(create_mul_model(), providers=["CPUExecutionProvider"])
+        x = np.arange(6, dtype=np.float32).reshape((3, 2))
+
+        feeds = C.OrtValueVector()
+        feeds.push_back(onnxrt.OrtValue.ortvalue_from_numpy(x)._get_c_value())
+        for _ in range(2):
+            fetches = sess.run_with_ortvaluevector(["Y"], ["X"], feeds)
+            self.assertEqual(len(fetches), 1)
+            np.testing.assert_equal(fetches[0].numpy(), x * 2)
+
+        # the output names default to all the outputs
+        fetches = sess.run_with_ortvaluevector(None, ["X"], feeds)
+        np.testing.assert_equal(fetches[0].numpy(), x * 2)
+
+        with self.assertRaises(ValueError):
+            sess.run_with_ortvaluevector(["Y"], [], feeds)
+
+    @unittest.skipIf(not hasattr(C.OrtValue, "from_dlpack"), "DLPack is not enabled in this build")
+    def test_ortvalue_dlpack_round_trip(self):
+        x = np.arange(6, dtype=np.float32).reshape((3, 2))
+        ortvalue = onnxrt.OrtValue.ortvalue_from_numpy(x)
+        self.assertEqual(ortvalue.__dlpack_device__()[1], 0)
+
+        # through a capsule, and through the __dlpack__ protocol
+        from_capsule = onnxrt.OrtValue.from_dlpack(ortvalue.to_dlpack())
+        from_protocol = onnxrt.OrtValue.from_dlpack(ortvalue)
+        for value in [from_capsule, from_protocol]:
+            self.assertEqual(value.data_ptr(), ortvalue.data_ptr())
+            self.assertEqual(value.shape(), [3, 2])
+            self.assertEqual(value.data_type(), "tensor(float)")
+            np.testing.assert_equal(value.numpy(), x)
+
+        # numpy consumes the protocol without a copy too
+        if hasattr(np, "from_dlpack"):
+            array = np.from_dlpack(ortvalue)
+            self.assertEqual(array.__array_interface__["data"][0], ortvalue.data_ptr())
+            np.testing.assert_equal(array, x)
+
+        # DLPack has no boolean type
+        b = np.array([True, False, True])
+        from_bool = onnxrt.OrtValue.from_dlpack(onnxrt.OrtValue.ortvalue_from_numpy(b).to_dlpack(), True)
+        self.assertEqual(from_bool.data_type(), "tensor(bool)")
+        np.testing.assert_equal(from_bool.numpy(), b)
+
+
+if __name__ == "__main__":
+    unittest.main(verbosity=1)
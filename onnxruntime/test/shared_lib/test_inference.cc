@@ -2072,6 +2072,74 @@ TEST(CApiTest, io_binding) {
   binding.ClearBoundOutputs();
 }
 
+TEST(CApiTest, PreparedRun) {
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::Session other_session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(), x_shape.data(), x_shape.size());
+  const std::array<float, 3 * 2> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, 1, output_names, 1);
+
+  // the prepared run is reused
+  for (int i = 0; i < 2; ++i) {
+    Ort::Value y{nullptr};
+    session.Run(Ort::RunOptions(), prepared_run, &x, 1, &y, 1);
+    const float* values = y.GetTensorData<float>();
+    ASSERT_TRUE(std::equal(values, values + expected_y.size(), std::begin(expected_y)));
+  }
+
+  // a prepared run can't be used with a different session
+  Ort::Value y{nullptr};
+  try {
+    other_session.Run(Ort::RunOptions(), prepared_run, &x, 1, &y, 1);
+    FAIL() << "Running a prepared run with a different session should fail";
+  } catch (const Ort::Exception& e) {
+    ASSERT_EQ(e.GetOrtErrorCode(), ORT_INVALID_ARGUMENT);
+  }
+}
+
+TEST(CApiTest, PreparedRunCApi) {
+  const OrtApi& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::Session other_session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(), x_shape.data(), x_shape.size());
+  const std::array<float, 3 * 2> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  OrtPreparedRun* prepared_run = nullptr;
+  Ort::ThrowOnError(api.CreatePreparedRun(session, input_names, 1, output_names, 1, &prepared_run));
+
+  const OrtValue* inputs[] = {x};
+  OrtValue* outputs[] = {nullptr};
+  Ort::ThrowOnError(api.RunPrepared(session, nullptr, prepared_run, inputs, 1, outputs, 1));
+  Ort::Value y{outputs[0]};
+  const float* values = y.GetTensorData<float>();
+  ASSERT_TRUE(std::equal(values, values + expected_y.size(), std::begin(expected_y)));
+
+  // a prepared run can't be used with a different session
+  OrtValue* other_outputs[] = {nullptr};
+  OrtStatus* status = api.RunPrepared(other_session, nullptr, prepared_run, inputs, 1, other_outputs, 1);
+  ASSERT_NE(status, nullptr);
+  EXPECT_EQ(api.GetErrorCode(status), ORT_INVALID_ARGUMENT);
+  EXPECT_EQ(other_outputs[0], nullptr);
+  api.ReleaseStatus(status);
+
+  api.ReleasePreparedRun(prepared_run);
+}
+
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
 TEST(CApiTest, io_binding_cuda) {
   Ort::SessionOptions session_options;
@@ -2545,6 +2613,56 @@ TEST(CApiTest, basic_cuda_graph_with_annotation) {
 }
 #endif
 
+#if defined(USE_CUDA)
+template <typename TInput, typename TOutput>
+static void RunWithGraphCaptureShapes(Ort::Session& session, const std::array<int64_t, 2>& x_shape, TInput& x_values,
+                                      const TOutput& expected_y) {
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), static_cast<size_t>(x_shape[0] * x_shape[1]),
+                                          x_shape.data(), x_shape.size());
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, 1);
+  ASSERT_EQ(outputs.size(), 1u);
+  const float* y = outputs[0].GetTensorData<float>();
+  ASSERT_THAT(std::vector<float>(y, y + expected_y.size()),
+              ::testing::ElementsAreArray(expected_y.data(), expected_y.size()));
+}
+
+TEST(CApiTest, cuda_graph_capture_per_input_shapes) {
+  const auto& api = Ort::GetApi();
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph"};
+  std::vector<const char*> values{"1"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), 1) == nullptr);
+
+  Ort::SessionOptions session_options;
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+  // two graphs are kept, so the third shape releases the graph of the first one.
+  session_options.AddConfigEntry(kOrtSessionOptionsGraphCaptureMaxShapes, "2");
+  Ort::Session session(*ort_env, CUDA_GRAPH_ANNOTATION_MODEL_URI, session_options);
+
+  CudaGraphInputOutputData_0 data_0;
+  CudaGraphInputOutputData_1 data_1;
+  CudaGraphInputOutputData_2 data_2;
+
+  // the first run of a shape captures its graph, the next ones replay it with new inputs.
+  RunWithGraphCaptureShapes(session, data_0.x_shape, data_0.x_values, data_0.expected_y);
+  RunWithGraphCaptureShapes(session, data_0.x_shape, data_0.new_x_values, data_0.new_expected_y);
+  RunWithGraphCaptureShapes(session, data_1.x_shape, data_1.x_values, data_1.expected_y);
+  RunWithGraphCaptureShapes(session, data_0.x_shape, data_0.x_values, data_0.expected_y);
+  RunWithGraphCaptureShapes(session, data_1.x_shape, data_1.new_x_values, data_1.new_expected_y);
+  RunWithGraphCaptureShapes(session, data_2.x_shape, data_2.x_values, data_2.expected_y);
+  RunWithGraphCaptureShapes(session, data_2.x_shape, data_2.new_x_values, data_2.new_expected_y);
+  RunWithGraphCaptureShapes(session, data_0.x_shape, data_0.new_x_values, data_0.new_expected_y);
+}
+#endif
+
 // The following test uses some ops not supported in the reduced ops build
 #ifndef REDUCED_OPS_BUILD
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
@@ -2675,6 +2793,37 @@ TEST(CApiTest, fill_string_tensor_directly) {
   }
 }
 
+TEST(CApiTest, fill_string_tensor_from_buffer) {
+  // the second string is empty and the third one holds a null character
+  const std::string data("abc\0x-kmp", 9);
+  const size_t offsets[] = {0, 3, 3, 5};
+  constexpr int64_t expected_len = 4;
+  MockedOrtAllocator default_allocator;
+
+  Ort::Value tensor = Ort::Value::CreateTensor(&default_allocator, &expected_len, 1U,
+                                               ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  tensor.FillStringTensorFromBuffer(data.data(), data.size(), offsets, 4);
+
+  ASSERT_EQ(tensor.GetStringTensorElement(0), "abc");
+  ASSERT_EQ(tensor.GetStringTensorElement(1), "");
+  ASSERT_EQ(tensor.GetStringTensorElement(2), std::string("\0x", 2));
+  ASSERT_EQ(tensor.GetStringTensorElement(3), "-kmp");
+
+  // the content reads back in the same layout
+  ASSERT_EQ(tensor.GetStringTensorDataLength(), data.size());
+  std::string result(data.size(), '\0');
+  std::vector<size_t> result_offsets(4);
+  tensor.GetStringTensorContent(result.data(), result.size(), result_offsets.data(), result_offsets.size());
+  ASSERT_EQ(result, data);
+  ASSERT_EQ(result_offsets, std::vector<size_t>(std::begin(offsets), std::end(offsets)));
+
+  const size_t bad_offsets[] = {0, 4, 3, 5};
+  ASSERT_THROW(tensor.FillStringTensorFromBuffer(data.data(), data.size(), bad_offsets, 4), Ort::Exception);
+  const size_t out_of_bounds_offsets[] = {0, 3, 3, 10};
+  ASSERT_THROW(tensor.FillStringTensorFromBuffer(data.data(), data.size(), out_of_bounds_offsets, 4), Ort::Exception);
+  ASSERT_THROW(tensor.FillStringTensorFromBuffer(data.data(), data.size(), offsets, 3), Ort::Exception);
+}
+
 TEST(CApiTest, get_string_tensor_element) {
   const char* s[] = {"abc", "kmp"};
   constexpr int64_t expected_len = 2;
@@ -2716,6 +2865,46 @@ TEST(CApiTest, create_tensor_with_data) {
   ASSERT_EQ(1u, tensor_info.GetDimensionsCount());
 }
 
+TEST(CApiTest, create_tensor_with_data_and_strides) {
+  float values[] = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  // contiguous strides create a regular tensor over the buffer
+  std::vector<int64_t> dims = {2, 3};
+  std::vector<int64_t> strides = {3, 1};
+  Ort::Value tensor = Ort::Value::CreateTensor(info, values, sizeof(values), dims.data(), dims.size(),
+                                               strides.data(), strides.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  ASSERT_EQ(tensor.GetTensorData<float>(), values);
+  ASSERT_EQ(tensor.GetTensorTypeAndShapeInfo().GetShape(), dims);
+
+  // the number of strides must match the rank
+  ASSERT_THROW(Ort::Value::CreateTensor(info, values, sizeof(values), dims.data(), dims.size(),
+                                        strides.data(), 1, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+               Ort::Exception);
+
+  // a transposed view of the buffer
+  std::vector<int64_t> transposed_dims = {3, 2};
+  std::vector<int64_t> transposed_strides = {1, 3};
+#ifdef ENABLE_STRIDED_TENSORS
+  Ort::Value view = Ort::Value::CreateTensor(info, values, sizeof(values), transposed_dims.data(),
+                                             transposed_dims.size(), transposed_strides.data(),
+                                             transposed_strides.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  ASSERT_EQ(view.GetTensorData<float>(), values);
+
+  // the view must not read past the end of the buffer
+  ASSERT_THROW(Ort::Value::CreateTensor(info, values, sizeof(float) * 5, transposed_dims.data(),
+                                        transposed_dims.size(), transposed_strides.data(),
+                                        transposed_strides.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+               Ort::Exception);
+#else
+  ASSERT_THROW(Ort::Value::CreateTensor(info, values, sizeof(values), transposed_dims.data(),
+                                        transposed_dims.size(), transposed_strides.data(),
+                                        transposed_strides.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+               Ort::Exception);
+#endif
+}
+
 TEST(CApiTest, create_tensor_with_data_float16) {
   // Example with C++. However, what we are feeding underneath is really
   // a continuous buffer of uint16_t
@@ -4402,6 +4591,55 @@ TEST(CApiTest, RunAsyncFail) {
   EXPECT_THROW(session.RunAsync(run_options, input_names, input_tensors, 1, output_names, output_values, 1, CallbackFail, nullptr), std::exception);
 }
 
+void CallbackCount(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status_ptr) {
+  Ort::Status status(status_ptr);
+  EXPECT_TRUE(status.IsOK());
+  EXPECT_EQ(num_outputs, 1UL);
+  Ort::Value output_value(outputs[0]);
+  EXPECT_EQ(output_value.At<float>({1, 0}), 9.f);
+  output_value.release();
+  reinterpret_cast<std::atomic_int*>(user_data)->fetch_add(1);
+}
+
+TEST(CApiTest, RunAsyncDedicatedThreads) {
+  Ort::SessionOptions session_options;
+  // RunAsync doesn't need intra op threads when it has dedicated threads
+  session_options.SetIntraOpNumThreads(1);
+  session_options.AddConfigEntry(kOrtSessionOptionsAsyncRunNumThreads, "2");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  constexpr int num_requests = 64;
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+  std::vector<Ort::Value> output_values;
+  for (int i = 0; i < num_requests; ++i) {
+    output_values.emplace_back(nullptr);
+  }
+
+  std::atomic_int num_completed{0};
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (int i = 0; i < num_requests; ++i) {
+    // the input names and input values are released before the runs complete
+    std::string input_name = "X";
+    const char* input_names[] = {input_name.c_str()};
+    const float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    int64_t x_dim[] = {3, 2};
+    Ort::Value input_tensors[1] = {Ort::Value::CreateTensor<float>(allocator, x_dim, 2)};
+    std::copy(std::begin(x_value), std::end(x_value), input_tensors[0].GetTensorMutableData<float>());
+
+    session.RunAsync(run_options, input_names, input_tensors, 1, output_names, &output_values[i], 1,
+                     CallbackCount, &num_completed);
+  }
+
+  std::chrono::duration<double, std::milli> dur{100};
+  // timeout in about 10 secs
+  for (int i = 0; i < 100 && num_completed.load() < num_requests; ++i) {
+    std::this_thread::sleep_for(dur);
+  }
+
+  EXPECT_EQ(num_completed.load(), num_requests);
+}
+
 struct MockGQA : public OrtCustomOp {
   MockGQA() {
     OrtCustomOp::GetMayInplace = [](int** input_index, int** output_index) {
@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
+#include "core/framework/data_types.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "orttraining/core/framework/ortmodule_graph_builder.h"
@@ -19,6 +23,10 @@ Status OrtModuleGraphBuilder::Initialize(std::istream& model_istream,
   ORT_RETURN_IF_ERROR(Model::Load(model_istream, &model_proto));
   ORT_RETURN_IF_ERROR(Model::Load(model_proto, original_model_, nullptr, *logger_));
   config_ = config;
+  ORT_RETURN_IF_NOT(config_.gradient_allreduce_bucket_size_mb >= 0,
+                    "gradient_allreduce_bucket_size_mb must not be negative: ", config_.gradient_allreduce_bucket_size_mb);
+  ORT_RETURN_IF_NOT(config_.gradient_allreduce_world_size > 0,
+                    "gradient_allreduce_world_size must be positive: ", config_.gradient_allreduce_world_size);
 
   // Handle original model inputs, outputs and trainable initializers.
   // We need to move all the initializers to graph inputs and keep the order in config,
@@ -98,6 +106,11 @@ Status OrtModuleGraphBuilder::Build(const TrainingGraphTransformerConfiguration&
   // Reorder outputs.
   ReorderOutputs();
 
+  // All-reduce the trainable initializer grads across the data parallel workers.
+  if (config_.gradient_allreduce_bucket_size_mb > 0) {
+    AddGradientAllReduce();
+  }
+
   // Find module outputs needed for backward computation
   FindModuleOutputNeededForBackward();
 
@@ -419,6 +432,133 @@ void OrtModuleGraphBuilder::ReorderOutputs() {
   gradient_graph.SetOutputs(new_output_args);
 }
 
+void OrtModuleGraphBuilder::AddGradientAllReduce() {
+  Graph& gradient_graph = gradient_model_->MainGraph();
+  ORT_THROW_IF_ERROR(gradient_graph.Resolve());
+  GraphViewer gradient_graph_viewer(gradient_graph);
+  const auto& gradient_node_topology_list = gradient_graph_viewer.GetNodesInTopologicalOrder();
+  std::unordered_map<NodeIndex, size_t> node_index_to_order;
+  for (size_t i = 0; i < gradient_node_topology_list.size(); ++i) {
+    node_index_to_order[gradient_node_topology_list[i]] = i;
+  }
+
+  // Sort the grads in the order they are computed, which is roughly the reverse order of the forward pass.
+  std::vector<std::pair<size_t, std::string>> ordered_grad_names;
+  for (const auto& grad_name : graph_info_.initializer_grad_names_to_train) {
+    const Node* producer_node = gradient_graph.GetProducerNode(grad_name);
+    if (producer_node != nullptr) {
+      ordered_grad_names.emplace_back(node_index_to_order[producer_node->Index()], grad_name);
+    }
+  }
+  std::sort(ordered_grad_names.begin(), ordered_grad_names.end());
+
+  // Returns the size of a grad, or -1 if it is unknown.
+  auto get_size_in_bytes = [](const NodeArg& node_arg) -> int64_t {
+    const TypeProto* type_proto = node_arg.TypeAsProto();
+    const ONNX_NAMESPACE::TensorShapeProto* shape = node_arg.Shape();
+    if (type_proto == nullptr || shape == nullptr) {
+      return -1;
+    }
+    int64_t size = static_cast<int64_t>(
+        DataTypeImpl::TypeFromProto(*type_proto)->AsTensorType()->GetElementType()->Size());
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim)) {
+        return -1;
+      }
+      size *= dim.dim_value();
+    }
+    return size;
+  };
+
+  // A bucket is closed when it reaches the bucket size, or when the next grad has a different type.
+  // A grad of an unknown size gets a bucket of its own.
+  const int64_t bucket_size_in_bytes = config_.gradient_allreduce_bucket_size_mb * 1024 * 1024;
+  std::vector<std::vector<NodeArg*>> buckets;
+  int32_t bucket_elem_type = ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+  int64_t bucket_bytes = 0;
+  for (const auto& order_and_name : ordered_grad_names) {
+    NodeArg* grad_node_arg = gradient_graph.GetNodeArg(order_and_name.second);
+    const TypeProto* type_proto = grad_node_arg->TypeAsProto();
+    const int32_t elem_type = type_proto != nullptr ? type_proto->tensor_type().elem_type()
+                                                    : ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+    const int64_t grad_bytes = get_size_in_bytes(*grad_node_arg);
+    if (buckets.empty() || elem_type != bucket_elem_type || bucket_bytes < 0 || grad_bytes < 0 ||
+        bucket_bytes >= bucket_size_in_bytes) {
+      buckets.emplace_back();
+      bucket_elem_type = elem_type;
+      bucket_bytes = 0;
+    }
+    buckets.back().push_back(grad_node_arg);
+    bucket_bytes = grad_bytes < 0 ? -1 : bucket_bytes + grad_bytes;
+  }
+
+  // AllReduce sums the grads, so they are scaled by 1 / world_size first to average them like torch DDP does.
+  // The scale is a scalar initializer of the type of the grads.
+  std::unordered_map<int32_t, NodeArg*> scale_node_args;
+  auto get_scale_node_arg = [&](int32_t elem_type) -> NodeArg* {
+    auto it = scale_node_args.find(elem_type);
+    if (it != scale_node_args.end()) {
+      return it->second;
+    }
+
+    const float scale = 1.0f / static_cast<float>(config_.gradient_allreduce_world_size);
+    ONNX_NAMESPACE::TensorProto scale_initializer;
+    scale_initializer.set_name(gradient_graph.GenerateNodeArgName("gradient_allreduce_scale"));
+    scale_initializer.set_data_type(elem_type);
+    switch (elem_type) {
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+        scale_initializer.add_float_data(scale);
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+        scale_initializer.add_double_data(1.0 / static_cast<double>(config_.gradient_allreduce_world_size));
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+        scale_initializer.add_int32_data(MLFloat16(scale).val);
+        break;
+      default:
+        ORT_THROW("Gradient all-reduce does not support grads of type ", elem_type);
+    }
+    NodeArg* scale_node_arg = &graph_utils::AddInitializer(gradient_graph, scale_initializer);
+    scale_node_args.emplace(elem_type, scale_node_arg);
+    return scale_node_arg;
+  };
+
+  // The producer of each grad writes to a new NodeArg, which is all-reduced into the grad, so the graph outputs
+  // and the consumers of the grads are unchanged.
+  for (size_t bucket_index = 0; bucket_index < buckets.size(); ++bucket_index) {
+    std::vector<NodeArg*> allreduce_input_node_args;
+    for (NodeArg* grad_node_arg : buckets[bucket_index]) {
+      Node* producer_node = gradient_graph.GetMutableProducerNode(grad_node_arg->Name());
+      int producer_node_arg_index = graph_utils::GetNodeOutputIndexFromOutputName(*producer_node,
+                                                                                  grad_node_arg->Name());
+      auto& local_grad_node_arg = gradient_graph.GetOrCreateNodeArg(
+          gradient_graph.GenerateNodeArgName(grad_node_arg->Name() + "_local"), grad_node_arg->TypeAsProto());
+      graph_utils::RemoveNodeOutputEdges(gradient_graph, *producer_node, producer_node_arg_index);
+      producer_node->MutableOutputDefs()[producer_node_arg_index] = &local_grad_node_arg;
+      gradient_graph.UpdateProducerNode(local_grad_node_arg.Name(), producer_node->Index());
+
+      if (config_.gradient_allreduce_world_size == 1) {
+        allreduce_input_node_args.push_back(&local_grad_node_arg);
+        continue;
+      }
+
+      ORT_ENFORCE(grad_node_arg->TypeAsProto() != nullptr, "The type of grad ", grad_node_arg->Name(), " is unknown.");
+      auto& scaled_grad_node_arg = gradient_graph.GetOrCreateNodeArg(
+          gradient_graph.GenerateNodeArgName(grad_node_arg->Name() + "_scaled"), grad_node_arg->TypeAsProto());
+      gradient_graph.AddNode(gradient_graph.GenerateNodeName(grad_node_arg->Name() + "_scale"), "Mul",
+                             "Scale a grad by 1 / world_size",
+                             {&local_grad_node_arg,
+                              get_scale_node_arg(grad_node_arg->TypeAsProto()->tensor_type().elem_type())},
+                             {&scaled_grad_node_arg});
+      allreduce_input_node_args.push_back(&scaled_grad_node_arg);
+    }
+
+    gradient_graph.AddNode(gradient_graph.GenerateNodeName("GradientAllReduce_" + std::to_string(bucket_index)),
+                           "AllReduce", "All-reduce a bucket of grads", allreduce_input_node_args,
+                           buckets[bucket_index], nullptr, kMSDomain);
+  }
+}
+
 void OrtModuleGraphBuilder::FindModuleOutputNeededForBackward() {
   Graph& gradient_graph = gradient_model_->MainGraph();
   ORT_THROW_IF_ERROR(gradient_graph.Resolve());
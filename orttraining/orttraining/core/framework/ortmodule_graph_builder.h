@@ -28,6 +28,12 @@ struct OrtModuleGraphBuilderConfiguration {
   bool use_memory_efficient_gradient = false;
   bool build_gradient_graph = true;
   bool enable_caching = false;
+  // Size of the buckets of the trainable initializer grads to all-reduce in the gradient graph, 0 to not all-reduce.
+  // A bucket is all-reduced as soon as all of its grads are computed, so the communication overlaps with the rest
+  // of the backward pass. The grads are averaged over gradient_allreduce_world_size workers, as torch DDP does.
+  // It must not be set for a module wrapped in torch DDP, which would all-reduce the grads a second time.
+  int64_t gradient_allreduce_bucket_size_mb = 0;
+  int64_t gradient_allreduce_world_size = 1;
 
   // Log severity
   logging::Severity loglevel{logging::Severity::kWARNING};
@@ -125,6 +131,9 @@ class OrtModuleGraphBuilder {
   // Reorder gradient graph outputs.
   void ReorderOutputs();
 
+  // Group the trainable initializer grads into buckets in the order they are computed, and all-reduce each bucket.
+  void AddGradientAllReduce();
+
   // Find the module output that are needed for backward computation
   void FindModuleOutputNeededForBackward();
 
@@ -19,6 +19,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_budget.h"
 
 namespace onnxruntime {
 
@@ -164,9 +165,10 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
   LOGS(logger, VERBOSE) << "Memory optimization config: " << optimizer_config_file_path_ << ", probe level: "
                         << static_cast<int>(recompute_probe_config_.probe_level)
                         << ", enable_transformer_layer_as_boundary:"
-                        << recompute_probe_config_.enable_transformer_layer_as_boundary;
+                        << recompute_probe_config_.enable_transformer_layer_as_boundary
+                        << ", memory budget: " << recompute_budget_config_.budget_bytes;
 
-  if (pattern_subgraph_to_user_optimizer_config_map_.empty()) {
+  if (pattern_subgraph_to_user_optimizer_config_map_.empty() && !recompute_budget_config_.IsEnabled()) {
     LOGS(logger, VERBOSE) << "No optimization pattern is specified, skip memory optimization.";
     return Status::OK();
   }
@@ -190,12 +192,26 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
                   memory_opt_planner)
                   .IsOK());
 
+  // User configs take precedence over the memory budget.
+  InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> budget_configs;
+  if (pattern_subgraph_to_user_optimizer_config_map_.empty()) {
+    ORT_RETURN_IF_ERROR(optimizer::memory_optimizer::CreateRecomputeConfigsForBudget(
+        memory_opt_planner,
+        node_index_to_its_order_in_topological_sort_map,
+        candidate_output_args_map,
+        recompute_budget_config_,
+        logger,
+        budget_configs));
+  }
+
   // Finalize the plan according to user config,
   // then create a ClusterApplyContext for each unique cluster (having the same node pattern)
   InlinedHashMap<const Node*, std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>>
       node_to_opt_plan_map;
   optimizer::memory_optimizer::NodeToClusterApplyContextMap node_to_apply_context_map;
-  ORT_ENFORCE(memory_opt_planner.FinalizeNodePlansFromUserConfig(pattern_subgraph_to_user_optimizer_config_map_,
+  ORT_ENFORCE(memory_opt_planner.FinalizeNodePlansFromUserConfig(pattern_subgraph_to_user_optimizer_config_map_.empty()
+                                                                     ? budget_configs
+                                                                     : pattern_subgraph_to_user_optimizer_config_map_,
                                                                  node_to_opt_plan_map,
                                                                  node_to_apply_context_map)
                   .IsOK());
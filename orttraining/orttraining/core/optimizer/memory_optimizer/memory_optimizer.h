@@ -9,6 +9,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/common.h"
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_budget.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
 
 namespace onnxruntime {
@@ -24,18 +25,26 @@ Find recompute subgraphs and enable them according to user configs. The way we c
   b. otherwise, stop collecting and return the subgraph (could be empty).
 3. Pick up the input node from the queue, and do 2 again. The process ends when the queue is empty or 2.b happens.
 4. Clone the recomputable subgraphs and insert them back to the original graph.
+
+Without user configs, if a memory budget is given, the subgraphs to recompute are chosen automatically: the ones
+that bring the stashed activations within the budget with the least recompute work (see recompute_budget.h).
 */
 
 class MemoryOptimizer : public GraphTransformer {
  private:
  public:
   MemoryOptimizer(const std::string& memory_optimization_config_file_path,
-                  const std::string& recompute_probe_config)
+                  const std::string& recompute_probe_config,
+                  const std::string& memory_budget_mb = "",
+                  const std::string& dim_values = "")
       : GraphTransformer("MemoryOptimizer") {
     // Parse user-defined configs.
     ORT_ENFORCE(ParseOptimizationConfigFromString(
                     memory_optimization_config_file_path, recompute_probe_config)
                     .IsOK());
+    ORT_ENFORCE(optimizer::memory_optimizer::ParseRecomputeBudgetConfigFromString(
+                    memory_budget_mb, dim_values, recompute_budget_config_)
+                    .IsOK());
   }
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
@@ -105,6 +114,7 @@ class MemoryOptimizer : public GraphTransformer {
   InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> pattern_subgraph_to_user_optimizer_config_map_;
   std::string optimizer_config_file_path_;
   optimizer::memory_optimizer::ProbeConfig recompute_probe_config_;
+  optimizer::memory_optimizer::RecomputeBudgetConfig recompute_budget_config_;
 };
 
 }  // namespace onnxruntime
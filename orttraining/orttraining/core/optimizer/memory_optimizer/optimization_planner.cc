@@ -93,10 +93,12 @@ Status MemoryOptimizationPlanner::FinalizeNodePlansFromUserConfig(
           std::shared_ptr<ClusterApplyContext> apply_context = std::make_shared<ClusterApplyContext>();
           apply_context->requested_count = user_config.requested_count;
           apply_context->type = user_config.type;
-          apply_context->total_frequency++;
           cluster_id_to_apply_contexts_map.insert({cluster_id, apply_context});
         }
 
+        // Count every node of the cluster, requested_count is applied against it.
+        cluster_id_to_apply_contexts_map.at(cluster_id)->total_frequency++;
+
         node_to_apply_context_map[node] = cluster_id_to_apply_contexts_map.at(cluster_id);
 
         // If different plans for the same node have same cluster id, we only need to finalize the first one.
@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_budget.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+namespace {
+
+// Returns false if the shape is unknown or has a symbolic dimension without a value, which is named in unresolved_dim.
+bool GetElementCount(const ONNX_NAMESPACE::TensorShapeProto* shape,
+                     const InlinedHashMap<std::string, int64_t>& dim_values,
+                     int64_t& count,
+                     std::string& unresolved_dim) {
+  if (shape == nullptr) {
+    unresolved_dim = "(unknown rank)";
+    return false;
+  }
+
+  count = 1;
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim)) {
+      count *= dim.dim_value();
+      continue;
+    }
+
+    const std::string dim_param = utils::TrimString(dim.dim_param());
+    auto it = dim_values.find(dim_param);
+    if (it == dim_values.end()) {
+      unresolved_dim = dim_param.empty() ? "(unnamed)" : dim_param;
+      return false;
+    }
+    count *= it->second;
+  }
+
+  return true;
+}
+
+bool GetActivationBytes(const Node& node, size_t output_index,
+                        const InlinedHashMap<std::string, int64_t>& dim_values,
+                        int64_t& bytes,
+                        std::string& unresolved_dim) {
+  const NodeArg* output_def = node.OutputDefs()[output_index];
+  int64_t element_count = 0;
+  if (!GetElementCount(output_def->Shape(), dim_values, element_count, unresolved_dim)) {
+    return false;
+  }
+
+  MLDataType ml_data_type = DataTypeImpl::TypeFromProto(*output_def->TypeAsProto());
+  ORT_ENFORCE(ml_data_type->IsTensorType(), "ml_type must be a tensor type, but it is ",
+              DataTypeImpl::ToString(ml_data_type));
+  bytes = element_count * static_cast<int64_t>(ml_data_type->AsTensorType()->GetElementType()->Size());
+  return true;
+}
+
+// Estimate the floating point operations of a node: 2 * M * N * K for the matrix multiplications, one per output
+// element for the others, which are mostly element-wise in the recompute subgraphs.
+bool EstimateNodeFlops(const Node& node,
+                       const InlinedHashMap<std::string, int64_t>& dim_values,
+                       int64_t& flops,
+                       std::string& unresolved_dim) {
+  flops = 0;
+  for (const NodeArg* output_def : node.OutputDefs()) {
+    if (!output_def->Exists() || output_def->TypeAsProto() == nullptr ||
+        !output_def->TypeAsProto()->has_tensor_type()) {
+      continue;
+    }
+
+    int64_t element_count = 0;
+    if (!GetElementCount(output_def->Shape(), dim_values, element_count, unresolved_dim)) {
+      return false;
+    }
+    flops += element_count;
+  }
+
+  if (node.OpType() == "MatMul" || node.OpType() == "Gemm" || node.OpType() == "FusedMatMul") {
+    const auto* a_shape = node.InputDefs()[0]->Shape();
+    if (a_shape == nullptr || a_shape->dim_size() < 2) {
+      unresolved_dim = "(unknown rank)";
+      return false;
+    }
+
+    const auto* trans_a = graph_utils::GetNodeAttribute(node, "transA");
+    const bool is_trans_a = trans_a != nullptr && trans_a->i() != 0;
+    ONNX_NAMESPACE::TensorShapeProto k_shape;
+    *k_shape.add_dim() = a_shape->dim(a_shape->dim_size() - (is_trans_a ? 2 : 1));
+
+    int64_t k = 0;
+    if (!GetElementCount(&k_shape, dim_values, k, unresolved_dim)) {
+      return false;
+    }
+    flops *= 2 * k;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+Status ParseRecomputeBudgetConfigFromString(std::string_view budget_mb,
+                                            std::string_view dim_values,
+                                            RecomputeBudgetConfig& budget_config) {
+  budget_config = RecomputeBudgetConfig{};
+
+  if (!budget_mb.empty()) {
+    double budget_mb_value = 0.0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(budget_mb, budget_mb_value) && budget_mb_value >= 0.0,
+                      "Invalid memory budget specified: ", budget_mb);
+    budget_config.budget_bytes = static_cast<int64_t>(budget_mb_value * 1024 * 1024);
+  }
+
+  if (!dim_values.empty()) {
+    for (const auto& dim_value_str : utils::SplitString(dim_values, ",")) {
+      const auto name_and_value = utils::SplitString(dim_value_str, "=");
+      ORT_RETURN_IF_NOT(name_and_value.size() == 2,
+                        "Dimension values should be in the format of name=value,name=value, got: ", dim_values);
+
+      int64_t value = 0;
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(utils::TrimString(std::string(name_and_value[1])), value) &&
+                            value >= 0,
+                        "Invalid value specified for dimension: ", name_and_value[0]);
+      budget_config.dim_values[utils::TrimString(std::string(name_and_value[0]))] = value;
+    }
+  }
+
+  return Status::OK();
+}
+
+int64_t SolveRecomputeBudget(gsl::span<const RecomputeCandidate> candidates,
+                             int64_t stashed_bytes,
+                             int64_t budget_bytes,
+                             InlinedHashMap<std::string, UserConfig>& cluster_id_to_config_map) {
+  struct Cluster {
+    const std::string* cluster_id;
+    OptimizationType type;
+    InlinedVector<const RecomputeCandidate*> candidates;
+    int64_t saved_bytes{0};
+    int64_t recompute_flops{0};
+  };
+
+  // Group the candidates by cluster, keeping the topological order within each cluster.
+  std::vector<Cluster> clusters;
+  InlinedHashMap<std::string_view, size_t> cluster_id_to_index;
+  for (const auto& candidate : candidates) {
+    auto it = cluster_id_to_index.find(candidate.cluster_id);
+    if (it == cluster_id_to_index.end()) {
+      it = cluster_id_to_index.insert({candidate.cluster_id, clusters.size()}).first;
+      clusters.push_back(Cluster{&candidate.cluster_id, candidate.type});
+    }
+
+    Cluster& cluster = clusters[it->second];
+    cluster.candidates.push_back(&candidate);
+    cluster.saved_bytes += candidate.saved_bytes;
+    cluster.recompute_flops += candidate.recompute_flops;
+  }
+
+  clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                [](const Cluster& cluster) { return cluster.saved_bytes <= 0; }),
+                 clusters.end());
+
+  // Cheapest recompute per saved byte first.
+  std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+    return static_cast<double>(a.recompute_flops) * static_cast<double>(b.saved_bytes) <
+           static_cast<double>(b.recompute_flops) * static_cast<double>(a.saved_bytes);
+  });
+
+  const int64_t bytes_to_save = stashed_bytes - budget_bytes;
+  int64_t saved_bytes = 0;
+  for (const auto& cluster : clusters) {
+    if (saved_bytes >= bytes_to_save) {
+      break;
+    }
+
+    int requested_count = 0;
+    for (const auto* candidate : cluster.candidates) {
+      if (saved_bytes >= bytes_to_save) {
+        break;
+      }
+      saved_bytes += candidate->saved_bytes;
+      ++requested_count;
+    }
+
+    const bool apply_all = static_cast<size_t>(requested_count) == cluster.candidates.size();
+    cluster_id_to_config_map[*cluster.cluster_id] = UserConfig{cluster.type, apply_all ? -1 : requested_count};
+  }
+
+  return saved_bytes;
+}
+
+Status CreateRecomputeConfigsForBudget(const MemoryOptimizationPlanner& memory_opt_planner,
+                                       const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                           node_index_to_its_order_in_topological_sort_map,
+                                       const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                           candidate_output_args_map,
+                                       const RecomputeBudgetConfig& budget_config,
+                                       const logging::Logger& logger,
+                                       InlinedHashMap<std::string, UserConfig>& cluster_id_to_config_map) {
+  const auto& dim_values = budget_config.dim_values;
+  std::string unresolved_dim;
+
+  int64_t stashed_bytes = 0;
+  for (const auto& node_to_output_indices : candidate_output_args_map) {
+    const Node* node = node_to_output_indices.first;
+    for (size_t output_index : node_to_output_indices.second) {
+      int64_t bytes = 0;
+      if (!GetActivationBytes(*node, output_index, dim_values, bytes, unresolved_dim)) {
+        LOGS(logger, WARNING) << "Memory budget is ignored: the size of activation "
+                              << node->OutputDefs()[output_index]->Name() << " depends on dimension "
+                              << unresolved_dim << ", set its value in optimization.memory_optimizer_dim_values.";
+        return Status::OK();
+      }
+      stashed_bytes += bytes;
+    }
+  }
+
+  std::vector<std::pair<ptrdiff_t, RecomputeCandidate>> ordered_candidates;
+  for (const auto& node_to_plans : memory_opt_planner.GetNodeToOptimizationPlanMap()) {
+    const Node* node = node_to_plans.first;
+    for (const auto& plan : node_to_plans.second) {
+      const auto* recompute_plan = dynamic_cast<const NodeRecomputePlan*>(plan.get());
+      if (recompute_plan == nullptr) {
+        continue;
+      }
+
+      int64_t saved_bytes = 0;
+      for (size_t output_index : plan->GetActivationOutputIndices()) {
+        int64_t bytes = 0;
+        if (!GetActivationBytes(*node, output_index, dim_values, bytes, unresolved_dim)) {
+          LOGS(logger, WARNING) << "Memory budget is ignored: the size of activation "
+                                << node->OutputDefs()[output_index]->Name() << " depends on dimension "
+                                << unresolved_dim << ", set its value in optimization.memory_optimizer_dim_values.";
+          return Status::OK();
+        }
+        saved_bytes += bytes;
+      }
+
+      int64_t recompute_flops = 0;
+      for (const Node* recompute_node : recompute_plan->GetNodesInTopoOrder()) {
+        int64_t node_flops = 0;
+        if (!EstimateNodeFlops(*recompute_node, dim_values, node_flops, unresolved_dim)) {
+          LOGS(logger, WARNING) << "Memory budget is ignored: the recompute cost of node " << recompute_node->Name()
+                                << " depends on dimension " << unresolved_dim
+                                << ", set its value in optimization.memory_optimizer_dim_values.";
+          return Status::OK();
+        }
+        recompute_flops += node_flops;
+      }
+
+      auto order = node_index_to_its_order_in_topological_sort_map.find(node->Index());
+      ORT_RETURN_IF(order == node_index_to_its_order_in_topological_sort_map.end(),
+                    "Node not found in the topological sort: ", node->Name());
+      ordered_candidates.push_back(
+          {order->second,
+           RecomputeCandidate{plan->GetClusterId(), plan->GetOptimizationType(),
+                              static_cast<int64_t>(static_cast<double>(saved_bytes) * plan->GetSaveRatio()),
+                              recompute_flops}});
+
+      // FinalizeNodePlansFromUserConfig finalizes the first plan of a node, so only consider that one.
+      break;
+    }
+  }
+
+  std::sort(ordered_candidates.begin(), ordered_candidates.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<RecomputeCandidate> candidates;
+  candidates.reserve(ordered_candidates.size());
+  for (auto& ordered_candidate : ordered_candidates) {
+    candidates.push_back(std::move(ordered_candidate.second));
+  }
+
+  const int64_t saved_bytes = SolveRecomputeBudget(candidates, stashed_bytes, budget_config.budget_bytes,
+                                                   cluster_id_to_config_map);
+
+  // Log the chosen configs in the format of the config file, so a run can be reproduced without the budget.
+  std::ostringstream oss;
+  oss << "[";
+  bool is_first = true;
+  for (const auto& cluster_id_to_config : cluster_id_to_config_map) {
+    oss << (is_first ? "" : ", ") << "\"" << cluster_id_to_config.first << ":"
+        << static_cast<int>(cluster_id_to_config.second.type) << ":" << cluster_id_to_config.second.requested_count
+        << "\"";
+    is_first = false;
+  }
+  oss << "]";
+
+  LOGS(logger, INFO) << "Memory budget: " << budget_config.budget_bytes << " bytes, stashed activations: "
+                     << stashed_bytes << " bytes, saved by recompute: " << saved_bytes
+                     << " bytes. Chosen memory optimizer config: " << oss.str();
+  if (stashed_bytes - saved_bytes > budget_config.budget_bytes) {
+    LOGS(logger, WARNING) << "Memory budget of " << budget_config.budget_bytes
+                          << " bytes cannot be met by recompute, the stashed activations take "
+                          << stashed_bytes - saved_bytes << " bytes after recomputing all the candidates.";
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
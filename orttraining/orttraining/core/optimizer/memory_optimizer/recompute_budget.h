@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+/**
+ * @brief Configuration to choose the recompute plans automatically from a memory budget.
+ */
+class RecomputeBudgetConfig {
+ public:
+  bool IsEnabled() const { return budget_bytes >= 0; }
+
+  // Upper bound of the bytes of the stashed activations, -1 if there is no budget.
+  int64_t budget_bytes{-1};
+  // Values of the symbolic dimensions, used to compute the sizes of the activations and the recompute work.
+  InlinedHashMap<std::string, int64_t> dim_values;
+};
+
+/**
+ * @brief Parse the budget config.
+ *
+ * @param budget_mb The budget of the stashed activations in MB, empty if there is no budget.
+ * @param dim_values The values of the symbolic dimensions, like "batch_size=8,sequence_length=512".
+ * @param budget_config Returns the parsed config.
+ */
+Status ParseRecomputeBudgetConfigFromString(std::string_view budget_mb,
+                                            std::string_view dim_values,
+                                            RecomputeBudgetConfig& budget_config);
+
+/**
+ * @brief A node whose stashed activations can be recomputed, with the memory that saves and the cost of the
+ * recomputation.
+ */
+struct RecomputeCandidate {
+  std::string cluster_id;
+  OptimizationType type;
+  int64_t saved_bytes;
+  // Estimated floating point operations of the recompute subgraph.
+  int64_t recompute_flops;
+};
+
+/**
+ * @brief Choose the recomputations that bring the stashed activations within the budget with the least recompute
+ * work, and return them as user configs.
+ *
+ * The clusters are taken in order of recompute flops per saved byte. The nodes of a cluster are taken in topological
+ * order, which is how requested_count applies them, and the last cluster taken is only applied to as many nodes as
+ * needed. If the budget cannot be met, all the candidates are applied.
+ *
+ * @param candidates The candidates in topological order.
+ * @param stashed_bytes The bytes of all the stashed activations.
+ * @param budget_bytes The budget of the stashed activations.
+ * @param cluster_id_to_config_map Returns the user config of each chosen cluster.
+ * @return The bytes saved by the chosen recomputations.
+ */
+int64_t SolveRecomputeBudget(gsl::span<const RecomputeCandidate> candidates,
+                             int64_t stashed_bytes,
+                             int64_t budget_bytes,
+                             InlinedHashMap<std::string, UserConfig>& cluster_id_to_config_map);
+
+/**
+ * @brief Compute the sizes of the stashed activations and the recompute candidates found by the planner, and choose
+ * the recomputations for the budget with SolveRecomputeBudget.
+ *
+ * Nothing is chosen if a size depends on a symbolic dimension without a value in the budget config.
+ *
+ * @param memory_opt_planner The planner holding the recompute plans of the nodes.
+ * @param node_index_to_its_order_in_topological_sort_map The mapping of node index to its order in topological sort.
+ * @param candidate_output_args_map A map from node to its stashed activations.
+ * @param budget_config The budget config.
+ * @param logger Logger.
+ * @param cluster_id_to_config_map Returns the user config of each chosen cluster.
+ */
+Status CreateRecomputeConfigsForBudget(const MemoryOptimizationPlanner& memory_opt_planner,
+                                       const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                           node_index_to_its_order_in_topological_sort_map,
+                                       const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                           candidate_output_args_map,
+                                       const RecomputeBudgetConfig& budget_config,
+                                       const logging::Logger& logger,
+                                       InlinedHashMap<std::string, UserConfig>& cluster_id_to_config_map);
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
@@ -516,6 +516,10 @@ void addObjectMethodsForTraining(py::module& m) {
                      &OrtModuleGraphBuilderConfiguration::use_memory_efficient_gradient)
       .def_readwrite("build_gradient_graph", &OrtModuleGraphBuilderConfiguration::build_gradient_graph)
       .def_readwrite("enable_caching", &OrtModuleGraphBuilderConfiguration::enable_caching)
+      .def_readwrite("gradient_allreduce_bucket_size_mb",
+                     &OrtModuleGraphBuilderConfiguration::gradient_allreduce_bucket_size_mb)
+      .def_readwrite("gradient_allreduce_world_size",
+                     &OrtModuleGraphBuilderConfiguration::gradient_allreduce_world_size)
       .def_readwrite("loglevel", &OrtModuleGraphBuilderConfiguration::loglevel);
 
   py::class_<GraphInfo> graph_info(m, "GraphInfo",
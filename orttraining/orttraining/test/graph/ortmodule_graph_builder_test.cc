@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "orttraining/core/framework/ortmodule_graph_builder.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+using namespace onnxruntime::training;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr int64_t kHiddenSize = 512;  // a [512, 512] float weight is 1MB
+
+// Creates a model with a chain of MatMul nodes, each with a [kHiddenSize, kHiddenSize] float weight.
+std::string CreateMatMulChainModel(const std::vector<std::string>& weight_names) {
+  onnxruntime::Model model("matmul_chain", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 14}, {kMSDomain, 1}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto activation_type;
+  activation_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  activation_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  activation_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  NodeArg* input = &graph.GetOrCreateNodeArg("X", &activation_type);
+  for (size_t i = 0; i < weight_names.size(); ++i) {
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name(weight_names[i]);
+    weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weight.add_dims(kHiddenSize);
+    weight.add_dims(kHiddenSize);
+    weight.set_raw_data(std::string(kHiddenSize * kHiddenSize * sizeof(float), '\0'));
+    graph.AddInitializedTensor(weight);
+
+    const std::string output_name = i + 1 == weight_names.size() ? "Y" : "matmul_" + std::to_string(i);
+    NodeArg* output = &graph.GetOrCreateNodeArg(output_name, &activation_type);
+    graph.AddNode(output_name, "MatMul", "", {input, graph.GetNodeArg(weight_names[i])}, {output});
+    input = output;
+  }
+
+  ORT_ENFORCE(graph.Resolve().IsOK());
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+struct GradientAllReduceResult {
+  // The number of grads of each AllReduce node, sorted.
+  std::vector<size_t> bucket_grad_counts;
+  // The number of grads that are AllReduce outputs.
+  size_t num_reduced_grads = 0;
+  // The number of grads that are scaled before they are all-reduced.
+  size_t num_scaled_grads = 0;
+};
+
+GradientAllReduceResult BuildWithGradientAllReduce(int64_t bucket_size_mb, int64_t world_size) {
+  const std::vector<std::string> weight_names{"W1", "W2", "W3"};
+  std::istringstream model_istream(CreateMatMulChainModel(weight_names));
+
+  OrtModuleGraphBuilderConfiguration config;
+  config.initializer_names = weight_names;
+  config.initializer_names_to_train = weight_names;
+  config.gradient_allreduce_bucket_size_mb = bucket_size_mb;
+  config.gradient_allreduce_world_size = world_size;
+
+  OrtModuleGraphBuilder graph_builder;
+  ORT_THROW_IF_ERROR(graph_builder.Initialize(model_istream, config));
+  ORT_THROW_IF_ERROR(graph_builder.Build(TrainingGraphTransformerConfiguration{}));
+
+  ONNX_NAMESPACE::ModelProto gradient_model;
+  ORT_ENFORCE(gradient_model.ParseFromString(graph_builder.GetGradientModel()));
+  const auto grad_names = graph_builder.GetGraphInfo().initializer_grad_names_to_train;
+
+  GradientAllReduceResult result;
+  for (const auto& node : gradient_model.graph().node()) {
+    if (node.op_type() == "AllReduce") {
+      EXPECT_EQ(node.domain(), kMSDomain);
+      EXPECT_EQ(node.input_size(), node.output_size());
+      result.bucket_grad_counts.push_back(static_cast<size_t>(node.output_size()));
+      result.num_reduced_grads += std::count_if(node.output().begin(), node.output().end(),
+                                                [&](const std::string& output_name) {
+                                                  return std::find(grad_names.begin(), grad_names.end(),
+                                                                   output_name) != grad_names.end();
+                                                });
+    } else if (node.op_type() == "Mul" && node.name().find("_scale") != std::string::npos) {
+      ++result.num_scaled_grads;
+    }
+  }
+
+  std::sort(result.bucket_grad_counts.begin(), result.bucket_grad_counts.end());
+  return result;
+}
+}  // namespace
+
+TEST(OrtModuleGraphBuilderTest, GradientAllReduceDisabled) {
+  const auto result = BuildWithGradientAllReduce(0, 2);
+  EXPECT_TRUE(result.bucket_grad_counts.empty());
+  EXPECT_EQ(result.num_scaled_grads, size_t(0));
+}
+
+TEST(OrtModuleGraphBuilderTest, GradientAllReduceBuckets) {
+  // each 1MB grad fills a bucket
+  auto result = BuildWithGradientAllReduce(1, 2);
+  EXPECT_EQ(result.bucket_grad_counts, (std::vector<size_t>{1, 1, 1}));
+  EXPECT_EQ(result.num_reduced_grads, size_t(3));
+  EXPECT_EQ(result.num_scaled_grads, size_t(3));
+
+  // the first 2 grads fill a bucket and the last one gets a bucket of its own
+  result = BuildWithGradientAllReduce(2, 2);
+  EXPECT_EQ(result.bucket_grad_counts, (std::vector<size_t>{1, 2}));
+  EXPECT_EQ(result.num_reduced_grads, size_t(3));
+
+  // all the grads fit in one bucket
+  result = BuildWithGradientAllReduce(4, 2);
+  EXPECT_EQ(result.bucket_grad_counts, (std::vector<size_t>{3}));
+  EXPECT_EQ(result.num_reduced_grads, size_t(3));
+}
+
+TEST(OrtModuleGraphBuilderTest, GradientAllReduceSingleWorker) {
+  // a single worker has nothing to average
+  const auto result = BuildWithGradientAllReduce(1, 1);
+  EXPECT_EQ(result.bucket_grad_counts, (std::vector<size_t>{1, 1, 1}));
+  EXPECT_EQ(result.num_scaled_grads, size_t(0));
+}
+
+TEST(OrtModuleGraphBuilderTest, GradientAllReduceInvalidWorldSize) {
+  std::istringstream model_istream(CreateMatMulChainModel({"W1"}));
+  OrtModuleGraphBuilderConfiguration config;
+  config.initializer_names = {"W1"};
+  config.initializer_names_to_train = {"W1"};
+  config.gradient_allreduce_bucket_size_mb = 1;
+  config.gradient_allreduce_world_size = 0;
+
+  OrtModuleGraphBuilder graph_builder;
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(graph_builder.Initialize(model_istream, config),
+                                      "gradient_allreduce_world_size must be positive");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -31,6 +31,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/common.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_optimizer.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_budget.h"
 #include "orttraining/core/optimizer/memory_optimizer/transformer_specific.h"
 
 using namespace std;
@@ -384,5 +385,69 @@ TEST(MemoryOptimizerTests, TransformerLayerDetectionTest) {
   ASSERT_EQ(layer_boundary_ln_node[2]->Name(), "LayerNormalization_token_12");
 }
 
+TEST(MemoryOptimizerTests, RecomputeBudget) {
+  using optimizer::memory_optimizer::OptimizationType;
+  using optimizer::memory_optimizer::RecomputeCandidate;
+  using optimizer::memory_optimizer::UserConfig;
+
+  // In topological order. Recomputing Gelu costs 1 flop per saved byte, Tile 10.
+  const std::vector<RecomputeCandidate> candidates{
+      {"Gelu+", OptimizationType::Recompute, 100, 100},
+      {"Tile+", OptimizationType::Recompute, 100, 1000},
+      {"Gelu+", OptimizationType::Recompute, 100, 100},
+      {"Tile+", OptimizationType::Recompute, 100, 1000},
+      {"Gelu+", OptimizationType::Recompute, 100, 100},
+  };
+  const int64_t stashed_bytes = 1000;
+
+  {
+    // Within the budget already.
+    InlinedHashMap<std::string, UserConfig> configs;
+    ASSERT_EQ(optimizer::memory_optimizer::SolveRecomputeBudget(candidates, stashed_bytes, 1000, configs), 0);
+    ASSERT_TRUE(configs.empty());
+  }
+
+  {
+    // The first two Gelu are enough.
+    InlinedHashMap<std::string, UserConfig> configs;
+    ASSERT_EQ(optimizer::memory_optimizer::SolveRecomputeBudget(candidates, stashed_bytes, 850, configs), 200);
+    ASSERT_EQ(configs.size(), 1U);
+    ASSERT_EQ(configs["Gelu+"].type, OptimizationType::Recompute);
+    ASSERT_EQ(configs["Gelu+"].requested_count, 2);
+  }
+
+  {
+    // All Gelu, then one Tile.
+    InlinedHashMap<std::string, UserConfig> configs;
+    ASSERT_EQ(optimizer::memory_optimizer::SolveRecomputeBudget(candidates, stashed_bytes, 600, configs), 400);
+    ASSERT_EQ(configs.size(), 2U);
+    ASSERT_EQ(configs["Gelu+"].requested_count, -1);
+    ASSERT_EQ(configs["Tile+"].requested_count, 1);
+  }
+
+  {
+    // The budget cannot be met, everything is recomputed.
+    InlinedHashMap<std::string, UserConfig> configs;
+    ASSERT_EQ(optimizer::memory_optimizer::SolveRecomputeBudget(candidates, stashed_bytes, 0, configs), 500);
+    ASSERT_EQ(configs["Gelu+"].requested_count, -1);
+    ASSERT_EQ(configs["Tile+"].requested_count, -1);
+  }
+
+  optimizer::memory_optimizer::RecomputeBudgetConfig budget_config;
+  ASSERT_STATUS_OK(optimizer::memory_optimizer::ParseRecomputeBudgetConfigFromString(
+      "1.5", "batch_size=8, sequence_length=512", budget_config));
+  ASSERT_TRUE(budget_config.IsEnabled());
+  ASSERT_EQ(budget_config.budget_bytes, 1536 * 1024);
+  ASSERT_EQ(budget_config.dim_values.size(), 2U);
+  ASSERT_EQ(budget_config.dim_values["batch_size"], 8);
+  ASSERT_EQ(budget_config.dim_values["sequence_length"], 512);
+
+  ASSERT_STATUS_OK(optimizer::memory_optimizer::ParseRecomputeBudgetConfigFromString("", "", budget_config));
+  ASSERT_FALSE(budget_config.IsEnabled());
+  ASSERT_FALSE(optimizer::memory_optimizer::ParseRecomputeBudgetConfigFromString("-1", "", budget_config).IsOK());
+  ASSERT_FALSE(optimizer::memory_optimizer::ParseRecomputeBudgetConfigFromString("1", "batch_size", budget_config)
+                   .IsOK());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
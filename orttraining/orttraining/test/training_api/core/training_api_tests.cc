@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -14,6 +15,7 @@
 #include "orttraining/training_api/checkpoint_property.h"
 #include "orttraining/training_api/checkpoint.h"
 #include "orttraining/training_api/lr_scheduler.h"
+#include "orttraining/training_api/loss_scaler.h"
 #include "orttraining/test/training_api/core/data_utils.h"
 #include "test/util/include/temp_dir.h"
 #include "default_providers.h"
@@ -757,6 +759,46 @@ TEST(TrainingApiTest, ModuleAndOptimizerWithNominalState) {
   }
 }
 
+TEST(TrainingApiTest, DynamicLossScaler) {
+  CheckpointState state;
+  const std::vector<int64_t> dims{4};
+  auto param = std::make_shared<Parameter>(
+      "weight", onnxruntime::test::CreateInputOrtValueOnCPU<float>(dims, std::vector<float>(4, 1.f)), true);
+  const float initial_loss_scale = DynamicLossScaler::kInitialLossScale;
+  const std::vector<float> scaled_gradient{initial_loss_scale, -initial_loss_scale, 0.f, 0.5f * initial_loss_scale};
+  ASSERT_STATUS_OK(param->SetGrad("weight_grad",
+                                  onnxruntime::test::CreateInputOrtValueOnCPU<float>(dims, scaled_gradient)));
+  state.module_checkpoint_state.named_parameters.insert({"weight", param});
+
+  ASSERT_FALSE(DynamicLossScaler::IsEnabled(state));
+  ASSERT_EQ(DynamicLossScaler::GetLossScale(state), initial_loss_scale);
+  ASSERT_TRUE(DynamicLossScaler::IsEnabled(state));
+
+  // The gradients are divided by the scale, which stays the same within the up scale window.
+  bool all_finite = false;
+  ASSERT_STATUS_OK(DynamicLossScaler::UnscaleGradients(state, all_finite));
+  ASSERT_TRUE(all_finite);
+  std::vector<float> gradient;
+  CpuOrtValueToVec(param->Gradient(), gradient);
+  ASSERT_EQ(gradient, (std::vector<float>{1.f, -1.f, 0.f, 0.5f}));
+  ASSERT_EQ(DynamicLossScaler::GetLossScale(state), initial_loss_scale);
+
+  // An overflow halves the scale.
+  param->Gradient().GetMutable<Tensor>()->MutableData<float>()[2] = std::numeric_limits<float>::infinity();
+  ASSERT_STATUS_OK(DynamicLossScaler::UnscaleGradients(state, all_finite));
+  ASSERT_FALSE(all_finite);
+  ASSERT_EQ(DynamicLossScaler::GetLossScale(state), initial_loss_scale / 2);
+  ASSERT_EQ(state.property_bag.GetProperty<int64_t>(DynamicLossScaler::kGoodStepsPropertyName), 0);
+
+  // The scale doubles after a window of steps without overflow.
+  ASSERT_STATUS_OK(param->ResetGrad());
+  for (int64_t step = 0; step < DynamicLossScaler::kUpScaleWindow; ++step) {
+    ASSERT_STATUS_OK(DynamicLossScaler::UnscaleGradients(state, all_finite));
+    ASSERT_TRUE(all_finite);
+  }
+  ASSERT_EQ(DynamicLossScaler::GetLossScale(state), initial_loss_scale);
+}
+
 }  // namespace test
 }  // namespace training
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <fstream>
 
 #include "gtest/gtest.h"
@@ -361,6 +362,87 @@ TEST(AdamWTest, HFAdamWMultipleWeightsStrictTest_Loop10Steps) {
   HFAdamWMultipleWeightsTestLoop10Steps(true);
 }
 
+// The CPU kernel updates the weights in chunks, see MultiTensorApply. Use a weight that spans several chunks and
+// ends in a partial one, next to weights smaller than a chunk, and compare with a reference implementation.
+void AdamWMultipleChunksTest(int64_t adam_mode) {
+  const float lr = 1e-03f;
+  const int64_t step = 3;
+  const float alpha = 0.9f, beta = 0.999f, epsilon = 1e-8f, weight_decay = 1e-2f;
+  const std::vector<int64_t> sizes{40000, 7, 16384};
+
+  const float alpha_correction = 1.f - static_cast<float>(std::pow(alpha, step));
+  const float beta_correction = 1.f - static_cast<float>(std::pow(beta, step));
+  const float lr_corrected = lr * std::sqrt(beta_correction) / alpha_correction;
+
+  SeqTensors<float> weight_seq, gradient_seq, momentum_1_seq, momentum_2_seq;
+  SeqTensors<float> updated_weight_seq, updated_momentum_1_seq, updated_momentum_2_seq;
+  for (const int64_t size : sizes) {
+    std::vector<float> weight(static_cast<size_t>(size)), gradient(weight.size());
+    std::vector<float> momentum_1(weight.size()), momentum_2(weight.size());
+    std::vector<float> updated_weight(weight.size());
+    std::vector<float> updated_momentum_1(weight.size()), updated_momentum_2(weight.size());
+    for (size_t i = 0; i < weight.size(); ++i) {
+      weight[i] = static_cast<float>(i % 97) * 0.05f;
+      gradient[i] = (static_cast<float>(i % 13) - 6.f) * 0.1f;
+      momentum_1[i] = (static_cast<float>(i % 7) - 3.f) * 0.01f;
+      momentum_2[i] = static_cast<float>(i % 5) * 0.001f;
+
+      float w = weight[i];
+      const float m1 = alpha * momentum_1[i] + (1.f - alpha) * gradient[i];
+      const float m2 = beta * momentum_2[i] + (1.f - beta) * gradient[i] * gradient[i];
+      if (adam_mode == 0) {
+        // Torch AdamW
+        w -= w * lr * weight_decay;
+        w -= (lr * m1) / (alpha_correction * (std::sqrt(m2 / beta_correction) + epsilon));
+      } else {
+        // Huggingface AdamW
+        w -= lr_corrected * m1 / (std::sqrt(m2) + epsilon);
+        w -= lr * weight_decay * w;
+      }
+      updated_weight[i] = w;
+      updated_momentum_1[i] = m1;
+      updated_momentum_2[i] = m2;
+    }
+    weight_seq.AddTensor({size}, weight);
+    gradient_seq.AddTensor({size}, gradient);
+    momentum_1_seq.AddTensor({size}, momentum_1);
+    momentum_2_seq.AddTensor({size}, momentum_2);
+    updated_weight_seq.AddTensor({size}, updated_weight);
+    updated_momentum_1_seq.AddTensor({size}, updated_momentum_1);
+    updated_momentum_2_seq.AddTensor({size}, updated_momentum_2);
+  }
+
+  OpTester test("AdamWOptimizer", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddAttribute("epsilon", epsilon);
+  test.AddAttribute("weight_decay", weight_decay);
+  test.AddAttribute("correct_bias", static_cast<int64_t>(1));
+  test.AddAttribute("adam_mode", adam_mode);
+  test.AddInput<float>("lr", {}, {lr});
+  test.AddInput<int64_t>("step", {}, {step});
+  test.AddSeqInput("weights", weight_seq);
+  test.AddSeqInput("gradients", gradient_seq);
+  test.AddSeqInput("momentums_1", momentum_1_seq);
+  test.AddSeqInput("momentums_2", momentum_2_seq);
+  test.AddOutput<bool>("updated_flag", {}, {true});
+  test.AddSeqOutput("updated_weights", updated_weight_seq, 1e-5f, 1e-6f);
+  test.AddSeqOutput("updated_momentums_1", updated_momentum_1_seq, 1e-5f, 1e-6f);
+  test.AddSeqOutput("updated_momentums_2", updated_momentum_2_seq, 1e-5f, 1e-6f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(AdamWTest, TorchAdamWMultipleChunksTest) {
+  AdamWMultipleChunksTest(0);
+}
+
+TEST(AdamWTest, HFAdamWMultipleChunksTest) {
+  AdamWMultipleChunksTest(1);
+}
+
 }  // namespace
 
 }  // namespace optimizer
@@ -296,6 +296,37 @@ TEST(SGDOptimizerV2Test, SGDMultipleWeightsNoUpdateTest_Loop10Steps) {
   SGDMultipleWeightsTestLoop10Steps(true, &update_signal);
 }
 
+// The CPU kernel updates the weights in chunks, see MultiTensorApply. Use a weight that spans several chunks and
+// ends in a partial one, next to weights smaller than a chunk.
+TEST(SGDOptimizerV2Test, SGDMultipleChunksTest) {
+  const float lr = 1e-02f;
+  const std::vector<int64_t> sizes{40000, 7, 16384};
+
+  SeqTensors<float> weight_seq, gradient_seq, updated_weight_seq;
+  for (const int64_t size : sizes) {
+    std::vector<float> weight(static_cast<size_t>(size)), gradient(weight.size()), updated_weight(weight.size());
+    for (size_t i = 0; i < weight.size(); ++i) {
+      weight[i] = static_cast<float>(i % 97) * 0.5f;
+      gradient[i] = static_cast<float>(i % 13) - 6.f;
+      updated_weight[i] = weight[i] - lr * gradient[i];
+    }
+    weight_seq.AddTensor({size}, weight);
+    gradient_seq.AddTensor({size}, gradient);
+    updated_weight_seq.AddTensor({size}, updated_weight);
+  }
+
+  OpTester test("SGDOptimizerV2", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("lr", {}, {lr});
+  test.AddSeqInput("weights", weight_seq);
+  test.AddSeqInput("gradients", gradient_seq);
+  test.AddOutput<bool>("update_completed", {}, {true});
+  test.AddSeqOutput("updated_weights", updated_weight_seq, 1e-5f, 1e-6f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace
 
 }  // namespace optimizer
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/training_api/loss_scaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/float16.h"
+
+namespace onnxruntime {
+namespace training {
+namespace api {
+
+namespace {
+
+template <typename T>
+bool UnscaleGradient(Tensor& gradient, float inv_loss_scale) {
+  bool all_finite = true;
+  auto* data = gradient.MutableData<T>();
+  for (int64_t i = 0, count = gradient.Shape().Size(); i < count; ++i) {
+    float value;
+    if constexpr (std::is_same_v<T, float>) {
+      value = data[i] * inv_loss_scale;
+      data[i] = value;
+    } else {
+      value = data[i].ToFloat() * inv_loss_scale;
+      data[i] = T(value);
+    }
+    all_finite = all_finite && std::isfinite(value);
+  }
+  return all_finite;
+}
+
+}  // namespace
+
+bool DynamicLossScaler::IsEnabled(const CheckpointState& state) {
+  return state.property_bag.HasProperty(kLossScalePropertyName);
+}
+
+float DynamicLossScaler::GetLossScale(CheckpointState& state) {
+  if (!IsEnabled(state)) {
+    state.property_bag.AddProperty(kLossScalePropertyName, kInitialLossScale);
+    state.property_bag.AddProperty(kGoodStepsPropertyName, static_cast<int64_t>(0));
+  }
+
+  return state.property_bag.GetProperty<float>(kLossScalePropertyName);
+}
+
+Status DynamicLossScaler::UnscaleGradients(CheckpointState& state, bool& all_finite) {
+  const float loss_scale = GetLossScale(state);
+  const float inv_loss_scale = 1.0f / loss_scale;
+
+  all_finite = true;
+  for (auto& named_parameter : state.module_checkpoint_state.named_parameters) {
+    Parameter& param = *named_parameter.second;
+    if (!param.RequiresGrad() || !param.Gradient().IsAllocated()) {
+      continue;
+    }
+
+    Tensor* gradient = param.Gradient().GetMutable<Tensor>();
+    ORT_RETURN_IF_NOT(gradient->Location().device.Type() == OrtDevice::CPU,
+                      "Loss scaling is only supported for gradients on CPU, param: ", param.Name());
+    if (gradient->IsDataType<float>()) {
+      all_finite = UnscaleGradient<float>(*gradient, inv_loss_scale) && all_finite;
+    } else if (gradient->IsDataType<MLFloat16>()) {
+      all_finite = UnscaleGradient<MLFloat16>(*gradient, inv_loss_scale) && all_finite;
+    } else if (gradient->IsDataType<BFloat16>()) {
+      all_finite = UnscaleGradient<BFloat16>(*gradient, inv_loss_scale) && all_finite;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported gradient data type for loss scaling: ",
+                             gradient->DataType(), ", param: ", param.Name());
+    }
+  }
+
+  int64_t good_steps = state.property_bag.GetProperty<int64_t>(kGoodStepsPropertyName);
+  float new_loss_scale = loss_scale;
+  if (!all_finite) {
+    new_loss_scale = std::max(kMinLossScale, loss_scale / 2);
+    good_steps = 0;
+  } else if (++good_steps >= kUpScaleWindow) {
+    new_loss_scale = std::min(kMaxLossScale, loss_scale * 2);
+    good_steps = 0;
+  }
+
+  state.property_bag.AddProperty(kLossScalePropertyName, new_loss_scale);
+  state.property_bag.AddProperty(kGoodStepsPropertyName, good_steps);
+
+  return Status::OK();
+}
+
+}  // namespace api
+}  // namespace training
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "orttraining/training_api/checkpoint.h"
+
+namespace onnxruntime {
+namespace training {
+namespace api {
+
+/**
+ * @brief Dynamic loss scaling for training models that compute in float16 or bfloat16.
+ *
+ * A training model with a float scalar input named "loss_scale" multiplies the loss by it before the backward
+ * pass, so that small gradients don't underflow. The Module feeds the current scale to TrainStep, and the gradients
+ * are accumulated with it across micro-batches. Before the optimizer step, the Optimizer divides the gradients by the
+ * scale and checks them for inf and nan. A step with a non finite gradient is skipped and the scale halved. After
+ * kUpScaleWindow steps without one, the scale is doubled.
+ *
+ * The scale and the number of steps since the last overflow are properties of the CheckpointState, so they are
+ * shared by the Module and the Optimizer and saved with the checkpoint.
+ */
+struct DynamicLossScaler {
+ public:
+  static constexpr const char* kLossScaleInputName = "loss_scale";
+  static constexpr const char* kLossScalePropertyName = "ort.loss_scale";
+  static constexpr const char* kGoodStepsPropertyName = "ort.loss_scale_good_steps";
+
+  static constexpr float kInitialLossScale = static_cast<float>(1 << 16);
+  static constexpr float kMinLossScale = 1.0f;
+  static constexpr float kMaxLossScale = static_cast<float>(1 << 24);
+  static constexpr int64_t kUpScaleWindow = 2000;
+
+  // Returns true if the model trains with a loss scale, i.e. TrainStep fed one.
+  static bool IsEnabled(const CheckpointState& state);
+
+  // Returns the current loss scale, initializing it on the first call.
+  static float GetLossScale(CheckpointState& state);
+
+  /**
+   * @brief Divide the gradients of the trainable parameters by the loss scale in place, and update the scale.
+   *
+   * @param state The checkpoint state holding the parameters and the scale.
+   * @param all_finite Returns false if a gradient has an inf or a nan, in which case the step should be skipped.
+   */
+  static Status UnscaleGradients(CheckpointState& state, bool& all_finite);
+};
+
+}  // namespace api
+}  // namespace training
+}  // namespace onnxruntime
@@ -14,6 +14,7 @@
 #include "core/graph/graph_utils.h"
 
 #include "orttraining/training_api/checkpoint.h"
+#include "orttraining/training_api/loss_scaler.h"
 
 using namespace onnxruntime;
 
@@ -328,6 +329,8 @@ Module::Module(const ModelIdentifiers& model_identifiers,
       param_input_names.emplace_back(input_name);
     } else if (input_name == ACCUMULATE_GRAD_CONTROL_INPUT_NAME) {
       reset_grad_name.emplace_back(input_name);
+    } else if (input_name == DynamicLossScaler::kLossScaleInputName) {
+      has_loss_scale_input_ = true;
     } else if (std::string param_name; utils::GetParamNameFromGradient(input_name, param_name)) {
       grad_input_names.emplace_back(input_name);
     } else {
@@ -337,7 +340,7 @@ Module::Module(const ModelIdentifiers& model_identifiers,
 
   gradients_.resize(grad_input_names.size());
 
-  train_input_names_ = TrainInputNames(user_input_names, param_input_names, grad_input_names);
+  train_input_names_ = TrainInputNames(user_input_names, param_input_names, grad_input_names, has_loss_scale_input_);
 
   for (const auto& output_name : train_output_names) {
     if (std::string param_name; !utils::GetParamNameFromGradient(output_name, param_name)) {
@@ -629,6 +632,12 @@ Status Module::TrainStep(const std::vector<OrtValue>& inputs, std::vector<OrtVal
   OrtValue reset_grad_input;
   utils::WrapInOrtValue<bool>(!accumulate_gradient_, &reset_grad_input);
   feeds.push_back(reset_grad_input);
+  if (has_loss_scale_input_) {
+    // The scale only changes in the optimizer step, so the gradients accumulated across micro-batches share it.
+    OrtValue loss_scale_input;
+    utils::WrapInOrtValue<float>(DynamicLossScaler::GetLossScale(*state_), &loss_scale_input);
+    feeds.push_back(loss_scale_input);
+  }
 
   ORT_THROW_IF_ERROR(train_sess_->Run(RunOptions(), train_input_names_.AllInputNames(), feeds, train_output_names_, &outputs));
 
@@ -731,11 +740,12 @@ std::pair<common::Status, const InputDefList*> Module::GetEvalModelInputs() cons
 
 Module::TrainInputNames::TrainInputNames(gsl::span<const std::string> user_input_names,
                                          gsl::span<const std::string> weights_input_names,
-                                         gsl::span<const std::string> gradient_input_names) {
+                                         gsl::span<const std::string> gradient_input_names,
+                                         bool has_loss_scale_input) {
   train_input_names_.reserve(user_input_names.size() +
                              weights_input_names.size() +
                              gradient_input_names.size() +
-                             1U);  // +1 for the reset gradient flag input
+                             2U);  // +2 for the reset gradient flag and the loss scale inputs
   train_input_index_offsets_.reserve(3);
 
   train_input_names_.insert(train_input_names_.end(),
@@ -748,6 +758,9 @@ Module::TrainInputNames::TrainInputNames(gsl::span<const std::string> user_input
                             gradient_input_names.begin(), gradient_input_names.end());
   train_input_index_offsets_.push_back(train_input_names_.size());
   train_input_names_.push_back(ACCUMULATE_GRAD_CONTROL_INPUT_NAME);
+  if (has_loss_scale_input) {
+    train_input_names_.push_back(DynamicLossScaler::kLossScaleInputName);
+  }
 }
 
 gsl::span<const std::string> Module::TrainInputNames::AllInputNames() const { return train_input_names_; }
@@ -102,6 +102,8 @@ struct Module {
 
   // Train Step – does forward and backward computation. The outputs will be the forward’s outputs.
   // Gradients will be accumulated within the Parameter object.
+  // If the training model has a "loss_scale" input, it is fed the current dynamic loss scale, and the gradients are
+  // accumulated scaled until the optimizer step unscales them, see DynamicLossScaler.
   // If the parameter state is not available; i.e. the module was created using the nominal checkpoint,
   // and the state has not been loaded yet, then this function will return an error.
   Status TrainStep(const std::vector<OrtValue>& inputs, std::vector<OrtValue>& outputs);
@@ -178,7 +180,8 @@ struct Module {
     TrainInputNames() = default;
     TrainInputNames(gsl::span<const std::string> user_input_names,
                     gsl::span<const std::string> weights_input_names,
-                    gsl::span<const std::string> gradient_input_names);
+                    gsl::span<const std::string> gradient_input_names,
+                    bool has_loss_scale_input);
 
     gsl::span<const std::string> AllInputNames() const;
     gsl::span<const std::string> UserInputNames() const;
@@ -197,6 +200,8 @@ struct Module {
   CheckpointState* state_;  // Non owning pointer to the state.
 
   bool accumulate_gradient_ = false;
+  // The training model takes a loss scale, see DynamicLossScaler.
+  bool has_loss_scale_input_ = false;
   std::optional<std::string> eval_model_path_;
   std::optional<gsl::span<const uint8_t>> eval_model_buffer_;
   size_t eval_user_input_count_{0U};
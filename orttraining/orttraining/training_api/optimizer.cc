@@ -10,6 +10,7 @@
 #include "core/session/environment.h"
 
 #include "orttraining/training_api/checkpoint.h"
+#include "orttraining/training_api/loss_scaler.h"
 #include "orttraining/training_api/utils.h"
 
 namespace onnxruntime {
@@ -260,6 +261,15 @@ Status Optimizer::Step() {
     ORT_RETURN_IF_ERROR(ConstructOptimizerStateAndInputs());
   }
 
+  if (DynamicLossScaler::IsEnabled(*state_)) {
+    // Skip the step if the gradients overflowed with the current loss scale.
+    bool all_finite = true;
+    ORT_RETURN_IF_ERROR(DynamicLossScaler::UnscaleGradients(*state_, all_finite));
+    if (!all_finite) {
+      return Status::OK();
+    }
+  }
+
   OrtValue learning_rate_input, step_input;
   utils::WrapInOrtValue<float>(optimizer_state_->learning_rate, &learning_rate_input);
   // Use step count + 1 before running optimizer step.
@@ -103,6 +103,8 @@ struct Optimizer {
             const std::vector<std::shared_ptr<IExecutionProvider>>& providers,
             gsl::span<OrtCustomOpDomain* const> op_domains = gsl::span<OrtCustomOpDomain* const>());
 
+  // If the module trains with a loss scale, the gradients are unscaled first, and the step is skipped if one of them
+  // is not finite, see DynamicLossScaler.
   Status Step();
 
   Status SetLearningRate(float lr) {
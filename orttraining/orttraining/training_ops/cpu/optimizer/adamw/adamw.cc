@@ -90,46 +90,48 @@ ONNX_OPERATOR_KERNEL_EX(
     AdamWOptimizer<float>);
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float alpha_correction, float beta_correction) const {
+void AdamWOptimizer<T>::AdamWComputeMode0(T* weight_data, const T* gradient_data, T* momentums_1_data,
+                                          T* momentums_2_data, std::ptrdiff_t count, float lr, float alpha_correction,
+                                          float beta_correction) const {
+  EigenVectorArrayMap<T> weight(weight_data, count);
+  ConstEigenVectorArrayMap<T> gradient(gradient_data, count);
+  EigenVectorArrayMap<T> momentums_1(momentums_1_data, count);
+  EigenVectorArrayMap<T> momentums_2(momentums_2_data, count);
+
   // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (MakeEigenArrayMap<T>(weight) * lr * weight_decay_);
+  weight = weight - (weight * lr * weight_decay_);
 
   // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+  momentums_1 = alpha_ * momentums_1 + (1.f - alpha_) * gradient;
 
   // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+  momentums_2 = beta_ * momentums_2 + (1.f - beta_) * gradient * gradient;
 
   // Compute the new weight.
-  auto denom = (MakeEigenArrayMap<T>(momentums_2) / beta_correction).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr * MakeEigenArrayMap<T>(momentums_1)) / (alpha_correction * denom);
-
-  return Status::OK();
+  auto denom = (momentums_2 / beta_correction).sqrt() + epsilon_;
+  weight = weight - (lr * momentums_1) / (alpha_correction * denom);
 }
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float lr_corrected) const {
+void AdamWOptimizer<T>::AdamWComputeMode1(T* weight_data, const T* gradient_data, T* momentums_1_data,
+                                          T* momentums_2_data, std::ptrdiff_t count, float lr,
+                                          float lr_corrected) const {
+  EigenVectorArrayMap<T> weight(weight_data, count);
+  ConstEigenVectorArrayMap<T> gradient(gradient_data, count);
+  EigenVectorArrayMap<T> momentums_1(momentums_1_data, count);
+  EigenVectorArrayMap<T> momentums_2(momentums_2_data, count);
+
   // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+  momentums_1 = alpha_ * momentums_1 + (1.f - alpha_) * gradient;
 
   // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+  momentums_2 = beta_ * momentums_2 + (1.f - beta_) * gradient * gradient;
 
-  auto denom = MakeEigenArrayMap<T>(momentums_2).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr_corrected * MakeEigenArrayMap<T>(momentums_1) / denom);
+  auto denom = momentums_2.sqrt() + epsilon_;
+  weight = weight - (lr_corrected * momentums_1 / denom);
 
   // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (lr * weight_decay_ * MakeEigenArrayMap<T>(weight));
-
-  return Status::OK();
+  weight = weight - (lr * weight_decay_ * weight);
 }
 
 template <typename T>
@@ -165,22 +167,25 @@ Status AdamWOptimizer<T>::Compute(OpKernelContext* ctx) const {
     //         bias correction is applied on learning rate, then use lr_corrected for subsequent computations.
     //         weight decay is applied after weight is updated.
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-      Tensor& momentums_1 = const_cast<Tensor&>(p.momentums_1->Get(weight_index));
-      Tensor& momentums_2 = const_cast<Tensor&>(p.momentums_2->Get(weight_index));
-
-      if (adam_mode_ == 0) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, lr, alpha_correction, beta_correction));
-      } else if (adam_mode_ == 1) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, lr, lr_corrected));
-      } else {
-        ORT_THROW("Unsupported Adamw optimizer mode.");
-      }
-    }
+    // All the weights are updated in one parallel loop over chunks of them, see MultiTensorApply.
+    static constexpr double cost_per_element = 16.0;
+    MultiTensorApply(
+        ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes, cost_per_element,
+        [this, &p, lr, alpha_correction, beta_correction, lr_corrected](size_t i, std::ptrdiff_t offset,
+                                                                        std::ptrdiff_t count) {
+          const std::vector<void*>& pointers = p.grouped_tensor_pointers[i];
+          T* weight = static_cast<T*>(pointers[0]) + offset;
+          const T* gradient = static_cast<const T*>(pointers[1]) + offset;
+          T* momentums_1 = static_cast<T*>(pointers[2]) + offset;
+          T* momentums_2 = static_cast<T*>(pointers[3]) + offset;
+
+          if (adam_mode_ == 0) {
+            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, count, lr, alpha_correction,
+                              beta_correction);
+          } else {
+            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, count, lr, lr_corrected);
+          }
+        });
 
     *updated_flag_ptr = true;
   } else {
@@ -4,7 +4,10 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include <cmath>
 
 namespace onnxruntime {
@@ -19,6 +22,41 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
   }
 }
 
+// Number of elements of the chunks of MultiTensorApply.
+constexpr std::ptrdiff_t kMultiTensorApplyChunkSize = 16 * 1024;
+
+// CPU counterpart of the CUDA launch_multi_tensor_functor. Splits the tensors of a group into chunks of at most
+// kMultiTensorApplyChunkSize elements and calls fn(tensor_index, offset, count) for all of them in one parallel loop,
+// so that thousands of small parameters are updated with a single dispatch to the thread pool and large parameters
+// are split across threads. A chunk fits in the L2 cache, so an update that makes several passes over it only
+// reads the tensors from memory once.
+template <typename TFunc>
+void MultiTensorApply(concurrency::ThreadPool* tp, gsl::span<const int> tensor_sizes, double cost_per_element,
+                      TFunc&& fn) {
+  struct Chunk {
+    size_t tensor_index;
+    std::ptrdiff_t offset;
+    std::ptrdiff_t count;
+  };
+
+  InlinedVector<Chunk> chunks;
+  for (size_t i = 0; i < tensor_sizes.size(); ++i) {
+    for (std::ptrdiff_t offset = 0; offset < tensor_sizes[i]; offset += kMultiTensorApplyChunkSize) {
+      chunks.push_back({i, offset, std::min<std::ptrdiff_t>(kMultiTensorApplyChunkSize, tensor_sizes[i] - offset)});
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(chunks.size()),
+      cost_per_element * static_cast<double>(kMultiTensorApplyChunkSize),
+      [&chunks, &fn](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const Chunk& chunk = chunks[i];
+          fn(chunk.tensor_index, chunk.offset, chunk.count);
+        }
+      });
+}
+
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 